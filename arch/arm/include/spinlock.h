@@ -49,6 +49,9 @@
 #  ifndef UP_SEV
 #    define UP_SEV() __asm__ __volatile__ ("sev" : : : "memory")
 #  endif
+#  ifndef UP_RELAX
+#    define UP_RELAX() __asm__ __volatile__ ("yield" : : : "memory")
+#  endif
 #endif
 
 /****************************************************************************
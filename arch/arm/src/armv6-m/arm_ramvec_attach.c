@@ -101,4 +101,20 @@ int arm_ramvec_attach(int irq, up_vector_t vector)
   return ret;
 }
 
+/****************************************************************************
+ * Name: up_attach_direct
+ *
+ * Description:
+ *   Point the RAM vector of 'irq' straight at 'isr' so that it is entered
+ *   by hardware without passing through exception_common.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_DIRECT
+int up_attach_direct(int irq, direct_xcpt_t isr)
+{
+  return arm_ramvec_attach(irq, (up_vector_t)isr);
+}
+#endif
+
 #endif /* CONFIG_ARCH_RAMVECTORS */
@@ -79,7 +79,12 @@
 
 #define EXC_RETURN_HANDLER       0xfffffff1
 
-#ifdef CONFIG_ARCH_FPU
+/* EXC_RETURN_FPU: New contexts start with the extended frame unless lazy
+ * FP stacking is enabled, in which case FPCCR.ASPEN will switch a thread
+ * to the extended frame on its first FP instruction.
+ */
+
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_ARCH_LAZYFPU)
 #  define EXC_RETURN_FPU         0
 #else
 #  define EXC_RETURN_FPU         EXC_RETURN_STD_CONTEXT
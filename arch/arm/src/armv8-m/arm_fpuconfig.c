@@ -60,6 +60,27 @@ void arm_fpuconfig(void)
 {
   uint32_t regval;
 
+#ifdef CONFIG_ARCH_LAZYFPU
+  /* Clear CONTROL.FPCA so that threads start with the basic frame; FPCA
+   * is only set once a thread executes its first FP instruction.
+   */
+
+  regval = getcontrol();
+  regval &= ~CONTROL_FPCA;
+  setcontrol(regval);
+
+  /* Set FPCCR.ASPEN so that only contexts that have used the FPU get the
+   * extended frame, and FPCCR.LSPEN so that the volatile FP registers are
+   * only written to the reserved frame space if the handler itself uses
+   * the FPU.  exception_common always executes an FP instruction for an
+   * extended frame (the S16-S31 save), so the lazy state is resolved
+   * before any context switch takes place.
+   */
+
+  regval = getreg32(NVIC_FPCCR);
+  regval |= NVIC_FPCCR_ASPEN | NVIC_FPCCR_LSPEN;
+  putreg32(regval, NVIC_FPCCR);
+#else
   /* Set CONTROL.FPCA so that we always get the extended context frame
    * with the volatile FP registers stacked above the basic context.
    */
@@ -76,6 +97,7 @@ void arm_fpuconfig(void)
   regval = getreg32(NVIC_FPCCR);
   regval &= ~(NVIC_FPCCR_ASPEN | NVIC_FPCCR_LSPEN);
   putreg32(regval, NVIC_FPCCR);
+#endif
 
   /* Enable full access to CP10 and CP11 */
 
@@ -28,6 +28,8 @@
 #include <nuttx/power/pm.h>
 #include <stdbool.h>
 
+#include "arm64_internal.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,7 +80,10 @@ static bool pm_idle_handler(int cpu,
 
         /* Operations here should not cross cores */
 
-        asm("WFI");
+        if (!arm64_idle_poll())
+          {
+            asm("WFI");
+          }
 
         first = pm_idle_lock(cpu);
         if (first)
@@ -106,7 +111,10 @@ static void pm_idle_handler(enum pm_state_e state)
   switch (state)
     {
       default:
-        asm("WFI");
+        if (!arm64_idle_poll())
+          {
+            asm("WFI");
+          }
         break;
     }
 }
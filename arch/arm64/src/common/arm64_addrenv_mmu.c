@@ -242,6 +242,61 @@ static int copy_kernel_mappings(arch_addrenv_t *addrenv)
   return OK;
 }
 
+#ifdef CONFIG_ARM64_ADDRENV_LARGE_PAGES
+
+/****************************************************************************
+ * Name: map_large
+ *
+ * Description:
+ *   Try to back a naturally aligned block of virtual memory with physically
+ *   contiguous memory of the same alignment, so it can be mapped either by
+ *   a single block entry or by a run of entries with the contiguous hint.
+ *
+ * Input Parameters:
+ *   ptlevel - The translation table level of the entries
+ *   lnvaddr - The virtual address of the translation table
+ *   vaddr - Base virtual address, aligned to the size of the block
+ *   npages - Size of the block in pages
+ *   nentries - Amount of entries mapping the block
+ *   mmuflags - MMU flags to use
+ *
+ * Returned value:
+ *   true if the block was mapped; false if there is no such memory
+ *
+ ****************************************************************************/
+
+static bool map_large(uint32_t ptlevel, uintptr_t lnvaddr, uintptr_t vaddr,
+                      unsigned int npages, unsigned int nentries,
+                      uint64_t mmuflags)
+{
+  uintptr_t    paddr;
+  size_t       entsize;
+  unsigned int i;
+
+  paddr = mm_pgalloc_align(npages, npages);
+  if (!paddr)
+    {
+      return false;
+    }
+
+  for (i = 0; i < npages; i++)
+    {
+      arm64_pgwipe(paddr + ((uintptr_t)i << MM_PGSHIFT));
+    }
+
+  entsize = ((size_t)npages << MM_PGSHIFT) / nentries;
+  for (i = 0; i < nentries; i++)
+    {
+      mmu_ln_setentry(ptlevel, lnvaddr, paddr, vaddr, mmuflags);
+      paddr += entsize;
+      vaddr += entsize;
+    }
+
+  return true;
+}
+
+#endif /* CONFIG_ARM64_ADDRENV_LARGE_PAGES */
+
 /****************************************************************************
  * Name: create_region
  *
@@ -290,6 +345,22 @@ static int create_region(arch_addrenv_t *addrenv, uintptr_t vaddr,
 
       paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, ptprev, vaddr));
 
+#ifdef CONFIG_ARM64_ADDRENV_LARGE_PAGES
+      /* A section fully covered by the region is mapped by a block entry,
+       * then no final level page table is needed at all.
+       */
+
+      if (!paddr && (vaddr & (MMU_L2_PAGE_SIZE - 1)) == 0 &&
+          size - nmapped >= MMU_L2_PAGE_SIZE &&
+          map_large(ptlevel, ptprev, vaddr, ENTRIES_PER_PGT, 1,
+                    (mmuflags & ~PTE_DESC_TYPE_MASK) | PTE_BLOCK_DESC))
+        {
+          nmapped += MMU_L2_PAGE_SIZE;
+          vaddr   += MMU_L2_PAGE_SIZE;
+          continue;
+        }
+#endif
+
       if (!paddr)
         {
           /* Nothing yet, allocate one page for final level page table */
@@ -321,6 +392,22 @@ static int create_region(arch_addrenv_t *addrenv, uintptr_t vaddr,
 #endif
            j++)
         {
+#ifdef CONFIG_ARM64_ADDRENV_LARGE_PAGES
+          /* Then try a 64KiB run sharing a single TLB entry */
+
+          if ((vaddr & (MMU_L3_CONT_SIZE - 1)) == 0 &&
+              size - nmapped >= MMU_L3_CONT_SIZE &&
+              j + MMU_L3_CONT_ENTRIES <= ENTRIES_PER_PGT &&
+              map_large(ptlevel + 1, ptlast, vaddr, MMU_L3_CONT_ENTRIES,
+                        MMU_L3_CONT_ENTRIES, mmuflags | PTE_BLOCK_DESC_CONT))
+            {
+              j       += MMU_L3_CONT_ENTRIES - 1;
+              nmapped += MMU_L3_CONT_SIZE;
+              vaddr   += MMU_L3_CONT_SIZE;
+              continue;
+            }
+#endif
+
           paddr = mm_pgalloc(1);
           if (!paddr)
             {
@@ -568,6 +655,14 @@ int up_addrenv_destroy(arch_addrenv_t *addrenv)
     {
       for (i = 0; i < ENTRIES_PER_PGT; i++, vaddr += pgsize)
         {
+          if ((ptprev[i] & PTE_DESC_TYPE_MASK) == PTE_BLOCK_DESC)
+            {
+              /* A whole section mapped by one block entry */
+
+              mm_pgfree(mmu_pte_to_paddr(ptprev[i]), ENTRIES_PER_PGT);
+              continue;
+            }
+
           ptlast = (uintptr_t *)arm64_pgvaddr(mmu_pte_to_paddr(ptprev[i]));
           if (ptlast)
             {
@@ -51,6 +51,29 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: split_contiguous
+ *
+ * Description:
+ *   Drop the contiguous hint from the run of final level entries containing
+ *   vaddr, so the attributes of a single entry can be changed.
+ *
+ ****************************************************************************/
+
+static void split_contiguous(uintptr_t lnvaddr, uintptr_t vaddr)
+{
+  uintptr_t entry;
+  int       i;
+
+  vaddr &= ~((uintptr_t)MMU_L3_CONT_SIZE - 1);
+  for (i = 0; i < MMU_L3_CONT_ENTRIES; i++, vaddr += MMU_L3_PAGE_SIZE)
+    {
+      entry = mmu_ln_getentry(MMU_PGT_LEVEL_MAX, lnvaddr, vaddr);
+      mmu_ln_restore(MMU_PGT_LEVEL_MAX, lnvaddr, vaddr,
+                     entry & ~PTE_BLOCK_DESC_CONT);
+    }
+}
+
 static int modify_region(uintptr_t vstart, uintptr_t vend, uintptr_t setmask)
 {
   uintptr_t l1vaddr;
@@ -58,6 +81,7 @@ static int modify_region(uintptr_t vstart, uintptr_t vend, uintptr_t setmask)
   uintptr_t entry;
   uintptr_t paddr;
   uintptr_t vaddr;
+  size_t    size;
   uint32_t  ptlevel;
 
   /* Must perform a reverse table walk */
@@ -77,7 +101,13 @@ static int modify_region(uintptr_t vstart, uintptr_t vend, uintptr_t setmask)
            ptlevel < MMU_PGT_LEVEL_MAX;
            ptlevel++)
         {
-          paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, lnvaddr, vaddr));
+          entry = mmu_ln_getentry(ptlevel, lnvaddr, vaddr);
+          if ((entry & PTE_DESC_TYPE_MASK) == PTE_BLOCK_DESC)
+            {
+              break;
+            }
+
+          paddr = mmu_pte_to_paddr(entry);
           lnvaddr = arm64_pgvaddr(paddr);
           if (!lnvaddr)
             {
@@ -88,12 +118,37 @@ static int modify_region(uintptr_t vstart, uintptr_t vend, uintptr_t setmask)
       /* Get entry and modify the flags */
 
       entry  = mmu_ln_getentry(ptlevel, lnvaddr, vaddr);
+      if (ptlevel < MMU_PGT_LEVEL_MAX)
+        {
+          /* A block entry can only be modified as a whole */
+
+          size = mmu_get_region_size(ptlevel);
+          if ((vaddr & (size - 1)) != 0 || vend - vaddr < size)
+            {
+              return -EINVAL;
+            }
+        }
+      else if ((entry & PTE_BLOCK_DESC_CONT) != 0)
+        {
+          /* The entries of a contiguous run must share their attributes */
+
+          split_contiguous(lnvaddr, vaddr);
+          entry &= ~PTE_BLOCK_DESC_CONT;
+        }
+
       entry &= ~CLR_MASK;
       entry |= setmask | PTE_BLOCK_DESC_AP_USER;
 
       /* Restore the entry */
 
       mmu_ln_restore(ptlevel, lnvaddr, vaddr, entry);
+
+      /* Skip the rest of a block */
+
+      if (ptlevel < MMU_PGT_LEVEL_MAX)
+        {
+          vaddr += size - MM_PGSIZE;
+        }
     }
 
   return OK;
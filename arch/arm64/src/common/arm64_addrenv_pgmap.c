@@ -26,6 +26,9 @@
 
 #include <nuttx/config.h>
 
+#include <errno.h>
+#include <assert.h>
+
 #include <nuttx/arch.h>
 #include <nuttx/addrenv.h>
 #include <nuttx/irq.h>
@@ -49,6 +52,47 @@
 static struct arch_addrenv_s g_kernel_addrenv;
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+
+/****************************************************************************
+ * Name: arm64_text_lnvaddr
+ *
+ * Description:
+ *   Find the final level page table that maps a user text address.
+ *
+ ****************************************************************************/
+
+static uintptr_t arm64_text_lnvaddr(arch_addrenv_t *addrenv, uintptr_t vaddr)
+{
+  uintptr_t lnvaddr;
+  uintptr_t entry;
+  uint32_t  ptlevel;
+
+  lnvaddr = arm64_pgvaddr(mmu_ttbr_to_paddr(addrenv->ttbr0));
+  for (ptlevel = mmu_get_base_pgt_level();
+       lnvaddr && ptlevel < MMU_PGT_LEVEL_MAX;
+       ptlevel++)
+    {
+      /* Text mapped by a block entry can not be shared page by page */
+
+      entry = mmu_ln_getentry(ptlevel, lnvaddr, vaddr);
+      if ((entry & PTE_DESC_TYPE_MASK) == PTE_BLOCK_DESC)
+        {
+          return 0;
+        }
+
+      lnvaddr = arm64_pgvaddr(mmu_pte_to_paddr(entry));
+    }
+
+  return lnvaddr;
+}
+
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -73,6 +117,7 @@ uintptr_t up_addrenv_find_page(arch_addrenv_t *addrenv, uintptr_t vaddr)
 {
   uintptr_t pgdir;
   uintptr_t lnvaddr;
+  uintptr_t entry;
   uintptr_t paddr;
   uint32_t  ptlevel;
 
@@ -97,7 +142,17 @@ uintptr_t up_addrenv_find_page(arch_addrenv_t *addrenv, uintptr_t vaddr)
        ptlevel < MMU_PGT_LEVEL_MAX;
        ptlevel++)
     {
-      paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, lnvaddr, vaddr));
+      entry = mmu_ln_getentry(ptlevel, lnvaddr, vaddr);
+      paddr = mmu_pte_to_paddr(entry);
+
+      /* A block entry maps the page directly at this level */
+
+      if ((entry & PTE_DESC_TYPE_MASK) == PTE_BLOCK_DESC)
+        {
+          return paddr + MM_PGALIGNDOWN(vaddr &
+                                        (mmu_get_region_size(ptlevel) - 1));
+        }
+
       lnvaddr = arm64_pgvaddr(paddr);
       if (!lnvaddr)
         {
@@ -171,6 +226,110 @@ void up_addrenv_page_wipe(uintptr_t page)
   arm64_pgwipe(page);
 }
 
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+
+/****************************************************************************
+ * Name: up_addrenv_text_share
+ *
+ * Description:
+ *   Replace the private text pages of an address environment with pages
+ *   shared with another address environment created from the same file.
+ *   The private pages are freed.
+ *
+ * Input Parameters:
+ *   addrenv - The user address environment.
+ *   pages   - The physical addresses of the shared text pages.
+ *   npages  - The number of pages in the list.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int up_addrenv_text_share(arch_addrenv_t *addrenv, const uintptr_t *pages,
+                          unsigned int npages)
+{
+  uintptr_t lnvaddr;
+  uintptr_t vaddr;
+  uintptr_t paddr;
+  unsigned int i;
+
+  DEBUGASSERT(addrenv && pages);
+
+  for (i = 0; i < npages; i++)
+    {
+      vaddr   = addrenv->textvbase + i * MM_PGSIZE;
+      lnvaddr = arm64_text_lnvaddr(addrenv, vaddr);
+      if (!lnvaddr)
+        {
+          return -EFAULT;
+        }
+
+      paddr = mmu_pte_to_paddr(mmu_ln_getentry(MMU_PGT_LEVEL_MAX, lnvaddr,
+                                               vaddr));
+      if (paddr != pages[i])
+        {
+          if (paddr)
+            {
+              mm_pgfree(paddr, 1);
+            }
+
+          mmu_ln_setentry(MMU_PGT_LEVEL_MAX, lnvaddr, pages[i], vaddr,
+                          MMU_UTEXT_FLAGS);
+        }
+    }
+
+  UP_DMB();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_addrenv_text_unshare
+ *
+ * Description:
+ *   Unmap the shared text pages from an address environment, so that
+ *   up_addrenv_destroy() does not return them to the page pool.  Entries
+ *   that do not map a shared page are left alone.
+ *
+ * Input Parameters:
+ *   addrenv - The user address environment.
+ *   pages   - The physical addresses of the shared text pages.
+ *   npages  - The number of pages in the list.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int up_addrenv_text_unshare(arch_addrenv_t *addrenv,
+                            const uintptr_t *pages, unsigned int npages)
+{
+  uintptr_t lnvaddr;
+  uintptr_t vaddr;
+  unsigned int i;
+
+  DEBUGASSERT(addrenv && pages);
+
+  for (i = 0; i < npages; i++)
+    {
+      vaddr   = addrenv->textvbase + i * MM_PGSIZE;
+      lnvaddr = arm64_text_lnvaddr(addrenv, vaddr);
+      if (lnvaddr &&
+          mmu_pte_to_paddr(mmu_ln_getentry(MMU_PGT_LEVEL_MAX, lnvaddr,
+                                           vaddr)) == pages[i])
+        {
+          mmu_ln_clear(MMU_PGT_LEVEL_MAX, lnvaddr, vaddr);
+        }
+    }
+
+  UP_DMB();
+  return OK;
+}
+
+#endif /* CONFIG_ARCH_ADDRENV_SHARED_TEXT */
+
 #ifdef CONFIG_MM_KMAP
 
 /****************************************************************************
@@ -62,6 +62,7 @@
 
 uintptr_t arm64_get_pgtable(arch_addrenv_t *addrenv, uintptr_t vaddr)
 {
+  uintptr_t entry;
   uintptr_t paddr;
   uintptr_t ptprev;
   uint32_t  ptlevel;
@@ -80,7 +81,15 @@ uintptr_t arm64_get_pgtable(arch_addrenv_t *addrenv, uintptr_t vaddr)
 
   /* Find the physical address of the final level page table */
 
-  paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, ptprev, vaddr));
+  entry = mmu_ln_getentry(ptlevel, ptprev, vaddr);
+  if ((entry & PTE_DESC_TYPE_MASK) == PTE_BLOCK_DESC)
+    {
+      /* Mapped by a block entry, there is no final level page table */
+
+      return 0;
+    }
+
+  paddr = mmu_pte_to_paddr(entry);
   if (!paddr)
     {
       /* No page table has been allocated... allocate one now */
@@ -57,9 +57,14 @@ void up_idle(void)
   nxsched_process_timer();
 #else
 
-  /* Sleep until an interrupt occurs to save power */
+  /* Spin if this CPU trades power for wakeup latency, otherwise sleep
+   * until an interrupt occurs to save power.
+   */
 
-  asm("dsb sy");
-  asm("wfi");
+  if (!arm64_idle_poll())
+    {
+      asm("dsb sy");
+      asm("wfi");
+    }
 #endif
 }
@@ -0,0 +1,80 @@
+/****************************************************************************
+ * arch/arm64/src/common/arm64_idlepoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+
+#include "arm64_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of spin iterations before control goes back to the idle loop, so
+ * that PM bookkeeping and mode changes are still observed.
+ */
+
+#define ARM64_IDLE_POLL_SPINS 1024
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm64_idle_poll
+ *
+ * Description:
+ *   If idle polling is enabled for this CPU, spin with interrupts enabled
+ *   instead of entering WFI.  A wakeup IPI or device interrupt is then
+ *   taken without the WFI exit latency.
+ *
+ * Returned Value:
+ *   True if the CPU polled and the caller must not enter WFI.
+ *
+ ****************************************************************************/
+
+bool arm64_idle_poll(void)
+{
+  int cpu = up_cpu_index();
+  int i;
+
+  if (!CPU_ISSET(cpu, &g_idle_poll_cpus))
+    {
+      return false;
+    }
+
+  for (i = 0; i < ARM64_IDLE_POLL_SPINS && CPU_ISSET(cpu, &g_idle_poll_cpus);
+       i++)
+    {
+      asm volatile("yield" ::: "memory");
+    }
+
+  return true;
+}
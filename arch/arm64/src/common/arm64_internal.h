@@ -278,6 +278,12 @@ void arm64_pminitialize(void);
 #  define arm64_pminitialize()
 #endif
 
+#ifdef CONFIG_SCHED_IDLE_POLL
+bool arm64_idle_poll(void);
+#else
+#  define arm64_idle_poll() false
+#endif
+
 /* Interrupt handling */
 
 /* Exception handling logic unique to the Cortex-A and Cortex-R families
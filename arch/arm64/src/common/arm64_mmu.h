@@ -117,6 +117,7 @@
 #define PTE_BLOCK_DESC_AF           (1ULL << 10) /* A-flag */
 #define PTE_BLOCK_DESC_NG           (1ULL << 11) /* Non-global */
 #define PTE_BLOCK_DESC_DIRTY        (1ULL << 51) /* D-flag */
+#define PTE_BLOCK_DESC_CONT         (1ULL << 52) /* Contiguous hint */
 #define PTE_BLOCK_DESC_PXN          (1ULL << 53) /* Kernel execute never */
 #define PTE_BLOCK_DESC_UXN          (1ULL << 54) /* User execute never */
 
@@ -278,6 +279,11 @@
 #define MMU_L2_PAGE_SIZE            (0x200000)     /* 2M */
 #define MMU_L3_PAGE_SIZE            (0x1000)       /* 4K */
 
+/* Final level entries that can be combined by the contiguous hint */
+
+#define MMU_L3_CONT_ENTRIES         (16U)
+#define MMU_L3_CONT_SIZE            (MMU_L3_CONT_ENTRIES * MMU_L3_PAGE_SIZE)
+
 /* Flags for user page tables */
 
 #define MMU_UPGT_FLAGS              (PTE_TABLE_DESC)
@@ -28,6 +28,8 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <nuttx/nuttx.h>
+
 #include "arm64_arch.h"
 #include "arm64_mmu.h"
 
@@ -42,6 +44,21 @@
 
 #define MTE_MM_AILGN    16
 
+/* DCZID_EL0 fields, DC GVA tags a block of (4 << BS) bytes at once */
+
+#define DCZID_BS_MASK   0xf
+#define DCZID_DZP_BIT   BIT(4)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Size of the block tagged by DC GVA, zero if the instruction is
+ * prohibited.
+ */
+
+static size_t g_mte_gva_size;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -70,7 +87,7 @@ uint8_t up_memtag_get_tag(const void *addr)
 
 uint8_t up_memtag_get_random_tag(const void *addr)
 {
-  asm("irg %0, %0" : "=r" (addr));
+  asm("irg %0, %0" : "+r" (addr));
 
   return up_memtag_get_tag(addr);
 }
@@ -82,38 +99,73 @@ void *up_memtag_set_tag(const void *addr, uint8_t tag)
           ((uint64_t)tag << MTE_TAG_SHIFT));
 }
 
-/* Set MTE state */
+/* Set MTE state.  The tag checks are suppressed through PSTATE.TCO, which
+ * is cheaper to flip than SCTLR_EL1.TCF1 on every heap operation and is
+ * saved and restored with the context of the thread instead of being a
+ * property of the CPU.
+ */
 
 bool up_memtag_bypass(bool bypass)
 {
-  uint64_t val = read_sysreg(sctlr_el1);
-  bool state = !(val & SCTLR_TCF1_BIT);
+  uint64_t tco;
+
+  __asm__ volatile ("mrs %0, tco" : "=r" (tco));
 
   if (bypass)
     {
-      val &= ~SCTLR_TCF1_BIT;
+      __asm__ volatile ("msr tco, #1" : : : "memory");
     }
   else
     {
-      val |= SCTLR_TCF1_BIT;
+      __asm__ volatile ("msr tco, #0" : : : "memory");
     }
 
-  write_sysreg(val, sctlr_el1);
-  return state;
+  return tco != 0;
 }
 
 /* Set memory tags for a given memory range */
 
 void up_memtag_tag_mem(const void *addr, size_t size)
 {
-  size_t i;
+  uintptr_t ptr = (uintptr_t)addr;
+  uintptr_t end = ptr + size;
+  uintptr_t block;
 
   DEBUGASSERT((uintptr_t)addr % MTE_MM_AILGN == 0);
   DEBUGASSERT(size % MTE_MM_AILGN == 0);
 
-  for (i = 0; i < size; i += MTE_MM_AILGN)
+  /* Tag the whole DC GVA blocks in the middle of a large range, the tag
+   * comes from the address so the alignment is not affected by it.
+   */
+
+  if (g_mte_gva_size != 0 && size >= 2 * g_mte_gva_size)
     {
-      asm("stg %0, [%0]" : : "r"(addr + i));
+      block = ALIGN_UP(ptr, g_mte_gva_size);
+      while (ptr < block)
+        {
+          asm("stg %0, [%0]" : : "r"(ptr) : "memory");
+          ptr += MTE_MM_AILGN;
+        }
+
+      block = ALIGN_DOWN(end, g_mte_gva_size);
+      while (ptr < block)
+        {
+          asm("dc gva, %0" : : "r"(ptr) : "memory");
+          ptr += g_mte_gva_size;
+        }
+    }
+
+  /* Two granules at a time for the rest */
+
+  while (end - ptr >= 2 * MTE_MM_AILGN)
+    {
+      asm("st2g %0, [%0]" : : "r"(ptr) : "memory");
+      ptr += 2 * MTE_MM_AILGN;
+    }
+
+  if (ptr < end)
+    {
+      asm("stg %0, [%0]" : : "r"(ptr) : "memory");
     }
 }
 
@@ -174,4 +226,12 @@ void arm64_mte_init(void)
 
   write_sysreg(0, tfsr_el1);
   write_sysreg(0, tfsre0_el1);
+
+  /* Tag large ranges with DC GVA if it isn't prohibited */
+
+  val = read_sysreg(dczid_el0);
+  if (!(val & DCZID_DZP_BIT))
+    {
+      g_mte_gva_size = 4 << (val & DCZID_BS_MASK);
+    }
 }
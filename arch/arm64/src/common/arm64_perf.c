@@ -25,9 +25,25 @@
  ****************************************************************************/
 
 #include <nuttx/clock.h>
+#include <nuttx/perf_event.h>
+
+#include <errno.h>
 
 #include "arm64_pmu.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The ARMv8 common architectural and microarchitectural events */
+
+#define ARMV8_EVENT_L1D_CACHE_REFILL  0x03
+#define ARMV8_EVENT_L1D_CACHE         0x04
+#define ARMV8_EVENT_INST_RETIRED      0x08
+#define ARMV8_EVENT_BR_MIS_PRED       0x10
+#define ARMV8_EVENT_CPU_CYCLES        0x11
+#define ARMV8_EVENT_BR_RETIRED        0x21
+
 #ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
 
 #  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
@@ -73,6 +89,59 @@ void up_perf_convert(clock_t elapsed, struct timespec *ts)
   left        = elapsed - ts->tv_sec * g_cpu_freq;
   ts->tv_nsec = NSEC_PER_SEC * left / g_cpu_freq;
 }
+
+#ifdef CONFIG_ARCH_HAVE_PMU_EVENTS
+int up_pmu_ncounters(void)
+{
+  return pmu_get_ncntr();
+}
+
+int up_pmu_event(int event)
+{
+  switch (event)
+    {
+      case PERF_COUNT_HW_CPU_CYCLES:
+        return ARMV8_EVENT_CPU_CYCLES;
+
+      case PERF_COUNT_HW_INSTRUCTIONS:
+        return ARMV8_EVENT_INST_RETIRED;
+
+      case PERF_COUNT_HW_CACHE_REFERENCES:
+        return ARMV8_EVENT_L1D_CACHE;
+
+      case PERF_COUNT_HW_CACHE_MISSES:
+        return ARMV8_EVENT_L1D_CACHE_REFILL;
+
+      case PERF_COUNT_HW_BRANCH_INSTRUCTIONS:
+        return ARMV8_EVENT_BR_RETIRED;
+
+      case PERF_COUNT_HW_BRANCH_MISSES:
+        return ARMV8_EVENT_BR_MIS_PRED;
+
+      default:
+        return -ENOENT;
+    }
+}
+
+void up_pmu_start(int idx, uint32_t event)
+{
+  pmu_cntr_disable(1ul << idx);
+  pmu_evcntr_config(idx, event);
+  pmu_set_evcntr(idx, 0);
+  pmu_cntr_enable(1ul << idx);
+}
+
+uint64_t up_pmu_stop(int idx)
+{
+  pmu_cntr_disable(1ul << idx);
+  return pmu_get_evcntr(idx);
+}
+
+uint64_t up_pmu_read(int idx)
+{
+  return pmu_get_evcntr(idx);
+}
+#endif
 #  endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
 
 clock_t up_perf_gettime(void)
@@ -56,6 +56,8 @@
 
 /* PMCR_EL0 */
 
+#define PMCR_EL0_N_SHIFT         11           /* Number of event counters */
+#define PMCR_EL0_N_MASK          (0x1ful << PMCR_EL0_N_SHIFT)
 #define PMCR_EL0_LC              (1ul << 6)   /* Long cycle counter enable */
 #define PMCR_EL0_DP              (1ul << 5)   /* Disable cycle counter when event counting is prohibited */
 #define PMCR_EL0_X               (1ul << 4)   /* Enable export of events */
@@ -269,6 +271,84 @@ static inline void pmu_cntr_irq_disable(uint64_t mask)
   write_sysreg(mask, pmintenclr_el1);
 }
 
+/****************************************************************************
+ * Name: pmu_cntr_disable
+ *
+ * Description:
+ *   Disable counters.
+ *
+ * Parameters:
+ *   mask - Counters to disable.
+ *
+ ****************************************************************************/
+
+static inline void pmu_cntr_disable(uint64_t mask)
+{
+  write_sysreg(mask, pmcntenclr_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_get_ncntr
+ *
+ * Description:
+ *   Get the number of event counters, the cycle counter excluded.
+ *
+ ****************************************************************************/
+
+static inline int pmu_get_ncntr(void)
+{
+  return (read_sysreg(pmcr_el0) & PMCR_EL0_N_MASK) >> PMCR_EL0_N_SHIFT;
+}
+
+/****************************************************************************
+ * Name: pmu_evcntr_config
+ *
+ * Description:
+ *   Select the event counted by an event counter.
+ *
+ * Parameters:
+ *   idx   - The event counter.
+ *   event - The event number, counted at EL0 and EL1.
+ *
+ ****************************************************************************/
+
+static inline void pmu_evcntr_config(int idx, uint64_t event)
+{
+  pmu_cntr_select(idx);
+  UP_ISB();
+  write_sysreg(event, pmxevtyper_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_get_evcntr
+ *
+ * Description:
+ *   Read an event counter.
+ *
+ ****************************************************************************/
+
+static inline uint64_t pmu_get_evcntr(int idx)
+{
+  pmu_cntr_select(idx);
+  UP_ISB();
+  return read_sysreg(pmxevcntr_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_set_evcntr
+ *
+ * Description:
+ *   Write an event counter.
+ *
+ ****************************************************************************/
+
+static inline void pmu_set_evcntr(int idx, uint64_t value)
+{
+  pmu_cntr_select(idx);
+  UP_ISB();
+  write_sysreg(value, pmxevcntr_el0);
+}
+
 #ifdef CONFIG_ARCH_CLUSTER_PMU
 
 /****************************************************************************
@@ -28,6 +28,8 @@
 #include <nuttx/power/pm.h>
 #include <stdbool.h>
 
+#include "arm64_internal.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -77,7 +79,10 @@ static bool pm_idle_handler(int cpu,
 
         /* do no cross-core relative operations */
 
-        asm("WFI");
+        if (!arm64_idle_poll())
+          {
+            asm("WFI");
+          }
 
         first = pm_idle_lock(cpu);
         if (first)
@@ -105,7 +110,10 @@ static void pm_idle_handler(enum pm_state_e state)
   switch (state)
     {
       default:
-        asm("WFI");
+        if (!arm64_idle_poll())
+          {
+            asm("WFI");
+          }
         break;
     }
 }
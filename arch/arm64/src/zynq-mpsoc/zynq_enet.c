@@ -1488,7 +1488,7 @@ static void zynq_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   isr = zynq_getreg(priv, ZYNQ_GMAC_ISR);
   rsr = zynq_getreg(priv, ZYNQ_GMAC_RSR);
   tsr = zynq_getreg(priv, ZYNQ_GMAC_TSR);
@@ -1670,7 +1670,7 @@ static void zynq_interrupt_work(void *arg)
     }
 #endif
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* EMAC Errata section 41.3.1 */
 
@@ -1769,14 +1769,14 @@ static void zynq_txtimeout_work(void *arg)
 
   /* Reset the hardware.  Just take the interface down, then back up again. */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   zynq_ifdown(&priv->dev);
   zynq_ifup(&priv->dev);
 
   /* Then poll the network for new XMIT data */
 
   zynq_dopoll(priv);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1954,7 +1954,7 @@ static void zynq_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->ifup)
     {
       /* Poll the network for new XMIT data */
@@ -1962,7 +1962,7 @@ static void zynq_txavail_work(void *arg)
       zynq_dopoll(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -135,6 +135,14 @@ struct arch_addrenv_s
   uintptr_t heapvbase;
   size_t    heapsize;
 
+#ifdef CONFIG_ARCH_ADDRENV_LAZY_HEAP
+  /* The end of the heap reserved by create and sbrk(), the pages below it
+   * are allocated on first access.
+   */
+
+  uintptr_t heapend;
+#endif
+
   /* The page directory root (satp) value */
 
   uintptr_t satp;
@@ -317,6 +317,51 @@ static int create_region(arch_addrenv_t *addrenv, uintptr_t vaddr,
   return npages;
 }
 
+/****************************************************************************
+ * Name: reserve_region
+ *
+ * Description:
+ *   Like create_region(), but only allocate the final level page tables.
+ *   The region memory is committed by the page fault handler on the first
+ *   access to each page.
+ *
+ * Input Parameters:
+ *   addrenv - Describes the address environment
+ *   vaddr - Base virtual address for the mapping
+ *   size - Size of the region in bytes
+ *
+ * Returned value:
+ *   Amount of pages reserved on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_LAZY_HEAP
+static int reserve_region(arch_addrenv_t *addrenv, uintptr_t vaddr,
+                          size_t size)
+{
+  uintptr_t vend = vaddr + MM_PGALIGNUP(size);
+
+  map_spgtables(addrenv, vaddr);
+
+  /* One final level table per ENTRIES_PER_PGT pages */
+
+  while (vaddr < vend)
+    {
+      if (!riscv_get_pgtable(addrenv, vaddr))
+        {
+          return -ENOMEM;
+        }
+
+      vaddr = (vaddr + ENTRIES_PER_PGT * MM_PGSIZE) &
+              ~(ENTRIES_PER_PGT * MM_PGSIZE - 1);
+    }
+
+  UP_DMB();
+
+  return MM_NPAGES(size);
+}
+#endif
+
 /****************************************************************************
  * Name: vaddr_is_shm
  *
@@ -457,7 +502,12 @@ int up_addrenv_create(size_t textsize, size_t datasize, size_t heapsize,
       goto errout;
     }
 
+#ifdef CONFIG_ARCH_ADDRENV_LAZY_HEAP
+  ret = reserve_region(addrenv, heapbase, heapsize);
+  addrenv->heapend = heapbase + MM_PGALIGNUP(heapsize);
+#else
   ret = create_region(addrenv, heapbase, heapsize, MMU_UDATA_FLAGS);
+#endif
 
   if (ret < 0)
     {
@@ -32,15 +32,19 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
-#ifdef CONFIG_PAGING
+#if defined(CONFIG_PAGING) || defined(CONFIG_ARCH_ADDRENV_LAZY_HEAP)
 #  include <nuttx/pgalloc.h>
 #endif
 
-#ifdef CONFIG_PAGING
+#if defined(CONFIG_PAGING) || defined(CONFIG_ARCH_ADDRENV_LAZY_HEAP)
 #  include "pgalloc.h"
 #  include "riscv_mmu.h"
 #endif
 
+#ifdef CONFIG_ARCH_ADDRENV_LAZY_HEAP
+#  include "addrenv.h"
+#endif
+
 #include "sched/sched.h"
 #include "riscv_internal.h"
 #include "chip.h"
@@ -248,6 +252,75 @@ int riscv_fillpage(int mcause, void *regs, void *args)
 }
 #endif /* CONFIG_PAGING */
 
+/****************************************************************************
+ * Name: riscv_heapfault
+ *
+ * Description:
+ *   Load and store page fault handler with CONFIG_ARCH_ADDRENV_LAZY_HEAP.
+ *   The first access to a reserved user heap page maps a zero filled page
+ *   there and retries the access.  Any other fault is passed on to
+ *   riscv_exception().
+ *
+ * Input Parameters:
+ *   mcause - The machine cause of the exception.
+ *   regs   - A pointer to the register state at the time of the exception.
+ *   args   - A pointer to any additional arguments.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_LAZY_HEAP
+int riscv_heapfault(int mcause, void *regs, void *args)
+{
+  struct tcb_s          *tcb = this_task();
+  struct arch_addrenv_s *addrenv;
+  uintptr_t              ptlast;
+  uintptr_t              paddr;
+  uintptr_t              vaddr;
+
+  if (tcb->addrenv_curr == NULL)
+    {
+      goto errout;
+    }
+
+  /* Only the reserved part of the heap is populated on demand */
+
+  addrenv = &tcb->addrenv_curr->addrenv;
+  vaddr   = MM_PGALIGNDOWN(READ_CSR(CSR_TVAL));
+  if (vaddr < addrenv->heapvbase || vaddr >= addrenv->heapend)
+    {
+      goto errout;
+    }
+
+  /* A valid entry means a permission fault, not a missing page */
+
+  ptlast = riscv_pgvaddr(riscv_get_pgtable(addrenv, vaddr));
+  if (!ptlast || mmu_ln_getentry(RV_MMU_PT_LEVELS, ptlast, vaddr) != 0)
+    {
+      goto errout;
+    }
+
+  paddr = mm_pgalloc(1);
+  if (!paddr)
+    {
+      goto errout;
+    }
+
+  /* Wipe the page, then map it and retry the faulting access */
+
+  riscv_pgwipe(paddr);
+  mmu_ln_setentry(RV_MMU_PT_LEVELS, ptlast, paddr, vaddr, MMU_UDATA_FLAGS);
+  mmu_invalidate_tlb_by_vaddr(vaddr);
+
+  return OK;
+
+errout:
+  return riscv_exception(mcause, regs, args);
+}
+#endif /* CONFIG_ARCH_ADDRENV_LAZY_HEAP */
+
 /****************************************************************************
  * Name: riscv_exception_attach
  *
@@ -292,9 +365,12 @@ void riscv_exception_attach(void)
 
   irq_attach(RISCV_IRQ_INSTRUCTIONPF, riscv_exception, NULL);
 
-#ifdef CONFIG_PAGING
+#if defined(CONFIG_PAGING)
   irq_attach(RISCV_IRQ_LOADPF, riscv_fillpage, NULL);
   irq_attach(RISCV_IRQ_STOREPF, riscv_fillpage, NULL);
+#elif defined(CONFIG_ARCH_ADDRENV_LAZY_HEAP)
+  irq_attach(RISCV_IRQ_LOADPF, riscv_heapfault, NULL);
+  irq_attach(RISCV_IRQ_STOREPF, riscv_heapfault, NULL);
 #else
   irq_attach(RISCV_IRQ_LOADPF, riscv_exception, NULL);
   irq_attach(RISCV_IRQ_STOREPF, riscv_exception, NULL);
@@ -100,7 +100,9 @@ uintptr_t pgalloc(uintptr_t brkaddr, unsigned int npages)
   struct tcb_s          *tcb = this_task();
   struct arch_addrenv_s *addrenv;
   uintptr_t              ptlast;
+#ifndef CONFIG_ARCH_ADDRENV_LAZY_HEAP
   uintptr_t              paddr;
+#endif
   uintptr_t              vaddr;
 
   DEBUGASSERT(tcb && tcb->addrenv_own);
@@ -138,6 +140,15 @@ uintptr_t pgalloc(uintptr_t brkaddr, unsigned int npages)
           return 0;
         }
 
+#ifdef CONFIG_ARCH_ADDRENV_LAZY_HEAP
+      /* The page is allocated by riscv_heapfault() on first access */
+
+      vaddr += MM_PGSIZE;
+      if (vaddr > addrenv->heapend)
+        {
+          addrenv->heapend = vaddr;
+        }
+#else
       /* Allocate physical memory for the new heap */
 
       paddr = mm_pgalloc(1);
@@ -154,6 +165,7 @@ uintptr_t pgalloc(uintptr_t brkaddr, unsigned int npages)
 
       mmu_ln_setentry(PGT_LAST, ptlast, paddr, vaddr, MMU_UDATA_FLAGS);
       vaddr += MM_PGSIZE;
+#endif
     }
 
   /* Flush the data cache, so the changes are committed to memory */
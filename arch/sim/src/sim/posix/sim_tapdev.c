@@ -65,6 +65,7 @@
 #include <sys/time.h>
 #include <sys/uio.h>
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -109,9 +110,14 @@ struct sel_arg_struct
 #ifdef TAPDEV_DEBUG
 static int  gdrop = 0;
 #endif
-static int  gtapdevfd[CONFIG_SIM_NETDEV_NUMBER] =
+/* The non-blocking file descriptors of the queues of the tap devices */
+
+static int  gtapdevfd[CONFIG_SIM_NETDEV_NUMBER][SIM_TAPDEV_NQUEUES] =
 {
-  [0 ... CONFIG_SIM_NETDEV_NUMBER - 1] = -1
+  [0 ... CONFIG_SIM_NETDEV_NUMBER - 1] =
+  {
+    [0 ... SIM_TAPDEV_NQUEUES - 1] = -1
+  }
 };
 static char gdevname[CONFIG_SIM_NETDEV_NUMBER][IFNAMSIZ];
 static void *g_priv[CONFIG_SIM_NETDEV_NUMBER];
@@ -183,43 +189,85 @@ static void set_macaddr(int devidx)
   sim_netdriver_setmacaddr(devidx, mac);
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
+/* Open a queue of the tap device ifname, or a new tap device if ifname is
+ * empty, and return its name in ifname.
+ */
 
-void sim_tapdev_init(int devidx, void *priv,
-                 void (*tx_done_intr_cb)(void *priv),
-                 void (*rx_ready_intr_cb)(void *priv))
+static int tapdev_open(char *ifname)
 {
   struct ifreq ifr;
   int tapdevfd;
   int ret;
-  int sockfd;
 
-  /* Open the tap device */
-
-  tapdevfd = open(DEVTAP, O_RDWR, 0644);
+  tapdevfd = open(DEVTAP, O_RDWR | O_NONBLOCK, 0644);
   if (tapdevfd < 0)
     {
-      syslog(LOG_ERR, "TAPDEV: open failed: %d\n", -tapdevfd);
-      return;
+      syslog(LOG_ERR, "TAPDEV: open failed: %d\n", -errno);
+      return -1;
     }
 
-  /* Configure the tap device */
-
   memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, ifname, IFNAMSIZ);
   ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+#if SIM_TAPDEV_NQUEUES > 1
+  ifr.ifr_flags |= IFF_MULTI_QUEUE;
+#endif
+
   ret = ioctl(tapdevfd, TUNSETIFF, (unsigned long) &ifr);
   if (ret < 0)
     {
-      syslog(LOG_ERR, "TAPDEV: ioctl failed: %d\n", -ret);
+      syslog(LOG_ERR, "TAPDEV: ioctl failed: %d\n", -errno);
       close(tapdevfd);
-      return;
+      return -1;
+    }
+
+  strncpy(ifname, ifr.ifr_name, IFNAMSIZ);
+  return tapdevfd;
+}
+
+static void tapdev_close(int *tapdevfd)
+{
+  int q;
+
+  for (q = 0; q < SIM_TAPDEV_NQUEUES; q++)
+    {
+      close(tapdevfd[q]);
     }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-  /* Save the tap device name */
+void sim_tapdev_init(int devidx, void *priv,
+                 void (*tx_done_intr_cb)(void *priv),
+                 void (*rx_ready_intr_cb)(void *priv))
+{
+  int tapdevfd[SIM_TAPDEV_NQUEUES];
+  struct ifreq ifr;
+  int ret;
+  int sockfd;
+  int q;
+
+  /* Open the tap device, and attach its other queues by its name.  The
+   * file descriptors are non-blocking so that a read doesn't need to
+   * check whether a packet is available first.
+   */
+
+  gdevname[devidx][0] = '\0';
+  for (q = 0; q < SIM_TAPDEV_NQUEUES; q++)
+    {
+      tapdevfd[q] = tapdev_open(gdevname[devidx]);
+      if (tapdevfd[q] < 0)
+        {
+          while (q-- > 0)
+            {
+              close(tapdevfd[q]);
+            }
 
-  strncpy(gdevname[devidx], ifr.ifr_name, IFNAMSIZ);
+          return;
+        }
+    }
 
   /* Get a socket with which to manipulate the tap device; the remaining
    * ioctl calls unfortunately won't work on the tap device fd.
@@ -229,7 +277,7 @@ void sim_tapdev_init(int devidx, void *priv,
   if (sockfd < 0)
     {
       syslog(LOG_ERR, "TAPDEV: Can't open socket: %d\n", -sockfd);
-      close(tapdevfd);
+      tapdev_close(tapdevfd);
       return;
     }
 
@@ -247,7 +295,7 @@ void sim_tapdev_init(int devidx, void *priv,
              "bridge %s): %d\n",
              gdevname[devidx], CONFIG_SIM_NET_BRIDGE_DEVICE, -ret);
       close(sockfd);
-      close(tapdevfd);
+      tapdev_close(tapdevfd);
       return;
     }
 #endif
@@ -261,7 +309,7 @@ void sim_tapdev_init(int devidx, void *priv,
       syslog(LOG_ERR, "TAPDEV: ioctl failed (can't set MTU "
                       "for %s): %d\n", gdevname[devidx], -ret);
       close(sockfd);
-      close(tapdevfd);
+      tapdev_close(tapdevfd);
       return;
     }
 
@@ -271,7 +319,7 @@ void sim_tapdev_init(int devidx, void *priv,
     {
       syslog(LOG_ERR, "TAPDEV: ioctl failed (can't get MTU "
              "from %s): %d\n", gdevname[devidx], -ret);
-      close(tapdevfd);
+      tapdev_close(tapdevfd);
       return;
     }
   else
@@ -279,7 +327,7 @@ void sim_tapdev_init(int devidx, void *priv,
       sim_netdriver_setmtu(devidx, ifr.ifr_mtu);
     }
 
-  gtapdevfd[devidx] = tapdevfd;
+  memcpy(gtapdevfd[devidx], tapdevfd, sizeof(tapdevfd));
   g_priv[devidx] = priv;
 
   /* Register the emulated TX done interrupt callback */
@@ -295,43 +343,66 @@ void sim_tapdev_init(int devidx, void *priv,
   set_macaddr(devidx);
 }
 
-int sim_tapdev_avail(int devidx)
+int sim_tapdev_avail_queue(int devidx, int queue)
 {
   struct timeval tv;
   fd_set fdset;
+  int maxfd = -1;
+  int q;
+
+  /* Check for data on the queue, or any queue if queue is negative */
+
+  FD_ZERO(&fdset);
+  for (q = 0; q < SIM_TAPDEV_NQUEUES; q++)
+    {
+      if ((queue < 0 || queue == q) && gtapdevfd[devidx][q] >= 0)
+        {
+          FD_SET(gtapdevfd[devidx][q], &fdset);
+          if (gtapdevfd[devidx][q] > maxfd)
+            {
+              maxfd = gtapdevfd[devidx][q];
+            }
+        }
+    }
 
   /* We can't do anything if we failed to open the tap device */
 
-  if (gtapdevfd[devidx] < 0)
+  if (maxfd < 0)
     {
       return 0;
     }
 
-  /* Wait for data on the tap device (or a timeout) */
-
   tv.tv_sec  = 0;
   tv.tv_usec = 0;
 
-  FD_ZERO(&fdset);
-  FD_SET(gtapdevfd[devidx], &fdset);
+  return select(maxfd + 1, &fdset, NULL, NULL, &tv) > 0;
+}
 
-  return select(gtapdevfd[devidx] + 1, &fdset, NULL, NULL, &tv) > 0;
+int sim_tapdev_avail(int devidx)
+{
+  return sim_tapdev_avail_queue(devidx, -1);
 }
 
-unsigned int sim_tapdev_read(int devidx, unsigned char *buf,
-                             unsigned int buflen)
+unsigned int sim_tapdev_read_queue(int devidx, int queue,
+                                   unsigned char *buf, unsigned int buflen)
 {
   int ret;
 
-  if (!sim_tapdev_avail(devidx))
+  if (gtapdevfd[devidx][queue] < 0)
     {
       return 0;
     }
 
-  ret = read(gtapdevfd[devidx], buf, buflen);
+  /* The read doesn't block, it fails with EAGAIN if the queue is empty */
+
+  ret = read(gtapdevfd[devidx][queue], buf, buflen);
   if (ret < 0)
     {
-      syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -ret);
+      if (errno != EAGAIN)
+        {
+          syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -errno);
+        }
+
       return 0;
     }
 
@@ -339,11 +410,18 @@ unsigned int sim_tapdev_read(int devidx, unsigned char *buf,
   return ret;
 }
 
-void sim_tapdev_send(int devidx, unsigned char *buf, unsigned int buflen)
+unsigned int sim_tapdev_read(int devidx, unsigned char *buf,
+                             unsigned int buflen)
+{
+  return sim_tapdev_read_queue(devidx, 0, buf, buflen);
+}
+
+void sim_tapdev_send_queue(int devidx, int queue, unsigned char *buf,
+                           unsigned int buflen)
 {
   int ret;
 
-  if (gtapdevfd[devidx] < 0)
+  if (gtapdevfd[devidx][queue] < 0)
     {
       return;
     }
@@ -359,10 +437,12 @@ void sim_tapdev_send(int devidx, unsigned char *buf, unsigned int buflen)
     }
 #endif
 
-  ret = write(gtapdevfd[devidx], buf, buflen);
-  if (ret < 0)
+  /* A full host queue drops the packet like a real link would */
+
+  ret = write(gtapdevfd[devidx][queue], buf, buflen);
+  if (ret < 0 && errno != EAGAIN)
     {
-      syslog(LOG_ERR, "TAPDEV: write failed: %d\n", -ret);
+      syslog(LOG_ERR, "TAPDEV: write failed: %d\n", -errno);
       exit(1);
     }
 
@@ -383,6 +463,11 @@ void sim_tapdev_send(int devidx, unsigned char *buf, unsigned int buflen)
     }
 }
 
+void sim_tapdev_send(int devidx, unsigned char *buf, unsigned int buflen)
+{
+  sim_tapdev_send_queue(devidx, 0, buf, buflen);
+}
+
 void sim_tapdev_ifup(int devidx, void *ifaddr)
 {
   struct ifreq ifr;
@@ -395,7 +480,7 @@ void sim_tapdev_ifup(int devidx, void *ifaddr)
 #  endif
 #endif
 
-  if (gtapdevfd[devidx] < 0)
+  if (gtapdevfd[devidx][0] < 0)
     {
       return;
     }
@@ -480,7 +565,7 @@ void sim_tapdev_ifdown(int devidx)
   int sockfd;
   int ret;
 
-  if (gtapdevfd[devidx] < 0)
+  if (gtapdevfd[devidx][0] < 0)
     {
       return;
     }
@@ -351,16 +351,37 @@ int sim_ajoy_initialize(void);
 /* sim_tapdev.c *************************************************************/
 
 #if defined(CONFIG_SIM_NETDEV_TAP) && !defined(__CYGWIN__)
+#  ifdef CONFIG_SIM_NETDEV_TAP_QUEUES
+#    define SIM_TAPDEV_NQUEUES CONFIG_SIM_NETDEV_TAP_QUEUES
+#  else
+#    define SIM_TAPDEV_NQUEUES 1
+#  endif
+
 void sim_tapdev_init(int devidx, void *priv,
                      void (*tx_done_intr_cb)(void *priv),
                      void (*rx_ready_intr_cb)(void *priv));
 int sim_tapdev_avail(int devidx);
+int sim_tapdev_avail_queue(int devidx, int queue);
 unsigned int sim_tapdev_read(int devidx, unsigned char *buf,
                              unsigned int buflen);
+unsigned int sim_tapdev_read_queue(int devidx, int queue,
+                                   unsigned char *buf, unsigned int buflen);
 void sim_tapdev_send(int devidx, unsigned char *buf, unsigned int buflen);
+void sim_tapdev_send_queue(int devidx, int queue, unsigned char *buf,
+                           unsigned int buflen);
 void sim_tapdev_ifup(int devidx, void *ifaddr);
 void sim_tapdev_ifdown(int devidx);
 
+/* The tap read doesn't block, it needn't check for a packet first */
+
+#  define SIM_NETDEV_NONBLOCK_READ
+#  define SIM_NETDEV_NQUEUES                  SIM_TAPDEV_NQUEUES
+#  define sim_netdev_avail_queue(idx,q)       sim_tapdev_avail_queue(idx,q)
+#  define sim_netdev_read_queue(idx,q,buf,buflen) \
+          sim_tapdev_read_queue(idx,q,buf,buflen)
+#  define sim_netdev_send_queue(idx,q,buf,buflen) \
+          sim_tapdev_send_queue(idx,q,buf,buflen)
+
 #  define sim_netdev_init(idx,priv,txcb,rxcb) sim_tapdev_init(idx,priv,txcb,rxcb)
 #  define sim_netdev_avail(idx)               sim_tapdev_avail(idx)
 #  define sim_netdev_read(idx,buf,buflen)     sim_tapdev_read(idx,buf,buflen)
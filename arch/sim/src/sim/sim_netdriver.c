@@ -66,6 +66,7 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
@@ -87,6 +88,21 @@
 #  define SIM_NETDEV_RECV_OFFLOAD
 #endif
 
+/* A multi queue TAP device spreads the received flows to its queues, each
+ * one is polled on the CPU of the queue.
+ */
+
+#if defined(SIM_NETDEV_NQUEUES) && SIM_NETDEV_NQUEUES > 1 && \
+    defined(CONFIG_NETDEV_RSS)
+#  define SIM_NETDEV_MULTIQUEUE
+#  define SIM_NETDEV_READ(i,q,b,l) sim_netdev_read_queue(i,q,b,l)
+#  define SIM_NETDEV_SEND(i,b,l)   sim_netdev_send_queue(i, \
+                                     this_cpu() % SIM_NETDEV_NQUEUES, b, l)
+#else
+#  define SIM_NETDEV_READ(i,q,b,l) sim_netdev_read(i,b,l)
+#  define SIM_NETDEV_SEND(i,b,l)   sim_netdev_send(i,b,l)
+#endif
+
 /* Get index / buffer from dev pointer. */
 
 #define DEVIDX(p) ((struct sim_netdev_s *)(p) - g_sim_dev)
@@ -117,6 +133,10 @@ struct sim_netdev_s
 
 static int netdriver_send(struct netdev_lowerhalf_s *dev, netpkt_t *pkt);
 static netpkt_t *netdriver_recv(struct netdev_lowerhalf_s *dev);
+#ifdef SIM_NETDEV_MULTIQUEUE
+static netpkt_t *netdriver_recv_queue(struct netdev_lowerhalf_s *dev,
+                                      int queue);
+#endif
 static int netdriver_ifup(struct netdev_lowerhalf_s *dev);
 static int netdriver_ifdown(struct netdev_lowerhalf_s *dev);
 #ifdef CONFIG_NET_MCASTGROUP
@@ -135,13 +155,16 @@ static int netdriver_rmmac(struct netdev_lowerhalf_s *dev,
 static struct sim_netdev_s g_sim_dev[CONFIG_SIM_NETDEV_NUMBER];
 static const struct netdev_ops_s g_ops =
 {
-  netdriver_ifup,   /* ifup */
-  netdriver_ifdown, /* ifdown */
-  netdriver_send,   /* transmit */
-  netdriver_recv    /* receive */
+  .ifup          = netdriver_ifup,
+  .ifdown        = netdriver_ifdown,
+  .transmit      = netdriver_send,
+  .receive       = netdriver_recv,
 #ifdef CONFIG_NET_MCASTGROUP
-  , netdriver_addmac,
-  netdriver_rmmac   /* addmac, rmmac */
+  .addmac        = netdriver_addmac,
+  .rmmac         = netdriver_rmmac,
+#endif
+#ifdef SIM_NETDEV_MULTIQUEUE
+  .receive_queue = netdriver_recv_queue,
 #endif
 };
 
@@ -156,56 +179,67 @@ static int netdriver_send(struct netdev_lowerhalf_s *dev, netpkt_t *pkt)
   if (netpkt_is_fragmented(pkt))
     {
       netpkt_copyout(dev, DEVBUF(dev), pkt, len, 0);
-      sim_netdev_send(DEVIDX(dev), DEVBUF(dev), len);
+      SIM_NETDEV_SEND(DEVIDX(dev), DEVBUF(dev), len);
     }
   else
     {
-      sim_netdev_send(DEVIDX(dev), netpkt_getdata(dev, pkt), len);
+      SIM_NETDEV_SEND(DEVIDX(dev), netpkt_getdata(dev, pkt), len);
     }
 
   netpkt_free(dev, pkt, NETPKT_TX);
   return OK;
 }
 
-static netpkt_t *netdriver_recv(struct netdev_lowerhalf_s *dev)
+static netpkt_t *netdriver_recv_queue(struct netdev_lowerhalf_s *dev,
+                                      int queue)
 {
-  netpkt_t *pkt = NULL;
+  netpkt_t *pkt;
   unsigned int len;
 
-  if (sim_netdev_avail(DEVIDX(dev)))
+#ifndef SIM_NETDEV_NONBLOCK_READ
+  if (!sim_netdev_avail(DEVIDX(dev)))
     {
-      pkt = netpkt_alloc(dev, NETPKT_RX);
-      if (pkt == NULL)
-        {
-          return NULL;
-        }
+      return NULL;
+    }
+#endif
 
-      /* sim_netdev_read will return 0 on a timeout event and > 0
-       * on a data received event
-       */
+  pkt = netpkt_alloc(dev, NETPKT_RX);
+  if (pkt == NULL)
+    {
+      return NULL;
+    }
+
+  /* SIM_NETDEV_READ will return 0 if there is no packet and > 0
+   * on a data received event
+   */
 
 #ifdef SIM_NETDEV_RECV_OFFLOAD
-      len = sim_netdev_read(DEVIDX(dev), netpkt_getdata(dev, pkt),
-                            SIM_NETDEV_BUFSIZE);
+  len = SIM_NETDEV_READ(DEVIDX(dev), queue, netpkt_getdata(dev, pkt),
+                        SIM_NETDEV_BUFSIZE);
 #else
-      len = sim_netdev_read(DEVIDX(dev), DEVBUF(dev), SIM_NETDEV_BUFSIZE);
+  len = SIM_NETDEV_READ(DEVIDX(dev), queue, DEVBUF(dev),
+                        SIM_NETDEV_BUFSIZE);
 #endif
-      if (len == 0)
-        {
-          netpkt_free(dev, pkt, NETPKT_RX);
-          return NULL;
-        }
+  if (len == 0)
+    {
+      netpkt_free(dev, pkt, NETPKT_RX);
+      return NULL;
+    }
 
 #ifdef SIM_NETDEV_RECV_OFFLOAD
-      netpkt_setdatalen(dev, pkt, len);
+  netpkt_setdatalen(dev, pkt, len);
 #else
-      netpkt_copyin(dev, pkt, DEVBUF(dev), len, 0);
+  netpkt_copyin(dev, pkt, DEVBUF(dev), len, 0);
 #endif
-    }
 
   return pkt;
 }
 
+static netpkt_t *netdriver_recv(struct netdev_lowerhalf_s *dev)
+{
+  return netdriver_recv_queue(dev, 0);
+}
+
 static int netdriver_ifup(struct netdev_lowerhalf_s *dev)
 {
 #ifdef CONFIG_NET_IPv4
@@ -268,15 +302,32 @@ static void netdriver_rxready_interrupt(void *priv)
   netdev_lower_rxready(dev);
 }
 
-static void sim_netdev_work(void *arg)
+static void netdriver_rxpoll(struct netdev_lowerhalf_s *dev)
 {
-  struct sim_netdev_s *priv = (struct sim_netdev_s *)arg;
-  struct netdev_lowerhalf_s *dev = (struct netdev_lowerhalf_s *)&priv->dev;
+#ifdef SIM_NETDEV_MULTIQUEUE
+  int queue;
 
+  for (queue = 0; queue < SIM_NETDEV_NQUEUES; queue++)
+    {
+      if (sim_netdev_avail_queue(DEVIDX(dev), queue))
+        {
+          netdev_lower_rxqueue_ready(dev, queue);
+        }
+    }
+#else
   if (sim_netdev_avail(DEVIDX(dev)))
     {
       netdev_lower_rxready(dev);
     }
+#endif
+}
+
+static void sim_netdev_work(void *arg)
+{
+  struct sim_netdev_s *priv = (struct sim_netdev_s *)arg;
+  struct netdev_lowerhalf_s *dev = (struct netdev_lowerhalf_s *)&priv->dev;
+
+  netdriver_rxpoll(dev);
 
   work_queue_next_wq(g_work_queue, &priv->work, sim_netdev_work, arg,
                      SIM_NETDEV_PERIOD);
@@ -301,11 +352,18 @@ int sim_netdriver_init(void)
                       netdriver_txdone_interrupt,
                       netdriver_rxready_interrupt);
 
-      /* 1TX + 1RX is enough for sim. */
+      /* The upper half polls every available packet in a batch, the
+       * quota only bounds the packets held at the same time, like the
+       * segments coalesced by GRO.
+       */
 
-      dev->quota[NETPKT_TX] = 1;
-      dev->quota[NETPKT_RX] = 1;
+      dev->quota[NETPKT_TX] = CONFIG_SIM_NETDEV_BATCH;
+      dev->quota[NETPKT_RX] = CONFIG_SIM_NETDEV_BATCH;
       dev->ops              = &g_ops;
+#ifdef SIM_NETDEV_MULTIQUEUE
+      dev->rxqnum           = SIM_NETDEV_NQUEUES;
+      dev->rxtype           = NETDEV_RX_THREAD_RSS;
+#endif
 
 #if CONFIG_SIM_WIFIDEV_NUMBER != 0
       if (devidx < CONFIG_SIM_WIFIDEV_NUMBER)
@@ -355,9 +413,6 @@ void sim_netdriver_loop(void)
   int devidx;
   for (devidx = 0; devidx < CONFIG_SIM_NETDEV_NUMBER; devidx++)
     {
-      if (sim_netdev_avail(devidx))
-        {
-          netdev_lower_rxready(IDXDEV(devidx));
-        }
+      netdriver_rxpoll(IDXDEV(devidx));
     }
 }
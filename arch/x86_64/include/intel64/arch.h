@@ -218,6 +218,7 @@
 #define X86_64_CPUID_VENDOR            0x00
 #define X86_64_CPUID_CAP               0x01
 #  define X86_64_CPUID_01_SSE3         (1 << 0)
+#  define X86_64_CPUID_01_PCLMUL       (1 << 1)
 #  define X86_64_CPUID_01_SSSE3        (1 << 9)
 #  define X86_64_CPUID_01_FMA          (1 << 12)
 #  define X86_64_CPUID_01_PCID         (1 << 17)
@@ -225,6 +226,7 @@
 #  define X86_64_CPUID_01_SSE42        (1 << 20)
 #  define X86_64_CPUID_01_X2APIC       (1 << 21)
 #  define X86_64_CPUID_01_TSCDEA       (1 << 24)
+#  define X86_64_CPUID_01_AES          (1 << 25)
 #  define X86_64_CPUID_01_XSAVE        (1 << 26)
 #  define X86_64_CPUID_01_AVX          (1 << 28)
 #  define X86_64_CPUID_01_RDRAND       (1 << 30)
@@ -239,6 +241,7 @@
 #  define X86_64_CPUID_07_AVX512PF     (1 << 26)
 #  define X86_64_CPUID_07_AVX512ER     (1 << 27)
 #  define X86_64_CPUID_07_AVX512CD     (1 << 28)
+#  define X86_64_CPUID_07_SHA          (1 << 29)
 #  define X86_64_CPUID_07_AVX512BW     (1 << 30)
 #  define X86_64_CPUID_07_AVX512VL     (1 << 31)
 #define X86_64_CPUID_XSAVE             0x0d
@@ -59,6 +59,8 @@
  *
  */
 
+#define UP_RELAX() __asm__ __volatile__ ("pause" : : : "memory")
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
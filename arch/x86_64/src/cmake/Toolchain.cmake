@@ -181,6 +181,18 @@ if(CONFIG_ARCH_X86_64_SSE42)
   add_compile_options(-msse4.2)
 endif()
 
+if(CONFIG_ARCH_X86_64_PCLMUL)
+  add_compile_options(-mpclmul)
+endif()
+
+if(CONFIG_ARCH_X86_64_AESNI)
+  add_compile_options(-maes)
+endif()
+
+if(CONFIG_ARCH_X86_64_SHANI)
+  add_compile_options(-msha)
+endif()
+
 if(CONFIG_ARCH_X86_64_SSE4A)
   add_compile_options(-msse4a)
 endif()
@@ -98,6 +98,18 @@ void x86_64_check_and_enable_capability(void)
   require |= X86_64_CPUID_01_SSE42;
 #endif
 
+  /* Check PCLMULQDQ instruction availability */
+
+#ifdef CONFIG_ARCH_X86_64_PCLMUL
+  require |= X86_64_CPUID_01_PCLMUL;
+#endif
+
+  /* Check AES-NI instructions availability */
+
+#ifdef CONFIG_ARCH_X86_64_AESNI
+  require |= X86_64_CPUID_01_AES;
+#endif
+
   /* Check x2APIC availability */
 
   require |= X86_64_CPUID_01_X2APIC;
@@ -152,6 +164,12 @@ void x86_64_check_and_enable_capability(void)
   require |= X86_64_CPUID_07_CLWB;
 #endif
 
+  /* Check SHA extensions availability */
+
+#ifdef CONFIG_ARCH_X86_64_SHANI
+  require |= X86_64_CPUID_07_SHA;
+#endif
+
   __asm__ volatile("cpuid" : "=b" (ebx) : "a" (X86_64_CPUID_EXTCAP), "c" (0)
                    : "rdx", "memory");
 
@@ -37,9 +37,11 @@
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
+#include <poll.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mqueue.h>
+#include <nuttx/mm/map.h>
 #include <nuttx/arch.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/audio/audio.h>
@@ -78,6 +80,19 @@ struct audio_upperhalf_s
   mutex_t           lock;             /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   struct file      *usermq;           /* User mode app's message queue */
+
+#ifdef CONFIG_AUDIO_RING
+  /* State of the mmap() ring set up by AUDIOIOC_RINGSETUP */
+
+  FAR struct ap_buffer_s **ring;      /* The period buffers */
+  FAR uint8_t      *ringbase;         /* Start of the contiguous samples */
+  bool              ringowned;        /* ringbase allocated here */
+  apb_samp_t        nperiods;         /* Number of periods in the ring */
+  apb_samp_t        period_bytes;     /* Size of each period */
+  uint32_t          appl;             /* Periods handed to the device */
+  volatile uint32_t hw;               /* Periods returned by the device */
+  FAR struct pollfd *fds[CONFIG_AUDIO_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -95,6 +110,13 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+#ifdef CONFIG_AUDIO_RING
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+static int      audio_poll(FAR struct file *filep,
+                           FAR struct pollfd *fds,
+                           bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -123,12 +145,340 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_RING
+  audio_mmap,  /* mmap */
+  NULL,        /* truncate */
+  audio_poll,  /* poll */
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_AUDIO_RING
+/****************************************************************************
+ * Name: audio_ring_free
+ *
+ * Description:
+ *   Release the period buffers of the mmap() ring.  The device must not own
+ *   any of them, i.e. it is stopped or shut down.
+ *
+ ****************************************************************************/
+
+static void audio_ring_free(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  struct audio_buf_desc_s bufdesc;
+  int i;
+
+  if (upper->ring == NULL)
+    {
+      return;
+    }
+
+  for (i = upper->nperiods - 1; i >= 0; i--)
+    {
+      FAR struct ap_buffer_s *apb = upper->ring[i];
+
+      if (apb == NULL)
+        {
+          continue;
+        }
+
+      if (!upper->ringowned && lower->ops->freebuffer != NULL)
+        {
+          memset(&bufdesc, 0, sizeof(bufdesc));
+          bufdesc.u.buffer = apb;
+          lower->ops->freebuffer(lower, &bufdesc);
+        }
+      else if (!upper->ringowned)
+        {
+          apb_free(apb);
+        }
+      else
+        {
+          nxmutex_destroy(&apb->lock);
+          kumm_free(apb);
+        }
+    }
+
+  if (upper->ringowned)
+    {
+      kumm_free(upper->ringbase);
+    }
+
+  kmm_free(upper->ring);
+  upper->ring         = NULL;
+  upper->ringbase     = NULL;
+  upper->ringowned    = false;
+  upper->nperiods     = 0;
+  upper->period_bytes = 0;
+}
+
+/****************************************************************************
+ * Name: audio_ring_setup
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGSETUP ioctl command.  A lower half that
+ *   allocates its own buffers (for DMA) must hand out contiguous periods so
+ *   that the ring can be mapped in one piece; audio_dma does.  Otherwise the
+ *   ring is carved out of one user heap allocation here.
+ *
+ ****************************************************************************/
+
+static int audio_ring_setup(FAR struct audio_upperhalf_s *upper,
+                            FAR const struct audio_ring_desc_s *desc)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  struct audio_buf_desc_s bufdesc;
+  int ret = OK;
+  int i;
+
+  if (upper->started)
+    {
+      return -EBUSY;
+    }
+
+  audio_ring_free(upper);
+
+  if (desc->nperiods == 0)
+    {
+      return OK;
+    }
+
+  if (desc->period_bytes == 0)
+    {
+      return -EINVAL;
+    }
+
+  upper->ring = kmm_zalloc(desc->nperiods *
+                           sizeof(FAR struct ap_buffer_s *));
+  if (upper->ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->nperiods     = desc->nperiods;
+  upper->period_bytes = desc->period_bytes;
+  upper->appl         = 0;
+  upper->hw           = 0;
+
+  if (lower->ops->allocbuffer != NULL)
+    {
+      for (i = 0; i < desc->nperiods; i++)
+        {
+          memset(&bufdesc, 0, sizeof(bufdesc));
+          bufdesc.numbytes  = desc->period_bytes;
+          bufdesc.u.pbuffer = &upper->ring[i];
+
+          ret = lower->ops->allocbuffer(lower, &bufdesc);
+          if (ret < 0)
+            {
+              upper->ring[i] = NULL;
+              goto errout;
+            }
+
+          if (upper->ring[i]->samp !=
+              upper->ring[0]->samp + i * desc->period_bytes)
+            {
+              ret = -ENOTSUP;
+              goto errout;
+            }
+        }
+
+      upper->ringbase = upper->ring[0]->samp;
+    }
+  else
+    {
+      upper->ringbase = kumm_memalign(sizeof(uintptr_t),
+                                      desc->nperiods * desc->period_bytes);
+      if (upper->ringbase == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      upper->ringowned = true;
+
+      for (i = 0; i < desc->nperiods; i++)
+        {
+          FAR struct ap_buffer_s *apb;
+
+          apb = kumm_zalloc(sizeof(struct ap_buffer_s));
+          if (apb == NULL)
+            {
+              ret = -ENOMEM;
+              goto errout;
+            }
+
+          apb->i.channels = 2;
+          apb->crefs      = 1;
+          apb->nmaxbytes  = desc->period_bytes;
+          apb->samp       = upper->ringbase + i * desc->period_bytes;
+          nxmutex_init(&apb->lock);
+
+          upper->ring[i] = apb;
+        }
+    }
+
+  return OK;
+
+errout:
+  audio_ring_free(upper);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_ring_commit
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGCOMMIT ioctl command: enqueue the next periods
+ *   of the ring and report the ring position.
+ *
+ ****************************************************************************/
+
+static int audio_ring_commit(FAR struct audio_upperhalf_s *upper,
+                             FAR struct audio_ring_pos_s *pos)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  uint32_t n;
+  int ret = OK;
+
+  if (upper->ring == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (upper->appl - upper->hw + pos->ncommit > upper->nperiods)
+    {
+      return -EINVAL;
+    }
+
+  for (n = 0; n < pos->ncommit; n++)
+    {
+      FAR struct ap_buffer_s *apb;
+
+      apb = upper->ring[upper->appl % upper->nperiods];
+      apb->nbytes  = upper->period_bytes;
+      apb->curbyte = 0;
+      apb->flags   = AUDIO_APB_RING;
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      upper->appl++;
+    }
+
+  pos->appl = upper->appl;
+  pos->hw   = upper->hw;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_ring_events
+ *
+ * Description:
+ *   Return the poll events: the application owns at least one period.
+ *
+ ****************************************************************************/
+
+static pollevent_t audio_ring_events(FAR struct audio_upperhalf_s *upper)
+{
+  if (upper->ring != NULL && upper->appl - upper->hw < upper->nperiods)
+    {
+      return POLLIN | POLLOUT;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: audio_mmap
+ ****************************************************************************/
+
+static int audio_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->ring == NULL || map->offset != 0 ||
+      map->length > upper->nperiods * upper->period_bytes)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      map->vaddr = upper->ringbase;
+    }
+
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_poll
+ ****************************************************************************/
+
+static int audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_AUDIO_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_AUDIO_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else
+        {
+          poll_notify(&fds, 1, audio_ring_events(upper));
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif /* CONFIG_AUDIO_RING */
+
 /****************************************************************************
  * Name: audio_open
  *
@@ -227,6 +577,10 @@ static int audio_close(FAR struct file *filep)
 
       lower->ops->shutdown(lower);
       upper->usermq = NULL;
+
+#ifdef CONFIG_AUDIO_RING
+      audio_ring_free(upper);
+#endif
     }
 
   ret = OK;
@@ -609,6 +963,36 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_AUDIO_RING
+      /* AUDIOIOC_RINGSETUP - Allocate or free the mmap() ring
+       *
+       *   ioctl argument:  pointer to an audio_ring_desc_s structure
+       */
+
+      case AUDIOIOC_RINGSETUP:
+        {
+          audinfo("AUDIOIOC_RINGSETUP\n");
+
+          ret = audio_ring_setup(upper,
+                  (FAR const struct audio_ring_desc_s *)((uintptr_t)arg));
+        }
+        break;
+
+      /* AUDIOIOC_RINGCOMMIT - Hand ring periods to the device
+       *
+       *   ioctl argument:  pointer to an audio_ring_pos_s structure
+       */
+
+      case AUDIOIOC_RINGCOMMIT:
+        {
+          audinfo("AUDIOIOC_RINGCOMMIT\n");
+
+          ret = audio_ring_commit(upper,
+                  (FAR struct audio_ring_pos_s *)((uintptr_t)arg));
+        }
+        break;
+#endif
+
       /* AUDIOIOC_RESERVE - Reserve a session with the driver
        *
        *   ioctl argument - pointer to receive the session context
@@ -711,6 +1095,18 @@ static inline void audio_dequeuebuffer(FAR struct audio_upperhalf_s *upper,
 
   audinfo("Entry\n");
 
+#ifdef CONFIG_AUDIO_RING
+  /* Ring periods are tracked by counter and wake up pollers instead */
+
+  if ((apb->flags & AUDIO_APB_RING) != 0)
+    {
+      upper->hw++;
+      poll_notify(upper->fds, CONFIG_AUDIO_NPOLLWAITERS,
+                  audio_ring_events(upper));
+      return;
+    }
+#endif
+
   /* Send a dequeue message to the user if a message queue is registered */
 
   if (upper->usermq != NULL)
@@ -0,0 +1,900 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define MIXER_WORK            HPWORK
+#else
+#  define MIXER_WORK            LPWORK
+#endif
+
+/* The output is always 16-bit stereo */
+
+#define MIXER_FRAMES            CONFIG_AUDIO_MIXER_PERIOD_FRAMES
+#define MIXER_PERIOD_BYTES      (MIXER_FRAMES * 2 * sizeof(int16_t))
+
+/* Resampling steps and stream gains are Q16 fixed point */
+
+#define MIXER_Q16               (1 << 16)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* One virtual output device */
+
+struct audio_mixer_stream_s
+{
+  /* This is our appearance to the upper half.  This *MUST* be the first
+   * element of the structure so that we can freely cast between types
+   * struct audio_lowerhalf and struct audio_mixer_stream_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer;
+  struct dq_queue_s pendq;      /* Buffers waiting to be mixed */
+  uint32_t          step;       /* Input frames per output frame (Q16) */
+  uint32_t          phase;      /* Fractional input position (Q16) */
+  int32_t           gain;       /* Volume (Q16) */
+  uint8_t           channels;   /* 1 or 2 */
+  bool              reserved;
+  bool              started;
+  bool              paused;
+};
+
+/* The mixer and the output device that it drives */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower;
+  mutex_t           lock;       /* Protects the streams and mixing */
+  spinlock_t        splock;     /* Protects freeq */
+  struct work_s     work;
+  struct dq_queue_s freeq;      /* Output buffers returned by the device */
+  bool              running;    /* The output device is started */
+  int               nactive;    /* Number of started streams */
+  int               nstreams;
+  int32_t           accum[MIXER_FRAMES * 2];
+  FAR struct ap_buffer_s *out[CONFIG_AUDIO_MIXER_NPERIODS];
+  struct audio_mixer_stream_s streams[1];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps);
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps);
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg);
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  audio_mixer_getcaps,       /* getcaps        */
+  audio_mixer_configure,     /* configure      */
+  audio_mixer_shutdown,      /* shutdown       */
+  audio_mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  audio_mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mixer_pause,         /* pause          */
+  audio_mixer_resume,        /* resume         */
+#endif
+  NULL,                      /* allocbuffer    */
+  NULL,                      /* freebuffer     */
+  audio_mixer_enqueuebuffer, /* enqueue_buffer */
+  NULL,                      /* cancel_buffer  */
+  audio_mixer_ioctl,         /* ioctl          */
+  NULL,                      /* read           */
+  NULL,                      /* write          */
+  audio_mixer_reserve,       /* reserve        */
+  audio_mixer_release        /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_retire
+ *
+ * Description:
+ *   Return a consumed stream buffer to the stream's upper half.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_retire(FAR struct audio_mixer_stream_s *stream,
+                               FAR struct ap_buffer_s *apb)
+{
+  bool final = (apb->flags & AUDIO_APB_FINAL) != 0;
+
+  dq_rem(&apb->dq_entry, &stream->pendq);
+  stream->export.upper(stream->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                       apb, OK);
+
+  if (final)
+    {
+      stream->export.upper(stream->export.priv, AUDIO_CALLBACK_COMPLETE,
+                           NULL, OK);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_copy
+ *
+ * Description:
+ *   Accumulate 'nframes' frames that need no resampling.  These loops have
+ *   no dependencies between iterations, so the compiler can vectorize them
+ *   (NEON, Helium, RVV, ...) when vectorization is enabled.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_copy(FAR int32_t *accum, FAR const int16_t *src,
+                             int nframes, uint8_t channels, int32_t gain)
+{
+  int i;
+
+  if (channels == 2)
+    {
+      for (i = 0; i < 2 * nframes; i++)
+        {
+          accum[i] += (src[i] * gain) >> 16;
+        }
+    }
+  else
+    {
+      for (i = 0; i < nframes; i++)
+        {
+          int32_t sample = (src[i] * gain) >> 16;
+
+          accum[2 * i]     += sample;
+          accum[2 * i + 1] += sample;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stream
+ *
+ * Description:
+ *   Accumulate one output period of a stream, resampling it by linear
+ *   interpolation if its rate differs from the output rate.  A stream that
+ *   runs out of data contributes silence for the rest of the period.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_stream(FAR struct audio_mixer_stream_s *stream,
+                               FAR int32_t *accum)
+{
+  uint32_t framebytes = stream->channels * sizeof(int16_t);
+  int n = 0;
+
+  while (n < MIXER_FRAMES)
+    {
+      FAR struct ap_buffer_s *apb;
+      FAR const int16_t *src;
+      uint32_t nframes;
+      uint32_t pos;
+
+      apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pendq);
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      nframes = apb->nbytes / framebytes;
+      pos     = apb->curbyte / framebytes;
+      if (pos >= nframes)
+        {
+          audio_mixer_retire(stream, apb);
+          continue;
+        }
+
+      src = (FAR const int16_t *)apb->samp;
+
+      if (stream->step == MIXER_Q16)
+        {
+          int count = MIN(MIXER_FRAMES - n, (int)(nframes - pos));
+
+          audio_mixer_copy(&accum[2 * n], &src[pos * stream->channels],
+                           count, stream->channels, stream->gain);
+          n   += count;
+          pos += count;
+        }
+      else
+        {
+          for (; n < MIXER_FRAMES && pos < nframes; n++)
+            {
+              uint32_t next = pos + 1 < nframes ? pos + 1 : pos;
+              int32_t frac = stream->phase;
+              int ch;
+
+              for (ch = 0; ch < 2; ch++)
+                {
+                  int c = stream->channels == 2 ? ch : 0;
+                  int32_t s0 = src[pos * stream->channels + c];
+                  int32_t s1 = src[next * stream->channels + c];
+                  int32_t s = s0 + (((s1 - s0) * frac) >> 16);
+
+                  accum[2 * n + ch] += (s * stream->gain) >> 16;
+                }
+
+              stream->phase += stream->step;
+              pos           += stream->phase >> 16;
+              stream->phase &= MIXER_Q16 - 1;
+            }
+        }
+
+      apb->curbyte = MIN(pos, nframes) * framebytes;
+      if (pos >= nframes)
+        {
+          audio_mixer_retire(stream, apb);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_fill
+ *
+ * Description:
+ *   Mix all started streams into an output buffer.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_fill(FAR struct audio_mixer_s *mixer,
+                             FAR struct ap_buffer_s *apb)
+{
+  FAR int16_t *dst = (FAR int16_t *)apb->samp;
+  int i;
+
+  memset(mixer->accum, 0, sizeof(mixer->accum));
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      FAR struct audio_mixer_stream_s *stream = &mixer->streams[i];
+
+      if (stream->started && !stream->paused)
+        {
+          audio_mixer_stream(stream, mixer->accum);
+        }
+    }
+
+  /* Saturate back to 16 bits */
+
+  for (i = 0; i < MIXER_FRAMES * 2; i++)
+    {
+      int32_t sample = mixer->accum[i];
+
+      dst[i] = sample > INT16_MAX ? INT16_MAX :
+               sample < INT16_MIN ? INT16_MIN : sample;
+    }
+
+  apb->i.channels = 2;
+  apb->nbytes     = MIXER_PERIOD_BYTES;
+  apb->curbyte    = 0;
+  apb->flags      = 0;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_worker
+ *
+ * Description:
+ *   Refill the output buffers returned by the device and queue them again.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  nxmutex_lock(&mixer->lock);
+
+  while (mixer->running)
+    {
+      flags = spin_lock_irqsave(&mixer->splock);
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      spin_unlock_irqrestore(&mixer->splock, flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      audio_mixer_fill(mixer, apb);
+      lower->ops->enqueuebuffer(lower, apb);
+    }
+
+  nxmutex_unlock(&mixer->lock);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   Callback from the output device.  May run in interrupt context.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  irqstate_t flags;
+
+  if (reason == AUDIO_CALLBACK_DEQUEUE && apb != NULL)
+    {
+      flags = spin_lock_irqsave(&mixer->splock);
+      dq_addlast(&apb->dq_entry, &mixer->freeq);
+      spin_unlock_irqrestore(&mixer->splock, flags);
+
+      if (mixer->running)
+        {
+          work_queue(MIXER_WORK, &mixer->work, audio_mixer_worker, mixer, 0);
+        }
+    }
+  else if (reason == AUDIO_CALLBACK_IOERR ||
+           reason == AUDIO_CALLBACK_UNDERRUN)
+    {
+      auderr("ERROR: output device reason %d status %d\n", reason, status);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_output_start
+ *
+ * Description:
+ *   Configure and start the output device when the first stream starts.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_output_start(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  struct audio_caps_s caps;
+  irqstate_t flags;
+  int ret;
+
+  memset(&caps, 0, sizeof(caps));
+  caps.ac_len            = sizeof(caps);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = 2;
+  caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_RATE & 0xffff;
+  caps.ac_controls.b[2]  = 16;
+  caps.ac_controls.b[3]  = CONFIG_AUDIO_MIXER_RATE >> 16;
+
+  ret = lower->ops->configure(lower, &caps);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Prime the device with every output buffer */
+
+  mixer->running = true;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&mixer->splock);
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      spin_unlock_irqrestore(&mixer->splock, flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      audio_mixer_fill(mixer, apb);
+      lower->ops->enqueuebuffer(lower, apb);
+    }
+
+  ret = lower->ops->start(lower);
+  if (ret < 0)
+    {
+      mixer->running = false;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_output_stop
+ *
+ * Description:
+ *   Stop the output device after the last stream stops.  The device hands
+ *   the output buffers back through the callback.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_output_stop(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+
+  mixer->running = false;
+  work_cancel(MIXER_WORK, &mixer->work);
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  lower->ops->stop(lower);
+#else
+  lower->ops->shutdown(lower);
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_flush
+ *
+ * Description:
+ *   Stop a stream and return all of its queued buffers.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_flush(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct ap_buffer_s *apb;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pendq)) != NULL)
+    {
+      dq_rem(&apb->dq_entry, &stream->pendq);
+      stream->export.upper(stream->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                           apb, OK);
+    }
+
+  stream->phase = 0;
+
+  if (stream->started)
+    {
+      stream->started = false;
+      stream->paused  = false;
+
+      if (--mixer->nactive == 0 && mixer->running)
+        {
+          audio_mixer_output_stop(mixer);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps && caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = 2;
+
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+            caps->ac_format.hw     = 1 << (AUDIO_FMT_PCM - 1);
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = 2;
+
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.hw[0] = AUDIO_SAMP_RATE_DEF_ALL;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ ****************************************************************************/
+
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  uint32_t samprate;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw != AUDIO_FU_VOLUME ||
+            caps->ac_controls.hw[0] > AUDIO_VOLUME_MAX)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        stream->gain = (int32_t)caps->ac_controls.hw[0] * MIXER_Q16 /
+                       AUDIO_VOLUME_MAX;
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0] |
+                   (caps->ac_controls.b[3] << 16);
+
+        if (caps->ac_channels < 1 || caps->ac_channels > 2 ||
+            (caps->ac_controls.b[2] != 0 && caps->ac_controls.b[2] != 16) ||
+            samprate == 0 || stream->started)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        stream->channels = caps->ac_channels;
+        stream->step     = (uint32_t)(((uint64_t)samprate << 16) /
+                                      CONFIG_AUDIO_MIXER_RATE);
+        stream->phase    = 0;
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  audio_mixer_flush(stream);
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ ****************************************************************************/
+
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  if (!stream->started)
+    {
+      stream->started = true;
+      stream->paused  = false;
+      mixer->nactive++;
+
+      if (!mixer->running)
+        {
+          ret = audio_mixer_output_start(mixer);
+          if (ret < 0)
+            {
+              stream->started = false;
+              mixer->nactive--;
+            }
+        }
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  audio_mixer_flush(stream);
+  nxmutex_unlock(&stream->mixer->lock);
+
+  stream->export.upper(stream->export.priv, AUDIO_CALLBACK_COMPLETE,
+                       NULL, OK);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_pause / audio_mixer_resume
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  stream->paused = true;
+  return OK;
+}
+
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  stream->paused = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  if (stream->channels == 0)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&stream->mixer->lock);
+  apb->curbyte = 0;
+  dq_addlast(&apb->dq_entry, &stream->pendq);
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve / audio_mixer_release
+ ****************************************************************************/
+
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  int ret = OK;
+
+  nxmutex_lock(&stream->mixer->lock);
+
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      stream->reserved = true;
+    }
+
+  nxmutex_unlock(&stream->mixer->lock);
+  return ret;
+}
+
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  stream->reserved = false;
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Put a mixer in front of an output device and register its streams.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name,
+                           FAR struct audio_lowerhalf_s *lower,
+                           int nstreams)
+{
+  FAR struct audio_mixer_s *mixer;
+  struct ap_buffer_info_s bufinfo;
+  struct audio_buf_desc_s bufdesc;
+  char devname[16];
+  int ret;
+  int i;
+
+  if (name == NULL || lower == NULL || nstreams <= 0)
+    {
+      return -EINVAL;
+    }
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s) +
+                     sizeof(struct audio_mixer_stream_s) * (nstreams - 1));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&mixer->lock);
+  spin_lock_init(&mixer->splock);
+  dq_init(&mixer->freeq);
+  mixer->lower    = lower;
+  mixer->nstreams = nstreams;
+  lower->upper    = audio_mixer_callback;
+  lower->priv     = mixer;
+
+  /* Drivers with their own buffers (audio_dma) must be told the size */
+
+  if (lower->ops->ioctl != NULL)
+    {
+      bufinfo.nbuffers    = CONFIG_AUDIO_MIXER_NPERIODS;
+      bufinfo.buffer_size = MIXER_PERIOD_BYTES;
+      lower->ops->ioctl(lower, AUDIOIOC_SETBUFFERINFO,
+                        (unsigned long)(uintptr_t)&bufinfo);
+    }
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NPERIODS; i++)
+    {
+      memset(&bufdesc, 0, sizeof(bufdesc));
+      bufdesc.numbytes  = MIXER_PERIOD_BYTES;
+      bufdesc.u.pbuffer = &mixer->out[i];
+
+      ret = lower->ops->allocbuffer != NULL ?
+            lower->ops->allocbuffer(lower, &bufdesc) : apb_alloc(&bufdesc);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      dq_addlast(&mixer->out[i]->dq_entry, &mixer->freeq);
+    }
+
+  for (i = 0; i < nstreams; i++)
+    {
+      FAR struct audio_mixer_stream_s *stream = &mixer->streams[i];
+
+      stream->export.ops = &g_audio_mixer_ops;
+      stream->mixer      = mixer;
+      stream->step       = MIXER_Q16;
+      stream->gain       = MIXER_Q16;
+      dq_init(&stream->pendq);
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &stream->export);
+      if (ret < 0)
+        {
+          auderr("ERROR: failed to register %s: %d\n", devname, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+
+errout:
+  while (--i >= 0)
+    {
+      memset(&bufdesc, 0, sizeof(bufdesc));
+      bufdesc.u.buffer = mixer->out[i];
+
+      if (lower->ops->freebuffer != NULL)
+        {
+          lower->ops->freebuffer(lower, &bufdesc);
+        }
+      else
+        {
+          apb_free(mixer->out[i]);
+        }
+    }
+
+  nxmutex_destroy(&mixer->lock);
+  kmm_free(mixer);
+  return ret;
+}
@@ -27,15 +27,20 @@
 #include <nuttx/config.h>
 
 #include <sys/param.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <stdint.h>
 #include <string.h>
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/addrenv.h>
 #include <nuttx/arch.h>
+#include <nuttx/atomic.h>
 #include <nuttx/binfmt/binfmt.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 
 #ifdef CONFIG_ELF
 
@@ -55,6 +60,55 @@
 #  define CONFIG_ELF_STACKSIZE 2048
 #endif
 
+#ifndef CONFIG_ELF_IMAGE_CACHE
+#  define CONFIG_ELF_IMAGE_CACHE 0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_ELF_IMAGE_CACHE > 0
+/* A loaded and relocated ELF image kept for the next exec of the file.
+ * Only one task at a time runs from an image, since the .data/.bss is
+ * shared; it is restored from dataimage before each run.
+ */
+
+struct elf_image_s
+{
+  FAR struct elf_image_s *flink;    /* The next image, most recent first */
+  FAR char              *path;      /* The file the image was loaded from */
+  ino_t                  ino;       /* The identity of the file, to detect */
+  off_t                  size;      /* ... that it was replaced */
+  time_t                 mtime;
+  struct module_s        mod;       /* The text and data allocations */
+  main_t                 entrypt;   /* The entry point of the image */
+  FAR void              *dataimage; /* The .data/.bss after relocation */
+  size_t                 datasize;
+#ifdef CONFIG_PIC
+  uintptr_t              gotaddr;   /* The GOT, 0 if there is none */
+#endif
+  bool                   busy;      /* A task runs from the image */
+};
+#endif
+
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+/* The text pages of a fully linked program, mapped into every process
+ * started from the file.  The entry holds one reference to the pages, so
+ * they are idle when that is the only one left.
+ */
+
+struct elf_text_s
+{
+  FAR struct elf_text_s     *flink; /* The next entry, most recent first */
+  FAR char                  *path;  /* The file the text was loaded from */
+  ino_t                      ino;   /* The identity of the file, to detect */
+  off_t                      size;  /* ... that it was replaced */
+  time_t                     mtime;
+  FAR struct addrenv_text_s *text;  /* The shared text pages */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -77,10 +131,493 @@ static struct binfmt_s g_elfbinfmt =
   elf_unloadbinary, /* unload */
 };
 
+#if CONFIG_ELF_IMAGE_CACHE > 0
+static FAR struct elf_image_s *g_elfimages;
+static int g_nelfimages;
+static mutex_t g_elfimagelock = NXMUTEX_INITIALIZER;
+#endif
+
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+static FAR struct elf_text_s *g_elftexts;
+static int g_nelftexts;
+static mutex_t g_elftextlock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#if CONFIG_ELF_IMAGE_CACHE > 0
+/****************************************************************************
+ * Name: elf_image_free
+ *
+ * Description:
+ *   Remove an idle image from the cache and free it.  The destructors
+ *   already ran when its last task exited.
+ *
+ ****************************************************************************/
+
+static void elf_image_free(FAR struct elf_image_s *image,
+                           FAR struct elf_image_s *prev)
+{
+  if (prev != NULL)
+    {
+      prev->flink = image->flink;
+    }
+  else
+    {
+      g_elfimages = image->flink;
+    }
+
+  g_nelfimages--;
+
+  image->mod.nfini = 0;
+  libelf_uninit(&image->mod);
+
+  kmm_free(image->dataimage);
+  kmm_free(image->path);
+  kmm_free(image);
+}
+
+/****************************************************************************
+ * Name: elf_image_load
+ *
+ * Description:
+ *   Set up binp from the cached image of filename, if there is an idle one
+ *   and the file did not change since it was loaded.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned if the
+ *   file must be loaded.
+ *
+ ****************************************************************************/
+
+static int elf_image_load(FAR struct binary_s *binp,
+                          FAR const char *filename)
+{
+  FAR struct elf_image_s *image;
+  FAR struct elf_image_s *prev = NULL;
+  struct stat buf;
+  int ret;
+
+  ret = nx_stat(filename, &buf, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxmutex_lock(&g_elfimagelock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (image = g_elfimages; image != NULL; image = image->flink)
+    {
+      if (strcmp(image->path, filename) == 0)
+        {
+          break;
+        }
+
+      prev = image;
+    }
+
+  if (image == NULL)
+    {
+      ret = -ENOENT;
+    }
+  else if (image->busy)
+    {
+      ret = -EBUSY;
+    }
+  else if (image->ino != buf.st_ino || image->size != buf.st_size ||
+           image->mtime != buf.st_mtime)
+    {
+      binfo("Dropping stale image of %s\n", filename);
+      elf_image_free(image, prev);
+      ret = -ESTALE;
+    }
+  else
+    {
+#ifdef CONFIG_PIC
+      if (image->gotaddr != 0)
+        {
+          FAR struct dspace_s *dspaces = kmm_zalloc(sizeof(struct dspace_s));
+
+          if (dspaces == NULL)
+            {
+              nxmutex_unlock(&g_elfimagelock);
+              return -ENOMEM;
+            }
+
+          dspaces->region = (FAR void *)image->gotaddr;
+          dspaces->crefs  = 1;
+          binp->picbase   = (FAR void *)dspaces;
+        }
+#endif
+
+      binfo("Reusing the image of %s\n", filename);
+
+      memcpy(image->mod.dataalloc, image->dataimage, image->datasize);
+      image->busy     = true;
+      binp->mod       = image->mod;
+      binp->entrypt   = image->entrypt;
+      binp->stacksize = CONFIG_ELF_STACKSIZE;
+#ifdef CONFIG_SCHED_USER_IDENTITY
+      binp->uid       = buf.st_uid;
+      binp->gid       = buf.st_gid;
+      binp->mode      = buf.st_mode;
+#endif
+
+      /* Keep the most recently used images first */
+
+      if (prev != NULL)
+        {
+          prev->flink  = image->flink;
+          image->flink = g_elfimages;
+          g_elfimages  = image;
+        }
+    }
+
+  nxmutex_unlock(&g_elfimagelock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: elf_image_insert
+ *
+ * Description:
+ *   Keep the image just loaded in binp for the next exec of filename.  The
+ *   least recently used idle image is dropped if the cache is full, and
+ *   nothing is cached if every image is in use.
+ *
+ ****************************************************************************/
+
+static void elf_image_insert(FAR struct binary_s *binp,
+                             FAR const char *filename,
+                             FAR struct mod_loadinfo_s *loadinfo)
+{
+  FAR struct elf_image_s *image;
+  FAR struct elf_image_s *prev;
+  FAR struct elf_image_s *victim = NULL;
+  FAR struct elf_image_s *vprev = NULL;
+  struct stat buf;
+#if CONFIG_LIBC_ELF_MAXDEPEND > 0
+  int i;
+
+  /* The image must not hold references on other modules while idle */
+
+  for (i = 0; i < CONFIG_LIBC_ELF_MAXDEPEND; i++)
+    {
+      if (binp->mod.dependencies[i] != NULL)
+        {
+          return;
+        }
+    }
+#endif
+
+  if (nx_stat(filename, &buf, 1) < 0 ||
+      nxmutex_lock(&g_elfimagelock) < 0)
+    {
+      return;
+    }
+
+  for (prev = NULL, image = g_elfimages; image != NULL;
+       prev = image, image = image->flink)
+    {
+      if (strcmp(image->path, filename) == 0)
+        {
+          goto out;
+        }
+
+      if (!image->busy)
+        {
+          victim = image;
+          vprev  = prev;
+        }
+    }
+
+  if (g_nelfimages >= CONFIG_ELF_IMAGE_CACHE)
+    {
+      if (victim == NULL)
+        {
+          goto out;
+        }
+
+      elf_image_free(victim, vprev);
+    }
+
+  image = kmm_zalloc(sizeof(struct elf_image_s));
+  if (image == NULL)
+    {
+      goto out;
+    }
+
+  image->path      = kmm_malloc(strlen(filename) + 1);
+  image->dataimage = kmm_malloc(loadinfo->datasize);
+  if (image->path == NULL ||
+      (image->dataimage == NULL && loadinfo->datasize > 0))
+    {
+      kmm_free(image->dataimage);
+      kmm_free(image->path);
+      kmm_free(image);
+      goto out;
+    }
+
+  strcpy(image->path, filename);
+  memcpy(image->dataimage, (FAR void *)loadinfo->datastart,
+         loadinfo->datasize);
+
+  image->ino      = buf.st_ino;
+  image->size     = buf.st_size;
+  image->mtime    = buf.st_mtime;
+  image->mod      = binp->mod;
+  image->entrypt  = binp->entrypt;
+  image->datasize = loadinfo->datasize;
+#ifdef CONFIG_PIC
+  if (loadinfo->gotindex >= 0)
+    {
+      image->gotaddr = loadinfo->shdr[loadinfo->gotindex].sh_addr;
+    }
+#endif
+
+  image->busy  = true;
+  image->flink = g_elfimages;
+  g_elfimages  = image;
+  g_nelfimages++;
+
+out:
+  nxmutex_unlock(&g_elfimagelock);
+}
+
+/****************************************************************************
+ * Name: elf_image_release
+ *
+ * Description:
+ *   Return the image binp runs from to the cache.
+ *
+ * Returned Value:
+ *   true if binp runs from a cached image, false if it must be unloaded.
+ *
+ ****************************************************************************/
+
+static bool elf_image_release(FAR struct binary_s *binp)
+{
+  FAR struct elf_image_s *image;
+  FAR void (**array)(void);
+  int i;
+
+  nxmutex_lock(&g_elfimagelock);
+  for (image = g_elfimages; image != NULL; image = image->flink)
+    {
+      if (image->busy && image->mod.textalloc == binp->mod.textalloc &&
+          image->mod.dataalloc == binp->mod.dataalloc)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_elfimagelock);
+  if (image == NULL)
+    {
+      return false;
+    }
+
+  /* Run the destructors, as libelf_uninit() does */
+
+  array = (FAR void (**)(void))binp->mod.finiarr;
+  for (i = 0; i < binp->mod.nfini; i++)
+    {
+      array[i]();
+    }
+
+  nxmutex_lock(&g_elfimagelock);
+  image->busy = false;
+  nxmutex_unlock(&g_elfimagelock);
+  return true;
+}
+#endif
+
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+/****************************************************************************
+ * Name: elf_text_free
+ *
+ * Description:
+ *   Remove an entry from the shared text cache and drop its reference to
+ *   the text pages.
+ *
+ ****************************************************************************/
+
+static void elf_text_free(FAR struct elf_text_s *entry,
+                          FAR struct elf_text_s *prev)
+{
+  if (prev != NULL)
+    {
+      prev->flink = entry->flink;
+    }
+  else
+    {
+      g_elftexts = entry->flink;
+    }
+
+  g_nelftexts--;
+
+  addrenv_text_release(entry->text);
+  kmm_free(entry->path);
+  kmm_free(entry);
+}
+
+/****************************************************************************
+ * Name: elf_text_find
+ *
+ * Description:
+ *   Find the shared text pages of filename, if the file did not change
+ *   since they were loaded.
+ *
+ * Returned Value:
+ *   The text pages with a reference taken for the caller, or NULL if the
+ *   text must be loaded.
+ *
+ ****************************************************************************/
+
+static FAR struct addrenv_text_s *elf_text_find(FAR const char *filename)
+{
+  FAR struct addrenv_text_s *text = NULL;
+  FAR struct elf_text_s *entry;
+  FAR struct elf_text_s *prev = NULL;
+  struct stat buf;
+
+  if (nx_stat(filename, &buf, 1) < 0 ||
+      nxmutex_lock(&g_elftextlock) < 0)
+    {
+      return NULL;
+    }
+
+  for (entry = g_elftexts; entry != NULL; entry = entry->flink)
+    {
+      if (strcmp(entry->path, filename) == 0)
+        {
+          break;
+        }
+
+      prev = entry;
+    }
+
+  if (entry != NULL)
+    {
+      if (entry->ino != buf.st_ino || entry->size != buf.st_size ||
+          entry->mtime != buf.st_mtime)
+        {
+          binfo("Dropping stale text of %s\n", filename);
+          elf_text_free(entry, prev);
+        }
+      else
+        {
+          binfo("Sharing the text of %s\n", filename);
+
+          text = entry->text;
+          atomic_fetch_add(&text->refs, 1);
+
+          /* Keep the most recently used entries first */
+
+          if (prev != NULL)
+            {
+              prev->flink  = entry->flink;
+              entry->flink = g_elftexts;
+              g_elftexts   = entry;
+            }
+        }
+    }
+
+  nxmutex_unlock(&g_elftextlock);
+  return text;
+}
+
+/****************************************************************************
+ * Name: elf_text_insert
+ *
+ * Description:
+ *   Make the text just loaded from filename shareable with the next
+ *   processes started from the file.  The least recently used idle entry
+ *   is dropped if the cache is full, and nothing is cached if every entry
+ *   is in use.
+ *
+ ****************************************************************************/
+
+static void elf_text_insert(FAR const char *filename,
+                            FAR struct mod_loadinfo_s *loadinfo)
+{
+  FAR struct elf_text_s *entry;
+  FAR struct elf_text_s *prev;
+  FAR struct elf_text_s *victim = NULL;
+  FAR struct elf_text_s *vprev = NULL;
+  struct stat buf;
+
+  if (nx_stat(filename, &buf, 1) < 0 ||
+      nxmutex_lock(&g_elftextlock) < 0)
+    {
+      return;
+    }
+
+  for (prev = NULL, entry = g_elftexts; entry != NULL;
+       prev = entry, entry = entry->flink)
+    {
+      if (strcmp(entry->path, filename) == 0)
+        {
+          goto out;
+        }
+
+      if (atomic_read(&entry->text->refs) == 1)
+        {
+          victim = entry;
+          vprev  = prev;
+        }
+    }
+
+  if (g_nelftexts >= CONFIG_ARCH_ADDRENV_SHARED_TEXT_NFILES)
+    {
+      if (victim == NULL)
+        {
+          goto out;
+        }
+
+      elf_text_free(victim, vprev);
+    }
+
+  entry = kmm_zalloc(sizeof(struct elf_text_s));
+  if (entry == NULL)
+    {
+      goto out;
+    }
+
+  entry->path = kmm_malloc(strlen(filename) + 1);
+  if (entry->path == NULL)
+    {
+      kmm_free(entry);
+      goto out;
+    }
+
+  entry->text = addrenv_text_create(loadinfo->addrenv, loadinfo->textsize);
+  if (entry->text == NULL)
+    {
+      kmm_free(entry->path);
+      kmm_free(entry);
+      goto out;
+    }
+
+  strcpy(entry->path, filename);
+  entry->ino   = buf.st_ino;
+  entry->size  = buf.st_size;
+  entry->mtime = buf.st_mtime;
+  entry->flink = g_elftexts;
+  g_elftexts   = entry;
+  g_nelftexts++;
+
+out:
+  nxmutex_unlock(&g_elftextlock);
+}
+#endif
+
 /****************************************************************************
  * Name: elf_loadbinary
  *
@@ -96,10 +633,22 @@ static int elf_loadbinary(FAR struct binary_s *binp,
                           int nexports)
 {
   struct mod_loadinfo_s loadinfo;
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+  FAR struct addrenv_text_s *text = NULL;
+#endif
   int ret;
 
   binfo("Loading file: %s\n", filename);
 
+#if CONFIG_ELF_IMAGE_CACHE > 0
+  /* Run from the image left by a previous exec of the file, if any */
+
+  if (elf_image_load(binp, filename) == OK)
+    {
+      return OK;
+    }
+#endif
+
   /* Initialize the ELF library to load the program binary. */
 
   ret = libelf_initialize(filename, &loadinfo);
@@ -110,6 +659,18 @@ static int elf_loadbinary(FAR struct binary_s *binp,
       goto errout_with_init;
     }
 
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+  /* A fully linked program has the same text in every process, so reuse
+   * the text pages of a process already started from the file.
+   */
+
+  if (loadinfo.ehdr.e_type == ET_EXEC)
+    {
+      text = elf_text_find(filename);
+      loadinfo.text = text;
+    }
+#endif
+
   /* Load the program binary */
 
   ret = libelf_load_with_addrenv(&loadinfo);
@@ -227,12 +788,38 @@ static int elf_loadbinary(FAR struct binary_s *binp,
     }
 #endif
 
+#if CONFIG_ELF_IMAGE_CACHE > 0
+  elf_image_insert(binp, filename, &loadinfo);
+#endif
+
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+  /* The text was not relocated, so later processes can share it */
+
+  if (loadinfo.ehdr.e_type == ET_EXEC && loadinfo.gotindex < 0 &&
+      loadinfo.text == NULL)
+    {
+      elf_text_insert(filename, &loadinfo);
+    }
+
+  if (text != NULL)
+    {
+      addrenv_text_release(text);
+    }
+#endif
+
   libelf_uninitialize(&loadinfo);
   return OK;
 
 errout_with_load:
   libelf_unload(&loadinfo);
 errout_with_init:
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+  if (text != NULL)
+    {
+      addrenv_text_release(text);
+    }
+#endif
+
   libelf_uninitialize(&loadinfo);
   return ret;
 }
@@ -248,6 +835,14 @@ errout_with_init:
 static int elf_unloadbinary(FAR struct binary_s *binp)
 {
   binfo("Unloading %p\n", binp);
+
+#if CONFIG_ELF_IMAGE_CACHE > 0
+  if (elf_image_release(binp))
+    {
+      return OK;
+    }
+#endif
+
   libelf_uninit(&binp->mod);
 
   return OK;
@@ -301,7 +896,45 @@ int elf_initialize(void)
 
 void elf_uninitialize(void)
 {
+#if CONFIG_ELF_IMAGE_CACHE > 0
+  FAR struct elf_image_s *image;
+  FAR struct elf_image_s *prev = NULL;
+  FAR struct elf_image_s *next;
+
+#endif
   unregister_binfmt(&g_elfbinfmt);
+
+#if CONFIG_ELF_IMAGE_CACHE > 0
+  /* Drop the idle images */
+
+  nxmutex_lock(&g_elfimagelock);
+  for (image = g_elfimages; image != NULL; image = next)
+    {
+      next = image->flink;
+      if (image->busy)
+        {
+          prev = image;
+        }
+      else
+        {
+          elf_image_free(image, prev);
+        }
+    }
+
+  nxmutex_unlock(&g_elfimagelock);
+#endif
+
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+  /* Drop the cached text, the pages stay mapped by running processes */
+
+  nxmutex_lock(&g_elftextlock);
+  while (g_elftexts != NULL)
+    {
+      elf_text_free(g_elftexts, NULL);
+    }
+
+  nxmutex_unlock(&g_elftextlock);
+#endif
 }
 
 #endif /* CONFIG_ELF */
@@ -137,6 +137,7 @@ static int csefree(FAR struct csession *);
 
 static int cryptodev_op(FAR struct csession *,
                         FAR struct crypt_op *);
+static int cryptodev_mop(FAR struct fcrypt *, FAR struct crypt_mop *);
 static int cryptodev_key(FAR struct fcrypt *, FAR struct crypt_kop *);
 static int cryptodevkey_cb(FAR struct cryptkop *);
 static int cryptodev_getkeystatus(FAR struct fcrypt *,
@@ -371,6 +372,9 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+      case CIOCNCRYPTM:
+        error = cryptodev_mop(fcr, (FAR struct crypt_mop *)arg);
+        break;
       case CIOCKEY:
         error = cryptodev_key(fcr, (FAR struct crypt_kop *)arg);
         break;
@@ -499,6 +503,50 @@ static int cryptodev_op(FAR struct csession *cse,
   return error;
 }
 
+/* Run a batch of requests, the session of consecutive requests of the
+ * same session is only looked up once.
+ */
+
+static int cryptodev_mop(FAR struct fcrypt *fcr, FAR struct crypt_mop *mop)
+{
+  FAR struct csession *cse = NULL;
+  FAR struct crypt_op *cop;
+  unsigned int i;
+  int error = OK;
+  int ret;
+
+  if (mop->count > 0 && mop->reqs == NULL)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < mop->count; i++)
+    {
+      cop = &mop->reqs[i];
+      if (cse == NULL || cse->ses != cop->ses)
+        {
+          cse = csefind(fcr, cop->ses);
+        }
+
+      ret = cse != NULL ? cryptodev_op(cse, cop) : -EINVAL;
+      if (mop->status != NULL)
+        {
+          mop->status[i] = ret;
+        }
+
+      if (ret < 0 && error == OK)
+        {
+          error = ret;
+          if (mop->status == NULL)
+            {
+              break;
+            }
+        }
+    }
+
+  return error;
+}
+
 static int cryptodev_key(FAR struct fcrypt *fcr, FAR struct crypt_kop *kop)
 {
   FAR struct cryptkop *krp_async = NULL;
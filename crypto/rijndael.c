@@ -1348,6 +1348,26 @@ static void rijndaeldecrypt(FAR const uint32_t *rk,
   PUTU32(pt + 12, s3);
 }
 
+#ifdef CONFIG_CRYPTO_ARCH_AES
+
+/* The accelerated block functions load each round key as 16 bytes, so
+ * store the schedule words in memory byte order rather than as host
+ * integers.
+ */
+
+static void rijndael_key_bytes(FAR uint32_t *rk, int nr)
+{
+  uint32_t w;
+  int i;
+
+  for (i = 0; i < 4 * (nr + 1); i++)
+    {
+      w = rk[i];
+      PUTU32((FAR uint8_t *)&rk[i], w);
+    }
+}
+#endif
+
 /* setup key context for encryption only */
 
 int rijndael_set_key_enc_only(FAR rijndael_ctx *ctx,
@@ -1362,6 +1382,10 @@ int rijndael_set_key_enc_only(FAR rijndael_ctx *ctx,
       return -1;
     }
 
+#ifdef CONFIG_CRYPTO_ARCH_AES
+  rijndael_key_bytes(ctx->ek, rounds);
+#endif
+
   ctx->nr = rounds;
   ctx->enc_only = 1;
 
@@ -1385,6 +1409,11 @@ int rijndael_set_key(FAR rijndael_ctx *ctx, FAR const u_char *key, int bits)
       return -1;
     }
 
+#ifdef CONFIG_CRYPTO_ARCH_AES
+  rijndael_key_bytes(ctx->ek, rounds);
+  rijndael_key_bytes(ctx->dk, rounds);
+#endif
+
   ctx->nr = rounds;
   ctx->enc_only = 0;
 
@@ -1395,12 +1424,20 @@ void rijndael_decrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_ARCH_AES
+  rijndael_arch_decrypt(ctx->dk, ctx->nr, src, dst);
+#else
   rijndaeldecrypt(ctx->dk, ctx->nr, src, dst);
+#endif
 }
 
 void rijndael_encrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_ARCH_AES
+  rijndael_arch_encrypt(ctx->ek, ctx->nr, src, dst);
+#else
   rijndaelencrypt(ctx->ek, ctx->nr, src, dst);
+#endif
 }
@@ -0,0 +1,133 @@
+/****************************************************************************
+ * crypto/rijndael_arch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <crypto/rijndael.h>
+
+#if defined(CONFIG_ARCH_X86_64_AESNI)
+#  include <wmmintrin.h>
+#elif defined(CONFIG_ARM64_CRYPTO)
+#  pragma GCC target("+crypto")
+#  include <arm_neon.h>
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* The key schedules are kept in memory byte order, see
+ * rijndael_set_key().  The decrypt schedule is the equivalent inverse
+ * cipher schedule, which is the round key layout expected by both
+ * AESDEC and AESD/AESIMC.
+ */
+
+#if defined(CONFIG_ARCH_X86_64_AESNI)
+
+void rijndael_arch_encrypt(FAR const uint32_t *rk, int nr,
+                           FAR const uint8_t *pt, FAR uint8_t *ct)
+{
+  FAR const __m128i *k = (FAR const __m128i *)rk;
+  __m128i s;
+  int r;
+
+  s = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)pt),
+                    _mm_loadu_si128(&k[0]));
+
+  for (r = 1; r < nr; r++)
+    {
+      s = _mm_aesenc_si128(s, _mm_loadu_si128(&k[r]));
+    }
+
+  s = _mm_aesenclast_si128(s, _mm_loadu_si128(&k[nr]));
+  _mm_storeu_si128((FAR __m128i *)ct, s);
+}
+
+void rijndael_arch_decrypt(FAR const uint32_t *rk, int nr,
+                           FAR const uint8_t *ct, FAR uint8_t *pt)
+{
+  FAR const __m128i *k = (FAR const __m128i *)rk;
+  __m128i s;
+  int r;
+
+  s = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)ct),
+                    _mm_loadu_si128(&k[0]));
+
+  for (r = 1; r < nr; r++)
+    {
+      s = _mm_aesdec_si128(s, _mm_loadu_si128(&k[r]));
+    }
+
+  s = _mm_aesdeclast_si128(s, _mm_loadu_si128(&k[nr]));
+  _mm_storeu_si128((FAR __m128i *)pt, s);
+}
+
+#elif defined(CONFIG_ARM64_CRYPTO)
+
+/* AESE/AESD add the round key before the substitution, so the first
+ * nr - 1 keys are consumed with the (inverse) MixColumns, the nr'th with
+ * the final round and the last one is a plain eor.
+ */
+
+void rijndael_arch_encrypt(FAR const uint32_t *rk, int nr,
+                           FAR const uint8_t *pt, FAR uint8_t *ct)
+{
+  FAR const uint8_t *k = (FAR const uint8_t *)rk;
+  uint8x16_t s;
+  int r;
+
+  s = vld1q_u8(pt);
+
+  for (r = 0; r < nr - 1; r++)
+    {
+      s = vaesmcq_u8(vaeseq_u8(s, vld1q_u8(k + 16 * r)));
+    }
+
+  s = vaeseq_u8(s, vld1q_u8(k + 16 * r));
+  s = veorq_u8(s, vld1q_u8(k + 16 * nr));
+  vst1q_u8(ct, s);
+}
+
+void rijndael_arch_decrypt(FAR const uint32_t *rk, int nr,
+                           FAR const uint8_t *ct, FAR uint8_t *pt)
+{
+  FAR const uint8_t *k = (FAR const uint8_t *)rk;
+  uint8x16_t s;
+  int r;
+
+  s = vld1q_u8(ct);
+
+  for (r = 0; r < nr - 1; r++)
+    {
+      s = vaesimcq_u8(vaesdq_u8(s, vld1q_u8(k + 16 * r)));
+    }
+
+  s = vaesdq_u8(s, vld1q_u8(k + 16 * r));
+  s = veorq_u8(s, vld1q_u8(k + 16 * nr));
+  vst1q_u8(pt, s);
+}
+
+#endif
@@ -312,7 +312,14 @@ void sha256init(FAR SHA2_CTX *context)
   context->bitcount[0] = 0;
 }
 
-#ifdef SHA2_UNROLL_TRANSFORM
+#if defined(CONFIG_CRYPTO_ARCH_SHA256)
+
+void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
+{
+  sha256_arch_transform(state, data, K256);
+}
+
+#elif defined(SHA2_UNROLL_TRANSFORM)
 
 /* Unrolled SHA-256 round macros: */
 
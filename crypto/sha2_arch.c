@@ -0,0 +1,148 @@
+/****************************************************************************
+ * crypto/sha2_arch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <crypto/sha2.h>
+
+#if defined(CONFIG_ARCH_X86_64_SHANI)
+#  include <immintrin.h>
+#elif defined(CONFIG_ARM64_CRYPTO)
+#  pragma GCC target("+crypto")
+#  include <arm_neon.h>
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Each pass of the loops below runs four rounds.  msg[] is a ring of the
+ * last 16 message schedule words, msg[i & 3] holds W[4i - 16 .. 4i - 13]
+ * before it is replaced by W[4i .. 4i + 3].
+ */
+
+#if defined(CONFIG_ARCH_X86_64_SHANI)
+
+void sha256_arch_transform(FAR uint32_t *state, FAR const uint8_t *data,
+                           FAR const uint32_t *k)
+{
+  const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull,
+                                      0x0405060700010203ull);
+  __m128i msg[4];
+  __m128i abef;
+  __m128i cdgh;
+  __m128i save0;
+  __m128i save1;
+  __m128i tmp;
+  int i;
+
+  /* The round instructions work on ABEF and CDGH halves */
+
+  tmp  = _mm_loadu_si128((FAR const __m128i *)&state[0]);
+  cdgh = _mm_loadu_si128((FAR const __m128i *)&state[4]);
+  tmp  = _mm_shuffle_epi32(tmp, 0xb1);
+  cdgh = _mm_shuffle_epi32(cdgh, 0x1b);
+  abef = _mm_alignr_epi8(tmp, cdgh, 8);
+  cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+
+  save0 = abef;
+  save1 = cdgh;
+
+  for (i = 0; i < 16; i++)
+    {
+      if (i < 4)
+        {
+          tmp = _mm_loadu_si128((FAR const __m128i *)(data + 16 * i));
+          msg[i] = _mm_shuffle_epi8(tmp, mask);
+        }
+      else
+        {
+          tmp = _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+          tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(msg[(i + 3) & 3],
+                                                   msg[(i + 2) & 3], 4));
+          msg[i & 3] = _mm_sha256msg2_epu32(tmp, msg[(i + 3) & 3]);
+        }
+
+      tmp  = _mm_add_epi32(msg[i & 3],
+                           _mm_loadu_si128((FAR const __m128i *)
+                                           &k[4 * i]));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, tmp);
+      tmp  = _mm_shuffle_epi32(tmp, 0x0e);
+      abef = _mm_sha256rnds2_epu32(abef, cdgh, tmp);
+    }
+
+  abef = _mm_add_epi32(abef, save0);
+  cdgh = _mm_add_epi32(cdgh, save1);
+
+  tmp  = _mm_shuffle_epi32(abef, 0x1b);
+  cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+  abef = _mm_blend_epi16(tmp, cdgh, 0xf0);
+  cdgh = _mm_alignr_epi8(cdgh, tmp, 8);
+
+  _mm_storeu_si128((FAR __m128i *)&state[0], abef);
+  _mm_storeu_si128((FAR __m128i *)&state[4], cdgh);
+}
+
+#elif defined(CONFIG_ARM64_CRYPTO)
+
+void sha256_arch_transform(FAR uint32_t *state, FAR const uint8_t *data,
+                           FAR const uint32_t *k)
+{
+  uint32x4_t msg[4];
+  uint32x4_t abcd;
+  uint32x4_t efgh;
+  uint32x4_t save;
+  uint32x4_t tmp;
+  int i;
+
+  abcd = vld1q_u32(&state[0]);
+  efgh = vld1q_u32(&state[4]);
+
+  for (i = 0; i < 16; i++)
+    {
+      if (i < 4)
+        {
+          msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data +
+                                                            16 * i)));
+        }
+      else
+        {
+          tmp = vsha256su0q_u32(msg[i & 3], msg[(i + 1) & 3]);
+          msg[i & 3] = vsha256su1q_u32(tmp, msg[(i + 2) & 3],
+                                       msg[(i + 3) & 3]);
+        }
+
+      tmp  = vaddq_u32(msg[i & 3], vld1q_u32(&k[4 * i]));
+      save = abcd;
+      abcd = vsha256hq_u32(abcd, efgh, tmp);
+      efgh = vsha256h2q_u32(efgh, save, tmp);
+    }
+
+  vst1q_u32(&state[0], vaddq_u32(abcd, vld1q_u32(&state[0])));
+  vst1q_u32(&state[4], vaddq_u32(efgh, vld1q_u32(&state[4])));
+}
+
+#endif
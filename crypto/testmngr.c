@@ -32,9 +32,14 @@
 #include <poll.h>
 #include <errno.h>
 #include <debug.h>
+#include <inttypes.h>
+#include <syslog.h>
 
 #include <sys/param.h>
 
+#include <crypto/rijndael.h>
+#include <crypto/sha2.h>
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
@@ -108,6 +113,129 @@ static int test_aes(void)
 }
 #endif
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+
+/* FIPS-197 appendix C and FIPS 180-2 appendix B.1 known answers */
+
+static const uint8_t g_bench_pt[16] =
+{
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+  0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+static const uint8_t g_bench_ct[3 * 16] =
+{
+  0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, /* AES-128 */
+  0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a,
+  0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0, /* AES-192 */
+  0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91,
+  0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, /* AES-256 */
+  0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89
+};
+
+static const uint8_t g_bench_sha256[SHA256_DIGEST_LENGTH] =
+{
+  0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+  0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+  0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+  0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+
+static void bench_report(FAR const char *name, clock_t elapsed)
+{
+  struct timespec ts;
+  uint64_t usec;
+
+  perf_convert(elapsed, &ts);
+  usec = (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+
+  syslog(LOG_INFO, "%s: %" PRIu64 " KiB/s\n", name,
+         (uint64_t)CONFIG_CRYPTO_ALGTEST_BENCH_SIZE * USEC_PER_SEC /
+         1024 / MAX(usec, 1));
+}
+
+static int test_bench(void)
+{
+  static const char *const names[3] =
+  {
+    "AES-128 encrypt", "AES-192 encrypt", "AES-256 encrypt"
+  };
+
+  uint8_t digest[SHA256_DIGEST_LENGTH];
+  uint8_t key[32];
+  uint8_t blk[16];
+  FAR uint8_t *buf;
+  rijndael_ctx ctx;
+  SHA2_CTX sha;
+  clock_t start;
+  size_t n;
+  int ret = -1;
+  int i;
+
+  buf = kmm_zalloc(CONFIG_CRYPTO_ALGTEST_BENCH_SIZE);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < sizeof(key); i++)
+    {
+      key[i] = i;
+    }
+
+  for (i = 0; i < 3; i++)
+    {
+      if (rijndael_set_key(&ctx, key, 128 + 64 * i) < 0)
+        {
+          goto out;
+        }
+
+      rijndael_encrypt(&ctx, g_bench_pt, blk);
+      if (memcmp(blk, g_bench_ct + 16 * i, sizeof(blk)) != 0)
+        {
+          crypterr("ERROR: Failed %s test\n", names[i]);
+          goto out;
+        }
+
+      rijndael_decrypt(&ctx, blk, blk);
+      if (memcmp(blk, g_bench_pt, sizeof(blk)) != 0)
+        {
+          crypterr("ERROR: Failed %s decrypt test\n", names[i]);
+          goto out;
+        }
+
+      start = perf_gettime();
+      for (n = 0; n + 16 <= CONFIG_CRYPTO_ALGTEST_BENCH_SIZE; n += 16)
+        {
+          rijndael_encrypt(&ctx, buf + n, buf + n);
+        }
+
+      bench_report(names[i], perf_gettime() - start);
+    }
+
+  sha256init(&sha);
+  sha256update(&sha, "abc", 3);
+  sha256final(digest, &sha);
+  if (memcmp(digest, g_bench_sha256, sizeof(digest)) != 0)
+    {
+      crypterr("ERROR: Failed SHA-256 test\n");
+      goto out;
+    }
+
+  start = perf_gettime();
+  sha256init(&sha);
+  sha256update(&sha, buf, CONFIG_CRYPTO_ALGTEST_BENCH_SIZE);
+  sha256final(digest, &sha);
+  bench_report("SHA-256", perf_gettime() - start);
+
+  ret = OK;
+
+out:
+  kmm_free(buf);
+  return ret;
+}
+#endif
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -117,6 +245,13 @@ int crypto_test(void)
     }
 #endif
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+  if (test_bench())
+    {
+      return -1;
+    }
+#endif
+
   return OK;
 }
 
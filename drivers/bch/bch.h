@@ -34,7 +34,9 @@
 #include <stdbool.h>
 
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/pagecache.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -42,22 +44,46 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* The sector cache holds BCH_NLINES sectors, BCH_NWAYS in each set */
+
+#define BCH_NSETS         CONFIG_BCH_CACHE_NSETS
+#define BCH_NWAYS         CONFIG_BCH_CACHE_NWAYS
+#define BCH_NLINES        (BCH_NSETS * BCH_NWAYS)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One sector of the cache */
+
+struct bchlib_line_s
+{
+  size_t sector;           /* The sector in the buffer, (size_t)-1 if none */
+  uint32_t stamp;          /* Time of the last access, for the LRU */
+  bool dirty;              /* true: Data has been written to the buffer */
+  FAR uint8_t *buffer;     /* One sector buffer, allocated on first use */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* The buffer of the current sector */
+  uint32_t stamp;          /* Clock of the cache line accesses */
+
+  /* The sector cache and the line of the current sector */
+
+  FAR struct bchlib_line_s *line;
+  struct bchlib_line_s lines[BCH_NLINES];
+
+#if CONFIG_BCH_CACHE_FLUSH_DELAY > 0
+  struct work_s work;      /* Delayed write-back of the dirty sectors */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -84,7 +110,12 @@ EXTERN const struct file_operations g_bch_fops;
  ****************************************************************************/
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
+EXTERN int  bchlib_flushsectors(FAR struct bchlib_s *bch, size_t sector,
+                                size_t nsectors);
+EXTERN void bchlib_discardsectors(FAR struct bchlib_s *bch, size_t sector,
+                                  size_t nsectors);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch);
 
 #undef EXTERN
 #if defined(__cplusplus)
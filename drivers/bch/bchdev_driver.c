@@ -36,6 +36,7 @@
 #include <sched.h>
 #include <errno.h>
 #include <poll.h>
+#include <stdint.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -437,9 +438,31 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       case BIOC_DISCARD:
         {
-          /* Invalidate the sector so next read is from the device- */
+          /* Invalidate the sectors so next read is from the device- */
+
+          bchlib_discardsectors(bch, 0, SIZE_MAX);
+          goto ioctl_default;
+        }
+
+      case BIOC_TRIM:
+      case BIOC_WRZEROES:
+        {
+          FAR const blkcnt_t *range = (FAR const blkcnt_t *)arg;
+
+          /* The cached copies of the sectors are stale after the call */
+
+          if (range != NULL)
+            {
+              ret = nxmutex_lock(&bch->lock);
+              if (ret < 0)
+                {
+                  break;
+                }
+
+              bchlib_discardsectors(bch, range[0], range[1]);
+              nxmutex_unlock(&bch->lock);
+            }
 
-          bch->sector = (size_t)-1;
           goto ioctl_default;
         }
 
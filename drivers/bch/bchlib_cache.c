@@ -29,6 +29,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -62,10 +63,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch,
+                      FAR struct bchlib_line_s *line, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)line->buffer;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -73,7 +75,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        line->sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -92,42 +94,31 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bchlib_flushline
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write one cache line back to the media (if dirty)
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+static int bchlib_flushline(FAR struct bchlib_s *bch,
+                            FAR struct bchlib_line_s *line)
 {
-  FAR struct inode *inode;
+  FAR struct inode *inode = bch->inode;
   ssize_t ret = OK;
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
-   */
-
-  if (bch->dirty && bch->buffer != NULL)
+  if (line->dirty)
     {
-      inode = bch->inode;
-
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, line, CYPHER_ENCRYPT);
 #endif
 
       /* Write the sector to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = pagecache_write(inode, line->buffer, line->sector, 1,
+                            bch->sectsize);
       if (ret < 0)
         {
           ferr("Write failed: %zd\n", ret);
@@ -139,27 +130,151 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, line, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
 
-      bch->dirty = false;
+      line->dirty = false;
     }
 
-  if (discard)
+  return (int)ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushworker
+ *
+ * Description:
+ *   Write the dirty sectors back some time after the first write.  The
+ *   worker never waits for the lock, the lock is held by bchlib_teardown()
+ *   when it cancels the work.
+ *
+ ****************************************************************************/
+
+#if CONFIG_BCH_CACHE_FLUSH_DELAY > 0
+static void bchlib_flushworker(FAR void *arg)
+{
+  FAR struct bchlib_s *bch = arg;
+
+  if (nxmutex_trylock(&bch->lock) < 0)
     {
-      bch->sector = (size_t)-1;
+      work_queue(LPWORK, &bch->work, bchlib_flushworker, bch,
+                 MSEC2TICK(CONFIG_BCH_CACHE_FLUSH_DELAY));
+      return;
     }
 
-  return (int)ret;
+  bchlib_flushsector(bch, false);
+  nxmutex_unlock(&bch->lock);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_flushsectors
+ *
+ * Description:
+ *   Write the dirty cached sectors in the range back to the media, in the
+ *   ascending sector order
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushsectors(FAR struct bchlib_s *bch, size_t sector,
+                        size_t nsectors)
+{
+  FAR struct bchlib_line_s *line;
+  int ret;
+  int i;
+
+  for (; ; )
+    {
+      line = NULL;
+      for (i = 0; i < BCH_NLINES; i++)
+        {
+          if (bch->lines[i].dirty &&
+              bch->lines[i].sector - sector < nsectors &&
+              (line == NULL || bch->lines[i].sector < line->sector))
+            {
+              line = &bch->lines[i];
+            }
+        }
+
+      if (line == NULL)
+        {
+          return OK;
+        }
+
+      ret = bchlib_flushline(bch, line);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush all the dirty cached sectors, then drop the whole cache if
+ *   requested
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+{
+  int ret;
+
+  ret = bchlib_flushsectors(bch, 0, SIZE_MAX);
+  if (ret >= 0 && discard)
+    {
+      bchlib_discardsectors(bch, 0, SIZE_MAX);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_discardsectors
+ *
+ * Description:
+ *   Drop the cached sectors in the range without writing them back
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_discardsectors(FAR struct bchlib_s *bch, size_t sector,
+                           size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < BCH_NLINES; i++)
+    {
+      if (bch->lines[i].sector - sector < nsectors)
+        {
+          bch->lines[i].sector = (size_t)-1;
+          bch->lines[i].dirty  = false;
+        }
+    }
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Make the sector the current one, reading it into the cache if needed.
+ *   A miss replaces the least recently used line of the set the sector
+ *   belongs to.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -168,46 +283,95 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct bchlib_line_s *set;
+  FAR struct bchlib_line_s *line;
+  ssize_t ret;
+  int i;
+
+  set  = &bch->lines[(sector % BCH_NSETS) * BCH_NWAYS];
+  line = set;
 
-  if (bch->buffer == NULL)
+  for (i = 0; i < BCH_NWAYS; i++)
+    {
+      if (set[i].sector == sector)
+        {
+          line = &set[i];
+          break;
+        }
+
+      if (set[i].sector == (size_t)-1 ||
+          (line->sector != (size_t)-1 && set[i].stamp < line->stamp))
+        {
+          line = &set[i];
+        }
+    }
+
+  if (line->buffer == NULL)
     {
 #if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
+      line->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                                  bch->sectsize);
 #else
-      bch->buffer = kmm_malloc(bch->sectsize);
+      line->buffer = kmm_malloc(bch->sectsize);
 #endif
-      if (bch->buffer == NULL)
+      if (line->buffer == NULL)
         {
           ferr("Failed to allocate sector buffer\n");
           return -ENOMEM;
         }
     }
 
-  if (bch->sector != sector)
+  if (line->sector != sector)
     {
-      inode = bch->inode;
-
-      ret = bchlib_flushsector(bch, true);
+      ret = bchlib_flushline(bch, line);
       if (ret < 0)
         {
           ferr("Flush failed: %zd\n", ret);
           return (int)ret;
         }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      line->sector = (size_t)-1;
+
+      ret = pagecache_read(bch->inode, line->buffer, sector, 1,
+                           bch->sectsize);
       if (ret < 0)
         {
           ferr("Read failed: %zd\n", ret);
           return (int)ret;
         }
 
-      bch->sector = sector;
+      line->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, line, CYPHER_DECRYPT);
 #endif
     }
 
-  return (int)ret;
+  line->stamp = ++bch->stamp;
+  bch->line   = line;
+  bch->buffer = line->buffer;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark the current sector as modified and arm the delayed write-back
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch)
+{
+  bch->line->dirty = true;
+
+#if CONFIG_BCH_CACHE_FLUSH_DELAY > 0
+  if (work_available(&bch->work))
+    {
+      work_queue(LPWORK, &bch->work, bchlib_flushworker, bch,
+                 MSEC2TICK(CONFIG_BCH_CACHE_FLUSH_DELAY));
+    }
+#endif
 }
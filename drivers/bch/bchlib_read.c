@@ -148,8 +148,17 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
+      /* The media must be up to date with the cached sectors */
+
+      ret = bchlib_flushsectors(bch, sector, nsectors);
+      if (ret < 0)
+        {
+          ferr("ERROR: Flush failed: %d\n", ret);
+          return ret;
+        }
+
+      ret = pagecache_read(bch->inode, (FAR uint8_t *)buffer, sector,
+                           nsectors, bch->sectsize);
       if (ret < 0)
         {
           ferr("ERROR: Read failed: %d\n", ret);
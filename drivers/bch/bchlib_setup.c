@@ -61,6 +61,7 @@ int bchlib_setup(FAR const char *blkdev, int oflags, FAR void **handle)
   struct geometry geo;
   bool readonly = (oflags & O_WROK) == 0;
   int ret;
+  int i;
 
   DEBUGASSERT(blkdev);
 
@@ -111,8 +112,13 @@ int bchlib_setup(FAR const char *blkdev, int oflags, FAR void **handle)
   nxmutex_init(&bch->lock);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
+
+  for (i = 0; i < BCH_NLINES; i++)
+    {
+      bch->lines[i].sector = (size_t)-1;
+    }
+
   *handle = bch;
   return OK;
 
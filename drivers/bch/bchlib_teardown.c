@@ -52,6 +52,7 @@
 int bchlib_teardown(FAR void *handle)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  int i;
 
   DEBUGASSERT(handle);
 
@@ -62,6 +63,15 @@ int bchlib_teardown(FAR void *handle)
       return -EBUSY;
     }
 
+#if CONFIG_BCH_CACHE_FLUSH_DELAY > 0
+  /* The worker requeues itself if it finds the lock held, so cancel again
+   * once it has returned.
+   */
+
+  work_cancel_sync(LPWORK, &bch->work);
+  work_cancel(LPWORK, &bch->work);
+#endif
+
   /* Flush any pending data to the block driver */
 
   bchlib_flushsector(bch, false);
@@ -72,9 +82,12 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
-  if (bch->buffer)
+  for (i = 0; i < BCH_NLINES; i++)
     {
-      kmm_free(bch->buffer);
+      if (bch->lines[i].buffer)
+        {
+          kmm_free(bch->lines[i].buffer);
+        }
     }
 
   nxmutex_destroy(&bch->lock);
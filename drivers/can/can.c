@@ -1285,6 +1285,10 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
   int                      i;
   int                      sval;
   bool                     was_empty;
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timespec          ts;
+  bool                     stamped = false;
+#endif
 
   caninfo("ID: %" PRId32 " DLC: %d\n", (uint32_t)hdr->ch_id, hdr->ch_dlc);
 
@@ -1382,6 +1386,27 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
               memcpy(fifo->rx_buffer[fifo->rx_tail].cm_data, data, nbytes);
             }
 
+#ifdef CONFIG_CAN_TIMESTAMP
+          /* Stamp the frame here if the lower half did not capture a
+           * hardware timestamp, so that every frame in a batched read
+           * carries its own arrival time.
+           */
+
+          if (hdr->ch_ts.tv_sec == 0 && hdr->ch_ts.tv_usec == 0)
+            {
+              if (!stamped)
+                {
+                  clock_systime_timespec(&ts);
+                  stamped = true;
+                }
+
+              fifo->rx_buffer[fifo->rx_tail].cm_hdr.ch_ts.tv_sec =
+                ts.tv_sec;
+              fifo->rx_buffer[fifo->rx_tail].cm_hdr.ch_ts.tv_usec =
+                ts.tv_nsec / NSEC_PER_USEC;
+            }
+#endif
+
           /* Increment the tail of the circular buffer */
 
           fifo->rx_tail = nexttail;
@@ -1394,13 +1419,18 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
           if (was_empty)
             {
               nxsem_post(&fifo->rx_sem);
-            }
 
-          /* Notify specific poll/select waiter that they can read from the
-           * cd_recv buffer
-           */
+              /* Notify specific poll/select waiter that they can read from
+               * the cd_recv buffer.  A waiter can only be blocked on an
+               * empty FIFO (can_poll() reports POLLIN immediately
+               * otherwise), so frames arriving behind an unread one are
+               * picked up by the same wakeup and drained by a single
+               * batched read.
+               */
+
+              poll_notify(&reader->cd_fds, 1, POLLIN);
+            }
 
-          poll_notify(&reader->cd_fds, 1, POLLIN);
           ret = OK;
         }
 #ifdef CONFIG_CAN_ERRORS
@@ -0,0 +1,177 @@
+/****************************************************************************
+ * drivers/dma/dma_sg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/dma/dma.h>
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void dma_sg_callback(FAR struct dma_chan_s *chan, FAR void *arg,
+                            ssize_t len);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_sg_start_one
+ *
+ * Description:
+ *   Start the current segment of the descriptor as a single transfer.
+ *
+ ****************************************************************************/
+
+static int dma_sg_start_one(FAR struct dma_sg_desc_s *desc)
+{
+  FAR const struct dma_sg_s *seg = &desc->sg[desc->index];
+  uintptr_t dst;
+  uintptr_t src;
+
+  switch (desc->direction)
+    {
+      case DMA_DEV_TO_MEM:
+        dst = seg->addr;
+        src = desc->addr;
+        break;
+
+      case DMA_MEM_TO_MEM:
+        dst = desc->addr + desc->done;
+        src = seg->addr;
+        break;
+
+      default:
+        dst = desc->addr;
+        src = seg->addr;
+        break;
+    }
+
+  return DMA_START(desc->chan, dma_sg_callback, desc, dst, src, seg->len);
+}
+
+/****************************************************************************
+ * Name: dma_sg_callback
+ *
+ * Description:
+ *   Completion of one segment in the software fallback: chain the next
+ *   one, or report the whole transfer to the client.
+ *
+ ****************************************************************************/
+
+static void dma_sg_callback(FAR struct dma_chan_s *chan, FAR void *arg,
+                            ssize_t len)
+{
+  FAR struct dma_sg_desc_s *desc = arg;
+  int ret;
+
+  if (len >= 0)
+    {
+      desc->done += len;
+      if (++desc->index < desc->nsg)
+        {
+          ret = dma_sg_start_one(desc);
+          if (ret >= 0)
+            {
+              return;
+            }
+
+          len = ret;
+        }
+      else
+        {
+          len = desc->done;
+        }
+    }
+
+  desc->callback(chan, desc->arg, len);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_sg_prep
+ *
+ * Description:
+ *   Prepare a scatter-gather descriptor.  The segment list must stay valid
+ *   until the descriptor is no longer used.
+ *
+ ****************************************************************************/
+
+int dma_sg_prep(FAR struct dma_sg_desc_s *desc, FAR struct dma_chan_s *chan,
+                unsigned int direction, uintptr_t addr,
+                FAR const struct dma_sg_s *sg, unsigned int nsg,
+                dma_callback_t callback, FAR void *arg)
+{
+  if (desc == NULL || chan == NULL || sg == NULL || nsg == 0 ||
+      callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  desc->chan      = chan;
+  desc->callback  = callback;
+  desc->arg       = arg;
+  desc->direction = direction;
+  desc->addr      = addr;
+  desc->sg        = sg;
+  desc->nsg       = nsg;
+  desc->index     = 0;
+  desc->done      = 0;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_sg_submit
+ *
+ * Description:
+ *   Start the transfer described by a prepared descriptor.  If the channel
+ *   has no native scatter-gather support, the segments are started one
+ *   after the other from the completion callback of the previous one.
+ *
+ ****************************************************************************/
+
+int dma_sg_submit(FAR struct dma_sg_desc_s *desc)
+{
+  FAR struct dma_chan_s *chan = desc->chan;
+
+  desc->index = 0;
+  desc->done  = 0;
+
+  if (chan->ops->start_sg != NULL)
+    {
+      return DMA_START_SG(chan, desc->callback, desc->arg, desc->addr,
+                          desc->sg, desc->nsg);
+    }
+
+  return dma_sg_start_one(desc);
+}
@@ -0,0 +1,519 @@
+/****************************************************************************
+ * drivers/dma/dma_soft.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/dma/dma.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dma_soft_chan_s
+{
+  struct dma_chan_s chan;           /* Must be the first field */
+  sem_t excl;                       /* Exclusive channel ownership */
+  struct work_s work;               /* Runs the copies */
+
+  unsigned int direction;           /* From DMA_CONFIG() */
+  unsigned int dst_width;
+  unsigned int src_width;
+
+  dma_callback_t callback;
+  FAR void *arg;
+  uintptr_t dst;                    /* Start of the transfer */
+  uintptr_t src;
+  size_t len;                       /* Total length */
+  size_t pos;                       /* Bytes already transferred */
+  size_t period_len;                /* Cyclic period, 0 if not cyclic */
+  FAR const struct dma_sg_s *sg;    /* Segments, NULL if not sg */
+  unsigned int nsg;
+  unsigned int index;               /* Current segment */
+  bool active;
+  bool paused;
+};
+
+struct dma_soft_dev_s
+{
+  struct dma_dev_s dev;             /* Must be the first field */
+  bool initialized;
+  struct dma_soft_chan_s chans[CONFIG_DMA_SOFT_NCHANNELS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int dma_soft_config(FAR struct dma_chan_s *chan,
+                           FAR const struct dma_config_s *cfg);
+static int dma_soft_start(FAR struct dma_chan_s *chan,
+                          dma_callback_t callback, FAR void *arg,
+                          uintptr_t dst, uintptr_t src, size_t len);
+static int dma_soft_start_cyclic(FAR struct dma_chan_s *chan,
+                                 dma_callback_t callback, FAR void *arg,
+                                 uintptr_t dst, uintptr_t src,
+                                 size_t len, size_t period_len);
+static int dma_soft_start_sg(FAR struct dma_chan_s *chan,
+                             dma_callback_t callback, FAR void *arg,
+                             uintptr_t addr, FAR const struct dma_sg_s *sg,
+                             unsigned int nsg);
+static int dma_soft_stop(FAR struct dma_chan_s *chan);
+static int dma_soft_pause(FAR struct dma_chan_s *chan);
+static int dma_soft_resume(FAR struct dma_chan_s *chan);
+static size_t dma_soft_residual(FAR struct dma_chan_s *chan);
+
+static FAR struct dma_chan_s *dma_soft_get_chan(FAR struct dma_dev_s *dev,
+                                                unsigned int ident);
+static void dma_soft_put_chan(FAR struct dma_dev_s *dev,
+                              FAR struct dma_chan_s *chan);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct dma_ops_s g_dma_soft_ops =
+{
+  dma_soft_config,         /* config */
+  dma_soft_start,          /* start */
+  dma_soft_start_cyclic,   /* start_cyclic */
+#ifdef CONFIG_DMA_LINK
+  NULL,                    /* start_link */
+#endif
+  dma_soft_stop,           /* stop */
+  dma_soft_pause,          /* pause */
+  dma_soft_resume,         /* resume */
+  dma_soft_residual,       /* residual */
+  dma_soft_start_sg,       /* start_sg */
+};
+
+static struct dma_soft_dev_s g_dma_soft =
+{
+  {
+    dma_soft_get_chan,
+    dma_soft_put_chan,
+  },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_soft_copy
+ *
+ * Description:
+ *   Copy len bytes.  A device side of the transfer is a fixed register,
+ *   accessed with its configured width.
+ *
+ ****************************************************************************/
+
+static void dma_soft_copy(FAR struct dma_soft_chan_s *ch, uintptr_t dst,
+                          uintptr_t src, size_t len)
+{
+  bool dst_inc = ch->direction != DMA_MEM_TO_DEV &&
+                 ch->direction != DMA_DEV_TO_DEV;
+  bool src_inc = ch->direction != DMA_DEV_TO_MEM &&
+                 ch->direction != DMA_DEV_TO_DEV;
+  size_t width;
+
+  if (dst_inc && src_inc)
+    {
+      memcpy((FAR void *)dst, (FAR const void *)src, len);
+      return;
+    }
+
+  width = !dst_inc ? ch->dst_width : ch->src_width;
+  if (width == 0)
+    {
+      width = 1;
+    }
+
+  while (len >= width)
+    {
+      memcpy((FAR void *)dst, (FAR const void *)src, width);
+      dst += dst_inc ? width : 0;
+      src += src_inc ? width : 0;
+      len -= width;
+    }
+}
+
+/****************************************************************************
+ * Name: dma_soft_worker
+ *
+ * Description:
+ *   Transfer one chunk: the whole buffer, one cyclic period or one
+ *   scatter-gather segment, then report it and reschedule if needed.
+ *
+ ****************************************************************************/
+
+static void dma_soft_worker(FAR void *arg)
+{
+  FAR struct dma_soft_chan_s *ch = arg;
+  dma_callback_t callback;
+  FAR void *cbarg;
+  irqstate_t flags;
+  uintptr_t dst;
+  uintptr_t src;
+  size_t chunk;
+  ssize_t report = -1;
+  bool more;
+
+  flags = enter_critical_section();
+  if (!ch->active || ch->paused)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  if (ch->sg != NULL)
+    {
+      FAR const struct dma_sg_s *seg = &ch->sg[ch->index];
+
+      chunk = seg->len;
+      if (ch->direction == DMA_DEV_TO_MEM)
+        {
+          dst = seg->addr;
+          src = ch->src;
+        }
+      else
+        {
+          dst = ch->direction == DMA_MEM_TO_MEM ? ch->dst + ch->pos :
+                                                 ch->dst;
+          src = seg->addr;
+        }
+    }
+  else
+    {
+      chunk = ch->period_len ? ch->period_len : ch->len - ch->pos;
+      dst   = ch->dst;
+      src   = ch->src;
+
+      if (ch->direction != DMA_MEM_TO_DEV && ch->direction != DMA_DEV_TO_DEV)
+        {
+          dst += ch->pos;
+        }
+
+      if (ch->direction != DMA_DEV_TO_MEM && ch->direction != DMA_DEV_TO_DEV)
+        {
+          src += ch->pos;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  dma_soft_copy(ch, dst, src, chunk);
+
+  flags = enter_critical_section();
+  if (!ch->active)
+    {
+      /* Stopped while copying */
+
+      leave_critical_section(flags);
+      return;
+    }
+
+  ch->pos += chunk;
+  if (ch->sg != NULL)
+    {
+      more = ++ch->index < ch->nsg;
+      if (!more)
+        {
+          report = ch->pos;
+        }
+    }
+  else if (ch->period_len)
+    {
+      if (ch->pos >= ch->len)
+        {
+          ch->pos = 0;
+        }
+
+      report = chunk;
+      more   = true;
+    }
+  else
+    {
+      report = ch->pos;
+      more   = false;
+    }
+
+  ch->active = more;
+  callback   = ch->callback;
+  cbarg      = ch->arg;
+  leave_critical_section(flags);
+
+  if (report >= 0 && callback != NULL)
+    {
+      callback(&ch->chan, cbarg, report);
+    }
+
+  /* The callback may have stopped or restarted the channel */
+
+  flags = enter_critical_section();
+  if (ch->active && !ch->paused)
+    {
+      work_queue(LPWORK, &ch->work, dma_soft_worker, ch, 0);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: dma_soft_kick
+ *
+ * Description:
+ *   Arm a new transfer whose parameters are already set.
+ *
+ ****************************************************************************/
+
+static int dma_soft_kick(FAR struct dma_soft_chan_s *ch,
+                         dma_callback_t callback, FAR void *arg)
+{
+  ch->callback = callback;
+  ch->arg      = arg;
+  ch->pos      = 0;
+  ch->index    = 0;
+  ch->paused   = false;
+  ch->active   = true;
+
+  return work_queue(LPWORK, &ch->work, dma_soft_worker, ch, 0);
+}
+
+static int dma_soft_config(FAR struct dma_chan_s *chan,
+                           FAR const struct dma_config_s *cfg)
+{
+  FAR struct dma_soft_chan_s *ch = (FAR struct dma_soft_chan_s *)chan;
+
+  /* Zero means keep the current value */
+
+  if (cfg->direction != 0)
+    {
+      ch->direction = cfg->direction;
+    }
+
+  if (cfg->dst_width != 0)
+    {
+      ch->dst_width = cfg->dst_width;
+    }
+
+  if (cfg->src_width != 0)
+    {
+      ch->src_width = cfg->src_width;
+    }
+
+  return OK;
+}
+
+static int dma_soft_start(FAR struct dma_chan_s *chan,
+                          dma_callback_t callback, FAR void *arg,
+                          uintptr_t dst, uintptr_t src, size_t len)
+{
+  return dma_soft_start_cyclic(chan, callback, arg, dst, src, len, 0);
+}
+
+static int dma_soft_start_cyclic(FAR struct dma_chan_s *chan,
+                                 dma_callback_t callback, FAR void *arg,
+                                 uintptr_t dst, uintptr_t src,
+                                 size_t len, size_t period_len)
+{
+  FAR struct dma_soft_chan_s *ch = (FAR struct dma_soft_chan_s *)chan;
+  irqstate_t flags;
+  int ret = -EBUSY;
+
+  if (len == 0 || (period_len != 0 && len % period_len != 0))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  if (!ch->active)
+    {
+      ch->dst        = dst;
+      ch->src        = src;
+      ch->len        = len;
+      ch->period_len = period_len;
+      ch->sg         = NULL;
+      ch->nsg        = 0;
+      ret = dma_soft_kick(ch, callback, arg);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+static int dma_soft_start_sg(FAR struct dma_chan_s *chan,
+                             dma_callback_t callback, FAR void *arg,
+                             uintptr_t addr, FAR const struct dma_sg_s *sg,
+                             unsigned int nsg)
+{
+  FAR struct dma_soft_chan_s *ch = (FAR struct dma_soft_chan_s *)chan;
+  irqstate_t flags;
+  unsigned int i;
+  size_t len = 0;
+  int ret = -EBUSY;
+
+  if (sg == NULL || nsg == 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < nsg; i++)
+    {
+      len += sg[i].len;
+    }
+
+  flags = enter_critical_section();
+  if (!ch->active)
+    {
+      ch->dst        = addr;
+      ch->src        = addr;
+      ch->len        = len;
+      ch->period_len = 0;
+      ch->sg         = sg;
+      ch->nsg        = nsg;
+      ret = dma_soft_kick(ch, callback, arg);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+static int dma_soft_stop(FAR struct dma_chan_s *chan)
+{
+  FAR struct dma_soft_chan_s *ch = (FAR struct dma_soft_chan_s *)chan;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  ch->active = false;
+  ch->paused = false;
+  work_cancel(LPWORK, &ch->work);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+static int dma_soft_pause(FAR struct dma_chan_s *chan)
+{
+  FAR struct dma_soft_chan_s *ch = (FAR struct dma_soft_chan_s *)chan;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  ch->paused = true;
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+static int dma_soft_resume(FAR struct dma_chan_s *chan)
+{
+  FAR struct dma_soft_chan_s *ch = (FAR struct dma_soft_chan_s *)chan;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (ch->paused)
+    {
+      ch->paused = false;
+      if (ch->active)
+        {
+          ret = work_queue(LPWORK, &ch->work, dma_soft_worker, ch, 0);
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+static size_t dma_soft_residual(FAR struct dma_chan_s *chan)
+{
+  FAR struct dma_soft_chan_s *ch = (FAR struct dma_soft_chan_s *)chan;
+
+  return ch->active ? ch->len - ch->pos : 0;
+}
+
+static FAR struct dma_chan_s *dma_soft_get_chan(FAR struct dma_dev_s *dev,
+                                                unsigned int ident)
+{
+  FAR struct dma_soft_dev_s *priv = (FAR struct dma_soft_dev_s *)dev;
+
+  DEBUGASSERT(ident < CONFIG_DMA_SOFT_NCHANNELS);
+  if (ident >= CONFIG_DMA_SOFT_NCHANNELS)
+    {
+      return NULL;
+    }
+
+  nxsem_wait_uninterruptible(&priv->chans[ident].excl);
+  return &priv->chans[ident].chan;
+}
+
+static void dma_soft_put_chan(FAR struct dma_dev_s *dev,
+                              FAR struct dma_chan_s *chan)
+{
+  FAR struct dma_soft_chan_s *ch = (FAR struct dma_soft_chan_s *)chan;
+
+  dma_soft_stop(chan);
+  nxsem_post(&ch->excl);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_soft_initialize
+ *
+ * Description:
+ *   Return the software DMA device.  Its channels copy memory with the CPU
+ *   from the low priority work queue.
+ *
+ ****************************************************************************/
+
+FAR struct dma_dev_s *dma_soft_initialize(void)
+{
+  FAR struct dma_soft_dev_s *priv = &g_dma_soft;
+  int i;
+
+  if (!priv->initialized)
+    {
+      for (i = 0; i < CONFIG_DMA_SOFT_NCHANNELS; i++)
+        {
+          priv->chans[i].chan.ops  = &g_dma_soft_ops;
+          priv->chans[i].direction = DMA_MEM_TO_MEM;
+          nxsem_init(&priv->chans[i].excl, 0, 1);
+        }
+
+      priv->initialized = true;
+    }
+
+  return &priv->dev;
+}
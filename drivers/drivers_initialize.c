@@ -31,6 +31,7 @@
 #include <nuttx/drivers/rpmsgblk.h>
 #include <nuttx/fs/loop.h>
 #include <nuttx/fs/smart.h>
+#include <nuttx/init.h>
 #include <nuttx/fs/loopmtd.h>
 #include <nuttx/input/uinput.h>
 #include <nuttx/mtd/mtd.h>
@@ -118,64 +119,80 @@ void drivers_initialize(void)
 
   /* Register devices */
 
-  syslog_initialize();
+  nx_bootcall(syslog_initialize());
 
 #ifdef CONFIG_SERIAL_RTT
-  serial_rtt_initialize();
+  nx_bootcall(serial_rtt_initialize());
 #endif
 
 #if defined(CONFIG_DEV_NULL)
-  devnull_register();   /* Standard /dev/null */
+  nx_bootcall(devnull_register());   /* Standard /dev/null */
 #endif
 
 #if defined(CONFIG_DEV_RANDOM)
-  devrandom_register(); /* Standard /dev/random */
+  nx_bootcall(devrandom_register()); /* Standard /dev/random */
 #endif
 
 #if defined(CONFIG_DEV_URANDOM)
-  devurandom_register();   /* Standard /dev/urandom */
+  nx_bootcall(devurandom_register());   /* Standard /dev/urandom */
 #endif
 
 #if defined(CONFIG_DEV_ZERO)
-  devzero_register();   /* Standard /dev/zero */
+  nx_bootcall(devzero_register());   /* Standard /dev/zero */
 #endif
 
 #ifdef CONFIG_DEV_MEM
-  devmem_register();
+  nx_bootcall(devmem_register());
 #endif
 
 #if defined(CONFIG_DEV_LOOP)
-  loop_register();      /* Standard /dev/loop */
+  nx_bootcall(loop_register());      /* Standard /dev/loop */
 #endif
 
 #if defined(CONFIG_DEV_ASCII)
-  devascii_register();  /* Non-standard /dev/ascii */
+  nx_bootcall(devascii_register());  /* Non-standard /dev/ascii */
+#endif
+
+#ifdef CONFIG_DEV_PROFILE
+  nx_bootcall(devprofile_register()); /* Non-standard /dev/profile */
+#endif
+
+#ifdef CONFIG_DEV_PERF
+  nx_bootcall(devperf_register()); /* Non-standard /dev/perf */
+#endif
+
+#ifdef CONFIG_DEV_BENCH
+  nx_bootcall(devbench_register()); /* Non-standard /dev/bench */
+#endif
+
+#ifdef CONFIG_DEV_RINGCHAN
+  nx_bootcall(ringchan_register()); /* Non-standard /dev/ringctl */
 #endif
 
 #if defined(CONFIG_DRIVERS_NOTE)
-  note_initialize();    /* Non-standard /dev/note */
+  nx_bootcall(note_initialize());    /* Non-standard /dev/note */
 #endif
 
 #if defined(CONFIG_CLK_RPMSG)
-  clk_rpmsg_server_initialize();
+  nx_bootcall(clk_rpmsg_server_initialize());
 #endif
 
 #if defined(CONFIG_REGULATOR_RPMSG)
-  regulator_rpmsg_server_init();
+  nx_bootcall(regulator_rpmsg_server_init());
 #endif
 
 #if defined(CONFIG_RESET_RPMSG)
-  reset_rpmsg_server_init();
+  nx_bootcall(reset_rpmsg_server_init());
 #endif
 
   /* Initialize the serial device driver */
 
 #ifdef CONFIG_RPMSG_UART
-  rpmsg_serialinit();
+  nx_bootcall(rpmsg_serialinit());
 #endif
 
 #ifdef CONFIG_RAM_UART
-  ram_serialinit();
+  nx_bootcall(ram_serialinit());
 #endif
 
   /* Initialize the console device driver (if it is other than the standard
@@ -183,135 +200,135 @@ void drivers_initialize(void)
    */
 
 #if defined(CONFIG_LWL_CONSOLE)
-  lwlconsole_init();
+  nx_bootcall(lwlconsole_init());
 #elif defined(CONFIG_CONSOLE_SYSLOG)
-  syslog_console_init();
+  nx_bootcall(syslog_console_init());
 #endif
 
 #ifdef CONFIG_UART_HOSTFS
-  uart_hostfs_init();
+  nx_bootcall(uart_hostfs_init());
 #endif
 
 #ifdef CONFIG_PSEUDOTERM_SUSV1
   /* Register the master pseudo-terminal multiplexor device */
 
-  ptmx_register();
+  nx_bootcall(ptmx_register());
 #endif
 
 #if defined(CONFIG_CRYPTO)
   /* Initialize the HW crypto and /dev/crypto */
 
-  up_cryptoinitialize();
+  nx_bootcall(up_cryptoinitialize());
 #endif
 
 #ifdef CONFIG_CRYPTO_CRYPTODEV
-  devcrypto_register();
+  nx_bootcall(devcrypto_register());
 #endif
 
 #ifdef CONFIG_UINPUT_TOUCH
-  uinput_touch_initialize();
+  nx_bootcall(uinput_touch_initialize());
 #endif
 
 #ifdef CONFIG_UINPUT_BUTTONS
-  uinput_button_initialize();
+  nx_bootcall(uinput_button_initialize());
 #endif
 
 #ifdef CONFIG_UINPUT_KEYBOARD
-  uinput_keyboard_initialize();
+  nx_bootcall(uinput_keyboard_initialize());
 #endif
 
 #ifdef CONFIG_NET_LOOPBACK
   /* Initialize the local loopback device */
 
-  localhost_initialize();
+  nx_bootcall(localhost_initialize());
 #endif
 
 #ifdef CONFIG_NET_TUN
   /* Initialize the TUN device */
 
-  tun_initialize();
+  nx_bootcall(tun_initialize());
 #endif
 
 #ifdef CONFIG_NETDEV_TELNET
   /* Initialize the Telnet session factory */
 
-  telnet_initialize();
+  nx_bootcall(telnet_initialize());
 #endif
 
 #ifdef CONFIG_USENSOR
-  usensor_initialize();
+  nx_bootcall(usensor_initialize());
 #endif
 
 #ifdef CONFIG_SENSORS_RPMSG
-  sensor_rpmsg_initialize();
+  nx_bootcall(sensor_rpmsg_initialize());
 #endif
 
 #ifdef CONFIG_SENSORS_MONITOR
-  sensor_monitor_initialize();
+  nx_bootcall(sensor_monitor_initialize());
 #endif
 
 #ifdef CONFIG_DEV_RPMSG_SERVER
-  rpmsgdev_server_init();
+  nx_bootcall(rpmsgdev_server_init());
 #endif
 
 #ifdef CONFIG_BLK_RPMSG_SERVER
-  rpmsgblk_server_init();
+  nx_bootcall(rpmsgblk_server_init());
 #endif
 
 #ifdef CONFIG_RPMSGMTD_SERVER
-  rpmsgmtd_server_init();
+  nx_bootcall(rpmsgmtd_server_init());
 #endif
 
 #ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER
   /* Initialize the user socket rpmsg server */
 
-  usrsock_rpmsg_server_initialize();
+  nx_bootcall(usrsock_rpmsg_server_initialize());
 #endif
 
 #ifdef CONFIG_NET_RPMSG_DRV_SERVER
   /* Initialize the net rpmsg default server */
 
-  net_rpmsg_drv_server_init();
+  nx_bootcall(net_rpmsg_drv_server_init());
 #endif
 
 #ifdef CONFIG_SMART_DEV_LOOP
-  smart_loop_register_driver();
+  nx_bootcall(smart_loop_register_driver());
 #endif
 
 #ifdef CONFIG_MTD_LOOP
-  mtd_loop_register();
+  nx_bootcall(mtd_loop_register());
 #endif
 
 #ifdef CONFIG_USBHOST_WAITER
-  usbhost_drivers_initialize();
+  nx_bootcall(usbhost_drivers_initialize());
 #endif
 
 #if defined(CONFIG_PCI) && !defined(CONFIG_PCI_LATE_DRIVERS_REGISTER)
-  pci_register_drivers();
+  nx_bootcall(pci_register_drivers());
 #endif
 
 #ifdef CONFIG_DRIVERS_VIRTIO
-  virtio_register_drivers();
+  nx_bootcall(virtio_register_drivers());
 #endif
 
 #ifdef CONFIG_DRIVERS_VHOST
-  vhost_register_drivers();
+  nx_bootcall(vhost_register_drivers());
 #endif
 
 #ifndef CONFIG_DEV_OPTEE_NONE
-  optee_register();
+  nx_bootcall(optee_register());
 #endif
 
 #ifdef CONFIG_THERMAL
-  thermal_init();
+  nx_bootcall(thermal_init());
 #endif
 
 #ifdef CONFIG_PTP_CLOCK_DUMMY
-  ptp_clock_dummy_initialize(0);
+  nx_bootcall(ptp_clock_dummy_initialize(0));
 #endif
 
 #ifdef CONFIG_FAKE_CAPTURE
-  fake_capture_initialize(2);
+  nx_bootcall(fake_capture_initialize(2));
 #endif
 
   drivers_trace_end();
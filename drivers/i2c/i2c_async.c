@@ -0,0 +1,206 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <nuttx/i2c/i2c_master.h>
+#include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The transfers block, so run them on the low-priority work queue if there
+ * is one.
+ */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define I2C_ASYNC_WORK LPWORK
+#else
+#  define I2C_ASYNC_WORK HPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The queue of the requests of one bus.  A slot is assigned to a bus while
+ * it has requests queued.
+ */
+
+struct i2c_busqueue_s
+{
+  FAR struct i2c_master_s *dev;   /* The bus, NULL if the slot is free */
+  sq_queue_t queue;               /* The requests, performed in order */
+  struct work_s work;             /* Performs the requests */
+  bool active;                    /* The work is queued or running */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct i2c_busqueue_s g_i2c_busqueue[CONFIG_I2C_ASYNC_NBUSES];
+static spinlock_t g_i2c_asynclock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_worker
+ *
+ * Description:
+ *   Perform the queued requests of a bus one after the other, for the
+ *   lower halves without their own queue of requests.
+ *
+ ****************************************************************************/
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_busqueue_s *bus = arg;
+  FAR struct i2c_async_s *req;
+  irqstate_t flags;
+  int ret;
+
+  flags = spin_lock_irqsave(&g_i2c_asynclock);
+  while ((req = (FAR struct i2c_async_s *)sq_peek(&bus->queue)) != NULL)
+    {
+      spin_unlock_irqrestore(&g_i2c_asynclock, flags);
+
+      ret = I2C_TRANSFER(req->dev, req->msgs, req->count);
+
+      /* Dequeue the request before the callback, which may queue it
+       * again.
+       */
+
+      flags = spin_lock_irqsave(&g_i2c_asynclock);
+      sq_remfirst(&bus->queue);
+      spin_unlock_irqrestore(&g_i2c_asynclock, flags);
+
+      req->callback(req, ret);
+
+      flags = spin_lock_irqsave(&g_i2c_asynclock);
+    }
+
+  /* The queue is empty, release the slot */
+
+  bus->active = false;
+  bus->dev    = NULL;
+  spin_unlock_irqrestore(&g_i2c_asynclock, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of I2C messages and call req->callback when the
+ *   transfer completes.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - Describes the messages and the completion callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_async_s *req)
+{
+  FAR struct i2c_busqueue_s *bus = NULL;
+  irqstate_t flags;
+  bool start;
+  int ret;
+  int i;
+
+  DEBUGASSERT(dev != NULL && req != NULL && req->msgs != NULL &&
+              req->count > 0 && req->callback != NULL);
+
+  req->dev = dev;
+
+  /* Let the lower half run the request from its interrupts if it can */
+
+  ret = I2C_TRANSFER_ASYNC(dev, req);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+
+  /* Find the queue of the bus, or a free one */
+
+  flags = spin_lock_irqsave(&g_i2c_asynclock);
+  for (i = 0; i < CONFIG_I2C_ASYNC_NBUSES; i++)
+    {
+      if (g_i2c_busqueue[i].dev == dev)
+        {
+          bus = &g_i2c_busqueue[i];
+          break;
+        }
+      else if (g_i2c_busqueue[i].dev == NULL && bus == NULL)
+        {
+          bus = &g_i2c_busqueue[i];
+        }
+    }
+
+  if (bus == NULL)
+    {
+      spin_unlock_irqrestore(&g_i2c_asynclock, flags);
+      return -ENOMEM;
+    }
+
+  bus->dev = dev;
+  sq_addlast(&req->node, &bus->queue);
+
+  start       = !bus->active;
+  bus->active = true;
+  spin_unlock_irqrestore(&g_i2c_asynclock, flags);
+
+  /* Start the worker unless it is already there to find the request */
+
+  if (start)
+    {
+      ret = work_queue(I2C_ASYNC_WORK, &bus->work, i2c_async_worker,
+                       bus, 0);
+    }
+  else
+    {
+      ret = OK;
+    }
+
+  return ret;
+}
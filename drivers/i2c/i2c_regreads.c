@@ -0,0 +1,86 @@
+/****************************************************************************
+ * drivers/i2c/i2c_regreads.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/i2c/i2c_master.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_setup_regreads
+ *
+ * Description:
+ *   Format the messages reading a batch of register blocks of one device.
+ *
+ * Input Parameters:
+ *   msgs   - Receives the 2 * nreads messages
+ *   config - Described the I2C configuration
+ *   reads  - The register blocks to read
+ *   nreads - The number of register blocks
+ *
+ * Returned Value:
+ *   The number of messages formatted.
+ *
+ ****************************************************************************/
+
+int i2c_setup_regreads(FAR struct i2c_msg_s *msgs,
+                       FAR const struct i2c_config_s *config,
+                       FAR struct i2c_regread_s *reads, int nreads)
+{
+  unsigned int flags;
+  int i;
+
+  /* 7- or 10-bit address? */
+
+  DEBUGASSERT(config->addrlen == 10 || config->addrlen == 7);
+  flags = (config->addrlen == 10) ? I2C_M_TEN : 0;
+
+  /* Each block is the write of its register, never terminated with a STOP
+   * condition, followed by a read with a repeated start.
+   */
+
+  for (i = 0; i < nreads; i++, msgs += 2)
+    {
+      msgs[0].frequency = config->frequency;
+      msgs[0].addr      = config->address;
+      msgs[0].flags     = flags | I2C_M_NOSTOP;
+      msgs[0].buffer    = &reads[i].reg;
+      msgs[0].length    = 1;
+
+      msgs[1].frequency = config->frequency;
+      msgs[1].addr      = config->address;
+      msgs[1].flags     = flags | I2C_M_READ;
+      msgs[1].buffer    = reads[i].buffer;
+      msgs[1].length    = reads[i].length;
+    }
+
+  return 2 * nreads;
+}
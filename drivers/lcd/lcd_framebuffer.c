@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -37,6 +39,11 @@
 #include <nuttx/lcd/lcd.h>
 #include <nuttx/video/fb.h>
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+#  include <nuttx/spinlock.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 #ifdef CONFIG_LCD_FRAMEBUFFER
 
 /****************************************************************************
@@ -47,6 +54,19 @@
 
 #define VIDEO_PLANE 0
 
+/* Work queue used to write the damaged areas to the LCD */
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+#  ifdef CONFIG_SCHED_LPWORK
+#    define LCDFB_WORK LPWORK
+#  else
+#    define LCDFB_WORK HPWORK
+#  endif
+
+#  define LCDFB_NAREAS CONFIG_LCD_FRAMEBUFFER_DAMAGE_NAREAS
+#  define LCDFB_PERIOD MSEC2TICK(CONFIG_LCD_FRAMEBUFFER_DAMAGE_PERIOD)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -65,6 +85,16 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  uint8_t ndamage;                  /* Number of entries in damage[] */
+  spinlock_t lock;                  /* Protects the damaged areas */
+  struct work_s work;               /* Deferred LCD update */
+
+  /* Areas of the framebuffer not yet written to the LCD */
+
+  struct fb_area_s damage[LCDFB_NAREAS];
+#endif
 };
 
 /****************************************************************************
@@ -76,6 +106,11 @@ struct lcdfb_dev_s
 static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
              FAR const struct fb_area_s *area);
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+static int lcdfb_damage(FAR struct fb_vtable_s *vtable,
+             FAR const struct fb_area_s *area);
+#endif
+
 /* Get information about the video controller configuration and the
  * configuration of each color plane.
  */
@@ -265,6 +300,178 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
   return OK;
 }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+/****************************************************************************
+ * Name: lcdfb_touch
+ *
+ * Description:
+ *   Return true if two areas overlap or are adjacent, so that writing
+ *   their bounding box costs little more than writing both.
+ *
+ ****************************************************************************/
+
+static bool lcdfb_touch(FAR const struct fb_area_s *a,
+                        FAR const struct fb_area_s *b)
+{
+  return a->x <= b->x + b->w && b->x <= a->x + a->w &&
+         a->y <= b->y + b->h && b->y <= a->y + a->h;
+}
+
+/****************************************************************************
+ * Name: lcdfb_union
+ *
+ * Description:
+ *   Grow an area to the bounding box of itself and another area.
+ *
+ ****************************************************************************/
+
+static void lcdfb_union(FAR struct fb_area_s *dest,
+                        FAR const struct fb_area_s *src)
+{
+  fb_coord_t x2 = MAX(dest->x + dest->w, src->x + src->w);
+  fb_coord_t y2 = MAX(dest->y + dest->h, src->y + src->h);
+
+  dest->x = MIN(dest->x, src->x);
+  dest->y = MIN(dest->y, src->y);
+  dest->w = x2 - dest->x;
+  dest->h = y2 - dest->y;
+}
+
+/****************************************************************************
+ * Name: lcdfb_damage_worker
+ *
+ * Description:
+ *   Write the accumulated damaged areas to the LCD.
+ *
+ ****************************************************************************/
+
+static void lcdfb_damage_worker(FAR void *arg)
+{
+  FAR struct lcdfb_dev_s *priv = arg;
+  struct fb_area_s damage[LCDFB_NAREAS];
+  irqstate_t flags;
+  int ndamage;
+  int i;
+
+  /* Take the list so that new damage can accumulate during the update */
+
+  flags   = spin_lock_irqsave(&priv->lock);
+  ndamage = priv->ndamage;
+  memcpy(damage, priv->damage, ndamage * sizeof(struct fb_area_s));
+  priv->ndamage = 0;
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  for (i = 0; i < ndamage; i++)
+    {
+      lcdfb_updateearea(&priv->vtable, &damage[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: lcdfb_damage
+ *
+ * Description:
+ *   Add an updated area of the framebuffer to the damaged areas and
+ *   schedule their update of the LCD.
+ *
+ ****************************************************************************/
+
+static int lcdfb_damage(FAR struct fb_vtable_s *vtable,
+                        FAR const struct fb_area_s *area)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+  struct fb_area_s rect;
+  irqstate_t flags;
+  uint32_t bestcost;
+  uint32_t cost;
+  bool queue;
+  int best;
+  int i;
+
+  /* Clip to fit in the framebuffer, NULL means all of it */
+
+  rect.x = 0;
+  rect.y = 0;
+  rect.w = priv->xres;
+  rect.h = priv->yres;
+
+  if (area != NULL)
+    {
+      if (area->x >= priv->xres || area->y >= priv->yres)
+        {
+          return OK;
+        }
+
+      rect.x = area->x;
+      rect.y = area->y;
+      rect.w = MIN(area->w, priv->xres - area->x);
+      rect.h = MIN(area->h, priv->yres - area->y);
+    }
+
+  if (rect.w == 0 || rect.h == 0)
+    {
+      return OK;
+    }
+
+  flags = spin_lock_irqsave(&priv->lock);
+
+  /* Absorb every damaged area that touches the new one.  The bounding box
+   * may then touch areas that were already checked, so start over.
+   */
+
+  for (i = 0; i < priv->ndamage; )
+    {
+      if (lcdfb_touch(&priv->damage[i], &rect))
+        {
+          lcdfb_union(&rect, &priv->damage[i]);
+          priv->damage[i] = priv->damage[--priv->ndamage];
+          i = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  /* If there is no room left, merge with the area that grows least */
+
+  if (priv->ndamage >= LCDFB_NAREAS)
+    {
+      best     = 0;
+      bestcost = UINT32_MAX;
+
+      for (i = 0; i < priv->ndamage; i++)
+        {
+          struct fb_area_s tmp = priv->damage[i];
+
+          lcdfb_union(&tmp, &rect);
+          cost = (uint32_t)tmp.w * tmp.h -
+                 (uint32_t)priv->damage[i].w * priv->damage[i].h;
+          if (cost < bestcost)
+            {
+              best     = i;
+              bestcost = cost;
+            }
+        }
+
+      lcdfb_union(&rect, &priv->damage[best]);
+      priv->damage[best] = priv->damage[--priv->ndamage];
+    }
+
+  priv->damage[priv->ndamage++] = rect;
+  queue = work_available(&priv->work);
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  if (queue)
+    {
+      work_queue(LCDFB_WORK, &priv->work, lcdfb_damage_worker, priv,
+                 LCDFB_PERIOD);
+    }
+
+  return OK;
+}
+#endif /* CONFIG_LCD_FRAMEBUFFER_DAMAGE */
+
 /****************************************************************************
  * Name: lcdfb_getvideoinfo
  ****************************************************************************/
@@ -623,6 +830,9 @@ int up_fbinitialize(int display)
   /* Initialize the LCD-independent fields of the state structure */
 
   priv->display             = display;
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  spin_lock_init(&priv->lock);
+#endif
 
   priv->vtable.getvideoinfo = lcdfb_getvideoinfo,
   priv->vtable.getplaneinfo = lcdfb_getplaneinfo,
@@ -634,7 +844,11 @@ int up_fbinitialize(int display)
   priv->vtable.getcursor    = lcdfb_getcursor,
   priv->vtable.setcursor    = lcdfb_setcursor,
 #endif
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  priv->vtable.updatearea   = lcdfb_damage,
+#else
   priv->vtable.updatearea   = lcdfb_updateearea,
+#endif
   priv->vtable.setpower     = lcdfb_setpower,
   priv->vtable.ioctl        = lcdfb_ioctl,
   priv->vtable.open         = lcdfb_open,
@@ -819,6 +1033,12 @@ void up_fbuninitialize(int display)
               g_lcdfb = priv->flink;
             }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+          /* Discard the pending update */
+
+          work_cancel_sync(LCDFB_WORK, &priv->work);
+#endif
+
 #ifndef CONFIG_LCD_EXTERNINIT
           /* Uninitialize the LCD */
 
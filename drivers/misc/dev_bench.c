@@ -0,0 +1,1118 @@
+/****************************************************************************
+ * drivers/misc/dev_bench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/drivers.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_NITER     CONFIG_DEV_BENCH_ITERATIONS
+#define BENCH_NBLOCKS   16    /* The blocks allocated in a batch */
+#define BENCH_BLOCKSIZE 64    /* The size of the blocks allocated */
+#define BENCH_CHUNK     512   /* The size of a pipe or socket transfer */
+#define BENCH_LINESIZE  64    /* The maximum size of a result line */
+#define BENCH_NAMESIZE  16    /* The maximum size of a selection */
+
+#define BENCH_HEADER    "# name,ops,total_ns,ns_per_op\n"
+
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+#  define BENCH_HAVE_PIPE
+#endif
+
+#if defined(CONFIG_NET_LOCAL_STREAM)
+#  define BENCH_HAVE_LOCAL
+#endif
+
+#if defined(BENCH_HAVE_PIPE) && CONFIG_DEV_BENCH_EPOLL_NFDS > 0
+#  define BENCH_HAVE_EPOLL
+#endif
+
+/* The tags are only known to be usable when KASan runs on them */
+
+#if defined(CONFIG_ARCH_HAVE_MEMTAG) && defined(CONFIG_MM_KASAN_HW_TAGS)
+#  define BENCH_HAVE_MEMTAG
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_s;
+
+/* One benchmark, run returns the number of the operations measured and
+ * their total time, or a negated errno.
+ */
+
+struct bench_case_s
+{
+  FAR const char *name;
+  CODE int (*run)(FAR struct bench_s *bench, int arg, FAR uint64_t *ns);
+  int arg;
+};
+
+/* The state shared with the helper thread of a benchmark */
+
+struct bench_s
+{
+  mutex_t lock;                  /* Serialize the runs */
+  char select[BENCH_NAMESIZE];   /* The selected benchmarks, "" for all */
+  CODE void (*helper)(FAR struct bench_s *bench);
+  sem_t ping;                    /* Signal the helper */
+  sem_t pong;                    /* Signal the benchmark */
+  sem_t done;                    /* The helper has finished */
+  mutex_t mutex;                 /* The mutex handed off */
+  clock_t stamp;                 /* The time the work was queued */
+  clock_t total;                 /* The total latency of the work */
+  int niter;                     /* The operations of the helper */
+#ifdef BENCH_HAVE_PIPE
+  struct file pipe[2];           /* The pipe of the pipe benchmark */
+#endif
+#ifdef BENCH_HAVE_LOCAL
+  struct socket sock[2];         /* The sockets of the local benchmark */
+#endif
+  char buffer[BENCH_CHUNK];      /* The data transferred */
+};
+
+/* The result of the runs of one open file */
+
+struct bench_file_s
+{
+  FAR char *result;
+  size_t len;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int bench_open(FAR struct file *filep);
+static int bench_close(FAR struct file *filep);
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen);
+static ssize_t bench_write(FAR struct file *filep, FAR const char *buffer,
+                           size_t buflen);
+
+static int bench_switch(FAR struct bench_s *bench, int arg,
+                        FAR uint64_t *ns);
+static int bench_sem(FAR struct bench_s *bench, int arg, FAR uint64_t *ns);
+static int bench_mutex(FAR struct bench_s *bench, int arg,
+                       FAR uint64_t *ns);
+static int bench_handoff(FAR struct bench_s *bench, int arg,
+                         FAR uint64_t *ns);
+#ifdef CONFIG_SCHED_WORKQUEUE
+static int bench_work(FAR struct bench_s *bench, int arg, FAR uint64_t *ns);
+#endif
+static int bench_wdog(FAR struct bench_s *bench, int arg, FAR uint64_t *ns);
+static int bench_malloc(FAR struct bench_s *bench, int arg,
+                        FAR uint64_t *ns);
+static int bench_mempool(FAR struct bench_s *bench, int arg,
+                         FAR uint64_t *ns);
+#ifdef CONFIG_MM_IOB
+static int bench_iob(FAR struct bench_s *bench, int arg, FAR uint64_t *ns);
+#endif
+#ifdef BENCH_HAVE_PIPE
+static int bench_pipe(FAR struct bench_s *bench, int arg, FAR uint64_t *ns);
+#endif
+#ifdef BENCH_HAVE_LOCAL
+static int bench_local(FAR struct bench_s *bench, int arg,
+                       FAR uint64_t *ns);
+#endif
+#ifdef BENCH_HAVE_EPOLL
+static int bench_epoll(FAR struct bench_s *bench, int arg,
+                       FAR uint64_t *ns);
+#endif
+#ifdef BENCH_HAVE_MEMTAG
+static int bench_memtag_bypass(FAR struct bench_s *bench, int arg,
+                               FAR uint64_t *ns);
+static int bench_memtag_tag(FAR struct bench_s *bench, int arg,
+                            FAR uint64_t *ns);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_bench_fops =
+{
+  bench_open,  /* open */
+  bench_close, /* close */
+  bench_read,  /* read */
+  bench_write, /* write */
+};
+
+static const struct bench_case_s g_bench_cases[] =
+{
+  { "switch",        bench_switch,        0 },
+  { "sem",           bench_sem,           0 },
+  { "mutex",         bench_mutex,         0 },
+  { "mutex_handoff", bench_handoff,       0 },
+#ifdef CONFIG_SCHED_HPWORK
+  { "work_hp",       bench_work,          HPWORK },
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  { "work_lp",       bench_work,          LPWORK },
+#endif
+  { "wdog",          bench_wdog,          0 },
+  { "malloc",        bench_malloc,        0 },
+  { "mempool",       bench_mempool,       0 },
+#ifdef CONFIG_MM_IOB
+  { "iob",           bench_iob,           0 },
+#endif
+#ifdef BENCH_HAVE_PIPE
+  { "pipe",          bench_pipe,          0 },
+#endif
+#ifdef BENCH_HAVE_LOCAL
+  { "local",         bench_local,         0 },
+#endif
+#ifdef BENCH_HAVE_EPOLL
+  { "epoll_1",       bench_epoll,         1 },
+  { "epoll_max",     bench_epoll,         CONFIG_DEV_BENCH_EPOLL_NFDS },
+#endif
+#ifdef BENCH_HAVE_MEMTAG
+  { "memtag_bypass", bench_memtag_bypass, 0 },
+  { "memtag_64",     bench_memtag_tag,    64 },
+  { "memtag_4k",     bench_memtag_tag,    4096 },
+#endif
+};
+
+static struct bench_s g_bench =
+{
+  NXMUTEX_INITIALIZER,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_ns
+ *
+ * Description:
+ *   Convert a perf_gettime() interval to nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t bench_ns(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: bench_thread and bench_spawn
+ *
+ * Description:
+ *   Run the helper of a benchmark in a thread of the priority of the
+ *   caller, which waits for it with bench_join().
+ *
+ ****************************************************************************/
+
+static int bench_thread(int argc, FAR char *argv[])
+{
+  g_bench.helper(&g_bench);
+  nxsem_post(&g_bench.done);
+  return 0;
+}
+
+static int bench_spawn(FAR struct bench_s *bench,
+                       CODE void (*helper)(FAR struct bench_s *bench))
+{
+  struct sched_param param;
+  int ret;
+
+  ret = nxsched_get_param(0, &param);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  bench->helper = helper;
+  ret = kthread_create("bench", param.sched_priority,
+                       CONFIG_DEV_BENCH_STACKSIZE, bench_thread, NULL);
+  return ret < 0 ? ret : OK;
+}
+
+static void bench_join(FAR struct bench_s *bench)
+{
+  nxsem_wait_uninterruptible(&bench->done);
+}
+
+/****************************************************************************
+ * Name: bench_switch
+ *
+ * Description:
+ *   Measure a context switch, the two threads block in turn on a
+ *   semaphore the other one posts.
+ *
+ ****************************************************************************/
+
+static void bench_switch_helper(FAR struct bench_s *bench)
+{
+  int i;
+
+  for (i = 0; i < bench->niter; i++)
+    {
+      nxsem_wait_uninterruptible(&bench->ping);
+      nxsem_post(&bench->pong);
+    }
+}
+
+static int bench_switch(FAR struct bench_s *bench, int arg,
+                        FAR uint64_t *ns)
+{
+  clock_t start;
+  int ret;
+  int i;
+
+  bench->niter = BENCH_NITER;
+  ret = bench_spawn(bench, bench_switch_helper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      nxsem_post(&bench->ping);
+      nxsem_wait_uninterruptible(&bench->pong);
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  bench_join(bench);
+  return 2 * BENCH_NITER;
+}
+
+/****************************************************************************
+ * Name: bench_sem
+ *
+ * Description:
+ *   Measure a post and a wait of a semaphore without contention.
+ *
+ ****************************************************************************/
+
+static int bench_sem(FAR struct bench_s *bench, int arg, FAR uint64_t *ns)
+{
+  clock_t start;
+  int i;
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      nxsem_post(&bench->ping);
+      nxsem_wait_uninterruptible(&bench->ping);
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  return BENCH_NITER;
+}
+
+/****************************************************************************
+ * Name: bench_mutex
+ *
+ * Description:
+ *   Measure a lock and an unlock of a mutex without contention.
+ *
+ ****************************************************************************/
+
+static int bench_mutex(FAR struct bench_s *bench, int arg,
+                       FAR uint64_t *ns)
+{
+  clock_t start;
+  int i;
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      nxmutex_lock(&bench->mutex);
+      nxmutex_unlock(&bench->mutex);
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  return BENCH_NITER;
+}
+
+/****************************************************************************
+ * Name: bench_handoff
+ *
+ * Description:
+ *   Measure the handoff of a mutex between two threads, each one yields
+ *   while holding it so the other one always has to wait.
+ *
+ ****************************************************************************/
+
+static void bench_handoff_helper(FAR struct bench_s *bench)
+{
+  int i;
+
+  for (i = 0; i < bench->niter; i++)
+    {
+      nxmutex_lock(&bench->mutex);
+      sched_yield();
+      nxmutex_unlock(&bench->mutex);
+    }
+}
+
+static int bench_handoff(FAR struct bench_s *bench, int arg,
+                         FAR uint64_t *ns)
+{
+  clock_t start;
+  int ret;
+
+  bench->niter = BENCH_NITER;
+  ret = bench_spawn(bench, bench_handoff_helper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  start = perf_gettime();
+  bench_handoff_helper(bench);
+  bench_join(bench);
+  *ns = bench_ns(perf_gettime() - start);
+  return 2 * BENCH_NITER;
+}
+
+/****************************************************************************
+ * Name: bench_work
+ *
+ * Description:
+ *   Measure the latency from the queueing of a work until it runs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void bench_worker(FAR void *arg)
+{
+  FAR struct bench_s *bench = arg;
+
+  bench->total += perf_gettime() - bench->stamp;
+  nxsem_post(&bench->pong);
+}
+
+static int bench_work(FAR struct bench_s *bench, int arg, FAR uint64_t *ns)
+{
+  struct work_s work;
+  int ret;
+  int i;
+
+  memset(&work, 0, sizeof(work));
+  bench->total = 0;
+
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      bench->stamp = perf_gettime();
+      ret = work_queue(arg, &work, bench_worker, bench, 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nxsem_wait_uninterruptible(&bench->pong);
+    }
+
+  *ns = bench_ns(bench->total);
+  return BENCH_NITER;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_wdog
+ *
+ * Description:
+ *   Measure the start and the cancel of a watchdog.
+ *
+ ****************************************************************************/
+
+static void bench_timeout(wdparm_t arg)
+{
+}
+
+static int bench_wdog(FAR struct bench_s *bench, int arg, FAR uint64_t *ns)
+{
+  struct wdog_s wdog;
+  clock_t start;
+  int i;
+
+  memset(&wdog, 0, sizeof(wdog));
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      wd_start(&wdog, SEC2TICK(60), bench_timeout, 0);
+      wd_cancel(&wdog);
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  return BENCH_NITER;
+}
+
+/****************************************************************************
+ * Name: bench_malloc
+ *
+ * Description:
+ *   Measure the allocation and the free of a block from the kernel heap,
+ *   in batches so that some blocks are in use.
+ *
+ ****************************************************************************/
+
+static int bench_malloc(FAR struct bench_s *bench, int arg,
+                        FAR uint64_t *ns)
+{
+  FAR void *blocks[BENCH_NBLOCKS];
+  clock_t start;
+  int ret = BENCH_NITER * BENCH_NBLOCKS;
+  int i;
+  int j;
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      for (j = 0; j < BENCH_NBLOCKS; j++)
+        {
+          blocks[j] = kmm_malloc(BENCH_BLOCKSIZE);
+        }
+
+      for (j = 0; j < BENCH_NBLOCKS; j++)
+        {
+          if (blocks[j] == NULL)
+            {
+              ret = -ENOMEM;
+            }
+
+          kmm_free(blocks[j]);
+        }
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bench_mempool
+ *
+ * Description:
+ *   Measure the allocation and the free of a block from a memory pool, in
+ *   the same batches as bench_malloc().
+ *
+ ****************************************************************************/
+
+static FAR void *bench_pool_alloc(FAR struct mempool_s *pool, size_t size)
+{
+  return kmm_malloc(size);
+}
+
+static void bench_pool_free(FAR struct mempool_s *pool, FAR void *addr)
+{
+  kmm_free(addr);
+}
+
+static int bench_mempool(FAR struct bench_s *bench, int arg,
+                         FAR uint64_t *ns)
+{
+  FAR void *blocks[BENCH_NBLOCKS];
+  FAR struct mempool_s *pool;
+  clock_t start;
+  int ret;
+  int i;
+  int j;
+
+  pool = kmm_zalloc(sizeof(*pool));
+  if (pool == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  pool->blocksize   = BENCH_BLOCKSIZE;
+  pool->initialsize = BENCH_NBLOCKS * (BENCH_BLOCKSIZE + 32);
+  pool->expandsize  = BENCH_NBLOCKS * (BENCH_BLOCKSIZE + 32);
+  pool->alloc       = bench_pool_alloc;
+  pool->free        = bench_pool_free;
+
+  ret = mempool_init(pool, "bench");
+  if (ret < 0)
+    {
+      kmm_free(pool);
+      return ret;
+    }
+
+  ret = BENCH_NITER * BENCH_NBLOCKS;
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      for (j = 0; j < BENCH_NBLOCKS; j++)
+        {
+          blocks[j] = mempool_allocate(pool);
+        }
+
+      for (j = 0; j < BENCH_NBLOCKS; j++)
+        {
+          if (blocks[j] == NULL)
+            {
+              ret = -ENOMEM;
+              continue;
+            }
+
+          mempool_release(pool, blocks[j]);
+        }
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  mempool_deinit(pool);
+  kmm_free(pool);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bench_iob
+ *
+ * Description:
+ *   Measure the allocation and the free of an IOB.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_IOB
+static int bench_iob(FAR struct bench_s *bench, int arg, FAR uint64_t *ns)
+{
+  FAR struct iob_s *iob;
+  clock_t start;
+  int i;
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      iob = iob_tryalloc(false);
+      if (iob == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      iob_free(iob);
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  return BENCH_NITER;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_pipe
+ *
+ * Description:
+ *   Measure the transfer of BENCH_CHUNK bytes through a pipe from another
+ *   thread.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_HAVE_PIPE
+static void bench_pipe_helper(FAR struct bench_s *bench)
+{
+  int i;
+
+  for (i = 0; i < bench->niter; i++)
+    {
+      if (file_write(&bench->pipe[1], bench->buffer, BENCH_CHUNK) < 0)
+        {
+          break;
+        }
+    }
+
+  file_close(&bench->pipe[1]);
+}
+
+static int bench_pipe(FAR struct bench_s *bench, int arg, FAR uint64_t *ns)
+{
+  FAR struct file *filep[2];
+  char buffer[BENCH_CHUNK];
+  clock_t start;
+  ssize_t nread;
+  size_t total = 0;
+  int ret;
+
+  memset(bench->pipe, 0, sizeof(bench->pipe));
+  filep[0] = &bench->pipe[0];
+  filep[1] = &bench->pipe[1];
+
+  ret = file_pipe(filep, CONFIG_DEV_PIPE_SIZE, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  bench->niter = BENCH_NITER;
+  ret = bench_spawn(bench, bench_pipe_helper);
+  if (ret < 0)
+    {
+      file_close(&bench->pipe[1]);
+      file_close(&bench->pipe[0]);
+      return ret;
+    }
+
+  /* Read until the helper closes the write end */
+
+  start = perf_gettime();
+  while ((nread = file_read(&bench->pipe[0], buffer, BENCH_CHUNK)) > 0)
+    {
+      total += nread;
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  bench_join(bench);
+  file_close(&bench->pipe[0]);
+  return total == BENCH_NITER * BENCH_CHUNK ? BENCH_NITER : -EIO;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_local
+ *
+ * Description:
+ *   Measure the transfer of BENCH_CHUNK bytes through a local stream
+ *   socket from another thread.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_HAVE_LOCAL
+static void bench_local_helper(FAR struct bench_s *bench)
+{
+  int i;
+
+  for (i = 0; i < bench->niter; i++)
+    {
+      if (psock_send(&bench->sock[1], bench->buffer, BENCH_CHUNK, 0) < 0)
+        {
+          break;
+        }
+    }
+
+  psock_close(&bench->sock[1]);
+}
+
+static int bench_local(FAR struct bench_s *bench, int arg,
+                       FAR uint64_t *ns)
+{
+  FAR struct socket *psock[2];
+  char buffer[BENCH_CHUNK];
+  clock_t start;
+  ssize_t nread;
+  size_t total = 0;
+  int ret;
+
+  memset(bench->sock, 0, sizeof(bench->sock));
+  psock[0] = &bench->sock[0];
+  psock[1] = &bench->sock[1];
+
+  ret = psock_socketpair(AF_LOCAL, SOCK_STREAM, 0, psock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  bench->niter = BENCH_NITER;
+  ret = bench_spawn(bench, bench_local_helper);
+  if (ret < 0)
+    {
+      psock_close(&bench->sock[1]);
+      psock_close(&bench->sock[0]);
+      return ret;
+    }
+
+  /* Receive until the helper closes its socket */
+
+  start = perf_gettime();
+  while ((nread = psock_recv(&bench->sock[0], buffer, BENCH_CHUNK, 0)) > 0)
+    {
+      total += nread;
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  bench_join(bench);
+  psock_close(&bench->sock[0]);
+  return total == BENCH_NITER * BENCH_CHUNK ? BENCH_NITER : -EIO;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_epoll
+ *
+ * Description:
+ *   Measure epoll_wait() returning one ready pipe out of the arg pipes of
+ *   the set, with the write and the read of one byte that make it ready.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_HAVE_EPOLL
+static int bench_epoll(FAR struct bench_s *bench, int arg, FAR uint64_t *ns)
+{
+  struct epoll_event ev;
+  FAR int *fds;
+  clock_t start;
+  char byte = 0;
+  int npipes;
+  int epfd;
+  int ret;
+  int i;
+
+  fds = kmm_malloc(2 * arg * sizeof(int));
+  if (fds == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (epfd < 0)
+    {
+      ret = -get_errno();
+      goto errout_with_fds;
+    }
+
+  for (npipes = 0; npipes < arg; npipes++)
+    {
+      if (pipe2(&fds[2 * npipes], O_CLOEXEC) < 0)
+        {
+          ret = -get_errno();
+          goto errout_with_pipes;
+        }
+
+      ev.events   = EPOLLIN;
+      ev.data.u32 = npipes;
+      if (epoll_ctl(epfd, EPOLL_CTL_ADD, fds[2 * npipes], &ev) < 0)
+        {
+          ret = -get_errno();
+          npipes++;
+          goto errout_with_pipes;
+        }
+    }
+
+  ret = BENCH_NITER;
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      nx_write(fds[2 * (i % arg) + 1], &byte, 1);
+      if (epoll_wait(epfd, &ev, 1, 0) != 1 || ev.data.u32 != i % arg)
+        {
+          ret = -EIO;
+          break;
+        }
+
+      nx_read(fds[2 * (i % arg)], &byte, 1);
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+
+errout_with_pipes:
+  while (npipes-- > 0)
+    {
+      nx_close(fds[2 * npipes]);
+      nx_close(fds[2 * npipes + 1]);
+    }
+
+  nx_close(epfd);
+
+errout_with_fds:
+  kmm_free(fds);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_memtag_bypass
+ *
+ * Description:
+ *   Measure the bypass of the tag checks done around each heap operation.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_HAVE_MEMTAG
+static int bench_memtag_bypass(FAR struct bench_s *bench, int arg,
+                               FAR uint64_t *ns)
+{
+  clock_t start;
+  bool state;
+  int i;
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      state = up_memtag_bypass(true);
+      up_memtag_bypass(state);
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  return BENCH_NITER;
+}
+
+/****************************************************************************
+ * Name: bench_memtag_tag
+ *
+ * Description:
+ *   Measure the tagging of a heap block of 'arg' bytes, as done on each
+ *   allocation and free.  The block is tagged again with its own tag.
+ *
+ ****************************************************************************/
+
+static int bench_memtag_tag(FAR struct bench_s *bench, int arg,
+                            FAR uint64_t *ns)
+{
+  FAR void *block;
+  clock_t start;
+  int i;
+
+  block = kmm_memalign(64, arg);
+  if (block == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      up_memtag_tag_mem(block, arg);
+    }
+
+  *ns = bench_ns(perf_gettime() - start);
+  kmm_free(block);
+  return BENCH_NITER;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_run
+ *
+ * Description:
+ *   Run the selected benchmarks and format their results.
+ *
+ ****************************************************************************/
+
+static int bench_run(FAR struct bench_s *bench,
+                     FAR struct bench_file_s *priv)
+{
+  FAR const struct bench_case_s *bc;
+  size_t size;
+  uint64_t ns;
+  int ret;
+
+  size = sizeof(BENCH_HEADER) + nitems(g_bench_cases) * BENCH_LINESIZE;
+  priv->result = kmm_malloc(size);
+  if (priv->result == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->len = strlcpy(priv->result, BENCH_HEADER, size);
+
+  nxsem_init(&bench->ping, 0, 0);
+  nxsem_init(&bench->pong, 0, 0);
+  nxsem_init(&bench->done, 0, 0);
+  nxmutex_init(&bench->mutex);
+
+  for (bc = g_bench_cases; bc < &g_bench_cases[nitems(g_bench_cases)];
+       bc++)
+    {
+      if (strncmp(bc->name, bench->select, strlen(bench->select)) != 0)
+        {
+          continue;
+        }
+
+      ns  = 0;
+      ret = bc->run(bench, bc->arg, &ns);
+      if (ret > 0)
+        {
+          priv->len += snprintf(priv->result + priv->len, size - priv->len,
+                                "%s,%d,%" PRIu64 ",%" PRIu64 "\n",
+                                bc->name, ret, ns, ns / ret);
+        }
+      else
+        {
+          priv->len += snprintf(priv->result + priv->len, size - priv->len,
+                                "# %s: %d\n", bc->name, ret);
+        }
+    }
+
+  nxmutex_destroy(&bench->mutex);
+  nxsem_destroy(&bench->done);
+  nxsem_destroy(&bench->pong);
+  nxsem_destroy(&bench->ping);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_open
+ ****************************************************************************/
+
+static int bench_open(FAR struct file *filep)
+{
+  FAR struct bench_file_s *priv;
+
+  priv = kmm_zalloc(sizeof(*priv));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_close
+ ****************************************************************************/
+
+static int bench_close(FAR struct file *filep)
+{
+  FAR struct bench_file_s *priv = filep->f_priv;
+
+  kmm_free(priv->result);
+  kmm_free(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_read
+ *
+ * Description:
+ *   The first read runs the benchmarks, the following ones return the rest
+ *   of the results.
+ *
+ ****************************************************************************/
+
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct bench_file_s *priv = filep->f_priv;
+  int ret;
+
+  if (priv->result == NULL)
+    {
+      ret = nxmutex_lock(&g_bench.lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = bench_run(&g_bench, priv);
+      nxmutex_unlock(&g_bench.lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (filep->f_pos >= priv->len)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, priv->len - filep->f_pos);
+  memcpy(buffer, priv->result + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: bench_write
+ *
+ * Description:
+ *   Select the benchmarks of the following runs by the prefix of their
+ *   names, an empty line selects all of them.
+ *
+ ****************************************************************************/
+
+static ssize_t bench_write(FAR struct file *filep, FAR const char *buffer,
+                           size_t buflen)
+{
+  size_t len = buflen;
+  int ret;
+
+  while (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == ' '))
+    {
+      len--;
+    }
+
+  if (len >= BENCH_NAMESIZE)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&g_bench.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(g_bench.select, buffer, len);
+  g_bench.select[len] = '\0';
+  nxmutex_unlock(&g_bench.lock);
+  return buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devbench_register
+ *
+ * Description:
+ *   Register the /dev/bench kernel micro-benchmarks
+ *
+ ****************************************************************************/
+
+int devbench_register(void)
+{
+  return register_driver("/dev/bench", &g_bench_fops, 0666, NULL);
+}
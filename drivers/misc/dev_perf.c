@@ -0,0 +1,536 @@
+/****************************************************************************
+ * drivers/misc/dev_perf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/drivers.h>
+#include <nuttx/perf_event.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PERF_MAX_COUNTERS 32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The event counted by one open file */
+
+struct perf_event_s
+{
+  mutex_t lock;                   /* Serialize the file operations */
+  struct perf_event_attr_s attr;  /* The event counted */
+  uint32_t event;                 /* The architecture event */
+  int idx;                        /* The counter, -1 before PERFIOC_SETUP */
+  bool enabled;                   /* The event is being counted */
+  uint64_t count;                 /* The count of the stopped counters */
+  uint64_t sum;                   /* The sum of a read of the CPUs */
+};
+
+/* The counters, each counter counts one event on every CPU */
+
+struct perf_s
+{
+  spinlock_t lock;                /* Protect the counters */
+  int ncounters;                  /* The number of counters */
+  int ntasks;                     /* The number of enabled task events */
+  FAR struct perf_event_s *events[PERF_MAX_COUNTERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int perf_open(FAR struct file *filep);
+static int perf_close(FAR struct file *filep);
+static ssize_t perf_read(FAR struct file *filep, FAR char *buffer,
+                         size_t buflen);
+static int perf_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_perf_fops =
+{
+  perf_open,  /* open */
+  perf_close, /* close */
+  perf_read,  /* read */
+  NULL,       /* write */
+  NULL,       /* seek */
+  perf_ioctl, /* ioctl */
+};
+
+static struct perf_s g_perf;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: perf_cpu_start, perf_cpu_stop, perf_cpu_read
+ *
+ * Description:
+ *   Start, stop or read the counter of a CPU event on the calling CPU.
+ *
+ ****************************************************************************/
+
+static int perf_cpu_start(FAR void *arg)
+{
+  FAR struct perf_event_s *ev = arg;
+
+  up_pmu_start(ev->idx, ev->event);
+  return OK;
+}
+
+static int perf_cpu_stop(FAR void *arg)
+{
+  FAR struct perf_event_s *ev = arg;
+
+  ev->sum += up_pmu_stop(ev->idx);
+  return OK;
+}
+
+static int perf_cpu_read(FAR void *arg)
+{
+  FAR struct perf_event_s *ev = arg;
+
+  ev->sum += up_pmu_read(ev->idx);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: perf_cpu_call
+ *
+ * Description:
+ *   Run a function on the CPUs counted by a CPU event, and return the sum
+ *   of their counts.
+ *
+ ****************************************************************************/
+
+static uint64_t perf_cpu_call(FAR struct perf_event_s *ev,
+                              CODE int (*func)(FAR void *arg))
+{
+#ifdef CONFIG_SMP
+  int cpu;
+#endif
+
+  ev->sum = 0;
+
+#ifdef CONFIG_SMP
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (ev->attr.cpu < 0 || ev->attr.cpu == cpu)
+        {
+          nxsched_smp_call_single(cpu, func, ev);
+        }
+    }
+#else
+  func(ev);
+#endif
+
+  return ev->sum;
+}
+
+/****************************************************************************
+ * Name: perf_enable
+ ****************************************************************************/
+
+static void perf_enable(FAR struct perf_event_s *ev)
+{
+  irqstate_t flags;
+
+  if (ev->idx < 0 || ev->enabled)
+    {
+      return;
+    }
+
+  if (ev->attr.pid < 0)
+    {
+      ev->enabled = true;
+      perf_cpu_call(ev, perf_cpu_start);
+      return;
+    }
+
+  /* A task event starts when the task is next resumed, or now if it
+   * is the calling task.
+   */
+
+  flags = spin_lock_irqsave(&g_perf.lock);
+  ev->enabled = true;
+  g_perf.ntasks++;
+  if (ev->attr.pid == nxsched_gettid())
+    {
+      up_pmu_start(ev->idx, ev->event);
+    }
+
+  spin_unlock_irqrestore(&g_perf.lock, flags);
+}
+
+/****************************************************************************
+ * Name: perf_disable
+ ****************************************************************************/
+
+static void perf_disable(FAR struct perf_event_s *ev)
+{
+  irqstate_t flags;
+
+  if (!ev->enabled)
+    {
+      return;
+    }
+
+  if (ev->attr.pid < 0)
+    {
+      ev->count += perf_cpu_call(ev, perf_cpu_stop);
+      ev->enabled = false;
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_perf.lock);
+  if (ev->attr.pid == nxsched_gettid())
+    {
+      ev->count += up_pmu_stop(ev->idx);
+    }
+
+  ev->enabled = false;
+  g_perf.ntasks--;
+  spin_unlock_irqrestore(&g_perf.lock, flags);
+}
+
+/****************************************************************************
+ * Name: perf_count
+ *
+ * Description:
+ *   Return the count of an event.  The count of a task event running on
+ *   another CPU does not include its current time slice.
+ *
+ ****************************************************************************/
+
+static uint64_t perf_count(FAR struct perf_event_s *ev)
+{
+  irqstate_t flags;
+  uint64_t count;
+
+  if (!ev->enabled)
+    {
+      return ev->count;
+    }
+
+  if (ev->attr.pid < 0)
+    {
+      return ev->count + perf_cpu_call(ev, perf_cpu_read);
+    }
+
+  flags = spin_lock_irqsave(&g_perf.lock);
+  count = ev->count;
+  if (ev->attr.pid == nxsched_gettid())
+    {
+      count += up_pmu_read(ev->idx);
+    }
+
+  spin_unlock_irqrestore(&g_perf.lock, flags);
+  return count;
+}
+
+/****************************************************************************
+ * Name: perf_setup
+ ****************************************************************************/
+
+static int perf_setup(FAR struct perf_event_s *ev,
+                      FAR const struct perf_event_attr_s *attr)
+{
+  irqstate_t flags;
+  int event;
+  int idx;
+
+  if (ev->idx >= 0)
+    {
+      return -EBUSY;
+    }
+
+  if (attr->pid < 0 && attr->cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  if (attr->type == PERF_TYPE_HARDWARE)
+    {
+      event = up_pmu_event(attr->config);
+      if (event < 0)
+        {
+          return event;
+        }
+    }
+  else if (attr->type == PERF_TYPE_RAW)
+    {
+      event = attr->config;
+    }
+  else
+    {
+      return -ENOENT;
+    }
+
+  flags = spin_lock_irqsave(&g_perf.lock);
+  for (idx = 0; idx < g_perf.ncounters; idx++)
+    {
+      if (g_perf.events[idx] == NULL)
+        {
+          g_perf.events[idx] = ev;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_perf.lock, flags);
+
+  if (idx >= g_perf.ncounters)
+    {
+      return -ENOSPC;
+    }
+
+  ev->attr  = *attr;
+  ev->event = event;
+  ev->idx   = idx;
+  ev->count = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: perf_open
+ ****************************************************************************/
+
+static int perf_open(FAR struct file *filep)
+{
+  FAR struct perf_event_s *ev;
+
+  ev = kmm_zalloc(sizeof(*ev));
+  if (ev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&ev->lock);
+  ev->idx = -1;
+  filep->f_priv = ev;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: perf_close
+ ****************************************************************************/
+
+static int perf_close(FAR struct file *filep)
+{
+  FAR struct perf_event_s *ev = filep->f_priv;
+  irqstate_t flags;
+
+  perf_disable(ev);
+  if (ev->idx >= 0)
+    {
+      flags = spin_lock_irqsave(&g_perf.lock);
+      g_perf.events[ev->idx] = NULL;
+      spin_unlock_irqrestore(&g_perf.lock, flags);
+    }
+
+  nxmutex_destroy(&ev->lock);
+  kmm_free(ev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: perf_read
+ ****************************************************************************/
+
+static ssize_t perf_read(FAR struct file *filep, FAR char *buffer,
+                         size_t buflen)
+{
+  FAR struct perf_event_s *ev = filep->f_priv;
+  uint64_t count;
+  int ret;
+
+  if (buflen < sizeof(count))
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&ev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  count = perf_count(ev);
+  nxmutex_unlock(&ev->lock);
+
+  memcpy(buffer, &count, sizeof(count));
+  return sizeof(count);
+}
+
+/****************************************************************************
+ * Name: perf_ioctl
+ ****************************************************************************/
+
+static int perf_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct perf_event_s *ev = filep->f_priv;
+  bool enabled;
+  int ret;
+
+  ret = nxmutex_lock(&ev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case PERFIOC_SETUP:
+        if (arg == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = perf_setup(ev,
+                    (FAR const struct perf_event_attr_s *)(uintptr_t)arg);
+          }
+        break;
+
+      case PERFIOC_ENABLE:
+        perf_enable(ev);
+        break;
+
+      case PERFIOC_DISABLE:
+        perf_disable(ev);
+        break;
+
+      case PERFIOC_RESET:
+        enabled = ev->enabled;
+        perf_disable(ev);
+        ev->count = 0;
+        if (enabled)
+          {
+            perf_enable(ev);
+          }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&ev->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: perf_event_switch
+ *
+ * Description:
+ *   Save the counts of the task events of the suspended task and restart
+ *   the counters of the resumed task.  Called by the scheduler on every
+ *   context switch.
+ *
+ ****************************************************************************/
+
+void perf_event_switch(FAR struct tcb_s *from, FAR struct tcb_s *to)
+{
+  FAR struct perf_event_s *ev;
+  irqstate_t flags;
+  int idx;
+
+  if (g_perf.ntasks == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave_notrace(&g_perf.lock);
+  for (idx = 0; idx < g_perf.ncounters; idx++)
+    {
+      ev = g_perf.events[idx];
+      if (ev == NULL || !ev->enabled || ev->attr.pid < 0)
+        {
+          continue;
+        }
+
+      if (ev->attr.pid == from->pid)
+        {
+          ev->count += up_pmu_stop(idx);
+        }
+
+      if (ev->attr.pid == to->pid)
+        {
+          up_pmu_start(idx, ev->event);
+        }
+    }
+
+  spin_unlock_irqrestore_notrace(&g_perf.lock, flags);
+}
+
+/****************************************************************************
+ * Name: devperf_register
+ *
+ * Description:
+ *   Register /dev/perf.  Every open file of it counts one hardware event of
+ *   a task or of the CPUs, see include/nuttx/perf_event.h.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero on success.  A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int devperf_register(void)
+{
+  g_perf.ncounters = up_pmu_ncounters();
+  if (g_perf.ncounters > PERF_MAX_COUNTERS)
+    {
+      g_perf.ncounters = PERF_MAX_COUNTERS;
+    }
+
+  return register_driver("/dev/perf", &g_perf_fops, 0666, NULL);
+}
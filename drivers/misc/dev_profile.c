@@ -0,0 +1,634 @@
+/****************************************************************************
+ * drivers/misc/dev_profile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/sched.h>
+#include <nuttx/wdog.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/drivers.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PROFTICK     NSEC2TICK(NSEC_PER_SEC / CONFIG_SCHED_PROFILE_TICKSPERSEC)
+#define PROFDEPTH    CONFIG_DEV_PROFILE_DEPTH
+#define PROFNSAMPLES CONFIG_DEV_PROFILE_NSAMPLES
+
+/* The backtrace of an interrupt includes the frames of the interrupt
+ * handler before the frames of the interrupted code.
+ */
+
+#define PROFISRDEPTH 16
+
+/* The fields of the pprof Profile message used here */
+
+#define PPROF_SAMPLE_TYPE          1  /* Profile.sample_type */
+#define PPROF_SAMPLE               2  /* Profile.sample */
+#define PPROF_MAPPING              3  /* Profile.mapping */
+#define PPROF_LOCATION             4  /* Profile.location */
+#define PPROF_STRING_TABLE         6  /* Profile.string_table */
+#define PPROF_DURATION_NANOS       10 /* Profile.duration_nanos */
+#define PPROF_PERIOD_TYPE          11 /* Profile.period_type */
+#define PPROF_PERIOD               12 /* Profile.period */
+#define PPROF_VALUETYPE_TYPE       1  /* ValueType.type */
+#define PPROF_VALUETYPE_UNIT       2  /* ValueType.unit */
+#define PPROF_SAMPLE_LOCATION_ID   1  /* Sample.location_id */
+#define PPROF_SAMPLE_VALUE         2  /* Sample.value */
+#define PPROF_SAMPLE_LABEL         3  /* Sample.label */
+#define PPROF_LABEL_KEY            1  /* Label.key */
+#define PPROF_LABEL_NUM            3  /* Label.num */
+#define PPROF_MAPPING_ID           1  /* Mapping.id */
+#define PPROF_MAPPING_MEMORY_LIMIT 3  /* Mapping.memory_limit */
+#define PPROF_MAPPING_FILENAME     5  /* Mapping.filename */
+#define PPROF_LOCATION_ID          1  /* Location.id */
+#define PPROF_LOCATION_MAPPING_ID  2  /* Location.mapping_id */
+#define PPROF_LOCATION_ADDRESS     3  /* Location.address */
+
+#define PPROF_WIRE_VARINT          0
+#define PPROF_WIRE_LENGTH          2
+
+/* The indexes of the strings of g_devprofile_strings */
+
+#define PPROF_STR_SAMPLES          1
+#define PPROF_STR_COUNT            2
+#define PPROF_STR_CPU              3
+#define PPROF_STR_NANOSECONDS      4
+#define PPROF_STR_PID              5
+#define PPROF_STR_NUTTX            6
+
+/* The encoded size bounds of the fixed fields, one sample and one
+ * location
+ */
+
+#define PPROF_HEADER_SIZE          160
+#define PPROF_SAMPLE_SIZE          (32 + 10 * PROFDEPTH)
+#define PPROF_LOCATION_SIZE        32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One sample, the leaf PC first */
+
+struct devprofile_sample_s
+{
+  pid_t pid;
+  uint8_t depth;
+  uintptr_t pc[PROFDEPTH];
+};
+
+/* The samples of one CPU, only written by that CPU */
+
+struct devprofile_cpu_s
+{
+  uint32_t head;
+  struct devprofile_sample_s samples[PROFNSAMPLES];
+};
+
+struct devprofile_s
+{
+  mutex_t lock;                     /* Serialize open, close and read */
+  int crefs;                        /* Number of open references */
+  volatile bool running;            /* The CPUs are being sampled */
+  clock_t start;                    /* Time when sampling started */
+  clock_t stop;                     /* Time when sampling stopped */
+  struct wdog_s timer;              /* Timer for sampling */
+  FAR struct devprofile_cpu_s *cpu; /* The per-CPU samples */
+};
+
+/* The pprof encoding of the samples, taken by the first read */
+
+struct devprofile_buf_s
+{
+  size_t len;
+  size_t size;
+  uint8_t data[1];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int devprofile_open(FAR struct file *filep);
+static int devprofile_close(FAR struct file *filep);
+static ssize_t devprofile_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+#ifdef CONFIG_SMP
+static int devprofile_sample_cpu(FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_devprofile_fops =
+{
+  devprofile_open,  /* open */
+  devprofile_close, /* close */
+  devprofile_read,  /* read */
+};
+
+static struct devprofile_s g_devprofile =
+{
+  NXMUTEX_INITIALIZER,
+};
+
+#ifdef CONFIG_SMP
+static struct smp_call_data_s g_call_data =
+SMP_CALL_INITIALIZER(devprofile_sample_cpu, &g_devprofile);
+#endif
+
+static FAR const char * const g_devprofile_strings[] =
+{
+  "", "samples", "count", "cpu", "nanoseconds", "pid", "nuttx",
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devprofile_sample_cpu
+ *
+ * Description:
+ *   Record the PC and the callers of the code interrupted on this CPU.
+ *
+ ****************************************************************************/
+
+static int devprofile_sample_cpu(FAR void *arg)
+{
+  FAR struct devprofile_s *prof = arg;
+  FAR struct devprofile_cpu_s *cpu;
+  FAR struct devprofile_sample_s *sample;
+  uintptr_t pc = up_getusrpc(NULL);
+#ifdef CONFIG_ARCH_HAVE_BACKTRACE
+  FAR void *frames[PROFISRDEPTH + PROFDEPTH];
+  int nframes;
+  int i;
+#endif
+
+  if (!prof->running)
+    {
+      return OK;
+    }
+
+  cpu = &prof->cpu[this_cpu()];
+  if (cpu->head >= PROFNSAMPLES)
+    {
+      return OK;
+    }
+
+  sample = &cpu->samples[cpu->head];
+  sample->pid = nxsched_gettid();
+  sample->pc[0] = pc;
+  sample->depth = 1;
+
+#ifdef CONFIG_ARCH_HAVE_BACKTRACE
+  /* The interrupted code starts at its PC, drop the frames of the
+   * interrupt handler before it.
+   */
+
+  nframes = up_backtrace(NULL, frames, PROFISRDEPTH + PROFDEPTH, 0);
+  for (i = 0; i < nframes; i++)
+    {
+      if ((uintptr_t)frames[i] == pc)
+        {
+          for (i++; i < nframes && sample->depth < PROFDEPTH; i++)
+            {
+              sample->pc[sample->depth++] = (uintptr_t)frames[i];
+            }
+
+          break;
+        }
+    }
+#endif
+
+  cpu->head++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: devprofile_timer
+ ****************************************************************************/
+
+static void devprofile_timer(wdparm_t arg)
+{
+  FAR struct devprofile_s *prof = (FAR struct devprofile_s *)(uintptr_t)arg;
+
+#ifdef CONFIG_SMP
+  cpu_set_t cpus = (1 << CONFIG_SMP_NCPUS) - 1;
+  CPU_CLR(this_cpu(), &cpus);
+  nxsched_smp_call_async(cpus, &g_call_data);
+#endif
+
+  devprofile_sample_cpu(prof);
+  wd_start_next(&prof->timer, PROFTICK, devprofile_timer, arg);
+}
+
+/****************************************************************************
+ * Name: devprofile_stop
+ ****************************************************************************/
+
+static void devprofile_stop(FAR struct devprofile_s *prof)
+{
+  if (prof->running)
+    {
+      prof->running = false;
+      prof->stop = clock_systime_ticks();
+      wd_cancel(&prof->timer);
+    }
+}
+
+/****************************************************************************
+ * Name: pprof_varint
+ ****************************************************************************/
+
+static void pprof_varint(FAR struct devprofile_buf_s *pb, uint64_t value)
+{
+  do
+    {
+      DEBUGASSERT(pb->len < pb->size);
+      pb->data[pb->len++] = (value & 0x7f) | (value > 0x7f ? 0x80 : 0);
+      value >>= 7;
+    }
+  while (value != 0);
+}
+
+/****************************************************************************
+ * Name: pprof_uint
+ ****************************************************************************/
+
+static void pprof_uint(FAR struct devprofile_buf_s *pb, int field,
+                       uint64_t value)
+{
+  pprof_varint(pb, (field << 3) | PPROF_WIRE_VARINT);
+  pprof_varint(pb, value);
+}
+
+/****************************************************************************
+ * Name: pprof_begin
+ *
+ * Description:
+ *   Start a nested message, two bytes are reserved for its length as a
+ *   redundant varint.
+ *
+ ****************************************************************************/
+
+static size_t pprof_begin(FAR struct devprofile_buf_s *pb, int field)
+{
+  size_t offset;
+
+  pprof_varint(pb, (field << 3) | PPROF_WIRE_LENGTH);
+  offset = pb->len;
+  pprof_varint(pb, 0);
+  pprof_varint(pb, 0);
+  return offset;
+}
+
+/****************************************************************************
+ * Name: pprof_end
+ ****************************************************************************/
+
+static void pprof_end(FAR struct devprofile_buf_s *pb, size_t offset)
+{
+  size_t len = pb->len - offset - 2;
+
+  pb->data[offset]     = 0x80 | (len & 0x7f);
+  pb->data[offset + 1] = len >> 7;
+}
+
+/****************************************************************************
+ * Name: pprof_valuetype
+ ****************************************************************************/
+
+static void pprof_valuetype(FAR struct devprofile_buf_s *pb, int field,
+                            int type, int unit)
+{
+  size_t offset = pprof_begin(pb, field);
+
+  pprof_uint(pb, PPROF_VALUETYPE_TYPE, type);
+  pprof_uint(pb, PPROF_VALUETYPE_UNIT, unit);
+  pprof_end(pb, offset);
+}
+
+/****************************************************************************
+ * Name: devprofile_compare
+ ****************************************************************************/
+
+static int devprofile_compare(FAR const void *a, FAR const void *b)
+{
+  uintptr_t pa = *(FAR const uintptr_t *)a;
+  uintptr_t pb = *(FAR const uintptr_t *)b;
+
+  return pa < pb ? -1 : pa > pb;
+}
+
+/****************************************************************************
+ * Name: devprofile_encode
+ *
+ * Description:
+ *   Encode the samples of all CPUs as a pprof profile.  The location of an
+ *   address uses the address as its id, pprof symbolizes the addresses
+ *   with the nuttx ELF file and aggregates the flat and call-graph
+ *   profiles.
+ *
+ ****************************************************************************/
+
+static FAR struct devprofile_buf_s *
+devprofile_encode(FAR struct devprofile_s *prof)
+{
+  FAR struct devprofile_buf_s *pb;
+  FAR struct devprofile_sample_s *sample;
+  FAR uintptr_t *addrs;
+  size_t naddrs = 0;
+  size_t nsamples = 0;
+  size_t offset;
+  size_t packed;
+  size_t i;
+  size_t n;
+  int cpu;
+  int j;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      nsamples += prof->cpu[cpu].head;
+    }
+
+  /* Collect the distinct addresses for the locations */
+
+  addrs = kmm_malloc(nsamples * PROFDEPTH * sizeof(uintptr_t) + 1);
+  if (addrs == NULL)
+    {
+      return NULL;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      n = prof->cpu[cpu].head;
+      for (i = 0; i < n; i++)
+        {
+          sample = &prof->cpu[cpu].samples[i];
+          for (j = 0; j < sample->depth; j++)
+            {
+              addrs[naddrs++] = sample->pc[j];
+            }
+        }
+    }
+
+  qsort(addrs, naddrs, sizeof(uintptr_t), devprofile_compare);
+  for (i = 0, n = 0; i < naddrs; i++)
+    {
+      if (n == 0 || addrs[n - 1] != addrs[i])
+        {
+          addrs[n++] = addrs[i];
+        }
+    }
+
+  naddrs = n;
+
+  n  = PPROF_HEADER_SIZE + nsamples * PPROF_SAMPLE_SIZE +
+       naddrs * PPROF_LOCATION_SIZE;
+  pb = kmm_malloc(sizeof(*pb) + n);
+  if (pb == NULL)
+    {
+      kmm_free(addrs);
+      return NULL;
+    }
+
+  pb->len  = 0;
+  pb->size = n;
+
+  pprof_valuetype(pb, PPROF_SAMPLE_TYPE, PPROF_STR_SAMPLES,
+                  PPROF_STR_COUNT);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      n = prof->cpu[cpu].head;
+      for (i = 0; i < n; i++)
+        {
+          sample = &prof->cpu[cpu].samples[i];
+          offset = pprof_begin(pb, PPROF_SAMPLE);
+
+          packed = pprof_begin(pb, PPROF_SAMPLE_LOCATION_ID);
+          for (j = 0; j < sample->depth; j++)
+            {
+              pprof_varint(pb, sample->pc[j]);
+            }
+
+          pprof_end(pb, packed);
+          pprof_uint(pb, PPROF_SAMPLE_VALUE, 1);
+
+          packed = pprof_begin(pb, PPROF_SAMPLE_LABEL);
+          pprof_uint(pb, PPROF_LABEL_KEY, PPROF_STR_PID);
+          pprof_uint(pb, PPROF_LABEL_NUM, sample->pid);
+          pprof_end(pb, packed);
+
+          pprof_end(pb, offset);
+        }
+    }
+
+  offset = pprof_begin(pb, PPROF_MAPPING);
+  pprof_uint(pb, PPROF_MAPPING_ID, 1);
+  pprof_uint(pb, PPROF_MAPPING_MEMORY_LIMIT, UINTPTR_MAX);
+  pprof_uint(pb, PPROF_MAPPING_FILENAME, PPROF_STR_NUTTX);
+  pprof_end(pb, offset);
+
+  for (i = 0; i < naddrs; i++)
+    {
+      offset = pprof_begin(pb, PPROF_LOCATION);
+      pprof_uint(pb, PPROF_LOCATION_ID, addrs[i]);
+      pprof_uint(pb, PPROF_LOCATION_MAPPING_ID, 1);
+      pprof_uint(pb, PPROF_LOCATION_ADDRESS, addrs[i]);
+      pprof_end(pb, offset);
+    }
+
+  kmm_free(addrs);
+
+  for (i = 0; i < nitems(g_devprofile_strings); i++)
+    {
+      n = strlen(g_devprofile_strings[i]);
+      pprof_varint(pb, (PPROF_STRING_TABLE << 3) | PPROF_WIRE_LENGTH);
+      pprof_varint(pb, n);
+      memcpy(pb->data + pb->len, g_devprofile_strings[i], n);
+      pb->len += n;
+    }
+
+  pprof_uint(pb, PPROF_DURATION_NANOS,
+             TICK2NSEC((uint64_t)(prof->stop - prof->start)));
+  pprof_valuetype(pb, PPROF_PERIOD_TYPE, PPROF_STR_CPU,
+                  PPROF_STR_NANOSECONDS);
+  pprof_uint(pb, PPROF_PERIOD, TICK2NSEC((uint64_t)PROFTICK));
+  return pb;
+}
+
+/****************************************************************************
+ * Name: devprofile_open
+ *
+ * Description:
+ *   The first open starts sampling all CPUs.
+ *
+ ****************************************************************************/
+
+static int devprofile_open(FAR struct file *filep)
+{
+  FAR struct devprofile_s *prof = filep->f_inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&prof->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (prof->crefs == 0)
+    {
+      prof->cpu = kmm_zalloc(CONFIG_SMP_NCPUS * sizeof(*prof->cpu));
+      if (prof->cpu == NULL)
+        {
+          nxmutex_unlock(&prof->lock);
+          return -ENOMEM;
+        }
+
+      prof->start = clock_systime_ticks();
+      prof->running = true;
+      wd_start(&prof->timer, PROFTICK, devprofile_timer,
+               (wdparm_t)(uintptr_t)prof);
+    }
+
+  prof->crefs++;
+  nxmutex_unlock(&prof->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: devprofile_close
+ ****************************************************************************/
+
+static int devprofile_close(FAR struct file *filep)
+{
+  FAR struct devprofile_s *prof = filep->f_inode->i_private;
+
+  nxmutex_lock(&prof->lock);
+  if (--prof->crefs == 0)
+    {
+      devprofile_stop(prof);
+      kmm_free(prof->cpu);
+      prof->cpu = NULL;
+    }
+
+  nxmutex_unlock(&prof->lock);
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: devprofile_read
+ *
+ * Description:
+ *   The first read stops sampling and returns the profile of the samples
+ *   taken since the device was first opened.
+ *
+ ****************************************************************************/
+
+static ssize_t devprofile_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct devprofile_s *prof = filep->f_inode->i_private;
+  FAR struct devprofile_buf_s *pb = filep->f_priv;
+  int ret;
+
+  if (pb == NULL)
+    {
+      ret = nxmutex_lock(&prof->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      devprofile_stop(prof);
+      pb = devprofile_encode(prof);
+      nxmutex_unlock(&prof->lock);
+      if (pb == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      filep->f_priv = pb;
+    }
+
+  if (filep->f_pos >= pb->len)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, pb->len - filep->f_pos);
+  memcpy(buffer, pb->data + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devprofile_register
+ *
+ * Description:
+ *   Register /dev/profile.  While it is open, the PC and the callers of the
+ *   running code of every CPU are sampled CONFIG_SCHED_PROFILE_TICKSPERSEC
+ *   times a second.  Reading it stops sampling and returns the samples as
+ *   a pprof profile.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero on success.  A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int devprofile_register(void)
+{
+  return register_driver("/dev/profile", &g_devprofile_fops, 0444,
+                         &g_devprofile);
+}
@@ -0,0 +1,593 @@
+/****************************************************************************
+ * drivers/misc/ringchan.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/drivers/drivers.h>
+#include <nuttx/ringchan.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RINGCHAN_MAXENTRIES 65536
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A channel, the ring itself is shared with the applications */
+
+struct ringchan_dev_s
+{
+  mutex_t lock;                      /* Serialize open, close and poll */
+  sem_t datasem;                     /* The consumer waits for a message */
+  sem_t spacesem;                    /* The producers wait for a slot */
+  FAR struct ringchan_s *ring;       /* The mapped ring */
+  int16_t crefs;                     /* Number of open files */
+  bool unlinked;                     /* The channel was unlinked */
+  FAR struct pollfd *fds[CONFIG_DEV_RINGCHAN_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ringchan_ctl_ioctl(FAR struct file *filep, int cmd,
+                              unsigned long arg);
+
+static int ringchan_open(FAR struct file *filep);
+static int ringchan_close(FAR struct file *filep);
+static int ringchan_ioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg);
+static int ringchan_mmap(FAR struct file *filep,
+                         FAR struct mm_map_entry_s *map);
+static int ringchan_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                         bool setup);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int ringchan_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_ringchan_ctl_fops =
+{
+  NULL,               /* open */
+  NULL,               /* close */
+  NULL,               /* read */
+  NULL,               /* write */
+  NULL,               /* seek */
+  ringchan_ctl_ioctl, /* ioctl */
+};
+
+static const struct file_operations g_ringchan_fops =
+{
+  ringchan_open,      /* open */
+  ringchan_close,     /* close */
+  NULL,               /* read */
+  NULL,               /* write */
+  NULL,               /* seek */
+  ringchan_ioctl,     /* ioctl */
+  ringchan_mmap,      /* mmap */
+  NULL,               /* truncate */
+  ringchan_poll,      /* poll */
+  NULL,               /* readv */
+  NULL,               /* writev */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  ringchan_unlink,    /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringchan_ready
+ *
+ * Description:
+ *   Return true if the side waiting for 'flag' can proceed: the slot of
+ *   the consumer holds a message, or the slot of the producers is free.
+ *
+ ****************************************************************************/
+
+static bool ringchan_ready(FAR struct ringchan_s *ring, uint32_t flag)
+{
+  uint32_t pos;
+
+  if (flag == RINGCHAN_WAIT_DATA)
+    {
+      pos = __atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST);
+      return __atomic_load_n(&RINGCHAN_SLOT(ring, pos)->seq,
+                             __ATOMIC_SEQ_CST) == pos + 1;
+    }
+  else
+    {
+      pos = __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST);
+      return __atomic_load_n(&RINGCHAN_SLOT(ring, pos)->seq,
+                             __ATOMIC_SEQ_CST) == pos;
+    }
+}
+
+/****************************************************************************
+ * Name: ringchan_post
+ *
+ * Description:
+ *   Wake up the task sleeping on a semaphore, at most one post is kept
+ *   pending so that spurious wakeups do not accumulate.
+ *
+ ****************************************************************************/
+
+static void ringchan_post(FAR sem_t *sem)
+{
+  int sval;
+
+  if (nxsem_get_value(sem, &sval) >= 0 && sval <= 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: ringchan_wait
+ *
+ * Description:
+ *   Sleep until ringchan_ready().  The waiting flag is published before
+ *   the ring is checked, so a side that makes the ring ready after the
+ *   check sees the flag and wakes the caller up.
+ *
+ ****************************************************************************/
+
+static int ringchan_wait(FAR struct file *filep, uint32_t flag)
+{
+  FAR struct ringchan_dev_s *dev = filep->f_inode->i_private;
+  FAR sem_t *sem;
+  int ret;
+
+  if (flag == RINGCHAN_WAIT_DATA)
+    {
+      sem = &dev->datasem;
+    }
+  else if (flag == RINGCHAN_WAIT_SPACE)
+    {
+      sem = &dev->spacesem;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  for (; ; )
+    {
+      __atomic_fetch_or(&dev->ring->waiting, flag, __ATOMIC_SEQ_CST);
+      if (ringchan_ready(dev->ring, flag))
+        {
+          return OK;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(sem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ringchan_wakeup
+ *
+ * Description:
+ *   Clear the waiting flags and wake up the sides that had set them.
+ *
+ ****************************************************************************/
+
+static int ringchan_wakeup(FAR struct ringchan_dev_s *dev, uint32_t flags)
+{
+  pollevent_t eventset = 0;
+  int ret;
+
+  flags &= __atomic_fetch_and(&dev->ring->waiting, ~flags,
+                              __ATOMIC_SEQ_CST);
+
+  if ((flags & RINGCHAN_WAIT_DATA) != 0)
+    {
+      ringchan_post(&dev->datasem);
+      eventset |= POLLIN;
+    }
+
+  if ((flags & RINGCHAN_WAIT_SPACE) != 0)
+    {
+      ringchan_post(&dev->spacesem);
+      eventset |= POLLOUT;
+    }
+
+  if (eventset != 0)
+    {
+      ret = nxmutex_lock(&dev->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      poll_notify(dev->fds, CONFIG_DEV_RINGCHAN_NPOLLWAITERS, eventset);
+      nxmutex_unlock(&dev->lock);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ringchan_free
+ ****************************************************************************/
+
+static void ringchan_free(FAR struct ringchan_dev_s *dev)
+{
+  nxmutex_destroy(&dev->lock);
+  nxsem_destroy(&dev->datasem);
+  nxsem_destroy(&dev->spacesem);
+  kmm_free(dev->ring);
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: ringchan_create
+ ****************************************************************************/
+
+static int ringchan_create(FAR const struct ringchan_create_s *create)
+{
+  FAR struct ringchan_dev_s *dev;
+  FAR struct ringchan_s *ring;
+  char path[sizeof(RINGCHAN_DIR) + RINGCHAN_NAME_MAX + 1];
+  size_t size;
+  uint32_t i;
+  int ret;
+
+  if (create == NULL ||
+      create->nentries < 2 || create->nentries > RINGCHAN_MAXENTRIES ||
+      (create->nentries & (create->nentries - 1)) != 0 ||
+      create->entsize == 0 ||
+      create->entsize > CONFIG_DEV_RINGCHAN_MAXSIZE ||
+      (create->flags & ~RINGCHAN_MPSC) != 0 ||
+      create->name[0] == '\0' ||
+      strnlen(create->name, RINGCHAN_NAME_MAX) == RINGCHAN_NAME_MAX ||
+      strchr(create->name, '/') != NULL)
+    {
+      return -EINVAL;
+    }
+
+  size = RINGCHAN_SIZE((size_t)create->nentries, create->entsize);
+  if (size > CONFIG_DEV_RINGCHAN_MAXSIZE)
+    {
+      return -EINVAL;
+    }
+
+  dev = kmm_zalloc(sizeof(struct ringchan_dev_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring = kmm_memalign(RINGCHAN_CACHELINE, size);
+  if (ring == NULL)
+    {
+      kmm_free(dev);
+      return -ENOMEM;
+    }
+
+  memset(ring, 0, size);
+  ring->flags    = create->flags;
+  ring->nentries = create->nentries;
+  ring->entsize  = create->entsize;
+  ring->stride   = RINGCHAN_STRIDE(create->entsize);
+  ring->slots    = 3 * RINGCHAN_CACHELINE;
+  ring->size     = size;
+
+  for (i = 0; i < ring->nentries; i++)
+    {
+      RINGCHAN_SLOT(ring, i)->seq = i;
+    }
+
+  nxmutex_init(&dev->lock);
+  nxsem_init(&dev->datasem, 0, 0);
+  nxsem_init(&dev->spacesem, 0, 0);
+  dev->ring = ring;
+
+  snprintf(path, sizeof(path), RINGCHAN_DIR "/%s", create->name);
+  ret = register_driver(path, &g_ringchan_fops, 0666, dev);
+  if (ret < 0)
+    {
+      ringchan_free(dev);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ringchan_ctl_ioctl
+ ****************************************************************************/
+
+static int ringchan_ctl_ioctl(FAR struct file *filep, int cmd,
+                              unsigned long arg)
+{
+  switch (cmd)
+    {
+      case RINGCHANIOC_CREATE:
+        return ringchan_create(
+                 (FAR const struct ringchan_create_s *)(uintptr_t)arg);
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Name: ringchan_open
+ ****************************************************************************/
+
+static int ringchan_open(FAR struct file *filep)
+{
+  FAR struct ringchan_dev_s *dev = filep->f_inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dev->crefs++;
+  nxmutex_unlock(&dev->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ringchan_close
+ ****************************************************************************/
+
+static int ringchan_close(FAR struct file *filep)
+{
+  FAR struct ringchan_dev_s *dev = filep->f_inode->i_private;
+
+  nxmutex_lock(&dev->lock);
+  if (--dev->crefs <= 0 && dev->unlinked)
+    {
+      nxmutex_unlock(&dev->lock);
+      ringchan_free(dev);
+      return OK;
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ringchan_ioctl
+ ****************************************************************************/
+
+static int ringchan_ioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg)
+{
+  FAR struct ringchan_dev_s *dev = filep->f_inode->i_private;
+  FAR size_t *size;
+
+  switch (cmd)
+    {
+      case RINGCHANIOC_GETSIZE:
+        size = (FAR size_t *)(uintptr_t)arg;
+        if (size == NULL)
+          {
+            return -EINVAL;
+          }
+
+        *size = dev->ring->size;
+        return OK;
+
+      case RINGCHANIOC_WAIT:
+        return ringchan_wait(filep, arg);
+
+      case RINGCHANIOC_WAKEUP:
+        return ringchan_wakeup(dev, arg);
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Name: ringchan_mmap
+ ****************************************************************************/
+
+static int ringchan_mmap(FAR struct file *filep,
+                         FAR struct mm_map_entry_s *map)
+{
+  FAR struct ringchan_dev_s *dev = filep->f_inode->i_private;
+
+  if (map->offset != 0 || map->length > dev->ring->size)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = dev->ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ringchan_poll
+ *
+ * Description:
+ *   POLLIN reports a message, POLLOUT a free slot.  A poll that has to
+ *   wait publishes the same waiting flags as RINGCHANIOC_WAIT, so the
+ *   other side issues RINGCHANIOC_WAKEUP, which notifies the poll.
+ *
+ ****************************************************************************/
+
+static int ringchan_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                         bool setup)
+{
+  FAR struct ringchan_dev_s *dev = filep->f_inode->i_private;
+  FAR struct ringchan_s *ring = dev->ring;
+  pollevent_t eventset = 0;
+  uint32_t flags = 0;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!setup)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (slot != NULL)
+        {
+          *slot = NULL;
+        }
+
+      fds->priv = NULL;
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_DEV_RINGCHAN_NPOLLWAITERS; i++)
+    {
+      if (dev->fds[i] == NULL)
+        {
+          dev->fds[i] = fds;
+          fds->priv   = &dev->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_DEV_RINGCHAN_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto out;
+    }
+
+  if ((fds->events & POLLIN) != 0)
+    {
+      flags |= RINGCHAN_WAIT_DATA;
+    }
+
+  if ((fds->events & POLLOUT) != 0)
+    {
+      flags |= RINGCHAN_WAIT_SPACE;
+    }
+
+  __atomic_fetch_or(&ring->waiting, flags, __ATOMIC_SEQ_CST);
+
+  if ((flags & RINGCHAN_WAIT_DATA) != 0 &&
+      ringchan_ready(ring, RINGCHAN_WAIT_DATA))
+    {
+      eventset |= POLLIN;
+    }
+
+  if ((flags & RINGCHAN_WAIT_SPACE) != 0 &&
+      ringchan_ready(ring, RINGCHAN_WAIT_SPACE))
+    {
+      eventset |= POLLOUT;
+    }
+
+  poll_notify(&fds, 1, eventset);
+
+out:
+  nxmutex_unlock(&dev->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ringchan_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int ringchan_unlink(FAR struct inode *inode)
+{
+  FAR struct ringchan_dev_s *dev = inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (dev->crefs <= 0)
+    {
+      nxmutex_unlock(&dev->lock);
+      ringchan_free(dev);
+      return OK;
+    }
+
+  dev->unlinked = true;
+  nxmutex_unlock(&dev->lock);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringchan_register
+ *
+ * Description:
+ *   Register the ring channel control device.  RINGCHANIOC_CREATE of the
+ *   control device creates a channel, an application maps the ring of an
+ *   opened channel and exchanges the messages with ringchan_send() and
+ *   ringchan_recv().
+ *
+ ****************************************************************************/
+
+int ringchan_register(void)
+{
+  return register_driver(RINGCHAN_CTLPATH, &g_ringchan_ctl_fops, 0666,
+                         NULL);
+}
@@ -42,6 +42,7 @@
 #include <nuttx/mutex.h>
 #include <nuttx/mmcsd.h>
 #include <nuttx/rpmsg/rpmsg.h>
+#include <nuttx/rpmsg/rpmsg_shm.h>
 
 #include "rpmsgblk.h"
 
@@ -98,6 +99,13 @@ static int     rpmsgblk_unlink(FAR struct inode *inode);
 
 /* Functions for sending data to the remote cpu */
 
+#ifdef CONFIG_RPMSG_SHM
+static ssize_t rpmsgblk_shm_transfer(FAR struct rpmsgblk_s *priv,
+                                     uint32_t command,
+                                     FAR unsigned char *buffer,
+                                     blkcnt_t start_sector,
+                                     unsigned int nsectors);
+#endif
 static int     rpmsgblk_send_recv(FAR struct rpmsgblk_s *priv,
                                   uint32_t command, bool copy,
                                   FAR struct rpmsgblk_header_s *msg,
@@ -145,6 +153,10 @@ static const rpmsg_ept_cb g_rpmsgblk_handler[] =
   [RPMSGBLK_WRITE]    = rpmsgblk_default_handler,
   [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
   [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
+#ifdef CONFIG_RPMSG_SHM
+  [RPMSGBLK_READ_SHM]  = rpmsgblk_default_handler,
+  [RPMSGBLK_WRITE_SHM] = rpmsgblk_default_handler,
+#endif
 };
 
 /****************************************************************************
@@ -288,6 +300,19 @@ static ssize_t rpmsgblk_read(FAR struct inode *inode,
       return ret;
     }
 
+#ifdef CONFIG_RPMSG_SHM
+  /* Read the sectors in one request through a shared memory buffer if one
+   * can be allocated.
+   */
+
+  ret = rpmsgblk_shm_transfer(priv, RPMSGBLK_READ_SHM, buffer,
+                              start_sector, nsectors);
+  if (ret != -ENOMEM)
+    {
+      return ret;
+    }
+#endif
+
   /* In block read, iov_len represent the received block number */
 
   iov.iov_base = buffer;
@@ -351,6 +376,20 @@ static ssize_t rpmsgblk_write(FAR struct inode *inode,
       return ret;
     }
 
+#ifdef CONFIG_RPMSG_SHM
+  /* Write the sectors in one request through a shared memory buffer if
+   * one can be allocated.
+   */
+
+  ret = rpmsgblk_shm_transfer(priv, RPMSGBLK_WRITE_SHM,
+                              (FAR unsigned char *)buffer,
+                              start_sector, nsectors);
+  if (ret != -ENOMEM)
+    {
+      return ret;
+    }
+#endif
+
   /* Perform the rpmsg write */
 
   memset(&cookie, 0, sizeof(cookie));
@@ -803,6 +842,74 @@ static FAR void *rpmsgblk_get_tx_payload_buffer(FAR struct rpmsgblk_s *priv,
   return rpmsg_get_tx_payload_buffer(&priv->ept, len, true);
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_shm_transfer
+ *
+ * Description:
+ *   Read or write the sectors in a single request, with the data in a
+ *   buffer of the shared memory pool instead of the rpmsg messages.
+ *
+ * Parameters:
+ *   priv         - rpmsg blk handle
+ *   command      - RPMSGBLK_READ_SHM or RPMSGBLK_WRITE_SHM
+ *   buffer       - The sectors to write, or receives the sectors read
+ *   start_sector - The first sector
+ *   nsectors     - The number of sectors
+ *
+ * Returned Values:
+ *   The number of sectors transferred on success; -ENOMEM if no shared
+ *   buffer is available, other negated errno values on any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_SHM
+static ssize_t rpmsgblk_shm_transfer(FAR struct rpmsgblk_s *priv,
+                                     uint32_t command,
+                                     FAR unsigned char *buffer,
+                                     blkcnt_t start_sector,
+                                     unsigned int nsectors)
+{
+  uint32_t sectorsize = priv->geo.geo_sectorsize;
+  size_t len = (size_t)nsectors * sectorsize;
+  struct rpmsgblk_shm_s msg;
+  FAR void *buf;
+  int ret;
+
+  buf = rpmsg_shm_alloc(&priv->ept, len);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Flush the buffer even for a read, so that no dirty cache line is
+   * evicted over the sectors written by the server.
+   */
+
+  if (command == RPMSGBLK_WRITE_SHM)
+    {
+      memcpy(buf, buffer, len);
+    }
+
+  rpmsg_shm_flush(buf, len);
+
+  msg.startsector = start_sector;
+  msg.nsectors    = nsectors;
+  msg.sectorsize  = sectorsize;
+  msg.handle      = rpmsg_shm_handle(&priv->ept, buf);
+
+  ret = rpmsgblk_send_recv(priv, command, true, &msg.header,
+                           sizeof(msg), NULL);
+  if (ret > 0 && command == RPMSGBLK_READ_SHM)
+    {
+      rpmsg_shm_invalidate(buf, ret * sectorsize);
+      memcpy(buffer, buf, ret * sectorsize);
+    }
+
+  rpmsg_shm_free(&priv->ept, buf);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgblk_send_recv
  *
@@ -45,6 +45,8 @@
 #define RPMSGBLK_WRITE           4
 #define RPMSGBLK_GEOMETRY        5
 #define RPMSGBLK_IOCTL           6
+#define RPMSGBLK_READ_SHM        7
+#define RPMSGBLK_WRITE_SHM       8
 
 /****************************************************************************
  * Public Types
@@ -76,6 +78,19 @@ begin_packed_struct struct rpmsgblk_read_s
 
 #define rpmsgblk_write_s rpmsgblk_read_s
 
+/* Read or write with the data in a shared memory buffer, see
+ * nuttx/rpmsg/rpmsg_shm.h.
+ */
+
+begin_packed_struct struct rpmsgblk_shm_s
+{
+  struct rpmsgblk_header_s header;
+  uint32_t                 startsector;
+  uint32_t                 nsectors;
+  int32_t                  sectorsize;
+  uint32_t                 handle;
+} end_packed_struct;
+
 begin_packed_struct struct rpmsgblk_geometry_s
 {
   struct rpmsgblk_header_s header;
@@ -32,6 +32,7 @@
 #include <nuttx/mmcsd.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/rpmsg/rpmsg.h>
+#include <nuttx/rpmsg/rpmsg_shm.h>
 
 #include "inode.h"
 #include "rpmsgblk.h"
@@ -72,6 +73,11 @@ static int rpmsgblk_write_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgblk_geometry_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv);
+#ifdef CONFIG_RPMSG_SHM
+static int rpmsgblk_shm_handler(FAR struct rpmsg_endpoint *ept,
+                                FAR void *data, size_t len,
+                                uint32_t src, FAR void *priv);
+#endif
 static int rpmsgblk_ioctl_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
@@ -100,6 +106,10 @@ static const rpmsg_ept_cb g_rpmsgblk_handler[] =
   [RPMSGBLK_WRITE]    = rpmsgblk_write_handler,
   [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
   [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
+#ifdef CONFIG_RPMSG_SHM
+  [RPMSGBLK_READ_SHM]  = rpmsgblk_shm_handler,
+  [RPMSGBLK_WRITE_SHM] = rpmsgblk_shm_handler,
+#endif
 };
 
 /****************************************************************************
@@ -245,6 +255,57 @@ static int rpmsgblk_read_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_shm_handler
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_SHM
+static int rpmsgblk_shm_handler(FAR struct rpmsg_endpoint *ept,
+                                FAR void *data, size_t len,
+                                uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgblk_server_s *server = ept->priv;
+  FAR struct rpmsgblk_shm_s *msg = data;
+  FAR unsigned char *buf;
+  int ret;
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  if (server->blknode->i_peer == NULL)
+    {
+      msg->header.result = -ENODEV;
+      return rpmsg_send(ept, msg, sizeof(*msg));
+    }
+#endif
+
+  /* The sectors are in the shared buffer of the client */
+
+  buf = rpmsg_shm_ptr(ept, msg->handle,
+                      (size_t)msg->nsectors * msg->sectorsize);
+  if (buf == NULL)
+    {
+      ret = -EINVAL;
+    }
+  else if (msg->header.command == RPMSGBLK_READ_SHM)
+    {
+      ret = server->bops->read(server->blknode, buf, msg->startsector,
+                               msg->nsectors);
+      if (ret > 0)
+        {
+          rpmsg_shm_flush(buf, ret * msg->sectorsize);
+        }
+    }
+  else
+    {
+      rpmsg_shm_invalidate(buf, (size_t)msg->nsectors * msg->sectorsize);
+      ret = server->bops->write(server->blknode, buf, msg->startsector,
+                                msg->nsectors);
+    }
+
+  msg->header.result = ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgblk_write_handler
  ****************************************************************************/
@@ -64,6 +64,10 @@
 
 static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
                          size_t nblocks, FAR uint8_t *rdbuffer);
+#ifdef CONFIG_DRVR_READAHEAD
+static int rwb_rhdiscard(FAR struct rwbuffer_s *rwb, off_t startblock,
+                         size_t nblocks);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -89,6 +93,56 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
 #  define rwb_unlock(l)
 #endif
 
+/****************************************************************************
+ * Name: rwb_flushdev / rwb_reloaddev
+ *
+ * Description:
+ *   Call the flush and reload callouts.  With more than one write segment
+ *   the flush worker writes to the device without holding the wrlock, so
+ *   the callouts are serialized by wriolock instead.
+ *
+ ****************************************************************************/
+
+static ssize_t rwb_flushdev(FAR struct rwbuffer_s *rwb,
+                            FAR const uint8_t *buffer,
+                            off_t startblock, size_t nblocks)
+{
+  ssize_t ret;
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  if (rwb->wrnsegments > 1)
+    {
+      nxmutex_lock(&rwb->wriolock);
+      ret = rwb->wrflush(rwb->dev, buffer, startblock, nblocks);
+      nxmutex_unlock(&rwb->wriolock);
+      return ret;
+    }
+#endif
+
+  ret = rwb->wrflush(rwb->dev, buffer, startblock, nblocks);
+  return ret;
+}
+
+static ssize_t rwb_reloaddev(FAR struct rwbuffer_s *rwb,
+                             FAR uint8_t *buffer,
+                             off_t startblock, size_t nblocks)
+{
+  ssize_t ret;
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  if (rwb->wrnsegments > 1)
+    {
+      nxmutex_lock(&rwb->wriolock);
+      ret = rwb->rhreload(rwb->dev, buffer, startblock, nblocks);
+      nxmutex_unlock(&rwb->wriolock);
+      return ret;
+    }
+#endif
+
+  ret = rwb->rhreload(rwb->dev, buffer, startblock, nblocks);
+  return ret;
+}
+
 /****************************************************************************
  * Name: rwb_overlap
  ****************************************************************************/
@@ -112,23 +166,326 @@ static inline bool rwb_overlap(off_t blockstart1, size_t nblocks1,
     }
 }
 
+/****************************************************************************
+ * Name: rwb_resetwrseg
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static inline void rwb_resetwrseg(FAR struct rwbuffer_s *rwb,
+                                  FAR struct rwb_wrseg_s *seg)
+{
+  seg->window     = -1;
+  seg->blockstart = -1;
+  seg->nblocks    = 0;
+  seg->flushing   = false;
+
+  if (rwb->wrlast == seg)
+    {
+      rwb->wrlast = NULL;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_resetwrbuffer
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static inline void rwb_resetwrbuffer(FAR struct rwbuffer_s *rwb)
+static void rwb_resetwrbuffer(FAR struct rwbuffer_s *rwb)
+{
+  int i;
+
+  /* We assume that the caller holds the wrlock and that no segment is
+   * being written by the flush worker.
+   */
+
+  for (i = 0; i < rwb->wrnsegments; i++)
+    {
+      rwb_resetwrseg(rwb, &rwb->wrseg[i]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrfind
+ *
+ * Description:
+ *   Return the segment caching the window that starts at 'window', or the
+ *   first free segment if 'window' is -1.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static FAR struct rwb_wrseg_s *rwb_wrfind(FAR struct rwbuffer_s *rwb,
+                                          off_t window)
+{
+  int i;
+
+  for (i = 0; i < rwb->wrnsegments; i++)
+    {
+      if (rwb->wrseg[i].window == window)
+        {
+          return &rwb->wrseg[i];
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrdirty
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static bool rwb_wrdirty(FAR struct rwbuffer_s *rwb)
+{
+  int i;
+
+  for (i = 0; i < rwb->wrnsegments; i++)
+    {
+      if (rwb->wrseg[i].nblocks > 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrbusy
+ *
+ * Description:
+ *   Return true if the flush worker owns a segment overlapping the given
+ *   range, or any segment at all if nblocks is zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static bool rwb_wrbusy(FAR struct rwbuffer_s *rwb, off_t startblock,
+                       size_t nblocks)
+{
+  FAR struct rwb_wrseg_s *seg;
+  int i;
+
+  for (i = 0; i < rwb->wrnsegments; i++)
+    {
+      seg = &rwb->wrseg[i];
+      if (seg->flushing &&
+          (nblocks == 0 || rwb_overlap(seg->blockstart, seg->nblocks,
+                                       startblock, nblocks)))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrwait
+ *
+ * Description:
+ *   Wait for the flush worker to release its segments.  The wrlock is
+ *   dropped while waiting, so the caller must re-evaluate the buffer state
+ *   afterwards.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrwait(FAR struct rwbuffer_s *rwb)
+{
+  rwb->wrwaiters++;
+  rwb_unlock(&rwb->wrlock);
+  nxsem_wait_uninterruptible(&rwb->wrsem);
+  rwb_lock(&rwb->wrlock);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrfill
+ *
+ * Description:
+ *   Load the blocks [startblock, endblock) of a segment window from the
+ *   media.  None of these blocks can be buffered in another segment.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrfill(FAR struct rwbuffer_s *rwb,
+                       FAR struct rwb_wrseg_s *seg,
+                       off_t startblock, off_t endblock)
+{
+  if (endblock > startblock)
+    {
+      rwb_read_(rwb, startblock, endblock - startblock,
+                seg->buffer + (startblock - seg->window) * rwb->blocksize);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrpad
+ *
+ * Description:
+ *   Extend a segment at both ends so that it covers whole multiples of
+ *   wralignblocks before it is handed to the flush callout.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrpad(FAR struct rwbuffer_s *rwb,
+                      FAR struct rwb_wrseg_s *seg)
+{
+  off_t first = seg->blockstart - seg->blockstart % rwb->wralignblocks;
+  off_t end   = seg->blockstart + seg->nblocks;
+  size_t padblocks;
+
+  rwb_wrfill(rwb, seg, first, seg->blockstart);
+
+  padblocks = end % rwb->wralignblocks;
+  if (padblocks)
+    {
+      padblocks = rwb->wralignblocks - padblocks;
+      rwb_wrfill(rwb, seg, end, end + padblocks);
+      end += padblocks;
+    }
+
+  seg->blockstart = first;
+  seg->nblocks    = end - first;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrnext
+ *
+ * Description:
+ *   Remove and return the segment with the lowest window from the set of
+ *   segment indexes, or -1 if the set is empty.  Segments are flushed in
+ *   this order so the media sees ascending block addresses.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static int rwb_wrnext(FAR struct rwbuffer_s *rwb, FAR uint32_t *set)
+{
+  int next = -1;
+  int i;
+
+  for (i = 0; i < rwb->wrnsegments; i++)
+    {
+      if ((*set & (1u << i)) != 0 &&
+          (next < 0 || rwb->wrseg[i].window < rwb->wrseg[next].window))
+        {
+          next = i;
+        }
+    }
+
+  if (next >= 0)
+    {
+      *set &= ~(1u << next);
+    }
+
+  return next;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrflushseg
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrflushseg(FAR struct rwbuffer_s *rwb,
+                           FAR struct rwb_wrseg_s *seg)
+{
+  FAR const uint8_t *buffer;
+  ssize_t ret;
+
+  DEBUGASSERT(seg->blockstart % rwb->wralignblocks == 0);
+
+  buffer = seg->buffer + (seg->blockstart - seg->window) * rwb->blocksize;
+
+  finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
+        (long)seg->blockstart, seg->nblocks, buffer);
+
+  /* Flush cache.  On success, the flush method will return the number
+   * of blocks written.  Anything other than the number requested is
+   * an error.
+   */
+
+  ret = rwb_flushdev(rwb, buffer, seg->blockstart, seg->nblocks);
+  if (ret != seg->nblocks)
+    {
+      ferr("ERROR: Error flushing write buffer: %zd\n", ret);
+    }
+
+#ifdef CONFIG_DRVR_READAHEAD
+  /* The read-ahead buffer may have been loaded with these blocks while
+   * they were still only in the write buffer.
+   */
+
+  rwb_rhdiscard(rwb, seg->blockstart, seg->nblocks);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrflushidle
+ *
+ * Description:
+ *   Synchronously flush every dirty segment that the flush worker does not
+ *   own, skipping 'skip' unless it is full.
+ *
+ * Assumptions:
+ *   The caller holds the wrlock mutex.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static uint32_t rwb_wrselect(FAR struct rwbuffer_s *rwb,
+                             FAR struct rwb_wrseg_s *skip)
+{
+  FAR struct rwb_wrseg_s *seg;
+  uint32_t set = 0;
+  int i;
+
+  for (i = 0; i < rwb->wrnsegments; i++)
+    {
+      seg = &rwb->wrseg[i];
+      if (seg->nblocks > 0 && !seg->flushing &&
+          (seg != skip || seg->nblocks == rwb->wrsegblocks))
+        {
+          rwb_wrpad(rwb, seg);
+          set |= 1u << i;
+        }
+    }
+
+  return set;
+}
+
+static void rwb_wrflushidle(FAR struct rwbuffer_s *rwb)
 {
-  /* We assume that the caller holds the wrlock */
+  uint32_t set = rwb_wrselect(rwb, NULL);
+  int i;
 
-  rwb->wrnblocks    = 0;
-  rwb->wrblockstart = -1;
+  while ((i = rwb_wrnext(rwb, &set)) >= 0)
+    {
+      rwb_wrflushseg(rwb, &rwb->wrseg[i]);
+      rwb_resetwrseg(rwb, &rwb->wrseg[i]);
+    }
 }
 #endif
 
 /****************************************************************************
  * Name: rwb_wrflush
  *
+ * Description:
+ *   Flush the whole write buffer, including the segments currently being
+ *   written by the flush worker.
+ *
  * Assumptions:
  *   The caller holds the wrlock mutex.
  *
@@ -137,40 +494,91 @@ static inline void rwb_resetwrbuffer(FAR struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrflush(FAR struct rwbuffer_s *rwb)
 {
-  int ret;
-
-  if (rwb->wrnblocks > 0)
+  rwb_wrflushidle(rwb);
+  while (rwb_wrbusy(rwb, 0, 0))
     {
-      size_t padblocks;
+      rwb_wrwait(rwb);
+      rwb_wrflushidle(rwb);
+    }
+}
+#endif
 
-      DEBUGASSERT(rwb->wrblockstart % rwb->wralignblocks == 0);
+/****************************************************************************
+ * Name: rwb_wrflushwork
+ *
+ * Description:
+ *   Background flush started when the last free segment is taken.  The
+ *   selected segments are written without holding the wrlock so the
+ *   writer can keep filling the segment it is streaming into, and readers
+ *   can still be served from the segments in flight.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_SCHED_WORKQUEUE)
+static void rwb_wrflushwork(FAR void *arg)
+{
+  FAR struct rwbuffer_s *rwb = (FAR struct rwbuffer_s *)arg;
+  uint32_t flushed;
+  uint32_t set;
+  int i;
 
-      finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
-            (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
+  DEBUGASSERT(rwb != NULL);
 
-      padblocks = rwb->wrnblocks % rwb->wralignblocks;
-      if (padblocks)
+  rwb_lock(&rwb->wrlock);
+  set = rwb_wrselect(rwb, rwb->wrlast);
+  for (i = 0; i < rwb->wrnsegments; i++)
+    {
+      if ((set & (1u << i)) != 0)
         {
-          padblocks = rwb->wralignblocks - padblocks;
-          rwb_read_(rwb, rwb->wrblockstart + rwb->wrnblocks, padblocks,
-                    &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-          rwb->wrnblocks += padblocks;
+          rwb->wrseg[i].flushing = true;
         }
+    }
 
-      /* Flush cache.  On success, the flush method will return the number
-       * of blocks written.  Anything other than the number requested is
-       * an error.
-       */
+  rwb_unlock(&rwb->wrlock);
+
+  /* Only this worker changes a segment marked flushing, so its state is
+   * stable without the lock.
+   */
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart,
-                         rwb->wrnblocks);
-      if (ret != rwb->wrnblocks)
+  flushed = set;
+  while ((i = rwb_wrnext(rwb, &set)) >= 0)
+    {
+      rwb_wrflushseg(rwb, &rwb->wrseg[i]);
+    }
+
+  rwb_lock(&rwb->wrlock);
+  for (i = 0; i < rwb->wrnsegments; i++)
+    {
+      if ((flushed & (1u << i)) != 0)
         {
-          ferr("ERROR: Error flushing write buffer: %d\n", ret);
+          rwb_resetwrseg(rwb, &rwb->wrseg[i]);
         }
+    }
 
-      rwb_resetwrbuffer(rwb);
+  while (rwb->wrwaiters > 0)
+    {
+      rwb->wrwaiters--;
+      nxsem_post(&rwb->wrsem);
     }
+
+  rwb_unlock(&rwb->wrlock);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrstartflush
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrstartflush(FAR struct rwbuffer_s *rwb)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE
+  if (rwb->wrnsegments > 1 && rwb_wrfind(rwb, -1) == NULL &&
+      work_available(&rwb->flushwork))
+    {
+      work_queue(LPWORK, &rwb->flushwork, rwb_wrflushwork, rwb, 0);
+    }
+#endif
 }
 #endif
 
@@ -231,107 +639,141 @@ static inline void rwb_wrcanceltimeout(FAR struct rwbuffer_s *rwb)
 #endif
 
 /****************************************************************************
- * Name: rwb_writebuffer
+ * Name: rwb_wrmerge
+ *
+ * Description:
+ *   Copy blocks that all fall inside the window of 'seg' into the segment.
+ *   A segment always holds one contiguous run of blocks, so any hole
+ *   between the buffered run and the new blocks, and the leading
+ *   alignment padding of a fresh segment, is loaded from the media.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
-                               off_t startblock, uint32_t nblocks,
-                               FAR const uint8_t *wrbuffer)
+static void rwb_wrmerge(FAR struct rwbuffer_s *rwb,
+                        FAR struct rwb_wrseg_s *seg, off_t startblock,
+                        size_t nblocks, FAR const uint8_t *wrbuffer)
 {
-  uint32_t nwritten = nblocks;
-
-  /* Write writebuffer Logic */
+  off_t first = startblock - startblock % rwb->wralignblocks;
+  off_t end   = startblock + nblocks;
+  off_t segend;
 
-  rwb_wrcanceltimeout(rwb);
-
-  /* Is data saved in the write buffer? */
-
-  if (rwb->wrnblocks > 0)
+  if (seg->nblocks == 0)
     {
-      off_t wrbend;
-      off_t newend;
-
-      /* Now there are five cases:
-       *
-       * 1. We update the non-overlapping region
-       */
-
-      wrbend = rwb->wrblockstart + rwb->wrnblocks;
-      newend = startblock + nblocks;
-
-      if (wrbend < startblock || rwb->wrblockstart > newend)
+      rwb_wrfill(rwb, seg, first, startblock);
+      seg->blockstart = first;
+      segend = end;
+    }
+  else
+    {
+      segend = seg->blockstart + seg->nblocks;
+      if (startblock > segend)
         {
-          /* Nothing to do */;
+          rwb_wrfill(rwb, seg, segend, startblock);
         }
-
-      /* 2. We update the entire write buffer. */
-
-      else if (rwb->wrblockstart > startblock && wrbend < newend)
+      else if (end < seg->blockstart)
         {
-          rwb->wrnblocks = 0;
+          rwb_wrfill(rwb, seg, end, seg->blockstart);
         }
 
-      /* We are going to update a subset of the write buffer.  Three
-       * more cases to consider:
-       *
-       * 3. We update a portion in the middle of the write buffer
-       */
+      if (startblock < seg->blockstart)
+        {
+          rwb_wrfill(rwb, seg, first, startblock);
+          seg->blockstart = first;
+        }
 
-      else if (rwb->wrblockstart <= startblock && wrbend >= newend)
+      if (end > segend)
         {
-          FAR uint8_t *dest;
-          size_t offset;
+          segend = end;
+        }
+    }
 
-          /* Copy the data to the middle of write buffer */
+  memcpy(seg->buffer + (startblock - seg->window) * rwb->blocksize,
+         wrbuffer, nblocks * rwb->blocksize);
+  seg->nblocks = segend - seg->blockstart;
+}
+#endif
 
-          offset = startblock - rwb->wrblockstart;
-          dest   = rwb->wrbuffer + offset * rwb->blocksize;
-          memcpy(dest, wrbuffer, nblocks * rwb->blocksize);
+/****************************************************************************
+ * Name: rwb_wrupdate
+ *
+ * Description:
+ *   Refresh the part of a buffered segment overlapped by a write that
+ *   bypasses the write buffer, so that a later flush of the segment does
+ *   not bring stale data back.
+ *
+ ****************************************************************************/
 
-          nblocks = 0;
-        }
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrupdate(FAR struct rwbuffer_s *rwb,
+                         FAR struct rwb_wrseg_s *seg, off_t startblock,
+                         size_t nblocks, FAR const uint8_t *wrbuffer)
+{
+  off_t first = startblock;
+  off_t end   = startblock + nblocks;
 
-      /* 4. We update a portion at the end of the write buffer */
+  if (first < seg->blockstart)
+    {
+      first = seg->blockstart;
+    }
 
-      else if (wrbend >= startblock && wrbend <= newend)
-        {
-          FAR uint8_t *dest;
-          size_t offset;
-          size_t ncopy;
+  if (end > seg->blockstart + seg->nblocks)
+    {
+      end = seg->blockstart + seg->nblocks;
+    }
 
-          /* Copy the data from the updating region to the end
-           * of the write buffer.
-           */
+  memcpy(seg->buffer + (first - seg->window) * rwb->blocksize,
+         wrbuffer + (first - startblock) * rwb->blocksize,
+         (end - first) * rwb->blocksize);
+}
+#endif
 
-          offset = rwb->wrnblocks - (wrbend - startblock);
-          ncopy  = rwb->wrmaxblocks - offset;
-          if (ncopy > nblocks)
-            {
-              ncopy = nblocks;
-            }
+/****************************************************************************
+ * Name: rwb_writebuffer
+ *
+ * Assumptions:
+ *   The caller holds the wrlock mutex.
+ *
+ ****************************************************************************/
 
-          dest = rwb->wrbuffer + offset * rwb->blocksize;
-          memcpy(dest, wrbuffer, ncopy * rwb->blocksize);
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
+                               off_t startblock, uint32_t nblocks,
+                               FAR const uint8_t *wrbuffer)
+{
+  FAR struct rwb_wrseg_s *seg;
+  uint32_t nwritten = nblocks;
+  int i;
 
-          rwb->wrnblocks = offset + ncopy;
-          wrbuffer      += ncopy * rwb->blocksize;
-          startblock    += ncopy;
-          nblocks       -= ncopy;
-        }
+  /* Write writebuffer Logic */
 
-      /* 5. We update a portion at the beginning of the write buffer.
-       * For writes that are ahead of the writerbuffer, we first flush and
-       * then process the write in the new writebuffer to ensure that each
-       * wrblockstart is aligned according to wralignblocks.
-       */
-    }
+  rwb_wrcanceltimeout(rwb);
 
-  /* Use the block cache unless the buffer size is bigger than block cache */
+  /* Use the block cache unless the buffer size is bigger than block cache.
+   * Buffered blocks hit by such a write are refreshed in place.
+   */
 
   if (nblocks > rwb->wrmaxblocks)
     {
-      ssize_t ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+      ssize_t ret;
+
+      while (rwb_wrbusy(rwb, startblock, nblocks))
+        {
+          rwb_wrwait(rwb);
+        }
+
+      for (i = 0; i < rwb->wrnsegments; i++)
+        {
+          seg = &rwb->wrseg[i];
+          if (seg->nblocks > 0 &&
+              rwb_overlap(seg->blockstart, seg->nblocks,
+                          startblock, nblocks))
+            {
+              rwb_wrupdate(rwb, seg, startblock, nblocks, wrbuffer);
+            }
+        }
+
+      ret = rwb_flushdev(rwb, wrbuffer, startblock, nblocks);
       if (ret < 0)
         {
           return ret;
@@ -342,43 +784,61 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
 
   while (nblocks > 0)
     {
-      size_t padblocks;
-      size_t remain = nblocks;
-
-      /* Flush the write buffer */
+      off_t window = startblock - startblock % rwb->wrsegblocks;
+      size_t remain = window + rwb->wrsegblocks - startblock;
 
-      rwb_wrflush(rwb);
+      if (remain > nblocks)
+        {
+          remain = nblocks;
+        }
 
-      /* Get the alignment padding of startblock, and read the contents
-       * of the padding area, ensure that wrblockstart is aligned
-       * according to wralignblocks.
+      /* Find the segment caching this window, or claim a free one.  When
+       * none is free, wait for the background flush if one is running or
+       * flush everything here otherwise.  A segment owned by the flush
+       * worker cannot be modified until it is done with it.
        */
 
-      padblocks = startblock % rwb->wralignblocks;
-      rwb->wrblockstart = startblock - padblocks;
-      rwb->wrnblocks = padblocks;
-      rwb_read_(rwb, rwb->wrblockstart, padblocks, rwb->wrbuffer);
-
-      if (remain > rwb->wrmaxblocks - padblocks)
+      seg = rwb_wrfind(rwb, window);
+      if (seg != NULL && seg->flushing)
         {
-          remain = rwb->wrmaxblocks - padblocks;
+          rwb_wrwait(rwb);
+          continue;
+        }
+      else if (seg == NULL)
+        {
+          seg = rwb_wrfind(rwb, -1);
+          if (seg == NULL)
+            {
+              if (rwb_wrbusy(rwb, 0, 0))
+                {
+                  rwb_wrwait(rwb);
+                }
+              else
+                {
+                  rwb_wrflushidle(rwb);
+                }
+
+              continue;
+            }
+
+          seg->window = window;
         }
 
       /* Buffer the data in the write buffer */
 
-      memcpy(rwb->wrbuffer + padblocks * rwb->blocksize, wrbuffer,
-             remain * rwb->blocksize);
-      rwb->wrnblocks += remain;
+      rwb_wrmerge(rwb, seg, startblock, remain, wrbuffer);
+      rwb->wrlast = seg;
 
       /* Update remain state of write buffer */
 
-      nblocks -= remain;
+      nblocks    -= remain;
       startblock += remain;
-      wrbuffer += remain * rwb->blocksize;
+      wrbuffer   += remain * rwb->blocksize;
     }
 
-  if (rwb->wrnblocks > 0)
+  if (rwb_wrdirty(rwb))
     {
+      rwb_wrstartflush(rwb);
       rwb_wrstarttimeout(rwb);
     }
 
@@ -476,7 +936,7 @@ static int rwb_rhreload(FAR struct rwbuffer_s *rwb, off_t startblock)
 
   /* Now perform the read */
 
-  ret = rwb->rhreload(rwb->dev, rwb->rhbuffer, startblock, nblocks);
+  ret = rwb_reloaddev(rwb, rwb->rhbuffer, startblock, nblocks);
   if (ret == nblocks)
     {
       /* Update information about what is in the read-ahead buffer */
@@ -507,11 +967,13 @@ static int rwb_rhreload(FAR struct rwbuffer_s *rwb, off_t startblock)
 int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, size_t blockcount)
 {
+  FAR struct rwb_wrseg_s *seg;
   int ret = OK;
+  int i;
 
-  /* Is there a write buffer?  Is data saved in the write buffer? */
+  /* Is there a write buffer? */
 
-  if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0)
+  if (rwb->wrmaxblocks > 0)
     {
       off_t wrbend;
       off_t invend;
@@ -525,111 +987,90 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
           return ret;
         }
 
-      /* Now there are five cases:
-       *
-       * 1. We invalidate nothing
-       */
-
-      wrbend = rwb->wrblockstart + rwb->wrnblocks;
-      invend = startblock + blockcount;
-
-      if (wrbend <= startblock || rwb->wrblockstart >= invend)
-        {
-          ret = OK;
-        }
-
-      /* 2. We invalidate the entire write buffer. */
-
-      else if (rwb->wrblockstart >= startblock && wrbend <= invend)
+      while (rwb_wrbusy(rwb, startblock, blockcount))
         {
-          rwb->wrnblocks = 0;
-          ret = OK;
+          rwb_wrwait(rwb);
         }
 
-      /* We are going to invalidate a subset of the write buffer.  Three
-       * more cases to consider:
-       *
-       * 3. We invalidate a portion in the middle of the write buffer
-       */
+      invend = startblock + blockcount;
 
-      else if (rwb->wrblockstart < startblock && wrbend > invend)
+      for (i = 0; i < rwb->wrnsegments; i++)
         {
-          FAR uint8_t *src;
-          off_t block;
-          off_t offset;
-          size_t nblocks;
+          seg = &rwb->wrseg[i];
+          if (seg->nblocks == 0)
+            {
+              continue;
+            }
 
-          /* Write the blocks at the end of the media to hardware */
+          /* Now there are five cases for each segment:
+           *
+           * 1. We invalidate nothing
+           */
 
-          nblocks = wrbend - invend;
-          block   = invend;
-          offset  = block - rwb->wrblockstart;
-          src     = rwb->wrbuffer + offset * rwb->blocksize;
+          wrbend = seg->blockstart + seg->nblocks;
 
-          ret = rwb->wrflush(rwb->dev, src, block, nblocks);
-          if (ret < 0)
+          if (wrbend <= startblock || seg->blockstart >= invend)
             {
-              ferr("ERROR: wrflush failed: %d\n", ret);
+              continue;
             }
 
-          /* Keep the blocks at the beginning of the buffer up the
-           * start of the invalidated region.
-           */
+          /* 2. We invalidate the entire segment. */
 
-          else
+          else if (seg->blockstart >= startblock && wrbend <= invend)
             {
-              rwb->wrnblocks = startblock - rwb->wrblockstart;
-              ret = OK;
+              rwb_resetwrseg(rwb, seg);
             }
-        }
 
-      /* 4. We invalidate a portion at the end of the write buffer */
-
-      else if (wrbend > startblock && wrbend <= invend)
-        {
-          rwb->wrnblocks -= wrbend - startblock;
-          ret = OK;
-        }
+          /* We are going to invalidate a subset of the segment.  Three
+           * more cases to consider:
+           *
+           * 3. We invalidate a portion in the middle of the segment
+           */
 
-      /* 5. We invalidate a portion at the beginning of the write buffer */
+          else if (seg->blockstart < startblock && wrbend > invend)
+            {
+              FAR uint8_t *src;
+              ssize_t nwritten;
 
-      else /* if (rwb->wrblockstart >= startblock && wrbend > invend) */
-        {
-          FAR uint8_t *src;
-          size_t ninval;
-          size_t nkeep;
+              /* Write the blocks at the end of the segment to hardware */
 
-          DEBUGASSERT(rwb->wrblockstart >= startblock && wrbend > invend);
+              src = seg->buffer + (invend - seg->window) * rwb->blocksize;
+              nwritten = rwb_flushdev(rwb, src, invend, wrbend - invend);
+              if (nwritten < 0)
+                {
+                  ferr("ERROR: wrflush failed: %zd\n", nwritten);
+                  ret = nwritten;
+                }
 
-          /* Copy the data from the uninvalidated region to the beginning
-           * of the write buffer.
-           *
-           * First calculate the source and destination of the transfer.
-           */
+              /* Keep the blocks at the beginning of the segment up the
+               * start of the invalidated region.
+               */
 
-          ninval = invend - rwb->wrblockstart;
-          src    = rwb->wrbuffer + ninval * rwb->blocksize;
+              else
+                {
+                  seg->nblocks = startblock - seg->blockstart;
+                }
+            }
 
-          /* Calculate the number of blocks we are keeping.  We keep
-           * the ones that we don't invalidate.
-           */
+          /* 4. We invalidate a portion at the end of the segment */
 
-          nkeep  = rwb->wrnblocks - ninval;
+          else if (wrbend > startblock && wrbend <= invend)
+            {
+              seg->nblocks -= wrbend - startblock;
+            }
 
-          /* Then move the data that we are keeping to the beginning
-           * the write buffer.
+          /* 5. We invalidate a portion at the beginning of the segment.
+           * The segment buffer is indexed from its window, so keeping the
+           * tail only means moving the start of the buffered run.
            */
 
-          memcpy(rwb->wrbuffer, src, nkeep * rwb->blocksize);
-
-          /* Update the block info.  The first block is now the one just
-           * after the invalidation region and the number buffered blocks
-           * is the number that we kept.
-           */
+          else /* if (seg->blockstart >= startblock && wrbend > invend) */
+            {
+              DEBUGASSERT(seg->blockstart >= startblock && wrbend > invend);
 
-          rwb->wrblockstart = invend;
-          rwb->wrnblocks    = nkeep;
-          ret = OK;
+              seg->blockstart = invend;
+              seg->nblocks    = wrbend - invend;
+            }
         }
 
       rwb_unlock(&rwb->wrlock);
@@ -758,6 +1199,54 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_rhdiscard
+ *
+ * Description:
+ *   Drop the blocks of the read-ahead buffer that a write is replacing.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_READAHEAD
+static int rwb_rhdiscard(FAR struct rwbuffer_s *rwb, off_t startblock,
+                         size_t nblocks)
+{
+  int ret;
+
+  if (rwb->rhmaxblocks == 0)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_DRVR_INVALIDATE
+  /* Just invalidate the read buffer startblock + nblocks data.  This
+   * takes the rhlock itself.
+   */
+
+  ret = rwb_invalidate_readahead(rwb, startblock, nblocks);
+  if (ret < 0)
+    {
+      ferr("ERROR: rwb_invalidate_readahead failed: %d\n", ret);
+    }
+#else
+  ret = rwb_lock(&rwb->rhlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks))
+    {
+      rwb_resetrhbuffer(rwb);
+    }
+
+  rwb_unlock(&rwb->rhlock);
+#endif
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -791,6 +1280,8 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
   if (rwb->wrmaxblocks > 0)
     {
+      int i;
+
       finfo("Initialize the write buffer\n");
 
       if (rwb->wralignblocks == 0)
@@ -798,29 +1289,56 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
           rwb->wralignblocks = 1;
         }
 
-      DEBUGASSERT(rwb->wralignblocks <= rwb->wrmaxblocks &&
-                  rwb->wrmaxblocks % rwb->wralignblocks == 0);
+      if (rwb->wrnsegments == 0)
+        {
+          rwb->wrnsegments = 1;
+        }
+
+      /* Each segment caches an aligned window of wrsegblocks blocks */
+
+      DEBUGASSERT(rwb->wrnsegments <= 32 &&
+                  rwb->wrmaxblocks % rwb->wrnsegments == 0);
+      rwb->wrsegblocks = rwb->wrmaxblocks / rwb->wrnsegments;
+      DEBUGASSERT(rwb->wralignblocks <= rwb->wrsegblocks &&
+                  rwb->wrsegblocks % rwb->wralignblocks == 0);
 
       /* Initialize the write buffer access mutex */
 
       nxmutex_init(&rwb->wrlock);
+      nxmutex_init(&rwb->wriolock);
+      nxsem_init(&rwb->wrsem, 0, 0);
+      rwb->wrwaiters = 0;
+      rwb->wrlast    = NULL;
 
-      /* Initialize write buffer parameters */
-
-      rwb_resetwrbuffer(rwb);
-
-      /* Allocate the write buffer */
+      /* Allocate the write buffer and the segment table */
 
       allocsize     = rwb->wrmaxblocks * rwb->blocksize;
       rwb->wrbuffer = kmm_malloc(allocsize);
-      if (!rwb->wrbuffer)
+      rwb->wrseg    = kmm_malloc(rwb->wrnsegments *
+                                 sizeof(struct rwb_wrseg_s));
+      if (!rwb->wrbuffer || !rwb->wrseg)
         {
           ferr("Write buffer kmm_malloc(%" PRIu32 ") failed\n", allocsize);
+          kmm_free(rwb->wrbuffer);
+          kmm_free(rwb->wrseg);
+          nxsem_destroy(&rwb->wrsem);
+          nxmutex_destroy(&rwb->wriolock);
           nxmutex_destroy(&rwb->wrlock);
           return -ENOMEM;
         }
 
-      finfo("Write buffer size: %" PRIu32 " bytes\n", allocsize);
+      /* Initialize write buffer parameters */
+
+      for (i = 0; i < rwb->wrnsegments; i++)
+        {
+          rwb->wrseg[i].buffer = rwb->wrbuffer +
+                                 i * rwb->wrsegblocks * rwb->blocksize;
+        }
+
+      rwb_resetwrbuffer(rwb);
+
+      finfo("Write buffer size: %" PRIu32 " bytes in %u segments\n",
+            allocsize, rwb->wrnsegments);
     }
 #endif /* CONFIG_DRVR_WRITEBUFFER */
 
@@ -849,7 +1367,10 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
           if (rwb->wrmaxblocks > 0)
             {
+              nxsem_destroy(&rwb->wrsem);
+              nxmutex_destroy(&rwb->wriolock);
               nxmutex_destroy(&rwb->wrlock);
+              kmm_free(rwb->wrseg);
             }
 
           if (rwb->wrbuffer != NULL)
@@ -877,9 +1398,17 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
   if (rwb->wrmaxblocks > 0)
     {
+#ifdef CONFIG_SCHED_WORKQUEUE
+      work_cancel_sync(LPWORK, &rwb->flushwork);
+#endif
       rwb_wrcanceltimeout(rwb);
+      rwb_lock(&rwb->wrlock);
       rwb_wrflush(rwb);
+      rwb_unlock(&rwb->wrlock);
+      nxsem_destroy(&rwb->wrsem);
+      nxmutex_destroy(&rwb->wriolock);
       nxmutex_destroy(&rwb->wrlock);
+      kmm_free(rwb->wrseg);
       if (rwb->wrbuffer)
         {
           kmm_free(rwb->wrbuffer);
@@ -983,7 +1512,7 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
 
       if (nblocks)
         {
-          ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, nblocks);
+          ret = rwb_reloaddev(rwb, rdbuffer, startblock, nblocks);
         }
     }
 
@@ -1010,23 +1539,53 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
 
   if (rwb->wrmaxblocks > 0)
     {
+      FAR struct rwb_wrseg_s *seg;
+      size_t rdblocks;
+      off_t segend;
+      int i;
+
       ret = rwb_lock(&rwb->wrlock);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* If the write buffer overlaps the block(s) requested */
-
-      if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock,
-                      nblocks))
+      while (nblocks > 0)
         {
-          size_t rdblocks = 0;
-          size_t wrnpass  = 0;
+          seg = rwb_wrfind(rwb, startblock - startblock %
+                                rwb->wrsegblocks);
+          segend = seg != NULL ? seg->blockstart + seg->nblocks : 0;
 
-          if (rwb->wrblockstart > startblock)
+          if (seg != NULL && startblock >= seg->blockstart &&
+              startblock < segend)
             {
-              rdblocks = rwb->wrblockstart - startblock;
+              /* Copy what the segment holds */
+
+              rdblocks = segend - startblock;
+              if (rdblocks > nblocks)
+                {
+                  rdblocks = nblocks;
+                }
+
+              memcpy(rdbuffer,
+                     seg->buffer + (startblock - seg->window) *
+                     rwb->blocksize, rdblocks * rwb->blocksize);
+            }
+          else
+            {
+              /* Read from the media up to the next buffered block */
+
+              rdblocks = nblocks;
+              for (i = 0; i < rwb->wrnsegments; i++)
+                {
+                  seg = &rwb->wrseg[i];
+                  if (seg->nblocks > 0 && seg->blockstart > startblock &&
+                      seg->blockstart - startblock < rdblocks)
+                    {
+                      rdblocks = seg->blockstart - startblock;
+                    }
+                }
+
               ret = rwb_read_(rwb, startblock, rdblocks, rdbuffer);
               if (ret < 0)
                 {
@@ -1034,29 +1593,22 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
                   return ret;
                 }
 
-              startblock += ret;
-              nblocks    -= ret;
-              rdbuffer   += ret * rwb->blocksize;
-              readblocks += ret;
+              rdblocks = ret;
             }
 
-          if (rwb->wrblockstart < startblock)
-            {
-              wrnpass = startblock - rwb->wrblockstart;
-            }
-
-          rdblocks = nblocks > (rwb->wrnblocks - wrnpass) ?
-                    (rwb->wrnblocks - wrnpass) : nblocks;
-          memcpy(rdbuffer, &rwb->wrbuffer[wrnpass * rwb->blocksize],
-                rdblocks * rwb->blocksize);
-
           startblock += rdblocks;
           nblocks    -= rdblocks;
           rdbuffer   += rdblocks * rwb->blocksize;
           readblocks += rdblocks;
+
+          if (rdblocks == 0)
+            {
+              break;
+            }
         }
 
       rwb_unlock(&rwb->wrlock);
+      return readblocks;
     }
 #endif
 
@@ -1087,31 +1639,11 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
        * streaming applications.
        */
 
-      ret = rwb_lock(&rwb->rhlock);
+      ret = rwb_rhdiscard(rwb, startblock, nblocks);
       if (ret < 0)
         {
           return ret;
         }
-
-      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock,
-                      nblocks))
-        {
-#ifdef CONFIG_DRVR_INVALIDATE
-          /* Just invalidate the read buffer startblock + nblocks data */
-
-          ret = rwb_invalidate_readahead(rwb, startblock, nblocks);
-          if (ret < 0)
-            {
-              ferr("ERROR: rwb_invalidate_readahead failed: %d\n", ret);
-              rwb_unlock(&rwb->rhlock);
-              return ret;
-            }
-#else
-          rwb_resetrhbuffer(rwb);
-#endif
-        }
-
-      rwb_unlock(&rwb->rhlock);
     }
 #endif
 
@@ -1198,6 +1730,11 @@ int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
           return ret;
         }
 
+      while (rwb_wrbusy(rwb, 0, 0))
+        {
+          rwb_wrwait(rwb);
+        }
+
       rwb_resetwrbuffer(rwb);
       rwb_unlock(&rwb->wrlock);
     }
@@ -98,8 +98,16 @@
 
 #define IS_EMPTY(priv) (priv->type == MMCSD_CARDTYPE_UNKNOWN)
 
-#if CONFIG_MMCSD_MULTIBLOCK_LIMIT == 0
-#  define MMCSD_MULTIBLOCK_LIMIT SSIZE_MAX
+/* The block count of CMD23 (SET_BLOCK_COUNT) is a 16-bit field and the
+ * bits above it select the reliable write and packed command modes, so the
+ * larger requests have to be split even if no limit is configured.
+ */
+
+#define MMCSD_CMD23_MAXBLOCKS   65535
+
+#if CONFIG_MMCSD_MULTIBLOCK_LIMIT == 0 || \
+    CONFIG_MMCSD_MULTIBLOCK_LIMIT > MMCSD_CMD23_MAXBLOCKS
+#  define MMCSD_MULTIBLOCK_LIMIT MMCSD_CMD23_MAXBLOCKS
 #else
 #  define MMCSD_MULTIBLOCK_LIMIT CONFIG_MMCSD_MULTIBLOCK_LIMIT
 #endif
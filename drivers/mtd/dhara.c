@@ -55,6 +55,17 @@ struct dhara_pagecache_s
 
 typedef struct dhara_pagecache_s dhara_pagecache_t;
 
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+struct dhara_sectorcache_s
+{
+  dq_entry_t     node;
+  dhara_sector_t sector;
+  FAR uint8_t   *buffer;
+};
+
+typedef struct dhara_sectorcache_s dhara_sectorcache_t;
+#endif
+
 struct dhara_dev_s
 {
   struct dhara_nand     nand;
@@ -77,6 +88,18 @@ struct dhara_dev_s
 
   struct dq_queue_s readcache;
   dhara_pagecache_t readpage[CONFIG_DHARA_READ_NCACHES];
+
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  /* Write-back cache of dirty logical sectors, rewrites of a cached sector
+   * are absorbed in RAM and the whole set is committed to the map in
+   * sector order on eviction, flush or close.
+   */
+
+  struct dq_queue_s writecache;
+  struct dq_queue_s writefree;
+  FAR uint8_t *writebuf;
+  dhara_sectorcache_t writesector[CONFIG_DHARA_WRITE_NCACHES];
+#endif
 };
 
 typedef struct dhara_dev_s dhara_dev_t;
@@ -288,6 +311,136 @@ static void dhara_update_readcache(FAR dhara_dev_t *dev,
     }
 }
 
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+static int dhara_init_writecache(FAR dhara_dev_t *dev)
+{
+  int i;
+
+  dq_init(&dev->writecache);
+  dq_init(&dev->writefree);
+
+  dev->writebuf = kmm_malloc(dev->geo.blocksize *
+                             CONFIG_DHARA_WRITE_NCACHES);
+  if (dev->writebuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_DHARA_WRITE_NCACHES; i++)
+    {
+      dev->writesector[i].sector = DHARA_SECTOR_NONE;
+      dev->writesector[i].buffer = dev->writebuf + i * dev->geo.blocksize;
+      dq_addlast(&dev->writesector[i].node, &dev->writefree);
+    }
+
+  return 0;
+}
+
+static void dhara_deinit_writecache(FAR dhara_dev_t *dev)
+{
+  kmm_free(dev->writebuf);
+}
+
+static FAR dhara_sectorcache_t *
+dhara_find_writecache(FAR dhara_dev_t *dev, dhara_sector_t sector)
+{
+  FAR dq_entry_t *c;
+
+  for (c = dq_peek(&dev->writecache); c; c = dq_next(c))
+    {
+      if (((FAR dhara_sectorcache_t *)c)->sector == sector)
+        {
+          return (FAR dhara_sectorcache_t *)c;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: dhara_flush_writecache
+ *
+ * Description:
+ *   Commit every dirty sector to the map in ascending sector order, so a
+ *   burst of scattered writes reaches the journal as one sequential run.
+ *   Sectors that fail to commit stay cached and the error is returned.
+ *
+ ****************************************************************************/
+
+static int dhara_flush_writecache(FAR dhara_dev_t *dev)
+{
+  FAR dhara_sectorcache_t *sorted[CONFIG_DHARA_WRITE_NCACHES];
+  FAR dhara_sectorcache_t *cache;
+  FAR dq_entry_t *c;
+  dhara_error_t err;
+  int nsorted = 0;
+  int ret = 0;
+  int i;
+  int j;
+
+  for (c = dq_peek(&dev->writecache); c; c = dq_next(c))
+    {
+      cache = (FAR dhara_sectorcache_t *)c;
+      for (j = nsorted++; j > 0 && sorted[j - 1]->sector > cache->sector;
+           j--)
+        {
+          sorted[j] = sorted[j - 1];
+        }
+
+      sorted[j] = cache;
+    }
+
+  for (i = 0; i < nsorted; i++)
+    {
+      cache = sorted[i];
+      ret = dhara_map_write(&dev->map, cache->sector, cache->buffer, &err);
+      if (ret < 0)
+        {
+          ret = dhara_convert_result(err);
+          ferr("Flush sector %lu failed err %s\n",
+               (unsigned long)cache->sector, dhara_strerror(err));
+          break;
+        }
+
+      cache->sector = DHARA_SECTOR_NONE;
+      dq_rem(&cache->node, &dev->writecache);
+      dq_addlast(&cache->node, &dev->writefree);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dhara_sync
+ *
+ * Description:
+ *   Flush the write-back cache and checkpoint the map so that everything
+ *   written so far survives a power loss.
+ *
+ ****************************************************************************/
+
+static int dhara_sync(FAR dhara_dev_t *dev)
+{
+  dhara_error_t err;
+  int ret;
+
+  ret = dhara_flush_writecache(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = dhara_map_sync(&dev->map, &err);
+  if (ret < 0)
+    {
+      ret = dhara_convert_result(err);
+      ferr("Map sync failed err %s\n", dhara_strerror(err));
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: dhara_open
  *
@@ -323,12 +476,22 @@ static int dhara_close(FAR struct inode *inode)
   dev = inode->i_private;
   nxmutex_lock(&dev->lock);
   dev->refs--;
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  if (dev->refs == 0)
+    {
+      dhara_sync(dev);
+    }
+#endif
+
   nxmutex_unlock(&dev->lock);
 
   if (dev->refs == 0 && dev->unlinked)
     {
       nxmutex_destroy(&dev->lock);
       dhara_deinit_readcache(dev);
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+      dhara_deinit_writecache(dev);
+#endif
       kmm_free(dev->pagebuf);
       kmm_free(dev);
     }
@@ -359,6 +522,17 @@ static ssize_t dhara_read(FAR struct inode *inode,
   while (nsectors-- > 0)
     {
       dhara_error_t err;
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+      FAR dhara_sectorcache_t *cache;
+
+      cache = dhara_find_writecache(dev, start_sector);
+      if (cache != NULL)
+        {
+          memcpy(buffer, cache->buffer, dev->geo.blocksize);
+          goto next;
+        }
+#endif
+
       ret = dhara_map_read(&dev->map,
                            start_sector,
                            buffer,
@@ -371,6 +545,9 @@ static ssize_t dhara_read(FAR struct inode *inode,
           break;
         }
 
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+next:
+#endif
       nread++;
       start_sector++;
       buffer += dev->geo.blocksize;
@@ -402,6 +579,28 @@ static ssize_t dhara_write(FAR struct inode *inode,
   nxmutex_lock(&dev->lock);
   while (nsectors-- > 0)
     {
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+      FAR dhara_sectorcache_t *cache;
+
+      cache = dhara_find_writecache(dev, start_sector);
+      if (cache == NULL)
+        {
+          if (dq_empty(&dev->writefree))
+            {
+              ret = dhara_flush_writecache(dev);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+
+          cache = (FAR dhara_sectorcache_t *)dq_remfirst(&dev->writefree);
+          cache->sector = start_sector;
+          dq_addlast(&cache->node, &dev->writecache);
+        }
+
+      memcpy(cache->buffer, buffer, dev->geo.blocksize);
+#else
       dhara_error_t err;
       ret = dhara_map_write(&dev->map,
                             start_sector,
@@ -414,6 +613,7 @@ static ssize_t dhara_write(FAR struct inode *inode,
                (long long)start_sector, nwrite, dhara_strerror(err));
           break;
         }
+#endif
 
       nwrite++;
       start_sector++;
@@ -472,6 +672,19 @@ static int dhara_ioctl(FAR struct inode *inode,
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  if (cmd == BIOC_FLUSH)
+    {
+      nxmutex_lock(&dev->lock);
+      ret = dhara_sync(dev);
+      nxmutex_unlock(&dev->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -508,6 +721,9 @@ static int dhara_unlink(FAR struct inode *inode)
     {
       nxmutex_destroy(&dev->lock);
       dhara_deinit_readcache(dev);
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+      dhara_deinit_writecache(dev);
+#endif
       kmm_free(dev->pagebuf);
       kmm_free(dev);
     }
@@ -744,6 +960,14 @@ int dhara_initialize_by_path(FAR const char *path,
       goto err;
     }
 
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  ret = dhara_init_writecache(dev);
+  if (ret != 0)
+    {
+      goto err;
+    }
+#endif
+
   dhara_map_init(&dev->map, &dev->nand,
                  dev->pagebuf + dev->geo.blocksize,
                  CONFIG_DHARA_GC_RATIO);
@@ -766,6 +990,9 @@ int dhara_initialize_by_path(FAR const char *path,
 err:
   nxmutex_destroy(&dev->lock);
   dhara_deinit_readcache(dev);
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  dhara_deinit_writecache(dev);
+#endif
   kmm_free(dev->pagebuf);
   kmm_free(dev);
   return ret;
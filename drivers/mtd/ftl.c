@@ -950,8 +950,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd,
       dev->rwb.rhreload      = ftl_reload;
 
 #if defined(CONFIG_FTL_WRITEBUFFER)
-      dev->rwb.wrmaxblocks   = dev->blkper;
+      dev->rwb.wrmaxblocks   = dev->blkper * CONFIG_FTL_NWRSEGMENTS;
       dev->rwb.wralignblocks = dev->blkper;
+      dev->rwb.wrnsegments   = CONFIG_FTL_NWRSEGMENTS;
 #endif
 
 #ifdef CONFIG_FTL_READAHEAD
@@ -31,6 +31,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <debug.h>
 #include <fcntl.h>
@@ -65,6 +66,16 @@
  * Private Types
  ****************************************************************************/
 
+/* RAM index entry of a live allocation table entry */
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+struct nvs_index_s
+{
+  uint32_t              id;            /* Data id, hash of the key */
+  uint32_t              addr;          /* Address of the ate */
+};
+#endif
+
 /* Non-volatile Storage File system structure */
 
 struct nvs_fs
@@ -85,7 +96,32 @@ struct nvs_fs
 #if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
   uint32_t              cache[CONFIG_MTD_CONFIG_CACHE_SIZE];
 #endif
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  FAR struct nvs_index_s *index;       /* Live ates sorted by id, newest
+                                        * first for the same id
+                                        */
+  uint32_t              nindex;        /* Number of entries in index */
+  uint32_t              nalloc;        /* Allocated entries of index */
+#endif
+};
+
+/* Per item state of a batch write */
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+struct nvs_batch_s
+{
+#ifdef CONFIG_MTD_CONFIG_NAMED
+  FAR const uint8_t     *key;          /* Key of the item */
+#else
+  uint8_t               key[sizeof(uint16_t) + sizeof(int)];
+#endif
+  size_t                key_size;      /* Size of key */
+  uint32_t              id;            /* Hash id of key */
+  uint32_t              hist_addr;     /* Address of the previous ate */
+  bool                  prev;          /* The key has a previous ate */
+  bool                  skip;          /* The data is unchanged */
 };
+#endif
 
 /* Allocation Table Entry */
 
@@ -170,6 +206,250 @@ static void nvs_invalid_cache(struct nvs_fs *fs, uint32_t sector)
 }
 #endif /* CONFIG_MTD_CONFIG_CACHE_SIZE */
 
+/****************************************************************************
+ * Name: nvs_index_lower
+ *
+ * Description:
+ *   Return the position of the first index entry with an id not less
+ *   than id.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+static uint32_t nvs_index_lower(FAR struct nvs_fs *fs, uint32_t id)
+{
+  uint32_t low = 0;
+  uint32_t high = fs->nindex;
+  uint32_t mid;
+
+  while (low < high)
+    {
+      mid = low + (high - low) / 2;
+      if (fs->index[mid].id < id)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  return low;
+}
+
+/****************************************************************************
+ * Name: nvs_index_grow
+ ****************************************************************************/
+
+static int nvs_index_grow(FAR struct nvs_fs *fs)
+{
+  FAR struct nvs_index_s *index;
+  uint32_t nalloc;
+
+  if (fs->nindex < fs->nalloc)
+    {
+      return 0;
+    }
+
+  nalloc = fs->nalloc ? fs->nalloc * 2 : 16;
+  index = kmm_realloc(fs->index, nalloc * sizeof(struct nvs_index_s));
+  if (index == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fs->index = index;
+  fs->nalloc = nalloc;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: nvs_index_drop
+ *
+ * Description:
+ *   Release the index, the lookups fall back to walking the flash.
+ *
+ ****************************************************************************/
+
+static void nvs_index_drop(FAR struct nvs_fs *fs)
+{
+  kmm_free(fs->index);
+  fs->index = NULL;
+  fs->nindex = 0;
+  fs->nalloc = 0;
+}
+
+/****************************************************************************
+ * Name: nvs_index_add
+ *
+ * Description:
+ *   Add the ate just written at addr, ahead of the older ates of the same
+ *   id.
+ *
+ ****************************************************************************/
+
+static void nvs_index_add(FAR struct nvs_fs *fs, uint32_t id,
+                          uint32_t addr)
+{
+  uint32_t pos;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  if (nvs_index_grow(fs) < 0)
+    {
+      fwarn("Out of memory, drop the index\n");
+      nvs_index_drop(fs);
+      return;
+    }
+
+  pos = nvs_index_lower(fs, id);
+  memmove(&fs->index[pos + 1], &fs->index[pos],
+          (fs->nindex - pos) * sizeof(struct nvs_index_s));
+  fs->index[pos].id = id;
+  fs->index[pos].addr = addr;
+  fs->nindex++;
+}
+
+/****************************************************************************
+ * Name: nvs_index_remove
+ ****************************************************************************/
+
+static void nvs_index_remove(FAR struct nvs_fs *fs, uint32_t id,
+                             uint32_t addr)
+{
+  uint32_t pos;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  for (pos = nvs_index_lower(fs, id);
+       pos < fs->nindex && fs->index[pos].id == id; pos++)
+    {
+      if (fs->index[pos].addr == addr)
+        {
+          fs->nindex--;
+          memmove(&fs->index[pos], &fs->index[pos + 1],
+                  (fs->nindex - pos) * sizeof(struct nvs_index_s));
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_move
+ *
+ * Description:
+ *   The gc copied the ate at from to the address to.
+ *
+ ****************************************************************************/
+
+static void nvs_index_move(FAR struct nvs_fs *fs, uint32_t id,
+                           uint32_t from, uint32_t to)
+{
+  uint32_t pos;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  for (pos = nvs_index_lower(fs, id);
+       pos < fs->nindex && fs->index[pos].id == id; pos++)
+    {
+      if (fs->index[pos].addr == from)
+        {
+          fs->index[pos].addr = to;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_purge
+ *
+ * Description:
+ *   Remove the entries of a block that is about to be erased.
+ *
+ ****************************************************************************/
+
+static void nvs_index_purge(FAR struct nvs_fs *fs, uint32_t block)
+{
+  uint32_t i;
+  uint32_t n;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  for (i = 0, n = 0; i < fs->nindex; i++)
+    {
+      if ((fs->index[i].addr >> NVS_ADDR_BLOCK_SHIFT) != block)
+        {
+          fs->index[n++] = fs->index[i];
+        }
+    }
+
+  fs->nindex = n;
+}
+
+/****************************************************************************
+ * Name: nvs_index_rank
+ *
+ * Description:
+ *   Map an ate address to a value that orders the ates from the newest to
+ *   the oldest: the blocks are counted backwards from the write block and
+ *   the ates of a block are written from its end to its start.
+ *   nvs_index_addr() is the inverse.
+ *
+ ****************************************************************************/
+
+static uint32_t nvs_index_rank(FAR struct nvs_fs *fs, uint32_t addr)
+{
+  uint32_t block = (fs->ate_wra >> NVS_ADDR_BLOCK_SHIFT) + fs->nblocks -
+                   (addr >> NVS_ADDR_BLOCK_SHIFT);
+
+  return ((block % fs->nblocks) << NVS_ADDR_BLOCK_SHIFT) |
+         (addr & NVS_ADDR_OFFS_MASK);
+}
+
+/****************************************************************************
+ * Name: nvs_index_addr
+ ****************************************************************************/
+
+static uint32_t nvs_index_addr(FAR struct nvs_fs *fs, uint32_t rank)
+{
+  uint32_t block = (fs->ate_wra >> NVS_ADDR_BLOCK_SHIFT) + fs->nblocks -
+                   (rank >> NVS_ADDR_BLOCK_SHIFT);
+
+  return ((block % fs->nblocks) << NVS_ADDR_BLOCK_SHIFT) |
+         (rank & NVS_ADDR_OFFS_MASK);
+}
+
+/****************************************************************************
+ * Name: nvs_index_cmp
+ ****************************************************************************/
+
+static int nvs_index_cmp(FAR const void *a, FAR const void *b)
+{
+  FAR const struct nvs_index_s *x = a;
+  FAR const struct nvs_index_s *y = b;
+
+  if (x->id != y->id)
+    {
+      return x->id < y->id ? -1 : 1;
+    }
+
+  return x->addr < y->addr ? -1 : x->addr > y->addr;
+}
+#endif /* CONFIG_MTD_CONFIG_NVS_INDEX */
+
 /****************************************************************************
  * Name: nvs_fnv_hash
  ****************************************************************************/
@@ -425,6 +705,30 @@ static int nvs_flash_ate_wrt(FAR struct nvs_fs *fs,
   return rc;
 }
 
+/****************************************************************************
+ * Name: nvs_flash_ate_wrt_multi
+ *
+ * Description:
+ *   Write n allocation entries with one flash program.  The entries are
+ *   in flash order, the last one goes to the current ate_wra.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+static int nvs_flash_ate_wrt_multi(FAR struct nvs_fs *fs,
+                                   FAR const uint8_t *entries, size_t n)
+{
+  size_t ate_size = nvs_ate_size(fs);
+  uint32_t addr = fs->ate_wra - (n - 1) * ate_size;
+  int rc;
+
+  rc = nvs_flash_wrt(fs, addr, entries, n * ate_size);
+  fs->ate_wra -= n * ate_size;
+
+  return rc;
+}
+#endif
+
 /****************************************************************************
  * Name: nvs_flash_data_wrt
  ****************************************************************************/
@@ -630,6 +934,9 @@ static int nvs_flash_erase_block(FAR struct nvs_fs *fs, uint32_t addr)
 #if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
   nvs_invalid_cache(fs, addr >> NVS_ADDR_BLOCK_SHIFT);
 #endif
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  nvs_index_purge(fs, addr >> NVS_ADDR_BLOCK_SHIFT);
+#endif
 
   rc = MTD_ERASE(fs->mtd,
                  CONFIG_MTD_CONFIG_BLOCKSIZE_MULTIPLE *
@@ -783,32 +1090,22 @@ int nvs_flash_write_multi_blk(FAR struct nvs_fs *fs, const uint8_t *addr,
 }
 
 /****************************************************************************
- * Name: nvs_flash_wrt_entry
+ * Name: nvs_flash_wrt_kv
  *
  * Description:
- *   Store an entry in flash
+ *   Store the key and the data of an entry in flash, at data_wra
  *
  ****************************************************************************/
 
-static int nvs_flash_wrt_entry(FAR struct nvs_fs *fs, uint32_t id,
-                               FAR const uint8_t *key, size_t key_size,
-                               FAR const void *data, size_t len)
+static int nvs_flash_wrt_kv(FAR struct nvs_fs *fs, FAR const uint8_t *key,
+                            size_t key_size, FAR const void *data,
+                            size_t len)
 {
-  size_t ate_size = nvs_ate_size(fs);
-  NVS_ATE(entry, ate_size);
   uint8_t buf[fs->progsize];
   uint16_t copy_len = 0;
   uint16_t left;
   int rc;
 
-  memset(entry, fs->erasestate, ate_size);
-  entry->id = id;
-  entry->offset = fs->data_wra & NVS_ADDR_OFFS_MASK;
-  entry->len = len;
-  entry->key_len = key_size;
-
-  nvs_ate_crc8_update(entry);
-
   /* Let's save key and data into one, key comes first, then data */
 
   rc = nvs_flash_write_multi_blk(fs, key, key_size);
@@ -859,6 +1156,56 @@ static int nvs_flash_wrt_entry(FAR struct nvs_fs *fs, uint32_t id,
         }
     }
 
+  return 0;
+}
+
+/****************************************************************************
+ * Name: nvs_ate_init
+ *
+ * Description:
+ *   Initialize the allocation entry of data about to be written at data_wra
+ *
+ ****************************************************************************/
+
+static void nvs_ate_init(FAR struct nvs_fs *fs, FAR struct nvs_ate *entry,
+                         uint32_t id, size_t key_size, size_t len)
+{
+  memset(entry, fs->erasestate, nvs_ate_size(fs));
+  entry->id = id;
+  entry->offset = fs->data_wra & NVS_ADDR_OFFS_MASK;
+  entry->len = len;
+  entry->key_len = key_size;
+
+  nvs_ate_crc8_update(entry);
+}
+
+/****************************************************************************
+ * Name: nvs_flash_wrt_entry
+ *
+ * Description:
+ *   Store an entry in flash
+ *
+ ****************************************************************************/
+
+static int nvs_flash_wrt_entry(FAR struct nvs_fs *fs, uint32_t id,
+                               FAR const uint8_t *key, size_t key_size,
+                               FAR const void *data, size_t len)
+{
+  size_t ate_size = nvs_ate_size(fs);
+  NVS_ATE(entry, ate_size);
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  uint32_t ate_addr = fs->ate_wra;
+#endif
+  int rc;
+
+  nvs_ate_init(fs, entry, id, key_size, len);
+
+  rc = nvs_flash_wrt_kv(fs, key, key_size, data, len);
+  if (rc)
+    {
+      return rc;
+    }
+
   /* Last, let's save entry to flash */
 
   rc = nvs_flash_ate_wrt(fs, entry);
@@ -868,6 +1215,10 @@ static int nvs_flash_wrt_entry(FAR struct nvs_fs *fs, uint32_t id,
       return rc;
     }
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  nvs_index_add(fs, id, ate_addr);
+#endif
+
   return 0;
 }
 
@@ -1194,6 +1545,10 @@ static int nvs_gc(FAR struct nvs_fs *fs)
               return rc;
             }
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+          nvs_index_move(fs, gc_ate->id, gc_prev_addr, fs->ate_wra);
+#endif
+
           rc = nvs_flash_ate_wrt(fs, gc_ate);
           if (rc)
             {
@@ -1222,28 +1577,352 @@ gc_done:
 }
 
 /****************************************************************************
- * Name: nvs_startup
+ * Name: nvs_expire_old_ate
+ *
+ * Description:
+ *   Check if there exists an old entry with the same id and key as the
+ *   newest entry.  If so, power loss occurred before writing the old entry
+ *   id as expired.  We need to set old entry expired.
+ *
  ****************************************************************************/
 
-static int nvs_startup(FAR struct nvs_fs *fs)
+static int nvs_expire_old_ate(FAR struct nvs_fs *fs)
 {
-  struct mtd_geometry_s geo;
+  size_t ate_size = nvs_ate_size(fs);
+  NVS_ATE(second_ate, ate_size);
+  NVS_ATE(last_ate, ate_size);
   uint32_t second_addr;
   uint32_t last_addr;
   uint32_t wlk_addr;
-  size_t empty_len;
+  int rc;
 
-  /* Initialize addr to 0 for the case fs->nblocks == 0. This
-   * should never happen but both
-   * Coverity and GCC believe the contrary.
-   */
+  wlk_addr = fs->ate_wra;
+  while (1)
+    {
+      last_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, last_ate);
+      if (rc)
+        {
+          return rc;
+        }
 
-  uint16_t closed_blocks = 0;
-  uint32_t addr = 0;
-  uint16_t i;
-  int rc;
+      /* Skip last one */
 
-  fs->ate_wra = 0;
+      if (wlk_addr == fs->ate_wra)
+        {
+          break;
+        }
+
+      if (nvs_ate_valid(fs, last_ate)
+          && (last_ate->id != nvs_special_ate_id(fs)))
+        {
+          finfo("ate found at 0x%" PRIx32 ", id %" PRIu32 ", "
+                "key_len %" PRIu16 ", offset %" PRIu16 "\n",
+                last_addr, last_ate->id, last_ate->key_len,
+                last_ate->offset);
+
+#if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
+          fs->cache[nvs_cache_index(last_ate->id)] = last_addr;
+#endif
+          while (1)
+            {
+              second_addr = wlk_addr;
+              rc = nvs_prev_ate(fs, &wlk_addr, second_ate);
+              if (rc)
+                {
+                  return rc;
+                }
+
+              if (nvs_ate_valid(fs, second_ate)
+                  && !nvs_ate_expired(fs, second_ate))
+                {
+#if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
+                  fs->cache[nvs_cache_index(second_ate->id)] = second_addr;
+#endif
+                  if (second_ate->id == last_ate->id)
+                    {
+                      finfo("same id at 0x%" PRIx32 ", key_len %" PRIu16 ", "
+                            "offset %" PRIu16 "\n", second_addr,
+                            second_ate->key_len, second_ate->offset);
+                      if ((second_ate->key_len == last_ate->key_len) &&
+                          !nvs_flash_direct_cmp(fs,
+                                                (last_addr &
+                                                 NVS_ADDR_BLOCK_MASK) +
+                                                last_ate->offset,
+                                                (second_addr &
+                                                 NVS_ADDR_BLOCK_MASK) +
+                                                second_ate->offset,
+                                                last_ate->key_len))
+                        {
+                          finfo("old ate found at 0x%" PRIx32 "\n",
+                                second_addr);
+                          rc = nvs_expire_ate(fs, second_addr);
+                          if (rc < 0)
+                            {
+                              ferr("expire ate failed, addr %" PRIx32 "\n",
+                                  second_addr);
+                              return rc;
+                            }
+
+                          return 0;
+                        }
+                      else
+                        {
+                          fwarn("hash conflict\n");
+                        }
+                    }
+                }
+
+              if (wlk_addr == fs->ate_wra)
+                {
+                  return 0;
+                }
+            }
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: nvs_index_lookup
+ *
+ * Description:
+ *   Find the live ate of a key in the index.
+ *
+ * Input Parameters:
+ *   fs       - Pointer to file system.
+ *   id       - Hash id of the key.
+ *   key      - Key of the entry.
+ *   key_size - Size of key.
+ *   ate_addr - Returns the address of the ate.
+ *   ate      - Returns the ate.
+ *
+ * Returned Value:
+ *   0 if found, -ENOENT if the key has no live entry, other -ERRNO code on
+ *   flash error.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+static int nvs_index_lookup(FAR struct nvs_fs *fs, uint32_t id,
+                            FAR const uint8_t *key, size_t key_size,
+                            FAR uint32_t *ate_addr, FAR struct nvs_ate *ate)
+{
+  uint32_t addr;
+  uint32_t pos;
+  int rc;
+
+  for (pos = nvs_index_lower(fs, id);
+       pos < fs->nindex && fs->index[pos].id == id; pos++)
+    {
+      addr = fs->index[pos].addr;
+      rc = nvs_flash_ate_rd(fs, addr, ate);
+      if (rc)
+        {
+          return rc;
+        }
+
+      if ((ate->key_len == key_size)
+          && !nvs_flash_block_cmp(fs, (addr & NVS_ADDR_BLOCK_MASK) +
+                                  ate->offset, key, key_size))
+        {
+          *ate_addr = addr;
+          return 0;
+        }
+
+      fwarn("hash conflict\n");
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nvs_index_same_key
+ *
+ * Description:
+ *   Compare the keys of the ates at addr1 and addr2.
+ *   Returns 0 if equal, 1 if not equal, errcode if error.
+ *
+ ****************************************************************************/
+
+static int nvs_index_same_key(FAR struct nvs_fs *fs, uint32_t addr1,
+                              uint32_t addr2)
+{
+  size_t ate_size = nvs_ate_size(fs);
+  NVS_ATE(ate1, ate_size);
+  NVS_ATE(ate2, ate_size);
+  int rc;
+
+  rc = nvs_flash_ate_rd(fs, addr1, ate1);
+  if (rc)
+    {
+      return rc;
+    }
+
+  rc = nvs_flash_ate_rd(fs, addr2, ate2);
+  if (rc)
+    {
+      return rc;
+    }
+
+  if (ate1->key_len != ate2->key_len)
+    {
+      return 1;
+    }
+
+  return nvs_flash_direct_cmp(fs, (addr1 & NVS_ADDR_BLOCK_MASK) +
+                              ate1->offset, (addr2 & NVS_ADDR_BLOCK_MASK) +
+                              ate2->offset, ate1->key_len);
+}
+
+/****************************************************************************
+ * Name: nvs_index_build
+ *
+ * Description:
+ *   Build the index with one walk over all ates.  The entries are first
+ *   sorted by id and age, then the older copies of a key that a power loss
+ *   left behind are expired.  If the heap is exhausted the index is dropped
+ *   and the lookups walk the flash.
+ *
+ ****************************************************************************/
+
+static int nvs_index_build(FAR struct nvs_fs *fs)
+{
+  size_t ate_size = nvs_ate_size(fs);
+  NVS_ATE(wlk_ate, ate_size);
+  FAR struct nvs_index_s *entry;
+  uint32_t wlk_addr;
+  uint32_t rd_addr;
+  uint32_t first;
+  uint32_t i;
+  uint32_t j;
+  uint32_t n;
+  int rc;
+
+  nvs_index_drop(fs);
+
+  /* Collect the live ates, with the rank instead of the address so that
+   * the sort puts the newest copy of an id first.
+   */
+
+  wlk_addr = fs->ate_wra;
+  do
+    {
+      rd_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, wlk_ate);
+      if (rc)
+        {
+          goto errout;
+        }
+
+      if (nvs_ate_valid(fs, wlk_ate)
+          && wlk_ate->id != nvs_special_ate_id(fs)
+          && !nvs_ate_expired(fs, wlk_ate))
+        {
+          rc = nvs_index_grow(fs);
+          if (rc < 0)
+            {
+              goto errout;
+            }
+
+          fs->index[fs->nindex].id = wlk_ate->id;
+          fs->index[fs->nindex].addr = nvs_index_rank(fs, rd_addr);
+          fs->nindex++;
+        }
+    }
+  while (wlk_addr != fs->ate_wra);
+
+  if (fs->index == NULL)
+    {
+      /* Empty, keep an allocation so the index is in use */
+
+      rc = nvs_index_grow(fs);
+      if (rc < 0)
+        {
+          goto errout;
+        }
+    }
+
+  qsort(fs->index, fs->nindex, sizeof(struct nvs_index_s), nvs_index_cmp);
+
+  for (i = 0, n = 0, first = 0; i < fs->nindex; i++)
+    {
+      entry = &fs->index[i];
+      entry->addr = nvs_index_addr(fs, entry->addr);
+      if (n == 0 || fs->index[n - 1].id != entry->id)
+        {
+          first = n;
+        }
+
+      /* Is there a newer entry with the same key? */
+
+      for (j = first; j < n; j++)
+        {
+          rc = nvs_index_same_key(fs, fs->index[j].addr, entry->addr);
+          if (rc < 0)
+            {
+              goto errout;
+            }
+
+          if (rc == 0)
+            {
+              break;
+            }
+        }
+
+      if (j < n)
+        {
+          finfo("old ate found at 0x%" PRIx32 "\n", entry->addr);
+          rc = nvs_expire_ate(fs, entry->addr);
+          if (rc < 0)
+            {
+              ferr("expire ate failed, addr %" PRIx32 "\n", entry->addr);
+              goto errout;
+            }
+
+          continue;
+        }
+
+      fs->index[n++] = *entry;
+    }
+
+  fs->nindex = n;
+  finfo("%" PRIu32 " entries indexed\n", n);
+  return 0;
+
+errout:
+  nvs_index_drop(fs);
+  if (rc == -ENOMEM)
+    {
+      fwarn("Out of memory, walk the flash without index\n");
+      return nvs_expire_old_ate(fs);
+    }
+
+  return rc;
+}
+#endif /* CONFIG_MTD_CONFIG_NVS_INDEX */
+
+/****************************************************************************
+ * Name: nvs_startup
+ ****************************************************************************/
+
+static int nvs_startup(FAR struct nvs_fs *fs)
+{
+  struct mtd_geometry_s geo;
+  size_t empty_len;
+
+  /* Initialize addr to 0 for the case fs->nblocks == 0. This
+   * should never happen but both
+   * Coverity and GCC believe the contrary.
+   */
+
+  uint16_t closed_blocks = 0;
+  uint32_t addr = 0;
+  uint16_t i;
+  int rc;
+
+  fs->ate_wra = 0;
   fs->data_wra = 0;
   fs->events = 0;
   fs->fds = NULL;
@@ -1266,7 +1945,6 @@ static int nvs_startup(FAR struct nvs_fs *fs)
   fs->progsize  = geo.blocksize;
 
   size_t ate_size = nvs_ate_size(fs);
-  NVS_ATE(second_ate, ate_size);
   NVS_ATE(last_ate, ate_size);
 
   rc = MTD_IOCTL(fs->mtd, MTDIOC_ERASESTATE,
@@ -1501,100 +2179,17 @@ static int nvs_startup(FAR struct nvs_fs *fs)
             fs->data_wra);
     }
 
-  /* Check if there exists an old entry with the same id and key
-   * as the newest entry.
-   * If so, power loss occurred before writing the old entry id as expired.
-   * We need to set old entry expired.
+  /* Expire the old entry a power loss may have left behind, the index
+   * build below does this for every entry.
    */
 
 #if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
   memset(fs->cache, 0xff, sizeof(fs->cache));
 #endif
 
-  wlk_addr = fs->ate_wra;
-  while (1)
-    {
-      last_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, last_ate);
-      if (rc)
-        {
-          return rc;
-        }
-
-      /* Skip last one */
-
-      if (wlk_addr == fs->ate_wra)
-        {
-          break;
-        }
-
-      if (nvs_ate_valid(fs, last_ate)
-          && (last_ate->id != nvs_special_ate_id(fs)))
-        {
-          finfo("ate found at 0x%" PRIx32 ", id %" PRIu32 ", "
-                "key_len %" PRIu16 ", offset %" PRIu16 "\n",
-                last_addr, last_ate->id, last_ate->key_len,
-                last_ate->offset);
-
-#if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
-          fs->cache[nvs_cache_index(last_ate->id)] = last_addr;
-#endif
-          while (1)
-            {
-              second_addr = wlk_addr;
-              rc = nvs_prev_ate(fs, &wlk_addr, second_ate);
-              if (rc)
-                {
-                  return rc;
-                }
-
-              if (nvs_ate_valid(fs, second_ate)
-                  && !nvs_ate_expired(fs, second_ate))
-                {
-#if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
-                  fs->cache[nvs_cache_index(second_ate->id)] = second_addr;
+#ifndef CONFIG_MTD_CONFIG_NVS_INDEX
+  rc = nvs_expire_old_ate(fs);
 #endif
-                  if (second_ate->id == last_ate->id)
-                    {
-                      finfo("same id at 0x%" PRIx32 ", key_len %" PRIu16 ", "
-                            "offset %" PRIu16 "\n", second_addr,
-                            second_ate->key_len, second_ate->offset);
-                      if ((second_ate->key_len == last_ate->key_len) &&
-                          !nvs_flash_direct_cmp(fs,
-                                                (last_addr &
-                                                 NVS_ADDR_BLOCK_MASK) +
-                                                last_ate->offset,
-                                                (second_addr &
-                                                 NVS_ADDR_BLOCK_MASK) +
-                                                second_ate->offset,
-                                                last_ate->key_len))
-                        {
-                          finfo("old ate found at 0x%" PRIx32 "\n",
-                                second_addr);
-                          rc = nvs_expire_ate(fs, second_addr);
-                          if (rc < 0)
-                            {
-                              ferr("expire ate failed, addr %" PRIx32 "\n",
-                                  second_addr);
-                              return rc;
-                            }
-
-                          goto end;
-                        }
-                      else
-                        {
-                          fwarn("hash conflict\n");
-                        }
-                    }
-                }
-
-              if (wlk_addr == fs->ate_wra)
-                {
-                  goto end;
-                }
-            }
-        }
-    }
 
 end:
   /* If the block is empty, add a gc done ate to avoid having insufficient
@@ -1607,6 +2202,13 @@ end:
       rc = nvs_add_gc_done_ate(fs);
     }
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  if (!rc)
+    {
+      rc = nvs_index_build(fs);
+    }
+#endif
+
   finfo("%" PRIu32 " Eraseblocks of %" PRIu32 " bytes\n",
         fs->nblocks, fs->blocksize);
   finfo("alloc wra: %" PRIu32 ", 0x%" PRIx32 "\n",
@@ -1656,6 +2258,21 @@ static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
   int rc;
 
   hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  if (fs->index != NULL)
+    {
+      rc = nvs_index_lookup(fs, hash_id, key, key_size, &rd_addr, wlk_ate);
+      if (rc < 0)
+        {
+          return rc;
+        }
+
+      hist_addr = rd_addr;
+      goto found;
+    }
+#endif
+
 #if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
   wlk_addr = fs->cache[nvs_cache_index(hash_id)];
   if (wlk_addr == NVS_CACHE_NO_ADDR)
@@ -1719,6 +2336,9 @@ static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
     }
   while (true);
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+found:
+#endif
   if (data && len)
     {
       rd_addr &= NVS_ADDR_BLOCK_MASK;
@@ -1812,6 +2432,25 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
 
   /* Find latest entry with same id. */
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  if (fs->index != NULL)
+    {
+      rc = nvs_index_lookup(fs, hash_id, key, key_size, &hist_addr,
+                            wlk_ate);
+      if (rc == 0)
+        {
+          rd_addr = hist_addr;
+          prev_found = true;
+        }
+      else if (rc != -ENOENT)
+        {
+          return rc;
+        }
+
+      goto prev_done;
+    }
+#endif
+
 #if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
   wlk_addr = fs->cache[nvs_cache_index(hash_id)];
   if (wlk_addr == NVS_CACHE_NO_ADDR)
@@ -1866,6 +2505,9 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
         }
     }
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+prev_done:
+#endif
   if (prev_found)
     {
       finfo("Previous found\n");
@@ -1895,6 +2537,10 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
                   return rc;
                 }
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+              nvs_index_remove(fs, hash_id, hist_addr);
+#endif
+
               /* Delete now requires no extra space, so skip write and gc. */
 
               finfo("nvs_delete success\n");
@@ -2002,6 +2648,10 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
                        hist_addr);
                   return rc;
                 }
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+              nvs_index_remove(fs, hash_id, hist_addr);
+#endif
             }
 
           break;
@@ -2052,6 +2702,253 @@ static int nvs_delete(FAR struct nvs_fs *fs, FAR struct config_data_s *pdata)
   return nvs_write(fs, pdata);
 }
 
+/****************************************************************************
+ * Name: nvs_write_batch
+ *
+ * Description:
+ *   Write several entries to the file system.  The data of all entries is
+ *   written first, then their ates are programmed together, so a batch
+ *   costs one ate program instead of one per entry.  A batch that doesn't
+ *   fit into one block is written entry by entry.
+ *
+ * Input Parameters:
+ *   fs    - Pointer to file system.
+ *   batch - Pointer to the items to write.
+ *
+ * Returned Value:
+ *   0 on success, -ERRNO errno code if error.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+static int nvs_write_batch(FAR struct nvs_fs *fs,
+                           FAR struct config_batch_s *batch)
+{
+  size_t ate_size = nvs_ate_size(fs);
+  NVS_ATE(wlk_ate, ate_size);
+  FAR struct config_data_s *pdata;
+  FAR struct nvs_batch_s *items;
+  FAR struct nvs_ate *entry;
+  FAR uint8_t *ates = NULL;
+  size_t required_space = 0;
+  size_t data_size;
+  uint32_t ate_addr;
+  uint32_t nwrite;
+  uint32_t gc_count;
+  size_t i;
+  size_t j;
+  int rc;
+
+  if (batch == NULL || batch->items == NULL || batch->nitems == 0)
+    {
+      return -EINVAL;
+    }
+
+  items = kmm_zalloc(batch->nitems * sizeof(struct nvs_batch_s));
+  if (items == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Prepare the keys and calculate the space of the whole batch */
+
+  for (i = 0; i < batch->nitems; i++)
+    {
+      pdata = &batch->items[i];
+
+#ifdef CONFIG_MTD_CONFIG_NAMED
+      items[i].key = (FAR const uint8_t *)pdata->name;
+      items[i].key_size = strlen(pdata->name) + 1;
+#else
+      memcpy(items[i].key, &pdata->id, sizeof(pdata->id));
+      memcpy(items[i].key + sizeof(pdata->id), &pdata->instance,
+             sizeof(pdata->instance));
+      items[i].key_size = sizeof(pdata->id) + sizeof(pdata->instance);
+#endif
+
+      data_size = nvs_align_up(fs, items[i].key_size + pdata->len);
+      if (pdata->len == 0 || pdata->configdata == NULL ||
+          data_size > fs->blocksize - 3 * ate_size)
+        {
+          rc = -EINVAL;
+          goto errout;
+        }
+
+      items[i].id = nvs_fnv_hash(items[i].key, items[i].key_size) %
+                    0xfffffffd + 1;
+
+      /* The same key twice would leave two live ates */
+
+      for (j = 0; j < i; j++)
+        {
+          if (items[j].id == items[i].id &&
+              items[j].key_size == items[i].key_size &&
+              !memcmp(items[j].key, items[i].key, items[i].key_size))
+            {
+              rc = -EINVAL;
+              goto errout;
+            }
+        }
+
+      required_space += data_size + ate_size;
+    }
+
+  /* The batch needs the index to find the previous entries */
+
+  if (fs->index == NULL || required_space > fs->blocksize - 3 * ate_size)
+    {
+      goto one_by_one;
+    }
+
+  ates = kmm_malloc(batch->nitems * ate_size);
+  if (ates == NULL)
+    {
+      goto one_by_one;
+    }
+
+  /* Make room for the whole batch in the write block, leaving space for
+   * the gc_done ate.
+   */
+
+  for (gc_count = 0; fs->ate_wra < fs->data_wra + required_space;
+       gc_count++)
+    {
+      if (gc_count == fs->nblocks)
+        {
+          rc = -ENOSPC;
+          goto errout;
+        }
+
+      rc = nvs_block_close(fs);
+      if (rc)
+        {
+          goto errout;
+        }
+
+      rc = nvs_gc(fs);
+      if (rc)
+        {
+          goto errout;
+        }
+    }
+
+  /* Find the previous entries, the items with unchanged data are
+   * skipped.
+   */
+
+  for (i = 0, nwrite = 0; i < batch->nitems; i++)
+    {
+      pdata = &batch->items[i];
+      rc = nvs_index_lookup(fs, items[i].id, items[i].key,
+                            items[i].key_size, &items[i].hist_addr,
+                            wlk_ate);
+      if (rc == 0)
+        {
+          items[i].prev = true;
+          if (pdata->len == wlk_ate->len)
+            {
+              rc = nvs_flash_block_cmp(fs, (items[i].hist_addr &
+                                            NVS_ADDR_BLOCK_MASK) +
+                                       wlk_ate->offset + wlk_ate->key_len,
+                                       pdata->configdata, pdata->len);
+              if (rc < 0)
+                {
+                  goto errout;
+                }
+
+              items[i].skip = rc == 0;
+            }
+        }
+      else if (rc != -ENOENT)
+        {
+          goto errout;
+        }
+
+      if (!items[i].skip)
+        {
+          nwrite++;
+        }
+    }
+
+  /* Write the key and data of every item, the ate of the first item goes
+   * to the end of the ate buffer which is in flash order.
+   */
+
+  for (i = 0, j = nwrite; i < batch->nitems; i++)
+    {
+      if (items[i].skip)
+        {
+          continue;
+        }
+
+      pdata = &batch->items[i];
+      entry = (FAR struct nvs_ate *)(ates + --j * ate_size);
+      nvs_ate_init(fs, entry, items[i].id, items[i].key_size, pdata->len);
+      rc = nvs_flash_wrt_kv(fs, items[i].key, items[i].key_size,
+                            pdata->configdata, pdata->len);
+      if (rc)
+        {
+          goto errout;
+        }
+    }
+
+  ate_addr = fs->ate_wra;
+  if (nwrite > 0)
+    {
+      rc = nvs_flash_ate_wrt_multi(fs, ates, nwrite);
+      if (rc)
+        {
+          ferr("Write ates failed, rc=%d\n", rc);
+          goto errout;
+        }
+    }
+
+  /* Index the new entries and expire the previous ones */
+
+  for (i = 0; i < batch->nitems; i++)
+    {
+      if (items[i].skip)
+        {
+          continue;
+        }
+
+      nvs_index_add(fs, items[i].id, ate_addr);
+      ate_addr -= ate_size;
+
+      if (items[i].prev)
+        {
+          rc = nvs_expire_ate(fs, items[i].hist_addr);
+          if (rc < 0)
+            {
+              ferr("expire ate failed, addr %" PRIx32 "\n",
+                   items[i].hist_addr);
+              goto errout;
+            }
+
+          nvs_index_remove(fs, items[i].id, items[i].hist_addr);
+        }
+    }
+
+  rc = 0;
+  goto errout;
+
+one_by_one:
+  for (i = 0; i < batch->nitems; i++)
+    {
+      rc = nvs_write(fs, &batch->items[i]);
+      if (rc < 0)
+        {
+          break;
+        }
+    }
+
+errout:
+  kmm_free(ates);
+  kmm_free(items);
+  return rc;
+}
+#endif
+
 /****************************************************************************
  * Name: nvs_read
  *
@@ -2314,6 +3211,20 @@ static int mtdconfig_ioctl(FAR struct file *filep, int cmd,
 
         break;
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+      case CFGDIOC_SETCONFIGS:
+
+        /* Write several nvs items. */
+
+        rc = nvs_write_batch(fs, (FAR struct config_batch_s *)arg);
+        if (rc >= 0)
+          {
+            mtdconfig_notify(fs, POLLPRI);
+          }
+
+        break;
+#endif
+
       case CFGDIOC_DELCONFIG:
 
         /* Delete a nvs item. */
@@ -2415,6 +3326,12 @@ int mtdconfig_register_by_path(FAR struct mtd_dev_s *mtd,
   /* Initialize the mtdnvs device structure */
 
   fs->mtd = mtd;
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  fs->index = NULL;
+  fs->nindex = 0;
+  fs->nalloc = 0;
+#endif
+
   rc = nxmutex_init(&fs->nvs_lock);
   if (rc < 0)
     {
@@ -2439,6 +3356,9 @@ int mtdconfig_register_by_path(FAR struct mtd_dev_s *mtd,
   return rc;
 
 mutex_err:
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  kmm_free(fs->index);
+#endif
   nxmutex_destroy(&fs->nvs_lock);
 
 errout:
@@ -2484,6 +3404,9 @@ int mtdconfig_unregister_by_path(FAR const char *path)
   inode = file.f_inode;
   fs = inode->i_private;
   nxmutex_destroy(&fs->nvs_lock);
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  kmm_free(fs->index);
+#endif
   kmm_free(fs);
   file_close(&file);
   unregister_driver(path);
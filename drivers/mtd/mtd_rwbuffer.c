@@ -65,6 +65,10 @@
 #  define CONFIG_MTD_NWRBLOCKS 4
 #endif
 
+#ifndef CONFIG_MTD_NWRSEGMENTS
+#  define CONFIG_MTD_NWRSEGMENTS 1
+#endif
+
 #ifndef CONFIG_MTD_NRDBLOCKS
 #  define CONFIG_MTD_NRDBLOCKS 4
 #endif
@@ -429,9 +433,11 @@ FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd)
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   priv->rwb.wrmaxblocks = CONFIG_MTD_NWRBLOCKS;
+  priv->rwb.wrnsegments = CONFIG_MTD_NWRSEGMENTS;
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
-  priv->rwb.rhmaxblocks = CONFIG_MTD_NRDBLOCKS;
+  priv->rwb.rhmaxblocks = CONFIG_MTD_NRDBLOCKS > 0 ?
+                          CONFIG_MTD_NRDBLOCKS : priv->spb;
 #endif
 
   /* Callouts */
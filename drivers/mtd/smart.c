@@ -45,6 +45,8 @@
 #include <nuttx/crc16.h>
 #include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -127,6 +129,21 @@
 
 #define SMART_MAX_ALLOCS        10
 
+/* The free sectors kept for the inline garbage collection, and the
+ * watermarks of the background collection above them.
+ */
+
+#define SMART_RESERVED_SECTORS(d) ((d)->sectorsperblk + 4)
+
+#ifdef CONFIG_MTD_SMART_BGGC
+#  define SMART_BGGC_LOWATER(d)   (SMART_RESERVED_SECTORS(d) + \
+                                   CONFIG_MTD_SMART_BGGC_LOWATER * \
+                                   (d)->availsectperblk)
+#  define SMART_BGGC_HIWATER(d)   (SMART_RESERVED_SECTORS(d) + \
+                                   CONFIG_MTD_SMART_BGGC_HIWATER * \
+                                   (d)->availsectperblk)
+#endif
+
 #ifndef CONFIG_MTD_SMART_ALLOC_DEBUG
 #define smart_malloc(d, b, n)   kmm_malloc(b)
 #define smart_zalloc(d, b, n)   kmm_zalloc(b)
@@ -295,6 +312,10 @@ struct smart_struct_s
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  mutex_t               lock;             /* Serializes the requests and the GC */
+  struct work_s         gcwork;           /* Background garbage collection */
+#endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
@@ -4014,6 +4035,53 @@ retry:
   return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_findcollectblock
+ *
+ * Description:  Returns the erase block with the most released sectors, or
+ *               0xffff if no block has released sectors.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_findcollectblock(FAR struct smart_struct_s *dev)
+{
+  uint16_t collectblock = 0xffff;
+  uint16_t releasemax = 0;
+  int x;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  uint8_t count;
+#endif
+
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+      if (count > releasemax)
+        {
+          releasemax = count;
+          collectblock = x;
+        }
+#else
+      if (dev->releasecount[x] > releasemax)
+        {
+          releasemax = dev->releasecount[x];
+          collectblock = x;
+        }
+#endif
+    }
+
+  return collectblock;
+}
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -4026,13 +4094,8 @@ retry:
 static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 {
   uint16_t collectblock;
-  uint16_t releasemax;
   bool collect = true;
-  int x;
   int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-  uint8_t count;
-#endif
 
   while (collect)
     {
@@ -4050,7 +4113,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 
       /* Test if we have more reached our reserved free sector limit */
 
-      if (dev->freesectors <= (dev->sectorsperblk << 0) + 4)
+      if (dev->freesectors <= SMART_RESERVED_SECTORS(dev))
         {
           collect = true;
         }
@@ -4061,38 +4124,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           /* Find the block with the most released sectors */
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
-
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
-#endif
-            }
-
-#if 0
-          releasemax = smart_get_count(dev, dev->releasecount, collectblock);
-#endif
+          collectblock = smart_findcollectblock(dev);
 
           if (collectblock == 0xffff)
             {
@@ -5138,7 +5170,7 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev,
    * on hand to do released sector garbage collection.
    */
 
-  if (dev->freesectors <= (dev->sectorsperblk << 0) + 4)
+  if (dev->freesectors <= SMART_RESERVED_SECTORS(dev))
     {
       /* Do a garbage collect and then test freesectors again */
 
@@ -5477,6 +5509,96 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_MTD_SMART_BGGC
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description: Collect one erase block in the background.  The work is
+ *              queued again until the high watermark is reached, so that
+ *              a request waits for one block relocation at most.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = arg;
+  uint16_t collectblock;
+
+  if (nxmutex_lock(&dev->lock) < 0)
+    {
+      return;
+    }
+
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED ||
+      dev->freesectors >= SMART_BGGC_HIWATER(dev))
+    {
+      goto out;
+    }
+
+  collectblock = smart_findcollectblock(dev);
+  if (collectblock == 0xffff)
+    {
+      goto out;
+    }
+
+  finfo("Background collecting block %d, free=%d released=%d\n",
+        collectblock, dev->freesectors, dev->releasesectors);
+
+  if (smart_relocate_block(dev, collectblock) != OK)
+    {
+      goto out;
+    }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+    {
+      smart_write_wearstatus(dev);
+    }
+#endif
+
+  if (dev->freesectors < SMART_BGGC_HIWATER(dev) &&
+      dev->releasesectors > 0)
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev, 0);
+    }
+
+out:
+  nxmutex_unlock(&dev->lock);
+}
+
+/****************************************************************************
+ * Name: smart_bggc_schedule
+ *
+ * Description: Schedule the background garbage collection after a request.
+ *              It starts at once below the low watermark, otherwise once
+ *              the device has been idle for CONFIG_MTD_SMART_BGGC_IDLE ms.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_schedule(FAR struct smart_struct_s *dev)
+{
+  clock_t delay;
+
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED ||
+      dev->releasesectors == 0 ||
+      dev->freesectors >= SMART_BGGC_HIWATER(dev))
+    {
+      return;
+    }
+
+  if (dev->freesectors < SMART_BGGC_LOWATER(dev))
+    {
+      delay = 0;
+    }
+  else
+    {
+      delay = MSEC2TICK(CONFIG_MTD_SMART_BGGC_IDLE);
+    }
+
+  work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev, delay);
+}
+#endif /* CONFIG_MTD_SMART_BGGC */
+
 /****************************************************************************
  * Name: smart_ioctl
  *
@@ -5502,6 +5624,18 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = inode->i_private;
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  /* The requests of the file system are serialized by its own lock, this
+   * one keeps them apart from the background garbage collection.
+   */
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5641,6 +5775,15 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+#ifdef CONFIG_MTD_SMART_BGGC
+  if (cmd == BIOC_WRITESECT || cmd == BIOC_FREESECT)
+    {
+      smart_bggc_schedule(dev);
+    }
+
+  nxmutex_unlock(&dev->lock);
+#endif
+
   return ret;
 }
 
@@ -6183,6 +6326,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BGGC
+      nxmutex_init(&dev->lock);
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -6332,6 +6478,9 @@ errout:
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  nxmutex_destroy(&dev->lock);
+#endif
   kmm_free(dev);
   return ret;
 }
@@ -6463,6 +6612,11 @@ static int smart_loteardown(FAR const char *devname)
 
   /* Now teardown the filemtd */
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  work_cancel_sync(LPWORK, &dev->gcwork);
+  nxmutex_destroy(&dev->lock);
+#endif
+
   filemtd_teardown(dev->mtd);
   unregister_blockdriver(devname);
 
@@ -108,6 +108,11 @@
                                E1000_IVAR_TXQ0_EN | \
                                E1000_IVAR_OTHER_EN)
 
+/* Interrupts masked while the upper half polls the RX ring */
+
+#define E1000_RX_INTERRUPTS   (E1000_IC_RXO    | E1000_IC_RXT0 |  \
+                               E1000_IC_RXDMT0 | E1000_IC_RXQ0)
+
 /* NIC specific Flags */
 
 #define E1000_RESET_BROKEN    (1 << 0)
@@ -200,6 +205,9 @@ static int e1000_transmit(FAR struct netdev_lowerhalf_s *dev,
 
 static FAR netpkt_t *e1000_receive(FAR struct netdev_lowerhalf_s *dev);
 static void e1000_txdone(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_NAPI
+static void e1000_rxint(FAR struct netdev_lowerhalf_s *dev, bool enable);
+#endif
 
 static void e1000_msi_interrupt(FAR struct e1000_driver_s *priv);
 #ifdef CONFIG_PCI_MSIX
@@ -312,6 +320,9 @@ static const struct netdev_ops_s g_e1000_ops =
   .addmac   = e1000_addmac,
   .rmmac    = e1000_rmmac,
 #endif
+#ifdef CONFIG_NETDEV_NAPI
+  .rxint    = e1000_rxint,
+#endif
 };
 
 /*****************************************************************************
@@ -754,6 +765,29 @@ static void e1000_txdone(FAR struct netdev_lowerhalf_s *dev)
   netdev_lower_txdone(dev);
 }
 
+/*****************************************************************************
+ * Name: e1000_rxint
+ *
+ * Description:
+ *   Enable or disable the RX interrupts.  The causes latched while they are
+ *   masked raise the interrupt as soon as they are enabled again.
+ *
+ * Input Parameters:
+ *   dev    - Reference to the lower half driver structure
+ *   enable - Enable or disable the RX interrupts
+ *
+ *****************************************************************************/
+
+#ifdef CONFIG_NETDEV_NAPI
+static void e1000_rxint(FAR struct netdev_lowerhalf_s *dev, bool enable)
+{
+  FAR struct e1000_driver_s *priv = (FAR struct e1000_driver_s *)dev;
+
+  e1000_putreg_mem(priv, enable ? E1000_IMS : E1000_IMC,
+                   priv->irqs & E1000_RX_INTERRUPTS);
+}
+#endif
+
 /*****************************************************************************
  * Name: e1000_link_work
  *
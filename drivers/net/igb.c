@@ -104,6 +104,10 @@
 #define IGB_MSIX_IVAR0         (IGB_IVAR0_RXQ0_VAL | IGB_IVAR0_TXQ0_VAL)
 #define IGB_MSIX_IVARMSC       (IGB_IVARMSC_OTHER_VAL)
 
+/* Interrupts masked while the upper half polls the RX ring */
+
+#define IGB_RX_IMS             (IGB_IC_RXMISS | IGB_IC_RXDW)
+
 /*****************************************************************************
  * Private Types
  *****************************************************************************/
@@ -188,6 +192,9 @@ static int igb_transmit(FAR struct netdev_lowerhalf_s *dev,
 
 static FAR netpkt_t *igb_receive(FAR struct netdev_lowerhalf_s *dev);
 static void igb_txdone(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_NAPI
+static void igb_rxint(FAR struct netdev_lowerhalf_s *dev, bool enable);
+#endif
 
 static void igb_msix_interrupt(FAR struct igb_driver_s *priv);
 static int igb_interrupt(int irq, FAR void *context, FAR void *arg);
@@ -268,6 +275,9 @@ static const struct netdev_ops_s g_igb_ops =
   .addmac   = igb_addmac,
   .rmmac    = igb_rmmac,
 #endif
+#ifdef CONFIG_NETDEV_NAPI
+  .rxint    = igb_rxint,
+#endif
 };
 
 /*****************************************************************************
@@ -729,6 +739,28 @@ static void igb_txdone(FAR struct netdev_lowerhalf_s *dev)
   netdev_lower_txdone(dev);
 }
 
+/*****************************************************************************
+ * Name: igb_rxint
+ *
+ * Description:
+ *   Enable or disable the RX interrupts.  The causes latched while they are
+ *   masked raise the interrupt as soon as they are enabled again.
+ *
+ * Input Parameters:
+ *   dev    - Reference to the lower half driver structure
+ *   enable - Enable or disable the RX interrupts
+ *
+ *****************************************************************************/
+
+#ifdef CONFIG_NETDEV_NAPI
+static void igb_rxint(FAR struct netdev_lowerhalf_s *dev, bool enable)
+{
+  FAR struct igb_driver_s *priv = (FAR struct igb_driver_s *)dev;
+
+  igb_putreg_mem(priv, enable ? IGB_IMS : IGB_IMC, IGB_RX_IMS);
+}
+#endif
+
 /*****************************************************************************
  * Name: igb_link_work
  *
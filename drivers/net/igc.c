@@ -528,6 +528,8 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
   int                      desc    = priv->tx_now;
   size_t                   len     = netpkt_getdatalen(dev, pkt);
   size_t                   tx_next = (priv->tx_now + 1) % IGC_TX_DESC;
+  uint16_t                 start;
+  uint16_t                 offset;
 
   ninfo("transmit\n");
 
@@ -568,8 +570,18 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
   priv->tx[desc].cmd    = (IGC_TDESC_CMD_EOP | IGC_TDESC_CMD_IFCS |
                            IGC_TDESC_CMD_RS);
   priv->tx[desc].cso    = 0;
+  priv->tx[desc].css    = 0;
   priv->tx[desc].status = 0;
 
+  /* Let the hardware complete the TCP or UDP checksum */
+
+  if (netpkt_get_txcsum(dev, pkt, &start, &offset))
+    {
+      priv->tx[desc].cmd |= IGC_TDESC_CMD_IC;
+      priv->tx[desc].css  = start;
+      priv->tx[desc].cso  = offset;
+    }
+
   UP_DSB();
 
   /* Update TX tail */
@@ -604,6 +616,7 @@ static FAR netpkt_t *igc_receive(FAR struct netdev_lowerhalf_s *dev)
   FAR netpkt_t            *pkt  = NULL;
   FAR struct igc_rx_leg_s *rx   = NULL;
   int                      desc = 0;
+  uint8_t                  status;
 
   desc = priv->rx_now;
 
@@ -635,6 +648,7 @@ static FAR netpkt_t *igc_receive(FAR struct netdev_lowerhalf_s *dev)
   /* Set packet length */
 
   netpkt_setdatalen(dev, pkt, rx->len);
+  status = rx->status;
 
   /* Store new packet in RX descriptor ring */
 
@@ -657,6 +671,9 @@ static FAR netpkt_t *igc_receive(FAR struct netdev_lowerhalf_s *dev)
       return NULL;
     }
 
+  /* The packets with bad checksums have been dropped above */
+
+  netpkt_set_rxcsum(dev, (status & IGC_RDESC_STATUS_L4CS) != 0);
   return pkt;
 }
 
@@ -1217,6 +1234,10 @@ static void igc_enable(FAR struct igc_driver_s *priv)
   regval |= IGC_TCTL_EN | IGC_TCTL_PSP;
   igc_putreg_mem(priv, IGC_TCTL, regval);
 
+  /* Enable the IP and TCP/UDP checksum offload for RX */
+
+  igc_putreg_mem(priv, IGC_RXCSUM, IGC_RXCSUM_IPOFLD | IGC_RXCSUM_TUOFLD);
+
   /* Setup and enable Receiver */
 
   regval = (IGC_RCTL_EN | IGC_RCTL_MPE |
@@ -1448,6 +1469,10 @@ static int igc_probe(FAR struct pci_device_s *dev)
   netdev->quota[NETPKT_RX] = IGC_RX_QUOTA;
   netdev->ops = &g_igc_ops;
 
+  /* The legacy descriptors complete a single checksum per packet */
+
+  netdev->netdev.d_features |= NETDEV_TX_CSUM;
+
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
 errout:
@@ -359,6 +359,14 @@
 #define IGC_RCTL_SECRC            (1 << 26)  /* Bit 26: Strip Ethernet CRC from incoming packet */
                                              /* Bits 27-31: Reserved */
 
+/* Receive Checksum Control */
+
+#define IGC_RXCSUM_PCSS_SHIFT     (0)        /* Bits 0-7: Packet Checksum Start */
+#define IGC_RXCSUM_IPOFLD         (1 << 8)   /* Bit 8: IP Checksum Off-load Enable */
+#define IGC_RXCSUM_TUOFLD         (1 << 9)   /* Bit 9: TCP/UDP Checksum Off-load Enable */
+#define IGC_RXCSUM_CRCOFL         (1 << 11)  /* Bit 11: CRC32 Offload Enable */
+#define IGC_RXCSUM_PCSD           (1 << 13)  /* Bit 13: Packet Checksum Disable */
+
 /* Receive Descriptor Control */
 
 #define IGC_RXDCTL_PTHRESH_SHIFT  (0)       /* Bits 0-4: Prefetch Threshold */
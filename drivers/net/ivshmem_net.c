@@ -0,0 +1,825 @@
+/****************************************************************************
+ * drivers/net/ivshmem_net.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+
+#include <nuttx/net/ivshmem_net.h>
+#include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/pci/pci_ivshmem.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ivshmem_net_from(dev) \
+  container_of(ivshmem_get_driver(dev), struct ivshmem_net_s, drv)
+
+#define IVSHMEM_NET_MAGIC       0x4e455431 /* "NET1" */
+#define IVSHMEM_NET_ALIGN       64
+
+#define IVSHMEM_NET_PKTSIZE     (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
+#define IVSHMEM_NET_SLOTSIZE    ALIGN_UP(sizeof(uint32_t) + \
+                                         IVSHMEM_NET_PKTSIZE, \
+                                         IVSHMEM_NET_ALIGN)
+
+#define IVSHMEM_NET_WDOG_DELAY  MSEC2TICK(1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The shared memory is laid out as below, the master initializes it and
+ * the peer (NuttX or a Linux guest) must follow the same layout:
+ *
+ *   struct ivshmem_net_shm_s   Header and the indexes of the two rings
+ *   slot[nslots]               Frames sent by the master
+ *   slot[nslots]               Frames sent by the slave
+ *
+ * A slot is slotsize bytes, a 32-bit frame length followed by the frame.
+ * Each ring has a single producer and a single consumer, the free running
+ * head and tail indexes are written by one side only and live in separate
+ * cachelines, so no lock is needed.  A side only rings the doorbell when
+ * the other one has asked for it by setting its wait flag.
+ */
+
+struct ivshmem_net_ring_s
+{
+  /* Written by the producer */
+
+  volatile uint32_t head;       /* Next slot to fill */
+  volatile uint32_t wait_space; /* Kick me when a slot is consumed */
+  uint8_t           pad0[IVSHMEM_NET_ALIGN - 8];
+
+  /* Written by the consumer */
+
+  volatile uint32_t tail;       /* Next slot to drain */
+  volatile uint32_t wait_data;  /* Kick me when a slot is filled */
+  uint8_t           pad1[IVSHMEM_NET_ALIGN - 8];
+};
+
+struct ivshmem_net_shm_s
+{
+  volatile uint32_t         magic;
+  volatile uint32_t         nslots;   /* Slots per ring, a power of 2 */
+  volatile uint32_t         slotsize; /* Bytes per slot */
+  volatile uint32_t         ready[2]; /* Interface up, indexed by role */
+  uint8_t                   pad[IVSHMEM_NET_ALIGN - 20];
+  struct ivshmem_net_ring_s ring[2];  /* Indexed by the producer role */
+};
+
+struct ivshmem_net_s
+{
+  struct netdev_lowerhalf_s      dev;      /* Must be the first */
+  struct ivshmem_driver_s        drv;
+  FAR struct ivshmem_device_s   *ivdev;
+  FAR struct ivshmem_net_shm_s  *shm;
+  size_t                         shmsize;
+  int                            role;     /* 0: master, 1: slave */
+  bool                           ifup;     /* Interface is up locally */
+  bool                           carrier;  /* Both sides are up */
+
+  /* Ring geometry, valid once attached to the shared memory */
+
+  FAR struct ivshmem_net_ring_s *txring;
+  FAR struct ivshmem_net_ring_s *rxring;
+  FAR uint8_t                   *txslots;
+  FAR uint8_t                   *rxslots;
+  uint32_t                       nslots;
+  uint32_t                       slotsize;
+
+  /* Local copies of the indexes this side owns */
+
+  uint32_t                       txhead;   /* Next TX slot to fill */
+  uint32_t                       txclean;  /* Next TX slot to release */
+  uint32_t                       rxtail;   /* Next RX slot to drain */
+
+  /* The TX packets are held until the peer consumes their slot, so the
+   * TX quota stalls the upper half exactly when the ring is full.
+   */
+
+  FAR netpkt_t                 **txpkts;
+
+  struct work_s                  work;     /* Link state work */
+  struct wdog_s                  wdog;     /* Poll without doorbell irq */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ivshmem_net_ifup(FAR struct netdev_lowerhalf_s *dev);
+static int ivshmem_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
+static int ivshmem_net_transmit(FAR struct netdev_lowerhalf_s *dev,
+                                FAR netpkt_t *pkt);
+static FAR netpkt_t *ivshmem_net_receive(FAR struct netdev_lowerhalf_s *dev);
+static void ivshmem_net_reclaim(FAR struct netdev_lowerhalf_s *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct netdev_ops_s g_ivshmem_net_ops =
+{
+  .ifup     = ivshmem_net_ifup,
+  .ifdown   = ivshmem_net_ifdown,
+  .transmit = ivshmem_net_transmit,
+  .receive  = ivshmem_net_receive,
+  .reclaim  = ivshmem_net_reclaim,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ivshmem_net_slot
+ ****************************************************************************/
+
+static inline FAR uint8_t *ivshmem_net_slot(FAR struct ivshmem_net_s *priv,
+                                            FAR uint8_t *slots,
+                                            uint32_t index)
+{
+  return slots + (index & (priv->nslots - 1)) * priv->slotsize;
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_kick
+ ****************************************************************************/
+
+static void ivshmem_net_kick(FAR struct ivshmem_net_s *priv)
+{
+  /* Without the doorbell the peer polls the rings */
+
+  if (ivshmem_support_irq(priv->ivdev))
+    {
+      ivshmem_kick_peer(priv->ivdev);
+    }
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_linkup
+ *
+ * Description:
+ *   Return true if the link should be up: the shared memory is initialized
+ *   and both sides have the interface up.
+ *
+ ****************************************************************************/
+
+static bool ivshmem_net_linkup(FAR struct ivshmem_net_s *priv)
+{
+  return priv->ifup && priv->shm->magic == IVSHMEM_NET_MAGIC &&
+         priv->shm->ready[priv->role] && priv->shm->ready[1 - priv->role];
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_unready
+ *
+ * Description:
+ *   Return true if the interface is up but our ready flag is missing, the
+ *   master may have (re)initialized the shared memory after it was set.
+ *
+ ****************************************************************************/
+
+static bool ivshmem_net_unready(FAR struct ivshmem_net_s *priv)
+{
+  return priv->ifup && priv->shm->magic == IVSHMEM_NET_MAGIC &&
+         !priv->shm->ready[priv->role];
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_txflush
+ *
+ * Description:
+ *   Release all the TX packets held by the ring when the link goes down.
+ *
+ ****************************************************************************/
+
+static void ivshmem_net_txflush(FAR struct ivshmem_net_s *priv)
+{
+  FAR netpkt_t *pkt;
+
+  while (priv->txclean != priv->txhead)
+    {
+      pkt = priv->txpkts[priv->txclean++ & (priv->nslots - 1)];
+      netpkt_free(&priv->dev, pkt, NETPKT_TX);
+    }
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_attach
+ *
+ * Description:
+ *   Pick up the ring geometry published by the master and resume the ring
+ *   indexes from the shared memory.
+ *
+ ****************************************************************************/
+
+static int ivshmem_net_attach(FAR struct ivshmem_net_s *priv)
+{
+  FAR struct ivshmem_net_shm_s *shm = priv->shm;
+  uint32_t nslots = shm->nslots;
+  uint32_t slotsize = shm->slotsize;
+
+  UP_RMB();
+
+  if (nslots == 0 || (nslots & (nslots - 1)) != 0 ||
+      slotsize <= sizeof(uint32_t) || slotsize % sizeof(uint32_t) != 0 ||
+      sizeof(*shm) + 2 * (size_t)nslots * slotsize > priv->shmsize)
+    {
+      nerr("ERROR: Bad ring geometry, nslots=%" PRIu32
+           " slotsize=%" PRIu32 "\n", nslots, slotsize);
+      return -EINVAL;
+    }
+
+  if (priv->txpkts == NULL)
+    {
+      priv->txpkts = kmm_zalloc(nslots * sizeof(*priv->txpkts));
+      if (priv->txpkts == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      priv->nslots = nslots;
+      atomic_set(&priv->dev.quota[NETPKT_TX], nslots);
+      atomic_set(&priv->dev.quota[NETPKT_RX], nslots);
+    }
+  else if (priv->nslots != nslots)
+    {
+      nerr("ERROR: Ring size changed from %" PRIu32 " to %" PRIu32 "\n",
+           priv->nslots, nslots);
+      return -EINVAL;
+    }
+
+  priv->slotsize = slotsize;
+  priv->txring   = &shm->ring[priv->role];
+  priv->rxring   = &shm->ring[1 - priv->role];
+  priv->txslots  = (FAR uint8_t *)(shm + 1) +
+                   priv->role * nslots * slotsize;
+  priv->rxslots  = (FAR uint8_t *)(shm + 1) +
+                   (1 - priv->role) * nslots * slotsize;
+  priv->txhead   = priv->txring->head;
+  priv->txclean  = priv->txhead;
+  priv->rxtail   = priv->rxring->tail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_link_work
+ *
+ * Description:
+ *   Publish the local interface state and follow the peer one, the
+ *   netdev_lower_carrier_xxx API can't be used in interrupt context.
+ *
+ ****************************************************************************/
+
+static void ivshmem_net_link_work(FAR void *arg)
+{
+  FAR struct ivshmem_net_s *priv = arg;
+  FAR struct ivshmem_net_shm_s *shm = priv->shm;
+
+  netdev_lock(&priv->dev.netdev);
+
+  if (ivshmem_net_unready(priv))
+    {
+      shm->ready[priv->role] = 1;
+      UP_DMB();
+      ivshmem_net_kick(priv);
+    }
+
+  if (ivshmem_net_linkup(priv))
+    {
+      if (!priv->carrier && ivshmem_net_attach(priv) >= 0)
+        {
+          priv->carrier = true;
+          netdev_lower_carrier_on(&priv->dev);
+        }
+    }
+  else if (priv->carrier)
+    {
+      priv->carrier = false;
+      netdev_lower_carrier_off(&priv->dev);
+      ivshmem_net_txflush(priv);
+    }
+
+  netdev_unlock(&priv->dev.netdev);
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_notify
+ *
+ * Description:
+ *   Handle the doorbell, or the poll without it: wake up the upper half for
+ *   the received frames and for the TX slots consumed by the peer, and
+ *   defer the link state changes to the work queue.
+ *
+ ****************************************************************************/
+
+static void ivshmem_net_notify(FAR struct ivshmem_net_s *priv)
+{
+  if (priv->carrier)
+    {
+      if (priv->rxring->head != priv->rxtail)
+        {
+          netdev_lower_rxready(&priv->dev);
+        }
+
+      if (priv->txring->tail != priv->txclean)
+        {
+          netdev_lower_txdone(&priv->dev);
+        }
+    }
+
+  if ((priv->carrier != ivshmem_net_linkup(priv) ||
+       ivshmem_net_unready(priv)) && work_available(&priv->work))
+    {
+      work_queue(LPWORK, &priv->work, ivshmem_net_link_work, priv, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_interrupt
+ ****************************************************************************/
+
+static int ivshmem_net_interrupt(int irq, FAR void *context, FAR void *arg)
+{
+  ivshmem_net_notify(arg);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_wdog
+ ****************************************************************************/
+
+static void ivshmem_net_wdog(wdparm_t arg)
+{
+  FAR struct ivshmem_net_s *priv = (FAR struct ivshmem_net_s *)arg;
+
+  ivshmem_net_notify(priv);
+  wd_start(&priv->wdog, IVSHMEM_NET_WDOG_DELAY,
+           ivshmem_net_wdog, (wdparm_t)priv);
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_ifup
+ *
+ * Description:
+ *   NuttX Callback: Bring up the interface, the carrier follows once the
+ *   peer is up too.
+ *
+ ****************************************************************************/
+
+static int ivshmem_net_ifup(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct ivshmem_net_s *priv = (FAR struct ivshmem_net_s *)dev;
+
+  priv->ifup = true;
+  work_queue(LPWORK, &priv->work, ivshmem_net_link_work, priv, 0);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_ifdown
+ *
+ * Description:
+ *   NuttX Callback: Stop the interface and tell the peer.
+ *
+ ****************************************************************************/
+
+static int ivshmem_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct ivshmem_net_s *priv = (FAR struct ivshmem_net_s *)dev;
+
+  priv->ifup = false;
+  if (priv->shm->magic == IVSHMEM_NET_MAGIC)
+    {
+      priv->shm->ready[priv->role] = 0;
+      UP_DMB();
+      ivshmem_net_kick(priv);
+    }
+
+  if (priv->carrier)
+    {
+      priv->carrier = false;
+      netdev_lower_carrier_off(dev);
+      ivshmem_net_txflush(priv);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_transmit
+ *
+ * Description:
+ *   Copy the frame into the next TX slot and publish it, the packet is
+ *   released by ivshmem_net_reclaim() once the peer consumed the slot.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int ivshmem_net_transmit(FAR struct netdev_lowerhalf_s *dev,
+                                FAR netpkt_t *pkt)
+{
+  FAR struct ivshmem_net_s *priv = (FAR struct ivshmem_net_s *)dev;
+  unsigned int len = netpkt_getdatalen(dev, pkt);
+  FAR uint8_t *slot;
+
+  if (!priv->carrier)
+    {
+      return -ENETDOWN;
+    }
+
+  if (len > priv->slotsize - sizeof(uint32_t))
+    {
+      nerr("ERROR: Frame too large for the slot: %u\n", len);
+      return -EMSGSIZE;
+    }
+
+  /* The TX quota matches the ring size, so this is only hit if the peer
+   * moved its tail backwards.
+   */
+
+  if (priv->txhead - priv->txring->tail >= priv->nslots)
+    {
+      nwarn("WARNING: TX ring full\n");
+      return -ENOBUFS;
+    }
+
+  slot = ivshmem_net_slot(priv, priv->txslots, priv->txhead);
+  *(FAR uint32_t *)slot = len;
+  netpkt_copyout(dev, slot + sizeof(uint32_t), pkt, len, 0);
+  priv->txpkts[priv->txhead & (priv->nslots - 1)] = pkt;
+
+  /* Publish the slot content before the head, then check the consumer
+   * wait flag after the head is visible, otherwise a consumer going to
+   * sleep at the same time could miss the frame.
+   */
+
+  UP_WMB();
+  priv->txring->head = ++priv->txhead;
+  UP_DMB();
+
+  if (priv->txring->wait_data)
+    {
+      ivshmem_net_kick(priv);
+    }
+
+  ivshmem_net_reclaim(dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_receive
+ *
+ * Description:
+ *   Copy the next received frame out of the RX ring, and ask for the
+ *   doorbell if the ring is empty.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *ivshmem_net_receive(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct ivshmem_net_s *priv = (FAR struct ivshmem_net_s *)dev;
+  FAR struct ivshmem_net_ring_s *ring = priv->rxring;
+  FAR netpkt_t *pkt = NULL;
+  FAR uint8_t *slot;
+  uint32_t len;
+
+  if (!priv->carrier)
+    {
+      return NULL;
+    }
+
+  while (pkt == NULL)
+    {
+      if (ring->head == priv->rxtail)
+        {
+          /* Ask for the doorbell, then check again for a frame published
+           * before the producer could see the flag.
+           */
+
+          ring->wait_data = 1;
+          UP_DMB();
+
+          if (ring->head == priv->rxtail)
+            {
+              return NULL;
+            }
+        }
+
+      ring->wait_data = 0;
+      UP_RMB();
+
+      slot = ivshmem_net_slot(priv, priv->rxslots, priv->rxtail);
+      len  = *(FAR uint32_t *)slot;
+
+      if (len <= priv->slotsize - sizeof(uint32_t))
+        {
+          pkt = netpkt_alloc(dev, NETPKT_RX);
+          if (pkt == NULL)
+            {
+              /* Leave the frame in the ring, the next one rings again */
+
+              ring->wait_data = 1;
+              return NULL;
+            }
+
+          if (netpkt_copyin(dev, pkt, slot + sizeof(uint32_t),
+                            len, 0) < 0)
+            {
+              netpkt_free(dev, pkt, NETPKT_RX);
+              pkt = NULL;
+            }
+        }
+      else
+        {
+          nerr("ERROR: Bad frame length: %" PRIu32 "\n", len);
+        }
+
+      /* Release the slot once it is copied */
+
+      UP_DMB();
+      ring->tail = ++priv->rxtail;
+      UP_DMB();
+
+      if (ring->wait_space)
+        {
+          ivshmem_net_kick(priv);
+        }
+    }
+
+  return pkt;
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_reclaim
+ *
+ * Description:
+ *   Release the TX packets whose slot was consumed by the peer, and ask for
+ *   the doorbell if we ran out of TX packets.
+ *
+ ****************************************************************************/
+
+static void ivshmem_net_reclaim(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct ivshmem_net_s *priv = (FAR struct ivshmem_net_s *)dev;
+  FAR struct ivshmem_net_ring_s *ring = priv->txring;
+  FAR netpkt_t *pkt;
+  uint32_t tail;
+
+  if (!priv->carrier)
+    {
+      return;
+    }
+
+  for (; ; )
+    {
+      tail = ring->tail;
+      while (priv->txclean != tail)
+        {
+          pkt = priv->txpkts[priv->txclean++ & (priv->nslots - 1)];
+          netpkt_free(dev, pkt, NETPKT_TX);
+        }
+
+      if (netdev_lower_quota_load(dev, NETPKT_TX) > 0)
+        {
+          ring->wait_space = 0;
+          break;
+        }
+
+      /* Ask for the doorbell, then check again for a slot consumed before
+       * the consumer could see the flag.
+       */
+
+      ring->wait_space = 1;
+      UP_DMB();
+
+      if (ring->tail == priv->txclean)
+        {
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_shm_init
+ *
+ * Description:
+ *   Master only: lay out the rings in the shared memory.
+ *
+ ****************************************************************************/
+
+static int ivshmem_net_shm_init(FAR struct ivshmem_net_s *priv)
+{
+  FAR struct ivshmem_net_shm_s *shm = priv->shm;
+  uint32_t nslots = CONFIG_NET_IVSHMEM_NSLOTS;
+
+  /* Round down to a power of 2 that fits in the shared memory */
+
+  while ((nslots & (nslots - 1)) != 0)
+    {
+      nslots &= nslots - 1;
+    }
+
+  while (nslots > 0 &&
+         sizeof(*shm) + 2 * (size_t)nslots * IVSHMEM_NET_SLOTSIZE >
+         priv->shmsize)
+    {
+      nslots >>= 1;
+    }
+
+  if (nslots == 0)
+    {
+      nerr("ERROR: Shared memory too small: %zu\n", priv->shmsize);
+      return -ENOMEM;
+    }
+
+  shm->magic = 0;
+  UP_DMB();
+
+  memset((FAR uint8_t *)shm + sizeof(shm->magic), 0,
+         sizeof(*shm) - sizeof(shm->magic));
+  shm->nslots   = nslots;
+  shm->slotsize = IVSHMEM_NET_SLOTSIZE;
+
+  UP_WMB();
+  shm->magic = IVSHMEM_NET_MAGIC;
+  UP_DMB();
+
+  ivshmem_net_kick(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_probe
+ ****************************************************************************/
+
+static int ivshmem_net_probe(FAR struct ivshmem_device_s *ivdev)
+{
+  FAR struct ivshmem_net_s *priv = ivshmem_net_from(ivdev);
+  FAR struct netdev_lowerhalf_s *dev = &priv->dev;
+  FAR uint8_t *mac = dev->netdev.d_mac.ether.ether_addr_octet;
+  int ret;
+
+  priv->ivdev = ivdev;
+  priv->shm   = ivshmem_get_shmem(ivdev, &priv->shmsize);
+  if (priv->shm == NULL || priv->shmsize < sizeof(*priv->shm))
+    {
+      nerr("ERROR: No usable shared memory\n");
+      return -ENOMEM;
+    }
+
+  ivshmem_attach_irq(ivdev, ivshmem_net_interrupt, priv);
+  ivshmem_control_irq(ivdev, true);
+
+  if (priv->role == 0)
+    {
+      ret = ivshmem_net_shm_init(priv);
+      if (ret < 0)
+        {
+          goto err;
+        }
+    }
+
+  /* Assign a random locally administered MAC address */
+
+  mac[0] = 0x42;
+  arc4random_buf(mac + 1, 5);
+
+  /* The quotas follow the ring size once attached */
+
+  dev->ops = &g_ivshmem_net_ops;
+  ret = netdev_lower_register(dev, NET_LL_ETHERNET);
+  if (ret < 0)
+    {
+      nerr("ERROR: netdev_lower_register failed: %d\n", ret);
+      goto err;
+    }
+
+  if (!ivshmem_support_irq(ivdev))
+    {
+      ret = wd_start(&priv->wdog, IVSHMEM_NET_WDOG_DELAY,
+                     ivshmem_net_wdog, (wdparm_t)priv);
+      if (ret < 0)
+        {
+          nerr("ERROR: wd_start failed: %d\n", ret);
+          netdev_lower_unregister(dev);
+          goto err;
+        }
+    }
+
+  return OK;
+
+err:
+  ivshmem_control_irq(ivdev, false);
+  ivshmem_detach_irq(ivdev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ivshmem_net_remove
+ ****************************************************************************/
+
+static void ivshmem_net_remove(FAR struct ivshmem_device_s *ivdev)
+{
+  FAR struct ivshmem_net_s *priv = ivshmem_net_from(ivdev);
+
+  if (!ivshmem_support_irq(ivdev))
+    {
+      wd_cancel(&priv->wdog);
+    }
+
+  ivshmem_control_irq(ivdev, false);
+  ivshmem_detach_irq(ivdev);
+  work_cancel_sync(LPWORK, &priv->work);
+
+  netdev_lower_unregister(&priv->dev);
+  kmm_free(priv->txpkts);
+  priv->txpkts = NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pci_register_ivshmem_net_driver
+ *
+ * Description:
+ *   Register the ivshmem net drivers described by CONFIG_NET_IVSHMEM_NAME,
+ *   "id:role;id:role...", the role is 'm' for the side laying out the
+ *   shared memory and 's' for the other one.
+ *
+ ****************************************************************************/
+
+int pci_register_ivshmem_net_driver(void)
+{
+  FAR char *name = CONFIG_NET_IVSHMEM_NAME;
+
+  while (name != NULL && *name != '\0')
+    {
+      FAR struct ivshmem_net_s *priv = kmm_zalloc(sizeof(*priv));
+      if (priv == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      priv->drv.id = strtoul(name, &name, 0);
+      priv->role   = *name == ':' && name[1] == 'm' ? 0 : 1;
+
+      ninfo("Register ivshmem net driver, id=%d, master=%d\n",
+            priv->drv.id, priv->role == 0);
+
+      priv->drv.probe  = ivshmem_net_probe;
+      priv->drv.remove = ivshmem_net_remove;
+      if (ivshmem_register_driver(&priv->drv) < 0)
+        {
+          kmm_free(priv);
+        }
+
+      name = strchr(name, ';');
+      if (name != NULL)
+        {
+          name++;
+        }
+    }
+
+  return 0;
+}
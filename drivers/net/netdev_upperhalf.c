@@ -28,7 +28,9 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -39,6 +41,8 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/net/vlan.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
@@ -88,6 +92,10 @@ struct netdev_upperhalf_s
 
   bool txing;
 
+#ifdef CONFIG_NETDEV_NAPI
+  int budget; /* Max # of packets received in one poll */
+#endif
+
   /* Deferring process to work queue or thread */
 
   union
@@ -102,6 +110,7 @@ struct netdev_upperhalf_s
  ****************************************************************************/
 
 static int netdev_upper_txavail(FAR struct net_driver_s *dev);
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev);
 
 /****************************************************************************
  * Private Functions
@@ -227,6 +236,10 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev, size_t extra_size)
   upper->lower = dev;
   dev->netdev.d_private = upper;
 
+#ifdef CONFIG_NETDEV_NAPI
+  upper->budget = CONFIG_NETDEV_NAPI_BUDGET;
+#endif
+
   return upper;
 }
 
@@ -299,7 +312,10 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  /* Only the TSO capable lower halves get packets larger than the MTU */
+
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev) &&
+      !NETDEV_IS_GSO(dev))
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
@@ -417,6 +433,10 @@ static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   int ret;
 
+  /* The packet loses its checksum state once it is queued */
+
+  netdev_checksum_complete(dev);
+
   if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
     {
       netdev_iob_clear(dev);
@@ -688,30 +708,123 @@ static void ip_input(FAR struct net_driver_s *dev)
 #endif
 
 /****************************************************************************
- * Function: netdev_upper_rxpoll_work
+ * Name: netdev_upper_rxbudget
+ *
+ * Description:
+ *   Get the max number of packets to receive in one poll.
+ *
+ ****************************************************************************/
+
+static inline int netdev_upper_rxbudget(FAR struct netdev_upperhalf_s *upper)
+{
+#ifdef CONFIG_NETDEV_NAPI
+  /* The direct mode polls in the context of the lower half, it has no other
+   * work to give way to.
+   */
+
+  if (upper->lower->rxtype != NETDEV_RX_DIRECT)
+    {
+      return upper->budget;
+    }
+#endif
+
+  return INT_MAX;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_rxqnum / netdev_upper_receive
+ *
+ * Description:
+ *   Get the number of RX queues of the lower half and receive a packet from
+ *   one of them.
+ *
+ ****************************************************************************/
+
+static inline int netdev_upper_rxqnum(FAR struct netdev_lowerhalf_s *lower)
+{
+#ifdef CONFIG_NETDEV_RSS
+  if (lower->rxqnum > 1)
+    {
+      return lower->rxqnum;
+    }
+#endif
+
+  return 1;
+}
+
+static inline FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_lowerhalf_s *lower, int queue)
+{
+#ifdef CONFIG_NETDEV_RSS
+  if (lower->rxqnum > 1)
+    {
+      return lower->ops->receive_queue(lower, queue);
+    }
+#endif
+
+  UNUSED(queue);
+  return lower->ops->receive(lower);
+}
+
+/****************************************************************************
+ * Function: netdev_upper_rxtime
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   Hand the hardware timestamp of the received packet to the network
+ *   stack, or the current time if the driver could not stamp it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_HWTSTAMP
+static inline void netdev_upper_rxtime(FAR struct net_driver_s *dev,
+                                       FAR netpkt_t *pkt)
+{
+  if ((dev->d_features & NETDEV_RX_TIME) == 0)
+    {
+      return;
+    }
+
+  if (pkt->io_tstamp.tv_sec != 0 || pkt->io_tstamp.tv_nsec != 0)
+    {
+      dev->d_rxtime = pkt->io_tstamp;
+    }
+  else
+    {
+      clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_queue
+ *
+ * Description:
+ *   Try to receive packets from one RX queue of the device and pass
+ *   packets into IP stack and send packets which is from IP stack if
+ *   necessary.
  *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
+ *   queue - The RX queue to poll
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static void netdev_upper_rxpoll_queue(FAR struct netdev_upperhalf_s *upper,
+                                      int queue)
 {
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR struct net_driver_s       *dev   = &lower->netdev;
   FAR netpkt_t                  *pkt;
+  int                            budget;
 
   /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
   netdev_lock(dev);
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  budget = netdev_upper_rxbudget(upper);
+  while (budget-- > 0 && (pkt = netdev_upper_receive(lower, queue)) != NULL)
     {
       if (!IFF_IS_UP(dev->d_flags))
         {
@@ -726,12 +839,46 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
       netpkt_put(dev, pkt, NETPKT_RX);
       NETDEV_RXPACKETS(dev);
 
+#ifdef CONFIG_NETDEV_HWTSTAMP
+      netdev_upper_rxtime(dev, pkt);
+#endif
+
+#ifdef CONFIG_NETDEV_RXHOOK
+      /* The early receive hook sees the frame before the packet sockets
+       * and the network stack.
+       */
+
+      if (netdev_rxhook_input(dev))
+        {
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
+          if (dev->d_len > 0)
+            {
+              netdev_upper_queue_tx(dev);
+            }
+#endif
+
+          netdev_iob_release(dev);
+          dev->d_len = 0;
+          continue;
+        }
+#endif
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the tap */
 
       pkt_input(dev);
 #endif
 
+#ifdef CONFIG_NETDEV_GRO
+      /* Coalesce the TCP segments of the same flow within this batch */
+
+      if (netdev_gro_receive(dev, eth_input))
+        {
+          continue;
+        }
+#endif
+
       switch (dev->d_lltype)
         {
 #ifdef CONFIG_NET_LOOPBACK
@@ -765,7 +912,59 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
         }
     }
 
+#ifdef CONFIG_NETDEV_GRO
+  netdev_gro_flush(dev, eth_input);
+#endif
+
   netdev_unlock(dev);
+
+#ifdef CONFIG_NETDEV_NAPI
+  if (lower->rxtype != NETDEV_RX_DIRECT)
+    {
+      if (budget < 0)
+        {
+          /* The budget is used up, keep the RX interrupt disabled and poll
+           * again after the other pending work.
+           */
+
+          netdev_upper_queue_work(dev);
+        }
+      else if (lower->ops->rxint != NULL)
+        {
+          lower->ops->rxint(lower, true);
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_work
+ *
+ * Description:
+ *   Poll the RX queues of the device served by 'cpu', or all of them if
+ *   'cpu' is negative.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   cpu   - The CPU of the RSS thread or -1
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     int cpu)
+{
+  int nqueue = netdev_upper_rxqnum(upper->lower);
+  int queue;
+
+  /* A single queue is polled by the thread of the interrupted CPU */
+
+  for (queue = 0; queue < nqueue; queue++)
+    {
+      if (nqueue == 1 || cpu < 0 || queue % CONFIG_SMP_NCPUS == cpu)
+        {
+          netdev_upper_rxpoll_queue(upper, queue);
+        }
+    }
 }
 
 /****************************************************************************
@@ -785,7 +984,7 @@ static void netdev_upper_work(FAR void *arg)
 
   /* RX may release quota and driver buffer, so do RX first. */
 
-  netdev_upper_rxpoll_work(upper);
+  netdev_upper_rxpoll_work(upper, -1);
   netdev_upper_txavail_work(upper);
 }
 
@@ -803,6 +1002,7 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
     (FAR struct netdev_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
   int cpu = atoi(argv[2]);
   FAR struct netdev_thread_s *t = &upper->thread[cpu];
+  int rxcpu = -1;
 
   if (upper->lower->rxtype == NETDEV_RX_THREAD_RSS)
     {
@@ -811,11 +1011,18 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
       CPU_ZERO(&cpuset);
       CPU_SET(cpu, &cpuset);
       sched_setaffinity(t->tid, sizeof(cpu_set_t), &cpuset);
+
+      /* Only poll the RX queues steered to this CPU */
+
+      rxcpu = cpu;
     }
 
   while (nxsem_wait(&t->sem) == OK && t->tid != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      /* RX may release quota and driver buffer, so do RX first. */
+
+      netdev_upper_rxpoll_work(upper, rxcpu);
+      netdev_upper_txavail_work(upper);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
@@ -823,6 +1030,24 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
   return 0;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_thread_post
+ *
+ * Description:
+ *   Wake up a dedicated thread if it isn't already going to run.
+ *
+ ****************************************************************************/
+
+static inline void netdev_upper_thread_post(FAR struct netdev_thread_s *t)
+{
+  int semcount;
+
+  if (nxsem_get_value(&t->sem, &semcount) == OK && semcount <= 0)
+    {
+      nxsem_post(&t->sem);
+    }
+}
+
 /****************************************************************************
  * Name: netdev_upper_queue_work
  *
@@ -856,15 +1081,7 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
       case NETDEV_RX_THREAD_RSS:
         cpu = this_cpu();
       case NETDEV_RX_THREAD:
-        {
-          FAR struct netdev_thread_s *t = &upper->thread[cpu];
-          int semcount;
-
-          if (nxsem_get_value(&t->sem, &semcount) == OK && semcount <= 0)
-            {
-              nxsem_post(&t->sem);
-            }
-        }
+        netdev_upper_thread_post(&upper->thread[cpu]);
         break;
     }
 }
@@ -1336,6 +1553,42 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
     }
 #endif
 
+#ifdef CONFIG_NETDEV_RSS
+  if (cmd == SIOCNOTIFYRECVCPU && netdev_upper_rxqnum(lower) > 1 &&
+      lower->ops->rss_steer != NULL)
+    {
+      FAR struct netdev_rss_s *rss =
+        (FAR struct netdev_rss_s *)((uintptr_t)arg);
+
+      /* Steer the flow to the queue polled by the CPU of its reader */
+
+      return lower->ops->rss_steer(lower, rss->hash,
+                                   rss->cpu % lower->rxqnum);
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_NAPI
+  if (cmd == SIOCGIFBUDGET || cmd == SIOCSIFBUDGET)
+    {
+      FAR struct ifreq *req = (FAR struct ifreq *)((uintptr_t)arg);
+
+      if (cmd == SIOCGIFBUDGET)
+        {
+          req->ifr_budget = upper->budget;
+        }
+      else if (req->ifr_budget > 0)
+        {
+          upper->budget = req->ifr_budget;
+        }
+      else
+        {
+          return -EINVAL;
+        }
+
+      return OK;
+    }
+#endif
+
   if (lower->ops->ioctl)
     {
       return lower->ops->ioctl(lower, cmd, arg);
@@ -1381,6 +1634,14 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
+#ifdef CONFIG_NETDEV_RSS
+  if (dev->rxqnum > 1 && dev->ops->receive_queue == NULL)
+    {
+      nerr("ERROR: Multi queue device without receive_queue\n");
+      return -EINVAL;
+    }
+#endif
+
   if (dev->quota_ptr == NULL)
     {
       dev->quota_ptr = dev->quota;
@@ -1431,6 +1692,14 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 #endif
   dev->netdev.d_private = upper;
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* The TX path is IOB only, so any lower half can take the segments of a
+   * large TCP packet in one batch if it can't do the segmentation itself.
+   */
+
+  dev->netdev.d_features |= NETDEV_TX_GSO;
+#endif
+
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
     {
@@ -1585,14 +1854,61 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 
   if (dev->rxtype == NETDEV_RX_DIRECT)
     {
-      netdev_upper_rxpoll_work(dev->netdev.d_private);
+      netdev_upper_rxpoll_work(dev->netdev.d_private, -1);
     }
   else
     {
+#ifdef CONFIG_NETDEV_NAPI
+      /* Poll with the RX interrupt disabled until no packet is left */
+
+      if (dev->ops->rxint != NULL)
+        {
+          dev->ops->rxint(dev, false);
+        }
+#endif
+
       netdev_upper_queue_work(&dev->netdev);
     }
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxqueue_ready
+ *
+ * Description:
+ *   Notifies the networking layer about RX packets ready to read on the RX
+ *   queue 'queue' of a multi queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The RX queue
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+void netdev_lower_rxqueue_ready(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  if (dev->rxtype != NETDEV_RX_THREAD_RSS)
+    {
+      netdev_lower_rxready(dev);
+      return;
+    }
+
+#ifdef CONFIG_NETDEV_NAPI
+  if (dev->ops->rxint != NULL)
+    {
+      dev->ops->rxint(dev, false);
+    }
+#endif
+
+  /* Each queue is polled by the thread bound to a fixed CPU */
+
+  netdev_upper_thread_post(&upper->thread[queue % CONFIG_SMP_NCPUS]);
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -1747,6 +2063,11 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
     }
 
   iob_reserve(pkt, CONFIG_NET_LL_GUARDSIZE);
+#ifdef CONFIG_NETDEV_HWTSTAMP
+  pkt->io_tstamp.tv_sec  = 0;
+  pkt->io_tstamp.tv_nsec = 0;
+#endif
+
   return pkt;
 }
 
@@ -1770,6 +2091,29 @@ void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
   iob_free_chain(pkt);
 }
 
+/****************************************************************************
+ * Name: netpkt_concat
+ *
+ * Description:
+ *   Append the netpkt pkt2 to the end of pkt1, e.g. the buffers of a frame
+ *   received in several pieces.  pkt2 is released from the quota, it is
+ *   freed together with pkt1 later.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   pkt1 - The packet to append to
+ *   pkt2 - The packet appended
+ *   type - Whether used for TX or RX
+ *
+ ****************************************************************************/
+
+void netpkt_concat(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt1,
+                   FAR netpkt_t *pkt2, enum netpkt_type_e type)
+{
+  atomic_fetch_add(&dev->quota_ptr[type], 1);
+  iob_concat(pkt1, pkt2);
+}
+
 /****************************************************************************
  * Name: netpkt_copyin
  *
@@ -1969,3 +2313,105 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
   return i;
 }
+
+/****************************************************************************
+ * Name: netpkt_get_txcsum
+ *
+ * Description:
+ *   Check whether the hardware has to complete the TCP or UDP checksum of
+ *   the packet being transmitted, it is only the case on the devices with
+ *   NETDEV_TX_CSUM.  The checksum field holds the pseudo header sum then,
+ *   the hardware adds the bytes from 'start' to the end of the packet and
+ *   stores the complement of the sum at 'offset'.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet being transmitted
+ *   start  - Returns where the hardware starts the sum
+ *   offset - Returns where the hardware stores the checksum
+ *
+ *   Both are counted from the beginning of the L2 header
+ *
+ * Returned Value:
+ *   True if the hardware has to complete the checksum.
+ *
+ ****************************************************************************/
+
+bool netpkt_get_txcsum(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                       FAR uint16_t *start, FAR uint16_t *offset)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  uint16_t iphdrlen;
+  uint8_t proto;
+
+  /* The flag is only valid while the stack hands the packet to transmit */
+
+  if (!dev->netdev.d_txcsum)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 4)
+#  endif
+    {
+      iphdrlen = (ip[0] & IPv4_HLMASK) << 2;
+      proto    = ((FAR struct ipv4_hdr_s *)ip)->proto;
+    }
+#endif
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  else
+#  endif
+    {
+      iphdrlen = IPv6_HDRLEN;
+      proto    = ((FAR struct ipv6_hdr_s *)ip)->proto;
+    }
+#endif
+
+  *start  = NET_LL_HDRLEN(&dev->netdev) + iphdrlen;
+  *offset = *start + offsetof(struct udp_hdr_s, udpchksum);
+
+#ifdef CONFIG_NET_TCP
+  if (proto == IP_PROTO_TCP)
+    {
+      *offset = *start + offsetof(struct tcp_hdr_s, tcpchksum);
+    }
+#else
+  UNUSED(proto);
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: netpkt_set_rxcsum
+ *
+ * Description:
+ *   Report whether the hardware has verified the checksums of the packet
+ *   being received, so the network stack skips its own verification.  It
+ *   is for the drivers which check the packets one by one, and has to be
+ *   called for each packet they return from the receive() operation.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   valid - True if the IP and the TCP or UDP checksums are good
+ *
+ ****************************************************************************/
+
+void netpkt_set_rxcsum(FAR struct netdev_lowerhalf_s *dev, bool valid)
+{
+  /* The packet is handed to the stack right after receive() returns, so
+   * the feature flag follows the packet being received.
+   */
+
+  if (valid)
+    {
+      dev->netdev.d_features |= NETDEV_RX_CSUM;
+    }
+  else
+    {
+      dev->netdev.d_features &= ~NETDEV_RX_CSUM;
+    }
+}
@@ -70,6 +70,19 @@
 
 #define get_pid(pid) ((pid) < NCPUS ? 0 : (pid))
 
+/* Every CPU owns a ring of the buffer with per-CPU buffers, it is the only
+ * writer of its ring and does not need a lock to add a note.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  define NOTERAM_NRINGS NCPUS
+#else
+#  define NOTERAM_NRINGS 1
+#endif
+
+#define NOTERAM_RING_SIZE(s) \
+  (((s) / NOTERAM_NRINGS) & ~(sizeof(uintptr_t) - 1))
+
 #define get_task_state(s)                                                    \
   ((s) == 0 ? 'X' : ((s) <= LAST_READY_TO_RUN_STATE ? 'R' : 'S'))
 
@@ -83,16 +96,32 @@
  * Private Types
  ****************************************************************************/
 
+/* The state of one circular buffer.  The positions are free running byte
+ * counts, the writer owns nr_seq, nr_tail, nr_tpos, nr_wpos and the
+ * overflow state, the reader owns nr_rpos and nr_start.  nr_seq is odd
+ * while the writer moves notes, the reader retries a copy that overlaps it.
+ */
+
+struct noteram_ring_s
+{
+  volatile unsigned int nr_seq;      /* Write sequence count */
+  volatile unsigned int nr_tail;     /* Index of the oldest note */
+  volatile uint32_t nr_tpos;         /* Position of the oldest note */
+  volatile uint32_t nr_wpos;         /* Position of the next note */
+  volatile uint32_t nr_rpos;         /* Position of the next note to read */
+  volatile uint32_t nr_start;        /* Position cleared up to */
+  volatile uint32_t nr_ovfstart;     /* nr_start when recording stopped */
+  volatile bool nr_overflow;         /* Recording stopped, ring full */
+};
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
   FAR uint8_t *ni_buffer;
-  size_t ni_bufsize;
+  size_t ni_bufsize;                 /* Size of each ring */
   unsigned int ni_overwrite;
   unsigned int threshold;
-  volatile unsigned int ni_head;
-  volatile unsigned int ni_tail;
-  volatile unsigned int ni_read;
+  struct noteram_ring_s ni_ring[NOTERAM_NRINGS];
   spinlock_t lock;
   FAR struct pollfd *pfd;
   struct notifier_block nb;
@@ -184,7 +213,7 @@ struct noteram_driver_s g_noteram_driver =
     &g_noteram_ops
   },
   g_ramnote_buffer,
-  CONFIG_DRIVERS_NOTERAM_BUFSIZE,
+  NOTERAM_RING_SIZE(CONFIG_DRIVERS_NOTERAM_BUFSIZE),
 #ifdef CONFIG_DRIVERS_NOTERAM_DEFAULT_NOOVERWRITE
   NOTERAM_MODE_OVERWRITE_DISABLE
 #else
@@ -212,8 +241,17 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
-  drv->ni_tail = drv->ni_head;
-  drv->ni_read = drv->ni_head;
+  FAR struct noteram_ring_s *ring;
+  int i;
+
+  /* The notes are removed by the writer when it finds them cleared */
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      ring = &drv->ni_ring[i];
+      ring->nr_start = ring->nr_wpos;
+      ring->nr_rpos = ring->nr_start;
+    }
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -250,30 +288,27 @@ static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
 }
 
 /****************************************************************************
- * Name: noteram_length
+ * Name: noteram_ring_buffer
+ ****************************************************************************/
+
+static inline FAR uint8_t *
+noteram_ring_buffer(FAR struct noteram_driver_s *drv,
+                    FAR struct noteram_ring_s *ring)
+{
+  return drv->ni_buffer + (ring - drv->ni_ring) * drv->ni_bufsize;
+}
+
+/****************************************************************************
+ * Name: noteram_ring_overflow
  *
  * Description:
- *   Length of data currently in circular buffer.
- *
- * Input Parameters:
- *   None
- *
- * Returned Value:
- *   Length of data currently in circular buffer.
+ *   Return true if the ring stopped recording and was not cleared since.
  *
  ****************************************************************************/
 
-static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
+static inline bool noteram_ring_overflow(FAR struct noteram_ring_s *ring)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int tail = drv->ni_tail;
-
-  if (tail > head)
-    {
-      head += drv->ni_bufsize;
-    }
-
-  return head - tail;
+  return ring->nr_overflow && ring->nr_ovfstart == ring->nr_start;
 }
 
 /****************************************************************************
@@ -292,15 +327,26 @@ static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
 
 static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int read = drv->ni_read;
-
-  if (read > head)
+  FAR struct noteram_ring_s *ring;
+  unsigned int length = 0;
+  uint32_t wpos;
+  uint32_t used;
+  uint32_t left;
+  int i;
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
     {
-      head += drv->ni_bufsize;
+      ring = &drv->ni_ring[i];
+      wpos = ring->nr_wpos;
+      used = wpos - ring->nr_tpos;
+      left = wpos - ring->nr_rpos;
+
+      /* The read position is behind the oldest note if it was overwritten */
+
+      length += left < used ? left : used;
     }
 
-  return head - read;
+  return length;
 }
 
 /****************************************************************************
@@ -316,44 +362,125 @@ static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   We are the writer of the ring.
  *
  ****************************************************************************/
 
-static void noteram_remove(FAR struct noteram_driver_s *drv)
+static void noteram_remove(FAR struct noteram_driver_s *drv,
+                           FAR struct noteram_ring_s *ring)
 {
   unsigned int tail;
   unsigned int length;
 
   /* Get the tail index of the circular buffer */
 
-  tail = drv->ni_tail;
+  tail = ring->nr_tail;
   DEBUGASSERT(tail < drv->ni_bufsize);
 
   /* Get the length of the note at the tail index */
 
-  length = NOTE_ALIGN(drv->ni_buffer[tail]);
-  DEBUGASSERT(length <= noteram_length(drv));
+  length = NOTE_ALIGN(noteram_ring_buffer(drv, ring)[tail]);
+  DEBUGASSERT(length <= ring->nr_wpos - ring->nr_tpos);
 
   /* Increment the tail index to remove the entire note from the circular
-   * buffer.
+   * buffer.  A reader behind it finds its position invalid.
    */
 
-  if (drv->ni_read == drv->ni_tail)
+  ring->nr_tail = noteram_next(drv, tail, length);
+  ring->nr_tpos += length;
+}
+
+/****************************************************************************
+ * Name: noteram_ring_read
+ *
+ * Description:
+ *   Copy up to buflen bytes of the next note to read from one ring, and
+ *   optionally remove it from the unread notes.
+ *
+ * Returned Value:
+ *   The length of the note, which may be larger than buflen.  Zero is
+ *   returned only if the ring has no unread note.
+ *
+ ****************************************************************************/
+
+static size_t noteram_ring_read(FAR struct noteram_driver_s *drv,
+                                FAR struct noteram_ring_s *ring,
+                                FAR uint8_t *buffer, size_t buflen,
+                                bool consume)
+{
+  FAR uint8_t *base = noteram_ring_buffer(drv, ring);
+  unsigned int seq;
+  unsigned int read;
+  unsigned int space;
+  uint32_t rpos;
+  uint32_t wpos;
+  size_t notelen;
+  size_t copylen;
+
+  for (; ; )
     {
-      /* The read index also needs increment. */
+      seq = ring->nr_seq;
+      if ((seq & 1) != 0)
+        {
+          continue;
+        }
 
-      drv->ni_read = noteram_next(drv, tail, length);
+      SMP_RMB();
+
+      /* Restart from the oldest note if the next one was overwritten */
+
+      rpos = ring->nr_rpos;
+      wpos = ring->nr_wpos;
+      if (wpos - rpos > wpos - ring->nr_tpos)
+        {
+          rpos = ring->nr_tpos;
+        }
+
+      if (rpos == wpos)
+        {
+          notelen = 0;
+          break;
+        }
+
+      /* Copy the note at the read index, handling wraparound */
+
+      read = noteram_next(drv, ring->nr_tail, rpos - ring->nr_tpos);
+      notelen = base[read];
+      copylen = notelen < buflen ? notelen : buflen;
+      space = drv->ni_bufsize - read;
+      space = space < copylen ? space : copylen;
+      memcpy(buffer, base + read, space);
+      memcpy(buffer + space, base, copylen - space);
+
+      /* The copy is valid if the writer has not moved notes meanwhile */
+
+      SMP_RMB();
+      if (ring->nr_seq == seq)
+        {
+          break;
+        }
     }
 
-  drv->ni_tail = noteram_next(drv, tail, length);
+  DEBUGASSERT(notelen <= wpos - rpos);
+
+  if (consume)
+    {
+      ring->nr_rpos = rpos + NOTE_ALIGN(notelen);
+    }
+  else
+    {
+      ring->nr_rpos = rpos;
+    }
+
+  return notelen;
 }
 
 /****************************************************************************
  * Name: noteram_get
  *
  * Description:
- *   Get the next note from the read index of the circular buffer.
+ *   Get the next note from the read index of the circular buffer.  With
+ *   per-CPU buffers, the oldest of the next notes of all CPUs is returned.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -369,63 +496,48 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
 static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
                            FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
-  unsigned int remaining;
-  unsigned int read;
-  ssize_t notelen;
-  size_t circlen;
+  FAR struct noteram_ring_s *ring = &drv->ni_ring[0];
+  size_t notelen;
+#if NOTERAM_NRINGS > 1
+  struct note_common_s note;
+  clock_t systime = 0;
+  int i;
+#endif
 
   DEBUGASSERT(buffer != NULL);
 
-  /* Verify that the circular buffer is not empty */
+#if NOTERAM_NRINGS > 1
+  /* Merge the rings by the time of the notes */
 
-  circlen = noteram_unread_length(drv);
-  if (circlen <= 0)
+  ring = NULL;
+  for (i = 0; i < NOTERAM_NRINGS; i++)
     {
-      return 0;
+      if (noteram_ring_read(drv, &drv->ni_ring[i], (FAR uint8_t *)&note,
+                            sizeof(note), false) > 0 &&
+          (ring == NULL || (sclock_t)(note.nc_systime - systime) < 0))
+        {
+          ring = &drv->ni_ring[i];
+          systime = note.nc_systime;
+        }
     }
 
-  /* Get the read index of the circular buffer */
-
-  read = drv->ni_read;
-  DEBUGASSERT(read < drv->ni_bufsize);
-
-  /* Get the length of the note at the read index */
+  if (ring == NULL)
+    {
+      return 0;
+    }
+#endif
 
-  note = (FAR struct note_common_s *)&drv->ni_buffer[read];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  notelen = noteram_ring_read(drv, ring, buffer, buflen, true);
 
-  /* Is the user buffer large enough to hold the note? */
+  /* Is the user buffer large enough to hold the note?  The large note is
+   * skipped so that we do not get constipated.
+   */
 
   if (buflen < notelen)
     {
-      /* Skip the large note so that we do not get constipated. */
-
-      drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
-
-      /* and return an error */
-
       return -EFBIG;
     }
 
-  /* Loop until the note has been transferred to the user buffer */
-
-  remaining = (unsigned int)notelen;
-  while (remaining > 0)
-    {
-      /* Copy the next byte at the read index */
-
-      *buffer++ = drv->ni_buffer[read];
-
-      /* Adjust indices and counts */
-
-      read = noteram_next(drv, read, 1);
-      remaining--;
-    }
-
-  drv->ni_read = noteram_next(drv, drv->ni_read, NOTE_ALIGN(notelen));
-
   return notelen;
 }
 
@@ -439,9 +551,15 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
 
+  int i;
+
   /* Reset the read index of the circular buffer */
 
-  drv->ni_read = drv->ni_tail;
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      drv->ni_ring[i].nr_rpos = drv->ni_ring[i].nr_start;
+    }
+
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -547,7 +665,19 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           }
         else
           {
+            int i;
+
             *(FAR unsigned int *)arg = drv->ni_overwrite;
+            for (i = 0; i < NOTERAM_NRINGS; i++)
+              {
+                if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE &&
+                    noteram_ring_overflow(&drv->ni_ring[i]))
+                  {
+                    *(FAR unsigned int *)arg =
+                      NOTERAM_MODE_OVERWRITE_OVERFLOW;
+                  }
+              }
+
             ret = OK;
           }
         break;
@@ -711,9 +841,6 @@ errout:
  * Returned Value:
  *   None
  *
- * Assumptions:
- *   We are within a critical section.
- *
  ****************************************************************************/
 
 static void noteram_add(FAR struct note_driver_s *driver,
@@ -721,51 +848,82 @@ static void noteram_add(FAR struct note_driver_s *driver,
 {
   FAR const char *buf = note;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *base;
   unsigned int head;
-  unsigned int remain;
   unsigned int space;
+  uint32_t start;
+  uint32_t used;
   irqstate_t flags;
 
+  /* Only the interrupts of this CPU can add notes to its own ring */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  flags = up_irq_save();
+  ring = &drv->ni_ring[this_cpu()];
+#else
   flags = spin_lock_irqsave_notrace(&drv->lock);
+  ring = &drv->ni_ring[0];
+#endif
 
-  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW ||
+      noteram_ring_overflow(ring))
     {
-      spin_unlock_irqrestore_notrace(&drv->lock, flags);
-      return;
+      goto out;
     }
 
   DEBUGASSERT(note != NULL && notelen < drv->ni_bufsize);
-  remain = drv->ni_bufsize - noteram_length(drv);
 
-  if (remain <= NOTE_ALIGN(notelen))
+  /* The cleared notes do not take space */
+
+  start = ring->nr_start;
+  used = ring->nr_wpos - ring->nr_tpos;
+  if ((int32_t)(start - ring->nr_tpos) > 0)
     {
-      if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
-        {
-          /* Stop recording if not in overwrite mode */
+      used = ring->nr_wpos - start;
+    }
 
-          drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-          spin_unlock_irqrestore_notrace(&drv->lock, flags);
-          return;
-        }
+  if (drv->ni_bufsize - used <= NOTE_ALIGN(notelen) &&
+      drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
+    {
+      /* Stop recording if not in overwrite mode */
 
-      /* Remove the note at the tail index , make sure there is enough space
-       */
+      ring->nr_ovfstart = start;
+      ring->nr_overflow = true;
+      goto out;
+    }
 
-      do
-        {
-          noteram_remove(drv);
-          remain = drv->ni_bufsize - noteram_length(drv);
-        }
-      while (remain <= NOTE_ALIGN(notelen));
+  ring->nr_seq++;
+  SMP_WMB();
+
+  /* Remove the cleared notes and the notes at the tail index, make sure
+   * there is enough space
+   */
+
+  while ((int32_t)(start - ring->nr_tpos) > 0 ||
+         drv->ni_bufsize - (ring->nr_wpos - ring->nr_tpos) <=
+         NOTE_ALIGN(notelen))
+    {
+      noteram_remove(drv, ring);
     }
 
-  head = drv->ni_head;
+  base = noteram_ring_buffer(drv, ring);
+  head = noteram_next(drv, ring->nr_tail, ring->nr_wpos - ring->nr_tpos);
   space = drv->ni_bufsize - head;
   space = space < notelen ? space : notelen;
-  memcpy(drv->ni_buffer + head, note, space);
-  memcpy(drv->ni_buffer, buf + space, notelen - space);
-  drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
+  memcpy(base + head, note, space);
+  memcpy(base, buf + space, notelen - space);
+
+  SMP_WMB();
+  ring->nr_wpos += NOTE_ALIGN(notelen);
+  ring->nr_seq++;
+
+out:
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  up_irq_restore(flags);
+#else
   spin_unlock_irqrestore_notrace(&drv->lock, flags);
+#endif
 
   if (drv->pfd && (noteram_unread_length(drv) >= drv->threshold))
     {
@@ -1417,12 +1575,10 @@ noteram_initialize(FAR const char *devpath, size_t bufsize,
 #endif
 
   drv->driver.ops = &g_noteram_ops;
-  drv->ni_bufsize = bufsize;
+  drv->ni_bufsize = NOTERAM_RING_SIZE(bufsize);
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
-  drv->ni_head = 0;
-  drv->ni_tail = 0;
-  drv->ni_read = 0;
+  memset(drv->ni_ring, 0, sizeof(drv->ni_ring));
   drv->pfd = NULL;
 
   ret = note_driver_register(&drv->driver);
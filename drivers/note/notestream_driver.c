@@ -24,16 +24,94 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdarg.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched_note.h>
 #include <nuttx/note/notestream_driver.h>
 
+#if defined(CONFIG_DRIVERS_NOTESTREAM_PERFETTO) && \
+    defined(CONFIG_SCHED_INSTRUMENTATION_SYSCALL)
+#  ifdef CONFIG_LIB_SYSCALL
+#    include <syscall.h>
+#  else
+#    define CONFIG_LIB_SYSCALL
+#    include <syscall.h>
+#    undef CONFIG_LIB_SYSCALL
+#  endif
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+
+/* The protobuf fields of the Perfetto trace messages used here */
+
+#define PERFETTO_TRACE_PACKET             1  /* Trace.packet */
+#define PERFETTO_PACKET_FTRACE_EVENTS     1  /* TracePacket.ftrace_events */
+#define PERFETTO_BUNDLE_CPU               1  /* FtraceEventBundle.cpu */
+#define PERFETTO_BUNDLE_EVENT             2  /* FtraceEventBundle.event */
+#define PERFETTO_EVENT_TIMESTAMP          1  /* FtraceEvent.timestamp */
+#define PERFETTO_EVENT_PID                2  /* FtraceEvent.pid */
+#define PERFETTO_EVENT_PRINT              3  /* FtraceEvent.print */
+#define PERFETTO_EVENT_SCHED_SWITCH       4  /* FtraceEvent.sched_switch */
+#define PERFETTO_PRINT_IP                 1  /* PrintFtraceEvent.ip */
+#define PERFETTO_PRINT_BUF                2  /* PrintFtraceEvent.buf */
+#define PERFETTO_SWITCH_PREV_COMM         1  /* SchedSwitchFtraceEvent */
+#define PERFETTO_SWITCH_PREV_PID          2
+#define PERFETTO_SWITCH_PREV_PRIO         3
+#define PERFETTO_SWITCH_PREV_STATE        4
+#define PERFETTO_SWITCH_NEXT_COMM         5
+#define PERFETTO_SWITCH_NEXT_PID          6
+#define PERFETTO_SWITCH_NEXT_PRIO         7
+
+#define PERFETTO_WIRE_VARINT              0
+#define PERFETTO_WIRE_LENGTH              2
+
+/* The linux prev_state values of a switched out task */
+
+#define PERFETTO_STATE_RUNNING            0x00
+#define PERFETTO_STATE_SLEEPING           0x01
+#define PERFETTO_STATE_DEAD               0x10
+
+#if CONFIG_TASK_NAME_SIZE > 0
+#  define PERFETTO_NAME_SIZE              (CONFIG_TASK_NAME_SIZE + 1)
+#else
+#  define PERFETTO_NAME_SIZE              16
+#endif
+
+/* A packet is encoded in a buffer of the stack, a note is at most 255
+ * bytes and the switch event adds two task names.
+ */
+
+#define PERFETTO_PACKET_SIZE              (288 + 2 * PERFETTO_NAME_SIZE)
+
+#define perfetto_pid(pid) ((pid) < CONFIG_SMP_NCPUS ? 0 : (pid))
+
+#endif /* CONFIG_DRIVERS_NOTESTREAM_PERFETTO */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+/* A packet under construction */
+
+struct perfetto_buf_s
+{
+  size_t len;
+  bool overflow;
+  uint8_t data[PERFETTO_PACKET_SIZE];
+};
+#endif
+
 #ifdef CONFIG_DRIVERS_NOTEFILE
 struct notestream_file_s
 {
@@ -87,12 +165,438 @@ struct notestream_driver_s g_notestream_lowerout =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+
+/****************************************************************************
+ * Name: perfetto_varint
+ ****************************************************************************/
+
+static void perfetto_varint(FAR struct perfetto_buf_s *pb, uint64_t value)
+{
+  do
+    {
+      if (pb->len >= sizeof(pb->data))
+        {
+          pb->overflow = true;
+          return;
+        }
+
+      pb->data[pb->len++] = (value & 0x7f) | (value > 0x7f ? 0x80 : 0);
+      value >>= 7;
+    }
+  while (value != 0);
+}
+
+/****************************************************************************
+ * Name: perfetto_uint
+ ****************************************************************************/
+
+static void perfetto_uint(FAR struct perfetto_buf_s *pb, int field,
+                          uint64_t value)
+{
+  perfetto_varint(pb, (field << 3) | PERFETTO_WIRE_VARINT);
+  perfetto_varint(pb, value);
+}
+
+/****************************************************************************
+ * Name: perfetto_string
+ ****************************************************************************/
+
+static void perfetto_string(FAR struct perfetto_buf_s *pb, int field,
+                            FAR const char *str, size_t len)
+{
+  perfetto_varint(pb, (field << 3) | PERFETTO_WIRE_LENGTH);
+  perfetto_varint(pb, len);
+  if (len > sizeof(pb->data) - pb->len)
+    {
+      pb->overflow = true;
+      return;
+    }
+
+  memcpy(pb->data + pb->len, str, len);
+  pb->len += len;
+}
+
+/****************************************************************************
+ * Name: perfetto_begin
+ *
+ * Description:
+ *   Start a nested message.  Its length is not known yet, so two bytes are
+ *   reserved for it as a redundant varint, like the Perfetto encoder does.
+ *
+ ****************************************************************************/
+
+static size_t perfetto_begin(FAR struct perfetto_buf_s *pb, int field)
+{
+  size_t offset;
+
+  perfetto_varint(pb, (field << 3) | PERFETTO_WIRE_LENGTH);
+  offset = pb->len;
+  perfetto_varint(pb, 0);
+  perfetto_varint(pb, 0);
+  return offset;
+}
+
+/****************************************************************************
+ * Name: perfetto_end
+ ****************************************************************************/
+
+static void perfetto_end(FAR struct perfetto_buf_s *pb, size_t offset)
+{
+  size_t len = pb->len - offset - 2;
+
+  if (!pb->overflow)
+    {
+      pb->data[offset]     = 0x80 | (len & 0x7f);
+      pb->data[offset + 1] = len >> 7;
+    }
+}
+
+/****************************************************************************
+ * Name: perfetto_state
+ ****************************************************************************/
+
+static uint64_t perfetto_state(uint8_t state)
+{
+  if (state == 0)
+    {
+      return PERFETTO_STATE_DEAD;
+    }
+  else if (state <= LAST_READY_TO_RUN_STATE)
+    {
+      return PERFETTO_STATE_RUNNING;
+    }
+
+  return PERFETTO_STATE_SLEEPING;
+}
+
+/****************************************************************************
+ * Name: perfetto_sched_switch
+ ****************************************************************************/
+
+static void perfetto_sched_switch(FAR struct perfetto_buf_s *pb,
+                                  FAR struct notestream_cpu_s *cctx)
+{
+  char name[PERFETTO_NAME_SIZE];
+  size_t offset;
+
+  offset = perfetto_begin(pb, PERFETTO_EVENT_SCHED_SWITCH);
+  note_get_taskname(cctx->current_pid, name, sizeof(name));
+  perfetto_string(pb, PERFETTO_SWITCH_PREV_COMM, name, strlen(name));
+  perfetto_uint(pb, PERFETTO_SWITCH_PREV_PID,
+                perfetto_pid(cctx->current_pid));
+  perfetto_uint(pb, PERFETTO_SWITCH_PREV_PRIO, cctx->current_priority);
+  perfetto_uint(pb, PERFETTO_SWITCH_PREV_STATE,
+                perfetto_state(cctx->current_state));
+  note_get_taskname(cctx->next_pid, name, sizeof(name));
+  perfetto_string(pb, PERFETTO_SWITCH_NEXT_COMM, name, strlen(name));
+  perfetto_uint(pb, PERFETTO_SWITCH_NEXT_PID, perfetto_pid(cctx->next_pid));
+  perfetto_uint(pb, PERFETTO_SWITCH_NEXT_PRIO, cctx->next_priority);
+  perfetto_end(pb, offset);
+
+  cctx->current_pid      = cctx->next_pid;
+  cctx->current_priority = cctx->next_priority;
+  cctx->current_state    = TSTATE_TASK_READYTORUN;
+  cctx->pendingswitch    = false;
+}
+
+/****************************************************************************
+ * Name: perfetto_print
+ *
+ * Description:
+ *   Add an atrace formatted print event, which the trace viewers turn into
+ *   slices, instants and counters of the task.  The text is formatted in
+ *   place in the packet.
+ *
+ ****************************************************************************/
+
+static void perfetto_print(FAR struct perfetto_buf_s *pb, uintptr_t ip,
+                           FAR const char *fmt, ...)
+{
+  size_t offset;
+  size_t str;
+  size_t space;
+  va_list ap;
+  int len;
+
+  offset = perfetto_begin(pb, PERFETTO_EVENT_PRINT);
+  perfetto_uint(pb, PERFETTO_PRINT_IP, ip);
+  str = perfetto_begin(pb, PERFETTO_PRINT_BUF);
+  if (pb->overflow)
+    {
+      return;
+    }
+
+  space = sizeof(pb->data) - pb->len;
+  va_start(ap, fmt);
+  len = vsnprintf((FAR char *)pb->data + pb->len, space, fmt, ap);
+  va_end(ap);
+
+  if (len < 0 || (size_t)len >= space)
+    {
+      pb->overflow = true;
+      return;
+    }
+
+  pb->len += len;
+  perfetto_end(pb, str);
+  perfetto_end(pb, offset);
+}
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+/****************************************************************************
+ * Name: perfetto_printf
+ *
+ * Description:
+ *   Add the text of a NOTE_DUMP_PRINTF note as a print event.
+ *
+ ****************************************************************************/
+
+static void perfetto_printf(FAR struct perfetto_buf_s *pb,
+                            FAR const struct note_printf_s *npt)
+{
+  struct lib_memoutstream_s stream;
+  size_t offset;
+  size_t str;
+
+  offset = perfetto_begin(pb, PERFETTO_EVENT_PRINT);
+  perfetto_uint(pb, PERFETTO_PRINT_IP, npt->npt_ip);
+  str = perfetto_begin(pb, PERFETTO_PRINT_BUF);
+  if (pb->overflow)
+    {
+      return;
+    }
+
+  lib_memoutstream(&stream, (FAR char *)pb->data + pb->len,
+                   sizeof(pb->data) - pb->len);
+  lib_bsprintf(&stream.common, npt->npt_fmt, (FAR void *)npt->npt_data);
+  pb->len += stream.common.nput;
+  perfetto_end(pb, str);
+  perfetto_end(pb, offset);
+}
+#endif
+
+/****************************************************************************
+ * Name: perfetto_event
+ *
+ * Description:
+ *   Encode the payload of the ftrace event of one note.
+ *
+ * Returned Value:
+ *   True if the note produced an event.
+ *
+ ****************************************************************************/
+
+static bool perfetto_event(FAR struct perfetto_buf_s *pb,
+                           FAR struct notestream_cpu_s *cctx,
+                           FAR const struct note_common_s *note)
+{
+  pid_t pid = perfetto_pid(note->nc_pid);
+  size_t len = pb->len;
+
+  switch (note->nc_type)
+    {
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
+      case NOTE_STOP:
+        cctx->current_state = 0;
+        break;
+
+      case NOTE_SUSPEND:
+        cctx->current_state =
+          ((FAR const struct note_suspend_s *)note)->nsu_state;
+        break;
+
+      case NOTE_RESUME:
+        cctx->next_pid = note->nc_pid;
+        cctx->next_priority = note->nc_priority;
+
+        /* In an interrupt handler, the switch happens when it leaves */
+
+        if (cctx->intr_nest == 0)
+          {
+            perfetto_sched_switch(pb, cctx);
+          }
+        else
+          {
+            cctx->pendingswitch = true;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+      case NOTE_IRQ_ENTER:
+        {
+          FAR const struct note_irqhandler_s *nih = (FAR const void *)note;
+
+          perfetto_print(pb, nih->nih_handler, "B|%d|irq_%u", pid,
+                         nih->nih_irq);
+          cctx->intr_nest++;
+        }
+        break;
+
+      case NOTE_IRQ_LEAVE:
+        perfetto_print(pb, 0, "E|%d", pid);
+        if (cctx->intr_nest > 0 && --cctx->intr_nest == 0 &&
+            cctx->pendingswitch)
+          {
+            perfetto_sched_switch(pb, cctx);
+          }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
+      case NOTE_SYSCALL_ENTER:
+        {
+          FAR const struct note_syscall_enter_s *nsc =
+            (FAR const void *)note;
+
+          if (nsc->nsc_nr >= CONFIG_SYS_RESERVED &&
+              nsc->nsc_nr < SYS_maxsyscall)
+            {
+              perfetto_print(pb, 0, "B|%d|sys_%s", pid,
+                             g_funcnames[nsc->nsc_nr - CONFIG_SYS_RESERVED]);
+            }
+        }
+        break;
+
+      case NOTE_SYSCALL_LEAVE:
+        {
+          FAR const struct note_syscall_leave_s *nsc =
+            (FAR const void *)note;
+
+          if (nsc->nsc_nr >= CONFIG_SYS_RESERVED &&
+              nsc->nsc_nr < SYS_maxsyscall)
+            {
+              perfetto_print(pb, 0, "E|%d", pid);
+            }
+        }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+      case NOTE_DUMP_PRINTF:
+        {
+          FAR const struct note_printf_s *npt = (FAR const void *)note;
+
+          if (npt->npt_type != 0)
+            {
+              perfetto_print(pb, npt->npt_ip, "I|%d|%p", pid, npt->npt_fmt);
+            }
+          else
+            {
+              perfetto_printf(pb, npt);
+            }
+        }
+        break;
+
+      case NOTE_DUMP_BEGIN:
+      case NOTE_DUMP_END:
+      case NOTE_DUMP_MARK:
+        {
+          FAR const struct note_event_s *nev = (FAR const void *)note;
+          int len = note->nc_length - SIZEOF_NOTE_EVENT(0);
+          char c = note->nc_type == NOTE_DUMP_BEGIN ? 'B' :
+                   note->nc_type == NOTE_DUMP_END ? 'E' : 'I';
+
+          if (len > 0)
+            {
+              perfetto_print(pb, nev->nev_ip, "%c|%d|%.*s", c, pid, len,
+                             (FAR const char *)nev->nev_data);
+            }
+          else
+            {
+              perfetto_print(pb, nev->nev_ip, "%c|%d|%p", c, pid,
+                             (FAR void *)nev->nev_ip);
+            }
+        }
+        break;
+
+      case NOTE_DUMP_COUNTER:
+        {
+          FAR const struct note_event_s *nev = (FAR const void *)note;
+          FAR const struct note_counter_s *counter =
+            (FAR const void *)nev->nev_data;
+
+          perfetto_print(pb, nev->nev_ip, "C|%d|%s|%ld", pid,
+                         counter->name, counter->value);
+        }
+        break;
+#endif
+
+      default:
+        perfetto_print(pb, 0, "I|%d|note_%u", pid, note->nc_type);
+        break;
+    }
+
+  return pb->len != len;
+}
+
+/****************************************************************************
+ * Name: notestream_perfetto
+ *
+ * Description:
+ *   Send one note as a Perfetto TracePacket holding one ftrace event.  The
+ *   stream of packets is a valid Perfetto trace at any point.
+ *
+ ****************************************************************************/
+
+static void notestream_perfetto(FAR struct notestream_driver_s *drv,
+                                FAR const struct note_common_s *note)
+{
+  struct perfetto_buf_s pb;
+  FAR struct notestream_cpu_s *cctx;
+  struct timespec ts;
+  size_t packet;
+  size_t bundle;
+  size_t event;
+#ifdef CONFIG_SMP
+  int cpu = note->nc_cpu;
+#else
+  int cpu = 0;
+#endif
+
+  cctx = &drv->cpu[cpu];
+  if (!cctx->valid)
+    {
+      cctx->current_pid = note->nc_pid;
+      cctx->current_priority = note->nc_priority;
+      cctx->valid = true;
+    }
+
+  perf_convert(note->nc_systime, &ts);
+
+  pb.len = 0;
+  pb.overflow = false;
+  packet = perfetto_begin(&pb, PERFETTO_TRACE_PACKET);
+  bundle = perfetto_begin(&pb, PERFETTO_PACKET_FTRACE_EVENTS);
+  perfetto_uint(&pb, PERFETTO_BUNDLE_CPU, cpu);
+  event = perfetto_begin(&pb, PERFETTO_BUNDLE_EVENT);
+  perfetto_uint(&pb, PERFETTO_EVENT_TIMESTAMP,
+                (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec);
+  perfetto_uint(&pb, PERFETTO_EVENT_PID, perfetto_pid(note->nc_pid));
+
+  if (!perfetto_event(&pb, cctx, note) || pb.overflow)
+    {
+      return;
+    }
+
+  perfetto_end(&pb, event);
+  perfetto_end(&pb, bundle);
+  perfetto_end(&pb, packet);
+  lib_stream_puts(drv->stream, pb.data, pb.len);
+}
+#endif /* CONFIG_DRIVERS_NOTESTREAM_PERFETTO */
+
 static void notestream_add(FAR struct note_driver_s *drv,
                            FAR const void *note, size_t len)
 {
   FAR struct notestream_driver_s *drivers =
       (FAR struct notestream_driver_s *)drv;
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+  notestream_perfetto(drivers, note);
+#else
   lib_stream_puts(drivers->stream, note, len);
+#endif
 }
 
 /****************************************************************************
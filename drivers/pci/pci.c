@@ -29,8 +29,10 @@
 #include <debug.h>
 #include <sys/pciio.h>
 #include <sys/endian.h>
+#include <sys/param.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/pci/pci.h>
 
@@ -1353,28 +1355,20 @@ static void pci_disable_msix(FAR struct pci_device_s *dev, uint8_t msix,
  *
  ****************************************************************************/
 
-static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
-                           int num, uint8_t msix)
+static uintptr_t pci_msix_table(FAR struct pci_device_s *dev, uint8_t msix,
+                                FAR uint16_t *tblsize)
 {
-  uint32_t  mdr       = 0;
-  uint16_t  flags     = 0;
-  uintptr_t mar       = 0;
   uintptr_t tbladdr   = 0;
   uintptr_t tblend    = 0;
   uint32_t  tbloffset = 0;
   uint32_t  tblbar    = 0;
   uint32_t  tbl       = 0;
-  uint16_t  tblsize   = 0;
-  int       i         = 0;
-  int       ret       = OK;
-
-  /* Get Flags */
-
-  pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+  uint16_t  flags     = 0;
 
   /* Table Size is N - 1 encoded */
 
-  tblsize = (flags & PCI_MSIX_FLAGS_QSIZE) + 1;
+  pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+  *tblsize = (flags & PCI_MSIX_FLAGS_QSIZE) + 1;
 
   /* Get MSI-X table */
 
@@ -1389,13 +1383,35 @@ static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
 
   /* Map MSI-X table */
 
-  tblend = tbladdr + tblsize * PCI_MSIX_ENTRY_SIZE;
+  tblend = tbladdr + *tblsize * PCI_MSIX_ENTRY_SIZE;
 
   if (dev->bus->ctrl->ops->map)
     {
       tbladdr = dev->bus->ctrl->ops->map(dev->bus, tbladdr, tblend);
     }
 
+  return tbladdr;
+}
+
+static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
+                           int num, uint8_t msix)
+{
+  uint32_t  mdr       = 0;
+  uint16_t  flags     = 0;
+  uintptr_t mar       = 0;
+  uintptr_t tbladdr   = 0;
+  uint16_t  tblsize   = 0;
+  int       i         = 0;
+  int       ret       = OK;
+
+  /* Get Flags */
+
+  pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+
+  /* Get the mapped MSI-X table */
+
+  tbladdr = pci_msix_table(dev, msix, &tblsize);
+
   /* Limit tblsize */
 
   if (num > tblsize)
@@ -2035,6 +2051,214 @@ int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num)
     }
 }
 
+/****************************************************************************
+ * Name: pci_alloc_irq_vectors
+ *
+ * Description:
+ *   Allocate and connect between min_vecs and max_vecs interrupt vectors,
+ *   trying MSI-X, then MSI, then INTx as allowed by flags.
+ *
+ * Input Parameters:
+ *   dev      - PCI device
+ *   irq      - allocated vectors, at least max_vecs entries
+ *   min_vecs - minimum number of vectors required
+ *   max_vecs - maximum number of vectors wanted
+ *   flags    - PCI_IRQ_* flags
+ *
+ * Return value:
+ *   Return the number of vectors on success or a negated errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_alloc_irq_vectors(FAR struct pci_device_s *dev, FAR int *irq,
+                          int min_vecs, int max_vecs, unsigned int flags)
+{
+  uint8_t msi = 0;
+  uint8_t msix = 0;
+  int num;
+  int ret;
+
+  if (min_vecs < 1 || max_vecs < min_vecs ||
+      dev->bus->ctrl->ops->alloc_irq == NULL ||
+      dev->bus->ctrl->ops->release_irq == NULL)
+    {
+      return -EINVAL;
+    }
+
+  pci_get_msi_base(dev, &msi, &msix);
+  if (dev->bus->ctrl->ops->connect_irq == NULL)
+    {
+      msi = 0;
+      msix = 0;
+    }
+
+#ifdef CONFIG_PCI_MSIX
+  if ((flags & PCI_IRQ_MSIX) != 0 && msix != 0)
+    {
+      uint16_t tblsize;
+
+      pci_msix_table(dev, msix, &tblsize);
+      num = MIN(max_vecs, tblsize);
+      num = num >= min_vecs ? pci_alloc_irq(dev, irq, num) : 0;
+      if (num >= min_vecs)
+        {
+          if (msi != 0)
+            {
+              pci_disable_msi(dev, msi);
+            }
+
+          ret = pci_enable_msix(dev, irq, num, msix);
+          if (ret >= 0)
+            {
+              goto affinity;
+            }
+
+          pci_disable_msix(dev, msix, num);
+        }
+
+      if (num > 0)
+        {
+          dev->bus->ctrl->ops->release_irq(dev->bus, irq, num);
+        }
+    }
+#endif
+
+  if ((flags & PCI_IRQ_MSI) != 0 && msi != 0 && min_vecs == 1)
+    {
+      /* Multiple message MSI needs contiguous aligned vectors, only use
+       * one.
+       */
+
+      num = 1;
+      ret = pci_alloc_irq(dev, irq, num);
+      if (ret == num)
+        {
+          ret = pci_enable_msi(dev, irq, num, msi);
+          if (ret >= 0)
+            {
+              goto affinity;
+            }
+
+          dev->bus->ctrl->ops->release_irq(dev->bus, irq, 1);
+        }
+    }
+
+  if ((flags & PCI_IRQ_INTX) != 0 && min_vecs == 1)
+    {
+      ret = pci_get_irq(dev);
+      if (ret >= 0)
+        {
+          irq[0] = ret;
+          return 1;
+        }
+    }
+
+  return -ENOSPC;
+
+affinity:
+#ifdef CONFIG_IRQ_AFFINITY
+  if ((flags & PCI_IRQ_AFFINITY) != 0)
+    {
+      cpu_set_t cpuset;
+      int i;
+
+      for (i = 0; i < num; i++)
+        {
+          CPU_ZERO(&cpuset);
+          CPU_SET(i % CONFIG_SMP_NCPUS, &cpuset);
+          irq_set_affinity(irq[i], cpuset);
+        }
+    }
+#endif
+
+  return num;
+}
+
+/****************************************************************************
+ * Name: pci_free_irq_vectors
+ *
+ * Description:
+ *   Disable MSI/MSI-X and release the vectors of pci_alloc_irq_vectors().
+ *
+ * Input Parameters:
+ *   dev - PCI device
+ *   irq - allocated vectors
+ *   num - number of vectors
+ *
+ ****************************************************************************/
+
+void pci_free_irq_vectors(FAR struct pci_device_s *dev, FAR int *irq,
+                          int num)
+{
+  uint16_t flags = 0;
+  uint8_t msi = 0;
+  uint8_t msix = 0;
+  bool enabled = false;
+
+  /* Nothing to release for INTx */
+
+  pci_get_msi_base(dev, &msi, &msix);
+  if (msi != 0)
+    {
+      pci_read_config_word(dev, msi + PCI_MSI_FLAGS, &flags);
+      enabled |= (flags & PCI_MSI_FLAGS_ENABLE) != 0;
+    }
+
+  if (msix != 0)
+    {
+      pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+      enabled |= (flags & PCI_MSIX_FLAGS_ENABLE) != 0;
+    }
+
+  if (enabled)
+    {
+      pci_release_irq(dev, irq, num);
+    }
+}
+
+#ifdef CONFIG_PCI_MSIX
+/****************************************************************************
+ * Name: pci_msix_mask_irq
+ *
+ * Description:
+ *   Mask or unmask one MSI-X vector at the device.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - MSI-X table entry
+ *   mask  - true to mask, false to unmask
+ *
+ * Return value:
+ *   OK on success or a negated errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_msix_mask_irq(FAR struct pci_device_s *dev, int index, bool mask)
+{
+  uintptr_t tbladdr;
+  uint16_t tblsize;
+  uint8_t msix = 0;
+
+  pci_get_msi_base(dev, NULL, &msix);
+  if (msix == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  tbladdr = pci_msix_table(dev, msix, &tblsize);
+  if (index < 0 || index >= tblsize || tbladdr == 0)
+    {
+      return -EINVAL;
+    }
+
+  tbladdr += index * PCI_MSIX_ENTRY_SIZE;
+  pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_VECTOR_CTRL,
+                       mask ? PCI_MSIX_ENTRY_CTRL_MASKBIT : 0);
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: pci_register_driver
  *
@@ -31,6 +31,7 @@
 #include <nuttx/rpmsg/rpmsg_virtio_ivshmem.h>
 #include <nuttx/virtio/virtio-pci.h>
 #include <nuttx/net/e1000.h>
+#include <nuttx/net/ivshmem_net.h>
 #include <nuttx/net/igc.h>
 #include <nuttx/net/igb.h>
 #include <nuttx/can/kvaser_pci.h>
@@ -90,6 +91,14 @@ int pci_register_drivers(void)
     }
 #endif
 
+#ifdef CONFIG_NET_IVSHMEM
+  ret = pci_register_ivshmem_net_driver();
+  if (ret < 0)
+    {
+      pcierr("pci_register_ivshmem_net_driver failed, ret=%d\n", ret);
+    }
+#endif
+
   /* Initialization pci qemu test driver */
 
 #ifdef CONFIG_PCI_QEMU_TEST
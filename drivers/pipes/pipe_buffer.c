@@ -0,0 +1,450 @@
+/****************************************************************************
+ * drivers/pipes/pipe_buffer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "pipe_common.h"
+
+#ifdef CONFIG_DEV_PIPE_PAGED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PIPE_PAGESIZE       CONFIG_DEV_PIPE_PAGESIZE
+#define PIPE_PAGE_ALLOCSIZE (sizeof(struct pipe_page_s) + PIPE_PAGESIZE - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pipebuf_alloc_page
+ ****************************************************************************/
+
+static FAR struct pipe_page_s *pipebuf_alloc_page(FAR pipe_buffer_t *buf)
+{
+  FAR struct pipe_page_s *page = buf->pb_spare;
+
+  if (page != NULL)
+    {
+      buf->pb_spare = NULL;
+    }
+  else
+    {
+      page = kmm_malloc(PIPE_PAGE_ALLOCSIZE);
+      if (page == NULL)
+        {
+          return NULL;
+        }
+    }
+
+  page->pp_next = NULL;
+  page->pp_head = 0;
+  page->pp_tail = 0;
+  return page;
+}
+
+/****************************************************************************
+ * Name: pipebuf_free_page
+ ****************************************************************************/
+
+static void pipebuf_free_page(FAR pipe_buffer_t *buf,
+                              FAR struct pipe_page_s *page)
+{
+  if (buf->pb_spare == NULL)
+    {
+      buf->pb_spare = page;
+    }
+  else
+    {
+      kmm_free(page);
+    }
+}
+
+/****************************************************************************
+ * Name: pipebuf_append_page
+ ****************************************************************************/
+
+static void pipebuf_append_page(FAR pipe_buffer_t *buf,
+                                FAR struct pipe_page_s *page)
+{
+  page->pp_next = NULL;
+  if (buf->pb_last != NULL)
+    {
+      buf->pb_last->pp_next = page;
+    }
+  else
+    {
+      buf->pb_first = page;
+    }
+
+  buf->pb_last = page;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pipebuf_init
+ *
+ * Description:
+ *   Initialize an empty buffer of 'size' bytes.  No page is allocated until
+ *   data is written.
+ *
+ ****************************************************************************/
+
+int pipebuf_init(FAR pipe_buffer_t *buf, size_t size)
+{
+  DEBUGASSERT(buf != NULL && !buf->pb_init);
+
+  buf->pb_first = NULL;
+  buf->pb_last  = NULL;
+  buf->pb_spare = NULL;
+  buf->pb_size  = size;
+  buf->pb_used  = 0;
+  buf->pb_init  = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pipebuf_uninit
+ *
+ * Description:
+ *   Discard the data of the buffer and free all its pages.
+ *
+ ****************************************************************************/
+
+void pipebuf_uninit(FAR pipe_buffer_t *buf)
+{
+  FAR struct pipe_page_s *page;
+
+  while ((page = buf->pb_first) != NULL)
+    {
+      buf->pb_first = page->pp_next;
+      kmm_free(page);
+    }
+
+  if (buf->pb_spare != NULL)
+    {
+      kmm_free(buf->pb_spare);
+    }
+
+  buf->pb_last  = NULL;
+  buf->pb_spare = NULL;
+  buf->pb_used  = 0;
+  buf->pb_init  = false;
+}
+
+/****************************************************************************
+ * Name: pipebuf_resize
+ *
+ * Description:
+ *   Change the capacity of the buffer.  The buffered data is kept, so the
+ *   capacity cannot go below the amount of data in the buffer.
+ *
+ ****************************************************************************/
+
+int pipebuf_resize(FAR pipe_buffer_t *buf, size_t size)
+{
+  if (!buf->pb_init)
+    {
+      return pipebuf_init(buf, size);
+    }
+
+  if (size < buf->pb_used)
+    {
+      return -EBUSY;
+    }
+
+  buf->pb_size = size;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pipebuf_get_writeptr
+ *
+ * Description:
+ *   Return where the next data can be written in place and, in 'size', how
+ *   many bytes can be written there.  A page is allocated if the newest one
+ *   is full.  'size' is zero if the buffer is full or no page is available.
+ *
+ ****************************************************************************/
+
+FAR void *pipebuf_get_writeptr(FAR pipe_buffer_t *buf, FAR size_t *size)
+{
+  FAR struct pipe_page_s *page = buf->pb_last;
+  size_t space = pipebuf_space(buf);
+
+  *size = 0;
+  if (space == 0)
+    {
+      return NULL;
+    }
+
+  if (page == NULL || page->pp_head >= PIPE_PAGESIZE)
+    {
+      page = pipebuf_alloc_page(buf);
+      if (page == NULL)
+        {
+          return NULL;
+        }
+
+      pipebuf_append_page(buf, page);
+    }
+
+  *size = MIN(PIPE_PAGESIZE - page->pp_head, space);
+  return &page->pp_data[page->pp_head];
+}
+
+/****************************************************************************
+ * Name: pipebuf_writecommit
+ *
+ * Description:
+ *   Add the 'len' bytes written at the pointer of pipebuf_get_writeptr().
+ *
+ ****************************************************************************/
+
+void pipebuf_writecommit(FAR pipe_buffer_t *buf, size_t len)
+{
+  DEBUGASSERT(buf->pb_last != NULL &&
+              buf->pb_last->pp_head + len <= PIPE_PAGESIZE);
+
+  buf->pb_last->pp_head += len;
+  buf->pb_used          += len;
+}
+
+/****************************************************************************
+ * Name: pipebuf_get_readptr
+ *
+ * Description:
+ *   Return where the data at 'offset' from the oldest byte is and, in
+ *   'size', how many bytes are contiguous there.  'size' is zero if the
+ *   buffer holds no data at 'offset'.
+ *
+ ****************************************************************************/
+
+FAR void *pipebuf_get_readptr(FAR pipe_buffer_t *buf, size_t offset,
+                              FAR size_t *size)
+{
+  FAR struct pipe_page_s *page;
+  size_t avail;
+
+  for (page = buf->pb_first; page != NULL; page = page->pp_next)
+    {
+      avail = page->pp_head - page->pp_tail;
+      if (offset < avail)
+        {
+          *size = avail - offset;
+          return &page->pp_data[page->pp_tail + offset];
+        }
+
+      offset -= avail;
+    }
+
+  *size = 0;
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pipebuf_readcommit
+ *
+ * Description:
+ *   Remove the 'len' oldest bytes of the buffer, and free the pages that
+ *   become empty.
+ *
+ ****************************************************************************/
+
+void pipebuf_readcommit(FAR pipe_buffer_t *buf, size_t len)
+{
+  FAR struct pipe_page_s *page;
+  size_t n;
+
+  DEBUGASSERT(len <= buf->pb_used);
+  buf->pb_used -= len;
+
+  while ((page = buf->pb_first) != NULL)
+    {
+      n              = MIN(len, page->pp_head - page->pp_tail);
+      page->pp_tail += n;
+      len           -= n;
+
+      if (page->pp_tail < page->pp_head)
+        {
+          break;
+        }
+
+      /* The page is empty.  The newest page is kept to write into. */
+
+      if (page == buf->pb_last)
+        {
+          page->pp_head = 0;
+          page->pp_tail = 0;
+          break;
+        }
+
+      buf->pb_first = page->pp_next;
+      pipebuf_free_page(buf, page);
+    }
+
+  DEBUGASSERT(len == 0);
+}
+
+/****************************************************************************
+ * Name: pipebuf_write
+ ****************************************************************************/
+
+ssize_t pipebuf_write(FAR pipe_buffer_t *buf, FAR const void *src,
+                      size_t len)
+{
+  FAR const uint8_t *data = src;
+  FAR void *ptr;
+  size_t nwritten = 0;
+  size_t n;
+
+  while (nwritten < len)
+    {
+      ptr = pipebuf_get_writeptr(buf, &n);
+      if (n == 0)
+        {
+          if (ptr == NULL && nwritten == 0 && !pipebuf_is_full(buf))
+            {
+              return -ENOMEM;
+            }
+
+          break;
+        }
+
+      n = MIN(n, len - nwritten);
+      memcpy(ptr, data + nwritten, n);
+      pipebuf_writecommit(buf, n);
+      nwritten += n;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: pipebuf_peekat
+ *
+ * Description:
+ *   Copy up to 'len' bytes from 'offset' past the oldest byte, without
+ *   removing them.
+ *
+ ****************************************************************************/
+
+ssize_t pipebuf_peekat(FAR pipe_buffer_t *buf, size_t offset,
+                       FAR void *dst, size_t len)
+{
+  FAR uint8_t *data = dst;
+  FAR void *ptr;
+  size_t nread = 0;
+  size_t n;
+
+  while (nread < len)
+    {
+      ptr = pipebuf_get_readptr(buf, offset + nread, &n);
+      if (n == 0)
+        {
+          break;
+        }
+
+      n = MIN(n, len - nread);
+      memcpy(data + nread, ptr, n);
+      nread += n;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipebuf_read
+ ****************************************************************************/
+
+ssize_t pipebuf_read(FAR pipe_buffer_t *buf, FAR void *dst, size_t len)
+{
+  ssize_t nread = pipebuf_peekat(buf, 0, dst, len);
+
+  pipebuf_readcommit(buf, nread);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipebuf_move
+ *
+ * Description:
+ *   Hand the oldest pages of 'src' over to 'dst' without copying their data,
+ *   as long as they fit in 'len' and in the space of 'dst'.  The page being
+ *   written in 'src' stays there unless it is full.
+ *
+ * Returned Value:
+ *   The number of bytes moved, possibly zero.
+ *
+ ****************************************************************************/
+
+size_t pipebuf_move(FAR pipe_buffer_t *dst, FAR pipe_buffer_t *src,
+                    size_t len)
+{
+  FAR struct pipe_page_s *page;
+  size_t nmoved = 0;
+  size_t avail;
+
+  while ((page = src->pb_first) != NULL)
+    {
+      avail = page->pp_head - page->pp_tail;
+      if (avail == 0 || avail > len - nmoved || avail > pipebuf_space(dst) ||
+          (page == src->pb_last && page->pp_head < PIPE_PAGESIZE))
+        {
+          break;
+        }
+
+      src->pb_first = page->pp_next;
+      if (src->pb_first == NULL)
+        {
+          src->pb_last = NULL;
+        }
+
+      src->pb_used -= avail;
+      pipebuf_append_page(dst, page);
+      dst->pb_used += avail;
+      nmoved       += avail;
+    }
+
+  return nmoved;
+}
+
+#endif /* CONFIG_DEV_PIPE_PAGED */
@@ -85,6 +85,458 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_relock
+ *
+ * Description:
+ *   Take the pipe back after a splice accessed the other file unlocked.
+ *   The splice still has to drop its claim on the pipe, so a signal must
+ *   not make it give up here.
+ *
+ ****************************************************************************/
+
+static void pipecommon_relock(FAR struct pipe_dev_s *dev)
+{
+  while (nxrmutex_lock(&dev->d_bflock) < 0)
+    {
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_notify_in
+ *
+ * Description:
+ *   Notify POLLIN after data was added to the pipe, which held 'before'
+ *   bytes.  With the paged buffer, the waiters are only notified when the
+ *   data crosses the POLLIN threshold, not on every write.
+ *
+ ****************************************************************************/
+
+static void pipecommon_notify_in(FAR struct pipe_dev_s *dev, size_t before)
+{
+#ifdef CONFIG_DEV_PIPE_PAGED
+  if (before > dev->d_pollinthrd)
+    {
+      return;
+    }
+#else
+  UNUSED(before);
+#endif
+
+  if (pipebuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_notify_out
+ *
+ * Description:
+ *   Notify POLLOUT after data was removed from the pipe, which held
+ *   'before' bytes.  With the paged buffer, the waiters are only notified
+ *   when the free space crosses the POLLOUT threshold.
+ *
+ ****************************************************************************/
+
+static void pipecommon_notify_out(FAR struct pipe_dev_s *dev, size_t before)
+{
+  size_t limit = dev->d_bufsize - dev->d_polloutthrd;
+
+#ifdef CONFIG_DEV_PIPE_PAGED
+  if (before <= limit)
+    {
+      return;
+    }
+#else
+  UNUSED(before);
+#endif
+
+  if (pipebuf_used(&dev->d_buffer) <= limit)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+    }
+}
+
+#ifdef CONFIG_DEV_PIPE_PAGED
+/****************************************************************************
+ * Name: pipecommon_splice_pages
+ *
+ * Description:
+ *   If the other end of a splice is another pipe, hand it the full pages of
+ *   this pipe without copying them.  Return the number of bytes moved.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_splice_pages(FAR struct pipe_dev_s *dev,
+                                      FAR struct pipe_splice_s *splice)
+{
+  FAR struct inode *inode = splice->file->f_inode;
+  FAR struct pipe_dev_s *peer;
+  size_t before;
+  size_t nmoved = 0;
+
+  if (splice->offset != NULL || inode == NULL || inode->u.i_ops == NULL ||
+      inode->u.i_ops->ioctl != pipecommon_ioctl ||
+      (splice->file->f_oflags & O_WROK) == 0)
+    {
+      return 0;
+    }
+
+  /* Never wait for the other pipe while this one is locked, the data is
+   * copied instead if the other pipe is busy.
+   */
+
+  peer = inode->i_private;
+  if (nxrmutex_trylock(&peer->d_bflock) < 0)
+    {
+      return 0;
+    }
+
+  /* A splice filling the other pipe relies on its pages staying put */
+
+  if (pipebuf_is_init(&peer->d_buffer) &&
+      !PIPE_IS_SPLICE_WR(peer->d_flags) &&
+      (peer->d_nreaders > 0 || PIPE_IS_POLICY_1(peer->d_flags)))
+    {
+      before = pipebuf_used(&peer->d_buffer);
+      nmoved = pipebuf_move(&peer->d_buffer, &dev->d_buffer, splice->len);
+      if (nmoved > 0)
+        {
+          pipecommon_notify_in(peer, before);
+          pipecommon_wakeup(&peer->d_rdsem);
+        }
+    }
+
+  nxrmutex_unlock(&peer->d_bflock);
+  return nmoved;
+}
+#endif
+
+/****************************************************************************
+ * Name: pipecommon_splice_out
+ *
+ * Description:
+ *   Write the data of the pipe to another file straight from the pipe
+ *   buffer.  The data is consumed unless splice->keep is set.  The pipe is
+ *   unlocked while the other file is written, the other readers wait for
+ *   the splice to finish instead, so the data stays where it is.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice_out(FAR struct file *filep,
+                                     FAR struct pipe_splice_s *splice,
+                                     bool nonblock)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR pipe_buffer_t *buf = &dev->d_buffer;
+  ssize_t nmoved = 0;
+  size_t used;
+  int ret;
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for data like a read does */
+
+  while (pipebuf_is_empty(buf) || PIPE_IS_SPLICE_RD(dev->d_flags))
+    {
+      if (pipebuf_is_empty(buf) && dev->d_nwriters <= 0 &&
+          PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      if (nonblock)
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_rdsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  used = pipebuf_used(buf);
+
+#ifdef CONFIG_DEV_PIPE_PAGED
+  /* Between two pipes, hand the whole pages over first */
+
+  if (!splice->keep)
+    {
+      nmoved = pipecommon_splice_pages(dev, splice);
+    }
+#endif
+
+  /* Then move what is left, in as many pieces as the data is split.  The
+   * data moved is consumed as it goes, unless it is kept.
+   */
+
+  dev->d_flags |= PIPE_FLAG_SPLICE_RD;
+  while ((size_t)nmoved < splice->len &&
+         (splice->keep ? (size_t)nmoved < used : !pipebuf_is_empty(buf)))
+    {
+      FAR char *buffer;
+      size_t n;
+      ssize_t nwritten;
+
+      buffer = pipebuf_get_readptr(buf, splice->keep ? nmoved : 0, &n);
+      n      = MIN(n, splice->len - nmoved);
+
+      nxrmutex_unlock(&dev->d_bflock);
+      if (splice->offset != NULL)
+        {
+          nwritten = file_pwrite(splice->file, buffer, n, *splice->offset);
+        }
+      else
+        {
+          nwritten = file_write(splice->file, buffer, n);
+        }
+
+      pipecommon_relock(dev);
+      if (nwritten <= 0)
+        {
+          if (nmoved == 0)
+            {
+              nmoved = nwritten;
+            }
+
+          break;
+        }
+
+      if (splice->offset != NULL)
+        {
+          *splice->offset += nwritten;
+        }
+
+      if (!splice->keep)
+        {
+          pipebuf_readcommit(buf, nwritten);
+        }
+
+      nmoved += nwritten;
+      if ((size_t)nwritten < n)
+        {
+          break;
+        }
+    }
+
+  dev->d_flags &= ~PIPE_FLAG_SPLICE_RD;
+  if (nmoved > 0 && !splice->keep)
+    {
+      pipecommon_notify_out(dev, used);
+      pipecommon_wakeup(&dev->d_wrsem);
+    }
+
+  /* Let the readers waiting for the splice go */
+
+  pipecommon_wakeup(&dev->d_rdsem);
+  nxrmutex_unlock(&dev->d_bflock);
+  return nmoved;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_in
+ *
+ * Description:
+ *   Read another file into the pipe.  The pipe is unlocked while the other
+ *   file is read, so the data goes through a bounce buffer: the readers
+ *   may empty and reuse the page the next data would be read into in the
+ *   meantime.  The other writers wait for the splice to finish, so the
+ *   room found before the read is still there after it.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice_in(FAR struct file *filep,
+                                    FAR struct pipe_splice_s *splice,
+                                    bool nonblock)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR pipe_buffer_t *buf = &dev->d_buffer;
+  FAR char *buffer;
+  ssize_t nmoved = 0;
+  size_t bufsize;
+  size_t used;
+  int ret;
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for room like a write does */
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      if (!pipebuf_is_full(buf) && !PIPE_IS_SPLICE_WR(dev->d_flags))
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  bufsize = MIN(splice->len, pipebuf_space(buf));
+  buffer  = kmm_malloc(bufsize);
+  if (buffer == NULL)
+    {
+      nxrmutex_unlock(&dev->d_bflock);
+      return -ENOMEM;
+    }
+
+  /* Fill the free space, in as many pieces as the buffer wraps, until the
+   * file has no more data to give.  The room is reserved in the pipe before
+   * each read, so the data read always fits in it afterwards.
+   */
+
+  dev->d_flags |= PIPE_FLAG_SPLICE_WR;
+  used = pipebuf_used(buf);
+  while ((size_t)nmoved < splice->len)
+    {
+      FAR void *ptr;
+      size_t n;
+      ssize_t nread;
+
+      ptr = pipebuf_get_writeptr(buf, &n);
+      n   = MIN(MIN(n, bufsize), splice->len - nmoved);
+      if (n == 0)
+        {
+          if (ptr == NULL && nmoved == 0)
+            {
+              nmoved = -ENOMEM;
+            }
+
+          break;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      if (splice->offset != NULL)
+        {
+          nread = file_pread(splice->file, buffer, n, *splice->offset);
+        }
+      else
+        {
+          nread = file_read(splice->file, buffer, n);
+        }
+
+      pipecommon_relock(dev);
+      if (nread <= 0)
+        {
+          if (nmoved == 0)
+            {
+              nmoved = nread;
+            }
+
+          break;
+        }
+
+      /* No page has to be allocated for the room found above */
+
+      DEBUGVERIFY(pipebuf_write(buf, buffer, nread));
+      if (splice->offset != NULL)
+        {
+          *splice->offset += nread;
+        }
+
+      nmoved += nread;
+      if ((size_t)nread < n)
+        {
+          break;
+        }
+    }
+
+  dev->d_flags &= ~PIPE_FLAG_SPLICE_WR;
+  if (nmoved > 0)
+    {
+      pipecommon_notify_in(dev, used);
+      pipecommon_wakeup(&dev->d_rdsem);
+    }
+
+  /* Let the writers waiting for the splice go */
+
+  pipecommon_wakeup(&dev->d_wrsem);
+  nxrmutex_unlock(&dev->d_bflock);
+  kmm_free(buffer);
+  return nmoved;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice
+ *
+ * Description:
+ *   Move data between the pipe and another file.  The pipe is not locked
+ *   while the other file is accessed, so a splice between two pipes or to a
+ *   file that blocks does not hold up the users of this pipe for long.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice(FAR struct file *filep,
+                                 FAR struct pipe_splice_s *splice)
+{
+  bool nonblock;
+
+  DEBUGASSERT(splice != NULL && splice->file != NULL);
+
+  /* Moving the data of a pipe to itself would wait forever */
+
+  if (splice->file->f_inode == filep->f_inode ||
+      (splice->write && splice->keep))
+    {
+      return -EINVAL;
+    }
+
+  if (splice->len == 0)
+    {
+      return 0;
+    }
+
+  nonblock = (filep->f_oflags & O_NONBLOCK) != 0 ||
+             (splice->flags & SPLICE_F_NONBLOCK) != 0;
+
+  if (splice->write)
+    {
+      return pipecommon_splice_in(filep, splice, nonblock);
+    }
+
+  return pipecommon_splice_out(filep, splice, nonblock);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -153,9 +605,9 @@ int pipecommon_open(FAR struct file *filep)
 
   /* If d_buffer is not initialized, init it. */
 
-  if (!circbuf_is_init(&dev->d_buffer))
+  if (!pipebuf_is_init(&dev->d_buffer))
     {
-      ret = circbuf_init(&dev->d_buffer, NULL, dev->d_bufsize);
+      ret = pipebuf_init(&dev->d_buffer, dev->d_bufsize);
       if (ret < 0)
         {
           nxrmutex_unlock(&dev->d_bflock);
@@ -187,7 +639,7 @@ int pipecommon_open(FAR struct file *filep)
   while ((filep->f_oflags & O_NONBLOCK) == 0 &&     /* Blocking */
          (filep->f_oflags & O_RDWR) == O_WRONLY &&  /* Write-only */
          dev->d_nreaders < 1 &&                     /* No readers on the pipe */
-         circbuf_is_empty(&dev->d_buffer))          /* Buffer is empty */
+         pipebuf_is_empty(&dev->d_buffer))          /* Buffer is empty */
     {
       /* If opened for write-only, then wait for at least one reader
        * on the pipe.
@@ -251,7 +703,7 @@ int pipecommon_open(FAR struct file *filep)
   while ((filep->f_oflags & O_NONBLOCK) == 0 &&     /* Blocking */
          (filep->f_oflags & O_RDWR) == O_RDONLY &&  /* Read-only */
          dev->d_nwriters < 1 &&                     /* No writers on the pipe */
-         circbuf_is_empty(&dev->d_buffer))          /* Buffer is empty */
+         pipebuf_is_empty(&dev->d_buffer))          /* Buffer is empty */
     {
       /* If opened for read-only, then wait for either at least one writer
        * on the pipe.
@@ -380,11 +832,11 @@ int pipecommon_close(FAR struct file *filep)
    */
 
   else if (PIPE_IS_POLICY_0(dev->d_flags) ||
-           circbuf_is_empty(&dev->d_buffer))
+           pipebuf_is_empty(&dev->d_buffer))
     {
       /* Policy 0 or the buffer is empty ... deallocate the buffer now. */
 
-      circbuf_uninit(&dev->d_buffer);
+      pipebuf_uninit(&dev->d_buffer);
 
       /* And reset all counts and indices */
 
@@ -409,19 +861,20 @@ int pipecommon_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: pipecommon_read
+ * Name: pipecommon_readv
  ****************************************************************************/
 
-ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+ssize_t pipecommon_readv(FAR struct file *filep, FAR struct uio *uio)
 {
   FAR struct inode      *inode = filep->f_inode;
   FAR struct pipe_dev_s *dev   = inode->i_private;
   ssize_t                nread = 0;
+  size_t                 before;
   int                    ret;
 
   DEBUGASSERT(dev);
 
-  if (len == 0)
+  if (uio->uio_resid == 0)
     {
       return 0;
     }
@@ -438,13 +891,17 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
-  /* If the pipe is empty, then wait for something to be written to it */
+  /* If the pipe is empty, then wait for something to be written to it.
+   * Also wait while a splice is writing the data out of the pipe.
+   */
 
-  while (circbuf_is_empty(&dev->d_buffer))
+  while (pipebuf_is_empty(&dev->d_buffer) ||
+         PIPE_IS_SPLICE_RD(dev->d_flags))
     {
       /* If there are no writers on the pipe, then return end of file */
 
-      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+      if (pipebuf_is_empty(&dev->d_buffer) && dev->d_nwriters <= 0 &&
+          PIPE_IS_POLICY_0(dev->d_flags))
         {
           nxrmutex_unlock(&dev->d_bflock);
           return 0;
@@ -474,19 +931,33 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
     }
 
   /* Then return whatever is available in the pipe (which is at least one
-   * byte).
+   * byte), scattered over as many of the segments as it fills.
    */
 
-  nread = circbuf_read(&dev->d_buffer, buffer, len);
+  before = pipebuf_used(&dev->d_buffer);
+  while (uio->uio_resid > 0)
+    {
+      FAR const struct iovec *iov = uio->uio_iov;
+      FAR char *buffer = (FAR char *)iov->iov_base + uio->uio_offset_in_iov;
+      size_t len = iov->iov_len - uio->uio_offset_in_iov;
+      ssize_t n;
+
+      n = pipebuf_read(&dev->d_buffer, buffer, len);
+      pipe_dumpbuffer("From PIPE:", buffer, n);
+      uio_advance(uio, n);
+      nread += n;
+
+      if ((size_t)n < len)
+        {
+          break;
+        }
+    }
 
   /* Notify all poll/select waiters that they can write to the
    * FIFO when buffer can accept more than d_polloutthrd bytes.
    */
 
-  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
-    {
-      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
-    }
+  pipecommon_notify_out(dev, before);
 
   /* Notify all waiting writers that bytes have been removed from the
    * buffer.
@@ -495,25 +966,53 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   pipecommon_wakeup(&dev->d_wrsem);
 
   nxrmutex_unlock(&dev->d_bflock);
-  pipe_dumpbuffer("From PIPE:", buffer, nread);
   return nread;
 }
 
 /****************************************************************************
- * Name: pipecommon_write
+ * Name: pipecommon_read
  ****************************************************************************/
 
-ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t len)
+ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+  struct iovec iov;
+  struct uio uio;
+  int ret;
+
+  iov.iov_base = buffer;
+  iov.iov_len  = len;
+
+  ret = uio_init(&uio, &iov, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return pipecommon_readv(filep, &uio);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writev
+ *
+ * Description:
+ *   Gather all the segments of the uio into the pipe under one hold of the
+ *   device lock, so that a message written with a single writev() is never
+ *   interleaved with the data of the other writers and the readers are
+ *   woken up once for the whole of it.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_writev(FAR struct file *filep, FAR struct uio *uio)
 {
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
+  ssize_t                len      = uio->uio_resid;
   ssize_t                nwritten = 0;
   ssize_t                last;
+  size_t                 before   = 0;
   int                    ret;
 
   DEBUGASSERT(dev);
-  pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
 
   /* Handle zero-length writes */
 
@@ -566,26 +1065,52 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* Would the next write overflow the circular buffer?  The writers
+       * also wait while a splice is reading data into the pipe.
+       */
 
-      if (!circbuf_is_full(&dev->d_buffer))
+      if (!pipebuf_is_full(&dev->d_buffer) &&
+          !PIPE_IS_SPLICE_WR(dev->d_flags))
         {
-          /* Loop until all of the bytes have been written */
+          /* Copy the segments until all of the bytes have been written or
+           * the buffer fills up.
+           */
+
+          before = pipebuf_used(&dev->d_buffer);
+          while (uio->uio_resid > 0)
+            {
+              FAR const struct iovec *iov = uio->uio_iov;
+              FAR const char *buffer = (FAR const char *)iov->iov_base +
+                                       uio->uio_offset_in_iov;
+              size_t remain = iov->iov_len - uio->uio_offset_in_iov;
+              ssize_t n;
+
+              n = pipebuf_write(&dev->d_buffer, buffer, remain);
+              if (n < 0)
+                {
+                  /* No memory for the paged buffer */
+
+                  ret = n;
+                  break;
+                }
+
+              pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, n);
+              uio_advance(uio, n);
+              nwritten += n;
 
-          nwritten += circbuf_write(&dev->d_buffer,
-                                    buffer + nwritten, len - nwritten);
+              if ((size_t)n < remain)
+                {
+                  break;
+                }
+            }
 
-          if ((size_t)nwritten == len)
+          if (nwritten == len || ret < 0)
             {
               /* Notify all poll/select waiters that they can read from the
                * FIFO when buffer used exceeds poll threshold.
                */
 
-              if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
-                {
-                  poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
-                              POLLIN);
-                }
+              pipecommon_notify_in(dev, before);
 
               /* Yes.. Notify all of the waiting readers that more data is
                * available.
@@ -596,7 +1121,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
               /* Return the number of bytes written */
 
               nxrmutex_unlock(&dev->d_bflock);
-              return len;
+              return nwritten > 0 ? nwritten : ret;
             }
         }
       else
@@ -611,7 +1136,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                * FIFO.
                */
 
-              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+              pipecommon_notify_in(dev, before);
 
               /* Yes.. Notify all of the waiting readers that more data is
                * available.
@@ -655,6 +1180,29 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_write
+ ****************************************************************************/
+
+ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t len)
+{
+  struct iovec iov;
+  struct uio uio;
+  int ret;
+
+  iov.iov_base = (FAR void *)buffer;
+  iov.iov_len  = len;
+
+  ret = uio_init(&uio, &iov, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return pipecommon_writev(filep, &uio);
+}
+
 /****************************************************************************
  * Name: pipecommon_poll
  ****************************************************************************/
@@ -710,7 +1258,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * First, determine how many bytes are in the buffer
        */
 
-      nbytes = circbuf_used(&dev->d_buffer);
+      nbytes = pipebuf_used(&dev->d_buffer);
 
       /* Notify the POLLOUT event if the pipe buffer can accept
        * more than d_polloutthrd bytes, but only if
@@ -797,6 +1345,13 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+  /* The splice takes the lock itself, since it may have to wait */
+
+  if (cmd == PIPEIOC_SPLICE)
+    {
+      return pipecommon_splice(filep, (FAR struct pipe_splice_s *)arg);
+    }
+
   ret = nxrmutex_lock(&dev->d_bflock);
   if (ret < 0)
     {
@@ -854,8 +1409,7 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           DEBUGASSERT(peek && peek->buf);
 
-          ret = circbuf_peekat(&dev->d_buffer,
-                               dev->d_buffer.tail + peek->offset,
+          ret = pipebuf_peekat(&dev->d_buffer, peek->offset,
                                peek->buf, peek->size);
         }
         break;
@@ -869,8 +1423,17 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+          /* A splice is using the buffer unlocked */
+
+          if (PIPE_IS_SPLICE_RD(dev->d_flags) ||
+              PIPE_IS_SPLICE_WR(dev->d_flags))
+            {
+              ret = -EBUSY;
+              break;
+            }
+
           size = MIN(size, CONFIG_DEV_PIPE_MAXSIZE);
-          ret = circbuf_resize(&dev->d_buffer, size);
+          ret = pipebuf_resize(&dev->d_buffer, size);
           if (ret != 0)
             {
               break;
@@ -889,7 +1452,7 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       case FIONWRITE:  /* Number of bytes waiting in send queue */
       case FIONREAD:   /* Number of bytes available for reading */
         {
-          *(FAR int *)((uintptr_t)arg) = circbuf_used(&dev->d_buffer);
+          *(FAR int *)((uintptr_t)arg) = pipebuf_used(&dev->d_buffer);
           ret = 0;
         }
         break;
@@ -898,7 +1461,7 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       case FIONSPACE:
         {
-          *(FAR int *)((uintptr_t)arg) = circbuf_space(&dev->d_buffer);
+          *(FAR int *)((uintptr_t)arg) = pipebuf_space(&dev->d_buffer);
           ret = 0;
         }
         break;
@@ -937,7 +1500,7 @@ int pipecommon_unlink(FAR struct inode *inode)
 
   if (dev->d_crefs <= 0)
     {
-      circbuf_uninit(&dev->d_buffer);
+      pipebuf_uninit(&dev->d_buffer);
       pipecommon_freedev(dev);
       return OK;
     }
@@ -951,4 +1514,32 @@ int pipecommon_unlink(FAR struct inode *inode)
 }
 #endif
 
+/****************************************************************************
+ * Name: pipebuf_get_readptr
+ *
+ * Description:
+ *   Return where the data at 'offset' from the oldest byte of the ring
+ *   buffer is and, in 'size', how many bytes are contiguous there.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DEV_PIPE_PAGED
+FAR void *pipebuf_get_readptr(FAR pipe_buffer_t *buf, size_t offset,
+                              FAR size_t *size)
+{
+  size_t used = circbuf_used(buf);
+  size_t off;
+
+  if (offset >= used)
+    {
+      *size = 0;
+      return NULL;
+    }
+
+  off   = (buf->tail + offset) % buf->size;
+  *size = MIN(buf->size - off, used - offset);
+  return (FAR char *)buf->base + off;
+}
+#endif
+
 #endif /* CONFIG_PIPES */
@@ -87,6 +87,8 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0) /* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1) /* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_SPLICE_RD (1 << 2) /* Bit 2: A splice is reading unlocked */
+#define PIPE_FLAG_SPLICE_WR (1 << 3) /* Bit 3: A splice is writing unlocked */
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -96,6 +98,37 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+#define PIPE_IS_SPLICE_RD(f) (((f) & PIPE_FLAG_SPLICE_RD) != 0)
+#define PIPE_IS_SPLICE_WR(f) (((f) & PIPE_FLAG_SPLICE_WR) != 0)
+
+/* The buffer of the pipe, a chain of pages or a ring buffer.  The offsets
+ * passed to pipebuf_peekat() and pipebuf_get_readptr() are relative to the
+ * oldest byte in the buffer.
+ */
+
+#ifdef CONFIG_DEV_PIPE_PAGED
+#  define pipebuf_is_init(b)         ((b)->pb_init)
+#  define pipebuf_used(b)            ((b)->pb_used)
+#  define pipebuf_space(b)           ((b)->pb_size - (b)->pb_used)
+#  define pipebuf_is_empty(b)        ((b)->pb_used == 0)
+#  define pipebuf_is_full(b)         ((b)->pb_used >= (b)->pb_size)
+#else
+#  define pipebuf_init(b, n)         circbuf_init(b, NULL, n)
+#  define pipebuf_uninit(b)          circbuf_uninit(b)
+#  define pipebuf_is_init(b)         circbuf_is_init(b)
+#  define pipebuf_used(b)            circbuf_used(b)
+#  define pipebuf_space(b)           circbuf_space(b)
+#  define pipebuf_is_empty(b)        circbuf_is_empty(b)
+#  define pipebuf_is_full(b)         circbuf_is_full(b)
+#  define pipebuf_read(b, d, n)      circbuf_read(b, d, n)
+#  define pipebuf_write(b, s, n)     circbuf_write(b, s, n)
+#  define pipebuf_peekat(b, o, d, n) circbuf_peekat(b, (b)->tail + (o), d, n)
+#  define pipebuf_resize(b, n)       circbuf_resize(b, n)
+#  define pipebuf_get_writeptr(b, n) circbuf_get_writeptr(b, n)
+#  define pipebuf_writecommit(b, n)  circbuf_writecommit(b, n)
+#  define pipebuf_readcommit(b, n)   circbuf_readcommit(b, n)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -110,6 +143,32 @@ typedef uint16_t pipe_ndx_t;  /* 16-bit index */
 typedef uint8_t pipe_ndx_t;   /*  8-bit index */
 #endif
 
+#ifdef CONFIG_DEV_PIPE_PAGED
+/* A page of a paged pipe buffer.  The data between pp_tail and pp_head is
+ * valid, pp_data is CONFIG_DEV_PIPE_PAGESIZE bytes long.
+ */
+
+struct pipe_page_s
+{
+  FAR struct pipe_page_s *pp_next;   /* The next newer page */
+  size_t                  pp_head;   /* The end of the data in the page */
+  size_t                  pp_tail;   /* The start of the data in the page */
+  uint8_t                 pp_data[1];
+};
+
+typedef struct pipe_buffer_s
+{
+  FAR struct pipe_page_s *pb_first;  /* The oldest page, read first */
+  FAR struct pipe_page_s *pb_last;   /* The newest page, written last */
+  FAR struct pipe_page_s *pb_spare;  /* A free page kept for the next use */
+  size_t                  pb_size;   /* The capacity in bytes */
+  size_t                  pb_used;   /* The number of bytes buffered */
+  bool                    pb_init;   /* The buffer is in use */
+} pipe_buffer_t;
+#else
+typedef struct circbuf_s pipe_buffer_t;
+#endif
+
 /* This structure represents the state of one pipe.  A reference to this
  * structure is retained in the i_private field of the inode whenthe
  * pipe/fifo device is registered.
@@ -129,7 +188,7 @@ struct pipe_dev_s
   uint8_t          d_nreaders;    /* Number of reference counts for read access */
   uint8_t          d_flags;       /* See PIPE_FLAG_* definitions */
   int16_t          d_crefs;       /* References to dev */
-  struct circbuf_s d_buffer;      /* Buffer allocated when device opened */
+  pipe_buffer_t    d_buffer;      /* Buffer allocated when device opened */
 
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
@@ -153,6 +212,7 @@ extern "C"
 
 struct file;  /* Forward reference */
 struct inode; /* Forward reference */
+struct uio;   /* Forward reference */
 
 FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize);
 void    pipecommon_freedev(FAR struct pipe_dev_s *dev);
@@ -160,6 +220,8 @@ int     pipecommon_open(FAR struct file *filep);
 int     pipecommon_close(FAR struct file *filep);
 ssize_t pipecommon_read(FAR struct file *, FAR char *, size_t);
 ssize_t pipecommon_write(FAR struct file *, FAR const char *, size_t);
+ssize_t pipecommon_readv(FAR struct file *filep, FAR struct uio *uio);
+ssize_t pipecommon_writev(FAR struct file *filep, FAR struct uio *uio);
 int     pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
                                bool setup);
@@ -167,6 +229,25 @@ int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 int     pipecommon_unlink(FAR struct inode *priv);
 #endif
 
+#ifdef CONFIG_DEV_PIPE_PAGED
+int     pipebuf_init(FAR pipe_buffer_t *buf, size_t size);
+void    pipebuf_uninit(FAR pipe_buffer_t *buf);
+int     pipebuf_resize(FAR pipe_buffer_t *buf, size_t size);
+ssize_t pipebuf_read(FAR pipe_buffer_t *buf, FAR void *dst, size_t len);
+ssize_t pipebuf_write(FAR pipe_buffer_t *buf, FAR const void *src,
+                      size_t len);
+ssize_t pipebuf_peekat(FAR pipe_buffer_t *buf, size_t offset,
+                       FAR void *dst, size_t len);
+FAR void *pipebuf_get_writeptr(FAR pipe_buffer_t *buf, FAR size_t *size);
+void    pipebuf_writecommit(FAR pipe_buffer_t *buf, size_t len);
+void    pipebuf_readcommit(FAR pipe_buffer_t *buf, size_t len);
+size_t  pipebuf_move(FAR pipe_buffer_t *dst, FAR pipe_buffer_t *src,
+                     size_t len);
+#endif
+
+FAR void *pipebuf_get_readptr(FAR pipe_buffer_t *buf, size_t offset,
+                              FAR size_t *size);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
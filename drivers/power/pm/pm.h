@@ -65,6 +65,12 @@ struct pm_domain_s
 
   struct dq_queue_s wakelock[PM_COUNT];
 
+#ifdef CONFIG_PM_QOS
+  /* The wakeup latency constraints, see pm_qos_add() */
+
+  struct dq_queue_s qos;
+#endif
+
 #ifdef CONFIG_PM_PROCFS
   struct dq_queue_s wakelockall;
   struct timespec start;
@@ -0,0 +1,550 @@
+/****************************************************************************
+ * drivers/power/pm/pm_hibernate.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <lzf.h>
+#include <sched.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <nuttx/board.h>
+#include <nuttx/cache.h>
+#include <nuttx/clock.h>
+#include <nuttx/crc32.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mtd/mtd.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/power/pm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PM_HIBERNATE_MAGIC   0x4e424948 /* "HIBN" */
+#define PM_HIBERNATE_CHUNK   CONFIG_PM_HIBERNATE_CHUNKSIZE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The image starts with this header, followed by the region table.  The
+ * LZF blocks of all the regions follow, from the first block boundary
+ * after the table.  The header is written last so that an incomplete
+ * image is never resumed.
+ */
+
+struct pm_hibernate_header_s
+{
+  uint32_t magic;    /* PM_HIBERNATE_MAGIC */
+  uint32_t nregions; /* Number of entries in the region table */
+  uint32_t datapos;  /* Offset of the LZF blocks in the image */
+  uint32_t datasize; /* Size of the LZF blocks */
+  uint32_t datacrc;  /* CRC32 of the LZF blocks */
+  uint32_t hdrcrc;   /* CRC32 of the header up to here and the table */
+};
+
+/* Streams the image to the MTD device one block at a time */
+
+struct pm_hibernate_writer_s
+{
+  FAR struct mtd_dev_s *mtd;     /* The device receiving the image */
+  struct mtd_geometry_s geo;     /* Its geometry */
+  FAR uint8_t          *block;   /* One block being filled */
+  size_t                fill;    /* Bytes in block */
+  off_t                 pos;     /* Image offset of block */
+  off_t                 nerased; /* Erase blocks erased so far */
+  uint32_t              size;    /* Bytes of LZF blocks written */
+  uint32_t              crc;     /* CRC32 of the LZF blocks written */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The context of pm_hibernate().  It is part of the image, so it holds the
+ * saved context again once pm_hibernate_resume() has restored the RAM.
+ */
+
+static jmp_buf g_pm_hibernate_jmpbuf;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_hibernate_flush
+ *
+ * Description:
+ *   Write the current block, erasing the flash ahead of it as needed.
+ *
+ ****************************************************************************/
+
+static int pm_hibernate_flush(FAR struct pm_hibernate_writer_s *writer)
+{
+  off_t blockno = writer->pos / writer->geo.blocksize;
+  off_t eraseno = writer->pos / writer->geo.erasesize;
+  int ret;
+
+  while (writer->nerased <= eraseno)
+    {
+      if (writer->nerased >= writer->geo.neraseblocks)
+        {
+          return -ENOSPC;
+        }
+
+      ret = MTD_ERASE(writer->mtd, writer->nerased, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      writer->nerased++;
+    }
+
+  memset(writer->block + writer->fill, 0xff,
+         writer->geo.blocksize - writer->fill);
+
+  ret = MTD_BWRITE(writer->mtd, blockno, 1, writer->block);
+  if (ret != 1)
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  writer->pos += writer->geo.blocksize;
+  writer->fill = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_write
+ *
+ * Description:
+ *   Append LZF blocks to the image.
+ *
+ ****************************************************************************/
+
+static int pm_hibernate_write(FAR struct pm_hibernate_writer_s *writer,
+                              FAR const void *data, size_t len)
+{
+  FAR const uint8_t *src = data;
+  int ret;
+
+  writer->crc   = crc32part(src, len, writer->crc);
+  writer->size += len;
+
+  while (len > 0)
+    {
+      size_t n = MIN(writer->geo.blocksize - writer->fill, len);
+
+      memcpy(writer->block + writer->fill, src, n);
+      writer->fill += n;
+      src          += n;
+      len          -= n;
+
+      if (writer->fill == writer->geo.blocksize)
+        {
+          ret = pm_hibernate_flush(writer);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_save
+ *
+ * Description:
+ *   Compress the regions to the image, then write its header.  Called with
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+static int pm_hibernate_save(FAR struct pm_hibernate_writer_s *writer,
+                             FAR struct pm_hibernate_header_s *header,
+                             FAR const struct pm_hibernate_region_s *regions,
+                             FAR uint8_t *in, FAR uint8_t *out,
+                             lzf_state_t htab)
+{
+  FAR struct lzf_header_s *lzfhdr;
+  size_t offset;
+  size_t len;
+  int ret;
+  int i;
+
+  for (i = 0; i < header->nregions; i++)
+    {
+      for (offset = 0; offset < regions[i].size; offset += len)
+        {
+          len = MIN(regions[i].size - offset, PM_HIBERNATE_CHUNK);
+
+          /* lzf_compress() writes the LZF header in front of its input or
+           * its output, so compress a copy with room for it.
+           */
+
+          memcpy(in + LZF_TYPE0_HDR_SIZE,
+                 (FAR uint8_t *)regions[i].base + offset, len);
+
+          ret = lzf_compress(in + LZF_TYPE0_HDR_SIZE, len,
+                             out + LZF_TYPE1_HDR_SIZE, len, htab, &lzfhdr);
+          ret = pm_hibernate_write(writer, lzfhdr, ret);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  if (writer->fill > 0)
+    {
+      ret = pm_hibernate_flush(writer);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* The image is complete, make it valid */
+
+  header->magic    = PM_HIBERNATE_MAGIC;
+  header->datasize = writer->size;
+  header->datacrc  = writer->crc;
+  header->hdrcrc   = crc32part((FAR const uint8_t *)regions,
+                               header->nregions * sizeof(*regions),
+                               crc32((FAR const uint8_t *)header,
+                                     offsetof(struct pm_hibernate_header_s,
+                                              hdrcrc)));
+
+  ret = MTD_BWRITE(writer->mtd, 0, header->datapos / writer->geo.blocksize,
+                   (FAR const uint8_t *)header);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_check
+ *
+ * Description:
+ *   Check that the LZF blocks of an image exactly cover its regions, so the
+ *   RAM is only touched once the whole image is known to be valid.
+ *
+ ****************************************************************************/
+
+static bool
+pm_hibernate_check(FAR const struct pm_hibernate_header_s *hdr,
+                   FAR const struct pm_hibernate_region_s *regions)
+{
+  FAR const uint8_t *data = (FAR const uint8_t *)hdr + hdr->datapos;
+  FAR const uint8_t *end = data + hdr->datasize;
+  size_t offset;
+  size_t len;
+  int i;
+
+  for (i = 0; i < hdr->nregions; i++)
+    {
+      for (offset = 0; offset < regions[i].size; offset += len)
+        {
+          if (end - data < LZF_TYPE0_HDR_SIZE ||
+              data[0] != 'Z' || data[1] != 'V')
+            {
+              return false;
+            }
+
+          if (data[2] == LZF_TYPE0_HDR)
+            {
+              len   = (data[3] << 8) | data[4];
+              data += LZF_TYPE0_HDR_SIZE + len;
+            }
+          else if (data[2] == LZF_TYPE1_HDR &&
+                   end - data >= LZF_TYPE1_HDR_SIZE)
+            {
+              len   = (data[5] << 8) | data[6];
+              data += LZF_TYPE1_HDR_SIZE + ((data[3] << 8) | data[4]);
+            }
+          else
+            {
+              return false;
+            }
+
+          if (data > end || len == 0 || len > regions[i].size - offset)
+            {
+              return false;
+            }
+        }
+    }
+
+  return data == end;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_hibernate
+ *
+ * Description:
+ *   Put every PM domain into PM_SLEEP, save a compressed image of the RAM
+ *   regions to the MTD device and power off the board.  The image starts
+ *   at the first block of the device, which should be a partition reserved
+ *   for it.
+ *
+ *   The regions must cover all the RAM that the system uses: data, bss,
+ *   heaps and stacks.  They must not include the memory used by the board
+ *   to call pm_hibernate_resume(), mainly its stack.
+ *
+ * Input Parameters:
+ *   mtd      - The MTD device that receives the image.
+ *   regions  - The RAM regions to save.
+ *   nregions - The number of regions.
+ *
+ * Returned Value:
+ *   Zero (OK) after the board resumed from the image, or a negated errno
+ *   value if the system could not hibernate.  In all cases the PM domains
+ *   are back in their previous state.
+ *
+ * Assumptions:
+ *   Called from a task, not from an interrupt handler.  The MTD driver
+ *   must be able to write with interrupts disabled.
+ *
+ ****************************************************************************/
+
+int pm_hibernate(FAR struct mtd_dev_s *mtd,
+                 FAR const struct pm_hibernate_region_s *regions,
+                 int nregions)
+{
+  enum pm_state_e states[CONFIG_PM_NDOMAINS];
+  struct pm_hibernate_writer_s writer;
+  FAR struct pm_hibernate_header_s *header;
+  FAR lzf_hslot_t *htab;
+  FAR uint8_t *in;
+  FAR uint8_t *out;
+  irqstate_t flags;
+  size_t hdrsize;
+  bool saved = false;
+  int domain;
+  int ret;
+
+  DEBUGASSERT(mtd != NULL && regions != NULL && nregions > 0);
+
+  memset(&writer, 0, sizeof(writer));
+  writer.mtd = mtd;
+
+  ret = MTD_IOCTL(mtd, MTDIOC_GEOMETRY, (unsigned long)&writer.geo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Allocate everything before the RAM is frozen */
+
+  hdrsize = ALIGN_UP(sizeof(*header) + nregions * sizeof(*regions),
+                     writer.geo.blocksize);
+
+  header       = kmm_zalloc(hdrsize);
+  writer.block = kmm_malloc(writer.geo.blocksize);
+  htab         = kmm_malloc(sizeof(lzf_state_t));
+  in           = kmm_malloc(PM_HIBERNATE_CHUNK + LZF_TYPE0_HDR_SIZE);
+  out          = kmm_malloc(PM_HIBERNATE_CHUNK + LZF_TYPE1_HDR_SIZE);
+  if (header == NULL || writer.block == NULL || htab == NULL ||
+      in == NULL || out == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  header->nregions = nregions;
+  header->datapos  = hdrsize;
+  memcpy(header + 1, regions, nregions * sizeof(*regions));
+  writer.pos       = hdrsize;
+
+  /* Suspend the drivers of all the domains */
+
+  sched_lock();
+
+  for (domain = 0; domain < CONFIG_PM_NDOMAINS; domain++)
+    {
+      states[domain] = pm_querystate(domain);
+      ret = pm_changestate(domain, PM_SLEEP);
+      if (ret < 0)
+        {
+          pwrwarn("WARNING: Domain %d refused to hibernate\n", domain);
+          goto errout_with_domains;
+        }
+    }
+
+  /* Save the RAM and power off.  When the board resumes from the image,
+   * setjmp() returns again, this time with 1.
+   */
+
+  flags = enter_critical_section();
+  saved = true;
+
+  if (setjmp(g_pm_hibernate_jmpbuf) == 0)
+    {
+      ret = pm_hibernate_save(&writer, header,
+                              (FAR const struct pm_hibernate_region_s *)
+                              (header + 1), in, out, htab);
+      if (ret >= 0)
+        {
+          board_power_off(0);
+          ret = -EIO;
+        }
+    }
+  else
+    {
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+
+errout_with_domains:
+  while (domain-- > 0)
+    {
+      pm_changestate(domain, states[domain]);
+    }
+
+  sched_unlock();
+
+  if (saved)
+    {
+      /* The image must not be resumed again */
+
+      MTD_ERASE(mtd, 0, 1);
+    }
+
+#if defined(CONFIG_RTC) && !defined(CONFIG_SCHED_TICKLESS)
+  if (ret == OK)
+    {
+      /* The system time stopped while the board was off */
+
+      clock_resynchronize(NULL);
+    }
+#endif
+
+errout:
+  kmm_free(out);
+  kmm_free(in);
+  kmm_free(htab);
+  kmm_free(writer.block);
+  kmm_free(header);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_resume
+ *
+ * Description:
+ *   Restore the RAM from an image saved by pm_hibernate() and continue in
+ *   pm_hibernate().  Called by the board early in the boot, on a stack that
+ *   is not part of the image, once the hardware that does not register PM
+ *   callbacks is initialized.
+ *
+ * Input Parameters:
+ *   image - The address of the image in memory mapped flash.
+ *
+ * Returned Value:
+ *   Does not return if the image is valid, otherwise returns -ENOENT and
+ *   the board should continue with a normal boot.
+ *
+ ****************************************************************************/
+
+int pm_hibernate_resume(FAR const void *image)
+{
+  FAR const struct pm_hibernate_header_s *header = image;
+  FAR const struct pm_hibernate_region_s *regions;
+  FAR const uint8_t *data;
+  size_t offset;
+  size_t len;
+  int i;
+
+  if (header->magic != PM_HIBERNATE_MAGIC)
+    {
+      return -ENOENT;
+    }
+
+  regions = (FAR const struct pm_hibernate_region_s *)(header + 1);
+  data    = (FAR const uint8_t *)image + header->datapos;
+
+  if (header->hdrcrc !=
+      crc32part((FAR const uint8_t *)regions,
+                header->nregions * sizeof(*regions),
+                crc32(image, offsetof(struct pm_hibernate_header_s,
+                                      hdrcrc))) ||
+      header->datacrc != crc32(data, header->datasize) ||
+      !pm_hibernate_check(header, regions))
+    {
+      return -ENOENT;
+    }
+
+  /* From here on the RAM of the system being booted is overwritten */
+
+  for (i = 0; i < header->nregions; i++)
+    {
+      FAR uint8_t *base = regions[i].base;
+
+      for (offset = 0; offset < regions[i].size; offset += len)
+        {
+          if (data[2] == LZF_TYPE0_HDR)
+            {
+              len = (data[3] << 8) | data[4];
+              memcpy(base + offset, data + LZF_TYPE0_HDR_SIZE, len);
+              data += LZF_TYPE0_HDR_SIZE + len;
+            }
+          else
+            {
+              unsigned int clen = (data[3] << 8) | data[4];
+
+              len = (data[5] << 8) | data[6];
+              lzf_decompress(data + LZF_TYPE1_HDR_SIZE, clen,
+                             base + offset, len);
+              data += LZF_TYPE1_HDR_SIZE + clen;
+            }
+        }
+    }
+
+  up_flush_dcache_all();
+  up_invalidate_icache_all();
+
+  longjmp(g_pm_hibernate_jmpbuf, 1);
+  return -ENOENT;
+}
@@ -0,0 +1,174 @@
+/****************************************************************************
+ * drivers/power/pm/pm_qos.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+#ifdef CONFIG_PM_QOS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   Register the maximum wakeup latency that a driver or a task can
+ *   tolerate in a domain.  The governor does not select a state that takes
+ *   longer to leave than the smallest latency registered.
+ *
+ * Input Parameters:
+ *   domain  - The PM domain of the constraint
+ *   qos     - The constraint, owned by the caller until pm_qos_remove()
+ *   latency - The maximum tolerable wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_add(int domain, FAR struct pm_qos_s *qos, uint32_t latency)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS && qos != NULL);
+
+  flags = pm_domain_lock(domain);
+  qos->latency = latency;
+  dq_addlast(&qos->node, &g_pmdomains[domain].qos);
+  pm_domain_unlock(domain, flags);
+}
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the latency of a constraint registered with pm_qos_add().
+ *
+ * Input Parameters:
+ *   domain  - The PM domain of the constraint
+ *   qos     - The constraint
+ *   latency - The new maximum tolerable wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_update(int domain, FAR struct pm_qos_s *qos, uint32_t latency)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS && qos != NULL);
+
+  flags = pm_domain_lock(domain);
+  qos->latency = latency;
+  pm_domain_unlock(domain, flags);
+}
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Remove a constraint registered with pm_qos_add().
+ *
+ * Input Parameters:
+ *   domain - The PM domain of the constraint
+ *   qos    - The constraint
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(int domain, FAR struct pm_qos_s *qos)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS && qos != NULL);
+
+  flags = pm_domain_lock(domain);
+  dq_rem(&qos->node, &g_pmdomains[domain].qos);
+  pm_domain_unlock(domain, flags);
+}
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the smallest latency registered in a domain.
+ *
+ * Input Parameters:
+ *   domain - The PM domain to check
+ *
+ * Returned Value:
+ *   The smallest tolerable wakeup latency in microseconds, or UINT32_MAX
+ *   if there is no constraint.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(int domain)
+{
+  FAR struct pm_qos_s *qos;
+  FAR dq_entry_t *entry;
+  uint32_t latency = UINT32_MAX;
+  irqstate_t flags;
+
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+
+  flags = pm_domain_lock(domain);
+
+  for (entry = dq_peek(&g_pmdomains[domain].qos); entry != NULL;
+       entry = dq_next(entry))
+    {
+      qos = (FAR struct pm_qos_s *)entry;
+      if (qos->latency < latency)
+        {
+          latency = qos->latency;
+        }
+    }
+
+  pm_domain_unlock(domain, flags);
+  return latency;
+}
+
+#endif /* CONFIG_PM_QOS */
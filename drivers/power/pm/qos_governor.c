@@ -0,0 +1,196 @@
+/****************************************************************************
+ * drivers/power/pm/qos_governor.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <limits.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/power/pm.h>
+#include <nuttx/wdog.h>
+
+#include <nuttx/irq.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static enum pm_state_e qos_governor_checkstate(int domain);
+static void qos_governor_activity(int domain, int count);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_qos_governor_ops =
+{
+  NULL,                         /* initialize */
+  NULL,                         /* deinitialize */
+  NULL,                         /* statechanged */
+  qos_governor_checkstate,      /* checkstate */
+  qos_governor_activity,        /* activity */
+  NULL                          /* priv */
+};
+
+/* Time needed to return to PM_NORMAL from each state, in microseconds */
+
+static const uint32_t g_qos_latency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_QOS_IDLE_LATENCY,
+  CONFIG_PM_GOVERNOR_QOS_STANDBY_LATENCY,
+  CONFIG_PM_GOVERNOR_QOS_SLEEP_LATENCY
+};
+
+/* Minimum time in each state for it to save power, in microseconds */
+
+static const uint32_t g_qos_residency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_QOS_IDLE_RESIDENCY,
+  CONFIG_PM_GOVERNOR_QOS_STANDBY_RESIDENCY,
+  CONFIG_PM_GOVERNOR_QOS_SLEEP_RESIDENCY
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qos_governor_nextevent
+ *
+ * Description:
+ *   Return the time until the next watchdog or hrtimer expiration, in
+ *   microseconds, or UINT64_MAX if no timer is active.
+ *
+ ****************************************************************************/
+
+static uint64_t qos_governor_nextevent(void)
+{
+  uint64_t next = UINT64_MAX;
+  clock_t ticks;
+#ifdef CONFIG_HRTIMER
+  uint64_t nsec;
+#endif
+
+  ticks = wd_gettime_next();
+  if (ticks != CLOCK_MAX)
+    {
+      next = TICK2USEC((uint64_t)ticks);
+    }
+
+#ifdef CONFIG_HRTIMER
+  nsec = hrtimer_gettime_next();
+  if (nsec != UINT64_MAX)
+    {
+      next = MIN(next, nsec / NSEC_PER_USEC);
+    }
+#endif
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: qos_governor_checkstate
+ ****************************************************************************/
+
+static enum pm_state_e qos_governor_checkstate(int domain)
+{
+  FAR struct pm_domain_s *pdom;
+  irqstate_t flags;
+  uint32_t latency;
+  uint64_t next;
+  int state;
+
+  pdom    = &g_pmdomains[domain];
+  state   = PM_NORMAL;
+  latency = pm_qos_latency(domain);
+  next    = qos_governor_nextevent();
+
+  /* We disable interrupts since pm_stay()/pm_relax() could be simultaneously
+   * invoked, which modifies the stay count which we are about to read
+   */
+
+  flags = spin_lock_irqsave(&pdom->lock);
+
+  /* Find the lowest power-level which is not locked. */
+
+  while (dq_empty(&pdom->wakelock[state]) && state < (PM_COUNT - 1))
+    {
+      state++;
+    }
+
+  spin_unlock_irqrestore(&pdom->lock, flags);
+
+  /* Back off to the deepest state that wakes up fast enough for every
+   * constraint and is worth entering before the next timer expires.
+   */
+
+  while (state > PM_NORMAL &&
+         (g_qos_latency[state] > latency || g_qos_residency[state] > next))
+    {
+      state--;
+    }
+
+  return state;
+}
+
+/****************************************************************************
+ * Name: qos_governor_activity
+ ****************************************************************************/
+
+static void qos_governor_activity(int domain, int count)
+{
+  pm_staytimeout(domain, PM_NORMAL, (count ? count : 1) * 1000);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_governor_initialize
+ *
+ * Description:
+ *   Return the QoS governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_qos_governor_initialize(void)
+{
+  return &g_qos_governor_ops;
+}
@@ -81,9 +81,39 @@ struct regmap_s
 
   int reg_stride;
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* Register cache state, see regmap_cache.c. */
+
+  enum regcache_type_e cache_type;
+  bool cache_only;
+  unsigned int max_register;
+  FAR const struct regmap_range_s *volatile_ranges;
+  unsigned int num_volatile_ranges;
+  FAR void *cache;
+#endif
+
   /* Prevent fragmentation */
 
   mutex_t mutex[0];
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/* Called with the regmap lock held, except regcache_init/regcache_exit. */
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config);
+void regcache_exit(FAR struct regmap_s *map);
+bool regcache_volatile(FAR struct regmap_s *map, unsigned int reg);
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val);
+int regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int val, bool dirty);
+
+#endif /* CONFIG_REGMAP_CACHE */
+
 #endif /* __DRIVERS_REGMAP_INTERNAL_H */
@@ -29,6 +29,7 @@
 #include <nuttx/kmalloc.h>
 
 #include <debug.h>
+#include <string.h>
 
 #include "internal.h"
 
@@ -61,6 +62,114 @@ static void regmap_unlock_mutex(FAR void *context)
   nxmutex_unlock(&map->mutex[0]);
 }
 
+static unsigned int regmap_get_val(FAR struct regmap_s *map,
+                                   FAR const void *buf)
+{
+  switch (map->val_bytes)
+    {
+      case 4:
+        return *(FAR const uint32_t *)buf;
+      case 2:
+        return *(FAR const uint16_t *)buf;
+      default:
+        return *(FAR const uint8_t *)buf;
+    }
+}
+
+#ifdef CONFIG_REGMAP_CACHE
+static void regmap_put_val(FAR struct regmap_s *map, FAR void *buf,
+                           unsigned int val)
+{
+  switch (map->val_bytes)
+    {
+      case 4:
+        *(FAR uint32_t *)buf = val;
+        break;
+      case 2:
+        *(FAR uint16_t *)buf = val;
+        break;
+      default:
+        *(FAR uint8_t *)buf = val;
+        break;
+    }
+}
+#endif
+
+/* Register address goes on the wire most significant byte first. */
+
+static void regmap_format_reg(FAR struct regmap_s *map, FAR uint8_t *buf,
+                              unsigned int reg)
+{
+  int i;
+
+  DEBUGASSERT(map->reg_bytes <= sizeof(reg));
+
+  for (i = map->reg_bytes - 1; i >= 0; i--)
+    {
+      buf[i] = reg & 0xff;
+      reg >>= 8;
+    }
+}
+
+/* Single register access, called with the regmap lock held.
+ * Non-volatile registers are served from and kept in the register cache.
+ */
+
+static int regmap_do_read(FAR struct regmap_s *map, unsigned int reg,
+                          FAR void *val)
+{
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  unsigned int ival;
+  bool cached = !regcache_volatile(map, reg);
+
+  if (cached && regcache_read(map, reg, &ival) >= 0)
+    {
+      regmap_put_val(map, val, ival);
+      return OK;
+    }
+#endif
+
+  ret = map->reg_read(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0 && cached)
+    {
+      regcache_write(map, reg, regmap_get_val(map, val), false);
+    }
+#endif
+
+  return ret;
+}
+
+static int regmap_do_write(FAR struct regmap_s *map, unsigned int reg,
+                           unsigned int val)
+{
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  bool cached = !regcache_volatile(map, reg);
+
+  if (cached && map->cache_only &&
+      regcache_write(map, reg, val, true) >= 0)
+    {
+      return OK;
+    }
+#endif
+
+  ret = map->reg_write(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0 && cached)
+    {
+      regcache_write(map, reg, val, false);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -122,6 +231,8 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
       map->unlock = regmap_unlock_mutex;
     }
 
+  map->disable_locking = config->disable_locking;
+
   if (config->reg_stride != 0)
     {
       map->reg_stride = config->reg_stride;
@@ -140,6 +251,20 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
   map->read  = bus->read;
   map->write = bus->write;
 
+#ifdef CONFIG_REGMAP_CACHE
+  if (regcache_init(map, config) < 0)
+    {
+      regcache_exit(map);
+      if (!map->disable_locking)
+        {
+          nxmutex_destroy(&map->mutex[0]);
+        }
+
+      kmm_free(map);
+      return NULL;
+    }
+#endif
+
   return map;
 }
 
@@ -173,7 +298,7 @@ int regmap_write(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
-  ret = map->reg_write(map->bus, reg, val);
+  ret = regmap_do_write(map, reg, val);
 
   map->unlock(map);
 
@@ -209,14 +334,46 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
   int ret = -ENOSYS;
   unsigned int ival;
   FAR uint8_t *ptr;
+  FAR uint8_t *buf;
   int i;
 
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->write != NULL && !map->cache_only)
+#else
   if (map->write != NULL)
+#endif
     {
-      ret = map->write(map->bus, val, val_bytes * val_count);
+      /* A single burst carrying the start address and all the values. */
+
+      buf = kmm_malloc(map->reg_bytes + val_bytes * val_count);
+      if (buf == NULL)
+        {
+          ret = -ENOMEM;
+          goto out;
+        }
+
+      regmap_format_reg(map, buf, reg);
+      memcpy(buf + map->reg_bytes, val, val_bytes * val_count);
+      ret = map->write(map->bus, buf,
+                       map->reg_bytes + val_bytes * val_count);
+      kmm_free(buf);
+
+#ifdef CONFIG_REGMAP_CACHE
+      for (i = 0; ret >= 0 && i < val_count; i++)
+        {
+          if (!regcache_volatile(map, reg + (i * map->reg_stride)))
+            {
+              ptr = (FAR uint8_t *)val + (i * val_bytes);
+              regcache_write(map, reg + (i * map->reg_stride),
+                             regmap_get_val(map, ptr), false);
+            }
+        }
+#endif
+
       goto out;
     }
 
@@ -239,7 +396,7 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
             goto out;
         }
 
-      ret = map->reg_write(map->bus, reg + (i * map->reg_stride), ival);
+      ret = regmap_do_write(map, reg + (i * map->reg_stride), ival);
       if (ret < 0)
         {
           break;
@@ -280,7 +437,7 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg, FAR void *val)
 
   map->lock(map);
 
-  ret = map->reg_read(map->bus, reg, val);
+  ret = regmap_do_read(map, reg, val);
 
   map->unlock(map);
   return ret;
@@ -314,6 +471,7 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
   FAR uint32_t *u32 = val;
   FAR uint16_t *u16 = val;
   FAR uint8_t  *u8  = val;
+  uint8_t regbuf[sizeof(reg)];
   unsigned int ival;
   int ret = -ENOSYS;
   int i;
@@ -322,15 +480,53 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* Serve the whole block from the cache if every register is there. */
+
+  for (i = 0; map->cache != NULL && i < val_count; i++)
+    {
+      if (regcache_volatile(map, reg + (i * map->reg_stride)) ||
+          regcache_read(map, reg + (i * map->reg_stride), &ival) < 0)
+        {
+          break;
+        }
+
+      regmap_put_val(map, u8 + (i * map->val_bytes), ival);
+    }
+
+  if (map->cache != NULL && i == val_count)
+    {
+      map->unlock(map);
+      return OK;
+    }
+#endif
+
   if (map->read != NULL)
     {
-      ret = map->read(map->bus, &reg, map->reg_bytes, val, val_count);
+      /* A single burst starting at reg. */
+
+      regmap_format_reg(map, regbuf, reg);
+      ret = map->read(map->bus, regbuf, map->reg_bytes, val,
+                      val_count * map->val_bytes);
+
+#ifdef CONFIG_REGMAP_CACHE
+      for (i = 0; ret >= 0 && i < val_count; i++)
+        {
+          if (!regcache_volatile(map, reg + (i * map->reg_stride)))
+            {
+              regcache_write(map, reg + (i * map->reg_stride),
+                             regmap_get_val(map,
+                                            u8 + (i * map->val_bytes)),
+                             false);
+            }
+        }
+#endif
     }
   else
     {
       for (i = 0; i < val_count; i++)
         {
-          ret = map->reg_read(map->bus, reg + (i * map->reg_stride), &ival);
+          ret = regmap_do_read(map, reg + (i * map->reg_stride), &ival);
           if (ret < 0)
             {
               break;
@@ -359,6 +555,52 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write the bits selected by mask. The register is written
+ *   only if its value actually changes, and with the register cache the
+ *   read is served from RAM.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - bits to be updated.
+ *   val  - new value of the bits selected by mask.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val)
+{
+  uint32_t buf = 0;
+  unsigned int orig;
+  unsigned int tmp;
+  int ret;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+  map->lock(map);
+
+  ret = regmap_do_read(map, reg, &buf);
+  if (ret >= 0)
+    {
+      orig = regmap_get_val(map, &buf);
+      tmp  = (orig & ~mask) | (val & mask);
+      if (tmp != orig)
+        {
+          ret = regmap_do_write(map, reg, tmp);
+        }
+    }
+
+  map->unlock(map);
+  return ret < 0 ? ret : OK;
+}
+
 /****************************************************************************
  * Name: regmap_exit
  *
@@ -374,6 +616,10 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
 void regmap_exit(FAR struct regmap_s *map)
 {
+#ifdef CONFIG_REGMAP_CACHE
+  regcache_exit(map);
+#endif
+
   if (!map->disable_locking)
     {
       nxmutex_destroy(&map->mutex[0]);
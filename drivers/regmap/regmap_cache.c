@@ -0,0 +1,416 @@
+/****************************************************************************
+ * drivers/regmap/regmap_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/tree.h>
+#include <errno.h>
+
+#include <nuttx/regmap/regmap.h>
+#include <nuttx/kmalloc.h>
+
+#include "internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define REGCACHE_VALID  (1 << 0)
+#define REGCACHE_DIRTY  (1 << 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* REGCACHE_FLAT: one slot per register from 0 to max_register, the flags
+ * array follows the values in the same allocation.
+ */
+
+struct regcache_flat_s
+{
+  unsigned int nregs;
+  FAR uint8_t *flags;
+  unsigned int vals[1];
+};
+
+/* REGCACHE_RBTREE: one node per cached register. */
+
+struct regcache_rbnode_s
+{
+  RB_ENTRY(regcache_rbnode_s) link;
+  unsigned int reg;
+  unsigned int val;
+  bool dirty;
+};
+
+RB_HEAD(regcache_rbtree_s, regcache_rbnode_s);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int regcache_rbnode_compare(FAR struct regcache_rbnode_s *a,
+                                   FAR struct regcache_rbnode_s *b)
+{
+  return a->reg < b->reg ? -1 : a->reg > b->reg;
+}
+
+RB_GENERATE_STATIC(regcache_rbtree_s, regcache_rbnode_s, link,
+                   regcache_rbnode_compare)
+
+static FAR struct regcache_rbnode_s *
+regcache_rbtree_find(FAR struct regmap_s *map, unsigned int reg)
+{
+  struct regcache_rbnode_s search;
+
+  search.reg = reg;
+  return RB_FIND(regcache_rbtree_s, map->cache, &search);
+}
+
+static int regcache_flat_index(FAR struct regmap_s *map, unsigned int reg)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+  unsigned int index = reg / map->reg_stride;
+
+  return index < flat->nregs ? (int)index : -EINVAL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_init
+ *
+ * Description:
+ *   Allocate the register cache described by config and seed it with the
+ *   register defaults.
+ *
+ ****************************************************************************/
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config)
+{
+  FAR struct regcache_flat_s *flat;
+  unsigned int nregs;
+  unsigned int i;
+
+  map->cache_type          = config->cache_type;
+  map->max_register        = config->max_register;
+  map->volatile_ranges     = config->volatile_ranges;
+  map->num_volatile_ranges = config->num_volatile_ranges;
+
+  if (map->cache_type != REGCACHE_NONE && map->val_bytes != 1 &&
+      map->val_bytes != 2 && map->val_bytes != 4)
+    {
+      return -EINVAL;
+    }
+
+  switch (map->cache_type)
+    {
+      case REGCACHE_NONE:
+        return OK;
+
+      case REGCACHE_FLAT:
+        if (map->max_register == 0)
+          {
+            return -EINVAL;
+          }
+
+        nregs = map->max_register / map->reg_stride + 1;
+        flat  = kmm_zalloc(sizeof(*flat) +
+                           nregs * (sizeof(unsigned int) + 1));
+        if (flat == NULL)
+          {
+            return -ENOMEM;
+          }
+
+        flat->nregs = nregs;
+        flat->flags = (FAR uint8_t *)&flat->vals[nregs];
+        map->cache  = flat;
+        break;
+
+      case REGCACHE_RBTREE:
+        map->cache = kmm_malloc(sizeof(struct regcache_rbtree_s));
+        if (map->cache == NULL)
+          {
+            return -ENOMEM;
+          }
+
+        RB_INIT((FAR struct regcache_rbtree_s *)map->cache);
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  for (i = 0; i < config->num_reg_defaults; i++)
+    {
+      regcache_write(map, config->reg_defaults[i].reg,
+                     config->reg_defaults[i].def, false);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regcache_exit
+ ****************************************************************************/
+
+void regcache_exit(FAR struct regmap_s *map)
+{
+  FAR struct regcache_rbnode_s *node;
+  FAR struct regcache_rbnode_s *temp;
+
+  if (map->cache == NULL)
+    {
+      return;
+    }
+
+  if (map->cache_type == REGCACHE_RBTREE)
+    {
+      RB_FOREACH_SAFE(node, regcache_rbtree_s, map->cache, temp)
+        {
+          RB_REMOVE(regcache_rbtree_s, map->cache, node);
+          kmm_free(node);
+        }
+    }
+
+  kmm_free(map->cache);
+  map->cache = NULL;
+}
+
+/****************************************************************************
+ * Name: regcache_volatile
+ *
+ * Description:
+ *   Return true if reg must always be accessed on the bus.
+ *
+ ****************************************************************************/
+
+bool regcache_volatile(FAR struct regmap_s *map, unsigned int reg)
+{
+  unsigned int i;
+
+  if (map->cache == NULL)
+    {
+      return true;
+    }
+
+  for (i = 0; i < map->num_volatile_ranges; i++)
+    {
+      if (reg >= map->volatile_ranges[i].range_min &&
+          reg <= map->volatile_ranges[i].range_max)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: regcache_read
+ *
+ * Description:
+ *   Look up reg in the cache, -ENOENT is returned on a miss.
+ *
+ ****************************************************************************/
+
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+  FAR struct regcache_rbnode_s *node;
+  int index;
+
+  if (map->cache_type == REGCACHE_FLAT)
+    {
+      index = regcache_flat_index(map, reg);
+      if (index < 0 || !(flat->flags[index] & REGCACHE_VALID))
+        {
+          return -ENOENT;
+        }
+
+      *val = flat->vals[index];
+      return OK;
+    }
+
+  node = regcache_rbtree_find(map, reg);
+  if (node == NULL)
+    {
+      return -ENOENT;
+    }
+
+  *val = node->val;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regcache_write
+ *
+ * Description:
+ *   Store val as the current value of reg. dirty means the hardware
+ *   doesn't hold it yet.
+ *
+ ****************************************************************************/
+
+int regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int val, bool dirty)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+  FAR struct regcache_rbnode_s *node;
+  int index;
+
+  if (map->cache_type == REGCACHE_FLAT)
+    {
+      index = regcache_flat_index(map, reg);
+      if (index < 0)
+        {
+          return index;
+        }
+
+      flat->vals[index]  = val;
+      flat->flags[index] = REGCACHE_VALID | (dirty ? REGCACHE_DIRTY : 0);
+      return OK;
+    }
+
+  node = regcache_rbtree_find(map, reg);
+  if (node == NULL)
+    {
+      node = kmm_malloc(sizeof(*node));
+      if (node == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      node->reg = reg;
+      RB_INSERT(regcache_rbtree_s, map->cache, node);
+    }
+
+  node->val   = val;
+  node->dirty = dirty;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regcache_cache_only
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable)
+{
+  map->lock(map);
+  map->cache_only = enable;
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_sync
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+  FAR struct regcache_rbnode_s *node;
+  unsigned int i;
+  int ret = OK;
+
+  map->lock(map);
+
+  if (map->cache == NULL)
+    {
+      goto out;
+    }
+
+  if (map->cache_type == REGCACHE_FLAT)
+    {
+      for (i = 0; i < flat->nregs; i++)
+        {
+          if (flat->flags[i] & REGCACHE_DIRTY)
+            {
+              ret = map->reg_write(map->bus, i * map->reg_stride,
+                                   flat->vals[i]);
+              if (ret < 0)
+                {
+                  goto out;
+                }
+
+              flat->flags[i] &= ~REGCACHE_DIRTY;
+            }
+        }
+    }
+  else
+    {
+      RB_FOREACH(node, regcache_rbtree_s, map->cache)
+        {
+          if (node->dirty)
+            {
+              ret = map->reg_write(map->bus, node->reg, node->val);
+              if (ret < 0)
+                {
+                  goto out;
+                }
+
+              node->dirty = false;
+            }
+        }
+    }
+
+out:
+  map->unlock(map);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+  FAR struct regcache_rbnode_s *node;
+  unsigned int i;
+
+  map->lock(map);
+
+  if (map->cache_type == REGCACHE_FLAT && flat != NULL)
+    {
+      for (i = 0; i < flat->nregs; i++)
+        {
+          if (flat->flags[i] & REGCACHE_VALID)
+            {
+              flat->flags[i] |= REGCACHE_DIRTY;
+            }
+        }
+    }
+  else if (map->cache_type == REGCACHE_RBTREE && map->cache != NULL)
+    {
+      RB_FOREACH(node, regcache_rbtree_s, map->cache)
+        {
+          node->dirty = true;
+        }
+    }
+
+  map->unlock(map);
+}
@@ -137,6 +137,9 @@ static void rpmsg_port_destroy_queue(FAR struct rpmsg_port_queue_s *queue)
   kmm_free(queue->node);
   nxsem_destroy(&queue->free.sem);
   nxsem_destroy(&queue->ready.sem);
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+  nxsem_destroy(&queue->urgent.sem);
+#endif
 }
 
 /****************************************************************************
@@ -191,6 +194,14 @@ static int rpmsg_port_create_queue(FAR struct rpmsg_port_queue_s *queue,
   nxsem_init(&queue->ready.sem, 0, 0);
   list_initialize(&queue->ready.head);
 
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+  /* Init urgent list, waiters of the ready list are posted for it too */
+
+  spin_lock_init(&queue->urgent.lock);
+  nxsem_init(&queue->urgent.sem, 0, 0);
+  list_initialize(&queue->urgent.head);
+#endif
+
   return 0;
 }
 
@@ -234,6 +245,30 @@ static void rpmsg_port_destroy_queues(FAR struct rpmsg_port_s *port)
   rpmsg_port_destroy_queue(&port->rxq);
 }
 
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+
+/****************************************************************************
+ * Name: rpmsg_port_is_urgent
+ ****************************************************************************/
+
+static bool rpmsg_port_is_urgent(FAR struct rpmsg_port_s *port,
+                                 uint32_t addr)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_RPMSG_PORT_PRIORITY_NEPTS; i++)
+    {
+      if (port->urgent[i] == addr)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_get_tx_payload_buffer
  ****************************************************************************/
@@ -282,7 +317,19 @@ static int rpmsg_port_send_offchannel_nocopy(FAR struct rpmsg_device *rdev,
   hdr->len = sizeof(struct rpmsg_port_header_s) +
              sizeof(struct rpmsg_hdr) + len;
 
-  rpmsg_port_queue_add_buffer(&port->txq, hdr);
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+  if (rpmsg_port_is_urgent(port, src))
+    {
+      rpmsg_port_add_node(&port->txq.urgent,
+                          RPMSG_PORT_BUF_TO_NODE(&port->txq, hdr));
+      rpmsg_port_post(&port->txq.ready.sem);
+    }
+  else
+#endif
+    {
+      rpmsg_port_queue_add_buffer(&port->txq, hdr);
+    }
+
   if (port->ops->notify_tx_ready)
     {
       port->ops->notify_tx_ready(port);
@@ -569,6 +616,13 @@ int rpmsg_port_initialize(FAR struct rpmsg_port_s *port,
   port->ops = ops;
   strlcpy(port->rpmsg.cpuname, cfg->remotecpu, RPMSG_NAME_SIZE);
 
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+  for (ret = 0; ret < CONFIG_RPMSG_PORT_PRIORITY_NEPTS; ret++)
+    {
+      port->urgent[ret] = RPMSG_ADDR_ANY;
+    }
+#endif
+
   rdev = &port->rdev;
   memset(rdev, 0, sizeof(*rdev));
   metal_mutex_init(&rdev->lock);
@@ -673,7 +727,25 @@ rpmsg_port_queue_get_buffer(FAR struct rpmsg_port_queue_s *queue, bool wait)
 
   for (; ; )
     {
-      node = rpmsg_port_remove_node(&queue->ready);
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+      /* Urgent buffers go first, but give way to a normal buffer after
+       * CONFIG_RPMSG_PORT_PRIORITY_WEIGHT of them in a row.
+       */
+
+      node = NULL;
+      if (queue->burst < CONFIG_RPMSG_PORT_PRIORITY_WEIGHT ||
+          list_is_empty(&queue->ready.head))
+        {
+          node = rpmsg_port_remove_node(&queue->urgent);
+        }
+
+      queue->burst = node ? queue->burst + 1 : 0;
+      if (node == NULL)
+#endif
+        {
+          node = rpmsg_port_remove_node(&queue->ready);
+        }
+
       if (node)
         {
           return RPMSG_PORT_NODE_TO_BUF(queue, node);
@@ -700,6 +772,54 @@ void rpmsg_port_queue_add_buffer(FAR struct rpmsg_port_queue_s *queue,
   rpmsg_port_post(&queue->ready.sem);
 }
 
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+
+/****************************************************************************
+ * Name: rpmsg_port_set_priority
+ ****************************************************************************/
+
+int rpmsg_port_set_priority(FAR struct rpmsg_endpoint *ept, bool urgent)
+{
+  FAR struct rpmsg_port_s *port;
+  irqstate_t flags;
+  uint32_t from;
+  uint32_t to;
+  int ret = -ENOSPC;
+  int i;
+
+  if (ept->rdev == NULL ||
+      ept->rdev->ops.send_offchannel_raw != rpmsg_port_send_offchannel_raw)
+    {
+      return -ENOTTY;
+    }
+
+  port = metal_container_of(ept->rdev, struct rpmsg_port_s, rdev);
+  from = urgent ? RPMSG_ADDR_ANY : ept->addr;
+  to   = urgent ? ept->addr : RPMSG_ADDR_ANY;
+
+  flags = spin_lock_irqsave(&port->txq.urgent.lock);
+  if (rpmsg_port_is_urgent(port, ept->addr) == urgent)
+    {
+      spin_unlock_irqrestore(&port->txq.urgent.lock, flags);
+      return 0;
+    }
+
+  for (i = 0; i < CONFIG_RPMSG_PORT_PRIORITY_NEPTS; i++)
+    {
+      if (port->urgent[i] == from)
+        {
+          port->urgent[i] = to;
+          ret = 0;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&port->txq.urgent.lock, flags);
+  return ret;
+}
+
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_drop_packets
  ****************************************************************************/
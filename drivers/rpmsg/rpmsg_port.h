@@ -98,6 +98,16 @@ struct rpmsg_port_queue_s
   /* Ready list of buffers which have been occupied data already */
 
   struct rpmsg_port_list_s ready;
+
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+  /* Ready list of buffers sent by the urgent endpoints */
+
+  struct rpmsg_port_list_s urgent;
+
+  /* Number of urgent buffers got in a row */
+
+  uint16_t                 burst;
+#endif
 };
 
 typedef void (*rpmsg_port_rx_cb_t)(FAR struct rpmsg_port_s *port,
@@ -137,6 +147,12 @@ struct rpmsg_port_s
   struct rpmsg_port_queue_s         txq;    /* Port tx queue */
   struct rpmsg_port_queue_s         rxq;    /* Port rx queue */
 
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+  /* Local addresses of the urgent endpoints */
+
+  uint32_t                          urgent[CONFIG_RPMSG_PORT_PRIORITY_NEPTS];
+#endif
+
   /* Ops need implemented by drivers under port layer */
 
   const FAR struct rpmsg_port_ops_s *ops;
@@ -271,7 +287,11 @@ uint16_t rpmsg_port_queue_navail(FAR struct rpmsg_port_queue_s *queue)
 static inline_function
 uint16_t rpmsg_port_queue_nused(FAR struct rpmsg_port_queue_s *queue)
 {
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+  return atomic_read(&queue->ready.num) + atomic_read(&queue->urgent.num);
+#else
   return atomic_read(&queue->ready.num);
+#endif
 }
 
 /****************************************************************************
@@ -0,0 +1,336 @@
+/****************************************************************************
+ * drivers/rpmsg/rpmsg_shm.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/rpmsg/rpmsg_shm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RPMSG_SHM_LINE              CONFIG_RPMSG_SHM_LINESIZE
+
+/* The pools of a cpu pair */
+
+#define RPMSG_SHM_TX                0  /* Allocated by the local cpu */
+#define RPMSG_SHM_RX                1  /* Allocated by the remote cpu */
+
+/* Set in a handle if the buffer is in the pool of the receiver of the
+ * handle, i.e. the buffer was allocated by the receiver.
+ */
+
+#define RPMSG_SHM_PEER              0x80000000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Each pool starts with the states of its blocks, one per cache line,
+ * followed by the blocks.  The state of a free block is zero, the states
+ * of the blocks of a buffer are the number of blocks of the buffer.  Only
+ * the cpu owning the pool marks its blocks busy, and only the cpu holding
+ * a buffer marks its blocks free.
+ */
+
+struct rpmsg_shm_s
+{
+  struct list_node node;
+  char             cpuname[RPMSG_NAME_SIZE];
+  FAR uint8_t     *base[2];     /* The pools, RPMSG_SHM_TX/RX */
+  size_t           blksize;     /* The size of a block */
+  uint32_t         nblocks;     /* The number of blocks of a pool */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct list_node g_rpmsg_shm = LIST_INITIAL_VALUE(g_rpmsg_shm);
+static spinlock_t g_rpmsg_shm_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR volatile uint32_t *
+rpmsg_shm_state(FAR struct rpmsg_shm_s *shm, int pool, uint32_t index)
+{
+  return (FAR volatile uint32_t *)(shm->base[pool] +
+                                   index * RPMSG_SHM_LINE);
+}
+
+static FAR uint8_t *rpmsg_shm_data(FAR struct rpmsg_shm_s *shm, int pool)
+{
+  return shm->base[pool] + shm->nblocks * RPMSG_SHM_LINE;
+}
+
+static uint32_t rpmsg_shm_getstate(FAR struct rpmsg_shm_s *shm, int pool,
+                                   uint32_t index)
+{
+  FAR volatile uint32_t *state = rpmsg_shm_state(shm, pool, index);
+
+  up_invalidate_dcache((uintptr_t)state, (uintptr_t)state + RPMSG_SHM_LINE);
+  return *state;
+}
+
+static void rpmsg_shm_setstate(FAR struct rpmsg_shm_s *shm, int pool,
+                               uint32_t index, uint32_t value)
+{
+  FAR volatile uint32_t *state = rpmsg_shm_state(shm, pool, index);
+
+  *state = value;
+  up_flush_dcache((uintptr_t)state, (uintptr_t)state + RPMSG_SHM_LINE);
+}
+
+static FAR struct rpmsg_shm_s *
+rpmsg_shm_find(FAR struct rpmsg_endpoint *ept)
+{
+  FAR const char *cpuname = rpmsg_get_cpuname(ept->rdev);
+  FAR struct rpmsg_shm_s *shm;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_rpmsg_shm_lock);
+  list_for_every_entry(&g_rpmsg_shm, shm, struct rpmsg_shm_s, node)
+    {
+      if (strcmp(shm->cpuname, cpuname) == 0)
+        {
+          spin_unlock_irqrestore(&g_rpmsg_shm_lock, flags);
+          return shm;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_rpmsg_shm_lock, flags);
+  return NULL;
+}
+
+static int rpmsg_shm_locate(FAR struct rpmsg_shm_s *shm, FAR void *buf,
+                            FAR uint32_t *offset)
+{
+  FAR uint8_t *data;
+  int pool;
+
+  for (pool = RPMSG_SHM_TX; pool <= RPMSG_SHM_RX; pool++)
+    {
+      data = rpmsg_shm_data(shm, pool);
+      if ((FAR uint8_t *)buf >= data &&
+          (FAR uint8_t *)buf < data + shm->nblocks * shm->blksize)
+        {
+          *offset = (FAR uint8_t *)buf - data;
+          return pool;
+        }
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int rpmsg_shm_register(FAR const char *cpuname, FAR void *txbase,
+                       FAR void *rxbase, size_t size, size_t blksize)
+{
+  FAR struct rpmsg_shm_s *shm;
+  irqstate_t flags;
+  uint32_t nblocks;
+
+  if (cpuname == NULL || txbase == NULL || rxbase == NULL ||
+      blksize == 0 || blksize % RPMSG_SHM_LINE != 0)
+    {
+      return -EINVAL;
+    }
+
+  nblocks = size / (blksize + RPMSG_SHM_LINE);
+  if (nblocks == 0)
+    {
+      return -EINVAL;
+    }
+
+  shm = kmm_zalloc(sizeof(*shm));
+  if (shm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  strlcpy(shm->cpuname, cpuname, sizeof(shm->cpuname));
+  shm->base[RPMSG_SHM_TX] = txbase;
+  shm->base[RPMSG_SHM_RX] = rxbase;
+  shm->blksize            = blksize;
+  shm->nblocks            = nblocks;
+
+  /* All the blocks of the local pool are free */
+
+  memset(txbase, 0, nblocks * RPMSG_SHM_LINE);
+  up_flush_dcache((uintptr_t)txbase,
+                  (uintptr_t)txbase + nblocks * RPMSG_SHM_LINE);
+
+  flags = spin_lock_irqsave(&g_rpmsg_shm_lock);
+  list_add_tail(&g_rpmsg_shm, &shm->node);
+  spin_unlock_irqrestore(&g_rpmsg_shm_lock, flags);
+  return OK;
+}
+
+FAR void *rpmsg_shm_alloc(FAR struct rpmsg_endpoint *ept, size_t size)
+{
+  FAR struct rpmsg_shm_s *shm;
+  irqstate_t flags;
+  uint32_t need;
+  uint32_t run;
+  uint32_t i;
+
+  shm = rpmsg_shm_find(ept);
+  if (shm == NULL || size == 0)
+    {
+      return NULL;
+    }
+
+  need = (size + shm->blksize - 1) / shm->blksize;
+
+  /* Find the first run of free blocks large enough */
+
+  flags = spin_lock_irqsave(&g_rpmsg_shm_lock);
+  for (i = 0, run = 0; i < shm->nblocks; i++)
+    {
+      if (rpmsg_shm_getstate(shm, RPMSG_SHM_TX, i) != 0)
+        {
+          run = 0;
+        }
+      else if (++run == need)
+        {
+          i -= need - 1;
+          for (run = 0; run < need; run++)
+            {
+              rpmsg_shm_setstate(shm, RPMSG_SHM_TX, i + run, need);
+            }
+
+          spin_unlock_irqrestore(&g_rpmsg_shm_lock, flags);
+          return rpmsg_shm_data(shm, RPMSG_SHM_TX) + i * shm->blksize;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_rpmsg_shm_lock, flags);
+  return NULL;
+}
+
+void rpmsg_shm_free(FAR struct rpmsg_endpoint *ept, FAR void *buf)
+{
+  FAR struct rpmsg_shm_s *shm;
+  irqstate_t flags;
+  uint32_t offset;
+  uint32_t index;
+  uint32_t nblocks;
+  int pool;
+
+  shm = rpmsg_shm_find(ept);
+  if (shm == NULL || buf == NULL)
+    {
+      return;
+    }
+
+  pool = rpmsg_shm_locate(shm, buf, &offset);
+  DEBUGASSERT(pool >= 0 && offset % shm->blksize == 0);
+  if (pool < 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_rpmsg_shm_lock);
+  index   = offset / shm->blksize;
+  nblocks = rpmsg_shm_getstate(shm, pool, index);
+  DEBUGASSERT(nblocks > 0 && index + nblocks <= shm->nblocks);
+
+  while (nblocks-- > 0)
+    {
+      rpmsg_shm_setstate(shm, pool, index++, 0);
+    }
+
+  spin_unlock_irqrestore(&g_rpmsg_shm_lock, flags);
+}
+
+uint32_t rpmsg_shm_handle(FAR struct rpmsg_endpoint *ept, FAR void *buf)
+{
+  FAR struct rpmsg_shm_s *shm;
+  uint32_t offset;
+  int pool;
+
+  shm = rpmsg_shm_find(ept);
+  if (shm == NULL)
+    {
+      return RPMSG_SHM_INVALID;
+    }
+
+  pool = rpmsg_shm_locate(shm, buf, &offset);
+  if (pool < 0)
+    {
+      return RPMSG_SHM_INVALID;
+    }
+
+  /* The local pool is the pool of the remote cpu for the receiver */
+
+  return pool == RPMSG_SHM_TX ? offset : offset | RPMSG_SHM_PEER;
+}
+
+FAR void *rpmsg_shm_ptr(FAR struct rpmsg_endpoint *ept, uint32_t handle,
+                        size_t len)
+{
+  FAR struct rpmsg_shm_s *shm;
+  uint32_t offset = handle & ~RPMSG_SHM_PEER;
+  size_t size;
+  int pool;
+
+  shm = rpmsg_shm_find(ept);
+  if (shm == NULL || handle == RPMSG_SHM_INVALID)
+    {
+      return NULL;
+    }
+
+  size = shm->nblocks * shm->blksize;
+  if (offset >= size || len > size - offset)
+    {
+      return NULL;
+    }
+
+  pool = (handle & RPMSG_SHM_PEER) ? RPMSG_SHM_TX : RPMSG_SHM_RX;
+  return rpmsg_shm_data(shm, pool) + offset;
+}
+
+void rpmsg_shm_flush(FAR const void *buf, size_t len)
+{
+  up_flush_dcache((uintptr_t)buf, (uintptr_t)buf + len);
+}
+
+void rpmsg_shm_invalidate(FAR const void *buf, size_t len)
+{
+  up_invalidate_dcache((uintptr_t)buf, (uintptr_t)buf + len);
+}
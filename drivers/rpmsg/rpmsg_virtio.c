@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/power/pm.h>
@@ -49,7 +50,8 @@
 #define RPMSG_VIRTIO_FEATURES        (1 << VIRTIO_RPMSG_F_NS | \
                                       1 << VIRTIO_RPMSG_F_ACK | \
                                       1 << VIRTIO_RPMSG_F_BUFSZ | \
-                                      1 << VIRTIO_RPMSG_F_CPUNAME)
+                                      1 << VIRTIO_RPMSG_F_CPUNAME | \
+                                      VIRTIO_RING_F_EVENT_IDX)
 
 #ifdef CONFIG_OPENAMP_CACHE
 #  define RPMSG_VIRTIO_INVALIDATE(x) metal_cache_invalidate(&x, sizeof(x))
@@ -252,6 +254,71 @@ static void rpmsg_virtio_rx_worker(FAR struct rpmsg_virtio_priv_s *priv)
     }
 }
 
+#if CONFIG_RPMSG_VIRTIO_POLL_US > 0
+
+/****************************************************************************
+ * Name: rpmsg_virtio_pending_rx
+ ****************************************************************************/
+
+static bool rpmsg_virtio_pending_rx(FAR struct rpmsg_virtio_priv_s *priv)
+{
+  FAR struct rpmsg_virtio_device *rvdev = &priv->rvdev;
+
+  if (rpmsg_virtio_get_role(rvdev) == RPMSG_HOST)
+    {
+      return virtqueue_nused(rvdev->rvq) > 0;
+    }
+  else
+    {
+      return virtqueue_navail(rvdev->rvq) > 0;
+    }
+}
+
+/****************************************************************************
+ * Name: rpmsg_virtio_poll_rx
+ *
+ * Description:
+ *   Poll the rx vring with the peer notification suppressed while messages
+ *   keep arriving, and go back to the notification once the vring stays
+ *   empty for CONFIG_RPMSG_VIRTIO_POLL_US.
+ *
+ ****************************************************************************/
+
+static void rpmsg_virtio_poll_rx(FAR struct rpmsg_virtio_priv_s *priv)
+{
+  FAR struct virtqueue *rvq = priv->rvdev.rvq;
+  unsigned int idle = 0;
+
+  virtqueue_disable_cb(rvq);
+  while (idle < CONFIG_RPMSG_VIRTIO_POLL_US)
+    {
+      if (rpmsg_virtio_pending_rx(priv))
+        {
+          priv->cbrx(rvq);
+          idle = 0;
+        }
+      else
+        {
+          up_udelay(1);
+          idle++;
+        }
+    }
+
+  /* The peer doesn't notify the message queued before the notification is
+   * enabled again, so check the vring once more.
+   */
+
+  virtqueue_enable_cb(rvq);
+  if (rpmsg_virtio_pending_rx(priv))
+    {
+      priv->cbrx(rvq);
+    }
+}
+
+#else
+#  define rpmsg_virtio_poll_rx(priv)
+#endif
+
 /****************************************************************************
  * Name: rpmsg_virtio_wakeup_rx
  ****************************************************************************/
@@ -593,6 +660,7 @@ static int rpmsg_virtio_thread(int argc, FAR char *argv[])
     {
       nxsem_wait_uninterruptible(&priv->semrx);
       rpmsg_virtio_rx_worker(priv);
+      rpmsg_virtio_poll_rx(priv);
     }
 
   return 0;
@@ -36,6 +36,9 @@
 
 #include <poll.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <nuttx/arch.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
@@ -121,6 +124,9 @@ struct sensor_upperhalf_s
   struct circbuf_s   buffer;             /* The circular buffer of data */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_mmap_s *mmap;        /* The buffers mapped by the users */
+#endif
 };
 
 /****************************************************************************
@@ -137,6 +143,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -229,7 +239,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -479,6 +493,57 @@ static void sensor_update_nonwakeup(FAR struct file *filep,
     }
 }
 
+static int sensor_init_buffer(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t bytes = lower->nbuffer * upper->state.esize;
+  int ret;
+
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_mmap_s *shm;
+  size_t data;
+  size_t timing;
+
+  /* Allocate the buffers in one block, after the header describing them,
+   * so that the users can map them.
+   */
+
+  data   = ALIGN_UP(sizeof(struct sensor_mmap_s), sizeof(uint64_t));
+  timing = ALIGN_UP(data + bytes, TIMING_BUF_ESIZE);
+  shm    = kmm_zalloc(timing + lower->nbuffer * TIMING_BUF_ESIZE);
+  if (shm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  shm->nbuffer = lower->nbuffer;
+  shm->esize   = upper->state.esize;
+  shm->data    = data;
+  shm->timing  = timing;
+
+  circbuf_init(&upper->buffer, (FAR char *)shm + data, bytes);
+  circbuf_init(&upper->timing, (FAR char *)shm + timing,
+               lower->nbuffer * TIMING_BUF_ESIZE);
+  upper->mmap = shm;
+  ret = 0;
+#else
+  ret = circbuf_init(&upper->buffer, NULL, bytes);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+    }
+#endif
+
+  return ret;
+}
+
 static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
                                    unsigned long nums)
 {
@@ -658,6 +723,41 @@ static ssize_t sensor_do_samples(FAR struct sensor_upperhalf_s *upper,
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_batch_read(FAR struct sensor_upperhalf_s *upper,
+                             FAR struct sensor_user_s *user,
+                             FAR struct sensor_batch_s *batch)
+{
+  size_t nums;
+
+  if (!circbuf_is_init(&upper->buffer) || !sensor_is_updated(upper, user))
+    {
+      return -ENODATA;
+    }
+
+  /* Take all the new samples, without copying them */
+
+  sensor_catch_up(upper, user);
+  nums = upper->timing.head / TIMING_BUF_ESIZE - user->bufferpos;
+  if (nums > batch->count)
+    {
+      nums = batch->count;
+    }
+
+  batch->index = user->bufferpos;
+  batch->count = nums;
+  if (nums > 0)
+    {
+      user->bufferpos += nums;
+      circbuf_peekat(&upper->timing,
+                     (user->bufferpos - 1) * TIMING_BUF_ESIZE,
+                     &user->state.generation, TIMING_BUF_ESIZE);
+    }
+
+  return 0;
+}
+#endif
+
 static void sensor_pollnotify_one(FAR struct sensor_user_s *user,
                                   pollevent_t eventset,
                                   sensor_role_t role)
@@ -1058,6 +1158,17 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_SENSORS_MMAP
+      case SNIOC_BATCH_READ:
+        {
+          nxrmutex_lock(&upper->lock);
+          ret = sensor_batch_read(upper, user,
+                             (FAR struct sensor_batch_s *)(uintptr_t)arg);
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+#endif
+
      case SNIOC_FLUSH:
         {
           /* If the sensor is not activated, return -EINVAL. */
@@ -1123,6 +1234,56 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t size;
+  int ret = 0;
+
+  /* The buffers are shared by all users, they are read-only */
+
+  if ((map->prot & PROT_WRITE) != 0)
+    {
+      return -EACCES;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  if (lower->ops->fetch || lower->nbuffer == 0)
+    {
+      ret = -ENOTSUP;
+      goto out;
+    }
+
+  /* Allocate the buffers now if no sample was published yet */
+
+  if (!circbuf_is_init(&upper->buffer))
+    {
+      ret = sensor_init_buffer(upper);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  size = upper->mmap->timing + lower->nbuffer * TIMING_BUF_ESIZE;
+  if (map->offset != 0 || map->length > size)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  map->vaddr = upper->mmap;
+
+out:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static int sensor_poll(FAR struct file *filep,
                        FAR struct pollfd *fds, bool setup)
 {
@@ -1226,26 +1387,23 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     {
       /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
+      ret = sensor_init_buffer(upper);
       if (ret < 0)
         {
           nxrmutex_unlock(&upper->lock);
           return ret;
         }
-
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
-        {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
     }
 
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* Publish the samples to the users reading them in place */
+
+  SMP_WMB();
+  upper->mmap->head = upper->timing.head / TIMING_BUF_ESIZE;
+#endif
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
       if (sensor_is_updated(upper, user))
@@ -1319,6 +1477,70 @@ void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
   memcpy(out, tmp, sizeof(tmp));
 }
 
+/****************************************************************************
+ * Name: sensor_push_fifo
+ *
+ * Description:
+ *   Push the samples drained from the hardware FIFO of the sensor, with
+ *   their timestamps interpolated back from the time of the newest sample.
+ *
+ * Input Parameters:
+ *   lower     - The instance of lower half sensor driver.
+ *   data      - The samples, oldest first.
+ *   bytes     - The number of bytes of the samples.
+ *   esize     - The size of a sample.
+ *   timestamp - The time the newest sample was taken, in us.
+ *   interval  - The nominal sample period, in us.
+ *
+ * Returned Value:
+ *   The bytes of push is returned when success;
+ *   A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_push_fifo(FAR struct sensor_lowerhalf_s *lower,
+                         FAR void *data, size_t bytes, size_t esize,
+                         uint64_t timestamp, uint32_t interval)
+{
+  FAR uint8_t *sample = data;
+  uint64_t period = interval;
+  uint64_t delta;
+  size_t nums;
+
+  DEBUGASSERT(lower != NULL && esize >= sizeof(uint64_t));
+
+  nums = bytes / esize;
+  if (nums == 0 || bytes != nums * esize)
+    {
+      return lower->push_event(lower->priv, data, bytes);
+    }
+
+  /* Measure the period since the newest sample of the previous batch, and
+   * trust it while it is close to the nominal one.
+   */
+
+  delta = timestamp - lower->fifo_timestamp;
+  if (lower->fifo_timestamp != 0 && timestamp > lower->fifo_timestamp &&
+      delta / nums >= period / 2 && delta / nums <= period * 2)
+    {
+      period = delta / nums;
+    }
+
+  lower->fifo_timestamp = timestamp;
+
+  /* The newest sample is the last one */
+
+  timestamp -= (nums - 1) * period;
+  while (nums-- > 0)
+    {
+      memcpy(sample, &timestamp, sizeof(timestamp));
+      timestamp += period;
+      sample    += esize;
+    }
+
+  return lower->push_event(lower->priv, data, bytes);
+}
+
 /****************************************************************************
  * Name: sensor_register
  *
@@ -1549,6 +1771,9 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
     {
       circbuf_uninit(&upper->buffer);
       circbuf_uninit(&upper->timing);
+#ifdef CONFIG_SENSORS_MMAP
+      kmm_free(upper->mmap);
+#endif
     }
 
   kmm_free(upper);
@@ -28,6 +28,7 @@
 
 #include <fcntl.h>
 #include <debug.h>
+#include <sys/param.h>
 
 #include <nuttx/nuttx.h>
 #include <nuttx/list.h>
@@ -912,6 +913,7 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
   FAR struct sensor_rpmsg_ept_s *sre;
   FAR struct sensor_rpmsg_data_s *msg;
   struct sensor_ustate_s state;
+  uint32_t window;
   uint64_t now;
   bool updated;
   int ret;
@@ -939,6 +941,19 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
       state.interval = 0;
     }
 
+  if (state.latency == UINT32_MAX)
+    {
+      state.latency = 0;
+    }
+
+  /* The samples may wait for the batch latency of the subscriber, or half
+   * of its interval, so that the samples of all topics sent to the remote
+   * cpu are coalesced into as few messages as possible.
+   */
+
+  window = MAX(state.latency, state.interval / 2);
+  window = MAX(window, CONFIG_SENSORS_RPMSG_BATCH_LATENCY);
+
   nxrmutex_lock(&sre->lock);
 
   /* Cancel work to fill new data to buffer */
@@ -1026,10 +1041,9 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
     }
   else
     {
-      if (sre->expire == UINT64_MAX ||
-          sre->expire - now > state.interval / 2)
+      if (sre->expire == UINT64_MAX || sre->expire - now > window)
         {
-          sre->expire = now + state.interval / 2;
+          sre->expire = now + window;
         }
 
       work_queue(HPWORK, &sre->work, sensor_rpmsg_data_worker, sre,
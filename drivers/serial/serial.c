@@ -889,6 +889,21 @@ static int uart_close(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: uart_rawinput
+ *
+ * Description:
+ *   Return true if the received data is returned as is, without any input
+ *   processing or echo.
+ *
+ ****************************************************************************/
+
+static inline bool uart_rawinput(FAR uart_dev_t *dev)
+{
+  return (dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0 &&
+         (dev->tc_lflag & (ICANON | ECHO)) == 0;
+}
+
 /****************************************************************************
  * Name: uart_readv
  ****************************************************************************/
@@ -901,13 +916,14 @@ static ssize_t uart_readv(FAR struct file *filep, FAR struct uio *uio)
 #ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
   unsigned int nbuffered;
   unsigned int watermark;
-  sbuf_size_t head;
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
   ssize_t buflen;
   bool echoed = false;
+  sbuf_size_t head;
   sbuf_size_t tail;
+  size_t nbytes;
   char ch;
   int ret;
 
@@ -963,8 +979,28 @@ static ssize_t uart_readv(FAR struct file *filep, FAR struct uio *uio)
        * The following code is therefore safe even with interrupts enabled.
        */
 
+      head = rxbuf->head;
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      if (head != tail && uart_rawinput(dev))
+        {
+          /* Without input processing, copy the contiguous data at the
+           * tail of the buffer (which is also the DMA buffer) at once.
+           */
+
+          nbytes = (head > tail ? head : rxbuf->size) - tail;
+          nbytes = MIN(nbytes, (size_t)(buflen - recvd));
+          uio_copyfrom(uio, recvd, &rxbuf->buffer[tail], nbytes);
+          recvd += nbytes;
+
+          tail += nbytes;
+          if (tail >= rxbuf->size)
+            {
+              tail = 0;
+            }
+
+          rxbuf->tail = tail;
+        }
+      else if (head != tail)
         {
           /* Take the next character from the tail of the buffer */
 
@@ -2168,6 +2204,25 @@ void uart_datareceived(FAR uart_dev_t *dev)
 #endif
 }
 
+/****************************************************************************
+ * Name: uart_recvidle
+ *
+ * Description:
+ *   This function is called by the lower half when the RX line went idle
+ *   (or its RX timeout expired) after some data was received.  It wakes up
+ *   the readers even if less data than their wake threshold (VMIN) was
+ *   received, so that a partial frame is returned at once.
+ *
+ ****************************************************************************/
+
+void uart_recvidle(FAR uart_dev_t *dev)
+{
+  if (dev->recv.head != dev->recv.tail)
+    {
+      uart_datareceived(dev);
+    }
+}
+
 /****************************************************************************
  * Name: uart_datasent
  *
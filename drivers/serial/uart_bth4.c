@@ -469,6 +469,9 @@ int uart_bth4_register(FAR const char *path, FAR struct bt_driver_s *drv)
 
   dev->drv     = drv;
   drv->receive = uart_bth4_receive;
+#ifdef CONFIG_MM_IOB
+  drv->receive_iob = NULL;
+#endif
   drv->priv    = dev;
 
   nxmutex_init(&dev->sendlock);
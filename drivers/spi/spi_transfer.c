@@ -34,6 +34,29 @@
 #include <nuttx/signal.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/spi/spi_transfer.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_transfer_worker
+ *
+ * Description:
+ *   Perform an asynchronous request on the work queue, for the lower halves
+ *   without their own queue of requests.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SPI_ASYNC) && defined(CONFIG_SCHED_HPWORK)
+static void spi_transfer_worker(FAR void *arg)
+{
+  FAR struct spi_async_s *req = arg;
+
+  req->callback(req, spi_transfer(req->spi, req->seq));
+}
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -143,3 +166,47 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
   return ret;
 }
 
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and call req->callback when it
+ *   completes.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   req - Describes the sequence and the completion callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_async_s *req)
+{
+  int ret;
+
+  DEBUGASSERT(spi != NULL && req != NULL && req->seq != NULL &&
+              req->callback != NULL);
+
+  req->spi = spi;
+
+  /* Let the lower half run the request from its interrupts if it can */
+
+  ret = SPI_TRANSFER_ASYNC(spi, req);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_SCHED_HPWORK
+  /* The work queue runs the requests in order */
+
+  return work_queue(HPWORK, &req->work, spi_transfer_worker, req, 0);
+#else
+  return -ENOSYS;
+#endif
+}
+#endif
@@ -29,7 +29,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <time.h>
 
 /****************************************************************************
  * Public Data
@@ -229,6 +232,70 @@ void syslog_add_intbuffer(FAR const char *buffer, size_t buflen);
 void syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_deferred
+ *
+ * Description:
+ *   Record a message for the deferred SYSLOG thread to format.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   ts       - The time of the message, NULL without timestamps
+ *   fmt      - The format string, which must outlive the message
+ *   ap       - The arguments, left untouched on a failure
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was recorded or dropped because the ring is
+ *   full.  A negated errno value is returned if the caller must format the
+ *   message itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred(int priority, FAR const struct timespec *ts,
+                    FAR const IPTR char *fmt, FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_bformat
+ *
+ * Description:
+ *   Format a deferred message, with the arguments packed as expected by
+ *   lib_bsprintf(), to the SYSLOG channels.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_bformat(int priority, FAR const struct timespec *ts, int cpu,
+                   pid_t pid, FAR const IPTR char *fmt,
+                   FAR const void *args);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Format the pending deferred messages in the caller's context.  Called
+ *   by syslog_flush() on a crash.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_deferred_flush(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the deferred SYSLOG thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_initialize(void);
+#endif
+
 /****************************************************************************
  * Name: syslog_write_foreach
  *
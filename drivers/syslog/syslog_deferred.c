@@ -0,0 +1,645 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SYSLOG_RING_SIZE     (CONFIG_SYSLOG_DEFERRED_BUFSIZE & ~7)
+#define SYSLOG_RECORD_ALIGN  8
+#define SYSLOG_RECORD_PAD    0xff
+#define SYSLOG_RECORD_HDRLEN offsetof(struct syslog_record_s, sr_args)
+
+#define syslog_align(n)      (((n) + SYSLOG_RECORD_ALIGN - 1) & \
+                              ~(SYSLOG_RECORD_ALIGN - 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One message in a ring.  A record with the priority SYSLOG_RECORD_PAD
+ * only fills the end of the ring, and just has the length.
+ */
+
+struct syslog_record_s
+{
+  uint16_t sr_len;                  /* The aligned length of the record */
+  uint8_t sr_priority;              /* The priority of the message */
+  uint8_t sr_cpu;                   /* The CPU that logged the message */
+  pid_t sr_pid;                     /* The thread that logged the message */
+  FAR const IPTR char *sr_fmt;      /* The format string */
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec sr_ts;            /* The time of the message */
+#endif
+  char sr_args[1];                  /* The arguments, see lib_bsprintf() */
+};
+
+/* The ring of one CPU.  The positions are free-running: the head is only
+ * written by the CPU with its interrupts disabled, the tail only by the
+ * formatting thread.
+ */
+
+struct syslog_ring_s
+{
+  uint32_t head;                    /* Where the CPU writes the next record */
+  uint32_t tail;                    /* The oldest record not formatted yet */
+  uint32_t dropped;                 /* The count of dropped messages */
+  uint32_t reported;                /* The count of reported drops */
+  uint64_t buffer[SYSLOG_RING_SIZE / sizeof(uint64_t)];
+};
+
+struct syslog_deferred_s
+{
+  bool running;                     /* The formatting thread runs */
+  atomic_t waiting;                 /* The formatting thread waits */
+  sem_t sem;                        /* Wake up the formatting thread */
+  struct syslog_ring_s ring[CONFIG_SMP_NCPUS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_deferred_s g_syslog_deferred =
+{
+  .sem = SEM_INITIALIZER(0),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_pack
+ *
+ * Description:
+ *   Pack the arguments of a format string in the layout read back by
+ *   lib_bsprintf(): every argument packed at its size, and the strings
+ *   copied.
+ *
+ * Returned Value:
+ *   The size of the packed arguments.  -E2BIG is returned if they do not
+ *   fit in the buffer, -ENOTSUP if the format string cannot be packed.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_pack(FAR char *buf, size_t size,
+                           FAR const IPTR char *fmt, va_list ap)
+{
+  begin_packed_struct union
+    {
+      char c;
+      short int si;
+      int i;
+      long l;
+#ifdef CONFIG_HAVE_LONG_LONG
+      long long ll;
+#endif
+      intmax_t im;
+      size_t sz;
+      ptrdiff_t pd;
+      uintptr_t p;
+#ifdef CONFIG_HAVE_DOUBLE
+      float f;
+      double d;
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+      long double ld;
+#  endif
+#endif
+    }
+
+  end_packed_struct *var;
+  FAR const char *prec = NULL;
+  FAR const char *s;
+  bool infmt = false;
+  size_t offset = 0;
+  size_t len = 0;
+  size_t n;
+  char c;
+
+  while ((c = *fmt++) != '\0')
+    {
+      if (c != '%' && !infmt)
+        {
+          continue;
+        }
+
+      if (!infmt)
+        {
+          len = 0;
+          prec = NULL;
+          infmt = true;
+        }
+
+      len++;
+      var = (FAR void *)(buf + offset);
+
+      /* Reserve room for the largest scalar argument */
+
+      if (offset + sizeof(*var) > size)
+        {
+          return -E2BIG;
+        }
+
+      if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
+          c == 'o' || c == 'x' || c == 'X')
+        {
+          if (*(fmt - 2) == 'j')
+            {
+              var->im = va_arg(ap, intmax_t);
+              offset += sizeof(var->im);
+            }
+#ifdef CONFIG_HAVE_LONG_LONG
+          else if (*(fmt - 2) == 'l' && *(fmt - 3) == 'l')
+            {
+              var->ll = va_arg(ap, long long);
+              offset += sizeof(var->ll);
+            }
+#endif
+          else if (*(fmt - 2) == 'l')
+            {
+              var->l = va_arg(ap, long);
+              offset += sizeof(var->l);
+            }
+          else if (*(fmt - 2) == 'z')
+            {
+              var->sz = va_arg(ap, size_t);
+              offset += sizeof(var->sz);
+            }
+          else if (*(fmt - 2) == 't')
+            {
+              var->pd = va_arg(ap, ptrdiff_t);
+              offset += sizeof(var->pd);
+            }
+          else if (*(fmt - 2) == 'h' && *(fmt - 3) == 'h')
+            {
+              var->c = va_arg(ap, int);
+              offset += sizeof(var->c);
+            }
+          else if (*(fmt - 2) == 'h')
+            {
+              var->si = va_arg(ap, int);
+              offset += sizeof(var->si);
+            }
+          else
+            {
+              var->i = va_arg(ap, int);
+              offset += sizeof(var->i);
+            }
+
+          infmt = false;
+        }
+      else if (c == 'e' || c == 'f' || c == 'g' || c == 'a' ||
+               c == 'A' || c == 'E' || c == 'F' || c == 'G')
+        {
+#ifdef CONFIG_HAVE_DOUBLE
+          if (*(fmt - 2) == 'h')
+            {
+              var->f = va_arg(ap, double);
+              offset += sizeof(var->f);
+            }
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+          else if (*(fmt - 2) == 'L')
+            {
+              var->ld = va_arg(ap, long double);
+              offset += sizeof(var->ld);
+            }
+#  endif
+          else
+            {
+              var->d = va_arg(ap, double);
+              offset += sizeof(var->d);
+            }
+
+          infmt = false;
+#else
+          return -ENOTSUP;
+#endif
+        }
+      else if (c == '*')
+        {
+          /* lib_bsprintf() cannot skip a string of variable precision */
+
+          if (prec != NULL)
+            {
+              return -ENOTSUP;
+            }
+
+          var->i = va_arg(ap, int);
+          offset += sizeof(var->i);
+        }
+      else if (c == 's')
+        {
+          s = va_arg(ap, FAR const char *);
+          if (s == NULL)
+            {
+              s = "(null)";
+            }
+
+          if (prec != NULL)
+            {
+              n = strtoul(prec, NULL, 10);
+              if (offset + n > size)
+                {
+                  return -E2BIG;
+                }
+
+              strncpy(buf + offset, s, n);
+            }
+          else
+            {
+              n = strlen(s) + 1;
+              if (offset + n > size)
+                {
+                  return -E2BIG;
+                }
+
+              memcpy(buf + offset, s, n);
+            }
+
+          offset += n;
+          infmt = false;
+        }
+      else if (c == 'p')
+        {
+          var->p = (uintptr_t)va_arg(ap, FAR void *);
+          offset += sizeof(var->p);
+          infmt = false;
+        }
+      else if (c == '%' && len == 2)
+        {
+          infmt = false;
+        }
+      else if (c == 'n')
+        {
+          return -ENOTSUP;
+        }
+      else if (c == '.')
+        {
+          prec = fmt;
+        }
+    }
+
+  return offset;
+}
+
+/****************************************************************************
+ * Name: syslog_ring_next
+ *
+ * Description:
+ *   Return the oldest record of a ring not formatted yet, skipping the
+ *   padding, or NULL if the ring is empty.
+ *
+ ****************************************************************************/
+
+static FAR struct syslog_record_s *
+syslog_ring_next(FAR struct syslog_ring_s *ring)
+{
+  FAR struct syslog_record_s *rec;
+  uint32_t head = ring->head;
+
+  SMP_RMB();
+
+  while (ring->tail != head)
+    {
+      rec = (FAR struct syslog_record_s *)
+        ((FAR char *)ring->buffer + ring->tail % SYSLOG_RING_SIZE);
+      if (rec->sr_priority != SYSLOG_RECORD_PAD)
+        {
+          return rec;
+        }
+
+      SMP_MB();
+      ring->tail += rec->sr_len;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: syslog_report_drops
+ ****************************************************************************/
+
+static void syslog_report_drops(FAR struct syslog_ring_s *ring, int cpu)
+{
+  struct timespec ts;
+  uint32_t count;
+
+  count = ring->dropped - ring->reported;
+  if (count == 0)
+    {
+      return;
+    }
+
+  ring->reported += count;
+  memset(&ts, 0, sizeof(ts));
+  syslog_bformat(LOG_WARNING, &ts, cpu, nxsched_gettid(),
+                 "syslog: %" PRIu32 " messages dropped\n", &count);
+}
+
+/****************************************************************************
+ * Name: syslog_drain
+ *
+ * Description:
+ *   Format all the records of the rings, the oldest first.
+ *
+ ****************************************************************************/
+
+static void syslog_drain(void)
+{
+  FAR struct syslog_record_s *rec;
+  FAR struct syslog_record_s *next;
+  int cpu;
+  int i;
+
+  for (; ; )
+    {
+      next = NULL;
+      cpu = 0;
+
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          syslog_report_drops(&g_syslog_deferred.ring[i], i);
+
+          rec = syslog_ring_next(&g_syslog_deferred.ring[i]);
+          if (rec == NULL)
+            {
+              continue;
+            }
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+          if (next != NULL &&
+              (rec->sr_ts.tv_sec > next->sr_ts.tv_sec ||
+               (rec->sr_ts.tv_sec == next->sr_ts.tv_sec &&
+                rec->sr_ts.tv_nsec >= next->sr_ts.tv_nsec)))
+            {
+              continue;
+            }
+#else
+          if (next != NULL)
+            {
+              continue;
+            }
+#endif
+
+          next = rec;
+          cpu = i;
+        }
+
+      if (next == NULL)
+        {
+          break;
+        }
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+      syslog_bformat(next->sr_priority, &next->sr_ts, next->sr_cpu,
+                     next->sr_pid, next->sr_fmt, next->sr_args);
+#else
+      syslog_bformat(next->sr_priority, NULL, next->sr_cpu,
+                     next->sr_pid, next->sr_fmt, next->sr_args);
+#endif
+
+      /* The record must be read before its space is handed back */
+
+      SMP_MB();
+      g_syslog_deferred.ring[cpu].tail += next->sr_len;
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_thread
+ ****************************************************************************/
+
+static int syslog_deferred_thread(int argc, FAR char *argv[])
+{
+  bool pending;
+  int i;
+
+  for (; ; )
+    {
+      syslog_drain();
+
+      /* Sleep unless a record was added before the flag was seen */
+
+      atomic_set(&g_syslog_deferred.waiting, 1);
+      SMP_MB();
+
+      pending = false;
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          if (g_syslog_deferred.ring[i].head !=
+              g_syslog_deferred.ring[i].tail)
+            {
+              pending = true;
+            }
+        }
+
+      if (!pending)
+        {
+          nxsem_wait_uninterruptible(&g_syslog_deferred.sem);
+        }
+
+      atomic_set(&g_syslog_deferred.waiting, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred
+ *
+ * Description:
+ *   Record a message for the deferred SYSLOG thread to format.  The caller
+ *   only disables its local interrupts while the record is copied into the
+ *   ring of its CPU.
+ *
+ ****************************************************************************/
+
+int syslog_deferred(int priority, FAR const struct timespec *ts,
+                    FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  FAR struct syslog_ring_s *ring;
+  FAR struct syslog_record_s *rec;
+  char args[CONFIG_SYSLOG_DEFERRED_ARGSIZE];
+  irqstate_t flags;
+  ssize_t nargs;
+  uint32_t offset;
+  uint32_t pad;
+  uint32_t len;
+  va_list copy;
+
+  if (!g_syslog_deferred.running || OSINIT_IS_PANIC())
+    {
+      return -EAGAIN;
+    }
+
+  /* Pack the arguments before touching the ring.  On a failure the
+   * caller formats the message from its untouched arguments.
+   */
+
+  va_copy(copy, *ap);
+  nargs = syslog_pack(args, sizeof(args), fmt, copy);
+  va_end(copy);
+
+  if (nargs < 0)
+    {
+      return nargs;
+    }
+
+  len = syslog_align(SYSLOG_RECORD_HDRLEN + nargs);
+  if (len > UINT16_MAX || len > SYSLOG_RING_SIZE / 2)
+    {
+      return -E2BIG;
+    }
+
+  flags = up_irq_save();
+  ring = &g_syslog_deferred.ring[this_cpu()];
+
+  /* A record does not wrap around, so the end of the ring is padded if
+   * the record does not fit there.
+   */
+
+  offset = ring->head % SYSLOG_RING_SIZE;
+  pad = SYSLOG_RING_SIZE - offset;
+  if (pad >= len)
+    {
+      pad = 0;
+    }
+
+  if (ring->head + pad + len - ring->tail > SYSLOG_RING_SIZE)
+    {
+      ring->dropped++;
+      up_irq_restore(flags);
+      return OK;
+    }
+
+  if (pad > 0)
+    {
+      rec = (FAR struct syslog_record_s *)
+        ((FAR char *)ring->buffer + offset);
+      rec->sr_len = pad;
+      rec->sr_priority = SYSLOG_RECORD_PAD;
+      offset = 0;
+    }
+
+  rec = (FAR struct syslog_record_s *)((FAR char *)ring->buffer + offset);
+  rec->sr_len = len;
+  rec->sr_priority = LOG_PRI(priority);
+  rec->sr_cpu = this_cpu();
+  rec->sr_pid = nxsched_gettid();
+  rec->sr_fmt = fmt;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  rec->sr_ts = *ts;
+#endif
+  memcpy(rec->sr_args, args, nargs);
+
+  /* Publish the record, then wake up the thread if it sleeps */
+
+  SMP_WMB();
+  ring->head += pad + len;
+  up_irq_restore(flags);
+
+  SMP_MB();
+  if (atomic_xchg(&g_syslog_deferred.waiting, 0))
+    {
+      nxsem_post(&g_syslog_deferred.sem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Format the pending deferred messages in the caller's context.
+ *
+ ****************************************************************************/
+
+void syslog_deferred_flush(void)
+{
+  if (g_syslog_deferred.running)
+    {
+      syslog_drain();
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the deferred SYSLOG thread.  The messages are formatted by their
+ *   callers until then.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_initialize(void)
+{
+  int ret;
+
+  ret = kthread_create("syslogd", CONFIG_SYSLOG_DEFERRED_PRIORITY,
+                       CONFIG_SYSLOG_DEFERRED_STACKSIZE,
+                       syslog_deferred_thread, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_syslog_deferred.running = true;
+  return OK;
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
@@ -383,6 +383,7 @@ static ssize_t syslog_dev_write(FAR syslog_channel_t *channel,
   ssize_t nwritten;
   size_t writelen;
   size_t remaining;
+  bool sync = false;
   int ret;
 
   /* Check if the system is ready to do output operations */
@@ -463,13 +464,13 @@ static ssize_t syslog_dev_write(FAR syslog_channel_t *channel,
               nwritten = file_write(&syslog_dev->sl_file,
                                     g_syscrlf, writelen);
 
-              /* Synchronize the file when each CR-LF is encountered
-               * (i.e., implements line buffering always).
+              /* Synchronize the file once the lines of the buffer are
+               * written (i.e., implements line buffering always).
                */
 
               if (nwritten > 0)
                 {
-                  syslog_dev_flush(channel);
+                  sync = true;
                 }
 
               if (nwritten < 0)
@@ -502,6 +503,11 @@ static ssize_t syslog_dev_write(FAR syslog_channel_t *channel,
         }
     }
 
+  if (sync)
+    {
+      syslog_dev_flush(channel);
+    }
+
   syslog_dev_unlock(syslog_dev);
   return buflen;
 
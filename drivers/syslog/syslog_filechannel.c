@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <sched.h>
@@ -36,9 +37,14 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/syslog/syslog.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 
 #include "syslog.h"
 
@@ -51,6 +57,42 @@
 #define OPEN_FLAGS (O_WRONLY | O_CREAT | O_APPEND)
 #define OPEN_MODE  (S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR)
 
+#if CONFIG_SYSLOG_FILE_BUFSIZE > 0
+#  define FILEBUF_SIZE      CONFIG_SYSLOG_FILE_BUFSIZE
+#  define FILEBUF_THRESHOLD (CONFIG_SYSLOG_FILE_BUFSIZE / 2)
+#  define FILEBUF_DELAY     MSEC2TICK(CONFIG_SYSLOG_FILE_FLUSH_MS)
+
+#  ifdef CONFIG_SCHED_LPWORK
+#    define FILEBUF_WORK    LPWORK
+#  else
+#    define FILEBUF_WORK    HPWORK
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_SYSLOG_FILE_BUFSIZE > 0
+/* A file channel that collects the messages in memory and writes them to
+ * the file on the work queue.  Loggers only fill the active buffer, while
+ * the work writes the other one.
+ */
+
+struct syslog_filebuf_s
+{
+  syslog_channel_t channel;        /* Must be first */
+  FAR syslog_channel_t *dev;       /* The channel writing the file */
+  spinlock_t lock;                 /* Protect the active buffer */
+  mutex_t wrlock;                  /* Serialize the file writes */
+  struct work_s work;              /* Write the buffer to the file */
+  uint8_t active;                  /* The buffer filled by the loggers */
+  size_t len;                      /* The bytes in the active buffer */
+  size_t dropped;                  /* The bytes dropped on overflow */
+  char buffer[2][FILEBUF_SIZE];
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -127,6 +169,196 @@ end:
 }
 #endif
 
+#if CONFIG_SYSLOG_FILE_BUFSIZE > 0
+
+/****************************************************************************
+ * Name: syslog_filebuf_sync
+ *
+ * Description:
+ *   Write the active buffer to the file and sync it, in the caller's
+ *   context.
+ *
+ ****************************************************************************/
+
+static void syslog_filebuf_sync(FAR struct syslog_filebuf_s *priv)
+{
+  FAR syslog_channel_t *dev = priv->dev;
+  irqstate_t flags;
+  size_t dropped;
+  size_t len;
+  char msg[48];
+  int n;
+
+  if (nxmutex_lock(&priv->wrlock) < 0)
+    {
+      return;
+    }
+
+  /* Swap the buffers, so the loggers continue with an empty one */
+
+  flags         = spin_lock_irqsave(&priv->lock);
+  n             = priv->active;
+  len           = priv->len;
+  dropped       = priv->dropped;
+  priv->active  = !n;
+  priv->len     = 0;
+  priv->dropped = 0;
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  if (len > 0)
+    {
+      dev->sc_ops->sc_write(dev, priv->buffer[n], len);
+    }
+
+  if (dropped > 0)
+    {
+      n = snprintf(msg, sizeof(msg), "[syslog: %zu bytes dropped]\n",
+                   dropped);
+      dev->sc_ops->sc_write(dev, msg, n);
+    }
+
+  if (len > 0 || dropped > 0)
+    {
+      dev->sc_ops->sc_flush(dev);
+    }
+
+  nxmutex_unlock(&priv->wrlock);
+}
+
+/****************************************************************************
+ * Name: syslog_filebuf_worker
+ ****************************************************************************/
+
+static void syslog_filebuf_worker(FAR void *arg)
+{
+  syslog_filebuf_sync(arg);
+}
+
+/****************************************************************************
+ * Name: syslog_filebuf_write
+ *
+ * Description:
+ *   Add the data to the active buffer, and schedule the write of the
+ *   buffer: soon when over the threshold, after the flush delay when the
+ *   first data is added.  Safe from interrupt handlers.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_filebuf_write(FAR syslog_channel_t *channel,
+                                    FAR const char *buffer, size_t buflen)
+{
+  FAR struct syslog_filebuf_s *priv =
+    (FAR struct syslog_filebuf_s *)channel;
+  irqstate_t flags;
+  size_t oldlen;
+  size_t n;
+
+  flags  = spin_lock_irqsave(&priv->lock);
+  oldlen = priv->len;
+  n      = MIN(buflen, FILEBUF_SIZE - oldlen);
+
+  memcpy(priv->buffer[priv->active] + oldlen, buffer, n);
+  priv->len     += n;
+  priv->dropped += buflen - n;
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  if (oldlen < FILEBUF_THRESHOLD && oldlen + n >= FILEBUF_THRESHOLD)
+    {
+      work_queue(FILEBUF_WORK, &priv->work, syslog_filebuf_worker,
+                 priv, 0);
+    }
+  else if (oldlen == 0 && n > 0)
+    {
+      work_queue(FILEBUF_WORK, &priv->work, syslog_filebuf_worker,
+                 priv, FILEBUF_DELAY);
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: syslog_filebuf_putc
+ ****************************************************************************/
+
+static int syslog_filebuf_putc(FAR syslog_channel_t *channel, int ch)
+{
+  char c = ch;
+
+  syslog_filebuf_write(channel, &c, 1);
+  return ch;
+}
+
+/****************************************************************************
+ * Name: syslog_filebuf_flush
+ *
+ * Description:
+ *   Write the buffered data to the file now.  Called by syslog_flush(),
+ *   including on a crash; nothing can be written from an interrupt
+ *   handler or the IDLE thread.
+ *
+ ****************************************************************************/
+
+static int syslog_filebuf_flush(FAR syslog_channel_t *channel)
+{
+  if (!up_interrupt_context() && !sched_idletask())
+    {
+      syslog_filebuf_sync((FAR struct syslog_filebuf_s *)channel);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_filebuf_close
+ ****************************************************************************/
+
+static void syslog_filebuf_close(FAR syslog_channel_t *channel)
+{
+  FAR struct syslog_filebuf_s *priv =
+    (FAR struct syslog_filebuf_s *)channel;
+
+  work_cancel_sync(FILEBUF_WORK, &priv->work);
+  syslog_filebuf_sync(priv);
+
+  syslog_dev_uninitialize(priv->dev);
+  nxmutex_destroy(&priv->wrlock);
+  kmm_free(priv);
+}
+
+static const struct syslog_channel_ops_s g_syslog_filebuf_ops =
+{
+  syslog_filebuf_putc,
+  syslog_filebuf_putc,
+  syslog_filebuf_flush,
+  syslog_filebuf_write,
+  syslog_filebuf_write,
+  syslog_filebuf_close
+};
+
+/****************************************************************************
+ * Name: syslog_filebuf_initialize
+ ****************************************************************************/
+
+static FAR syslog_channel_t *
+syslog_filebuf_initialize(FAR syslog_channel_t *dev)
+{
+  FAR struct syslog_filebuf_s *priv;
+
+  priv = kmm_zalloc(sizeof(struct syslog_filebuf_s));
+  if (priv == NULL)
+    {
+      return NULL;
+    }
+
+  priv->dev = dev;
+  spin_lock_init(&priv->lock);
+  nxmutex_init(&priv->wrlock);
+  priv->channel.sc_ops = &g_syslog_filebuf_ops;
+  return &priv->channel;
+}
+
+#endif /* CONFIG_SYSLOG_FILE_BUFSIZE > 0 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -170,6 +402,9 @@ end:
 FAR syslog_channel_t *syslog_file_channel(FAR const char *devpath)
 {
   FAR syslog_channel_t *file_channel;
+#if CONFIG_SYSLOG_FILE_BUFSIZE > 0
+  FAR syslog_channel_t *channel;
+#endif
   irqstate_t flags;
 
   /* Reset the default SYSLOG channel so that we can safely modify the
@@ -202,13 +437,27 @@ FAR syslog_channel_t *syslog_file_channel(FAR const char *devpath)
       goto errout_with_lock;
     }
 
+#if CONFIG_SYSLOG_FILE_BUFSIZE > 0
+  /* Collect the output in memory and write the file on the work queue */
+
+  channel = syslog_filebuf_initialize(file_channel);
+  if (channel == NULL)
+    {
+      syslog_dev_uninitialize(file_channel);
+      file_channel = NULL;
+      goto errout_with_lock;
+    }
+
+  file_channel = channel;
+#endif
+
   /* Use the file as the SYSLOG channel. If this fails we are pretty much
    * screwed.
    */
 
   if (syslog_channel_register(file_channel) != OK)
     {
-      syslog_dev_uninitialize(file_channel);
+      file_channel->sc_ops->sc_close(file_channel);
       file_channel = NULL;
     }
 
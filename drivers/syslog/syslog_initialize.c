@@ -97,6 +97,10 @@ int syslog_initialize(void)
   syslog_rpmsg_server_init();
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  ret = syslog_deferred_initialize();
+#endif
+
   return ret;
 }
 
@@ -65,35 +65,65 @@ static FAR const char * const g_priority_str[] =
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_gettime
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+static void syslog_gettime(FAR struct timespec *ts)
+{
+  ts->tv_sec = 0;
+  ts->tv_nsec = 0;
+
+  /* Get the current time.  Since debug output may be generated very early
+   * in the start-up sequence, hardware timer support may not yet be
+   * available.
+   */
+
+  if (OSINIT_HW_READY())
+    {
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
+      /* Use CLOCK_REALTIME if so configured */
+
+      clock_gettime(CLOCK_REALTIME, ts);
+#  else
+      /* Prefer monotonic when enabled, as it can be synchronized to
+       * RTC with clock_resynchronize.
+       */
+
+      clock_gettime(CLOCK_MONOTONIC, ts);
+#  endif
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_format
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Format a message and its header to the SYSLOG channels.  The arguments
+ *   are either in 'ap' or, if 'ap' is NULL, packed in 'args' as expected by
+ *   lib_bsprintf().
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+static int syslog_format(int priority, FAR const struct timespec *ts,
+                         int cpu, pid_t pid, FAR const IPTR char *fmt,
+                         FAR va_list *ap, FAR const void *args)
 {
   struct lib_syslograwstream_s stream;
   int ret = 0;
 #ifdef CONFIG_SYSLOG_PROCESS_NAME
-  FAR struct tcb_s *tcb = nxsched_self();
+  /* A deferred message may outlive the thread that logged it */
+
+  FAR struct tcb_s *tcb = ap != NULL ? nxsched_self() : nxsched_get_tcb(pid);
 #endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+#if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   struct tm tm;
   char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
 #endif
 
   /* Wrap the low-level output in a stream object and let lib_vsprintf
@@ -102,49 +132,23 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
   lib_syslograwstream_open(&stream);
 
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+#if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   memset(&tm, 0, sizeof(tm));
-#  endif
 
-  /* Get the current time.  Since debug output may be generated very early
-   * in the start-up sequence, hardware timer support may not yet be
-   * available.
-   */
+  /* Prepend the message with the current time, if available */
 
-  if (OSINIT_HW_READY())
+  if (ts->tv_sec != 0 || ts->tv_nsec != 0)
     {
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
-      /* Use CLOCK_REALTIME if so configured */
-
-      clock_gettime(CLOCK_REALTIME, &ts);
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
+      localtime_r(&ts->tv_sec, &tm);
 #  else
-      /* Prefer monotonic when enabled, as it can be synchronized to
-       * RTC with clock_resynchronize.
-       */
-
-      clock_gettime(CLOCK_MONOTONIC, &ts);
-#  endif
-
-      /* Prepend the message with the current time, if available */
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-#    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
-#    else
-      gmtime_r(&ts.tv_sec, &tm);
-#    endif
+      gmtime_r(&ts->tv_sec, &tm);
 #  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
-#  endif
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
@@ -206,24 +210,24 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, ts->tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)ts->tv_sec
+                             , ts->tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , this_cpu()
+                             , cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
@@ -247,7 +251,7 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_PROCESS_NAME
   /* Prepend the thread name */
 
-                             , get_task_name(tcb)
+                             , tcb != NULL ? get_task_name(tcb) : ""
 #endif
                     );
 
@@ -255,7 +259,14 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
   /* Generate the output */
 
-  ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+  if (ap != NULL)
+    {
+      ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+    }
+  else
+    {
+      ret += lib_bsprintf(&stream.common, fmt, args);
+    }
 
   if (stream.last_ch != '\n')
     {
@@ -274,3 +285,60 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
   lib_syslograwstream_close(&stream);
   return ret;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  FAR const struct timespec *tsp = NULL;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;
+
+  syslog_gettime(&ts);
+  tsp = &ts;
+#endif
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Leave the formatting to the deferred SYSLOG thread if possible */
+
+  if (syslog_deferred(priority, tsp, fmt, ap) >= 0)
+    {
+      return 0;
+    }
+#endif
+
+  return syslog_format(priority, tsp, this_cpu(), nxsched_gettid(),
+                       fmt, ap, NULL);
+}
+
+/****************************************************************************
+ * Name: syslog_bformat
+ *
+ * Description:
+ *   Format a message recorded by the deferred SYSLOG logic.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_bformat(int priority, FAR const struct timespec *ts, int cpu,
+                   pid_t pid, FAR const IPTR char *fmt,
+                   FAR const void *args)
+{
+  return syslog_format(priority, ts, cpu, pid, fmt, NULL, args);
+}
+#endif
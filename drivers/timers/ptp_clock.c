@@ -23,7 +23,9 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <sys/time.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -31,6 +33,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/timers/ptp_clock.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -48,6 +51,13 @@ struct ptp_upperhalf_s
   mutex_t                     lock;     /* Manages exclusive access to file operations */
   long                        max_adj;  /* The maximum frequency adjustment */
   long                        adj_freq; /* remembers the frequency adjustment */
+#ifdef CONFIG_PTP_CLOCK_SERVO
+  struct ptp_servo_status_s   servo;    /* The in-kernel servo state */
+  int64_t                     local;    /* PTP time of the last sample */
+#  ifdef CONFIG_PTP_CLOCK_SERVO_SYSTIME
+  struct work_s               work;     /* System time discipline */
+#  endif
+#endif
 };
 
 /****************************************************************************
@@ -163,6 +173,183 @@ static int ptp_clock_adjtime(FAR struct ptp_lowerhalf_s *lower,
   return ret;
 }
 
+#ifdef CONFIG_PTP_CLOCK_SERVO
+static long ptp_clock_servo_clamp(FAR struct ptp_upperhalf_s *upper,
+                                  int64_t ppb)
+{
+  return (long)(ppb > upper->max_adj ? upper->max_adj :
+                ppb < -upper->max_adj ? -upper->max_adj : ppb);
+}
+
+/****************************************************************************
+ * Name: ptp_clock_systime_work
+ *
+ * Description:
+ *   Keep CLOCK_REALTIME on the PTP clock disciplined by the servo.
+ *
+ ****************************************************************************/
+
+#  ifdef CONFIG_PTP_CLOCK_SERVO_SYSTIME
+static void ptp_clock_systime_work(FAR void *arg)
+{
+  FAR struct ptp_upperhalf_s *upper = arg;
+  FAR struct ptp_lowerhalf_s *lower = upper->lower;
+  struct timespec pre;
+  struct timespec post;
+  struct timespec ts;
+  struct timeval delta;
+  int64_t offset;
+
+  nxmutex_lock(&upper->lock);
+
+  if (upper->servo.state == PTP_SERVO_LOCKED)
+    {
+      /* Take the system time on both sides of the PTP clock read */
+
+      nxclock_gettime(CLOCK_REALTIME, &pre);
+      if (lower->ops->gettime(lower, &ts, NULL) >= 0)
+        {
+          nxclock_gettime(CLOCK_REALTIME, &post);
+
+          offset = (int64_t)(clock_time2nsec(&pre) / 2 +
+                             clock_time2nsec(&post) / 2 -
+                             clock_time2nsec(&ts));
+          upper->servo.sysoffset = offset;
+
+          if (llabs(offset) > CONFIG_PTP_CLOCK_SERVO_STEP_NS)
+            {
+              clock_settime(CLOCK_REALTIME, &ts);
+            }
+          else
+            {
+              delta.tv_sec  = 0;
+              delta.tv_usec = -offset / NSEC_PER_USEC;
+              adjtime(&delta, NULL);
+            }
+        }
+    }
+
+  nxmutex_unlock(&upper->lock);
+
+  work_queue(LPWORK, &upper->work, ptp_clock_systime_work, upper,
+             MSEC2TICK(CONFIG_PTP_CLOCK_SERVO_SYSTIME_MS));
+}
+#  endif
+
+/****************************************************************************
+ * Name: ptp_clock_servo_sample
+ *
+ * Description:
+ *   Run the PI servo on one offset from the master.  The first two samples
+ *   measure the frequency error, then the clock is stepped once, and from
+ *   there on only its frequency is adjusted.  An offset beyond the step
+ *   threshold starts over.
+ *
+ ****************************************************************************/
+
+static int
+ptp_clock_servo_sample(FAR struct ptp_upperhalf_s *upper,
+                       FAR const struct ptp_servo_sample_s *sample)
+{
+  FAR struct ptp_lowerhalf_s *lower = upper->lower;
+  FAR struct ptp_servo_status_s *servo = &upper->servo;
+  int64_t offset = sample->offset;
+  int64_t local = (int64_t)clock_time2nsec(&sample->local);
+  int64_t dt = local - upper->local;
+  int64_t kiterm;
+  int64_t ppb;
+  int ret = OK;
+
+  if (lower->ops->adjfine == NULL || lower->ops->adjtime == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  if (servo->state == PTP_SERVO_LOCKED &&
+      llabs(offset) > CONFIG_PTP_CLOCK_SERVO_STEP_NS)
+    {
+      servo->state = PTP_SERVO_UNLOCKED;
+    }
+
+  switch (servo->state)
+    {
+      case PTP_SERVO_UNLOCKED:
+        servo->state = PTP_SERVO_LOCKING;
+        break;
+
+      case PTP_SERVO_LOCKING:
+
+        /* Estimate the frequency error from the drift of the offset, then
+         * step the clock onto the master.
+         */
+
+        if (dt <= 0 || llabs(offset - servo->offset) >= NSEC_PER_SEC)
+          {
+            break;
+          }
+
+        servo->drift = ptp_clock_servo_clamp(upper, servo->drift +
+                         (offset - servo->offset) * NSEC_PER_SEC / dt);
+
+        ret = lower->ops->adjtime(lower, -offset);
+        if (ret < 0)
+          {
+            break;
+          }
+
+        servo->freq = ptp_clock_servo_clamp(upper, -servo->drift);
+        ret = lower->ops->adjfine(lower, servo->freq);
+        servo->state = PTP_SERVO_LOCKED;
+        offset = 0;
+
+#  ifdef CONFIG_PTP_CLOCK_SERVO_SYSTIME
+        if (work_available(&upper->work))
+          {
+            work_queue(LPWORK, &upper->work, ptp_clock_systime_work,
+                       upper, 0);
+          }
+#  endif
+        break;
+
+      case PTP_SERVO_LOCKED:
+
+        /* The samples are expected about once per second, anything else
+         * in the integral term is weighted by the actual interval.
+         */
+
+        if (dt <= 0 || dt > 64ll * NSEC_PER_SEC)
+          {
+            dt = NSEC_PER_SEC;
+          }
+
+        kiterm = offset * CONFIG_PTP_CLOCK_SERVO_KI / 1000 *
+                 (dt / NSEC_PER_USEC) / USEC_PER_SEC;
+        ppb    = offset * CONFIG_PTP_CLOCK_SERVO_KP / 1000 +
+                 servo->drift + kiterm;
+
+        /* Don't wind up the integral term while saturated */
+
+        if (llabs(ppb) < upper->max_adj)
+          {
+            servo->drift += kiterm;
+          }
+
+        servo->freq = ptp_clock_servo_clamp(upper, -ppb);
+        ret = lower->ops->adjfine(lower, servo->freq);
+        break;
+    }
+
+  if (ret >= 0)
+    {
+      upper->adj_freq = servo->freq;
+    }
+
+  servo->offset = offset;
+  upper->local  = local;
+  return ret;
+}
+#endif
+
 static int ptp_clock_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg)
 {
@@ -182,6 +369,10 @@ static int ptp_clock_ioctl(FAR struct file *filep, int cmd,
               ret = lower->ops->settime(lower,
                     (FAR const struct timespec *)(uintptr_t)arg);
             }
+
+#ifdef CONFIG_PTP_CLOCK_SERVO
+          upper->servo.state = PTP_SERVO_UNLOCKED;
+#endif
         }
         break;
 
@@ -339,6 +530,23 @@ static int ptp_clock_ioctl(FAR struct file *filep, int cmd,
         }
         break;
 
+#ifdef CONFIG_PTP_CLOCK_SERVO
+      case PTP_CLOCK_SERVO_SAMPLE:
+        {
+          ret = ptp_clock_servo_sample(upper,
+                  (FAR const struct ptp_servo_sample_s *)(uintptr_t)arg);
+        }
+        break;
+
+      case PTP_CLOCK_SERVO_STATUS:
+        {
+          memcpy((FAR void *)(uintptr_t)arg, &upper->servo,
+                 sizeof(upper->servo));
+          ret = OK;
+        }
+        break;
+#endif
+
       default:
         {
           if (lower->ops->control)
@@ -476,6 +684,9 @@ void ptp_clock_unregister(FAR struct ptp_lowerhalf_s *lower, int devno)
 
       snprintf(path, sizeof(path), "/dev/ptp%d", devno);
       unregister_driver(path);
+#ifdef CONFIG_PTP_CLOCK_SERVO_SYSTIME
+      work_cancel_sync(LPWORK, &upper->work);
+#endif
       nxmutex_destroy(&upper->lock);
       kmm_free(upper);
     }
@@ -156,6 +156,19 @@
 #  endif
 #endif
 
+/* Sectors held by the I/O buffer, for multiple sector reads and writes */
+
+#ifndef CONFIG_USBMSC_RDSECTORS
+#  define CONFIG_USBMSC_RDSECTORS 1
+#endif
+
+#if defined(CONFIG_USBMSC_WRMULTIPLE) && \
+    CONFIG_USBMSC_NWRREQS > CONFIG_USBMSC_RDSECTORS
+#  define USBMSC_IOSECTORS CONFIG_USBMSC_NWRREQS
+#else
+#  define USBMSC_IOSECTORS CONFIG_USBMSC_RDSECTORS
+#endif
+
 /* Vendor and product IDs and strings */
 
 #ifndef CONFIG_USBMSC_COMPOSITE
@@ -410,9 +423,10 @@ struct usbmsc_dev_s
   uint8_t           cbwdir:2;         /* Direction from CBW. See USBMSC_FLAGS_DIR* definitions */
   uint8_t           cdblen;           /* Length of cdb[] from CBW */
   uint8_t           cbwlun;           /* LUN from the CBW */
-  uint16_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
+  uint32_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
+  uint32_t          iolen;            /* Bytes read into iobuffer[] */
   uint16_t          nreqbytes;        /* Bytes buffered in head write requests */
-  uint16_t          iosize;           /* Size of iobuffer[] */
+  uint32_t          iosize;           /* Size of iobuffer[] */
   uint32_t          cbwlen;           /* Length of data from CBW */
   uint32_t          cbwtag;           /* Tag from the CBW */
   union
@@ -29,6 +29,7 @@
 #include <errno.h>
 
 #include <sys/endian.h>
+#include <sys/param.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
@@ -67,7 +68,8 @@
 #define XHCI_MAX_ERST            (1)
 #define XHCI_CMD_MAX             (16)
 #define XHCI_EVENT_MAX           (232)
-#define XHCI_TD_MAX              (8)
+#define XHCI_TD_MAX              (CONFIG_USBHOST_XHCI_TD_NUM)
+#define XHCI_TRB_BUFMAX          (64 * 1024)
 #define XHCI_BUFSIZE             (512)
 
 /* Port numbers macros */
@@ -131,6 +133,8 @@ struct xhci_epinfo_s
   int                result;       /* The result of the transfer */
   size_t             xfrd;         /* On completion, will hold the number of bytes transferred */
   size_t             buflen;       /* Buffer length used for transfer */
+  size_t             tdstart;      /* Ring index of the first TRB of the TD */
+  uint16_t           ntrb;         /* Number of Normal TRBs in the TD */
   sem_t              iocsem;       /* Semaphore used to wait for transfer completion */
 #ifdef CONFIG_USBHOST_ASYNCH
   usbhost_asynch_t   callback;     /* Transfer complete callback */
@@ -892,12 +896,14 @@ static void xhci_add_trb(FAR struct usbhost_xhci_s *priv,
                          FAR struct xhci_trb_s *trb,
                          int len)
 {
+  uint32_t chain;
   uint32_t d2;
   int      i;
 
   for (i = 0; i < len; i++)
     {
-      d2 = trb[i].d2;
+      d2    = trb[i].d2;
+      chain = d2 & XHCI_TRB_D2_CH;
 
       if (ring->ccs)
         {
@@ -941,6 +947,10 @@ static void xhci_add_trb(FAR struct usbhost_xhci_s *priv,
                    XHCI_TRB_D2_TYPE_SET(XHCI_TRB_TYPE_LINK);
             }
 
+          /* A Link TRB in the middle of a TD must keep the chain */
+
+          d2 |= chain;
+
           /* Other parameters are already correct for this TRB */
 
           ring->ring[ring->i].d2 = htole32(d2);
@@ -2295,16 +2305,51 @@ static int xhci_normal_setup(FAR struct xhci_rhport_s *rhport,
 {
   FAR struct usbhost_xhci_s *priv = XHCI_PRIV_FROM_RHPORT(rhport);
   struct xhci_trb_s          trb;
+  uintptr_t                  pa   = up_addrenv_va_to_pa(buffer);
+  size_t                     ntrb;
+  size_t                     len;
 
-  /* Prepare TRB */
+  /* A TRB buffer must not cross a 64KB boundary (4.11.7.1), so split the
+   * buffer into a chain of Normal TRBs.  One slot of the ring is the Link
+   * TRB.
+   */
 
-  trb.d0 = up_addrenv_va_to_pa(buffer);
-  trb.d1 = XHCI_TRB_D1_IRQ_SET(0) | XHCI_TRB_D1_TXLEN_SET(buflen);
-  trb.d2 = XHCI_TRB_D2_IOC | XHCI_TRB_D2_TYPE_SET(XHCI_TRB_TYPE_NORMAL);
+  ntrb = (pa % XHCI_TRB_BUFMAX + buflen + XHCI_TRB_BUFMAX - 1) /
+         XHCI_TRB_BUFMAX;
+  if (ntrb > XHCI_TD_MAX - 1)
+    {
+      return -E2BIG;
+    }
 
-  /* Add TRBs to ring */
+  epinfo->tdstart = epinfo->td.i;
+  epinfo->ntrb    = ntrb;
 
-  xhci_add_trb(priv, &epinfo->td, &trb, 1);
+  while (ntrb-- > 0)
+    {
+      len = MIN(buflen, XHCI_TRB_BUFMAX - pa % XHCI_TRB_BUFMAX);
+
+      /* Prepare TRB, interrupt on the last TRB or on a short packet */
+
+      trb.d0 = pa;
+      trb.d1 = XHCI_TRB_D1_IRQ_SET(0) | XHCI_TRB_D1_TXLEN_SET(len);
+      trb.d2 = XHCI_TRB_D2_TYPE_SET(XHCI_TRB_TYPE_NORMAL);
+
+      if (ntrb > 0)
+        {
+          trb.d2 |= XHCI_TRB_D2_CH | XHCI_TRB_D2_ISP;
+        }
+      else
+        {
+          trb.d2 |= XHCI_TRB_D2_IOC;
+        }
+
+      /* Add TRBs to ring */
+
+      xhci_add_trb(priv, &epinfo->td, &trb, 1);
+
+      pa     += len;
+      buflen -= len;
+    }
 
   /* Trigger transfer */
 
@@ -2313,6 +2358,51 @@ static int xhci_normal_setup(FAR struct xhci_rhport_s *rhport,
   return OK;
 }
 
+/****************************************************************************
+ * Name: xhci_normal_xfrd
+ *
+ * Description:
+ *   Get the number of bytes transferred by the chain of Normal TRBs when
+ *   the event is reported for the TRB at address trbpa.
+ *
+ * Returned Value:
+ *   The number of bytes transferred; a negated errno value is returned if
+ *   the TRB does not belong to the current TD (a late event of a TD that
+ *   already completed on a short packet).
+ *
+ ****************************************************************************/
+
+static ssize_t xhci_normal_xfrd(FAR struct xhci_epinfo_s *epinfo,
+                                uint64_t trbpa, uint32_t tl)
+{
+  FAR struct xhci_ring_s *ring = &epinfo->td;
+  size_t                  xfrd = 0;
+  size_t                  len;
+  size_t                  i    = epinfo->tdstart;
+  int                     n;
+
+  for (n = 0; n < epinfo->ntrb; n++)
+    {
+      /* Skip the Link TRB */
+
+      if (i >= ring->len - 1)
+        {
+          i = 0;
+        }
+
+      len = XHCI_TRB_D1_TXLEN_GET(le32toh(ring->ring[i].d1));
+      if (up_addrenv_va_to_pa(&ring->ring[i]) == trbpa)
+        {
+          return xfrd + len - tl;
+        }
+
+      xfrd += len;
+      i++;
+    }
+
+  return -ENOENT;
+}
+
 #ifndef CONFIG_USBHOST_ISOC_DISABLE
 /****************************************************************************
  * Name: xhci_isoc_setup
@@ -2656,7 +2746,25 @@ static void xhci_transfer_complete(FAR struct usbhost_xhci_s *priv,
 
   /* Get transferred length */
 
-  if (epinfo->buflen > 0)
+  if (epinfo->xfrtype == USB_EP_ATTR_XFER_BULK ||
+      epinfo->xfrtype == USB_EP_ATTR_XFER_INT)
+    {
+      ssize_t xfrd = xhci_normal_xfrd(epinfo, le64toh(evt->d0), tl);
+
+      if (xfrd < 0)
+        {
+          /* A short packet already completed this TD, the event of its
+           * last TRB is not interesting.
+           */
+
+          spin_unlock_irqrestore(&priv->spinlock, flags);
+          return;
+        }
+
+      epinfo->ntrb = 0;
+      epinfo->xfrd = xfrd;
+    }
+  else if (epinfo->buflen > 0)
     {
       epinfo->xfrd = epinfo->buflen - tl;
     }
@@ -0,0 +1,604 @@
+/****************************************************************************
+ * drivers/vhost/vhost-net.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <debug.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/vhost/vhost.h>
+
+#include "vhost-net.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The virtqueues are named from the guest side: the guest receives the
+ * packets we transmit on VHOST_NET_RX and transmits the packets we
+ * receive on VHOST_NET_TX.
+ */
+
+#define VHOST_NET_RX            0
+#define VHOST_NET_TX            1
+#define VHOST_NET_NUM           2
+
+/* The feature bits changing the header size */
+
+#define VHOST_NET_F_MRG_RXBUF   15
+
+/* Chains returned to the guest before it is notified, while more are
+ * pending.
+ */
+
+#define VHOST_NET_BATCH         16
+
+/* Guest RX chains a transmitted packet spans at most */
+
+#define VHOST_NET_MAX_CHAINS    32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The virtio net header, num_buffers exists with mergeable RX buffers or
+ * a virtio 1.0 guest only.
+ */
+
+begin_packed_struct struct vhost_net_hdr_s
+{
+  uint8_t  flags;
+  uint8_t  gso_type;
+  uint16_t hdr_len;
+  uint16_t gso_size;
+  uint16_t csum_start;
+  uint16_t csum_offset;
+  uint16_t num_buffers;
+} end_packed_struct;
+
+struct vhost_net_priv_s
+{
+  /* This holds the information visible to the NuttX network */
+
+  struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
+
+  FAR struct vhost_device  *hdev;      /* Vhost device pointer */
+  spinlock_t                lock[VHOST_NET_NUM];
+  size_t                    hdrsize;   /* Header size of the guest */
+  bool                      mrg;       /* Guest RX buffers are merged */
+  int                       batch;     /* Chains not notified yet */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Netdev lowerhalf functions */
+
+static int vhost_net_ifup(FAR struct netdev_lowerhalf_s *dev);
+static int vhost_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
+static int vhost_net_transmit(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt);
+static FAR netpkt_t *vhost_net_receive(FAR struct netdev_lowerhalf_s *dev);
+
+/* Vhost driver functions */
+
+static int vhost_net_probe(FAR struct vhost_device *hdev);
+static void vhost_net_remove(FAR struct vhost_device *hdev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct vhost_driver g_vhost_net_driver =
+{
+  LIST_INITIAL_VALUE(g_vhost_net_driver.node), /* Node */
+  VIRTIO_ID_NETWORK,                           /* Device id */
+  vhost_net_probe,                             /* Probe */
+  vhost_net_remove,                            /* Remove */
+};
+
+static const struct netdev_ops_s g_vhost_net_ops =
+{
+  vhost_net_ifup,     /* ifup */
+  vhost_net_ifdown,   /* ifdown */
+  vhost_net_transmit, /* transmit */
+  vhost_net_receive,  /* receive */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vhost_net_vq
+ ****************************************************************************/
+
+static inline FAR struct virtqueue *
+vhost_net_vq(FAR struct vhost_net_priv_s *priv, int index)
+{
+  return priv->hdev->vrings_info[index].vq;
+}
+
+/****************************************************************************
+ * Name: vhost_net_kick
+ *
+ * Description:
+ *   Notify the guest of the chains returned since the last notification.
+ *   The guest may still suppress it with its used event index.
+ *
+ ****************************************************************************/
+
+static void vhost_net_kick(FAR struct vhost_net_priv_s *priv, int index)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&priv->lock[index]);
+  virtqueue_kick(vhost_net_vq(priv, index));
+  spin_unlock_irqrestore(&priv->lock[index], flags);
+}
+
+/****************************************************************************
+ * Name: vhost_net_get_chain
+ *
+ * Description:
+ *   Take the first buffer of the next chain the guest made available
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vhost_net_get_chain(FAR struct vhost_net_priv_s *priv,
+                                        int index, FAR uint16_t *head,
+                                        FAR uint32_t *len)
+{
+  irqstate_t flags;
+  FAR void *buf;
+
+  flags = spin_lock_irqsave(&priv->lock[index]);
+  buf = virtqueue_get_first_avail_buffer(vhost_net_vq(priv, index), head,
+                                         len);
+  spin_unlock_irqrestore(&priv->lock[index], flags);
+  return buf;
+}
+
+/****************************************************************************
+ * Name: vhost_net_put_chain
+ *
+ * Description:
+ *   Return a chain to the guest with the bytes written to it
+ *
+ ****************************************************************************/
+
+static void vhost_net_put_chain(FAR struct vhost_net_priv_s *priv,
+                                int index, uint16_t head, uint32_t len)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&priv->lock[index]);
+  virtqueue_add_consumed_buffer(vhost_net_vq(priv, index), head, len);
+  spin_unlock_irqrestore(&priv->lock[index], flags);
+}
+
+/****************************************************************************
+ * Name: vhost_net_fill
+ *
+ * Description:
+ *   Copy the header and the packet from 'offset' to the descriptors of the
+ *   chain of head, up to 'total' bytes.  The guest memory is accessed in
+ *   place, mapped by the transport.
+ *
+ * Returned Value:
+ *   The bytes written to the chain.
+ *
+ ****************************************************************************/
+
+static uint32_t vhost_net_fill(FAR struct vhost_net_priv_s *priv,
+                               FAR netpkt_t *pkt, FAR uint8_t *buf,
+                               uint16_t head, uint32_t len,
+                               FAR const struct vhost_net_hdr_s *hdr,
+                               uint32_t offset, uint32_t total)
+{
+  FAR struct virtqueue *vq = vhost_net_vq(priv, VHOST_NET_RX);
+  uint32_t written = 0;
+  uint32_t chunk;
+  uint16_t idx = head;
+
+  while (buf != NULL && offset < total)
+    {
+      chunk = MIN(len, total - offset);
+
+      /* The header is at the start of the first chain */
+
+      if (offset < priv->hdrsize)
+        {
+          uint32_t n = MIN(chunk, priv->hdrsize - offset);
+
+          memcpy(buf, (FAR const uint8_t *)hdr + offset, n);
+          netpkt_copyout(&priv->lower, buf + n, pkt, chunk - n, 0);
+        }
+      else
+        {
+          netpkt_copyout(&priv->lower, buf, pkt, chunk,
+                         offset - priv->hdrsize);
+        }
+
+      offset  += chunk;
+      written += chunk;
+      buf = virtqueue_get_next_avail_buffer(vq, idx, &idx, &len);
+    }
+
+  return written;
+}
+
+/****************************************************************************
+ * Name: vhost_net_ifup
+ ****************************************************************************/
+
+static int vhost_net_ifup(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct vhost_net_priv_s *priv = (FAR struct vhost_net_priv_s *)dev;
+  irqstate_t flags;
+  int pending;
+
+  netdev_lower_carrier_on(dev);
+
+  flags = spin_lock_irqsave(&priv->lock[VHOST_NET_TX]);
+  pending = virtqueue_enable_cb(vhost_net_vq(priv, VHOST_NET_TX));
+  spin_unlock_irqrestore(&priv->lock[VHOST_NET_TX], flags);
+
+  flags = spin_lock_irqsave(&priv->lock[VHOST_NET_RX]);
+  virtqueue_enable_cb(vhost_net_vq(priv, VHOST_NET_RX));
+  spin_unlock_irqrestore(&priv->lock[VHOST_NET_RX], flags);
+
+  if (pending)
+    {
+      netdev_lower_rxready(dev);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vhost_net_ifdown
+ ****************************************************************************/
+
+static int vhost_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct vhost_net_priv_s *priv = (FAR struct vhost_net_priv_s *)dev;
+  irqstate_t flags;
+  int i;
+
+  for (i = 0; i < VHOST_NET_NUM; i++)
+    {
+      flags = spin_lock_irqsave(&priv->lock[i]);
+      virtqueue_disable_cb(vhost_net_vq(priv, i));
+      spin_unlock_irqrestore(&priv->lock[i], flags);
+    }
+
+  netdev_lower_carrier_off(dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vhost_net_transmit
+ *
+ * Description:
+ *   Copy a packet to the RX buffers of the guest.  With mergeable RX
+ *   buffers, the packet spans as many chains as it needs.
+ *
+ ****************************************************************************/
+
+static int vhost_net_transmit(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt)
+{
+  FAR struct vhost_net_priv_s *priv = (FAR struct vhost_net_priv_s *)dev;
+  uint32_t total = priv->hdrsize + netpkt_getdatalen(dev, pkt);
+  uint32_t written[VHOST_NET_MAX_CHAINS];
+  uint16_t heads[VHOST_NET_MAX_CHAINS];
+  FAR struct vhost_net_hdr_s *first;
+  struct vhost_net_hdr_s hdr;
+  uint32_t offset = 0;
+  uint16_t nbufs = 0;
+  FAR uint8_t *buf;
+  uint32_t len;
+  int i;
+
+  buf = vhost_net_get_chain(priv, VHOST_NET_RX, &heads[0], &len);
+  if (buf == NULL || len < priv->hdrsize)
+    {
+      if (buf != NULL)
+        {
+          vhost_net_put_chain(priv, VHOST_NET_RX, heads[0], 0);
+        }
+
+      return -EAGAIN;
+    }
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.num_buffers = 1;
+  first = (FAR struct vhost_net_hdr_s *)buf;
+
+  do
+    {
+      written[nbufs] = vhost_net_fill(priv, pkt, buf, heads[nbufs], len,
+                                      &hdr, offset, total);
+      offset += written[nbufs++];
+    }
+  while (offset < total && priv->mrg && nbufs < VHOST_NET_MAX_CHAINS &&
+         (buf = vhost_net_get_chain(priv, VHOST_NET_RX, &heads[nbufs],
+                                    &len)) != NULL);
+
+  /* A short packet is dropped by the guest on its length */
+
+  if (offset < total)
+    {
+      vhosterr("Guest RX buffers too short %" PRIu32 "\n", total);
+      NETDEV_TXERRORS(&dev->netdev);
+    }
+
+  /* The guest may look at the chains as soon as they are returned */
+
+  if (priv->mrg)
+    {
+      first->num_buffers = nbufs;
+    }
+
+  for (i = 0; i < nbufs; i++)
+    {
+      vhost_net_put_chain(priv, VHOST_NET_RX, heads[i], written[i]);
+    }
+
+  vhost_net_kick(priv, VHOST_NET_RX);
+  netpkt_free(dev, pkt, NETPKT_TX);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vhost_net_receive
+ *
+ * Description:
+ *   Copy a packet out of the next TX chain of the guest.  The chains are
+ *   returned in batches while the guest keeps transmitting.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *vhost_net_receive(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct vhost_net_priv_s *priv = (FAR struct vhost_net_priv_s *)dev;
+  FAR struct virtqueue *vq = vhost_net_vq(priv, VHOST_NET_TX);
+  FAR netpkt_t *pkt;
+  FAR uint8_t *buf;
+  uint32_t skip = priv->hdrsize;
+  uint32_t offset = 0;
+  irqstate_t flags;
+  uint16_t head;
+  uint16_t idx;
+  uint32_t len;
+  int ret = OK;
+
+  pkt = netpkt_alloc(dev, NETPKT_RX);
+  if (pkt == NULL)
+    {
+      return NULL;
+    }
+
+  for (; ; )
+    {
+      buf = vhost_net_get_chain(priv, VHOST_NET_TX, &head, &len);
+      if (buf != NULL)
+        {
+          break;
+        }
+
+      /* Drained, stop suppressing the notifications of the guest */
+
+      if (priv->batch > 0)
+        {
+          priv->batch = 0;
+          vhost_net_kick(priv, VHOST_NET_TX);
+        }
+
+      flags = spin_lock_irqsave(&priv->lock[VHOST_NET_TX]);
+      ret = virtqueue_enable_cb(vq);
+      spin_unlock_irqrestore(&priv->lock[VHOST_NET_TX], flags);
+      if (ret == 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          return NULL;
+        }
+
+      /* More chains came after the last check */
+
+      flags = spin_lock_irqsave(&priv->lock[VHOST_NET_TX]);
+      virtqueue_disable_cb(vq);
+      spin_unlock_irqrestore(&priv->lock[VHOST_NET_TX], flags);
+    }
+
+  /* Skip the header, it may share a descriptor with the packet */
+
+  ret = OK;
+  for (idx = head; buf != NULL && ret >= 0; )
+    {
+      if (len > skip)
+        {
+          ret = netpkt_copyin(dev, pkt, buf + skip, len - skip, offset);
+          offset += len - skip;
+        }
+
+      skip -= MIN(skip, len);
+      buf = virtqueue_get_next_avail_buffer(vq, idx, &idx, &len);
+    }
+
+  vhost_net_put_chain(priv, VHOST_NET_TX, head, 0);
+  if (++priv->batch >= VHOST_NET_BATCH)
+    {
+      priv->batch = 0;
+      vhost_net_kick(priv, VHOST_NET_TX);
+    }
+
+  if (ret < 0 || offset == 0)
+    {
+      NETDEV_RXERRORS(&dev->netdev);
+      netpkt_free(dev, pkt, NETPKT_RX);
+      return NULL;
+    }
+
+  return pkt;
+}
+
+/****************************************************************************
+ * Name: vhost_net_rxready
+ *
+ * Description:
+ *   The guest transmitted, poll its TX queue without notifications
+ *
+ ****************************************************************************/
+
+static void vhost_net_rxready(FAR struct virtqueue *vq)
+{
+  FAR struct vhost_net_priv_s *priv = vq->vq_dev->priv;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&priv->lock[VHOST_NET_TX]);
+  virtqueue_disable_cb(vq);
+  spin_unlock_irqrestore(&priv->lock[VHOST_NET_TX], flags);
+
+  netdev_lower_rxready(&priv->lower);
+}
+
+/****************************************************************************
+ * Name: vhost_net_txready
+ *
+ * Description:
+ *   The guest made RX buffers available, resume the transmission
+ *
+ ****************************************************************************/
+
+static void vhost_net_txready(FAR struct virtqueue *vq)
+{
+  FAR struct vhost_net_priv_s *priv = vq->vq_dev->priv;
+
+  netdev_lower_txdone(&priv->lower);
+}
+
+/****************************************************************************
+ * Name: vhost_net_probe
+ ****************************************************************************/
+
+static int vhost_net_probe(FAR struct vhost_device *hdev)
+{
+  FAR struct vhost_net_priv_s *priv;
+  FAR struct netdev_lowerhalf_s *netdev;
+  FAR const char *vqnames[VHOST_NET_NUM];
+  vq_callback callbacks[VHOST_NET_NUM];
+  int ret;
+
+  priv = kmm_zalloc(sizeof(*priv));
+  if (priv == NULL)
+    {
+      vhosterr("No enough memory\n");
+      return -ENOMEM;
+    }
+
+  spin_lock_init(&priv->lock[VHOST_NET_RX]);
+  spin_lock_init(&priv->lock[VHOST_NET_TX]);
+  priv->hdev = hdev;
+  hdev->priv = priv;
+
+  /* The header size follows the features the guest negotiated */
+
+  priv->mrg     = virtio_has_feature(hdev, VHOST_NET_F_MRG_RXBUF);
+  priv->hdrsize = sizeof(struct vhost_net_hdr_s);
+  if (!priv->mrg && !virtio_has_feature(hdev, VIRTIO_F_VERSION_1))
+    {
+      priv->hdrsize = offsetof(struct vhost_net_hdr_s, num_buffers);
+    }
+
+  /* Create the virtqueues */
+
+  vqnames[VHOST_NET_RX]   = "virtio_net_rx";
+  vqnames[VHOST_NET_TX]   = "virtio_net_tx";
+  callbacks[VHOST_NET_RX] = vhost_net_txready;
+  callbacks[VHOST_NET_TX] = vhost_net_rxready;
+  ret = vhost_create_virtqueues(hdev, 0, VHOST_NET_NUM, vqnames, callbacks,
+                                NULL);
+  if (ret < 0)
+    {
+      vhosterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
+      goto err_with_priv;
+    }
+
+  /* The packets are copied, a transmitted one is freed at once */
+
+  netdev = &priv->lower;
+  netdev->quota[NETPKT_RX] = VHOST_NET_BATCH;
+  netdev->quota[NETPKT_TX] = 1;
+  netdev->ops = &g_vhost_net_ops;
+
+  ret = netdev_lower_register(netdev, NET_LL_ETHERNET);
+  if (ret < 0)
+    {
+      vhosterr("netdev_lower_register failed, ret=%d\n", ret);
+      goto err_with_queues;
+    }
+
+  return ret;
+
+err_with_queues:
+  vhost_delete_virtqueues(hdev);
+err_with_priv:
+  kmm_free(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: vhost_net_remove
+ ****************************************************************************/
+
+static void vhost_net_remove(FAR struct vhost_device *hdev)
+{
+  FAR struct vhost_net_priv_s *priv = hdev->priv;
+
+  netdev_lower_unregister(&priv->lower);
+  vhost_delete_virtqueues(hdev);
+  kmm_free(priv);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vhost_register_net_driver
+ ****************************************************************************/
+
+int vhost_register_net_driver(void)
+{
+  return vhost_register_driver(&g_vhost_net_driver);
+}
@@ -31,6 +31,7 @@
 #include <nuttx/wqueue.h>
 #include <nuttx/vhost/vhost.h>
 
+#include "vhost-net.h"
 #include "vhost-rng.h"
 #include "vhost-rpmsg.h"
 
@@ -398,6 +399,14 @@ void vhost_register_drivers(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVERS_VHOST_NET
+  ret = vhost_register_net_driver();
+  if (ret < 0)
+    {
+      vhosterr("vhost_register_net_driver failed, ret=%d\n", ret);
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_VHOST_RPMSG
   ret = vhost_register_rpmsg_driver();
   if (ret < 0)
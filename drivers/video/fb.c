@@ -41,6 +41,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/video/dmabuf.h>
 #include <nuttx/video/fb.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
@@ -153,6 +154,11 @@ static int     fb_poll(FAR struct file *filep, FAR struct pollfd *fds,
 static int     fb_get_panelinfo(FAR struct fb_chardev_s *fb,
                                 FAR struct fb_panelinfo_s *panelinfo,
                                 int overlay);
+#ifdef CONFIG_VIDEO_DMABUF
+static int     fb_export_dmabuf(FAR struct fb_chardev_s *fb,
+                                FAR struct fb_dmabuf_s *dmabuf,
+                                int overlay);
+#endif
 static int     fb_get_planeinfo(FAR struct fb_chardev_s *fb,
                                 FAR struct fb_planeinfo_s *pinfo,
                                 uint8_t display);
@@ -1314,6 +1320,19 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_VIDEO_DMABUF
+      case FBIOGET_DMABUF:
+        {
+          FAR struct fb_dmabuf_s *dmabuf =
+            (FAR struct fb_dmabuf_s *)((uintptr_t)arg);
+          FAR struct fb_priv_s *priv = filep->f_priv;
+
+          DEBUGASSERT(dmabuf != NULL && priv != NULL);
+          ret = fb_export_dmabuf(fb, dmabuf, priv->overlay);
+        }
+        break;
+#endif
+
       default:
         if (fb->vtable->ioctl != NULL)
           {
@@ -1517,6 +1536,63 @@ static int fb_get_panelinfo(FAR struct fb_chardev_s *fb,
   return OK;
 }
 
+/****************************************************************************
+ * Name: fb_export_dmabuf
+ *
+ * Description:
+ *   Export a range of the plane memory as a shared buffer.  The memory
+ *   belongs to the display driver and outlives any importer, so no release
+ *   callback is needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VIDEO_DMABUF
+static int fb_export_dmabuf(FAR struct fb_chardev_s *fb,
+                            FAR struct fb_dmabuf_s *dmabuf, int overlay)
+{
+  struct fb_panelinfo_s panelinfo;
+  FAR struct dmabuf_s *buf;
+  size_t length;
+  int ret;
+
+  ret = fb_get_panelinfo(fb, &panelinfo, overlay);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (dmabuf->offset >= panelinfo.fblen)
+    {
+      return -EINVAL;
+    }
+
+  length = dmabuf->length != 0 ? dmabuf->length :
+           panelinfo.fblen - dmabuf->offset;
+  if (length > panelinfo.fblen - dmabuf->offset)
+    {
+      return -EINVAL;
+    }
+
+  buf = dmabuf_alloc((FAR uint8_t *)panelinfo.fbmem + dmabuf->offset,
+                     length, NULL, NULL);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = dmabuf_export(buf, dmabuf->flags);
+  dmabuf_put(buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dmabuf->length = length;
+  dmabuf->fd     = ret;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: fb_get_planeinfo
  ****************************************************************************/
@@ -109,6 +109,9 @@ struct capture_type_inf_s
   struct v4l2_fract      frame_interval;
   video_framebuff_t      bufinf;
   FAR uint8_t            *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s    *heapbuf;   /* bufheap once a buffer is exported */
+#endif
   FAR struct pollfd      *fds;
   uint32_t               seqnum;
 };
@@ -217,6 +220,8 @@ static int validate_frame_setting(FAR capture_mng_t *cmng,
                                   FAR struct v4l2_rect *clip,
                                   FAR struct v4l2_fract *interval);
 static size_t get_bufsize(FAR video_format_t *vf);
+static void free_bufheap(FAR capture_mng_t *cmng,
+                         FAR capture_type_inf_t *type_inf);
 
 /* ioctl function for each cmds of ioctl */
 
@@ -287,6 +292,10 @@ static int capture_enum_frminterval(FAR struct file *filep,
                                     FAR struct v4l2_frmivalenum *f);
 static int capture_enum_frmsize(FAR struct file *filep,
                                 FAR struct v4l2_frmsizeenum *f);
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *expbuf);
+#endif
 
 /* File operations function */
 
@@ -339,7 +348,17 @@ static const struct v4l2_ops_s g_capture_vops =
   capture_s_ext_ctrls_scene,          /* s_ext_ctrls_scene */
   capture_enum_fmt,                   /* enum_fmt */
   capture_enum_frminterval,           /* enum_frminterval */
-  capture_enum_frmsize                /* enum_frmsize */
+  capture_enum_frmsize,               /* enum_frmsize */
+  NULL,                               /* cropcap */
+  NULL,                               /* dqevent */
+  NULL,                               /* subscribe_event */
+  NULL,                               /* decoder_cmd */
+  NULL,                               /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  capture_expbuf                      /* expbuf */
+#else
+  NULL                                /* expbuf */
+#endif
 };
 
 static const struct file_operations g_capture_fops =
@@ -1185,19 +1204,7 @@ static void cleanup_streamresources(FAR capture_type_inf_t *type_inf,
   video_framebuff_uninit(&type_inf->bufinf);
   nxsem_destroy(&type_inf->wait_capture.dqbuf_wait_flg);
   nxmutex_destroy(&type_inf->lock_state);
-  if (type_inf->bufheap != NULL)
-    {
-      if (cmng->imgdata->ops->free)
-        {
-          cmng->imgdata->ops->free(cmng->imgdata, type_inf->bufheap);
-        }
-      else
-        {
-          kumm_free(type_inf->bufheap);
-        }
-
-      type_inf->bufheap = NULL;
-    }
+  free_bufheap(cmng, type_inf);
 }
 
 static void cleanup_scene_parameter(FAR capture_scene_params_t **vsp)
@@ -1323,6 +1330,51 @@ static size_t get_heapsize(FAR capture_type_inf_t *type_inf)
          get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]);
 }
 
+static void release_bufheap(FAR struct imgdata_s *imgdata,
+                            FAR void *bufheap)
+{
+  if (imgdata->ops->free)
+    {
+      imgdata->ops->free(imgdata, bufheap);
+    }
+  else
+    {
+      kumm_free(bufheap);
+    }
+}
+
+#ifdef CONFIG_VIDEO_DMABUF
+static void release_heapbuf(FAR struct dmabuf_s *buf)
+{
+  release_bufheap(buf->priv, buf->vaddr);
+}
+#endif
+
+static void free_bufheap(FAR capture_mng_t *cmng,
+                         FAR capture_type_inf_t *type_inf)
+{
+  if (type_inf->bufheap == NULL)
+    {
+      return;
+    }
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* Exported frames keep the heap alive until their last user is gone */
+
+  if (type_inf->heapbuf != NULL)
+    {
+      dmabuf_put(type_inf->heapbuf);
+      type_inf->heapbuf = NULL;
+    }
+  else
+#endif
+    {
+      release_bufheap(cmng->imgdata, type_inf->bufheap);
+    }
+
+  type_inf->bufheap = NULL;
+}
+
 static bool validate_clip_range(int32_t pos, uint32_t c_sz, uint16_t frm_sz)
 {
   return pos >= 0 && c_sz <= frm_sz && pos + c_sz <= frm_sz;
@@ -2174,17 +2226,7 @@ static int capture_reqbufs(FAR struct file *filep,
                                               reqbufs->count);
       if (ret == OK && reqbufs->memory == V4L2_MEMORY_MMAP)
         {
-          if (type_inf->bufheap != NULL)
-            {
-              if (imgdata->ops->free)
-                {
-                    imgdata->ops->free(imgdata, type_inf->bufheap);
-                }
-              else
-                {
-                  kumm_free(type_inf->bufheap);
-                }
-            }
+          free_bufheap(cmng, type_inf);
 
           if (imgdata->ops->alloc)
             {
@@ -2259,7 +2301,8 @@ static int capture_qbuf(FAR struct file *filep,
       return -EINVAL;
     }
 
-  if (!is_bufsize_sufficient(cmng, buf->length))
+  if (buf->memory != V4L2_MEMORY_DMABUF &&
+      !is_bufsize_sufficient(cmng, buf->length))
     {
       return -EINVAL;
     }
@@ -2279,6 +2322,18 @@ static int capture_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      int ret = video_framebuff_import(container,
+                  get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]));
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
+    }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -2393,7 +2448,7 @@ static int capture_dqbuf(FAR struct file *filep,
       type_inf->wait_capture.done_container = NULL;
     }
 
-  memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+  video_framebuff_dequeue(container, buf);
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
@@ -3537,6 +3592,64 @@ static int capture_enum_frminterval(FAR struct file *filep,
   return 0;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR capture_mng_t *cmng = inode->i_private;
+  FAR capture_type_inf_t *type_inf;
+  FAR struct dmabuf_s *slice;
+  size_t bufsize;
+  int ret;
+
+  if (cmng == NULL || expbuf == NULL || expbuf->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_capture_type_inf(cmng, expbuf->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      expbuf->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  /* The first export hands ownership of the MMAP heap to a buffer object
+   * so that frames stay valid after REQBUFS or close.
+   */
+
+  if (type_inf->heapbuf == NULL)
+    {
+      type_inf->heapbuf = dmabuf_alloc(type_inf->bufheap,
+                                       get_heapsize(type_inf),
+                                       release_heapbuf, cmng->imgdata);
+      if (type_inf->heapbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  bufsize = get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]);
+  slice   = dmabuf_slice(type_inf->heapbuf, bufsize * expbuf->index,
+                         bufsize);
+  if (slice == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = dmabuf_export(slice, expbuf->flags);
+  dmabuf_put(slice);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  expbuf->fd = ret;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * File Opterations Functions
  ****************************************************************************/
@@ -63,6 +63,9 @@ struct codec_type_inf_s
 {
   video_framebuff_t bufinf;
   FAR uint8_t       *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s *heapbuf; /* bufheap once a buffer is exported */
+#endif
   bool              buflast;
 };
 
@@ -153,6 +156,10 @@ static int codec_decoder_cmd(FAR struct file *filep,
                              FAR struct v4l2_decoder_cmd *cmd);
 static int codec_encoder_cmd(FAR struct file *filep,
                              FAR struct v4l2_encoder_cmd *cmd);
+#ifdef CONFIG_VIDEO_DMABUF
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *expbuf);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -198,7 +205,12 @@ static const struct v4l2_ops_s g_codec_vops =
   codec_dqevent,         /* dqevent */
   codec_subscribe_event, /* subscribe_event */
   codec_decoder_cmd,     /* decoder_cmd */
-  codec_encoder_cmd      /* encoder_cmd */
+  codec_encoder_cmd,     /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  codec_expbuf           /* expbuf */
+#else
+  NULL                   /* expbuf */
+#endif
 };
 
 static const struct file_operations g_codec_fops =
@@ -218,6 +230,32 @@ static const struct file_operations g_codec_fops =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void codec_release_heapbuf(FAR struct dmabuf_s *buf)
+{
+  kumm_free(buf->vaddr);
+}
+#endif
+
+static void codec_free_bufheap(FAR codec_type_inf_t *type_inf)
+{
+#ifdef CONFIG_VIDEO_DMABUF
+  /* Exported frames keep the heap alive until their last user is gone */
+
+  if (type_inf->heapbuf != NULL)
+    {
+      dmabuf_put(type_inf->heapbuf);
+      type_inf->heapbuf = NULL;
+    }
+  else
+#endif
+    {
+      kumm_free(type_inf->bufheap);
+    }
+
+  type_inf->bufheap = NULL;
+}
+
 static FAR codec_type_inf_t *
 codec_get_type_inf(FAR struct codec_file_s *cfile, int type)
 {
@@ -307,7 +345,7 @@ static int codec_reqbufs(FAR struct file *filep,
                                           reqbufs->count);
   if (ret == 0 && reqbufs->memory == V4L2_MEMORY_MMAP)
     {
-      kumm_free(type_inf->bufheap);
+      codec_free_bufheap(type_inf);
       type_inf->bufheap = kumm_memalign(32, reqbufs->count * buf_size);
       if (type_inf->bufheap == NULL)
         {
@@ -413,6 +451,32 @@ static int codec_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      int ret;
+
+      if (V4L2_TYPE_IS_OUTPUT(buf->type))
+        {
+          buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
+        }
+      else
+        {
+          buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
+        }
+
+      /* An imported output buffer only has to hold the payload */
+
+      ret = video_framebuff_import(container,
+                                   V4L2_TYPE_IS_OUTPUT(buf->type) ?
+                                   buf->bytesused : buf_size);
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
+    }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -460,7 +524,7 @@ static int codec_dqbuf(FAR struct file *filep,
       return -EAGAIN;
     }
 
-  memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+  video_framebuff_dequeue(container, buf);
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   vinfo("%s dequeue done\n", V4L2_TYPE_IS_OUTPUT(buf->type) ?
@@ -811,6 +875,75 @@ int codec_encoder_cmd(FAR struct file *filep,
 
 /* file operations */
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR codec_mng_t *cmng = inode->i_private;
+  FAR codec_file_t *cfile = filep->f_priv;
+  FAR codec_type_inf_t *type_inf;
+  FAR struct dmabuf_s *slice;
+  size_t buf_size;
+  int ret;
+
+  if (expbuf == NULL || expbuf->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = codec_get_type_inf(cfile, expbuf->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      expbuf->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  if (V4L2_TYPE_IS_OUTPUT(expbuf->type))
+    {
+      buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+  else
+    {
+      buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+
+  if (buf_size == 0)
+    {
+      return -EINVAL;
+    }
+
+  if (type_inf->heapbuf == NULL)
+    {
+      type_inf->heapbuf = dmabuf_alloc(type_inf->bufheap,
+                                       type_inf->bufinf.container_size *
+                                       buf_size, codec_release_heapbuf,
+                                       NULL);
+      if (type_inf->heapbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  slice = dmabuf_slice(type_inf->heapbuf, buf_size * expbuf->index,
+                       buf_size);
+  if (slice == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = dmabuf_export(slice, expbuf->flags);
+  dmabuf_put(slice);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  expbuf->fd = ret;
+  return OK;
+}
+#endif
+
 static int codec_open(FAR struct file *filep)
 {
   FAR struct inode *inode = filep->f_inode;
@@ -859,8 +992,8 @@ static int codec_close(FAR struct file *filep)
 
   video_framebuff_uninit(&cfile->capture_inf.bufinf);
   video_framebuff_uninit(&cfile->output_inf.bufinf);
-  kumm_free(cfile->capture_inf.bufheap);
-  kumm_free(cfile->output_inf.bufheap);
+  codec_free_bufheap(&cfile->capture_inf);
+  codec_free_bufheap(&cfile->output_inf);
   kmm_free(cfile);
 
   return OK;
@@ -0,0 +1,206 @@
+/****************************************************************************
+ * drivers/video/video_dmabuf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/video/dmabuf.h>
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void dmabuf_slice_release(FAR struct dmabuf_s *buf);
+static int dmabuf_close(FAR struct file *filep);
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_dmabuf_fops =
+{
+  NULL,          /* open */
+  dmabuf_close,  /* close */
+  NULL,          /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  NULL,          /* ioctl */
+  dmabuf_mmap,   /* mmap */
+};
+
+static struct inode g_dmabuf_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_dmabuf_fops        /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void dmabuf_slice_release(FAR struct dmabuf_s *buf)
+{
+  dmabuf_put(buf->priv);
+}
+
+static int dmabuf_close(FAR struct file *filep)
+{
+  dmabuf_put(filep->f_priv);
+  return OK;
+}
+
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct dmabuf_s *buf = filep->f_priv;
+
+  if (map->offset >= 0 && map->offset < buf->size &&
+      map->length && map->offset + map->length <= buf->size)
+    {
+      map->vaddr = (FAR uint8_t *)buf->vaddr + map->offset;
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_alloc(FAR void *vaddr, size_t size,
+                                  CODE void (*release)
+                                  (FAR struct dmabuf_s *buf),
+                                  FAR void *priv)
+{
+  FAR struct dmabuf_s *buf;
+
+  buf = kmm_zalloc(sizeof(struct dmabuf_s));
+  if (buf != NULL)
+    {
+      atomic_set(&buf->crefs, 1);
+      buf->vaddr   = vaddr;
+      buf->size    = size;
+      buf->release = release;
+      buf->priv    = priv;
+    }
+
+  return buf;
+}
+
+FAR struct dmabuf_s *dmabuf_slice(FAR struct dmabuf_s *parent,
+                                  size_t offset, size_t size)
+{
+  FAR struct dmabuf_s *buf;
+
+  if (parent == NULL || offset > parent->size ||
+      size > parent->size - offset)
+    {
+      return NULL;
+    }
+
+  buf = dmabuf_alloc((FAR uint8_t *)parent->vaddr + offset, size,
+                     dmabuf_slice_release, parent);
+  if (buf != NULL)
+    {
+      dmabuf_ref(parent);
+    }
+
+  return buf;
+}
+
+int dmabuf_export(FAR struct dmabuf_s *buf, int oflags)
+{
+  int fd;
+
+  if (buf == NULL || (oflags & ~(O_ACCMODE | O_CLOEXEC)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  dmabuf_ref(buf);
+  fd = file_allocate_from_inode(&g_dmabuf_inode,
+                                (oflags & O_ACCMODE) ?
+                                oflags : oflags | O_RDWR,
+                                0, buf, 0);
+  if (fd < 0)
+    {
+      dmabuf_put(buf);
+    }
+
+  return fd;
+}
+
+FAR struct dmabuf_s *dmabuf_get(int fd)
+{
+  FAR struct dmabuf_s *buf = NULL;
+  FAR struct file *filep;
+
+  if (file_get(fd, &filep) < 0)
+    {
+      return NULL;
+    }
+
+  if (filep->f_inode == &g_dmabuf_inode)
+    {
+      buf = filep->f_priv;
+      dmabuf_ref(buf);
+    }
+
+  file_put(filep);
+  return buf;
+}
+
+void dmabuf_ref(FAR struct dmabuf_s *buf)
+{
+  atomic_fetch_add(&buf->crefs, 1);
+}
+
+void dmabuf_put(FAR struct dmabuf_s *buf)
+{
+  if (buf != NULL && atomic_fetch_sub(&buf->crefs, 1) == 1)
+    {
+      if (buf->release != NULL)
+        {
+          buf->release(buf);
+        }
+
+      kmm_free(buf);
+    }
+}
@@ -54,6 +54,27 @@ static void init_buf_chain(video_framebuff_t *fbuf)
     }
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void release_dmabuf(vbuf_container_t *cnt)
+{
+  dmabuf_put(cnt->dmabuf);
+  cnt->dmabuf = NULL;
+}
+
+static void release_all_dmabuf(video_framebuff_t *fbuf)
+{
+  int i;
+
+  for (i = 0; i < fbuf->container_size; i++)
+    {
+      release_dmabuf(&fbuf->vbuf_alloced[i]);
+    }
+}
+#else
+#  define release_dmabuf(cnt)
+#  define release_all_dmabuf(fbuf)
+#endif
+
 static inline bool is_last_one(video_framebuff_t *fbuf)
 {
   return fbuf->vbuf_top == fbuf->vbuf_tail;
@@ -111,6 +132,10 @@ int video_framebuff_realloc_container(video_framebuff_t *fbuf, int sz)
       return OK;
     }
 
+  /* Drop the buffers still held by queued containers */
+
+  release_all_dmabuf(fbuf);
+
   if (sz > 0)
     {
       vbuf = kmm_realloc(fbuf->vbuf_alloced, sizeof(vbuf_container_t) * sz);
@@ -163,6 +188,8 @@ vbuf_container_t *video_framebuff_get_container(video_framebuff_t *fbuf)
 void video_framebuff_free_container(video_framebuff_t *fbuf,
                                     vbuf_container_t  *cnt)
 {
+  release_dmabuf(cnt);
+
   nxmutex_lock(&fbuf->lock_empty);
   cnt->next = fbuf->vbuf_empty;
   fbuf->vbuf_empty = cnt;
@@ -289,3 +316,44 @@ vbuf_container_t *video_framebuff_pop_curr_container(video_framebuff_t *fbuf)
   spin_unlock_irqrestore(&fbuf->lock_queue, flags);
   return ret;
 }
+
+#ifdef CONFIG_VIDEO_DMABUF
+int video_framebuff_import(vbuf_container_t *cnt, size_t minsize)
+{
+  FAR struct dmabuf_s *dmabuf;
+
+  dmabuf = dmabuf_get(cnt->buf.m.fd);
+  if (dmabuf == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (dmabuf->size < minsize)
+    {
+      dmabuf_put(dmabuf);
+      return -EINVAL;
+    }
+
+  /* Drivers only see a plain pointer into the shared buffer */
+
+  cnt->dmabuf        = dmabuf;
+  cnt->dmafd         = cnt->buf.m.fd;
+  cnt->buf.length    = dmabuf->size;
+  cnt->buf.m.userptr = (unsigned long)dmabuf->vaddr;
+  return OK;
+}
+#endif
+
+void video_framebuff_dequeue(vbuf_container_t *cnt, struct v4l2_buffer *buf)
+{
+  memcpy(buf, &cnt->buf, sizeof(struct v4l2_buffer));
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* Hand back the descriptor the application queued, not our pointer */
+
+  if (cnt->dmabuf != NULL)
+    {
+      buf->m.fd = cnt->dmafd;
+    }
+#endif
+}
@@ -0,0 +1,613 @@
+/****************************************************************************
+ * drivers/video/vnc/vnc_hextile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Sub-rectangle position and size, packed 4 bits each */
+
+#define HEXTILE_XY(x,y)        (((x) << 4) | (y))
+#define HEXTILE_WH(w,h)        ((((w) - 1) << 4) | ((h) - 1))
+
+/* Maximum number of sub-rectangles that fit in the count byte */
+
+#define HEXTILE_MAXSUBRECTS    255
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE uint32_t (*vnc_hextile_convert_t)(lfb_color_t rgb);
+
+/* State carried from tile to tile while one rectangle is encoded */
+
+struct vnc_hextile_s
+{
+  FAR struct vnc_session_s *session;
+  FAR uint8_t *pos;            /* Next free byte in session->outbuf */
+  FAR uint8_t *end;            /* End of session->outbuf */
+  vnc_hextile_convert_t convert;
+  uint32_t bg;                 /* Background of the previous tile */
+  uint32_t fg;                 /* Foreground of the previous tile */
+  uint8_t bpp;                 /* Remote bytes per pixel */
+  bool bigendian;
+  bool bgvalid;                /* bg may be carried over */
+  bool fgvalid;                /* fg may be carried over */
+  size_t nbytes;               /* Total bytes sent */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t vnc_hextile_rgb8_222(lfb_color_t rgb)
+{
+  return vnc_convert_rgb8_222(rgb);
+}
+
+static uint32_t vnc_hextile_rgb8_332(lfb_color_t rgb)
+{
+  return vnc_convert_rgb8_332(rgb);
+}
+
+static uint32_t vnc_hextile_rgb16_555(lfb_color_t rgb)
+{
+  return vnc_convert_rgb16_555(rgb);
+}
+
+static uint32_t vnc_hextile_rgb16_565(lfb_color_t rgb)
+{
+  return vnc_convert_rgb16_565(rgb);
+}
+
+static uint32_t vnc_hextile_rgb32_888(lfb_color_t rgb)
+{
+  return vnc_convert_rgb32_888(rgb);
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_flush
+ *
+ * Description:
+ *   Send everything accumulated in the output buffer.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_flush(FAR struct vnc_hextile_s *ctx)
+{
+  FAR const uint8_t *src = ctx->session->outbuf;
+  size_t size = ctx->pos - src;
+  ssize_t nsent;
+
+  while (size > 0)
+    {
+      nsent = psock_send(&ctx->session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      src         += nsent;
+      size        -= nsent;
+      ctx->nbytes += nsent;
+    }
+
+  ctx->pos = ctx->session->outbuf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_putc / vnc_hextile_putpixel
+ *
+ * Description:
+ *   Append a byte or a remote pixel to the output, sending the buffer
+ *   whenever it fills up.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_putc(FAR struct vnc_hextile_s *ctx, uint8_t ch)
+{
+  if (ctx->pos >= ctx->end)
+    {
+      int ret = vnc_hextile_flush(ctx);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  *ctx->pos++ = ch;
+  return OK;
+}
+
+static int vnc_hextile_putpixel(FAR struct vnc_hextile_s *ctx,
+                                uint32_t pixel)
+{
+  uint8_t bytes[4];
+  int ret = OK;
+  int i;
+
+  if (ctx->bpp == 1)
+    {
+      bytes[0] = (uint8_t)pixel;
+    }
+  else if (ctx->bpp == 2)
+    {
+      if (ctx->bigendian)
+        {
+          rfb_putbe16(bytes, pixel);
+        }
+      else
+        {
+          rfb_putle16(bytes, pixel);
+        }
+    }
+  else
+    {
+      if (ctx->bigendian)
+        {
+          rfb_putbe32(bytes, pixel);
+        }
+      else
+        {
+          rfb_putle32(bytes, pixel);
+        }
+    }
+
+  for (i = 0; i < ctx->bpp && ret >= 0; i++)
+    {
+      ret = vnc_hextile_putc(ctx, bytes[i]);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_subrect
+ *
+ * Description:
+ *   Grow a sub-rectangle of one color from the unmarked pixel at (x, y),
+ *   first to the right and then downwards, and mark the pixels it covers.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_subrect(FAR const uint32_t *tile,
+                                FAR uint16_t *mark, int x, int y,
+                                int w, int h, FAR int *sw, FAR int *sh)
+{
+  uint32_t color = tile[y * w + x];
+  uint16_t bits;
+  int i;
+  int j;
+
+  for (i = x + 1; i < w; i++)
+    {
+      if (tile[y * w + i] != color || (mark[y] & (1 << i)) != 0)
+        {
+          break;
+        }
+    }
+
+  *sw  = i - x;
+  bits = ((1 << *sw) - 1) << x;
+
+  for (j = y + 1; j < h; j++)
+    {
+      if ((mark[j] & bits) != 0)
+        {
+          break;
+        }
+
+      for (i = x; i < x + *sw; i++)
+        {
+          if (tile[j * w + i] != color)
+            {
+              break;
+            }
+        }
+
+      if (i < x + *sw)
+        {
+          break;
+        }
+    }
+
+  *sh = j - y;
+
+  for (j = y; j < y + *sh; j++)
+    {
+      mark[j] |= bits;
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_scan
+ *
+ * Description:
+ *   Walk the sub-rectangles that paint the non-background pixels of a
+ *   tile.  If 'ctx' is NULL they are only counted, otherwise they are
+ *   emitted.
+ *
+ * Returned Value:
+ *   The number of sub-rectangles, or a negated errno value if sending
+ *   failed.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_scan(FAR struct vnc_hextile_s *ctx,
+                            FAR const uint32_t *tile, int w, int h,
+                            uint32_t bg, bool colored)
+{
+  uint16_t mark[16];
+  int nsubrects = 0;
+  int sw;
+  int sh;
+  int ret;
+  int x;
+  int y;
+
+  memset(mark, 0, sizeof(mark));
+
+  for (y = 0; y < h; y++)
+    {
+      for (x = 0; x < w; x++)
+        {
+          if (tile[y * w + x] == bg || (mark[y] & (1 << x)) != 0)
+            {
+              continue;
+            }
+
+          vnc_hextile_subrect(tile, mark, x, y, w, h, &sw, &sh);
+
+          if (ctx != NULL)
+            {
+              ret = colored ? vnc_hextile_putpixel(ctx, tile[y * w + x]) :
+                              OK;
+              if (ret >= 0)
+                {
+                  ret = vnc_hextile_putc(ctx, HEXTILE_XY(x, y));
+                }
+
+              if (ret >= 0)
+                {
+                  ret = vnc_hextile_putc(ctx, HEXTILE_WH(sw, sh));
+                }
+
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          nsubrects++;
+        }
+    }
+
+  return nsubrects;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile of at most 16x16 pixels at (x, y) in the local
+ *   framebuffer.  The cheapest of background only, monochrome
+ *   sub-rectangles, colored sub-rectangles and raw pixels is chosen.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_tile(FAR struct vnc_hextile_s *ctx,
+                            fb_coord_t x, fb_coord_t y, int w, int h)
+{
+  FAR struct vnc_session_s *session = ctx->session;
+  FAR uint32_t *tile = session->hextile_tile;
+  FAR const lfb_color_t *src;
+  uint32_t colors[2];
+  uint32_t bg;
+  uint32_t fg = 0;
+  int ncolors = 0;
+  int nsubrects = 0;
+  size_t rawsize;
+  size_t size;
+  uint8_t subenc = 0;
+  bool colored = false;
+  int ret;
+  int i;
+  int j;
+
+  /* Fetch the tile in the remote pixel format */
+
+  for (j = 0; j < h; j++)
+    {
+      src = (FAR const lfb_color_t *)
+        (session->fb + RFB_STRIDE * (y + j) + RFB_BYTESPERPIXEL * x);
+
+      for (i = 0; i < w; i++)
+        {
+          uint32_t pixel = ctx->convert(src[i]);
+
+          tile[j * w + i] = pixel;
+          if (ncolors < 3 &&
+              (ncolors < 1 || pixel != colors[0]) &&
+              (ncolors < 2 || pixel != colors[1]))
+            {
+              if (ncolors < 2)
+                {
+                  colors[ncolors] = pixel;
+                }
+
+              ncolors++;
+            }
+        }
+    }
+
+  /* Prefer the carried over background when it appears in the tile */
+
+  bg = colors[0];
+  if (ctx->bgvalid && ncolors > 1 && ctx->bg == colors[1])
+    {
+      bg = colors[1];
+      fg = colors[0];
+    }
+  else if (ncolors > 1)
+    {
+      fg = colors[1];
+    }
+
+  rawsize = w * h * ctx->bpp;
+  size    = 1 + ((ctx->bgvalid && bg == ctx->bg) ? 0 : ctx->bpp);
+
+  if (ncolors > 1)
+    {
+      colored   = ncolors > 2;
+      nsubrects = vnc_hextile_scan(NULL, tile, w, h, bg, colored);
+
+      size += 1 + nsubrects * (colored ? ctx->bpp + 2 : 2);
+      if (!colored && !(ctx->fgvalid && fg == ctx->fg))
+        {
+          size += ctx->bpp;
+        }
+    }
+
+  if (nsubrects > HEXTILE_MAXSUBRECTS || size >= 1 + rawsize)
+    {
+      /* Raw is no larger; it also invalidates both carried colors */
+
+      ret = vnc_hextile_putc(ctx, RFB_SUBENCODING_RAW);
+      for (i = 0; i < w * h && ret >= 0; i++)
+        {
+          ret = vnc_hextile_putpixel(ctx, tile[i]);
+        }
+
+      ctx->bgvalid = false;
+      ctx->fgvalid = false;
+      return ret;
+    }
+
+  if (!ctx->bgvalid || bg != ctx->bg)
+    {
+      subenc |= RFB_SUBENCODING_BACK;
+    }
+
+  if (nsubrects > 0)
+    {
+      subenc |= RFB_SUBENCODING_ANY;
+      if (colored)
+        {
+          subenc |= RFB_SUBENCODING_COLORED;
+        }
+      else if (!ctx->fgvalid || fg != ctx->fg)
+        {
+          subenc |= RFB_SUBENCODING_FORE;
+        }
+    }
+
+  ret = vnc_hextile_putc(ctx, subenc);
+  if (ret >= 0 && (subenc & RFB_SUBENCODING_BACK) != 0)
+    {
+      ret = vnc_hextile_putpixel(ctx, bg);
+    }
+
+  if (ret >= 0 && (subenc & RFB_SUBENCODING_FORE) != 0)
+    {
+      ret = vnc_hextile_putpixel(ctx, fg);
+    }
+
+  if (ret >= 0 && nsubrects > 0)
+    {
+      ret = vnc_hextile_putc(ctx, nsubrects);
+      if (ret >= 0)
+        {
+          ret = vnc_hextile_scan(ctx, tile, w, h, bg, colored);
+        }
+    }
+
+  ctx->bg      = bg;
+  ctx->bgvalid = true;
+
+  if (colored)
+    {
+      ctx->fgvalid = false;
+    }
+  else if (nsubrects > 0)
+    {
+      ctx->fg      = fg;
+      ctx->fgvalid = true;
+    }
+
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the update rectangle using the Hextile encoding if the client
+ *  supports it.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct fb_area_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  struct vnc_hextile_s ctx;
+  uint8_t colorfmt;
+  fb_coord_t x;
+  fb_coord_t y;
+  int ret;
+
+  if (!session->hextile)
+    {
+      return 0;
+    }
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.session   = session;
+  ctx.end       = session->outbuf + sizeof(session->outbuf);
+  ctx.bpp       = (session->bpp + 7) >> 3;
+  ctx.bigendian = session->bigendian;
+
+  colorfmt = session->colorfmt;
+  switch (colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        ctx.convert = vnc_hextile_rgb8_222;
+        break;
+
+      case FB_FMT_RGB8_332:
+        ctx.convert = vnc_hextile_rgb8_332;
+        break;
+
+      case FB_FMT_RGB16_555:
+        ctx.convert = vnc_hextile_rgb16_555;
+        break;
+
+      case FB_FMT_RGB16_565:
+        ctx.convert = vnc_hextile_rgb16_565;
+        break;
+
+      case FB_FMT_RGB32:
+        ctx.convert = vnc_hextile_rgb32_888;
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", session->colorfmt);
+        return -EINVAL;
+    }
+
+  /* One FramebufferUpdate with a single Hextile rectangle.  The tiles are
+   * streamed behind the header, so the rectangle is not limited by the
+   * size of the output buffer.
+   */
+
+  update = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, rect->x);
+  rfb_putbe16(update->rect[0].ypos, rect->y);
+  rfb_putbe16(update->rect[0].width, rect->w);
+  rfb_putbe16(update->rect[0].height, rect->h);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_HEXTILE);
+
+  ctx.pos = session->outbuf +
+            SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0));
+
+  for (y = rect->y; y < rect->y + rect->h; y += 16)
+    {
+      for (x = rect->x; x < rect->x + rect->w; x += 16)
+        {
+          /* Once the header is out the tiles must follow, even if the
+           * client changes its pixel format meanwhile.
+           */
+
+          ret = vnc_hextile_tile(&ctx, x, y,
+                                 MIN(16, rect->x + rect->w - x),
+                                 MIN(16, rect->y + rect->h - y));
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  ret = vnc_hextile_flush(&ctx);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n",
+          rect->x, rect->y, rect->w, rect->h);
+  return ctx.nbytes;
+}
@@ -293,6 +293,13 @@ int vnc_receiver(FAR struct vnc_session_s *session)
                   rect.w = rfb_getbe16(update->width);
                   rect.h = rfb_getbe16(update->height);
 
+                  /* A non-incremental request asks for the full content */
+
+                  if (!update->incremental)
+                    {
+                      vnc_damage_invalidate(session, &rect);
+                    }
+
                   ret = vnc_update_rectangle(session, &rect, false);
                   if (ret < 0)
                     {
@@ -470,7 +477,8 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
 
   /* Assume that there are no common encodings (other than RAW) */
 
-  session->rre = false;
+  session->rre     = false;
+  session->hextile = false;
 
   /* Loop for each client supported encoding */
 
@@ -487,6 +495,12 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      else if (encoding == RFB_ENCODING_HEXTILE)
+        {
+          session->hextile = true;
+        }
+#endif
     }
 
   session->change = true;
@@ -127,6 +127,10 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   session->nwhupd  = 0;
   session->change  = true;
 
+  /* A new client has seen nothing yet */
+
+  vnc_damage_invalidate(session, NULL);
+
 #ifdef CONFIG_VNCSERVER_TOUCH
   session->touch.maxpoint = 1;
 #endif
@@ -140,12 +140,25 @@
 #define VNCSERVER_UPDATE_BUFSIZE \
   (CONFIG_VNCSERVER_UPDATE_BUFSIZE + SIZEOF_RFB_FRAMEBUFFERUPDATE_S(0))
 
+#ifndef CONFIG_VNCSERVER_UPDATE_INTERVAL
+#  define CONFIG_VNCSERVER_UPDATE_INTERVAL 0
+#endif
+
 /* Local framebuffer characteristics in bytes */
 
 #define RFB_BYTESPERPIXEL   ((RFB_BITSPERPIXEL + 7) >> 3)
 #define RFB_STRIDE          (RFB_BYTESPERPIXEL * CONFIG_VNCSERVER_SCREENWIDTH)
 #define RFB_SIZE            (RFB_STRIDE * CONFIG_VNCSERVER_SCREENHEIGHT)
 
+/* Damage tracking works on the 16x16 Hextile grid */
+
+#define RFB_TILESIZE        16
+#define RFB_TILESX          \
+  ((CONFIG_VNCSERVER_SCREENWIDTH + RFB_TILESIZE - 1) / RFB_TILESIZE)
+#define RFB_TILESY          \
+  ((CONFIG_VNCSERVER_SCREENHEIGHT + RFB_TILESIZE - 1) / RFB_TILESIZE)
+#define RFB_NTILES          (RFB_TILESX * RFB_TILESY)
+
 /* RFB Port Number */
 
 #define RFB_PORT_BASE       5900
@@ -209,6 +222,7 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -244,6 +258,18 @@ struct vnc_session_s
 
   uint8_t inbuf[CONFIG_VNCSERVER_INBUFFER_SIZE];
   uint8_t outbuf[VNCSERVER_UPDATE_BUFSIZE];
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  /* Hextile encoder work buffer, one tile in the remote format */
+
+  uint32_t hextile_tile[RFB_TILESIZE * RFB_TILESIZE];
+#endif
+
+#ifdef CONFIG_VNCSERVER_DAMAGE
+  /* Hash of each tile as last sent to the client, zero if unknown */
+
+  uint32_t tilehash[RFB_NTILES];
+#endif
 };
 
 /* This structure is used to communicate start-up status between the server
@@ -427,6 +453,29 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                          FAR const struct fb_area_s *rect,
                          bool change);
 
+/****************************************************************************
+ * Name: vnc_damage_invalidate
+ *
+ * Description:
+ *  Forget what the client has seen of the tiles overlapping a rectangle so
+ *  that they are sent again by the next update.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The rectangular region, NULL for the whole screen.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_DAMAGE
+void vnc_damage_invalidate(FAR struct vnc_session_s *session,
+                           FAR const struct fb_area_s *rect);
+#else
+#  define vnc_damage_invalidate(s,r)
+#endif
+
 /****************************************************************************
  * Name: vnc_receiver
  *
@@ -466,6 +515,32 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the update rectangle using the Hextile encoding if the client
+ *  supports it.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct fb_area_s *rect);
+#else
+#  define vnc_hextile(s,r) 0
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
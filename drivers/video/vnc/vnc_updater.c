@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <string.h>
 #include <sched.h>
 #include <nuttx/irq.h>
@@ -50,7 +51,9 @@
 #endif
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/queue.h>
+#include <nuttx/signal.h>
 #ifdef VNCSERVER_SEM_DEBUG
 #  include <nuttx/mutex.h>
 #endif
@@ -258,6 +261,7 @@ static void vnc_free_update(FAR struct vnc_session_s *session,
  *
  * Input Parameters:
  *   session - A reference to the VNC session structure.
+ *   wait    - False: Return NULL instead of waiting if the queue is empty.
  *
  * Returned Value:
  *   A structure pointer should always be returned. If the return value is
@@ -266,7 +270,7 @@ static void vnc_free_update(FAR struct vnc_session_s *session,
  ****************************************************************************/
 
 static FAR struct vnc_fbupdate_s *
-vnc_remove_queue(FAR struct vnc_session_s *session)
+vnc_remove_queue(FAR struct vnc_session_s *session, bool wait)
 {
   FAR struct vnc_fbupdate_s *rect;
   irqstate_t flags;
@@ -280,7 +284,15 @@ vnc_remove_queue(FAR struct vnc_session_s *session)
   vnc_sem_debug(session, "Before remove", 0);
   flags = enter_critical_section();
 
-  nxsem_wait_uninterruptible(&session->queuesem);
+  if (wait)
+    {
+      nxsem_wait_uninterruptible(&session->queuesem);
+    }
+  else if (nxsem_trywait(&session->queuesem) < 0)
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
 
   /* It is reserved.. go get it */
 
@@ -351,6 +363,203 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
               sval <= CONFIG_VNCSERVER_NUPDATES);
 }
 
+/****************************************************************************
+ * Name: vnc_send_rect
+ *
+ * Description:
+ *   Send one rectangle with the best encoding the client supports.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_send_rect(FAR struct vnc_session_s *session,
+                         FAR struct fb_area_s *rect)
+{
+  int ret;
+
+  /* Attempt to use RRE encoding for a single color, then Hextile */
+
+  ret = vnc_rre(session, rect);
+  if (ret == 0)
+    {
+      ret = vnc_hextile(session, rect);
+    }
+
+  if (ret == 0)
+    {
+      /* Perform the framebuffer update using the default RAW encoding */
+
+      ret = vnc_raw(session, rect);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: vnc_tile_hash
+ *
+ * Description:
+ *   Hash (FNV-1a) the local pixels of one tile.  Zero is reserved to mean
+ *   "not known to the client".
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_DAMAGE
+static uint32_t vnc_tile_hash(FAR struct vnc_session_s *session,
+                              fb_coord_t x, fb_coord_t y,
+                              fb_coord_t w, fb_coord_t h)
+{
+  FAR const uint8_t *row;
+  uint32_t hash = 2166136261u;
+  fb_coord_t i;
+  fb_coord_t j;
+
+  row = session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x;
+  for (j = 0; j < h; j++, row += RFB_STRIDE)
+    {
+      for (i = 0; i < w * RFB_BYTESPERPIXEL; i++)
+        {
+          hash = (hash ^ row[i]) * 16777619u;
+        }
+    }
+
+  return hash != 0 ? hash : 1;
+}
+
+/****************************************************************************
+ * Name: vnc_send_damage
+ *
+ * Description:
+ *   Send only the tiles of a rectangle whose content differs from what was
+ *   last sent.  The rectangle is widened to the tile grid, and each run of
+ *   changed tiles in a tile row goes out as one rectangle.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_send_damage(FAR struct vnc_session_s *session,
+                           FAR const struct fb_area_s *rect)
+{
+  struct fb_area_s run;
+  fb_coord_t tx0 = rect->x / RFB_TILESIZE;
+  fb_coord_t ty0 = rect->y / RFB_TILESIZE;
+  fb_coord_t tx1 = (rect->x + rect->w + RFB_TILESIZE - 1) / RFB_TILESIZE;
+  fb_coord_t ty1 = (rect->y + rect->h + RFB_TILESIZE - 1) / RFB_TILESIZE;
+  fb_coord_t first;
+  fb_coord_t tx;
+  fb_coord_t ty;
+  int ret = OK;
+
+  tx1 = MIN(tx1, RFB_TILESX);
+  ty1 = MIN(ty1, RFB_TILESY);
+
+  for (ty = ty0; ty < ty1 && ret >= 0; ty++)
+    {
+      run.y = ty * RFB_TILESIZE;
+      run.h = MIN(RFB_TILESIZE, CONFIG_VNCSERVER_SCREENHEIGHT - run.y);
+
+      for (tx = tx0, first = tx0; tx <= tx1 && ret >= 0; tx++)
+        {
+          bool changed = false;
+
+          if (tx < tx1)
+            {
+              FAR uint32_t *slot = &session->tilehash[ty * RFB_TILESX + tx];
+              fb_coord_t x = tx * RFB_TILESIZE;
+              uint32_t hash;
+
+              hash = vnc_tile_hash(session, x, run.y,
+                                   MIN(RFB_TILESIZE,
+                                       CONFIG_VNCSERVER_SCREENWIDTH - x),
+                                   run.h);
+              changed = hash != *slot;
+              *slot   = hash;
+            }
+
+          if (changed)
+            {
+              continue;
+            }
+
+          /* Flush the run of changed tiles that ends here */
+
+          if (tx > first)
+            {
+              run.x = first * RFB_TILESIZE;
+              run.w = MIN(tx * RFB_TILESIZE,
+                          CONFIG_VNCSERVER_SCREENWIDTH) - run.x;
+              ret   = vnc_send_rect(session, &run);
+            }
+
+          first = tx + 1;
+        }
+    }
+
+  return ret;
+}
+#else
+#  define vnc_send_damage(s,r) vnc_send_rect(s,r)
+#endif
+
+/****************************************************************************
+ * Name: vnc_merge_queue
+ *
+ * Description:
+ *   Wait out the minimum update interval, then fold every update queued
+ *   meanwhile into the bounding box of 'rect'.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The update being processed, grown in place.
+ *   last    - Time of the previous update in clock ticks.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_VNCSERVER_UPDATE_INTERVAL > 0
+static void vnc_merge_queue(FAR struct vnc_session_s *session,
+                            FAR struct fb_area_s *rect, clock_t last)
+{
+  FAR struct vnc_fbupdate_s *next;
+  clock_t elapsed;
+  fb_coord_t x1;
+  fb_coord_t y1;
+
+  elapsed = clock_systime_ticks() - last;
+  if (elapsed < MSEC2TICK(CONFIG_VNCSERVER_UPDATE_INTERVAL))
+    {
+      nxsig_usleep(TICK2USEC(MSEC2TICK(CONFIG_VNCSERVER_UPDATE_INTERVAL) -
+                             elapsed));
+    }
+
+  while ((next = vnc_remove_queue(session, false)) != NULL)
+    {
+      x1      = MAX(rect->x + rect->w, next->rect.x + next->rect.w);
+      y1      = MAX(rect->y + rect->h, next->rect.y + next->rect.h);
+      rect->x = MIN(rect->x, next->rect.x);
+      rect->y = MIN(rect->y, next->rect.y);
+      rect->w = x1 - rect->x;
+      rect->h = y1 - rect->y;
+
+      vnc_free_update(session, next);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -374,6 +583,9 @@ static FAR void *vnc_updater(FAR void *arg)
 #ifdef CONFIG_FB_SYNC
   int val;
 #endif
+#if CONFIG_VNCSERVER_UPDATE_INTERVAL > 0
+  clock_t last = 0;
+#endif
 
   DEBUGASSERT(session != NULL);
   ginfo("Updater running for Display %d\n", session->display);
@@ -390,7 +602,7 @@ static FAR void *vnc_updater(FAR void *arg)
        * update is available for the case where the update queue is empty.
        */
 
-      srcrect = vnc_remove_queue(session);
+      srcrect = vnc_remove_queue(session, true);
 
       /* If connect lost, exit this updater loop */
 
@@ -404,19 +616,18 @@ static FAR void *vnc_updater(FAR void *arg)
           continue;
         }
 
+#if CONFIG_VNCSERVER_UPDATE_INTERVAL > 0
+      /* Rate limit the updates, coalescing those that arrive meanwhile */
+
+      vnc_merge_queue(session, &srcrect->rect, last);
+      last = clock_systime_ticks();
+#endif
+
       updinfo("Dequeued {(%d, %d),(%d, %d)}\n",
               srcrect->rect.x, srcrect->rect.y,
               srcrect->rect.w, srcrect->rect.h);
 
-      /* Attempt to use RRE encoding */
-
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
-        {
-          /* Perform the framebuffer update using the default RAW encoding */
-
-          ret = vnc_raw(session, &srcrect->rect);
-        }
+      ret = vnc_send_damage(session, &srcrect->rect);
 
       /* Release the update structure */
 
@@ -691,3 +902,49 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: vnc_damage_invalidate
+ *
+ * Description:
+ *  Forget what the client has seen of the tiles overlapping a rectangle so
+ *  that they are sent again by the next update.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The rectangular region, NULL for the whole screen.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_DAMAGE
+void vnc_damage_invalidate(FAR struct vnc_session_s *session,
+                           FAR const struct fb_area_s *rect)
+{
+  fb_coord_t tx;
+  fb_coord_t ty;
+  fb_coord_t tx1;
+  fb_coord_t ty1;
+
+  if (rect == NULL)
+    {
+      memset(session->tilehash, 0, sizeof(session->tilehash));
+      return;
+    }
+
+  tx1 = MIN((rect->x + rect->w + RFB_TILESIZE - 1) / RFB_TILESIZE,
+            RFB_TILESX);
+  ty1 = MIN((rect->y + rect->h + RFB_TILESIZE - 1) / RFB_TILESIZE,
+            RFB_TILESY);
+
+  for (ty = rect->y / RFB_TILESIZE; ty < ty1; ty++)
+    {
+      for (tx = rect->x / RFB_TILESIZE; tx < tx1; tx++)
+        {
+          session->tilehash[ty * RFB_TILESX + tx] = 0;
+        }
+    }
+}
+#endif
@@ -27,9 +27,12 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
+#include <sys/param.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkqueue.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/virtio/virtio.h>
@@ -49,12 +52,21 @@
 #define VIRTIO_BLK_F_RO             5  /* Disk is read-only */
 #define VIRTIO_BLK_F_BLK_SIZE       6  /* Block size of disk is available */
 #define VIRTIO_BLK_F_FLUSH          9  /* Cache flush command support */
+#define VIRTIO_BLK_F_MQ             12 /* Support more than one vq */
+#define VIRTIO_BLK_F_DISCARD        13 /* Discard command support */
+#define VIRTIO_BLK_F_WRITE_ZEROES   14 /* Write zeroes command support */
 
 /* Block request type */
 
 #define VIRTIO_BLK_T_IN             0  /* READ */
 #define VIRTIO_BLK_T_OUT            1  /* WRITE */
 #define VIRTIO_BLK_T_FLUSH          4  /* FLUSH */
+#define VIRTIO_BLK_T_DISCARD        11 /* DISCARD */
+#define VIRTIO_BLK_T_WRITE_ZEROES   13 /* WRITE ZEROES */
+
+/* Discard and write zeroes flags */
+
+#define VIRTIO_BLK_WRITE_ZEROES_F_UNMAP (1 << 0)
 
 /* Block request return status */
 
@@ -67,6 +79,14 @@
 #define VIRTIO_BLK_SECTOR_BITS      9
 #define VIRTIO_BLK_SECTOR_SIZE      (1UL << VIRTIO_BLK_SECTOR_BITS)
 
+/* One virtqueue per CPU at most */
+
+#ifdef CONFIG_SMP
+#  define VIRTIO_BLK_MAX_QUEUES     CONFIG_SMP_NCPUS
+#else
+#  define VIRTIO_BLK_MAX_QUEUES     1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -80,6 +100,15 @@ begin_packed_struct struct virtio_blk_req_s
   uint64_t sector;
 } end_packed_struct;
 
+/* The segment of a discard or write zeroes request */
+
+begin_packed_struct struct virtio_blk_discard_s
+{
+  uint64_t sector;
+  uint32_t num_sectors;
+  uint32_t flags;
+} end_packed_struct;
+
 /* Block request in header */
 
 begin_packed_struct struct virtio_blk_resp_s
@@ -115,12 +144,29 @@ begin_packed_struct struct virtio_blk_config_s
   uint32_t secure_erase_sector_alignment;
 } end_packed_struct;
 
+/* The cookie of a request in the virtqueue.  The headers live in it until
+ * the device completes the request.
+ */
+
+struct virtio_blk_cookie_s
+{
+  struct virtio_blk_req_s   req;  /* The block out header */
+  struct virtio_blk_resp_s  resp; /* The block in header */
+  FAR sem_t                *sem;  /* Posted when a waited request is done */
+#ifdef CONFIG_BLK_QUEUE
+  FAR struct blk_request_s *breq; /* The asynchronous request, if any */
+#endif
+};
+
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio device */
-  spinlock_t                    lock;           /* Lock */
+  spinlock_t                    lock[VIRTIO_BLK_MAX_QUEUES];
+  int                           nvqs;           /* Virtqueue numbers */
   uint64_t                      nsectors;       /* Sectore numbers */
   uint32_t                      block_size;     /* Block size */
+  uint32_t                      max_discard;    /* Discard sectors limit */
+  uint32_t                      max_zeroes;     /* Write zeroes limit */
   char                          name[NAME_MAX]; /* Device name */
 };
 
@@ -145,7 +191,15 @@ static int     virtio_blk_geometry(FAR struct inode *inode,
                                    FAR struct geometry *geometry);
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                                 unsigned long arg);
-static int     virtio_blk_flush(FAR struct virtio_blk_priv_s *priv);
+static int     virtio_blk_cmd(FAR struct virtio_blk_priv_s *priv,
+                              uint32_t type, FAR void *data, size_t len);
+static int     virtio_blk_discard(FAR struct virtio_blk_priv_s *priv,
+                                  uint32_t type, uint32_t limit,
+                                  FAR const blkcnt_t *range);
+#ifdef CONFIG_BLK_QUEUE
+static int     virtio_blk_submit(FAR struct inode *inode,
+                                 FAR struct blk_request_s *breq);
+#endif
 
 /* Other functions */
 
@@ -175,7 +229,13 @@ static const struct block_operations g_virtio_blk_bops =
   virtio_blk_read,     /* read     */
   virtio_blk_write,    /* write    */
   virtio_blk_geometry, /* geometry */
-  virtio_blk_ioctl     /* ioctl    */
+  virtio_blk_ioctl,    /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,                /* unlink   */
+#endif
+#ifdef CONFIG_BLK_QUEUE
+  virtio_blk_submit,   /* submit   */
+#endif
 };
 
 static int g_virtio_blk_idx = 0;
@@ -184,6 +244,45 @@ static int g_virtio_blk_idx = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_blk_vq
+ *
+ * Description:
+ *   Return the index of the virtqueue used by the current CPU
+ *
+ ****************************************************************************/
+
+static inline int virtio_blk_vq(FAR struct virtio_blk_priv_s *priv)
+{
+  return this_cpu() % priv->nvqs;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_complete
+ *
+ * Description:
+ *   Handle the completion of a request by the device
+ *
+ ****************************************************************************/
+
+static void virtio_blk_complete(FAR struct virtio_blk_cookie_s *cookie)
+{
+#ifdef CONFIG_BLK_QUEUE
+  FAR struct blk_request_s *breq = cookie->breq;
+
+  if (breq != NULL)
+    {
+      bool ok = cookie->resp.status == VIRTIO_BLK_S_OK;
+
+      kmm_free(cookie);
+      blk_complete(breq, ok ? (ssize_t)breq->br_nsectors : -EIO);
+      return;
+    }
+#endif
+
+  nxsem_post(cookie->sem);
+}
+
 /****************************************************************************
  * Name: virtio_blk_wait_complete
  *
@@ -193,62 +292,60 @@ static int g_virtio_blk_idx = 0;
  ****************************************************************************/
 
 static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
-                                     FAR sem_t *respsem)
+                                     FAR struct virtio_blk_cookie_s *resp)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *sem;
+  FAR spinlock_t *lock = &priv->lock[vq->vq_queue_index];
+  FAR struct virtio_blk_cookie_s *cookie;
 
   if (up_interrupt_context() || OSINIT_IS_PANIC())
     {
       for (; ; )
         {
-          sem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-          if (sem == respsem)
+          cookie = virtqueue_get_buffer_lock(vq, NULL, NULL, lock);
+          if (cookie == resp)
             {
               break;
             }
-          else if (sem != NULL)
+          else if (cookie != NULL)
             {
-              nxsem_post(sem);
+              virtio_blk_complete(cookie);
             }
         }
     }
   else
     {
-      nxsem_wait_uninterruptible(respsem);
+      nxsem_wait_uninterruptible(resp->sem);
     }
 }
 
 /****************************************************************************
- * Name: virtio_blk_rdwr
+ * Name: virtio_blk_queue
  *
  * Description:
- *   Common function for read and write
+ *   Add a read or write request to the virtqueue
  *
  ****************************************************************************/
 
-static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
-                               FAR void *buffer, blkcnt_t startsector,
-                               unsigned int nsectors, bool write)
+static int virtio_blk_queue(FAR struct virtio_blk_priv_s *priv, int index,
+                            FAR struct virtio_blk_cookie_s *cookie,
+                            FAR void *buffer, blkcnt_t startsector,
+                            unsigned int nsectors, bool write)
 {
   FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
+  FAR struct virtqueue *vq = vdev->vrings_info[index].vq;
   FAR struct virtqueue_buf vb[3];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
   irqstate_t flags;
-  sem_t respsem;
-  ssize_t ret;
   int readnum;
-
-  nxsem_init(&respsem, 0, 0);
+  int ret;
 
   /* Build the block request */
 
-  req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
-  req.reserved = 0;
-  req.sector   = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+  cookie->req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+  cookie->req.reserved = 0;
+  cookie->req.sector   = startsector * priv->block_size >>
+                         VIRTIO_BLK_SECTOR_BITS;
+  cookie->resp.status  = VIRTIO_BLK_S_IOERR;
 
   /* Fill the virtqueue buffer:
    * Buffer 0: the block out header;
@@ -256,36 +353,70 @@ static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
    * Buffer 2: the block in header, return the status.
    */
 
-  vb[0].buf = &req;
+  vb[0].buf = &cookie->req;
   vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
   vb[1].buf = buffer;
   vb[1].len = nsectors * priv->block_size;
-  vb[2].buf = &resp;
+  vb[2].buf = &cookie->resp;
   vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
   readnum = write ? 2 : 1;
 
+  flags = spin_lock_irqsave(&priv->lock[index]);
+  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, cookie);
+  if (ret < 0)
+    {
+      spin_unlock_irqrestore(&priv->lock[index], flags);
+      vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+  spin_unlock_irqrestore(&priv->lock[index], flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_rdwr
+ *
+ * Description:
+ *   Common function for read and write
+ *
+ ****************************************************************************/
+
+static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
+                               FAR void *buffer, blkcnt_t startsector,
+                               unsigned int nsectors, bool write)
+{
+  FAR struct virtio_device *vdev = priv->vdev;
+  int index = virtio_blk_vq(priv);
+  FAR struct virtqueue *vq = vdev->vrings_info[index].vq;
+  struct virtio_blk_cookie_s cookie;
+  sem_t respsem;
+  ssize_t ret;
+
+  nxsem_init(&respsem, 0, 0);
+  cookie.sem = &respsem;
+#ifdef CONFIG_BLK_QUEUE
+  cookie.breq = NULL;
+#endif
+
   if (up_interrupt_context())
     {
-      virtqueue_disable_cb_lock(vq, &priv->lock);
+      virtqueue_disable_cb_lock(vq, &priv->lock[index]);
     }
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
+  ret = virtio_blk_queue(priv, index, &cookie, buffer, startsector,
+                         nsectors, write);
   if (ret < 0)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
       goto err;
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
-
   /* Wait for the request completion */
 
-  virtio_blk_wait_complete(vq, &respsem);
+  virtio_blk_wait_complete(vq, &cookie);
 
-  if (resp.status != VIRTIO_BLK_S_OK)
+  if (cookie.resp.status != VIRTIO_BLK_S_OK)
     {
       vrterr("%s Error\n", write ? "Write" : "Read");
       ret = -EIO;
@@ -294,7 +425,7 @@ static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
 err:
   if (up_interrupt_context())
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock);
+      virtqueue_enable_cb_lock(vq, &priv->lock[index]);
     }
 
   return ret >= 0 ? nsectors : ret;
@@ -402,52 +533,117 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 }
 
 /****************************************************************************
- * Name: virtio_blk_ioctl
+ * Name: virtio_blk_cmd
+ *
+ * Description:
+ *   Send a request without a data buffer to transfer and wait for its
+ *   completion, data is the segment of the request if any.
+ *
  ****************************************************************************/
 
-static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
+static int virtio_blk_cmd(FAR struct virtio_blk_priv_s *priv,
+                          uint32_t type, FAR void *data, size_t len)
 {
   FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[2];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
+  int index = virtio_blk_vq(priv);
+  FAR struct virtqueue *vq = vdev->vrings_info[index].vq;
+  FAR struct virtqueue_buf vb[3];
+  struct virtio_blk_cookie_s cookie;
   irqstate_t flags;
   sem_t respsem;
+  int readnum = 0;
   int ret;
 
   nxsem_init(&respsem, 0, 0);
+  cookie.sem = &respsem;
+#ifdef CONFIG_BLK_QUEUE
+  cookie.breq = NULL;
+#endif
 
   /* Build the block request */
 
-  req.type     = VIRTIO_BLK_T_FLUSH;
-  req.reserved = 0;
-  req.sector   = 0;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+  cookie.req.type     = type;
+  cookie.req.reserved = 0;
+  cookie.req.sector   = 0;
+  cookie.resp.status  = VIRTIO_BLK_S_IOERR;
 
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = &resp;
-  vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+  vb[readnum].buf = &cookie.req;
+  vb[readnum++].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+  if (data != NULL)
+    {
+      vb[readnum].buf = data;
+      vb[readnum++].len = len;
+    }
+
+  vb[readnum].buf = &cookie.resp;
+  vb[readnum].len = VIRTIO_BLK_RESP_HEADER_SIZE;
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
+  flags = spin_lock_irqsave(&priv->lock[index]);
+  ret = virtqueue_add_buffer(vq, vb, readnum, 1, &cookie);
   if (ret < 0)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
+      spin_unlock_irqrestore(&priv->lock[index], flags);
       return ret;
     }
 
   virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  spin_unlock_irqrestore(&priv->lock[index], flags);
 
   /* Wait for the request completion */
 
   nxsem_wait_uninterruptible(&respsem);
-  if (resp.status != VIRTIO_BLK_S_OK)
+  if (cookie.resp.status != VIRTIO_BLK_S_OK)
     {
-      vrterr("Flush Error\n");
-      ret = -EIO;
+      vrterr("Request %" PRIu32 " Error\n", type);
+      ret = cookie.resp.status == VIRTIO_BLK_S_UNSUPP ? -ENOTSUP : -EIO;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_discard
+ *
+ * Description:
+ *   Discard or write zeroes to range[1] sectors from the sector range[0],
+ *   split into requests of at most limit device sectors.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_discard(FAR struct virtio_blk_priv_s *priv,
+                              uint32_t type, uint32_t limit,
+                              FAR const blkcnt_t *range)
+{
+  struct virtio_blk_discard_s seg;
+  uint64_t sector;
+  uint64_t nsectors;
+  int ret = OK;
+
+  if (range == NULL || range[1] > priv->nsectors ||
+      range[0] > priv->nsectors - range[1])
+    {
+      return -EINVAL;
+    }
+
+  sector   = (uint64_t)range[0] * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+  nsectors = (uint64_t)range[1] * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+
+  /* The zeroed sectors may be unmapped too, they only have to read back
+   * as zero.
+   */
+
+  seg.flags = type == VIRTIO_BLK_T_WRITE_ZEROES ?
+              VIRTIO_BLK_WRITE_ZEROES_F_UNMAP : 0;
+
+  while (nsectors > 0 && ret >= 0)
+    {
+      seg.sector      = sector;
+      seg.num_sectors = MIN(nsectors, limit);
+
+      ret = virtio_blk_cmd(priv, type, &seg, sizeof(seg));
+
+      sector   += seg.num_sectors;
+      nsectors -= seg.num_sectors;
     }
 
   return ret;
@@ -471,7 +667,25 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
       case BIOC_FLUSH:
         if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_FLUSH))
           {
-            ret = virtio_blk_flush(priv);
+            ret = virtio_blk_cmd(priv, VIRTIO_BLK_T_FLUSH, NULL, 0);
+          }
+        break;
+
+      case BIOC_TRIM:
+        if (priv->max_discard > 0)
+          {
+            ret = virtio_blk_discard(priv, VIRTIO_BLK_T_DISCARD,
+                                     priv->max_discard,
+                                     (FAR const blkcnt_t *)arg);
+          }
+        break;
+
+      case BIOC_WRZEROES:
+        if (priv->max_zeroes > 0)
+          {
+            ret = virtio_blk_discard(priv, VIRTIO_BLK_T_WRITE_ZEROES,
+                                     priv->max_zeroes,
+                                     (FAR const blkcnt_t *)arg);
           }
         break;
     }
@@ -479,6 +693,51 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
   return ret;
 }
 
+/****************************************************************************
+ * Name: virtio_blk_submit
+ *
+ * Description:
+ *   Queue an asynchronous request, the virtqueue holds as many requests in
+ *   flight as it has descriptors for.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BLK_QUEUE
+static int virtio_blk_submit(FAR struct inode *inode,
+                             FAR struct blk_request_s *breq)
+{
+  FAR struct virtio_blk_priv_s *priv;
+  FAR struct virtio_blk_cookie_s *cookie;
+  int ret;
+
+  DEBUGASSERT(inode->i_private);
+  priv = inode->i_private;
+  if (breq->br_write && virtio_has_feature(priv->vdev, VIRTIO_BLK_F_RO))
+    {
+      return -EPERM;
+    }
+
+  cookie = kmm_malloc(sizeof(*cookie));
+  if (cookie == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  cookie->sem  = NULL;
+  cookie->breq = breq;
+
+  ret = virtio_blk_queue(priv, virtio_blk_vq(priv), cookie,
+                         breq->br_buffer, breq->br_sector,
+                         breq->br_nsectors, breq->br_write);
+  if (ret < 0)
+    {
+      kmm_free(cookie);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_blk_done
  ****************************************************************************/
@@ -486,17 +745,18 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *respsem;
+  FAR struct virtio_blk_cookie_s *cookie;
 
   for (; ; )
     {
-      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-      if (respsem == NULL)
+      cookie = virtqueue_get_buffer_lock(vq, NULL, NULL,
+                                         &priv->lock[vq->vq_queue_index]);
+      if (cookie == NULL)
         {
           break;
         }
 
-      nxsem_post(respsem);
+      virtio_blk_complete(cookie);
     }
 }
 
@@ -507,25 +767,43 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqname[1];
-  vq_callback callback[1];
+  FAR const char *vqname[VIRTIO_BLK_MAX_QUEUES];
+  vq_callback callback[VIRTIO_BLK_MAX_QUEUES];
+  uint16_t nvqs = 1;
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
-  spin_lock_init(&priv->lock);
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_RO) |
                                   (1UL << VIRTIO_BLK_F_BLK_SIZE) |
-                                  (1UL << VIRTIO_BLK_F_FLUSH), NULL);
+                                  (1UL << VIRTIO_BLK_F_FLUSH) |
+                                  (1UL << VIRTIO_BLK_F_MQ) |
+                                  (1UL << VIRTIO_BLK_F_DISCARD) |
+                                  (1UL << VIRTIO_BLK_F_WRITE_ZEROES) |
+                                  VIRTIO_RING_F_EVENT_IDX, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqname[0]   = "virtio_blk_vq";
-  callback[0] = virtio_blk_done;
-  ret = virtio_create_virtqueues(vdev, 0, 1, vqname, callback, NULL);
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                num_queues, &nvqs);
+      nvqs = MAX(MIN(nvqs, VIRTIO_BLK_MAX_QUEUES), 1);
+    }
+
+  priv->nvqs = nvqs;
+  for (i = 0; i < nvqs; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+      vqname[i]   = "virtio_blk_vq";
+      callback[i] = virtio_blk_done;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqname, callback, NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -533,7 +811,11 @@ static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
     }
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
-  virtqueue_enable_cb(vdev->vrings_info[0].vq);
+  for (i = 0; i < nvqs; i++)
+    {
+      virtqueue_enable_cb(vdev->vrings_info[i].vq);
+    }
+
   return ret;
 }
 
@@ -593,6 +875,20 @@ static int virtio_blk_probe(FAR struct virtio_device *vdev)
       priv->block_size = VIRTIO_BLK_SECTOR_SIZE;
     }
 
+  /* Only one segment is sent in a discard or write zeroes request */
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_DISCARD))
+    {
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_discard_sectors, &priv->max_discard);
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+    {
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_write_zeroes_sectors, &priv->max_zeroes);
+    }
+
   /* Register block driver */
 
   snprintf(priv->name, NAME_MAX, "/dev/virtblk%d", g_virtio_blk_idx);
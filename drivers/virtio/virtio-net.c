@@ -26,14 +26,18 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/sched.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -45,32 +49,89 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM           0
+#define VIRTIO_NET_F_GUEST_CSUM     1
+#define VIRTIO_NET_F_MAC            5
+#define VIRTIO_NET_F_HOST_TSO4      11
+#define VIRTIO_NET_F_HOST_TSO6      12
+#define VIRTIO_NET_F_MRG_RXBUF      15
+#define VIRTIO_NET_F_CTRL_VQ        17
+#define VIRTIO_NET_F_MQ             22
 
-/* Virtio net header size and packet buffer size */
+/* Virtio net header flags and gso types */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1
+#define VIRTIO_NET_HDR_F_DATA_VALID 2
+#define VIRTIO_NET_HDR_GSO_TCPV4    1
+#define VIRTIO_NET_HDR_GSO_TCPV6    4
+
+/* Virtio net control commands */
+
+#define VIRTIO_NET_OK               0
+#define VIRTIO_NET_ERR              1
+#define VIRTIO_NET_CTRL_MQ          4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+#define VIRTIO_NET_CTRL_RETRY       1000
+
+/* The TCP segmentation offload needs the pseudo header sum from the stack */
+
+#if defined(CONFIG_NET_TCP_GSO) && defined(CONFIG_NET_TCP_CHECKSUMS)
+#  define VIRTIO_NET_TSO
+#endif
+
+/* Virtio net header size and packet buffer size, the header is shorter
+ * without VIRTIO_NET_F_MRG_RXBUF, see virtio_net_init().
+ */
 
 #define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
-#define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* The size of a mergeable RX buffer, the part of a netpkt in its first
+ * IOB, so that a small packet takes one IOB only.
+ */
+
+#define VIRTIO_NET_MRG_BUFSIZE \
+    MIN(CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE + ETH_HDRLEN, \
+        VIRTIO_NET_BUFSIZE)
+
+/* Virtio net virtqueue index and number, the queue pair n is made of the
+ * virtqueues 2n and 2n + 1.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+#define VIRTIO_NET_VQ(pair, dir) ((pair) * VIRTIO_NET_NUM + (dir))
+
+/* One queue pair per CPU with the receive side scaling */
+
+#ifdef CONFIG_NETDEV_RSS
+#  define VIRTIO_NET_MAX_PAIRS CONFIG_SMP_NCPUS
+#else
+#  define VIRTIO_NET_MAX_PAIRS 1
+#endif
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+/* A large TCP packet takes more buffers, so less of them fit in TX ring */
+
+#ifdef VIRTIO_NET_TSO
+#  define VIRTIO_NET_MAX_TX_NIOB \
+    ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_NET_TCP_GSO_MAXSIZE + \
+      CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
+#else
+#  define VIRTIO_NET_MAX_TX_NIOB VIRTIO_NET_MAX_NIOB
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* Virtio net header, just define it here for further, now only use it
- * to calculate the virto net header size, see marco VIRTIO_NET_HDRSIZE
- */
+/* Virtio net header, num_buffers only exists with VIRTIO_NET_F_MRG_RXBUF */
 
 begin_packed_struct struct virtio_net_hdr_s
 {
@@ -80,6 +141,16 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t gso_size;
   uint16_t csum_start;
   uint16_t csum_offset;
+  uint16_t num_buffers;
+} end_packed_struct;
+
+/* Virtio net control command VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET */
+
+begin_packed_struct struct virtio_net_ctrl_mq_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
 } end_packed_struct;
 
 /* The definition of the struct virtio_net_config refers to the link
@@ -113,15 +184,24 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  spinlock_t                lock[VIRTIO_NET_NUM * VIRTIO_NET_MAX_PAIRS];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
   int                       bufnum;    /* TX and RX Buffer number */
+#ifdef VIRTIO_NET_TSO
+  int                       txnum;     /* TX Buffer number with TSO */
+#endif
+  int                       rxnum;     /* RX Buffer number per queue */
+  int                       rxposted[VIRTIO_NET_MAX_PAIRS];
+  uint16_t                  hdrsize;   /* Virtio net header size */
+  uint16_t                  npairs;    /* Number of queue pairs used */
 };
 
-/* Virtio Link Layer Header, follow shows the iob buffer layout:
+/* The virtio net header is put in front of the link layer header, the
+ * netpkt itself is the cookie of the virtqueue buffer. Follow shows the
+ * iob buffer layout:
  *
  * |<-- CONFIG_NET_LL_GUARDSIZE -->|
  * +---------------+---------------+------------+------+     +-------------+
@@ -130,21 +210,14 @@ struct virtio_net_priv_s
  * |               |<--------- datalen -------->|
  * ^base           ^data
  *
- * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDR_SIZE
- *                          = sizeof(uintptr) + 10 + 14
- *                          = 32 (64-Bit)
- *                          = 28 (32-Bit)
+ * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_HDRSIZE + ETH_HDR_SIZE
+ *                          = 12 + 14
+ *                          = 26
  */
 
-begin_packed_struct struct virtio_net_llhdr_s
-{
-  FAR netpkt_t           *pkt;         /* Netpaket pointer */
-  struct virtio_net_hdr_s vhdr;        /* Virtio net header */
-} end_packed_struct;
-
-static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN,
+static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_HDRSIZE + ETH_HDRLEN,
               "CONFIG_NET_LL_GUARDSIZE cannot be less than ETH_HDRLEN"
-              " + VIRTIO_NET_LLHDRSIZE");
+              " + VIRTIO_NET_HDRSIZE");
 
 /****************************************************************************
  * Private Function Prototypes
@@ -155,6 +228,10 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt);
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_RSS
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int queue);
+#endif
 #ifdef CONFIG_NET_MCASTGROUP
 static int virtio_net_addmac(FAR struct netdev_lowerhalf_s *dev,
                              FAR const uint8_t *mac);
@@ -195,7 +272,11 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#ifdef CONFIG_NETDEV_RSS
+  NULL,                  /* rxint */
+  virtio_net_recv_queue, /* receive_queue */
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -206,32 +287,143 @@ static uint8_t g_netdev_num = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_net_gsohdr
+ *
+ * Description:
+ *   Fill the virtio net header of a large TCP packet, so that the device
+ *   cuts it into segments of d_gsosize bytes and completes the checksum
+ *   from the pseudo header sum left by the stack.
+ *
+ ****************************************************************************/
+
+#ifdef VIRTIO_NET_TSO
+static void virtio_net_gsohdr(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt,
+                              FAR struct virtio_net_hdr_s *vhdr)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t iphdrlen;
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 4)
+#  endif
+    {
+      iphdrlen       = (ip[0] & IPv4_HLMASK) << 2;
+      vhdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+    }
+#endif
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  else
+#  endif
+    {
+      iphdrlen       = IPv6_HDRLEN;
+      vhdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV6;
+    }
+#endif
+
+  tcp = (FAR struct tcp_hdr_s *)(ip + iphdrlen);
+
+  vhdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  vhdr->csum_start  = NET_LL_HDRLEN(&dev->netdev) + iphdrlen;
+  vhdr->csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
+  vhdr->hdr_len     = vhdr->csum_start + ((tcp->tcpoffset >> 4) << 2);
+  vhdr->gso_size    = dev->netdev.d_gsosize;
+}
+
+/****************************************************************************
+ * Name: virtio_net_tso
+ *
+ * Description:
+ *   Check whether the device does the segmentation for all of the enabled
+ *   IP versions.
+ *
+ ****************************************************************************/
+
+static bool virtio_net_tso(FAR struct virtio_device *vdev)
+{
+  return virtio_has_feature(vdev, VIRTIO_NET_F_CSUM)
+#ifdef CONFIG_NET_IPv4
+         && virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4)
+#endif
+#ifdef CONFIG_NET_IPv6
+         && virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6)
+#endif
+         ;
+}
+#endif
+
+/****************************************************************************
+ * Name: virtio_net_hdr
+ *
+ * Description:
+ *   Get the virtio net header in front of the link layer header of a
+ *   netpkt.
+ *
+ ****************************************************************************/
+
+static FAR struct virtio_net_hdr_s *
+virtio_net_hdr(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+
+  return (FAR struct virtio_net_hdr_s *)
+         (netpkt_getdata(dev, pkt) - priv->hdrsize);
+}
+
 /****************************************************************************
  * Name: virtio_net_addbuffer
  ****************************************************************************/
 
 static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
-                                FAR struct virtqueue *vq, FAR netpkt_t *pkt,
-                                unsigned int vq_id)
+                                FAR netpkt_t *pkt, unsigned int vq_id)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  FAR struct virtio_net_hdr_s *vhdr;
+  struct virtqueue_buf vb[VIRTIO_NET_MAX_TX_NIOB + 1];
+  struct iovec iov[VIRTIO_NET_MAX_TX_NIOB];
+  uint16_t offset;
+  uint16_t start;
   int iov_cnt;
   int i;
 
   /* Convert netpkt to virtqueue_buf */
 
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_TX_NIOB);
 
-  /* Alloc cookie and net header from transport layer */
+  /* The net header is in the guard space in front of the data */
 
-  hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)iov[0].iov_base - VIRTIO_NET_LLHDRSIZE);
-  DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
-  hdr->pkt = pkt;
+  vhdr = virtio_net_hdr(dev, pkt);
+  DEBUGASSERT((FAR uint8_t *)vhdr >= netpkt_getbase(pkt));
+  memset(vhdr, 0, priv->hdrsize);
+
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_TX)
+    {
+#ifdef VIRTIO_NET_TSO
+      /* d_gsosize is also set for the segments cut in software, only ask
+       * the device to segment if it offered TSO.
+       */
+
+      if ((dev->netdev.d_features & NETDEV_TX_TSO) != 0 &&
+          NETDEV_IS_GSO(&dev->netdev))
+        {
+          virtio_net_gsohdr(dev, pkt, vhdr);
+        }
+      else
+#endif
+      if (netpkt_get_txcsum(dev, pkt, &start, &offset))
+        {
+          /* Let the device complete the checksum */
+
+          vhdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+          vhdr->csum_start  = start;
+          vhdr->csum_offset = offset - start;
+        }
+    }
 
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
@@ -239,10 +431,10 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     {
       /* Append the virtio net header to the first buffer */
 
-      vb[0].buf = &hdr->vhdr;
-      vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
+      vb[0].buf = vhdr;
+      vb[0].len = iov[0].iov_len + priv->hdrsize;
 
-#if VIRTIO_NET_MAX_NIOB > 1
+#if VIRTIO_NET_MAX_TX_NIOB > 1
       for (i = 1; i < iov_cnt; i++)
         {
           vb[i].buf = iov[i].iov_base;
@@ -254,8 +446,8 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     {
       /* Buffer 0 is only for virtio net header */
 
-      vb[0].buf = &hdr->vhdr;
-      vb[0].len = VIRTIO_NET_HDRSIZE;
+      vb[0].buf = vhdr;
+      vb[0].len = priv->hdrsize;
 
       for (i = 0; i < iov_cnt; i++)
         {
@@ -266,15 +458,15 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       iov_cnt++;
     }
 
-  vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  vrtinfo("Fill vq=%u, pkt=%p, count=%d\n", vq_id, pkt, iov_cnt);
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_RX)
     {
-      return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
+      return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, pkt,
                                        &priv->lock[vq_id]);
     }
   else
     {
-      return virtqueue_add_buffer_lock(vq, vb, iov_cnt, 0, hdr,
+      return virtqueue_add_buffer_lock(vq, vb, iov_cnt, 0, pkt,
                                        &priv->lock[vq_id]);
     }
 }
@@ -283,14 +475,23 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev, int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  int vq_id = VIRTIO_NET_VQ(pair, VIRTIO_NET_RX);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  unsigned int bufsize = VIRTIO_NET_BUFSIZE;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  /* Mergeable buffers are filled with one IOB each */
+
+  if (virtio_has_feature(priv->vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      bufsize = VIRTIO_NET_MRG_BUFSIZE;
+    }
+
+  for (i = 0; priv->rxposted[pair] < priv->rxnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -303,8 +504,7 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Preserve data length */
 
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      if (netpkt_setdatalen(dev, pkt, bufsize) < bufsize)
         {
           vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
           netpkt_free(dev, pkt, NETPKT_RX);
@@ -313,12 +513,18 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      if (virtio_net_addbuffer(dev, pkt, vq_id) < 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          break;
+        }
+
+      priv->rxposted[pair]++;
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[vq_id]);
     }
 }
 
@@ -329,22 +535,30 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  FAR struct virtqueue *vq;
+  FAR netpkt_t *pkt;
+  int vq_id;
+  int pair;
 
-  while (1)
+  for (pair = 0; pair < priv->npairs; pair++)
     {
-      /* Get buffer from tx virtqueue */
+      vq_id = VIRTIO_NET_VQ(pair, VIRTIO_NET_TX);
+      vq = priv->vdev->vrings_info[vq_id].vq;
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
-      if (hdr == NULL)
+      while (1)
         {
-          break;
-        }
+          /* Get buffer from tx virtqueue */
 
-      netpkt_free(dev, hdr->pkt, NETPKT_TX);
-      vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
+          pkt = virtqueue_get_buffer_lock(vq, NULL, NULL,
+                                          &priv->lock[vq_id]);
+          if (pkt == NULL)
+            {
+              break;
+            }
+
+          vrtinfo("Free, pkt: %p\n", pkt);
+          netpkt_free(dev, pkt, NETPKT_TX);
+        }
     }
 }
 
@@ -355,6 +569,8 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int vq_id;
+  int pair;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -371,9 +587,13 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (pair = 0; pair < priv->npairs; pair++)
+    {
+      vq_id = VIRTIO_NET_VQ(pair, VIRTIO_NET_RX);
+      virtqueue_enable_cb_lock(priv->vdev->vrings_info[vq_id].vq,
+                               &priv->lock[vq_id]);
+      virtio_net_rxfill(dev, pair);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -396,7 +616,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < VIRTIO_NET_NUM * priv->npairs; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -423,11 +643,13 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  int vq_id = VIRTIO_NET_VQ(this_cpu() % priv->npairs, VIRTIO_NET_TX);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
 
   /* Check the send length */
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE &&
+      !NETDEV_IS_GSO(&dev->netdev))
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
@@ -435,8 +657,8 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtio_net_addbuffer(dev, pkt, vq_id);
+  virtqueue_kick_lock(vq, &priv->lock[vq_id]);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
@@ -444,56 +666,138 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* If we have no buffer left, enable TX done callback. */
 
-  if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
+  if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0 &&
+      virtqueue_enable_cb_lock(vq, &priv->lock[vq_id]) != 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      /* Buffers returned before the callback is enabled aren't notified */
+
+      virtio_net_txfree(dev);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_recv_pair
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static netpkt_t *virtio_net_recv_pair(FAR struct netdev_lowerhalf_s *dev,
+                                      int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  int vq_id = VIRTIO_NET_VQ(pair, VIRTIO_NET_RX);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  FAR struct virtio_net_hdr_s *vhdr;
+  FAR netpkt_t *next;
+  FAR netpkt_t *pkt;
   irqstate_t flags;
+  uint16_t nbuf = 1;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, pair);
 
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
-  if (hdr == NULL)
+  flags = spin_lock_irqsave(&priv->lock[vq_id]);
+  pkt = virtqueue_get_buffer(vq, &len, NULL);
+  if (pkt == NULL && virtqueue_enable_cb(vq) != 0)
+    {
+      /* A buffer used before the RX callback is enabled again isn't
+       * notified with the event index, so get it now.
+       */
+
+      virtqueue_disable_cb(vq);
+      pkt = virtqueue_get_buffer(vq, &len, NULL);
+    }
+
+  if (pkt == NULL)
     {
-      /* If we have no buffer left, enable RX callback. */
+      /* If we have no buffer left, the RX callback is enabled above. */
 
-      virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[vq_id], flags);
 
       vrtinfo("get NULL buffer\n");
       return NULL;
     }
   else
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[vq_id], flags);
     }
 
+  priv->rxposted[pair]--;
+
   /* Set the received pkt length */
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
-  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
-  return hdr->pkt;
+  vhdr = virtio_net_hdr(dev, pkt);
+  netpkt_setdatalen(dev, pkt, len - priv->hdrsize);
+
+  /* A frame larger than the mergeable buffer continues in the next
+   * buffers, from their start since only the first one has the header.
+   */
+
+  if (virtio_has_feature(priv->vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      nbuf = vhdr->num_buffers;
+    }
+
+  while (nbuf-- > 1)
+    {
+      next = virtqueue_get_buffer_lock(vq, &len, NULL, &priv->lock[vq_id]);
+      if (next == NULL)
+        {
+          vrterr("Missing buffers of a merged frame\n");
+          netpkt_free(dev, pkt, NETPKT_RX);
+          return NULL;
+        }
+
+      priv->rxposted[pair]--;
+
+      next->io_offset = CONFIG_NET_LL_GUARDSIZE -
+                        NET_LL_HDRLEN(&dev->netdev) - priv->hdrsize;
+      next->io_len    = len;
+      next->io_pktlen = len;
+      netpkt_concat(dev, pkt, next, NETPKT_RX);
+    }
+
+  /* The packet with the checksum left to complete comes from the host
+   * directly, so it is as good as the one verified by the device.
+   */
+
+  if (virtio_has_feature(priv->vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      netpkt_set_rxcsum(dev, (vhdr->flags &
+                              (VIRTIO_NET_HDR_F_NEEDS_CSUM |
+                               VIRTIO_NET_HDR_F_DATA_VALID)) != 0);
+    }
+
+  vrtinfo("Recv, pair=%d, pkt=%p, len=%u\n", pair, pkt,
+          netpkt_getdatalen(dev, pkt));
+  return pkt;
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recv_pair(dev, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv_queue
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int queue)
+{
+  return virtio_net_recv_pair(dev, queue);
+}
+#endif
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -536,8 +840,13 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+#ifdef CONFIG_NETDEV_RSS
+  netdev_lower_rxqueue_ready((FAR struct netdev_lowerhalf_s *)priv,
+                             vq->vq_queue_index / VIRTIO_NET_NUM);
+#else
   netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+#endif
 }
 
 /****************************************************************************
@@ -548,10 +857,79 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_ctrl_mq
+ *
+ * Description:
+ *   Tell the device the number of queue pairs used, it uses one only until
+ *   then.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+static int virtio_net_ctrl_mq(FAR struct virtio_net_priv_s *priv,
+                              uint16_t maxpairs)
+{
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_NUM * maxpairs].vq;
+  FAR struct virtio_net_ctrl_mq_s *ctrl;
+  struct virtqueue_buf vb[3];
+  FAR uint8_t *ack;
+  int retry;
+  int ret;
+
+  /* Not on the stack, the device may complete it after a timeout */
+
+  ctrl = kmm_malloc(sizeof(*ctrl) + 1);
+  if (ctrl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ack         = (FAR uint8_t *)(ctrl + 1);
+  *ack        = VIRTIO_NET_ERR;
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = priv->npairs;
+
+  vb[0].buf = ctrl;
+  vb[0].len = offsetof(struct virtio_net_ctrl_mq_s, pairs);
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = ack;
+  vb[2].len = sizeof(*ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, ctrl);
+  if (ret < 0)
+    {
+      kmm_free(ctrl);
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+
+  /* The device handles the command at the kick normally */
+
+  for (retry = 0; virtqueue_get_buffer(vq, NULL, NULL) == NULL; retry++)
+    {
+      if (retry >= VIRTIO_NET_CTRL_RETRY)
+        {
+          return -ETIMEDOUT;
+        }
+
+      up_udelay(100);
+    }
+
+  ret = *ack == VIRTIO_NET_OK ? OK : -EIO;
+  kmm_free(ctrl);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -559,12 +937,13 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char **vqnames;
+  FAR vq_callback *callbacks;
+  uint16_t maxpairs = 1;
+  int nvqs = VIRTIO_NET_NUM;
   int ret;
+  int i;
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
   priv->vdev = vdev;
   vdev->priv = priv;
 
@@ -572,15 +951,78 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+                                  (1UL << VIRTIO_NET_F_CSUM) |
+                                  (1UL << VIRTIO_NET_F_GUEST_CSUM) |
+#ifdef VIRTIO_NET_TSO
+                                  (1UL << VIRTIO_NET_F_HOST_TSO4) |
+                                  (1UL << VIRTIO_NET_F_HOST_TSO6) |
+#endif
+                                  (1UL << VIRTIO_NET_F_MRG_RXBUF) |
+#ifdef CONFIG_NETDEV_RSS
+                                  (1UL << VIRTIO_NET_F_CTRL_VQ) |
+                                  (1UL << VIRTIO_NET_F_MQ) |
+#endif
+                                  (1UL << VIRTIO_F_ANY_LAYOUT) |
+                                  VIRTIO_RING_F_EVENT_IDX, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  /* The header has no num_buffers without mergeable RX buffers */
+
+  priv->hdrsize = VIRTIO_NET_HDRSIZE;
+  if (!virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      priv->hdrsize = offsetof(struct virtio_net_hdr_s, num_buffers);
+    }
+
+#ifdef CONFIG_NETDEV_RSS
+  /* All the queue pairs of the device come before the control virtqueue,
+   * even if less of them are used.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &maxpairs);
+      maxpairs = MAX(maxpairs, 1);
+      nvqs = VIRTIO_NET_NUM * maxpairs + 1;
+    }
+#endif
+
+  priv->npairs = MIN(maxpairs, VIRTIO_NET_MAX_PAIRS);
+  for (i = 0; i < VIRTIO_NET_NUM * priv->npairs; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
+
+  vqnames = kmm_malloc(nvqs * (sizeof(*vqnames) + sizeof(*callbacks)));
+  if (vqnames == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  callbacks = (FAR vq_callback *)(vqnames + nvqs);
+  for (i = 0; i < nvqs; i++)
+    {
+      if (i == VIRTIO_NET_NUM * maxpairs)
+        {
+          vqnames[i]   = "virtio_net_ctrl";
+          callbacks[i] = NULL;
+        }
+      else if (i % VIRTIO_NET_NUM == VIRTIO_NET_RX)
+        {
+          vqnames[i]   = "virtio_net_rx";
+          callbacks[i] = virtio_net_rxready;
+        }
+      else
+        {
+          vqnames[i]   = "virtio_net_tx";
+          callbacks[i] = virtio_net_txdone;
+        }
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
+  kmm_free(vqnames);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -589,6 +1031,18 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#ifdef CONFIG_NETDEV_RSS
+  if (priv->npairs > 1)
+    {
+      ret = virtio_net_ctrl_mq(priv, maxpairs);
+      if (ret < 0)
+        {
+          vrtwarn("Use one queue pair, ret=%d\n", ret);
+          priv->npairs = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
@@ -602,6 +1056,34 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+#ifdef VIRTIO_NET_TSO
+  /* Each TX packet may be a large TCP packet if the device segments it */
+
+  priv->txnum = 0;
+  if (virtio_net_tso(vdev))
+    {
+      priv->txnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
+                        (VIRTIO_NET_MAX_TX_NIOB + 1), priv->bufnum);
+    }
+#endif
+
+  /* The RX buffers are shared by the queue pairs, a mergeable buffer
+   * takes one IOB and one descriptor or two.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      priv->rxnum = MIN(priv->bufnum * VIRTIO_NET_MAX_NIOB / priv->npairs,
+                        vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
+                        VIRTIO_NET_NUM);
+    }
+  else
+    {
+      priv->rxnum = priv->bufnum / priv->npairs;
+    }
+
+  priv->rxnum = MAX(priv->rxnum, 1);
   return OK;
 }
 
@@ -657,10 +1139,37 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->rxnum * priv->npairs;
   netdev->quota[NETPKT_TX] = priv->bufnum;
   netdev->ops = &g_virtio_net_ops;
 
+#ifdef CONFIG_NETDEV_RSS
+  /* Each RX queue is polled on the CPU it belongs to */
+
+  if (priv->npairs > 1)
+    {
+      netdev->rxqnum = priv->npairs;
+      netdev->rxtype = NETDEV_RX_THREAD_RSS;
+    }
+#endif
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_TX_CSUM;
+    }
+
+#ifdef VIRTIO_NET_TSO
+  /* Fall back to the segmentation in software if the TX ring is too small
+   * for more than one large packet.
+   */
+
+  if (priv->txnum > 1)
+    {
+      netdev->quota[NETPKT_TX] = priv->txnum;
+      netdev->netdev.d_features |= NETDEV_TX_TSO;
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
@@ -668,6 +668,9 @@ int bt_bridge_register(FAR struct bt_driver_s *hcidrv,
   bridge->driver = hcidrv;
 
   hcidrv->receive = bt_bridge_receive;
+#ifdef CONFIG_MM_IOB
+  hcidrv->receive_iob = NULL;
+#endif
   hcidrv->priv = bridge;
 
   bt_device_init(bridge, btdrv, BT_FILTER_TYPE_BT);
@@ -527,6 +527,9 @@ int rpmshci_server_init(FAR const char *name, FAR struct bt_driver_s *btdev)
   /* Connect BT receive callback and RPMSG as priv */
 
   btdev->receive = rpmsghci_bt_receive;
+#ifdef CONFIG_MM_IOB
+  btdev->receive_iob = NULL;
+#endif
   btdev->priv    = priv;
 
   /* Initialize RPMSG-HCI server data */
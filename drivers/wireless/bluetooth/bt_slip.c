@@ -1037,6 +1037,9 @@ FAR struct bt_driver_s *bt_slip_register(FAR struct bt_driver_s *drv)
   priv->drv = drv;
   drv->priv = priv;
   drv->receive = bt_slip_receive;
+#ifdef CONFIG_MM_IOB
+  drv->receive_iob = NULL;
+#endif
 
   nxmutex_init(&priv->sliplock);
   nxmutex_init(&priv->unacklock);
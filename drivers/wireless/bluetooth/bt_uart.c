@@ -45,6 +45,9 @@
 #include <debug.h>
 
 #include <nuttx/net/bluetooth.h>
+#ifdef CONFIG_BLUETOOTH_UART_IOB
+#  include <nuttx/mm/iob.h>
+#endif
 
 #include <nuttx/wireless/bluetooth/bt_core.h>
 #include <nuttx/wireless/bluetooth/bt_hci.h>
@@ -92,100 +95,181 @@ static ssize_t btuart_read(FAR struct btuart_upperhalf_s *upper,
   return ntotal;
 }
 
-static void btuart_rxwork(FAR void *arg)
+/****************************************************************************
+ * Name: btuart_pktlen
+ *
+ * Description:
+ *   Return the number of bytes needed to complete the H4 packet starting at
+ *   'buf':  the header size while the header is still incomplete, the full
+ *   packet size once 'len' covers the header.
+ *
+ ****************************************************************************/
+
+static int btuart_pktlen(FAR const uint8_t *buf, size_t len,
+                         FAR enum bt_buf_type_e *type)
 {
-  FAR struct btuart_upperhalf_s *upper;
-  enum bt_buf_type_e type;
-  unsigned int pktlen;
-  ssize_t nread;
-  union
+  FAR const union
     {
       struct bt_hci_evt_hdr_s evt;
       struct bt_hci_acl_hdr_s acl;
       struct bt_hci_iso_hdr_s iso;
     }
 
-  *hdr;
+  *hdr = (FAR const void *)&buf[H4_HEADER_SIZE];
+  size_t hdrlen;
 
-  upper = (FAR struct btuart_upperhalf_s *)arg;
+  if (len < H4_HEADER_SIZE)
+    {
+      return H4_HEADER_SIZE;
+    }
 
-  nread = btuart_read(upper, &upper->rxbuf[upper->rxlen],
-                      sizeof(upper->rxbuf) - upper->rxlen);
-  if (nread <= 0)
+  switch (buf[0])
     {
-      wlerr("ERROR: btuart_read failed: %zd\n", nread);
-      return;
+    case H4_EVT:
+      *type  = BT_EVT;
+      hdrlen = H4_HEADER_SIZE + sizeof(struct bt_hci_evt_hdr_s);
+      return len < hdrlen ? hdrlen : hdrlen + hdr->evt.len;
+
+    case H4_ACL:
+      *type  = BT_ACL_IN;
+      hdrlen = H4_HEADER_SIZE + sizeof(struct bt_hci_acl_hdr_s);
+      return len < hdrlen ? hdrlen : hdrlen + hdr->acl.len;
+
+    case H4_ISO:
+      *type  = BT_ISO_IN;
+      hdrlen = H4_HEADER_SIZE + sizeof(struct bt_hci_iso_hdr_s);
+      return len < hdrlen ? hdrlen : hdrlen + hdr->iso.len;
+
+    default:
+      wlerr("ERROR: Unknown H4 type %u\n", buf[0]);
+      return -EINVAL;
     }
+}
 
-  upper->rxlen += (uint16_t)nread;
+#ifdef CONFIG_BLUETOOTH_UART_IOB
+static void btuart_rxwork(FAR void *arg)
+{
+  FAR struct btuart_upperhalf_s *upper;
+  FAR struct iob_s *iob;
+  enum bt_buf_type_e type;
+  ssize_t nread;
+  int pktlen;
 
-  while (upper->rxlen)
-    {
-      hdr = (FAR void *)&upper->rxbuf[H4_HEADER_SIZE];
+  upper = (FAR struct btuart_upperhalf_s *)arg;
+
+  /* Each packet is read straight into the IOB that is handed to the stack,
+   * first the header then exactly the payload, so a batch of packets
+   * pending in the serial buffer is drained with no intermediate copy.
+   */
 
-      switch (upper->rxbuf[0])
+  for (; ; )
+    {
+      if (upper->rxiob == NULL)
         {
-        case H4_EVT:
-          if (upper->rxlen < H4_HEADER_SIZE +
-              sizeof(struct bt_hci_evt_hdr_s))
+          upper->rxiob = iob_tryalloc(false);
+          if (upper->rxiob == NULL)
             {
-              wlwarn("WARNING: Incomplete HCI event header\n");
+              work_queue(HPWORK, &upper->work, btuart_rxwork, upper, 1);
               return;
             }
 
-          type = BT_EVT;
-          pktlen = H4_HEADER_SIZE +
-                   sizeof(struct bt_hci_evt_hdr_s) + hdr->evt.len;
-          break;
+          upper->rxlen = 0;
+        }
 
-        case H4_ACL:
-          if (upper->rxlen < H4_HEADER_SIZE +
-              sizeof(struct bt_hci_acl_hdr_s))
-            {
-              wlwarn("WARNING: Incomplete HCI ACL header\n");
-              return;
-            }
+      iob    = upper->rxiob;
+      pktlen = btuart_pktlen(iob->io_data, upper->rxlen, &type);
+      if (pktlen < 0 || pktlen > CONFIG_IOB_BUFSIZE)
+        {
+          /* Drop what was received and resynchronize on the next byte */
 
-          type = BT_ACL_IN;
-          pktlen = H4_HEADER_SIZE +
-                   sizeof(struct bt_hci_acl_hdr_s) + hdr->acl.len;
-          break;
+          wlerr("ERROR: Bad H4 packet: type %u len %d\n",
+                iob->io_data[0], pktlen);
+          upper->rxlen = 0;
+          continue;
+        }
 
-        case H4_ISO:
-          if (upper->rxlen < H4_HEADER_SIZE +
-              sizeof(struct bt_hci_iso_hdr_s))
+      /* Read the rest of the header, then the rest of the payload */
+
+      if (upper->rxlen < pktlen)
+        {
+          nread = btuart_read(upper, &iob->io_data[upper->rxlen],
+                              pktlen - upper->rxlen);
+          if (nread <= 0)
             {
-              wlwarn("WARNING: Incomplete HCI ISO header\n");
               return;
             }
 
-          type = BT_ISO_IN;
-          pktlen = H4_HEADER_SIZE +
-                   sizeof(struct bt_hci_iso_hdr_s) + hdr->iso.len;
-          break;
-
-        default:
-          wlerr("ERROR: Unknown H4 type %u\n", upper->rxbuf[0]);
-          return;
+          upper->rxlen += (uint16_t)nread;
+          continue;
         }
 
-      if (upper->rxlen < pktlen)
+      BT_DUMP("Received", iob->io_data, pktlen);
+
+      iob->io_offset = H4_HEADER_SIZE;
+      iob->io_len    = pktlen; /* IOB length includes offset */
+      iob->io_pktlen = pktlen;
+
+      upper->rxiob = NULL;
+      upper->rxlen = 0;
+      bt_netdev_receive_iob(&upper->dev, type, iob);
+    }
+}
+#else
+static void btuart_rxwork(FAR void *arg)
+{
+  FAR struct btuart_upperhalf_s *upper;
+  enum bt_buf_type_e type;
+  unsigned int offset = 0;
+  ssize_t nread;
+  int pktlen;
+
+  upper = (FAR struct btuart_upperhalf_s *)arg;
+
+  nread = btuart_read(upper, &upper->rxbuf[upper->rxlen],
+                      sizeof(upper->rxbuf) - upper->rxlen);
+  if (nread <= 0)
+    {
+      wlerr("ERROR: btuart_read failed: %zd\n", nread);
+      return;
+    }
+
+  upper->rxlen += (uint16_t)nread;
+
+  /* Pass every complete packet of the batch to the stack, then move the
+   * trailing partial packet to the front of the buffer once.
+   */
+
+  while (offset < upper->rxlen)
+    {
+      pktlen = btuart_pktlen(&upper->rxbuf[offset], upper->rxlen - offset,
+                             &type);
+      if (pktlen < 0)
         {
-          wlwarn("WARNING: Incomplete packet: rxlen=%u, pktlen=%u\n",
-                 upper->rxlen, pktlen);
-          return;
+          break;
         }
 
-      /* Pass buffer to the stack */
+      if (upper->rxlen - offset < pktlen)
+        {
+          wlinfo("Incomplete packet: rxlen=%u, pktlen=%d\n",
+                 upper->rxlen - offset, pktlen);
+          break;
+        }
 
-      BT_DUMP("Received", upper->rxbuf, pktlen);
-      bt_netdev_receive(&upper->dev, type, &upper->rxbuf[H4_HEADER_SIZE],
+      BT_DUMP("Received", &upper->rxbuf[offset], pktlen);
+      bt_netdev_receive(&upper->dev, type,
+                        &upper->rxbuf[offset + H4_HEADER_SIZE],
                         pktlen - H4_HEADER_SIZE);
 
-      upper->rxlen -= pktlen;
-      memmove(upper->rxbuf, upper->rxbuf + pktlen, upper->rxlen);
+      offset += pktlen;
+    }
+
+  if (offset > 0)
+    {
+      upper->rxlen -= offset;
+      memmove(upper->rxbuf, &upper->rxbuf[offset], upper->rxlen);
     }
 }
+#endif
 
 static void btuart_rxcallback(FAR const struct btuart_lowerhalf_s *lower,
                               FAR void *arg)
@@ -299,6 +383,17 @@ void btuart_close(FAR struct bt_driver_s *dev)
   /* Detach the Rx event handler */
 
   lower->rxattach(lower, NULL, NULL);
+
+#ifdef CONFIG_BLUETOOTH_UART_IOB
+  /* Release the partially received packet */
+
+  work_cancel(HPWORK, &upper->work);
+  if (upper->rxiob != NULL)
+    {
+      iob_free(upper->rxiob);
+      upper->rxiob = NULL;
+    }
+#endif
 }
 
 int btuart_ioctl(FAR struct bt_driver_s *dev,
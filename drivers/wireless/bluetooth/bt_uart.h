@@ -76,7 +76,11 @@ struct btuart_upperhalf_s
   FAR const struct btuart_lowerhalf_s *lower;
 
   uint16_t           rxlen;
+#ifdef CONFIG_BLUETOOTH_UART_IOB
+  FAR struct iob_s  *rxiob;    /* Packet being received */
+#else
   uint8_t            rxbuf[CONFIG_BLUETOOTH_UART_RXBUFSIZE];
+#endif
 
   /* Work queue support */
 
@@ -41,8 +41,10 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/map.h>
 
 #include "cromfs.h"
 #include "fs_heap.h"
@@ -53,7 +55,8 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define CROMFS_MAX_LINKS 64
+#define CROMFS_MAX_LINKS    64
+#define CROMFS_CACHE_BLOCKS CONFIG_FS_CROMFS_CACHE_BLOCKS
 
 /****************************************************************************
  * Private Types
@@ -71,10 +74,24 @@ struct cromfs_dir_s
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
+#if CROMFS_CACHE_BLOCKS == 0
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#endif
+};
+
+#if CROMFS_CACHE_BLOCKS > 0
+/* A block of the decompression cache shared by all the open files */
+
+struct cromfs_cache_s
+{
+  uint32_t cc_offset;                       /* Cached block offset (zero means none) */
+  uint32_t cc_stamp;                        /* Time of the last use */
+  uint16_t cc_ulen;                         /* Length of decompressed data in cache */
+  FAR uint8_t *cc_buffer;                   /* Cached, decompressed data */
 };
+#endif
 
 /* This is the form of the callback from cromfs_foreach_node(): */
 
@@ -133,6 +150,14 @@ static int      cromfs_compare_node(FAR const struct cromfs_volume_s *fs,
                                     FAR const struct cromfs_node_s *node,
                                     uint32_t offset,
                                     FAR void *arg);
+static uint32_t cromfs_blksize(FAR const struct lzf_header_s *hdr,
+                               FAR uint16_t *ulen, FAR uint16_t *clen);
+#if CROMFS_CACHE_BLOCKS > 0
+static int      cromfs_cache_read(FAR const struct cromfs_volume_s *fs,
+                                  FAR const uint8_t *src, uint16_t clen,
+                                  FAR uint8_t *dest, unsigned int copyoffs,
+                                  unsigned int copysize);
+#endif
 static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                                  FAR const char *relpath,
                                  FAR struct cromfs_nodeinfo_s *info,
@@ -145,6 +170,8 @@ static int      cromfs_open(FAR struct file *filep, FAR const char *relpath,
 static int      cromfs_close(FAR struct file *filep);
 static ssize_t  cromfs_read(FAR struct file *filep,
                             FAR char *buffer, size_t buflen);
+static int      cromfs_mmap(FAR struct file *filep,
+                            FAR struct mm_map_entry_s *map);
 static int      cromfs_ioctl(FAR struct file *filep,
                              int cmd, unsigned long arg);
 
@@ -191,7 +218,7 @@ const struct mountpt_operations g_cromfs_operations =
   NULL,              /* write */
   NULL,              /* seek */
   cromfs_ioctl,      /* ioctl */
-  NULL,              /* mmap */
+  cromfs_mmap,       /* mmap */
   NULL,              /* truncate */
   NULL,              /* poll */
   NULL,              /* readv */
@@ -230,6 +257,15 @@ const struct mountpt_operations g_cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+#if CROMFS_CACHE_BLOCKS > 0
+/* The decompression cache, shared by all the mounts of the image */
+
+static struct cromfs_cache_s g_cromfs_cache[CROMFS_CACHE_BLOCKS];
+static mutex_t g_cromfs_cachelock = NXMUTEX_INITIALIZER;
+static uint32_t g_cromfs_stamp;
+static unsigned int g_cromfs_nmounts;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -649,6 +685,112 @@ static int cromfs_compare_node(FAR const struct cromfs_volume_s *fs,
   return 0;  /* Keep looking in this directory */
 }
 
+/****************************************************************************
+ * Name: cromfs_blksize
+ *
+ * Description:
+ *   Decode the header of a data block.  Return the size of the block in the
+ *   image, header included, and its uncompressed and compressed lengths.
+ *
+ ****************************************************************************/
+
+static uint32_t cromfs_blksize(FAR const struct lzf_header_s *hdr,
+                               FAR uint16_t *ulen, FAR uint16_t *clen)
+{
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR const struct lzf_type0_header_s *hdr0 =
+        (FAR const struct lzf_type0_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr0->lzf_len[0] << 8 |
+              (uint16_t)hdr0->lzf_len[1];
+      *clen = *ulen;
+      return (uint32_t)*ulen + LZF_TYPE0_HDR_SIZE;
+    }
+  else
+    {
+      FAR const struct lzf_type1_header_s *hdr1 =
+        (FAR const struct lzf_type1_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+              (uint16_t)hdr1->lzf_ulen[1];
+      *clen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+              (uint16_t)hdr1->lzf_clen[1];
+      return (uint32_t)*clen + LZF_TYPE1_HDR_SIZE;
+    }
+}
+
+#if CROMFS_CACHE_BLOCKS > 0
+/****************************************************************************
+ * Name: cromfs_cache_read
+ *
+ * Description:
+ *   Copy 'copysize' bytes at 'copyoffs' in the decompressed data of the
+ *   block 'src' to 'dest'.  The block is decompressed into the least
+ *   recently used cache block if it is not cached.
+ *
+ ****************************************************************************/
+
+static int cromfs_cache_read(FAR const struct cromfs_volume_s *fs,
+                             FAR const uint8_t *src, uint16_t clen,
+                             FAR uint8_t *dest, unsigned int copyoffs,
+                             unsigned int copysize)
+{
+  FAR struct cromfs_cache_s *victim = &g_cromfs_cache[0];
+  FAR struct cromfs_cache_s *cache;
+  uint32_t voloffs = cromfs_addr2offset(fs, src);
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&g_cromfs_cachelock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < CROMFS_CACHE_BLOCKS; i++)
+    {
+      cache = &g_cromfs_cache[i];
+      if (cache->cc_offset == voloffs)
+        {
+          victim = cache;
+          goto hit;
+        }
+
+      if (cache->cc_offset == 0 ||
+          (victim->cc_offset != 0 &&
+           (int32_t)(cache->cc_stamp - victim->cc_stamp) < 0))
+        {
+          victim = cache;
+        }
+    }
+
+  if (victim->cc_buffer == NULL)
+    {
+      victim->cc_buffer = fs_heap_malloc(fs->cv_bsize);
+      if (victim->cc_buffer == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+    }
+
+  victim->cc_ulen   = lzf_decompress(src, clen, victim->cc_buffer,
+                                     fs->cv_bsize);
+  victim->cc_offset = voloffs;
+
+hit:
+  DEBUGASSERT(victim->cc_ulen >= copyoffs + copysize);
+
+  victim->cc_stamp = ++g_cromfs_stamp;
+  memcpy(dest, &victim->cc_buffer[copyoffs], copysize);
+
+errout_with_lock:
+  nxmutex_unlock(&g_cromfs_cachelock);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_find_node
  *
@@ -796,6 +938,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#if CROMFS_CACHE_BLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   ff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
@@ -804,6 +947,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       fs_heap_free(ff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -830,11 +974,13 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
+#if CROMFS_CACHE_BLOCKS == 0
   fs_heap_free(ff->ff_buffer);
+#endif
   fs_heap_free(ff);
 
   return OK;
@@ -876,7 +1022,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -921,36 +1067,13 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
       do
         {
-          uint32_t blksize;
-
           /* Go to the next block */
 
           currhdr  = nexthdr;
           blkoffs += ulen;
-
-          if (currhdr->lzf_type == LZF_TYPE0_HDR)
-            {
-              FAR struct lzf_type0_header_s *hdr0 =
-                (FAR struct lzf_type0_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
-                        (uint16_t)hdr0->lzf_len[1];
-              blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
-            }
-          else
-            {
-              FAR struct lzf_type1_header_s * hdr1 =
-                (FAR struct lzf_type1_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
-                        (uint16_t)hdr1->lzf_ulen[1];
-              clen    = (uint16_t)hdr1->lzf_clen[0] << 8 |
-                        (uint16_t)hdr1->lzf_clen[1];
-              blksize = (uint32_t)clen + LZF_TYPE1_HDR_SIZE;
-            }
-
           nexthdr  = (FAR struct lzf_header_s *)
-                     ((FAR uint8_t *)currhdr + blksize);
+                     ((FAR uint8_t *)currhdr +
+                      cromfs_blksize(currhdr, &ulen, &clen));
         }
       while (fpos >= (blkoffs + ulen));
 
@@ -981,6 +1104,36 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
           finfo("blkoffs=%" PRIu32 " ulen=%" PRIu16 " copysize=%u\n",
                 blkoffs, ulen, copysize);
         }
+#if CROMFS_CACHE_BLOCKS > 0
+      else
+        {
+          int ret;
+
+          /* Copy the data from the decompression cache */
+
+          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
+          DEBUGASSERT(ulen > copyoffs);
+          copysize = ulen - copyoffs;
+
+          if (copysize > remaining)
+            {
+              /* Clip to the size really needed */
+
+              copysize = remaining;
+            }
+
+          src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+          ret = cromfs_cache_read(fs, src, clen, dest, copyoffs, copysize);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          finfo("blkoffs=%" PRIu32 " ulen=%" PRIu16 " clen=%" PRIu16
+                " copyoffs=%u copysize=%u\n",
+                blkoffs, ulen, clen, copyoffs, copysize);
+        }
+#else
       else
         {
           /* If the source of the data is at the beginning of the compressed
@@ -997,25 +1150,24 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
               /* Get the address and offset in the CROMFS image to obtain
                * the data.  Check if we already have this offset in the
-               * cache.
+               * cache, the data does not go through the cache otherwise.
                */
 
               src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
               voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+              if (voloffs == ff->ff_offset)
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  DEBUGASSERT(ff->ff_ulen >= copysize);
+                  memcpy(dest, ff->ff_buffer, copysize);
+                }
+              else
+                {
+                  lzf_decompress(src, clen, dest, fs->cv_bsize);
                 }
 
               finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32
                     " ulen=%" PRIu16 " ff_offset=%" PRIu32 " copysize=%u\n",
                     voloffs, blkoffs, ulen, ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
             }
           else
             {
@@ -1064,6 +1216,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
               memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
             }
         }
+#endif
 
       /* Adjust pointers counts and offset */
 
@@ -1078,6 +1231,63 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   return buflen;
 }
 
+/****************************************************************************
+ * Name: cromfs_mmap
+ *
+ * Description:
+ *   The image is in memory, so a mapping that lies within one uncompressed
+ *   block of the file is served with a direct pointer into the image.  The
+ *   other mappings fall back to a copy in RAM.
+ *
+ ****************************************************************************/
+
+static int cromfs_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR const struct cromfs_volume_s *fs;
+  FAR const struct lzf_header_s *hdr;
+  FAR struct cromfs_file_s *ff;
+  uint32_t blksize;
+  uint32_t blkoffs = 0;
+  uint16_t ulen;
+  uint16_t clen;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  fs = filep->f_inode->i_private;
+  ff = filep->f_priv;
+
+  if (map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > ff->ff_node->cn_size)
+    {
+      return -ENOTTY;
+    }
+
+  hdr = cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+  for (; ; )
+    {
+      blksize = cromfs_blksize(hdr, &ulen, &clen);
+      if (map->offset < blkoffs + ulen)
+        {
+          break;
+        }
+
+      blkoffs += ulen;
+      hdr      = (FAR const struct lzf_header_s *)
+                 ((FAR const uint8_t *)hdr + blksize);
+    }
+
+  if (hdr->lzf_type != LZF_TYPE0_HDR ||
+      map->offset + map->length > blkoffs + ulen)
+    {
+      return -ENOTTY;
+    }
+
+  map->vaddr = (FAR uint8_t *)hdr + LZF_TYPE0_HDR_SIZE +
+               (map->offset - blkoffs);
+  return OK;
+}
+
 /****************************************************************************
  * Name: cromfs_ioctl
  ****************************************************************************/
@@ -1117,7 +1327,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -1129,6 +1339,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
+#if CROMFS_CACHE_BLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   newff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
@@ -1137,6 +1348,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       fs_heap_free(newff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -1174,7 +1386,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1436,6 +1648,12 @@ static int cromfs_bind(FAR struct inode *blkdriver, FAR const void *data,
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+#if CROMFS_CACHE_BLOCKS > 0
+  nxmutex_lock(&g_cromfs_cachelock);
+  g_cromfs_nmounts++;
+  nxmutex_unlock(&g_cromfs_cachelock);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1453,8 +1671,30 @@ static int cromfs_bind(FAR struct inode *blkdriver, FAR const void *data,
 static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
                          unsigned int flags)
 {
+#if CROMFS_CACHE_BLOCKS > 0
+  int i;
+#endif
+
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#if CROMFS_CACHE_BLOCKS > 0
+  /* The cache is released with the last mount of the image */
+
+  nxmutex_lock(&g_cromfs_cachelock);
+  if (--g_cromfs_nmounts == 0)
+    {
+      for (i = 0; i < CROMFS_CACHE_BLOCKS; i++)
+        {
+          fs_heap_free(g_cromfs_cache[i].cc_buffer);
+          g_cromfs_cache[i].cc_buffer = NULL;
+          g_cromfs_cache[i].cc_offset = 0;
+        }
+    }
+
+  nxmutex_unlock(&g_cromfs_cachelock);
+#endif
+
   return OK;
 }
 
@@ -0,0 +1,352 @@
+/****************************************************************************
+ * fs/driver/fs_blkqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BLK_QUEUE_MAXSECTORS CONFIG_BLK_QUEUE_MAXSECTORS
+
+#define blk_request(n)       container_of(n, struct blk_request_s, br_node)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_blk_lock = NXMUTEX_INITIALIZER;
+
+/* The queued requests of the drivers without a submit method, sorted by
+ * driver and by sector.
+ */
+
+static dq_queue_t g_blk_pending;
+static struct work_s g_blk_work;
+static bool g_blk_busy;
+
+/* The position of the elevator: the end of the last transfer */
+
+static FAR struct inode *g_blk_inode;
+static blkcnt_t g_blk_sector;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blk_before
+ *
+ * Description:
+ *   Return true if the position (inode1, sector1) comes before the position
+ *   (inode2, sector2) in the order of the queue.
+ *
+ ****************************************************************************/
+
+static bool blk_before(FAR struct inode *inode1, blkcnt_t sector1,
+                       FAR struct inode *inode2, blkcnt_t sector2)
+{
+  if (inode1 != inode2)
+    {
+      return (uintptr_t)inode1 < (uintptr_t)inode2;
+    }
+
+  return sector1 < sector2;
+}
+
+/****************************************************************************
+ * Name: blk_insert
+ *
+ * Description:
+ *   Insert a request in the sorted queue.  The new requests are usually at
+ *   the end of the queue, so the search starts from the tail.
+ *
+ ****************************************************************************/
+
+static void blk_insert(FAR struct blk_request_s *req)
+{
+  FAR struct blk_request_s *prev;
+  FAR dq_entry_t *node;
+
+  for (node = dq_tail(&g_blk_pending); node != NULL; node = dq_prev(node))
+    {
+      prev = blk_request(node);
+      if (!blk_before(req->br_inode, req->br_sector,
+                      prev->br_inode, prev->br_sector))
+        {
+          dq_addafter(node, &req->br_node, &g_blk_pending);
+          return;
+        }
+    }
+
+  dq_addfirst(&req->br_node, &g_blk_pending);
+}
+
+/****************************************************************************
+ * Name: blk_next
+ *
+ * Description:
+ *   Pick the next request to execute.  The elevator serves the requests in
+ *   ascending order from its position and goes back to the first request
+ *   when there is none after it.
+ *
+ ****************************************************************************/
+
+static FAR struct blk_request_s *blk_next(void)
+{
+  FAR struct blk_request_s *req;
+  FAR dq_entry_t *node;
+
+  for (node = dq_peek(&g_blk_pending); node != NULL; node = dq_next(node))
+    {
+      req = blk_request(node);
+      if (!blk_before(req->br_inode, req->br_sector,
+                      g_blk_inode, g_blk_sector))
+        {
+          return req;
+        }
+    }
+
+  node = dq_peek(&g_blk_pending);
+  return node != NULL ? blk_request(node) : NULL;
+}
+
+/****************************************************************************
+ * Name: blk_mergeable
+ *
+ * Description:
+ *   Return true if 'next' continues 'last' on the media and in memory, so
+ *   that both can be executed with one transfer.
+ *
+ ****************************************************************************/
+
+static bool blk_mergeable(FAR struct blk_request_s *last,
+                          FAR struct blk_request_s *next,
+                          size_t sectsize, unsigned int nsectors)
+{
+  return next->br_inode == last->br_inode &&
+         next->br_write == last->br_write &&
+         next->br_sector == last->br_sector + last->br_nsectors &&
+         next->br_buffer == last->br_buffer +
+                            last->br_nsectors * sectsize &&
+         nsectors + next->br_nsectors <= BLK_QUEUE_MAXSECTORS;
+}
+
+/****************************************************************************
+ * Name: blk_worker
+ *
+ * Description:
+ *   Execute the queued requests with the synchronous methods of the
+ *   drivers.
+ *
+ ****************************************************************************/
+
+static void blk_worker(FAR void *arg)
+{
+  FAR struct blk_request_s *first;
+  FAR struct blk_request_s *last;
+  FAR struct blk_request_s *req;
+  FAR struct inode *inode;
+  FAR dq_entry_t *node;
+  struct geometry geo;
+  dq_queue_t batch;
+  unsigned int nsectors;
+  size_t sectsize;
+  ssize_t ret;
+
+  nxmutex_lock(&g_blk_lock);
+
+  while ((first = blk_next()) != NULL)
+    {
+      /* Take the request and the requests it can be merged with */
+
+      inode    = first->br_inode;
+      last     = first;
+      nsectors = first->br_nsectors;
+      sectsize = 0;
+
+      node = dq_next(&first->br_node);
+      dq_rem(&first->br_node, &g_blk_pending);
+      dq_init(&batch);
+      dq_addlast(&first->br_node, &batch);
+
+      while (node != NULL)
+        {
+          req = blk_request(node);
+          if (req->br_inode != inode ||
+              req->br_sector != last->br_sector + last->br_nsectors)
+            {
+              break;
+            }
+
+          if (sectsize == 0)
+            {
+              if (inode->u.i_bops->geometry == NULL ||
+                  inode->u.i_bops->geometry(inode, &geo) < 0)
+                {
+                  break;
+                }
+
+              sectsize = geo.geo_sectorsize;
+            }
+
+          if (!blk_mergeable(last, req, sectsize, nsectors))
+            {
+              break;
+            }
+
+          node = dq_next(node);
+          dq_rem(&req->br_node, &g_blk_pending);
+          dq_addlast(&req->br_node, &batch);
+          nsectors += req->br_nsectors;
+          last      = req;
+        }
+
+      g_blk_inode  = inode;
+      g_blk_sector = first->br_sector + nsectors;
+      nxmutex_unlock(&g_blk_lock);
+
+      if (first->br_write)
+        {
+          ret = inode->u.i_bops->write(inode, first->br_buffer,
+                                       first->br_sector, nsectors);
+        }
+      else
+        {
+          ret = inode->u.i_bops->read(inode, first->br_buffer,
+                                      first->br_sector, nsectors);
+        }
+
+      /* Share the result among the merged requests */
+
+      while ((node = dq_remfirst(&batch)) != NULL)
+        {
+          req = blk_request(node);
+          if (ret < 0)
+            {
+              blk_complete(req, ret);
+            }
+          else
+            {
+              nsectors = MIN((size_t)ret, req->br_nsectors);
+              ret     -= nsectors;
+              blk_complete(req, nsectors);
+            }
+        }
+
+      nxmutex_lock(&g_blk_lock);
+    }
+
+  g_blk_busy = false;
+  nxmutex_unlock(&g_blk_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blk_submit
+ *
+ * Description:
+ *   Submit an asynchronous request to a block driver.
+ *
+ ****************************************************************************/
+
+int blk_submit(FAR struct blk_request_s *req)
+{
+  FAR struct inode *inode = req->br_inode;
+  FAR const struct block_operations *bops;
+  int ret;
+
+  if (inode == NULL || req->br_complete == NULL ||
+      !INODE_IS_BLOCK(inode) || inode->u.i_bops == NULL)
+    {
+      return -EINVAL;
+    }
+
+  bops = inode->u.i_bops;
+  if (bops->submit != NULL)
+    {
+      return bops->submit(inode, req);
+    }
+
+  if (req->br_write ? bops->write == NULL : bops->read == NULL)
+    {
+      return req->br_write ? -EACCES : -EINVAL;
+    }
+
+  ret = nxmutex_lock(&g_blk_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  blk_insert(req);
+
+  if (!g_blk_busy)
+    {
+      ret = work_queue(LPWORK, &g_blk_work, blk_worker, NULL, 0);
+      if (ret < 0)
+        {
+          dq_rem(&req->br_node, &g_blk_pending);
+        }
+      else
+        {
+          g_blk_busy = true;
+        }
+    }
+
+  nxmutex_unlock(&g_blk_lock);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: blk_complete
+ *
+ * Description:
+ *   Complete a request.
+ *
+ ****************************************************************************/
+
+void blk_complete(FAR struct blk_request_s *req, ssize_t result)
+{
+  req->br_result = result;
+  req->br_complete(req);
+}
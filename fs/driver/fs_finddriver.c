@@ -58,9 +58,10 @@ FAR void *find_driver(FAR const char *pathname)
 
   SETUP_SEARCH(&desc, pathname, false);
 
-  /* Get the search results */
+  /* Get the search results.  inode_find() takes the tree lock for reading
+   * itself and returns with a reference on the inode.
+   */
 
-  inode_lock();
   if (inode_find(&desc) < 0)
     {
       ferr("ERROR: Failed to find %s\n", pathname);
@@ -71,7 +72,6 @@ FAR void *find_driver(FAR const char *pathname)
       inode_release(desc.node);
     }
 
-  inode_unlock();
   RELEASE_SEARCH(&desc);
 
   return drvr;
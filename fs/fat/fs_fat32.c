@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -583,6 +584,11 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
   FAR struct inode *inode = filep->f_inode;
   FAR struct fat_mountpt_s *fs = inode->i_private;
   FAR struct fat_file_s *ff = filep->f_priv;
+#ifdef CONFIG_FAT_CHAINCACHE
+  uint32_t index;
+  uint32_t cached;
+  int last;
+#endif
   int i;
   int num_clu;
   int new_num_clu;
@@ -620,6 +626,29 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
       num_traversed = 1;
     }
 
+  /* Start from the closest cluster known to the chain cache if it is
+   * further along the chain.
+   */
+
+#ifdef CONFIG_FAT_CHAINCACHE
+  last = MIN(num_clu, new_num_clu) - 1;
+  if (num_traversed > 0 && last >= num_traversed)
+    {
+      index = last;
+      if (fat_chaincache_find(ff, &index, &cached) &&
+          (int)index >= num_traversed)
+        {
+          cluster = cached;
+          num_traversed = index + 1;
+        }
+    }
+#endif
+
+  if (num_traversed > 0)
+    {
+      fat_chaincache_add(ff, num_traversed - 1, cluster);
+    }
+
   /* Traverse the existing chain */
 
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
@@ -632,6 +661,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
         {
           return -EIO;
         }
+
+      fat_chaincache_add(ff, i, cluster);
     }
 
   if (read)
@@ -684,6 +715,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_chaincache_add(ff, i, cluster);
+
       /* zero area (2) */
 
       ret = fat_zero_cluster(fs, cluster, 0, clu_size);
@@ -707,6 +740,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_chaincache_add(ff, i, cluster);
+
       /* zero area (3) */
 
       zero_end = filep->f_pos & (clu_size -1);
@@ -2013,6 +2048,11 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
 
+#ifdef CONFIG_FAT_CHAINCACHE
+  newff->ff_nextextent       = oldff->ff_nextextent;
+  memcpy(newff->ff_extents, oldff->ff_extents, sizeof(newff->ff_extents));
+#endif
+
   /* Attach the private date to the struct file instance */
 
   newp->f_priv = newff;
@@ -2771,6 +2811,13 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap)
+    {
+      fs_heap_free(fs->fs_freemap);
+    }
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
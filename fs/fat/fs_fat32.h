@@ -853,6 +853,15 @@
 #  define fat_io_free(m,s) fs_heap_free(m)
 #endif
 
+/* Cluster chain cache ******************************************************/
+
+#ifdef CONFIG_FAT_CHAINCACHE
+#  define FAT_CHAINCACHE_NEXTENTS CONFIG_FAT_CHAINCACHE_NEXTENTS
+#else
+#  define fat_chaincache_add(ff, index, cluster)
+#  define fat_chaincache_invalidate(fs)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -891,7 +900,24 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t *fs_freemap;            /* One bit per cluster, set if free */
+#endif
+};
+
+#ifdef CONFIG_FAT_CHAINCACHE
+/* This structure describes a run of contiguous clusters of an open file:
+ * the clusters fe_index .. fe_index + fe_count - 1 of the file are the
+ * clusters fe_cluster .. fe_cluster + fe_count - 1 of the volume.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* Cluster number of the first cluster */
+  uint32_t fe_count;               /* Number of clusters, 0 if unused */
 };
+#endif
 
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
@@ -913,6 +939,10 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_CHAINCACHE
+  uint8_t  ff_nextextent;          /* The extent to replace next */
+  struct fat_extent_s ff_extents[FAT_CHAINCACHE_NEXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1055,6 +1085,17 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+/* Cluster chain cache of the open files */
+
+#ifdef CONFIG_FAT_CHAINCACHE
+EXTERN void   fat_chaincache_add(FAR struct fat_file_s *ff, uint32_t index,
+                                 uint32_t cluster);
+EXTERN bool   fat_chaincache_find(FAR struct fat_file_s *ff,
+                                  FAR uint32_t *index,
+                                  FAR uint32_t *cluster);
+EXTERN void   fat_chaincache_invalidate(FAR struct fat_mountpt_s *fs);
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
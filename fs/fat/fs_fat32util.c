@@ -26,12 +26,14 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
@@ -40,6 +42,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/pagecache.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
@@ -270,6 +273,166 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_freemap_set
+ *
+ * Description:
+ *   Record in the free cluster bitmap whether a cluster is free.
+ *
+ ****************************************************************************/
+
+static inline void fat_freemap_set(FAR struct fat_mountpt_s *fs,
+                                   uint32_t cluster, bool isfree)
+{
+  if (isfree)
+    {
+      fs->fs_freemap[cluster >> 5] |= UINT32_C(1) << (cluster & 31);
+    }
+  else
+    {
+      fs->fs_freemap[cluster >> 5] &= ~(UINT32_C(1) << (cluster & 31));
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemap_next
+ *
+ * Description:
+ *   Return the first free cluster in the range [first, last) of the free
+ *   cluster bitmap, or last if there is none.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemap_next(FAR struct fat_mountpt_s *fs,
+                                 uint32_t first, uint32_t last)
+{
+  uint32_t word;
+
+  while (first < last)
+    {
+      word = fs->fs_freemap[first >> 5] >> (first & 31);
+      if (word != 0)
+        {
+          first += ffs(word) - 1;
+          return first < last ? first : last;
+        }
+
+      /* Nothing left in this word, continue with the next one */
+
+      first = (first | 31) + 1;
+    }
+
+  return last;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_findfreecluster
+ *
+ * Description:
+ *   Search a free cluster after 'startcluster', wrapping back to the
+ *   beginning of the FAT but not past 'startcluster'.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_findfreecluster(FAR struct fat_mountpt_s *fs,
+                                   uint32_t startcluster)
+{
+  off_t    startsector;
+  uint32_t newcluster;
+
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap != NULL)
+    {
+      for (; ; )
+        {
+          newcluster = fat_freemap_next(fs, startcluster + 1,
+                                        fs->fs_nclusters + 2);
+          if (newcluster >= fs->fs_nclusters + 2)
+            {
+              newcluster = fat_freemap_next(fs, 2, startcluster + 1);
+              if (newcluster >= startcluster + 1)
+                {
+                  return 0;
+                }
+            }
+
+          /* Double check with the FAT, the bitmap is only a hint */
+
+          startsector = fat_getcluster(fs, newcluster);
+          if (startsector <= 0)
+            {
+              return startsector < 0 ? startsector : newcluster;
+            }
+
+          fat_freemap_set(fs, newcluster, false);
+        }
+    }
+#endif
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters + 2)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -496,6 +659,10 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+  /* The media may have been written while it was not mounted */
+
+  pagecache_invalidate(inode);
+
   /* Make sure that that the media is write-able (if write access is
    * needed).
    */
@@ -626,9 +793,24 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
         }
     }
 
-  /* Enforce computation of free clusters if configured */
+  /* Allocate the free cluster bitmap if configured.  If there is no memory
+   * for it, the search of the free clusters simply falls back to the FAT.
+   */
+
+#ifdef CONFIG_FAT_FREEMAP
+  fs->fs_freemap = fs_heap_zalloc(((fs->fs_nclusters + 2 + 31) >> 5) *
+                                  sizeof(uint32_t));
+  if (fs->fs_freemap == NULL)
+    {
+      fwarn("WARNING: No memory for the free cluster bitmap\n");
+    }
+#endif
+
+  /* Enforce computation of free clusters if configured.  This also fills
+   * the free cluster bitmap.
+   */
 
-#ifdef CONFIG_FAT_COMPUTE_FSINFO
+#if defined(CONFIG_FAT_COMPUTE_FSINFO) || defined(CONFIG_FAT_FREEMAP)
   ret = fat_computefreeclusters(fs);
   if (ret != OK)
     {
@@ -658,6 +840,11 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_FREEMAP
+  fs_heap_free(fs->fs_freemap);
+  fs->fs_freemap = NULL;
+#endif
+
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = NULL;
 
@@ -705,6 +892,11 @@ int fat_checkmount(struct fat_mountpt_s *fs)
 
       /* If we get here, the mount is NOT healthy */
 
+      if (fs->fs_blkdriver)
+        {
+          pagecache_invalidate(fs->fs_blkdriver);
+        }
+
       fs->fs_mounted = false;
     }
 
@@ -728,8 +920,9 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
+          ssize_t nsectorsread = pagecache_read(inode, buffer, sector,
+                                                nsectors,
+                                                fs->fs_hwsectorsize);
           if (nsectorsread == nsectors)
             {
               ret = OK;
@@ -762,7 +955,8 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
           ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+              pagecache_write(inode, buffer, sector, nsectors,
+                              fs->fs_hwsectorsize);
 
           if (nsectorswritten == nsectors)
             {
@@ -1103,6 +1297,14 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+
+#ifdef CONFIG_FAT_FREEMAP
+      if (fs->fs_freemap != NULL && clusterno != 0)
+        {
+          fat_freemap_set(fs, clusterno, nextcluster == 0);
+        }
+#endif
+
       return OK;
     }
 
@@ -1122,6 +1324,10 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
   int32_t nextcluster;
   int    ret;
 
+  /* The cached chains of the open files may refer to these clusters */
+
+  fat_chaincache_invalidate(fs);
+
   /* Loop while there are clusters in the chain */
 
   while (cluster >= 2 && cluster < fs->fs_nclusters + 2)
@@ -1226,68 +1432,20 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
-
-  newcluster = startcluster;
-  for (; ; )
+  ret = fat_findfreecluster(fs, startcluster);
+  if (ret <= 0)
     {
-      /* Examine the next cluster in the FAT */
-
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters + 2)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
+      /* An error occurred or there is no free cluster */
 
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
-
-          return startsector;
-        }
-
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
-
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return ret;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
+  /* We have an available cluster number in 'newcluster'.  Now mark that
+   * cluster as in-use.
    */
 
+  newcluster = ret;
+
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
   if (ret < 0)
     {
@@ -1323,6 +1481,126 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+#ifdef CONFIG_FAT_CHAINCACHE
+/****************************************************************************
+ * Name: fat_chaincache_add
+ *
+ * Description:
+ *   Record that the cluster 'index' of the open file is 'cluster'.  The
+ *   extent ending just before it grows if the clusters are contiguous,
+ *   otherwise a new extent replaces the oldest one.
+ *
+ ****************************************************************************/
+
+void fat_chaincache_add(FAR struct fat_file_s *ff, uint32_t index,
+                        uint32_t cluster)
+{
+  FAR struct fat_extent_s *ext;
+  int i;
+
+  for (i = 0; i < FAT_CHAINCACHE_NEXTENTS; i++)
+    {
+      ext = &ff->ff_extents[i];
+      if (ext->fe_count == 0)
+        {
+          continue;
+        }
+
+      if (index >= ext->fe_index && index < ext->fe_index + ext->fe_count)
+        {
+          /* Already known */
+
+          return;
+        }
+
+      if (index == ext->fe_index + ext->fe_count &&
+          cluster == ext->fe_cluster + ext->fe_count)
+        {
+          ext->fe_count++;
+          return;
+        }
+    }
+
+  ext = &ff->ff_extents[ff->ff_nextextent];
+  ext->fe_index   = index;
+  ext->fe_cluster = cluster;
+  ext->fe_count   = 1;
+
+  if (++ff->ff_nextextent >= FAT_CHAINCACHE_NEXTENTS)
+    {
+      ff->ff_nextextent = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_chaincache_find
+ *
+ * Description:
+ *   Find the cluster of the open file which is known to the cache and is
+ *   the closest to the cluster '*index' without being past it.
+ *
+ * Returned Value:
+ *   true if a cluster was found, its index in the file and its cluster
+ *   number are returned in 'index' and 'cluster'.
+ *
+ ****************************************************************************/
+
+bool fat_chaincache_find(FAR struct fat_file_s *ff, FAR uint32_t *index,
+                         FAR uint32_t *cluster)
+{
+  FAR struct fat_extent_s *ext;
+  FAR struct fat_extent_s *best = NULL;
+  uint32_t bestindex = 0;
+  uint32_t last;
+  int i;
+
+  for (i = 0; i < FAT_CHAINCACHE_NEXTENTS; i++)
+    {
+      ext = &ff->ff_extents[i];
+      if (ext->fe_count == 0 || ext->fe_index > *index)
+        {
+          continue;
+        }
+
+      last = MIN(*index, ext->fe_index + ext->fe_count - 1);
+      if (best == NULL || last > bestindex)
+        {
+          best      = ext;
+          bestindex = last;
+        }
+    }
+
+  if (best == NULL)
+    {
+      return false;
+    }
+
+  *cluster = best->fe_cluster + (bestindex - best->fe_index);
+  *index   = bestindex;
+  return true;
+}
+
+/****************************************************************************
+ * Name: fat_chaincache_invalidate
+ *
+ * Description:
+ *   Forget the cached chains of all the files open on the volume.  This is
+ *   called whenever clusters are removed from a chain.
+ *
+ ****************************************************************************/
+
+void fat_chaincache_invalidate(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_file_s *ff;
+
+  for (ff = fs->fs_head; ff != NULL; ff = ff->ff_next)
+    {
+      memset(ff->ff_extents, 0, sizeof(ff->ff_extents));
+      ff->ff_nextextent = 0;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -2038,6 +2316,8 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
   /* We have to count the number of free clusters */
 
   uint32_t nfreeclusters = 0;
+  bool     isfree;
+
   if (fs->fs_type == FSTYPE_FAT12)
     {
       off_t sector;
@@ -2050,10 +2330,18 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
            * clusters
            */
 
-          if ((uint16_t)fat_getcluster(fs, sector) == 0)
+          isfree = (uint16_t)fat_getcluster(fs, sector) == 0;
+          if (isfree)
             {
               nfreeclusters++;
             }
+
+#ifdef CONFIG_FAT_FREEMAP
+          if (fs->fs_freemap != NULL)
+            {
+              fat_freemap_set(fs, sector, isfree);
+            }
+#endif
         }
     }
   else
@@ -2066,9 +2354,11 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
       fatsector    = fs->fs_fatbase;
       offset       = fs->fs_hwsectorsize;
 
-      /* Examine each cluster in the fat */
+      /* Examine each cluster in the fat.  The first two entries of the FAT
+       * are reserved and do not describe a cluster.
+       */
 
-      for (cluster = fs->fs_nclusters; cluster > 0; cluster--)
+      for (cluster = 0; cluster < fs->fs_nclusters + 2; cluster++)
         {
           /* If we are starting a new sector, then read the new sector in
            * fs_buffer
@@ -2096,22 +2386,31 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
 
           if (fs->fs_type == FSTYPE_FAT16)
             {
-              if (FAT_GETFAT16(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-
+              isfree = FAT_GETFAT16(fs->fs_buffer, offset) == 0;
               offset += 2;
             }
           else
             {
-              if (FAT_GETFAT32(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-
+              isfree = FAT_GETFAT32(fs->fs_buffer, offset) == 0;
               offset += 4;
             }
+
+          if (cluster < 2)
+            {
+              continue;
+            }
+
+          if (isfree)
+            {
+              nfreeclusters++;
+            }
+
+#ifdef CONFIG_FAT_FREEMAP
+          if (fs->fs_freemap != NULL)
+            {
+              fat_freemap_set(fs, cluster, isfree);
+            }
+#endif
         }
     }
 
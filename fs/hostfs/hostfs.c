@@ -240,6 +240,249 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+
+/****************************************************************************
+ * Name: hostfs_buf_seek
+ *
+ * Description: Move the host file position to 'pos' if it is not already
+ *   there.
+ *
+ ****************************************************************************/
+
+static int hostfs_buf_seek(FAR struct hostfs_ofile_s *hf, off_t pos)
+{
+  off_t ret;
+
+  if (hf->hpos == pos)
+    {
+      return OK;
+    }
+
+  ret = host_lseek(hf->fd, hf->hpos, pos, SEEK_SET);
+  if (ret < 0)
+    {
+      hf->hpos = -1;
+      return ret;
+    }
+
+  hf->hpos = ret;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_buf_flush
+ *
+ * Description: Write back any buffered data and drop the buffer contents.
+ *
+ ****************************************************************************/
+
+static int hostfs_buf_flush(FAR struct hostfs_ofile_s *hf)
+{
+  size_t nwritten = 0;
+  ssize_t ret = OK;
+
+  if (hf->dirty)
+    {
+      ret = hostfs_buf_seek(hf, hf->bpos);
+      while (ret >= 0 && nwritten < hf->blen)
+        {
+          ret = host_write(hf->fd, hf->buf + nwritten, hf->blen - nwritten);
+          if (ret > 0)
+            {
+              nwritten += ret;
+              hf->hpos += ret;
+            }
+          else if (ret == 0)
+            {
+              ret = -EIO;
+            }
+        }
+
+      /* In append mode the host decides where the data went */
+
+      if ((hf->oflags & O_APPEND) != 0)
+        {
+          hf->hpos = -1;
+        }
+
+      hf->dirty = false;
+    }
+
+  hf->blen = 0;
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_buf_read
+ *
+ * Description: Read through the per-file buffer.  Small requests are served
+ *   from one buffer sized host read, large ones go directly to the host.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_buf_read(FAR struct file *filep,
+                               FAR struct hostfs_ofile_s *hf,
+                               FAR char *buffer, size_t buflen)
+{
+  off_t pos = filep->f_pos;
+  size_t nread = 0;
+  ssize_t ret = 0;
+
+  if (hf->dirty)
+    {
+      ret = hostfs_buf_flush(hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (hf->buf == NULL)
+    {
+      hf->buf = fs_heap_malloc(CONFIG_FS_HOSTFS_BUFFER_SIZE);
+    }
+
+  while (buflen > 0)
+    {
+      if (pos >= hf->bpos && pos < hf->bpos + (off_t)hf->blen)
+        {
+          size_t n = hf->bpos + (off_t)hf->blen - pos;
+
+          if (n > buflen)
+            {
+              n = buflen;
+            }
+
+          memcpy(buffer, hf->buf + (pos - hf->bpos), n);
+          buffer += n;
+          buflen -= n;
+          nread  += n;
+          pos    += n;
+          continue;
+        }
+
+      ret = hostfs_buf_seek(hf, pos);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      if (hf->buf == NULL || buflen >= CONFIG_FS_HOSTFS_BUFFER_SIZE)
+        {
+          ret = host_read(hf->fd, buffer, buflen);
+          if (ret > 0)
+            {
+              hf->hpos += ret;
+              nread    += ret;
+              pos      += ret;
+            }
+
+          break;
+        }
+
+      ret = host_read(hf->fd, hf->buf, CONFIG_FS_HOSTFS_BUFFER_SIZE);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      hf->hpos += ret;
+      hf->bpos  = pos;
+      hf->blen  = ret;
+    }
+
+  filep->f_pos = pos;
+  return nread > 0 ? (ssize_t)nread : ret;
+}
+
+/****************************************************************************
+ * Name: hostfs_buf_write
+ *
+ * Description: Write through the per-file buffer.  Contiguous small writes
+ *   are collected and handed to the host once the buffer is full.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_buf_write(FAR struct file *filep,
+                                FAR struct hostfs_ofile_s *hf,
+                                FAR const char *buffer, size_t buflen)
+{
+  off_t pos = filep->f_pos;
+  size_t nwritten = 0;
+  ssize_t ret = OK;
+
+  /* Cached read data or a non-contiguous write ends the current run */
+
+  if (!hf->dirty || pos != hf->bpos + (off_t)hf->blen)
+    {
+      ret = hostfs_buf_flush(hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (hf->buf == NULL)
+    {
+      hf->buf = fs_heap_malloc(CONFIG_FS_HOSTFS_BUFFER_SIZE);
+    }
+
+  if (hf->buf == NULL ||
+      (!hf->dirty && buflen >= CONFIG_FS_HOSTFS_BUFFER_SIZE))
+    {
+      ret = hostfs_buf_seek(hf, pos);
+      if (ret >= 0)
+        {
+          ret = host_write(hf->fd, buffer, buflen);
+        }
+
+      if (ret > 0)
+        {
+          hf->hpos      = (hf->oflags & O_APPEND) ? -1 : hf->hpos + ret;
+          filep->f_pos += ret;
+        }
+
+      return ret;
+    }
+
+  while (buflen > 0)
+    {
+      size_t n = CONFIG_FS_HOSTFS_BUFFER_SIZE - hf->blen;
+
+      if (!hf->dirty)
+        {
+          hf->bpos  = pos;
+          hf->dirty = true;
+        }
+
+      if (n > buflen)
+        {
+          n = buflen;
+        }
+
+      memcpy(hf->buf + hf->blen, buffer, n);
+      hf->blen += n;
+      buffer   += n;
+      buflen   -= n;
+      nwritten += n;
+      pos      += n;
+
+      if (hf->blen == CONFIG_FS_HOSTFS_BUFFER_SIZE)
+        {
+          ret = hostfs_buf_flush(hf);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+    }
+
+  filep->f_pos = pos;
+  return nwritten > 0 ? (ssize_t)nwritten : ret;
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -330,6 +573,13 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
   hf->fnext = fs->fs_head;
   hf->crefs = 1;
   hf->oflags = oflags;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  hf->buf   = NULL;
+  hf->bpos  = 0;
+  hf->hpos  = filep->f_pos;
+  hf->blen  = 0;
+  hf->dirty = false;
+#endif
   memcpy(hf->relpath, relpath, len + 1);
   fs->fs_head = hf;
 
@@ -426,6 +676,14 @@ static int hostfs_close(FAR struct file *filep)
 
   /* Close the host file */
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  hostfs_buf_flush(hf);
+  if (hf->buf != NULL)
+    {
+      fs_heap_free(hf->buf);
+    }
+#endif
+
   host_close(hf->fd);
 
   /* Now free the pointer */
@@ -472,11 +730,15 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  ret = hostfs_buf_read(filep, hf, buffer, buflen);
+#else
   ret = host_read(hf->fd, buffer, buflen);
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
+#endif
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -524,11 +786,15 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  ret = hostfs_buf_write(filep, hf, buffer, buflen);
+#else
   ret = host_write(hf->fd, buffer, buflen);
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
+#endif
 
 errout_with_lock:
   nxmutex_unlock(&g_lock);
@@ -566,14 +832,42 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+  /* Buffered data must reach the host before SEEK_END can be resolved,
+   * and the host position may run ahead of f_pos because of read-ahead.
+   */
+
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  if (hf->dirty)
+    {
+      ret = hostfs_buf_flush(hf);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  if (whence == SEEK_CUR)
+    {
+      offset += filep->f_pos;
+      whence  = SEEK_SET;
+    }
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = host_lseek(hf->fd, filep->f_pos, offset, whence);
   if (ret >= 0)
     {
       filep->f_pos = ret;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+      hf->hpos     = ret;
+#endif
     }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+errout_with_lock:
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -611,6 +905,10 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  hostfs_buf_flush(hf);
+#endif
+
   ret = host_ioctl(hf->fd, cmd, arg);
   if (ret < 0)
     {
@@ -671,10 +969,14 @@ static int hostfs_sync(FAR struct file *filep)
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  ret = hostfs_buf_flush(hf);
+#endif
+
   host_sync(hf->fd);
 
   nxmutex_unlock(&g_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -747,6 +1049,13 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   /* Call the host to perform the read */
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  if (hf->dirty)
+    {
+      hostfs_buf_flush(hf);
+    }
+#endif
+
   ret = host_fstat(hf->fd, buf);
 
   nxmutex_unlock(&g_lock);
@@ -834,6 +1143,10 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  hostfs_buf_flush(hf);
+#endif
+
   ret = host_ftruncate(hf->fd, length);
 
   nxmutex_unlock(&g_lock);
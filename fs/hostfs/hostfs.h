@@ -53,6 +53,13 @@ struct hostfs_ofile_s
   int16_t                   crefs;   /* Reference count */
   mode_t                    oflags;  /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  FAR char                 *buf;     /* Read cache / write-behind buffer */
+  off_t                     bpos;    /* File offset of buf[0] */
+  off_t                     hpos;    /* Current host file position */
+  size_t                    blen;    /* Number of valid bytes in buf */
+  bool                      dirty;   /* buf holds data not yet written */
+#endif
   char                      relpath[1];
 };
 
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/param.h>
 #include <string.h>
 #include <assert.h>
 #include <execinfo.h>
@@ -54,6 +55,35 @@
 #include "inode/inode.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With the lock-free lookup, each allocated fl_fds array is preceded by a
+ * pointer to the array it replaced.  The replaced arrays are only freed by
+ * fdlist_free(), since a reader may still be walking them.
+ */
+
+#ifdef CONFIG_FS_FDLIST_LOCKFREE
+#  define FDLIST_RETIRED 1
+#else
+#  define FDLIST_RETIRED 0
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FDLIST_LOCKFREE
+/* The freed file instances are kept here and never returned to the heap,
+ * so that a lock-free reader holding a stale pointer still addresses a
+ * struct file.  The free instances are linked through f_priv.
+ */
+
+static spinlock_t g_file_pool_lock = SP_UNLOCKED;
+static FAR struct file *g_file_pool;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -68,6 +98,44 @@ static void fdlist_get_by_index(FAR struct fdlist *list,
                                 FAR struct fd **fdp)
 {
   FAR struct fd *fdp1;
+#ifdef CONFIG_FS_FDLIST_LOCKFREE
+  FAR struct fd **fds;
+  FAR struct file *file;
+  int refs;
+
+  fds  = __atomic_load_n(&list->fl_fds, __ATOMIC_ACQUIRE);
+  fdp1 = &fds[l1][l2];
+
+  for (; ; )
+    {
+      file = __atomic_load_n(&fdp1->f_file, __ATOMIC_ACQUIRE);
+      if (file == NULL)
+        {
+          break;
+        }
+
+      /* Take a reference unless the file is being released, then check
+       * that the descriptor still refers to it: the instance may have been
+       * closed and reused for another descriptor meanwhile.
+       */
+
+      refs = atomic_read(&file->f_refs);
+      while (refs > 0 &&
+             !atomic_try_cmpxchg_acquire(&file->f_refs, &refs, refs + 1));
+
+      if (refs > 0)
+        {
+          if (__atomic_load_n(&fdp1->f_file, __ATOMIC_ACQUIRE) == file)
+            {
+              break;
+            }
+
+          file_put(file);
+        }
+    }
+
+  *filep = file;
+#else
   irqstate_t flags;
 
   flags = spin_lock_irqsave_notrace(&list->fl_lock);
@@ -79,6 +147,8 @@ static void fdlist_get_by_index(FAR struct fdlist *list,
     }
 
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
+#endif
+
   if (fdp != NULL)
     {
       *fdp = fdp1;
@@ -110,13 +180,15 @@ static int fdlist_extend(FAR struct fdlist *list, size_t row)
       return -EMFILE;
     }
 
-  fds = fs_heap_malloc(sizeof(FAR struct fd *) * row);
+  fds = fs_heap_malloc(sizeof(FAR struct fd *) * (row + FDLIST_RETIRED));
   DEBUGASSERT(fds);
   if (fds == NULL)
     {
       return -ENFILE;
     }
 
+  fds += FDLIST_RETIRED;
+
   i = orig_rows;
   do
     {
@@ -129,7 +201,7 @@ static int fdlist_extend(FAR struct fdlist *list, size_t row)
               fs_heap_free(fds[i]);
             }
 
-          fs_heap_free(fds);
+          fs_heap_free(fds - FDLIST_RETIRED);
           return -ENFILE;
         }
     }
@@ -151,7 +223,7 @@ static int fdlist_extend(FAR struct fdlist *list, size_t row)
           fs_heap_free(fds[j]);
         }
 
-      fs_heap_free(fds);
+      fs_heap_free(fds - FDLIST_RETIRED);
 
       return OK;
     }
@@ -162,8 +234,22 @@ static int fdlist_extend(FAR struct fdlist *list, size_t row)
     }
 
   tmp = list->fl_fds;
-  list->fl_fds = fds;
-  list->fl_rows = row;
+
+#ifdef CONFIG_FS_FDLIST_LOCKFREE
+  /* The lock-free readers may still use the old array, chain it to the
+   * new one and let fdlist_free() release it.
+   */
+
+  *(fds - 1) = tmp;
+  tmp = NULL;
+#endif
+
+  /* Publish the array before the number of rows, a reader which sees the
+   * new number of rows also sees the new array.
+   */
+
+  __atomic_store_n(&list->fl_fds, fds, __ATOMIC_RELEASE);
+  __atomic_store_n(&list->fl_rows, row, __ATOMIC_RELEASE);
 
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
 
@@ -217,10 +303,12 @@ static void fdlist_install(FAR struct fdlist *list, int fd,
 
   flags = spin_lock_irqsave_notrace(&list->fl_lock);
 
+  /* Take the reference before the file is visible to the readers */
+
   fdp1 = &list->fl_fds[l1][l2];
   filep1 = fdp1->f_file;
-  fdp1->f_file = filep;
   file_ref(filep);
+  __atomic_store_n(&fdp1->f_file, filep, __ATOMIC_RELEASE);
   fdp1->f_cloexec = !!(oflags & O_CLOEXEC);
   FS_ADD_BACKTRACE(fdp1);
   if (copy)
@@ -456,6 +544,8 @@ void fdlist_dump(FAR struct fdlist *list)
 
 void fdlist_free(FAR struct fdlist *list)
 {
+  FAR struct fd **fds;
+  FAR void *tmp;
   int i;
   int j;
 
@@ -477,9 +567,16 @@ void fdlist_free(FAR struct fdlist *list)
         }
     }
 
-  if (list->fl_fds != &list->fl_prefd)
+  fds = list->fl_fds;
+  while (fds != NULL && fds != &list->fl_prefd)
     {
-      fs_heap_free(list->fl_fds);
+      tmp = fds - FDLIST_RETIRED;
+#ifdef CONFIG_FS_FDLIST_LOCKFREE
+      fds = (FAR struct fd **)*(fds - 1);
+#else
+      fds = NULL;
+#endif
+      fs_heap_free(tmp);
     }
 }
 
@@ -499,7 +596,8 @@ void fdlist_free(FAR struct fdlist *list)
 
 int fdlist_count(FAR struct fdlist *list)
 {
-  return list->fl_rows * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+  return __atomic_load_n(&list->fl_rows, __ATOMIC_ACQUIRE) *
+         CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
 }
 
 /****************************************************************************
@@ -606,7 +704,7 @@ int fdlist_dupfile(FAR struct fdlist *list, int oflags, int minfd,
           if (fdp->f_file == NULL)
             {
               atomic_fetch_add(&filep->f_refs, 1);
-              fdp->f_file        = filep;
+              __atomic_store_n(&fdp->f_file, filep, __ATOMIC_RELEASE);
               fdp->f_cloexec     = !!(oflags & O_CLOEXEC);
  #ifdef CONFIG_FDSAN
               fdp->f_tag_fdsan   = 0;
@@ -692,11 +790,20 @@ int fdlist_copy(FAR struct fdlist *plist, FAR struct fdlist *clist,
                 bool cloexec)
 {
   bool fcloexec;
+  int rows;
   int ret;
   int fd;
   int i;
   int j;
 
+  /* The number of rows the child will most likely need */
+
+#ifdef CONFIG_FDCLONE_STDIO
+  rows = 1;
+#else
+  rows = plist->fl_rows;
+#endif
+
   for (i = 0; i < plist->fl_rows; i++)
     {
       for (j = 0; j < CONFIG_NFILE_DESCRIPTORS_PER_BLOCK; j++)
@@ -751,7 +858,11 @@ int fdlist_copy(FAR struct fdlist *plist, FAR struct fdlist *clist,
               continue;
             }
 
-          ret = fdlist_extend(clist, i + 1);
+          /* Grow the child's list to the size of the parent's at once
+           * instead of one row at a time, each growth copies the list.
+           */
+
+          ret = fdlist_extend(clist, MAX(i + 1, rows));
           if (ret < 0)
             {
               file_put(filep);
@@ -778,6 +889,26 @@ int fdlist_copy(FAR struct fdlist *plist, FAR struct fdlist *clist,
 
 FAR struct file *file_allocate(void)
 {
+#ifdef CONFIG_FS_FDLIST_LOCKFREE
+  FAR struct file *filep;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_file_pool_lock);
+  filep = g_file_pool;
+  if (filep != NULL)
+    {
+      g_file_pool = filep->f_priv;
+    }
+
+  spin_unlock_irqrestore(&g_file_pool_lock, flags);
+
+  if (filep != NULL)
+    {
+      memset(filep, 0, sizeof(struct file));
+      return filep;
+    }
+#endif
+
   return fs_heap_zalloc(sizeof(struct file));
 }
 
@@ -791,7 +922,16 @@ FAR struct file *file_allocate(void)
 
 void file_deallocate(FAR struct file *filep)
 {
+#ifdef CONFIG_FS_FDLIST_LOCKFREE
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_file_pool_lock);
+  filep->f_priv = g_file_pool;
+  g_file_pool   = filep;
+  spin_unlock_irqrestore(&g_file_pool_lock, flags);
+#else
   fs_heap_free(filep);
+#endif
 }
 
 /****************************************************************************
@@ -870,7 +1010,7 @@ int file_put(FAR struct file *filep)
           ferr("ERROR: fs putfilep file_close() failed: %d\n", ret);
         }
 
-      fs_heap_free(filep);
+      file_deallocate(filep);
     }
 
   return ret;
@@ -41,6 +41,10 @@
  * Private Data
  ****************************************************************************/
 
+/* The lookups of the inode tree hold the lock for reading and proceed in
+ * parallel, only the modifications of the tree hold it for writing.
+ */
+
 static rw_semaphore_t g_inode_lock = RWSEM_INITIALIZER;
 
 /****************************************************************************
@@ -80,7 +84,8 @@ void inode_lock(void)
  * Name: inode_rlock
  *
  * Description:
- *   Get readable exclusive access to the in-memory inode tree.
+ *   Get shared read access to the in-memory inode tree.  The lookups which
+ *   don't modify the tree use this lock and run in parallel.
  *
  ****************************************************************************/
 
@@ -106,7 +111,7 @@ void inode_unlock(void)
  * Name: inode_runlock
  *
  * Description:
- *   Relinquish read exclusive access to the in-memory inode tree.
+ *   Relinquish shared read access to the in-memory inode tree.
  *
  ****************************************************************************/
 
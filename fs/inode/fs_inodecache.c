@@ -0,0 +1,227 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INODE_CACHE_SIZE    CONFIG_FS_INODE_CACHE_SIZE
+#define INODE_CACHE_NAMELEN CONFIG_FS_INODE_CACHE_NAMELEN
+
+#if (INODE_CACHE_SIZE & (INODE_CACHE_SIZE - 1)) != 0
+#  error CONFIG_FS_INODE_CACHE_SIZE must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The result of the search of one path component among the children of
+ * a directory inode.  A negative entry has a NULL ic_node and records
+ * where the component would be inserted.
+ */
+
+struct inode_cache_s
+{
+  FAR struct inode *ic_parent;                /* The directory searched */
+  FAR struct inode *ic_node;                  /* The inode found or NULL */
+  FAR struct inode *ic_peer;                  /* The peer to "left" */
+  uint32_t          ic_gen;                   /* Tree generation */
+  char              ic_name[INODE_CACHE_NAMELEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_inode_cache_lock = SP_UNLOCKED;
+
+/* The cache is direct mapped, a colliding entry simply replaces the old
+ * one.  The entries of an older generation than g_inode_cache_gen are
+ * stale, the zeroed entries of the generation zero are never used.
+ */
+
+static struct inode_cache_s g_inode_cache[INODE_CACHE_SIZE];
+static uint32_t g_inode_cache_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Hash the path component and its directory, and return the length of
+ *   the component.
+ *
+ ****************************************************************************/
+
+static size_t inode_cache_hash(FAR struct inode *parent,
+                               FAR const char *name, FAR uint32_t *hash)
+{
+  uint32_t h = (uint32_t)(uintptr_t)parent;
+  size_t len;
+
+  for (len = 0; name[len] != '\0' && name[len] != '/'; len++)
+    {
+      h = (h ^ (uint8_t)name[len]) * 16777619u;
+    }
+
+  *hash = (h ^ (h >> 16)) & (INODE_CACHE_SIZE - 1);
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the search result of the first component of 'name' among the
+ *   children of 'parent'.
+ *
+ * Returned Value:
+ *   true if the result is cached, the inode found (NULL if none) and the
+ *   inode to its "left" are returned in 'node' and 'peer'.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for reading
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode **node, FAR struct inode **peer)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+  bool found = false;
+
+  len = inode_cache_hash(parent, name, &hash);
+  if (parent == NULL || len >= INODE_CACHE_NAMELEN)
+    {
+      return false;
+    }
+
+  entry = &g_inode_cache[hash];
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  if (entry->ic_gen == g_inode_cache_gen && entry->ic_parent == parent &&
+      strncmp(entry->ic_name, name, len) == 0 &&
+      entry->ic_name[len] == '\0')
+    {
+      *node = entry->ic_node;
+      *peer = entry->ic_peer;
+      found = true;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+  return found;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the search result of the first component of 'name' among the
+ *   children of 'parent'.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for reading
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR struct inode *parent, FAR const char *name,
+                     FAR struct inode *node, FAR struct inode *peer)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  len = inode_cache_hash(parent, name, &hash);
+  if (parent == NULL || len >= INODE_CACHE_NAMELEN)
+    {
+      return;
+    }
+
+  entry = &g_inode_cache[hash];
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  entry->ic_parent = parent;
+  entry->ic_node   = node;
+  entry->ic_peer   = peer;
+  entry->ic_gen    = g_inode_cache_gen;
+  memcpy(entry->ic_name, name, len);
+  entry->ic_name[len] = '\0';
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_flush
+ *
+ * Description:
+ *   Drop all the cached search results after the inode tree changed.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for writing
+ *
+ ****************************************************************************/
+
+void inode_cache_flush(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  /* Clear the table when the generation wraps, so that no entry of the
+   * previous round can become valid again.
+   */
+
+  if (++g_inode_cache_gen == 0)
+    {
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+      g_inode_cache_gen = 1;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
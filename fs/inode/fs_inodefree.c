@@ -31,6 +31,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/pagecache.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
@@ -76,6 +77,15 @@ void inode_free(FAR struct inode *inode)
         }
 #endif
 
+      /* Don't let a new block driver at the same address hit the sectors
+       * cached for this one.
+       */
+
+      if (INODE_IS_BLOCK(inode))
+        {
+          pagecache_invalidate(inode);
+        }
+
       fs_heap_free(inode);
     }
 }
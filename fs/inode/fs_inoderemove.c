@@ -108,6 +108,10 @@ static FAR struct inode *inode_unlink(FAR const char *path)
       inode->i_peer   = NULL;
       inode->i_parent = NULL;
       atomic_fetch_sub(&inode->i_crefs, 1);
+
+      /* The cached searches may have found the node or have it as peer */
+
+      inode_cache_flush();
     }
 
 errout:
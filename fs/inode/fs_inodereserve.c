@@ -129,6 +129,10 @@ static void inode_insert(FAR struct inode *inode,
       inode->i_parent = parent;
       parent->i_child = inode;
     }
+
+  /* The cached searches may have missed the node or have a stale peer */
+
+  inode_cache_flush();
 }
 
 /****************************************************************************
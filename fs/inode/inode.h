@@ -89,6 +89,12 @@
 #  define FS_ADD_BACKTRACE(fd)
 #endif
 
+#ifndef CONFIG_FS_INODE_CACHE
+#  define inode_cache_lookup(parent, name, node, peer) false
+#  define inode_cache_add(parent, name, node, peer)
+#  define inode_cache_flush()
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -237,6 +243,26 @@ void inode_runlock(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Name: inode_cache_lookup, inode_cache_add and inode_cache_flush
+ *
+ * Description:
+ *   The cache of the inode_search() results for one path component among
+ *   the children of a directory inode, including the components not found.
+ *   It must be flushed whenever the inode tree changes.
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode **node, FAR struct inode **peer);
+void inode_cache_add(FAR struct inode *parent, FAR const char *name,
+                     FAR struct inode *node, FAR struct inode *peer);
+void inode_cache_flush(void);
+
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
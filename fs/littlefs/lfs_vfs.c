@@ -53,6 +53,9 @@
 #  error littlefs requires CONFIG_C99_BOOL to be selected
 #endif
 
+#define LITTLEFS_CACHE_LINES   CONFIG_FS_LITTLEFS_READ_CACHE_LINES
+#define LITTLEFS_CACHE_INVALID ((lfs_block_t)-1)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -69,6 +72,20 @@ struct littlefs_file_s
   int                   refs;
 };
 
+#if LITTLEFS_CACHE_LINES > 0
+/* A line of the shared read cache, the data of a line is cfg.cache_size
+ * bytes of the block at the offset 'off'.
+ */
+
+struct littlefs_cache_s
+{
+  lfs_block_t           block;   /* LITTLEFS_CACHE_INVALID if unused */
+  lfs_off_t             off;
+  uint32_t              stamp;   /* Time of the last use */
+  FAR uint8_t          *data;
+};
+#endif
+
 /* This structure represents the overall mountpoint state. An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a littlefs filesystem.
@@ -82,6 +99,10 @@ struct littlefs_mountpt_s
   struct lfs_config     cfg;
   struct lfs            lfs;
   bool                  readonly;
+#if LITTLEFS_CACHE_LINES > 0
+  FAR struct littlefs_cache_s *cache;
+  uint32_t              stamp;
+#endif
 };
 
 /* NuttX specific file attributes.
@@ -1198,12 +1219,12 @@ static void littlefs_check(FAR struct inode *drv, lfs_block_t block,
 #endif
 
 /****************************************************************************
- * Name: littlefs_read_block
+ * Name: littlefs_read_device
  ****************************************************************************/
 
-static int littlefs_read_block(FAR const struct lfs_config *c,
-                               lfs_block_t block, lfs_off_t off,
-                               FAR void *buffer, lfs_size_t size)
+static int littlefs_read_device(FAR const struct lfs_config *c,
+                                lfs_block_t block, lfs_off_t off,
+                                FAR void *buffer, lfs_size_t size)
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -1228,13 +1249,131 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
   return ret >= 0 ? OK : ret;
 }
 
+#if LITTLEFS_CACHE_LINES > 0
 /****************************************************************************
- * Name: littlefs_write_block
+ * Name: littlefs_cache_alloc
  ****************************************************************************/
 
-static int littlefs_write_block(FAR const struct lfs_config *c,
-                                lfs_block_t block, lfs_off_t off,
-                                FAR const void *buffer, lfs_size_t size)
+static int littlefs_cache_alloc(FAR struct littlefs_mountpt_s *fs)
+{
+  FAR uint8_t *data;
+  int i;
+
+  fs->cache = fs_heap_malloc(LITTLEFS_CACHE_LINES *
+                             (sizeof(struct littlefs_cache_s) +
+                              fs->cfg.cache_size));
+  if (fs->cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  data = (FAR uint8_t *)&fs->cache[LITTLEFS_CACHE_LINES];
+  for (i = 0; i < LITTLEFS_CACHE_LINES; i++)
+    {
+      fs->cache[i].block = LITTLEFS_CACHE_INVALID;
+      fs->cache[i].stamp = 0;
+      fs->cache[i].data  = data + i * fs->cfg.cache_size;
+    }
+
+  fs->stamp = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_line
+ *
+ * Description:
+ *   Return the line holding the data of the block at 'off', aligned to the
+ *   line size.  On a miss, the least recently used line is filled from the
+ *   device.
+ *
+ ****************************************************************************/
+
+static FAR struct littlefs_cache_s *
+littlefs_cache_line(FAR const struct lfs_config *c, lfs_block_t block,
+                    lfs_off_t off, FAR int *result)
+{
+  FAR struct littlefs_mountpt_s *fs = c->context;
+  FAR struct littlefs_cache_s *victim = &fs->cache[0];
+  FAR struct littlefs_cache_s *line;
+  int i;
+
+  for (i = 0; i < LITTLEFS_CACHE_LINES; i++)
+    {
+      line = &fs->cache[i];
+      if (line->block == block && line->off == off)
+        {
+          line->stamp = ++fs->stamp;
+          return line;
+        }
+
+      if (line->block == LITTLEFS_CACHE_INVALID ||
+          (victim->block != LITTLEFS_CACHE_INVALID &&
+           (int32_t)(line->stamp - victim->stamp) < 0))
+        {
+          victim = line;
+        }
+    }
+
+  victim->block = LITTLEFS_CACHE_INVALID;
+  *result = littlefs_read_device(c, block, off, victim->data,
+                                 c->cache_size);
+  if (*result < 0)
+    {
+      return NULL;
+    }
+
+  victim->block = block;
+  victim->off   = off;
+  victim->stamp = ++fs->stamp;
+  return victim;
+}
+#endif
+
+/****************************************************************************
+ * Name: littlefs_read_block
+ ****************************************************************************/
+
+static int littlefs_read_block(FAR const struct lfs_config *c,
+                               lfs_block_t block, lfs_off_t off,
+                               FAR void *buffer, lfs_size_t size)
+{
+#if LITTLEFS_CACHE_LINES > 0
+  FAR struct littlefs_cache_s *line;
+  FAR uint8_t *dest = buffer;
+  lfs_off_t lineoff;
+  lfs_size_t n;
+  int ret = OK;
+
+  while (size > 0)
+    {
+      lineoff = off - off % c->cache_size;
+      line = littlefs_cache_line(c, block, lineoff, &ret);
+      if (line == NULL)
+        {
+          return ret;
+        }
+
+      n = lfs_min(c->cache_size - (off - lineoff), size);
+      memcpy(dest, line->data + (off - lineoff), n);
+      dest += n;
+      off  += n;
+      size -= n;
+    }
+
+  return OK;
+#else
+  return littlefs_read_device(c, block, off, buffer, size);
+#endif
+}
+
+/****************************************************************************
+ * Name: littlefs_write_device
+ ****************************************************************************/
+
+static int littlefs_write_device(FAR const struct lfs_config *c,
+                                 lfs_block_t block, lfs_off_t off,
+                                 FAR const void *buffer, lfs_size_t size)
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -1264,6 +1403,57 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
   return ret >= 0 ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_write_block
+ ****************************************************************************/
+
+static int littlefs_write_block(FAR const struct lfs_config *c,
+                                lfs_block_t block, lfs_off_t off,
+                                FAR const void *buffer, lfs_size_t size)
+{
+  int ret = littlefs_write_device(c, block, off, buffer, size);
+
+#if LITTLEFS_CACHE_LINES > 0
+  FAR struct littlefs_mountpt_s *fs = c->context;
+  FAR struct littlefs_cache_s *line;
+  lfs_off_t start;
+  lfs_off_t end;
+  int i;
+
+  /* Keep the cached copies of the range in step with the device, or drop
+   * them if the device may hold something else now.
+   */
+
+  for (i = 0; i < LITTLEFS_CACHE_LINES; i++)
+    {
+      line = &fs->cache[i];
+      if (line->block != block)
+        {
+          continue;
+        }
+
+      start = lfs_max(line->off, off);
+      end   = lfs_min(line->off + c->cache_size, off + size);
+      if (start >= end)
+        {
+          continue;
+        }
+
+      if (ret < 0)
+        {
+          line->block = LITTLEFS_CACHE_INVALID;
+        }
+      else
+        {
+          memcpy(line->data + (start - line->off),
+                 (FAR const uint8_t *)buffer + (start - off), end - start);
+        }
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: littlefs_erase_block
  ****************************************************************************/
@@ -1274,12 +1464,25 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct inode *drv = fs->drv;
   int ret = OK;
+#if LITTLEFS_CACHE_LINES > 0
+  int i;
+#endif
 
   if (fs->readonly)
     {
       return -EROFS;
     }
 
+#if LITTLEFS_CACHE_LINES > 0
+  for (i = 0; i < LITTLEFS_CACHE_LINES; i++)
+    {
+      if (fs->cache[i].block == block)
+        {
+          fs->cache[i].block = LITTLEFS_CACHE_INVALID;
+        }
+    }
+#endif
+
   if (INODE_IS_MTD(drv))
     {
       FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -1445,6 +1648,14 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.disk_version   = CONFIG_FS_LITTLEFS_DISK_VERSION;
 #endif
 
+#if LITTLEFS_CACHE_LINES > 0
+  ret = littlefs_cache_alloc(fs);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+#endif
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
@@ -1494,6 +1705,9 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+#if LITTLEFS_CACHE_LINES > 0
+  fs_heap_free(fs->cache);
+#endif
   nxmutex_destroy(&fs->lock);
   fs_heap_free(fs);
 errout_with_block:
@@ -1553,6 +1767,9 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+#if LITTLEFS_CACHE_LINES > 0
+      fs_heap_free(fs->cache);
+#endif
       nxmutex_destroy(&fs->lock);
       fs_heap_free(fs);
     }
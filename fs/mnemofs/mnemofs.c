@@ -162,6 +162,11 @@ static int     mnemofs_rename(FAR struct inode *mountpt,
 static int     mnemofs_stat(FAR struct inode *mountpt,
                             FAR const char *relpath, FAR struct stat *buf);
 
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+static void    mnemofs_flush_worker(FAR void *arg);
+static void    mnemofs_flush_schedule(FAR struct mfs_sb_s *sb);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -786,6 +791,10 @@ static ssize_t mnemofs_write(FAR struct file *filep, FAR const char *buffer,
   MFS_EXTRA_LOG("WRITE", "Updated file offset and size.");
   MFS_EXTRA_LOG_F(f);
 
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+  mnemofs_flush_schedule(sb);
+#endif
+
 errout_with_lock:
   nxmutex_unlock(&MFS_LOCK(sb));
   MFS_EXTRA_LOG("WRITE", "Mutex  released.");
@@ -1992,6 +2001,10 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
   *driver = sb->drv;
   MFS_LOG("UNBIND", "Driver %p.", driver);
 
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+  work_cancel_sync(LPWORK, &sb->flush_work);
+#endif
+
   mfs_jrnl_free(sb);
   mfs_ba_free(sb);
 
@@ -2620,6 +2633,72 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+/****************************************************************************
+ * Name: mnemofs_flush_worker
+ *
+ * Description:
+ *   Flushes the LRU, and the journal if needed, from the low priority work
+ *   queue.
+ *
+ * Input Parameters:
+ *   arg - Superblock instance of the device.
+ *
+ ****************************************************************************/
+
+static void mnemofs_flush_worker(FAR void *arg)
+{
+  FAR struct mfs_sb_s *sb = arg;
+  int                  ret;
+
+  ret = nxmutex_lock(&MFS_LOCK(sb));
+  if (predict_false(ret < 0))
+    {
+      return;
+    }
+
+  MFS_EXTRA_LOG("BGFLUSH", "Mutex acquired.");
+
+  ret = mnemofs_flush(sb);
+  if (predict_false(ret < 0))
+    {
+      MFS_LOG("BGFLUSH", "Background flush failed: %d.", ret);
+    }
+
+  nxmutex_unlock(&MFS_LOCK(sb));
+  MFS_EXTRA_LOG("BGFLUSH", "Mutex released.");
+}
+
+/****************************************************************************
+ * Name: mnemofs_flush_schedule
+ *
+ * Description:
+ *   Schedules a background flush after a write. The flush runs at once if
+ *   the LRU has reached a threshold, otherwise it runs after a delay unless
+ *   one is already pending.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Assumptions/Limitations:
+ *   The file system lock is held.
+ *
+ ****************************************************************************/
+
+static void mnemofs_flush_schedule(FAR struct mfs_sb_s *sb)
+{
+  if (mfs_lru_ishigh(sb))
+    {
+      work_queue(LPWORK, &sb->flush_work, mnemofs_flush_worker, sb, 0);
+    }
+  else if (work_available(&sb->flush_work))
+    {
+      work_queue(LPWORK, &sb->flush_work, mnemofs_flush_worker, sb,
+                 MSEC2TICK(CONFIG_MNEMOFS_BGFLUSH_DELAY));
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
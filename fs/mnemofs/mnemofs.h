@@ -61,6 +61,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/list.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -207,6 +208,9 @@ struct mfs_sb_s
   struct list_node        lru;
   struct list_node        of;            /* open files. */
   bool                    flush;
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+  struct work_s           flush_work;    /* Background flush */
+#endif
 };
 
 /* This is for *dir VFS methods. */
@@ -1517,6 +1521,26 @@ int mfs_lru_updatectz(FAR struct mfs_sb_s * sb,
 bool mfs_lru_isempty(FAR struct mfs_sb_s * const sb);
 int mfs_lru_flush(FAR struct mfs_sb_s * const sb);
 
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+/****************************************************************************
+ * Name: mfs_lru_ishigh
+ *
+ * Description:
+ *   Check whether the LRU has reached one of the background flush
+ *   thresholds.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Returned Value:
+ *   true  - The LRU should be flushed now.
+ *   false - The LRU can wait.
+ *
+ ****************************************************************************/
+
+bool mfs_lru_ishigh(FAR struct mfs_sb_s * const sb);
+#endif
+
 /* mnemofs_master.c */
 
 /****************************************************************************
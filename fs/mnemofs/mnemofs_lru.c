@@ -1066,3 +1066,25 @@ bool mfs_lru_isempty(FAR struct mfs_sb_s * const sb)
 {
   return list_length(&MFS_LRU(sb)) == 0;
 }
+
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+bool mfs_lru_ishigh(FAR struct mfs_sb_s * const sb)
+{
+  FAR struct mfs_node_s *node = NULL;
+
+  if (list_length(&MFS_LRU(sb)) >= CONFIG_MNEMOFS_BGFLUSH_NLRU)
+    {
+      return true;
+    }
+
+  list_for_every_entry(&MFS_LRU(sb), node, struct mfs_node_s, list)
+    {
+      if (node->n_list >= CONFIG_MNEMOFS_BGFLUSH_NLRUDELTA)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
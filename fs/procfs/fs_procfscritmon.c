@@ -360,6 +360,84 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: critmon_read_subsys
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0
+static ssize_t critmon_read_subsys(FAR struct critmon_file_s *attr,
+                                   FAR char *buffer, size_t buflen,
+                                   FAR off_t *offset, int subsys)
+{
+  static FAR const char *const names[CRITMON_SUBSYS_NUM] =
+  {
+    "wdog",
+    "mqueue"
+  };
+
+  struct timespec maxtime;
+  struct timespec alltime;
+  clock_t max = 0;
+  clock_t total = 0;
+  size_t linesize;
+  int cpu;
+
+  /* Merge the statistics of all CPUs and reset the maximum */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_subsys_max[cpu][subsys] > max)
+        {
+          max = g_subsys_max[cpu][subsys];
+        }
+
+      total += g_subsys_total[cpu][subsys];
+      g_subsys_max[cpu][subsys] = 0;
+    }
+
+  perf_convert(max, &maxtime);
+  perf_convert(total, &alltime);
+
+  /* Generate output for the subsystem name, maximum and total time */
+
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                             "%s,%lu.%09lu,%lu.%09lu\n", names[subsys],
+                             (unsigned long)maxtime.tv_sec,
+                             (unsigned long)maxtime.tv_nsec,
+                             (unsigned long)alltime.tv_sec,
+                             (unsigned long)alltime.tv_nsec);
+  return procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+}
+#endif
+
+/****************************************************************************
+ * Name: critmon_read_cputime
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+static ssize_t critmon_read_cputime(FAR struct critmon_file_s *attr,
+                                    FAR char *buffer, size_t buflen,
+                                    FAR off_t *offset, int cpu)
+{
+  struct timespec irqtime;
+  struct timespec worktime;
+  size_t linesize;
+
+  perf_convert(g_cputime_irq[cpu], &irqtime);
+  perf_convert(g_cputime_work[cpu], &worktime);
+
+  /* Generate output for the interrupt and work queue time of the CPU */
+
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                             "cpu%d,%lu.%09lu,%lu.%09lu\n", cpu,
+                             (unsigned long)irqtime.tv_sec,
+                             (unsigned long)irqtime.tv_nsec,
+                             (unsigned long)worktime.tv_sec,
+                             (unsigned long)worktime.tv_nsec);
+  return procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -371,6 +449,9 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
   off_t offset;
   ssize_t ret;
   int cpu;
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0
+  int subsys;
+#endif
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -396,6 +477,26 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+  /* Get the interrupt and work queue time of each CPU */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && ret < buflen; cpu++)
+    {
+      ret += critmon_read_cputime(attr, buffer + ret, buflen - ret,
+                                  &offset, cpu);
+    }
+#endif
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0
+  /* Get the lock holding time of each monitored subsystem */
+
+  for (subsys = 0; subsys < CRITMON_SUBSYS_NUM && ret < buflen; subsys++)
+    {
+      ret += critmon_read_subsys(attr, buffer + ret, buflen - ret,
+                                 &offset, subsys);
+    }
+#endif
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -0,0 +1,344 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsheapprof.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/mm/mm.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_MM_HEAP_PROFILE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest field generated by this logic.
+ */
+
+#define HEAPPROF_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct heapprof_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  char line[HEAPPROF_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     heapprof_close(FAR struct file *filep);
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     heapprof_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     heapprof_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_heapprof_operations =
+{
+  heapprof_open,      /* open */
+  heapprof_close,     /* close */
+  heapprof_read,      /* read */
+  NULL,               /* write */
+  NULL,               /* poll */
+
+  heapprof_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  heapprof_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_open
+ ****************************************************************************/
+
+static int heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct heapprof_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct heapprof_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_close
+ ****************************************************************************/
+
+static int heapprof_close(FAR struct file *filep)
+{
+  FAR struct heapprof_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct heapprof_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_read_site
+ *
+ * Description:
+ *   Generate the line of one call site: the live and the total sampled
+ *   objects and bytes followed by the call stack.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_read_site(FAR struct heapprof_file_s *attr,
+                                  FAR char *buffer, size_t buflen,
+                                  FAR off_t *offset,
+                                  FAR const struct mm_profile_site_s *site)
+{
+  size_t linesize;
+  size_t totalsize;
+  int i;
+
+  linesize  = procfs_snprintf(attr->line, HEAPPROF_LINELEN,
+                              "%zu: %zu [%zu: %zu] @",
+                              site->inuse_objs, site->inuse_bytes,
+                              site->alloc_objs, site->alloc_bytes);
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+
+  for (i = 0; i < site->depth && totalsize < buflen; i++)
+    {
+      linesize   = procfs_snprintf(attr->line, HEAPPROF_LINELEN, " %p",
+                                   site->stack[i]);
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, offset);
+    }
+
+  if (totalsize < buflen)
+    {
+      totalsize += procfs_memcpy("\n", 1, buffer + totalsize,
+                                 buflen - totalsize, offset);
+    }
+
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heapprof_read
+ *
+ * Description:
+ *   Generate the profile in the legacy pprof heap format, the sampling
+ *   interval in the header lets pprof scale the sampled counters.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct heapprof_file_s *attr;
+  struct mm_profile_site_s site;
+  size_t inuse_objs = 0;
+  size_t inuse_bytes = 0;
+  size_t alloc_objs = 0;
+  size_t alloc_bytes = 0;
+  size_t linesize;
+  off_t offset;
+  ssize_t ret;
+  int index;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct heapprof_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  /* The header carries the totals of all the sites */
+
+  for (index = 0; mm_profile_site(index, &site) >= 0; index++)
+    {
+      inuse_objs  += site.inuse_objs;
+      inuse_bytes += site.inuse_bytes;
+      alloc_objs  += site.alloc_objs;
+      alloc_bytes += site.alloc_bytes;
+    }
+
+  linesize = procfs_snprintf(attr->line, HEAPPROF_LINELEN,
+                             "heap profile: %zu: %zu [%zu: %zu] "
+                             "@ heap_v2/%d\n",
+                             inuse_objs, inuse_bytes, alloc_objs,
+                             alloc_bytes, CONFIG_MM_HEAP_PROFILE_INTERVAL);
+  ret      = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  /* Then one line per call site */
+
+  for (index = 0; ret < buflen && mm_profile_site(index, &site) >= 0;
+       index++)
+    {
+      ret += heapprof_read_site(attr, buffer + ret, buflen - ret, &offset,
+                                &site);
+    }
+
+  /* There are no shared libraries, the section is empty */
+
+  if (ret < buflen)
+    {
+      linesize = procfs_snprintf(attr->line, HEAPPROF_LINELEN,
+                                 "\nMAPPED_LIBRARIES:\n");
+      ret     += procfs_memcpy(attr->line, linesize, buffer + ret,
+                               buflen - ret, &offset);
+    }
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: heapprof_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heapprof_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heapprof_file_s *oldattr;
+  FAR struct heapprof_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct heapprof_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct heapprof_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct heapprof_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heapprof_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "heapprof" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_MM_HEAP_PROFILE */
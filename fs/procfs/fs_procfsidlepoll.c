@@ -0,0 +1,282 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsidlepoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/sched.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_IDLE_POLL)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to hold the CPU mask.
+ */
+
+#define IDLEPOLL_LINELEN 16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct idlepoll_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[IDLEPOLL_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     idlepoll_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     idlepoll_close(FAR struct file *filep);
+static ssize_t idlepoll_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t idlepoll_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     idlepoll_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     idlepoll_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_idlepoll_operations =
+{
+  idlepoll_open,      /* open */
+  idlepoll_close,     /* close */
+  idlepoll_read,      /* read */
+  idlepoll_write,     /* write */
+  NULL,               /* poll */
+
+  idlepoll_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  idlepoll_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: idlepoll_open
+ ****************************************************************************/
+
+static int idlepoll_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct idlepoll_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct idlepoll_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: idlepoll_close
+ ****************************************************************************/
+
+static int idlepoll_close(FAR struct file *filep)
+{
+  FAR struct idlepoll_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct idlepoll_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: idlepoll_read
+ ****************************************************************************/
+
+static ssize_t idlepoll_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct idlepoll_file_s *attr;
+  size_t linesize;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct idlepoll_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset   = filep->f_pos;
+  linesize = procfs_snprintf(attr->line, IDLEPOLL_LINELEN, "%08" PRIx32 "\n",
+                             (uint32_t)g_idle_poll_cpus);
+  ret      = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: idlepoll_write
+ ****************************************************************************/
+
+static ssize_t idlepoll_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen)
+{
+  char line[IDLEPOLL_LINELEN];
+  FAR char *endptr;
+  unsigned long cpuset;
+  size_t len;
+
+  len = buflen < sizeof(line) - 1 ? buflen : sizeof(line) - 1;
+  memcpy(line, buffer, len);
+  line[len] = '\0';
+
+  /* The new value is the hexadecimal mask of the polling CPUs */
+
+  cpuset = strtoul(line, &endptr, 16);
+  if (endptr == line)
+    {
+      return -EINVAL;
+    }
+
+  g_idle_poll_cpus = (cpu_set_t)(cpuset & ((1ul << CONFIG_SMP_NCPUS) - 1));
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: idlepoll_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int idlepoll_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct idlepoll_file_s *oldattr;
+  FAR struct idlepoll_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct idlepoll_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct idlepoll_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct idlepoll_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: idlepoll_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int idlepoll_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "sched/idlepoll" is the name for a read/write file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWOTH |
+                 S_IWGRP | S_IWUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_PROCFS && CONFIG_SCHED_IDLE_POLL */
@@ -201,8 +201,9 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
   /* The first line is the headers */
 
   linesize  = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
-                              "%10s%10s%10s%10s\n",
-                              "ntotal", "nfree", "nwait", "nthrottle");
+                              "%10s%10s%10s%10s%10s\n",
+                              "ntotal", "nfree", "nwait", "nthrottle",
+                              "npeak");
 
   copysize  = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
                             &offset);
@@ -215,9 +216,10 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
 
   iob_getstats(&stats);
   linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
-                               "%10d%10d%10d%10d\n",
+                               "%10d%10d%10d%10d%10d\n",
                                stats.ntotal, stats.nfree,
-                               stats.nwait, stats.nthrottle);
+                               stats.nwait, stats.nthrottle,
+                               stats.npeak);
 
   copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
                              &offset);
@@ -297,9 +297,10 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
   /* The first line is the headers */
 
   linesize  = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
-                              "%11s%11s%11s%11s%11s%7s%7s%s\n",
+                              "%11s%11s%11s%11s%11s%7s%7s%6s%s\n",
                               "total", "used", "free", "maxused",
-                              "maxfree", "nused", "nfree", " name");
+                              "maxfree", "nused", "nfree", "frag",
+                              " name");
 
   copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
                             &offset);
@@ -314,6 +315,7 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
       if (buflen > 0)
         {
           struct mallinfo info;
+          unsigned long frag = 0;
 
           buffer    += copysize;
           buflen    -= copysize;
@@ -329,9 +331,19 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
               info = mm_mallinfo(entry->heap);
             }
 
+          /* The external fragmentation is the percentage of the free
+           * memory that is not part of the largest free chunk.
+           */
+
+          if (info.fordblks > 0)
+            {
+              frag = 100 - (unsigned long)((uint64_t)info.mxordblk * 100 /
+                                           info.fordblks);
+            }
+
           linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
                                        "%11lu%11lu%11lu%11lu%11lu"
-                                       "%7lu%7lu %s\n",
+                                       "%7lu%7lu%5lu%% %s\n",
                                        (unsigned long)info.arena,
                                        (unsigned long)info.uordblks,
                                        (unsigned long)info.fordblks,
@@ -339,7 +351,7 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
                                        (unsigned long)info.mxordblk,
                                        (unsigned long)info.aordblks,
                                        (unsigned long)info.ordblks,
-                                       entry->name);
+                                       frag, entry->name);
           copysize   = procfs_memcpy(procfile->line, linesize, buffer,
                                      buflen, &offset);
           totalsize += copysize;
@@ -368,7 +380,7 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
       max        = (unsigned long)pg_info.mxfree << MM_PGSHIFT;
 
       linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
-                                   "%11lu%11lu%11lu%11s%11lu %18s\n", total,
+                                   "%11lu%11lu%11lu%11s%11lu %24s\n", total,
                                    allocated, available, "", max, "Page");
 
       copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
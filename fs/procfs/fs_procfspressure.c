@@ -34,6 +34,7 @@
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
 #include <nuttx/spinlock.h>
@@ -44,10 +45,22 @@
  * Private Types
  ****************************************************************************/
 
+/* The resources that report their pressure */
+
+enum pressure_type_e
+{
+  PRESSURE_MEMORY = 0,              /* Heap memory, in bytes */
+#ifdef CONFIG_MM_IOB
+  PRESSURE_IOB,                     /* I/O buffers, in buffers */
+#endif
+  PRESSURE_NTYPES
+};
+
 struct pressure_file_s
 {
   struct procfs_file_s base;        /* Base open file structure */
   dq_entry_t entry;                 /* Supports a linked list */
+  int type;                         /* The resource of the file */
   FAR struct pollfd *fds;           /* Polling structure of waiting thread */
   size_t threshold;                 /* Memory notification threshold */
   clock_t lasttick;                 /* Last time notified */
@@ -58,10 +71,18 @@ struct pressure_file_s
  * Private Data
  ****************************************************************************/
 
-static dq_queue_t g_pressure_memory_queue;
+static FAR const char * const g_pressure_names[PRESSURE_NTYPES] =
+{
+  "memory",
+#ifdef CONFIG_MM_IOB
+  "iob",
+#endif
+};
+
+static dq_queue_t g_pressure_queue[PRESSURE_NTYPES];
 static spinlock_t g_pressure_lock;
-static size_t g_remaining;
-static size_t g_largest;
+static size_t g_remaining[PRESSURE_NTYPES];
+static size_t g_largest[PRESSURE_NTYPES];
 
 /****************************************************************************
  * Private Function Prototypes
@@ -109,6 +130,94 @@ const struct procfs_operations g_pressure_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: pressure_find
+ *
+ * Description:
+ *   Return the resource type of a relative path or -ENOENT.
+ *
+ ****************************************************************************/
+
+static int pressure_find(FAR const char *relpath)
+{
+  int i;
+
+  if (strncmp(relpath, "pressure/", 9) == 0)
+    {
+      for (i = 0; i < PRESSURE_NTYPES; i++)
+        {
+          if (strcmp(relpath + 9, g_pressure_names[i]) == 0)
+            {
+              return i;
+            }
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: pressure_notify
+ *
+ * Description:
+ *   Update the state of one resource and notify the files whose threshold
+ *   is reached.
+ *
+ ****************************************************************************/
+
+static void pressure_notify(int type, size_t remaining, size_t largest)
+{
+  clock_t current = clock_systime_ticks();
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *tmp;
+  uint32_t flags;
+
+  flags             = spin_lock_irqsave(&g_pressure_lock);
+  g_remaining[type] = remaining;
+  g_largest[type]   = largest;
+
+  dq_for_every_safe(&g_pressure_queue[type], entry, tmp)
+    {
+      FAR struct pressure_file_s *pressure =
+          container_of(entry, struct pressure_file_s, entry);
+
+      /* If the largest available block is less than the threshold,
+       * send a notification
+       */
+
+      if (largest > pressure->threshold)
+        {
+          continue;
+        }
+
+      /* If lasttick is CLOCK_MAX, it means that the event is triggered
+       * for the first time and we should always send notifications.
+       */
+
+      if (pressure->lasttick != CLOCK_MAX && current - pressure->lasttick <
+          pressure->interval)
+        {
+          continue;
+        }
+
+      /* If fds is NULL, it means no one is listening for the event and
+       * we should delay sending the notification.
+       */
+
+      if (pressure->fds == NULL)
+        {
+          continue;
+        }
+
+      pressure->lasttick = current;
+      spin_unlock_irqrestore(&g_pressure_lock, flags);
+      poll_notify(&pressure->fds, 1, POLLPRI);
+      flags = spin_lock_irqsave(&g_pressure_lock);
+    }
+
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
+
 /****************************************************************************
  * Name: pressure_open
  ****************************************************************************/
@@ -118,11 +227,13 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct pressure_file_s *priv;
   uint32_t flags;
+  int type;
 
-  if (strcmp(relpath, "pressure/memory") != 0)
+  type = pressure_find(relpath);
+  if (type < 0)
     {
       ferr("ERROR: relpath is invalid: %s\n", relpath);
-      return -ENOENT;
+      return type;
     }
 
   priv = fs_heap_zalloc(sizeof(struct pressure_file_s));
@@ -133,8 +244,9 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   priv->interval = CLOCK_MAX;
-  filep->f_priv = priv;
-  dq_addfirst(&priv->entry, &g_pressure_memory_queue);
+  priv->type     = type;
+  filep->f_priv  = priv;
+  dq_addfirst(&priv->entry, &g_pressure_queue[type]);
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   return OK;
 }
@@ -149,7 +261,7 @@ static int pressure_close(FAR struct file *filep)
   uint32_t flags;
 
   flags = spin_lock_irqsave(&g_pressure_lock);
-  dq_rem(&priv->entry, &g_pressure_memory_queue);
+  dq_rem(&priv->entry, &g_pressure_queue[priv->type]);
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   fs_heap_free(priv);
   return OK;
@@ -162,6 +274,7 @@ static int pressure_close(FAR struct file *filep)
 static ssize_t pressure_read(FAR struct file *filep, FAR char *buffer,
                              size_t buflen)
 {
+  FAR struct pressure_file_s *priv = filep->f_priv;
   char buf[128];
   uint32_t flags;
   size_t remain;
@@ -170,12 +283,20 @@ static ssize_t pressure_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   flags   = spin_lock_irqsave(&g_pressure_lock);
-  remain  = g_remaining;
-  largest = g_largest;
+  remain  = g_remaining[priv->type];
+  largest = g_largest[priv->type];
   spin_unlock_irqrestore(&g_pressure_lock, flags);
 
-  ret = procfs_snprintf(buf, sizeof(buf), "remaining %zu, largest:%zu\n",
-                        remain, largest);
+  if (priv->type == PRESSURE_MEMORY)
+    {
+      ret = procfs_snprintf(buf, sizeof(buf),
+                            "remaining %zu, largest:%zu\n",
+                            remain, largest);
+    }
+  else
+    {
+      ret = procfs_snprintf(buf, sizeof(buf), "remaining %zu\n", remain);
+    }
 
   if (ret > buflen)
     {
@@ -261,7 +382,8 @@ static int pressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
            * the first time and we should always send a notification.
            */
 
-          if (g_remaining <= priv->threshold && (priv->lasttick ==
+          if (g_remaining[priv->type] <= priv->threshold &&
+              (priv->lasttick ==
               CLOCK_MAX || current - priv->lasttick >= priv->interval))
             {
               priv->lasttick = current;
@@ -304,7 +426,7 @@ static int pressure_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   memcpy(newpriv, oldpriv, sizeof(struct pressure_file_s));
-  dq_addfirst(&newpriv->entry, &g_pressure_memory_queue);
+  dq_addfirst(&newpriv->entry, &g_pressure_queue[newpriv->type]);
   newpriv->fds = NULL;
   newp->f_priv = newpriv;
   spin_unlock_irqrestore(&g_pressure_lock, flags);
@@ -330,7 +452,7 @@ static int pressure_opendir(FAR const char *relpath,
     }
 
   level->level    = 1;
-  level->nentries = 1;
+  level->nentries = PRESSURE_NTYPES;
 
   *dir = (FAR struct fs_dirent_s *)level;
   return OK;
@@ -365,7 +487,8 @@ static int pressure_readdir(FAR struct fs_dirent_s *dir,
     }
 
   entry->d_type = DTYPE_FILE;
-  strncpy(entry->d_name, "memory", sizeof(entry->d_name));
+  strncpy(entry->d_name, g_pressure_names[level->index],
+          sizeof(entry->d_name));
   level->index++;
   return OK;
 }
@@ -396,7 +519,7 @@ static int pressure_stat(const char *relpath, struct stat *buf)
     {
       buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
     }
-  else if (strcmp(relpath, "pressure/memory") == 0)
+  else if (pressure_find(relpath) >= 0)
     {
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWOTH |
                      S_IWGRP | S_IWUSR;
@@ -420,54 +543,16 @@ static int pressure_stat(const char *relpath, struct stat *buf)
 
 void mm_notify_pressure(size_t remaining, size_t largest)
 {
-  clock_t current = clock_systime_ticks();
-  FAR dq_entry_t *entry;
-  FAR dq_entry_t *tmp;
-  uint32_t flags;
-
-  flags       = spin_lock_irqsave(&g_pressure_lock);
-  g_remaining = remaining;
-  g_largest   = largest;
-
-  dq_for_every_safe(&g_pressure_memory_queue, entry, tmp)
-    {
-      FAR struct pressure_file_s *pressure =
-          container_of(entry, struct pressure_file_s, entry);
-
-      /* If the largest available block is less than the threshold,
-       * send a notification
-       */
-
-      if (largest > pressure->threshold)
-        {
-          continue;
-        }
-
-      /* If lasttick is CLOCK_MAX, it means that the event is triggered
-       * for the first time and we should always send notifications.
-       */
-
-      if (pressure->lasttick != CLOCK_MAX && current - pressure->lasttick <
-          pressure->interval)
-        {
-          continue;
-        }
-
-      /* If fds is NULL, it means no one is listening for the event and
-       * we should delay sending the notification.
-       */
-
-      if (pressure->fds == NULL)
-        {
-          continue;
-        }
+  pressure_notify(PRESSURE_MEMORY, remaining, largest);
+}
 
-      pressure->lasttick = current;
-      spin_unlock_irqrestore(&g_pressure_lock, flags);
-      poll_notify(&pressure->fds, 1, POLLPRI);
-      flags = spin_lock_irqsave(&g_pressure_lock);
-    }
+#ifdef CONFIG_MM_IOB
+/****************************************************************************
+ * iob_notify_pressure
+ ****************************************************************************/
 
-  spin_unlock_irqrestore(&g_pressure_lock, flags);
+void iob_notify_pressure(int navail)
+{
+  pressure_notify(PRESSURE_IOB, navail, navail);
 }
-
+#endif
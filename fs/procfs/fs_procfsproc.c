@@ -99,6 +99,12 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+  PROC_TASKSTAT,                      /* Run time per CPU */
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  PROC_LATENCY,                       /* Scheduling latency histogram */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   PROC_HEAP,                          /* Task heap info */
 #endif
@@ -190,6 +196,19 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+static ssize_t proc_taskstat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+static ssize_t proc_latency(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+static ssize_t proc_latency_write(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR const char *buffer,
+                 size_t buflen, off_t offset);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 static ssize_t proc_heap(FAR struct proc_file_s *procfile,
                          FAR struct tcb_s *tcb, FAR char *buffer,
@@ -302,6 +321,20 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+static const struct proc_node_s g_taskstat =
+{
+  "stat",         "stat",    (uint8_t)PROC_TASKSTAT,     DTYPE_FILE        /* Run time per CPU */
+};
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+static const struct proc_node_s g_latency =
+{
+  "latency",       "latency", (uint8_t)PROC_LATENCY,     DTYPE_FILE        /* Scheduling latency histogram */
+};
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static const struct proc_node_s g_heap =
 {
@@ -356,6 +389,12 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+  &g_taskstat,     /* Run time per CPU */
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  &g_latency,      /* Scheduling latency histogram */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -385,6 +424,12 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+  &g_taskstat,     /* Run time per CPU */
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  &g_latency,      /* Scheduling latency histogram */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -944,6 +989,142 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_taskstat
+ *
+ * Description:
+ *   Generate one line in the spirit of the Linux /proc/<pid>/stat:
+ *
+ *     <pid> (<name>) <state> <cpu> <run time> <run time on cpu0> ...
+ *
+ *   where state is R for a ready to run thread and S for a blocked one and
+ *   cpu is the CPU that ran the thread last.  The times are measured with
+ *   the perf counter at every context switch, interrupt time excluded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+static ssize_t proc_taskstat(FAR struct proc_file_s *procfile,
+                             FAR struct tcb_s *tcb, FAR char *buffer,
+                             size_t buflen, off_t offset)
+{
+  struct timespec runtime;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int cpu;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Generate output for the thread identity and total run time */
+
+  perf_convert(tcb->run_time, &runtime);
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                             "%d (%s) %c %d %lu.%09lu", tcb->pid,
+                             get_task_name(tcb),
+                             tcb->task_state < FIRST_BLOCKED_STATE ?
+                             'R' : 'S',
+#ifdef CONFIG_SMP
+                             tcb->cpu,
+#else
+                             0,
+#endif
+                             (unsigned long)runtime.tv_sec,
+                             (unsigned long)runtime.tv_nsec);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  /* Generate output for the run time on each CPU */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && totalsize < buflen; cpu++)
+    {
+      perf_convert(tcb->run_cpu[cpu], &runtime);
+      linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                 " %lu.%09lu%s",
+                                 (unsigned long)runtime.tv_sec,
+                                 (unsigned long)runtime.tv_nsec,
+                                 cpu == CONFIG_SMP_NCPUS - 1 ? "\n" : "");
+      copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: proc_latency
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+static ssize_t proc_latency(FAR struct proc_file_s *procfile,
+                            FAR struct tcb_s *tcb, FAR char *buffer,
+                            size_t buflen, off_t offset)
+{
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int i;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Generate one line per bucket with its upper bound in nanoseconds */
+
+  for (i = 0; i < CONFIG_SCHED_LATENCY_NBUCKETS; i++)
+    {
+      if (i < CONFIG_SCHED_LATENCY_NBUCKETS - 1)
+        {
+          linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                     "%10lu %10" PRIu32 "\n", 1ul << i,
+                                     tcb->latency_hist[i]);
+        }
+      else
+        {
+          linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                     "%10s %10" PRIu32 "\n", "inf",
+                                     tcb->latency_hist[i]);
+        }
+
+      copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      if (totalsize >= buflen)
+        {
+          break;
+        }
+    }
+
+  return totalsize;
+}
+
+static ssize_t proc_latency_write(FAR struct proc_file_s *procfile,
+                                  FAR struct tcb_s *tcb,
+                                  FAR const char *buffer,
+                                  size_t buflen, off_t offset)
+{
+  /* Any write resets the histogram */
+
+  memset(tcb->latency_hist, 0, sizeof(tcb->latency_hist));
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_heap
  ****************************************************************************/
@@ -1130,6 +1311,26 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   remaining -= copysize;
 #endif
 
+#ifdef CONFIG_STACK_WATERMARK
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the deepest sampled stack usage */
+
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN, "%-12s%zu\n",
+                               "StackPeak:", tcb->sp_watermark == 0 ? 0 :
+                               (size_t)((uintptr_t)tcb->stack_base_ptr +
+                               tcb->adj_stack_size - tcb->sp_watermark));
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+#endif
+
 #if CONFIG_SCHED_STACK_RECORD > 0
   linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN, "%-12s%zu\n",
                               "StackMax: ",
@@ -1692,6 +1893,16 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+    case PROC_TASKSTAT: /* Run time per CPU */
+      ret = proc_taskstat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+    case PROC_LATENCY: /* Scheduling latency histogram */
+      ret = proc_latency(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
       ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -1772,6 +1983,12 @@ static ssize_t proc_write(FAR struct file *filep, FAR const char *buffer,
                                    filep->f_pos);
         break;
 #endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+      case PROC_LATENCY:
+        ret = proc_latency_write(procfile, tcb, buffer, buflen,
+                                 filep->f_pos);
+        break;
+#endif
 
       default:
         ret = -EINVAL;
@@ -0,0 +1,297 @@
+/****************************************************************************
+ * fs/procfs/fs_procfspthread.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/pthread.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_PTHREAD_CACHE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define PTHCACHE_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct pthcache_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  char line[PTHCACHE_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     pthcache_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     pthcache_close(FAR struct file *filep);
+static ssize_t pthcache_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     pthcache_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     pthcache_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_pthcache_operations =
+{
+  pthcache_open,      /* open */
+  pthcache_close,     /* close */
+  pthcache_read,      /* read */
+  NULL,               /* write */
+  NULL,               /* poll */
+
+  pthcache_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  pthcache_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthcache_us
+ *
+ * Description:
+ *   Convert an interval of perf_gettime() to microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t pthcache_us(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: pthcache_open
+ ****************************************************************************/
+
+static int pthcache_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct pthcache_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct pthcache_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthcache_close
+ ****************************************************************************/
+
+static int pthcache_close(FAR struct file *filep)
+{
+  FAR struct pthcache_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct pthcache_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthcache_read
+ ****************************************************************************/
+
+static ssize_t pthcache_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct pthcache_file_s *attr;
+  struct pthread_cache_stats_s stats;
+  size_t linesize;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct pthcache_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  nx_pthread_cache_stats(&stats);
+
+  offset   = filep->f_pos;
+  linesize = procfs_snprintf(attr->line, PTHCACHE_LINELEN,
+                             "Cached:   %" PRIu32 "\n"
+                             "Hits:     %" PRIu32 "\n"
+                             "Misses:   %" PRIu32 "\n",
+                             stats.ncached, stats.hits, stats.misses);
+  ret      = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  if (ret < buflen)
+    {
+      linesize = procfs_snprintf(attr->line, PTHCACHE_LINELEN,
+                                 "Created:  %" PRIu32 "\n"
+                                 "Avg(us):  %" PRIu64 "\n"
+                                 "Max(us):  %" PRIu64 "\n",
+                                 stats.ncreated,
+                                 stats.ncreated == 0 ? 0 :
+                                 pthcache_us(stats.total / stats.ncreated),
+                                 pthcache_us(stats.max));
+      ret += procfs_memcpy(attr->line, linesize, buffer + ret,
+                           buflen - ret, &offset);
+    }
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pthcache_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int pthcache_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct pthcache_file_s *oldattr;
+  FAR struct pthcache_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct pthcache_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct pthcache_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct pthcache_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthcache_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int pthcache_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "sched/pthread" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_PTHREAD_CACHE */
@@ -39,6 +39,7 @@
 #include <nuttx/crc16.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/pagecache.h>
 
 #include "fs_romfs.h"
 #include "fs_heap.h"
@@ -575,8 +576,8 @@ int romfs_hwread(FAR struct romfs_mountpt_s *rm, FAR uint8_t *buffer,
       /* In non-XIP mode, we have to read the data from the device */
 
       FAR struct inode *inode = rm->rm_blkdriver;
-      ssize_t nsectorsread =
-        inode->u.i_bops->read(inode, buffer, sector, nsectors);
+      ssize_t nsectorsread = pagecache_read(inode, buffer, sector,
+                                            nsectors, rm->rm_hwsectorsize);
 
       if (nsectorsread < 0)
         {
@@ -697,6 +698,10 @@ int romfs_hwconfigure(FAR struct romfs_mountpt_s *rm)
       return -EBUSY;
     }
 
+  /* The image may have been replaced while it was not mounted */
+
+  pagecache_invalidate(inode);
+
   /* Save that information in the mount structure */
 
   rm->rm_hwsectorsize = geo.geo_sectorsize;
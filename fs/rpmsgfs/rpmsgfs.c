@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -52,6 +53,7 @@
  ****************************************************************************/
 
 #define RPMSGFS_RETRY_DELAY_MS       10
+#define RPMSGFS_READAHEAD            CONFIG_FS_RPMSGFS_READAHEAD
 
 /****************************************************************************
  * Private Types
@@ -73,6 +75,11 @@ struct rpmsgfs_ofile_s
   int16_t                    crefs;    /* Reference count */
   mode_t                     oflags;   /* Open mode */
   int                        fd;
+#if RPMSGFS_READAHEAD > 0
+  FAR char                   *rabuf;   /* Read-ahead data, O_RDONLY only */
+  size_t                     ralen;    /* Bytes of data in rabuf */
+  size_t                     rapos;    /* Bytes of rabuf already read */
+#endif
 };
 
 /* This structure represents the overall mountpoint state.  An instance of
@@ -147,6 +154,14 @@ static int     rpmsgfs_chstat(FAR struct inode *mountpt,
                               FAR const char *relpath,
                               FAR const struct stat *buf, int flags);
 
+#if RPMSGFS_READAHEAD > 0
+static ssize_t rpmsgfs_readahead(FAR struct rpmsgfs_mountpt_s *fs,
+                                 FAR struct rpmsgfs_ofile_s *hf,
+                                 FAR char *buffer, size_t buflen);
+static int     rpmsgfs_discard(FAR struct rpmsgfs_mountpt_s *fs,
+                               FAR struct rpmsgfs_ofile_s *hf);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -315,7 +330,7 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Allocate memory for the open file */
 
-  hf = fs_heap_malloc(sizeof *hf);
+  hf = fs_heap_zalloc(sizeof *hf);
   if (hf == NULL)
     {
       ret = -ENOMEM;
@@ -468,6 +483,9 @@ static int rpmsgfs_close(FAR struct file *filep)
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if RPMSGFS_READAHEAD > 0
+  fs_heap_free(hf->rabuf);
+#endif
   fs_heap_free(hf);
 
 okout:
@@ -509,7 +527,17 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
-  ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+#if RPMSGFS_READAHEAD > 0
+  if ((hf->oflags & O_WROK) == 0)
+    {
+      ret = rpmsgfs_readahead(fs, hf, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -519,6 +547,93 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
   return ret;
 }
 
+#if RPMSGFS_READAHEAD > 0
+/****************************************************************************
+ * Name: rpmsgfs_readahead
+ *
+ * Description:
+ *   Read a file opened read-only through its read-ahead buffer.  The small
+ *   reads are served from data fetched from the host in one round trip of
+ *   CONFIG_FS_RPMSGFS_READAHEAD bytes, the large ones go to the host
+ *   directly.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_readahead(FAR struct rpmsgfs_mountpt_s *fs,
+                                 FAR struct rpmsgfs_ofile_s *hf,
+                                 FAR char *buffer, size_t buflen)
+{
+  size_t nread;
+  ssize_t ret;
+
+  nread = MIN(buflen, hf->ralen - hf->rapos);
+  memcpy(buffer, hf->rabuf + hf->rapos, nread);
+  hf->rapos += nread;
+
+  if (nread == buflen)
+    {
+      return nread;
+    }
+
+  if (hf->rabuf == NULL)
+    {
+      hf->rabuf = fs_heap_malloc(RPMSGFS_READAHEAD);
+    }
+
+  if (buflen - nread >= RPMSGFS_READAHEAD || hf->rabuf == NULL)
+    {
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer + nread,
+                                buflen - nread);
+    }
+  else
+    {
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, hf->rabuf,
+                                RPMSGFS_READAHEAD);
+      if (ret > 0)
+        {
+          hf->ralen = ret;
+          hf->rapos = MIN(buflen - nread, (size_t)ret);
+          memcpy(buffer + nread, hf->rabuf, hf->rapos);
+          ret = hf->rapos;
+        }
+    }
+
+  if (ret < 0)
+    {
+      return nread > 0 ? nread : ret;
+    }
+
+  return nread + ret;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_discard
+ *
+ * Description:
+ *   Drop the read-ahead data and move the host file position back to the
+ *   file position.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_discard(FAR struct rpmsgfs_mountpt_s *fs,
+                           FAR struct rpmsgfs_ofile_s *hf)
+{
+  off_t unread = hf->ralen - hf->rapos;
+  off_t ret;
+
+  hf->ralen = 0;
+  hf->rapos = 0;
+
+  if (unread == 0)
+    {
+      return OK;
+    }
+
+  ret = rpmsgfs_client_lseek(fs->handle, hf->fd, -unread, SEEK_CUR);
+  return ret < 0 ? ret : OK;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgfs_write
  ****************************************************************************/
@@ -603,6 +718,18 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+#if RPMSGFS_READAHEAD > 0
+  /* The host is ahead of the file position by the unread data */
+
+  if (whence == SEEK_CUR)
+    {
+      offset -= hf->ralen - hf->rapos;
+    }
+
+  hf->ralen = 0;
+  hf->rapos = 0;
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
@@ -646,6 +773,15 @@ static int rpmsgfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+#if RPMSGFS_READAHEAD > 0
+  ret = rpmsgfs_discard(fs, hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+#endif
+
   /* Call our internal routine to perform the ioctl */
 
   ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
@@ -60,6 +60,8 @@
 #define RPMSGFS_STAT            20
 #define RPMSGFS_FCHSTAT         21
 #define RPMSGFS_CHSTAT          22
+#define RPMSGFS_READ_SHM        23
+#define RPMSGFS_WRITE_SHM       24
 
 /****************************************************************************
  * Public Types
@@ -96,6 +98,18 @@ begin_packed_struct struct rpmsgfs_read_s
 
 #define rpmsgfs_write_s rpmsgfs_read_s
 
+/* Read or write with the data in a shared memory buffer, see
+ * nuttx/rpmsg/rpmsg_shm.h.
+ */
+
+begin_packed_struct struct rpmsgfs_shm_s
+{
+  struct rpmsgfs_header_s header;
+  int32_t                 fd;
+  uint32_t                count;
+  uint32_t                handle;
+} end_packed_struct;
+
 begin_packed_struct struct rpmsgfs_lseek_s
 {
   struct rpmsgfs_header_s header;
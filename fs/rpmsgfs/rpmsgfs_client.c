@@ -35,6 +35,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/rpmsg/rpmsg.h>
+#include <nuttx/rpmsg/rpmsg_shm.h>
 #include <nuttx/semaphore.h>
 
 #include "rpmsgfs.h"
@@ -91,6 +92,11 @@ static int rpmsgfs_send_recv(FAR struct rpmsgfs_s *priv,
                              uint32_t command, bool copy,
                              FAR struct rpmsgfs_header_s *msg,
                              int len, FAR void *data);
+#ifdef CONFIG_RPMSG_SHM
+static ssize_t rpmsgfs_shm_transfer(FAR struct rpmsgfs_s *priv,
+                                    uint32_t command, int fd,
+                                    FAR void *buf, size_t count);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -120,6 +126,10 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_default_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_default_handler,
+#ifdef CONFIG_RPMSG_SHM
+  [RPMSGFS_READ_SHM]  = rpmsgfs_default_handler,
+  [RPMSGFS_WRITE_SHM] = rpmsgfs_default_handler,
+#endif
 };
 
 /****************************************************************************
@@ -394,6 +404,55 @@ fail:
   return ret;
 }
 
+#ifdef CONFIG_RPMSG_SHM
+/* Read or write in a single request, with the data in a buffer of the
+ * shared memory pool instead of the rpmsg messages.  -ENOMEM is returned
+ * if no such buffer is available.
+ */
+
+static ssize_t rpmsgfs_shm_transfer(FAR struct rpmsgfs_s *priv,
+                                    uint32_t command, int fd,
+                                    FAR void *buf, size_t count)
+{
+  struct rpmsgfs_shm_s msg;
+  FAR void *shm;
+  ssize_t ret;
+
+  shm = rpmsg_shm_alloc(&priv->ept, count);
+  if (shm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Flush the buffer even for a read, so that no dirty cache line is
+   * evicted over the data written by the server.
+   */
+
+  if (command == RPMSGFS_WRITE_SHM)
+    {
+      memcpy(shm, buf, count);
+    }
+
+  rpmsg_shm_flush(shm, count);
+
+  msg.fd     = fd;
+  msg.count  = count;
+  msg.handle = rpmsg_shm_handle(&priv->ept, shm);
+
+  ret = rpmsgfs_send_recv(priv, command, true,
+                          (FAR struct rpmsgfs_header_s *)&msg,
+                          sizeof(msg), NULL);
+  if (ret > 0 && command == RPMSGFS_READ_SHM)
+    {
+      rpmsg_shm_invalidate(shm, ret);
+      memcpy(buf, shm, ret);
+    }
+
+  rpmsg_shm_free(&priv->ept, shm);
+  return ret;
+}
+#endif
+
 static ssize_t rpmsgfs_ioctl_arglen(int cmd)
 {
   switch (cmd)
@@ -479,6 +538,14 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
       return 0;
     }
 
+#ifdef CONFIG_RPMSG_SHM
+  ret = rpmsgfs_shm_transfer(priv, RPMSGFS_READ_SHM, fd, buf, count);
+  if (ret != -ENOMEM)
+    {
+      return ret;
+    }
+#endif
+
   memset(&cookie, 0, sizeof(cookie));
 
   nxsem_init(&cookie.sem, 0, 0);
@@ -522,6 +589,15 @@ ssize_t rpmsgfs_client_write(FAR void *handle, int fd,
       return 0;
     }
 
+#ifdef CONFIG_RPMSG_SHM
+  ret = rpmsgfs_shm_transfer(priv, RPMSGFS_WRITE_SHM, fd,
+                             (FAR void *)buf, count);
+  if (ret != -ENOMEM)
+    {
+      return ret;
+    }
+#endif
+
   memset(&cookie, 0, sizeof(cookie));
   nxsem_init(&cookie.sem, 0, 0);
 
@@ -38,6 +38,7 @@
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/rpmsg/rpmsg.h>
+#include <nuttx/rpmsg/rpmsg_shm.h>
 
 #include "rpmsgfs.h"
 #include "fs_heap.h"
@@ -72,6 +73,11 @@ static int rpmsgfs_read_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_write_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv);
+#ifdef CONFIG_RPMSG_SHM
+static int rpmsgfs_shm_handler(FAR struct rpmsg_endpoint *ept,
+                               FAR void *data, size_t len,
+                               uint32_t src, FAR void *priv);
+#endif
 static int rpmsgfs_lseek_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv);
@@ -165,6 +171,10 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_fchstat_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_chstat_handler,
+#ifdef CONFIG_RPMSG_SHM
+  [RPMSGFS_READ_SHM]  = rpmsgfs_shm_handler,
+  [RPMSGFS_WRITE_SHM] = rpmsgfs_shm_handler,
+#endif
 };
 
 /****************************************************************************
@@ -443,6 +453,59 @@ static int rpmsgfs_write_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+#ifdef CONFIG_RPMSG_SHM
+static int rpmsgfs_shm_handler(FAR struct rpmsg_endpoint *ept,
+                               FAR void *data, size_t len,
+                               uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_shm_s *msg = data;
+  FAR struct file *filep;
+  FAR char *buf;
+  ssize_t ret = -ENOENT;
+
+  /* The data is in the shared buffer of the client */
+
+  filep = rpmsgfs_get_file(priv, msg->fd);
+  buf   = rpmsg_shm_ptr(ept, msg->handle, msg->count);
+  if (buf == NULL)
+    {
+      ret = -EINVAL;
+    }
+  else if (filep != NULL && msg->header.command == RPMSGFS_READ_SHM)
+    {
+      ret = file_read(filep, buf, msg->count);
+      if (ret > 0)
+        {
+          rpmsg_shm_flush(buf, ret);
+        }
+    }
+  else if (filep != NULL)
+    {
+      size_t written = 0;
+
+      rpmsg_shm_invalidate(buf, msg->count);
+      while (written < msg->count)
+        {
+          ret = file_write(filep, buf + written, msg->count - written);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          written += ret;
+        }
+
+      if (ret >= 0)
+        {
+          ret = written;
+        }
+    }
+
+  msg->header.result = ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+#endif
+
 static int rpmsgfs_lseek_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv)
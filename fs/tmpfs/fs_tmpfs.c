@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <stdint.h>
@@ -54,10 +55,34 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+#  if (CONFIG_FS_TMPFS_PAGESIZE & (CONFIG_FS_TMPFS_PAGESIZE - 1)) != 0
+#    error CONFIG_FS_TMPFS_PAGESIZE must be a power of two
+#  endif
+
+#  define TMPFS_PAGE_SIZE       CONFIG_FS_TMPFS_PAGESIZE
+
+/* Each node of the radix tree holds TMPFS_RADIX_FANOUT pointers to the
+ * nodes of the next level, or to the pages at the last level.  A tree of
+ * height zero is a single page.
+ */
+
+#  define TMPFS_RADIX_BITS      5
+#  define TMPFS_RADIX_FANOUT    (1 << TMPFS_RADIX_BITS)
+#  define TMPFS_RADIX_MASK      (TMPFS_RADIX_FANOUT - 1)
+#  define TMPFS_RADIX_MAXHEIGHT ((sizeof(size_t) * 8 - 1) / TMPFS_RADIX_BITS)
+#  define TMPFS_RADIX_SIZE      (TMPFS_RADIX_FANOUT * sizeof(FAR void *))
+#elif CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+/* The end of a hash bucket chain, also the limit of the number of entries
+ * of a directory.
+ */
+
+#define TMPFS_NO_DIRENT   0xffff
+#define TMPFS_MAX_BUCKETS 0x8000
+
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -96,11 +121,20 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_read_file(FAR struct tmpfs_file_s *tfo, off_t pos,
+              FAR char *buffer, size_t buflen);
+static ssize_t tmpfs_write_file(FAR struct tmpfs_file_s *tfo, off_t pos,
+              FAR const char *buffer, size_t buflen);
+static FAR uint8_t *tmpfs_file_addr(FAR struct tmpfs_file_s *tfo,
+              off_t offset, size_t length);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name, size_t len);
+static void tmpfs_unlink_dirent(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
 static int  tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name);
 static int  tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -244,10 +278,11 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
     }
 
   /* Added some additional amount to the new size to account frequent
-   * reallocations.
+   * reallocations.  The directory grows by half of its size at least, so
+   * that adding many entries copies the array a few times only.
    */
 
-  objsize += CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD;
+  objsize += MAX(CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD, objsize / 2);
 
   /* Realloc the directory object */
 
@@ -268,6 +303,290 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
   return ret;
 }
 
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+/****************************************************************************
+ * Name: tmpfs_find_page
+ *
+ * Description:
+ *   Return the page of a file at a page index.  If 'alloc' is true, the
+ *   missing page and the radix tree nodes leading to it are allocated,
+ *   otherwise NULL is returned for a hole.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_find_page(FAR struct tmpfs_file_s *tfo,
+                                    size_t index, bool alloc)
+{
+  FAR void **slot;
+  FAR void **node;
+  unsigned int height;
+
+  /* Add levels on top of the tree until it covers the index */
+
+  while (index >= ((size_t)1 << (tfo->tfo_height * TMPFS_RADIX_BITS)))
+    {
+      if (!alloc || tfo->tfo_height >= TMPFS_RADIX_MAXHEIGHT)
+        {
+          return NULL;
+        }
+
+      if (tfo->tfo_root != NULL)
+        {
+          node = fs_heap_zalloc(TMPFS_RADIX_SIZE);
+          if (node == NULL)
+            {
+              return NULL;
+            }
+
+          node[0]       = tfo->tfo_root;
+          tfo->tfo_root = node;
+        }
+
+      tfo->tfo_height++;
+    }
+
+  slot = &tfo->tfo_root;
+  for (height = tfo->tfo_height; height > 0; height--)
+    {
+      if (*slot == NULL)
+        {
+          if (!alloc)
+            {
+              return NULL;
+            }
+
+          *slot = fs_heap_zalloc(TMPFS_RADIX_SIZE);
+          if (*slot == NULL)
+            {
+              return NULL;
+            }
+        }
+
+      node = *slot;
+      slot = &node[(index >> ((height - 1) * TMPFS_RADIX_BITS)) &
+                   TMPFS_RADIX_MASK];
+    }
+
+  if (*slot == NULL && alloc)
+    {
+      *slot = fs_heap_zalloc(TMPFS_PAGE_SIZE);
+      if (*slot != NULL)
+        {
+          tfo->tfo_alloc += TMPFS_PAGE_SIZE;
+        }
+    }
+
+  return *slot;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_pages
+ *
+ * Description:
+ *   Free the pages from the page index 'first' in the subtree of '*slot',
+ *   which has 'height' levels and starts at the page index 'base'.  The
+ *   nodes left without pages in this range are freed too.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo,
+                             FAR void **slot, unsigned int height,
+                             size_t base, size_t first)
+{
+  FAR void **node = *slot;
+  size_t span;
+  int i;
+
+  if (node == NULL)
+    {
+      return;
+    }
+
+  if (height > 0)
+    {
+      span = (size_t)1 << ((height - 1) * TMPFS_RADIX_BITS);
+      for (i = 0; i < TMPFS_RADIX_FANOUT; i++)
+        {
+          if (base + (i + 1) * span > first)
+            {
+              tmpfs_free_pages(tfo, &node[i], height - 1, base + i * span,
+                               first);
+            }
+        }
+    }
+
+  if (base >= first)
+    {
+      fs_heap_free(node);
+      *slot = NULL;
+
+      if (height == 0)
+        {
+          tfo->tfo_alloc -= TMPFS_PAGE_SIZE;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_realloc_file
+ ****************************************************************************/
+
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR uint8_t *page;
+  size_t offset;
+
+  /* Growing only moves the end of the file, the new range is a hole */
+
+  if (newsize < tfo->tfo_size)
+    {
+      /* Free the pages past the new end and zero the end of the last page,
+       * so that the range reads as zeros if the file grows again.
+       */
+
+      tmpfs_free_pages(tfo, &tfo->tfo_root, tfo->tfo_height, 0,
+                       (newsize + TMPFS_PAGE_SIZE - 1) / TMPFS_PAGE_SIZE);
+
+      offset = newsize % TMPFS_PAGE_SIZE;
+      if (offset > 0)
+        {
+          page = tmpfs_find_page(tfo, newsize / TMPFS_PAGE_SIZE, false);
+          if (page != NULL)
+            {
+              memset(page + offset, 0, TMPFS_PAGE_SIZE - offset);
+            }
+        }
+
+      if (newsize == 0)
+        {
+          tfo->tfo_height = 0;
+        }
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_read_file
+ *
+ * Description:
+ *   Copy file data to a buffer, the range must be within the file.
+ *
+ ****************************************************************************/
+
+static void tmpfs_read_file(FAR struct tmpfs_file_s *tfo, off_t pos,
+                            FAR char *buffer, size_t buflen)
+{
+  FAR uint8_t *page;
+  size_t offset;
+  size_t nread;
+
+  while (buflen > 0)
+    {
+      offset = pos % TMPFS_PAGE_SIZE;
+      nread  = MIN(buflen, TMPFS_PAGE_SIZE - offset);
+      page   = tmpfs_find_page(tfo, pos / TMPFS_PAGE_SIZE, false);
+      if (page != NULL)
+        {
+          memcpy(buffer, page + offset, nread);
+        }
+      else
+        {
+          memset(buffer, 0, nread);
+        }
+
+      buffer += nread;
+      buflen -= nread;
+      pos    += nread;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_file
+ *
+ * Description:
+ *   Copy a buffer to the file data, growing the file if the range goes
+ *   past its end.  Return the number of bytes written, which is short if
+ *   a page can't be allocated.
+ *
+ ****************************************************************************/
+
+static ssize_t tmpfs_write_file(FAR struct tmpfs_file_s *tfo, off_t pos,
+                                FAR const char *buffer, size_t buflen)
+{
+  FAR uint8_t *page;
+  size_t nwritten = 0;
+  size_t offset;
+  size_t nbytes;
+
+  while (nwritten < buflen)
+    {
+      offset = pos % TMPFS_PAGE_SIZE;
+      nbytes = MIN(buflen - nwritten, TMPFS_PAGE_SIZE - offset);
+      page   = tmpfs_find_page(tfo, pos / TMPFS_PAGE_SIZE, true);
+      if (page == NULL)
+        {
+          break;
+        }
+
+      memcpy(page + offset, buffer + nwritten, nbytes);
+      nwritten += nbytes;
+      pos      += nbytes;
+    }
+
+  if (nwritten == 0 && buflen > 0)
+    {
+      return -ENOMEM;
+    }
+
+  if (pos > tfo->tfo_size)
+    {
+      tfo->tfo_size = pos;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: tmpfs_file_addr
+ *
+ * Description:
+ *   Return the address of a range of the file data, or NULL if the range
+ *   is not contiguous in memory.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_file_addr(FAR struct tmpfs_file_s *tfo,
+                                    off_t offset, size_t length)
+{
+  FAR uint8_t *page;
+
+  if (length == 0 || offset % TMPFS_PAGE_SIZE + length > TMPFS_PAGE_SIZE)
+    {
+      return NULL;
+    }
+
+  page = tmpfs_find_page(tfo, offset / TMPFS_PAGE_SIZE, true);
+  return page != NULL ? page + offset % TMPFS_PAGE_SIZE : NULL;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_file
+ *
+ * Description:
+ *   Free the data of a file.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  tmpfs_free_pages(tfo, &tfo->tfo_root, tfo->tfo_height, 0, 0);
+  tfo->tfo_height = 0;
+}
+
+#else
 /****************************************************************************
  * Name: tmpfs_realloc_file
  ****************************************************************************/
@@ -346,6 +665,94 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_read_file
+ *
+ * Description:
+ *   Copy file data to a buffer, the range must be within the file.
+ *
+ ****************************************************************************/
+
+static void tmpfs_read_file(FAR struct tmpfs_file_s *tfo, off_t pos,
+                            FAR char *buffer, size_t buflen)
+{
+  if (tfo->tfo_data != NULL)
+    {
+      memcpy(buffer, &tfo->tfo_data[pos], buflen);
+    }
+  else
+    {
+      DEBUGASSERT(tfo->tfo_size == 0 && buflen == 0);
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_file
+ *
+ * Description:
+ *   Copy a buffer to the file data, growing the file if the range goes
+ *   past its end.
+ *
+ ****************************************************************************/
+
+static ssize_t tmpfs_write_file(FAR struct tmpfs_file_s *tfo, off_t pos,
+                                FAR const char *buffer, size_t buflen)
+{
+  off_t endpos = pos + buflen;
+  int ret;
+
+  if (endpos > tfo->tfo_size)
+    {
+      /* Reallocate the file to handle the write past the end of the file. */
+
+      ret = tmpfs_realloc_file(tfo, (size_t)endpos);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (tfo->tfo_data != NULL)
+    {
+      memcpy(&tfo->tfo_data[pos], buffer, buflen);
+    }
+  else
+    {
+      DEBUGASSERT(tfo->tfo_size == 0 && buflen == 0);
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: tmpfs_file_addr
+ *
+ * Description:
+ *   Return the address of a range of the file data.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_file_addr(FAR struct tmpfs_file_s *tfo,
+                                    off_t offset, size_t length)
+{
+  return tfo->tfo_data != NULL ? tfo->tfo_data + offset : NULL;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_file
+ *
+ * Description:
+ *   Free the data of a file.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  fs_heap_free(tfo->tfo_data);
+  tfo->tfo_data = NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -383,7 +790,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_file(tfo);
       fs_heap_free(tfo);
     }
 
@@ -418,6 +825,57 @@ static int tmpfs_release_file(FAR struct tmpfs_file_s *tfo)
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_hash_name
+ ****************************************************************************/
+
+static uint32_t tmpfs_hash_name(FAR const char *name, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: tmpfs_rehash_directory
+ *
+ * Description:
+ *   Rebuild the hash table of a directory with a new number of buckets.
+ *
+ ****************************************************************************/
+
+static int tmpfs_rehash_directory(FAR struct tmpfs_directory_s *tdo,
+                                  unsigned int nbuckets)
+{
+  FAR uint16_t *buckets;
+  unsigned int i;
+  uint32_t slot;
+
+  buckets = fs_heap_malloc(nbuckets * sizeof(uint16_t));
+  if (buckets == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(buckets, 0xff, nbuckets * sizeof(uint16_t));
+  for (i = 0; i < tdo->tdo_nentries; i++)
+    {
+      slot = tdo->tdo_entry[i].tde_hash & (nbuckets - 1);
+      tdo->tdo_entry[i].tde_next = buckets[slot];
+      buckets[slot] = i;
+    }
+
+  fs_heap_free(tdo->tdo_hash);
+  tdo->tdo_hash     = buckets;
+  tdo->tdo_nbuckets = nbuckets;
+  return OK;
+}
+
 /****************************************************************************
  * Name: tmpfs_find_dirent
  ****************************************************************************/
@@ -425,6 +883,7 @@ static int tmpfs_release_file(FAR struct tmpfs_file_s *tfo)
 static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
                              FAR const char *name, size_t len)
 {
+  uint32_t hash;
   int i;
 
   if (len == 0)
@@ -441,17 +900,77 @@ static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
         }
     }
 
-  /* Search the list of directory entries for a match */
+  /* Search the hash bucket of the name for a match */
+
+  if (tdo->tdo_hash == NULL)
+    {
+      return -ENOENT;
+    }
+
+  hash = tmpfs_hash_name(name, len);
+  for (i = tdo->tdo_hash[hash & (tdo->tdo_nbuckets - 1)];
+       i != TMPFS_NO_DIRENT; i = tdo->tdo_entry[i].tde_next)
+    {
+      FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[i];
+
+      if (tde->tde_hash == hash && strncmp(tde->tde_name, name, len) == 0 &&
+          tde->tde_name[len] == '\0')
+        {
+          return i;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_link
+ *
+ * Description:
+ *   Return the link which points to a directory entry in its hash bucket.
+ *
+ ****************************************************************************/
+
+static FAR uint16_t *tmpfs_hash_link(FAR struct tmpfs_directory_s *tdo,
+                                     unsigned int index)
+{
+  FAR uint16_t *link;
+
+  link = &tdo->tdo_hash[tdo->tdo_entry[index].tde_hash &
+                        (tdo->tdo_nbuckets - 1)];
+  while (*link != index)
+    {
+      link = &tdo->tdo_entry[*link].tde_next;
+    }
+
+  return link;
+}
+
+/****************************************************************************
+ * Name: tmpfs_unlink_dirent
+ *
+ * Description:
+ *   Remove a directory entry by replacing it with the final directory
+ *   entry.
+ *
+ ****************************************************************************/
+
+static void tmpfs_unlink_dirent(FAR struct tmpfs_directory_s *tdo,
+                                unsigned int index)
+{
+  unsigned int last = tdo->tdo_nentries - 1;
+
+  *tmpfs_hash_link(tdo, index) = tdo->tdo_entry[index].tde_next;
 
-  for (i = 0;
-       i < tdo->tdo_nentries &&
-       (strncmp(tdo->tdo_entry[i].tde_name, name, len) != 0 ||
-       tdo->tdo_entry[i].tde_name[len] != 0);
-       i++);
+  if (index != last)
+    {
+      *tmpfs_hash_link(tdo, last) = index;
+      tdo->tdo_entry[index] = tdo->tdo_entry[last];
+    }
 
-  /* Return what we found, if anything */
+  /* And decrement the count of directory entries */
 
-  return i < tdo->tdo_nentries ? i : -ENOENT;
+  tdo->tdo_nentries = last;
 }
 
 /****************************************************************************
@@ -462,7 +981,6 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
                                FAR const char *name)
 {
   int index;
-  int last;
 
   /* Search the list of directory entries for a match */
 
@@ -481,15 +999,7 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
 
   /* Remove by replacing this entry with the final directory entry */
 
-  last = tdo->tdo_nentries - 1;
-  if (index != last)
-    {
-      tdo->tdo_entry[index] = tdo->tdo_entry[last];
-    }
-
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  tmpfs_unlink_dirent(tdo, index);
   return OK;
 }
 
@@ -505,6 +1015,7 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
   FAR char *newname;
   unsigned int nentries;
   size_t namelen;
+  uint32_t slot;
   int index;
 
   /* Copy the name string so that it will persist as long as the
@@ -526,16 +1037,20 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
         }
     }
 
+  /* Get the new number of entries */
+
+  nentries = tdo->tdo_nentries + 1;
+  if (nentries >= TMPFS_NO_DIRENT)
+    {
+      return -ENOSPC;
+    }
+
   newname = fs_heap_strndup(name, namelen);
   if (newname == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Get the new number of entries */
-
-  nentries = tdo->tdo_nentries + 1;
-
   /* Reallocate the directory object (if necessary) */
 
   index = tmpfs_realloc_directory(tdo, nentries);
@@ -551,7 +1066,29 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
   tde             = &tdo->tdo_entry[index];
   tde->tde_object = to;
   tde->tde_name   = newname;
+  tde->tde_hash   = tmpfs_hash_name(newname, namelen);
+
+  /* Keep about one entry per hash bucket.  If the table can't grow, the
+   * entry goes to the old one, only the first table is mandatory.
+   */
+
+  if (nentries > tdo->tdo_nbuckets &&
+      tdo->tdo_nbuckets < TMPFS_MAX_BUCKETS &&
+      tmpfs_rehash_directory(tdo, MAX(2 * tdo->tdo_nbuckets, 8)) >= 0)
+    {
+      return OK;
+    }
+
+  if (tdo->tdo_hash == NULL)
+    {
+      tdo->tdo_nentries--;
+      fs_heap_free(newname);
+      return -ENOMEM;
+    }
 
+  slot = tde->tde_hash & (tdo->tdo_nbuckets - 1);
+  tde->tde_next = tdo->tdo_hash[slot];
+  tdo->tdo_hash[slot] = index;
   return OK;
 }
 
@@ -582,7 +1119,12 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+  tfo->tfo_height = 0;
+  tfo->tfo_root   = NULL;
+#else
   tfo->tfo_data   = NULL;
+#endif
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -731,7 +1273,9 @@ tmpfs_alloc_directory(FAR struct tmpfs_directory_s *parent)
   tdo->tdo_refs     = 0;
   tdo->tdo_parent   = parent;
   tdo->tdo_nentries = 0;
+  tdo->tdo_nbuckets = 0;
   tdo->tdo_entry    = NULL;
+  tdo->tdo_hash     = NULL;
 
   nxrmutex_init(&tdo->tdo_lock);
 
@@ -1189,7 +1733,11 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1220,10 +1768,8 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
                               unsigned int index, FAR void *arg)
 {
-  FAR struct tmpfs_dirent_s *tde;
   FAR struct tmpfs_object_s *to;
   FAR struct tmpfs_file_s *tfo;
-  unsigned int last;
 
   /* Free the object name */
 
@@ -1234,20 +1780,8 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 
   /* Remove by replacing this entry with the final directory entry */
 
-  tde  = &tdo->tdo_entry[index];
-  to   = tde->tde_object;
-  last = tdo->tdo_nentries - 1;
-
-  if (index != last)
-    {
-      /* Move the directory entry */
-
-      *tde = tdo->tdo_entry[last];
-    }
-
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  to = tdo->tdo_entry[index].tde_object;
+  tmpfs_unlink_dirent(tdo, index);
 
   /* Is this directory entry a file object? */
 
@@ -1265,13 +1799,14 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_file(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
       tdo = (FAR struct tmpfs_directory_s *)to;
 
       fs_heap_free(tdo->tdo_entry);
+      fs_heap_free(tdo->tdo_hash);
     }
 
   /* Free the object now */
@@ -1586,15 +2121,8 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
-    }
+  tmpfs_read_file(tfo, startpos, buffer, nread);
+  filep->f_pos += nread;
 
   /* Release the lock on the file */
 
@@ -1612,7 +2140,6 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct tmpfs_file_s *tfo;
   ssize_t nwritten;
   off_t startpos;
-  off_t endpos;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1642,41 +2169,18 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
       startpos = filep->f_pos;
     }
 
-  nwritten = buflen;
-  endpos   = startpos + buflen;
+  /* Copy data from the user buffer to the memory object */
 
-  if (endpos > tfo->tfo_size)
+  nwritten = tmpfs_write_file(tfo, startpos, buffer, buflen);
+  if (nwritten >= 0)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
-
-      ret = tmpfs_realloc_file(tfo, (size_t)endpos);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
+      filep->f_pos = startpos + nwritten;
     }
 
-  /* Copy data from the memory object to the user buffer */
-
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
-    }
-
-  filep->f_pos = endpos;
-
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
   return nwritten;
-
-errout_with_lock:
-  tmpfs_unlock_file(tfo);
-  return (ssize_t)ret;
 }
 
 /****************************************************************************
@@ -1788,7 +2292,19 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
+      tmpfs_lock_file(tfo);
+      map->vaddr = tmpfs_file_addr(tfo, map->offset, map->length);
+      tmpfs_unlock_file(tfo);
+
+      if (map->vaddr == NULL)
+        {
+          /* The range is not contiguous in memory, let the caller copy
+           * the data.
+           */
+
+          return -ENOTTY;
+        }
+
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
@@ -1841,8 +2357,18 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   else if (cmd == FIOC_XIPBASE)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
+      FAR uint8_t *base;
 
-      *ptr = (uintptr_t)tfo->tfo_data;
+      tmpfs_lock_file(tfo);
+      base = tmpfs_file_addr(tfo, 0, tfo->tfo_size);
+      tmpfs_unlock_file(tfo);
+
+      if (base == NULL && tfo->tfo_size > 0)
+        {
+          return -ENOTTY;
+        }
+
+      *ptr = (uintptr_t)base;
       return OK;
     }
 
@@ -1976,6 +2502,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
+#if CONFIG_FS_TMPFS_PAGESIZE == 0
       /* If the size has increased, then we need to zero the newly added
        * memory.
        */
@@ -1984,6 +2511,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2264,6 +2792,7 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+  fs_heap_free(tdo->tdo_hash);
   fs_heap_free(tdo);
 
   nxrmutex_destroy(&fs->tfs_lock);
@@ -2430,7 +2959,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_file(tfo);
       fs_heap_free(tfo);
     }
 
@@ -2573,6 +3102,7 @@ static int tmpfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+  fs_heap_free(tdo->tdo_hash);
   fs_heap_free(tdo);
 
   /* Release the reference and lock on the parent directory */
@@ -70,6 +70,8 @@ struct tmpfs_dirent_s
 {
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+  uint32_t tde_hash;     /* Hash of tde_name */
+  uint16_t tde_next;     /* Next entry in the same hash bucket */
 };
 
 /* The generic form of a TMPFS memory object */
@@ -100,7 +102,9 @@ struct tmpfs_directory_s
   /* Remaining fields are unique to a directory object */
 
   uint16_t tdo_nentries; /* Number of directory entries */
+  uint16_t tdo_nbuckets; /* Number of hash buckets, a power of two */
   FAR struct tmpfs_dirent_s *tdo_entry;
+  FAR uint16_t *tdo_hash; /* First entry of each hash bucket */
 };
 
 #define SIZEOF_TMPFS_DIRECTORY(n) ((n) * sizeof(struct tmpfs_dirent_s))
@@ -111,6 +115,11 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * With CONFIG_FS_TMPFS_PAGESIZE > 0, the file data is held in pages of
+ * that size found through a radix tree.  A page is allocated by the first
+ * write into it and a missing page reads as zeros.  Otherwise the file
+ * data is one contiguous buffer.
  */
 
 struct tmpfs_file_s
@@ -126,9 +135,14 @@ struct tmpfs_file_s
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;  /* See TFO_FLAG_* definitions */
+  size_t        tfo_size;   /* Valid file size */
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+  uint8_t       tfo_height; /* Number of levels of the radix tree */
+  FAR void     *tfo_root;   /* Root of the radix tree of the pages */
+#else
+  FAR uint8_t  *tfo_data;   /* File data starts here */
+#endif
 };
 
 /* This structure represents one instance of a TMPFS file system */
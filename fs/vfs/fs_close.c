@@ -114,6 +114,7 @@ int file_close(FAR struct file *filep)
   if (inode)
     {
       file_closelk(filep);
+      file_readahead_release(filep);
 
       /* Close the file, driver, or mountpoint. */
 
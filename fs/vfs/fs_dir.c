@@ -205,7 +205,7 @@ static off_t seek_pseudodir(FAR struct file *filep, off_t offset)
    * be a very unpredictable operation.
    */
 
-  inode_lock();
+  inode_rlock();
 
   for (; curr != NULL && pos != offset; pos++, curr = curr->i_peer);
 
@@ -223,7 +223,7 @@ static off_t seek_pseudodir(FAR struct file *filep, off_t offset)
       atomic_fetch_add(&curr->i_crefs, 1);
     }
 
-  inode_unlock();
+  inode_runlock();
 
   if (prev != NULL)
     {
@@ -378,7 +378,7 @@ static int read_pseudodir(FAR struct fs_dirent_s *dir,
 
   /* Now get the inode to visit next time that readdir() is called */
 
-  inode_lock();
+  inode_rlock();
 
   prev       = pdir->next;
   pdir->next = prev->i_peer; /* The next node to visit */
@@ -390,7 +390,7 @@ static int read_pseudodir(FAR struct fs_dirent_s *dir,
       atomic_fetch_add(&pdir->next->i_crefs, 1);
     }
 
-  inode_unlock();
+  inode_runlock();
 
   if (prev != NULL)
     {
@@ -42,6 +42,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/tls.h>
 
 #include "inode/inode.h"
@@ -54,8 +55,9 @@
 struct epoll_node_s
 {
   struct list_node         node;
+  struct list_node         rnode;    /* Link in the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     notified; /* Notified since the last setup */
   struct pollfd            pfd;
   FAR struct file         *filep;
   FAR struct epoll_head_s *eph;
@@ -69,6 +71,14 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
+  spinlock_t            rlock;    /* Protects the ready list, which is
+                                   * changed by the poll callbacks.
+                                   */
+  struct list_node      ready;    /* The ready list, store the setuped
+                                   * epoll node notified by its poll
+                                   * callback, so epoll_wait() only visits
+                                   * these nodes.
+                                   */
   struct list_node      setup;    /* The setup list, store all the setuped
                                    * epoll node.
                                    */
@@ -250,12 +260,14 @@ static int epoll_do_create(int size, int flags)
   eph->size = size;
   nxmutex_init(&eph->lock);
   nxsem_init(&eph->sem, 0, 0);
+  spin_lock_init(&eph->rlock);
 
   /* List initialize */
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
   list_initialize(&eph->setup);
+  list_initialize(&eph->ready);
   list_initialize(&eph->teardown);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
@@ -281,6 +293,29 @@ static int epoll_do_create(int size, int flags)
   return fd;
 }
 
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove an epoll node from the ready list.  The poll of the node must be
+ *   torn down already, so that its callback can't queue it again.
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (list_in_list(&epn->rnode))
+    {
+      list_delete(&epn->rnode);
+    }
+
+  epn->notified = false;
+  spin_unlock_irqrestore(&eph->rlock, flags);
+}
+
 /****************************************************************************
  * Name: epoll_setup
  *
@@ -335,8 +370,8 @@ static int epoll_setup(FAR epoll_head_t *eph)
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notified fd and check the notified fd's event with user
- *   expected event.
+ *   Consume the ready list: teardown the notified level triggered fd and
+ *   check the notified fd's event with user expected event.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -352,42 +387,68 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  /* Only visit the notified fd, the ones left when evs is full stay in the
+   * ready list for the next epoll_wait().
+   */
+
+  while (i < maxevents)
     {
-      /* Only check the notified fd */
+      flags = spin_lock_irqsave(&eph->rlock);
+      epn = list_remove_head_type(&eph->ready, epoll_node_t, rnode);
+      if (epn == NULL)
+        {
+          spin_unlock_irqrestore(&eph->rlock, flags);
+          break;
+        }
 
-      if (!epn->notified)
+      revents = epn->pfd.revents;
+      if ((epn->pfd.events & EPOLLET) != 0)
         {
-          continue;
+          /* The edge triggered fd stays setuped, the next notification
+           * queues it again.
+           */
+
+          epn->pfd.revents = 0;
+          epn->notified    = false;
         }
 
-      /* Teradown all the notified fd */
+      spin_unlock_irqrestore(&eph->rlock, flags);
 
-      file_poll(epn->filep, &epn->pfd, false);
-      list_delete(&epn->node);
+      if ((epn->pfd.events & EPOLLET) == 0)
+        {
+          /* Teardown the level triggered fd, epoll_setup() sets it up again
+           * to check the pending poll notification.
+           */
+
+          file_poll(epn->filep, &epn->pfd, false);
+          list_delete(&epn->node);
+          list_add_tail(&eph->teardown, &epn->node);
+        }
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if (revents == 0)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
-            {
-              list_add_tail(&eph->teardown, &epn->node);
-            }
+          continue;
         }
-      else
+
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          if ((epn->pfd.events & EPOLLET) != 0)
+            {
+              file_poll(epn->filep, &epn->pfd, false);
+              epoll_unready(eph, epn);
+            }
+
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
         }
     }
 
@@ -426,15 +487,25 @@ static void epoll_cleanup(FAR void *arg)
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
   int semcount = 0;
 
-  epn->notified = true;
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (!epn->notified)
+    {
+      epn->notified = true;
+      list_add_tail(&eph->ready, &epn->rnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
   if (fds->revents != 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
+      nxsem_get_value(&eph->sem, &semcount);
       if (semcount < 1)
         {
-          nxsem_post(&epn->eph->sem);
+          nxsem_post(&eph->sem);
         }
     }
 }
@@ -617,6 +688,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 file_poll(epn->filep, &epn->pfd, false);
+                epoll_unready(eph, epn);
                 file_put(epn->filep);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
@@ -657,8 +729,8 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     file_poll(epn->filep, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
-                    epn->notified    = false;
                     epn->data        = ev->data;
                     epn->pfd.events  = ev->events | POLLALWAYS;
                     epn->pfd.revents = 0;
@@ -96,6 +96,7 @@ struct inotify_global_s
   int      watch_cookie;       /* Watch cookie */
   uint32_t read_count;         /* Number of read events */
   uint32_t write_count;        /* Number of write events */
+  uint32_t watch_count;        /* Number of active watches */
   struct   hsearch_data hash;  /* Hash table for watch lists */
 };
 
@@ -188,7 +189,8 @@ static void inotify_sub_count(uint32_t mask)
 
 static int notify_check_mask(uint32_t mask)
 {
-  return (((mask & IN_ACCESS) && g_inotify.read_count == 0) ||
+  return (g_inotify.watch_count == 0 ||
+          ((mask & IN_ACCESS) && g_inotify.read_count == 0) ||
           ((mask & IN_MODIFY) && g_inotify.write_count == 0)) ?
           -EBADF : OK;
 }
@@ -314,6 +316,7 @@ inotify_remove_watch_no_event(FAR struct inotify_watch_s *watch)
   list_delete(&watch->d_node);
   list_delete(&watch->l_node);
   inotify_sub_count(watch->mask);
+  g_inotify.watch_count--;
   fs_heap_free(watch);
 
   if (list_is_empty(&list->watches))
@@ -884,6 +887,15 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
   FAR char *pathbuffer;
   uint32_t cookie = 0;
 
+  /* Nothing is watched anywhere, skip the path resolution and the hash
+   * lookups entirely.
+   */
+
+  if (g_inotify.watch_count == 0)
+    {
+      return;
+    }
+
   pathbuffer = lib_get_pathbuffer();
   if (pathbuffer == NULL)
     {
@@ -1147,6 +1159,7 @@ int inotify_add_watch(int fd, FAR const char *pathname, uint32_t mask)
 
       ret = watch->wd;
       inotify_add_count(mask);
+      g_inotify.watch_count++;
     }
 
 out:
@@ -0,0 +1,637 @@
+/****************************************************************************
+ * fs/vfs/fs_ioring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioring.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <poll.h>
+#include <errno.h>
+#include <fcntl.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The kernel state of a ring.  The indexes and the entry arrays are copied
+ * at setup, only the indexes produced by the application are read back
+ * from the shared structure.
+ */
+
+struct ioring_priv_s
+{
+  FAR struct ioring     *ring;     /* The rings of the application */
+  FAR struct fdlist     *list;     /* The descriptors of the application */
+  FAR struct ioring_sqe *sqes;     /* The submission entries */
+  FAR struct ioring_cqe *cqes;     /* The completion entries */
+  uint32_t               sqmask;   /* sq_entries - 1 */
+  uint32_t               cqmask;   /* cq_entries - 1 */
+  uint32_t               sq_head;  /* Next submission to take */
+  uint32_t               cq_tail;  /* Next completion to post */
+  mutex_t                lock;     /* Protects crefs and nwaiters */
+  sem_t                  sqsem;    /* Wakes up the ring thread */
+  sem_t                  cqsem;    /* Wakes up the ioring_enter() waiters */
+  sem_t                  pollsem;  /* Waited by IORING_OP_POLL */
+  sem_t                  exitsem;  /* Posted when the ring thread exits */
+  unsigned int           nwaiters; /* Threads waiting for completions */
+  uint8_t                crefs;    /* References counts on the ring */
+  volatile bool          stop;     /* The ring is being closed */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ioring_open(FAR struct file *filep);
+static int ioring_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_ioring_fops =
+{
+  ioring_open,  /* open */
+  ioring_close, /* close */
+};
+
+static struct inode g_ioring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_ioring_fops        /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_wakeup
+ ****************************************************************************/
+
+static void ioring_wakeup(FAR sem_t *sem)
+{
+  int semcount = 0;
+
+  nxsem_get_value(sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_poll
+ *
+ * Description:
+ *   Wait for the events of a descriptor.  The wait is ended early by the
+ *   close of the ring.
+ *
+ ****************************************************************************/
+
+static ssize_t ioring_poll(FAR struct ioring_priv_s *priv,
+                           FAR struct file *filep, int fd,
+                           pollevent_t events)
+{
+  struct pollfd fds;
+  int ret;
+
+  memset(&fds, 0, sizeof(fds));
+  fds.fd     = fd;
+  fds.events = events | POLLERR | POLLHUP;
+  fds.arg    = &priv->pollsem;
+  fds.cb     = poll_default_cb;
+
+  ret = file_poll(filep, &fds, true);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The semaphore may keep a wakeup of an earlier poll, so the events are
+   * checked again after every wakeup.
+   */
+
+  while (fds.revents == 0 && !priv->stop)
+    {
+      nxsem_wait_uninterruptible(&priv->pollsem);
+    }
+
+  file_poll(filep, &fds, false);
+  return fds.revents != 0 ? fds.revents : -ECANCELED;
+}
+
+/****************************************************************************
+ * Name: ioring_execute
+ *
+ * Description:
+ *   Execute one submission entry on the descriptors of the application and
+ *   return the result of its completion entry.
+ *
+ ****************************************************************************/
+
+static ssize_t ioring_execute(FAR struct ioring_priv_s *priv,
+                              FAR const struct ioring_sqe *sqe)
+{
+  FAR struct file *filep;
+#ifdef CONFIG_NET
+  FAR struct socket *psock;
+#endif
+  ssize_t ret;
+
+  if (sqe->opcode == IORING_OP_NOP)
+    {
+      return 0;
+    }
+
+  ret = fdlist_get(priv->list, sqe->fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_READ:
+        ret = sqe->off < 0 ? file_read(filep, sqe->addr, sqe->len) :
+              file_pread(filep, sqe->addr, sqe->len, sqe->off);
+        break;
+
+      case IORING_OP_WRITE:
+        ret = sqe->off < 0 ? file_write(filep, sqe->addr, sqe->len) :
+              file_pwrite(filep, sqe->addr, sqe->len, sqe->off);
+        break;
+
+#ifdef CONFIG_NET
+      case IORING_OP_SEND:
+      case IORING_OP_RECV:
+        psock = file_socket(filep);
+        if (psock == NULL)
+          {
+            ret = -ENOTSOCK;
+          }
+        else if (sqe->opcode == IORING_OP_SEND)
+          {
+            ret = psock_send(psock, sqe->addr, sqe->len, sqe->op_flags);
+          }
+        else
+          {
+            ret = psock_recv(psock, sqe->addr, sqe->len, sqe->op_flags);
+          }
+        break;
+#endif
+
+      case IORING_OP_FSYNC:
+        ret = file_fsync(filep);
+        break;
+
+      case IORING_OP_POLL:
+        ret = ioring_poll(priv, filep, sqe->fd, sqe->op_flags);
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  file_put(filep);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_complete
+ *
+ * Description:
+ *   Post a completion entry and wake up the threads waiting for it.  The
+ *   completion is dropped and counted in cq_overflow if the completion
+ *   queue is full.
+ *
+ ****************************************************************************/
+
+static void ioring_complete(FAR struct ioring_priv_s *priv,
+                            uintptr_t user_data, ssize_t res)
+{
+  FAR struct ioring *ring = priv->ring;
+  FAR struct ioring_cqe *cqe;
+  uint32_t head;
+
+  head = __atomic_load_n(&ring->cq_head, __ATOMIC_ACQUIRE);
+  if (priv->cq_tail - head > priv->cqmask)
+    {
+      ring->cq_overflow++;
+    }
+  else
+    {
+      cqe = &priv->cqes[priv->cq_tail & priv->cqmask];
+      cqe->user_data = user_data;
+      cqe->res       = res;
+      __atomic_store_n(&ring->cq_tail, ++priv->cq_tail, __ATOMIC_RELEASE);
+    }
+
+  nxmutex_lock(&priv->lock);
+  while (priv->nwaiters > 0)
+    {
+      priv->nwaiters--;
+      nxsem_post(&priv->cqsem);
+    }
+
+  nxmutex_unlock(&priv->lock);
+}
+
+/****************************************************************************
+ * Name: ioring_thread
+ *
+ * Description:
+ *   The thread of a ring.  It executes the submissions one after the other
+ *   in the order of the queue, so an operation which blocks delays the
+ *   ones behind it.  When the submission queue stays empty, the thread
+ *   polls it for CONFIG_IORING_SQPOLL_IDLE milliseconds, then it sets
+ *   IORING_SQ_NEED_WAKEUP and sleeps until ioring_enter() is called.
+ *
+ ****************************************************************************/
+
+static int ioring_thread(int argc, FAR char *argv[])
+{
+  FAR struct ioring_priv_s *priv =
+    (FAR struct ioring_priv_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  FAR struct ioring *ring = priv->ring;
+  struct ioring_sqe sqe;
+#if CONFIG_IORING_SQPOLL_IDLE > 0
+  clock_t idle = clock_systime_ticks();
+#endif
+
+  while (!priv->stop)
+    {
+      if (priv->sq_head !=
+          __atomic_load_n(&ring->sq_tail, __ATOMIC_ACQUIRE))
+        {
+          /* Copy the entry so the application can reuse it at once */
+
+          memcpy(&sqe, &priv->sqes[priv->sq_head & priv->sqmask],
+                 sizeof(sqe));
+          __atomic_store_n(&ring->sq_head, ++priv->sq_head,
+                           __ATOMIC_RELEASE);
+
+          ioring_complete(priv, sqe.user_data, ioring_execute(priv, &sqe));
+#if CONFIG_IORING_SQPOLL_IDLE > 0
+          idle = clock_systime_ticks();
+#endif
+          continue;
+        }
+
+#if CONFIG_IORING_SQPOLL_IDLE > 0
+      if (clock_systime_ticks() - idle <
+          MSEC2TICK(CONFIG_IORING_SQPOLL_IDLE))
+        {
+          sched_yield();
+          continue;
+        }
+#endif
+
+      /* The queue is checked again after the flag is set, a submission
+       * published before the application could see the flag is not lost.
+       */
+
+      __atomic_fetch_or(&ring->flags, IORING_SQ_NEED_WAKEUP,
+                        __ATOMIC_SEQ_CST);
+      if (priv->sq_head ==
+          __atomic_load_n(&ring->sq_tail, __ATOMIC_SEQ_CST) && !priv->stop)
+        {
+          nxsem_wait_uninterruptible(&priv->sqsem);
+        }
+
+      __atomic_fetch_and(&ring->flags, ~IORING_SQ_NEED_WAKEUP,
+                         __ATOMIC_SEQ_CST);
+#if CONFIG_IORING_SQPOLL_IDLE > 0
+      idle = clock_systime_ticks();
+#endif
+    }
+
+  nxsem_post(&priv->exitsem);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ioring_free
+ ****************************************************************************/
+
+static void ioring_free(FAR struct ioring_priv_s *priv)
+{
+  nxmutex_destroy(&priv->lock);
+  nxsem_destroy(&priv->sqsem);
+  nxsem_destroy(&priv->cqsem);
+  nxsem_destroy(&priv->pollsem);
+  nxsem_destroy(&priv->exitsem);
+  fs_heap_free(priv);
+}
+
+/****************************************************************************
+ * Name: ioring_stop
+ *
+ * Description:
+ *   Stop the ring thread and wait for it to exit.  The operation in
+ *   progress is completed first unless it is a POLL, which is cancelled.
+ *   The submissions not taken yet are dropped.
+ *
+ ****************************************************************************/
+
+static void ioring_stop(FAR struct ioring_priv_s *priv)
+{
+  priv->stop = true;
+  ioring_wakeup(&priv->sqsem);
+  ioring_wakeup(&priv->pollsem);
+  nxsem_wait_uninterruptible(&priv->exitsem);
+
+  /* Release the threads still waiting in ioring_enter() */
+
+  nxmutex_lock(&priv->lock);
+  while (priv->nwaiters > 0)
+    {
+      priv->nwaiters--;
+      nxsem_post(&priv->cqsem);
+    }
+
+  nxmutex_unlock(&priv->lock);
+}
+
+/****************************************************************************
+ * Name: ioring_open
+ ****************************************************************************/
+
+static int ioring_open(FAR struct file *filep)
+{
+  FAR struct ioring_priv_s *priv = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (priv->crefs >= 255)
+    {
+      ret = -EMFILE;
+    }
+  else
+    {
+      priv->crefs++;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_close
+ ****************************************************************************/
+
+static int ioring_close(FAR struct file *filep)
+{
+  FAR struct ioring_priv_s *priv = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (--priv->crefs > 0)
+    {
+      nxmutex_unlock(&priv->lock);
+      return OK;
+    }
+
+  nxmutex_unlock(&priv->lock);
+
+  ioring_stop(priv);
+  ioring_free(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_setup
+ *
+ * Description:
+ *   Create a ring on the structure and the entries allocated by the
+ *   application, and start its thread.
+ *
+ * Input Parameters:
+ *   ring  - The rings shared with the kernel
+ *   flags - IORING_SETUP_CLOEXEC or zero
+ *
+ * Returned Value:
+ *   The descriptor of the ring on success; ERROR with errno set on failure.
+ *
+ ****************************************************************************/
+
+int ioring_setup(FAR struct ioring *ring, int flags)
+{
+  FAR struct ioring_priv_s *priv;
+  FAR char *argv[2];
+  char arg1[32];
+  pid_t pid;
+  int ret;
+
+  if (ring == NULL || ring->sqes == NULL || ring->cqes == NULL ||
+      ring->sq_entries == 0 || ring->cq_entries == 0 ||
+      (ring->sq_entries & (ring->sq_entries - 1)) != 0 ||
+      (ring->cq_entries & (ring->cq_entries - 1)) != 0 ||
+      (flags & ~IORING_SETUP_CLOEXEC) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  priv = fs_heap_zalloc(sizeof(struct ioring_priv_s));
+  if (priv == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ring->sq_head     = 0;
+  ring->sq_tail     = 0;
+  ring->cq_head     = 0;
+  ring->cq_tail     = 0;
+  ring->flags       = 0;
+  ring->cq_overflow = 0;
+
+  priv->ring   = ring;
+  priv->list   = nxsched_get_fdlist();
+  priv->sqes   = ring->sqes;
+  priv->cqes   = ring->cqes;
+  priv->sqmask = ring->sq_entries - 1;
+  priv->cqmask = ring->cq_entries - 1;
+  priv->crefs  = 1;
+
+  nxmutex_init(&priv->lock);
+  nxsem_init(&priv->sqsem, 0, 0);
+  nxsem_init(&priv->cqsem, 0, 0);
+  nxsem_init(&priv->pollsem, 0, 0);
+  nxsem_init(&priv->exitsem, 0, 0);
+
+  snprintf(arg1, sizeof(arg1), "%p", priv);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  pid = kthread_create("ioring", CONFIG_IORING_PRIORITY,
+                       CONFIG_IORING_STACKSIZE, ioring_thread, argv);
+  if (pid < 0)
+    {
+      ret = pid;
+      goto errout_with_priv;
+    }
+
+  ret = file_allocate_from_inode(&g_ioring_inode, O_RDWR | flags,
+                                 0, priv, 0);
+  if (ret < 0)
+    {
+      ioring_stop(priv);
+      goto errout_with_priv;
+    }
+
+  return ret;
+
+errout_with_priv:
+  ioring_free(priv);
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: ioring_enter
+ *
+ * Description:
+ *   Wake up the thread of a ring if it is sleeping, and optionally wait
+ *   until the completion queue holds min_complete entries.
+ *
+ * Input Parameters:
+ *   fd           - The descriptor returned by ioring_setup()
+ *   min_complete - The number of completion entries to wait for
+ *   flags        - IORING_ENTER_GETEVENTS to wait, otherwise zero
+ *
+ * Returned Value:
+ *   The number of completion entries available on success; ERROR with
+ *   errno set on failure.
+ *
+ ****************************************************************************/
+
+int ioring_enter(int fd, unsigned int min_complete, int flags)
+{
+  FAR struct ioring_priv_s *priv;
+  FAR struct ioring *ring;
+  FAR struct file *filep;
+  int ret;
+
+  ret = file_get(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (filep->f_inode != &g_ioring_inode ||
+      (flags & ~IORING_ENTER_GETEVENTS) != 0)
+    {
+      ret = -EINVAL;
+      goto errout_with_filep;
+    }
+
+  priv = filep->f_priv;
+  ring = priv->ring;
+
+  if (__atomic_load_n(&ring->flags, __ATOMIC_SEQ_CST) &
+      IORING_SQ_NEED_WAKEUP)
+    {
+      ioring_wakeup(&priv->sqsem);
+    }
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      goto errout_with_filep;
+    }
+
+  while ((flags & IORING_ENTER_GETEVENTS) != 0 && !priv->stop &&
+         priv->cq_tail - ring->cq_head < min_complete)
+    {
+      priv->nwaiters++;
+      nxmutex_unlock(&priv->lock);
+
+      ret = nxsem_wait(&priv->cqsem);
+      nxmutex_lock(&priv->lock);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (ret >= 0)
+    {
+      ret = priv->cq_tail - ring->cq_head;
+    }
+
+  nxmutex_unlock(&priv->lock);
+
+errout_with_filep:
+  file_put(filep);
+errout:
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return ret;
+}
@@ -0,0 +1,420 @@
+/****************************************************************************
+ * fs/vfs/fs_pagecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/hashtable.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/fs/pagecache.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PAGECACHE_NPAGES    CONFIG_FS_PAGECACHE_NPAGES
+#define PAGECACHE_SIZEOF(s) (offsetof(struct pagecache_page_s, pg_data) + (s))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached sector of a block driver */
+
+struct pagecache_page_s
+{
+  hash_node_t       pg_node;   /* Link in the hash bucket */
+  FAR struct inode *pg_inode;  /* The block driver, NULL if unused */
+  blkcnt_t          pg_sector; /* The sector number on the block driver */
+  size_t            pg_size;   /* The size of pg_data */
+  bool              pg_ref;    /* Hit since the clock hand passed */
+  uint8_t           pg_data[1];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The lock is not held while the block drivers are accessed.  The
+ * generation is bumped when a write starts and ends and on invalidation,
+ * so a read which saw it change while the driver was read knows that its
+ * data may be stale, and a write knows that another write overlapped it.
+ */
+
+static mutex_t g_pagecache_lock = NXMUTEX_INITIALIZER;
+static unsigned int g_pagecache_gen;
+
+/* The hash buckets are empty queues when zeroed */
+
+static DECLARE_HASHTABLE(g_pagecache_hash, CONFIG_FS_PAGECACHE_HASH_BITS);
+
+/* The pages allocated so far and the clock hand running over them */
+
+static FAR struct pagecache_page_s *g_pagecache_pages[PAGECACHE_NPAGES];
+static unsigned int g_pagecache_npages;
+static unsigned int g_pagecache_hand;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t pagecache_key(FAR struct inode *inode,
+                                     blkcnt_t sector)
+{
+  return (uint32_t)(uintptr_t)inode ^ (uint32_t)sector;
+}
+
+/****************************************************************************
+ * Name: pagecache_relock
+ *
+ * Description:
+ *   Take the lock back after a block driver was accessed.  The cache must
+ *   still be brought up to date, so a signal must not make it give up.
+ *
+ ****************************************************************************/
+
+static void pagecache_relock(void)
+{
+  while (nxmutex_lock(&g_pagecache_lock) < 0)
+    {
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_find
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *
+pagecache_find(FAR struct inode *inode, blkcnt_t sector, size_t sectsize)
+{
+  FAR struct pagecache_page_s *page;
+  FAR hash_node_t *node;
+
+  hashtable_for_every_possible(g_pagecache_hash, node,
+                               pagecache_key(inode, sector))
+    {
+      page = container_of(node, struct pagecache_page_s, pg_node);
+      if (page->pg_inode == inode && page->pg_sector == sector &&
+          page->pg_size == sectsize)
+        {
+          return page;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pagecache_unlink
+ ****************************************************************************/
+
+static void pagecache_unlink(FAR struct pagecache_page_s *page)
+{
+  if (page->pg_inode != NULL)
+    {
+      hashtable_delete(g_pagecache_hash, &page->pg_node,
+                       pagecache_key(page->pg_inode, page->pg_sector));
+      page->pg_inode = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_alloc
+ *
+ * Description:
+ *   Get a page for a new sector.  The pages are allocated on demand until
+ *   the limit is reached or the heap is exhausted, then the clock hand
+ *   picks the first unused page or the first page not hit since its last
+ *   pass.
+ *
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *pagecache_alloc(size_t sectsize)
+{
+  FAR struct pagecache_page_s *page = NULL;
+
+  if (g_pagecache_npages < PAGECACHE_NPAGES)
+    {
+      page = kmm_malloc(PAGECACHE_SIZEOF(sectsize));
+      if (page != NULL)
+        {
+          page->pg_inode = NULL;
+          page->pg_size  = sectsize;
+          g_pagecache_pages[g_pagecache_npages++] = page;
+          return page;
+        }
+    }
+
+  while (g_pagecache_npages > 0)
+    {
+      if (g_pagecache_hand >= g_pagecache_npages)
+        {
+          g_pagecache_hand = 0;
+        }
+
+      page = g_pagecache_pages[g_pagecache_hand];
+      if (page->pg_inode != NULL && page->pg_ref)
+        {
+          page->pg_ref = false;
+          g_pagecache_hand++;
+          continue;
+        }
+
+      pagecache_unlink(page);
+      if (page->pg_size == sectsize)
+        {
+          g_pagecache_hand++;
+          return page;
+        }
+
+      /* The victim was sized for another block driver, give its slot to
+       * a page of the new size if the heap allows it.
+       */
+
+      kmm_free(page);
+      page = kmm_malloc(PAGECACHE_SIZEOF(sectsize));
+      if (page != NULL)
+        {
+          page->pg_inode = NULL;
+          page->pg_size  = sectsize;
+          g_pagecache_pages[g_pagecache_hand++] = page;
+          return page;
+        }
+
+      g_pagecache_pages[g_pagecache_hand] =
+        g_pagecache_pages[--g_pagecache_npages];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pagecache_insert
+ ****************************************************************************/
+
+static void pagecache_insert(FAR struct inode *inode, blkcnt_t sector,
+                             FAR const unsigned char *data, size_t sectsize)
+{
+  FAR struct pagecache_page_s *page;
+
+  /* Another read may have cached the sector while the driver was read */
+
+  if (pagecache_find(inode, sector, sectsize) != NULL)
+    {
+      return;
+    }
+
+  page = pagecache_alloc(sectsize);
+  if (page != NULL)
+    {
+      /* A new page has to be hit once to survive a pass of the hand, so
+       * the sectors which are read only once are evicted first.
+       */
+
+      memcpy(page->pg_data, data, sectsize);
+      page->pg_inode  = inode;
+      page->pg_sector = sector;
+      page->pg_ref    = false;
+      hashtable_add(g_pagecache_hash, &page->pg_node,
+                    pagecache_key(inode, sector));
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_read
+ *
+ * Description:
+ *   Read sectors from a block driver through the shared sector cache.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                       blkcnt_t start_sector, unsigned int nsectors,
+                       size_t sectsize)
+{
+  FAR struct pagecache_page_s *page;
+  unsigned int nread = 0;
+  unsigned int nmiss;
+  unsigned int gen;
+  ssize_t ret;
+  ssize_t i;
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (nread < nsectors)
+    {
+      page = pagecache_find(inode, start_sector + nread, sectsize);
+      if (page != NULL)
+        {
+          memcpy(buffer + nread * sectsize, page->pg_data, sectsize);
+          page->pg_ref = true;
+          nread++;
+          continue;
+        }
+
+      /* Read the run of the missing sectors with one request */
+
+      for (nmiss = 1; nread + nmiss < nsectors; nmiss++)
+        {
+          if (pagecache_find(inode, start_sector + nread + nmiss,
+                             sectsize) != NULL)
+            {
+              break;
+            }
+        }
+
+      gen = g_pagecache_gen;
+      nxmutex_unlock(&g_pagecache_lock);
+
+      ret = inode->u.i_bops->read(inode, buffer + nread * sectsize,
+                                  start_sector + nread, nmiss);
+
+      pagecache_relock();
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      /* Don't cache what a write may have changed in the meantime */
+
+      for (i = 0; i < ret && gen == g_pagecache_gen; i++)
+        {
+          pagecache_insert(inode, start_sector + nread + i,
+                           buffer + (nread + i) * sectsize, sectsize);
+        }
+
+      nread += ret;
+      if (ret < (ssize_t)nmiss)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_write
+ *
+ * Description:
+ *   Write sectors to a block driver and update the cached copies.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_write(FAR struct inode *inode,
+                        FAR const unsigned char *buffer,
+                        blkcnt_t start_sector, unsigned int nsectors,
+                        size_t sectsize)
+{
+  FAR struct pagecache_page_s *page;
+  unsigned int gen;
+  ssize_t ret;
+  ssize_t i;
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  gen = ++g_pagecache_gen;
+  nxmutex_unlock(&g_pagecache_lock);
+
+  ret = inode->u.i_bops->write(inode, buffer, start_sector, nsectors);
+
+  pagecache_relock();
+
+  /* Only the sectors which are already cached are updated, so the large
+   * streaming writes don't flush the sectors which are read frequently.
+   * If another write ran at the same time, the order in which the two
+   * reached the media is unknown and the sectors are dropped instead.
+   */
+
+  for (i = 0; i < ret && gen == g_pagecache_gen; i++)
+    {
+      page = pagecache_find(inode, start_sector + i, sectsize);
+      if (page != NULL)
+        {
+          memcpy(page->pg_data, buffer + i * sectsize, sectsize);
+        }
+    }
+
+  /* The state of the sectors after a partial write is unknown */
+
+  for (i = gen == g_pagecache_gen && ret > 0 ? ret : 0;
+       i < (ssize_t)nsectors; i++)
+    {
+      page = pagecache_find(inode, start_sector + i, sectsize);
+      if (page != NULL)
+        {
+          pagecache_unlink(page);
+        }
+    }
+
+  g_pagecache_gen++;
+  nxmutex_unlock(&g_pagecache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Drop all the cached sectors of a block driver.
+ *
+ ****************************************************************************/
+
+void pagecache_invalidate(FAR struct inode *inode)
+{
+  unsigned int i;
+
+  nxmutex_lock(&g_pagecache_lock);
+
+  g_pagecache_gen++;
+  for (i = 0; i < g_pagecache_npages; i++)
+    {
+      if (g_pagecache_pages[i]->pg_inode == inode)
+        {
+          pagecache_unlink(g_pagecache_pages[i]);
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
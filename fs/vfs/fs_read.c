@@ -159,10 +159,16 @@ ssize_t file_readv(FAR struct file *filep,
                    FAR const struct iovec *iov, int iovcnt)
 {
   FAR struct inode *inode;
+#ifdef CONFIG_FS_READAHEAD
+  off_t pos;
+#endif
   ssize_t ret;
 
   DEBUGASSERT(filep);
   inode = filep->f_inode;
+#ifdef CONFIG_FS_READAHEAD
+  pos   = filep->f_pos;
+#endif
 
   /* Check buffer count and pointer for iovec */
 
@@ -222,6 +228,15 @@ ssize_t file_readv(FAR struct file *filep,
         }
     }
 
+#ifdef CONFIG_FS_READAHEAD
+  /* Prefetch ahead of the sequential reads of the regular files */
+
+  if (ret > 0 && INODE_IS_MOUNTPT(inode))
+    {
+      file_readahead(filep, pos, ret);
+    }
+#endif
+
   /* Return the number of bytes read (or possibly an error code) */
 
 #ifdef CONFIG_FS_NOTIFY
@@ -0,0 +1,259 @@
+/****************************************************************************
+ * fs/vfs/fs_readahead.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "vfs.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The readahead state of an open file.  The window [ra_start, ra_end) is
+ * the last one issued, the next one is issued at ra_end as soon as the
+ * reader enters it.
+ */
+
+struct file_readahead_s
+{
+  struct work_s ra_work;   /* Work running the prefetch */
+  struct file   ra_file;   /* Private open of the file for the worker */
+  mutex_t       ra_lock;   /* Protects the fields below */
+  off_t         ra_next;   /* Position of the next sequential read */
+  off_t         ra_start;  /* Start of the last window issued */
+  off_t         ra_end;    /* End of the last window issued */
+  size_t        ra_size;   /* Size of the last window, 0 if not streaming */
+  bool          ra_busy;   /* The worker is queued or running */
+  bool          ra_eof;    /* The worker reached the end of the file */
+  FAR void     *ra_buffer; /* Scratch the worker reads into */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readahead_worker
+ *
+ * Description:
+ *   Read one window from the private open of the file.  The data is
+ *   dropped, what is kept is the block driver sectors left in the page
+ *   cache for the following reads of the application.
+ *
+ ****************************************************************************/
+
+static void file_readahead_worker(FAR void *arg)
+{
+  FAR struct file_readahead_s *ra = arg;
+  FAR struct file *filep = &ra->ra_file;
+  ssize_t nread = -EINVAL;
+  off_t pos;
+  size_t size;
+
+  nxmutex_lock(&ra->ra_lock);
+  pos  = ra->ra_start;
+  size = ra->ra_size;
+  nxmutex_unlock(&ra->ra_lock);
+
+  if (file_seek(filep, pos, SEEK_SET) == pos)
+    {
+      nread = filep->f_inode->u.i_ops->read(filep, ra->ra_buffer, size);
+    }
+
+  nxmutex_lock(&ra->ra_lock);
+  ra->ra_eof  = nread < (ssize_t)size;
+  ra->ra_busy = false;
+  nxmutex_unlock(&ra->ra_lock);
+}
+
+/****************************************************************************
+ * Name: file_readahead_issue
+ *
+ * Description:
+ *   Queue the prefetch of the window [pos, pos + size).
+ *
+ * Assumptions:
+ *   The caller holds ra_lock and the worker is idle.
+ *
+ ****************************************************************************/
+
+static void file_readahead_issue(FAR struct file_readahead_s *ra,
+                                 off_t pos, size_t size)
+{
+  size = MIN(size, CONFIG_FS_READAHEAD_MAX);
+
+  ra->ra_start = pos;
+  ra->ra_end   = pos + size;
+  ra->ra_size  = size;
+  ra->ra_busy  = work_queue(LPWORK, &ra->ra_work, file_readahead_worker,
+                            ra, 0) >= 0;
+}
+
+/****************************************************************************
+ * Name: file_readahead_start
+ *
+ * Description:
+ *   Set up the worker resources on the first sequential read.  A private
+ *   open is used so that the worker never moves the file position of the
+ *   application.
+ *
+ ****************************************************************************/
+
+static int file_readahead_start(FAR struct file *filep,
+                                FAR struct file_readahead_s *ra)
+{
+  int ret;
+
+  ra->ra_buffer = kmm_malloc(CONFIG_FS_READAHEAD_MAX);
+  if (ra->ra_buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = file_dup2(filep, &ra->ra_file);
+  if (ret < 0)
+    {
+      kmm_free(ra->ra_buffer);
+      ra->ra_buffer = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readahead
+ *
+ * Description:
+ *   Account for a read of nread bytes at pos.  The second consecutive read
+ *   of a file starts the readahead with a window of CONFIG_FS_READAHEAD_MIN
+ *   bytes, the window doubles every time the reader catches up with it
+ *   until it reaches CONFIG_FS_READAHEAD_MAX bytes, and a read anywhere
+ *   else stops the readahead until the access is sequential again.
+ *
+ * Input Parameters:
+ *   filep - The file that was read
+ *   pos   - The file position of the read
+ *   nread - The number of bytes read
+ *
+ ****************************************************************************/
+
+void file_readahead(FAR struct file *filep, off_t pos, size_t nread)
+{
+  FAR struct file_readahead_s *ra = filep->f_ra;
+  off_t next = pos + nread;
+
+  if (ra == NULL)
+    {
+      /* Nothing to do until the next read shows whether this is a stream */
+
+      ra = kmm_zalloc(sizeof(struct file_readahead_s));
+      if (ra != NULL)
+        {
+          nxmutex_init(&ra->ra_lock);
+          ra->ra_next = next;
+          filep->f_ra = ra;
+        }
+
+      return;
+    }
+
+  nxmutex_lock(&ra->ra_lock);
+
+  if (pos != ra->ra_next)
+    {
+      ra->ra_size = 0;
+      ra->ra_eof  = false;
+    }
+  else if (!ra->ra_busy && !ra->ra_eof)
+    {
+      if (ra->ra_size == 0)
+        {
+          if (ra->ra_buffer != NULL ||
+              file_readahead_start(filep, ra) >= 0)
+            {
+              file_readahead_issue(ra, next, CONFIG_FS_READAHEAD_MIN);
+            }
+        }
+      else if (next > ra->ra_start)
+        {
+          /* The reader entered the last window, issue the next one.  If
+           * the reader ran past it, the readahead restarts in front of
+           * the reader.
+           */
+
+          file_readahead_issue(ra, MAX(next, ra->ra_end), ra->ra_size * 2);
+        }
+    }
+
+  ra->ra_next = next;
+  nxmutex_unlock(&ra->ra_lock);
+}
+
+/****************************************************************************
+ * Name: file_readahead_release
+ *
+ * Description:
+ *   Stop the readahead of a file being closed and free its state.
+ *
+ * Input Parameters:
+ *   filep - The file being closed
+ *
+ ****************************************************************************/
+
+void file_readahead_release(FAR struct file *filep)
+{
+  FAR struct file_readahead_s *ra = filep->f_ra;
+
+  if (ra != NULL)
+    {
+      filep->f_ra = NULL;
+      work_cancel_sync(LPWORK, &ra->ra_work);
+
+      if (ra->ra_buffer != NULL)
+        {
+          file_close(&ra->ra_file);
+          kmm_free(ra->ra_buffer);
+        }
+
+      nxmutex_destroy(&ra->ra_lock);
+      kmm_free(ra);
+    }
+}
@@ -0,0 +1,319 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_is_pipe
+ *
+ * Description:
+ *   Return true if the file is a pipe or a FIFO.  Only the pipe drivers
+ *   implement the PIPEIOC commands.
+ *
+ ****************************************************************************/
+
+static bool file_is_pipe(FAR struct file *filep)
+{
+  return file_ioctl(filep, PIPEIOC_GETSIZE) > 0;
+}
+
+/****************************************************************************
+ * Name: file_pipe_splice
+ ****************************************************************************/
+
+static ssize_t file_pipe_splice(FAR struct file *pipe,
+                                FAR struct file *filep, FAR off_t *offset,
+                                size_t len, unsigned int flags,
+                                bool write, bool keep)
+{
+  struct pipe_splice_s splice;
+
+  splice.file   = filep;
+  splice.offset = offset;
+  splice.len    = MIN(len, INT_MAX);
+  splice.flags  = flags;
+  splice.write  = write;
+  splice.keep   = keep;
+
+  return file_ioctl(pipe, PIPEIOC_SPLICE, (unsigned long)(uintptr_t)&splice);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags)
+{
+  if (file_is_pipe(infile))
+    {
+      if (inoff != NULL)
+        {
+          return -ESPIPE;
+        }
+
+      return file_pipe_splice(infile, outfile, outoff, len, flags,
+                              false, false);
+    }
+
+  if (file_is_pipe(outfile))
+    {
+      if (outoff != NULL)
+        {
+          return -ESPIPE;
+        }
+
+      return file_pipe_splice(outfile, infile, inoff, len, flags,
+                              true, false);
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee function except that is accepts struct
+ *   file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags)
+{
+  if (!file_is_pipe(infile) || !file_is_pipe(outfile))
+    {
+      return -EINVAL;
+    }
+
+  return file_pipe_splice(infile, outfile, NULL, len, flags, false, true);
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between a pipe and another file descriptor, which
+ *   may be a pipe, a socket or a regular file.  The data goes straight
+ *   between the pipe buffer and the other file, it is not copied through
+ *   the user memory.
+ *
+ *   NOTE: This interface is not specified by POSIX, it follows the Linux
+ *   splice interface.
+ *
+ * Input Parameters:
+ *   fd_in   - The descriptor the data is read from
+ *   off_in  - NULL to read from the current position of fd_in, otherwise
+ *             the offset to read from, updated on return.  Must be NULL
+ *             if fd_in is a pipe.
+ *   fd_out  - The descriptor the data is written to
+ *   off_out - NULL to write at the current position of fd_out, otherwise
+ *             the offset to write at, updated on return.  Must be NULL
+ *             if fd_out is a pipe.
+ *   len     - The maximum number of bytes to move
+ *   flags   - SPLICE_F_* flags.  Only SPLICE_F_NONBLOCK has an effect, it
+ *             makes the pipe operations non-blocking.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at the end of the input.  On error, -1
+ *   is returned, and errno is set appropriately:
+ *
+ *   EINVAL - Neither descriptor is a pipe, or both refer to the same pipe
+ *   ESPIPE - An offset was given for a pipe
+ *   EAGAIN - SPLICE_F_NONBLOCK was given and the pipe would block
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out,
+               size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = file_get(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_get(fd_out, &outfile);
+  if (ret < 0)
+    {
+      file_put(infile);
+      goto errout;
+    }
+
+  ret = file_splice(infile, off_in, outfile, off_out, len, flags);
+  file_put(outfile);
+  file_put(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() duplicates up to len bytes of the pipe fd_in into the pipe
+ *   fd_out without consuming them, so that they can still be spliced
+ *   elsewhere.
+ *
+ *   NOTE: This interface is not specified by POSIX, it follows the Linux
+ *   tee interface.
+ *
+ * Returned Value:
+ *   The number of bytes duplicated, zero if fd_in has no writer left.  On
+ *   error, -1 is returned, and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = file_get(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_get(fd_out, &outfile);
+  if (ret < 0)
+    {
+      file_put(infile);
+      goto errout;
+    }
+
+  ret = file_tee(infile, outfile, len, flags);
+  file_put(outfile);
+  file_put(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: vmsplice
+ *
+ * Description:
+ *   vmsplice() moves the user memory described by iov into the pipe fd if
+ *   it is open for writing, or the data of the pipe into the user memory if
+ *   it is open for reading.  The pipe buffer is a byte ring, so the pages
+ *   cannot be gifted: the data is copied once, like writev() or readv()
+ *   would.  The flags are hints, the pipe blocks according to its own
+ *   O_NONBLOCK setting.
+ *
+ *   NOTE: This interface is not specified by POSIX, it follows the Linux
+ *   vmsplice interface.
+ *
+ * Returned Value:
+ *   The number of bytes moved.  On error, -1 is returned, and errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nr_segs,
+                 unsigned int flags)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  ret = file_get(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!file_is_pipe(filep) || nr_segs > IOV_MAX)
+    {
+      ret = -EINVAL;
+    }
+  else if ((filep->f_oflags & O_WROK) != 0)
+    {
+      ret = file_writev(filep, iov, nr_segs);
+    }
+  else
+    {
+      ret = file_readv(filep, iov, nr_segs);
+    }
+
+  file_put(filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
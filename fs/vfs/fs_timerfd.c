@@ -48,6 +48,14 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* A timer keeps the slack of the thread that armed it */
+
+#ifdef CONFIG_WDOG_TIMER_SLACK
+#  define TIMERFD_SLACK(dev) ((dev)->slack)
+#else
+#  define TIMERFD_SLACK(dev) 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -68,6 +76,9 @@ struct timerfd_priv_s
   clock_t                   delay;   /* If non-zero, used to reset repetitive
                                       * timers */
   struct wdog_s             wdog;    /* The watchdog that provides the timing */
+#ifdef CONFIG_WDOG_TIMER_SLACK
+  clock_t                   slack;   /* Timer slack of the arming thread */
+#endif
   timerfd_t                 counter; /* timerfd counter */
   uint8_t                   crefs;   /* References counts on timerfd (max: 255) */
 
@@ -406,7 +417,8 @@ static void timerfd_timeout(wdparm_t arg)
 
   if (dev->delay > 0u)
     {
-      wd_start(&dev->wdog, dev->delay, timerfd_timeout, arg);
+      wd_start_slack(&dev->wdog, dev->delay, TIMERFD_SLACK(dev),
+                     timerfd_timeout, arg);
     }
 
 #ifdef CONFIG_TIMER_FD_POLL
@@ -601,7 +613,12 @@ int timerfd_settime(int fd, int flags,
 
   /* Then start the watchdog */
 
-  ret = wd_start(&dev->wdog, delay, timerfd_timeout, (wdparm_t)dev);
+#ifdef CONFIG_WDOG_TIMER_SLACK
+  dev->slack = wd_task_slack();
+#endif
+
+  ret = wd_start_slack(&dev->wdog, delay, TIMERFD_SLACK(dev),
+                       timerfd_timeout, (wdparm_t)dev);
   if (ret < 0)
     {
       leave_critical_section(intflags);
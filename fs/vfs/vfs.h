@@ -107,6 +107,14 @@ int file_setlk(FAR struct file *filep, FAR struct flock *flock,
 
 #endif /* CONFIG_FS_LOCK_BUCKET_SIZE */
 
+#ifdef CONFIG_FS_READAHEAD
+void file_readahead(FAR struct file *filep, off_t pos, size_t nread);
+void file_readahead_release(FAR struct file *filep);
+#else
+#  define file_readahead(filep, pos, nread)
+#  define file_readahead_release(filep)
+#endif
+
 #ifdef CONFIG_FS_NOTIFY
 void notify_open(FAR const char *path, int oflags);
 void notify_close(FAR const char *path, int oflags);
@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <search.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -34,6 +35,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/lib/lib.h>
 
 #include <unzip.h>
 
@@ -51,8 +53,20 @@ struct zipfs_dir_s
   bool last;
 };
 
+#ifdef CONFIG_ZIPFS_INDEX
+struct zipfs_entry_s
+{
+  unz64_file_pos pos;           /* Position in the central directory */
+  ZPOS64_T size;                /* Uncompressed size */
+  char name[1];                 /* Entry name, also the hash key */
+};
+#endif
+
 struct zipfs_mountpt_s
 {
+#ifdef CONFIG_ZIPFS_INDEX
+  struct hsearch_data index;    /* Entry name -> struct zipfs_entry_s */
+#endif
   char abspath[1];
 };
 
@@ -243,6 +257,141 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+#ifdef CONFIG_ZIPFS_INDEX
+static void zipfs_free_entry(FAR ENTRY *entry)
+{
+  /* The key points into the entry itself */
+
+  fs_heap_free(entry->data);
+}
+
+static FAR struct zipfs_entry_s *
+zipfs_find_entry(FAR struct zipfs_mountpt_s *fs, FAR const char *relpath)
+{
+  FAR ENTRY *result;
+  ENTRY item;
+
+  item.key  = (FAR char *)relpath;
+  item.data = NULL;
+
+  if (hsearch_r(item, FIND, &result, &fs->index) == 0)
+    {
+      return NULL;
+    }
+
+  return result->data;
+}
+
+static int zipfs_build_index(FAR struct zipfs_mountpt_s *fs, unzFile uf)
+{
+  FAR struct zipfs_entry_s *entry;
+  unz_global_info64 global_info;
+  unz_file_info64 file_info;
+  FAR ENTRY *result;
+  FAR char *name;
+  ENTRY item;
+  int ret;
+
+  ret = zipfs_convert_result(unzGetGlobalInfo64(uf, &global_info));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  fs->index.free_entry = zipfs_free_entry;
+  if (hcreate_r(global_info.number_entry, &fs->index) == 0)
+    {
+      return -ENOMEM;
+    }
+
+  name = lib_get_pathbuffer();
+  if (name == NULL)
+    {
+      hdestroy_r(&fs->index);
+      return -ENOMEM;
+    }
+
+  ret = zipfs_convert_result(unzGoToFirstFile(uf));
+  while (ret == OK)
+    {
+      ret = unzGetCurrentFileInfo64(uf, &file_info, name, PATH_MAX,
+                                    NULL, 0, NULL, 0);
+      ret = zipfs_convert_result(ret);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* Names that do not fit in a path can never be opened anyway */
+
+      if (file_info.size_filename < PATH_MAX)
+        {
+          entry = fs_heap_malloc(sizeof(*entry) + file_info.size_filename);
+          if (entry == NULL)
+            {
+              ret = -ENOMEM;
+              break;
+            }
+
+          ret = zipfs_convert_result(unzGetFilePos64(uf, &entry->pos));
+          if (ret < 0)
+            {
+              fs_heap_free(entry);
+              break;
+            }
+
+          entry->size = file_info.uncompressed_size;
+          strcpy(entry->name, name);
+
+          item.key  = entry->name;
+          item.data = entry;
+          if (hsearch_r(item, ENTER, &result, &fs->index) == 0)
+            {
+              fs_heap_free(entry);
+              ret = -ENOMEM;
+              break;
+            }
+
+          /* Keep the first of duplicated names, as unzLocateFile does */
+
+          if (result->data != entry)
+            {
+              fs_heap_free(entry);
+            }
+        }
+
+      ret = zipfs_convert_result(unzGoToNextFile(uf));
+    }
+
+  lib_put_pathbuffer(name);
+  if (ret == -ENOENT)
+    {
+      return OK;
+    }
+
+  hdestroy_r(&fs->index);
+  return ret;
+}
+#endif
+
+static int zipfs_locate(FAR struct zipfs_mountpt_s *fs, unzFile uf,
+                        FAR const char *relpath)
+{
+#ifdef CONFIG_ZIPFS_INDEX
+  FAR struct zipfs_entry_s *entry;
+
+  entry = zipfs_find_entry(fs, relpath);
+  if (entry == NULL)
+    {
+      return -ENOENT;
+    }
+
+  return zipfs_convert_result(unzGoToFilePos64(uf, &entry->pos));
+#else
+  return zipfs_convert_result(unzLocateFile(uf, relpath, 0));
+#endif
+}
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -271,7 +420,7 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_mutex;
     }
 
-  ret = zipfs_convert_result(unzLocateFile(fp->uf, relpath, 0));
+  ret = zipfs_locate(fs, fp->uf, relpath);
   if (ret < 0)
     {
       goto err_with_zip;
@@ -369,7 +518,6 @@ static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
 static off_t zipfs_seek(FAR struct file *filep, off_t offset,
                         int whence)
 {
-  FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
   FAR struct zipfs_file_s *fp = filep->f_priv;
   unz_file_info64 file_info;
   off_t ret = 0;
@@ -404,25 +552,12 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
     }
   else if (filep->f_pos > offset)
     {
-      ret = zipfs_convert_result(unzClose(fp->uf));
-      if (ret < 0)
-        {
-          goto err_with_lock;
-        }
-
-      fp->uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
-      if (fp->uf == NULL)
-        {
-          ret = -EINVAL;
-          goto err_with_lock;
-        }
-
-      ret = zipfs_convert_result(unzLocateFile(fp->uf, fp->relpath, 0));
-      if (ret < 0)
-        {
-          goto err_with_lock;
-        }
+      /* Restart the inflate stream of the current entry.  The archive
+       * stays open and positioned, so no directory lookup is needed.
+       * A CRC error on close is ignored as unzClose() would.
+       */
 
+      unzCloseCurrentFile(fp->uf);
       ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
       if (ret < 0)
         {
@@ -584,6 +719,9 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 {
   FAR struct zipfs_mountpt_s *fs;
   unzFile uf;
+#ifdef CONFIG_ZIPFS_INDEX
+  int ret;
+#endif
 
   if (data == NULL)
     {
@@ -603,6 +741,16 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
       return -EINVAL;
     }
 
+#ifdef CONFIG_ZIPFS_INDEX
+  ret = zipfs_build_index(fs, uf);
+  if (ret < 0)
+    {
+      unzClose(uf);
+      fs_heap_free(fs);
+      return ret;
+    }
+#endif
+
   unzClose(uf);
   strcpy(fs->abspath, data);
   *handle = fs;
@@ -613,6 +761,12 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 static int zipfs_unbind(FAR void *handle, FAR struct inode **driver,
                         unsigned int flags)
 {
+#ifdef CONFIG_ZIPFS_INDEX
+  FAR struct zipfs_mountpt_s *fs = handle;
+
+  hdestroy_r(&fs->index);
+#endif
+
   fs_heap_free(handle);
   return OK;
 }
@@ -628,8 +782,12 @@ static int zipfs_stat(FAR struct inode *mountpt,
                       FAR const char *relpath, FAR struct stat *buf)
 {
   FAR struct zipfs_mountpt_s *fs;
+#ifdef CONFIG_ZIPFS_INDEX
+  FAR struct zipfs_entry_s *entry;
+#else
   unzFile uf;
   int ret;
+#endif
 
   /* Sanity checks */
 
@@ -642,13 +800,28 @@ static int zipfs_stat(FAR struct inode *mountpt,
     }
 
   fs = mountpt->i_private;
+
+#ifdef CONFIG_ZIPFS_INDEX
+  /* Everything stat() reports is already in the index */
+
+  entry = zipfs_find_entry(fs, relpath);
+  if (entry == NULL)
+    {
+      return -ENOENT;
+    }
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_size = entry->size;
+  buf->st_mode = S_IFREG | 0444;
+  return OK;
+#else
   uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
   if (uf == NULL)
     {
       return -EINVAL;
     }
 
-  ret = zipfs_convert_result(unzLocateFile(uf, relpath, 0));
+  ret = zipfs_locate(fs, uf, relpath);
   if (ret < 0)
     {
       unzClose(uf);
@@ -659,4 +832,5 @@ static int zipfs_stat(FAR struct inode *mountpt,
 
   unzClose(uf);
   return ret;
+#endif
 }
@@ -41,6 +41,12 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The 2D acceleration hooks are only offered by framebuffer drivers */
+
+#if defined(CONFIG_FB_ACCEL) && !defined(CONFIG_NX_LCDDRIVER)
+#  define NXBE_HAVE_ACCEL 1
+#endif
+
 /* These are the values for the clipping order provided to nx_clipper */
 
 #define NX_CLIPORDER_TLRB    (0)   /* Top-left-right-bottom */
@@ -173,6 +179,14 @@ struct nxbe_plane_s
   struct nxbe_cursorops_s cursor;
 #endif
 
+#ifdef NXBE_HAVE_ACCEL
+  /* Software raster operations replaced by the accelerated ones in dev */
+
+  struct nxbe_dev_vtable_s cpu;
+  uint8_t planeno;                  /* Index of the plane in the driver */
+  uint8_t fmt;                      /* Video format of the plane */
+#endif
+
   /* Framebuffer plane info describing destination video plane */
 
   NX_DRIVERTYPE *driver;
@@ -325,6 +339,24 @@ void nxbe_notify_rectangle(FAR NX_DRIVERTYPE *dev,
 
 int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be);
 
+#ifdef NXBE_HAVE_ACCEL
+/****************************************************************************
+ * Name: nxbe_accel_configure
+ *
+ * Description:
+ *   Route the fill and copy raster operations of a color plane to the 2D
+ *   engine of the framebuffer driver, keeping the software rasterizers
+ *   selected by nxbe_configure() as the fallback.
+ *
+ * Input Parameters:
+ *   be      - The back-end state structure instance
+ *   planeno - The color plane being configured
+ *
+ ****************************************************************************/
+
+void nxbe_accel_configure(FAR struct nxbe_state_s *be, int planeno);
+#endif
+
 #if defined(CONFIG_NX_SWCURSOR) || defined(CONFIG_NX_HWCURSOR)
 /****************************************************************************
  * Name: nxbe_cursor_enable
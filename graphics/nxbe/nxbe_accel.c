@@ -0,0 +1,156 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_accel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/video/fb.h>
+
+#include "nxbe.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_accel_area
+ *
+ * Description:
+ *   Convert an NX rectangle, whose corners are both inclusive, to a
+ *   framebuffer area.
+ *
+ ****************************************************************************/
+
+static inline void nxbe_accel_area(FAR const struct nxgl_rect_s *rect,
+                                   FAR struct fb_area_s *area)
+{
+  area->x = rect->pt1.x;
+  area->y = rect->pt1.y;
+  area->w = rect->pt2.x - rect->pt1.x + 1;
+  area->h = rect->pt2.y - rect->pt1.y + 1;
+}
+
+/****************************************************************************
+ * Name: nxbe_accel_fillrectangle
+ *
+ * Description:
+ *   Fill a rectangle of a color plane with the 2D engine, or with the
+ *   software rasterizer if the engine refuses it.
+ *
+ ****************************************************************************/
+
+static void nxbe_accel_fillrectangle(FAR struct fb_planeinfo_s *pinfo,
+                                     FAR const struct nxgl_rect_s *rect,
+                                     nxgl_mxpixel_t color)
+{
+  FAR struct nxbe_plane_s *plane =
+    container_of(pinfo, struct nxbe_plane_s, pinfo);
+  FAR struct fb_vtable_s *dev = plane->driver;
+  struct fb_area_s area;
+
+  nxbe_accel_area(rect, &area);
+  if (dev->fillarea(dev, plane->planeno, &area, color) < 0)
+    {
+      plane->cpu.fillrectangle(pinfo, rect, color);
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_accel_copyrectangle
+ *
+ * Description:
+ *   Copy a part of an image to a rectangle of a color plane with the 2D
+ *   engine, or with the software rasterizer if the engine refuses it.
+ *
+ ****************************************************************************/
+
+static void nxbe_accel_copyrectangle(FAR struct fb_planeinfo_s *pinfo,
+                                     FAR const struct nxgl_rect_s *dest,
+                                     FAR const void *src,
+                                     FAR const struct nxgl_point_s *origin,
+                                     unsigned int srcstride)
+{
+  FAR struct nxbe_plane_s *plane =
+    container_of(pinfo, struct nxbe_plane_s, pinfo);
+  FAR struct fb_vtable_s *dev = plane->driver;
+  FAR const uint8_t *sline;
+  struct fb_area_s area;
+
+  /* The image starts at origin, find the first pixel that lands on dest */
+
+  sline = (FAR const uint8_t *)src +
+          (dest->pt1.y - origin->y) * srcstride +
+          (((dest->pt1.x - origin->x) * pinfo->bpp) >> 3);
+
+  nxbe_accel_area(dest, &area);
+  if (dev->copyarea(dev, plane->planeno, &area, sline, srcstride,
+                    plane->fmt) < 0)
+    {
+      plane->cpu.copyrectangle(pinfo, dest, src, origin, srcstride);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_accel_configure
+ *
+ * Description:
+ *   Route the fill and copy raster operations of a color plane to the 2D
+ *   engine of the framebuffer driver, keeping the software rasterizers
+ *   selected by nxbe_configure() as the fallback.
+ *
+ * Input Parameters:
+ *   be      - The back-end state structure instance
+ *   planeno - The color plane being configured
+ *
+ ****************************************************************************/
+
+void nxbe_accel_configure(FAR struct nxbe_state_s *be, int planeno)
+{
+  FAR struct nxbe_plane_s *plane = &be->plane[planeno];
+  FAR struct fb_vtable_s *dev = plane->driver;
+
+  plane->cpu     = plane->dev;
+  plane->planeno = planeno;
+  plane->fmt     = be->vinfo.fmt;
+
+  if (dev->fillarea != NULL)
+    {
+      plane->dev.fillrectangle = nxbe_accel_fillrectangle;
+    }
+
+  /* Images of less than a byte per pixel may not start on a byte boundary
+   * and are left to the software rasterizer.
+   */
+
+  if (dev->copyarea != NULL && plane->pinfo.bpp >= 8)
+    {
+      plane->dev.copyrectangle = nxbe_accel_copyrectangle;
+    }
+}
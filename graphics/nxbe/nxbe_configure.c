@@ -292,6 +292,10 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
                i, be->plane[i].pinfo.bpp);
           return -ENOSYS;
         }
+
+#ifdef NXBE_HAVE_ACCEL
+      nxbe_accel_configure(be, i);
+#endif
     }
 
   return OK;
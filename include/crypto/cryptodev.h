@@ -418,6 +418,19 @@ struct crypt_op
   caddr_t aad;
 };
 
+/* ioctl parameter to run several crypt_op with one CIOCNCRYPTM call.
+ * With status set every request is run and its result, zero or a negated
+ * errno, is stored in status[i].  Without status the requests stop at
+ * the first failure.  The call itself returns the first failure, if any.
+ */
+
+struct crypt_mop
+{
+  unsigned int count;         /* Number of requests */
+  FAR struct crypt_op *reqs;  /* The requests */
+  FAR int *status;            /* Optional, returns: result of each request */
+};
+
 /* hamc buffer, software & hardware need it */
 
 extern const uint8_t hmac_ipad_buffer[HMAC_MAX_BLOCK_LEN];
@@ -439,6 +452,7 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEY                 104
 #define CIOCKEYRET              105
 #define CIOCASYMFEAT            106
+#define CIOCNCRYPTM             107
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
@@ -64,4 +64,15 @@ void rijndael_encrypt1(const unsigned int [],
                        const unsigned char [],
                        unsigned char []);
 
+/* Architecture accelerated block functions, the key schedules are in
+ * memory byte order.
+ */
+
+#ifdef CONFIG_CRYPTO_ARCH_AES
+void rijndael_arch_encrypt(FAR const uint32_t *, int,
+                           FAR const uint8_t *, FAR uint8_t *);
+void rijndael_arch_decrypt(FAR const uint32_t *, int,
+                           FAR const uint8_t *, FAR uint8_t *);
+#endif
+
 #endif /* __INCLUDE_CRYPTO_RIJNDAEL_H */
@@ -78,6 +78,15 @@ void sha256init(FAR SHA2_CTX *);
 void sha256update(FAR SHA2_CTX *, FAR const void *, size_t);
 void sha256final(FAR uint8_t *, FAR SHA2_CTX *);
 
+/* Architecture accelerated SHA-256 block function, k is the table of the
+ * 64 round constants.
+ */
+
+#ifdef CONFIG_CRYPTO_ARCH_SHA256
+void sha256_arch_transform(FAR uint32_t *, FAR const uint8_t *,
+                           FAR const uint32_t *);
+#endif
+
 void sha384init(FAR SHA2_CTX *);
 void sha384update(FAR SHA2_CTX *, FAR const void *, size_t);
 void sha384final(FAR uint8_t *, FAR SHA2_CTX *);
@@ -459,6 +459,40 @@ struct avg_filter_data_s
   float k;             /* k counter */
 };
 
+/* Second order IIR section (biquad), direct form II transposed:
+ *
+ *   y(n)  = b0*x(n) + z1
+ *   z1    = b1*x(n) - a1*y(n) + z2
+ *   z2    = b2*x(n) - a2*y(n)
+ *
+ * The a0 coefficient is assumed to be normalized to 1.
+ */
+
+struct biquad_f32_s
+{
+  float b0;            /* Feed-forward coefficients */
+  float b1;
+  float b2;
+  float a1;            /* Feedback coefficients (a0 = 1) */
+  float a2;
+  float z1;            /* Filter state */
+  float z2;
+};
+
+/* FIR filter.  The caller provides the coefficients and a delay line of
+ * 2 * ntaps samples.  Every sample is stored twice so that the dot product
+ * always runs over contiguous memory, which lets the compiler keep it in a
+ * single (vectorizable) multiply-accumulate loop.
+ */
+
+struct fir_f32_s
+{
+  FAR const float *coef;  /* ntaps coefficients, coef[0] for newest sample */
+  FAR float       *state; /* Delay line of 2 * ntaps samples */
+  uint16_t         ntaps; /* Number of taps */
+  uint16_t         pos;   /* Position of the newest sample */
+};
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -619,6 +653,24 @@ void avg_filter_data_init(FAR struct avg_filter_data_s *data,
                           float prev_avg, float k);
 float avg_filter(FAR struct avg_filter_data_s *data, float x);
 
+/* Biquad filter */
+
+void biquad_init(FAR struct biquad_f32_s *bq, float b0, float b1, float b2,
+                 float a1, float a2);
+void biquad_reset(FAR struct biquad_f32_s *bq);
+float biquad_filter(FAR struct biquad_f32_s *bq, float x);
+void biquad_filter_block(FAR struct biquad_f32_s *bq, FAR const float *in,
+                         FAR float *out, size_t n);
+
+/* FIR filter */
+
+void fir_init(FAR struct fir_f32_s *fir, FAR const float *coef,
+              FAR float *state, uint16_t ntaps);
+void fir_reset(FAR struct fir_f32_s *fir);
+float fir_filter(FAR struct fir_f32_s *fir, float x);
+void fir_filter_block(FAR struct fir_f32_s *fir, FAR const float *in,
+                      FAR float *out, size_t n);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
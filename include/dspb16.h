@@ -107,6 +107,24 @@
 
 #define LP_FILTER_B16(val, sample, filter) val -= (b16mulb16(filter, (val - sample)))
 
+/****************************************************************************
+ * Name: B16MAC2
+ *
+ * Description:
+ *   Sum of two b16 products, a*b + c*d, accumulated at full precision and
+ *   rounded once.  With 64-bit support this maps onto a single
+ *   multiply-accumulate long pair (SMULL + SMLAL on ARM) instead of two
+ *   separately shifted products.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HAVE_LONG_LONG
+#  define B16MAC2(a, b, c, d) \
+     b32tob16((b32_t)(a) * (b32_t)(b) + (b32_t)(c) * (b32_t)(d))
+#else
+#  define B16MAC2(a, b, c, d) (b16mulb16(a, b) + b16mulb16(c, d))
+#endif
+
 /****************************************************************************
  * Name: SVM3_BASE_VOLTAGE_GET_B16
  *
@@ -441,6 +459,36 @@ struct pmsm_model_b16_s
   b16_t                         iq_int; /* Iq integral part */
 };
 
+/* Second order IIR section (biquad), direct form I.  Direct form I keeps
+ * the whole section in one wide accumulator so that there is a single
+ * rounding per output sample.  The a0 coefficient is assumed to be 1.
+ */
+
+struct biquad_b16_s
+{
+  b16_t b0;            /* Feed-forward coefficients */
+  b16_t b1;
+  b16_t b2;
+  b16_t a1;            /* Feedback coefficients (a0 = 1) */
+  b16_t a2;
+  b16_t x1;            /* Filter state */
+  b16_t x2;
+  b16_t y1;
+  b16_t y2;
+};
+
+/* FIR filter.  The caller provides the coefficients and a delay line of
+ * 2 * ntaps samples, see struct fir_f32_s.
+ */
+
+struct fir_b16_s
+{
+  FAR const b16_t *coef;  /* ntaps coefficients, coef[0] for newest sample */
+  FAR b16_t       *state; /* Delay line of 2 * ntaps samples */
+  uint16_t         ntaps; /* Number of taps */
+  uint16_t         pos;   /* Position of the newest sample */
+};
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -600,6 +648,24 @@ int pmsm_model_elec_b16(FAR struct pmsm_model_b16_s *model,
                         FAR ab_frame_b16_t *vab);
 int pmsm_model_mech_b16(FAR struct pmsm_model_b16_s *model, b16_t load);
 
+/* Biquad filter */
+
+void biquad_init_b16(FAR struct biquad_b16_s *bq, b16_t b0, b16_t b1,
+                     b16_t b2, b16_t a1, b16_t a2);
+void biquad_reset_b16(FAR struct biquad_b16_s *bq);
+b16_t biquad_filter_b16(FAR struct biquad_b16_s *bq, b16_t x);
+void biquad_filter_block_b16(FAR struct biquad_b16_s *bq,
+                             FAR const b16_t *in, FAR b16_t *out, size_t n);
+
+/* FIR filter */
+
+void fir_init_b16(FAR struct fir_b16_s *fir, FAR const b16_t *coef,
+                  FAR b16_t *state, uint16_t ntaps);
+void fir_reset_b16(FAR struct fir_b16_s *fir);
+b16_t fir_filter_b16(FAR struct fir_b16_s *fir, b16_t x);
+void fir_filter_block_b16(FAR struct fir_b16_s *fir, FAR const b16_t *in,
+                          FAR b16_t *out, size_t n);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -160,6 +160,13 @@
 #define F_SEAL_WRITE        0x0008 /* Prevent writes */
 #define F_SEAL_FUTURE_WRITE 0x0010 /* Prevent future writes while mapped */
 
+/* splice(), tee() and vmsplice() flags */
+
+#define SPLICE_F_MOVE       0x0001 /* Move rather than copy (a hint) */
+#define SPLICE_F_NONBLOCK   0x0002 /* Do not block on the pipe */
+#define SPLICE_F_MORE       0x0004 /* More data will follow (a hint) */
+#define SPLICE_F_GIFT       0x0008 /* The user pages are gifted (a hint) */
+
 #if defined(CONFIG_FS_LARGEFILE)
 #  define F_GETLK64         F_GETLK
 #  define F_SETLK64         F_SETLK
@@ -180,6 +187,8 @@
 
 /* struct flock is the third argument for F_GETLK, F_SETLK and F_SETLKW */
 
+struct iovec;
+
 struct flock
 {
   int16_t l_type;    /* Type of lock: F_RDLCK, F_WRLCK, F_UNLCK */
@@ -215,6 +224,12 @@ int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out,
+               size_t len, unsigned int flags);
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nr_segs,
+                 unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
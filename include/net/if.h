@@ -327,6 +327,7 @@ struct ifreq
 #define ifr_metric            ifr_ifru.ifru_ivalue           /* metric */
 #define ifr_bandwidth         ifr_ifru.ifru_ivalue           /* link bandwidth */
 #define ifr_qlen              ifr_ifru.ifru_ivalue           /* Queue length */
+#define ifr_budget            ifr_ifru.ifru_ivalue           /* RX poll budget */
 #define ifr_mtu               ifr_ifru.ifru_mtu              /* MTU */
 #define ifr_count             ifr_ifru.ifru_count            /* Number of devices */
 #define ifr_flags             ifr_ifru.ifru_flags            /* interface flags */
@@ -59,4 +59,12 @@
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 #define TCP_CORK      (__SO_PROTOCOL + 5) /* Coalescing of small segments */
 
+/* Congestion control algorithm, argument: name string */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 6)
+
+/* The maximum length of the name of a congestion control algorithm */
+
+#define TCP_CA_NAME_MAX 16
+
 #endif /* __INCLUDE_NETINET_TCP_H */
@@ -33,6 +33,15 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* UDP protocol (SOL_UDP) socket options */
+
+#define UDP_SEGMENT   103  /* Send the data as the datagrams of this size.
+                            * Argument: int, 0 to disable. Also accepted as
+                            * a uint16_t control message on send */
+#define UDP_GRO       104  /* Coalesce the received datagrams of the same
+                            * sender and size.  Argument: int, the segment
+                            * size is reported in an int control message */
+
 /* UDP header as specified by RFC 768, August 1980. */
 
 struct udphdr
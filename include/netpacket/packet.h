@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/compiler.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -49,8 +50,45 @@
 #define PACKET_ADD_MEMBERSHIP  1 /* Add a multicast address to the interface */
 #define PACKET_DROP_MEMBERSHIP 2 /* Drop a multicast address from the interface */
 
+#define PACKET_RX_RING         5  /* Map a receive ring into the process */
+#define PACKET_VERSION         10 /* Select the format of the ring */
+#define PACKET_TX_RING         13 /* Map a transmit ring into the process */
+
 #define PACKET_MR_MULTICAST    0 /* Multicast address */
 
+/* Formats of the mapped rings, only the block ring of TPACKET_V3 is
+ * supported.
+ */
+
+#define TPACKET_V1             0
+#define TPACKET_V2             1
+#define TPACKET_V3             2
+
+/* Status of the receive blocks and of the packets in them */
+
+#define TP_STATUS_KERNEL       0        /* Owned by the kernel */
+#define TP_STATUS_USER         (1 << 0) /* Owned by the application */
+#define TP_STATUS_COPY         (1 << 1) /* The packet is truncated */
+#define TP_STATUS_LOSING       (1 << 2) /* Packets were dropped before */
+#define TP_STATUS_BLK_TMO      (1 << 5) /* Retired by the block timeout */
+
+/* Status of the transmit frames */
+
+#define TP_STATUS_AVAILABLE    0        /* Free for the application */
+#define TP_STATUS_SEND_REQUEST (1 << 0) /* Filled, to be sent */
+#define TP_STATUS_SENDING      (1 << 1) /* Being sent by the kernel */
+#define TP_STATUS_WRONG_FORMAT (1 << 2) /* Rejected by the kernel */
+
+/* The frame headers and the frames are aligned to TPACKET_ALIGNMENT, the
+ * packet data in a frame follows TPACKET3_HDRLEN.
+ */
+
+#define TPACKET_ALIGNMENT      16
+#define TPACKET_ALIGN(x)       (((x) + TPACKET_ALIGNMENT - 1) & \
+                                ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET3_HDRLEN        (TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) + \
+                                sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -74,4 +112,83 @@ struct packet_mreq
   unsigned char  mr_address[8];
 };
 
+/* The argument of PACKET_RX_RING and PACKET_TX_RING.  The ring is
+ * tp_block_nr blocks of tp_block_size bytes.  The receive ring packs the
+ * packets of variable length into a block, the transmit ring divides a
+ * block into frames of tp_frame_size bytes.
+ */
+
+struct tpacket_req3
+{
+  unsigned int   tp_block_size;       /* Size of a block */
+  unsigned int   tp_block_nr;         /* Number of the blocks */
+  unsigned int   tp_frame_size;       /* Size of a frame */
+  unsigned int   tp_frame_nr;         /* Total number of the frames */
+  unsigned int   tp_retire_blk_tov;   /* Block timeout in milliseconds */
+  unsigned int   tp_sizeof_priv;      /* Private area of a block */
+  unsigned int   tp_feature_req_word; /* Not used */
+};
+
+/* Header of a packet in a receive block or of a transmit frame */
+
+struct tpacket_hdr_variant1
+{
+  uint32_t       tp_rxhash;
+  uint32_t       tp_vlan_tci;
+  uint16_t       tp_vlan_tpid;
+  uint16_t       tp_padding;
+};
+
+struct tpacket3_hdr
+{
+  uint32_t       tp_next_offset;      /* Offset of the next packet, or 0 */
+  uint32_t       tp_sec;              /* Time of the reception */
+  uint32_t       tp_nsec;
+  uint32_t       tp_snaplen;          /* Bytes stored in the ring */
+  uint32_t       tp_len;              /* Length of the packet */
+  uint32_t       tp_status;
+  uint16_t       tp_mac;              /* Offset of the link layer header */
+  uint16_t       tp_net;              /* Offset of the network header */
+  union
+  {
+    struct tpacket_hdr_variant1 hv1;
+  };
+  uint8_t        tp_padding[8];
+};
+
+/* Header of a receive block */
+
+struct tpacket_bd_ts
+{
+  unsigned int   ts_sec;
+  union
+  {
+    unsigned int ts_usec;
+    unsigned int ts_nsec;
+  };
+};
+
+struct tpacket_hdr_v1
+{
+  uint32_t       block_status;        /* TP_STATUS_KERNEL or TP_STATUS_USER */
+  uint32_t       num_pkts;            /* Number of the packets */
+  uint32_t       offset_to_first_pkt; /* Offset of the first packet */
+  uint32_t       blk_len;             /* Bytes used in the block */
+  uint64_t       seq_num aligned_data(8);
+  struct tpacket_bd_ts ts_first_pkt;
+  struct tpacket_bd_ts ts_last_pkt;
+};
+
+union tpacket_bd_header_u
+{
+  struct tpacket_hdr_v1 bh1;
+};
+
+struct tpacket_block_desc
+{
+  uint32_t       version;
+  uint32_t       offset_to_priv;      /* Offset of the private area */
+  union tpacket_bd_header_u hdr;
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
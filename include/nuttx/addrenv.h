@@ -265,11 +265,28 @@ struct tcb_s;                  /* Forward reference to TCB */
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+/* The read-only text pages of a program, shared by all address
+ * environments created from the same file.  The pages are returned to the
+ * page pool when the last reference is released.
+ */
+
+struct addrenv_text_s
+{
+  atomic_t      refs;            /* Users of the text pages                 */
+  unsigned int  npages;          /* Number of text pages                    */
+  uintptr_t     pages[1];        /* Physical addresses of the text pages    */
+};
+#endif
+
 struct addrenv_s
 {
   struct arch_addrenv_s addrenv; /* The address environment page directory  */
   struct work_s         work;    /* Worker to free address environment      */
   atomic_t              refs;    /* Users of address environment            */
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+  FAR struct addrenv_text_s *text; /* Shared text pages, if any             */
+#endif
 };
 
 typedef struct addrenv_s addrenv_t;
@@ -505,6 +522,65 @@ int addrenv_give(FAR struct addrenv_s *addrenv);
 
 void addrenv_drop(FAR struct addrenv_s *addrenv, bool deferred);
 
+/****************************************************************************
+ * Name: addrenv_text_create
+ *
+ * Description:
+ *   Make the text pages of a freshly loaded address environment shareable.
+ *   The returned object holds one reference for the address environment and
+ *   one for the caller.
+ *
+ * Input Parameters:
+ *   addrenv  - The address environment holding the loaded text.
+ *   textsize - The size of the text region in bytes.
+ *
+ * Returned Value:
+ *   The shared text on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+FAR struct addrenv_text_s *addrenv_text_create(FAR struct addrenv_s *addrenv,
+                                               size_t textsize);
+
+/****************************************************************************
+ * Name: addrenv_text_attach
+ *
+ * Description:
+ *   Map shared text pages into an address environment in place of its own
+ *   text pages, taking a reference to the shared text.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment.
+ *   text    - The shared text.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int addrenv_text_attach(FAR struct addrenv_s *addrenv,
+                        FAR struct addrenv_text_s *text);
+
+/****************************************************************************
+ * Name: addrenv_text_release
+ *
+ * Description:
+ *   Release a reference to shared text, freeing the pages with the last
+ *   one.
+ *
+ * Input Parameters:
+ *   text - The shared text.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void addrenv_text_release(FAR struct addrenv_text_s *text);
+#endif
+
 /****************************************************************************
  * Address Environment Interfaces
  *
@@ -135,6 +135,15 @@
 #  define UP_SEV()
 #endif
 
+/* UP_RELAX may also be provided in arch/spinlock.h.  It tells the CPU that
+ * it is busy waiting, so that it can save power or give its pipeline to
+ * the other hardware thread.
+ */
+
+#if !defined(UP_RELAX)
+#  define UP_RELAX()
+#endif
+
 #ifdef CONFIG_SMP
 #  define SMP_MB()  UP_DMB()
 #  define SMP_RMB() UP_RMB()
@@ -1543,6 +1552,52 @@ int up_addrenv_kstackfree(FAR struct tcb_s *tcb);
 uintptr_t up_addrenv_find_page(FAR arch_addrenv_t *addrenv, uintptr_t vaddr);
 #endif
 
+/****************************************************************************
+ * Name: up_addrenv_text_share
+ *
+ * Description:
+ *   Replace the private text pages of an address environment with pages
+ *   shared with another address environment created from the same file.
+ *   The private pages are freed.
+ *
+ * Input Parameters:
+ *   addrenv - The user address environment.
+ *   pages   - The physical addresses of the shared text pages.
+ *   npages  - The number of pages in the list.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+int up_addrenv_text_share(FAR arch_addrenv_t *addrenv,
+                          FAR const uintptr_t *pages, unsigned int npages);
+
+/****************************************************************************
+ * Name: up_addrenv_text_unshare
+ *
+ * Description:
+ *   Unmap the shared text pages from an address environment, so that
+ *   up_addrenv_destroy() does not return them to the page pool.  Entries
+ *   that do not map a shared page are left alone.
+ *
+ * Input Parameters:
+ *   addrenv - The user address environment.
+ *   pages   - The physical addresses of the shared text pages.
+ *   npages  - The number of pages in the list.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int up_addrenv_text_unshare(FAR arch_addrenv_t *addrenv,
+                            FAR const uintptr_t *pages, unsigned int npages);
+#endif
+
 /****************************************************************************
  * Name: up_addrenv_page_vaddr
  *
@@ -1868,6 +1923,19 @@ int up_set_irq_type(int irq, int mode);
 int up_prioritize_irq(int irq, int priority);
 #endif
 
+/****************************************************************************
+ * Name: up_attach_direct
+ *
+ * Description:
+ *   Point the hardware vector of 'irq' at 'isr', or back at the common
+ *   interrupt entry if 'isr' is NULL.  Used by irq_attach_direct().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_DIRECT
+int up_attach_direct(int irq, direct_xcpt_t isr);
+#endif
+
 /****************************************************************************
  * Name: up_secure_irq
  *
@@ -2897,6 +2965,28 @@ clock_t up_perf_gettime(void);
 unsigned long up_perf_getfreq(void);
 void up_perf_convert(clock_t elapsed, FAR struct timespec *ts);
 
+/****************************************************************************
+ * Name: up_pmu_*
+ *
+ * Description:
+ *   Count hardware events with the event counters of the calling CPU.
+ *   up_pmu_ncounters() returns the number of event counters and
+ *   up_pmu_event() the architecture event of a PERF_COUNT_HW_* event, or
+ *   a negated errno value if it is not supported.  up_pmu_start() counts
+ *   an event with a counter from zero, up_pmu_stop() stops the counter and
+ *   returns its count, and up_pmu_read() returns the count of a running
+ *   counter.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PMU_EVENTS
+int up_pmu_ncounters(void);
+int up_pmu_event(int event);
+void up_pmu_start(int idx, uint32_t event);
+uint64_t up_pmu_stop(int idx);
+uint64_t up_pmu_read(int idx);
+#endif
+
 /****************************************************************************
  * Name: up_show_cpuinfo
  *
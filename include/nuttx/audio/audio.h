@@ -94,6 +94,19 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_RINGSETUP - Allocate a ring of period buffers that the
+ *                    application maps with mmap() and fills or drains in
+ *                    place.  A period count of zero frees the ring.
+ *
+ *   ioctl argument:  Pointer to a struct audio_ring_desc_s
+ *
+ * AUDIOIOC_RINGCOMMIT - Hand the next 'ncommit' periods of the ring to
+ *                    the device and report the ring position.  poll()
+ *                    reports POLLIN | POLLOUT while the application owns
+ *                    at least one period.
+ *
+ *   ioctl argument:  Pointer to a struct audio_ring_pos_s
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -117,6 +130,8 @@
 #define AUDIOIOC_GETLATENCY         _AUDIOIOC(19)
 #define AUDIOIOC_FLUSH              _AUDIOIOC(20)
 #define AUDIOIOC_GETPOSITION        _AUDIOIOC(21)
+#define AUDIOIOC_RINGSETUP          _AUDIOIOC(22)
+#define AUDIOIOC_RINGCOMMIT         _AUDIOIOC(23)
 
 /* Audio Device Types *******************************************************/
 
@@ -370,6 +385,7 @@
 #define AUDIO_APB_OUTPUT_PROCESS    (1 << 1)
 #define AUDIO_APB_DEQUEUED          (1 << 2)
 #define AUDIO_APB_FINAL             (1 << 3) /* Last buffer in the stream */
+#define AUDIO_APB_RING              (1 << 4) /* Period of an mmap() ring */
 
 /* Audio channels range wrapper macro */
 
@@ -526,6 +542,30 @@ struct audio_buf_desc_s
   } u;
 };
 
+/* Structure describing the ring set up by AUDIOIOC_RINGSETUP.  The ring is
+ * 'nperiods' buffers of 'period_bytes' each, contiguous in memory so that a
+ * single mmap() of nperiods * period_bytes bytes covers the whole ring.
+ */
+
+struct audio_ring_desc_s
+{
+  apb_samp_t          nperiods;           /* Number of periods */
+  apb_samp_t          period_bytes;       /* Size of each period */
+};
+
+/* Structure for AUDIOIOC_RINGCOMMIT.  Both counters are free running
+ * period counts: 'appl' periods have been handed to the device and 'hw' of
+ * them have been returned by it.  Period n lives at offset
+ * (n % nperiods) * period_bytes of the mapping.
+ */
+
+struct audio_ring_pos_s
+{
+  uint32_t            ncommit;            /* In: periods to hand over */
+  uint32_t            appl;               /* Out: periods handed over */
+  uint32_t            hw;                 /* Out: periods completed */
+};
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
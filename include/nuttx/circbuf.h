@@ -28,6 +28,13 @@
  * For multiple writer and one reader there is only a need to lock the
  * writer. And vice versa for only one writer and multiple reader there is
  * only a need to lock the reader.
+ *
+ * The head and tail are published with release/acquire ordering, so the
+ * single reader and single writer may run on different CPUs or in
+ * interrupt context without a critical section.  For zero-copy access use
+ * circbuf_get_writeptr()/circbuf_writecommit() on the writer side and
+ * circbuf_get_readptr()/circbuf_readcommit() on the reader side.  A power
+ * of two buffer size avoids a division on every access.
  */
 
 /****************************************************************************
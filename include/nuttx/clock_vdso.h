@@ -0,0 +1,189 @@
+/****************************************************************************
+ * include/nuttx/clock_vdso.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CLOCK_VDSO_H
+#define __INCLUDE_NUTTX_CLOCK_VDSO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/seqlock.h>
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Snapshot of the timekeeping state published by the kernel in memory that
+ * user space can read.  The kernel refreshes it on every system tick and
+ * whenever the time of day is changed; readers use the sequence count to
+ * obtain a consistent copy without entering the kernel.
+ *
+ * If the platform registered a free running counter that user space may
+ * read (see clock_vdso_counter()), readers extrapolate from the snapshot
+ * with ns = ((counter - cycle_last) * mult) >> shift, bounded to one tick
+ * so that the result never runs past the next snapshot.
+ */
+
+struct clock_vdso_s
+{
+  seqcount_t                    seq;        /* Protects the fields below */
+  struct timespec               monotonic;  /* CLOCK_MONOTONIC at update */
+  struct timespec               realtime;   /* CLOCK_REALTIME at update */
+  FAR const volatile uint32_t  *counter;    /* User readable counter or NULL */
+  uint32_t                      cycle_last; /* Counter value at update */
+  uint32_t                      mult;       /* Counter to ns multiplier */
+  uint32_t                      shift;      /* Counter to ns shift */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxclock_vdso
+ *
+ * Description:
+ *   Return the address of the timekeeping snapshot.  The structure lives in
+ *   the user heap so that it may be read directly from user space.
+ *
+ * Returned Value:
+ *   The address of the snapshot or NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR const struct clock_vdso_s *nxclock_vdso(void);
+
+/****************************************************************************
+ * Name: clock_vdso_counter
+ *
+ * Description:
+ *   Register a free running 32-bit up counter that user space is permitted
+ *   to read.  Readers then interpolate between system ticks instead of
+ *   returning tick resolution times.  The counter must not wrap within one
+ *   system tick.
+ *
+ * Input Parameters:
+ *   counter - Address of the counter, or NULL to stop interpolating
+ *   freq    - Counter frequency in Hz
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef __KERNEL__
+void clock_vdso_counter(FAR const volatile uint32_t *counter,
+                        uint32_t freq);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_gettime
+ *
+ * Description:
+ *   Compute CLOCK_MONOTONIC, CLOCK_BOOTTIME or CLOCK_REALTIME from the
+ *   snapshot without entering the kernel.
+ *
+ * Input Parameters:
+ *   vdso     - The snapshot returned by nxclock_vdso()
+ *   clock_id - The clock to read
+ *   tp       - Location to return the time
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if the clock cannot be read from the snapshot
+ *   and the caller must fall back to nxclock_gettime().
+ *
+ ****************************************************************************/
+
+static inline int clock_vdso_gettime(FAR const struct clock_vdso_s *vdso,
+                                     clockid_t clock_id,
+                                     FAR struct timespec *tp)
+{
+  FAR const volatile uint32_t *counter;
+  uint32_t start;
+  uint32_t nsec;
+
+  if (clock_id != CLOCK_MONOTONIC && clock_id != CLOCK_BOOTTIME &&
+      clock_id != CLOCK_REALTIME)
+    {
+      return -EINVAL;
+    }
+
+  do
+    {
+      start = read_seqbegin(&vdso->seq);
+
+      *tp     = clock_id == CLOCK_REALTIME ? vdso->realtime :
+                                             vdso->monotonic;
+      counter = vdso->counter;
+      nsec    = 0;
+
+      if (counter != NULL)
+        {
+          uint64_t delta = (uint32_t)(*counter - vdso->cycle_last);
+
+          delta = (delta * vdso->mult) >> vdso->shift;
+          nsec  = delta < NSEC_PER_TICK ? (uint32_t)delta :
+                                          NSEC_PER_TICK - 1;
+        }
+    }
+  while (read_seqretry(&vdso->seq, start));
+
+  tp->tv_nsec += nsec;
+  if (tp->tv_nsec >= NSEC_PER_SEC)
+    {
+      tp->tv_nsec -= NSEC_PER_SEC;
+      tp->tv_sec++;
+    }
+
+  return 0;
+}
+
+#endif /* CONFIG_CLOCK_VDSO */
+#endif /* __INCLUDE_NUTTX_CLOCK_VDSO_H */
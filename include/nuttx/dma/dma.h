@@ -153,6 +153,26 @@
     (chan)->ops->start_link(chan, callback, arg, mode, link_cfg)
 #endif
 
+/****************************************************************************
+ * Name: DMA_START_SG
+ *
+ * Description:
+ *   Start a scatter-gather transfer between the fixed address 'addr' and
+ *   the 'nsg' memory segments of 'sg'.  For DMA_DEV_TO_MEM 'addr' is the
+ *   source and the segments are filled in order, for DMA_MEM_TO_DEV and
+ *   DMA_MEM_TO_MEM the segments are the source and 'addr' the destination
+ *   (advanced contiguously for DMA_MEM_TO_MEM).
+ *
+ *   This operation is optional, use dma_sg_submit() which falls back to
+ *   one DMA_START per segment if the channel doesn't implement it.
+ *
+ * Note: callback get called once when the whole list is transferred.
+ *
+ ****************************************************************************/
+
+#define DMA_START_SG(chan, callback, arg, addr, sg, nsg) \
+    (chan)->ops->start_sg(chan, callback, arg, addr, sg, nsg)
+
 /****************************************************************************
  * Name: DMA_PAUSE
  *
@@ -262,6 +282,35 @@ struct dma_config_s
   int src_step;
 };
 
+/* One memory segment of a scatter-gather transfer */
+
+struct dma_sg_s
+{
+  uintptr_t addr;
+  size_t len;
+};
+
+/* Scatter-gather transfer descriptor.  It is owned by the client and may
+ * be submitted again once its callback ran, so the segment list is only
+ * built once for repeated transfers.
+ */
+
+struct dma_sg_desc_s
+{
+  FAR struct dma_chan_s *chan;       /* Channel used by the transfer */
+  dma_callback_t callback;           /* Called when the list is done */
+  FAR void *arg;                     /* Argument of callback */
+  unsigned int direction;            /* DMA_MEM_TO_DEV... */
+  uintptr_t addr;                    /* Fixed side of the transfer */
+  FAR const struct dma_sg_s *sg;     /* Memory segments */
+  unsigned int nsg;                  /* Number of memory segments */
+
+  /* Used internally by the software fallback */
+
+  unsigned int index;
+  size_t done;
+};
+
 #ifdef CONFIG_DMA_LINK
 struct dma_link_s
 {
@@ -305,6 +354,10 @@ struct dma_ops_s
   CODE int (*pause)(FAR struct dma_chan_s *chan);
   CODE int (*resume)(FAR struct dma_chan_s *chan);
   CODE size_t (*residual)(FAR struct dma_chan_s *chan);
+  CODE int (*start_sg)(FAR struct dma_chan_s *chan,
+                       dma_callback_t callback, FAR void *arg,
+                       uintptr_t addr, FAR const struct dma_sg_s *sg,
+                       unsigned int nsg);
 };
 
 /* This structure only defines the initial fields of the structure
@@ -325,4 +378,86 @@ struct dma_dev_s
                         FAR struct dma_chan_s *chan);
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_DMA
+
+/****************************************************************************
+ * Name: dma_sg_prep
+ *
+ * Description:
+ *   Prepare a scatter-gather descriptor.  The segment list must stay valid
+ *   until the descriptor is no longer used.
+ *
+ * Input Parameters:
+ *   desc      - The descriptor to prepare
+ *   chan      - The channel, configured with DMA_CONFIG() beforehand
+ *   direction - DMA_MEM_TO_DEV, DMA_DEV_TO_MEM or DMA_MEM_TO_MEM
+ *   addr      - The device (or destination memory) address
+ *   sg        - The memory segments
+ *   nsg       - The number of memory segments
+ *   callback  - The callback when the whole list is transferred
+ *   arg       - The argument will pass to callback
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_sg_prep(FAR struct dma_sg_desc_s *desc, FAR struct dma_chan_s *chan,
+                unsigned int direction, uintptr_t addr,
+                FAR const struct dma_sg_s *sg, unsigned int nsg,
+                dma_callback_t callback, FAR void *arg);
+
+/****************************************************************************
+ * Name: dma_sg_submit
+ *
+ * Description:
+ *   Start the transfer described by a prepared descriptor.  If the channel
+ *   has no native scatter-gather support, the segments are started one
+ *   after the other from the completion callback of the previous one.
+ *
+ * Input Parameters:
+ *   desc - The descriptor prepared by dma_sg_prep()
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_sg_submit(FAR struct dma_sg_desc_s *desc);
+
+#endif /* CONFIG_DMA */
+
+#ifdef CONFIG_DMA_SOFT
+
+/****************************************************************************
+ * Name: dma_soft_initialize
+ *
+ * Description:
+ *   Return the software DMA device.  Its channels copy memory with the CPU
+ *   from the low priority work queue, which makes it a reference for the
+ *   DMA interface and a fallback for boards without a DMA controller.
+ *
+ ****************************************************************************/
+
+FAR struct dma_dev_s *dma_soft_initialize(void);
+
+#endif /* CONFIG_DMA_SOFT */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_DMA_DMA_H */
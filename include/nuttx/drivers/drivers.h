@@ -158,6 +158,54 @@ void devcrypto_register(void);
 int devmem_register(void);
 #endif
 
+/****************************************************************************
+ * Name: devprofile_register
+ *
+ * Description:
+ *   Register the /dev/profile sampling profiler
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PROFILE
+int devprofile_register(void);
+#endif
+
+/****************************************************************************
+ * Name: devperf_register
+ *
+ * Description:
+ *   Register the /dev/perf hardware event counters
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PERF
+int devperf_register(void);
+#endif
+
+/****************************************************************************
+ * Name: devbench_register
+ *
+ * Description:
+ *   Register the /dev/bench kernel micro-benchmarks
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_BENCH
+int devbench_register(void);
+#endif
+
+/****************************************************************************
+ * Name: ringchan_register
+ *
+ * Description:
+ *   Register the shared memory ring channel control device /dev/ringctl
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_RINGCHAN
+int ringchan_register(void);
+#endif
+
 /****************************************************************************
  * Name: devzero_register
  *
@@ -30,9 +30,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/wqueue.h>
 
 #if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
@@ -55,6 +57,22 @@ typedef CODE ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer,
 typedef CODE ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
                                    off_t startblock, size_t nblocks);
 
+/* One segment of the write buffer.  Each segment caches a window of
+ * wrmaxblocks / wrnsegments blocks aligned to its own size, so different
+ * segments never hold the same block.
+ */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+struct rwb_wrseg_s
+{
+  FAR uint8_t  *buffer;          /* Window contents, indexed from window */
+  off_t         window;          /* First block of the window, -1 if free */
+  off_t         blockstart;      /* First buffered block in the window */
+  uint16_t      nblocks;         /* Number of buffered blocks */
+  bool          flushing;        /* Being written by the flush worker */
+};
+#endif
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -75,8 +93,8 @@ typedef CODE ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
  *
  *  FAR struct foo_dev_s *priv;
  *  ...
- *  ... [Setup blocksize, nblocks, dev, wrmaxblocks, wrflush,
- *       rhmaxblocks, rhreload] ...
+ *  ... [Setup blocksize, nblocks, dev, wrmaxblocks, wrnsegments,
+ *       wrflush, rhmaxblocks, rhreload] ...
  *  ret = rwb_initialize(&priv->rwbuffer);
  */
 
@@ -103,6 +121,9 @@ struct rwbuffer_s
   uint16_t      wralignblocks;   /* The buffer to be flash is always multiplied by this
                                   * number. It must be 0 or divisible by wrmaxblocks.
                                   */
+  uint16_t      wrnsegments;     /* The number of independent segments the write
+                                  * buffer is split into.  0 is the same as 1.
+                                  */
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   uint16_t      rhmaxblocks;     /* The number of blocks to buffer in memory */
@@ -130,10 +151,18 @@ struct rwbuffer_s
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   mutex_t       wrlock;          /* Enforces exclusive access to the write buffer */
+  mutex_t       wriolock;        /* Serializes the callouts with the flush worker */
   struct work_s work;            /* Delayed work to flush buffer after a delay with no activity */
+  struct work_s flushwork;       /* Background flush of the idle segments */
+  sem_t         wrsem;           /* Wakes writers waiting for the background flush */
+  uint16_t      wrwaiters;       /* Number of writers waiting on wrsem */
+  uint16_t      wrsegblocks;     /* Number of blocks in one segment */
   FAR uint8_t  *wrbuffer;        /* Allocated write buffer */
-  uint16_t      wrnblocks;       /* Number of blocks in write buffer */
-  off_t         wrblockstart;    /* First block in write buffer */
+
+  /* Allocated segment table and the segment written last */
+
+  FAR struct rwb_wrseg_s *wrseg;
+  FAR struct rwb_wrseg_s *wrlast;
 #endif
 
   /* This is the state of the read-ahead buffering */
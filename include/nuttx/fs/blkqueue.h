@@ -0,0 +1,132 @@
+/****************************************************************************
+ * include/nuttx/fs/blkqueue.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_BLKQUEUE_H
+#define __INCLUDE_NUTTX_FS_BLKQUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+#include <nuttx/queue.h>
+#include <nuttx/fs/fs.h>
+
+#ifdef CONFIG_BLK_QUEUE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct blk_request_s;
+
+/* The completion callback of a request.  It may be called from the
+ * interrupt handler of the block driver.
+ */
+
+typedef CODE void (*blk_complete_t)(FAR struct blk_request_s *req);
+
+/* An asynchronous block request.  The request and its buffer belong to the
+ * block layer from blk_submit() until the completion callback is called.
+ */
+
+struct blk_request_s
+{
+  dq_entry_t         br_node;     /* Used by the owner of the request */
+  FAR struct inode  *br_inode;    /* The block driver */
+  FAR unsigned char *br_buffer;   /* The data to read or to write */
+  blkcnt_t           br_sector;   /* The first sector */
+  unsigned int       br_nsectors; /* The number of sectors */
+  bool               br_write;    /* true: write, false: read */
+  ssize_t            br_result;   /* Sectors transferred or negated errno */
+  blk_complete_t     br_complete; /* Called when the request is done */
+  FAR void          *br_arg;      /* Argument of the caller */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: blk_submit
+ *
+ * Description:
+ *   Submit an asynchronous request to a block driver.  The request goes to
+ *   the submit method of the driver if it has one, otherwise it is queued,
+ *   sorted by sector and merged with the requests contiguous to it, and
+ *   executed with the read and write methods of the driver on the low
+ *   priority work queue.
+ *
+ *   The caller fills br_inode, br_buffer, br_sector, br_nsectors,
+ *   br_write, br_complete and br_arg.  br_result holds the outcome when
+ *   br_complete is called.  The caller keeps its reference to the driver
+ *   inode until then.
+ *
+ * Input Parameters:
+ *   req - The request
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was accepted, br_complete will be called
+ *   exactly once.  A negated errno value if it was not, br_complete will
+ *   not be called.
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int blk_submit(FAR struct blk_request_s *req);
+
+/****************************************************************************
+ * Name: blk_complete
+ *
+ * Description:
+ *   Complete a request, called by the block drivers which implement the
+ *   submit method.
+ *
+ * Input Parameters:
+ *   req    - The request
+ *   result - The number of sectors transferred or a negated errno value
+ *
+ ****************************************************************************/
+
+void blk_complete(FAR struct blk_request_s *req, ssize_t result);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_BLK_QUEUE */
+#endif /* __INCLUDE_NUTTX_FS_BLKQUEUE_H */
@@ -108,6 +108,7 @@
 #define __FS_FLAG_ERROR (1 << 1) /* Error detected by any operation */
 #define __FS_FLAG_LBF   (1 << 2) /* Line buffered */
 #define __FS_FLAG_UBF   (1 << 3) /* Buffer allocated by caller of setvbuf */
+#define __FS_FLAG_NOLK  (1 << 4) /* Not locked by stdio, __fsetlocking() */
 
 /* Inode i_flags values:
  *
@@ -259,6 +260,7 @@ struct file_operations
  */
 
 struct inode;
+struct blk_request_s;
 struct block_operations
 {
   CODE int     (*open)(FAR struct inode *inode);
@@ -274,6 +276,10 @@ struct block_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_BLK_QUEUE
+  CODE int     (*submit)(FAR struct inode *inode,
+                         FAR struct blk_request_s *req);
+#endif
 };
 
 /* This structure is provided by a filesystem to describe a mount point.
@@ -454,6 +460,10 @@ typedef struct cookie_io_functions_t
  * the file descriptor to the file state and to a set of inode operations.
  */
 
+#ifdef CONFIG_FS_READAHEAD
+struct file_readahead_s;
+#endif
+
 struct file
 {
   int               f_oflags;   /* Open mode flags */
@@ -464,6 +474,9 @@ struct file
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   bool              f_locked;   /* Filelock state: false - unlocked, true - locked */
 #endif
+#ifdef CONFIG_FS_READAHEAD
+  FAR struct file_readahead_s *f_ra; /* Sequential readahead state */
+#endif
 };
 
 struct fd
@@ -1636,6 +1649,21 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice and file_tee
+ *
+ * Description:
+ *   Equivalent to the standard splice and tee functions except that they
+ *   accept struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags);
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags);
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -113,6 +113,8 @@
 #define _1WIREBASE      (0x4500) /* 1WIRE ioctl commands */
 #define _EEPIOCBASE     (0x4600) /* EEPROM driver ioctl commands */
 #define _PTPBASE        (0x4700) /* PTP ioctl commands */
+#define _PERFIOCBASE    (0x4800) /* Perf event ioctl commands */
+#define _RINGCHANBASE   (0x4900) /* Ring channel ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -366,6 +368,17 @@
                                            * IN:  None
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_TRIM       _BIOC(0x0012)     /* Tell the device the sectors are unused
+                                           * IN:  Pointer to blkcnt_t[2], the first
+                                           *      sector and the number of sectors
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
+#define BIOC_WRZEROES   _BIOC(0x0013)     /* Write zeroes to the sectors without a
+                                           * data transfer.
+                                           * IN:  Pointer to blkcnt_t[2], the first
+                                           *      sector and the number of sectors
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -526,6 +539,11 @@
                                                * IN: None
                                                * OUT: int */
 
+#define PIPEIOC_SPLICE      _PIPEIOC(0x0007)  /* Move data between the pipe
+                                               * and another file
+                                               * IN: pipe_splice_s
+                                               * OUT: Length of data */
+
 /* RTC driver ioctl definitions *********************************************/
 
 /* (see nuttx/include/rtc.h */
@@ -807,6 +825,20 @@
 #define _PTPIOCVALID(c)       (_IOC_TYPE(c)==_PTPBASE)
 #define _PTPIOC(nr)           _IOC(_PTPBASE,nr)
 
+/* Perf event driver ioctl definitions **************************************/
+
+/* see nuttx/include/perf_event.h */
+
+#define _PERFIOCVALID(c)      (_IOC_TYPE(c)==_PERFIOCBASE)
+#define _PERFIOC(nr)          _IOC(_PERFIOCBASE,nr)
+
+/* Ring channel driver ioctl definitions ************************************/
+
+/* see nuttx/include/ringchan.h */
+
+#define _RINGCHANIOCVALID(c)  (_IOC_TYPE(c)==_RINGCHANBASE)
+#define _RINGCHANIOC(nr)      _IOC(_RINGCHANBASE,nr)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -845,6 +877,18 @@ struct pipe_peek_s
   size_t size;
 };
 
+struct file;
+
+struct pipe_splice_s
+{
+  FAR struct file *file;   /* The file at the other end of the transfer */
+  FAR off_t       *offset; /* The offset in file, NULL for its position */
+  size_t           len;    /* The maximum number of bytes to move */
+  unsigned int     flags;  /* SPLICE_F_* definitions */
+  bool             write;  /* true: file to pipe, false: pipe to file */
+  bool             keep;   /* true: do not consume the pipe data (tee) */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
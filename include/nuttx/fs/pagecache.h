@@ -0,0 +1,132 @@
+/****************************************************************************
+ * include/nuttx/fs/pagecache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_PAGECACHE_H
+#define __INCLUDE_NUTTX_FS_PAGECACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_PAGECACHE
+#  define pagecache_read(i, b, s, n, z)  ((i)->u.i_bops->read(i, b, s, n))
+#  define pagecache_write(i, b, s, n, z) ((i)->u.i_bops->write(i, b, s, n))
+#  define pagecache_invalidate(i)        ((void)(i))
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Name: pagecache_read
+ *
+ * Description:
+ *   Read sectors from a block driver through the shared sector cache.  The
+ *   cached sectors are copied out and the missing runs are read from the
+ *   driver straight into the buffer, then kept in the cache.
+ *
+ * Input Parameters:
+ *   inode        - The block driver inode
+ *   buffer       - The buffer receiving the data
+ *   start_sector - The first sector to read
+ *   nsectors     - The number of sectors to read
+ *   sectsize     - The sector size of the block driver
+ *
+ * Returned Value:
+ *   The number of sectors read, or a negated errno value on failure if no
+ *   sector could be read.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                       blkcnt_t start_sector, unsigned int nsectors,
+                       size_t sectsize);
+
+/****************************************************************************
+ * Name: pagecache_write
+ *
+ * Description:
+ *   Write sectors to a block driver and update the copies of the written
+ *   sectors which are in the cache.  The cache is write-through, so the
+ *   media is always in sync with the cached sectors.
+ *
+ * Input Parameters:
+ *   inode        - The block driver inode
+ *   buffer       - The data to write
+ *   start_sector - The first sector to write
+ *   nsectors     - The number of sectors to write
+ *   sectsize     - The sector size of the block driver
+ *
+ * Returned Value:
+ *   The value returned by the write method of the block driver.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_write(FAR struct inode *inode,
+                        FAR const unsigned char *buffer,
+                        blkcnt_t start_sector, unsigned int nsectors,
+                        size_t sectsize);
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Drop all the cached sectors of a block driver.  This must be called
+ *   whenever the media may have been changed behind the cache, and before
+ *   the inode is freed.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode
+ *
+ ****************************************************************************/
+
+void pagecache_invalidate(FAR struct inode *inode);
+
+#endif /* CONFIG_FS_PAGECACHE */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_FS_PAGECACHE_H */
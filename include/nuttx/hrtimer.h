@@ -230,6 +230,23 @@ int hrtimer_start(FAR hrtimer_t *hrtimer, hrtimer_entry_t func,
 
 uint64_t hrtimer_gettime(FAR hrtimer_t *timer);
 
+/****************************************************************************
+ * Name: hrtimer_gettime_next
+ *
+ * Description:
+ *   Get the delay until the first armed hrtimer expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value
+ *   The time until the next expiration in nanoseconds, zero if it is
+ *   already due, or UINT64_MAX if no hrtimer is armed.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime_next(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
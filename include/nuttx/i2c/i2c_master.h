@@ -34,6 +34,10 @@
 
 #include <nuttx/fs/ioctl.h>
 
+#ifdef CONFIG_I2C_ASYNC
+#  include <nuttx/queue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -205,6 +209,31 @@
 
 #define I2C_SHUTDOWN(d) ((d)->ops->shutdown(d))
 
+/****************************************************************************
+ * Name: I2C_TRANSFER_ASYNC
+ *
+ * Description:
+ *   Queue a request on the lower half and return at once.  The lower half
+ *   performs the requests of the bus in order, typically from its
+ *   interrupt handler, and calls req->callback with the result of each.
+ *   This method is optional; use i2c_transfer_async() rather than calling
+ *   it directly.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request to queue
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; -ENOSYS if the lower half has no
+ *   such method; another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+#  define I2C_TRANSFER_ASYNC(d,r) \
+     ((d)->ops->transfer_async ? (d)->ops->transfer_async(d,r) : -ENOSYS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -213,6 +242,7 @@
 
 struct i2c_master_s;
 struct i2c_msg_s;
+struct i2c_async_s;
 struct i2c_ops_s
 {
   CODE int (*transfer)(FAR struct i2c_master_s *dev,
@@ -222,6 +252,10 @@ struct i2c_ops_s
 #endif
   CODE int (*setup)(FAR struct i2c_master_s *dev);
   CODE int (*shutdown)(FAR struct i2c_master_s *dev);
+#ifdef CONFIG_I2C_ASYNC
+  CODE int (*transfer_async)(FAR struct i2c_master_s *dev,
+                             FAR struct i2c_async_s *req);
+#endif
 };
 
 /* This structure contains the full state of I2C as needed for a specific
@@ -270,6 +304,41 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+/* This describes one register block read by a batch of register reads.
+ * See i2c_setup_regreads().
+ */
+
+struct i2c_regread_s
+{
+  uint8_t reg;                /* The first register to read */
+  FAR uint8_t *buffer;        /* Receives the register values */
+  ssize_t length;             /* The number of registers to read */
+};
+
+#ifdef CONFIG_I2C_ASYNC
+/* This describes a transfer queued by i2c_transfer_async().  The callback
+ * is called with the result of the transfer, from the interrupt handler of
+ * the lower half or from the work queue, so it must not block.  The request
+ * and its messages must stay valid until then.
+ */
+
+typedef CODE void (*i2c_async_callback_t)(FAR struct i2c_async_s *req,
+                                          int result);
+
+struct i2c_async_s
+{
+  FAR struct i2c_msg_s *msgs;     /* The messages to transfer */
+  int count;                      /* The number of messages */
+  i2c_async_callback_t callback;  /* Called when the transfer completes */
+  FAR void *arg;                  /* For the use of the callback */
+
+  /* Owned by the I2C layer while the request is queued */
+
+  sq_entry_t node;                /* The queue of the bus */
+  FAR struct i2c_master_s *dev;   /* The bus of the request */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -383,6 +452,58 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+/****************************************************************************
+ * Name: i2c_setup_regreads
+ *
+ * Description:
+ *   Format the messages reading a batch of register blocks of one device.
+ *   Each block is read by writing its first register followed by a
+ *   restarted read, and the batch is performed by a single I2C_TRANSFER()
+ *   or i2c_transfer_async() with 2 * nreads messages.  The reads array
+ *   must stay valid until the transfer completes.
+ *
+ * Input Parameters:
+ *   msgs   - Receives the 2 * nreads messages
+ *   config - Described the I2C configuration
+ *   reads  - The register blocks to read
+ *   nreads - The number of register blocks
+ *
+ * Returned Value:
+ *   The number of messages formatted.
+ *
+ ****************************************************************************/
+
+int i2c_setup_regreads(FAR struct i2c_msg_s *msgs,
+                       FAR const struct i2c_config_s *config,
+                       FAR struct i2c_regread_s *reads, int nreads);
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of I2C messages and return at once.  The messages are
+ *   transferred like I2C_TRANSFER() does, then req->callback is called
+ *   with the result.  Requests queued on the same bus complete in order.
+ *
+ *   The lower half performs the request if it provides the
+ *   transfer_async() method.  Otherwise, the requests of each bus are
+ *   performed one after the other by I2C_TRANSFER() on the work queue.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - Describes the messages and the completion callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure,
+ *   in which case the callback is not called.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_async_s *req);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
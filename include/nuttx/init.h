@@ -31,6 +31,9 @@
 #include <nuttx/compiler.h>
 
 #include <stdint.h>
+#include <time.h>
+
+#include <nuttx/atomic.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -48,6 +51,24 @@
 #define OSINIT_IS_PANIC()        (g_nx_initstate >= OSINIT_PANIC)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+/* Run one initialization call, recording how long it takes in the boot
+ * profile if CONFIG_SCHED_BOOT_PROFILE is enabled.  The text of the call
+ * is used as the name of the record.
+ */
+
+#ifdef CONFIG_SCHED_BOOT_PROFILE
+#  define nx_bootcall(call) \
+     do \
+       { \
+         int __bootslot = nx_bootprof_begin(#call); \
+         call; \
+         nx_bootprof_end(__bootslot); \
+       } \
+     while (0)
+#else
+#  define nx_bootcall(call) call
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -77,6 +98,23 @@ enum nx_initstate_e
   OSINIT_PANIC     = 8   /* Fatal error happened. */
 };
 
+#ifdef CONFIG_SCHED_BOOT_PROFILE
+/* One step of the boot, timed with perf_gettime() */
+
+struct bootprof_s
+{
+  FAR const char *name;  /* The name of the step */
+  clock_t         start; /* perf_gettime() when the step started */
+  clock_t         end;   /* perf_gettime() when it ended, 0 if running */
+};
+#endif
+
+#ifdef CONFIG_SCHED_BOOT_ASYNC
+/* An initialization function run by nx_bootasync() */
+
+typedef CODE int (*bootasync_t)(FAR void *arg);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -96,6 +134,15 @@ extern "C"
 
 EXTERN volatile enum nx_initstate_e g_nx_initstate;  /* See enum nx_initstate_e */
 
+#ifdef CONFIG_SCHED_BOOT_PROFILE
+/* The boot profile, g_nbootprof counts the steps started so far and may
+ * exceed CONFIG_SCHED_BOOT_PROFILE_NRECORDS.
+ */
+
+EXTERN struct bootprof_s g_bootprof[CONFIG_SCHED_BOOT_PROFILE_NRECORDS];
+EXTERN atomic_t g_nbootprof;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -106,6 +153,85 @@ EXTERN volatile enum nx_initstate_e g_nx_initstate;  /* See enum nx_initstate_e
 
 void nx_start(void);
 
+/****************************************************************************
+ * Name: nx_bootprof_begin
+ *
+ * Description:
+ *   Record the start of a boot step.  Usually called through
+ *   nx_bootcall().
+ *
+ * Input Parameters:
+ *   name - The name of the step, must remain valid after boot.
+ *
+ * Returned Value:
+ *   The record of the step for nx_bootprof_end(), or a negated errno value
+ *   if the profile is full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_BOOT_PROFILE
+int nx_bootprof_begin(FAR const char *name);
+
+/****************************************************************************
+ * Name: nx_bootprof_end
+ *
+ * Description:
+ *   Record the end of a boot step.
+ *
+ * Input Parameters:
+ *   slot - The value returned by nx_bootprof_begin().
+ *
+ ****************************************************************************/
+
+void nx_bootprof_end(int slot);
+#endif
+
+/****************************************************************************
+ * Name: nx_bootasync
+ *
+ * Description:
+ *   Run a slow initialization, like card detection, PHY link negotiation
+ *   or a flash mount, on the low priority work queue instead of the boot
+ *   thread.  Initializations with no dependency between them run
+ *   concurrently, up to CONFIG_SCHED_LPNTHREADS at a time.
+ *
+ * Input Parameters:
+ *   name  - The name of the initialization, must remain valid after boot.
+ *   init  - The initialization function.
+ *   arg   - The argument passed to init.
+ *   after - The name of an initialization that must have completed
+ *           successfully before this one starts, or NULL.  If it fails,
+ *           this initialization does not run and fails with -ECANCELED.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_BOOT_ASYNC
+int nx_bootasync(FAR const char *name, bootasync_t init, FAR void *arg,
+                 FAR const char *after);
+
+/****************************************************************************
+ * Name: nx_bootasync_wait
+ *
+ * Description:
+ *   Wait for an initialization started by nx_bootasync(), or for all of
+ *   them.
+ *
+ * Input Parameters:
+ *   name - The name of the initialization, or NULL to wait for all.
+ *
+ * Returned Value:
+ *   The value returned by the initialization function, the first error of
+ *   all of them if name is NULL, or -ENOENT if there is no such
+ *   initialization.
+ *
+ ****************************************************************************/
+
+int nx_bootasync_wait(FAR const char *name);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
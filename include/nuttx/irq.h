@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <sys/types.h>
 #  include <stdint.h>
 #  include <stdbool.h>
 #endif
@@ -50,6 +51,15 @@
 #define irq_detach(irq) irq_attach(irq, NULL, NULL)
 #define irq_detach_wqueue(irq) irq_attach_wqueue(irq, NULL, NULL, NULL, 0)
 #define irq_detach_thread(irq) irq_attach_thread(irq, NULL, NULL, NULL, 0, 0)
+#define irq_detach_direct(irq) irq_attach_direct(irq, NULL)
+
+/* Direct interrupt handlers get no OS prologue, so they account for
+ * themselves in the IRQ monitor by calling irq_direct_count().
+ */
+
+#if !defined(CONFIG_IRQ_DIRECT) || !defined(CONFIG_SCHED_IRQMONITOR)
+#  define irq_direct_count(irq)
+#endif
 
 /* Maximum/minimum values of IRQ integer types */
 
@@ -166,6 +176,10 @@
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_WDOG -1
 #endif
 
+#ifndef CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS
+#  define CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS -1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -200,6 +214,12 @@ typedef uint32_t irq_mapped_t;
 /* This struct defines the form of an interrupt service routine */
 
 typedef CODE int (*xcpt_t)(int irq, FAR void *context, FAR void *arg);
+
+/* This is the form of a direct interrupt handler, entered straight from
+ * the hardware vector without the common dispatch logic.
+ */
+
+typedef CODE void (*direct_xcpt_t)(void);
 #endif /* __ASSEMBLY__ */
 
 /****************************************************************************
@@ -308,6 +328,63 @@ int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #  define irqchain_detach(irq, isr, arg) irq_detach(irq)
 #endif
 
+/****************************************************************************
+ * Name: irq_attach_direct
+ *
+ * Description:
+ *   Install 'isr' directly in the hardware vector of IRQ number 'irq',
+ *   bypassing irq_dispatch().  The handler runs without a saved
+ *   xcptcontext and so must not call any OS interface; it may raise a
+ *   normally attached (e.g. PendSV) interrupt to defer such work.  The
+ *   IRQ remains listed in the IRQ monitor and its count is updated by
+ *   irq_direct_count().
+ *
+ * Input Parameters:
+ *   irq - IRQ number
+ *   isr - Direct handler, or NULL to restore the common vector
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_DIRECT
+int irq_attach_direct(int irq, direct_xcpt_t isr);
+#endif
+
+/****************************************************************************
+ * Name: irq_direct_count
+ *
+ * Description:
+ *   Account one occurrence of a direct interrupt in the IRQ monitor.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_IRQ_DIRECT) && defined(CONFIG_SCHED_IRQMONITOR)
+void irq_direct_count(int irq);
+#endif
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Route IRQ number 'irq' to the CPUs in 'cpuset' and move its IRQ
+ *   thread, if any, to the same CPUs.  The IRQ is then excluded from
+ *   automatic balancing.
+ *
+ * Input Parameters:
+ *   irq    - IRQ number
+ *   cpuset - Set of target CPUs
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+int irq_set_affinity(int irq, cpu_set_t cpuset);
+#endif
+
 /****************************************************************************
  * Name: enter_critical_section
  *
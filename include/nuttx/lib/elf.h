@@ -245,11 +245,16 @@ struct mod_loadinfo_s
    *
    * addrenv - This is the handle created by addrenv_allocate() that can be
    *   used to manage the tasks address space.
+   * text - Text pages already loaded by an earlier instance of the same
+   *   file.  When set, the read-only sections are not loaded again.
    */
 
 #ifdef CONFIG_ARCH_ADDRENV
   FAR addrenv_t     *addrenv;    /* Address environment */
   FAR addrenv_t     *oldenv;     /* Saved address environment */
+#  ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+  FAR struct addrenv_text_s *text; /* Shared text pages */
+#  endif
 #endif
 };
 
@@ -30,6 +30,10 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#ifdef CONFIG_LIBM_FLOAT_VECTOR
+#  include <stddef.h>
+#endif
+
 /* If CONFIG_ARCH_MATH_H is defined, then the top-level Makefile will copy
  * this header file to include/math.h where it will become the system math.h
  * header file.  In this case, the architecture specific code must provide
@@ -607,6 +611,17 @@ double      scalbn(double x, int n);
 long double scalbnl(long double x, int n);
 #endif
 
+/* Array entry points (non-standard): y[i] = f(x[i]) for i < n */
+
+#ifdef CONFIG_LIBM_FLOAT_VECTOR
+void        vsinf   (FAR float *y, FAR const float *x, size_t n);
+void        vcosf   (FAR float *y, FAR const float *x, size_t n);
+void        vsincosf(FAR float *s, FAR float *c, FAR const float *x,
+                     size_t n);
+void        vexpf   (FAR float *y, FAR const float *x, size_t n);
+void        vlogf   (FAR float *y, FAR const float *x, size_t n);
+#endif
+
 #define FP_INFINITE     0
 #define FP_NAN          1
 #define FP_NORMAL       2
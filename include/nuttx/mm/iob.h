@@ -37,6 +37,14 @@
 #  include <nuttx/wqueue.h>
 #endif
 
+#ifdef CONFIG_IOB_ALLOC
+#  include <nuttx/atomic.h>
+#endif
+
+#ifdef CONFIG_IOB_TIMESTAMP
+#  include <time.h>
+#endif
+
 #ifdef CONFIG_MM_IOB
 
 /****************************************************************************
@@ -101,6 +109,20 @@
 
 typedef CODE void (*iob_free_cb_t)(FAR void *data);
 
+#ifdef CONFIG_IOB_ALLOC
+/* An external data buffer shared by reference between I/O buffers.  It is
+ * handed back to its owner through free_cb when the last I/O buffer
+ * referring to it is freed.
+ */
+
+struct iob_extbuf_s
+{
+  atomic_t      refs;     /* Number of I/O buffers referring to the data */
+  iob_free_cb_t free_cb;  /* Return the data to its owner */
+  FAR void     *data;     /* The external data buffer */
+};
+#endif
+
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
@@ -126,8 +148,16 @@ struct iob_s
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
 
+#ifdef CONFIG_IOB_TIMESTAMP
+  struct timespec io_tstamp; /* Packet timestamp, valid like io_pktlen */
+#endif
+
 #ifdef CONFIG_IOB_ALLOC
   iob_free_cb_t io_free;  /* Custom free callback */
+
+  /* Reference counted external buffer or NULL */
+
+  FAR struct iob_extbuf_s *io_ext;
   FAR uint8_t  *io_data;
 #else
   uint8_t       io_data[CONFIG_IOB_BUFSIZE];
@@ -167,6 +197,7 @@ struct iob_stats_s
   int nfree;
   int nwait;
   int nthrottle;
+  int npeak;
 };
 
 /****************************************************************************
@@ -220,6 +251,21 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate 'count' I/O buffers at once, linked together through
+ *   io_flink, without waiting for buffers to become free.  Either all of
+ *   the buffers are allocated under a single lock or none of them.
+ *
+ * Returned Value:
+ *   The first I/O buffer of the list on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_batch(unsigned int count, bool throttled);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -292,6 +338,36 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
 FAR struct iob_s *iob_init_with_data(FAR void *data, uint16_t size,
                                      iob_free_cb_t free_cb);
 
+/****************************************************************************
+ * Name: iob_alloc_extbuf
+ *
+ * Description:
+ *   Allocate an I/O buffer from heap referring to a reference counted
+ *   external payload, e.g. the DMA memory of a network driver.  Unlike
+ *   iob_alloc_with_data(), the payload can then be shared with more I/O
+ *   buffers by iob_share() without copying it.
+ *
+ * Input Parameters:
+ *   data    - The external payload, owned by the caller until free_cb is
+ *             called.
+ *   size    - The size of the data parameter
+ *   free_cb - Called with data when the last I/O buffer referring to the
+ *             payload is freed.
+ *
+ *             +---------+      +--------+
+ *             |   IOB   |----->| extbuf |
+ *             | io_data |--+   +--------+
+ *             +---------+  |       |
+ *             |   IOB   |--|-------+
+ *             | io_data |--+-->+--------+
+ *             +---------+      |  data  |
+ *                              +--------+
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_extbuf(FAR void *data, uint16_t size,
+                                   iob_free_cb_t free_cb);
+
 #endif
 
 /****************************************************************************
@@ -574,6 +650,32 @@ int iob_clone_partial(FAR struct iob_s *iob1, unsigned int len,
                       int offset1, FAR struct iob_s *iob2,
                       int offset2, bool throttled, bool block);
 
+/****************************************************************************
+ * Name: iob_share
+ *
+ * Description:
+ *   Create a new I/O buffer chain holding 'len' bytes of the chain 'iob'
+ *   starting at 'offset'.  The data of external buffers allocated by
+ *   iob_alloc_extbuf() is referenced rather than copied; the data of any
+ *   other I/O buffer is copied.
+ *
+ *   The shared data must be treated as read-only by all the chains, the
+ *   new chain has no tail room in the entries referring to it.
+ *
+ * Input Parameters:
+ *   iob       - Pointer to source iob_s
+ *   len       - Number of bytes to share
+ *   offset    - Offset of the data in the source
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ * Returned Value:
+ *   The new I/O buffer chain on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_share(FAR struct iob_s *iob, unsigned int len,
+                            unsigned int offset, bool throttled);
+
 /****************************************************************************
  * Name: iob_concat
  *
@@ -722,5 +824,24 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 void iob_getstats(FAR struct iob_stats_s *stats);
 #endif
 
+/****************************************************************************
+ * Name: iob_notify_pressure
+ *
+ * Description:
+ *   Report the number of available I/O buffers to the listeners of
+ *   /proc/pressure/iob.  This function is implemented in
+ *   fs_procfspressure.c.
+ *
+ * Input Parameters:
+ *   navail - The number of I/O buffers that can still be allocated
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS_INCLUDE_PRESSURE
+void iob_notify_pressure(int navail);
+#else
+#  define iob_notify_pressure(navail)
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __INCLUDE_NUTTX_MM_IOB_H */
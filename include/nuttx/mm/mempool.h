@@ -87,6 +87,16 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+/* This structure describes the free blocks cached by one CPU */
+
+struct mempool_cache_s
+{
+  sq_queue_t queue; /* The free block queue of this CPU */
+  size_t     count; /* The number of blocks in the queue */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -110,6 +120,9 @@ struct mempool_s
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  struct mempool_cache_s cache[CONFIG_SMP_NCPUS]; /* The per-CPU caches */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
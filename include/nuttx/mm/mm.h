@@ -198,6 +198,21 @@ struct mm_heap_config_s
   bool                  nokasan;
 };
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+/* The allocations of one call site sampled by the heap profiler */
+
+struct mm_profile_site_s
+{
+  size_t inuse_objs;                             /* Live sampled allocations */
+  size_t inuse_bytes;                            /* Live sampled bytes */
+  size_t alloc_objs;                             /* All sampled allocations */
+  size_t alloc_bytes;                            /* All sampled bytes */
+  uint32_t hash;                                 /* Hash of the call stack */
+  int depth;                                     /* Depth of the call stack */
+  FAR void *stack[CONFIG_MM_HEAP_PROFILE_DEPTH]; /* The call stack */
+};
+#endif
+
 struct mempool_init_s
 {
   FAR const size_t *poolsize;
@@ -489,6 +504,12 @@ void kmm_checkcorruption(void);
 
 #endif /* CONFIG_DEBUG_MM */
 
+/* Functions contained in mm_profile.c **************************************/
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+int mm_profile_site(int index, FAR struct mm_profile_site_s *site);
+#endif
+
 /* Functions contained in fs_procfspressure.c *******************************/
 
 #ifdef CONFIG_FS_PROCFS_INCLUDE_PRESSURE
@@ -130,6 +130,17 @@ struct mqueue_inode_s
   FAR struct pollfd *fds[CONFIG_FS_MQUEUE_NPOLLWAITERS];
 };
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/* This structure describes one message received by file_mq_receivebufs() */
+
+struct mqueue_buf_s
+{
+  FAR void *buf;              /* The message, release with nxmq_freebuf() */
+  size_t msglen;              /* The length of the message */
+  unsigned int prio;          /* The priority of the message */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -793,6 +804,44 @@ int file_mq_setattr(FAR struct file *mq, FAR const struct mq_attr *mq_stat,
 
 int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: file_mq_allocbuf, file_mq_sendbuf, file_mq_receivebufs and
+ *       nxmq_freebuf
+ *
+ * Description:
+ *   Zero-copy message passing.  The sender gets a message buffer with
+ *   file_mq_allocbuf(), fills it in place and queues it with
+ *   file_mq_sendbuf().  The receiver takes one or more buffers off the
+ *   queue with file_mq_receivebufs() and releases each with
+ *   nxmq_freebuf() once done with it.  Queueing follows the rules of
+ *   file_mq_timedsend() and file_mq_timedreceive().
+ *
+ *   The buffers are kernel memory, so only the kernel and tasks in a flat
+ *   build can share them.  nxmq_allocbuf(), nxmq_sendbuf() and
+ *   nxmq_receivebufs() take a message queue descriptor instead.
+ *
+ * Returned Value:
+ *   Zero (OK) or, for file_mq_receivebufs(), the number of messages
+ *   received on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int file_mq_allocbuf(FAR struct file *mq, size_t msglen, FAR void **buf);
+int file_mq_sendbuf(FAR struct file *mq, FAR void *buf, size_t msglen,
+                    unsigned int prio, FAR const struct timespec *abstime);
+ssize_t file_mq_receivebufs(FAR struct file *mq,
+                            FAR struct mqueue_buf_s *bufs, int nbufs,
+                            FAR const struct timespec *abstime);
+void nxmq_freebuf(FAR void *buf);
+
+int nxmq_allocbuf(mqd_t mqdes, size_t msglen, FAR void **buf);
+int nxmq_sendbuf(mqd_t mqdes, FAR void *buf, size_t msglen,
+                 unsigned int prio, FAR const struct timespec *abstime);
+ssize_t nxmq_receivebufs(mqd_t mqdes, FAR struct mqueue_buf_s *bufs,
+                         int nbufs, FAR const struct timespec *abstime);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -58,6 +58,15 @@
  *   ioctl argument:  Pointer to a config_data_s structure to receive the
  *                    config data.  All fields of the structure must be
  *                    specified (i.e. id, instance, pointer and len).
+ *
+ * CFGDIOC_SETCONFIGS - Set several Config Data Items at once
+ *
+ *   ioctl argument:  Pointer to a config_batch_s structure that describes
+ *                    an array of config_data_s items with distinct keys and
+ *                    a non-zero len.  The NVS backend writes the data of
+ *                    all items first and then programs their allocation
+ *                    table entries together.  Every item is power loss
+ *                    safe on its own, the batch as a whole is not atomic.
  */
 
 #define CFGDIOC_GETCONFIG    _CFGDIOC(1)
@@ -66,6 +75,7 @@
 #define CFGDIOC_FINDCONFIG   _CFGDIOC(4)
 #define CFGDIOC_FIRSTCONFIG  _CFGDIOC(5)
 #define CFGDIOC_NEXTCONFIG   _CFGDIOC(6)
+#define CFGDIOC_SETCONFIGS   _CFGDIOC(7)
 
 /****************************************************************************
  * Public Types
@@ -85,6 +95,14 @@ struct config_data_s
   size_t      len;          /* Length of the config data buffer */
 };
 
+/* This structure is used to set several config data items at once */
+
+struct config_batch_s
+{
+  FAR struct config_data_s *items;  /* Array of config data items */
+  size_t                   nitems;  /* Number of items in the array */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -159,6 +159,11 @@
 #define SIOCGIFVLAN        _SIOC(0x0043)  /* Get VLAN interface */
 #define SIOCSIFVLAN        _SIOC(0x0044)  /* Set VLAN interface */
 
+/* RX poll budget ***********************************************************/
+
+#define SIOCGIFBUDGET      _SIOC(0x0045)  /* Get RX poll budget */
+#define SIOCSIFBUDGET      _SIOC(0x0046)  /* Set RX poll budget */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
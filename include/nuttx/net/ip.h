@@ -217,6 +217,21 @@ struct ipv6_stats_s
                            * were neither ICMP, UDP nor TCP */
 };
 #endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPFRAG
+struct ipfrag_stats_s
+{
+  net_stats_t recv;       /* Number of fragments queued for reassembly */
+  net_stats_t reass;      /* Number of datagrams reassembled */
+  net_stats_t dup;        /* Number of fragments replaced by a later copy */
+  net_stats_t timeout;    /* Number of datagrams dropped on the
+                           * reassembly timeout */
+  net_stats_t evict;      /* Number of datagrams dropped to keep the
+                           * reassembly cache in its bound */
+  net_stats_t nomem;      /* Number of fragments dropped for lack of
+                           * memory */
+};
+#endif /* CONFIG_NET_IPFRAG */
 #endif /* CONFIG_NET_STATISTICS */
 
 #ifdef CONFIG_NET_ARP_ACD
@@ -137,10 +137,11 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct file;    /* Forward reference */
-struct stat;    /* Forward reference */
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct file;            /* Forward reference */
+struct stat;            /* Forward reference */
+struct socket;          /* Forward reference */
+struct pollfd;          /* Forward reference */
+struct mm_map_entry_s;  /* Forward reference */
 
 struct sock_intf_s
 {
@@ -181,6 +182,8 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -339,7 +342,11 @@ ssize_t net_ioctl_arglen(uint8_t domain, int cmd);
  * Name: net_lock
  *
  * Description:
- *   Take the network lock
+ *   Take the network lock.  The connections and the network devices are
+ *   protected by their own locks (see conn_lock() and netdev_lock()), so
+ *   this global lock is only needed for the state shared by all of them.
+ *   Drivers should serialize their RX/TX paths with netdev_lock() so that
+ *   the devices can be serviced in parallel on SMP.
  *
  * Input Parameters:
  *   None
@@ -914,6 +921,61 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a vector of messages to a socket with a single
+ *   lookup of the socket.  It is functionally equivalent to sendmmsg()
+ *   except that it is not a cancellation point, it does not modify the
+ *   errno variable and it accepts the internal socket structure as an
+ *   input.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Vector of the messages to send
+ *   vlen      Number of the messages in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of the messages sent, the msg_len of
+ *   each one is updated with the number of bytes sent.  If the first
+ *   message fails, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages from a socket with a
+ *   single lookup of the socket.  It is functionally equivalent to
+ *   recvmmsg() except that it is not a cancellation point, it does not
+ *   modify the errno variable and it accepts the internal socket structure
+ *   as an input.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Vector of the buffers to receive the messages
+ *   vlen      Number of the messages in msgvec
+ *   flags     Receive flags
+ *   timeout   Time limit of the whole operation, checked after each
+ *             message, or NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of the messages received, the msg_len
+ *   of each one is updated with the number of bytes received.  If the
+ *   first message fails, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -1316,6 +1378,25 @@ int psock_shutdown(FAR struct socket *psock, int how);
 struct pollfd; /* Forward reference -- see poll.h */
 int psock_poll(FAR struct socket *psock, struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: psock_mmap
+ *
+ * Description:
+ *   The standard mmap() operation redirects operations on socket
+ *   descriptors to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   map   - The mapping requested, the address family fills in the
+ *           address of the memory mapped.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure.
+ *
+ ****************************************************************************/
+
+int psock_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
 /****************************************************************************
  * Name: psock_dup2
  *
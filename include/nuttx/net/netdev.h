@@ -84,6 +84,20 @@
 
 #define NETDEV_TX_CSUM  (1 << 1) /* Netdev support hardware tx checksum */
 #define NETDEV_RX_CSUM  (1 << 2) /* Netdev support hardware rx checksum */
+#define NETDEV_TX_TSO   (1 << 3) /* Netdev support hardware tcp segmentation */
+#define NETDEV_TX_GSO   (1 << 4) /* Netdev accept software tcp segmentation */
+#define NETDEV_RX_TIME  (1 << 5) /* Netdev provides rx timestamp in d_rxtime */
+
+/* Check if the outgoing packet is a TCP or UDP packet larger than the
+ * segment size, to be segmented by the hardware or before handed to the
+ * driver.
+ */
+
+#ifdef CONFIG_NETDEV_GSO
+#  define NETDEV_IS_GSO(dev) ((dev)->d_gsosize > 0)
+#else
+#  define NETDEV_IS_GSO(dev) false
+#endif
 
 /* Determine the largest possible address */
 
@@ -308,6 +322,10 @@ struct netdev_ifaddr6_s
 };
 
 #ifdef CONFIG_NETDEV_RSS
+/* The size of the Toeplitz hash key used for the RSS hash */
+
+#define NETDEV_RSS_KEYSIZE 40
+
 struct netdev_rss_s
 {
   int      cpu;  /* CPU ID */
@@ -315,12 +333,45 @@ struct netdev_rss_s
 };
 #endif // CONFIG_NETDEV_RSS
 
+#ifdef CONFIG_NETDEV_RXHOOK
+/* Verdicts of the early receive hook on a frame:
+ *
+ *   NETDEV_RXHOOK_PASS   - Give the frame to the network stack.
+ *   NETDEV_RXHOOK_DROP   - Drop the frame.
+ *   NETDEV_RXHOOK_TX     - Send the frame, rewritten in place with d_len
+ *                          updated, back out of the device.
+ *   NETDEV_RXHOOK_STOLEN - The hook has taken d_iob with
+ *                          netdev_iob_clear().
+ */
+
+enum netdev_rxhook_e
+{
+  NETDEV_RXHOOK_PASS = 0,
+  NETDEV_RXHOOK_DROP,
+  NETDEV_RXHOOK_TX,
+  NETDEV_RXHOOK_STOLEN
+};
+
+/* The early receive hook sees the frames received by the device before the
+ * packet sockets and the network stack.  The L2 frame is at NETLLBUF in
+ * dev->d_iob and d_len is its length.  It is called with the device locked
+ * and must not block.
+ */
+
+struct net_driver_s;     /* Forward reference */
+
+typedef CODE enum netdev_rxhook_e
+  (*netdev_rxhook_t)(FAR struct net_driver_s *dev, FAR void *arg);
+#endif
+
 /* This structure collects information that is specific to a specific network
  * interface driver.  If the hardware platform supports only a single
  * instance of this structure.
  */
 
 struct devif_callback_s; /* Forward reference */
+struct arp_entry_s;      /* Forward reference */
+struct neighbor_entry_s; /* Forward reference */
 
 struct net_driver_s
 {
@@ -449,6 +500,18 @@ struct net_driver_s
   struct iob_queue_s d_arpout;
 #endif
 
+  /* The last hit of the ARP and Neighbor Tables, which short-circuits the
+   * lookups of the bulk flows.
+   */
+
+#ifdef CONFIG_NET_ARP
+  FAR struct arp_entry_s *d_arplast;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  FAR struct neighbor_entry_s *d_nelast;
+#endif
+
   /* The d_buf array is used to hold incoming and outgoing packets. The
    * device driver should place incoming data into this buffer.  When sending
    * data, the device driver should read the link level headers and the
@@ -505,6 +568,40 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* When the outgoing packet is a TCP packet larger than the MSS,
+   * d_gsosize is non-zero and holds the MSS it has to be segmented to,
+   * either by the hardware (NETDEV_TX_TSO) or by the network stack before
+   * the packet is handed to the driver (NETDEV_TX_GSO).  UDP packets
+   * holding several datagrams are always segmented by the network stack.
+   */
+
+  uint16_t d_gsosize;
+#endif
+
+  /* When the TCP or UDP checksum of the outgoing packet is left to the
+   * hardware (NETDEV_TX_CSUM), d_txcsum is true and the checksum field only
+   * holds the pseudo header sum the hardware has to complete.
+   */
+
+  bool d_txcsum;
+
+#ifdef CONFIG_NETDEV_RXHOOK
+  /* The early receive hook, see netdev_rxhook_attach() */
+
+  netdev_rxhook_t d_rxhook;
+  FAR void *d_rxhookarg;
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+  /* The TCP segment held back by the generic receive offload, the
+   * following in-order segments of the same flow are appended to it until
+   * netdev_gro_flush() hands it to the network stack.
+   */
+
+  FAR struct iob_s *d_gro;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -841,6 +938,26 @@ void netdev_carrier_off(FAR struct net_driver_s *dev);
 
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 
+/****************************************************************************
+ * Name: net_chksum_partial
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer in the CPU byte order to a 32-bit one's
+ *   complement sum.  This is the inner loop of chksum() which could be
+ *   replaced by an optimized version with CONFIG_LIBC_ARCH_NET_CHKSUM.
+ *
+ * Input Parameters:
+ *   sum  - The partial sum carried over from a previous call
+ *   data - Beginning of the data to add, there is no alignment requirement
+ *   len  - Length of the data to add
+ *
+ * Returned Value:
+ *   The updated sum, which still has to be folded to 16 bits.
+ *
+ ****************************************************************************/
+
+uint32_t net_chksum_partial(uint32_t sum, FAR const void *data, size_t len);
+
 /****************************************************************************
  * Name: chksum_iob
  *
@@ -1149,6 +1266,104 @@ void netdev_iob_release(FAR struct net_driver_s *dev);
 FAR struct iob_s *netdev_iob_clone(FAR struct net_driver_s *dev,
                                    bool throttled);
 
+/****************************************************************************
+ * Name: netdev_rss_key
+ *
+ * Description:
+ *   Return the NETDEV_RSS_KEYSIZE bytes Toeplitz key of the RSS hash
+ *   reported by SIOCNOTIFYRECVCPU.  The devices must hash the received
+ *   packets with the same key for the steering to find their flows.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+FAR const uint8_t *netdev_rss_key(void);
+#endif
+
+/****************************************************************************
+ * Name: netdev_rxhook_attach
+ *
+ * Description:
+ *   Attach the early receive hook of the device, or detach it with a NULL
+ *   'hook'.  A device has one hook, a module that needs several chains
+ *   them in its own hook.
+ *
+ * Input Parameters:
+ *   dev  - The network device
+ *   hook - The hook function run on each received frame, or NULL
+ *   arg  - The argument passed to the hook
+ *
+ * Returned Value:
+ *   OK on success; -EBUSY if another hook is attached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXHOOK
+int netdev_rxhook_attach(FAR struct net_driver_s *dev,
+                         netdev_rxhook_t hook, FAR void *arg);
+
+/****************************************************************************
+ * Name: netdev_rxhook_input
+ *
+ * Description:
+ *   Run the early receive hook of the device on the frame in dev->d_iob
+ *   and carry out its verdict.
+ *
+ * Returned Value:
+ *   false if the frame goes on to the network stack as usual.  true if the
+ *   hook has consumed it: the frame has either been dropped or stolen, or
+ *   it is left with d_len > 0 to be sent back by the caller.
+ *
+ * Assumptions:
+ *   The caller has locked the network device.
+ *
+ ****************************************************************************/
+
+bool netdev_rxhook_input(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Try to coalesce the received packet in dev->d_iob with the TCP segment
+ *   held back on the device.  The held segment is passed to 'input' first
+ *   if the packet doesn't belong to it, and the packet then becomes the
+ *   new held segment if it is eligible for the coalescing.
+ *
+ * Input Parameters:
+ *   dev   - The network device holding the received L2 packet
+ *   input - The L2 input function used to pass a held segment to the stack
+ *
+ * Returned Value:
+ *   true if the packet has been taken by the generic receive offload, false
+ *   if the caller has to handle it as usual.
+ *
+ * Assumptions:
+ *   The caller has locked the network device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+bool netdev_gro_receive(FAR struct net_driver_s *dev,
+                        CODE void (*input)(FAR struct net_driver_s *dev));
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass the TCP segment held back on the device to 'input', it must be
+ *   called at the end of each receive batch.
+ *
+ * Assumptions:
+ *   The caller has locked the network device.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct net_driver_s *dev,
+                      CODE void (*input)(FAR struct net_driver_s *dev));
+#endif
+
 /****************************************************************************
  * Name: netdev_ipv6_add/del
  *
@@ -1345,4 +1560,19 @@ int netdev_checksum_offset(FAR struct net_driver_s *dev);
 
 uint16_t netdev_upperlayer_header_checksum(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_checksum_complete
+ *
+ * Description:
+ *   Complete in software the TCP or UDP checksum left to the hardware,
+ *   for the packet which is not handed to the driver right away, or is
+ *   looped back to ourself.
+ *
+ * Input Parameters:
+ *   dev  -  The driver structure
+ *
+ ****************************************************************************/
+
+void netdev_checksum_complete(FAR struct net_driver_s *dev);
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
@@ -127,6 +127,14 @@ struct netdev_lowerhalf_s
   uint8_t rxtype;
   uint8_t priority;
 
+#ifdef CONFIG_NETDEV_RSS
+  /* Number of RX queues, a device with more than one queue receives with
+   * receive_queue() and reports them with netdev_lower_rxqueue_ready().
+   */
+
+  uint8_t rxqnum;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -180,6 +188,37 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+  /* rxint - Enable or disable the RX interrupt, optional.  With
+   *         CONFIG_NETDEV_NAPI, the upper half disables it when the driver
+   *         reports received packets and enables it again once all of them
+   *         have been polled, the driver should then raise the interrupt
+   *         for the packets already pending.  May be called from the
+   *         interrupt handler through netdev_lower_rxready().
+   */
+
+  CODE void (*rxint)(FAR struct netdev_lowerhalf_s *dev, bool enable);
+
+#ifdef CONFIG_NETDEV_RSS
+  /* receive_queue - Try to receive a packet from the RX queue 'queue' of a
+   *                 multi queue device, non-blocking.
+   *   Returned Value:
+   *     A netpkt contains the packet, or NULL if no more packets.
+   */
+
+  CODE FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                      int queue);
+
+  /* rss_steer - Steer the received flows with the RSS hash 'hash' to the
+   *             RX queue 'queue', optional.  The hash is the Toeplitz hash
+   *             with the key of netdev_rss_key(), the device normally
+   *             updates the entry of its redirection table indexed by the
+   *             low bits of the hash.
+   */
+
+  CODE int (*rss_steer)(FAR struct netdev_lowerhalf_s *dev, uint32_t hash,
+                        int queue);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -303,6 +342,26 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxqueue_ready
+ *
+ * Description:
+ *   Notifies the networking layer about RX packets ready to read on the RX
+ *   queue 'queue' of a multi queue device.  In the NETDEV_RX_THREAD_RSS
+ *   mode, the queue is polled by the thread bound to the CPU
+ *   queue % CONFIG_SMP_NCPUS.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The RX queue
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+void netdev_lower_rxqueue_ready(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -402,6 +461,25 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
 void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                  enum netpkt_type_e type);
 
+/****************************************************************************
+ * Name: netpkt_concat
+ *
+ * Description:
+ *   Append the netpkt pkt2 to the end of pkt1, e.g. the buffers of a frame
+ *   received in several pieces.  pkt2 is released from the quota, it is
+ *   freed together with pkt1 later.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   pkt1 - The packet to append to
+ *   pkt2 - The packet appended
+ *   type - Whether used for TX or RX
+ *
+ ****************************************************************************/
+
+void netpkt_concat(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt1,
+                   FAR netpkt_t *pkt2, enum netpkt_type_e type);
+
 /****************************************************************************
  * Name: netpkt_copyin
  *
@@ -555,6 +633,67 @@ bool netpkt_is_fragmented(FAR netpkt_t *pkt);
 int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                   FAR struct iovec *iov, int iovcnt);
 
+/****************************************************************************
+ * Name: netpkt_get_txcsum
+ *
+ * Description:
+ *   Check whether the hardware has to complete the TCP or UDP checksum of
+ *   the packet being transmitted, it is only the case on the devices with
+ *   NETDEV_TX_CSUM.  The checksum field holds the pseudo header sum then,
+ *   the hardware adds the bytes from 'start' to the end of the packet and
+ *   stores the complement of the sum at 'offset'.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet being transmitted
+ *   start  - Returns where the hardware starts the sum
+ *   offset - Returns where the hardware stores the checksum
+ *
+ *   Both are counted from the beginning of the L2 header
+ *
+ * Returned Value:
+ *   True if the hardware has to complete the checksum.
+ *
+ ****************************************************************************/
+
+bool netpkt_get_txcsum(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                       FAR uint16_t *start, FAR uint16_t *offset);
+
+/****************************************************************************
+ * Name: netpkt_set_rxcsum
+ *
+ * Description:
+ *   Report whether the hardware has verified the checksums of the packet
+ *   being received, so the network stack skips its own verification.  It
+ *   is for the drivers which check the packets one by one, and has to be
+ *   called for each packet they return from the receive() operation.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   valid - True if the IP and the TCP or UDP checksums are good
+ *
+ ****************************************************************************/
+
+void netpkt_set_rxcsum(FAR struct netdev_lowerhalf_s *dev, bool valid);
+
+/****************************************************************************
+ * Name: netpkt_settimestamp
+ *
+ * Description:
+ *   Stamp a received packet with its hardware reception time, in the time
+ *   base of the device PTP clock.  Used by the drivers setting
+ *   NETDEV_RX_TIME, the packets left unstamped get the current time.
+ *
+ * Input Parameters:
+ *   pkt - The packet being received
+ *   ts  - The reception timestamp
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_HWTSTAMP
+#  define netpkt_settimestamp(pkt, ts) ((pkt)->io_tstamp = *(ts))
+#endif
+
 /****************************************************************************
  * Name: netpkt_tryadd_queue
  *
@@ -94,6 +94,10 @@ struct net_stats_s
   struct ipv6_stats_s ipv6;     /* IPv6 statistics */
 #endif
 
+#ifdef CONFIG_NET_IPFRAG
+  struct ipfrag_stats_s ipfrag; /* IP reassembly statistics */
+#endif
+
 #ifdef CONFIG_NET_ICMP
   struct icmp_stats_s icmp;     /* ICMP statistics */
 #endif
@@ -36,10 +36,31 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+/* The scheduling state of one CPU, a task switch is encoded from the
+ * NOTE_SUSPEND and NOTE_RESUME pair.
+ */
+
+struct notestream_cpu_s
+{
+  bool valid;                /* current_pid is known */
+  bool pendingswitch;        /* Switch postponed until the IRQ leaves */
+  uint8_t current_state;     /* State of the suspended task */
+  uint8_t current_priority;  /* Priority of the running task */
+  uint8_t next_priority;     /* Priority of the resumed task */
+  int intr_nest;             /* Interrupt nest level */
+  pid_t current_pid;         /* The running task */
+  pid_t next_pid;            /* The resumed task */
+};
+#endif
+
 struct notestream_driver_s
 {
   struct note_driver_s driver;
   struct lib_outstream_s *stream;
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+  struct notestream_cpu_s cpu[CONFIG_SMP_NCPUS];
+#endif
 };
 
 #if defined(__cplusplus)
@@ -42,6 +42,14 @@
 #define PCI_RESOURCE_MEM_64   0x00000004
 #define PCI_RESOURCE_PREFETCH 0x00000008 /* No side effects */
 
+/* Interrupt types accepted by pci_alloc_irq_vectors() */
+
+#define PCI_IRQ_INTX          0x00000001 /* Legacy INTx interrupt */
+#define PCI_IRQ_MSI           0x00000002 /* MSI, a single vector */
+#define PCI_IRQ_MSIX          0x00000004 /* MSI-X, one vector per entry */
+#define PCI_IRQ_AFFINITY      0x00000008 /* Spread vectors over the CPUs */
+#define PCI_IRQ_ALL_TYPES     (PCI_IRQ_INTX | PCI_IRQ_MSI | PCI_IRQ_MSIX)
+
 /* The PCI interface treats multi-function devices as independent
  * devices.  The slot/function address of each device is encoded
  * in a single byte as follows:
@@ -834,6 +842,68 @@ void pci_release_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
 int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
+/****************************************************************************
+ * Name: pci_alloc_irq_vectors
+ *
+ * Description:
+ *   Allocate and connect between min_vecs and max_vecs interrupt vectors,
+ *   trying MSI-X, then MSI, then INTx as allowed by flags.  With MSI-X,
+ *   irq[i] is the vector of MSI-X table entry i, so multi-queue devices
+ *   can bind one vector to each queue.  With PCI_IRQ_AFFINITY and
+ *   CONFIG_IRQ_AFFINITY, vector i is routed to CPU i % CONFIG_SMP_NCPUS.
+ *
+ * Input Parameters:
+ *   dev      - PCI device
+ *   irq      - allocated vectors, at least max_vecs entries
+ *   min_vecs - minimum number of vectors required
+ *   max_vecs - maximum number of vectors wanted
+ *   flags    - PCI_IRQ_* flags
+ *
+ * Return value:
+ *   Return the number of vectors on success or a negated errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_alloc_irq_vectors(FAR struct pci_device_s *dev, FAR int *irq,
+                          int min_vecs, int max_vecs, unsigned int flags);
+
+/****************************************************************************
+ * Name: pci_free_irq_vectors
+ *
+ * Description:
+ *   Disable MSI/MSI-X and release the vectors of pci_alloc_irq_vectors().
+ *
+ * Input Parameters:
+ *   dev - PCI device
+ *   irq - allocated vectors
+ *   num - number of vectors
+ *
+ ****************************************************************************/
+
+void pci_free_irq_vectors(FAR struct pci_device_s *dev, FAR int *irq,
+                          int num);
+
+#ifdef CONFIG_PCI_MSIX
+/****************************************************************************
+ * Name: pci_msix_mask_irq
+ *
+ * Description:
+ *   Mask or unmask one MSI-X vector at the device, e.g. to quiesce a single
+ *   queue while it is being polled.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - MSI-X table entry
+ *   mask  - true to mask, false to unmask
+ *
+ * Return value:
+ *   OK on success or a negated errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_msix_mask_irq(FAR struct pci_device_s *dev, int index, bool mask);
+#endif
+
 /****************************************************************************
  * Name: pci_register_driver
  *
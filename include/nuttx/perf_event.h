@@ -0,0 +1,131 @@
+/****************************************************************************
+ * include/nuttx/perf_event.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_PERF_EVENT_H
+#define __INCLUDE_NUTTX_PERF_EVENT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL commands of /dev/perf, one open file counts one event.
+ *
+ * PERFIOC_SETUP
+ *   Description: Select the event counted by the file
+ *   Argument:    A read-only pointer to struct perf_event_attr_s
+ *   Return:      Zero (OK) on success, -ENOSPC if no hardware counter is
+ *                free, -ENOENT if the event is not supported
+ *
+ * PERFIOC_ENABLE, PERFIOC_DISABLE
+ *   Description: Start or stop counting
+ *   Argument:    Ignored
+ *
+ * PERFIOC_RESET
+ *   Description: Clear the count
+ *   Argument:    Ignored
+ *
+ * read() of the file returns the count as a uint64_t.
+ */
+
+#define PERFIOC_SETUP                _PERFIOC(0x0001)
+#define PERFIOC_ENABLE               _PERFIOC(0x0002)
+#define PERFIOC_DISABLE              _PERFIOC(0x0003)
+#define PERFIOC_RESET                _PERFIOC(0x0004)
+
+/* The event types */
+
+#define PERF_TYPE_HARDWARE           0 /* config is a PERF_COUNT_HW_* */
+#define PERF_TYPE_RAW                4 /* config is an architecture event */
+
+/* The generic hardware events */
+
+#define PERF_COUNT_HW_CPU_CYCLES          0
+#define PERF_COUNT_HW_INSTRUCTIONS        1
+#define PERF_COUNT_HW_CACHE_REFERENCES    2
+#define PERF_COUNT_HW_CACHE_MISSES        3
+#define PERF_COUNT_HW_BRANCH_INSTRUCTIONS 4
+#define PERF_COUNT_HW_BRANCH_MISSES       5
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The event counted by a /dev/perf file.  With pid >= 0, the event is
+ * only counted while that task runs, on any CPU.  With pid == -1, the
+ * event is counted on the CPU cpu, or on all CPUs if cpu is -1.
+ */
+
+struct perf_event_attr_s
+{
+  uint32_t type;             /* PERF_TYPE_* */
+  uint64_t config;           /* The event of the type */
+  pid_t    pid;              /* The task counted, -1 for CPU counting */
+  int      cpu;              /* The CPU counted with pid -1, -1 for all */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+struct tcb_s;
+
+/****************************************************************************
+ * Name: perf_event_switch
+ *
+ * Description:
+ *   Save the counts of the task events of the suspended task and restart
+ *   the counters of the resumed task.  Called by the scheduler on every
+ *   context switch.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PERF
+void perf_event_switch(FAR struct tcb_s *from, FAR struct tcb_s *to);
+#else
+#  define perf_event_switch(from, to)
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_PERF_EVENT_H */
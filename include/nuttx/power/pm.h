@@ -386,6 +386,28 @@ struct pm_wakelock_s
 #endif
 };
 
+#ifdef CONFIG_PM_QOS
+/* A wakeup latency constraint, see pm_qos_add() */
+
+struct pm_qos_s
+{
+  struct dq_entry_s node;    /* Supports a doubly linked list */
+  uint32_t          latency; /* Maximum tolerable wakeup latency in us */
+};
+#endif
+
+#ifdef CONFIG_PM_HIBERNATE
+struct mtd_dev_s;
+
+/* One RAM region saved by pm_hibernate() */
+
+struct pm_hibernate_region_s
+{
+  FAR void *base;  /* Start of the region */
+  size_t    size;  /* Size of the region in bytes */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -463,6 +485,19 @@ FAR const struct pm_governor_s *pm_greedy_governor_initialize(void);
 
 FAR const struct pm_governor_s *pm_activity_governor_initialize(void);
 
+/****************************************************************************
+ * Name: pm_qos_governor_initialize
+ *
+ * Description:
+ *   Return the QoS governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_qos_governor_initialize(void);
+
 /****************************************************************************
  * Name: pm_set_governor
  *
@@ -782,6 +817,94 @@ void pm_wakelock_staytimeout(FAR struct pm_wakelock_s *wakelock, int ms);
 
 int pm_wakelock_staycount(FAR struct pm_wakelock_s *wakelock);
 
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   Register the maximum wakeup latency that a driver or a task can
+ *   tolerate in a domain.  The governor does not select a state that takes
+ *   longer to leave than the smallest latency registered.
+ *
+ * Input Parameters:
+ *   domain  - The PM domain of the constraint
+ *   qos     - The constraint, owned by the caller until pm_qos_remove()
+ *   latency - The maximum tolerable wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PM_QOS
+void pm_qos_add(int domain, FAR struct pm_qos_s *qos, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the latency of a constraint registered with pm_qos_add().
+ *
+ * Input Parameters:
+ *   domain  - The PM domain of the constraint
+ *   qos     - The constraint
+ *   latency - The new maximum tolerable wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_update(int domain, FAR struct pm_qos_s *qos, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Remove a constraint registered with pm_qos_add().
+ *
+ * Input Parameters:
+ *   domain - The PM domain of the constraint
+ *   qos    - The constraint
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(int domain, FAR struct pm_qos_s *qos);
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the smallest latency registered in a domain.
+ *
+ * Input Parameters:
+ *   domain - The PM domain to check
+ *
+ * Returned Value:
+ *   The smallest tolerable wakeup latency in microseconds, or UINT32_MAX
+ *   if there is no constraint.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(int domain);
+#else
+#  define pm_qos_add(d,q,l)
+#  define pm_qos_update(d,q,l)
+#  define pm_qos_remove(d,q)
+#  define pm_qos_latency(d)                   (UINT32_MAX)
+#endif
+
 /****************************************************************************
  * Name: pm_checkstate
  *
@@ -941,6 +1064,63 @@ bool pm_idle_lock(int cpu);
 #  define pm_idle_lock(cpu) (0)
 #endif
 
+#ifdef CONFIG_PM_HIBERNATE
+
+/****************************************************************************
+ * Name: pm_hibernate
+ *
+ * Description:
+ *   Put every PM domain into PM_SLEEP, save a compressed image of the RAM
+ *   regions to the MTD device and power off the board.  The image starts
+ *   at the first block of the device, which should be a partition reserved
+ *   for it.
+ *
+ *   The regions must cover all the RAM that the system uses: data, bss,
+ *   heaps and stacks.  They must not include the memory used by the board
+ *   to call pm_hibernate_resume(), mainly its stack.
+ *
+ * Input Parameters:
+ *   mtd      - The MTD device that receives the image.
+ *   regions  - The RAM regions to save.
+ *   nregions - The number of regions.
+ *
+ * Returned Value:
+ *   Zero (OK) after the board resumed from the image, or a negated errno
+ *   value if the system could not hibernate.  In all cases the PM domains
+ *   are back in their previous state.
+ *
+ * Assumptions:
+ *   Called from a task, not from an interrupt handler.  The MTD driver
+ *   must be able to write with interrupts disabled.
+ *
+ ****************************************************************************/
+
+int pm_hibernate(FAR struct mtd_dev_s *mtd,
+                 FAR const struct pm_hibernate_region_s *regions,
+                 int nregions);
+
+/****************************************************************************
+ * Name: pm_hibernate_resume
+ *
+ * Description:
+ *   Restore the RAM from an image saved by pm_hibernate() and continue in
+ *   pm_hibernate().  Called by the board early in the boot, on a stack that
+ *   is not part of the image, once the hardware that does not register PM
+ *   callbacks is initialized.
+ *
+ * Input Parameters:
+ *   image - The address of the image in memory mapped flash.
+ *
+ * Returned Value:
+ *   Does not return if the image is valid, otherwise returns -ENOENT and
+ *   the board should continue with a normal boot.
+ *
+ ****************************************************************************/
+
+int pm_hibernate_resume(FAR const void *image);
+
+#endif /* CONFIG_PM_HIBERNATE */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -976,6 +1156,10 @@ bool pm_idle_lock(int cpu);
 #  define pm_wakelock_relax(w)
 #  define pm_wakelock_staytimeout(w,m)
 #  define pm_wakelock_staycount(w)            (0)
+#  define pm_qos_add(d,q,l)
+#  define pm_qos_update(d,q,l)
+#  define pm_qos_remove(d,q)
+#  define pm_qos_latency(d)                   (UINT32_MAX)
 #  define pm_checkstate(domain)               (0)
 #  define pm_changestate(domain,state)        (0)
 #  define pm_querystate(domain)               (0)
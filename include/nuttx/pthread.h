@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <pthread.h>
 #include <sched.h>
 
@@ -104,6 +105,20 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_PTHREAD_CACHE
+/* Statistics of the pthread TCB and stack cache */
+
+struct pthread_cache_stats_s
+{
+  uint32_t ncached;   /* Number of TCBs currently cached */
+  uint32_t hits;      /* Creations that reused a cached TCB and stack */
+  uint32_t misses;    /* Creations that allocated a new TCB */
+  uint32_t ncreated;  /* Number of creations timed */
+  uint64_t total;     /* Total creation time in perf_gettime() units */
+  clock_t max;        /* Longest creation time in perf_gettime() units */
+};
+#endif
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -168,6 +183,24 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
 
 void nx_pthread_exit(FAR void *exit_value) noreturn_function;
 
+/****************************************************************************
+ * Name: nx_pthread_cache_stats
+ *
+ * Description:
+ *   Get the statistics of the pthread TCB and stack cache.
+ *
+ * Input Parameters:
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_CACHE
+void nx_pthread_cache_stats(FAR struct pthread_cache_stats_s *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
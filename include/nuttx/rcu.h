@@ -0,0 +1,187 @@
+/****************************************************************************
+ * include/nuttx/rcu.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RCU_H
+#define __INCLUDE_NUTTX_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Publish a pointer to an object for the readers, the object must be
+ * completely initialized before.
+ */
+
+#define rcu_assign_pointer(p, v) \
+  do \
+    { \
+      SMP_MB(); \
+      (p) = (v); \
+    } \
+  while (0)
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The callback of call_rcu(), the head is usually embedded in the object
+ * to reclaim.
+ */
+
+struct rcu_head_s;
+typedef CODE void (*rcu_callback_t)(FAR struct rcu_head_s *head);
+
+struct rcu_head_s
+{
+  FAR struct rcu_head_s *next;
+  rcu_callback_t func;
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The readers count themselves in the counter of the current epoch.  Only
+ * for the inline functions below.
+ */
+
+EXTERN atomic_t g_rcu_epoch;
+EXTERN atomic_t g_rcu_readers[2];
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter a read-side section.  The objects which the section finds stay
+ *   valid until it is left.  The section never blocks the writers or the
+ *   scheduler, may nest and may be entered from the interrupt handler.
+ *
+ * Returned Value:
+ *   The epoch of the section which must be passed to rcu_read_unlock().
+ *
+ ****************************************************************************/
+
+static inline_function int rcu_read_lock(void)
+{
+  int epoch;
+
+  for (; ; )
+    {
+      epoch = atomic_read_acquire(&g_rcu_epoch) & 1;
+      atomic_fetch_add(&g_rcu_readers[epoch], 1);
+
+      /* Order the count before the re-check, see synchronize_rcu() */
+
+      SMP_MB();
+
+      /* Retry in the new epoch if a grace period started meanwhile, it may
+       * not wait for this counter any more.
+       */
+
+      if ((atomic_read_acquire(&g_rcu_epoch) & 1) == epoch)
+        {
+          return epoch;
+        }
+
+      atomic_fetch_sub(&g_rcu_readers[epoch], 1);
+    }
+}
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave a read-side section.
+ *
+ * Input Parameters:
+ *   epoch - The value returned by rcu_read_lock()
+ *
+ ****************************************************************************/
+
+static inline_function void rcu_read_unlock(int epoch)
+{
+  atomic_fetch_sub(&g_rcu_readers[epoch], 1);
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait for the end of a grace period: all the read-side sections which
+ *   may have seen an object unlinked by the caller are left, so it can be
+ *   freed or reused.  This sleeps and must not be called from a read-side
+ *   section or the interrupt handler.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void);
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Call func with head from the low priority work queue after a grace
+ *   period.  This doesn't block and may be called from the interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   head - The callback storage, usually in the object to reclaim
+ *   func - The callback
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+void call_rcu(FAR struct rcu_head_s *head, rcu_callback_t func);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_RCU_H */
@@ -30,6 +30,7 @@
 #include <nuttx/compiler.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -41,6 +42,31 @@
 
 struct regmap_bus_s;
 
+/* Register cache type, see CONFIG_REGMAP_CACHE. */
+
+enum regcache_type_e
+{
+  REGCACHE_NONE = 0,    /* No caching, every access goes to the bus */
+  REGCACHE_FLAT,        /* Flat array covering 0..max_register */
+  REGCACHE_RBTREE       /* Red-black tree, for sparse register maps */
+};
+
+/* An inclusive range of register addresses. */
+
+struct regmap_range_s
+{
+  unsigned int range_min;
+  unsigned int range_max;
+};
+
+/* Power-on default value of one register, used to seed the cache. */
+
+struct regmap_reg_default_s
+{
+  unsigned int reg;
+  unsigned int def;
+};
+
 /* Single byte register read/write. */
 
 typedef CODE int (*reg_read_t)(FAR struct regmap_bus_s *bus,
@@ -100,6 +126,30 @@ struct regmap_config_s
    */
 
   bool disable_locking;
+
+  /* Register cache used to serve reads of non-volatile registers from
+   * RAM. Only effective if CONFIG_REGMAP_CACHE is enabled.
+   */
+
+  enum regcache_type_e cache_type;
+
+  /* Highest valid register address, mandatory for REGCACHE_FLAT. */
+
+  unsigned int max_register;
+
+  /* Registers whose value can change behind the driver's back (status,
+   * interrupt, FIFO...). They are never cached.
+   */
+
+  FAR const struct regmap_range_s *volatile_ranges;
+  unsigned int num_volatile_ranges;
+
+  /* Optional power-on defaults, the cache starts with them so the first
+   * read of these registers doesn't touch the bus.
+   */
+
+  FAR const struct regmap_reg_default_s *reg_defaults;
+  unsigned int num_reg_defaults;
 };
 
 struct regmap_s;
@@ -312,6 +362,79 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg,
 int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
                      FAR void *val, unsigned int val_count);
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write the bits selected by mask. The register is written
+ *   only if its value actually changes, and with the register cache the
+ *   read is served from RAM.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - bits to be updated.
+ *   val  - new value of the bits selected by mask.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val);
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/****************************************************************************
+ * Name: regcache_cache_only
+ *
+ * Description:
+ *   While enabled, writes to non-volatile registers only update the cache
+ *   and are marked dirty; they reach the hardware on regcache_sync(). This
+ *   collapses a sequence of writes to the same register (e.g. a codec
+ *   initialization) into a single bus transaction.
+ *
+ * Input Parameters:
+ *   map    - regmap handler, from regmap bus init function return.
+ *   enable - true to defer writes, false to write through again.
+ *
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable);
+
+/****************************************************************************
+ * Name: regcache_sync
+ *
+ * Description:
+ *   Write all dirty registers of the cache to the hardware.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ *
+ * Description:
+ *   Mark every cached register dirty, e.g. after the device lost power, so
+ *   that the next regcache_sync() restores the whole register state.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map);
+
+#endif /* CONFIG_REGMAP_CACHE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
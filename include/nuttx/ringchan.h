@@ -0,0 +1,273 @@
+/****************************************************************************
+ * include/nuttx/ringchan.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RINGCHAN_H
+#define __INCLUDE_NUTTX_RINGCHAN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The control device creates the channels, every channel is registered as
+ * RINGCHAN_DIR "/" name and is removed again with unlink().
+ */
+
+#define RINGCHAN_CTLPATH      "/dev/ringctl"
+#define RINGCHAN_DIR          "/dev/ring"
+#define RINGCHAN_NAME_MAX     32
+
+/* IOCTL commands of the control device
+ *
+ * RINGCHANIOC_CREATE
+ *   Description: Create a channel
+ *   Argument:    A read-only pointer to struct ringchan_create_s
+ *   Return:      Zero (OK) on success, -EEXIST if the channel exists,
+ *                -EINVAL if the geometry is not valid
+ *
+ * IOCTL commands of a channel
+ *
+ * RINGCHANIOC_GETSIZE
+ *   Description: Return the size of the mapping of the channel
+ *   Argument:    A pointer to a size_t
+ *
+ * RINGCHANIOC_WAIT
+ *   Description: Sleep until the channel has a message (RINGCHAN_WAIT_DATA)
+ *                or a free slot (RINGCHAN_WAIT_SPACE).  Returns -EAGAIN
+ *                instead if the file is non-blocking.  poll() waits for
+ *                POLLIN and POLLOUT the same way, with a timeout.
+ *   Argument:    RINGCHAN_WAIT_DATA or RINGCHAN_WAIT_SPACE
+ *
+ * RINGCHANIOC_WAKEUP
+ *   Description: Wake up the sides that ringchan_waiting() reported
+ *                sleeping
+ *   Argument:    The RINGCHAN_WAIT_* flags to wake up
+ */
+
+#define RINGCHANIOC_CREATE    _RINGCHANIOC(0x0001)
+#define RINGCHANIOC_GETSIZE   _RINGCHANIOC(0x0002)
+#define RINGCHANIOC_WAIT      _RINGCHANIOC(0x0003)
+#define RINGCHANIOC_WAKEUP    _RINGCHANIOC(0x0004)
+
+/* Channel flags */
+
+#define RINGCHAN_MPSC         (1 << 0) /* Several producers send */
+
+/* The sides sleeping in the kernel */
+
+#define RINGCHAN_WAIT_DATA    (1 << 0) /* The consumer waits for a message */
+#define RINGCHAN_WAIT_SPACE   (1 << 1) /* A producer waits for a slot */
+
+/* The layout of a mapping.  The header takes three cache lines, so that
+ * the producer and the consumer indexes do not share one, and is followed
+ * by the slots.
+ */
+
+#define RINGCHAN_CACHELINE    64
+#define RINGCHAN_STRIDE(entsize) \
+  (((entsize) + 2 * sizeof(uint32_t) + 7) & ~7)
+#define RINGCHAN_SIZE(nentries, entsize) \
+  (3 * RINGCHAN_CACHELINE + (nentries) * RINGCHAN_STRIDE(entsize))
+
+#define RINGCHAN_SLOT(r, i) \
+  ((FAR struct ringchan_slot_s *)((FAR uint8_t *)(r) + (r)->slots + \
+                                  ((i) & ((r)->nentries - 1)) * (r)->stride))
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* The argument of RINGCHANIOC_CREATE */
+
+struct ringchan_create_s
+{
+  char     name[RINGCHAN_NAME_MAX]; /* The name under RINGCHAN_DIR */
+  uint32_t nentries;                /* Number of slots, a power of two */
+  uint32_t entsize;                 /* Maximum size of a message */
+  uint32_t flags;                   /* RINGCHAN_MPSC */
+};
+
+/* A slot.  The sequence of slot i starts at i.  A producer claims the
+ * slot when the sequence equals the producer index and publishes the
+ * message by setting it to the index plus one.  The consumer takes the
+ * message and releases the slot for the next lap by setting the sequence
+ * to its index plus the number of slots.
+ */
+
+struct ringchan_slot_s
+{
+  volatile uint32_t seq;            /* See above */
+  uint32_t          len;            /* The length of the message */
+  uint8_t           data[1];        /* The message, up to entsize bytes */
+};
+
+/* The header of the mapping, set up by the kernel.  head and tail are free
+ * running, the slot of an index is the index masked with nentries - 1.
+ */
+
+struct ringchan_s
+{
+  uint32_t          flags;          /* RINGCHAN_MPSC */
+  uint32_t          nentries;       /* Number of slots */
+  uint32_t          entsize;        /* Maximum size of a message */
+  uint32_t          stride;         /* Distance between two slots */
+  uint32_t          slots;          /* Offset of the first slot */
+  uint32_t          size;           /* Size of the mapping */
+  volatile uint32_t waiting;        /* RINGCHAN_WAIT_* of sleeping sides */
+  uint8_t           reserved1[RINGCHAN_CACHELINE - 7 * sizeof(uint32_t)];
+  volatile uint32_t head;           /* Next slot claimed by a producer */
+  uint8_t           reserved2[RINGCHAN_CACHELINE - sizeof(uint32_t)];
+  volatile uint32_t tail;           /* Next slot read by the consumer */
+  uint8_t           reserved3[RINGCHAN_CACHELINE - sizeof(uint32_t)];
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringchan_send
+ *
+ * Description:
+ *   Copy a message into the next free slot of a mapped channel.  Only
+ *   channels created with RINGCHAN_MPSC may have several producers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EAGAIN if all slots are in use or -EMSGSIZE if
+ *   the message is longer than the entries of the channel.
+ *
+ ****************************************************************************/
+
+static inline int ringchan_send(FAR struct ringchan_s *ring,
+                                FAR const void *data, size_t len)
+{
+  FAR struct ringchan_slot_s *slot;
+  uint32_t pos;
+  uint32_t seq;
+
+  if (len > ring->entsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+  for (; ; )
+    {
+      slot = RINGCHAN_SLOT(ring, pos);
+      seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+      if ((int32_t)(seq - pos) < 0)
+        {
+          return -EAGAIN;
+        }
+      else if (seq != pos)
+        {
+          /* Another producer claimed the slot meanwhile */
+
+          pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        }
+      else if ((ring->flags & RINGCHAN_MPSC) == 0)
+        {
+          __atomic_store_n(&ring->head, pos + 1, __ATOMIC_RELAXED);
+          break;
+        }
+      else if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1,
+                                           true, __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED))
+        {
+          break;
+        }
+    }
+
+  memcpy(slot->data, data, len);
+  slot->len = len;
+  __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_SEQ_CST);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ringchan_recv
+ *
+ * Description:
+ *   Copy the oldest message of a mapped channel into a buffer and release
+ *   its slot.  A channel has a single consumer.
+ *
+ * Returned Value:
+ *   The length of the message on success, -EAGAIN if the channel is empty
+ *   or -EMSGSIZE if the buffer is too small, the message stays queued then.
+ *
+ ****************************************************************************/
+
+static inline ssize_t ringchan_recv(FAR struct ringchan_s *ring,
+                                    FAR void *buf, size_t buflen)
+{
+  FAR struct ringchan_slot_s *slot;
+  uint32_t pos = ring->tail;
+  uint32_t len;
+
+  slot = RINGCHAN_SLOT(ring, pos);
+  if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1)
+    {
+      return -EAGAIN;
+    }
+
+  len = slot->len;
+  if (len > buflen)
+    {
+      return -EMSGSIZE;
+    }
+
+  memcpy(buf, slot->data, len);
+  __atomic_store_n(&slot->seq, pos + ring->nentries, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&ring->tail, pos + 1, __ATOMIC_RELEASE);
+  return len;
+}
+
+/****************************************************************************
+ * Name: ringchan_waiting
+ *
+ * Description:
+ *   Return the RINGCHAN_WAIT_* flags of the sides sleeping in the kernel.
+ *   A producer checks for RINGCHAN_WAIT_DATA after ringchan_send() and the
+ *   consumer for RINGCHAN_WAIT_SPACE after ringchan_recv(), and only then
+ *   issues RINGCHANIOC_WAKEUP, so no system call is made while the other
+ *   side is running.
+ *
+ ****************************************************************************/
+
+static inline uint32_t ringchan_waiting(FAR struct ringchan_s *ring)
+{
+  return __atomic_load_n(&ring->waiting, __ATOMIC_SEQ_CST);
+}
+
+#endif /* __INCLUDE_NUTTX_RINGCHAN_H */
@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/ioexpander/ioexpander.h>
@@ -154,6 +155,32 @@ rpmsg_port_spi_slave_initialize(FAR const struct rpmsg_port_config_s *cfg,
 
 #endif
 
+#ifdef CONFIG_RPMSG_PORT_PRIORITY
+
+/****************************************************************************
+ * Name: rpmsg_port_set_priority
+ *
+ * Description:
+ *   Mark an endpoint of a rpmsg port device urgent or not. The frames of
+ *   the urgent endpoints are sent ahead of the frames of the others. The
+ *   endpoint should be marked not urgent before it is destroyed.
+ *
+ * Input Parameters:
+ *   ept    - The endpoint, bound to a rpmsg port device.
+ *   urgent - Mark the endpoint urgent or not.
+ *
+ * Returned Value:
+ *   Zero on success, -ENOTTY if the endpoint isn't on a rpmsg port device
+ *   or -ENOSPC if there are already CONFIG_RPMSG_PORT_PRIORITY_NEPTS
+ *   urgent endpoints.
+ *
+ ****************************************************************************/
+
+struct rpmsg_endpoint;
+int rpmsg_port_set_priority(FAR struct rpmsg_endpoint *ept, bool urgent);
+
+#endif
+
 #ifdef CONFIG_RPMSG_PORT_UART
 
 /****************************************************************************
@@ -0,0 +1,174 @@
+/****************************************************************************
+ * include/nuttx/rpmsg/rpmsg_shm.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RPMSG_RPMSG_SHM_H
+#define __INCLUDE_NUTTX_RPMSG_RPMSG_SHM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_RPMSG_SHM
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nuttx/rpmsg/rpmsg.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* An invalid buffer handle */
+
+#define RPMSG_SHM_INVALID           UINT32_MAX
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: rpmsg_shm_register
+ *
+ * Description:
+ *   Register the shared memory pools used with the remote cpu.  The local
+ *   cpu allocates its buffers from txbase, the remote cpu from rxbase, so
+ *   the remote cpu registers the same two regions swapped, with the same
+ *   size and block size.  The regions are split in blocks of blksize
+ *   bytes, the buffers are runs of consecutive blocks.
+ *
+ * Input Parameters:
+ *   cpuname - The name of the remote cpu
+ *   txbase  - The pool of the local cpu, as mapped locally
+ *   rxbase  - The pool of the remote cpu, as mapped locally
+ *   size    - The size of each pool
+ *   blksize - The size of the blocks, a multiple of the cache line
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rpmsg_shm_register(FAR const char *cpuname, FAR void *txbase,
+                       FAR void *rxbase, size_t size, size_t blksize);
+
+/****************************************************************************
+ * Name: rpmsg_shm_alloc
+ *
+ * Description:
+ *   Allocate a buffer from the local pool shared with the remote cpu of
+ *   the endpoint.  It does not wait for a buffer, so the caller should
+ *   fall back to copying the payload through the vring if it fails.
+ *
+ * Input Parameters:
+ *   ept  - The endpoint
+ *   size - The size of the buffer
+ *
+ * Returned Value:
+ *   The buffer, or NULL if there is no pool or no free run large enough.
+ *
+ ****************************************************************************/
+
+FAR void *rpmsg_shm_alloc(FAR struct rpmsg_endpoint *ept, size_t size);
+
+/****************************************************************************
+ * Name: rpmsg_shm_free
+ *
+ * Description:
+ *   Free a buffer.  The buffer is either one allocated locally, or one
+ *   received from the remote cpu, which is then released back to it.
+ *
+ * Input Parameters:
+ *   ept - The endpoint
+ *   buf - The buffer
+ *
+ ****************************************************************************/
+
+void rpmsg_shm_free(FAR struct rpmsg_endpoint *ept, FAR void *buf);
+
+/****************************************************************************
+ * Name: rpmsg_shm_handle
+ *
+ * Description:
+ *   Return the handle naming a buffer of either pool in the messages sent
+ *   to the remote cpu.
+ *
+ * Input Parameters:
+ *   ept - The endpoint
+ *   buf - The buffer
+ *
+ * Returned Value:
+ *   The handle, or RPMSG_SHM_INVALID if buf is in no pool.
+ *
+ ****************************************************************************/
+
+uint32_t rpmsg_shm_handle(FAR struct rpmsg_endpoint *ept, FAR void *buf);
+
+/****************************************************************************
+ * Name: rpmsg_shm_ptr
+ *
+ * Description:
+ *   Return the buffer named by a handle received from the remote cpu.
+ *
+ * Input Parameters:
+ *   ept    - The endpoint
+ *   handle - The handle
+ *   len    - The length of the buffer
+ *
+ * Returned Value:
+ *   The buffer, or NULL if the handle and length are not in a pool.
+ *
+ ****************************************************************************/
+
+FAR void *rpmsg_shm_ptr(FAR struct rpmsg_endpoint *ept, uint32_t handle,
+                        size_t len);
+
+/****************************************************************************
+ * Name: rpmsg_shm_flush/rpmsg_shm_invalidate
+ *
+ * Description:
+ *   Maintain the data cache over a buffer: flush it before passing the
+ *   buffer to the remote cpu after writing it, invalidate it before
+ *   reading what the remote cpu wrote.
+ *
+ ****************************************************************************/
+
+void rpmsg_shm_flush(FAR const void *buf, size_t len);
+void rpmsg_shm_invalidate(FAR const void *buf, size_t len);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_RPMSG_SHM */
+#endif /* __INCLUDE_NUTTX_RPMSG_RPMSG_SHM_H */
@@ -27,6 +27,12 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <nuttx/mutex.h>
 
 /****************************************************************************
@@ -34,13 +40,46 @@
  ****************************************************************************/
 
 #define RWSEM_NO_HOLDER     ((pid_t)-1)
+
+#ifdef CONFIG_RWSEM_PREFER_WRITER
+#  define RWSEM_WWAITER_INITIALIZER , 0
+#else
+#  define RWSEM_WWAITER_INITIALIZER
+#endif
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  define RWSEM_BOOSTED_INITIALIZER , false
+#else
+#  define RWSEM_BOOSTED_INITIALIZER
+#endif
+
+#ifdef CONFIG_RWSEM_STATS
+#  define RWSEM_STATS_INITIALIZER   , {0, 0, 0, 0, 0}
+#else
+#  define RWSEM_STATS_INITIALIZER
+#endif
+
 #define RWSEM_INITIALIZER   {NXMUTEX_INITIALIZER, SEM_INITIALIZER(0), \
-                             RWSEM_NO_HOLDER, 0, 0, 0}
+                             RWSEM_NO_HOLDER, 0, 0, 0 \
+                             RWSEM_WWAITER_INITIALIZER \
+                             RWSEM_BOOSTED_INITIALIZER \
+                             RWSEM_STATS_INITIALIZER}
 
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_RWSEM_STATS
+struct rwsem_stats_s
+{
+  uint32_t nreads;      /* Read locks taken */
+  uint32_t nwrites;     /* Write locks taken */
+  uint32_t rcontended;  /* Read locks that had to wait */
+  uint32_t wcontended;  /* Write locks that had to wait */
+  clock_t  maxwait;     /* Longest wait for a lock, in clock ticks */
+};
+#endif
+
 typedef struct
 {
   mutex_t protected;    /* Protecting Locks for Read/Write Locked Tables */
@@ -52,6 +91,15 @@ typedef struct
   int     waiter;       /* Waiter Count */
   int     writer;       /* Writer Count */
   int     reader;       /* Reader Count */
+#ifdef CONFIG_RWSEM_PREFER_WRITER
+  int     wwaiter;      /* Writers among the waiters */
+#endif
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  bool    boosted;      /* The priority of the writer was raised */
+#endif
+#ifdef CONFIG_RWSEM_STATS
+  struct rwsem_stats_s stats;
+#endif
 } rw_semaphore_t;
 
 /****************************************************************************
@@ -186,4 +234,22 @@ int init_rwsem(FAR rw_semaphore_t *rwsem);
 
 void destroy_rwsem(FAR rw_semaphore_t *rwsem);
 
+/****************************************************************************
+ * Name: get_rwsem_stats
+ *
+ * Description:
+ *   Return the contention statistics of a read-write-lock object.
+ *
+ * Input Parameters:
+ *   rwsem - Pointer to the read-write-lock descriptor.
+ *   stats - Location to return the statistics.
+ *   reset - Clear the statistics after returning them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RWSEM_STATS
+void get_rwsem_stats(FAR rw_semaphore_t *rwsem,
+                     FAR struct rwsem_stats_s *stats, bool reset);
+#endif
+
 #endif  /* __INCLUDE_NUTTX_RWSEM_H */
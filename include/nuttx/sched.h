@@ -98,6 +98,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 5)                      /* Bit 5: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 6)                      /* Bit 6: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 7)                      /* Bit 7: In a system call */
@@ -289,6 +290,19 @@ typedef enum tstate_e tstate_t;
 typedef CODE void (*start_t)(void);
 typedef CODE void (*sig_deliver_t)(FAR struct tcb_s *tcb);
 
+/* These are the subsystems whose lock holding time is monitored by
+ * CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS.
+ */
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0
+enum critmon_subsys_e
+{
+  CRITMON_SUBSYS_WDOG = 0,    /* Watchdog timer list */
+  CRITMON_SUBSYS_MQUEUE,      /* Message queue free lists */
+  CRITMON_SUBSYS_NUM
+};
+#endif
+
 /* This is the entry point into the main thread of the task or into a created
  * pthread within the task.
  */
@@ -347,6 +361,33 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure that
+ * holds the parameters and the state of the SCHED_DEADLINE policy.  All
+ * times are in system clock ticks.
+ */
+
+struct deadline_s
+{
+  FAR struct tcb_s *tcb;            /* The parent TCB structure              */
+  struct wdog_s budget_timer;       /* Expires when the budget is consumed   */
+  struct wdog_s period_timer;       /* Expires at the start of each period   */
+  clock_t   runtime;                /* Execution budget per period           */
+  clock_t   deadline;               /* Deadline relative to period start     */
+  clock_t   period;                 /* Activation period                     */
+  clock_t   abstime;                /* Absolute deadline of current period   */
+  clock_t   remaining;              /* Budget left in the current period     */
+  clock_t   eventtime;              /* Time the thread was last switched in  */
+  uint32_t  bandwidth;              /* runtime / period in 1/2^20 units      */
+  bool      running;                /* Budget timer is consuming budget      */
+  bool      throttled;              /* Budget of this period is exhausted    */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -528,6 +569,8 @@ struct task_group_s
   FAR char **tg_envp;               /* Allocated environment strings        */
   ssize_t    tg_envpc;              /* Maximum entries of environment array */
   ssize_t    tg_envc;               /* Number of environment strings        */
+  FAR char  *tg_envblk;             /* Inherited strings, one allocation    */
+  size_t     tg_envblklen;          /* Size of the tg_envblk allocation     */
 #endif
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -613,6 +656,10 @@ struct tcb_s
   FAR struct semholder_s *holdsem;       /* List of held semaphores         */
 #endif
 
+#ifdef CONFIG_RWSEM_PREFER_WRITER
+  int16_t  rwsem_nreads;                 /* # of rwsem read locks held      */
+#endif
+
 #ifdef CONFIG_SMP
   uint8_t  cpu;                          /* CPU index if running/assigned   */
   cpu_set_t affinity;                    /* Bit set of permitted CPUs       */
@@ -631,6 +678,9 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters  */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
 
@@ -655,6 +705,10 @@ struct tcb_s
 
   FAR void *waitobj;                     /* Object thread waiting on        */
 
+#ifdef CONFIG_WDOG_TIMER_SLACK
+  clock_t timerslack;                    /* Timer slack in clock ticks      */
+#endif
+
 #ifdef CONFIG_SCHED_EVENTS
   nxevent_mask_t expect;                 /* expected event mask */
   nxevent_flags_t eflags;                /* event wait flags */
@@ -666,6 +720,9 @@ struct tcb_s
   sig_deliver_t sigdeliver;
   sq_queue_t sigpendactionq;             /* List of pending signal actions  */
   sq_queue_t sigpostedq;                 /* List of posted signals          */
+#ifdef CONFIG_SIG_FASTPATH
+  FAR struct sigq_s *sigqcache;          /* Free signal action for reuse    */
+#endif
 #endif /* CONFIG_ENABLE_ALL_SIGNALS*/
 #ifndef CONFIG_DISABLE_ALL_SIGNALS
   sigset_t   sigprocmask;                /* Signals that are blocked        */
@@ -687,6 +744,10 @@ struct tcb_s
   clock_t run_time;                      /* Total time thread run           */
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+  clock_t run_cpu[CONFIG_SMP_NCPUS];     /* Time thread run on each CPU     */
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
   clock_t preemp_start;                  /* Time when preemption disabled   */
   clock_t preemp_max;                    /* Max time preemption disabled    */
@@ -709,6 +770,16 @@ struct tcb_s
   void   *busywait_max_caller;           /* Caller of max busywait          */
 #endif
 
+  /* Scheduling latency histogram support ***********************************/
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  clock_t  latency_start;                /* Time when made ready-to-run     */
+
+  /* Number of wakeup-to-run latencies that fell in each log2 bucket */
+
+  uint32_t latency_hist[CONFIG_SCHED_LATENCY_NBUCKETS];
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -729,6 +800,10 @@ struct tcb_s
   size_t level_deepest;
   size_t level;
 #endif
+
+#ifdef CONFIG_STACK_WATERMARK
+  uintptr_t sp_watermark;                /* Lowest sampled stack pointer    */
+#endif
 };
 
 /* struct pthread_tcb_s *****************************************************/
@@ -834,6 +909,33 @@ EXTERN clock_t g_busywait_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_busywait_total[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT >= 0 */
 
+/* Maximum and accumulated lock holding time of each monitored subsystem */
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0
+EXTERN clock_t g_subsys_max[CONFIG_SMP_NCPUS][CRITMON_SUBSYS_NUM];
+EXTERN clock_t g_subsys_total[CONFIG_SMP_NCPUS][CRITMON_SUBSYS_NUM];
+#endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0 */
+
+/* Time each CPU spent in interrupt handlers and in work queue items */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+EXTERN clock_t g_cputime_irq[CONFIG_SMP_NCPUS];
+EXTERN clock_t g_cputime_work[CONFIG_SMP_NCPUS];
+#endif /* CONFIG_SCHED_CRITMONITOR_CPUTIME */
+
+/* CPUs that spin instead of sleeping when idle */
+
+#ifdef CONFIG_SCHED_IDLE_POLL
+EXTERN cpu_set_t g_idle_poll_cpus;
+#endif
+
+/* Wakeup-to-run latency histogram of each CPU */
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+EXTERN uint32_t g_latency_hist[CONFIG_SMP_NCPUS]
+                              [CONFIG_SCHED_LATENCY_NBUCKETS];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -1310,6 +1412,70 @@ int nxsched_get_scheduler(pid_t pid);
 int nxsched_set_scheduler(pid_t pid, int policy,
                           FAR const struct sched_param *param);
 
+/****************************************************************************
+ * Name: nxsched_set_attr
+ *
+ * Description:
+ *   nxsched_set_attr() sets the scheduling policy and the associated
+ *   attributes for the thread identified by pid.  If pid equals zero, the
+ *   attributes of the calling thread will be set.  This is the only way
+ *   to select the SCHED_DEADLINE policy.
+ *
+ *   nxsched_set_attr() is identical to the function sched_setattr(),
+ *   differing only in its return value:  This function does not modify the
+ *   errno variable.
+ *
+ * Input Parameters:
+ *   pid   - the task ID of the task to modify.  If pid is zero, the
+ *           calling task is modified.
+ *   attr  - The new scheduling policy and attributes.
+ *   flags - Reserved, must be zero.
+ *
+ * Returned Value:
+ *   On success, nxsched_set_attr() returns OK (zero).  On error, a negated
+ *   errno value is returned:
+ *
+ *   EINVAL The policy or its attributes are not valid.
+ *   EBUSY  Admitting the SCHED_DEADLINE thread would exceed the bandwidth
+ *          limit.
+ *   ESRCH  The task whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int nxsched_set_attr(pid_t pid, FAR const struct sched_attr *attr,
+                     unsigned int flags);
+
+/****************************************************************************
+ * Name: nxsched_get_attr
+ *
+ * Description:
+ *   nxsched_get_attr() returns the scheduling policy and the associated
+ *   attributes of the thread identified by pid.  If pid equals zero, the
+ *   attributes of the calling thread are returned.
+ *
+ *   nxsched_get_attr() is identical to the function sched_getattr(),
+ *   differing only in its return value:  This function does not modify the
+ *   errno variable.
+ *
+ * Input Parameters:
+ *   pid   - the task ID of the task to query.  If pid is zero, the
+ *           calling task is queried.
+ *   attr  - The location to return the attributes.
+ *   size  - The size of the structure pointed to by attr.
+ *   flags - Reserved, must be zero.
+ *
+ * Returned Value:
+ *   On success, nxsched_get_attr() returns OK (zero).  On error, a negated
+ *   errno value is returned:
+ *
+ *   EINVAL The arguments are not valid.
+ *   ESRCH  The task whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int nxsched_get_attr(pid_t pid, FAR struct sched_attr *attr,
+                     unsigned int size, unsigned int flags);
+
 /****************************************************************************
  * Name: nxsched_get_affinity
  *
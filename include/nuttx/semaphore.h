@@ -280,7 +280,7 @@ int nxsem_trywait_slow(FAR sem_t *sem);
 int nxsem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime);
 
 /****************************************************************************
- * Name: nxsem_clockwait
+ * Name: nxsem_clockwait / nxsem_clockwait_slow
  *
  * Description:
  *   This function will lock the semaphore referenced by sem as in the
@@ -326,6 +326,8 @@ int nxsem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime);
 
 int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
                     FAR const struct timespec *abstime);
+int nxsem_clockwait_slow(FAR sem_t *sem, clockid_t clockid,
+                         FAR const struct timespec *abstime);
 
 /****************************************************************************
  * Name: nxsem_tickwait
@@ -509,6 +509,17 @@
 
 #define SNIOC_SET_NONWAKEUP           _SNIOC(0x00A9)
 
+/* Command:      SNIOC_BATCH_READ
+ * Description:  Take the new samples of the user, like read() does, but
+ *               without copying them; they are consumed in place in the
+ *               memory mapped from the topic.  All new samples are
+ *               returned regardless of the interval of the user.
+ * Argument:     A pointer to struct sensor_batch_s.
+ * Dependencies: CONFIG_SENSORS_MMAP
+ */
+
+#define SNIOC_BATCH_READ              _SNIOC(0x00AA)
+
 /****************************************************************************
  * Public types
  ****************************************************************************/
@@ -173,6 +173,25 @@ static inline uint64_t sensor_get_timestamp(void)
   return 1000000ull * ts.tv_sec + ts.tv_nsec / 1000;
 }
 
+/* Return the FIFO watermark, in samples, that meets the batch latency of
+ * a sensor sampled every interval us.  It is clamped to the depth of the
+ * hardware FIFO, and is one sample when batching is off.
+ */
+
+static inline uint32_t sensor_batch_watermark(uint32_t interval,
+                                              uint32_t latency,
+                                              uint32_t nfifo)
+{
+  uint32_t nsamples = interval ? latency / interval : 0;
+
+  if (nsamples > nfifo)
+    {
+      nsamples = nfifo;
+    }
+
+  return nsamples ? nsamples : 1;
+}
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -618,6 +637,10 @@ struct sensor_lowerhalf_s
    */
 
   bool persist;
+
+  /* The time of the newest sample pushed by sensor_push_fifo() */
+
+  uint64_t fifo_timestamp;
 };
 
 /****************************************************************************
@@ -651,6 +674,36 @@ extern "C"
 void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
                                int place);
 
+/****************************************************************************
+ * Name: sensor_push_fifo
+ *
+ * Description:
+ *   Push the samples drained from the hardware FIFO of the sensor in one
+ *   transfer, instead of pushing them one by one.  The timestamps of the
+ *   samples are interpolated back from the time of the newest sample, with
+ *   the sample period measured between the batches so that it follows the
+ *   clock of the sensor.  The nominal interval is used for the first batch
+ *   and after a gap, e.g. when the FIFO overflowed.
+ *
+ * Input Parameters:
+ *   lower     - The instance of lower half sensor driver.
+ *   data      - The samples, oldest first, each starting with its uint64_t
+ *               timestamp which is overwritten.
+ *   bytes     - The number of bytes of the samples.
+ *   esize     - The size of a sample.
+ *   timestamp - The time the newest sample was taken, in us.
+ *   interval  - The nominal sample period, in us.
+ *
+ * Returned Value:
+ *   The bytes of push is returned when success;
+ *   A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_push_fifo(FAR struct sensor_lowerhalf_s *lower,
+                         FAR void *data, size_t bytes, size_t esize,
+                         uint64_t timestamp, uint32_t interval);
+
 /****************************************************************************
  * "Upper Half" Sensor Driver Interfaces
  ****************************************************************************/
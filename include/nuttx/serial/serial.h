@@ -454,6 +454,21 @@ void uart_recvchars(FAR uart_dev_t *dev);
 
 void uart_datareceived(FAR uart_dev_t *dev);
 
+/****************************************************************************
+ * Name: uart_recvidle
+ *
+ * Description:
+ *  This function is called from the UART interrupt handler when the RX
+ *  line went idle, or an RX timeout expired, after some data was received.
+ *  It wakes up the readers even below their VMIN wake threshold, so that a
+ *  partial frame does not wait for more data or for VTIME.  A lower half
+ *  receiving with DMA reports the partial transfer with
+ *  uart_recvchars_done() first.
+ *
+ ****************************************************************************/
+
+void uart_recvidle(FAR uart_dev_t *dev);
+
 /****************************************************************************
  * Name: uart_datasent
  *
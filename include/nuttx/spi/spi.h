@@ -436,6 +436,27 @@
 #  define SPI_TRIGGER(d) \
   (((d)->ops->trigger) ? ((d)->ops->trigger(d)) : -ENOSYS)
 
+/****************************************************************************
+ * Name: SPI_TRANSFER_ASYNC
+ *
+ * Description:
+ *   Queue a sequence of transfers, see spi_transfer_async().
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request describing the sequence and its completion callback
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *   -ENOSYS if the lower half does not queue transfers itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+#  define SPI_TRANSFER_ASYNC(d,r) \
+  (((d)->ops->transfer_async) ? ((d)->ops->transfer_async(d,r)) : -ENOSYS)
+#endif
+
 /* SPI Device Macros ********************************************************/
 
 /* This builds a SPI devid from its type and index */
@@ -543,6 +564,9 @@ typedef uint8_t spi_hwfeatures_t;
 /* The SPI vtable */
 
 struct spi_dev_s;
+#ifdef CONFIG_SPI_ASYNC
+struct spi_async_s;
+#endif
 struct spi_ops_s
 {
   CODE int      (*lock)(FAR struct spi_dev_s *dev, bool lock);
@@ -581,6 +605,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_ASYNC
+  CODE int      (*transfer_async)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_async_s *req);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
@@ -36,6 +36,11 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 
+#ifdef CONFIG_SPI_ASYNC
+#  include <nuttx/queue.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 #ifdef CONFIG_SPI_EXCHANGE
 
 /* SPI Character Driver IOCTL Commands **************************************/
@@ -114,6 +119,32 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* This describes a sequence queued by spi_transfer_async().  The callback
+ * is called with the result of the sequence, from the interrupt handler of
+ * the lower half or from the work queue, so it must not block.  The request
+ * and the sequence must stay valid until then.
+ */
+
+struct spi_async_s;
+typedef CODE void (*spi_async_callback_t)(FAR struct spi_async_s *req,
+                                          int result);
+
+struct spi_async_s
+{
+  FAR struct spi_sequence_s *seq;  /* The sequence to perform */
+  spi_async_callback_t callback;   /* Called when the sequence completes */
+  FAR void *arg;                   /* For the use of the callback */
+
+  /* Owned by the SPI layer while the request is queued */
+
+  sq_entry_t node;                 /* The queue of the lower half */
+  FAR struct spi_dev_s *spi;       /* The bus of the request */
+  struct work_s work;              /* Runs the request without a lower half
+                                    * queue */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -137,6 +168,35 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return at once.  The transfers
+ *   are performed like spi_transfer() does, then req->callback is called
+ *   with the result.  Requests queued on the same bus complete in order.
+ *
+ *   The lower half performs the request if it provides the
+ *   transfer_async() method, typically chaining the transfers from its DMA
+ *   interrupts; the inter-transfer delays are then waited for without
+ *   blocking.  Otherwise, spi_transfer() performs the request on the
+ *   high-priority work queue.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   req - Describes the sequence and the completion callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure,
+ *   in which case the callback is not called.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_async_s *req);
+#endif
+
 /****************************************************************************
  * Name: spi_register
  *
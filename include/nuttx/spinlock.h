@@ -72,10 +72,34 @@ void nxsched_critmon_busywait(bool state, FAR void *caller);
 #  define nxsched_critmon_busywait(state, caller)
 #endif
 
+#ifdef CONFIG_SPINLOCK_LOCKSTAT
+void spin_lock_stat(FAR volatile spinlock_t *lock, FAR void *caller);
+void spin_lock_stat_reset(void);
+#else
+#  define spin_lock_stat(lock, caller) spin_lock_notrace(lock)
+#endif
+
 /****************************************************************************
  * Public Data Types
  ****************************************************************************/
 
+#ifdef CONFIG_SPINLOCK_LOCKSTAT
+/* Contention statistics of one spinlock, see /proc/sched/lockstat */
+
+struct spinlock_stat_s
+{
+  FAR volatile spinlock_t *lock; /* The lock, NULL if the entry is free */
+  FAR void *caller;              /* The first caller that took the lock */
+  uint32_t acquired;             /* Number of times the lock was taken */
+  uint32_t contended;            /* How many of them had to spin */
+  clock_t spintime;              /* Total time spent spinning */
+  clock_t maxspin;               /* Longest single spin */
+};
+
+EXTERN struct spinlock_stat_s
+g_spinlock_stat[CONFIG_SPINLOCK_LOCKSTAT_NLOCKS];
+#endif
+
 /****************************************************************************
  * Name: up_testset
  *
@@ -233,9 +257,9 @@ static inline_function void spin_lock(FAR volatile spinlock_t *lock)
 
   nxsched_critmon_busywait(true, return_address(0));
 
-  /* Lock without trace note */
+  /* Lock without trace note, recording contention if enabled */
 
-  spin_lock_notrace(lock);
+  spin_lock_stat(lock, return_address(0));
 
   /* Get the lock, end counting busy-waiting */
 
@@ -276,8 +300,14 @@ static inline_function bool
 spin_trylock_notrace(FAR volatile spinlock_t *lock)
 {
 #ifdef CONFIG_TICKET_SPINLOCK
-  if (!atomic_cmpxchg(&lock->next, &lock->owner,
-                      atomic_read(&lock->next) + 1))
+  int32_t owner = atomic_read(&lock->owner);
+
+  /* The lock is free only if no ticket beyond the owner's was handed out.
+   * Compare against a local copy: on failure atomic_cmpxchg() stores the
+   * current value of next through the expected pointer.
+   */
+
+  if (!atomic_cmpxchg(&lock->next, &owner, owner + 1))
 #else /* CONFIG_TICKET_SPINLOCK */
   if (up_testset(lock) == SP_LOCKED)
 #endif /* CONFIG_TICKET_SPINLOCK */
@@ -495,9 +525,10 @@ irqstate_t spin_lock_irqsave(FAR volatile spinlock_t *lock)
 
   nxsched_critmon_busywait(true, return_address(0));
 
-  /* Lock without trace note */
+  /* Lock without trace note, recording contention if enabled */
 
-  flags = spin_lock_irqsave_notrace(lock);
+  flags = up_irq_save();
+  spin_lock_stat(lock, return_address(0));
 
   /* Get the lock, end counting busy-waiting */
 
@@ -53,6 +53,24 @@
 #define PTP_CLOCK_SETSTATS       _PTPIOC(0xd)
 #define PTP_CLOCK_GETSTATS       _PTPIOC(0xe)
 
+/* In-kernel servo, CONFIG_PTP_CLOCK_SERVO:
+ *
+ *   PTP_CLOCK_SERVO_SAMPLE - Feed an offset from the master measured by
+ *                            the PTP protocol, argument:
+ *                            struct ptp_servo_sample_s
+ *   PTP_CLOCK_SERVO_STATUS - Get the servo state, argument:
+ *                            struct ptp_servo_status_s
+ */
+
+#define PTP_CLOCK_SERVO_SAMPLE   _PTPIOC(0xf)
+#define PTP_CLOCK_SERVO_STATUS   _PTPIOC(0x10)
+
+/* Servo states */
+
+#define PTP_SERVO_UNLOCKED       0 /* No sample yet */
+#define PTP_SERVO_LOCKING        1 /* Measuring the frequency error */
+#define PTP_SERVO_LOCKED         2 /* Tracking the master */
+
 /* Maximum allowed offset measurement samples. */
 
 #define PTP_MAX_SAMPLES          25
@@ -86,6 +104,25 @@ struct ptp_statistics_s
   int32_t unknown;
 };
 
+/* One offset measurement fed to the in-kernel servo */
+
+struct ptp_servo_sample_s
+{
+  int64_t         offset; /* Local minus master time, in nanoseconds */
+  struct timespec local;  /* PTP clock time of the measurement */
+};
+
+/* The in-kernel servo state */
+
+struct ptp_servo_status_s
+{
+  int     state;     /* PTP_SERVO_xxx */
+  int64_t offset;    /* Last offset from the master, in nanoseconds */
+  long    freq;      /* Frequency adjustment applied, in ppb */
+  long    drift;     /* Estimated frequency error, in ppb */
+  int64_t sysoffset; /* System time minus PTP clock, in nanoseconds */
+};
+
 /* struct system_device_crosststamp - system/device cross-timestamp
  * (synchronized capture)
  */
@@ -1260,6 +1260,33 @@ struct sensor_ustate_s
   uint32_t generation;         /* The recent generation of circular buffer */
 };
 
+/* This structure is at the start of the memory mapped from a topic.  The
+ * sample number n, counting from 0, is at offset
+ * data + (n % nbuffer) * esize, and its generation is the uint32_t at
+ * offset timing + (n % nbuffer) * 4.  head is the number of samples
+ * published so far, only the samples from head - nbuffer are in the
+ * buffer.  A sample read in place was intact if head - n < nbuffer still
+ * holds after it was read.
+ */
+
+struct sensor_mmap_s
+{
+  uint32_t head;               /* The number of samples published */
+  uint32_t nbuffer;            /* The number of samples the buffer holds */
+  uint32_t esize;              /* The size of a sample */
+  uint32_t data;               /* The offset of the samples */
+  uint32_t timing;             /* The offset of the generations */
+};
+
+/* This structure describes the samples taken by SNIOC_BATCH_READ */
+
+struct sensor_batch_s
+{
+  uint32_t index;              /* Out: The number of the first sample */
+  uint32_t count;              /* In: The maximum number of samples,
+                                * out: the number of samples taken */
+};
+
 /* This structure describes the context custom ioctl for device */
 
 struct sensor_ioctl_s
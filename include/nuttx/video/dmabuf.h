@@ -0,0 +1,144 @@
+/****************************************************************************
+ * include/nuttx/video/dmabuf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VIDEO_DMABUF_H
+#define __INCLUDE_NUTTX_VIDEO_DMABUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/atomic.h>
+
+#ifdef CONFIG_VIDEO_DMABUF
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A shared buffer object.  The memory belongs to the exporting driver and
+ * stays valid until the last reference is dropped, at which point the
+ * exporter's release() callback is invoked.  Every file descriptor that
+ * refers to the buffer and every driver queue that holds it owns one
+ * reference.
+ */
+
+struct dmabuf_s
+{
+  atomic_t   crefs;        /* Reference count */
+  FAR void  *vaddr;        /* Start of the buffer */
+  size_t     size;         /* Size of the buffer in bytes */
+  FAR void  *priv;         /* Exporter private data */
+
+  /* Called when the last reference is dropped */
+
+  CODE void (*release)(FAR struct dmabuf_s *buf);
+};
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmabuf_alloc
+ *
+ * Description:
+ *   Wrap exporter memory in a new buffer object with one reference.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_alloc(FAR void *vaddr, size_t size,
+                                  CODE void (*release)
+                                  (FAR struct dmabuf_s *buf),
+                                  FAR void *priv);
+
+/****************************************************************************
+ * Name: dmabuf_slice
+ *
+ * Description:
+ *   Create a buffer object that covers part of another one.  The slice
+ *   holds a reference on 'parent' for as long as it exists, so a driver
+ *   can export single frames of one large allocation.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_slice(FAR struct dmabuf_s *parent,
+                                  size_t offset, size_t size);
+
+/****************************************************************************
+ * Name: dmabuf_export
+ *
+ * Description:
+ *   Create a file descriptor for the buffer.  The descriptor takes its own
+ *   reference, which is dropped when it is closed.
+ *
+ * Returned Value:
+ *   The new file descriptor on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dmabuf_export(FAR struct dmabuf_s *buf, int oflags);
+
+/****************************************************************************
+ * Name: dmabuf_get
+ *
+ * Description:
+ *   Look up the buffer behind a file descriptor returned by
+ *   dmabuf_export() and take a reference.
+ *
+ * Returned Value:
+ *   The buffer on success; NULL if 'fd' does not refer to a buffer.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_get(int fd);
+
+/****************************************************************************
+ * Name: dmabuf_ref / dmabuf_put
+ *
+ * Description:
+ *   Take or drop a reference.  Dropping the last one releases the memory.
+ *
+ ****************************************************************************/
+
+void dmabuf_ref(FAR struct dmabuf_s *buf);
+void dmabuf_put(FAR struct dmabuf_s *buf);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_VIDEO_DMABUF */
+#endif /* __INCLUDE_NUTTX_VIDEO_DMABUF_H */
@@ -324,6 +324,13 @@
 #define FBIOGET_PANINFOCNT    _FBIOC(0x001d)  /* Get pan info count */
                                               /* Argument: read-only
                                                *           unsigned long */
+#ifdef CONFIG_VIDEO_DMABUF
+#  define FBIOGET_DMABUF      _FBIOC(0x001e)  /* Export part of the selected
+                                               * plane or overlay as a
+                                               * shared buffer descriptor
+                                               * Argument: read/write struct
+                                               *           fb_dmabuf_s */
+#endif
 
 #define FB_TYPE_PACKED_PIXELS        0      /* Packed Pixels */
 #define FB_TYPE_PLANES               1      /* Non interleaved planes */
@@ -545,6 +552,21 @@ struct fb_planeinfo_s
   uint32_t   yoffset;      /* Offset from virtual to visible resolution */
 };
 
+#ifdef CONFIG_VIDEO_DMABUF
+/* This structure describes a FBIOGET_DMABUF request.  Capture and codec
+ * drivers import the returned descriptor with V4L2_MEMORY_DMABUF and write
+ * frames straight into display memory.
+ */
+
+struct fb_dmabuf_s
+{
+  uint32_t offset;        /* Start of the exported range in bytes */
+  uint32_t length;        /* Length of the range, 0 for the rest */
+  uint32_t flags;         /* O_CLOEXEC and access mode of the new fd */
+  int32_t  fd;            /* Returned file descriptor */
+};
+#endif
+
 /* This structure describes an area. */
 
 struct fb_area_s
@@ -769,6 +791,32 @@ struct fb_vtable_s
   int (*waitforvsync)(FAR struct fb_vtable_s *vtable);
 #endif
 
+#ifdef CONFIG_FB_ACCEL
+  /* The following are provided only if the video hardware has a 2D engine
+   * that can draw into a color plane.  Either may be NULL and both may
+   * return a negated errno value for what the engine cannot do, the caller
+   * then draws with the CPU.  The drawing must be complete when they
+   * return.
+   */
+
+  /* Fill an area of a color plane with a pixel value in the format of the
+   * plane.
+   */
+
+  int (*fillarea)(FAR struct fb_vtable_s *vtable, int planeno,
+                  FAR const struct fb_area_s *area, uint32_t color);
+
+  /* Copy an image to an area of a color plane.  src is the first pixel of
+   * the image and srcstride the length of one of its lines in bytes.  The
+   * image is converted if srcfmt (FB_FMT_*) is not the format of the plane
+   * and blended over the plane if srcfmt has an alpha channel.
+   */
+
+  int (*copyarea)(FAR struct fb_vtable_s *vtable, int planeno,
+                  FAR const struct fb_area_s *area, FAR const void *src,
+                  fb_coord_t srcstride, uint8_t srcfmt);
+#endif
+
 #ifdef CONFIG_FB_OVERLAY
   /* Get information about the video controller configuration and the
    * configuration of each overlay.
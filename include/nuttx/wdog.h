@@ -144,6 +144,49 @@ extern "C"
 int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
                      wdentry_t wdentry, wdparm_t arg);
 
+/****************************************************************************
+ * Name: wd_start_abstick_slack
+ *
+ * Description:
+ *   Like wd_start_abstick(), but the watchdog may expire up to 'slack'
+ *   ticks late so that it shares the timer interrupt of other watchdogs.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   ticks    - Absolute time in clock ticks
+ *   slack    - Tolerated delay in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_SLACK
+int wd_start_abstick_slack(FAR struct wdog_s *wdog, clock_t ticks,
+                           clock_t slack, wdentry_t wdentry, wdparm_t arg);
+#else
+#  define wd_start_abstick_slack(wdog, ticks, slack, wdentry, arg) \
+     wd_start_abstick(wdog, ticks, wdentry, arg)
+#endif
+
+/****************************************************************************
+ * Name: wd_task_slack
+ *
+ * Description:
+ *   Return the timer slack, in clock ticks, of the calling thread, as set
+ *   by prctl(PR_SET_TIMERSLACK).  Zero is returned in interrupt context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_SLACK
+clock_t wd_task_slack(void);
+#else
+#  define wd_task_slack() 0
+#endif
+
 /****************************************************************************
  * Name: wd_start
  *
@@ -196,6 +239,41 @@ int wd_start(FAR struct wdog_s *wdog, clock_t delay,
   return ret;
 }
 
+/****************************************************************************
+ * Name: wd_start_slack
+ *
+ * Description:
+ *   Like wd_start(), but the watchdog may expire up to 'slack' ticks late
+ *   so that it shares the timer interrupt of other watchdogs.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   delay    - Delay count in clock ticks
+ *   slack    - Tolerated delay in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+static inline_function
+int wd_start_slack(FAR struct wdog_s *wdog, clock_t delay, clock_t slack,
+                   wdentry_t wdentry, wdparm_t arg)
+{
+  int ret = -EINVAL;
+
+  if (delay <= WDOG_MAX_DELAY)
+    {
+      ret = wd_start_abstick_slack(wdog, clock_delay2abstick(delay), slack,
+                                   wdentry, arg);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: wd_start_abstime
  *
@@ -376,6 +454,24 @@ int wd_cancel(FAR struct wdog_s *wdog);
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog);
 
+/****************************************************************************
+ * Name: wd_gettime_next
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the first watchdog expires,
+ *   zero if it has already expired, or CLOCK_MAX if no watchdog is active.
+ *
+ ****************************************************************************/
+
+clock_t wd_gettime_next(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -42,6 +42,10 @@
 
 #include <nuttx/wireless/bluetooth/bt_buf.h>
 
+#ifdef CONFIG_MM_IOB
+#  include <nuttx/mm/iob.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -86,6 +90,16 @@ struct bt_driver_s
                       enum bt_buf_type_e type,
                       FAR void *data, size_t len);
 
+#ifdef CONFIG_MM_IOB
+  /* Optional zero-copy receive, filled by register function.  The frame
+   * is passed in an IOB (io_len includes io_offset) which is consumed.
+   */
+
+  CODE int (*receive_iob)(FAR struct bt_driver_s *btdev,
+                          enum bt_buf_type_e type,
+                          FAR struct iob_s *iob);
+#endif
+
   /* Lower-half logic may support platform-specific ioctl commands */
 
   CODE int (*ioctl)(FAR struct bt_driver_s *btdev, int cmd,
@@ -104,6 +118,42 @@ struct bt_driver_s
   FAR void *bt_net;
 };
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_IOB
+
+/****************************************************************************
+ * Name: bt_netdev_receive_iob
+ *
+ * Description:
+ *   Pass a frame received into an IOB to the upper layer.  The IOB is
+ *   handed over without copying if the upper layer supports it, otherwise
+ *   the data is passed through the receive() method and the IOB is freed.
+ *   The IOB is consumed in all cases.
+ *
+ ****************************************************************************/
+
+static inline int bt_netdev_receive_iob(FAR struct bt_driver_s *btdev,
+                                        enum bt_buf_type_e type,
+                                        FAR struct iob_s *iob)
+{
+  int ret;
+
+  if (btdev->receive_iob != NULL)
+    {
+      return btdev->receive_iob(btdev, type, iob);
+    }
+
+  ret = btdev->receive(btdev, type, &iob->io_data[iob->io_offset],
+                       iob->io_len - iob->io_offset);
+  iob_free(iob);
+  return ret;
+}
+
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -253,6 +253,9 @@ struct work_s
   clock_t          qtime;  /* Time work queued */
   worker_t         worker; /* Work callback */
   FAR void        *arg;    /* Callback argument */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  FAR struct kwork_wqueue_s *wq; /* Queue chosen by work_queue_cpu() */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
@@ -513,6 +516,61 @@ int work_cancel_sync(int qid, FAR struct work_s *work);
 int work_cancel_sync_wq(FAR struct kwork_wqueue_s *wqueue,
                         FAR struct work_s *work);
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work to the high priority work queue of a CPU.  The work is
+ *   performed by a worker thread pinned to that CPU, unless the queue of
+ *   that CPU is saturated, in which case the shared high priority work
+ *   queue is used.
+ *
+ *   Work queued with work_queue_cpu() must be cancelled with
+ *   work_cancel_cpu() or work_cancel_sync_cpu().
+ *
+ * Input Parameters:
+ *   cpu    - The target CPU
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.
+ *   arg    - The argument that will be passed to the worker callback.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure:
+ *
+ *   -EBUSY  - The work is already queued.
+ *   -EINVAL - Invalid parameters.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_cpu(int cpu, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay);
+#endif
+
+/****************************************************************************
+ * Name: work_cancel_cpu/work_cancel_sync_cpu
+ *
+ * Description:
+ *   Cancel work previously queued by work_queue_cpu().  The synchronous
+ *   variant also waits for the worker callback to finish if it is
+ *   currently running.
+ *
+ * Input Parameters:
+ *   work - The previously queued work structure to cancel
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure.  work_cancel_sync_cpu()
+ *   returns the first error met on any of the queues.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_cancel_cpu(FAR struct work_s *work);
+int work_cancel_sync_cpu(FAR struct work_s *work);
+#endif
+
 /****************************************************************************
  * Name: work_available
  *
@@ -50,6 +50,7 @@
 #define SCHED_SPORADIC            3  /* Sporadic scheduling policy */
 #define SCHED_BATCH               4  /* Batch scheduling policy */
 #define SCHED_IDLE                5  /* Idle scheduling policy */
+#define SCHED_DEADLINE            6  /* Earliest deadline first policy */
 
 /* Maximum number of SCHED_SPORADIC replenishments */
 
@@ -203,6 +204,23 @@ struct sched_param
 #endif
 };
 
+/* This is the extended scheduling attribute structure used with
+ * sched_setattr() and sched_getattr().  The layout is the same as on Linux;
+ * all times are in nanoseconds and are only used by SCHED_DEADLINE.
+ */
+
+struct sched_attr
+{
+  uint32_t size;                        /* Size of this structure */
+  uint32_t sched_policy;                /* Scheduling policy */
+  uint64_t sched_flags;                 /* Policy flags, must be zero */
+  int32_t  sched_nice;                  /* Not used */
+  uint32_t sched_priority;              /* Priority for SCHED_FIFO/RR */
+  uint64_t sched_runtime;               /* Execution budget per period */
+  uint64_t sched_deadline;              /* Relative deadline */
+  uint64_t sched_period;                /* Activation period */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -245,6 +263,10 @@ int    sched_getparam(pid_t pid, FAR struct sched_param *param);
 int    sched_setscheduler(pid_t pid, int policy,
                           FAR const struct sched_param *param);
 int    sched_getscheduler(pid_t pid);
+int    sched_setattr(pid_t pid, FAR const struct sched_attr *attr,
+                     unsigned int flags);
+int    sched_getattr(pid_t pid, FAR struct sched_attr *attr,
+                     unsigned int size, unsigned int flags);
 int    sched_yield(void);
 int    sched_get_priority_max(int policy);
 int    sched_get_priority_min(int policy);
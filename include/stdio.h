@@ -339,6 +339,22 @@ fortify_function(sprintf) int sprintf(FAR char *buf,
 #endif
 #endif
 
+/* getc_unlocked() takes a buffered byte without a function call, it falls
+ * back to fgetc_unlocked() once the read buffer is empty.
+ */
+
+#if defined(CONFIG_FILE_STREAM) && !defined(CONFIG_STDIO_DISABLE_BUFFERING)
+#  if CONFIG_NUNGET_CHARS > 0
+#    define __fs_ungotten(stream) ((stream)->fs_nungotten)
+#  else
+#    define __fs_ungotten(stream) 0
+#  endif
+#  define getc_unlocked(stream) \
+     ((stream)->fs_bufpos < (stream)->fs_bufread && \
+      __fs_ungotten(stream) == 0 ? \
+      (int)(unsigned char)*(stream)->fs_bufpos++ : fgetc_unlocked(stream))
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
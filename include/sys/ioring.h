@@ -0,0 +1,209 @@
+/****************************************************************************
+ * include/sys/ioring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_IORING_H
+#define __INCLUDE_SYS_IORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <fcntl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The operations of a submission queue entry */
+
+#define IORING_OP_NOP          0  /* Complete with 0 */
+#define IORING_OP_READ         1  /* read() or pread() */
+#define IORING_OP_WRITE        2  /* write() or pwrite() */
+#define IORING_OP_SEND         3  /* send() */
+#define IORING_OP_RECV         4  /* recv() */
+#define IORING_OP_FSYNC        5  /* fsync() */
+#define IORING_OP_POLL         6  /* Wait for the events of one descriptor */
+
+/* ioring_setup() flags */
+
+#define IORING_SETUP_CLOEXEC   O_CLOEXEC
+
+/* ioring_enter() flags */
+
+#define IORING_ENTER_GETEVENTS (1 << 0) /* Wait for min_complete entries */
+
+/* Ring flags, set by the kernel */
+
+#define IORING_SQ_NEED_WAKEUP  (1 << 0) /* The ring thread is sleeping */
+
+/* The ring indexes are free running, an index is masked with the number of
+ * entries minus one to address its entry.
+ */
+
+#define IORING_SQ_ENTRY(r, i)  (&(r)->sqes[(i) & ((r)->sq_entries - 1)])
+#define IORING_CQ_ENTRY(r, i)  (&(r)->cqes[(i) & ((r)->cq_entries - 1)])
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* A submission queue entry */
+
+struct ioring_sqe
+{
+  uint8_t   opcode;    /* IORING_OP_* */
+  uint8_t   flags;     /* Reserved, must be zero */
+  int16_t   reserved;
+  int       fd;        /* The descriptor operated on */
+  off_t     off;       /* The file offset, -1 for the file position */
+  FAR void *addr;      /* The buffer */
+  size_t    len;       /* The size of the buffer */
+  uint32_t  op_flags;  /* MSG_* flags of SEND and RECV, events of POLL */
+  uintptr_t user_data; /* Copied to the completion queue entry */
+};
+
+/* A completion queue entry */
+
+struct ioring_cqe
+{
+  uintptr_t user_data; /* The user_data of the submission */
+  ssize_t   res;       /* The result, a negated errno value on failure */
+};
+
+/* The rings shared by the application and the kernel.  The structure and
+ * the entries are allocated by the application, the number of entries of
+ * each ring must be a power of two.  The application produces sq_tail and
+ * cq_head, the kernel produces sq_head and cq_tail.
+ */
+
+struct ioring
+{
+  volatile uint32_t      sq_head;     /* Next submission the kernel takes */
+  volatile uint32_t      sq_tail;     /* Next submission the app fills */
+  volatile uint32_t      cq_head;     /* Next completion the app reaps */
+  volatile uint32_t      cq_tail;     /* Next completion the kernel posts */
+  volatile uint32_t      flags;       /* IORING_SQ_* */
+  volatile uint32_t      cq_overflow; /* Completions dropped, CQ was full */
+  uint32_t               sq_entries;  /* Number of submission entries */
+  uint32_t               cq_entries;  /* Number of completion entries */
+  FAR struct ioring_sqe *sqes;        /* The submission entries */
+  FAR struct ioring_cqe *cqes;        /* The completion entries */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_get_sqe
+ *
+ * Description:
+ *   Return the next free submission entry, or NULL if the submission queue
+ *   is full.  The entry is handed to the kernel by ioring_submit().
+ *
+ ****************************************************************************/
+
+static inline FAR struct ioring_sqe *ioring_get_sqe(FAR struct ioring *ring)
+{
+  uint32_t head = __atomic_load_n(&ring->sq_head, __ATOMIC_ACQUIRE);
+
+  if (ring->sq_tail - head >= ring->sq_entries)
+    {
+      return NULL;
+    }
+
+  return IORING_SQ_ENTRY(ring, ring->sq_tail);
+}
+
+/****************************************************************************
+ * Name: ioring_submit
+ *
+ * Description:
+ *   Publish the entry returned by ioring_get_sqe().  Return non-zero if the
+ *   ring thread is sleeping and ioring_enter() has to be called to wake it
+ *   up.
+ *
+ ****************************************************************************/
+
+static inline int ioring_submit(FAR struct ioring *ring)
+{
+  __atomic_store_n(&ring->sq_tail, ring->sq_tail + 1, __ATOMIC_SEQ_CST);
+  return __atomic_load_n(&ring->flags, __ATOMIC_SEQ_CST) &
+         IORING_SQ_NEED_WAKEUP;
+}
+
+/****************************************************************************
+ * Name: ioring_peek_cqe
+ *
+ * Description:
+ *   Return the oldest completion entry, or NULL if there is none.  The
+ *   entry is released by ioring_cqe_seen().
+ *
+ ****************************************************************************/
+
+static inline FAR struct ioring_cqe *
+ioring_peek_cqe(FAR struct ioring *ring)
+{
+  uint32_t tail = __atomic_load_n(&ring->cq_tail, __ATOMIC_ACQUIRE);
+
+  if (ring->cq_head == tail)
+    {
+      return NULL;
+    }
+
+  return IORING_CQ_ENTRY(ring, ring->cq_head);
+}
+
+/****************************************************************************
+ * Name: ioring_cqe_seen
+ ****************************************************************************/
+
+static inline void ioring_cqe_seen(FAR struct ioring *ring)
+{
+  __atomic_store_n(&ring->cq_head, ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+int ioring_setup(FAR struct ioring *ring, int flags);
+int ioring_enter(int fd, unsigned int min_complete, int flags);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_IORING_H */
@@ -69,6 +69,18 @@
  *
  *      char myname[CONFIG_TASK_NAME_SIZE];
  *      prctl(PR_GET_NAME_EXT, myname, pid);
+ *
+ *  PR_SET_TIMERSLACK
+ *    Set the timer slack of the calling thread to optional arg2 (unsigned
+ *    long) nanoseconds, or to the default slack if arg2 is zero.  The
+ *    sleeps and timeouts of the thread may then expire up to that much
+ *    late, to share a timer interrupt with other timers.  Requires
+ *    CONFIG_WDOG_TIMER_SLACK.  As an example:
+ *
+ *      prctl(PR_SET_TIMERSLACK, 50000ul);
+ *
+ *  PR_GET_TIMERSLACK
+ *    Return the timer slack of the calling thread in nanoseconds.
  */
 
 #define PR_SET_NAME     1
@@ -79,6 +91,9 @@
 #define PR_SET_DUMPABLE 5
 #define PR_GET_DUMPABLE 6
 
+#define PR_SET_TIMERSLACK 7
+#define PR_GET_TIMERSLACK 8
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -800,6 +800,23 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* struct v4l2_exportbuffer
+ * Used by VIDIOC_EXPBUF to export a buffer as a shareable file descriptor
+ * which other drivers import with V4L2_MEMORY_DMABUF.
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t type;        /* enum #v4l2_buf_type */
+  uint32_t index;       /* Buffer id */
+  uint32_t plane;       /* Plane index, 0 for single-planar buffers */
+  uint32_t flags;       /* O_CLOEXEC and access mode of the new fd */
+  int32_t  fd;          /* Returned file descriptor */
+  uint32_t reserved[11];
+};
+
+typedef struct v4l2_exportbuffer v4l2_exportbuffer_t;
+
 /* Image is a keyframe (I-frame) */
 
 #define V4L2_BUF_FLAG_KEYFRAME                  0x00000008
@@ -65,11 +65,14 @@
  * with legacy naming of other ELF types.
  */
 
+/* The symbols resolved while binding a module, direct mapped by the
+ * symbol index.
+ */
+
 typedef struct
 {
-  dq_entry_t entry;
   Elf_Sym    sym;
-  int        idx;
+  int        idx;               /* Symbol index, -1 if the entry is free */
 } Elf_SymCache;
 
 struct
@@ -165,6 +168,58 @@ static inline int libelf_readrelas(FAR struct mod_loadinfo_s *loadinfo,
                      relsec->sh_offset + offset);
 }
 
+/****************************************************************************
+ * Name: libelf_cachesym
+ *
+ * Description:
+ *   Get the symbol table entry at symidx with its value resolved.  The
+ *   entry is read and resolved only if it is not in the module cache.
+ *
+ * Returned Value:
+ *   0 (OK) or -ESRCH, if the symbol has no name, is returned with *sym
+ *   set.  Another negated errno is returned on failure.
+ *
+ ****************************************************************************/
+
+static int libelf_cachesym(FAR struct module_s *modp,
+                           FAR struct mod_loadinfo_s *loadinfo,
+                           FAR Elf_SymCache *cache, int symidx,
+                           FAR const struct symtab_s *exports, int nexports,
+                           FAR Elf_Sym **sym)
+{
+  int ret;
+
+  cache += symidx % CONFIG_LIBC_ELF_SYMBOL_CACHECOUNT;
+  *sym = &cache->sym;
+  if (cache->idx == symidx)
+    {
+      return OK;
+    }
+
+  /* Read the symbol table entry into memory */
+
+  cache->idx = -1;
+  ret = libelf_readsym(loadinfo, symidx, &cache->sym,
+                       &loadinfo->shdr[loadinfo->symtabidx]);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Get the value of the symbol (in sym.st_value) */
+
+  ret = libelf_symvalue(modp, loadinfo, &cache->sym,
+                        loadinfo->shdr[loadinfo->strtabidx].sh_offset,
+                        exports, nexports);
+  if (ret < 0 && ret != -ESRCH)
+    {
+      return ret;
+    }
+
+  cache->idx = symidx;
+  return ret;
+}
+
 /****************************************************************************
  * Name: libelf_relocate and libelf_relocateadd
  *
@@ -179,21 +234,18 @@ static inline int libelf_readrelas(FAR struct mod_loadinfo_s *loadinfo,
 
 static int libelf_relocate(FAR struct module_s *modp,
                            FAR struct mod_loadinfo_s *loadinfo, int relidx,
+                           FAR Elf_SymCache *cache,
                            FAR const struct symtab_s *exports, int nexports)
 {
   FAR Elf_Shdr     *relsec = &loadinfo->shdr[relidx];
   FAR Elf_Shdr     *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rel      *rels;
   FAR Elf_Rel      *rel;
-  FAR Elf_SymCache *cache;
   FAR Elf_Sym      *sym;
-  FAR dq_entry_t   *e;
-  dq_queue_t        q;
   uintptr_t         addr;
   int               symidx;
   int               ret = OK;
   int               i;
-  int               j;
 
   /* Define potential architecture specific elf data container */
 
@@ -207,14 +259,12 @@ static int libelf_relocate(FAR struct module_s *modp,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -239,94 +289,31 @@ static int libelf_relocate(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rel->r_info);
 
-      /* First try the cache */
+      /* Get the symbol, reading and resolving it only once per module.
+       *
+       * The special error -ESRCH is returned only in one condition:  The
+       * symbol has no name.
+       *
+       * There are a few relocations for a few architectures that do no
+       * depend upon a named symbol.  We don't know if that is the case
+       * here, but we will use a NULL symbol pointer to indicate that case
+       * to up_relocate().  That function can then do what is best.
+       */
 
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
+      ret = libelf_cachesym(modp, loadinfo, cache, symidx, exports,
+                            nexports, &sym);
+      if (ret == -ESRCH)
         {
-          cache = (FAR Elf_SymCache *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
+          berr("ERROR: Section %d reloc %d: "
+               "Undefined symbol[%d] has no name: %d\n",
+               relidx, i, symidx, ret);
         }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
-       */
-
-      if (sym == NULL)
+      else if (ret < 0)
         {
-          if (j < CONFIG_LIBC_ELF_SYMBOL_CACHECOUNT)
-            {
-              cache = lib_malloc(sizeof(Elf_SymCache));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR Elf_SymCache *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = libelf_readsym(loadinfo, symidx, sym,
-                               &loadinfo->shdr[loadinfo->symtabidx]);
-          if (ret < 0)
-            {
-              berr("ERROR: Section %d reloc %d: "
-                   "Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              lib_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = libelf_symvalue(modp, loadinfo, sym,
-                  loadinfo->shdr[loadinfo->strtabidx].sh_offset,
-                  exports, nexports);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  lib_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
+          berr("ERROR: Section %d reloc %d: "
+               "Failed to get symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -418,18 +405,13 @@ static int libelf_relocate(FAR struct module_s *modp,
     }
 
   lib_free(rels);
-  while ((e = dq_peek(&q)) != NULL)
-    {
-      dq_rem(e, &q);
-      lib_free(e);
-    }
 
   return ret;
 }
 
 static int libelf_relocateadd(FAR struct module_s *modp,
                               FAR struct mod_loadinfo_s *loadinfo,
-                              int relidx,
+                              int relidx, FAR Elf_SymCache *cache,
                               FAR const struct symtab_s *exports,
                               int nexports)
 {
@@ -437,15 +419,11 @@ static int libelf_relocateadd(FAR struct module_s *modp,
   FAR Elf_Shdr     *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rela     *relas;
   FAR Elf_Rela     *rela;
-  FAR Elf_SymCache *cache;
   FAR Elf_Sym      *sym;
-  FAR dq_entry_t   *e;
-  dq_queue_t        q;
   uintptr_t         addr;
   int               symidx;
   int               ret = OK;
   int               i;
-  int               j;
 
   /* Define potential architecture specific elf data container */
 
@@ -459,14 +437,12 @@ static int libelf_relocateadd(FAR struct module_s *modp,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -491,94 +467,31 @@ static int libelf_relocateadd(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rela->r_info);
 
-      /* First try the cache */
+      /* Get the symbol, reading and resolving it only once per module.
+       *
+       * The special error -ESRCH is returned only in one condition:  The
+       * symbol has no name.
+       *
+       * There are a few relocations for a few architectures that do no
+       * depend upon a named symbol.  We don't know if that is the case
+       * here, but we will use a NULL symbol pointer to indicate that case
+       * to up_relocate().  That function can then do what is best.
+       */
 
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
+      ret = libelf_cachesym(modp, loadinfo, cache, symidx, exports,
+                            nexports, &sym);
+      if (ret == -ESRCH)
         {
-          cache = (FAR Elf_SymCache *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
+          berr("ERROR: Section %d reloc %d: "
+               "Undefined symbol[%d] has no name: %d\n",
+               relidx, i, symidx, ret);
         }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
-       */
-
-      if (sym == NULL)
+      else if (ret < 0)
         {
-          if (j < CONFIG_LIBC_ELF_SYMBOL_CACHECOUNT)
-            {
-              cache = lib_malloc(sizeof(Elf_SymCache));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR Elf_SymCache *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = libelf_readsym(loadinfo, symidx, sym,
-                               &loadinfo->shdr[loadinfo->symtabidx]);
-          if (ret < 0)
-            {
-              berr("ERROR: Section %d reloc %d: "
-                   "Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              lib_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = libelf_symvalue(modp, loadinfo, sym,
-                           loadinfo->shdr[loadinfo->strtabidx].sh_offset,
-                           exports, nexports);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  lib_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
+          berr("ERROR: Section %d reloc %d: "
+               "Failed to get symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -614,11 +527,6 @@ static int libelf_relocateadd(FAR struct module_s *modp,
     }
 
   lib_free(relas);
-  while ((e = dq_peek(&q)) != NULL)
-    {
-      dq_rem(e, &q);
-      lib_free(e);
-    }
 
   return ret;
 }
@@ -916,6 +824,7 @@ int libelf_bind(FAR struct module_s *modp,
                 FAR struct mod_loadinfo_s *loadinfo,
                 FAR const struct symtab_s *exports, int nexports)
 {
+  FAR Elf_SymCache *cache = NULL;
   int ret;
   int i;
 
@@ -944,6 +853,25 @@ int libelf_bind(FAR struct module_s *modp,
       goto errout_with_addrenv;
     }
 
+  /* The resolved symbols are shared by the relocation sections */
+
+  if (loadinfo->ehdr.e_type != ET_DYN)
+    {
+      cache = lib_malloc(CONFIG_LIBC_ELF_SYMBOL_CACHECOUNT *
+                         sizeof(Elf_SymCache));
+      if (cache == NULL)
+        {
+          berr("Failed to allocate memory for elf symbols\n");
+          ret = -ENOMEM;
+          goto errout_with_addrenv;
+        }
+
+      for (i = 0; i < CONFIG_LIBC_ELF_SYMBOL_CACHECOUNT; i++)
+        {
+          cache[i].idx = -1;
+        }
+    }
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -1019,7 +947,8 @@ int libelf_bind(FAR struct module_s *modp,
                     continue;
                   }
 
-                ret = libelf_relocate(modp, loadinfo, i, exports, nexports);
+                ret = libelf_relocate(modp, loadinfo, i, cache, exports,
+                                      nexports);
                 break;
               case SHT_RELA:
                 if ((loadinfo->shdr[infosec].sh_flags & SHF_ALLOC) == 0)
@@ -1027,7 +956,7 @@ int libelf_bind(FAR struct module_s *modp,
                     continue;
                   }
 
-                ret = libelf_relocateadd(modp, loadinfo, i, exports,
+                ret = libelf_relocateadd(modp, loadinfo, i, cache, exports,
                                          nexports);
                 break;
               case SHT_INIT_ARRAY:
@@ -1080,6 +1009,7 @@ int libelf_bind(FAR struct module_s *modp,
 #endif
 
 errout_with_addrenv:
+  lib_free(cache);
 
 #ifdef CONFIG_ARCH_ADDRENV
   if (loadinfo->addrenv != NULL)
@@ -41,6 +41,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/lib/elf.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/pgalloc.h>
 
 #include "libc.h"
 #include "elf/elf.h"
@@ -432,6 +433,15 @@ static inline int libelf_loadfile(FAR struct mod_loadinfo_s *loadinfo)
               goto skipload;
             }
 
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+          /* The read-only sections are already in the shared text pages */
+
+          if (pptr == &text && loadinfo->text != NULL)
+            {
+              goto skipload;
+            }
+#endif
+
           /* SHT_NOBITS indicates that there is no data in the file for the
            * section.
            */
@@ -737,6 +747,26 @@ int libelf_load_with_addrenv(FAR struct mod_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+  /* Map the text pages of an earlier instance instead of private ones */
+
+  if (loadinfo->text != NULL &&
+      loadinfo->text->npages != MM_NPAGES(loadinfo->textsize))
+    {
+      loadinfo->text = NULL;
+    }
+
+  if (loadinfo->text != NULL)
+    {
+      ret = addrenv_text_attach(loadinfo->addrenv, loadinfo->text);
+      if (ret < 0)
+        {
+          berr("ERROR: addrenv_text_attach failed: %d\n", ret);
+          goto errout_with_buffers;
+        }
+    }
+#endif
+
   /* If CONFIG_ARCH_ADDRENV=y, then the loaded ELF lies in a virtual address
    * space that may not be in place now.  elf_addrenv_select() will
    * temporarily instantiate that address space.
@@ -33,6 +33,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/mutex.h>
 #include <nuttx/symtab.h>
 #include <nuttx/lib/elf.h>
 
@@ -65,6 +66,22 @@ struct eptable_s
   FAR void    *epaddr;      /* Address of global symbol */
 };
 
+#ifdef CONFIG_LIBC_ELF_SYMBOL_HASH
+/* A hash index of the symbol table exported by the base code, built on
+ * the first lookup and kept until another table is passed.
+ */
+
+struct libelf_symhash_s
+{
+  FAR const struct symtab_s *exports; /* The indexed table */
+  int nexports;                       /* The number of symbols in it */
+  uint32_t mask;                      /* The number of buckets - 1 */
+  FAR uint32_t *hash;                 /* The hash of each symbol */
+  FAR int *bucket;                    /* First symbol of each bucket */
+  FAR int *chain;                     /* Next symbol in the same bucket */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -72,6 +89,15 @@ struct eptable_s
 extern struct eptable_s global_table[];
 extern int nglobals;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_ELF_SYMBOL_HASH
+static struct libelf_symhash_s g_symhash;
+static mutex_t g_symhash_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -228,6 +254,141 @@ static int libelf_symcallback(FAR struct module_s *modp, FAR void *arg)
   return SYM_NOT_FOUND;
 }
 
+/****************************************************************************
+ * Name: libelf_hashname
+ *
+ * Description:
+ *   The GNU hash function used by the dynamic linkers (DT_GNU_HASH).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_ELF_SYMBOL_HASH
+static uint32_t libelf_hashname(FAR const char *name)
+{
+  uint32_t hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: libelf_buildhash
+ *
+ * Description:
+ *   Index the symbol table exports in g_symhash.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int libelf_buildhash(FAR const struct symtab_s *exports, int nexports)
+{
+  FAR uint32_t *hash;
+  uint32_t nbuckets = 1;
+  int i;
+
+  while (nbuckets < nexports)
+    {
+      nbuckets <<= 1;
+    }
+
+  hash = lib_malloc((nexports + nbuckets + nexports) * sizeof(uint32_t));
+  if (hash == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  lib_free(g_symhash.hash);
+  g_symhash.exports  = exports;
+  g_symhash.nexports = nexports;
+  g_symhash.mask     = nbuckets - 1;
+  g_symhash.hash     = hash;
+  g_symhash.bucket   = (FAR int *)(hash + nexports);
+  g_symhash.chain    = g_symhash.bucket + nbuckets;
+
+  memset(g_symhash.bucket, 0xff, nbuckets * sizeof(int));
+
+  /* Insert backwards, so that a chain is walked in the table order and
+   * the first of duplicate names is found, as symtab_findbyname() does.
+   */
+
+  for (i = nexports - 1; i >= 0; i--)
+    {
+      FAR int *bucket;
+
+      hash[i]             = libelf_hashname(exports[i].sym_name);
+      bucket              = &g_symhash.bucket[hash[i] & g_symhash.mask];
+      g_symhash.chain[i]  = *bucket;
+      *bucket             = i;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: libelf_findexport
+ *
+ * Description:
+ *   Find a symbol of the table exported by the base code.  With
+ *   CONFIG_LIBC_ELF_SYMBOL_HASH, the table is hashed instead of searched.
+ *
+ ****************************************************************************/
+
+static FAR const struct symtab_s *
+libelf_findexport(FAR const struct symtab_s *exports,
+                  FAR const char *name, int nexports)
+{
+#ifdef CONFIG_LIBC_ELF_SYMBOL_HASH
+  FAR const struct symtab_s *symbol = NULL;
+  uint32_t hash;
+  int i;
+
+  if (exports == NULL || nexports <= 0 ||
+      nxmutex_lock(&g_symhash_lock) < 0)
+    {
+      return symtab_findbyname(exports, name, nexports);
+    }
+
+  if ((g_symhash.exports != exports || g_symhash.nexports != nexports) &&
+      libelf_buildhash(exports, nexports) < 0)
+    {
+      nxmutex_unlock(&g_symhash_lock);
+      return symtab_findbyname(exports, name, nexports);
+    }
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  hash = libelf_hashname(name);
+  for (i = g_symhash.bucket[hash & g_symhash.mask]; i >= 0;
+       i = g_symhash.chain[i])
+    {
+      if (g_symhash.hash[i] == hash &&
+          strcmp(exports[i].sym_name, name) == 0)
+        {
+          symbol = &exports[i];
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_symhash_lock);
+  return symbol;
+#else
+  return symtab_findbyname(exports, name, nexports);
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -408,7 +569,7 @@ int libelf_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            symbol = symtab_findbyname(exports, exportinfo.name,
+            symbol = libelf_findexport(exports, exportinfo.name,
                                        nexports);
           }
 
@@ -199,6 +199,11 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream);
 ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
                             FAR FILE *stream);
 
+/* Defined in lib_libfilelock.c */
+
+void lib_flockfile(FAR FILE *stream);
+void lib_funlockfile(FAR FILE *stream);
+
 /* Defined in lib_libfread_unlocked.c */
 
 ssize_t lib_fread_unlocked(FAR void *ptr, size_t count, FAR FILE *stream);
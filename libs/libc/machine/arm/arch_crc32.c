@@ -74,14 +74,14 @@ uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
 }
 
 /****************************************************************************
- * Name: crc32part_c
+ * Name: crc32cpart
  *
  * Description:
  *   crc32 Castagnoli polynomial 0x1EDC6F41
  *
  ****************************************************************************/
 
-uint32_t crc32part_c(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+uint32_t crc32cpart(FAR const uint8_t *src, size_t len, uint32_t crc32val)
 {
   size_t i = 0;
 
@@ -0,0 +1,153 @@
+/****************************************************************************
+ * libs/libc/machine/arm/armv8-m/arch_net_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The value of a 16-bit word with 'b' as its first or its second byte */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b) << 8)
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b))
+#else
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b))
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b) << 8)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_chksum_partial
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer in the CPU byte order to a 32-bit one's
+ *   complement sum, four 32-bit words per round chained through the carry
+ *   flag.
+ *
+ ****************************************************************************/
+
+uint32_t net_chksum_partial(uint32_t sum, FAR const void *data, size_t len)
+{
+  FAR const uint8_t *ptr = data;
+  uint32_t acc = 0;
+  uint32_t res;
+  bool odd;
+
+  if (len == 0)
+    {
+      return sum;
+    }
+
+  /* Start from a word aligned address, LDM and LDRD which the compiler
+   * may merge the loads into can't access the unaligned memory.
+   */
+
+  odd = ((uintptr_t)ptr & 1) != 0;
+  if (odd)
+    {
+      acc = CHKSUM_BYTE1(*ptr++);
+      len--;
+    }
+
+  if (((uintptr_t)ptr & 2) != 0 && len >= 2)
+    {
+      acc += *(FAR const uint16_t *)ptr;
+      ptr += 2;
+      len -= 2;
+    }
+
+  while (len >= 16)
+    {
+      FAR const uint32_t *ptr32 = (FAR const uint32_t *)ptr;
+
+      __asm__
+      (
+        "adds %0, %0, %1\n"
+        "adcs %0, %0, %2\n"
+        "adcs %0, %0, %3\n"
+        "adcs %0, %0, %4\n"
+        "adc  %0, %0, #0\n"
+        : "+r"(acc)
+        : "r"(ptr32[0]), "r"(ptr32[1]), "r"(ptr32[2]), "r"(ptr32[3])
+        : "cc"
+      );
+
+      ptr += 16;
+      len -= 16;
+    }
+
+  while (len >= 4)
+    {
+      __asm__
+      (
+        "adds %0, %0, %1\n"
+        "adc  %0, %0, #0\n"
+        : "+r"(acc)
+        : "r"(*(FAR const uint32_t *)ptr)
+        : "cc"
+      );
+
+      ptr += 4;
+      len -= 4;
+    }
+
+  /* The remaining words can't overflow the folded sum */
+
+  res = (acc & 0xffff) + (acc >> 16);
+
+  if (len >= 2)
+    {
+      res += *(FAR const uint16_t *)ptr;
+      ptr += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      res += CHKSUM_BYTE0(*ptr);
+    }
+
+  res = (res & 0xffff) + (res >> 16);
+  res = (res & 0xffff) + (res >> 16);
+
+  if (odd)
+    {
+      res = ((res & 0xff) << 8) | (res >> 8);
+    }
+
+  sum += res;
+  return sum < res ? sum + 1 : sum;
+}
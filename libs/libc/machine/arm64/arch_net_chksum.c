@@ -0,0 +1,132 @@
+/****************************************************************************
+ * libs/libc/machine/arm64/arch_net_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/param.h>
+#include <arm_neon.h>
+
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each round adds four 16-bit words to every 32-bit lane, so the lanes
+ * can't overflow within this number of the rounds.
+ */
+
+#define CHKSUM_NROUNDS  16384
+
+/* The value of a 16-bit word with 'b' as its first or its second byte */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b) << 8)
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b))
+#else
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b))
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b) << 8)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_chksum_partial
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer in the CPU byte order to a 32-bit one's
+ *   complement sum, 32 bytes per round with the NEON pairwise additions.
+ *
+ ****************************************************************************/
+
+uint32_t net_chksum_partial(uint32_t sum, FAR const void *data, size_t len)
+{
+  FAR const uint8_t *ptr = data;
+  uint64_t acc = 0;
+  uint32_t res;
+  bool odd;
+
+  if (len == 0)
+    {
+      return sum;
+    }
+
+  /* Start from an even address, the result is swapped at the end */
+
+  odd = ((uintptr_t)ptr & 1) != 0;
+  if (odd)
+    {
+      acc = CHKSUM_BYTE1(*ptr++);
+      len--;
+    }
+
+  while (len >= 32)
+    {
+      uint32x4_t acc32 = vdupq_n_u32(0);
+      size_t n = MIN(len / 32, CHKSUM_NROUNDS);
+
+      len -= n * 32;
+      while (n-- > 0)
+        {
+          acc32 = vpadalq_u16(acc32, vld1q_u16((FAR const uint16_t *)ptr));
+          acc32 = vpadalq_u16(acc32,
+                              vld1q_u16((FAR const uint16_t *)ptr + 8));
+          ptr  += 32;
+        }
+
+      acc += vaddlvq_u32(acc32);
+    }
+
+  while (len >= 2)
+    {
+      acc += *(FAR const uint16_t *)ptr;
+      ptr += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc += CHKSUM_BYTE0(*ptr);
+    }
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  res = (uint32_t)acc;
+  res = (res & 0xffff) + (res >> 16);
+  res = (res & 0xffff) + (res >> 16);
+
+  if (odd)
+    {
+      res = ((res & 0xff) << 8) | (res >> 8);
+    }
+
+  sum += res;
+  return sum < res ? sum + 1 : sum;
+}
@@ -0,0 +1,102 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_memchr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include "libc.h"
+#include "arch_string.h"
+
+#if defined(LIBC_BUILD_MEMCHR)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memchr
+ *
+ * Description:
+ *   Locate the first occurrence of c in the first n bytes of s, a vector
+ *   register group of bytes per round, or a word per round without the
+ *   vector extension.
+ *
+ ****************************************************************************/
+
+#undef memchr
+no_builtin("memchr")
+FAR void *ARCH_LIBCFUN(memchr)(FAR const void *s, int c, size_t n)
+{
+  FAR const uint8_t *p = s;
+#ifdef CONFIG_RISCV_STRING_VECTOR
+  size_t vl;
+  long first;
+
+  for (; n > 0; n -= vl, p += vl)
+    {
+      vuint8m8_t vec;
+
+      vl    = __riscv_vsetvl_e8m8(n);
+      vec   = __riscv_vle8_v_u8m8(p, vl);
+      first = __riscv_vfirst_m_b1(
+                __riscv_vmseq_vx_u8m8_b1(vec, (uint8_t)c, vl), vl);
+      if (first >= 0)
+        {
+          return (FAR void *)(p + first);
+        }
+    }
+#else
+  uintptr_t mask = WORD_REPEAT(c);
+
+  for (; n > 0 && !WORD_ALIGNED(p); n--, p++)
+    {
+      if (*p == (uint8_t)c)
+        {
+          return (FAR void *)p;
+        }
+    }
+
+  for (; n >= WORD_SIZE; n -= WORD_SIZE, p += WORD_SIZE)
+    {
+      if (WORD_HASZERO(*(FAR const uintptr_t *)p ^ mask))
+        {
+          break;
+        }
+    }
+
+  for (; n > 0; n--, p++)
+    {
+      if (*p == (uint8_t)c)
+        {
+          return (FAR void *)p;
+        }
+    }
+#endif
+
+  return NULL;
+}
+#endif
@@ -0,0 +1,107 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_memcmp.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include "libc.h"
+#include "arch_string.h"
+
+#if defined(LIBC_BUILD_MEMCMP)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memcmp
+ *
+ * Description:
+ *   Compare the first n bytes of s1 and s2, a vector register group of
+ *   bytes per round, or a word per round when both are equally aligned.
+ *
+ ****************************************************************************/
+
+#undef memcmp
+no_builtin("memcmp")
+int ARCH_LIBCFUN(memcmp)(FAR const void *s1, FAR const void *s2, size_t n)
+{
+  FAR const uint8_t *p1 = s1;
+  FAR const uint8_t *p2 = s2;
+#ifdef CONFIG_RISCV_STRING_VECTOR
+  size_t vl;
+  long first;
+
+  for (; n > 0; n -= vl, p1 += vl, p2 += vl)
+    {
+      vuint8m8_t v1;
+      vuint8m8_t v2;
+
+      vl    = __riscv_vsetvl_e8m8(n);
+      v1    = __riscv_vle8_v_u8m8(p1, vl);
+      v2    = __riscv_vle8_v_u8m8(p2, vl);
+      first = __riscv_vfirst_m_b1(__riscv_vmsne_vv_u8m8_b1(v1, v2, vl), vl);
+      if (first >= 0)
+        {
+          return p1[first] - p2[first];
+        }
+    }
+#else
+  if (WORD_ALIGNED((uintptr_t)p1 ^ (uintptr_t)p2))
+    {
+      for (; n > 0 && !WORD_ALIGNED(p1); n--, p1++, p2++)
+        {
+          if (*p1 != *p2)
+            {
+              return *p1 - *p2;
+            }
+        }
+
+      for (; n >= WORD_SIZE; n -= WORD_SIZE)
+        {
+          if (*(FAR const uintptr_t *)p1 != *(FAR const uintptr_t *)p2)
+            {
+              break;
+            }
+
+          p1 += WORD_SIZE;
+          p2 += WORD_SIZE;
+        }
+    }
+
+  for (; n > 0; n--, p1++, p2++)
+    {
+      if (*p1 != *p2)
+        {
+          return *p1 - *p2;
+        }
+    }
+#endif
+
+  return 0;
+}
+#endif
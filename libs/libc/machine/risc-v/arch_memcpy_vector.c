@@ -0,0 +1,66 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_memcpy_vector.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include "libc.h"
+#include "arch_string.h"
+
+#if defined(LIBC_BUILD_MEMCPY)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memcpy
+ *
+ * Description:
+ *   Copy n bytes from src to dest, a vector register group of bytes per
+ *   round.
+ *
+ ****************************************************************************/
+
+#undef memcpy
+no_builtin("memcpy")
+FAR void *ARCH_LIBCFUN(memcpy)(FAR void *dest, FAR const void *src,
+                               size_t n)
+{
+  FAR uint8_t *d = dest;
+  FAR const uint8_t *s = src;
+  size_t vl;
+
+  for (; n > 0; n -= vl, d += vl, s += vl)
+    {
+      vl = __riscv_vsetvl_e8m8(n);
+      __riscv_vse8_v_u8m8(d, __riscv_vle8_v_u8m8(s, vl), vl);
+    }
+
+  return dest;
+}
+#endif
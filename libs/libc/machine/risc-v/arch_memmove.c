@@ -0,0 +1,132 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_memmove.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include "libc.h"
+#include "arch_string.h"
+
+#if defined(LIBC_BUILD_MEMMOVE)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memmove
+ *
+ * Description:
+ *   Copy n bytes from src to dest, the areas may overlap.  Copy forward
+ *   unless dest overlaps the end of src, a vector register group of bytes
+ *   per round, or a word per round when both are equally aligned.
+ *
+ ****************************************************************************/
+
+#undef memmove
+no_builtin("memmove")
+FAR void *ARCH_LIBCFUN(memmove)(FAR void *dest, FAR const void *src,
+                                size_t n)
+{
+  FAR uint8_t *d = dest;
+  FAR const uint8_t *s = src;
+#ifdef CONFIG_RISCV_STRING_VECTOR
+  size_t vl;
+
+  if ((uintptr_t)d - (uintptr_t)s >= n)
+    {
+      for (; n > 0; n -= vl, d += vl, s += vl)
+        {
+          vl = __riscv_vsetvl_e8m8(n);
+          __riscv_vse8_v_u8m8(d, __riscv_vle8_v_u8m8(s, vl), vl);
+        }
+    }
+  else
+    {
+      for (d += n, s += n; n > 0; n -= vl)
+        {
+          vl = __riscv_vsetvl_e8m8(n);
+          d -= vl;
+          s -= vl;
+          __riscv_vse8_v_u8m8(d, __riscv_vle8_v_u8m8(s, vl), vl);
+        }
+    }
+#else
+  bool words = WORD_ALIGNED((uintptr_t)d ^ (uintptr_t)s);
+
+  if ((uintptr_t)d - (uintptr_t)s >= n)
+    {
+      if (words)
+        {
+          for (; n > 0 && !WORD_ALIGNED(d); n--)
+            {
+              *d++ = *s++;
+            }
+
+          for (; n >= WORD_SIZE; n -= WORD_SIZE)
+            {
+              *(FAR uintptr_t *)d = *(FAR const uintptr_t *)s;
+              d += WORD_SIZE;
+              s += WORD_SIZE;
+            }
+        }
+
+      for (; n > 0; n--)
+        {
+          *d++ = *s++;
+        }
+    }
+  else
+    {
+      d += n;
+      s += n;
+
+      if (words)
+        {
+          for (; n > 0 && !WORD_ALIGNED(d); n--)
+            {
+              *--d = *--s;
+            }
+
+          for (; n >= WORD_SIZE; n -= WORD_SIZE)
+            {
+              d -= WORD_SIZE;
+              s -= WORD_SIZE;
+              *(FAR uintptr_t *)d = *(FAR const uintptr_t *)s;
+            }
+        }
+
+      for (; n > 0; n--)
+        {
+          *--d = *--s;
+        }
+    }
+#endif
+
+  return dest;
+}
+#endif
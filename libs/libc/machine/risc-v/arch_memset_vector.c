@@ -0,0 +1,66 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_memset_vector.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include "libc.h"
+#include "arch_string.h"
+
+#if defined(LIBC_BUILD_MEMSET)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memset
+ *
+ * Description:
+ *   Fill n bytes of s with c, a vector register group of bytes per
+ *   round.
+ *
+ ****************************************************************************/
+
+#undef memset
+no_builtin("memset")
+FAR void *ARCH_LIBCFUN(memset)(FAR void *s, int c, size_t n)
+{
+  FAR uint8_t *d = s;
+  vuint8m8_t vec;
+  size_t vl;
+
+  vec = __riscv_vmv_v_x_u8m8((uint8_t)c, __riscv_vsetvlmax_e8m8());
+  for (; n > 0; n -= vl, d += vl)
+    {
+      vl = __riscv_vsetvl_e8m8(n);
+      __riscv_vse8_v_u8m8(d, vec, vl);
+    }
+
+  return s;
+}
+#endif
@@ -0,0 +1,121 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_net_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <riscv_vector.h>
+
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The value of a 16-bit word with 'b' as its first or its second byte */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b) << 8)
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b))
+#else
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b))
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b) << 8)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_chksum_partial
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer in the CPU byte order to a 32-bit one's
+ *   complement sum, a vector register group of words per round with the
+ *   widening reduction.
+ *
+ ****************************************************************************/
+
+uint32_t net_chksum_partial(uint32_t sum, FAR const void *data, size_t len)
+{
+  FAR const uint8_t *ptr = data;
+  vuint32m1_t zero;
+  uint64_t acc = 0;
+  uint32_t res;
+  size_t vl;
+  bool odd;
+
+  if (len == 0)
+    {
+      return sum;
+    }
+
+  /* Start from an even address, the result is swapped at the end */
+
+  odd = ((uintptr_t)ptr & 1) != 0;
+  if (odd)
+    {
+      acc = CHKSUM_BYTE1(*ptr++);
+      len--;
+    }
+
+  /* A round reduces at most VLEN / 4 words, which fit in 32 bits up to
+   * the largest VLEN allowed.
+   */
+
+  zero = __riscv_vmv_s_x_u32m1(0, 1);
+  while (len >= 2)
+    {
+      vuint16m4_t vec;
+
+      vl   = __riscv_vsetvl_e16m4(len / 2);
+      vec  = __riscv_vle16_v_u16m4((FAR const uint16_t *)ptr, vl);
+      acc += __riscv_vmv_x_s_u32m1_u32(
+               __riscv_vwredsumu_vs_u16m4_u32m1(vec, zero, vl));
+      ptr += 2 * vl;
+      len -= 2 * vl;
+    }
+
+  if (len > 0)
+    {
+      acc += CHKSUM_BYTE0(*ptr);
+    }
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  res = (uint32_t)acc;
+  res = (res & 0xffff) + (res >> 16);
+  res = (res & 0xffff) + (res >> 16);
+
+  if (odd)
+    {
+      res = ((res & 0xff) << 8) | (res >> 8);
+    }
+
+  sum += res;
+  return sum < res ? sum + 1 : sum;
+}
@@ -0,0 +1,102 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_strchr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include "libc.h"
+#include "arch_string.h"
+
+#if defined(LIBC_BUILD_STRCHR)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: strchr
+ *
+ * Description:
+ *   Locate the first occurrence of c in s, the terminator included.
+ *
+ ****************************************************************************/
+
+#undef strchr
+no_builtin("strchr")
+nosanitize_address
+FAR char *ARCH_LIBCFUN(strchr)(FAR const char *s, int c)
+{
+  FAR const uint8_t *p = (FAR const uint8_t *)s;
+#ifdef CONFIG_RISCV_STRING_VECTOR
+  size_t vl;
+  long first;
+
+  for (; ; p += vl)
+    {
+      vuint8m8_t vec;
+
+      vec   = __riscv_vle8ff_v_u8m8(p, &vl, __riscv_vsetvlmax_e8m8());
+      first = __riscv_vfirst_m_b1(
+                __riscv_vmor_mm_b1(
+                  __riscv_vmseq_vx_u8m8_b1(vec, (uint8_t)c, vl),
+                  __riscv_vmseq_vx_u8m8_b1(vec, 0, vl), vl), vl);
+      if (first >= 0)
+        {
+          p += first;
+          break;
+        }
+    }
+#else
+  uintptr_t mask = WORD_REPEAT(c);
+  uintptr_t word;
+
+  for (; !WORD_ALIGNED(p); p++)
+    {
+      if (*p == (uint8_t)c || *p == '\0')
+        {
+          break;
+        }
+    }
+
+  if (WORD_ALIGNED(p))
+    {
+      for (; ; p += WORD_SIZE)
+        {
+          word = *(FAR const uintptr_t *)p;
+          if (WORD_HASZERO(word) || WORD_HASZERO(word ^ mask))
+            {
+              break;
+            }
+        }
+    }
+
+  for (; *p != (uint8_t)c && *p != '\0'; p++);
+#endif
+
+  return *p == (uint8_t)c ? (FAR char *)p : NULL;
+}
+#endif
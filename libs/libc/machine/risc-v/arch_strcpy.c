@@ -0,0 +1,103 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_strcpy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include "libc.h"
+#include "arch_string.h"
+
+#if defined(LIBC_BUILD_STRCPY)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: strcpy
+ *
+ * Description:
+ *   Copy the string src, the terminator included, to dest.
+ *
+ ****************************************************************************/
+
+#undef strcpy
+no_builtin("strcpy")
+nosanitize_address
+FAR char *ARCH_LIBCFUN(strcpy)(FAR char *dest, FAR const char *src)
+{
+  FAR uint8_t *d = (FAR uint8_t *)dest;
+  FAR const uint8_t *s = (FAR const uint8_t *)src;
+#ifdef CONFIG_RISCV_STRING_VECTOR
+  size_t vl;
+  long first;
+
+  for (; ; d += vl, s += vl)
+    {
+      vuint8m8_t vec;
+
+      vec   = __riscv_vle8ff_v_u8m8(s, &vl, __riscv_vsetvlmax_e8m8());
+      first = __riscv_vfirst_m_b1(__riscv_vmseq_vx_u8m8_b1(vec, 0, vl), vl);
+      if (first >= 0)
+        {
+          __riscv_vse8_v_u8m8(d, vec, first + 1);
+          break;
+        }
+
+      __riscv_vse8_v_u8m8(d, vec, vl);
+    }
+#else
+  uintptr_t word;
+
+  if (WORD_ALIGNED((uintptr_t)d ^ (uintptr_t)s))
+    {
+      for (; !WORD_ALIGNED(s); d++, s++)
+        {
+          if ((*d = *s) == '\0')
+            {
+              return dest;
+            }
+        }
+
+      for (; ; d += WORD_SIZE, s += WORD_SIZE)
+        {
+          word = *(FAR const uintptr_t *)s;
+          if (WORD_HASZERO(word))
+            {
+              break;
+            }
+
+          *(FAR uintptr_t *)d = word;
+        }
+    }
+
+  while ((*d++ = *s++) != '\0');
+#endif
+
+  return dest;
+}
+#endif
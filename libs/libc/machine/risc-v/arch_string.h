@@ -0,0 +1,58 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_string.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBC_MACHINE_RISCV_ARCH_STRING_H
+#define __LIBS_LIBC_MACHINE_RISCV_ARCH_STRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_RISCV_STRING_VECTOR
+#  include <riscv_vector.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The scalar fallbacks work a register of bytes at a time */
+
+#define WORD_SIZE         sizeof(uintptr_t)
+#define WORD_ALIGNED(p)   (((uintptr_t)(p) & (WORD_SIZE - 1)) == 0)
+#define WORD_ONES         ((uintptr_t)-1 / 0xff)
+#define WORD_HIGHS        (WORD_ONES << 7)
+
+/* Nonzero if any byte of the word is zero */
+
+#define WORD_HASZERO(w)   (((w) - WORD_ONES) & ~(w) & WORD_HIGHS)
+
+/* The word with all bytes set to c */
+
+#define WORD_REPEAT(c)    (WORD_ONES * (uint8_t)(c))
+
+#endif /* __LIBS_LIBC_MACHINE_RISCV_ARCH_STRING_H */
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_strncmp.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include "libc.h"
+#include "arch_string.h"
+
+#if defined(LIBC_BUILD_STRNCMP)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: strncmp
+ *
+ * Description:
+ *   Compare at most n bytes of the strings s1 and s2.
+ *
+ ****************************************************************************/
+
+#undef strncmp
+no_builtin("strncmp")
+nosanitize_address
+int ARCH_LIBCFUN(strncmp)(FAR const char *s1, FAR const char *s2,
+                          size_t n)
+{
+  FAR const uint8_t *p1 = (FAR const uint8_t *)s1;
+  FAR const uint8_t *p2 = (FAR const uint8_t *)s2;
+#ifdef CONFIG_RISCV_STRING_VECTOR
+  size_t vl;
+  long first;
+
+  for (; n > 0; n -= vl, p1 += vl, p2 += vl)
+    {
+      vuint8m8_t v1;
+      vuint8m8_t v2;
+
+      /* The second load may stop earlier at a page without the data */
+
+      v1    = __riscv_vle8ff_v_u8m8(p1, &vl, __riscv_vsetvl_e8m8(n));
+      v2    = __riscv_vle8ff_v_u8m8(p2, &vl, vl);
+      first = __riscv_vfirst_m_b1(
+                __riscv_vmor_mm_b1(
+                  __riscv_vmsne_vv_u8m8_b1(v1, v2, vl),
+                  __riscv_vmseq_vx_u8m8_b1(v1, 0, vl), vl), vl);
+      if (first >= 0)
+        {
+          return p1[first] - p2[first];
+        }
+    }
+
+  return 0;
+#else
+  uintptr_t word;
+
+  if (WORD_ALIGNED((uintptr_t)p1 ^ (uintptr_t)p2))
+    {
+      for (; n > 0 && !WORD_ALIGNED(p1); n--, p1++, p2++)
+        {
+          if (*p1 != *p2 || *p1 == '\0')
+            {
+              return *p1 - *p2;
+            }
+        }
+
+      for (; n >= WORD_SIZE; n -= WORD_SIZE)
+        {
+          word = *(FAR const uintptr_t *)p1;
+          if (word != *(FAR const uintptr_t *)p2 || WORD_HASZERO(word))
+            {
+              break;
+            }
+
+          p1 += WORD_SIZE;
+          p2 += WORD_SIZE;
+        }
+    }
+
+  for (; n > 0; n--, p1++, p2++)
+    {
+      if (*p1 != *p2 || *p1 == '\0')
+        {
+          return *p1 - *p2;
+        }
+    }
+
+  return 0;
+#endif
+}
+#endif
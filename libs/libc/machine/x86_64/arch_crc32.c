@@ -0,0 +1,265 @@
+/****************************************************************************
+ * libs/libc/machine/x86_64/arch_crc32.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include <nuttx/crc32.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_X86_64_CRC32
+
+/* The folding constants in the bit reflected domain, from "Fast CRC
+ * Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Intel,
+ * 2009): x^(4*128+32) and x^(4*128-32) mod P, x^(128+32) and x^(128-32)
+ * mod P, x^64 mod P, then P and the Barrett constant.
+ */
+
+static const uint64_t g_k1k2[2] aligned_data(16) =
+{
+  0x0154442bd4, 0x01c6e41596
+};
+
+static const uint64_t g_k3k4[2] aligned_data(16) =
+{
+  0x01751997d0, 0x00ccaa009e
+};
+
+static const uint64_t g_k5k0[2] aligned_data(16) =
+{
+  0x0163cd6124, 0x0000000000
+};
+
+static const uint64_t g_poly[2] aligned_data(16) =
+{
+  0x01db710641, 0x01f7011641
+};
+
+/* The CRC32 of a nibble, for the few bytes which do not fill a block */
+
+static const uint32_t g_crc32_nibble[16] =
+{
+  0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+  0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+  0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+  0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t crc32_bytes(FAR const uint8_t *src, size_t len,
+                            uint32_t crc32val)
+{
+  while (len-- > 0)
+    {
+      crc32val ^= *src++;
+      crc32val  = (crc32val >> 4) ^ g_crc32_nibble[crc32val & 0xf];
+      crc32val  = (crc32val >> 4) ^ g_crc32_nibble[crc32val & 0xf];
+    }
+
+  return crc32val;
+}
+
+/****************************************************************************
+ * Name: crc32_fold
+ *
+ * Description:
+ *   Fold a multiple of 16 bytes, at least 16, with PCLMULQDQ: four
+ *   independent 128-bit lanes over 64 bytes per round, then one lane,
+ *   then the Barrett reduction to 32 bits.
+ *
+ ****************************************************************************/
+
+static uint32_t crc32_fold(FAR const uint8_t *src, size_t len,
+                           uint32_t crc32val)
+{
+  __m128i x0;
+  __m128i x1;
+  __m128i x2;
+  __m128i x3;
+  __m128i x4;
+  __m128i x5;
+
+  x1 = _mm_loadu_si128((FAR const __m128i *)src);
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc32val));
+
+  if (len >= 64)
+    {
+      x2 = _mm_loadu_si128((FAR const __m128i *)(src + 16));
+      x3 = _mm_loadu_si128((FAR const __m128i *)(src + 32));
+      x4 = _mm_loadu_si128((FAR const __m128i *)(src + 48));
+      x0 = _mm_load_si128((FAR const __m128i *)g_k1k2);
+
+      for (src += 64, len -= 64; len >= 64; src += 64, len -= 64)
+        {
+          __m128i x6;
+          __m128i x7;
+          __m128i x8;
+
+          x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+          x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+          x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+          x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+          x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+          x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+          x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+          x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+          x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                      _mm_loadu_si128((FAR const __m128i *)src));
+          x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                      _mm_loadu_si128((FAR const __m128i *)(src + 16)));
+          x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                      _mm_loadu_si128((FAR const __m128i *)(src + 32)));
+          x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                      _mm_loadu_si128((FAR const __m128i *)(src + 48)));
+        }
+
+      /* Fold the four lanes into one */
+
+      x0 = _mm_load_si128((FAR const __m128i *)g_k3k4);
+
+      x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+      x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+      x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+      x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+      x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+      x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+    }
+  else
+    {
+      x0   = _mm_load_si128((FAR const __m128i *)g_k3k4);
+      src += 16;
+      len -= 16;
+    }
+
+  for (; len >= 16; src += 16, len -= 16)
+    {
+      x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+      x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                         _mm_loadu_si128((FAR const __m128i *)src));
+    }
+
+  /* Fold 128 bits to 64 bits */
+
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x1 = _mm_srli_si128(x1, 8);
+  x1 = _mm_xor_si128(x1, x2);
+
+  x0 = _mm_loadl_epi64((FAR const __m128i *)g_k5k0);
+
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, x3);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  /* Barrett reduction to 32 bits */
+
+  x0 = _mm_load_si128((FAR const __m128i *)g_poly);
+
+  x2 = _mm_and_si128(x1, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+  x2 = _mm_and_si128(x2, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return _mm_extract_epi32(x1, 1);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_X86_64_CRC32
+/****************************************************************************
+ * Name: crc32part
+ *
+ * Description:
+ *   crc32 polynomial 0x04C11DB7 (bitreflected 0xEDB88320)
+ *
+ ****************************************************************************/
+
+uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  size_t fold = len & ~(size_t)15;
+
+  if (fold > 0)
+    {
+      crc32val = crc32_fold(src, fold, crc32val);
+    }
+
+  return crc32_bytes(src + fold, len - fold, crc32val);
+}
+#endif
+
+#ifdef CONFIG_X86_64_CRC32C
+/****************************************************************************
+ * Name: crc32cpart
+ *
+ * Description:
+ *   crc32 Castagnoli polynomial 0x1EDC6F41, with the SSE4.2 crc32
+ *   instruction
+ *
+ ****************************************************************************/
+
+uint32_t crc32cpart(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  uint64_t crc = crc32val;
+  uint64_t data;
+
+  for (; len >= 8; src += 8, len -= 8)
+    {
+      memcpy(&data, src, 8);
+      crc = _mm_crc32_u64(crc, data);
+    }
+
+  crc32val = (uint32_t)crc;
+  for (; len > 0; src++, len--)
+    {
+      crc32val = _mm_crc32_u8(crc32val, *src);
+    }
+
+  return crc32val;
+}
+#endif
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * libs/libc/machine/x86_64/arch_memset.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CPUID_01_ECX_OSXSAVE    (1 << 27)
+#define CPUID_01_ECX_AVX        (1 << 28)
+#define CPUID_07_EBX_AVX2       (1 << 5)
+
+/* The SSE and AVX state must be enabled by the kernel in XCR0 */
+
+#define XCR0_SSE_AVX            (0x6)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef FAR void *(*memset_t)(FAR void *s, int c, size_t n);
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+FAR void *arch_memset_sse2(FAR void *s, int c, size_t n);
+FAR void *arch_memset_avx2(FAR void *s, int c, size_t n);
+
+static FAR void *memset_resolve(FAR void *s, int c, size_t n);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static memset_t g_memset = memset_resolve;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void cpuid(uint32_t leaf, FAR uint32_t *eax, FAR uint32_t *ebx,
+                  FAR uint32_t *ecx)
+{
+  uint32_t edx;
+
+  __asm__ volatile("cpuid"
+                   : "=a" (*eax), "=b" (*ebx), "=c" (*ecx), "=d" (edx)
+                   : "a" (leaf), "c" (0));
+}
+
+/****************************************************************************
+ * Name: have_avx2
+ *
+ * Description:
+ *   Return true if the CPU has AVX2 and the kernel saves the YMM state.
+ *   An image built without ARCH_X86_64_AVX does not enable the AVX state,
+ *   so it keeps the SSE2 version even on a CPU with AVX2.
+ *
+ ****************************************************************************/
+
+static bool have_avx2(void)
+{
+  uint32_t eax;
+  uint32_t ebx;
+  uint32_t ecx;
+  uint32_t edx;
+
+  /* The highest basic leaf must include the extended features */
+
+  cpuid(0, &eax, &ebx, &ecx);
+  if (eax < 7)
+    {
+      return false;
+    }
+
+  cpuid(1, &eax, &ebx, &ecx);
+  if ((ecx & (CPUID_01_ECX_OSXSAVE | CPUID_01_ECX_AVX)) !=
+      (CPUID_01_ECX_OSXSAVE | CPUID_01_ECX_AVX))
+    {
+      return false;
+    }
+
+  __asm__ volatile("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+  if ((eax & XCR0_SSE_AVX) != XCR0_SSE_AVX)
+    {
+      return false;
+    }
+
+  cpuid(7, &eax, &ebx, &ecx);
+  return (ebx & CPUID_07_EBX_AVX2) != 0;
+}
+
+/****************************************************************************
+ * Name: memset_resolve
+ *
+ * Description:
+ *   Pick the memset() variant on the first call.  Concurrent first calls
+ *   store the same pointer.
+ *
+ ****************************************************************************/
+
+static FAR void *memset_resolve(FAR void *s, int c, size_t n)
+{
+  g_memset = have_avx2() ? arch_memset_avx2 : arch_memset_sse2;
+  return g_memset(s, c, n);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#undef memset
+FAR void *memset(FAR void *s, int c, size_t n)
+{
+  return g_memset(s, c, n);
+}
@@ -25,6 +25,12 @@
  * For multiple writer and one reader there is only a need to lock the
  * writer. And vice versa for only one writer and multiple reader there is
  * only a need to lock the reader.
+ *
+ * The head is only advanced by the writer and the tail only by the reader.
+ * Each is published with release semantics after the data it covers has
+ * been written or consumed, and loaded with acquire semantics by the other
+ * side, so a lock-free producer (e.g. an interrupt handler) and consumer
+ * also work on SMP.
  */
 
 /****************************************************************************
@@ -35,13 +41,66 @@
 
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/lib/lib.h>
 
 /****************************************************************************
- * Private Types
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: circbuf_offset
+ *
+ * Description:
+ *   Map a free running position to an offset in the buffer.  Power of two
+ *   sizes use a mask, avoiding a division that is a library call on cores
+ *   without a hardware divider.
+ *
+ ****************************************************************************/
+
+static inline size_t circbuf_offset(FAR struct circbuf_s *circ, size_t pos)
+{
+  if ((circ->size & (circ->size - 1)) == 0)
+    {
+      return pos & (circ->size - 1);
+    }
+
+  return pos % circ->size;
+}
+
+/****************************************************************************
+ * Name: circbuf_load_acquire
+ *
+ * Description:
+ *   Load the position published by the other side before touching the
+ *   data it covers.
+ *
+ ****************************************************************************/
+
+static inline size_t circbuf_load_acquire(FAR const size_t *pos)
+{
+  size_t val = *(FAR const volatile size_t *)pos;
+
+  SMP_MB();
+  return val;
+}
+
+/****************************************************************************
+ * Name: circbuf_store_release
+ *
+ * Description:
+ *   Publish a new position once all accesses to the data it covers are
+ *   complete.
+ *
+ ****************************************************************************/
+
+static inline void circbuf_store_release(FAR size_t *pos, size_t val)
+{
+  SMP_MB();
+  *(FAR volatile size_t *)pos = val;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -211,7 +270,8 @@ size_t circbuf_size(FAR struct circbuf_s *circ)
 size_t circbuf_used(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
-  return circ->head - circ->tail;
+  return circbuf_load_acquire(&circ->head) -
+         circbuf_load_acquire(&circ->tail);
 }
 
 /****************************************************************************
@@ -298,6 +358,7 @@ bool circbuf_is_full(FAR struct circbuf_s *circ)
 ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
                        FAR void *dst, size_t bytes)
 {
+  size_t head;
   size_t len;
   size_t off;
 
@@ -308,13 +369,14 @@ ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
       return 0;
     }
 
-  if (circ->head - pos > circ->head - circ->tail)
+  head = circbuf_load_acquire(&circ->head);
+  if (head - pos > head - circ->tail)
     {
       pos = circ->tail;
     }
 
-  len = circ->head - pos;
-  off = pos % circ->size;
+  len = head - pos;
+  off = circbuf_offset(circ, pos);
 
   if (bytes > len)
     {
@@ -386,7 +448,7 @@ ssize_t circbuf_read(FAR struct circbuf_s *circ,
   DEBUGASSERT(dst || !bytes);
 
   bytes = circbuf_peek(circ, dst, bytes);
-  circ->tail += bytes;
+  circbuf_store_release(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -423,7 +485,7 @@ ssize_t circbuf_skip(FAR struct circbuf_s *circ, size_t bytes)
       bytes = len;
     }
 
-  circ->tail += bytes;
+  circbuf_store_release(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -463,7 +525,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
     }
 
   space = circbuf_space(circ);
-  off = circ->head % circ->size;
+  off = circbuf_offset(circ, circ->head);
   if (bytes > space)
     {
       bytes = space;
@@ -477,7 +539,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
 
   memcpy((FAR char *)circ->base + off, src, space);
   memcpy(circ->base, (FAR char *)src + space, bytes - space);
-  circ->head += bytes;
+  circbuf_store_release(&circ->head, circ->head + bytes);
 
   return bytes;
 }
@@ -534,7 +596,7 @@ ssize_t circbuf_overwrite(FAR struct circbuf_s *circ,
     }
 
   circ->head += skip;
-  off = circ->head % circ->size;
+  off = circbuf_offset(circ, circ->head);
   space = circ->size - off;
   if (bytes < space)
     {
@@ -571,7 +633,7 @@ FAR void *circbuf_get_writeptr(FAR struct circbuf_s *circ, FAR size_t *size)
   DEBUGASSERT(circ);
 
   *size = circbuf_space(circ);
-  off = circ->head % circ->size;
+  off = circbuf_offset(circ, circ->head);
   if (off + *size > circ->size)
     {
       *size = circ->size - off;
@@ -602,7 +664,7 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
   DEBUGASSERT(circ);
 
   *size = circbuf_used(circ);
-  off = circ->tail % circ->size;
+  off = circbuf_offset(circ, circ->tail);
   if (off + *size > circ->size)
     {
       *size = circ->size - off;
@@ -628,7 +690,7 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 {
   DEBUGASSERT(circ);
-  circ->head += writtensize;
+  circbuf_store_release(&circ->head, circ->head + writtensize);
 }
 
 /****************************************************************************
@@ -648,5 +710,5 @@ void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 void circbuf_readcommit(FAR struct circbuf_s *circ, size_t readsize)
 {
   DEBUGASSERT(circ);
-  circ->tail += readsize;
+  circbuf_store_release(&circ->tail, circ->tail + readsize);
 }
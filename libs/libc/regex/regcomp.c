@@ -3913,6 +3913,9 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
   tnfa->final           = transitions + offs[tree->lastpos[0].position];
   tnfa->num_states      = parse_ctx.position;
   tnfa->cflags          = cflags;
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tnfa->dfa             = tre_dfa_create(tnfa);
+#endif
 
   tre_mem_destroy(mem);
   tre_stack_destroy(stack);
@@ -4021,5 +4024,9 @@ void regfree(regex_t *preg)
       xfree(tnfa->minimal_tags);
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tre_dfa_free(tnfa->dfa);
+#endif
+
   xfree(tnfa);
 }
@@ -0,0 +1,529 @@
+/****************************************************************************
+ * libs/libc/regex/regdfa.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <wchar.h>
+
+#include <nuttx/mutex.h>
+
+#include "tre.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Special values of the cached transitions */
+
+#define TRE_DFA_UNKNOWN   0xffff  /* Not computed yet */
+#define TRE_DFA_MATCH     0xfffe  /* Reaches the final state */
+#define TRE_DFA_DEAD      0xfffd  /* Can never reach the final state */
+#define TRE_DFA_MAXSTATES 0xfffc
+
+/* Characters below this get a cached transition, others are stepped
+ * through the NFA every time.
+ */
+
+#define TRE_DFA_NCHARS    128
+
+/* Assertions the DFA can evaluate */
+
+#define TRE_DFA_CLASSES   (ASSERT_CHAR_CLASS | ASSERT_CHAR_CLASS_NEG)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A DFA state is a set of NFA states.  The cache holds an array of hashes
+ * followed by the states, each made of the transitions per character class
+ * and the NFA set bitmap.  When the cache is full, it is flushed and filled
+ * again from the current state.
+ */
+
+struct tre_dfa
+{
+  mutex_t               lock;       /* Serializes the users of the cache */
+  tre_tnfa_transition_t **nfa;      /* Transitions leaving each NFA state */
+  uint32_t              *start[2];  /* Start sets, without and with BOL */
+  uint32_t              *work;      /* The set under construction */
+  uint8_t               *cache;     /* The state cache, lazily allocated */
+  int                   final;      /* ID of the final NFA state or -1 */
+  int                   icase;      /* REG_ICASE */
+  int                   newline;    /* REG_NEWLINE */
+  int                   nwords;     /* Words of a set bitmap */
+  int                   nclass;     /* Number of character classes */
+  int                   setofs;     /* Offset of the bitmap in a state */
+  int                   stride;     /* Size of a state */
+  int                   nstates;    /* States in the cache */
+  int                   maxstates;  /* States fitting in the cache */
+  int                   startidx[2];
+  unsigned int          generation; /* Incremented on every flush */
+  uint8_t               classmap[TRE_DFA_NCHARS];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int tre_dfa_isctype(tre_cint_t c, tre_ctype_t class, int icase)
+{
+  if (!icase)
+    {
+      return tre_isctype(c, class);
+    }
+
+  return tre_isctype(tre_tolower(c), class) ||
+         tre_isctype(tre_toupper(c), class);
+}
+
+/* Evaluate the character class assertions of a transition, as the parallel
+ * matcher does with CHECK_CHAR_CLASSES().
+ */
+
+static int tre_dfa_classes_ok(const tre_dfa_t *dfa,
+                              const tre_tnfa_transition_t *trans,
+                              tre_cint_t c)
+{
+  tre_ctype_t *classes;
+
+  if ((trans->assertions & ASSERT_CHAR_CLASS) &&
+      !tre_dfa_isctype(c, trans->u.class, dfa->icase))
+    {
+      return 0;
+    }
+
+  if (trans->assertions & ASSERT_CHAR_CLASS_NEG)
+    {
+      for (classes = trans->neg_classes; *classes; classes++)
+        {
+          if (tre_dfa_isctype(c, *classes, dfa->icase))
+            {
+              return 0;
+            }
+        }
+    }
+
+  return 1;
+}
+
+static int tre_dfa_isfinal(const tre_dfa_t *dfa, const uint32_t *set)
+{
+  return dfa->final >= 0 &&
+         (set[dfa->final / 32] & (UINT32_C(1) << (dfa->final % 32)));
+}
+
+static uint16_t *tre_dfa_next(const tre_dfa_t *dfa, int idx)
+{
+  return (uint16_t *)(dfa->cache + dfa->maxstates * sizeof(uint32_t) +
+                      (size_t)idx * dfa->stride);
+}
+
+static uint32_t *tre_dfa_set(const tre_dfa_t *dfa, int idx)
+{
+  return (uint32_t *)((uint8_t *)tre_dfa_next(dfa, idx) + dfa->setofs);
+}
+
+/* Find the state holding an NFA set, adding it if it is not cached */
+
+static int tre_dfa_lookup(tre_dfa_t *dfa, const uint32_t *set)
+{
+  uint32_t *hashes = (uint32_t *)dfa->cache;
+  size_t   size    = dfa->nwords * sizeof(uint32_t);
+  uint32_t hash    = 2166136261u;
+  int      i;
+
+  for (i = 0; i < dfa->nwords; i++)
+    {
+      hash = (hash ^ set[i]) * 16777619u;
+    }
+
+  for (i = 0; i < dfa->nstates; i++)
+    {
+      if (hashes[i] == hash && memcmp(tre_dfa_set(dfa, i), set, size) == 0)
+        {
+          return i;
+        }
+    }
+
+  if (dfa->nstates == dfa->maxstates)
+    {
+      dfa->nstates     = 0;
+      dfa->startidx[0] = -1;
+      dfa->startidx[1] = -1;
+      dfa->generation++;
+    }
+
+  i = dfa->nstates++;
+  hashes[i] = hash;
+  memset(tre_dfa_next(dfa, i), 0xff, dfa->nclass * sizeof(uint16_t));
+  memcpy(tre_dfa_set(dfa, i), set, size);
+  return i;
+}
+
+/* Compute the state following idx on c and cache it for the character
+ * class cls, if cls is not negative.
+ */
+
+static int tre_dfa_step(tre_dfa_t *dfa, int idx, tre_cint_t c, int cls)
+{
+  const tre_tnfa_transition_t *trans;
+  const uint32_t              *set  = tre_dfa_set(dfa, idx);
+  uint32_t                    *work = dfa->work;
+  unsigned int                generation;
+  uint32_t                    bits;
+  int                         empty = 1;
+  int                         next;
+  int                         i;
+  int                         j;
+
+  /* The search is unanchored, so a match may start after every character */
+
+  memcpy(work, dfa->start[dfa->newline && c == L'\n'],
+         dfa->nwords * sizeof(uint32_t));
+
+  for (i = 0; i < dfa->nwords; i++)
+    {
+      for (bits = set[i]; bits != 0; bits &= bits - 1)
+        {
+          j = i * 32 + ffs(bits) - 1;
+          for (trans = dfa->nfa[j]; trans->state; trans++)
+            {
+              if (trans->code_min <= c && trans->code_max >= c &&
+                  (!trans->assertions || tre_dfa_classes_ok(dfa, trans, c)))
+                {
+                  work[trans->state_id / 32] |=
+                    UINT32_C(1) << (trans->state_id % 32);
+                }
+            }
+        }
+    }
+
+  for (i = 0; i < dfa->nwords; i++)
+    {
+      if (work[i] != 0)
+        {
+          empty = 0;
+          break;
+        }
+    }
+
+  if (tre_dfa_isfinal(dfa, work))
+    {
+      next = TRE_DFA_MATCH;
+    }
+  else if (empty && !dfa->newline)
+    {
+      next = TRE_DFA_DEAD;
+    }
+  else
+    {
+      generation = dfa->generation;
+      next = tre_dfa_lookup(dfa, work);
+      if (generation != dfa->generation)
+        {
+          /* The cache was flushed, idx is gone */
+
+          cls = -1;
+        }
+    }
+
+  if (cls >= 0)
+    {
+      tre_dfa_next(dfa, idx)[cls] = next;
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tre_dfa_create
+ *
+ * Description:
+ *   Prepare the lazy DFA of a compiled regex.  NULL is returned if the
+ *   regex uses assertions other than a leading '^' or character classes,
+ *   since the DFA has no lookahead, or if the cache is too small.
+ *
+ ****************************************************************************/
+
+tre_dfa_t *tre_dfa_create(const tre_tnfa_t *tnfa)
+{
+  tre_tnfa_transition_t *trans;
+  tre_dfa_t             *dfa;
+  uint8_t               brk[TRE_DFA_NCHARS];
+  unsigned int          i;
+  int                   nwords;
+  int                   stride;
+  int                   c;
+
+  if (tnfa->have_backrefs || tnfa->have_approx || tnfa->num_states <= 0)
+    {
+      return NULL;
+    }
+
+  for (trans = tnfa->initial; trans->state; trans++)
+    {
+      if (trans->assertions & ~(ASSERT_AT_BOL | TRE_DFA_CLASSES))
+        {
+          return NULL;
+        }
+    }
+
+  /* Split the characters in classes that all the transitions, and the
+   * REG_NEWLINE handling, treat alike.
+   */
+
+  memset(brk, 0, sizeof(brk));
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans = &tnfa->transitions[i];
+      if (trans->state == NULL)
+        {
+          continue;
+        }
+
+      if (trans->assertions & ~TRE_DFA_CLASSES)
+        {
+          return NULL;
+        }
+
+      if (trans->code_min > 0 && trans->code_min < TRE_DFA_NCHARS)
+        {
+          brk[trans->code_min] = 1;
+        }
+
+      if (trans->code_max + 1 < TRE_DFA_NCHARS)
+        {
+          brk[trans->code_max + 1] = 1;
+        }
+    }
+
+  nwords = (tnfa->num_states + 31) / 32;
+  dfa = xcalloc(1, sizeof(*dfa) + tnfa->num_states * sizeof(*dfa->nfa) +
+                   3 * nwords * sizeof(uint32_t));
+  if (dfa == NULL)
+    {
+      return NULL;
+    }
+
+  dfa->nfa      = (tre_tnfa_transition_t **)(dfa + 1);
+  dfa->start[0] = (uint32_t *)(dfa->nfa + tnfa->num_states);
+  dfa->start[1] = dfa->start[0] + nwords;
+  dfa->work     = dfa->start[1] + nwords;
+  dfa->final    = -1;
+  dfa->icase    = tnfa->cflags & REG_ICASE;
+  dfa->newline  = tnfa->cflags & REG_NEWLINE;
+  dfa->nwords   = nwords;
+
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans = &tnfa->transitions[i];
+      if (trans->state == NULL)
+        {
+          continue;
+        }
+
+      dfa->nfa[trans->state_id] = trans->state;
+      if (trans->state == tnfa->final)
+        {
+          dfa->final = trans->state_id;
+        }
+
+      if (trans->assertions)
+        {
+          for (c = 1; c < TRE_DFA_NCHARS; c++)
+            {
+              if (tre_dfa_classes_ok(dfa, trans, c) !=
+                  tre_dfa_classes_ok(dfa, trans, c - 1))
+                {
+                  brk[c] = 1;
+                }
+            }
+        }
+    }
+
+  for (trans = tnfa->initial; trans->state; trans++)
+    {
+      dfa->nfa[trans->state_id] = trans->state;
+      if (trans->state == tnfa->final)
+        {
+          dfa->final = trans->state_id;
+        }
+
+      dfa->start[1][trans->state_id / 32] |=
+        UINT32_C(1) << (trans->state_id % 32);
+      if (!(trans->assertions & ASSERT_AT_BOL))
+        {
+          dfa->start[0][trans->state_id / 32] |=
+            UINT32_C(1) << (trans->state_id % 32);
+        }
+    }
+
+  if (dfa->newline)
+    {
+      brk[L'\n']     = 1;
+      brk[L'\n' + 1] = 1;
+    }
+
+  for (c = 0; c < TRE_DFA_NCHARS; c++)
+    {
+      if (c > 0 && brk[c])
+        {
+          dfa->nclass++;
+        }
+
+      dfa->classmap[c] = dfa->nclass;
+    }
+
+  dfa->nclass++;
+  dfa->setofs    = (dfa->nclass * sizeof(uint16_t) + 3) & ~3;
+  stride         = dfa->setofs + nwords * sizeof(uint32_t);
+  dfa->stride    = stride;
+  dfa->maxstates = MIN(CONFIG_LIBC_REGEX_DFA_CACHE /
+                       (stride + sizeof(uint32_t)), TRE_DFA_MAXSTATES);
+  if (dfa->maxstates < 2)
+    {
+      xfree(dfa);
+      return NULL;
+    }
+
+  dfa->startidx[0] = -1;
+  dfa->startidx[1] = -1;
+  nxmutex_init(&dfa->lock);
+  return dfa;
+}
+
+/****************************************************************************
+ * Name: tre_dfa_free
+ ****************************************************************************/
+
+void tre_dfa_free(tre_dfa_t *dfa)
+{
+  if (dfa != NULL)
+    {
+      nxmutex_destroy(&dfa->lock);
+      xfree(dfa->cache);
+      xfree(dfa);
+    }
+}
+
+/****************************************************************************
+ * Name: tre_dfa_run
+ *
+ * Description:
+ *   Tell whether the regex matches anywhere in string.  REG_ESPACE is
+ *   returned, and the caller falls back to the NFA matchers, if the cache
+ *   cannot be allocated or is in use by another thread.
+ *
+ ****************************************************************************/
+
+reg_errcode_t tre_dfa_run(tre_dfa_t *dfa, const char *string, int eflags)
+{
+  const unsigned char *s   = (const unsigned char *)string;
+  int                 bol  = !(eflags & REG_NOTBOL);
+  reg_errcode_t       ret  = REG_NOMATCH;
+  wchar_t             wc;
+  int                 next;
+  int                 idx;
+  int                 n;
+
+  if (tre_dfa_isfinal(dfa, dfa->start[bol]))
+    {
+      return REG_OK;
+    }
+
+  if (nxmutex_trylock(&dfa->lock) < 0)
+    {
+      return REG_ESPACE;
+    }
+
+  if (dfa->cache == NULL)
+    {
+      dfa->cache = xmalloc(dfa->maxstates *
+                           (dfa->stride + sizeof(uint32_t)));
+      if (dfa->cache == NULL)
+        {
+          nxmutex_unlock(&dfa->lock);
+          return REG_ESPACE;
+        }
+    }
+
+  idx = dfa->startidx[bol];
+  if (idx < 0)
+    {
+      idx = tre_dfa_lookup(dfa, dfa->start[bol]);
+      dfa->startidx[bol] = idx;
+    }
+
+  while (*s != '\0')
+    {
+      if (*s < TRE_DFA_NCHARS)
+        {
+          n    = dfa->classmap[*s];
+          next = tre_dfa_next(dfa, idx)[n];
+          if (next == TRE_DFA_UNKNOWN)
+            {
+              next = tre_dfa_step(dfa, idx, *s, n);
+            }
+
+          s++;
+        }
+      else
+        {
+          n = mbtowc(&wc, (const char *)s, MB_LEN_MAX);
+          if (n <= 0)
+            {
+              break;
+            }
+
+          next = tre_dfa_step(dfa, idx, wc, -1);
+          s += n;
+        }
+
+      if (next == TRE_DFA_MATCH)
+        {
+          ret = REG_OK;
+          break;
+        }
+      else if (next == TRE_DFA_DEAD)
+        {
+          break;
+        }
+
+      idx = next;
+    }
+
+  nxmutex_unlock(&dfa->lock);
+  return ret;
+}
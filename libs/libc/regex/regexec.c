@@ -1225,6 +1225,19 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
       nmatch = 0;
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  /* Without submatches only success matters, let the DFA answer it. */
+
+  if (tnfa->dfa != NULL && nmatch == 0)
+    {
+      status = tre_dfa_run(tnfa->dfa, string, eflags);
+      if (status != REG_ESPACE)
+        {
+          return status;
+        }
+    }
+#endif
+
   if (tnfa->num_tags > 0 && nmatch > 0)
     {
       tags = xmalloc(sizeof(*tags) * tnfa->num_tags);
@@ -36,6 +36,8 @@
 #ifndef _REGEX_TRE_H
 #define _REGEX_TRE_H
 
+#include <nuttx/config.h>
+
 #include <regex.h>
 #include <wchar.h>
 #include <wctype.h>
@@ -191,6 +193,7 @@ typedef struct tre_submatch_data tre_submatch_data_t;
 /* TNFA definition. */
 
 typedef struct tnfa tre_tnfa_t;
+typedef struct tre_dfa tre_dfa_t;
 
 struct tnfa
 {
@@ -211,8 +214,21 @@ struct tnfa
   int cflags;
   int have_backrefs;
   int have_approx;
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tre_dfa_t *dfa;
+#endif
 };
 
+/* from regdfa.c: the lazy DFA used by regexec() when no submatch is
+ * requested.
+ */
+
+#ifdef CONFIG_LIBC_REGEX_DFA
+tre_dfa_t *tre_dfa_create(const tre_tnfa_t *tnfa);
+void tre_dfa_free(tre_dfa_t *dfa);
+reg_errcode_t tre_dfa_run(tre_dfa_t *dfa, const char *string, int eflags);
+#endif
+
 /* from tre-mem.h: */
 
 #define TRE_MEM_BLOCK_SIZE  1024
@@ -28,9 +28,15 @@
 
 #include <time.h>
 #include <errno.h>
+#include <assert.h>
+#include <sched.h>
 
+#include <nuttx/sched.h>
+#include <nuttx/init.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/atomic.h>
+#include <nuttx/irq.h>
 
 /****************************************************************************
  * Public Functions
@@ -104,3 +110,120 @@ int sem_clockwait(FAR sem_t *sem, clockid_t clockid,
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxsem_clockwait
+ *
+ * Description:
+ *   This function will lock the semaphore referenced by sem as in the
+ *   sem_wait() function. However, if the semaphore cannot be locked without
+ *   waiting for another process or thread to unlock the semaphore by
+ *   performing a sem_post() function, this wait will be terminated when the
+ *   specified timeout expires.
+ *
+ *   An uncontended semaphore is taken here with a single atomic operation;
+ *   only when the semaphore is not available is nxsem_clockwait_slow()
+ *   called to set up the timeout and block.
+ *
+ *   This is an internal OS interface.  It is functionally equivalent to
+ *   sem_wait except that:
+ *
+ *   - It is not a cancellation point, and
+ *   - It does not modify the errno value.
+ *
+ * Input Parameters:
+ *   sem     - Semaphore object
+ *   clockid - The timing source to use in the conversion
+ *   abstime - The absolute time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   This is an internal OS interface and should not be used by applications.
+ *   It follows the NuttX internal error return policy:  Zero (OK) is
+ *   returned on success.  A negated errno value is returned on failure.
+ *   That may be one of:
+ *
+ *   EINVAL    The sem argument does not refer to a valid semaphore.  Or the
+ *             thread would have blocked, and the abstime parameter specified
+ *             a nanoseconds field value less than zero or greater than or
+ *             equal to 1000 million.
+ *   ETIMEDOUT The semaphore could not be locked before the specified timeout
+ *             expired.
+ *   EDEADLK   A deadlock condition was detected.
+ *   EINTR     A signal interrupted this function.
+ *   ECANCELED May be returned if the thread is canceled while waiting.
+ *
+ ****************************************************************************/
+
+int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
+                    FAR const struct timespec *abstime)
+{
+  bool fastpath = true;
+  bool mutex;
+
+  DEBUGASSERT(sem != NULL && abstime != NULL);
+
+  /* This API should not be called from the idleloop or interrupt */
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask() ||
+              up_interrupt_context());
+#endif
+
+  mutex = NXSEM_IS_MUTEX(sem);
+
+  /* Disable fast path if priority protection is enabled on the semaphore */
+
+#ifdef CONFIG_PRIORITY_PROTECT
+  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_PROTECT)
+    {
+      fastpath = false;
+    }
+#endif
+
+  /* Disable fast path on a counting semaphore with priority inheritance */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (!mutex && (sem->flags & SEM_PRIO_MASK) != SEM_PRIO_NONE)
+    {
+      fastpath = false;
+    }
+#endif
+
+  /* POSIX does not require abstime to be validated if the semaphore can
+   * be locked immediately, so the attempt is made before the timeout is
+   * ever looked at.
+   */
+
+  while (fastpath)
+    {
+      FAR atomic_t *val = mutex ? NXSEM_MHOLDER(sem) : NXSEM_COUNT(sem);
+      int32_t old = atomic_read(val);
+      int32_t new;
+
+      if (mutex)
+        {
+          if (old != NXSEM_NO_MHOLDER)
+            {
+              break;
+            }
+
+          new = _SCHED_GETTID();
+        }
+      else
+        {
+          if (old < 1)
+            {
+              break;
+            }
+
+          new = old - 1;
+        }
+
+      if (atomic_try_cmpxchg_acquire(val, &old, new))
+        {
+          return OK;
+        }
+    }
+
+  return nxsem_clockwait_slow(sem, clockid, abstime);
+}
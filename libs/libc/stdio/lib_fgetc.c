@@ -40,6 +40,19 @@ int fgetc_unlocked(FAR FILE *stream)
   unsigned char ch;
   ssize_t ret;
 
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Take the next byte straight from the read buffer if there is one */
+
+  if (stream != NULL && stream->fs_bufpos < stream->fs_bufread
+#  if CONFIG_NUNGET_CHARS > 0
+      && stream->fs_nungotten == 0
+#  endif
+     )
+    {
+      return (unsigned char)*stream->fs_bufpos++;
+    }
+#endif
+
   ret = lib_fread_unlocked(&ch, 1, stream);
   if (ret > 0)
     {
@@ -55,9 +68,9 @@ int fgetc(FAR FILE *stream)
 {
   int ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = fgetc_unlocked(stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
@@ -67,9 +67,9 @@ FAR char *fgets(FAR char *buf, int buflen, FAR FILE *stream)
 {
   FAR char *ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = fgets_unlocked(buf, buflen, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
@@ -33,6 +33,8 @@
 #include <errno.h>
 #include <string.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_FILE_STREAM
 
 /****************************************************************************
@@ -114,9 +116,9 @@ wint_t fgetwc_unlocked(FAR FILE *f)
 wint_t fgetwc(FAR FILE *f)
 {
   wint_t c;
-  flockfile(f);
+  lib_flockfile(f);
   c = fgetwc_unlocked(f);
-  funlockfile(f);
+  lib_funlockfile(f);
   return c;
 }
 
@@ -24,6 +24,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <fcntl.h>
 #include <stdio.h>
 #include "libc.h"
 
@@ -40,6 +41,21 @@ int fputc_unlocked(int c, FAR FILE *stream)
   unsigned char buf = (unsigned char)c;
   int ret;
 
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Append to a write buffer that has room, a full buffer, a newline and
+   * everything else go through lib_fwrite_unlocked().
+   */
+
+  if (stream != NULL && buf != '\n' &&
+      (stream->fs_oflags & O_WROK) != 0 &&
+      stream->fs_bufread == stream->fs_bufstart &&
+      stream->fs_bufpos != NULL && stream->fs_bufpos + 1 < stream->fs_bufend)
+    {
+      *stream->fs_bufpos++ = buf;
+      return buf;
+    }
+#endif
+
   ret = lib_fwrite_unlocked(&buf, 1, stream);
   if (ret > 0)
     {
@@ -66,9 +82,9 @@ int fputc(int c, FAR FILE *stream)
 {
   int ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = fputc_unlocked(c, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
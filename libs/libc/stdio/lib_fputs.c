@@ -149,9 +149,9 @@ int fputs(FAR const IPTR char *s, FAR FILE *stream)
 {
   int ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = fputs_unlocked(s, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
@@ -66,7 +66,7 @@ int fputws_unlocked(FAR const wchar_t *ws, FAR FILE *f)
     {
       if (lib_fwrite_unlocked(buf, l, f) < l)
         {
-          funlockfile(f);
+          lib_funlockfile(f);
           return -1;
         }
     }
@@ -93,9 +93,9 @@ int fputws_unlocked(FAR const wchar_t *ws, FAR FILE *f)
 int fputws(FAR const wchar_t *ws, FAR FILE *f)
 {
   int l;
-  flockfile(f);
+  lib_flockfile(f);
   l = fputws_unlocked(ws, f);
-  funlockfile(f);
+  lib_funlockfile(f);
   return l;
 }
 
@@ -63,9 +63,9 @@ size_t fread(FAR void *ptr, size_t size, size_t n_items, FAR FILE *stream)
 {
   size_t ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = fread_unlocked(ptr, size, n_items, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
@@ -103,7 +103,7 @@ FAR FILE *freopen(FAR const char *path, FAR const char *mode,
 
       /* Make sure that we have exclusive access to the stream */
 
-      flockfile(stream);
+      lib_flockfile(stream);
 
       /* Flush the stream and invalidate the read buffer. */
 
@@ -113,7 +113,7 @@ FAR FILE *freopen(FAR const char *path, FAR const char *mode,
       lib_rdflush_unlocked(stream);
 #endif
 
-      funlockfile(stream);
+      lib_funlockfile(stream);
 
       /* close the old fd */
 
@@ -133,9 +133,9 @@ FAR FILE *freopen(FAR const char *path, FAR const char *mode,
           android_fdsan_create_owner_tag(ANDROID_FDSAN_OWNER_TYPE_FILE,
                                         (uintptr_t)stream));
 #endif
-      flockfile(stream);
+      lib_flockfile(stream);
       stream->fs_cookie = (FAR void *)(intptr_t)fd;
-      funlockfile(stream);
+      lib_funlockfile(stream);
 
       /* To clear the stale fd */
 
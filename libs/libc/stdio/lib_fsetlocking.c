@@ -0,0 +1,70 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_fsetlocking.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio_ext.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __fsetlocking
+ *
+ * Description:
+ *   Select who locks the stream.  With FSETLOCKING_BYCALLER the stdio
+ *   functions no longer lock it on every call, the caller uses flockfile()
+ *   if the stream is shared between threads.  FSETLOCKING_INTERNAL
+ *   restores the default.
+ *
+ * Input Parameters:
+ *   stream - The stream
+ *   type   - FSETLOCKING_INTERNAL, FSETLOCKING_BYCALLER or
+ *            FSETLOCKING_QUERY to leave the locking type unchanged
+ *
+ * Returned Value:
+ *   The locking type before the call, FSETLOCKING_INTERNAL or
+ *   FSETLOCKING_BYCALLER.
+ *
+ ****************************************************************************/
+
+int __fsetlocking(FAR FILE *stream, int type)
+{
+  int prev = (stream->fs_flags & __FS_FLAG_NOLK) != 0 ?
+             FSETLOCKING_BYCALLER : FSETLOCKING_INTERNAL;
+
+  if (type == FSETLOCKING_BYCALLER)
+    {
+      stream->fs_flags |= __FS_FLAG_NOLK;
+    }
+  else if (type == FSETLOCKING_INTERNAL)
+    {
+      stream->fs_flags &= ~__FS_FLAG_NOLK;
+    }
+
+  return prev;
+}
@@ -26,6 +26,8 @@
 
 #include <stdio.h>
 
+#undef getc_unlocked
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -175,8 +175,8 @@ ssize_t lib_fflush(FAR FILE *stream)
 
   /* Make sure that we have exclusive access to the stream */
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = lib_fflush_unlocked(stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
   return ret;
 }
@@ -211,9 +211,9 @@ FAR char *lib_fgets(FAR char *buf, size_t buflen, FILE *stream,
 {
   FAR char *ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = lib_fgets_unlocked(buf, buflen, stream, keepnl, consume);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
@@ -35,6 +35,8 @@
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,3 +67,33 @@ void funlockfile(FAR struct file_struct *stream)
 {
   nxrmutex_unlock(&stream->fs_lock);
 }
+
+/****************************************************************************
+ * Name: lib_flockfile
+ *
+ * Description:
+ *   The lock taken by the stdio functions themselves.  It is skipped once
+ *   __fsetlocking(FSETLOCKING_BYCALLER) made the caller responsible for
+ *   the locking, flockfile() still locks such a stream.
+ *
+ ****************************************************************************/
+
+void lib_flockfile(FAR struct file_struct *stream)
+{
+  if ((stream->fs_flags & __FS_FLAG_NOLK) == 0)
+    {
+      nxrmutex_lock(&stream->fs_lock);
+    }
+}
+
+/****************************************************************************
+ * Name: lib_funlockfile
+ ****************************************************************************/
+
+void lib_funlockfile(FAR struct file_struct *stream)
+{
+  if ((stream->fs_flags & __FS_FLAG_NOLK) == 0)
+    {
+      nxrmutex_unlock(&stream->fs_lock);
+    }
+}
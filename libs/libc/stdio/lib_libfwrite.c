@@ -53,6 +53,7 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
   FAR const char *src   = ptr;
   ssize_t ret = ERROR;
   size_t gulp_size;
+  size_t bufsize;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -102,10 +103,13 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
       goto errout;
     }
 
-  /* Determine the number of bytes left in the buffer */
+  /* Determine the number of bytes left in the buffer, the size may have
+   * been changed by setvbuf().
+   */
 
+  bufsize   = stream->fs_bufend - stream->fs_bufstart;
   gulp_size = stream->fs_bufend - stream->fs_bufpos;
-  if (gulp_size != CONFIG_STDIO_BUFFER_SIZE || count < gulp_size)
+  if (gulp_size != bufsize || count < gulp_size)
     {
       if (gulp_size > count)
         {
@@ -140,7 +144,7 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
         }
     }
 
-  if (count >= CONFIG_STDIO_BUFFER_SIZE)
+  if (count >= bufsize)
     {
       if (stream->fs_iofunc.write != NULL)
         {
@@ -205,9 +209,9 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 {
   ssize_t ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = lib_fwrite_unlocked(ptr, count, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
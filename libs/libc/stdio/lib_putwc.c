@@ -32,6 +32,8 @@
 #include <wchar.h>
 #include <stdio.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_FILE_STREAM
 
 /****************************************************************************
@@ -78,9 +80,9 @@ wint_t putwc_unlocked(wchar_t c, FAR FILE *f)
 wint_t putwc(wchar_t c, FAR FILE *f)
 {
   wint_t wc;
-  flockfile(f);
+  lib_flockfile(f);
   wc = putwc_unlocked(c, f);
-  funlockfile(f);
+  lib_funlockfile(f);
   return wc;
 }
 
@@ -48,8 +48,8 @@ void rewind(FAR FILE *stream)
       return;
     }
 
-  flockfile(stream);
+  lib_flockfile(stream);
   fseek(stream, 0L, SEEK_SET);
   stream->fs_flags &= ~__FS_FLAG_ERROR;
-  funlockfile(stream);
+  lib_funlockfile(stream);
 }
@@ -26,6 +26,8 @@
 
 #include <nuttx/streams.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -46,9 +48,9 @@ int vfprintf(FAR FILE *stream, FAR const IPTR char *fmt, va_list ap)
    * before being preempted by the next thread.
    */
 
-  flockfile(stream);
+  lib_flockfile(stream);
   n = lib_vsprintf(&stdoutstream.common, fmt, ap);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return n;
 }
@@ -26,6 +26,8 @@
 
 #include <nuttx/streams.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -51,7 +53,7 @@ int vfscanf(FAR FILE *stream, FAR const IPTR char *fmt, va_list ap)
        * by the next thread.
        */
 
-      flockfile(stream);
+      lib_flockfile(stream);
 
       n = lib_vscanf(&stdinstream.common, &lastc, fmt, ap);
 
@@ -64,7 +66,7 @@ int vfscanf(FAR FILE *stream, FAR const IPTR char *fmt, va_list ap)
           ungetc(lastc, stream);
         }
 
-      funlockfile(stream);
+      lib_funlockfile(stream);
     }
 
   return n;
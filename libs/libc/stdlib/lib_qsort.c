@@ -43,6 +43,7 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
 #include <stdlib.h>
 
 /****************************************************************************
@@ -79,14 +80,23 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+/* Below this many elements a partition is sorted by insertion */
+
+#define INSERTION_CUTOFF  7
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE int (*compar_t)(FAR const void *, FAR const void *);
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+                             compar_t compar);
 
 /****************************************************************************
  * Private Functions
@@ -105,59 +115,96 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
 }
 
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+                             compar_t compar)
 {
   return compar(a, b) < 0 ?
          (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
          (compar(b, c) > 0 ? b : (compar(a, c) < 0 ? a : c));
 }
 
-/****************************************************************************
- * Public Function
- ****************************************************************************/
+/* Insertion sort of nel elements.  With a non-zero limit, give up and
+ * return false once more than limit elements have been moved, the array
+ * is then only partially sorted.
+ */
 
-/****************************************************************************
- * Name: qsort
- *
- * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
- *
- * Returned Value:
- *   The qsort() function will not return a value.
- *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
- *
- ****************************************************************************/
+static bool insertion_sort(FAR char *base, size_t nel, size_t width,
+                           int swaptype, compar_t compar, size_t limit)
+{
+  FAR char *pl;
+  FAR char *pm;
+  size_t moves = 0;
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+  for (pm = base + width; pm < base + nel * width; pm += width)
+    {
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          swap(pl, pl - width);
+        }
+
+      if (limit > 0 && pl != pm)
+        {
+          moves += (pm - pl) / width;
+          if (moves > limit)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+static void sift_down(FAR char *base, size_t root, size_t nel, size_t width,
+                      int swaptype, compar_t compar)
+{
+  size_t child;
+
+  while ((child = 2 * root + 1) < nel)
+    {
+      if (child + 1 < nel &&
+          compar(base + child * width, base + (child + 1) * width) < 0)
+        {
+          child++;
+        }
+
+      if (compar(base + root * width, base + child * width) >= 0)
+        {
+          break;
+        }
+
+      swap(base + root * width, base + child * width);
+      root = child;
+    }
+}
+
+/* The fallback once the partitioning goes too deep, O(n log n) whatever
+ * the input.
+ */
+
+static void heap_sort(FAR char *base, size_t nel, size_t width,
+                      int swaptype, compar_t compar)
+{
+  size_t i;
+
+  for (i = nel / 2; i-- > 0; )
+    {
+      sift_down(base, i, nel, width, swaptype, compar);
+    }
+
+  for (i = nel - 1; i > 0; i--)
+    {
+      swap(base, base + i * width);
+      sift_down(base, 0, i, width, swaptype, compar);
+    }
+}
+
+/* Bentley & McIlroy quicksort with introsort depth limiting.  The smaller
+ * partition is sorted by recursion and the larger one by iteration, so the
+ * stack use is O(log n) and no memory is allocated.
+ */
+
+static void introsort(FAR char *base, size_t nel, size_t width,
+                      compar_t compar, int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -166,37 +213,35 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
+  size_t left;
+  size_t right;
   int swaptype;
   int swap_cnt;
-  int d;
-  int r;
+  size_t d;
+  size_t r;
+  int cmp;
 
 loop:
   SWAPINIT(base, width);
   swap_cnt = 0;
 
-  if (nel < 7)
+  if (nel < INSERTION_CUTOFF)
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
-        {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
-        }
+      insertion_sort(base, nel, width, swaptype, compar, 0);
+      return;
+    }
 
+  if (depth-- <= 0)
+    {
+      heap_sort(base, nel, width, swaptype, compar);
       return;
     }
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
+  pm = base + (nel / 2) * width;
+  if (nel > INSERTION_CUTOFF)
     {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
+      pn = base + (nel - 1) * width;
       if (nel > 40)
         {
           d  = (nel / 8) * width;
@@ -209,14 +254,14 @@ loop:
     }
 
   swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+  pa = pb = base + width;
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
+  pc = pd = base + (nel - 1) * width;
   for (; ; )
     {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      while (pb <= pc && (cmp = compar(pb, base)) <= 0)
         {
-          if (r == 0)
+          if (cmp == 0)
             {
               swap_cnt = 1;
               swap(pa, pb);
@@ -226,9 +271,9 @@ loop:
           pb += width;
         }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
+      while (pb <= pc && (cmp = compar(pc, base)) >= 0)
         {
-          if (r == 0)
+          if (cmp == 0)
             {
               swap_cnt = 1;
               swap(pc, pd);
@@ -249,43 +294,111 @@ loop:
       pc      -= width;
     }
 
-  if (swap_cnt == 0)
+  pn = base + nel * width;
+  r  = MIN(pa - base, pb - pa);
+  vecswap(base, pb - r, r);
+
+  r  = MIN(pd - pc, pn - pd - width);
+  vecswap(pb, pn - r, r);
+
+  left  = (pb - pa) / width;
+  right = (pd - pc) / width;
+
+  /* Nothing moved, the input is likely already sorted.  Try to finish
+   * both sides by insertion, but give up after as many moves as there are
+   * elements so that an adversarial input cannot make it O(n^2).
+   */
+
+  if (swap_cnt == 0 &&
+      insertion_sort(base, left, width, swaptype, compar, left) &&
+      insertion_sort(pn - right * width, right, width, swaptype, compar,
+                     right))
     {
-      /* Switch to insertion sort */
+      return;
+    }
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+  if (left < right)
+    {
+      if (left > 1)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          introsort(base, left, width, compar, depth);
         }
 
-      return;
+      base = pn - right * width;
+      nel  = right;
     }
+  else
+    {
+      if (right > 1)
+        {
+          introsort(pn - right * width, right, width, compar, depth);
+        }
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
-
-  r  = MIN(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+      nel = left;
+    }
 
-  if ((r = pb - pa) > width)
+  if (nel > 1)
     {
-      qsort(base, r / width, width, compar);
+      goto loop;
     }
+}
 
-  if ((r = pd - pc) > width)
-    {
-      /* Iterate rather than recurse to save stack space */
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *
+ *   The partitioning depth is limited to 2 * log2(nel) before falling back
+ *   to heapsort, so the worst case is O(n log n).  No memory is allocated.
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  int depth = 0;
+  size_t n;
+
+  for (n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
     }
+
+  introsort(base, nel, width, compar, depth);
 }
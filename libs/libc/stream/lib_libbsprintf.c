@@ -189,6 +189,12 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
           ret += lib_sprintf(s, fmtstr, var->p);
           infmt = false;
         }
+      else if (c == '%' && len == 2)
+        {
+          lib_stream_putc(s, c);
+          ret++;
+          infmt = false;
+        }
       else if (c == '.')
         {
           prec = fmt;
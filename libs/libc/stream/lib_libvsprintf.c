@@ -65,9 +65,42 @@
 #  undef CONFIG_LIBC_LONG_LONG
 #endif
 
-#define stream_putc(c,stream)  (total_len++, lib_stream_putc(stream, c))
-#define stream_puts(buf, len, stream) \
+/* With CONFIG_LIBC_PRINTF_BUFSIZE the output is collected in a chunk on
+ * the stack and handed to the stream in blocks, rather than by one
+ * indirect putc() call per character.  The chunk must be flushed before
+ * anything else writes to the stream.
+ */
+
+#if CONFIG_LIBC_PRINTF_BUFSIZE > 0
+#  define stream_putc(c, stream) \
+     do \
+       { \
+         if (nchunk == CONFIG_LIBC_PRINTF_BUFSIZE) \
+           { \
+             stream_flush(stream); \
+           } \
+         chunk[nchunk++] = (c); \
+         total_len++; \
+       } \
+     while (0)
+#  define stream_puts(buf, len, stream) \
+     (total_len += len, vsprintf_puts(stream, chunk, &nchunk, buf, len))
+#  define stream_flush(stream) \
+     do \
+       { \
+         if (nchunk > 0) \
+           { \
+             lib_stream_puts(stream, chunk, nchunk); \
+             nchunk = 0; \
+           } \
+       } \
+     while (0)
+#else
+#  define stream_putc(c,stream)  (total_len++, lib_stream_putc(stream, c))
+#  define stream_puts(buf, len, stream) \
         (total_len += len, lib_stream_puts(stream, buf, len))
+#  define stream_flush(stream)
+#endif
 
 /* Order is relevant here and matches order in format string */
 
@@ -155,6 +188,31 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
  * Private Functions
  ****************************************************************************/
 
+#if CONFIG_LIBC_PRINTF_BUFSIZE > 0
+static void vsprintf_puts(FAR struct lib_outstream_s *stream,
+                          FAR char *chunk, FAR size_t *nchunk,
+                          FAR const char *buf, size_t len)
+{
+  if (*nchunk + len > CONFIG_LIBC_PRINTF_BUFSIZE)
+    {
+      if (*nchunk > 0)
+        {
+          lib_stream_puts(stream, chunk, *nchunk);
+          *nchunk = 0;
+        }
+
+      if (len >= CONFIG_LIBC_PRINTF_BUFSIZE)
+        {
+          lib_stream_puts(stream, buf, len);
+          return;
+        }
+    }
+
+  memcpy(chunk + *nchunk, buf, len);
+  *nchunk += len;
+}
+#endif
+
 static int vsprintf_internal(FAR struct lib_outstream_s *stream,
                              FAR struct arg_s *arglist, int numargs,
                              FAR const IPTR char *fmt, va_list ap)
@@ -182,6 +240,10 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
   size_t size;
   unsigned char len;
   int total_len = 0;
+#if CONFIG_LIBC_PRINTF_BUFSIZE > 0
+  char chunk[CONFIG_LIBC_PRINTF_BUFSIZE];
+  size_t nchunk = 0;
+#endif
 
 #ifdef CONFIG_LIBC_NUMBERED_ARGS
   int argnumber = 0;
@@ -1127,6 +1189,7 @@ str_lpad:
                     {
                       FAR struct va_format *vaf = (FAR void *)(uintptr_t)x;
 
+                      stream_flush(stream);
                       lib_bsprintf(stream, vaf->fmt, vaf->va);
                       continue;
                     }
@@ -1138,9 +1201,11 @@ str_lpad:
                       va_list copy;
 
                       va_copy(copy, *vaf->va);
+                      stream_flush(stream);
                       lib_vsprintf(stream, vaf->fmt, copy);
                       va_end(copy);
 #  else
+                      stream_flush(stream);
                       lib_vsprintf(stream, vaf->fmt, *vaf->va);
 #  endif
                       continue;
@@ -1165,6 +1230,7 @@ str_lpad:
 
                           if (c == 'S')
                             {
+                              stream_flush(stream);
                               total_len +=
                               lib_sprintf_internal(stream,
                                                    "+%#tx/%#zx",
@@ -1330,6 +1396,7 @@ tail:
     }
 
 ret:
+  stream_flush(stream);
   return total_len;
 }
 
@@ -39,6 +39,38 @@
 
 #include "lib_ultoa_invert.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The two digit strings of 00 .. 99, 100 is the common decimal case and
+ * a division by the constant 100 compiles into a multiplication.
+ */
+
+static const char g_digit_pairs[200] =
+{
+  '0', '0', '0', '1', '0', '2', '0', '3', '0', '4',
+  '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+  '1', '0', '1', '1', '1', '2', '1', '3', '1', '4',
+  '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+  '2', '0', '2', '1', '2', '2', '2', '3', '2', '4',
+  '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+  '3', '0', '3', '1', '3', '2', '3', '3', '3', '4',
+  '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+  '4', '0', '4', '1', '4', '2', '4', '3', '4', '4',
+  '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+  '5', '0', '5', '1', '5', '2', '5', '3', '5', '4',
+  '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+  '6', '0', '6', '1', '6', '2', '6', '3', '6', '4',
+  '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+  '7', '0', '7', '1', '7', '2', '7', '3', '7', '4',
+  '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+  '8', '0', '8', '1', '8', '2', '8', '3', '8', '4',
+  '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+  '9', '0', '9', '1', '9', '2', '9', '3', '9', '4',
+  '9', '5', '9', '6', '9', '7', '9', '8', '9', '9'
+};
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,14 +81,58 @@ FAR char *__ultoa_invert(unsigned long long val, FAR char *str, int base)
 FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
 #endif
 {
+  FAR const char *digits = "0123456789abcdef";
   int upper = 0;
+  int shift;
 
   if (base & XTOA_UPPER)
     {
+      digits = "0123456789ABCDEF";
       upper = 1;
       base &= ~XTOA_UPPER;
     }
 
+  /* The digits are produced least significant first */
+
+  if (base == 10)
+    {
+      while (val >= 100)
+        {
+          int v = val % 100;
+
+          val /= 100;
+          *str++ = g_digit_pairs[2 * v + 1];
+          *str++ = g_digit_pairs[2 * v];
+        }
+
+      if (val >= 10)
+        {
+          *str++ = g_digit_pairs[2 * val + 1];
+          *str++ = g_digit_pairs[2 * val];
+        }
+      else
+        {
+          *str++ = '0' + val;
+        }
+
+      return str;
+    }
+
+  /* Power of two bases are shifts and masks, not divisions */
+
+  shift = base == 16 ? 4 : base == 8 ? 3 : base == 2 ? 1 : 0;
+  if (shift != 0)
+    {
+      do
+        {
+          *str++ = digits[val & (base - 1)];
+          val >>= shift;
+        }
+      while (val);
+
+      return str;
+    }
+
   do
     {
       int v;
@@ -70,10 +146,7 @@ FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
         }
       else
         {
-          if (upper)
-            v += 'A' - 10;
-          else
-            v += 'a' - 10;
+          v += upper ? 'A' - 10 : 'a' - 10;
         }
 
       *str++ = v;
@@ -0,0 +1,93 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/clock_vdso.h>
+
+/* The kernel keeps its own clock_gettime(); only the user space copy of the
+ * C library reads the snapshot.
+ */
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct clock_vdso_s *g_clock_vdso;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Get the current value of the specified clock.  CLOCK_MONOTONIC,
+ *   CLOCK_BOOTTIME and CLOCK_REALTIME are computed from the timekeeping
+ *   snapshot published by the kernel; all other clocks fall back to the
+ *   nxclock_gettime() system call.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR const struct clock_vdso_s *vdso = g_clock_vdso;
+  int ret = -EINVAL;
+
+  /* Look up the snapshot once.  Racing threads store the same value. */
+
+  if (vdso == NULL)
+    {
+      vdso = nxclock_vdso();
+      g_clock_vdso = vdso;
+    }
+
+  if (vdso != NULL && tp != NULL)
+    {
+      ret = clock_vdso_gettime(vdso, clock_id, tp);
+    }
+
+  if (ret < 0)
+    {
+      ret = nxclock_gettime(clock_id, tp);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_VDSO && !__KERNEL__ */
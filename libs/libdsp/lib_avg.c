@@ -54,7 +54,7 @@
 void avg_filter_data_init(FAR struct avg_filter_data_s *data,
                           float prev_avg, float k)
 {
-  LIBDSP_DEBUGASSERT(k > 0.0f)
+  LIBDSP_DEBUGASSERT(k > 0.0f);
 
   data->prev_avg = prev_avg;
   data->k        = k;
@@ -0,0 +1,173 @@
+/****************************************************************************
+ * libs/libdsp/lib_biquad.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: biquad_init
+ *
+ * Description:
+ *   Initialize a biquad section with normalized coefficients (a0 = 1)
+ *   and clear its state.
+ *
+ * Input Parameters:
+ *   bq - (out) pointer to the biquad filter data
+ *   b0 - (in) feed-forward coefficient for x(n)
+ *   b1 - (in) feed-forward coefficient for x(n-1)
+ *   b2 - (in) feed-forward coefficient for x(n-2)
+ *   a1 - (in) feedback coefficient for y(n-1)
+ *   a2 - (in) feedback coefficient for y(n-2)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_init(FAR struct biquad_f32_s *bq, float b0, float b1, float b2,
+                 float a1, float a2)
+{
+  LIBDSP_DEBUGASSERT(bq != NULL);
+
+  bq->b0 = b0;
+  bq->b1 = b1;
+  bq->b2 = b2;
+  bq->a1 = a1;
+  bq->a2 = a2;
+
+  biquad_reset(bq);
+}
+
+/****************************************************************************
+ * Name: biquad_reset
+ *
+ * Description:
+ *   Clear the biquad state.
+ *
+ * Input Parameters:
+ *   bq - (in/out) pointer to the biquad filter data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_reset(FAR struct biquad_f32_s *bq)
+{
+  LIBDSP_DEBUGASSERT(bq != NULL);
+
+  bq->z1 = 0.0f;
+  bq->z2 = 0.0f;
+}
+
+/****************************************************************************
+ * Name: biquad_filter
+ *
+ * Description:
+ *   Filter one sample.
+ *
+ * Input Parameters:
+ *   bq - (in/out) pointer to the biquad filter data
+ *   x  - (in) input sample
+ *
+ * Returned Value:
+ *   Filtered sample.
+ *
+ ****************************************************************************/
+
+float biquad_filter(FAR struct biquad_f32_s *bq, float x)
+{
+  float y;
+
+  LIBDSP_DEBUGASSERT(bq != NULL);
+
+  y      = bq->b0 * x + bq->z1;
+  bq->z1 = bq->b1 * x - bq->a1 * y + bq->z2;
+  bq->z2 = bq->b2 * x - bq->a2 * y;
+
+  return y;
+}
+
+/****************************************************************************
+ * Name: biquad_filter_block
+ *
+ * Description:
+ *   Filter a block of samples.  Coefficients and state are kept in
+ *   registers for the whole block, which is considerably cheaper than
+ *   calling biquad_filter() per sample.  'in' and 'out' may be the same
+ *   buffer.
+ *
+ * Input Parameters:
+ *   bq  - (in/out) pointer to the biquad filter data
+ *   in  - (in) input samples
+ *   out - (out) filtered samples
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_filter_block(FAR struct biquad_f32_s *bq, FAR const float *in,
+                         FAR float *out, size_t n)
+{
+  float b0;
+  float b1;
+  float b2;
+  float a1;
+  float a2;
+  float z1;
+  float z2;
+  float x;
+  float y;
+
+  LIBDSP_DEBUGASSERT(bq != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(out != NULL || n == 0);
+
+  b0 = bq->b0;
+  b1 = bq->b1;
+  b2 = bq->b2;
+  a1 = bq->a1;
+  a2 = bq->a2;
+  z1 = bq->z1;
+  z2 = bq->z2;
+
+  while (n-- > 0)
+    {
+      x  = *in++;
+      y  = b0 * x + z1;
+      z1 = b1 * x - a1 * y + z2;
+      z2 = b2 * x - a2 * y;
+      *out++ = y;
+    }
+
+  bq->z1 = z1;
+  bq->z2 = z2;
+}
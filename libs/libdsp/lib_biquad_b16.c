@@ -0,0 +1,210 @@
+/****************************************************************************
+ * libs/libdsp/lib_biquad_b16.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dspb16.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: biquad_step_b16
+ *
+ * Description:
+ *   Direct form I step.  All five products are summed in one wide
+ *   accumulator (SMULL/SMLAL on ARM) and rounded once.
+ *
+ ****************************************************************************/
+
+static inline b16_t biquad_step_b16(FAR const struct biquad_b16_s *bq,
+                                    b16_t x, b16_t x1, b16_t x2,
+                                    b16_t y1, b16_t y2)
+{
+#ifdef CONFIG_HAVE_LONG_LONG
+  b32_t acc;
+
+  acc  = (b32_t)bq->b0 * x;
+  acc += (b32_t)bq->b1 * x1;
+  acc += (b32_t)bq->b2 * x2;
+  acc -= (b32_t)bq->a1 * y1;
+  acc -= (b32_t)bq->a2 * y2;
+
+  return b32tob16(acc);
+#else
+  return b16mulb16(bq->b0, x) + b16mulb16(bq->b1, x1) +
+         b16mulb16(bq->b2, x2) - b16mulb16(bq->a1, y1) -
+         b16mulb16(bq->a2, y2);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: biquad_init_b16
+ *
+ * Description:
+ *   Initialize a biquad section with normalized coefficients (a0 = 1)
+ *   and clear its state.
+ *
+ * Input Parameters:
+ *   bq - (out) pointer to the biquad filter data
+ *   b0 - (in) feed-forward coefficient for x(n)
+ *   b1 - (in) feed-forward coefficient for x(n-1)
+ *   b2 - (in) feed-forward coefficient for x(n-2)
+ *   a1 - (in) feedback coefficient for y(n-1)
+ *   a2 - (in) feedback coefficient for y(n-2)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_init_b16(FAR struct biquad_b16_s *bq, b16_t b0, b16_t b1,
+                     b16_t b2, b16_t a1, b16_t a2)
+{
+  LIBDSP_DEBUGASSERT(bq != NULL);
+
+  bq->b0 = b0;
+  bq->b1 = b1;
+  bq->b2 = b2;
+  bq->a1 = a1;
+  bq->a2 = a2;
+
+  biquad_reset_b16(bq);
+}
+
+/****************************************************************************
+ * Name: biquad_reset_b16
+ *
+ * Description:
+ *   Clear the biquad state.
+ *
+ * Input Parameters:
+ *   bq - (in/out) pointer to the biquad filter data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_reset_b16(FAR struct biquad_b16_s *bq)
+{
+  LIBDSP_DEBUGASSERT(bq != NULL);
+
+  bq->x1 = 0;
+  bq->x2 = 0;
+  bq->y1 = 0;
+  bq->y2 = 0;
+}
+
+/****************************************************************************
+ * Name: biquad_filter_b16
+ *
+ * Description:
+ *   Filter one sample.
+ *
+ * Input Parameters:
+ *   bq - (in/out) pointer to the biquad filter data
+ *   x  - (in) input sample
+ *
+ * Returned Value:
+ *   Filtered sample.
+ *
+ ****************************************************************************/
+
+b16_t biquad_filter_b16(FAR struct biquad_b16_s *bq, b16_t x)
+{
+  b16_t y;
+
+  LIBDSP_DEBUGASSERT(bq != NULL);
+
+  y = biquad_step_b16(bq, x, bq->x1, bq->x2, bq->y1, bq->y2);
+
+  bq->x2 = bq->x1;
+  bq->x1 = x;
+  bq->y2 = bq->y1;
+  bq->y1 = y;
+
+  return y;
+}
+
+/****************************************************************************
+ * Name: biquad_filter_block_b16
+ *
+ * Description:
+ *   Filter a block of samples, keeping the state in registers for the
+ *   whole block.  'in' and 'out' may be the same buffer.
+ *
+ * Input Parameters:
+ *   bq  - (in/out) pointer to the biquad filter data
+ *   in  - (in) input samples
+ *   out - (out) filtered samples
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_filter_block_b16(FAR struct biquad_b16_s *bq,
+                             FAR const b16_t *in, FAR b16_t *out, size_t n)
+{
+  b16_t x1;
+  b16_t x2;
+  b16_t y1;
+  b16_t y2;
+  b16_t x;
+  b16_t y;
+
+  LIBDSP_DEBUGASSERT(bq != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(out != NULL || n == 0);
+
+  x1 = bq->x1;
+  x2 = bq->x2;
+  y1 = bq->y1;
+  y2 = bq->y2;
+
+  while (n-- > 0)
+    {
+      x = *in++;
+      y = biquad_step_b16(bq, x, x1, x2, y1, y2);
+
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+
+      *out++ = y;
+    }
+
+  bq->x1 = x1;
+  bq->x2 = x2;
+  bq->y1 = y1;
+  bq->y2 = y2;
+}
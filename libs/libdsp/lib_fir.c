@@ -0,0 +1,186 @@
+/****************************************************************************
+ * libs/libdsp/lib_fir.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+#include <string.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_push
+ *
+ * Description:
+ *   Store a new sample in the delay line and return a pointer to the
+ *   ntaps most recent samples, newest first, in contiguous memory.
+ *
+ ****************************************************************************/
+
+static inline FAR const float *fir_push(FAR struct fir_f32_s *fir, float x)
+{
+  uint16_t pos = fir->pos == 0 ? fir->ntaps : fir->pos;
+
+  pos--;
+  fir->state[pos]              = x;
+  fir->state[pos + fir->ntaps] = x;
+  fir->pos                     = pos;
+
+  return &fir->state[pos];
+}
+
+/****************************************************************************
+ * Name: fir_dot
+ ****************************************************************************/
+
+static inline float fir_dot(FAR const float *coef, FAR const float *x,
+                            uint16_t ntaps)
+{
+  float acc = 0.0f;
+  uint16_t i;
+
+  /* Plain multiply-accumulate over contiguous arrays: this is the form
+   * compilers turn into FMA / MVE / NEON vector loops.
+   */
+
+  for (i = 0; i < ntaps; i++)
+    {
+      acc += coef[i] * x[i];
+    }
+
+  return acc;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_init
+ *
+ * Description:
+ *   Initialize a FIR filter and clear its delay line.
+ *
+ * Input Parameters:
+ *   fir   - (out) pointer to the FIR filter data
+ *   coef  - (in) ntaps coefficients, coef[0] applies to the newest sample.
+ *           The array is referenced, not copied.
+ *   state - (in) delay line buffer of 2 * ntaps samples
+ *   ntaps - (in) number of taps
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_init(FAR struct fir_f32_s *fir, FAR const float *coef,
+              FAR float *state, uint16_t ntaps)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(coef != NULL);
+  LIBDSP_DEBUGASSERT(state != NULL);
+  LIBDSP_DEBUGASSERT(ntaps > 0);
+
+  fir->coef  = coef;
+  fir->state = state;
+  fir->ntaps = ntaps;
+
+  fir_reset(fir);
+}
+
+/****************************************************************************
+ * Name: fir_reset
+ *
+ * Description:
+ *   Clear the FIR delay line.
+ *
+ * Input Parameters:
+ *   fir - (in/out) pointer to the FIR filter data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_reset(FAR struct fir_f32_s *fir)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+
+  memset(fir->state, 0, 2 * fir->ntaps * sizeof(float));
+  fir->pos = 0;
+}
+
+/****************************************************************************
+ * Name: fir_filter
+ *
+ * Description:
+ *   Filter one sample.
+ *
+ * Input Parameters:
+ *   fir - (in/out) pointer to the FIR filter data
+ *   x   - (in) input sample
+ *
+ * Returned Value:
+ *   Filtered sample.
+ *
+ ****************************************************************************/
+
+float fir_filter(FAR struct fir_f32_s *fir, float x)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+
+  return fir_dot(fir->coef, fir_push(fir, x), fir->ntaps);
+}
+
+/****************************************************************************
+ * Name: fir_filter_block
+ *
+ * Description:
+ *   Filter a block of samples.  'in' and 'out' may be the same buffer.
+ *
+ * Input Parameters:
+ *   fir - (in/out) pointer to the FIR filter data
+ *   in  - (in) input samples
+ *   out - (out) filtered samples
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter_block(FAR struct fir_f32_s *fir, FAR const float *in,
+                      FAR float *out, size_t n)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(out != NULL || n == 0);
+
+  while (n-- > 0)
+    {
+      *out++ = fir_dot(fir->coef, fir_push(fir, *in++), fir->ntaps);
+    }
+}
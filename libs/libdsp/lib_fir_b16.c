@@ -0,0 +1,199 @@
+/****************************************************************************
+ * libs/libdsp/lib_fir_b16.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dspb16.h>
+#include <string.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_push_b16
+ *
+ * Description:
+ *   Store a new sample in the delay line and return a pointer to the
+ *   ntaps most recent samples, newest first, in contiguous memory.
+ *
+ ****************************************************************************/
+
+static inline FAR const b16_t *fir_push_b16(FAR struct fir_b16_s *fir,
+                                            b16_t x)
+{
+  uint16_t pos = fir->pos == 0 ? fir->ntaps : fir->pos;
+
+  pos--;
+  fir->state[pos]              = x;
+  fir->state[pos + fir->ntaps] = x;
+  fir->pos                     = pos;
+
+  return &fir->state[pos];
+}
+
+/****************************************************************************
+ * Name: fir_dot_b16
+ ****************************************************************************/
+
+static inline b16_t fir_dot_b16(FAR const b16_t *coef, FAR const b16_t *x,
+                                uint16_t ntaps)
+{
+#ifdef CONFIG_HAVE_LONG_LONG
+  b32_t acc = 0;
+  uint16_t i;
+
+  /* Accumulate all products at full precision (SMLAL on ARM) and round
+   * once at the end.
+   */
+
+  for (i = 0; i < ntaps; i++)
+    {
+      acc += (b32_t)coef[i] * x[i];
+    }
+
+  return b32tob16(acc);
+#else
+  b16_t acc = 0;
+  uint16_t i;
+
+  for (i = 0; i < ntaps; i++)
+    {
+      acc += b16mulb16(coef[i], x[i]);
+    }
+
+  return acc;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_init_b16
+ *
+ * Description:
+ *   Initialize a FIR filter and clear its delay line.
+ *
+ * Input Parameters:
+ *   fir   - (out) pointer to the FIR filter data
+ *   coef  - (in) ntaps coefficients, coef[0] applies to the newest sample.
+ *           The array is referenced, not copied.
+ *   state - (in) delay line buffer of 2 * ntaps samples
+ *   ntaps - (in) number of taps
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_init_b16(FAR struct fir_b16_s *fir, FAR const b16_t *coef,
+                  FAR b16_t *state, uint16_t ntaps)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(coef != NULL);
+  LIBDSP_DEBUGASSERT(state != NULL);
+  LIBDSP_DEBUGASSERT(ntaps > 0);
+
+  fir->coef  = coef;
+  fir->state = state;
+  fir->ntaps = ntaps;
+
+  fir_reset_b16(fir);
+}
+
+/****************************************************************************
+ * Name: fir_reset_b16
+ *
+ * Description:
+ *   Clear the FIR delay line.
+ *
+ * Input Parameters:
+ *   fir - (in/out) pointer to the FIR filter data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_reset_b16(FAR struct fir_b16_s *fir)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+
+  memset(fir->state, 0, 2 * fir->ntaps * sizeof(b16_t));
+  fir->pos = 0;
+}
+
+/****************************************************************************
+ * Name: fir_filter_b16
+ *
+ * Description:
+ *   Filter one sample.
+ *
+ * Input Parameters:
+ *   fir - (in/out) pointer to the FIR filter data
+ *   x   - (in) input sample
+ *
+ * Returned Value:
+ *   Filtered sample.
+ *
+ ****************************************************************************/
+
+b16_t fir_filter_b16(FAR struct fir_b16_s *fir, b16_t x)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+
+  return fir_dot_b16(fir->coef, fir_push_b16(fir, x), fir->ntaps);
+}
+
+/****************************************************************************
+ * Name: fir_filter_block_b16
+ *
+ * Description:
+ *   Filter a block of samples.  'in' and 'out' may be the same buffer.
+ *
+ * Input Parameters:
+ *   fir - (in/out) pointer to the FIR filter data
+ *   in  - (in) input samples
+ *   out - (out) filtered samples
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter_block_b16(FAR struct fir_b16_s *fir, FAR const b16_t *in,
+                          FAR b16_t *out, size_t n)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(out != NULL || n == 0);
+
+  while (n-- > 0)
+    {
+      *out++ = fir_dot_b16(fir->coef, fir_push_b16(fir, *in++), fir->ntaps);
+    }
+}
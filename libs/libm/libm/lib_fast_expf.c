@@ -0,0 +1,94 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fast_expf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* 2^(j/32), j = 0..31, rounded to nearest */
+
+const float g_libm_exp2f_tbl[32] =
+{
+  1.000000000f, 1.021897197f, 1.044273734f, 1.067140460f,
+  1.090507746f, 1.114386797f, 1.138788581f, 1.163724899f,
+  1.189207077f, 1.215247393f, 1.241857767f, 1.269050956f,
+  1.296839595f, 1.325236678f, 1.354255557f, 1.383909941f,
+  1.414213538f, 1.445180774f, 1.476826191f, 1.509164453f,
+  1.542210817f, 1.575980902f, 1.610490322f, 1.645755529f,
+  1.681792855f, 1.718619347f, 1.756252170f, 1.794709086f,
+  1.834008098f, 1.874167681f, 1.915206552f, 1.957144141f
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float expf(float x)
+{
+  union libm_float_u scale;
+  int32_t k;
+  float m;
+
+  if (x >= LIBM_EXPF_KERNEL_MIN && x <= LIBM_EXPF_KERNEL_MAX)
+    {
+      return libm_expf_kernel(x);
+    }
+
+  if (isnanf(x))
+    {
+      return x + x;
+    }
+
+  if (x > LIBM_EXPF_OVERFLOW)
+    {
+      return HUGE_VALF;
+    }
+
+  if (x < LIBM_EXPF_UNDERFLOW)
+    {
+      return 0.0f;
+    }
+
+  /* Results close to overflow or subnormal: 2^k is not a normal float,
+   * apply it in two steps so that there is a single final rounding.
+   */
+
+  m = libm_expf_mant(x, &k);
+  if (k > 0)
+    {
+      scale.i = (uint32_t)(k - 1 + 127) << 23;
+      return m * 2.0f * scale.f;
+    }
+
+  scale.i = (uint32_t)(k + 100 + 127) << 23;
+  return m * scale.f * 7.88860905e-31f;        /* 2^-100 */
+}
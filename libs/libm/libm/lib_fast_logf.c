@@ -0,0 +1,63 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fast_logf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <float.h>
+#include <math.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float logf(float x)
+{
+  if (x >= FLT_MIN && x <= FLT_MAX)
+    {
+      return libm_logf_kernel(x);
+    }
+
+  if (isnanf(x) || x == INFINITY_F)
+    {
+      return x;
+    }
+
+  if (x == 0.0f)
+    {
+      return -HUGE_VALF;
+    }
+
+  if (x < 0.0f)
+    {
+      return NAN_F;
+    }
+
+  /* Subnormal input: log(x) = log(x * 2^23) - 23 * ln2 */
+
+  return libm_logf_kernel(x * 8388608.0f) - 15.9423847f;
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fast_sincosf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <math.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sincosf_reduce
+ *
+ * Description:
+ *   Bring an argument outside of the kernel range back into it.  Returns
+ *   false if the argument is NaN or infinite.
+ *
+ ****************************************************************************/
+
+static bool sincosf_reduce(FAR float *x)
+{
+  if (isnanf(*x) || isinff(*x))
+    {
+      return false;
+    }
+
+  *x = fmodf(*x, 2 * M_PI_F);
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float sinf(float x)
+{
+  float s;
+  float c;
+
+  if (!(fabsf(x) <= LIBM_SINCOSF_REDUCE_MAX) && !sincosf_reduce(&x))
+    {
+      return x - x;
+    }
+
+  libm_sincosf_kernel(x, &s, &c);
+  return s;
+}
+
+float cosf(float x)
+{
+  float s;
+  float c;
+
+  if (!(fabsf(x) <= LIBM_SINCOSF_REDUCE_MAX) && !sincosf_reduce(&x))
+    {
+      return x - x;
+    }
+
+  libm_sincosf_kernel(x, &s, &c);
+  return c;
+}
+
+void sincosf(float x, FAR float *s, FAR float *c)
+{
+  if (!(fabsf(x) <= LIBM_SINCOSF_REDUCE_MAX) && !sincosf_reduce(&x))
+    {
+      *s = x - x;
+      *c = *s;
+      return;
+    }
+
+  libm_sincosf_kernel(x, s, c);
+}
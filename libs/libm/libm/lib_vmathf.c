@@ -0,0 +1,134 @@
+/****************************************************************************
+ * libs/libm/libm/lib_vmathf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <float.h>
+#include <math.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vsinf, vcosf, vsincosf, vexpf, vlogf
+ *
+ * Description:
+ *   Apply sinf(), cosf(), sincosf(), expf() or logf() to n elements.  The
+ *   result is the same as calling the scalar function on every element;
+ *   in-range elements go through the inlined kernel, the rest through the
+ *   scalar function.  'y' may alias 'x'.
+ *
+ ****************************************************************************/
+
+void vsinf(FAR float *y, FAR const float *x, size_t n)
+{
+  float c;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      if (fabsf(x[i]) <= LIBM_SINCOSF_REDUCE_MAX)
+        {
+          libm_sincosf_kernel(x[i], &y[i], &c);
+        }
+      else
+        {
+          y[i] = sinf(x[i]);
+        }
+    }
+}
+
+void vcosf(FAR float *y, FAR const float *x, size_t n)
+{
+  float s;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      if (fabsf(x[i]) <= LIBM_SINCOSF_REDUCE_MAX)
+        {
+          libm_sincosf_kernel(x[i], &s, &y[i]);
+        }
+      else
+        {
+          y[i] = cosf(x[i]);
+        }
+    }
+}
+
+void vsincosf(FAR float *s, FAR float *c, FAR const float *x, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      if (fabsf(x[i]) <= LIBM_SINCOSF_REDUCE_MAX)
+        {
+          libm_sincosf_kernel(x[i], &s[i], &c[i]);
+        }
+      else
+        {
+          sincosf(x[i], &s[i], &c[i]);
+        }
+    }
+}
+
+void vexpf(FAR float *y, FAR const float *x, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      if (x[i] >= LIBM_EXPF_KERNEL_MIN && x[i] <= LIBM_EXPF_KERNEL_MAX)
+        {
+          y[i] = libm_expf_kernel(x[i]);
+        }
+      else
+        {
+          y[i] = expf(x[i]);
+        }
+    }
+}
+
+void vlogf(FAR float *y, FAR const float *x, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      if (x[i] >= FLT_MIN && x[i] <= FLT_MAX)
+        {
+          y[i] = libm_logf_kernel(x[i]);
+        }
+      else
+        {
+          y[i] = logf(x[i]);
+        }
+    }
+}
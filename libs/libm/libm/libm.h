@@ -29,15 +29,47 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+
+/* Largest |x| for which the sinf/cosf Cody-Waite reduction in
+ * libm_sincosf_kernel() is exact: the first three parts of pi/2 have 11
+ * significant bits, so n * part is exact for n < 2^13.  Larger arguments
+ * are first brought into [-pi, pi) with fmodf() like the reference
+ * implementation does.
+ */
+
+#  define LIBM_SINCOSF_REDUCE_MAX  8192.0f
+
+/* Input range of libm_expf_kernel(): results are normal floats */
+
+#  define LIBM_EXPF_KERNEL_MIN     -87.3f
+#  define LIBM_EXPF_KERNEL_MAX     88.0f
+
+/* Overflow and underflow limits of expf() */
+
+#  define LIBM_EXPF_OVERFLOW       88.7229f
+#  define LIBM_EXPF_UNDERFLOW      -103.972084f
+
+#endif /* CONFIG_LIBM_FLOAT_FAST */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+union libm_float_u
+{
+  float    f;
+  uint32_t i;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -64,6 +96,157 @@ double lib_expi(size_t n);
 
 float lib_sqrtapprox(float x);
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+
+/* Defined in lib_fast_expf.c: 2^(j/32), j = 0..31 */
+
+EXTERN const float g_libm_exp2f_tbl[32];
+
+/****************************************************************************
+ * Name: libm_sincosf_kernel
+ *
+ * Description:
+ *   sin(x) and cos(x) for |x| <= LIBM_SINCOSF_REDUCE_MAX.  x is reduced to
+ *   r in [-pi/4, pi/4] with a four part Cody-Waite split of pi/2, then
+ *   both minimax polynomials (Cephes) are evaluated and the quadrant only
+ *   selects and negates them, which keeps the kernel free of data
+ *   dependent control flow for the vector entry points.
+ *
+ ****************************************************************************/
+
+static inline void libm_sincosf_kernel(float x, FAR float *s, FAR float *c)
+{
+  float    t  = x * 6.36619772e-1f;            /* 2/pi */
+  int32_t  n  = (int32_t)(t + (t >= 0.0f ? 0.5f : -0.5f));
+  float    fn = (float)n;
+  float    r;
+  float    z;
+  float    sp;
+  float    cp;
+  float    tmp;
+
+  r  = x - fn * 1.5703125f;
+  r -= fn * 4.8375129699707031e-4f;
+  r -= fn * 7.5495336204767227e-8f;
+  r -= fn * 2.5633440682570896e-12f;
+  z  = r * r;
+
+  sp = r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f +
+                    z * -1.9515295891e-4f));
+  cp = 1.0f - 0.5f * z + z * z * (4.166664568298827e-2f +
+                    z * (-1.388731625493765e-3f +
+                    z * 2.443315711809948e-5f));
+
+  if ((n & 1) != 0)
+    {
+      tmp = sp;
+      sp  = cp;
+      cp  = tmp;
+    }
+
+  *s = (n & 2) != 0 ? -sp : sp;
+  *c = ((n + 1) & 2) != 0 ? -cp : cp;
+}
+
+/****************************************************************************
+ * Name: libm_expf_mant
+ *
+ * Description:
+ *   exp(x) = 2^k * m with m in [1, 2) approximated as 2^(j/32) * exp(r),
+ *   |r| <= ln2/64: the 2^(j/32) factor comes from a table and exp(r) from
+ *   a degree 4 polynomial.  Valid for any x between LIBM_EXPF_UNDERFLOW
+ *   and LIBM_EXPF_OVERFLOW.
+ *
+ ****************************************************************************/
+
+static inline float libm_expf_mant(float x, FAR int32_t *k)
+{
+  float    t  = x * 46.1662413f;               /* 32/ln2 */
+  int32_t  n  = (int32_t)(t + (t >= 0.0f ? 0.5f : -0.5f));
+  float    fn = (float)n;
+  int32_t  j  = n & 31;
+  float    r;
+  float    p;
+
+  /* ln2/32 split so that fn * hi is exact for any n in range */
+
+  r = x - fn * 2.166748046875e-2f;
+  r = r - fn * -6.63107630e-6f;
+
+  p = 1.0f + r * (1.0f + r * (0.5f + r * (1.66666672e-1f +
+                                     r * 4.16666679e-2f)));
+
+  *k = (n - j) / 32;
+  return g_libm_exp2f_tbl[j] * p;
+}
+
+/****************************************************************************
+ * Name: libm_expf_kernel
+ *
+ * Description:
+ *   exp(x) for LIBM_EXPF_KERNEL_MIN <= x <= LIBM_EXPF_KERNEL_MAX, where
+ *   2^k is a normal float and is built directly in the exponent field.
+ *
+ ****************************************************************************/
+
+static inline float libm_expf_kernel(float x)
+{
+  union libm_float_u scale;
+  int32_t  k;
+  float    m;
+
+  m       = libm_expf_mant(x, &k);
+  scale.i = (uint32_t)(k + 127) << 23;
+  return m * scale.f;
+}
+
+/****************************************************************************
+ * Name: libm_logf_kernel
+ *
+ * Description:
+ *   log(x) for positive, normal, finite x.  x = 2^e * m with m in
+ *   [sqrt(1/2), sqrt(2)), log(m) from the Cephes minimax polynomial in
+ *   f = m - 1, e * ln2 added in two parts.
+ *
+ ****************************************************************************/
+
+static inline float libm_logf_kernel(float x)
+{
+  union libm_float_u u;
+  int32_t  e;
+  float    fe;
+  float    f;
+  float    z;
+  float    y;
+
+  u.f = x;
+  e   = (int32_t)(u.i >> 23) - 127;
+  u.i = (u.i & 0x007fffff) | 0x3f800000;
+
+  if (u.f > 1.41421356f)
+    {
+      u.f *= 0.5f;
+      e++;
+    }
+
+  fe = (float)e;
+  f  = u.f - 1.0f;
+  z  = f * f;
+
+  y = ((((((((7.0376836292e-2f * f - 1.1514610310e-1f) * f +
+             1.1676998740e-1f) * f - 1.2420140846e-1f) * f +
+             1.4249322787e-1f) * f - 1.6668057665e-1f) * f +
+             2.0000714765e-1f) * f - 2.4999993993e-1f) * f +
+             3.3333331174e-1f) * f * z;
+
+  y += fe * -2.12194440e-4f;
+  y -= 0.5f * z;
+
+  return f + y + fe * 0.693359375f;
+}
+
+#endif /* CONFIG_LIBM_FLOAT_FAST */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -50,7 +50,9 @@
 
 FAR void *operator new(std::size_t nbytes)
 {
-  // Perform the allocation
+  // Perform the allocation.  Requests below MM_HEAP_MEMPOOL_THRESHOLD are
+  // served by the heap's multiple mempool, so short-lived small objects do
+  // not fragment the general heap.
 
   FAR void *alloc = lib_malloc(nbytes);
 
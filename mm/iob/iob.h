@@ -30,7 +30,9 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <stddef.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
@@ -51,6 +53,57 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* The data of an external buffer referenced by more than one I/O buffer
+ * must not be moved or modified.
+ */
+
+#ifdef CONFIG_IOB_ALLOC
+#  define IOB_SHARED(p) ((p)->io_ext != NULL && \
+                         atomic_read(&(p)->io_ext->refs) > 1)
+#else
+#  define IOB_SHARED(p) false
+#endif
+
+/* Fix the I/O Buffer size with specified alignment size */
+
+#ifdef CONFIG_IOB_ALLOC
+#  define IOB_ALIGN_SIZE  ALIGN_UP(sizeof(struct iob_s) + CONFIG_IOB_BUFSIZE, \
+                                   IOB_ALIGNMENT)
+#else
+#  define IOB_ALIGN_SIZE  ALIGN_UP(sizeof(struct iob_s), IOB_ALIGNMENT)
+#endif
+
+#define IOB_BUFFER_SIZE   (IOB_ALIGN_SIZE * CONFIG_IOB_NBUFFERS + \
+                           IOB_ALIGNMENT - 1)
+
+/* The pool may grow from the heap by up to IOB_NGROW buffers.  A grown
+ * buffer is laid out like the ones of the pool, starting IOB_GROWN_PAD
+ * bytes into an IOB_GROWN_SIZE bytes allocation so that its payload is
+ * aligned.  It is told apart from the pool by its address.
+ */
+
+#if CONFIG_IOB_NBUFFERS_MAX > CONFIG_IOB_NBUFFERS
+#  define IOB_ELASTIC
+#  define IOB_NGROW       (CONFIG_IOB_NBUFFERS_MAX - CONFIG_IOB_NBUFFERS)
+#  define IOB_NTOTAL      (CONFIG_IOB_NBUFFERS + g_iob_ngrown)
+#  define IOB_GROWN(p)    ((FAR uint8_t *)(p) < g_iob_buffer || \
+                           (FAR uint8_t *)(p) >= g_iob_buffer + \
+                                                 IOB_BUFFER_SIZE)
+#  ifdef CONFIG_IOB_ALLOC
+#    define IOB_GROWN_PAD  0
+#    define IOB_GROWN_SIZE (ALIGN_UP(sizeof(struct iob_s), IOB_ALIGNMENT) + \
+                            CONFIG_IOB_BUFSIZE)
+#  else
+#    define IOB_GROWN_PAD  (ALIGN_UP(offsetof(struct iob_s, io_data), \
+                                     IOB_ALIGNMENT) - \
+                            offsetof(struct iob_s, io_data))
+#    define IOB_GROWN_SIZE (IOB_GROWN_PAD + sizeof(struct iob_s))
+#  endif
+#else
+#  define IOB_NTOTAL      CONFIG_IOB_NBUFFERS
+#  define IOB_GROWN(p)    false
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -81,6 +134,20 @@ extern sem_t g_iob_sem;
 
 extern int16_t g_iob_count;
 
+/* High-watermark of the I/O buffers in use */
+
+extern int16_t g_iob_npeak;
+
+/* The memory of the pre-allocated I/O buffers */
+
+extern uint8_t g_iob_buffer[IOB_BUFFER_SIZE];
+
+#ifdef IOB_ELASTIC
+/* Number of the I/O buffers allocated from the heap */
+
+extern int16_t g_iob_ngrown;
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
 extern sem_t g_throttle_sem;
 
@@ -137,6 +204,18 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_free_batch
+ *
+ * Description:
+ *   Return a list of I/O buffers of the pool, linked through io_flink, to
+ *   the free or the committed list under a single lock.  This function is
+ *   intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_batch(FAR struct iob_s *iob);
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
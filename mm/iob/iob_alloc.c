@@ -32,9 +32,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
-#ifdef CONFIG_IOB_ALLOC
-#  include <nuttx/kmalloc.h>
-#endif
+#include <nuttx/kmalloc.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/mm/iob.h>
 
@@ -44,6 +42,99 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_update_peak
+ *
+ * Description:
+ *   Update the high-watermark of the I/O buffers in use.  The lock must be
+ *   held.
+ *
+ ****************************************************************************/
+
+static void iob_update_peak(void)
+{
+  int16_t nused = IOB_NTOTAL - MAX(g_iob_count, 0);
+
+  if (nused > g_iob_npeak)
+    {
+      g_iob_npeak = nused;
+    }
+}
+
+#ifdef IOB_ELASTIC
+/****************************************************************************
+ * Name: iob_grow
+ *
+ * Description:
+ *   Allocate one more I/O buffer from the heap when the pre-allocated ones
+ *   have run out.  NULL is returned if the pool can't grow any more or if
+ *   called from a context that can't allocate from the heap.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_grow(void)
+{
+  FAR struct iob_s *iob;
+  FAR uint8_t *mem;
+  irqstate_t flags;
+
+  if (up_interrupt_context() || sched_idletask())
+    {
+      return NULL;
+    }
+
+  /* Reserve the buffer before dropping the lock to allocate it.  The
+   * throttle is kept in the pre-allocated buffers, not here, so that the
+   * throttled allocations stop IOB_THROTTLE buffers short of the ceiling.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  if (g_iob_ngrown >= IOB_NGROW)
+    {
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+      return NULL;
+    }
+
+  g_iob_ngrown++;
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  mem = kmm_memalign(IOB_ALIGNMENT, IOB_GROWN_SIZE);
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  if (mem == NULL)
+    {
+      g_iob_ngrown--;
+    }
+  else
+    {
+      iob_update_peak();
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  if (mem == NULL)
+    {
+      return NULL;
+    }
+
+  /* Put the I/O buffer in a known state */
+
+  iob             = (FAR struct iob_s *)(mem + IOB_GROWN_PAD);
+  iob->io_flink   = NULL; /* Not in a chain */
+  iob->io_len     = 0;    /* Length of the data in the entry */
+  iob->io_offset  = 0;    /* Offset to the beginning of data */
+  iob->io_pktlen  = 0;    /* Total length of the packet */
+#ifdef CONFIG_IOB_ALLOC
+  iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+  iob->io_free    = NULL;
+  iob->io_ext     = NULL;
+  iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
+                                            IOB_ALIGNMENT);
+#endif
+  return iob;
+}
+#endif
+
 static clock_t iob_allocwait_gettimeout(clock_t start, unsigned int timeout)
 {
   sclock_t tick;
@@ -128,6 +219,7 @@ static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
 
           g_iob_count--;
           DEBUGASSERT(g_iob_count >= 0);
+          iob_update_peak();
 
           /* Put the I/O buffer in a known state */
 
@@ -178,6 +270,23 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   /* Try to get an I/O buffer */
 
   iob = iob_tryalloc_internal(throttled);
+#ifdef IOB_ELASTIC
+  if (iob == NULL)
+    {
+      /* Grow the pool from the heap before resorting to wait */
+
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+      iob = iob_grow();
+      if (iob != NULL)
+        {
+          return iob;
+        }
+
+      flags = spin_lock_irqsave(&g_iob_lock);
+      iob = iob_tryalloc_internal(throttled);
+    }
+#endif
+
   if (iob == NULL)
     {
 #if CONFIG_IOB_THROTTLE > 0
@@ -268,9 +377,17 @@ FAR struct iob_s *iob_timedalloc(bool throttled, unsigned int timeout)
     }
   else
     {
+      FAR struct iob_s *iob;
+
       /* Then allocate an I/O buffer, waiting as necessary */
 
-      return iob_allocwait(throttled, timeout);
+      iob = iob_allocwait(throttled, timeout);
+      if (iob != NULL)
+        {
+          iob_notify_pressure(iob_navail(false));
+        }
+
+      return iob;
     }
 }
 
@@ -308,9 +425,82 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   flags = spin_lock_irqsave(&g_iob_lock);
   iob = iob_tryalloc_internal(throttled);
   spin_unlock_irqrestore(&g_iob_lock, flags);
+
+#ifdef IOB_ELASTIC
+  if (iob == NULL)
+    {
+      iob = iob_grow();
+    }
+#endif
+
+  if (iob != NULL)
+    {
+      iob_notify_pressure(iob_navail(false));
+    }
+
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate 'count' I/O buffers at once, linked together through
+ *   io_flink, without waiting for buffers to become free.  Either all of
+ *   the buffers are allocated under a single lock or none of them.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_batch(unsigned int count, bool throttled)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int navail;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  /* The free list holds exactly g_iob_count buffers when it is positive */
+
+  navail = g_iob_count;
+#if CONFIG_IOB_THROTTLE > 0
+  if (throttled)
+    {
+      navail -= CONFIG_IOB_THROTTLE;
+    }
+#endif
+
+  if (count > 0 && navail >= (int)count)
+    {
+      g_iob_count -= count;
+      while (count-- > 0)
+        {
+          iob = g_iob_freelist;
+          DEBUGASSERT(iob != NULL);
+          g_iob_freelist = iob->io_flink;
+
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = head; /* Linked to the previous one */
+          iob->io_len    = 0;    /* Length of the data in the entry */
+          iob->io_offset = 0;    /* Offset to the beginning of data */
+          iob->io_pktlen = 0;    /* Total length of the packet */
+          head           = iob;
+        }
+
+      iob_update_peak();
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  if (head != NULL)
+    {
+      iob_notify_pressure(iob_navail(false));
+    }
+
+  return head;
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
@@ -346,6 +536,7 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_bufsize = size;             /* Total length of the iob buffer */
       iob->io_pktlen  = 0;                /* Total length of the packet */
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
+      iob->io_ext     = NULL;             /* No shared external buffer */
       iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
                                                 IOB_ALIGNMENT);
     }
@@ -392,6 +583,7 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_bufsize = size;    /* Total length of the iob buffer */
       iob->io_pktlen  = 0;       /* Total length of the packet */
       iob->io_free    = free_cb; /* Customer free callback */
+      iob->io_ext     = NULL;    /* No shared external buffer */
       iob->io_data    = data;
     }
 
@@ -431,6 +623,7 @@ FAR struct iob_s *iob_init_with_data(FAR void *data, uint16_t size,
   iob->io_offset  = 0;       /* Offset to the beginning of data */
   iob->io_pktlen  = 0;       /* Total length of the packet */
   iob->io_free    = free_cb; /* Customer free callback */
+  iob->io_ext     = NULL;    /* No shared external buffer */
   iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
                                             IOB_ALIGNMENT);
   iob->io_bufsize = ((FAR uint8_t *)data + size) - iob->io_data;
@@ -438,4 +631,57 @@ FAR struct iob_s *iob_init_with_data(FAR void *data, uint16_t size,
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_extbuf
+ *
+ * Description:
+ *   Allocate an I/O buffer from heap referring to a reference counted
+ *   external payload.
+ *
+ * Input Parameters:
+ *   data    - The external payload, owned by the caller until free_cb is
+ *             called.
+ *   size    - The size of the data parameter
+ *   free_cb - Called with data when the last I/O buffer referring to the
+ *             payload is freed.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_extbuf(FAR void *data, uint16_t size,
+                                   iob_free_cb_t free_cb)
+{
+  FAR struct iob_extbuf_s *ext;
+  FAR struct iob_s *iob;
+
+  DEBUGASSERT(free_cb != NULL);
+
+  ext = kmm_malloc(sizeof(struct iob_extbuf_s));
+  if (ext == NULL)
+    {
+      return NULL;
+    }
+
+  iob = kmm_malloc(sizeof(struct iob_s));
+  if (iob == NULL)
+    {
+      kmm_free(ext);
+      return NULL;
+    }
+
+  atomic_set(&ext->refs, 1);
+  ext->free_cb    = free_cb;
+  ext->data       = data;
+
+  iob->io_flink   = NULL;    /* Not in a chain */
+  iob->io_len     = 0;       /* Length of the data in the entry */
+  iob->io_offset  = 0;       /* Offset to the beginning of data */
+  iob->io_bufsize = size;    /* Total length of the iob buffer */
+  iob->io_pktlen  = 0;       /* Total length of the packet */
+  iob->io_free    = NULL;    /* Released through io_ext instead */
+  iob->io_ext     = ext;     /* Shared external buffer */
+  iob->io_data    = data;
+
+  return iob;
+}
+
 #endif
@@ -76,6 +76,13 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len)
    * head I/0 buffer?
    */
 
+  else if (IOB_SHARED(iob))
+    {
+      /* The shared data can't be moved */
+
+      ioberr("ERROR: Can't pack the shared data of %p\n", iob);
+      return -EBUSY;
+    }
   else if (len <= iob->io_pktlen)
     {
       /* Yes.. First eliminate any leading offset */
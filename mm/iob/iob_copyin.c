@@ -57,11 +57,13 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
                                bool throttled, bool can_block)
 {
   FAR struct iob_s *head = iob;
+  FAR struct iob_s *spare = NULL;
   FAR struct iob_s *next;
   FAR uint8_t *dest;
   unsigned int ncopy;
   unsigned int avail;
   unsigned int total = len;
+  bool batch = true;
 
   iobinfo("iob=%p len=%u offset=%d\n", iob, len, offset);
   DEBUGASSERT(iob && src);
@@ -178,12 +180,26 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
       if (len > 0 && !next)
         {
-          /* Yes.. allocate a new buffer.
-           *
-           * Copy as many bytes as possible. Block if we're allowed.
+          /* Yes.. allocate a new buffer.  Try once to take all of the
+           * buffers needed by the rest of the copy at once.
            */
 
-          if (can_block)
+          if (batch)
+            {
+              spare = iob_alloc_batch((len + CONFIG_IOB_BUFSIZE - 1) /
+                                      CONFIG_IOB_BUFSIZE, throttled);
+              batch = false;
+            }
+
+          /* Copy as many bytes as possible. Block if we're allowed. */
+
+          if (spare != NULL)
+            {
+              next           = spare;
+              spare          = next->io_flink;
+              next->io_flink = NULL;
+            }
+          else if (can_block)
             {
               next = iob_alloc(throttled);
             }
@@ -208,6 +224,10 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
       offset = 0;
     }
 
+  /* Each new buffer is filled up, so nothing should be left over */
+
+  DEBUGASSERT(spare == NULL);
+
   return total;
 }
 
@@ -32,9 +32,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
-#ifdef CONFIG_IOB_ALLOC
-#  include <nuttx/kmalloc.h>
-#endif
+#include <nuttx/kmalloc.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/mm/iob.h>
 
@@ -62,12 +60,139 @@
 #  endif
 #endif
 
-#define IOB_MASK      (IOB_DIVIDER - 1)
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_free_batch
+ *
+ * Description:
+ *   Return a list of I/O buffers of the pool, linked through io_flink, to
+ *   the free or the committed list under a single lock.  The buffers grown
+ *   from the heap go back to the heap unless someone is waiting for them.
+ *
+ ****************************************************************************/
+
+void iob_free_batch(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+#ifdef IOB_ELASTIC
+  FAR struct iob_s *shrink = NULL;
+#endif
+  irqstate_t flags;
+  int npost = 0;
+#if CONFIG_IOB_THROTTLE > 0
+  int nthrottle = 0;
+#endif
+#ifdef CONFIG_IOB_NOTIFIER
+  int16_t before;
+  int16_t after;
+#endif
+
+  /* We don't know what context we are called from so we use extreme
+   * measures to protect the free list:  We disable interrupts very
+   * briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+#ifdef CONFIG_IOB_NOTIFIER
+  before = g_iob_count;
+#endif
+
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+
+      /* Which list?  If there is a task waiting for an IOB, then put
+       * the IOB on either the free list or on the committed list where
+       * it is reserved for that allocation (and not available to
+       * iob_tryalloc()). This is true for both throttled and
+       * non-throttled cases.
+       */
+
+      if (g_iob_count < 0)
+        {
+          g_iob_count++;
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+          npost++;
+        }
+#if CONFIG_IOB_THROTTLE > 0
+      else if (g_throttle_wait > 0 &&
+               (g_iob_count >= CONFIG_IOB_THROTTLE || IOB_GROWN(iob)))
+        {
+          /* A grown buffer is outside of the throttle, it is handed to
+           * the throttled waiters before it could go back to the heap.
+           */
+
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+          g_throttle_wait--;
+          nthrottle++;
+        }
+#endif
+#ifdef IOB_ELASTIC
+      else if (IOB_GROWN(iob))
+        {
+          g_iob_ngrown--;
+          iob->io_flink   = shrink;
+          shrink          = iob;
+        }
+#endif
+      else
+        {
+          g_iob_count++;
+          iob->io_flink   = g_iob_freelist;
+          g_iob_freelist  = iob;
+        }
+    }
+
+#ifdef CONFIG_IOB_NOTIFIER
+  after = g_iob_count;
+#endif
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+
+#ifdef IOB_ELASTIC
+  /* Shrink the pool now that the lock is released */
+
+  for (; shrink != NULL; shrink = next)
+    {
+      next = shrink->io_flink;
+      kmm_free((FAR uint8_t *)shrink - IOB_GROWN_PAD);
+    }
+#endif
+
+  /* Wake up the waiters that the buffers were committed to */
+
+  while (npost-- > 0)
+    {
+      nxsem_post(&g_iob_sem);
+    }
+
+#if CONFIG_IOB_THROTTLE > 0
+  while (nthrottle-- > 0)
+    {
+      nxsem_post(&g_throttle_sem);
+    }
+#endif
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Signal any threads that have requested a signal notification when an
+   * IOB becomes available, once per IOB_DIVIDER buffers made available.
+   */
+
+  if (after > 0 && after / IOB_DIVIDER > MAX(before, 0) / IOB_DIVIDER)
+    {
+      iob_notifier_signal();
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -80,10 +205,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -119,6 +240,22 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 
 #ifdef CONFIG_IOB_ALLOC
+  if (iob->io_ext != NULL)
+    {
+      FAR struct iob_extbuf_s *ext = iob->io_ext;
+
+      /* Drop the reference, the last one returns the data to its owner */
+
+      kmm_free(iob);
+      if (atomic_fetch_sub(&ext->refs, 1) == 1)
+        {
+          ext->free_cb(ext->data);
+          kmm_free(ext);
+        }
+
+      return next;
+    }
+
   if (iob->io_free != NULL)
     {
       FAR uint8_t *io_data = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
@@ -137,64 +274,10 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 #endif
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
-
-  if (g_iob_count < 0)
-    {
-      g_iob_count++;
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_iob_sem);
-    }
-#if CONFIG_IOB_THROTTLE > 0
-  else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
-    {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      g_throttle_wait--;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_throttle_sem);
-    }
-#endif
-  else
-    {
-      g_iob_count++;
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-    }
-
-  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
-
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
-   */
-
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
-    {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
+  /* Return the I/O buffer to the pool */
 
-      iob_notifier_signal();
-    }
-#endif
+  iob->io_flink = NULL;
+  iob_free_batch(iob);
 
   /* And return the I/O buffer after the one that was freed */
 
@@ -46,12 +46,32 @@
 
 void iob_free_chain(FAR struct iob_s *iob)
 {
+  FAR struct iob_s *pool = NULL;
   FAR struct iob_s *next;
 
-  /* Free each IOB in the chain -- one at a time to keep the count straight */
+  /* Collect the I/O buffers of the pool to return them all at once, any
+   * other I/O buffer is released to its owner one at a time.
+   */
 
   for (; iob; iob = next)
     {
-      next = iob_free(iob);
+      next = iob->io_flink;
+
+#ifdef CONFIG_IOB_ALLOC
+      if (iob->io_ext != NULL || iob->io_free != NULL)
+        {
+          iob->io_flink = NULL;
+          iob_free(iob);
+          continue;
+        }
+#endif
+
+      iob->io_flink = pool;
+      pool          = iob;
+    }
+
+  if (pool != NULL)
+    {
+      iob_free_batch(pool);
     }
 }
@@ -34,23 +34,17 @@
 #include "iob.h"
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Data
  ****************************************************************************/
 
-/* Fix the I/O Buffer size with specified alignment size */
+#if CONFIG_IOB_NCHAINS > 0
+/* This is a pool of pre-allocated iob_qentry_s buffers */
 
-#ifdef CONFIG_IOB_ALLOC
-#  define IOB_ALIGN_SIZE  ALIGN_UP(sizeof(struct iob_s) + CONFIG_IOB_BUFSIZE, \
-                                   IOB_ALIGNMENT)
-#else
-#  define IOB_ALIGN_SIZE  ALIGN_UP(sizeof(struct iob_s), IOB_ALIGNMENT)
+static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
 #endif
 
-#define IOB_BUFFER_SIZE   (IOB_ALIGN_SIZE * CONFIG_IOB_NBUFFERS + \
-                           IOB_ALIGNMENT - 1)
-
 /****************************************************************************
- * Private Data
+ * Public Data
  ****************************************************************************/
 
 /* Following raw buffer will be divided into iob_s instances, the initial
@@ -59,21 +53,11 @@
  */
 
 #ifdef IOB_SECTION
-static uint8_t g_iob_buffer[IOB_BUFFER_SIZE] locate_data(IOB_SECTION);
+uint8_t g_iob_buffer[IOB_BUFFER_SIZE] locate_data(IOB_SECTION);
 #else
-static uint8_t g_iob_buffer[IOB_BUFFER_SIZE];
-#endif
-
-#if CONFIG_IOB_NCHAINS > 0
-/* This is a pool of pre-allocated iob_qentry_s buffers */
-
-static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
+uint8_t g_iob_buffer[IOB_BUFFER_SIZE];
 #endif
 
-/****************************************************************************
- * Public Data
- ****************************************************************************/
-
 /* A list of all free, unallocated I/O buffers */
 
 FAR struct iob_s *g_iob_freelist;
@@ -98,6 +82,16 @@ sem_t g_iob_sem = SEM_INITIALIZER(0);
 
 int16_t g_iob_count = CONFIG_IOB_NBUFFERS;
 
+/* High-watermark of the I/O buffers in use */
+
+int16_t g_iob_npeak;
+
+#ifdef IOB_ELASTIC
+/* Number of the I/O buffers allocated from the heap */
+
+int16_t g_iob_ngrown;
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
 
 sem_t g_throttle_sem = SEM_INITIALIZER(0);
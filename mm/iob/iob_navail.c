@@ -47,6 +47,9 @@
 int iob_navail(bool throttled)
 {
   int ret;
+#ifdef IOB_ELASTIC
+  int growth;
+#endif
 
 #if CONFIG_IOB_NBUFFERS > 0
   ret = g_iob_count;
@@ -69,5 +72,15 @@ int iob_navail(bool throttled)
   ret = 0;
 #endif
 
+#ifdef IOB_ELASTIC
+  /* Add the buffers that the pool can still grow by */
+
+  growth = IOB_NGROW - g_iob_ngrown;
+  if (growth > 0)
+    {
+      ret += growth;
+    }
+#endif
+
   return ret;
 }
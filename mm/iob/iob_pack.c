@@ -70,6 +70,14 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
     {
       next = iob->io_flink;
 
+      /* The shared data can't be moved, leave the entry as it is */
+
+      if (IOB_SHARED(iob))
+        {
+          iob = next;
+          continue;
+        }
+
       /* Eliminate the data offset in this entry */
 
       if (iob->io_offset > 0)
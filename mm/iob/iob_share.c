@@ -0,0 +1,168 @@
+/****************************************************************************
+ * mm/iob/iob_share.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <sys/param.h>
+#include <assert.h>
+#include <debug.h>
+
+#ifdef CONFIG_IOB_ALLOC
+#  include <nuttx/kmalloc.h>
+#endif
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_share_entry
+ *
+ * Description:
+ *   Create one entry of the new chain holding 'len' bytes of 'iob' starting
+ *   at 'offset', either referring to the shared buffer of 'iob' or holding
+ *   a copy of its data.  The number of bytes taken is returned in 'len'.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_share_entry(FAR struct iob_s *iob,
+                                         FAR unsigned int *len,
+                                         unsigned int offset,
+                                         bool throttled)
+{
+  FAR struct iob_s *entry;
+
+#ifdef CONFIG_IOB_ALLOC
+  if (iob->io_ext != NULL)
+    {
+      entry = kmm_malloc(sizeof(struct iob_s));
+      if (entry == NULL)
+        {
+          return NULL;
+        }
+
+      atomic_fetch_add(&iob->io_ext->refs, 1);
+
+      /* Leave no tail room, the data beyond belongs to the source */
+
+      entry->io_offset  = iob->io_offset + offset;
+      entry->io_len     = *len;
+      entry->io_bufsize = entry->io_offset + *len;
+      entry->io_free    = NULL;
+      entry->io_ext     = iob->io_ext;
+      entry->io_data    = iob->io_data;
+    }
+  else
+#endif
+    {
+      entry = iob_alloc(throttled);
+      if (entry == NULL)
+        {
+          return NULL;
+        }
+
+      *len = MIN(*len, IOB_BUFSIZE(entry));
+      memcpy(entry->io_data, &iob->io_data[iob->io_offset + offset], *len);
+      entry->io_len = *len;
+    }
+
+  entry->io_flink  = NULL;
+  entry->io_pktlen = 0;
+  return entry;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_share
+ *
+ * Description:
+ *   Create a new I/O buffer chain holding 'len' bytes of the chain 'iob'
+ *   starting at 'offset'.  The data of external buffers allocated by
+ *   iob_alloc_extbuf() is referenced rather than copied; the data of any
+ *   other I/O buffer is copied.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_share(FAR struct iob_s *iob, unsigned int len,
+                            unsigned int offset, bool throttled)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *entry;
+  unsigned int pktlen = 0;
+  unsigned int ncopy;
+
+  while (iob != NULL && len > 0)
+    {
+      /* Skip to the I/O buffer containing the offset */
+
+      if (offset >= iob->io_len)
+        {
+          offset -= iob->io_len;
+          iob     = iob->io_flink;
+          continue;
+        }
+
+      ncopy = MIN(len, iob->io_len - offset);
+      entry = iob_share_entry(iob, &ncopy, offset, throttled);
+      if (entry == NULL)
+        {
+          ioberr("ERROR: Failed to share %u bytes\n", len);
+          iob_free_chain(head);
+          return NULL;
+        }
+
+      /* Append the new entry to the chain */
+
+      if (tail == NULL)
+        {
+          head = entry;
+        }
+      else
+        {
+          tail->io_flink = entry;
+        }
+
+      tail    = entry;
+      pktlen += ncopy;
+      len    -= ncopy;
+      offset += ncopy;
+    }
+
+  if (head != NULL)
+    {
+      head->io_pktlen = pktlen;
+    }
+
+  return head;
+}
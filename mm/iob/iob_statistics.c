@@ -54,7 +54,8 @@
 
 void iob_getstats(FAR struct iob_stats_s *stats)
 {
-  stats->ntotal = CONFIG_IOB_NBUFFERS;
+  stats->ntotal = IOB_NTOTAL;
+  stats->npeak  = g_iob_npeak;
 
   stats->nfree = g_iob_count;
   if (stats->nfree < 0)
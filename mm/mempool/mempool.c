@@ -42,6 +42,18 @@
 
 #define MEMPOOL_HEADER_SIZE (sizeof(sq_entry_t) + CONFIG_MM_NODE_GUARDSIZE)
 
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+/* The number of blocks moved between a CPU cache and the pool at once */
+
+#  define MEMPOOL_CACHE_BATCH ((CONFIG_MM_MEMPOOL_CACHE_SIZE + 1) / 2)
+
+/* Blocks held by a cache are missing from the pool, so only cache the
+ * pools that can expand instead of failing or waiting when they are empty.
+ */
+
+#  define MEMPOOL_CACHEABLE(pool) ((pool)->expandsize != 0)
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #define MEMPOOL_MAGIC_FREE  0x55555555
 #define MEMPOOL_MAGIC_ALLOC 0xAAAAAAAA
@@ -100,6 +112,114 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+static inline void mempool_free_check(FAR struct mempool_s *pool,
+                                      FAR void *blk)
+{
+#if CONFIG_MM_BACKTRACE >= 0
+  FAR struct mempool_backtrace_s *buf =
+    (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
+
+  /* Check double free or out of out of bounds */
+
+  DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
+  buf->magic = MEMPOOL_MAGIC_FREE;
+#endif
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(blk, MM_FREE_MAGIC, pool->blocksize);
+#endif
+}
+
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+static size_t mempool_cache_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += pool->cache[cpu].count;
+    }
+
+  return count;
+}
+
+/* Move nblks blocks from the cache back to the pool; the caller must have
+ * disabled the local interrupts.
+ */
+
+static void mempool_cache_flush(FAR struct mempool_s *pool,
+                                FAR struct mempool_cache_s *cache,
+                                size_t nblks)
+{
+  spin_lock(&pool->lock);
+  cache->count -= nblks;
+  pool->nalloc -= nblks;
+  while (nblks-- > 0)
+    {
+      sq_addlast(mempool_remove_queue(pool, &cache->queue), &pool->queue);
+    }
+
+  spin_unlock(&pool->lock);
+}
+
+static FAR sq_entry_t *mempool_cache_allocate(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  cache = &pool->cache[this_cpu()];
+  if (cache->count == 0)
+    {
+      /* Refill the cache with a batch of blocks from the pool.  The pool
+       * keeps counting the cached blocks as allocated.
+       */
+
+      spin_lock(&pool->lock);
+      while (cache->count < MEMPOOL_CACHE_BATCH &&
+             (blk = mempool_remove_queue(pool, &pool->queue)) != NULL)
+        {
+          sq_addlast(blk, &cache->queue);
+          cache->count++;
+          pool->nalloc++;
+        }
+
+      spin_unlock(&pool->lock);
+    }
+
+  blk = mempool_remove_queue(pool, &cache->queue);
+  if (blk != NULL)
+    {
+      cache->count--;
+    }
+
+  up_irq_restore(flags);
+  return blk;
+}
+
+static void mempool_cache_release(FAR struct mempool_s *pool,
+                                  FAR void *blk)
+{
+  FAR struct mempool_cache_s *cache;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  mempool_free_check(pool, blk);
+
+  cache = &pool->cache[this_cpu()];
+  sq_addlast(blk, &cache->queue);
+  kasan_poison(blk, pool->blocksize);
+  if (++cache->count > CONFIG_MM_MEMPOOL_CACHE_SIZE)
+    {
+      mempool_cache_flush(pool, cache, MEMPOOL_CACHE_BATCH);
+    }
+
+  up_irq_restore(flags);
+}
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -264,11 +384,22 @@ mempool_memdump_free_callback(FAR struct mempool_s *pool,
 int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  int i;
+#endif
 
   sq_init(&pool->queue);
   sq_init(&pool->iqueue);
   sq_init(&pool->equeue);
   pool->nalloc = 0;
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      sq_init(&pool->cache[i].queue);
+      pool->cache[i].count = 0;
+    }
+#endif
+
   if (pool->interruptsize >= blocksize)
     {
       size_t ninterrupt = pool->interruptsize / blocksize;
@@ -354,6 +485,17 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  if (MEMPOOL_CACHEABLE(pool))
+    {
+      blk = mempool_cache_allocate(pool);
+      if (blk != NULL)
+        {
+          goto out_with_blk;
+        }
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
@@ -408,6 +550,9 @@ retry:
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
 
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+out_with_blk:
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
                               ((FAR char *)blk + pool->blocksize));
@@ -434,24 +579,24 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
-#if CONFIG_MM_BACKTRACE >= 0
-  FAR struct mempool_backtrace_s *buf =
-    (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
+  irqstate_t flags;
 
-  /* Check double free or out of out of bounds */
-
-  DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
-  buf->magic = MEMPOOL_MAGIC_FREE;
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  /* Blocks of the interrupt pool always go back to the interrupt queue */
 
+  if (MEMPOOL_CACHEABLE(pool) &&
+      (pool->ibase == NULL || (FAR char *)blk < pool->ibase ||
+       (FAR char *)blk >= pool->ibase + pool->interruptsize))
+    {
+      mempool_cache_release(pool, blk);
+      return;
+    }
 #endif
 
+  flags = spin_lock_irqsave(&pool->lock);
+  mempool_free_check(pool, blk);
   pool->nalloc--;
 
-#ifdef CONFIG_MM_FILL_ALLOCATIONS
-  memset(blk, MM_FREE_MAGIC, pool->blocksize);
-#endif
-
   if (pool->ibase)
     {
       if ((FAR char *)blk >= pool->ibase &&
@@ -501,6 +646,9 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   irqstate_t flags;
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  size_t cached;
+#endif
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
@@ -508,6 +656,13 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   info->ordblks = sq_count(&pool->queue);
   info->iordblks = sq_count(&pool->iqueue);
   info->aordblks = pool->nalloc;
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  /* The cached blocks are free, but the pool counts them as allocated */
+
+  cached = mempool_cache_count(pool);
+  info->ordblks += cached;
+  info->aordblks -= cached;
+#endif
   info->arena = sq_count(&pool->equeue) * MEMPOOL_HEADER_SIZE +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
@@ -536,16 +691,21 @@ mempool_info_task(FAR struct mempool_s *pool,
                   FAR const struct malltask *task)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  size_t cached = 0;
   struct mallinfo_task info =
     {
       0, 0
     };
 
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  cached = mempool_cache_count(pool);
+#endif
+
   if (task->pid == PID_MM_FREE)
     {
       irqstate_t flags = spin_lock_irqsave(&pool->lock);
       size_t count = sq_count(&pool->queue) +
-                     sq_count(&pool->iqueue);
+                     sq_count(&pool->iqueue) + cached;
 
       spin_unlock_irqrestore(&pool->lock, flags);
       info.aordblks += count;
@@ -553,8 +713,8 @@ mempool_info_task(FAR struct mempool_s *pool,
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      info.aordblks += pool->nalloc - cached;
+      info.uordblks += (pool->nalloc - cached) * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -623,6 +783,20 @@ int mempool_deinit(FAR struct mempool_s *pool)
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   FAR sq_entry_t *blk;
   size_t count = 0;
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  irqstate_t flags;
+  int cpu;
+
+  /* Give the cached blocks back to the pool first */
+
+  flags = up_irq_save();
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      mempool_cache_flush(pool, &pool->cache[cpu], pool->cache[cpu].count);
+    }
+
+  up_irq_restore(flags);
+#endif
 
   if (pool->nalloc != 0)
     {
@@ -110,7 +110,13 @@ FAR void *gran_alloc_align(GRAN_HANDLE handle, size_t size, size_t align)
   posi = gran_search(gran, naligned_up);
   if (posi >= 0)
     {
-      posi = (posi + nalign - 1) & ~(nalign - 1);
+      /* Align the address rather than the granule index, the heap itself
+       * needn't start on the requested boundary.
+       */
+
+      retp = gran->heapstart + ((uintptr_t)posi << gran->log2gran);
+      retp = (retp + align - 1) & ~((uintptr_t)align - 1);
+      posi = (retp - gran->heapstart) >> gran->log2gran;
       gran_set(gran, posi, ngran);
     }
 
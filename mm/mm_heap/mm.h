@@ -35,6 +35,10 @@
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
 #include <nuttx/mm/mm.h>
+#include <nuttx/spinlock.h>
+#ifdef CONFIG_MM_FREE_DELAY_WORKER
+#  include <nuttx/wqueue.h>
+#endif
 
 #include <assert.h>
 #include <sys/types.h>
@@ -260,6 +264,17 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
+  /* The worker that drains the delay lists of all CPUs; in SMP the lists
+   * are then protected by a spinlock instead of the local interrupt mask.
+   */
+
+#ifdef CONFIG_MM_FREE_DELAY_WORKER
+  struct work_s mm_delaywork;
+#  ifdef CONFIG_SMP
+  spinlock_t mm_delaylock;
+#  endif
+#endif
+
   /* The is a multiple mempool of the heap */
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
@@ -267,6 +282,13 @@ struct mm_heap_s
   FAR struct mempool_multiple_s *mm_mpool;
 #endif
 
+  /* The per-CPU arenas carved out of this heap */
+
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  FAR struct mm_heap_s *mm_arena[CONFIG_SMP_NCPUS];
+  bool                  mm_isarena;
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
@@ -305,10 +327,34 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
+void mm_delayfree_list(FAR struct mm_heap_s *heap,
+                       FAR struct mm_delaynode_s *list);
 
 /* Functions contained in mm_malloc.c ***************************************/
 
 void mm_free_delaylist(FAR struct mm_heap_s *heap);
+#ifdef CONFIG_MM_FREE_DELAY_WORKER
+void mm_free_delaywork(FAR void *arg);
+#endif
+
+/* Functions contained in mm_arena.c ****************************************/
+
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+FAR struct mm_heap_s *mm_arena_get(FAR struct mm_heap_s *heap);
+FAR struct mm_heap_s *mm_arena_find(FAR struct mm_heap_s *heap,
+                                    FAR void *mem);
+#endif
+
+/* Functions contained in mm_profile.c **************************************/
+
+#if defined(CONFIG_MM_HEAP_PROFILE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+void mm_profile_alloc(FAR void *mem, size_t size);
+void mm_profile_free(FAR void *mem);
+#else
+#  define mm_profile_alloc(mem, size)
+#  define mm_profile_free(mem)
+#endif
 
 /****************************************************************************
  * Inline Functions
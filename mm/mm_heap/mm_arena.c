@@ -0,0 +1,180 @@
+/****************************************************************************
+ * mm/mm_heap/mm_arena.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_arena_create
+ *
+ * Description:
+ *   Carve a new arena out of the heap.  The arena is an anonymous heap of
+ *   its own, so it is neither registered in procfs nor with KASan (its
+ *   memory is already covered by the parent heap).
+ *
+ ****************************************************************************/
+
+static FAR struct mm_heap_s *mm_arena_create(FAR struct mm_heap_s *heap)
+{
+  struct mm_heap_config_s config;
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_heap_s *arena;
+  FAR void *start;
+
+  start = mm_memalign(heap, MM_ALIGN, CONFIG_MM_HEAP_ARENA_SIZE);
+  if (start == NULL)
+    {
+      return NULL;
+    }
+
+#if CONFIG_MM_BACKTRACE >= 0
+  /* The arena is memory handed to another allocator, like the mempool
+   * chunks; don't report it as an allocation of the calling thread.
+   */
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)start - MM_SIZEOF_ALLOCNODE);
+  node->pid = PID_MM_MEMPOOL;
+#endif
+
+  memset(&config, 0, sizeof(config));
+  config.start   = start;
+  config.size    = CONFIG_MM_HEAP_ARENA_SIZE;
+  config.nokasan = true;
+
+  arena = mm_initialize_heap(&config);
+  arena->mm_isarena = true;
+  return arena;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_arena_get
+ *
+ * Description:
+ *   Return the arena of the current CPU, creating it on first use.  NULL
+ *   is returned if the heap is an arena itself, if the arena cannot be
+ *   created right now or if the heap has no room left for it.
+ *
+ *   The thread may migrate to another CPU after this returns; that only
+ *   costs some locality since each arena has its own lock.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_arena_get(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_heap_s *arena;
+  FAR struct mm_heap_s *other;
+  int cpu;
+
+  if (heap->mm_isarena)
+    {
+      return NULL;
+    }
+
+  cpu   = this_cpu();
+  arena = heap->mm_arena[cpu];
+  if (arena != NULL || up_interrupt_context())
+    {
+      return arena;
+    }
+
+  arena = mm_arena_create(heap);
+  if (arena == NULL)
+    {
+      return NULL;
+    }
+
+  /* Another thread on this CPU may have created the arena meanwhile */
+
+  DEBUGVERIFY(mm_lock(heap));
+  other = heap->mm_arena[cpu];
+  if (other == NULL)
+    {
+      heap->mm_arena[cpu] = arena;
+    }
+
+  mm_unlock(heap);
+
+  if (other != NULL)
+    {
+      /* The arena context sits at the start of the carved memory */
+
+      mm_uninitialize(arena);
+      mm_free(heap, arena);
+      arena = other;
+    }
+
+  minfo("CPU%d arena %p\n", cpu, arena);
+  return arena;
+}
+
+/****************************************************************************
+ * Name: mm_arena_find
+ *
+ * Description:
+ *   Return the arena that the memory was allocated from, or NULL if it
+ *   was allocated from the heap itself.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_arena_find(FAR struct mm_heap_s *heap,
+                                    FAR void *mem)
+{
+  FAR struct mm_heap_s *arena;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      arena = heap->mm_arena[cpu];
+      if (arena != NULL && mm_heapmember(arena, mem))
+        {
+          return arena;
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_MM_HEAP_ARENA_SIZE > 0 */
@@ -77,5 +77,17 @@ static void checkcorruption_handler(FAR struct mm_allocnode_s *node,
 
 void mm_checkcorruption(FAR struct mm_heap_s *heap)
 {
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (heap->mm_arena[cpu] != NULL)
+        {
+          mm_foreach(heap->mm_arena[cpu], checkcorruption_handler, NULL);
+        }
+    }
+#endif
+
   mm_foreach(heap, checkcorruption_handler, NULL);
 }
@@ -46,6 +46,9 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
 #if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
   FAR struct mm_delaynode_s *tmp = mem;
   irqstate_t flags;
+#ifdef CONFIG_MM_FREE_DELAY_WORKER
+  bool drain = true;
+#endif
 
   /* Delay the deallocation until a more appropriate time. */
 
@@ -63,44 +66,40 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
 
 #if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
   heap->mm_delaycount[this_cpu()]++;
+#  ifdef CONFIG_MM_FREE_DELAY_WORKER
+  drain = heap->mm_delaycount[this_cpu()] >= CONFIG_MM_FREE_DELAYCOUNT_MAX;
+#  endif
 #endif
 
   mm_unlock_irq(heap, flags);
+
+#ifdef CONFIG_MM_FREE_DELAY_WORKER
+  /* Let the worker drain the list.  That is not possible in the middle of
+   * a context switch; the next malloc() will do it instead.
+   */
+
+  if (drain && work_available(&heap->mm_delaywork) &&
+      (up_interrupt_context() || _SCHED_GETTID() >= 0))
+    {
+      work_queue(LPWORK, &heap->mm_delaywork, mm_free_delaywork, heap, 0);
+    }
+#endif
 #endif
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: mm_delayfree
+ * Name: free_prepare
  *
  * Description:
- *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *   Fill and poison the memory that is about to be freed.
  *
  ****************************************************************************/
 
-void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+static void free_prepare(FAR struct mm_heap_s *heap, FAR void *mem,
+                         bool delay)
 {
-  FAR struct mm_freenode_s *node;
-  FAR struct mm_freenode_s *prev;
-  FAR struct mm_freenode_s *next;
-  size_t nodesize;
-  size_t prevsize;
-
-  if (mm_lock(heap) < 0)
-    {
-      /* Meet -ESRCH return, which means we are in situations
-       * during context switching(See mm_lock() & gettid()).
-       * Then add to the delay list.
-       */
-
-      add_delaylist(heap, mem);
-      return;
-    }
+  size_t nodesize = mm_malloc_size(heap, mem);
 
-  nodesize = mm_malloc_size(heap, mem);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
 #if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
   /* If delay free is enabled, a memory node will be freed twice.
@@ -117,13 +116,24 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
 #endif
 
   kasan_poison(mem, nodesize);
+}
 
-  if (delay)
-    {
-      mm_unlock(heap);
-      add_delaylist(heap, mem);
-      return;
-    }
+/****************************************************************************
+ * Name: free_node
+ *
+ * Description:
+ *   Return the chunk to the free node lists, merging it with the adjacent
+ *   free chunks.  The caller must hold the heap lock.
+ *
+ ****************************************************************************/
+
+static void free_node(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_freenode_s *node;
+  FAR struct mm_freenode_s *prev;
+  FAR struct mm_freenode_s *next;
+  size_t nodesize;
+  size_t prevsize;
 
   /* Map the memory chunk into a free node */
 
@@ -217,6 +227,82 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   /* Add the merged node to the nodelist */
 
   mm_addfreechunk(heap, node);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_delayfree
+ *
+ * Description:
+ *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *
+ ****************************************************************************/
+
+void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+{
+  if (mm_lock(heap) < 0)
+    {
+      /* Meet -ESRCH return, which means we are in situations
+       * during context switching(See mm_lock() & gettid()).
+       * Then add to the delay list.
+       */
+
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  free_prepare(heap, mem, delay);
+
+  if (delay)
+    {
+      mm_unlock(heap);
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  free_node(heap, mem);
+  mm_unlock(heap);
+}
+
+/****************************************************************************
+ * Name: mm_delayfree_list
+ *
+ * Description:
+ *   Free a list of delayed deallocations.  The heap lock is taken once for
+ *   the whole batch instead of once per node.
+ *
+ ****************************************************************************/
+
+void mm_delayfree_list(FAR struct mm_heap_s *heap,
+                       FAR struct mm_delaynode_s *list)
+{
+  FAR struct mm_delaynode_s *next;
+
+  if (mm_lock(heap) < 0)
+    {
+      /* Still not possible to free, put the nodes back */
+
+      while (list != NULL)
+        {
+          next = list->flink;
+          add_delaylist(heap, list);
+          list = next;
+        }
+
+      return;
+    }
+
+  while (list != NULL)
+    {
+      next = list->flink;
+      free_prepare(heap, list, false);
+      free_node(heap, list);
+      list = next;
+    }
+
   mm_unlock(heap);
 }
 
@@ -231,6 +317,10 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 {
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  FAR struct mm_heap_s *arena;
+#endif
+
   minfo("Freeing %p\n", mem);
 
   /* Protect against attempts to free a NULL reference */
@@ -252,5 +342,17 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 #endif
 
+  mm_profile_free(kasan_clear_tag(mem));
+
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  /* Memory always goes back to the arena that it came from */
+
+  arena = mm_arena_find(heap, mem);
+  if (arena != NULL)
+    {
+      heap = arena;
+    }
+#endif
+
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
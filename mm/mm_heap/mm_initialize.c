@@ -284,6 +284,9 @@ mm_initialize_heap(FAR const struct mm_heap_config_s *config)
    */
 
   nxmutex_init(&heap->mm_lock);
+#if defined(CONFIG_MM_FREE_DELAY_WORKER) && defined(CONFIG_SMP)
+  spin_lock_init(&heap->mm_delaylock);
+#endif
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
 #  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
@@ -387,6 +390,20 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
   mempool_multiple_deinit(heap->mm_mpool);
 #endif
 
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (heap->mm_arena[i] != NULL)
+        {
+          mm_uninitialize(heap->mm_arena[i]);
+        }
+    }
+#endif
+
+#ifdef CONFIG_MM_FREE_DELAY_WORKER
+  work_cancel_sync(LPWORK, &heap->mm_delaywork);
+#endif
+
   mm_free_delaylist(heap);
 
   for (i = 0; i < CONFIG_MM_REGIONS; i++)
@@ -146,9 +146,13 @@ void mm_unlock(FAR struct mm_heap_s *heap)
 
 irqstate_t mm_lock_irq(FAR struct mm_heap_s *heap)
 {
+#if defined(CONFIG_MM_FREE_DELAY_WORKER) && defined(CONFIG_SMP)
+  irqstate_t flags = spin_lock_irqsave(&heap->mm_delaylock);
+#else
   irqstate_t flags = up_irq_save();
 
   UNUSED(heap);
+#endif
   kasan_bypass(true);
 
   return flags;
@@ -164,7 +168,11 @@ irqstate_t mm_lock_irq(FAR struct mm_heap_s *heap)
 
 void mm_unlock_irq(FAR struct mm_heap_s *heap, irqstate_t state)
 {
-  UNUSED(heap);
   kasan_bypass(false);
+#if defined(CONFIG_MM_FREE_DELAY_WORKER) && defined(CONFIG_SMP)
+  spin_unlock_irqrestore(&heap->mm_delaylock, state);
+#else
+  UNUSED(heap);
   up_irq_restore(state);
+#endif
 }
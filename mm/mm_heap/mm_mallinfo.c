@@ -131,6 +131,10 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   struct mallinfo poolinfo;
 #endif
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  struct mallinfo arenainfo;
+  int cpu;
+#endif
 
   memset(&info, 0, sizeof(info));
   mm_foreach(heap, mallinfo_handler, &info);
@@ -146,6 +150,29 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
   info.fordblks += poolinfo.fordblks;
 #endif
 
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  /* The arenas are allocated chunks of this heap; account their contents
+   * instead.
+   */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (heap->mm_arena[cpu] != NULL)
+        {
+          arenainfo = mm_mallinfo(heap->mm_arena[cpu]);
+
+          info.aordblks += arenainfo.aordblks - 1;
+          info.ordblks  += arenainfo.ordblks;
+          info.uordblks -= arenainfo.fordblks;
+          info.fordblks += arenainfo.fordblks;
+          if (arenainfo.mxordblk > info.mxordblk)
+            {
+              info.mxordblk = arenainfo.mxordblk;
+            }
+        }
+    }
+#endif
+
   DEBUGASSERT(info.uordblks + info.fordblks == info.arena);
 
   return info;
@@ -163,6 +190,10 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
 struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
                                       FAR const struct malltask *task)
 {
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  struct mallinfo_task arenainfo;
+  int cpu;
+#endif
   struct mm_mallinfo_handler_s handle;
   struct mallinfo_task info =
     {
@@ -177,6 +208,18 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
   handle.info = &info;
   mm_foreach(heap, mallinfo_task_handler, &handle);
 
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (heap->mm_arena[cpu] != NULL)
+        {
+          arenainfo = mm_mallinfo_task(heap->mm_arena[cpu], task);
+          info.aordblks += arenainfo.aordblks;
+          info.uordblks += arenainfo.uordblks;
+        }
+    }
+#endif
+
   return info;
 }
 
@@ -190,8 +233,25 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 
 size_t mm_heapfree(FAR struct mm_heap_s *heap)
 {
+  size_t size;
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  int cpu;
+#endif
+
   mm_free_delaylist(heap);
-  return heap->mm_heapsize - heap->mm_curused;
+  size = heap->mm_heapsize - heap->mm_curused;
+
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (heap->mm_arena[cpu] != NULL)
+        {
+          size += mm_heapfree(heap->mm_arena[cpu]);
+        }
+    }
+#endif
+
+  return size;
 }
 
 /****************************************************************************
@@ -205,6 +265,11 @@ size_t mm_heapfree(FAR struct mm_heap_s *heap)
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 {
   FAR struct mm_freenode_s *node;
+  size_t largest = 0;
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  size_t size;
+  int cpu;
+#endif
 
   mm_free_delaylist(heap);
 
@@ -214,9 +279,24 @@ size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
       size_t nodesize = MM_SIZEOF_NODE(node);
       if (nodesize != 0)
         {
-          return nodesize;
+          largest = nodesize;
+          break;
         }
     }
 
-  return 0;
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (heap->mm_arena[cpu] != NULL)
+        {
+          size = mm_heapfree_largest(heap->mm_arena[cpu]);
+          if (size > largest)
+            {
+              largest = size;
+            }
+        }
+    }
+#endif
+
+  return largest;
 }
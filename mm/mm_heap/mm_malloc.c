@@ -42,6 +42,37 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: take_delaylist
+ *
+ * Description:
+ *  Detach the delay list of a CPU.  Unless force is true, the list is only
+ *  detached when CONFIG_MM_FREE_DELAYCOUNT_MAX (if enabled) is reached.
+ *  The caller must hold mm_lock_irq().
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+static FAR struct mm_delaynode_s *
+take_delaylist(FAR struct mm_heap_s *heap, int cpu, bool force)
+{
+  FAR struct mm_delaynode_s *tmp = heap->mm_delaylist[cpu];
+
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  if (tmp == NULL ||
+      (!force && heap->mm_delaycount[cpu] < CONFIG_MM_FREE_DELAYCOUNT_MAX))
+    {
+      return NULL;
+    }
+
+  heap->mm_delaycount[cpu] = 0;
+#endif
+
+  heap->mm_delaylist[cpu] = NULL;
+  return tmp;
+}
+#endif
+
 /****************************************************************************
  * Name: free_delaylist
  *
@@ -63,49 +94,31 @@ static bool free_delaylist(FAR struct mm_heap_s *heap, bool force)
   FAR struct mm_delaynode_s *tmp;
   irqstate_t flags;
 
-  /* Move the delay list to local */
-
-  flags = mm_lock_irq(heap);
-
-  tmp = heap->mm_delaylist[this_cpu()];
+  /* Don't mask the interrupts on every allocation just to find the list
+   * empty.  Only this CPU adds to its list, so a stale value only defers
+   * the work to the next call.
+   */
 
-#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  if (tmp == NULL ||
-      (!force &&
-        heap->mm_delaycount[this_cpu()] < CONFIG_MM_FREE_DELAYCOUNT_MAX))
+  if (heap->mm_delaylist[this_cpu()] == NULL)
     {
-      mm_unlock_irq(heap, flags);
       return false;
     }
 
-  heap->mm_delaycount[this_cpu()] = 0;
-#endif
-
-  heap->mm_delaylist[this_cpu()] = NULL;
+  /* Move the delay list to local */
 
+  flags = mm_lock_irq(heap);
+  tmp = take_delaylist(heap, this_cpu(), force);
   mm_unlock_irq(heap, flags);
 
-  /* Test if the delayed is empty */
+  /* Free the whole list in one batch */
 
   ret = tmp != NULL;
-
-  while (tmp)
+  if (ret)
     {
-      FAR void *address;
-
-      /* Get the first delayed deallocation */
-
-      address = tmp;
-      tmp = tmp->flink;
-
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
-       */
-
-      mm_delayfree(heap, address, false);
+      mm_delayfree_list(heap, tmp);
     }
-
 #endif
+
   return ret;
 }
 
@@ -156,6 +169,36 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
     }
 }
 
+/****************************************************************************
+ * Name: mm_free_delaywork
+ *
+ * Description:
+ *   The work queue callback that drains the delay lists of all CPUs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_FREE_DELAY_WORKER
+void mm_free_delaywork(FAR void *arg)
+{
+  FAR struct mm_heap_s *heap = arg;
+  FAR struct mm_delaynode_s *tmp;
+  irqstate_t flags;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      flags = mm_lock_irq(heap);
+      tmp = take_delaylist(heap, cpu, false);
+      mm_unlock_irq(heap, flags);
+
+      if (tmp != NULL)
+        {
+          mm_delayfree_list(heap, tmp);
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mm_malloc
  *
@@ -169,6 +212,9 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 {
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  FAR struct mm_heap_s *arena;
+#endif
   FAR struct mm_freenode_s *node;
   size_t alignsize;
   size_t nodesize;
@@ -190,6 +236,20 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  /* Try the arena of this CPU before taking the lock of the heap */
+
+  arena = mm_arena_get(heap);
+  if (arena != NULL)
+    {
+      ret = mm_malloc(arena, size);
+      if (ret != NULL)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Adjust the size to account for (1) the size of the allocated node and
    * (2) to make sure that it is aligned with MM_ALIGN and its size is at
    * least MM_MIN_CHUNK.
@@ -333,6 +393,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   if (ret)
     {
       MM_ADD_BACKTRACE(heap, node);
+      mm_profile_alloc(ret, nodesize - MM_ALLOCNODE_OVERHEAD);
       ret = kasan_unpoison(ret, nodesize - MM_ALLOCNODE_OVERHEAD);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
       memset(ret, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
@@ -243,6 +243,9 @@ void mm_memdump(FAR struct mm_heap_s *heap,
 {
   struct mm_memdump_priv_s priv;
   pid_t pid = dump->pid;
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  int i;
+#endif
 
   memset(&priv, 0, sizeof(struct mm_memdump_priv_s));
   priv.dump = dump;
@@ -323,6 +326,16 @@ void mm_memdump(FAR struct mm_heap_s *heap,
 
   mm_foreach(heap, memdump_handler, &priv);
 
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (heap->mm_arena[i] != NULL)
+        {
+          mm_foreach(heap->mm_arena[i], memdump_handler, &priv);
+        }
+    }
+#endif
+
 #if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
   if (pid == PID_MM_BIGGEST)
     {
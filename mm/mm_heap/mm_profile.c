@@ -0,0 +1,337 @@
+/****************************************************************************
+ * mm/mm_heap/mm_profile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The live samples are kept in a set associative table indexed by the
+ * hash of their address.  The entries never move, so a free() can look
+ * for its address without taking the lock.
+ */
+
+#define PROFILE_NWAYS     4
+#define PROFILE_NSETS     ((CONFIG_MM_HEAP_PROFILE_NSAMPLES + \
+                            PROFILE_NWAYS - 1) / PROFILE_NWAYS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mm_profile_sample_s
+{
+  FAR void *mem;                       /* The sampled allocation or NULL */
+  size_t size;                         /* Size of the sampled allocation */
+  FAR struct mm_profile_site_s *site;  /* Call site of the allocation */
+};
+
+struct mm_profile_s
+{
+  spinlock_t lock;                     /* Protects the tables below */
+  uint32_t seed;                       /* Random sampling interval */
+  size_t nlive;                        /* Number of the live samples */
+  int nsites;                          /* Number of the used sites */
+  ssize_t countdown[CONFIG_SMP_NCPUS]; /* Bytes until the next sample */
+  struct mm_profile_sample_s samples[PROFILE_NSETS][PROFILE_NWAYS];
+  struct mm_profile_site_s sites[CONFIG_MM_HEAP_PROFILE_NSITES];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_profile_s g_mm_profile;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_set
+ *
+ * Description:
+ *   Return the set of the sample table that an address belongs to.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_profile_sample_s *profile_set(FAR void *mem)
+{
+  uint32_t hash = (uint32_t)((uintptr_t)mem / MM_ALIGN) * 2654435761u;
+
+  return g_mm_profile.samples[hash % PROFILE_NSETS];
+}
+
+/****************************************************************************
+ * Name: profile_interval
+ *
+ * Description:
+ *   Return a random number of bytes until the next sample, uniformly
+ *   distributed around CONFIG_MM_HEAP_PROFILE_INTERVAL.  The lock must be
+ *   held.
+ *
+ ****************************************************************************/
+
+static ssize_t profile_interval(void)
+{
+  uint32_t x = g_mm_profile.seed;
+
+  /* xorshift32, the seed must never become zero */
+
+  if (x == 0)
+    {
+      x = 0x9e3779b9;
+    }
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  g_mm_profile.seed = x;
+
+  return 1 + x % (2 * CONFIG_MM_HEAP_PROFILE_INTERVAL);
+}
+
+/****************************************************************************
+ * Name: profile_site
+ *
+ * Description:
+ *   Find the site of a call stack or allocate a new one.  NULL is returned
+ *   if the site table is full.  The lock must be held.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_profile_site_s *
+profile_site(uint32_t hash, FAR void * const *stack, int depth)
+{
+  FAR struct mm_profile_site_s *site;
+  int i;
+
+  for (i = 0; i < g_mm_profile.nsites; i++)
+    {
+      site = &g_mm_profile.sites[i];
+      if (site->hash == hash && site->depth == depth &&
+          memcmp(site->stack, stack, depth * sizeof(FAR void *)) == 0)
+        {
+          return site;
+        }
+    }
+
+  if (g_mm_profile.nsites >= CONFIG_MM_HEAP_PROFILE_NSITES)
+    {
+      return NULL;
+    }
+
+  site        = &g_mm_profile.sites[g_mm_profile.nsites++];
+  site->hash  = hash;
+  site->depth = depth;
+  memcpy(site->stack, stack, depth * sizeof(FAR void *));
+  return site;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_alloc
+ *
+ * Description:
+ *   Account an allocation to the sampling profiler.  A sample is taken
+ *   each time the per-CPU count of allocated bytes runs below zero, so
+ *   large allocations are more likely to be sampled than small ones.
+ *
+ * Input Parameters:
+ *   mem  - The allocated memory
+ *   size - The usable size of the allocation
+ *
+ ****************************************************************************/
+
+void mm_profile_alloc(FAR void *mem, size_t size)
+{
+  FAR struct mm_profile_sample_s *sample;
+  FAR struct mm_profile_site_s *site;
+  FAR void *stack[CONFIG_MM_HEAP_PROFILE_DEPTH];
+  irqstate_t flags;
+  uint32_t hash;
+  pid_t pid;
+  int depth;
+  int i;
+
+  /* Count down without any lock, a lost update only moves the next sample
+   * by a few bytes.
+   */
+
+  g_mm_profile.countdown[this_cpu()] -= size;
+  if (g_mm_profile.countdown[this_cpu()] > 0)
+    {
+      return;
+    }
+
+  /* The call stack can't be taken in the interrupt handler nor during the
+   * context switch, so let the next allocation take the sample.
+   */
+
+  pid = _SCHED_GETTID();
+  if (pid < 0 || up_interrupt_context())
+    {
+      return;
+    }
+
+  depth = sched_backtrace(pid, stack, CONFIG_MM_HEAP_PROFILE_DEPTH,
+                          CONFIG_MM_HEAP_PROFILE_SKIP);
+  if (depth < 0)
+    {
+      depth = 0;
+    }
+
+  /* FNV-1a hash of the call stack */
+
+  hash = 2166136261u;
+  for (i = 0; i < depth; i++)
+    {
+      hash = (hash ^ (uint32_t)(uintptr_t)stack[i]) * 16777619u;
+    }
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+
+  g_mm_profile.countdown[this_cpu()] = profile_interval();
+
+  /* Find a free entry in the set of the address */
+
+  sample = profile_set(mem);
+  for (i = 0; i < PROFILE_NWAYS && sample->mem != NULL; i++)
+    {
+      sample++;
+    }
+
+  site = profile_site(hash, stack, depth);
+  if (i < PROFILE_NWAYS && site != NULL)
+    {
+      site->inuse_objs++;
+      site->inuse_bytes += size;
+      site->alloc_objs++;
+      site->alloc_bytes += size;
+
+      sample->size = size;
+      sample->site = site;
+      sample->mem  = mem;
+      g_mm_profile.nlive++;
+    }
+
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_profile_free
+ *
+ * Description:
+ *   Remove an allocation from the live samples if it has been sampled.
+ *
+ * Input Parameters:
+ *   mem - The memory about to be freed
+ *
+ ****************************************************************************/
+
+void mm_profile_free(FAR void *mem)
+{
+  FAR struct mm_profile_sample_s *sample;
+  irqstate_t flags;
+  int i;
+
+  if (g_mm_profile.nlive == 0)
+    {
+      return;
+    }
+
+  /* Only the owner of the memory can add or remove its entry, so there is
+   * no need to lock for the lookup.
+   */
+
+  sample = profile_set(mem);
+  for (i = 0; i < PROFILE_NWAYS; i++, sample++)
+    {
+      if (sample->mem == mem)
+        {
+          flags = spin_lock_irqsave(&g_mm_profile.lock);
+
+          sample->site->inuse_objs--;
+          sample->site->inuse_bytes -= sample->size;
+          sample->mem = NULL;
+          g_mm_profile.nlive--;
+
+          spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_profile_site
+ *
+ * Description:
+ *   Get a snapshot of one call site of the heap profiler.
+ *
+ * Input Parameters:
+ *   index - The index of the site, starting from zero
+ *   site  - The location to return the site
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if there is no such site.
+ *
+ ****************************************************************************/
+
+int mm_profile_site(int index, FAR struct mm_profile_site_s *site)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+  if (index >= 0 && index < g_mm_profile.nsites)
+    {
+      memcpy(site, &g_mm_profile.sites[index], sizeof(*site));
+      ret = OK;
+    }
+
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+  return ret;
+}
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
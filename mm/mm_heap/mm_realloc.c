@@ -76,6 +76,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   size_t prevsize = 0;
   size_t nextsize = 0;
   FAR void *newmem;
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  FAR struct mm_heap_s *arena;
+#endif
 
   /* If oldmem is NULL, then realloc is equivalent to malloc */
 
@@ -110,6 +113,28 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
     }
 #endif
 
+#if CONFIG_MM_HEAP_ARENA_SIZE > 0
+  arena = mm_arena_find(heap, oldmem);
+  if (arena != NULL)
+    {
+      newmem = mm_realloc(arena, oldmem, size);
+      if (newmem == NULL)
+        {
+          /* The arena is full, move the memory out of it */
+
+          newmem = mm_malloc(heap, size);
+          if (newmem != NULL)
+            {
+              memcpy(newmem, oldmem,
+                     MIN(size, mm_malloc_size(arena, oldmem)));
+              mm_free(arena, oldmem);
+            }
+        }
+
+      return newmem;
+    }
+#endif
+
   /* Adjust the size to account for (1) the size of the allocated node and
    * (2) to make sure that it is aligned with MM_ALIGN and its size is at
    * least MM_MIN_CHUNK.
@@ -161,6 +186,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, oldnode);
+      mm_profile_free(kasan_clear_tag(oldmem));
+      mm_profile_alloc(kasan_clear_tag(oldmem),
+                       MM_SIZEOF_NODE(oldnode) - MM_ALLOCNODE_OVERHEAD);
 
       return oldmem;
     }
@@ -392,6 +420,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size = MM_SIZEOF_NODE(oldnode);
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, (FAR char *)newmem - MM_SIZEOF_ALLOCNODE);
+      mm_profile_free(kasan_clear_tag(oldmem));
+      mm_profile_alloc(newmem, size - MM_ALLOCNODE_OVERHEAD);
 
       newmem = kasan_unpoison(newmem, size - MM_ALLOCNODE_OVERHEAD);
 
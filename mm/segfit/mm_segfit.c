@@ -0,0 +1,2265 @@
+/****************************************************************************
+ * mm/segfit/mm_segfit.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <unistd.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+#include <execinfo.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/lib/math32.h>
+#include <nuttx/mutex.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/kasan.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/sched_note.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0
+#  define MEMPOOL_NPOOLS (CONFIG_MM_HEAP_MEMPOOL_THRESHOLD / MM_ALIGN)
+#endif
+
+#define SEGFIT_MASK          (MM_ALIGN - 1)
+#define SEGFIT_ALIGN_UP(a)   (((a) + SEGFIT_MASK) & ~SEGFIT_MASK)
+#define SEGFIT_ALIGN_DOWN(a) ((a) & ~SEGFIT_MASK)
+
+/* The size classes form a two level index.  The first level splits the
+ * sizes into powers of two, the second level splits each power of two into
+ * SEGFIT_SL_COUNT linear classes.  All the sizes below SEGFIT_SMALL_SIZE
+ * live in the first level 0 whose classes are MM_ALIGN bytes apart.
+ */
+
+#define SEGFIT_SL_SHIFT      3
+#define SEGFIT_SL_COUNT      (1 << SEGFIT_SL_SHIFT)
+#define SEGFIT_ALIGN_SHIFT   LOG2_CEIL(MM_ALIGN)
+#define SEGFIT_SMALL_SHIFT   (SEGFIT_SL_SHIFT + SEGFIT_ALIGN_SHIFT)
+#define SEGFIT_SMALL_SIZE    (1 << SEGFIT_SMALL_SHIFT)
+#define SEGFIT_FL_COUNT      (32 - SEGFIT_SMALL_SHIFT + 1)
+
+/* The first level bitmap is 32 bits wide, so one node can't reach 4GB */
+
+#define SEGFIT_MAX_SIZE      SEGFIT_ALIGN_DOWN((size_t)UINT32_MAX)
+
+/* The lowest bit of the size field tells whether the node is allocated */
+
+#define SEGFIT_ALLOC         ((size_t)1)
+#define SEGFIT_SIZE(n)       ((n)->size & ~SEGFIT_ALLOC)
+#define SEGFIT_IS_ALLOC(n)   (((n)->size & SEGFIT_ALLOC) != 0)
+
+#define SEGFIT_HDRSIZE       SEGFIT_ALIGN_UP(2 * sizeof(size_t))
+#define SEGFIT_MINSIZE       SEGFIT_ALIGN_UP(sizeof(struct segfit_node_s))
+
+#if CONFIG_MM_BACKTRACE >= 0
+#  define SEGFIT_OVERHEAD    (SEGFIT_HDRSIZE + \
+                              sizeof(struct memdump_backtrace_s))
+#else
+#  define SEGFIT_OVERHEAD    SEGFIT_HDRSIZE
+#endif
+
+#define SEGFIT_PAYLOAD(n)    ((FAR void *)((FAR char *)(n) + SEGFIT_HDRSIZE))
+#define SEGFIT_NODE(p)       ((FAR struct segfit_node_s *) \
+                              ((FAR char *)(p) - SEGFIT_HDRSIZE))
+#define SEGFIT_NEXT(n)       ((FAR struct segfit_node_s *) \
+                              ((FAR char *)(n) + SEGFIT_SIZE(n)))
+#define SEGFIT_PREV(n)       ((FAR struct segfit_node_s *) \
+                              ((FAR char *)(n) - (n)->preceding))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Every node starts with the sizes of itself and of its physical
+ * predecessor (boundary tags) so that the neighbours can be merged in
+ * constant time.  The list links are only valid while the node is free.
+ */
+
+struct segfit_node_s
+{
+  size_t preceding;                     /* Size of the preceding node */
+  size_t size;                          /* Size of this node | SEGFIT_ALLOC */
+  FAR struct segfit_node_s *flink;      /* Next free node of the class */
+  FAR struct segfit_node_s *blink;      /* Previous free node of the class */
+};
+
+typedef CODE void (*segfit_handler_t)(FAR struct segfit_node_s *node,
+                                      FAR void *arg);
+
+struct mm_delaynode_s
+{
+  FAR struct mm_delaynode_s *flink;
+};
+
+struct mm_heap_s
+{
+  /* Mutually exclusive access to this data set is enforced with
+   * the following un-named mutex.
+   */
+
+  mutex_t mm_lock;
+
+  /* This is the size of the heap provided to mm */
+
+  size_t mm_heapsize;
+
+  /* This is the heap maximum used memory size */
+
+  size_t mm_maxused;
+
+  /* This is the current used size of the heap */
+
+  size_t mm_curused;
+
+  /* This is the first and last guard node of each region */
+
+  FAR struct segfit_node_s *mm_heapstart[CONFIG_MM_REGIONS];
+  FAR struct segfit_node_s *mm_heapend[CONFIG_MM_REGIONS];
+
+#if CONFIG_MM_REGIONS > 1
+  int mm_nregions;
+#endif
+
+  /* The free lists of each size class and the bitmaps of the non-empty
+   * classes.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[SEGFIT_FL_COUNT];
+  FAR struct segfit_node_s *mm_freelist[SEGFIT_FL_COUNT][SEGFIT_SL_COUNT];
+
+  /* The is a multiple mempool of the heap */
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  size_t                         mm_threshold;
+  FAR struct mempool_multiple_s *mm_mpool;
+#endif
+
+  /* Free delay list, for some situation can't do free immediately */
+
+  struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
+
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  size_t mm_delaycount[CONFIG_SMP_NCPUS];
+#endif
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+  struct procfs_meminfo_entry_s mm_procfs;
+#endif
+
+  /* Kasan is disable or enable for this heap */
+
+  bool mm_nokasan;
+};
+
+#if CONFIG_MM_BACKTRACE >= 0
+struct memdump_backtrace_s
+{
+  pid_t pid;                                /* The pid for caller */
+  unsigned long seqno;                      /* The sequence of memory malloc */
+#if CONFIG_MM_BACKTRACE > 0
+  FAR void *backtrace[CONFIG_MM_BACKTRACE]; /* The backtrace buffer for caller */
+#endif
+};
+#endif
+
+struct mm_mallinfo_handler_s
+{
+  FAR const struct malltask *task;
+  FAR struct mallinfo_task *info;
+};
+
+#if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
+struct mm_segfit_biggest_s
+{
+  FAR void *ptr;
+  size_t size;
+};
+#endif
+
+struct mm_memdump_priv_s
+{
+  FAR const struct mm_memdump_s *dump;
+  struct mallinfo_task info;
+#if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
+  struct mm_segfit_biggest_s node[CONFIG_MM_HEAP_BIGGEST_COUNT];
+  size_t filled;
+#endif
+};
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+static inline_function
+void memdump_info_pool(FAR struct mm_memdump_priv_s *priv,
+                       FAR struct mm_heap_s *heap)
+{
+  priv->info = mempool_multiple_info_task(heap->mm_mpool, priv->dump);
+}
+
+static inline_function
+void memdump_dump_pool(FAR struct mm_memdump_priv_s *priv,
+                       FAR struct mm_heap_s *heap)
+{
+  if (priv->info.aordblks > 0)
+    {
+      mempool_multiple_memdump(heap->mm_mpool, priv->dump);
+    }
+}
+#else
+#  define memdump_info_pool(priv,heap)
+#  define memdump_dump_pool(priv,heap)
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void mm_delayfree(struct mm_heap_s *heap, void *mem, bool delay);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: segfit_mapping
+ *
+ * Description:
+ *   Return the size class that a free node of the given size belongs to.
+ *
+ ****************************************************************************/
+
+static inline_function void segfit_mapping(size_t size, FAR int *fl,
+                                           FAR int *sl)
+{
+  if (size < SEGFIT_SMALL_SIZE)
+    {
+      *fl = 0;
+      *sl = size >> SEGFIT_ALIGN_SHIFT;
+    }
+  else
+    {
+      int bit = flsl(size) - 1;
+
+      *fl = bit - SEGFIT_SMALL_SHIFT + 1;
+      *sl = (size >> (bit - SEGFIT_SL_SHIFT)) - SEGFIT_SL_COUNT;
+    }
+}
+
+/****************************************************************************
+ * Name: segfit_insert
+ *
+ * Description:
+ *   Add a free node to the head of the list of its size class.
+ *
+ ****************************************************************************/
+
+static void segfit_insert(FAR struct mm_heap_s *heap,
+                          FAR struct segfit_node_s *node)
+{
+  FAR struct segfit_node_s *head;
+  int fl;
+  int sl;
+
+  segfit_mapping(node->size, &fl, &sl);
+
+  head        = heap->mm_freelist[fl][sl];
+  node->blink = NULL;
+  node->flink = head;
+  if (head != NULL)
+    {
+      head->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_flbitmap        |= 1u << fl;
+  heap->mm_slbitmap[fl]    |= 1u << sl;
+}
+
+/****************************************************************************
+ * Name: segfit_remove
+ *
+ * Description:
+ *   Remove a free node from the list of its size class.
+ *
+ ****************************************************************************/
+
+static void segfit_remove(FAR struct mm_heap_s *heap,
+                          FAR struct segfit_node_s *node)
+{
+  int fl;
+  int sl;
+
+  if (node->flink != NULL)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  if (node->blink != NULL)
+    {
+      node->blink->flink = node->flink;
+      return;
+    }
+
+  segfit_mapping(node->size, &fl, &sl);
+
+  heap->mm_freelist[fl][sl] = node->flink;
+  if (node->flink == NULL)
+    {
+      heap->mm_slbitmap[fl] &= ~(1u << sl);
+      if (heap->mm_slbitmap[fl] == 0)
+        {
+          heap->mm_flbitmap &= ~(1u << fl);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: segfit_search
+ *
+ * Description:
+ *   Find a free node of at least the given size.  The size is rounded up to
+ *   the next class boundary so that the head of every class found through
+ *   the bitmaps is large enough and no list needs to be walked.  Only when
+ *   that fails, the class of the size itself is searched for a node that
+ *   happens to be large enough.
+ *
+ ****************************************************************************/
+
+static FAR struct segfit_node_s *
+segfit_search(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct segfit_node_s *node;
+  size_t round = 0;
+  uint32_t map;
+  int fl;
+  int sl;
+
+  if (size >= SEGFIT_SMALL_SIZE)
+    {
+      round = ((size_t)1 << (flsl(size) - 1 - SEGFIT_SL_SHIFT)) - 1;
+    }
+
+  if (size <= SEGFIT_MAX_SIZE - round)
+    {
+      segfit_mapping(size + round, &fl, &sl);
+
+      map = heap->mm_slbitmap[fl] & (UINT32_MAX << sl);
+      if (map == 0)
+        {
+          map = heap->mm_flbitmap & (UINT32_MAX << (fl + 1));
+          if (map != 0)
+            {
+              fl  = ffs(map) - 1;
+              map = heap->mm_slbitmap[fl];
+            }
+        }
+
+      if (map != 0)
+        {
+          sl = ffs(map) - 1;
+          return heap->mm_freelist[fl][sl];
+        }
+    }
+
+  segfit_mapping(size, &fl, &sl);
+
+  for (node = heap->mm_freelist[fl][sl]; node != NULL; node = node->flink)
+    {
+      if (node->size >= size)
+        {
+          return node;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: segfit_release
+ *
+ * Description:
+ *   Merge a node that is no longer in use with its free neighbours and put
+ *   the result back to the free lists.  The node must already be marked as
+ *   free.
+ *
+ ****************************************************************************/
+
+static void segfit_release(FAR struct mm_heap_s *heap,
+                           FAR struct segfit_node_s *node)
+{
+  FAR struct segfit_node_s *next = SEGFIT_NEXT(node);
+  FAR struct segfit_node_s *prev = SEGFIT_PREV(node);
+  size_t size = node->size;
+
+  if (!SEGFIT_IS_ALLOC(next))
+    {
+      segfit_remove(heap, next);
+      size += next->size;
+    }
+
+  if (!SEGFIT_IS_ALLOC(prev))
+    {
+      segfit_remove(heap, prev);
+      size += prev->size;
+      node  = prev;
+    }
+
+  node->size = size;
+  SEGFIT_NEXT(node)->preceding = size;
+  segfit_insert(heap, node);
+}
+
+/****************************************************************************
+ * Name: segfit_split
+ *
+ * Description:
+ *   Shrink an allocated node to the given size and release the remainder
+ *   if it is big enough to form a node of its own.
+ *
+ ****************************************************************************/
+
+static void segfit_split(FAR struct mm_heap_s *heap,
+                         FAR struct segfit_node_s *node, size_t size)
+{
+  size_t remain = SEGFIT_SIZE(node) - size;
+  FAR struct segfit_node_s *next;
+
+  if (remain >= SEGFIT_MINSIZE)
+    {
+      node->size      = size | SEGFIT_ALLOC;
+      next            = SEGFIT_NEXT(node);
+      next->preceding = size;
+      next->size      = remain;
+      SEGFIT_NEXT(next)->preceding = remain;
+      segfit_release(heap, next);
+    }
+}
+
+/****************************************************************************
+ * Name: segfit_allocate
+ *
+ * Description:
+ *   Take a node of exactly the given size out of the free lists.
+ *
+ ****************************************************************************/
+
+static FAR struct segfit_node_s *
+segfit_allocate(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct segfit_node_s *node = segfit_search(heap, size);
+
+  if (node != NULL)
+    {
+      segfit_remove(heap, node);
+      node->size |= SEGFIT_ALLOC;
+      segfit_split(heap, node, size);
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: segfit_nodesize
+ *
+ * Description:
+ *   Convert a request size to the node size, zero if it can't be served.
+ *
+ ****************************************************************************/
+
+static size_t segfit_nodesize(size_t size)
+{
+  if (size > SEGFIT_MAX_SIZE - SEGFIT_OVERHEAD - MM_ALIGN)
+    {
+      return 0;
+    }
+
+  size = SEGFIT_ALIGN_UP(size + SEGFIT_OVERHEAD);
+  return MAX(size, SEGFIT_MINSIZE);
+}
+
+/****************************************************************************
+ * Name: segfit_foreach
+ *
+ * Description:
+ *   Visit every node of one region, the guard nodes excluded.
+ *
+ ****************************************************************************/
+
+static void segfit_foreach(FAR struct mm_heap_s *heap, int region,
+                           segfit_handler_t handler, FAR void *arg)
+{
+  FAR struct segfit_node_s *node;
+
+  for (node = SEGFIT_NEXT(heap->mm_heapstart[region]);
+       node < heap->mm_heapend[region];
+       node = SEGFIT_NEXT(node))
+    {
+      handler(node, arg);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_lock_irq
+ *
+ * Description:
+ *   Locking by pausing interruption
+ *
+ ****************************************************************************/
+
+static irqstate_t mm_lock_irq(FAR struct mm_heap_s *heap)
+{
+  UNUSED(heap);
+  return up_irq_save();
+}
+
+/****************************************************************************
+ * Name: mm_unlock_irq
+ *
+ * Description:
+ *   Release the lock by resuming the interrupt
+ *
+ ****************************************************************************/
+
+static void mm_unlock_irq(FAR struct mm_heap_s *heap, irqstate_t state)
+{
+  UNUSED(heap);
+  up_irq_restore(state);
+}
+
+static void memdump_allocnode(FAR void *ptr, size_t size)
+{
+#if CONFIG_MM_BACKTRACE < 0
+  syslog(LOG_INFO, "%12zu%*p\n", size, BACKTRACE_PTR_FMT_WIDTH, ptr);
+
+#elif CONFIG_MM_BACKTRACE == 0
+  FAR struct memdump_backtrace_s *buf =
+    ptr + size - sizeof(struct memdump_backtrace_s);
+
+  syslog(LOG_INFO, "%6d%12zu"
+#  ifdef CONFIG_MM_BACKTRACE_SEQNO
+         "%12lu"
+#  endif
+         "%*p\n",
+         buf->pid, size,
+#  ifdef CONFIG_MM_BACKTRACE_SEQNO
+         buf->seqno,
+#  endif
+         BACKTRACE_PTR_FMT_WIDTH, ptr);
+#else
+  char tmp[BACKTRACE_BUFFER_SIZE(CONFIG_MM_BACKTRACE)];
+  FAR struct memdump_backtrace_s *buf =
+    ptr + size - sizeof(struct memdump_backtrace_s);
+
+  backtrace_format(tmp, sizeof(tmp), buf->backtrace,
+                   CONFIG_MM_BACKTRACE);
+
+  syslog(LOG_INFO, "%6d%12zu"
+#  ifdef CONFIG_MM_BACKTRACE_SEQNO
+         "%12lu"
+#  endif
+         "%*p %s\n",
+         buf->pid, size,
+#  ifdef CONFIG_MM_BACKTRACE_SEQNO
+         buf->seqno,
+#  endif
+         BACKTRACE_PTR_FMT_WIDTH,
+         ptr, tmp);
+#endif
+}
+
+#if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
+static int memdump_record_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct mm_segfit_biggest_s *node_a = a;
+  FAR const struct mm_segfit_biggest_s *node_b = b;
+  size_t size_a = node_a->size;
+  size_t size_b = node_b->size;
+  return size_a > size_b ? 1 : -1;
+}
+
+static void memdump_record_biggest(FAR struct mm_memdump_priv_s *priv,
+                                   FAR void *ptr, size_t size)
+{
+  if (priv->filled < CONFIG_MM_HEAP_BIGGEST_COUNT)
+    {
+      priv->node[priv->filled].ptr  = ptr;
+      priv->node[priv->filled].size = size;
+      priv->filled++;
+    }
+  else
+    {
+      if (size <= priv->node[0].size)
+        {
+          return;
+        }
+
+      priv->node[0].ptr  = ptr;
+      priv->node[0].size = size;
+    }
+
+  if (priv->filled > 1)
+    {
+      qsort(priv->node, priv->filled, sizeof(struct mm_segfit_biggest_s),
+            memdump_record_compare);
+    }
+}
+
+static void memdump_dump_biggestnodes(FAR struct mm_memdump_priv_s *priv)
+{
+  size_t i;
+  for (i = 0; i < priv->filled; i++)
+    {
+      priv->info.uordblks += priv->node[i].size;
+      memdump_allocnode(priv->node[i].ptr, priv->node[i].size);
+    }
+
+  priv->info.aordblks = priv->filled;
+}
+
+#endif
+
+#if CONFIG_MM_BACKTRACE >= 0
+
+/****************************************************************************
+ * Name: memdump_backtrace
+ ****************************************************************************/
+
+static void memdump_backtrace(FAR struct mm_heap_s *heap,
+                              FAR struct memdump_backtrace_s *buf)
+{
+#  if CONFIG_MM_BACKTRACE > 0
+  FAR struct tcb_s *tcb;
+#  endif
+
+  buf->pid = _SCHED_GETTID();
+  MM_INCSEQNO(buf);
+#  if CONFIG_MM_BACKTRACE > 0
+  tcb = nxsched_get_tcb(buf->pid);
+  if (heap->mm_procfs.backtrace ||
+      (tcb && tcb->flags & TCB_FLAG_HEAP_DUMP))
+    {
+      int ret = sched_backtrace(buf->pid, buf->backtrace,
+                                CONFIG_MM_BACKTRACE,
+                                CONFIG_MM_BACKTRACE_SKIP);
+      if (ret < CONFIG_MM_BACKTRACE)
+        {
+          buf->backtrace[ret] = NULL;
+        }
+    }
+#  endif
+}
+#endif
+
+/****************************************************************************
+ * Name: add_delaylist
+ ****************************************************************************/
+
+static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *tmp = mem;
+  irqstate_t flags;
+
+  /* Delay the deallocation until a more appropriate time. */
+
+  flags = mm_lock_irq(heap);
+
+  tmp->flink = heap->mm_delaylist[this_cpu()];
+  heap->mm_delaylist[this_cpu()] = tmp;
+
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  heap->mm_delaycount[this_cpu()]++;
+#endif
+
+  mm_unlock_irq(heap, flags);
+#endif
+}
+
+/****************************************************************************
+ * Name: free_delaylist
+ ****************************************************************************/
+
+static bool free_delaylist(FAR struct mm_heap_s *heap, bool force)
+{
+  bool ret = false;
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *tmp;
+  irqstate_t flags;
+
+  /* Move the delay list to local */
+
+  flags = mm_lock_irq(heap);
+
+  tmp = heap->mm_delaylist[this_cpu()];
+
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  if (tmp == NULL ||
+      (!force &&
+        heap->mm_delaycount[this_cpu()] < CONFIG_MM_FREE_DELAYCOUNT_MAX))
+    {
+      mm_unlock_irq(heap, flags);
+      return false;
+    }
+
+  heap->mm_delaycount[this_cpu()] = 0;
+#endif
+
+  heap->mm_delaylist[this_cpu()] = NULL;
+
+  mm_unlock_irq(heap, flags);
+
+  /* Test if the delayed is empty */
+
+  ret = tmp != NULL;
+
+  while (tmp)
+    {
+      FAR void *address;
+
+      /* Get the first delayed deallocation */
+
+      address = tmp;
+      tmp = tmp->flink;
+
+      /* The address should always be non-NULL since that was checked in the
+       * 'while' condition above.
+       */
+
+      mm_delayfree(heap, address, false);
+    }
+
+#endif
+  return ret;
+}
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL) && CONFIG_MM_BACKTRACE >= 0
+
+/****************************************************************************
+ * Name: mempool_memalign
+ *
+ * Description:
+ *   This function call mm_memalign and set mm_backtrace pid to free pid
+ *   avoid repeated calculation.
+ ****************************************************************************/
+
+static FAR void *mempool_memalign(FAR void *arg, size_t alignment,
+                                  size_t size)
+{
+  FAR struct memdump_backtrace_s *buf;
+  FAR void *ret;
+
+  ret = mm_memalign(arg, alignment, size);
+  if (ret)
+    {
+      buf = ret + mm_malloc_size(arg, ret);
+      buf->pid = PID_MM_MEMPOOL;
+    }
+
+  return ret;
+}
+#else
+#  define mempool_memalign mm_memalign
+#endif
+
+/****************************************************************************
+ * Name: mallinfo_handler
+ ****************************************************************************/
+
+static void mallinfo_handler(FAR struct segfit_node_s *node, FAR void *arg)
+{
+  FAR struct mallinfo *info = arg;
+  size_t size = SEGFIT_SIZE(node);
+
+  if (!SEGFIT_IS_ALLOC(node))
+    {
+      info->ordblks++;
+      info->fordblks += size;
+      if (size > info->mxordblk)
+        {
+          info->mxordblk = size;
+        }
+    }
+  else
+    {
+      info->aordblks++;
+    }
+}
+
+/****************************************************************************
+ * Name: mallinfo_task_handler
+ ****************************************************************************/
+
+static void mallinfo_task_handler(FAR struct segfit_node_s *node,
+                                  FAR void *arg)
+{
+  FAR struct mm_mallinfo_handler_s *handler = arg;
+  FAR const struct malltask *task = handler->task;
+  FAR struct mallinfo_task *info = handler->info;
+  size_t size = SEGFIT_SIZE(node);
+
+  if (SEGFIT_IS_ALLOC(node))
+    {
+#if CONFIG_MM_BACKTRACE >= 0
+      FAR struct memdump_backtrace_s *buf = (FAR void *)
+        ((FAR char *)node + size - sizeof(struct memdump_backtrace_s));
+#else
+#  define buf NULL
+#endif
+
+      if ((MM_DUMP_ASSIGN(task, buf) || MM_DUMP_ALLOC(task, buf) ||
+           MM_DUMP_LEAK(task, buf)) && MM_DUMP_SEQNO(task, buf))
+        {
+          info->aordblks++;
+          info->uordblks += size;
+        }
+#undef buf
+    }
+  else if (task->pid == PID_MM_FREE)
+    {
+      info->aordblks++;
+      info->uordblks += size;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_lock
+ *
+ * Description:
+ *   Take the MM mutex. This may be called from the OS in certain conditions
+ *   when it is impossible to wait on a mutex:
+ *     1.The idle process performs the memory corruption check.
+ *     2.The task/thread free the memory in the exiting process.
+ *
+ * Input Parameters:
+ *   heap  - heap instance want to take mutex
+ *
+ * Returned Value:
+ *   0 if the lock can be taken, otherwise negative errno.
+ *
+ ****************************************************************************/
+
+static int mm_lock(FAR struct mm_heap_s *heap)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  /* Check current environment */
+
+  if (up_interrupt_context())
+    {
+#if !defined(CONFIG_SMP)
+      /* Check the mutex value, if held by someone, then return false.
+       * Or, touch the heap internal data directly.
+       */
+
+      return nxmutex_is_locked(&heap->mm_lock) ? -EAGAIN : 0;
+#else
+      /* Can't take mutex in SMP interrupt handler */
+
+      return -EAGAIN;
+#endif
+    }
+  else
+#endif
+
+  /* _SCHED_GETTID() returns the task ID of the task at the head of the
+   * ready-to-run task list.  mm_lock() may be called during context
+   * switches.  There are certain situations during context switching when
+   * the OS data structures are in flux and then can't be freed immediately
+   * (e.g. the running thread stack).
+   *
+   * This is handled by _SCHED_GETTID() to return the special value
+   * -ESRCH to indicate this special situation.
+   */
+
+  if (_SCHED_GETTID() < 0)
+    {
+      return -ESRCH;
+    }
+  else
+    {
+      return nxmutex_lock(&heap->mm_lock);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_unlock
+ *
+ * Description:
+ *   Release the MM mutex when it is not longer needed.
+ *
+ ****************************************************************************/
+
+static void mm_unlock(FAR struct mm_heap_s *heap)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  if (up_interrupt_context())
+    {
+      return;
+    }
+#endif
+
+  DEBUGVERIFY(nxmutex_unlock(&heap->mm_lock));
+}
+
+/****************************************************************************
+ * Name: memdump_handler
+ ****************************************************************************/
+
+static void memdump_handler(FAR struct segfit_node_s *node, FAR void *arg)
+{
+  FAR struct mm_memdump_priv_s *priv = arg;
+  FAR const struct mm_memdump_s *dump = priv->dump;
+  FAR void *ptr = SEGFIT_PAYLOAD(node);
+  size_t size = SEGFIT_SIZE(node) - SEGFIT_HDRSIZE;
+
+  if (SEGFIT_IS_ALLOC(node))
+    {
+#if CONFIG_MM_BACKTRACE >= 0
+      FAR struct memdump_backtrace_s *buf =
+        ptr + size - sizeof(struct memdump_backtrace_s);
+#else
+#  define buf NULL
+#endif
+      if ((MM_DUMP_ASSIGN(dump, buf) || MM_DUMP_ALLOC(dump, buf) ||
+           MM_DUMP_LEAK(dump, buf)) && MM_DUMP_SEQNO(dump, buf))
+        {
+          priv->info.aordblks++;
+          priv->info.uordblks += size;
+          memdump_allocnode(ptr, size);
+        }
+#if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
+      else if(dump->pid == PID_MM_BIGGEST && MM_DUMP_SEQNO(dump, buf))
+        {
+          memdump_record_biggest(priv, ptr, size);
+        }
+#endif
+#undef buf
+    }
+  else if (dump->pid == PID_MM_FREE)
+    {
+      priv->info.aordblks++;
+      priv->info.uordblks += size;
+      syslog(LOG_INFO, "%12zu%*p\n", size, BACKTRACE_PTR_FMT_WIDTH, ptr);
+    }
+}
+
+#ifdef CONFIG_DEBUG_MM
+/****************************************************************************
+ * Name: checkcorruption_handler
+ ****************************************************************************/
+
+static void checkcorruption_handler(FAR struct segfit_node_s *node,
+                                    FAR void *arg)
+{
+  FAR struct segfit_node_s *prev = SEGFIT_PREV(node);
+
+  ASSERT(SEGFIT_SIZE(node) >= SEGFIT_MINSIZE);
+  ASSERT(SEGFIT_NEXT(prev) == node);
+
+  if (!SEGFIT_IS_ALLOC(node))
+    {
+      /* Free nodes are always merged with their neighbours */
+
+      ASSERT(SEGFIT_IS_ALLOC(prev));
+      ASSERT(SEGFIT_IS_ALLOC(SEGFIT_NEXT(node)));
+      ASSERT(node->flink == NULL || node->flink->blink == node);
+      ASSERT(node->blink == NULL || node->blink->flink == node);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_delayfree
+ *
+ * Description:
+ *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *
+ ****************************************************************************/
+
+static void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem,
+                         bool delay)
+{
+  if (mm_lock(heap) == 0)
+    {
+      FAR struct segfit_node_s *node = SEGFIT_NODE(mem);
+      size_t size = mm_malloc_size(heap, mem);
+      UNUSED(size);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  /* If delay free is enabled, a memory node will be freed twice.
+   * The first time is to add the node to the delay list, and the second
+   * time is to actually free the node. Therefore, we only colorize the
+   * memory node the first time, when `delay` is set to true.
+   */
+
+  if (delay)
+#endif
+    {
+      memset(mem, MM_FREE_MAGIC, size);
+    }
+#endif
+
+      kasan_poison(mem, size);
+
+      if (delay)
+        {
+          add_delaylist(heap, mem);
+        }
+      else
+        {
+          /* Update heap statistics */
+
+          DEBUGASSERT(SEGFIT_IS_ALLOC(node));
+          heap->mm_curused -= SEGFIT_SIZE(node);
+          sched_note_heap(NOTE_HEAP_FREE, heap, mem, size, heap->mm_curused);
+
+          /* Return the node to the free lists */
+
+          node->size &= ~SEGFIT_ALLOC;
+          segfit_release(heap, node);
+        }
+
+      mm_unlock(heap);
+    }
+  else
+    {
+      /* Add to the delay list(see the comment in mm_lock) */
+
+      add_delaylist(heap, mem);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_addregion
+ *
+ * Description:
+ *   This function adds a region of contiguous memory to the selected heap.
+ *
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   heapstart - Start of the heap region
+ *   heapsize  - Size of the heap region
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
+                  size_t heapsize)
+{
+  FAR struct segfit_node_s *node;
+  uintptr_t heapbase;
+  uintptr_t heapend;
+#if CONFIG_MM_REGIONS > 1
+  int idx;
+
+  idx = heap->mm_nregions;
+
+  /* Writing past CONFIG_MM_REGIONS would have catastrophic consequences */
+
+  DEBUGASSERT(idx < CONFIG_MM_REGIONS);
+  if (idx >= CONFIG_MM_REGIONS)
+    {
+      return;
+    }
+
+#else
+#  define idx 0
+#endif
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  /* Use the fill value to mark uninitialized user memory */
+
+  memset(heapstart, MM_INIT_MAGIC, heapsize);
+#endif
+
+  /* Register to KASan for access check */
+
+  if (!heap->mm_nokasan)
+    {
+      kasan_register(heapstart, &heapsize);
+    }
+
+  /* Adjust the provided heap start and size, a single region can't exceed
+   * the largest size class.
+   */
+
+  heapbase = SEGFIT_ALIGN_UP((uintptr_t)heapstart);
+  heapend  = SEGFIT_ALIGN_DOWN((uintptr_t)heapstart + heapsize);
+  heapsize = MIN(heapend - heapbase, SEGFIT_MAX_SIZE);
+  heapend  = heapbase + heapsize;
+
+  DEBUGASSERT(heapsize >= 2 * SEGFIT_HDRSIZE + SEGFIT_MINSIZE);
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  minfo("Region %d: base=%p size=%zu\n", idx + 1, heapstart, heapsize);
+
+  /* Add the size of this region to the total size of the heap */
+
+  heap->mm_heapsize += heapsize;
+
+  /* Create two "allocated" guard nodes at the beginning and end of the
+   * region.  They keep all the merge operations inside of the region.
+   */
+
+  heap->mm_heapstart[idx] = (FAR struct segfit_node_s *)heapbase;
+  heap->mm_heapstart[idx]->preceding = 0;
+  heap->mm_heapstart[idx]->size = SEGFIT_HDRSIZE | SEGFIT_ALLOC;
+
+  node            = SEGFIT_NEXT(heap->mm_heapstart[idx]);
+  node->preceding = SEGFIT_HDRSIZE;
+  node->size      = heapsize - 2 * SEGFIT_HDRSIZE;
+
+  heap->mm_heapend[idx] = SEGFIT_NEXT(node);
+  heap->mm_heapend[idx]->preceding = node->size;
+  heap->mm_heapend[idx]->size = SEGFIT_HDRSIZE | SEGFIT_ALLOC;
+
+  heap->mm_curused += 2 * SEGFIT_HDRSIZE;
+  heap->mm_maxused  = MAX(heap->mm_maxused, heap->mm_curused);
+
+#undef idx
+
+#if CONFIG_MM_REGIONS > 1
+  heap->mm_nregions++;
+#endif
+
+  /* Add the single, large free node to the free lists */
+
+  segfit_insert(heap, node);
+  sched_note_heap(NOTE_HEAP_ADD, heap, heapstart, heapsize,
+                  heap->mm_curused);
+  mm_unlock(heap);
+}
+
+/****************************************************************************
+ * Name: mm_brkaddr
+ *
+ * Description:
+ *   Return the break address of a heap region.  Zero is returned if the
+ *   memory region is not initialized.
+ *
+ ****************************************************************************/
+
+FAR void *mm_brkaddr(FAR struct mm_heap_s *heap, int region)
+{
+#if CONFIG_MM_REGIONS > 1
+  DEBUGASSERT(region >= 0 && region < heap->mm_nregions);
+#else
+  DEBUGASSERT(region == 0);
+#endif
+
+  return (FAR char *)heap->mm_heapend[region] + SEGFIT_HDRSIZE;
+}
+
+/****************************************************************************
+ * Name: mm_calloc
+ *
+ * Descriptor:
+ *   mm_calloc() calculates the size of the allocation and calls mm_zalloc()
+ *
+ ****************************************************************************/
+
+FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
+{
+  FAR void *mem = NULL;
+
+  /* Verify input parameters
+   *
+   * elem_size or n is zero treats as valid input.
+   *
+   * Assure that the following multiplication cannot overflow the size_t
+   * type, i.e., that:  SIZE_MAX >= n * elem_size
+   *
+   * Refer to SEI CERT C Coding Standard.
+   */
+
+  if (elem_size == 0 || n <= (SIZE_MAX / elem_size))
+    {
+      mem = mm_zalloc(heap, n * elem_size);
+    }
+
+  return mem;
+}
+
+#ifdef CONFIG_DEBUG_MM
+/****************************************************************************
+ * Name: mm_checkcorruption
+ *
+ * Description:
+ *   mm_checkcorruption is used to check whether memory heap is normal.
+ *
+ ****************************************************************************/
+
+void mm_checkcorruption(FAR struct mm_heap_s *heap)
+{
+  int fl;
+  int sl;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  free_delaylist(heap, true);
+
+  /* Visit each region */
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      /* Retake the mutex for each region to reduce latencies */
+
+      if (mm_lock(heap) < 0)
+        {
+          return;
+        }
+
+      /* Check the bitmaps against the free lists in the first pass */
+
+      if (region == 0)
+        {
+          for (fl = 0; fl < SEGFIT_FL_COUNT; fl++)
+            {
+              ASSERT(((heap->mm_flbitmap >> fl) & 1) ==
+                     (heap->mm_slbitmap[fl] != 0));
+
+              for (sl = 0; sl < SEGFIT_SL_COUNT; sl++)
+                {
+                  ASSERT(((heap->mm_slbitmap[fl] >> sl) & 1) ==
+                         (heap->mm_freelist[fl][sl] != NULL));
+                }
+            }
+        }
+
+      segfit_foreach(heap, region, checkcorruption_handler, NULL);
+      ASSERT(SEGFIT_NEXT(SEGFIT_PREV(heap->mm_heapend[region])) ==
+             heap->mm_heapend[region]);
+
+      /* Release the mutex */
+
+      mm_unlock(heap);
+    }
+#undef region
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_extend
+ *
+ * Description:
+ *   Extend a heap region by add a block of (virtually) contiguous memory
+ *   to the end of the heap.
+ *
+ ****************************************************************************/
+
+void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
+               int region)
+{
+  FAR struct segfit_node_s *node;
+  FAR struct segfit_node_s *end;
+
+  /* Make sure that we were passed valid parameters */
+
+#if CONFIG_MM_REGIONS > 1
+  DEBUGASSERT(region >= 0 && region < heap->mm_nregions);
+#else
+  DEBUGASSERT(region == 0);
+#endif
+  DEBUGASSERT(mem == mm_brkaddr(heap, region));
+
+  size = SEGFIT_ALIGN_DOWN(size);
+  DEBUGASSERT(size >= SEGFIT_MINSIZE);
+
+  /* Take the memory manager mutex */
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  DEBUGASSERT((uintptr_t)mem + size - (uintptr_t)heap->mm_heapstart[region]
+              <= SEGFIT_MAX_SIZE);
+
+  /* The old end guard becomes the new free node, followed by a new guard
+   * at the new end of the region.
+   */
+
+  node             = heap->mm_heapend[region];
+  node->size       = size;
+  end              = SEGFIT_NEXT(node);
+  end->preceding   = size;
+  end->size        = SEGFIT_HDRSIZE | SEGFIT_ALLOC;
+
+  heap->mm_heapend[region] = end;
+  heap->mm_heapsize       += size;
+
+  /* Merge the new memory with the last node of the region */
+
+  segfit_release(heap, node);
+  mm_unlock(heap);
+}
+
+/****************************************************************************
+ * Name: mm_free
+ *
+ * Description:
+ *   Returns a chunk of memory to the list of free nodes,  merging with
+ *   adjacent free chunks if possible.
+ *
+ ****************************************************************************/
+
+void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  minfo("Freeing %p\n", mem);
+
+  /* Protect against attempts to free a NULL reference */
+
+  if (mem == NULL)
+    {
+      return;
+    }
+
+  DEBUGASSERT(mm_heapmember(heap, mem));
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  if (heap->mm_mpool)
+    {
+      if (mempool_multiple_free(heap->mm_mpool, mem) >= 0)
+        {
+          return;
+        }
+    }
+#endif
+
+  mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
+}
+
+/****************************************************************************
+ * Name: mm_heapmember
+ *
+ * Description:
+ *   Check if an address lies in the heap.
+ *
+ * Parameters:
+ *   heap - The heap to check
+ *   mem  - The address to check
+ *
+ * Return Value:
+ *   true if the address is a member of the heap.  false if not
+ *   not.  If the address is not a member of the heap, then it
+ *   must be a member of the user-space heap (unchecked)
+ *
+ ****************************************************************************/
+
+bool mm_heapmember(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#if CONFIG_MM_REGIONS > 1
+  int i;
+
+  /* A valid address from the heap for this region would have to lie
+   * between the region's two guard nodes.
+   */
+
+  for (i = 0; i < heap->mm_nregions; i++)
+    {
+      if (mem > (FAR void *)heap->mm_heapstart[i] &&
+          mem < (FAR void *)heap->mm_heapend[i])
+        {
+          return true;
+        }
+    }
+
+  /* The address does not like any any region assigned to the heap */
+
+  return false;
+
+#else
+  /* A valid address from the heap would have to lie between the
+   * two guard nodes.
+   */
+
+  if (mem > (FAR void *)heap->mm_heapstart[0] &&
+      mem < (FAR void *)heap->mm_heapend[0])
+    {
+      return true;
+    }
+
+  /* Otherwise, the address does not lie in the heap */
+
+  return false;
+
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_initialize_heap
+ *
+ * Description:
+ *   Initialize the selected heap data structures, providing the initial
+ *   heap region.
+ *
+ * Input Parameters:
+ *   config - The heap config structure
+ *
+ * Returned Value:
+ *   Return the address of a new heap instance.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *
+mm_initialize_heap(FAR const struct mm_heap_config_s *config)
+{
+  FAR struct mm_heap_s *heap = config->heap;
+  FAR const char *name = config->name;
+  FAR void *heapstart = config->start;
+  size_t heapsize = config->size;
+
+  minfo("Heap: name=%s start=%p size=%zu\n", name, heapstart, heapsize);
+  if (heap == NULL)
+    {
+      /* Reserve a block space for mm_heap_s context */
+
+      DEBUGASSERT(heapsize > sizeof(struct mm_heap_s));
+      heap = (FAR struct mm_heap_s *)heapstart;
+      heapstart += sizeof(struct mm_heap_s);
+      heapsize -= sizeof(struct mm_heap_s);
+
+      memset(heap, 0, sizeof(struct mm_heap_s));
+    }
+  else
+    {
+      heap = mm_memalign(heap, MM_ALIGN, sizeof(struct mm_heap_s));
+      if (heap == NULL)
+        {
+          return NULL;
+        }
+
+      memset(heap, 0, sizeof(struct mm_heap_s));
+    }
+
+  heap->mm_nokasan = config->nokasan;
+
+  /* Initialize the malloc mutex (to support one-at-
+   * a-time access to private data sets).
+   */
+
+  nxmutex_init(&heap->mm_lock);
+
+  /* Add the initial region of memory to the heap */
+
+  mm_addregion(heap, heapstart, heapsize);
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  heap->mm_procfs.name = name;
+  heap->mm_procfs.heap = heap;
+#  ifdef CONFIG_MM_BACKTRACE_DEFAULT
+  heap->mm_procfs.backtrace = true;
+#  endif
+  procfs_register_meminfo(&heap->mm_procfs);
+#endif
+#endif
+
+  return heap;
+}
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+FAR struct mm_heap_s *
+mm_initialize_pool(FAR const struct mm_heap_config_s *config,
+                   FAR const struct mempool_init_s *init)
+{
+  FAR struct mm_heap_s *heap;
+#if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0
+  size_t poolsize[MEMPOOL_NPOOLS];
+  struct mempool_init_s def;
+
+  if (init == NULL)
+    {
+      /* Initialize the multiple mempool default parameter */
+
+      int i;
+
+      for (i = 0; i < MEMPOOL_NPOOLS; i++)
+        {
+#  if CONFIG_MM_MIN_BLKSIZE != 0
+          poolsize[i] = (i + 1) * CONFIG_MM_MIN_BLKSIZE;
+#  else
+          poolsize[i] = (i + 1) * MM_ALIGN;
+#  endif
+        }
+
+      def.poolsize        = poolsize;
+      def.npools          = MEMPOOL_NPOOLS;
+      def.threshold       = CONFIG_MM_HEAP_MEMPOOL_THRESHOLD;
+      def.chunksize       = CONFIG_MM_HEAP_MEMPOOL_CHUNK_SIZE;
+      def.expandsize      = CONFIG_MM_HEAP_MEMPOOL_EXPAND_SIZE;
+      def.dict_expendsize = CONFIG_MM_HEAP_MEMPOOL_DICTIONARY_EXPAND_SIZE;
+
+      init = &def;
+    }
+#endif
+
+  heap = mm_initialize_heap(config);
+
+  /* Initialize the multiple mempool in heap */
+
+  if (init != NULL && init->poolsize != NULL && init->npools != 0)
+    {
+      heap->mm_threshold = init->threshold;
+      heap->mm_mpool     = mempool_multiple_init(config->name,
+                               init->poolsize, init->npools,
+                               (mempool_multiple_alloc_t)mempool_memalign,
+                               (mempool_multiple_alloc_size_t)mm_malloc_size,
+                               (mempool_multiple_free_t)mm_free, heap,
+                               init->chunksize, init->expandsize,
+                               init->dict_expendsize);
+    }
+
+  return heap;
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_mallinfo
+ *
+ * Description:
+ *   mallinfo returns a copy of updated current heap information.
+ *
+ ****************************************************************************/
+
+struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
+{
+  struct mallinfo info;
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  struct mallinfo poolinfo;
+#endif
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  memset(&info, 0, sizeof(struct mallinfo));
+
+  free_delaylist(heap, true);
+
+  /* Visit each region */
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      /* Retake the mutex for each region to reduce latencies */
+
+      DEBUGVERIFY(mm_lock(heap));
+      segfit_foreach(heap, region, mallinfo_handler, &info);
+      mm_unlock(heap);
+    }
+#undef region
+
+  info.arena    = heap->mm_heapsize;
+  info.uordblks = info.arena - info.fordblks;
+  info.usmblks  = heap->mm_maxused;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  poolinfo = mempool_multiple_mallinfo(heap->mm_mpool);
+
+  info.uordblks -= poolinfo.fordblks;
+  info.fordblks += poolinfo.fordblks;
+#endif
+
+  return info;
+}
+
+struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
+                                      FAR const struct malltask *task)
+{
+  struct mm_mallinfo_handler_s handle;
+  struct mallinfo_task info =
+    {
+      0, 0
+    };
+
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#define region 0
+#endif
+
+  free_delaylist(heap, true);
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  info = mempool_multiple_info_task(heap->mm_mpool, task);
+#endif
+
+  handle.task = task;
+  handle.info = &info;
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      /* Retake the mutex for each region to reduce latencies */
+
+      DEBUGVERIFY(mm_lock(heap));
+      segfit_foreach(heap, region, mallinfo_task_handler, &handle);
+      mm_unlock(heap);
+    }
+#undef region
+
+  return info;
+}
+
+/****************************************************************************
+ * Name: mm_memdump
+ *
+ * Description:
+ *   mm_memdump returns a memory info about specified pid of task/thread.
+ *   if pid equals -1, this function will dump all allocated node and output
+ *   backtrace for every allocated node for this heap, if pid equals -2, this
+ *   function will dump all free node for this heap, and if pid is greater
+ *   than or equal to 0, will dump pid allocated node and output backtrace.
+ ****************************************************************************/
+
+void mm_memdump(FAR struct mm_heap_s *heap,
+                FAR const struct mm_memdump_s *dump)
+{
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+  struct mm_memdump_priv_s priv;
+  pid_t pid = dump->pid;
+
+  memset(&priv, 0, sizeof(struct mm_memdump_priv_s));
+  priv.dump = dump;
+
+  free_delaylist(heap, true);
+
+  if (pid == PID_MM_MEMPOOL)
+    {
+      syslog(LOG_INFO, "Memdump mempool\n");
+    }
+  else if (pid == PID_MM_LEAK)
+    {
+      syslog(LOG_INFO, "Memdump leak\n");
+      memdump_info_pool(&priv, heap);
+    }
+  else if (pid == PID_MM_ALLOC || pid >= 0)
+    {
+      FAR struct tcb_s *tcb = NULL;
+      FAR const char   *name;
+
+      if (pid == PID_MM_ALLOC)
+        {
+          name = "ALL";
+        }
+      else
+        {
+          name = "Unknown";
+          tcb  = nxsched_get_tcb(pid);
+        }
+
+      if (tcb == NULL)
+        {
+          syslog(LOG_INFO, "Memdump task %s\n", name);
+        }
+      else
+        {
+          name = get_task_name(tcb);
+          syslog(LOG_INFO, "Memdump task stack_alloc_ptr: %p,"
+                           " adj_stack_size: %zu, name: %s\n",
+                           tcb->stack_alloc_ptr, tcb->adj_stack_size, name);
+        }
+
+      memdump_info_pool(&priv, heap);
+    }
+  else if (pid == PID_MM_FREE)
+    {
+      syslog(LOG_INFO, "Dump all free memory node info\n");
+      memdump_info_pool(&priv, heap);
+    }
+#if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
+  else if (pid == PID_MM_BIGGEST)
+    {
+      syslog(LOG_INFO, "Memdump biggest allocated top %d\n",
+                       CONFIG_MM_HEAP_BIGGEST_COUNT);
+    }
+#endif
+
+#if CONFIG_MM_BACKTRACE < 0
+  syslog(LOG_INFO, "%12s%*s\n", "Size", BACKTRACE_PTR_FMT_WIDTH, "Address");
+#else
+  syslog(LOG_INFO, "%6s%12s%12s%*s %s\n", "PID", "Size", "Sequence",
+                   BACKTRACE_PTR_FMT_WIDTH, "Address", "Backtrace");
+#endif
+
+  memdump_dump_pool(&priv, heap);
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      DEBUGVERIFY(mm_lock(heap));
+      segfit_foreach(heap, region, memdump_handler, &priv);
+      mm_unlock(heap);
+    }
+#undef region
+
+#if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
+  if (pid == PID_MM_BIGGEST)
+    {
+      memdump_dump_biggestnodes(&priv);
+    }
+#endif
+
+  syslog(LOG_INFO, "%12s%12s\n", "Total Blks", "Total Size");
+  syslog(LOG_INFO, "%12d%12d\n", priv.info.aordblks, priv.info.uordblks);
+}
+
+/****************************************************************************
+ * Name: mm_malloc_size
+ ****************************************************************************/
+
+size_t mm_malloc_size(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  if (heap->mm_mpool)
+    {
+      ssize_t size = mempool_multiple_alloc_size(heap->mm_mpool, mem);
+      if (size >= 0)
+        {
+          return size;
+        }
+    }
+#endif
+
+  return SEGFIT_SIZE(SEGFIT_NODE(mem)) - SEGFIT_OVERHEAD;
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find a free node from the smallest non-empty size class that satisfies
+ *  the request. Take the memory from that node, save the remaining, smaller
+ *  node (if any).
+ *
+ *  MM_ALIGN alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct segfit_node_s *node = NULL;
+  size_t nodesize;
+  FAR void *ret = NULL;
+
+  /* In case of zero-length allocations allocate the minimum size object */
+
+  if (size < 1)
+    {
+      size = 1;
+    }
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  if (heap->mm_mpool)
+    {
+      ret = mempool_multiple_alloc(heap->mm_mpool, size);
+      if (ret != NULL)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  nodesize = segfit_nodesize(size);
+  if (nodesize == 0)
+    {
+      return NULL;
+    }
+
+  /* Free the delay list first */
+
+  free_delaylist(heap, false);
+
+  /* Allocate from the size class free lists */
+
+  DEBUGVERIFY(mm_lock(heap));
+  node = segfit_allocate(heap, nodesize);
+  if (node != NULL)
+    {
+      ret = SEGFIT_PAYLOAD(node);
+      heap->mm_curused += SEGFIT_SIZE(node);
+      if (heap->mm_curused > heap->mm_maxused)
+        {
+          heap->mm_maxused = heap->mm_curused;
+        }
+
+      nodesize = mm_malloc_size(heap, ret);
+      sched_note_heap(NOTE_HEAP_ALLOC, heap, ret, nodesize,
+                      heap->mm_curused);
+    }
+
+  mm_unlock(heap);
+
+  if (ret)
+    {
+#if CONFIG_MM_BACKTRACE >= 0
+      FAR struct memdump_backtrace_s *buf = ret + nodesize;
+
+      memdump_backtrace(heap, buf);
+#endif
+
+      ret = kasan_unpoison(ret, nodesize);
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, MM_ALLOC_MAGIC, nodesize);
+#endif
+    }
+
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  /* Try again after free delay list */
+
+  else if (free_delaylist(heap, true))
+    {
+      return mm_malloc(heap, size);
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_memalign
+ *
+ * Description:
+ *   memalign requests more than enough space from malloc, finds a region
+ *   within that chunk that meets the alignment request and then frees any
+ *   leading or trailing space.
+ *
+ *   The alignment argument must be a power of two (not checked).  MM_ALIGN
+ *   alignment is guaranteed by normal malloc calls.
+ *
+ ****************************************************************************/
+
+FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                      size_t size)
+{
+  FAR struct segfit_node_s *node;
+  size_t nodesize;
+  size_t allocsize;
+  FAR void *ret = NULL;
+
+  /* If this requested alinement's less than or equal to the natural
+   * alignment of malloc, then just let malloc do the work.
+   */
+
+  if (alignment <= MM_ALIGN)
+    {
+      return mm_malloc(heap, size);
+    }
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  if (heap->mm_mpool)
+    {
+      ret = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
+      if (ret != NULL)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  /* Reserve room for moving the payload to the alignment with a leading
+   * free node of at least the minimum size.
+   */
+
+  nodesize = segfit_nodesize(size);
+  if (nodesize == 0 ||
+      nodesize > SEGFIT_MAX_SIZE - alignment - SEGFIT_MINSIZE)
+    {
+      return NULL;
+    }
+
+  allocsize = nodesize + alignment + SEGFIT_MINSIZE;
+
+  /* Free the delay list first */
+
+  free_delaylist(heap, false);
+
+  /* Allocate from the size class free lists */
+
+  DEBUGVERIFY(mm_lock(heap));
+  node = segfit_allocate(heap, allocsize);
+  if (node != NULL)
+    {
+      uintptr_t payload = (uintptr_t)SEGFIT_PAYLOAD(node);
+
+      if ((payload & (alignment - 1)) != 0)
+        {
+          FAR struct segfit_node_s *newnode;
+          uintptr_t aligned;
+          size_t lead;
+
+          aligned = payload + SEGFIT_MINSIZE + alignment - 1;
+          aligned = aligned & ~(alignment - 1);
+
+          /* Split off the leading part and give it back */
+
+          lead               = aligned - payload;
+          newnode            = SEGFIT_NODE(aligned);
+          newnode->preceding = lead;
+          newnode->size      = (SEGFIT_SIZE(node) - lead) | SEGFIT_ALLOC;
+          SEGFIT_NEXT(newnode)->preceding = SEGFIT_SIZE(newnode);
+
+          node->size = lead;
+          segfit_release(heap, node);
+          node = newnode;
+        }
+
+      /* Then give back the trailing part */
+
+      segfit_split(heap, node, nodesize);
+
+      ret = SEGFIT_PAYLOAD(node);
+      heap->mm_curused += SEGFIT_SIZE(node);
+      if (heap->mm_curused > heap->mm_maxused)
+        {
+          heap->mm_maxused = heap->mm_curused;
+        }
+
+      nodesize = mm_malloc_size(heap, ret);
+      sched_note_heap(NOTE_HEAP_ALLOC, heap, ret, nodesize,
+                      heap->mm_curused);
+    }
+
+  mm_unlock(heap);
+
+  if (ret)
+    {
+#if CONFIG_MM_BACKTRACE >= 0
+      FAR struct memdump_backtrace_s *buf = ret + nodesize;
+
+      memdump_backtrace(heap, buf);
+#endif
+      ret = kasan_unpoison(ret, nodesize);
+    }
+
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  /* Try again after free delay list */
+
+  else if (free_delaylist(heap, true))
+    {
+      return mm_memalign(heap, alignment, size);
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_realloc
+ *
+ * Description:
+ *   If the reallocation is for less space, then:
+ *
+ *     (1) the current allocation is reduced in size
+ *     (2) the remainder at the end of the allocation is returned to the
+ *         free list.
+ *
+ *  If the request is for more space and the following node is free and
+ *  large enough, the current allocation is extended into it.
+ *
+ *  Otherwise malloc a new buffer, copy the data into the new buffer, and
+ *  free the old buffer.
+ *
+ ****************************************************************************/
+
+FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
+                     size_t size)
+{
+  FAR void *newmem;
+#ifndef CONFIG_MM_KASAN
+  FAR struct segfit_node_s *node;
+  FAR struct segfit_node_s *next;
+  size_t nodesize;
+  size_t oldsize;
+  size_t newsize;
+#endif
+
+  /* If oldmem is NULL, then realloc is equivalent to malloc */
+
+  if (oldmem == NULL)
+    {
+      return mm_malloc(heap, size);
+    }
+
+  /* If size is zero, reallocate to the minim size object, so
+   * the memory pointed by oldmem is freed
+   */
+
+  if (size < 1)
+    {
+      size = 1;
+    }
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  if (heap->mm_mpool)
+    {
+      newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
+      if (newmem != NULL)
+        {
+          return newmem;
+        }
+      else if (size <= heap->mm_threshold ||
+               mempool_multiple_alloc_size(heap->mm_mpool, oldmem) >= 0)
+        {
+          newmem = mm_malloc(heap, size);
+          if (newmem != NULL)
+            {
+              memcpy(newmem, oldmem, MIN(size,
+                                         mm_malloc_size(heap, oldmem)));
+              mm_free(heap, oldmem);
+            }
+
+          return newmem;
+        }
+    }
+#endif
+
+#ifndef CONFIG_MM_KASAN
+  nodesize = segfit_nodesize(size);
+  if (nodesize == 0)
+    {
+      return NULL;
+    }
+
+  /* Free the delay list first */
+
+  free_delaylist(heap, false);
+
+  /* Try to resize the node in place */
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  newmem  = NULL;
+  node    = SEGFIT_NODE(oldmem);
+  oldsize = SEGFIT_SIZE(node);
+  next    = SEGFIT_NEXT(node);
+
+  if (nodesize > oldsize && !SEGFIT_IS_ALLOC(next) &&
+      oldsize + next->size >= nodesize)
+    {
+      /* Absorb the following free node */
+
+      segfit_remove(heap, next);
+      node->size = (oldsize + next->size) | SEGFIT_ALLOC;
+      SEGFIT_NEXT(node)->preceding = SEGFIT_SIZE(node);
+    }
+
+  if (nodesize <= SEGFIT_SIZE(node))
+    {
+      segfit_split(heap, node, nodesize);
+
+      newmem  = oldmem;
+      newsize = SEGFIT_SIZE(node);
+      heap->mm_curused += newsize - oldsize;
+      if (heap->mm_curused > heap->mm_maxused)
+        {
+          heap->mm_maxused = heap->mm_curused;
+        }
+
+      sched_note_heap(NOTE_HEAP_FREE, heap, oldmem,
+                      oldsize - SEGFIT_OVERHEAD,
+                      heap->mm_curused - newsize);
+      sched_note_heap(NOTE_HEAP_ALLOC, heap, newmem,
+                      newsize - SEGFIT_OVERHEAD, heap->mm_curused);
+    }
+
+  mm_unlock(heap);
+
+  if (newmem)
+    {
+#if CONFIG_MM_BACKTRACE >= 0
+      FAR struct memdump_backtrace_s *buf =
+        newmem + mm_malloc_size(heap, newmem);
+      memdump_backtrace(heap, buf);
+#endif
+      return newmem;
+    }
+#endif
+
+  /* Fall back to allocate, copy and free */
+
+  newmem = mm_malloc(heap, size);
+  if (newmem)
+    {
+      if (size > mm_malloc_size(heap, oldmem))
+        {
+          size = mm_malloc_size(heap, oldmem);
+        }
+
+      memcpy(newmem, oldmem, size);
+      mm_free(heap, oldmem);
+    }
+
+  return newmem;
+}
+
+/****************************************************************************
+ * Name: mm_uninitialize
+ *
+ * Description:
+ *   Uninitialize the selected heap data structures.
+ *
+ * Input Parameters:
+ *   heap - The heap to uninitialize
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_uninitialize(FAR struct mm_heap_s *heap)
+{
+  int i;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  mempool_multiple_deinit(heap->mm_mpool);
+#endif
+
+  free_delaylist(heap, true);
+
+#if CONFIG_MM_REGIONS > 1
+  for (i = 0; i < heap->mm_nregions; i++)
+#else
+  for (i = 0; i < 1; i++)
+#endif
+    {
+      if (!heap->mm_nokasan)
+        {
+          kasan_unregister(heap->mm_heapstart[i]);
+        }
+
+      sched_note_heap(NOTE_HEAP_REMOVE, heap, heap->mm_heapstart[i],
+                      (uintptr_t)mm_brkaddr(heap, i) -
+                      (uintptr_t)heap->mm_heapstart[i], heap->mm_curused);
+    }
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  procfs_unregister_meminfo(&heap->mm_procfs);
+#  endif
+#endif
+  nxmutex_destroy(&heap->mm_lock);
+}
+
+/****************************************************************************
+ * Name: mm_zalloc
+ *
+ * Description:
+ *   mm_zalloc calls mm_malloc, then zeroes out the allocated chunk.
+ *
+ ****************************************************************************/
+
+FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR void *alloc = mm_malloc(heap, size);
+
+  if (alloc)
+    {
+       memset(alloc, 0, size);
+    }
+
+  return alloc;
+}
+
+/****************************************************************************
+ * Name: mm_heapfree
+ *
+ * Description:
+ *   Return the total free size (in bytes) in the heap
+ *
+ ****************************************************************************/
+
+size_t mm_heapfree(FAR struct mm_heap_s *heap)
+{
+  free_delaylist(heap, true);
+  return heap->mm_heapsize - heap->mm_curused;
+}
+
+/****************************************************************************
+ * Name: mm_heapfree_largest
+ *
+ * Description:
+ *   Return the largest chunk of contiguous memory in the heap
+ *
+ ****************************************************************************/
+
+size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
+{
+  FAR struct segfit_node_s *node;
+  size_t largest = 0;
+  int fl;
+  int sl;
+
+  free_delaylist(heap, true);
+
+  /* The largest free node is in the highest non-empty size class */
+
+  DEBUGVERIFY(mm_lock(heap));
+  if (heap->mm_flbitmap != 0)
+    {
+      fl = fls(heap->mm_flbitmap) - 1;
+      sl = fls(heap->mm_slbitmap[fl]) - 1;
+
+      for (node = heap->mm_freelist[fl][sl]; node; node = node->flink)
+        {
+          largest = MAX(largest, node->size);
+        }
+    }
+
+  mm_unlock(heap);
+  return largest;
+}
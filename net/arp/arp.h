@@ -166,6 +166,7 @@ struct arp_entry_s
   clock_t                  at_time;     /* Time of last usage */
   uint8_t                  at_flags;    /* Flags, examples: ATF_PERM */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
+  FAR struct arp_entry_s  *at_hnext;    /* Next entry in the hash bucket */
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
   struct iob_queue_s       at_queue;    /* Queue iobs to wait arp complete */
   struct work_s            at_work;     /* Arp response timeout handle */
@@ -527,7 +528,8 @@ void arp_hdr_update(FAR struct net_driver_s *dev, FAR uint16_t *pipaddr,
  *
  * Returned Value:
  *   On success, the number of entries actually copied is returned.  Unused
- *   entries are not returned.
+ *   entries are not returned.  If 'snapshot' is NULL, nothing is copied
+ *   and the number of valid entries (up to 'nentries') is returned.
  *
  * Assumptions
  *   The network is locked to assure exclusive access to the ARP table
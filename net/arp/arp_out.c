@@ -276,6 +276,9 @@ void arp_out(FAR struct net_driver_s *dev)
            */
 
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
+          /* The queued packet loses its checksum state */
+
+          netdev_checksum_complete(dev);
           arp_queue_iob(dev, ipaddr, dev->d_iob);
           netdev_iob_clear(dev);
 #else
@@ -290,6 +293,7 @@ void arp_out(FAR struct net_driver_s *dev)
 
       arp_update(dev, ipaddr, NULL, 0);
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
+      netdev_checksum_complete(dev);
       arp_queue_iob(dev, ipaddr, dev->d_iob);
       netdev_iob_clear(dev);
 #endif
@@ -75,6 +75,14 @@
 #define ARP_MAXAGE_UNREACHABLE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE_UNREACHABLE)
 #define ARP_INPROGRESS_TICK MSEC2TICK(CONFIG_ARP_SEND_MAXTRIES * CONFIG_ARP_SEND_DELAYMSEC)
 
+#ifndef CONFIG_NET_ARPTAB_NHASH
+#  define CONFIG_NET_ARPTAB_NHASH 8
+#endif
+
+#if (CONFIG_NET_ARPTAB_NHASH & (CONFIG_NET_ARPTAB_NHASH - 1)) != 0
+#  error CONFIG_NET_ARPTAB_NHASH must be a power of two
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -93,6 +101,10 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The hash buckets of the entries in use, by the IPv4 address */
+
+static FAR struct arp_entry_s *g_arphash[CONFIG_NET_ARPTAB_NHASH];
+
 static const struct ether_addr g_zero_ethaddr =
 {
   {
@@ -104,6 +116,80 @@ static const struct ether_addr g_zero_ethaddr =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the hash bucket of an IPv4 address.
+ *
+ ****************************************************************************/
+
+static inline FAR struct arp_entry_s **arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr * 0x9e3779b1u;
+
+  return &g_arphash[(hash >> 16) & (CONFIG_NET_ARPTAB_NHASH - 1)];
+}
+
+/****************************************************************************
+ * Name: arp_hash_add and arp_hash_remove
+ *
+ * Description:
+ *   Add an entry to or remove it from its hash bucket.  An entry is in the
+ *   hash buckets if and only if its IPv4 address is not zero.
+ *
+ ****************************************************************************/
+
+static void arp_hash_add(FAR struct arp_entry_s *tabptr)
+{
+  FAR struct arp_entry_s **bucket = arp_hash(tabptr->at_ipaddr);
+
+  tabptr->at_hnext = *bucket;
+  *bucket = tabptr;
+}
+
+static void arp_hash_remove(FAR struct arp_entry_s *tabptr)
+{
+  FAR struct arp_entry_s **pp = arp_hash(tabptr->at_ipaddr);
+
+  for (; *pp != NULL; pp = &(*pp)->at_hnext)
+    {
+      if (*pp == tabptr)
+        {
+          *pp = tabptr->at_hnext;
+          break;
+        }
+    }
+
+  tabptr->at_hnext = NULL;
+}
+
+/****************************************************************************
+ * Name: arp_search
+ *
+ * Description:
+ *   Find the ARP entry of the IP address on the device, expired or not.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_search(in_addr_t ipaddr,
+                                          FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  for (tabptr = *arp_hash(ipaddr); tabptr != NULL;
+       tabptr = tabptr->at_hnext)
+    {
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: arp_match
  *
@@ -202,30 +288,44 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR struct arp_entry_s *tabptr = NULL;
 
-  /* Check if the IPv4 address is already in the ARP table. */
+  if (ipaddr == 0)
+    {
+      return NULL;
+    }
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  /* Try the last hit of the device first, then the IPv4 address in the
+   * ARP table.
+   */
+
+  if (dev != NULL)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+      tabptr = dev->d_arplast;
+    }
+
+  if (tabptr == NULL || tabptr->at_dev != dev ||
+      !net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+    {
+      tabptr = arp_search(ipaddr, dev);
+      if (tabptr == NULL)
         {
-          if ((tabptr->at_flags & ATF_PERM) != 0 ||
-              clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-            {
-              return tabptr;
-            }
+          return NULL;  /* Not found */
+        }
 
-          return NULL;  /* Expired */
+      if (dev != NULL)
+        {
+          dev->d_arplast = tabptr;
         }
     }
 
-  /* Not found */
+  if ((tabptr->at_flags & ATF_PERM) != 0 ||
+      clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
+    {
+      return tabptr;
+    }
 
-  return NULL;
+  return NULL;  /* Expired */
 }
 
 /****************************************************************************
@@ -295,43 +395,31 @@ static void arp_unreach_work(FAR void *param)
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr, uint8_t flags)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
   bool new_entry;
 #endif
-#if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
-  bool found = false;
-#endif
+  bool found;
   int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
-
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  if (ipaddr == 0)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
+      return -EINVAL;
+    }
 
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in the ARP table, in place of the oldest
+   * entry.
+   */
 
-          tabptr = &g_arptable[i];
-#if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
-          found = true;
-#endif
-          break;
-        }
-      else
+  tabptr = arp_search(ipaddr, dev);
+  found  = tabptr != NULL;
+  if (!found)
+    {
+      tabptr = &g_arptable[0];
+      for (i = 1; i < CONFIG_NET_ARPTAB_SIZE; ++i)
         {
-          /* Record the oldest entry. */
-
           tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
         }
     }
@@ -380,12 +468,22 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
    * information.
    */
 
+  if (!found && tabptr->at_ipaddr != 0)
+    {
+      arp_hash_remove(tabptr);
+    }
+
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_ipaddr = ipaddr;
   tabptr->at_time   = clock_systime_ticks();
   tabptr->at_flags  = flags;
   tabptr->at_dev    = dev;
 
+  if (!found)
+    {
+      arp_hash_add(tabptr);
+    }
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -575,6 +673,7 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
       /* Yes.. Set the IP address to zero to "delete" it */
 
+      arp_hash_remove(tabptr);
       tabptr->at_ipaddr = 0;
       return OK;
     }
@@ -609,9 +708,16 @@ void arp_cleanup(FAR struct net_driver_s *dev)
           iob_free_queue(&g_arptable[i].at_queue);
 #endif
 
+          if (g_arptable[i].at_ipaddr != 0)
+            {
+              arp_hash_remove(&g_arptable[i]);
+            }
+
           memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
         }
     }
+
+  dev->d_arplast = NULL;
 }
 
 /****************************************************************************
@@ -627,7 +733,8 @@ void arp_cleanup(FAR struct net_driver_s *dev)
  *
  * Returned Value:
  *   On success, the number of entries actually copied is returned.  Unused
- *   entries are not returned.
+ *   entries are not returned.  If 'snapshot' is NULL, nothing is copied
+ *   and the number of valid entries (up to 'nentries') is returned.
  *
  * Assumptions
  *   The network is locked to assure exclusive access to the ARP table
@@ -653,7 +760,11 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
       if (tabptr->at_ipaddr != 0 && ((tabptr->at_flags & ATF_PERM) != 0 ||
           now - tabptr->at_time <= ARP_MAXAGE_TICK))
         {
-          arp_get_arpreq(&snapshot[ncopied], tabptr);
+          if (snapshot != NULL)
+            {
+              arp_get_arpreq(&snapshot[ncopied], tabptr);
+            }
+
           ncopied++;
         }
     }
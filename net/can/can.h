@@ -57,6 +57,12 @@
 #define can_callback_free(dev,conn,cb) \
   devif_conn_callback_free(dev, cb, &conn->sconn.list, &conn->sconn.list_tail)
 
+/* Number of buckets in the per-connection exact-ID filter hash.  Must be
+ * a power of two.
+ */
+
+#define CAN_FILTER_HASHSIZE 16
+
 #ifndef CONFIG_NET_CAN_NBUFFERS
 #  define CONFIG_NET_CAN_NBUFFERS 0
 #endif
@@ -129,6 +135,16 @@ struct can_conn_s
 #ifdef CONFIG_NET_CANPROTO_OPTIONS
   struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
   int32_t filter_count;
+
+  /* Filters that match one exact ID are chained in filter_hash[] so that
+   * the receive path only compares against filters sharing the frame's
+   * bucket.  Entries hold the filter index plus one, zero ends a chain.
+   * filter_nmasked counts the remaining filters that must be scanned.
+   */
+
+  uint8_t filter_hash[CAN_FILTER_HASHSIZE];
+  uint8_t filter_next[CONFIG_NET_CAN_RAW_FILTER_MAX];
+  uint8_t filter_nmasked;
 #  ifdef CONFIG_NET_CAN_ERRORS
   can_err_mask_t err_mask;
 #  endif
@@ -204,6 +220,46 @@ FAR struct can_conn_s *can_nextconn(FAR struct can_conn_s *conn);
 void can_conn_list_lock(void);
 void can_conn_list_unlock(void);
 
+/****************************************************************************
+ * Name: can_filter_rehash
+ *
+ * Description:
+ *   Rebuild the exact-ID filter hash of a connection after its
+ *   CAN_RAW_FILTER list has changed.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection whose filters[] have been updated
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_rehash(FAR struct can_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: can_hwfilter_update
+ *
+ * Description:
+ *   Reprogram the hardware acceptance filters of a CAN device from the
+ *   union of the CAN_RAW_FILTER lists of all sockets receiving from it.
+ *   If any of those filters can not be expressed in hardware (inverted
+ *   or catch-all filters, too many entries), the device is left accepting
+ *   all frames and filtering stays purely in software.
+ *
+ * Input Parameters:
+ *   dev - The CAN device to update, or NULL to update every CAN device
+ *
+ * Assumptions:
+ *   Called from socket logic, the network is not locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+void can_hwfilter_update(FAR struct net_driver_s *dev);
+#else
+#  define can_hwfilter_update(dev)
+#endif
+
 /****************************************************************************
  * Name: can_active()
  *
@@ -107,6 +107,7 @@ FAR struct can_conn_s *can_alloc(void)
        */
 
       conn->filter_count = 1;
+      conn->filter_nmasked = 1;
 #endif
 
       /* Enqueue the connection into the active list */
@@ -168,6 +169,58 @@ void can_free(FAR struct can_conn_s *conn)
   NET_BUFPOOL_UNLOCK(g_can_connections);
 }
 
+/****************************************************************************
+ * Name: can_filter_key
+ *
+ * Description:
+ *   Return the part of a CAN identifier that an exact-ID filter compares,
+ *   i.e. the frame format flag and the 11- or 29-bit identifier.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+static inline canid_t can_filter_key(canid_t id)
+{
+  return id & ((id & CAN_EFF_FLAG) != 0 ?
+               CAN_EFF_FLAG | CAN_EFF_MASK : CAN_SFF_MASK);
+}
+
+/****************************************************************************
+ * Name: can_filter_bucket
+ ****************************************************************************/
+
+static inline unsigned int can_filter_bucket(canid_t key)
+{
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return (key ^ (key >> 4)) & (CAN_FILTER_HASHSIZE - 1);
+}
+
+/****************************************************************************
+ * Name: can_filter_exact
+ *
+ * Description:
+ *   Return true if the filter accepts exactly one identifier of one frame
+ *   format and can therefore be found through the filter hash.
+ *
+ ****************************************************************************/
+
+static bool can_filter_exact(FAR const struct can_filter *filter)
+{
+  canid_t idmask;
+
+  if ((filter->can_id & CAN_INV_FILTER) != 0)
+    {
+      return false;
+    }
+
+  idmask = (filter->can_id & CAN_EFF_FLAG) != 0 ?
+           CAN_EFF_FLAG | CAN_EFF_MASK : CAN_EFF_FLAG | CAN_SFF_MASK;
+
+  return (filter->can_mask & idmask) == idmask;
+}
+#endif
+
 /****************************************************************************
  * Name: can_recv_filter
  *
@@ -196,8 +249,33 @@ static int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
     }
 #endif
 
+  /* Exact-ID filters first: only those in the frame's bucket can match */
+
+  i = conn->filter_hash[can_filter_bucket(can_filter_key(id))];
+  while (i != 0)
+    {
+      FAR const struct can_filter *filter = &conn->filters[i - 1];
+
+      if ((id & filter->can_mask) == (filter->can_id & filter->can_mask))
+        {
+          return 1;
+        }
+
+      i = conn->filter_next[i - 1];
+    }
+
+  if (conn->filter_nmasked == 0)
+    {
+      return 0;
+    }
+
   for (i = 0; i < conn->filter_count; i++)
     {
+      if (can_filter_exact(&conn->filters[i]))
+        {
+          continue;
+        }
+
       if (conn->filters[i].can_id & CAN_INV_FILTER)
         {
           if ((id & conn->filters[i].can_mask) !=
@@ -267,6 +345,48 @@ void can_conn_list_unlock(void)
   NET_BUFPOOL_UNLOCK(g_can_connections);
 }
 
+/****************************************************************************
+ * Name: can_filter_rehash
+ *
+ * Description:
+ *   Rebuild the exact-ID filter hash of a connection after its
+ *   CAN_RAW_FILTER list has changed.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection whose filters[] have been updated
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_rehash(FAR struct can_conn_s *conn)
+{
+  unsigned int bucket;
+  int i;
+
+  memset(conn->filter_hash, 0, sizeof(conn->filter_hash));
+  conn->filter_nmasked = 0;
+
+  /* Insert in reverse so that each chain keeps the filters in the order
+   * they were configured.
+   */
+
+  for (i = conn->filter_count - 1; i >= 0; i--)
+    {
+      if (can_filter_exact(&conn->filters[i]))
+        {
+          bucket = can_filter_key(conn->filters[i].can_id);
+          bucket = can_filter_bucket(bucket);
+          conn->filter_next[i] = conn->filter_hash[bucket];
+          conn->filter_hash[bucket] = i + 1;
+        }
+      else
+        {
+          conn->filter_nmasked++;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: can_active()
  *
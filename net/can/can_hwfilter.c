@@ -0,0 +1,278 @@
+/****************************************************************************
+ * net/can/can_hwfilter.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/if.h>
+#include <nuttx/can.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ioctl.h>
+
+#include "netdev/netdev.h"
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The hardware filter set being assembled for one device */
+
+struct can_hwfilter_s
+{
+  struct can_ioctl_filter_s filter[CONFIG_NET_CAN_HWFILTER_MAX];
+  bool                      ext[CONFIG_NET_CAN_HWFILTER_MAX];
+  int                       nfilters;
+  bool                      acceptall;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_hwfilter_add
+ *
+ * Description:
+ *   Add one mask filter to the set, skipping duplicates.  Falls back to
+ *   accepting everything when the set is full.
+ *
+ ****************************************************************************/
+
+static void can_hwfilter_add(FAR struct can_hwfilter_s *set, bool ext,
+                             uint32_t id, uint32_t mask)
+{
+  int i;
+
+  id &= mask;
+
+  for (i = 0; i < set->nfilters; i++)
+    {
+      if (set->ext[i] == ext && set->filter[i].fid1 == id &&
+          set->filter[i].fid2 == mask)
+        {
+          return;
+        }
+    }
+
+  if (set->nfilters >= CONFIG_NET_CAN_HWFILTER_MAX)
+    {
+      set->acceptall = true;
+      return;
+    }
+
+  set->filter[set->nfilters].fid1  = id;
+  set->filter[set->nfilters].fid2  = mask;
+  set->filter[set->nfilters].ftype = CAN_FILTER_MASK;
+  set->filter[set->nfilters].fprio = CAN_MSGPRIO_HIGH;
+  set->ext[set->nfilters]          = ext;
+  set->nfilters++;
+}
+
+/****************************************************************************
+ * Name: can_hwfilter_collect
+ *
+ * Description:
+ *   Translate the socket filters of every connection that may receive from
+ *   'dev' into hardware mask filters.  The hardware set only has to be a
+ *   superset of what the sockets accept, can_recv_filter() still runs on
+ *   every frame that gets through.
+ *
+ ****************************************************************************/
+
+static void can_hwfilter_collect(FAR struct net_driver_s *dev,
+                                 FAR struct can_hwfilter_s *set)
+{
+  FAR struct can_conn_s *conn = NULL;
+  int i;
+
+  can_conn_list_lock();
+
+  while (!set->acceptall && (conn = can_nextconn(conn)) != NULL)
+    {
+      /* Sockets not bound to a device receive from all of them.  Such a
+       * socket is counted even before bind() completes, which can only
+       * make the hardware accept more than needed.
+       */
+
+      if (conn->dev != NULL && conn->dev != dev)
+        {
+          continue;
+        }
+
+      for (i = 0; i < conn->filter_count && !set->acceptall; i++)
+        {
+          FAR const struct can_filter *filter = &conn->filters[i];
+          canid_t mask = filter->can_mask;
+          canid_t id   = filter->can_id;
+
+          if ((id & CAN_INV_FILTER) != 0)
+            {
+              set->acceptall = true;
+            }
+          else if ((mask & CAN_EFF_FLAG) == 0)
+            {
+              /* Frame format is not part of the match: both standard and
+               * extended frames are accepted.
+               */
+
+              if ((mask & CAN_SFF_MASK) == 0)
+                {
+                  set->acceptall = true;
+                }
+              else
+                {
+                  can_hwfilter_add(set, false, id & CAN_SFF_MASK,
+                                   mask & CAN_SFF_MASK);
+                  can_hwfilter_add(set, true, id & CAN_EFF_MASK,
+                                   mask & CAN_EFF_MASK);
+                }
+            }
+          else if ((id & CAN_EFF_FLAG) != 0)
+            {
+              can_hwfilter_add(set, true, id & CAN_EFF_MASK,
+                               mask & CAN_EFF_MASK);
+            }
+          else
+            {
+              can_hwfilter_add(set, false, id & CAN_SFF_MASK,
+                               mask & CAN_SFF_MASK);
+            }
+        }
+    }
+
+  can_conn_list_unlock();
+}
+
+/****************************************************************************
+ * Name: can_hwfilter_program
+ *
+ * Description:
+ *   Replace the acceptance filters of one CAN device.
+ *
+ ****************************************************************************/
+
+static int can_hwfilter_program(FAR struct net_driver_s *dev,
+                                FAR void *arg)
+{
+  struct can_ioctl_filter_s reset;
+  struct can_hwfilter_s set;
+  int ret = OK;
+  int i;
+
+  if (dev->d_lltype != NET_LL_CAN || dev->d_ioctl == NULL)
+    {
+      return 0;
+    }
+
+  memset(&set, 0, sizeof(set));
+  can_hwfilter_collect(dev, &set);
+
+  /* Lower halves treat the delete commands as "clear the filter bank",
+   * after which the controller accepts every frame again.
+   */
+
+  memset(&reset, 0, sizeof(reset));
+
+  netdev_lock(dev);
+
+  dev->d_ioctl(dev, SIOCDCANSTDFILTER, (unsigned long)(uintptr_t)&reset);
+  dev->d_ioctl(dev, SIOCDCANEXTFILTER, (unsigned long)(uintptr_t)&reset);
+
+  if (!set.acceptall)
+    {
+      for (i = 0; i < set.nfilters; i++)
+        {
+          ret = dev->d_ioctl(dev, set.ext[i] ? SIOCACANEXTFILTER :
+                                               SIOCACANSTDFILTER,
+                             (unsigned long)(uintptr_t)&set.filter[i]);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      if (ret < 0)
+        {
+          /* A partially programmed bank would drop frames that some
+           * socket wants.  Go back to accepting everything.
+           */
+
+          nwarn("WARNING: %s: hardware filter %d failed: %d\n",
+                dev->d_ifname, i, ret);
+
+          dev->d_ioctl(dev, SIOCDCANSTDFILTER,
+                       (unsigned long)(uintptr_t)&reset);
+          dev->d_ioctl(dev, SIOCDCANEXTFILTER,
+                       (unsigned long)(uintptr_t)&reset);
+        }
+    }
+
+  netdev_unlock(dev);
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_hwfilter_update
+ *
+ * Description:
+ *   Reprogram the hardware acceptance filters of a CAN device from the
+ *   union of the CAN_RAW_FILTER lists of all sockets receiving from it.
+ *   If any of those filters can not be expressed in hardware (inverted
+ *   or catch-all filters, too many entries), the device is left accepting
+ *   all frames and filtering stays purely in software.
+ *
+ * Input Parameters:
+ *   dev - The CAN device to update, or NULL to update every CAN device
+ *
+ * Assumptions:
+ *   Called from socket logic, the network is not locked.
+ *
+ ****************************************************************************/
+
+void can_hwfilter_update(FAR struct net_driver_s *dev)
+{
+  if (dev != NULL)
+    {
+      can_hwfilter_program(dev, NULL);
+    }
+  else
+    {
+      netdev_foreach(can_hwfilter_program, NULL);
+    }
+}
+
+#endif /* CONFIG_NET_CAN_HWFILTER */
@@ -97,7 +97,12 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
       case CAN_RAW_FILTER:
         if (value_len == 0)
           {
+            can_conn_list_lock();
             conn->filter_count = 0;
+            can_filter_rehash(conn);
+            can_conn_list_unlock();
+
+            can_hwfilter_update(conn->dev);
             ret = OK;
           }
         else if (value_len % sizeof(struct can_filter) != 0)
@@ -115,13 +120,20 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
 
             count = value_len / sizeof(struct can_filter);
 
+            /* Hold off the receive path while the filters are rebuilt */
+
+            can_conn_list_lock();
+
             for (i = 0; i < count; i++)
               {
                 conn->filters[i] = ((struct can_filter *)value)[i];
               }
 
             conn->filter_count = count;
+            can_filter_rehash(conn);
+            can_conn_list_unlock();
 
+            can_hwfilter_update(conn->dev);
             ret = OK;
           }
         break;
@@ -327,6 +327,9 @@ static int can_bind(FAR struct socket *psock,
 {
   FAR struct sockaddr_can *canaddr;
   FAR struct can_conn_s *conn;
+#ifdef CONFIG_NET_CAN_HWFILTER
+  FAR struct net_driver_s *olddev;
+#endif
   DEBUGASSERT(addr != NULL &&
               addrlen >= sizeof(struct sockaddr_can));
 
@@ -334,6 +337,9 @@ static int can_bind(FAR struct socket *psock,
 
   canaddr = (FAR struct sockaddr_can *)addr;
   conn    = psock->s_conn;
+#ifdef CONFIG_NET_CAN_HWFILTER
+  olddev  = conn->dev;
+#endif
 
   /* Bind CAN device to socket */
 
@@ -345,7 +351,25 @@ static int can_bind(FAR struct socket *psock,
   conn->dev = netdev_findbyname((const char *)&netdev_name);
 #endif
 
-  return conn->dev == NULL && canaddr->can_ifindex != 0 ? -ENODEV : OK;
+  if (conn->dev == NULL && canaddr->can_ifindex != 0)
+    {
+      return -ENODEV;
+    }
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+  /* The socket now receives from a different device (or from all of
+   * them): refresh the acceptance filters of both.
+   */
+
+  if (olddev != NULL && olddev != conn->dev)
+    {
+      can_hwfilter_update(olddev);
+    }
+
+  can_hwfilter_update(conn->dev);
+#endif
+
+  return OK;
 }
 
 /****************************************************************************
@@ -515,6 +539,9 @@ errout_with_lock:
 static int can_close(FAR struct socket *psock)
 {
   FAR struct can_conn_s *conn = psock->s_conn;
+#ifdef CONFIG_NET_CAN_HWFILTER
+  FAR struct net_driver_s *dev;
+#endif
   int ret = OK;
 
   /* Perform some pre-close operations for the CAN socket type. */
@@ -539,9 +566,16 @@ static int can_close(FAR struct socket *psock)
 
       /* Free the connection structure */
 
+#ifdef CONFIG_NET_CAN_HWFILTER
+      dev = conn->dev;
+#endif
       conn->crefs = 0;
       can_free(psock->s_conn);
 
+      /* Drop this socket's filters from the hardware filter set */
+
+      can_hwfilter_update(dev);
+
       if (ret < 0)
         {
           /* Return with error code, but free resources. */
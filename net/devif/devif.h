@@ -506,6 +506,26 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
                     unsigned int target_offset);
 #endif
 
+/****************************************************************************
+ * Name: devif_xip_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_file_send() except that the file
+ *   data is in memory and referenced by the packet rather than copied.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+int devif_xip_send(FAR struct net_driver_s *dev, FAR const void *data,
+                   unsigned int len, unsigned int target_offset);
+#endif
+
 /****************************************************************************
  * Name: devif_out
  *
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -37,6 +38,26 @@
 
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_xip_free
+ *
+ * Description:
+ *   Release the file data referenced by devif_xip_send(), which stays
+ *   with the file system.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+static void devif_xip_free(FAR void *data)
+{
+  UNUSED(data);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -163,4 +184,83 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: devif_xip_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_file_send() except that the file
+ *   data is in memory and referenced by the packet rather than copied.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+int devif_xip_send(FAR struct net_driver_s *dev, FAR const void *data,
+                   unsigned int len, unsigned int target_offset)
+{
+  FAR struct iob_s *iob;
+  int ret;
+
+  if (dev == NULL)
+    {
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  if (len == 0 || len > UINT16_MAX)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+#ifndef CONFIG_NET_IPFRAG
+  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+    {
+      ret = -EMSGSIZE;
+      goto errout;
+    }
+#endif
+
+  /* The first buffer only holds the headers, the data follows in an I/O
+   * buffer referring to the file without any tail room.
+   */
+
+  if (netdev_iob_prepare(dev, false, 0) != OK)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  iob_update_pktlen(dev->d_iob, target_offset, false);
+
+  iob = iob_alloc_with_data((FAR void *)data, len, devif_xip_free);
+  if (iob == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  iob->io_len    = len;
+  iob->io_pktlen = len;
+  iob_concat(dev->d_iob, iob);
+
+  dev->d_sndlen = len;
+  return len;
+
+errout:
+  if (dev != NULL)
+    {
+      netdev_iob_release(dev);
+    }
+
+  nerr("ERROR: devif_xip_send error: %d\n", ret);
+  return ret;
+}
+#endif /* CONFIG_NET_SENDFILE_ZEROCOPY */
+
 #endif /* CONFIG_MM_IOB */
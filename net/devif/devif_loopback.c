@@ -105,6 +105,10 @@ int devif_loopback(FAR struct net_driver_s *dev)
        NETDEV_TXPACKETS(dev);
        NETDEV_RXPACKETS(dev);
 
+      /* The packet never reaches the hardware to complete its checksum */
+
+      netdev_checksum_complete(dev);
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the tap */
 
@@ -187,6 +187,32 @@ static void devif_packet_conversion(FAR struct net_driver_s *dev,
 #  define devif_packet_conversion(dev,pkttype)
 #endif /* CONFIG_NET_6LOWPAN */
 
+/****************************************************************************
+ * Name: devif_poll_proto
+ *
+ * Description:
+ *   Return the protocol of the outgoing IP packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GSO
+static uint8_t devif_poll_proto(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv4(dev->d_flags))
+#endif
+    {
+      return IPv4BUF->proto;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  return IPv6BUF->proto;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: devif_poll_local_out
  *
@@ -1268,19 +1294,56 @@ int devif_poll_out(FAR struct net_driver_s *dev,
 
   if (dev->d_len == 0)
     {
+#ifdef CONFIG_NETDEV_GSO
+      dev->d_gsosize = 0;
+#endif
       return 0;
     }
 
+#ifdef CONFIG_NET_UDP_GSO
+  /* Cut the UDP packet holding several datagrams first, each one of them
+   * then takes the path below on its own, the loopback included.
+   */
+
+  if (dev->d_gsosize > 0 && callback != NULL &&
+      devif_poll_proto(dev) == IP_PROTO_UDP)
+    {
+      return udp_gso_poll(dev, callback);
+    }
+#endif
+
   devif_out(dev);
 
   bstop = devif_loopback(dev);
   if (bstop)
     {
+#ifdef CONFIG_NETDEV_GSO
+      dev->d_gsosize = 0;
+#endif
       return bstop;
     }
 
   if (callback)
     {
+#ifdef CONFIG_NET_TCP_GSO
+      if (dev->d_gsosize > 0)
+        {
+          /* Segment the large TCP packet here unless the hardware does */
+
+          if ((dev->d_features & NETDEV_TX_TSO) == 0)
+            {
+              bstop = tcp_gso_poll(dev, callback);
+            }
+          else
+            {
+              bstop = callback(dev);
+            }
+
+          dev->d_gsosize = 0;
+          return bstop;
+        }
+#endif
+
 #ifdef CONFIG_NET_IPFRAG
       if (ip_fragout(dev) != OK)
         {
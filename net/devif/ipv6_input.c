@@ -682,7 +682,10 @@ int ipv6_input(FAR struct net_driver_s *dev)
   /* Store reception timestamp if enabled and not provided by hardware. */
 
 #if defined(CONFIG_NET_TIMESTAMP) && !defined(CONFIG_ARCH_HAVE_NETDEV_TIMESTAMP)
-  clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
+  if ((dev->d_features & NETDEV_RX_TIME) == 0)
+    {
+      clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
+    }
 #endif
 
   if (dev->d_iob != NULL)
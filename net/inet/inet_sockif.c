@@ -33,6 +33,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <netinet/udp.h>
+
 #include <nuttx/net/net.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/tcp.h>
@@ -783,6 +785,11 @@ static int inet_getsockopt(FAR struct socket *psock, int level, int option,
         return tcp_getsockopt(psock, option, value, value_len);
 #endif
 
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+      case IPPROTO_UDP:
+        return udp_getsockopt(psock, option, value, value_len);
+#endif
+
 #ifdef CONFIG_NET_IPv4
       case IPPROTO_IP:/* IPv4 protocol socket options (see include/netinet/in.h) */
         return ipv4_getsockopt(psock, option, value, value_len);
@@ -932,6 +939,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the receive buffer size */
 
               tcp->rcv_bufs = buffersize;
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTOTUNE
+              tcp->flags   |= TCP_RCVBUF_LOCK;
+#endif
             }
           else
 #endif
@@ -993,6 +1003,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the send buffer size */
 
               tcp->snd_bufs = buffersize;
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTOTUNE
+              tcp->flags   |= TCP_SNDBUF_LOCK;
+#endif
             }
           else
 #endif
@@ -1755,35 +1768,20 @@ static ssize_t inet_send(FAR struct socket *psock, FAR const void *buf,
 }
 
 /****************************************************************************
- * Name: inet_sendto
+ * Name: inet_sockaddr_len
  *
  * Description:
- *   Implements the sendto() operation for the case of the AF_INET and
- *   AF_INET6 sockets.
- *
- * Input Parameters:
- *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
- *   to       Address of recipient
- *   tolen    The length of the address structure
+ *   Verify the destination address given to sendto().
  *
  * Returned Value:
- *   On success, returns the number of characters sent.  On  error, a negated
- *   errno value is returned (see send_to() for the list of appropriate error
- *   values.
+ *   The size of the address structure of its family on success, a negated
+ *   errno value on failure.
  *
  ****************************************************************************/
 
-static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
-                           size_t len, int flags,
-                           FAR const struct sockaddr *to, socklen_t tolen)
+static int inet_sockaddr_len(FAR const struct sockaddr *to, socklen_t tolen)
 {
   socklen_t minlen;
-  ssize_t nsent;
-
-  /* Verify that a valid address has been provided */
 
   switch (to->sa_family)
     {
@@ -1810,6 +1808,46 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EBADF;
     }
 
+  return minlen;
+}
+
+/****************************************************************************
+ * Name: inet_sendto
+ *
+ * Description:
+ *   Implements the sendto() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send_to() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
+                           size_t len, int flags,
+                           FAR const struct sockaddr *to, socklen_t tolen)
+{
+  ssize_t nsent;
+  int minlen;
+
+  /* Verify that a valid address has been provided */
+
+  minlen = inet_sockaddr_len(to, tolen);
+  if (minlen < 0)
+    {
+      return minlen;
+    }
+
 #ifdef CONFIG_NET_UDP
   if (psock->s_type != SOCK_DGRAM)
     {
@@ -1847,6 +1885,50 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
   return nsent;
 }
 
+/****************************************************************************
+ * Name: inet_sendbuf
+ *
+ * Description:
+ *   Send the data of a message gathered in one buffer, as the datagrams of
+ *   the size given in a UDP_SEGMENT control message if any.
+ *
+ ****************************************************************************/
+
+static ssize_t inet_sendbuf(FAR struct socket *psock, FAR const void *buf,
+                            size_t len, int flags,
+                            FAR const struct msghdr *msg)
+{
+  FAR const struct sockaddr *to = msg->msg_name;
+  socklen_t tolen = msg->msg_namelen;
+
+#ifdef CONFIG_NET_UDP_GSO
+  if (psock->s_type == SOCK_DGRAM && msg->msg_control != NULL)
+    {
+      FAR const uint16_t *gsosize;
+      int ret;
+
+      gsosize = cmsg_find(msg, SOL_UDP, UDP_SEGMENT, sizeof(uint16_t));
+      if (gsosize != NULL)
+        {
+          if (to != NULL)
+            {
+              ret = inet_sockaddr_len(to, tolen);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          return psock_udp_sendto_segment(psock, buf, len, flags, to,
+                                          tolen, *gsosize);
+        }
+    }
+#endif
+
+  return to ? inet_sendto(psock, buf, len, flags, to, tolen) :
+              inet_send(psock, buf, len, flags);
+}
+
 /****************************************************************************
  * Name: inet_sendmsg
  *
@@ -1871,16 +1953,13 @@ static ssize_t inet_sendmsg(FAR struct socket *psock,
 {
   FAR void *buf = msg->msg_iov->iov_base;
   size_t len = msg->msg_iov->iov_len;
-  FAR const struct sockaddr *to = msg->msg_name;
-  socklen_t tolen = msg->msg_namelen;
   FAR const struct iovec *iov;
   FAR const struct iovec *end;
   int ret;
 
   if (msg->msg_iovlen == 1)
     {
-      return to ? inet_sendto(psock, buf, len, flags, to, tolen) :
-                  inet_send(psock, buf, len, flags);
+      return inet_sendbuf(psock, buf, len, flags, msg);
     }
 
   end = &msg->msg_iov[msg->msg_iovlen];
@@ -1906,8 +1985,7 @@ static ssize_t inet_sendmsg(FAR struct socket *psock,
       len += iov->iov_len;
     }
 
-  ret = to ? inet_sendto(psock, buf, len, flags, to, tolen) :
-             inet_send(psock, buf, len, flags);
+  ret = inet_sendbuf(psock, buf, len, flags, msg);
 
   kmm_free(buf);
 
@@ -32,6 +32,8 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <nuttx/net/ip.h>
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -76,6 +78,40 @@ struct forward_s
 #endif
 };
 
+/* This is the forwarding flow cache entry, also used as the lookup key */
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+struct ipfwd_flow_s
+{
+  FAR struct net_driver_s     *f_indev;   /* Receiving device */
+  FAR struct net_driver_s     *f_outdev;  /* Forwarding device */
+  union
+  {
+#ifdef CONFIG_NET_IPv4
+    struct
+    {
+      in_addr_t                src;       /* IPv4 source address */
+      in_addr_t                dst;       /* IPv4 destination address */
+    } ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+    struct
+    {
+      net_ipv6addr_t           src;       /* IPv6 source address */
+      net_ipv6addr_t           dst;       /* IPv6 destination address */
+    } ipv6;
+#endif
+  } f_addr;
+  uint16_t                     f_sport;   /* Source port, network order */
+  uint16_t                     f_dport;   /* Destination port, network order */
+  uint8_t                      f_proto;   /* IP_PROTO_TCP or IP_PROTO_UDP, or
+                                           * zero if not cacheable */
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t                      f_domain;  /* Domain: PF_INET or PF_INET6 */
+#endif
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -112,6 +148,88 @@ FAR struct forward_s *ipfwd_alloc(void);
 
 void ipfwd_free(FAR struct forward_s *fwd);
 
+/****************************************************************************
+ * Name: ipv4_flow_key / ipv6_flow_key
+ *
+ * Description:
+ *   Fill the key of the flow a packet to be forwarded belongs to.  Only
+ *   the unfragmented TCP and UDP packets are cached, f_proto is left zero
+ *   for the others so neither the lookup nor the add will match them.
+ *
+ * Input Parameters:
+ *   dev       - The device on which the packet was received
+ *   ipv4/ipv6 - The IPv4/IPv6 header of the packet
+ *   flow      - The flow key to fill
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+#ifdef CONFIG_NET_IPv4
+void ipv4_flow_key(FAR struct net_driver_s *dev,
+                   FAR const struct ipv4_hdr_s *ipv4,
+                   FAR struct ipfwd_flow_s *flow);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void ipv6_flow_key(FAR struct net_driver_s *dev,
+                   FAR const struct ipv6_hdr_s *ipv6,
+                   FAR struct ipfwd_flow_s *flow);
+#endif
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_lookup
+ *
+ * Description:
+ *   Look up the device a flow is forwarded to.  A flow is only cached
+ *   after it has been routed and accepted by the forward filter, so the
+ *   packets of a hit can skip both.
+ *
+ * Input Parameters:
+ *   flow - The flow key from ipv4_flow_key() or ipv6_flow_key()
+ *
+ * Returned Value:
+ *   The forwarding device, or NULL if the flow isn't cached or the device
+ *   isn't running any more.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct net_driver_s *
+ipfwd_flow_lookup(FAR const struct ipfwd_flow_s *flow);
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_add
+ *
+ * Description:
+ *   Cache the forwarding device of a flow, replacing the flow which was in
+ *   its slot.
+ *
+ * Input Parameters:
+ *   flow   - The flow key from ipv4_flow_key() or ipv6_flow_key()
+ *   outdev - The device the flow has been forwarded to
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flow_add(FAR const struct ipfwd_flow_s *flow,
+                    FAR struct net_driver_s *outdev);
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Drop all the cached flows.  This must be called whenever the routing,
+ *   the forward filter, or the addresses and state of the devices change.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flow_flush(void);
+#endif
+
 /****************************************************************************
  * Name: ipv4_forward_broadcast
  *
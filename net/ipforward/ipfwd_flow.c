@@ -0,0 +1,290 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flow.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/udp.h>
+
+#include "ipforward/ipforward.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE & \
+     (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE - 1)) != 0
+#  error CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE must be a power of two
+#endif
+
+#define FLOW_MASK  (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE - 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The direct mapped flow cache, a new flow replaces the one in its slot */
+
+static struct ipfwd_flow_s g_flows[CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE];
+
+/* Serializes access to the flow cache, packets from different devices can
+ * be forwarded at the same time.
+ */
+
+static mutex_t g_flow_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flow_hash
+ *
+ * Description:
+ *   Return the slot of a flow in the cache.
+ *
+ ****************************************************************************/
+
+static unsigned int ipfwd_flow_hash(FAR const struct ipfwd_flow_s *flow)
+{
+  FAR const uint32_t *addr = (FAR const uint32_t *)&flow->f_addr;
+  uint32_t hash = (uint32_t)(uintptr_t)flow->f_indev ^ flow->f_proto;
+  unsigned int i;
+
+  for (i = 0; i < sizeof(flow->f_addr) / sizeof(uint32_t); i++)
+    {
+      hash ^= addr[i];
+    }
+
+  hash ^= ((uint32_t)flow->f_sport << 16) | flow->f_dport;
+
+  /* Fibonacci hashing spreads the bits to the top of the word */
+
+  return ((hash * 0x9e3779b1u) >> 16) & FLOW_MASK;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_match
+ ****************************************************************************/
+
+static bool ipfwd_flow_match(FAR const struct ipfwd_flow_s *entry,
+                             FAR const struct ipfwd_flow_s *flow)
+{
+  return entry->f_outdev != NULL && entry->f_indev == flow->f_indev &&
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+         entry->f_domain == flow->f_domain &&
+#endif
+         entry->f_proto == flow->f_proto &&
+         entry->f_sport == flow->f_sport &&
+         entry->f_dport == flow->f_dport &&
+         memcmp(&entry->f_addr, &flow->f_addr, sizeof(flow->f_addr)) == 0;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_ports
+ *
+ * Description:
+ *   Take the ports of a TCP or UDP header, which are at the same offset.
+ *
+ ****************************************************************************/
+
+static void ipfwd_flow_ports(FAR struct ipfwd_flow_s *flow,
+                             FAR const void *l4hdr, uint8_t proto)
+{
+  FAR const struct udp_hdr_s *udp = l4hdr;
+
+  flow->f_sport = udp->srcport;
+  flow->f_dport = udp->destport;
+  flow->f_proto = proto;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_key / ipv6_flow_key
+ *
+ * Description:
+ *   Fill the key of the flow a packet to be forwarded belongs to.  Only
+ *   the unfragmented TCP and UDP packets are cached, f_proto is left zero
+ *   for the others so neither the lookup nor the add will match them.
+ *
+ * Input Parameters:
+ *   dev       - The device on which the packet was received
+ *   ipv4/ipv6 - The IPv4/IPv6 header of the packet
+ *   flow      - The flow key to fill
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void ipv4_flow_key(FAR struct net_driver_s *dev,
+                   FAR const struct ipv4_hdr_s *ipv4,
+                   FAR struct ipfwd_flow_s *flow)
+{
+  uint16_t iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+
+  memset(flow, 0, sizeof(*flow));
+  if ((ipv4->proto != IP_PROTO_TCP && ipv4->proto != IP_PROTO_UDP) ||
+      (((ipv4->ipoffset[0] << 8) | ipv4->ipoffset[1]) &
+       ~IP_FLAG_DONTFRAG) != 0 ||
+      dev->d_len < iphdrlen + 4)
+    {
+      return;
+    }
+
+  flow->f_indev  = dev;
+#ifdef CONFIG_NET_IPv6
+  flow->f_domain = PF_INET;
+#endif
+  flow->f_addr.ipv4.src = net_ip4addr_conv32(ipv4->srcipaddr);
+  flow->f_addr.ipv4.dst = net_ip4addr_conv32(ipv4->destipaddr);
+  ipfwd_flow_ports(flow, (FAR const uint8_t *)ipv4 + iphdrlen,
+                   ipv4->proto);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void ipv6_flow_key(FAR struct net_driver_s *dev,
+                   FAR const struct ipv6_hdr_s *ipv6,
+                   FAR struct ipfwd_flow_s *flow)
+{
+  memset(flow, 0, sizeof(*flow));
+  if ((ipv6->proto != IP_PROTO_TCP && ipv6->proto != IP_PROTO_UDP) ||
+      dev->d_len < IPv6_HDRLEN + 4)
+    {
+      return;
+    }
+
+  flow->f_indev  = dev;
+#ifdef CONFIG_NET_IPv4
+  flow->f_domain = PF_INET6;
+#endif
+  net_ipv6addr_copy(flow->f_addr.ipv6.src, ipv6->srcipaddr);
+  net_ipv6addr_copy(flow->f_addr.ipv6.dst, ipv6->destipaddr);
+  ipfwd_flow_ports(flow, (FAR const uint8_t *)ipv6 + IPv6_HDRLEN,
+                   ipv6->proto);
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_lookup
+ *
+ * Description:
+ *   Look up the device a flow is forwarded to.  A flow is only cached
+ *   after it has been routed and accepted by the forward filter, so the
+ *   packets of a hit can skip both.
+ *
+ * Input Parameters:
+ *   flow - The flow key from ipv4_flow_key() or ipv6_flow_key()
+ *
+ * Returned Value:
+ *   The forwarding device, or NULL if the flow isn't cached or the device
+ *   isn't running any more.
+ *
+ ****************************************************************************/
+
+FAR struct net_driver_s *
+ipfwd_flow_lookup(FAR const struct ipfwd_flow_s *flow)
+{
+  FAR struct net_driver_s *outdev = NULL;
+  FAR struct ipfwd_flow_s *entry;
+
+  if (flow->f_proto == 0)
+    {
+      return NULL;
+    }
+
+  entry = &g_flows[ipfwd_flow_hash(flow)];
+
+  nxmutex_lock(&g_flow_lock);
+  if (ipfwd_flow_match(entry, flow) &&
+      IFF_IS_RUNNING(entry->f_outdev->d_flags))
+    {
+      outdev = entry->f_outdev;
+    }
+
+  nxmutex_unlock(&g_flow_lock);
+  return outdev;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_add
+ *
+ * Description:
+ *   Cache the forwarding device of a flow, replacing the flow which was in
+ *   its slot.
+ *
+ * Input Parameters:
+ *   flow   - The flow key from ipv4_flow_key() or ipv6_flow_key()
+ *   outdev - The device the flow has been forwarded to
+ *
+ ****************************************************************************/
+
+void ipfwd_flow_add(FAR const struct ipfwd_flow_s *flow,
+                    FAR struct net_driver_s *outdev)
+{
+  FAR struct ipfwd_flow_s *entry;
+
+  if (flow->f_proto == 0)
+    {
+      return;
+    }
+
+  entry = &g_flows[ipfwd_flow_hash(flow)];
+
+  nxmutex_lock(&g_flow_lock);
+  memcpy(entry, flow, sizeof(*entry));
+  entry->f_outdev = outdev;
+  nxmutex_unlock(&g_flow_lock);
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Drop all the cached flows.  This must be called whenever the routing,
+ *   the forward filter, or the addresses and state of the devices change.
+ *
+ ****************************************************************************/
+
+void ipfwd_flow_flush(void)
+{
+  nxmutex_lock(&g_flow_lock);
+  memset(g_flows, 0, sizeof(g_flows));
+  nxmutex_unlock(&g_flow_lock);
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -199,6 +200,8 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
  *              contains the IPv4 packet.
  *   fwdddev  - The device on which the packet must be forwarded.
  *   ipv4     - A pointer to the IPv4 header in within the IPv4 packet
+ *   filter   - Whether to apply the forward filter, false if the flow
+ *              cache has accepted the packet already.
  *
  * Returned Value:
  *   Zero is returned if the packet was successfully forward;  A negated
@@ -209,7 +212,7 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_dev_forward(FAR struct net_driver_s *dev,
                             FAR struct net_driver_s *fwddev,
-                            FAR struct ipv4_hdr_s *ipv4)
+                            FAR struct ipv4_hdr_s *ipv4, bool filter)
 {
   FAR struct forward_s *fwd = NULL;
 #ifdef CONFIG_DEBUG_NET_WARN
@@ -222,7 +225,7 @@ static int ipv4_dev_forward(FAR struct net_driver_s *dev,
    * replying any other errors.
    */
 
-  ret = ipv4_filter_fwd(dev, fwddev, ipv4);
+  ret = filter ? ipv4_filter_fwd(dev, fwddev, ipv4) : OK;
   if (ret < 0)
     {
       ninfo("Drop/Reject FORWARD packet due to filter %d\n", ret);
@@ -404,7 +407,7 @@ static int ipv4_forward_callback(FAR struct net_driver_s *fwddev,
 
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, true);
       if (ret < 0)
         {
           iob_free_chain(iob);
@@ -458,7 +461,11 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
 {
   in_addr_t destipaddr;
   in_addr_t srcipaddr;
-  FAR struct net_driver_s *fwddev;
+  FAR struct net_driver_s *fwddev = NULL;
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  struct ipfwd_flow_s flow;
+#endif
+  bool filter = true;
   int ret;
 #if defined(CONFIG_NET_ICMP) && !defined(CONFIG_NET_ICMP_NO_STACK)
   int icmp_reply_type;
@@ -470,7 +477,19 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
   srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
 
-  fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* A cached flow has been routed and accepted by the filter already */
+
+  ipv4_flow_key(dev, ipv4, &flow);
+  fwddev = ipfwd_flow_lookup(&flow);
+  filter = fwddev == NULL;
+#endif
+
+  if (fwddev == NULL)
+    {
+      fwddev = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+    }
+
   if (fwddev == NULL)
     {
       nwarn("WARNING: Not routable\n");
@@ -486,12 +505,21 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
     {
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, filter);
       if (ret < 0)
         {
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
           goto drop;
         }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      /* The flow is routed and accepted, let the next packets skip both */
+
+      if (filter)
+        {
+          ipfwd_flow_add(&flow, fwddev);
+        }
+#endif
     }
   else
     {
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -322,6 +323,8 @@ static int ipv6_packet_conversion(FAR struct net_driver_s *dev,
  *              contains the IPv6 packet.
  *   fwdddev  - The device on which the packet must be forwarded.
  *   ipv6     - A pointer to the IPv6 header in within the IPv6 packet
+ *   filter   - Whether to apply the forward filter, false if the flow
+ *              cache has accepted the packet already.
  *
  * Returned Value:
  *   Zero is returned if the packet was successfully forwarded;  A negated
@@ -332,7 +335,7 @@ static int ipv6_packet_conversion(FAR struct net_driver_s *dev,
 
 static int ipv6_dev_forward(FAR struct net_driver_s *dev,
                             FAR struct net_driver_s *fwddev,
-                            FAR struct ipv6_hdr_s *ipv6)
+                            FAR struct ipv6_hdr_s *ipv6, bool filter)
 {
   FAR struct forward_s *fwd = NULL;
 #ifdef CONFIG_DEBUG_NET_WARN
@@ -345,7 +348,7 @@ static int ipv6_dev_forward(FAR struct net_driver_s *dev,
    * replying any other errors.
    */
 
-  ret = ipv6_filter_fwd(dev, fwddev, ipv6);
+  ret = filter ? ipv6_filter_fwd(dev, fwddev, ipv6) : OK;
   if (ret < 0)
     {
       ninfo("Drop/Reject FORWARD packet due to filter %d\n", ret);
@@ -543,7 +546,7 @@ static int ipv6_forward_callback(FAR struct net_driver_s *fwddev,
 
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv6_dev_forward(dev, fwddev, ipv6);
+      ret = ipv6_dev_forward(dev, fwddev, ipv6, true);
       if (ret < 0)
         {
           iob_free_chain(iob);
@@ -595,7 +598,11 @@ static int ipv6_forward_callback(FAR struct net_driver_s *fwddev,
 
 int ipv6_forward(FAR struct net_driver_s *dev, FAR struct ipv6_hdr_s *ipv6)
 {
-  FAR struct net_driver_s *fwddev;
+  FAR struct net_driver_s *fwddev = NULL;
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  struct ipfwd_flow_s flow;
+#endif
+  bool filter = true;
   int ret;
 #ifdef CONFIG_NET_ICMPv6
   int icmpv6_reply_type;
@@ -605,7 +612,19 @@ int ipv6_forward(FAR struct net_driver_s *dev, FAR struct ipv6_hdr_s *ipv6)
 
   /* Search for a device that can forward this packet. */
 
-  fwddev = netdev_findby_ripv6addr(ipv6->srcipaddr, ipv6->destipaddr);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* A cached flow has been routed and accepted by the filter already */
+
+  ipv6_flow_key(dev, ipv6, &flow);
+  fwddev = ipfwd_flow_lookup(&flow);
+  filter = fwddev == NULL;
+#endif
+
+  if (fwddev == NULL)
+    {
+      fwddev = netdev_findby_ripv6addr(ipv6->srcipaddr, ipv6->destipaddr);
+    }
+
   if (fwddev == NULL)
     {
       nwarn("WARNING: Not routable\n");
@@ -621,12 +640,21 @@ int ipv6_forward(FAR struct net_driver_s *dev, FAR struct ipv6_hdr_s *ipv6)
     {
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv6_dev_forward(dev, fwddev, ipv6);
+      ret = ipv6_dev_forward(dev, fwddev, ipv6, filter);
       if (ret < 0)
         {
           nwarn("WARNING: ipv6_dev_forward failed: %d\n", ret);
           goto drop;
         }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      /* The flow is routed and accepted, let the next packets skip both */
+
+      if (filter)
+        {
+          ipfwd_flow_add(&flow, fwddev);
+        }
+#endif
     }
   else
 #if defined(CONFIG_NET_6LOWPAN) /* REVISIT:  Currently only support for 6LoWPAN */
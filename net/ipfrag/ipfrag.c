@@ -92,9 +92,15 @@ do  \
 #define IOBUF_CNT(ptr)    (((ptr)->io_pktlen + CONFIG_IOB_BUFSIZE - 1)/ \
                           CONFIG_IOB_BUFSIZE)
 
-/* The maximum I/O buffer occupied by fragment reassembly cache */
+/* The maximum I/O buffer occupied by fragment reassembly cache, a fifth
+ * of the I/O buffer pool if not configured.
+ */
 
-#define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
+#if CONFIG_NET_IPFRAG_REASS_MAXIOB > 0
+#  define REASSEMBLY_MAXOCCUPYIOB      CONFIG_NET_IPFRAG_REASS_MAXIOB
+#else
+#  define REASSEMBLY_MAXOCCUPYIOB      (CONFIG_IOB_NBUFFERS / 5)
+#endif
 
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
@@ -117,7 +123,13 @@ static struct work_s g_wkfragtimeout;
 
 /* Remember the number of I/O buffers currently in reassembly cache */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
+
+/* The node the latest fragment went to, the following fragments of the
+ * same datagram usually come back to back.
+ */
+
+static FAR struct ip_fragsnode_s *g_lastnode;
 
 /* Queue header definition, it links all fragments of all NICs by ascending
  * ipid.
@@ -149,7 +161,6 @@ static void ip_fragin_timerout_expiry(wdparm_t arg);
 static void ip_fragin_timerwork(FAR void *arg);
 static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
@@ -227,6 +238,7 @@ static void ip_fragin_timerwork(FAR void *arg)
            */
 
           ninfo("Reassembly timeout occurs!");
+          IPFRAG_STATS(timeout);
 #if defined(CONFIG_NET_ICMP) && !defined(CONFIG_NET_ICMP_NO_STACK)
           if ((node->verifyflag & IP_FRAGVERIFY_RECVDZEROFRAG) != 0)
             {
@@ -362,51 +374,6 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
   return next;
 }
 
-/****************************************************************************
- * Name: ip_fragin_check
- *
- * Description:
- *   Check whether the zero fragment has been received or all fragments have
- *   been received.
- *
- * Input Parameters:
- *   fragsnode - node of the upper-level linked list, it maintains
- *               information bout all fragments belonging to an IP datagram
- *
- * Returned Value:
- *   None
- *
- ****************************************************************************/
-
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
-{
-  uint16_t formerlen = 0;
-  FAR struct ip_fraglink_s *entry;
-
-  if (fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG)
-    {
-      entry = fragsnode->frags;
-      while (entry != NULL)
-        {
-          if (entry->morefrags)
-            {
-              formerlen += entry->fraglen;
-            }
-          else
-            {
-              /* Only the last entry has a 0 morefrags flag */
-
-              if (entry->fragoff == formerlen)
-                {
-                  fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
-                }
-            }
-
-          entry = entry->flink;
-        }
-    }
-}
-
 /****************************************************************************
  * Name: ip_fragin_cachemonitor
  *
@@ -465,6 +432,7 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
 
               bufcnt = ip_frag_remnode(node);
               kmm_free(node);
+              IPFRAG_STATS(evict);
 
               cleancnt = cleancnt > bufcnt ? cleancnt - bufcnt : 0;
             }
@@ -527,8 +495,13 @@ ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq)
 
 uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
 {
+  DEBUGASSERT(g_bufoccupy >= node->bufcnt);
   g_bufoccupy -= node->bufcnt;
-  ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
+
+  if (g_lastnode == node)
+    {
+      g_lastnode = NULL;
+    }
 
   sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
   sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
@@ -551,83 +524,85 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   1 if the queue was empty before enqueue the new node, 0 if not, or
+ *   -ENOMEM if no node could be allocated for a new IP ID.
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink)
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink)
 {
   FAR struct ip_fragsnode_s *node;
+  FAR struct ip_fraglink_s  *fraglink;
+  FAR struct ip_fraglink_s  *lastlink = NULL;
   FAR sq_entry_t            *entry;
   FAR sq_entry_t            *entrylast = NULL;
+  uint32_t                   bufcnt = IOBUF_CNT(curfraglink->frag);
   bool                       empty;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
-   */
+  IPFRAG_STATS(recv);
 
   entry = sq_peek(&g_assemblyhead_ipid);
   empty = (entry == NULL) ? true : false;
 
-  while (entry != NULL)
-    {
-      node = (struct ip_fragsnode_s *)entry;
+  /* Try the node of the previous fragment first, otherwise walk through
+   * the linked list which is ordered by IP ID value and try to find a node
+   * that has the same IP ID value.  If there is none a new node need to be
+   * created and inserted into the linked list.
+   */
 
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+  node = g_lastnode;
+  if (node == NULL || node->dev != dev || node->ipid != curfraglink->ipid)
+    {
+      while (entry != NULL)
         {
-          break;
+          node = (struct ip_fragsnode_s *)entry;
+
+          if (dev == node->dev && curfraglink->ipid <= node->ipid)
+            {
+              break;
+            }
+
+          entrylast = entry;
+          entry = sq_next(entry);
         }
 
-      entrylast = entry;
-      entry = sq_next(entry);
+      node = (FAR struct ip_fragsnode_s *)entry;
+      if (node != NULL && curfraglink->ipid != node->ipid)
+        {
+          node = NULL;
+        }
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
-
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node != NULL)
     {
-      FAR struct ip_fraglink_s *fraglink;
-      FAR struct ip_fraglink_s *lastlink = NULL;
-
       /* Found a previously created ip_fragsnode_s, insert this new
-       * ip_fraglink_s to the subchain of this node.
+       * ip_fraglink_s to the subchain of this node which is ordered by
+       * fragment offset value.  The fragments mostly arrive in order, so
+       * check the tail of the subchain before walking through it.
        */
 
-      fraglink = node->frags;
-
-      /* An ip_fragsnode_s must have an ip_fraglink_s because we allocate a
-       * new ip_fraglink_s when caching a new ip_fraglink_s with a new IP ID
-       */
+      lastlink = node->lastfrag;
+      fraglink = NULL;
 
-      while (fraglink != NULL)
+      if (curfraglink->fragoff <= lastlink->fragoff)
         {
-          /* The fragment list is ordered by fragment offset value */
+          /* An ip_fragsnode_s must have an ip_fraglink_s because we
+           * allocate a new ip_fraglink_s when caching a new ip_fraglink_s
+           * with a new IP ID
+           */
+
+          lastlink = NULL;
+          fraglink = node->frags;
 
-          if (curfraglink->fragoff <= fraglink->fragoff)
+          while (curfraglink->fragoff > fraglink->fragoff)
             {
-              break;
+              lastlink = fraglink;
+              fraglink = fraglink->flink;
             }
-
-          lastlink = fraglink;
-          fraglink = fraglink->flink;
         }
 
-      if (fraglink == NULL)
-        {
-          /* This fragment offset is greater than the previous fragments,
-           * added to the last position
-           */
-
-          lastlink->flink      = curfraglink;
-
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
-      else if (curfraglink->fragoff == fraglink->fragoff)
+      if (fraglink != NULL && curfraglink->fragoff == fraglink->fragoff)
         {
           /* Fragments with same offset value contain the same data, use the
            * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
@@ -644,33 +619,47 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
               lastlink->flink = curfraglink;
             }
 
+          if (node->lastfrag == fraglink)
+            {
+              node->lastfrag = curfraglink;
+            }
+
+          if (fraglink->morefrags)
+            {
+              node->morelen -= fraglink->fraglen;
+            }
+
+          node->bufcnt -= IOBUF_CNT(fraglink->frag);
+          g_bufoccupy  -= IOBUF_CNT(fraglink->frag);
+
           iob_free_chain(fraglink->frag);
           kmm_free(fraglink);
+          IPFRAG_STATS(dup);
+        }
+      else if (lastlink == NULL)
+        {
+          /* Insert before the first node */
+
+          curfraglink->flink = node->frags;
+          node->frags = curfraglink;
         }
       else
         {
-          /* Insert into the fragment list */
+          /* Insert this node after lastlink */
 
-          if (lastlink == NULL)
-            {
-              /* Insert before the first node */
+          curfraglink->flink = lastlink->flink;
+          lastlink->flink = curfraglink;
 
-              curfraglink->flink = node->frags;
-              node->frags = curfraglink;
-            }
-          else
+          if (node->lastfrag == lastlink)
             {
-              /* Insert this node after lastlink */
-
-              curfraglink->flink = lastlink->flink;
-              lastlink->flink = curfraglink;
+              node->lastfrag = curfraglink;
             }
+        }
 
-          /* Remember I/O buffer count */
+      /* Remember I/O buffer count */
 
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
+      node->bufcnt += bufcnt;
+      g_bufoccupy  += bufcnt;
     }
   else
     {
@@ -682,6 +671,7 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       if (node == NULL)
         {
           nerr("ERROR: Failed to allocate buffer.\n");
+          IPFRAG_STATS(nomem);
           return -ENOMEM;
         }
 
@@ -690,9 +680,11 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->dev        = dev;
       node->ipid       = curfraglink->ipid;
       node->frags      = curfraglink;
+      node->lastfrag   = curfraglink;
+      node->morelen    = 0;
       node->tick       = clock_systime_ticks();
-      node->bufcnt     = IOBUF_CNT(curfraglink->frag);
-      g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
+      node->bufcnt     = bufcnt;
+      g_bufoccupy     += bufcnt;
       node->verifyflag = 0;
       node->outgoframe = NULL;
 
@@ -723,20 +715,33 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDZEROFRAG;
     }
-  else if (!curfraglink->morefrags)
+
+  if (curfraglink->morefrags)
+    {
+      node->morelen += curfraglink->fraglen;
+    }
+  else
     {
       /* Have received the tail fragment */
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDTAILFRAG;
     }
 
-  /* For indexing convenience */
+  /* All fragments have been received once the tail fragment is the last
+   * one and the payload of the fragments ahead of it adds up to its offset.
+   */
 
-  curfraglink->fragsnode = node;
+  lastlink = node->lastfrag;
+  if ((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0 &&
+      !lastlink->morefrags && lastlink->fragoff == node->morelen)
+    {
+      node->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
+    }
 
-  /* Check receiving status */
+  /* For indexing convenience */
 
-  ip_fragin_check(node);
+  curfraglink->fragsnode = node;
+  g_lastnode = node;
 
   /* Buffer is take away, clear original pointers in NIC */
 
@@ -1204,6 +1209,7 @@ void ip_frag_remallfrags(void)
 
   sq_init(&g_assemblyhead_time);
   g_bufoccupy = 0;
+  g_lastnode  = NULL;
 
   nxmutex_unlock(&g_ipfrag_lock);
 
@@ -1266,6 +1272,10 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
 
   ninfo("pkt size: %d, MTU: %d\n", dev->d_iob->io_pktlen, mtu);
 
+  /* The hardware can't complete the checksum over the fragments */
+
+  netdev_checksum_complete(dev);
+
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv4(dev->d_flags))
     {
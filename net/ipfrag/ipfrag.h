@@ -39,11 +39,22 @@
 #include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
 
 #if defined(CONFIG_NET_IPFRAG)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS
+#  define IPFRAG_STATS(name)  (g_netstats.ipfrag.name++)
+#else
+#  define IPFRAG_STATS(name)
+#endif
+
 /****************************************************************************
  * Public types
  ****************************************************************************/
@@ -132,6 +143,18 @@ struct ip_fragsnode_s
 
   FAR struct ip_fraglink_s  *frags;
 
+  /* The fragment with the highest offset, where the in-order fragments are
+   * appended without walking through the list
+   */
+
+  FAR struct ip_fraglink_s  *lastfrag;
+
+  /* Total payload length of the fragments with the more frag flag set,
+   * which equals the offset of the tail fragment once all have arrived
+   */
+
+  uint32_t                   morelen;
+
   /* Points to the reassembled outgoing IP frame */
 
   FAR struct iob_s          *outgoframe;
@@ -191,12 +214,13 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   1 if the queue was empty before enqueue the new node, 0 if not, or
+ *   -ENOMEM if no node could be allocated for a new IP ID.
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink);
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink);
 
 /****************************************************************************
  * Name: ipv4_fragin
@@ -262,6 +262,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
   FAR struct ip_fragsnode_s *node;
   FAR struct ip_fraglink_s *fraginfo;
   bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -273,6 +274,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
   if (fraginfo == NULL)
     {
       nerr("ERROR: Failed to allocate buffer.\n");
+      IPFRAG_STATS(nomem);
       return -ENOMEM;
     }
 
@@ -284,7 +286,15 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
+
+  restartwdog = ret > 0;
 
   node = fraginfo->fragsnode;
 
@@ -296,6 +306,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
        */
 
       ip_frag_remnode(node);
+      IPFRAG_STATS(reass);
 
       /* All fragments belonging to one IP frame have been separated
        * from the fragment processing module, unlocks mutex as soon
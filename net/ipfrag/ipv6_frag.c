@@ -469,6 +469,7 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
   FAR struct ip_fragsnode_s *node = NULL;
   FAR struct ip_fraglink_s *fraginfo = NULL;
   bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -480,6 +481,7 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
   if (fraginfo == NULL)
     {
       nerr("ERROR: Failed to allocate buffer.\n");
+      IPFRAG_STATS(nomem);
       return -ENOMEM;
     }
 
@@ -491,7 +493,15 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
+
+  restartwdog = ret > 0;
 
   node = fraginfo->fragsnode;
   if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
@@ -502,6 +512,7 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
        */
 
       ip_frag_remnode(node);
+      IPFRAG_STATS(reass);
 
       /* All fragments belonging to one IP frame have been separated
        * from the fragment processing module, unlocks mutex as soon
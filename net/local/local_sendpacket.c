@@ -91,6 +91,89 @@ static int local_fifo_write(FAR struct file *filep, FAR const uint8_t *buf,
   return nwritten > 0 ? nwritten : ret;
 }
 
+/****************************************************************************
+ * Name: local_fifo_writev
+ *
+ * Description:
+ *   Gather a vector of data on the write-only FIFO, handing as much of it
+ *   as possible to the pipe in one call.
+ *
+ * Input Parameters:
+ *   filep    File structure of write-only FIFO.
+ *   buf      Vector of data to send
+ *   len      Number of the entries in the vector
+ *
+ * Returned Value:
+ *   On success, the number of bytes written are returned (zero indicates
+ *   nothing was written).  On any failure, a negated errno value is returned
+ *
+ ****************************************************************************/
+
+static ssize_t local_fifo_writev(FAR struct file *filep,
+                                 FAR const struct iovec *buf, size_t len)
+{
+  FAR const struct iovec *end = buf + len;
+  ssize_t nwritten = 0;
+  ssize_t ret = 0;
+
+  while (buf != end)
+    {
+      ret = file_writev(filep, buf, end - buf);
+      if (ret < 0)
+        {
+          if (ret == -EINTR)
+            {
+              continue;
+            }
+          else if (ret != -EAGAIN)
+            {
+              nerr("ERROR: file_writev failed: %zd\n", ret);
+            }
+
+          break;
+        }
+
+      else if (ret == 0)
+        {
+          break;
+        }
+
+      nwritten += ret;
+
+      /* Skip the entries written completely */
+
+      while (buf != end && (size_t)ret >= buf->iov_len)
+        {
+          ret -= buf->iov_len;
+          buf++;
+        }
+
+      /* Finish the entry the pipe filled up in, then go on with the rest */
+
+      if (ret > 0)
+        {
+          size_t remain = buf->iov_len - ret;
+
+          ret = local_fifo_write(filep, (FAR const uint8_t *)buf->iov_base +
+                                 ret, remain);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          nwritten += ret;
+          if ((size_t)ret != remain)
+            {
+              break;
+            }
+
+          buf++;
+        }
+    }
+
+  return nwritten > 0 ? nwritten : ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -120,11 +203,12 @@ int local_send_preamble(FAR struct local_conn_s *conn,
 {
   FAR const struct iovec *end = buf + len;
   FAR const struct iovec *iov;
-  int ret;
+  struct iovec preamble[3];
+  ssize_t ret;
   lc_size_t pathlen;
   lc_size_t pktlen;
 
-  /* Send the packet length */
+  /* Get the packet length */
 
   for (pktlen = 0, iov = buf; iov != end; iov++)
     {
@@ -137,24 +221,27 @@ int local_send_preamble(FAR struct local_conn_s *conn,
       return -EMSGSIZE;
     }
 
+  /* Hand the whole preamble to the FIFO in one write, so that it takes
+   * the pipe lock and wakes up the reader only once.
+   */
+
   pathlen = strlen(conn->lc_path);
-  ret = local_fifo_write(&conn->lc_outfile, (FAR const uint8_t *)&pathlen,
-                         sizeof(lc_size_t));
-  if (ret != sizeof(lc_size_t))
-    {
-      nerr("ERROR: local send path length failed ret: %d\n", ret);
-      return ret;
-    }
 
-  ret = local_fifo_write(filep, (FAR const uint8_t *)&pktlen,
-                         sizeof(lc_size_t));
-  if (ret != sizeof(lc_size_t))
+  preamble[0].iov_base = &pathlen;
+  preamble[0].iov_len  = sizeof(lc_size_t);
+  preamble[1].iov_base = &pktlen;
+  preamble[1].iov_len  = sizeof(lc_size_t);
+  preamble[2].iov_base = conn->lc_path;
+  preamble[2].iov_len  = pathlen;
+
+  ret = local_fifo_writev(filep, preamble, 3);
+  if (ret != (ssize_t)(2 * sizeof(lc_size_t) + pathlen))
     {
-      return ret;
+      nerr("ERROR: local send preamble failed ret: %zd\n", ret);
+      return ret < 0 ? ret : -EIO;
     }
 
-  return local_fifo_write(&conn->lc_outfile, (uint8_t *)conn->lc_path,
-                          pathlen);
+  return pathlen;
 }
 
 /****************************************************************************
@@ -177,33 +264,13 @@ int local_send_preamble(FAR struct local_conn_s *conn,
 int local_send_packet(FAR struct file *filep, FAR const struct iovec *buf,
                       size_t len)
 {
-  FAR const struct iovec *end = buf + len;
-  FAR const struct iovec *iov;
-  int ret = -EINVAL;
-  lc_size_t sendlen;
+  ssize_t ret;
 
-  for (sendlen = 0, iov = buf; iov != end; iov++)
+  ret = local_fifo_writev(filep, buf, len);
+  if (ret < 0 && ret != -EAGAIN)
     {
-      ret = local_fifo_write(filep, iov->iov_base, iov->iov_len);
-      if (ret < 0)
-        {
-          if (ret != -EAGAIN)
-            {
-              nerr("ERROR: local send packet failed ret: %d\n", ret);
-            }
-
-          break;
-        }
-
-      if (ret > 0)
-        {
-          sendlen += ret;
-          if (ret != iov->iov_len)
-            {
-              break;
-            }
-        }
+      nerr("ERROR: local send packet failed ret: %zd\n", ret);
     }
 
-  return sendlen > 0 ? sendlen : ret;
+  return ret;
 }
@@ -38,6 +38,18 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_IPv6_NCONF_NHASH
+#  define CONFIG_NET_IPv6_NCONF_NHASH 8
+#endif
+
+/* The next entry in the hash bucket of a Neighbor Table entry */
+
+#define NEIGHBOR_HNEXT(ne) g_neighbor_hnext[(ne) - g_neighbors]
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -48,12 +60,31 @@
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The hash buckets of the entries in use, by the IPv6 address.  The chains
+ * are kept apart from the entries, which are copied to the netlink as is.
+ */
+
+extern FAR struct neighbor_entry_s *
+  g_neighbor_hash[CONFIG_NET_IPv6_NCONF_NHASH];
+extern FAR struct neighbor_entry_s *
+  g_neighbor_hnext[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash bucket of an IPv6 address in the Neighbor Table.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s **neighbor_hash(const net_ipv6addr_t ipaddr);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -176,7 +207,8 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev);
  *
  * Returned Value:
  *   On success, the number of entries actually copied is returned.  Unused
- *   entries are not returned.
+ *   entries are not returned.  If 'snapshot' is NULL, nothing is copied
+ *   and the number of valid entries (up to 'nentries') is returned.
  *
  * Assumptions
  *   The network is locked to assure exclusive access to the ARP table
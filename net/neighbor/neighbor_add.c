@@ -41,6 +41,34 @@
 #include "netlink/netlink.h"
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash_remove
+ *
+ * Description:
+ *   Remove an entry from its hash bucket.
+ *
+ ****************************************************************************/
+
+static void neighbor_hash_remove(FAR struct neighbor_entry_s *neighbor)
+{
+  FAR struct neighbor_entry_s **pp = neighbor_hash(neighbor->ne_ipaddr);
+
+  for (; *pp != NULL; pp = &NEIGHBOR_HNEXT(*pp))
+    {
+      if (*pp == neighbor)
+        {
+          *pp = NEIGHBOR_HNEXT(neighbor);
+          break;
+        }
+    }
+
+  NEIGHBOR_HNEXT(neighbor) = NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,6 +93,8 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s **bucket;
+  FAR struct neighbor_entry_s *neighbor;
   uint8_t lltype;
   clock_t oldest_time;
   int     oldest_ndx;
@@ -74,6 +104,11 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
+  if (net_is_addr_unspecified(ipaddr))
+    {
+      return;
+    }
+
   /* Find the matching entry, first unused entry, or the oldest used entry.
    * The unused entry will have ne_time == 0 and should generate the oldest
    * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
@@ -83,17 +118,22 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
   oldest_time = g_neighbors[0].ne_time;
   oldest_ndx  = 0;
   lltype      = dev->d_lltype;
+  bucket      = neighbor_hash(ipaddr);
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = *bucket; neighbor != NULL;
+       neighbor = NEIGHBOR_HNEXT(neighbor))
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      if (neighbor->ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
+          oldest_ndx = neighbor - g_neighbors;
           found = true;
           break;
         }
+    }
 
+  for (i = 0; !found && i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+    {
       if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
         {
           oldest_ndx = i;
@@ -109,6 +149,13 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                            AF_INET6);
     }
 
+  /* The entries in use are the ones with an IPv6 address */
+
+  if (!found && !net_is_addr_unspecified(g_neighbors[oldest_ndx].ne_ipaddr))
+    {
+      neighbor_hash_remove(&g_neighbors[oldest_ndx]);
+    }
+
   /* Need to notify when entry is not found or changes in table */
 
   new_entry = !found || memcmp(&g_neighbors[oldest_ndx].ne_addr.u, addr,
@@ -128,6 +175,12 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
   memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
          g_neighbors[oldest_ndx].ne_addr.na_llsize);
 
+  if (!found)
+    {
+      NEIGHBOR_HNEXT(&g_neighbors[oldest_ndx]) = *bucket;
+      *bucket = &g_neighbors[oldest_ndx];
+    }
+
   /* Notify the new entry */
 
   if (new_entry)
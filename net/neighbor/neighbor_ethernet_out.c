@@ -98,6 +98,7 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev)
 {
   FAR struct eth_hdr_s *eth = ETHBUF;
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
+  FAR struct neighbor_entry_s *ne;
   struct neighbor_addr_s laddr;
 
   /* Find the destination IPv6 address in the Neighbor Table and construct
@@ -150,10 +151,21 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev)
         }
 
       /* Check if we already have this destination address in the
-       * Neighbor Table.
+       * Neighbor Table, the last hit of the device first.
        */
 
-      if (neighbor_lookup(ipaddr, &laddr) < 0)
+      ne = dev->d_nelast;
+      if (ne == NULL || !net_ipv6addr_cmp(ne->ne_ipaddr, ipaddr))
+        {
+          ne = neighbor_findentry(ipaddr);
+          dev->d_nelast = ne;
+        }
+
+      if (ne != NULL)
+        {
+          memcpy(&laddr, &ne->ne_addr, sizeof(laddr));
+        }
+      else if (neighbor_lookup(ipaddr, &laddr) < 0)
         {
 #ifdef NET_ICMPv6_HAVE_STACK
           /* No ARP packet if this device do not support ARP */
@@ -31,10 +31,40 @@
 
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_IPv6_NCONF_NHASH & (CONFIG_NET_IPv6_NCONF_NHASH - 1)) != 0
+#  error CONFIG_NET_IPv6_NCONF_NHASH must be a power of two
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash bucket of an IPv6 address in the Neighbor Table.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s **neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      hash ^= ((uint32_t)ipaddr[i] << 16) | ipaddr[i + 1];
+    }
+
+  hash *= 0x9e3779b1u;
+  return &g_neighbor_hash[(hash >> 16) & (CONFIG_NET_IPv6_NCONF_NHASH - 1)];
+}
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -53,12 +83,11 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry_s *neighbor;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = *neighbor_hash(ipaddr); neighbor != NULL;
+       neighbor = NEIGHBOR_HNEXT(neighbor))
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
-
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
           neighbor_dumpentry("Entry found", neighbor);
@@ -38,6 +38,13 @@
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The hash buckets of the entries in use, by the IPv6 address.  The chains
+ * are kept apart from the entries, which are copied to the netlink as is.
+ */
+
+FAR struct neighbor_entry_s *g_neighbor_hash[CONFIG_NET_IPv6_NCONF_NHASH];
+FAR struct neighbor_entry_s *g_neighbor_hnext[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
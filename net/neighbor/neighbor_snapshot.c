@@ -53,7 +53,8 @@
  *
  * Returned Value:
  *   On success, the number of entries actually copied is returned.  Unused
- *   entries are not returned.
+ *   entries are not returned.  If 'snapshot' is NULL, nothing is copied
+ *   and the number of valid entries (up to 'nentries') is returned.
  *
  * Assumptions
  *   The network is locked to assure exclusive access to the ARP table
@@ -81,8 +82,12 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
 
       if (!net_ipv6addr_cmp(neighbor->ne_ipaddr, g_ipv6_unspecaddr))
         {
-          memcpy(&snapshot[ncopied], neighbor,
-                 sizeof(struct neighbor_entry_s));
+          if (snapshot != NULL)
+            {
+              memcpy(&snapshot[ncopied], neighbor,
+                     sizeof(struct neighbor_entry_s));
+            }
+
           ncopied++;
         }
     }
@@ -617,6 +617,24 @@ void netdev_list_lock(void);
 
 void netdev_list_unlock(void);
 
+/****************************************************************************
+ * Name: netdev_list_read_lock and netdev_list_read_unlock
+ *
+ * Description:
+ *   Enter and leave a lookup of the network device list.  The lookup
+ *   doesn't block the registration and the device stays linked until the
+ *   lookups which may see it are left.  The section must not modify the
+ *   list.
+ *
+ * Returned Value:
+ *   netdev_list_read_lock() returns the value to pass to
+ *   netdev_list_read_unlock().
+ *
+ ****************************************************************************/
+
+int netdev_list_read_lock(void);
+void netdev_list_read_unlock(int epoch);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
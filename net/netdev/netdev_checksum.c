@@ -262,3 +262,98 @@ uint16_t netdev_upperlayer_header_checksum(FAR struct net_driver_s *dev)
 
   return 0;
 }
+
+/****************************************************************************
+ * Name: netdev_checksum_complete
+ *
+ * Description:
+ *   Complete in software the TCP or UDP checksum left to the hardware,
+ *   for the packet which is not handed to the driver right away, or is
+ *   looped back to ourself.
+ *
+ * Input Parameters:
+ *   dev  -  The driver structure
+ *
+ ****************************************************************************/
+
+void netdev_checksum_complete(FAR struct net_driver_s *dev)
+{
+#if defined(CONFIG_NET_UDP) || defined(CONFIG_NET_TCP)
+  FAR uint8_t *l4hdr;
+  uint8_t proto;
+  uint16_t sum;
+
+  if (!dev->d_txcsum || dev->d_iob == NULL)
+    {
+      return;
+    }
+
+  dev->d_txcsum = false;
+  proto = hardware_chksum_get_proto(dev);
+  l4hdr = IOB_DATA(dev->d_iob);
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#  endif
+    {
+      l4hdr += IPv6_HDRLEN;
+    }
+#endif
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      l4hdr += (IPv4BUF->vhl & IPv4_HLMASK) << 2;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP
+  if (proto == IP_PROTO_TCP)
+    {
+      ((FAR struct tcp_hdr_s *)l4hdr)->tcpchksum = 0;
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP
+  if (proto == IP_PROTO_UDP)
+    {
+      ((FAR struct udp_hdr_s *)l4hdr)->udpchksum = 0;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#  endif
+    {
+      sum = ~ipv6_upperlayer_chksum(dev, proto, IPv6_HDRLEN);
+    }
+#endif
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      sum = ~ipv4_upperlayer_chksum(dev, proto);
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP
+  if (proto == IP_PROTO_TCP)
+    {
+      ((FAR struct tcp_hdr_s *)l4hdr)->tcpchksum = sum;
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP
+  if (proto == IP_PROTO_UDP)
+    {
+      ((FAR struct udp_hdr_s *)l4hdr)->udpchksum = sum == 0 ? 0xffff : sum;
+    }
+#endif
+#else
+  dev->d_txcsum = false;
+#endif
+}
@@ -56,9 +56,10 @@ int netdev_count(void)
 {
   struct net_driver_s *dev;
   int ndev;
+  int epoch;
 
-  netdev_list_lock();
+  epoch = netdev_list_read_lock();
   for (dev = g_netdevices, ndev = 0; dev; dev = dev->flink, ndev++);
-  netdev_list_unlock();
+  netdev_list_read_unlock(epoch);
   return ndev;
 }
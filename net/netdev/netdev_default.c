@@ -60,10 +60,11 @@ FAR struct net_driver_s *netdev_default(void)
 {
   FAR struct net_driver_s *ret = NULL;
   FAR struct net_driver_s *dev;
+  int epoch;
 
   /* Examine each registered network device */
 
-  netdev_list_lock();
+  epoch = netdev_list_read_lock();
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "running" state? */
@@ -84,6 +85,6 @@ FAR struct net_driver_s *netdev_default(void)
         }
     }
 
-  netdev_list_unlock();
+  netdev_list_read_unlock(epoch);
   return ret;
 }
@@ -74,13 +74,14 @@ netdev_prefixlen_findby_lipv4addr(in_addr_t lipaddr, FAR int8_t *prefixlen)
   FAR struct net_driver_s *dev;
   FAR struct net_driver_s *bestdev  = NULL;
   int8_t                   bestpref = -1;
+  int                      epoch;
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
   int8_t len;
 #endif
 
   /* Examine each registered network device */
 
-  netdev_list_lock();
+  epoch = netdev_list_read_lock();
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "running" state? */
@@ -140,7 +141,7 @@ netdev_prefixlen_findby_lipv4addr(in_addr_t lipaddr, FAR int8_t *prefixlen)
         }
     }
 
-  netdev_list_unlock();
+  netdev_list_read_unlock(epoch);
   *prefixlen = bestpref;
   return bestdev;
 }
@@ -172,6 +173,7 @@ netdev_prefixlen_findby_lipv6addr(const net_ipv6addr_t lipaddr,
   FAR struct net_driver_s *dev;
   FAR struct net_driver_s *bestdev  = NULL;
   int16_t                  bestpref = -1;
+  int                      epoch;
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
   FAR struct netdev_ifaddr6_s *ifaddr6;
   FAR struct neighbor_entry_s *ne;
@@ -179,7 +181,7 @@ netdev_prefixlen_findby_lipv6addr(const net_ipv6addr_t lipaddr,
   int16_t len;
 #endif
 
-  netdev_list_lock();
+  epoch = netdev_list_read_lock();
 
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
   /* Find a hint from neighbor table in case same prefix length exists on
@@ -244,7 +246,7 @@ netdev_prefixlen_findby_lipv6addr(const net_ipv6addr_t lipaddr,
         }
     }
 
-  netdev_list_unlock();
+  netdev_list_read_unlock(epoch);
   *prefixlen = bestpref;
   return bestdev;
 }
@@ -58,6 +58,7 @@
 FAR struct net_driver_s *netdev_findbyindex(int ifindex)
 {
   FAR struct net_driver_s *dev;
+  int epoch;
 #ifdef CONFIG_NETDEV_IFINDEX
   /* The bit index is the interface index minus one.  Zero is reserved in
    * POSIX to mean no interface index.
@@ -72,7 +73,7 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
 
 #endif
 
-  netdev_list_lock();
+  epoch = netdev_list_read_lock();
 
 #ifdef CONFIG_NETDEV_IFINDEX
   /* Check if this index has been assigned */
@@ -81,7 +82,7 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
     {
       /* This index has not been assigned */
 
-      netdev_list_unlock();
+      netdev_list_read_unlock(epoch);
       return NULL;
     }
 #endif
@@ -104,12 +105,12 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
       if (++i == ifindex)
 #endif
         {
-          netdev_list_unlock();
+          netdev_list_read_unlock(epoch);
           return dev;
         }
     }
 
-  netdev_list_unlock();
+  netdev_list_read_unlock(epoch);
   return NULL;
 }
 
@@ -132,6 +133,8 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
 #ifdef CONFIG_NETDEV_IFINDEX
 int netdev_nextindex(int ifindex)
 {
+  int epoch;
+
   /* The bit index is the interface index minus one.  Zero is reserved in
    * POSIX to mean no interface index.
    */
@@ -141,7 +144,7 @@ int netdev_nextindex(int ifindex)
 
   if (ifindex >= 0 && ifindex < MAX_IFINDEX)
     {
-      netdev_list_lock();
+      epoch = netdev_list_read_lock();
       for (; ifindex < MAX_IFINDEX; ifindex++)
         {
           if ((g_devset & (1UL << ifindex)) != 0)
@@ -150,12 +153,12 @@ int netdev_nextindex(int ifindex)
                * mean no-index in the POSIX standards.
                */
 
-              netdev_list_unlock();
+              netdev_list_read_unlock(epoch);
               return ifindex + 1;
             }
         }
 
-      netdev_list_unlock();
+      netdev_list_read_unlock(epoch);
     }
 
   return -ENODEV;
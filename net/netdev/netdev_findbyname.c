@@ -56,20 +56,21 @@
 FAR struct net_driver_s *netdev_findbyname(FAR const char *ifname)
 {
   FAR struct net_driver_s *dev;
+  int epoch;
 
   if (ifname)
     {
-      netdev_list_lock();
+      epoch = netdev_list_read_lock();
       for (dev = g_netdevices; dev; dev = dev->flink)
         {
           if (strcmp(ifname, dev->d_ifname) == 0)
             {
-              netdev_list_unlock();
+              netdev_list_read_unlock(epoch);
               return dev;
             }
         }
 
-      netdev_list_unlock();
+      netdev_list_read_unlock(epoch);
     }
 
   return NULL;
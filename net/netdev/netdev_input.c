@@ -26,10 +26,155 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
 
+#include "tcp/tcp.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_hdrlen
+ *
+ * Description:
+ *   Check whether the received packet in dev->d_iob is a TCP segment that
+ *   can be coalesced: IPv4 without options or fragmentation, addressed to
+ *   the device, valid checksums, data and no flags other than ACK and PSH.
+ *   The link layer padding is removed from an eligible packet.
+ *
+ * Returned Value:
+ *   The size of the IP and TCP headers of an eligible packet, else zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+static uint16_t netdev_gro_hdrlen(FAR struct net_driver_s *dev)
+{
+  FAR struct eth_hdr_s *eth = NETLLBUF;
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t totlen;
+  uint16_t hdrlen;
+
+  if (dev->d_lltype != NET_LL_ETHERNET || eth->type != HTONS(ETHTYPE_IP) ||
+      iob->io_len < IPv4_HDRLEN + TCP_HDRLEN)
+    {
+      return 0;
+    }
+
+  ipv4   = IPv4BUF;
+  tcp    = IPBUF(IPv4_HDRLEN);
+  totlen = (ipv4->len[0] << 8) + ipv4->len[1];
+  hdrlen = IPv4_HDRLEN + ((tcp->tcpoffset >> 4) << 2);
+
+  if (ipv4->vhl != 0x45 || ipv4->proto != IP_PROTO_TCP ||
+      (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+      !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                        dev->d_ipaddr) ||
+      (tcp->flags & ~TCP_PSH) != TCP_ACK ||
+      hdrlen < IPv4_HDRLEN + TCP_HDRLEN || iob->io_len < hdrlen ||
+      totlen <= hdrlen || totlen > iob->io_pktlen)
+    {
+      return 0;
+    }
+
+  if (totlen < iob->io_pktlen)
+    {
+      iob_update_pktlen(iob, totlen, false);
+      dev->d_len = totlen + NET_LL_HDRLEN(dev);
+    }
+
+  /* A bad packet is left to the network stack to be dropped and counted */
+
+  if ((dev->d_features & NETDEV_RX_CSUM) == 0)
+    {
+      if (ipv4_chksum(ipv4) != 0xffff)
+        {
+          return 0;
+        }
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if (tcp_ipv4_chksum(dev) != 0xffff)
+        {
+          return 0;
+        }
+#endif
+    }
+
+  return hdrlen;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_merge
+ *
+ * Description:
+ *   Append the payload of the eligible segment 'iob' to the held segment
+ *   'gro' if it is the next segment of the same flow.
+ *
+ * Returned Value:
+ *   true if the segment has been appended and is owned by 'gro' now.
+ *
+ ****************************************************************************/
+
+static bool netdev_gro_merge(FAR struct iob_s *gro, FAR struct iob_s *iob,
+                             uint16_t hdrlen)
+{
+  FAR struct ipv4_hdr_s *gipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(gro);
+  FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(iob);
+  FAR struct tcp_hdr_s *gtcp = (FAR struct tcp_hdr_s *)(gipv4 + 1);
+  FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)(ipv4 + 1);
+  uint32_t seqno;
+
+  /* The segment must carry the same addresses, ports, acknowledgment and
+   * TCP options, and the held segment must not have been pushed already.
+   */
+
+  if (hdrlen != IPv4_HDRLEN + ((gtcp->tcpoffset >> 4) << 2) ||
+      (gtcp->flags & TCP_PSH) != 0 ||
+      gro->io_pktlen + iob->io_pktlen - hdrlen > CONFIG_NETDEV_GRO_MAXSIZE ||
+      memcmp(gipv4->srcipaddr, ipv4->srcipaddr,
+             2 * sizeof(in_addr_t)) != 0 ||
+      gtcp->srcport != tcp->srcport || gtcp->destport != tcp->destport ||
+      memcmp(gtcp->ackno, tcp->ackno, 4) != 0 ||
+      memcmp(gtcp->optdata, tcp->optdata,
+             hdrlen - IPv4_HDRLEN - TCP_HDRLEN) != 0)
+    {
+      return false;
+    }
+
+  /* And it must follow the held segment exactly */
+
+  seqno = tcp_getsequence(gtcp->seqno) + gro->io_pktlen - hdrlen;
+  if (seqno != tcp_getsequence(tcp->seqno))
+    {
+      return false;
+    }
+
+  /* The latest window and PSH flag apply to the coalesced segment */
+
+  gtcp->wnd[0]  = tcp->wnd[0];
+  gtcp->wnd[1]  = tcp->wnd[1];
+  gtcp->flags  |= tcp->flags;
+
+  iob_concat(gro, iob_trimhead(iob, hdrlen));
+  return true;
+}
+#endif /* CONFIG_NETDEV_GRO */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,3 +250,206 @@ int netdev_input(FAR struct net_driver_s *dev,
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: netdev_rxhook_attach
+ *
+ * Description:
+ *   Attach the early receive hook of the device, or detach it with a NULL
+ *   'hook'.  A device has one hook, a module that needs several chains
+ *   them in its own hook.
+ *
+ * Input Parameters:
+ *   dev  - The network device
+ *   hook - The hook function run on each received frame, or NULL
+ *   arg  - The argument passed to the hook
+ *
+ * Returned Value:
+ *   OK on success; -EBUSY if another hook is attached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXHOOK
+int netdev_rxhook_attach(FAR struct net_driver_s *dev,
+                         netdev_rxhook_t hook, FAR void *arg)
+{
+  int ret = OK;
+
+  netdev_lock(dev);
+
+  if (hook != NULL && dev->d_rxhook != NULL)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      dev->d_rxhook    = hook;
+      dev->d_rxhookarg = arg;
+    }
+
+  netdev_unlock(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_rxhook_input
+ *
+ * Description:
+ *   Run the early receive hook of the device on the frame in dev->d_iob
+ *   and carry out its verdict.
+ *
+ * Returned Value:
+ *   false if the frame goes on to the network stack as usual.  true if the
+ *   hook has consumed it: the frame has either been dropped or stolen, or
+ *   it is left with d_len > 0 to be sent back by the caller.
+ *
+ * Assumptions:
+ *   The caller has locked the network device.
+ *
+ ****************************************************************************/
+
+bool netdev_rxhook_input(FAR struct net_driver_s *dev)
+{
+  enum netdev_rxhook_e verdict;
+
+  if (dev->d_rxhook == NULL || dev->d_iob == NULL)
+    {
+      return false;
+    }
+
+  verdict = dev->d_rxhook(dev, dev->d_rxhookarg);
+  if (verdict == NETDEV_RXHOOK_PASS)
+    {
+      return false;
+    }
+  else if (verdict == NETDEV_RXHOOK_STOLEN)
+    {
+      DEBUGASSERT(dev->d_iob == NULL);
+      dev->d_len = 0;
+      return true;
+    }
+  else if (verdict == NETDEV_RXHOOK_TX && dev->d_iob != NULL &&
+           dev->d_len > 0)
+    {
+      return true;
+    }
+
+  /* Drop the frame, also on a bad verdict or with nothing left to send */
+
+  NETDEV_RXDROPPED(dev);
+  netdev_iob_release(dev);
+  dev->d_len = 0;
+  return true;
+}
+#endif /* CONFIG_NETDEV_RXHOOK */
+
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Try to coalesce the received packet in dev->d_iob with the TCP segment
+ *   held back on the device.  The held segment is passed to 'input' first
+ *   if the packet doesn't belong to it, and the packet then becomes the
+ *   new held segment if it is eligible for the coalescing.
+ *
+ * Input Parameters:
+ *   dev   - The network device holding the received L2 packet
+ *   input - The L2 input function used to pass a held segment to the stack
+ *
+ * Returned Value:
+ *   true if the packet has been taken by the generic receive offload, false
+ *   if the caller has to handle it as usual.
+ *
+ * Assumptions:
+ *   The caller has locked the network device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+bool netdev_gro_receive(FAR struct net_driver_s *dev,
+                        CODE void (*input)(FAR struct net_driver_s *dev))
+{
+  uint16_t hdrlen;
+
+  hdrlen = netdev_gro_hdrlen(dev);
+  if (hdrlen == 0)
+    {
+      /* Keep the packets in order, the held segment goes first */
+
+      netdev_gro_flush(dev, input);
+      return false;
+    }
+
+  if (dev->d_gro != NULL && netdev_gro_merge(dev->d_gro, dev->d_iob, hdrlen))
+    {
+      netdev_iob_clear(dev);
+      return true;
+    }
+
+  /* Start again from this segment */
+
+  netdev_gro_flush(dev, input);
+
+  dev->d_gro = dev->d_iob;
+  netdev_iob_clear(dev);
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass the TCP segment held back on the device to 'input', it must be
+ *   called at the end of each receive batch.
+ *
+ * Assumptions:
+ *   The caller has locked the network device.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct net_driver_s *dev,
+                      CODE void (*input)(FAR struct net_driver_s *dev))
+{
+  FAR struct iob_s *gro = dev->d_gro;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct iob_s *iob;
+  uint8_t features;
+
+  if (gro == NULL)
+    {
+      return;
+    }
+
+  dev->d_gro = NULL;
+
+  /* Update the IPv4 header for the coalesced payload */
+
+  ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(gro);
+  ipv4->len[0]   = gro->io_pktlen >> 8;
+  ipv4->len[1]   = gro->io_pktlen & 0xff;
+  ipv4->ipchksum = 0;
+  ipv4->ipchksum = ~ipv4_chksum(ipv4);
+
+  /* Set the packet being received aside while the held one is input */
+
+  iob = dev->d_iob;
+  netdev_iob_clear(dev);
+  netdev_iob_replace_l2(dev, gro);
+
+  /* The checksum of each segment has been verified when it was received
+   * and the TCP checksum isn't updated for the coalesced payload, so skip
+   * the checks of the stack like a device with the RX checksum offload.
+   */
+
+  features = dev->d_features;
+  dev->d_features |= NETDEV_RX_CSUM;
+  input(dev);
+  dev->d_features = features;
+
+  netdev_iob_release(dev);
+  if (iob != NULL)
+    {
+      netdev_iob_replace_l2(dev, iob);
+    }
+}
+#endif /* CONFIG_NETDEV_GRO */
@@ -81,7 +81,8 @@ int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
 
   /* Set the device buffer to l2 */
 
-  dev->d_buf = NETLLBUF;
+  dev->d_buf    = NETLLBUF;
+  dev->d_txcsum = false;
 
   return OK;
 }
@@ -144,9 +145,10 @@ void netdev_iob_replace(FAR struct net_driver_s *dev, FAR struct iob_s *iob)
 
   /* Set new buffer */
 
-  dev->d_iob = iob;
-  dev->d_buf = NETLLBUF;
-  dev->d_len = iob->io_pktlen;
+  dev->d_iob    = iob;
+  dev->d_buf    = NETLLBUF;
+  dev->d_len    = iob->io_pktlen;
+  dev->d_txcsum = false;
 }
 
 /****************************************************************************
@@ -171,8 +173,9 @@ void netdev_iob_replace_l2(FAR struct net_driver_s *dev,
 
   /* Set new buffer */
 
-  dev->d_iob = iob;
-  dev->d_len = iob->io_pktlen + NET_LL_HDRLEN(dev);
+  dev->d_iob    = iob;
+  dev->d_len    = iob->io_pktlen + NET_LL_HDRLEN(dev);
+  dev->d_txcsum = false;
 }
 
 /****************************************************************************
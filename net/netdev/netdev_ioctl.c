@@ -83,6 +83,7 @@
 #include "netdev/netdev.h"
 #include "devif/devif.h"
 #include "igmp/igmp.h"
+#include "ipforward/ipforward.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
@@ -778,6 +779,8 @@ static ssize_t net_ioctl_ifreq_arglen(uint8_t domain, int cmd)
       case SIOCSIFNAME:
       case SIOCGIFNAME:
       case SIOCGIFINDEX:
+      case SIOCGIFBUDGET:
+      case SIOCSIFBUDGET:
         return sizeof(struct ifreq);
 
       case SIOCSIFADDR:
@@ -1314,11 +1317,39 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         break;
 #endif
 
+#ifdef CONFIG_NETDEV_IOCTL
+      case SIOCGIFBUDGET:  /* Get the RX poll budget */
+      case SIOCSIFBUDGET:  /* Set the RX poll budget */
+        if (dev->d_ioctl)
+          {
+            ret = dev->d_ioctl(dev, cmd, (unsigned long)(uintptr_t)req);
+          }
+        else
+          {
+            ret = -ENOSYS;
+          }
+        break;
+#endif
+
       default:
         ret = -ENOTTY;
         break;
     }
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* The addresses and the flags of the devices select the forwarding
+   * device of the cached flows.
+   */
+
+  if (ret >= 0 && (cmd == SIOCSIFADDR || cmd == SIOCDIFADDR ||
+                   cmd == SIOCSIFDSTADDR || cmd == SIOCSIFNETMASK ||
+                   cmd == SIOCSLIFADDR || cmd == SIOCSLIFNETMASK ||
+                   cmd == SIOCSLIFDSTADDR || cmd == SIOCSIFFLAGS))
+    {
+      ipfwd_flow_flush();
+    }
+#endif
+
   netdev_unlock(dev);
   return ret;
 }
@@ -1654,6 +1685,13 @@ static int netdev_rt_ioctl(FAR struct socket *psock, int cmd,
         break;
     }
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  if (ret >= 0)
+    {
+      ipfwd_flow_flush();
+    }
+#endif
+
   return ret;
 }
 #endif
@@ -2086,6 +2124,12 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
 
               dev->d_flags &= ~(IFF_UP | IFF_RUNNING);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+              /* Drop the flows forwarded to or received on the device */
+
+              ipfwd_flow_flush();
+#endif
+
               /* Update the driver status */
 
               netlink_device_notify(dev);
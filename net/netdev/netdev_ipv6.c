@@ -33,6 +33,7 @@
 #include <nuttx/net/netdev.h>
 
 #include "inet/inet.h"
+#include "ipforward/ipforward.h"
 #include "netdev/netdev.h"
 #include "utils/utils.h"
 
@@ -181,6 +182,9 @@ int netdev_ipv6_add(FAR struct net_driver_s *dev, const net_ipv6addr_t addr,
        */
 
       net_ipv6_pref2mask(ifaddr->mask, preflen);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipfwd_flow_flush();
+#endif
       return OK;
     }
 
@@ -216,6 +220,14 @@ int netdev_ipv6_add(FAR struct net_driver_s *dev, const net_ipv6addr_t addr,
 
   netdev_ipv6_addmcastmac(dev, addr);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* Every address change, including the ones made by SLAAC, can move the
+   * forwarding device of the cached flows.
+   */
+
+  ipfwd_flow_flush();
+#endif
+
   return OK;
 }
 
@@ -255,6 +267,10 @@ int netdev_ipv6_del(FAR struct net_driver_s *dev, const net_ipv6addr_t addr,
 
   netdev_ipv6_removemcastmac(dev, addr);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  ipfwd_flow_flush();
+#endif
+
   return OK;
 }
 
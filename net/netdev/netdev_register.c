@@ -40,6 +40,7 @@
 #include <nuttx/net/ethernet.h>
 #include <nuttx/net/bluetooth.h>
 #include <nuttx/net/can.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "icmpv6/icmpv6.h"
@@ -249,6 +250,32 @@ void netdev_list_unlock(void)
   nxmutex_unlock(&g_netdevices_lock);
 }
 
+/****************************************************************************
+ * Name: netdev_list_read_lock
+ *
+ * Description:
+ *   Enter a lookup of the network device list without taking the lock.
+ *
+ ****************************************************************************/
+
+int netdev_list_read_lock(void)
+{
+  return rcu_read_lock();
+}
+
+/****************************************************************************
+ * Name: netdev_list_read_unlock
+ *
+ * Description:
+ *   Leave a lookup of the network device list.
+ *
+ ****************************************************************************/
+
+void netdev_list_read_unlock(int epoch)
+{
+  rcu_read_unlock(epoch);
+}
+
 /****************************************************************************
  * Name: netdev_register
  *
@@ -499,9 +526,12 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
           last = &((*last)->flink);
         }
 
-      *last = dev;
+      /* The lookups traverse the list without the lock, the device must be
+       * complete before it is linked.
+       */
 
       dev->flink = NULL;
+      rcu_assign_pointer(*last, dev);
 
 #ifdef CONFIG_NET_IGMP
       /* Configure the device for IGMP support */
@@ -36,7 +36,9 @@
 #include <net/if.h>
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
+#include "ipforward/ipforward.h"
 #include "mld/mld.h"
 #include "utils/utils.h"
 #include "netdev/netdev.h"
@@ -144,8 +146,6 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 
               g_netdevices = curr->flink;
             }
-
-          curr->flink = NULL;
         }
 
 #ifdef CONFIG_NETDEV_IFINDEX
@@ -163,6 +163,22 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 
       netdev_list_unlock();
 
+      /* A lookup may still be at the device, keep its link until all of
+       * them have passed.
+       */
+
+      if (curr)
+        {
+          synchronize_rcu();
+          curr->flink = NULL;
+        }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      /* The cached flows must not refer to the device any more */
+
+      ipfwd_flow_flush();
+#endif
+
       nxrmutex_destroy(&dev->d_lock);
 
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
@@ -52,10 +52,11 @@ bool netdev_verify(FAR struct net_driver_s *dev)
 {
   FAR struct net_driver_s *chkdev;
   bool valid = false;
+  int epoch;
 
   /* Search the list of registered devices */
 
-  netdev_list_lock();
+  epoch = netdev_list_read_lock();
   for (chkdev = g_netdevices; chkdev != NULL; chkdev = chkdev->flink)
     {
       /* Is the network device that we are looking for? */
@@ -69,6 +70,6 @@ bool netdev_verify(FAR struct net_driver_s *dev)
         }
     }
 
-  netdev_list_unlock();
+  netdev_list_read_unlock(epoch);
   return valid;
 }
@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <poll.h>
 
 #include <netpacket/netlink.h>
@@ -178,6 +179,24 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* State of an incremental table dump.  'fill' queues the responses for
+ * up to CONFIG_NETLINK_DUMP_BATCH entries starting at 'cursor' and advances
+ * the cursor.  It returns a positive value if more entries may follow, zero
+ * once the table is exhausted or a negated errno value on failure.
+ */
+
+struct netlink_dump_s;
+typedef CODE int (*netlink_dump_fill_t)(NETLINK_HANDLE handle,
+                                        FAR struct netlink_dump_s *dump);
+
+struct netlink_dump_s
+{
+  netlink_dump_fill_t fill;          /* NULL if no dump is in progress */
+  struct nlmsghdr req;               /* Header of the dump request */
+  unsigned int cursor;               /* Index of the next entry */
+  bool busy;                         /* A batch is being filled */
+};
+
 /* This connection structure describes the underlying state of the socket. */
 
 struct netlink_conn_s
@@ -202,6 +221,10 @@ struct netlink_conn_s
   /* Queued response data */
 
   sq_queue_t resplist;               /* Singly linked list of responses */
+
+  /* Dump in progress */
+
+  struct netlink_dump_s dump;
 };
 
 /* Standard attribute types to specify validation policy */
@@ -416,6 +439,46 @@ void netlink_notifier_signal(FAR struct netlink_conn_s *conn);
 int netlink_add_terminator(NETLINK_HANDLE handle,
                            FAR const struct nlmsghdr *req, int group);
 
+/****************************************************************************
+ * Name: netlink_start_dump
+ *
+ * Description:
+ *   Start an incremental dump in response to 'req'.  The first batch of
+ *   responses is queued immediately; the following batches are queued by
+ *   netlink_continue_dump() as the application receives the responses and
+ *   the NLMSG_DONE terminator is added when 'fill' reports the end of the
+ *   table.
+ *
+ * Input Parameters:
+ *   handle - The handle previously provided to the sendto() implementation
+ *            for the protocol.
+ *   req    - The request message header.
+ *   fill   - The function that queues the next batch of responses.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  -EBUSY is returned if a dump is
+ *   already in progress on the socket.  Otherwise a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+int netlink_start_dump(NETLINK_HANDLE handle, FAR const struct nlmsghdr *req,
+                       netlink_dump_fill_t fill);
+
+/****************************************************************************
+ * Name: netlink_continue_dump
+ *
+ * Description:
+ *   Queue the next batch of the dump in progress, if any, once all of the
+ *   previously queued responses have been received.
+ *
+ *   Must not be called with the netlink lock held, since the 'fill' method
+ *   takes the locks of the dumped table.
+ *
+ ****************************************************************************/
+
+void netlink_continue_dump(FAR struct netlink_conn_s *conn);
+
 /****************************************************************************
  * Name: netlink_tryget_response
  *
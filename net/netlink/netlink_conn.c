@@ -164,6 +164,7 @@ FAR struct netlink_conn_s *netlink_alloc(void)
     {
       /* Enqueue the connection into the active list */
 
+      memset(&conn->dump, 0, sizeof(conn->dump));
       dq_addlast(&conn->sconn.node, &g_active_netlink_connections);
     }
 
@@ -312,6 +313,115 @@ int netlink_add_terminator(NETLINK_HANDLE handle,
   return OK;
 }
 
+/****************************************************************************
+ * Name: netlink_start_dump
+ *
+ * Description:
+ *   Start an incremental dump in response to 'req'.  The first batch of
+ *   responses is queued immediately; the following batches are queued by
+ *   netlink_continue_dump() as the application receives the responses and
+ *   the NLMSG_DONE terminator is added when 'fill' reports the end of the
+ *   table.
+ *
+ * Input Parameters:
+ *   handle - The handle previously provided to the sendto() implementation
+ *            for the protocol.
+ *   req    - The request message header.
+ *   fill   - The function that queues the next batch of responses.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  -EBUSY is returned if a dump is
+ *   already in progress on the socket.  Otherwise a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+int netlink_start_dump(NETLINK_HANDLE handle, FAR const struct nlmsghdr *req,
+                       netlink_dump_fill_t fill)
+{
+  FAR struct netlink_conn_s *conn = handle;
+
+  DEBUGASSERT(conn != NULL && req != NULL && fill != NULL);
+
+  netlink_lock();
+  if (conn->dump.fill != NULL)
+    {
+      netlink_unlock();
+      return -EBUSY;
+    }
+
+  conn->dump.fill   = fill;
+  conn->dump.cursor = 0;
+  conn->dump.busy   = false;
+  memcpy(&conn->dump.req, req, sizeof(struct nlmsghdr));
+
+  /* All parts of the dump, including the terminator, are multipart
+   * messages.
+   */
+
+  conn->dump.req.nlmsg_flags |= NLM_F_MULTI;
+  netlink_unlock();
+
+  netlink_continue_dump(conn);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netlink_continue_dump
+ *
+ * Description:
+ *   Queue the next batch of the dump in progress, if any, once all of the
+ *   previously queued responses have been received.
+ *
+ *   Must not be called with the netlink lock held, since the 'fill' method
+ *   takes the locks of the dumped table.
+ *
+ ****************************************************************************/
+
+void netlink_continue_dump(FAR struct netlink_conn_s *conn)
+{
+  netlink_dump_fill_t fill;
+  int ret;
+
+  DEBUGASSERT(conn != NULL);
+
+  /* Claim the dump, unless there is nothing to do or another receiver is
+   * already filling the next batch.
+   */
+
+  netlink_lock();
+  fill = conn->dump.fill;
+  if (fill == NULL || conn->dump.busy || !sq_empty(&conn->resplist))
+    {
+      netlink_unlock();
+      return;
+    }
+
+  conn->dump.busy = true;
+  netlink_unlock();
+
+  ret = fill(conn, &conn->dump);
+
+  netlink_lock();
+  conn->dump.busy = false;
+  if (ret <= 0)
+    {
+      /* The table is exhausted (or could not be read further), terminate
+       * the dump.
+       */
+
+      if (ret < 0)
+        {
+          nerr("ERROR: Dump failed: %d\n", ret);
+        }
+
+      conn->dump.fill = NULL;
+      netlink_add_terminator(conn, &conn->dump.req, 0);
+    }
+
+  netlink_unlock();
+}
+
 /****************************************************************************
  * Name: netlink_add_broadcast
  *
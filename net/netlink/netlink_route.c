@@ -45,6 +45,7 @@
 
 #include "netdev/netdev.h"
 #include "arp/arp.h"
+#include "ipforward/ipforward.h"
 #include "net/if_arp.h"
 #include "neighbor/neighbor.h"
 #include "route/route.h"
@@ -222,6 +223,16 @@ struct nlroute_info_s
   FAR const struct nlroute_sendto_request_s *req;
 };
 
+/* Position of an incremental routing table dump */
+
+struct nlroute_dump_s
+{
+  NETLINK_HANDLE handle;
+  FAR struct netlink_dump_s *dump;
+  unsigned int index;                /* Index of the visited entry */
+  unsigned int nqueued;              /* Responses queued in this batch */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -516,113 +527,11 @@ static int netlink_get_devlist(NETLINK_HANDLE handle,
 #endif
 
 /****************************************************************************
- * Name: netlink_fill_arptable()
- *
- * Description:
- *   Return the entire ARP table.
- *
- ****************************************************************************/
-
-#if defined(CONFIG_NET_ARP) && !defined(CONFIG_NETLINK_DISABLE_GETNEIGH)
-static size_t netlink_fill_arptable(
-                              FAR struct getneigh_recvfrom_rsplist_s **entry)
-{
-  unsigned int ncopied;
-  size_t allocsize;
-  size_t tabsize;
-  size_t rspsize;
-
-  /* Lock the network so that the ARP table will be stable, then copy
-   * the ARP table into the allocated memory.
-   */
-
-  ncopied = arp_snapshot((FAR struct arpreq *)(*entry)->payload.data,
-                         CONFIG_NET_ARPTAB_SIZE);
-
-  /* Now we have the real number of valid entries in the ARP table and
-   * we can trim the allocation.
-   */
-
-  if (ncopied > 0)
-    {
-      FAR struct getneigh_recvfrom_rsplist_s *newentry;
-
-      tabsize = ncopied * sizeof(struct arpreq);
-      rspsize = SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(tabsize);
-      allocsize = SIZEOF_NLROUTE_RECVFROM_RSPLIST_S(tabsize);
-
-      newentry = kmm_realloc(*entry, allocsize);
-
-      if (newentry != NULL)
-        {
-          *entry = newentry;
-        }
-
-      (*entry)->payload.hdr.nlmsg_len = rspsize;
-      (*entry)->payload.attr.rta_len  = RTA_LENGTH(tabsize);
-    }
-
-  return ncopied;
-}
-#endif
-
-/****************************************************************************
- * Name: netlink_fill_nbtable()
- *
- * Description:
- *   Return the entire IPv6 neighbor table.
- *
- ****************************************************************************/
-
-#if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETNEIGH)
-static size_t netlink_fill_nbtable(
-                              FAR struct getneigh_recvfrom_rsplist_s **entry)
-{
-  unsigned int ncopied;
-  size_t allocsize;
-  size_t tabsize;
-  size_t rspsize;
-
-  /* Lock the network so that the Neighbor table will be stable, then
-   * copy the Neighbor table into the allocated memory.
-   */
-
-  ncopied = neighbor_snapshot(
-                      (FAR struct neighbor_entry_s *)(*entry)->payload.data,
-                      CONFIG_NET_IPv6_NCONF_ENTRIES);
-
-  /* Now we have the real number of valid entries in the Neighbor table
-   * and we can trim the allocation.
-   */
-
-  if (ncopied > 0)
-    {
-      FAR struct getneigh_recvfrom_rsplist_s *newentry;
-
-      tabsize   = ncopied * sizeof(struct neighbor_entry_s);
-      rspsize   = SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(tabsize);
-      allocsize = SIZEOF_NLROUTE_RECVFROM_RSPLIST_S(tabsize);
-
-      newentry = kmm_realloc(*entry, allocsize);
-
-      if (newentry != NULL)
-        {
-          *entry = newentry;
-        }
-
-      (*entry)->payload.hdr.nlmsg_len = rspsize;
-      (*entry)->payload.attr.rta_len  = RTA_LENGTH(tabsize);
-    }
-
-  return ncopied;
-}
-#endif
-
-/****************************************************************************
- * Name: netlink_fill_nbtable()
+ * Name: netlink_get_neighbor()
  *
  * Description:
- *   Return the entire IPv6 neighbor table.
+ *   Return the entire ARP or IPv6 neighbor table, or the single entry
+ *   'neigh' for a notification.
  *
  ****************************************************************************/
 
@@ -634,36 +543,51 @@ netlink_get_neighbor(FAR const void *neigh, int domain, int type,
   FAR struct getneigh_recvfrom_rsplist_s *alloc;
   FAR struct getneigh_recvfrom_response_s *resp;
   size_t allocsize;
+  size_t entsize;
   size_t tabsize;
   size_t tabnum;
   size_t rspsize;
 
-  /* Preallocate memory to hold the maximum sized ARP table
-   * REVISIT:  This is probably excessively large and could cause false
-   * memory out conditions.  A better approach would be to actually count
-   * the number of valid entries in the ARP table.
+  /* Hold the network lock so that the table does not change between
+   * counting the valid entries and copying them.  The response is then
+   * sized for the entries actually present rather than the whole table.
    */
 
+  net_lock();
+
 #if defined(CONFIG_NET_ARP)
   if (domain == AF_INET)
     {
-      tabnum  = req ? CONFIG_NET_ARPTAB_SIZE : 1;
-      tabsize = tabnum * sizeof(struct arpreq);
+      tabnum  = req ? arp_snapshot(NULL, CONFIG_NET_ARPTAB_SIZE) : 1;
+      entsize = sizeof(struct arpreq);
     }
   else
 #endif
 #if defined(CONFIG_NET_IPv6)
   if (domain == AF_INET6)
     {
-      tabnum  = req ? CONFIG_NET_IPv6_NCONF_ENTRIES : 1;
-      tabsize = tabnum * sizeof(struct neighbor_entry_s);
+      tabnum  = req ? neighbor_snapshot(NULL, CONFIG_NET_IPv6_NCONF_ENTRIES)
+                    : 1;
+      entsize = sizeof(struct neighbor_entry_s);
     }
   else
 #endif
     {
+      net_unlock();
+      return NULL;
+    }
+
+  /* If no entry in table, there is nothing to return */
+
+  if (tabnum == 0 || (req == NULL && neigh == NULL))
+    {
+      net_unlock();
+      nwarn("WARNING: Failed to get entry in %s table.\n",
+            domain == AF_INET ? "ARP" : "neighbor");
       return NULL;
     }
 
+  tabsize   = tabnum * entsize;
   rspsize   = SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(tabsize);
   allocsize = SIZEOF_NLROUTE_RECVFROM_RSPLIST_S(tabsize);
 
@@ -672,6 +596,7 @@ netlink_get_neighbor(FAR const void *neigh, int domain, int type,
   alloc = kmm_zalloc(allocsize);
   if (alloc == NULL)
     {
+      net_unlock();
       nerr("ERROR: Failed to allocate response buffer.\n");
       return NULL;
     }
@@ -692,38 +617,35 @@ netlink_get_neighbor(FAR const void *neigh, int domain, int type,
 
   if (req == NULL)
     {
-      if (neigh == NULL)
-        {
-          return NULL;
-        }
-
       /* Only one entry need to notify */
 
       memcpy(resp->data, neigh, tabsize);
     }
-#if defined(CONFIG_NET_ARP)
-  else if (domain == AF_INET)
+  else
     {
-      tabnum = netlink_fill_arptable(&alloc);
-    }
+#if defined(CONFIG_NET_ARP)
+      if (domain == AF_INET)
+        {
+          tabnum = arp_snapshot((FAR struct arpreq *)resp->data, tabnum);
+        }
 #endif
+
 #if defined(CONFIG_NET_IPv6)
-  else if (domain == AF_INET6)
-    {
-      tabnum = netlink_fill_nbtable(&alloc);
-    }
+      if (domain == AF_INET6)
+        {
+          tabnum = neighbor_snapshot(
+                      (FAR struct neighbor_entry_s *)resp->data, tabnum);
+        }
 #endif
 
-  /* If no entry in table, just free alloc */
+      /* Entries may have aged out since they were counted */
 
-  if (tabnum <= 0)
-    {
-      kmm_free(alloc);
-      nwarn("WARNING: Failed to get entry in %s table.\n",
-            domain == AF_INET ? "ARP" : "neighbor");
-      return NULL;
+      tabsize             = tabnum * entsize;
+      resp->hdr.nlmsg_len = SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(tabsize);
+      resp->attr.rta_len  = RTA_LENGTH(tabsize);
     }
 
+  net_unlock();
   return (FAR struct netlink_response_s *)alloc;
 }
 
@@ -755,7 +677,7 @@ static int netlink_get_neighborlist(NETLINK_HANDLE handle, int domain,
 #if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
 static FAR struct netlink_response_s *
 netlink_get_ipv4_route(FAR const struct net_route_ipv4_s *route, int type,
-                       FAR const struct nlroute_sendto_request_s *req)
+                       FAR const struct nlmsghdr *req)
 {
   FAR struct getroute_recvfrom_ipv4resplist_s *alloc;
   FAR struct getroute_recvfrom_ipv4response_s *resp;
@@ -776,9 +698,9 @@ netlink_get_ipv4_route(FAR const struct net_route_ipv4_s *route, int type,
   resp                  = &alloc->payload;
   resp->hdr.nlmsg_len   = sizeof(struct getroute_recvfrom_ipv4response_s);
   resp->hdr.nlmsg_type  = type;
-  resp->hdr.nlmsg_flags = req ? req->hdr.nlmsg_flags : 0;
-  resp->hdr.nlmsg_seq   = req ? req->hdr.nlmsg_seq : 0;
-  resp->hdr.nlmsg_pid   = req ? req->hdr.nlmsg_pid : 0;
+  resp->hdr.nlmsg_flags = req ? req->nlmsg_flags : 0;
+  resp->hdr.nlmsg_seq   = req ? req->nlmsg_seq : 0;
+  resp->hdr.nlmsg_pid   = req ? req->nlmsg_pid : 0;
 
   resp->rte.rtm_family   = AF_INET;
   resp->rte.rtm_table    = RT_TABLE_MAIN;
@@ -812,20 +734,57 @@ netlink_get_ipv4_route(FAR const struct net_route_ipv4_s *route, int type,
 static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
                                       FAR void *arg)
 {
-  FAR struct nlroute_info_s *info = arg;
+  FAR struct nlroute_dump_s *info = arg;
   FAR struct netlink_response_s *resp;
 
-  resp = netlink_get_ipv4_route(route, RTM_NEWROUTE, info->req);
+  /* Skip the entries already dumped, stop once the batch is full */
+
+  if (info->index++ < info->dump->cursor)
+    {
+      return OK;
+    }
+
+  if (info->nqueued >= CONFIG_NETLINK_DUMP_BATCH)
+    {
+      return 1;
+    }
+
+  resp = netlink_get_ipv4_route(route, RTM_NEWROUTE, &info->dump->req);
   if (resp == NULL)
     {
-      return -ENOENT;
+      return -ENOMEM;
     }
 
   /* Finally, add the response to the list of pending responses */
 
   netlink_add_response(info->handle, resp);
+  info->nqueued++;
   return OK;
 }
+
+/****************************************************************************
+ * Name: netlink_dump_ipv4_route
+ *
+ * Description:
+ *   Queue the next batch of an IPv4 routing table dump.
+ *
+ ****************************************************************************/
+
+static int netlink_dump_ipv4_route(NETLINK_HANDLE handle,
+                                   FAR struct netlink_dump_s *dump)
+{
+  struct nlroute_dump_s info;
+  int ret;
+
+  info.handle  = handle;
+  info.dump    = dump;
+  info.index   = 0;
+  info.nqueued = 0;
+
+  ret = net_foreachroute_ipv4(netlink_ipv4route_callback, &info);
+  dump->cursor += info.nqueued;
+  return ret;
+}
 #endif
 
 /****************************************************************************
@@ -840,23 +799,9 @@ static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
 static int netlink_list_ipv4_route(NETLINK_HANDLE handle,
                               FAR const struct nlroute_sendto_request_s *req)
 {
-  struct nlroute_info_s info;
-  int ret;
-
-  /* Visit each routing table entry */
-
-  info.handle = handle;
-  info.req    = req;
+  /* Dump the routing table incrementally as the responses are received */
 
-  ret = net_foreachroute_ipv4(netlink_ipv4route_callback, &info);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Terminate the routing table */
-
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  return netlink_start_dump(handle, &req->hdr, netlink_dump_ipv4_route);
 }
 #endif
 
@@ -871,7 +816,7 @@ static int netlink_list_ipv4_route(NETLINK_HANDLE handle,
 #if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
 static FAR struct netlink_response_s *
 netlink_get_ipv6_route(FAR const struct net_route_ipv6_s *route, int type,
-                       FAR const struct nlroute_sendto_request_s *req)
+                       FAR const struct nlmsghdr *req)
 {
   FAR struct getroute_recvfrom_ipv6resplist_s *alloc;
   FAR struct getroute_recvfrom_ipv6response_s *resp;
@@ -892,9 +837,9 @@ netlink_get_ipv6_route(FAR const struct net_route_ipv6_s *route, int type,
   resp                  = &alloc->payload;
   resp->hdr.nlmsg_len   = sizeof(struct getroute_recvfrom_ipv6response_s);
   resp->hdr.nlmsg_type  = type;
-  resp->hdr.nlmsg_flags = req ? req->hdr.nlmsg_flags : 0;
-  resp->hdr.nlmsg_seq   = req ? req->hdr.nlmsg_seq : 0;
-  resp->hdr.nlmsg_pid   = req ? req->hdr.nlmsg_pid : 0;
+  resp->hdr.nlmsg_flags = req ? req->nlmsg_flags : 0;
+  resp->hdr.nlmsg_seq   = req ? req->nlmsg_seq : 0;
+  resp->hdr.nlmsg_pid   = req ? req->nlmsg_pid : 0;
 
   resp->rte.rtm_family   = AF_INET6;
   resp->rte.rtm_table    = RT_TABLE_MAIN;
@@ -931,21 +876,57 @@ netlink_get_ipv6_route(FAR const struct net_route_ipv6_s *route, int type,
 static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
                                       FAR void *arg)
 {
-  FAR struct nlroute_info_s *info = arg;
+  FAR struct nlroute_dump_s *info = arg;
   FAR struct netlink_response_s *resp;
 
-  resp = netlink_get_ipv6_route(route, RTM_NEWROUTE, info->req);
+  /* Skip the entries already dumped, stop once the batch is full */
+
+  if (info->index++ < info->dump->cursor)
+    {
+      return OK;
+    }
+
+  if (info->nqueued >= CONFIG_NETLINK_DUMP_BATCH)
+    {
+      return 1;
+    }
+
+  resp = netlink_get_ipv6_route(route, RTM_NEWROUTE, &info->dump->req);
   if (resp == NULL)
     {
-      return -ENOENT;
+      return -ENOMEM;
     }
 
   /* Finally, add the response to the list of pending responses */
 
   netlink_add_response(info->handle, resp);
-
+  info->nqueued++;
   return OK;
 }
+
+/****************************************************************************
+ * Name: netlink_dump_ipv6_route
+ *
+ * Description:
+ *   Queue the next batch of an IPv6 routing table dump.
+ *
+ ****************************************************************************/
+
+static int netlink_dump_ipv6_route(NETLINK_HANDLE handle,
+                                   FAR struct netlink_dump_s *dump)
+{
+  struct nlroute_dump_s info;
+  int ret;
+
+  info.handle  = handle;
+  info.dump    = dump;
+  info.index   = 0;
+  info.nqueued = 0;
+
+  ret = net_foreachroute_ipv6(netlink_ipv6route_callback, &info);
+  dump->cursor += info.nqueued;
+  return ret;
+}
 #endif
 
 /****************************************************************************
@@ -960,23 +941,9 @@ static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
 static int netlink_list_ipv6_route(NETLINK_HANDLE handle,
                               FAR const struct nlroute_sendto_request_s *req)
 {
-  struct nlroute_info_s info;
-  int ret;
-
-  /* Visit each routing table entry */
-
-  info.handle = handle;
-  info.req    = req;
-
-  ret = net_foreachroute_ipv6(netlink_ipv6route_callback, &info);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Terminate the routing table */
+  /* Dump the routing table incrementally as the responses are received */
 
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  return netlink_start_dump(handle, &req->hdr, netlink_dump_ipv6_route);
 }
 #endif
 
@@ -1021,6 +988,10 @@ static int netlink_new_ipv4addr(NETLINK_HANDLE handle,
   dev->d_ipaddr  = nla_get_in_addr(tb[IFA_LOCAL]);
   dev->d_netmask = make_mask(ifm->ifa_prefixlen);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  ipfwd_flow_flush();
+#endif
+
   netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET, &dev->d_ipaddr,
                                ifm->ifa_prefixlen);
   netdev_unlock(dev);
@@ -1123,6 +1094,10 @@ static int netlink_del_ipv4addr(NETLINK_HANDLE handle,
                                net_ipv4_mask2pref(dev->d_netmask));
   dev->d_ipaddr  = 0;
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  ipfwd_flow_flush();
+#endif
+
   netdev_unlock(dev);
 
   return OK;
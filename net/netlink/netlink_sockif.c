@@ -722,6 +722,10 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
   memcpy(buf, &entry->msg, len);
   kmm_free(entry);
 
+  /* Queue the next part of a dump in progress */
+
+  netlink_continue_dump(psock->s_conn);
+
   if (from != NULL)
     {
       netlink_getpeername(psock, from, fromlen);
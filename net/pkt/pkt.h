@@ -33,6 +33,11 @@
 
 #include <nuttx/net/net.h>
 
+#ifdef CONFIG_NET_PKT_MMAP
+#  include <nuttx/atomic.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 #ifdef CONFIG_NET_PKT
 
 /****************************************************************************
@@ -64,6 +69,39 @@ struct pkt_poll_s
   FAR struct devif_callback_s *cb;   /* Needed to teardown the poll */
 };
 
+#ifdef CONFIG_NET_PKT_MMAP
+/* A ring set up by PACKET_RX_RING or PACKET_TX_RING.  The receive ring
+ * packs the packets into blocks, the transmit ring is an array of frames.
+ */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *pr_base;  /* The first block, NULL without the ring */
+  uint32_t     pr_bsize; /* Size of a block */
+  uint32_t     pr_bnr;   /* Number of the blocks */
+  uint32_t     pr_fsize; /* Size of a transmit frame */
+  uint32_t     pr_fnr;   /* Number of the transmit frames */
+  uint32_t     pr_head;  /* The block or the frame the kernel is at */
+  uint32_t     pr_first; /* Offset of the first packet in a block */
+  uint32_t     pr_fill;  /* Used bytes of the open block, 0 if none */
+  uint32_t     pr_last;  /* Offset of the last packet in the open block */
+  uint32_t     pr_tmo;   /* Timeout of the open block in ticks */
+  uint64_t     pr_seq;   /* Sequence number of the last block opened */
+  bool         pr_lost;  /* Packets were dropped on the full ring */
+};
+
+/* The memory of both rings.  The socket and every mapping of the rings
+ * hold a reference, so the memory stays for the process after the close.
+ */
+
+struct pkt_ringmem_s
+{
+  atomic_t     pm_refs;  /* References to the memory */
+  size_t       pm_size;  /* Size of the rings */
+  FAR uint8_t *pm_base;  /* The receive ring followed by the transmit ring */
+};
+#endif
+
 struct pkt_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -99,11 +137,25 @@ struct pkt_conn_s
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
    *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Rings mapped into the process.
+   *
+   *   ringmem   - The memory of the rings, NULL without any ring.
+   *   rxwork    - Retires the open receive block on its timeout.
+   */
+
+  FAR struct pkt_ringmem_s *ringmem;
+  struct pkt_ring_s  rxring;      /* PACKET_RX_RING */
+  struct pkt_ring_s  txring;      /* PACKET_TX_RING */
+  struct work_s      rxwork;      /* Receive block timeout */
+  uint8_t            tpversion;   /* PACKET_VERSION */
+  uint8_t            socktype;    /* SOCK_RAW or SOCK_DGRAM */
+#endif
+
   FAR struct iob_s  *pendiob;     /* The iob currently being sent */
 
   /* The following is a list of poll structures of threads waiting for
@@ -463,6 +515,106 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
 
 #endif
 
+#ifdef CONFIG_NET_PKT_MMAP
+struct tpacket_req3;   /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up or, with no blocks requested, release the receive or the
+ *   transmit ring of a packet socket.
+ *
+ * Input Parameters:
+ *   conn   - The packet socket connection
+ *   option - PACKET_RX_RING or PACKET_TX_RING
+ *   req    - The geometry of the ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -EBUSY is
+ *   returned while the rings are mapped.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, int option,
+                   FAR const struct tpacket_req3 *req);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings of a packet socket being closed.  The memory stays
+ *   until the process unmaps it.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the receive ring followed by the transmit ring into the process.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Store the packet in the device into the receive ring of the
+ *   connection.  It is dropped if the application still owns the next
+ *   block.
+ *
+ * Returned Value:
+ *   OK if the packet has been consumed by the ring; -ENOENT if the
+ *   connection has no receive ring.
+ *
+ * Assumptions:
+ *   The device is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if there is a receive block owned by the application.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_sendmsg
+ *
+ * Description:
+ *   A send of no data on a socket with the transmit ring sends all the
+ *   frames marked TP_STATUS_SEND_REQUEST, others are passed to
+ *   pkt_sendmsg().
+ *
+ * Returned Value:
+ *   The number of the bytes sent from the ring; a negated errno value if
+ *   no frame could be sent.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_sendmsg(FAR struct socket *psock,
+                         FAR const struct msghdr *msg, int flags);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
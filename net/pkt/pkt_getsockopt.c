@@ -32,6 +32,8 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <netpacket/packet.h>
+
 #include <nuttx/net/net.h>
 #include <nuttx/net/pkt.h>
 
@@ -113,6 +115,22 @@ int pkt_getsockopt(FAR struct socket *psock, int level, int option,
           }
 #endif
 
+#ifdef CONFIG_NET_PKT_MMAP
+      case PACKET_VERSION:
+        {
+          FAR struct pkt_conn_s *conn = psock->s_conn;
+
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = conn->tpversion;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized RAW PKT socket option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -174,13 +174,24 @@ static int pkt_in(FAR struct net_driver_s *dev)
 #if defined(CONFIG_NET_TIMESTAMP) && !defined(CONFIG_ARCH_HAVE_NETDEV_TIMESTAMP)
       /* Get system as timestamp if no hardware timestamp */
 
-      if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP) ||
-          _SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMPNS))
+      if ((_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP) ||
+           _SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMPNS)) &&
+          (dev->d_features & NETDEV_RX_TIME) == 0)
         {
           clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
         }
 #endif /* CONFIG_NET_TIMESTAMP */
 
+#ifdef CONFIG_NET_PKT_MMAP
+      /* A socket with the receive ring takes the packet into the ring */
+
+      if (pkt_ring_input(dev, conn) == OK)
+        {
+          pkt_conn_list_unlock();
+          return OK;
+        }
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -0,0 +1,832 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <debug.h>
+
+#include <net/if_arp.h>
+#include <netpacket/packet.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "devif/devif.h"
+#include "utils/utils.h"
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_MMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The packets in a receive block are aligned to 8 bytes */
+
+#define PKT_RING_ALIGN(x)  (((x) + 7) & ~7)
+
+/* The block header, the sockaddr_ll after a packet header and the offset
+ * of the packet data in a transmit frame.
+ */
+
+#define PKT_RING_BLKHDR    PKT_RING_ALIGN(sizeof(struct tpacket_block_desc))
+#define PKT_RING_SLLOFF    TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+#define PKT_RING_TXOFF     (TPACKET3_HDRLEN - sizeof(struct sockaddr_ll))
+
+/* Block timeout in milliseconds if tp_retire_blk_tov is zero */
+
+#define PKT_RING_DEFTMO    8
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct ether_addr g_broadcast_ethaddr =
+{
+  {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_block and pkt_ring_frame
+ *
+ * Description:
+ *   Return a receive block or a transmit frame by its index.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tpacket_block_desc *
+pkt_ring_block(FAR struct pkt_ring_s *ring, uint32_t index)
+{
+  return (FAR struct tpacket_block_desc *)
+         (ring->pr_base + index * ring->pr_bsize);
+}
+
+static inline FAR struct tpacket3_hdr *
+pkt_ring_frame(FAR struct pkt_ring_s *ring, uint32_t index)
+{
+  uint32_t nframes = ring->pr_bsize / ring->pr_fsize;
+
+  return (FAR struct tpacket3_hdr *)
+         (ring->pr_base + index / nframes * ring->pr_bsize +
+          index % nframes * ring->pr_fsize);
+}
+
+/****************************************************************************
+ * Name: pkt_ringmem_release
+ *
+ * Description:
+ *   Drop a reference to the ring memory, free it with the last one.
+ *
+ ****************************************************************************/
+
+static void pkt_ringmem_release(FAR struct pkt_ringmem_s *mem)
+{
+  if (atomic_fetch_sub(&mem->pm_refs, 1) == 1)
+    {
+      kumm_free(mem->pm_base);
+      kmm_free(mem);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_munmap
+ *
+ * Description:
+ *   Undo a mapping done by pkt_ring_mmap(), the whole ring only.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_munmap(FAR struct task_group_s *group,
+                           FAR struct mm_map_entry_s *entry,
+                           FAR void *start, size_t length)
+{
+  FAR struct pkt_ringmem_s *mem = entry->priv.p;
+  int ret;
+
+  if (start != entry->vaddr || length < entry->length)
+    {
+      nerr("ERROR: Cannot unmap a part of the packet ring\n");
+      return -ENOSYS;
+    }
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  if (ret >= 0)
+    {
+      pkt_ringmem_release(mem);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_notify
+ *
+ * Description:
+ *   Wake up the threads polling for a receive block.
+ *
+ * Assumptions:
+ *   The device is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_notify(FAR struct pkt_conn_s *conn)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+    {
+      FAR struct pkt_poll_s *info = &conn->pollinfo[i];
+
+      if (info->conn != NULL)
+        {
+          poll_notify(&info->fds, 1, POLLIN);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_retire
+ *
+ * Description:
+ *   Hand the open receive block over to the application.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_retire(FAR struct pkt_ring_s *ring, uint32_t status)
+{
+  FAR struct tpacket_block_desc *desc = pkt_ring_block(ring, ring->pr_head);
+
+  if (ring->pr_lost)
+    {
+      status       |= TP_STATUS_LOSING;
+      ring->pr_lost = false;
+    }
+
+  desc->hdr.bh1.blk_len = ring->pr_fill;
+
+  /* The packets must be visible before the block changes the owner */
+
+  SMP_WMB();
+  desc->hdr.bh1.block_status = TP_STATUS_USER | status;
+
+  ring->pr_head = (ring->pr_head + 1) % ring->pr_bnr;
+  ring->pr_fill = 0;
+  ring->pr_last = 0;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_timeout
+ *
+ * Description:
+ *   Retire the open receive block when no more packets fill it in time.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_timeout(FAR void *arg)
+{
+  FAR struct pkt_conn_s *conn = arg;
+  FAR struct net_driver_s *dev = pkt_find_device(conn);
+
+  conn_dev_lock(&conn->sconn, dev);
+
+  if (conn->rxring.pr_base != NULL && conn->rxring.pr_fill != 0)
+    {
+      pkt_ring_retire(&conn->rxring, TP_STATUS_BLK_TMO);
+      pkt_ring_notify(conn);
+    }
+
+  conn_dev_unlock(&conn->sconn, dev);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_open
+ *
+ * Description:
+ *   Open the next receive block if the application has released it.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+static bool pkt_ring_open(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *desc = pkt_ring_block(ring, ring->pr_head);
+
+  if (desc->hdr.bh1.block_status != TP_STATUS_KERNEL)
+    {
+      return false;
+    }
+
+  /* Don't write the block before the release by the application */
+
+  SMP_RMB();
+
+  desc->version                     = TPACKET_V3;
+  desc->offset_to_priv              = PKT_RING_BLKHDR;
+  desc->hdr.bh1.num_pkts            = 0;
+  desc->hdr.bh1.offset_to_first_pkt = ring->pr_first;
+  desc->hdr.bh1.blk_len             = 0;
+  desc->hdr.bh1.seq_num             = ++ring->pr_seq;
+
+  ring->pr_fill = ring->pr_first;
+  ring->pr_last = 0;
+
+  work_queue(LPWORK, &conn->rxwork, pkt_ring_timeout, conn, ring->pr_tmo);
+  return true;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_check
+ *
+ * Description:
+ *   Validate the geometry of a requested ring, return its size.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_check(int option, FAR const struct tpacket_req3 *req,
+                          FAR size_t *size)
+{
+  uint32_t nframes;
+
+  if (req->tp_block_nr == 0)
+    {
+      *size = 0;
+      return OK;
+    }
+
+  if (req->tp_block_size == 0 ||
+      req->tp_block_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size < TPACKET3_HDRLEN ||
+      req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size > req->tp_block_size)
+    {
+      return -EINVAL;
+    }
+
+  nframes = req->tp_block_size / req->tp_frame_size;
+  if (req->tp_frame_nr != nframes * req->tp_block_nr ||
+      req->tp_block_nr > SIZE_MAX / req->tp_block_size)
+    {
+      return -EINVAL;
+    }
+
+  if (option == PACKET_RX_RING &&
+      (req->tp_sizeof_priv >= req->tp_block_size ||
+       PKT_RING_BLKHDR + PKT_RING_ALIGN(req->tp_sizeof_priv) +
+       TPACKET_ALIGN(TPACKET3_HDRLEN) >= req->tp_block_size))
+    {
+      return -EINVAL;
+    }
+
+  *size = (size_t)req->tp_block_nr * req->tp_block_size;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up or, with no blocks requested, release the receive or the
+ *   transmit ring of a packet socket.
+ *
+ * Input Parameters:
+ *   conn   - The packet socket connection
+ *   option - PACKET_RX_RING or PACKET_TX_RING
+ *   req    - The geometry of the ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -EBUSY is
+ *   returned while the rings are mapped.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, int option,
+                   FAR const struct tpacket_req3 *req)
+{
+  FAR struct pkt_ringmem_s *mem = NULL;
+  FAR struct pkt_ring_s *rx = &conn->rxring;
+  FAR struct pkt_ring_s *tx = &conn->txring;
+  FAR struct pkt_ring_s *ring;
+  size_t rxsize;
+  size_t txsize;
+  size_t size;
+  int ret;
+
+  if (conn->tpversion != TPACKET_V3)
+    {
+      return -EINVAL;
+    }
+
+  ret = pkt_ring_check(option, req, &size);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  conn_lock(&conn->sconn);
+
+  /* The layout can't change under the mappings */
+
+  if (conn->ringmem != NULL && atomic_read(&conn->ringmem->pm_refs) > 1)
+    {
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  if (option == PACKET_RX_RING)
+    {
+      ring   = rx;
+      rxsize = size;
+      txsize = (size_t)tx->pr_bnr * tx->pr_bsize;
+    }
+  else
+    {
+      ring   = tx;
+      rxsize = (size_t)rx->pr_bnr * rx->pr_bsize;
+      txsize = size;
+    }
+
+  /* Both rings live in one allocation so that one mmap() covers them */
+
+  if (rxsize + txsize > 0)
+    {
+      mem = kmm_zalloc(sizeof(struct pkt_ringmem_s));
+      if (mem == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
+      mem->pm_base = kumm_memalign(TPACKET_ALIGNMENT, rxsize + txsize);
+      if (mem->pm_base == NULL)
+        {
+          kmm_free(mem);
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
+      memset(mem->pm_base, 0, rxsize + txsize);
+      mem->pm_size = rxsize + txsize;
+      atomic_set(&mem->pm_refs, 1);
+    }
+
+  if (conn->ringmem != NULL)
+    {
+      pkt_ringmem_release(conn->ringmem);
+    }
+
+  conn->ringmem = mem;
+
+  ring->pr_bsize = req->tp_block_size;
+  ring->pr_bnr   = req->tp_block_nr;
+  ring->pr_fsize = req->tp_frame_size;
+  ring->pr_fnr   = req->tp_frame_nr;
+
+  if (option == PACKET_RX_RING)
+    {
+      ring->pr_first = PKT_RING_BLKHDR +
+                       PKT_RING_ALIGN(req->tp_sizeof_priv);
+      ring->pr_tmo   = MSEC2TICK(req->tp_retire_blk_tov != 0 ?
+                                 req->tp_retire_blk_tov : PKT_RING_DEFTMO);
+    }
+
+  /* The rings restart empty in the new memory */
+
+  rx->pr_base = rxsize > 0 ? mem->pm_base : NULL;
+  rx->pr_head = 0;
+  rx->pr_fill = 0;
+  rx->pr_last = 0;
+  rx->pr_lost = false;
+  tx->pr_base = txsize > 0 ? mem->pm_base + rxsize : NULL;
+  tx->pr_head = 0;
+
+errout_with_lock:
+  conn_unlock(&conn->sconn);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings of a packet socket being closed.  The memory stays
+ *   until the process unmaps it.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  conn_lock(&conn->sconn);
+
+  if (conn->ringmem != NULL)
+    {
+      pkt_ringmem_release(conn->ringmem);
+      conn->ringmem = NULL;
+    }
+
+  memset(&conn->rxring, 0, sizeof(conn->rxring));
+  memset(&conn->txring, 0, sizeof(conn->txring));
+  conn->tpversion = TPACKET_V1;
+
+  conn_unlock(&conn->sconn);
+
+  /* The timeout finds no ring any more, wait for it outside of the lock */
+
+  work_cancel_sync(LPWORK, &conn->rxwork);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the receive ring followed by the transmit ring into the process.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_ringmem_s *mem;
+  int ret = -EINVAL;
+
+  conn_lock(&conn->sconn);
+
+  /* Only the whole rings are mapped, like the other systems do */
+
+  mem = conn->ringmem;
+  if (mem != NULL && map->offset == 0 && map->length == mem->pm_size)
+    {
+      map->vaddr  = mem->pm_base;
+      map->priv.p = mem;
+      map->munmap = pkt_ring_munmap;
+
+      ret = mm_map_add(get_current_mm(), map);
+      if (ret >= 0)
+        {
+          atomic_fetch_add(&mem->pm_refs, 1);
+        }
+    }
+
+  conn_unlock(&conn->sconn);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Store the packet in the device into the receive ring of the
+ *   connection.  It is dropped if the application still owns the next
+ *   block.
+ *
+ * Returned Value:
+ *   OK if the packet has been consumed by the ring; -ENOENT if the
+ *   connection has no receive ring.
+ *
+ * Assumptions:
+ *   The device is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *desc;
+  FAR struct tpacket3_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  struct timespec ts;
+  uint16_t llhdrlen = NET_LL_HDRLEN(dev);
+  uint32_t status = TP_STATUS_USER;
+  uint32_t macoff;
+  uint32_t netoff;
+  uint32_t snaplen;
+  uint32_t space;
+  uint32_t total;
+  uint32_t len;
+  bool retired = false;
+
+  conn_lock(&conn->sconn);
+
+  if (ring->pr_base == NULL)
+    {
+      conn_unlock(&conn->sconn);
+      return -ENOENT;
+    }
+
+  /* Lay out the packet the same way as the other systems, the network
+   * header aligned after the sockaddr_ll and the link layer header.
+   */
+
+  if (conn->socktype == SOCK_DGRAM)
+    {
+      len    = dev->d_len - llhdrlen;
+      netoff = TPACKET_ALIGN(TPACKET3_HDRLEN) + 16;
+      macoff = netoff;
+    }
+  else
+    {
+      len    = dev->d_len;
+      netoff = TPACKET_ALIGN(TPACKET3_HDRLEN + MAX(llhdrlen, 16));
+      macoff = netoff - llhdrlen;
+    }
+
+  /* A packet larger than a block is truncated */
+
+  space   = ring->pr_bsize - ring->pr_first;
+  snaplen = len;
+  if (macoff >= space)
+    {
+      ring->pr_lost = true;
+      goto out;
+    }
+  else if (macoff + snaplen > space)
+    {
+      snaplen = space - macoff;
+      status |= TP_STATUS_COPY;
+    }
+
+  total = PKT_RING_ALIGN(macoff + snaplen);
+
+  if (ring->pr_fill != 0 && ring->pr_fill + total > ring->pr_bsize)
+    {
+      pkt_ring_retire(ring, 0);
+      retired = true;
+    }
+
+  if (ring->pr_fill == 0 && !pkt_ring_open(conn))
+    {
+      /* The application hasn't caught up, drop the packet */
+
+      ring->pr_lost = true;
+      goto out;
+    }
+
+  desc = pkt_ring_block(ring, ring->pr_head);
+  hdr  = (FAR struct tpacket3_hdr *)((FAR uint8_t *)desc + ring->pr_fill);
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_next_offset = 0;
+  hdr->tp_sec         = ts.tv_sec;
+  hdr->tp_nsec        = ts.tv_nsec;
+  hdr->tp_snaplen     = snaplen;
+  hdr->tp_len         = len;
+  hdr->tp_status      = status;
+  hdr->tp_mac         = macoff;
+  hdr->tp_net         = netoff;
+  memset(&hdr->hv1, 0, sizeof(hdr->hv1));
+
+  sll = (FAR struct sockaddr_ll *)((FAR uint8_t *)hdr + PKT_RING_SLLOFF);
+  memset(sll, 0, sizeof(*sll));
+  sll->sll_family  = AF_PACKET;
+  sll->sll_ifindex = dev->d_ifindex;
+
+  if (dev->d_lltype == NET_LL_ETHERNET || dev->d_lltype == NET_LL_IEEE80211)
+    {
+      FAR struct eth_hdr_s *ethhdr = NETLLBUF;
+
+      sll->sll_protocol = ethhdr->type;
+      sll->sll_hatype   = ARPHRD_ETHER;
+      sll->sll_halen    = ETHER_ADDR_LEN;
+      memcpy(sll->sll_addr, ethhdr->src, ETHER_ADDR_LEN);
+
+      if ((ethhdr->dest[0] & 0x01) == 0)
+        {
+          sll->sll_pkttype = memcmp(ethhdr->dest, &dev->d_mac.ether,
+                                    ETHER_ADDR_LEN) == 0 ?
+                             PACKET_HOST : PACKET_OTHERHOST;
+        }
+      else
+        {
+          sll->sll_pkttype = memcmp(ethhdr->dest, &g_broadcast_ethaddr,
+                                    ETHER_ADDR_LEN) == 0 ?
+                             PACKET_BROADCAST : PACKET_MULTICAST;
+        }
+    }
+
+  iob_copyout((FAR uint8_t *)hdr + macoff, dev->d_iob, snaplen,
+              conn->socktype == SOCK_DGRAM ? 0 : -llhdrlen);
+
+  /* Chain the packet to the previous one in the block */
+
+  if (ring->pr_last != 0)
+    {
+      FAR struct tpacket3_hdr *prev = (FAR struct tpacket3_hdr *)
+                                      ((FAR uint8_t *)desc + ring->pr_last);
+
+      prev->tp_next_offset = ring->pr_fill - ring->pr_last;
+    }
+
+  if (desc->hdr.bh1.num_pkts++ == 0)
+    {
+      desc->hdr.bh1.ts_first_pkt.ts_sec  = ts.tv_sec;
+      desc->hdr.bh1.ts_first_pkt.ts_nsec = ts.tv_nsec;
+    }
+
+  desc->hdr.bh1.ts_last_pkt.ts_sec  = ts.tv_sec;
+  desc->hdr.bh1.ts_last_pkt.ts_nsec = ts.tv_nsec;
+
+  ring->pr_last  = ring->pr_fill;
+  ring->pr_fill += total;
+
+out:
+  conn_unlock(&conn->sconn);
+
+  if (retired)
+    {
+      pkt_ring_notify(conn);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if there is a receive block owned by the application.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  uint32_t i;
+
+  if (ring->pr_base != NULL)
+    {
+      for (i = 0; i < ring->pr_bnr; i++)
+        {
+          if ((pkt_ring_block(ring, i)->hdr.bh1.block_status &
+               TP_STATUS_USER) != 0)
+            {
+              return true;
+            }
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_sendmsg
+ *
+ * Description:
+ *   A send of no data on a socket with the transmit ring sends all the
+ *   frames marked TP_STATUS_SEND_REQUEST, others are passed to
+ *   pkt_sendmsg().
+ *
+ * Returned Value:
+ *   The number of the bytes sent from the ring; a negated errno value if
+ *   no frame could be sent.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_sendmsg(FAR struct socket *psock,
+                         FAR const struct msghdr *msg, int flags)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_ringmem_s *mem;
+  struct pkt_ring_s ring;
+  struct msghdr frame;
+  struct iovec iov;
+  ssize_t total = 0;
+  ssize_t ret = OK;
+  uint32_t index;
+  uint32_t n;
+
+  if (msg->msg_iovlen != 1 || msg->msg_iov->iov_len != 0)
+    {
+      return pkt_sendmsg(psock, msg, flags);
+    }
+
+  /* Hold the memory, the layout is fixed while it is referenced */
+
+  conn_lock(&conn->sconn);
+  mem = conn->ringmem;
+  if (mem == NULL || conn->txring.pr_base == NULL)
+    {
+      conn_unlock(&conn->sconn);
+      return pkt_sendmsg(psock, msg, flags);
+    }
+
+  atomic_fetch_add(&mem->pm_refs, 1);
+  ring = conn->txring;
+  conn_unlock(&conn->sconn);
+
+  frame             = *msg;
+  frame.msg_iov     = &iov;
+  frame.msg_iovlen  = 1;
+
+  for (index = ring.pr_head, n = 0; n < ring.pr_fnr; n++)
+    {
+      FAR struct tpacket3_hdr *hdr = pkt_ring_frame(&ring, index);
+
+      if (hdr->tp_status != TP_STATUS_SEND_REQUEST)
+        {
+          break;
+        }
+
+      /* Read the frame only after its status */
+
+      SMP_RMB();
+
+      if (hdr->tp_len == 0 || hdr->tp_len > ring.pr_fsize - PKT_RING_TXOFF)
+        {
+          hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+          ret = -EINVAL;
+          break;
+        }
+
+      hdr->tp_status = TP_STATUS_SENDING;
+      iov.iov_base   = (FAR uint8_t *)hdr + PKT_RING_TXOFF;
+      iov.iov_len    = hdr->tp_len;
+
+      ret = pkt_sendmsg(psock, &frame, flags);
+      if (ret < 0)
+        {
+          /* Leave the frame for the next send */
+
+          hdr->tp_status = TP_STATUS_SEND_REQUEST;
+          break;
+        }
+
+      SMP_WMB();
+      hdr->tp_status = TP_STATUS_AVAILABLE;
+
+      total += ret;
+      index  = (index + 1) % ring.pr_fnr;
+    }
+
+  conn_lock(&conn->sconn);
+  if (conn->ringmem == mem)
+    {
+      conn->txring.pr_head = index;
+    }
+
+  conn_unlock(&conn->sconn);
+  pkt_ringmem_release(mem);
+
+  return total > 0 ? total : ret;
+}
+
+#endif /* CONFIG_NET_PKT_MMAP */
+#endif /* CONFIG_NET && CONFIG_NET_PKT */
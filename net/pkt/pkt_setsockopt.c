@@ -172,6 +172,52 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_PKT_MMAP
+      case PACKET_VERSION:
+        {
+          FAR struct pkt_conn_s *conn = psock->s_conn;
+          int version;
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          /* Only the block ring format is supported */
+
+          version = *(FAR const int *)value;
+          if (version != TPACKET_V3)
+            {
+              return -EINVAL;
+            }
+
+          conn_lock(&conn->sconn);
+          if (conn->ringmem != NULL)
+            {
+              ret = -EBUSY;
+            }
+          else
+            {
+              conn->tpversion = version;
+            }
+
+          conn_unlock(&conn->sconn);
+        }
+        break;
+
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        {
+          if (value_len < sizeof(struct tpacket_req3))
+            {
+              return -EINVAL;
+            }
+
+          ret = pkt_ring_setup(psock->s_conn, option, value);
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized PKT option: %d\n", option);
         ret = -ENOPROTOOPT;
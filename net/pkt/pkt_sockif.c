@@ -77,7 +77,11 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_connect */
   NULL,            /* si_accept */
   pkt_netpoll,     /* si_poll */
+#ifdef CONFIG_NET_PKT_MMAP
+  pkt_ring_sendmsg, /* si_sendmsg */
+#else
   pkt_sendmsg,     /* si_sendmsg */
+#endif
   pkt_recvmsg,     /* si_recvmsg */
   pkt_close,       /* si_close */
   NULL,            /* si_ioctl */
@@ -87,6 +91,12 @@ const struct sock_intf_s g_pkt_sockif =
   , pkt_getsockopt /* si_getsockopt */
   , pkt_setsockopt /* si_setsockopt */
 #endif
+#ifdef CONFIG_NET_PKT_MMAP
+#  ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#  endif
+  , pkt_ring_mmap  /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -126,6 +136,10 @@ static int pkt_sockif_alloc(FAR struct socket *psock)
 
   conn->type = psock->s_proto;
 
+#ifdef CONFIG_NET_PKT_MMAP
+  conn->socktype = psock->s_type;
+#endif
+
 #ifdef CONFIG_NET_PKT_WRITE_BUFFERS
 #  if CONFIG_NET_SEND_BUFSIZE > 0
   conn->sndbufs = CONFIG_NET_SEND_BUFSIZE;
@@ -362,6 +376,14 @@ static int pkt_close(FAR struct socket *psock)
 
           if (conn->crefs <= 1)
             {
+#ifdef CONFIG_NET_PKT_MMAP
+              /* Release the rings before any lock is held, the block
+               * timeout work takes them.
+               */
+
+              pkt_ring_free(conn);
+#endif
+
               conn_dev_lock(&conn->sconn, dev);
 
               /* Yes... free any read-ahead data */
@@ -68,6 +68,10 @@ static int netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_IPFRAG
+static int netprocfs_ipfrag_1(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_ipfrag_2(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_IPFRAG */
 
 /****************************************************************************
  * Private Data
@@ -102,6 +106,11 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_IPFRAG
+  , netprocfs_ipfrag_1
+  , netprocfs_ipfrag_2
+#endif /* CONFIG_NET_IPFRAG */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -449,6 +458,34 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_ipfrag_1
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPFRAG)
+static int netprocfs_ipfrag_1(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  Reass    Frg: %04x   Ok:  %04x   Dup: %04x\n",
+                  g_netstats.ipfrag.recv, g_netstats.ipfrag.reass,
+                  g_netstats.ipfrag.dup);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPFRAG */
+
+/****************************************************************************
+ * Name: netprocfs_ipfrag_2
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPFRAG)
+static int netprocfs_ipfrag_2(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "           Tmo: %04x   Evc: %04x   Mem: %04x\n",
+                  g_netstats.ipfrag.timeout, g_netstats.ipfrag.evict,
+                  g_netstats.ipfrag.nomem);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPFRAG */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -39,6 +39,7 @@
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -63,6 +64,9 @@
 int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_ipv4_s *route;
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+  int ret;
+#endif
 
   /* Allocate a route entry */
 
@@ -84,6 +88,16 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_lockroute_ipv4();
 
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+  ret = net_trieroute_add_ipv4(route);
+  if (ret < 0)
+    {
+      net_unlockroute_ipv4();
+      net_freeroute_ipv4(route);
+      return ret;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
@@ -100,6 +114,9 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
                       net_ipv6addr_t router)
 {
   FAR struct net_route_ipv6_s *route;
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+  int ret;
+#endif
 
   /* Allocate a route entry */
 
@@ -121,6 +138,16 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_lockroute_ipv6();
 
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+  ret = net_trieroute_add_ipv6(route);
+  if (ret < 0)
+    {
+      net_unlockroute_ipv6();
+      net_freeroute_ipv6(route);
+      return ret;
+    }
+#endif
+
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
   net_unlockroute_ipv6();
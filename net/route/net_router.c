@@ -37,6 +37,7 @@
 #include "devif/devif.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 #include "utils/utils.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -264,6 +265,16 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+  /* Look up the trie unless the table has routes only the scan can match */
+
+  ret = net_trieroute_ipv4(target, router, prefixlen);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -358,6 +369,16 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+  /* Look up the trie unless the table has routes only the scan can match */
+
+  ret = net_trieroute_ipv6(target, router, prefixlen);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
@@ -0,0 +1,643 @@
+/****************************************************************************
+ * net/route/net_trieroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/rcu.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+#include "route/trieroute.h"
+
+#if defined(CONFIG_ROUTE_IPv4_TRIEROUTE) || defined(CONFIG_ROUTE_IPv6_TRIEROUTE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A node of the path compressed binary trie.  A node only exists for the
+ * prefix of a route or where the prefixes of two subtrees diverge, so the
+ * lookup only visits the nodes at the real branches.  A branch node has no
+ * route and always has two children.
+ *
+ * The lookup walks the trie without the routing table lock.  The writers
+ * publish a node only after it is complete and free the unlinked nodes and
+ * the route only after synchronize_rcu().
+ */
+
+struct route_trie_s
+{
+  FAR struct route_trie_s *child[2]; /* Subtrees of the next bit 0 and 1 */
+  FAR void *route;                   /* The first route of the prefix in
+                                      * the list, NULL in a branch node */
+  uint8_t len;                       /* The prefix length in bits */
+  uint8_t key[1];                    /* The prefix in network order, the
+                                      * actual size is the address size */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The tries and the number of routes with the non-contiguous netmasks,
+ * which can't be in the trie.
+ */
+
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+static FAR struct route_trie_s *g_ipv4_trie;
+static unsigned int g_ipv4_nlinear;
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+static FAR struct route_trie_s *g_ipv6_trie;
+static unsigned int g_ipv6_nlinear;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_bit
+ *
+ * Description:
+ *   Return the bit of a key at the position, counted from the MS bit.
+ *
+ ****************************************************************************/
+
+static inline int trie_bit(FAR const uint8_t *key, unsigned int pos)
+{
+  return (key[pos >> 3] >> (7 - (pos & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of the leading bits two keys have in common, up to
+ *   len.  The bits before from are known to be the same already.
+ *
+ ****************************************************************************/
+
+static unsigned int trie_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                                unsigned int from, unsigned int len)
+{
+  unsigned int pos;
+
+  for (pos = from & ~7; pos < len; pos += 8)
+    {
+      uint8_t diff = a[pos >> 3] ^ b[pos >> 3];
+
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              pos++;
+            }
+
+          return pos < len ? pos : len;
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: trie_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a netmask, or -1 if it isn't contiguous.
+ *
+ ****************************************************************************/
+
+static int trie_prefixlen(FAR const uint8_t *mask, unsigned int keylen)
+{
+  unsigned int i;
+  uint8_t byte;
+  int len = 0;
+
+  for (i = 0; i < keylen && mask[i] == 0xff; i++)
+    {
+      len += 8;
+    }
+
+  if (i < keylen)
+    {
+      for (byte = mask[i++]; (byte & 0x80) != 0; byte <<= 1)
+        {
+          len++;
+        }
+
+      if (byte != 0)
+        {
+          return -1;
+        }
+
+      for (; i < keylen; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -1;
+            }
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: trie_alloc
+ ****************************************************************************/
+
+static FAR struct route_trie_s *trie_alloc(FAR const uint8_t *key,
+                                           unsigned int len,
+                                           unsigned int keylen,
+                                           FAR void *route)
+{
+  FAR struct route_trie_s *node;
+
+  node = kmm_malloc(offsetof(struct route_trie_s, key) + keylen);
+  if (node != NULL)
+    {
+      node->child[0] = NULL;
+      node->child[1] = NULL;
+      node->route    = route;
+      node->len      = len;
+      memcpy(node->key, key, keylen);
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Add a route with the masked key of the prefix to the trie.  If the
+ *   prefix has a route already, that one keeps matching first like in the
+ *   list.
+ *
+ ****************************************************************************/
+
+static int trie_insert(FAR struct route_trie_s **root,
+                       FAR const uint8_t *key, unsigned int len,
+                       unsigned int keylen, FAR void *route)
+{
+  FAR struct route_trie_s **pp = root;
+  FAR struct route_trie_s *branch;
+  FAR struct route_trie_s *leaf;
+  FAR struct route_trie_s *node;
+  unsigned int common = 0;
+
+  while ((node = *pp) != NULL)
+    {
+      common = trie_common(node->key, key, common,
+                           node->len < len ? node->len : len);
+      if (common < node->len)
+        {
+          break;
+        }
+
+      /* The node is a prefix of the new one */
+
+      if (node->len == len)
+        {
+          if (node->route == NULL)
+            {
+              rcu_assign_pointer(node->route, route);
+            }
+
+          return OK;
+        }
+
+      pp = &node->child[trie_bit(key, node->len)];
+    }
+
+  leaf = trie_alloc(key, len, keylen, route);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (node == NULL)
+    {
+      rcu_assign_pointer(*pp, leaf);
+    }
+  else if (common == len)
+    {
+      /* The new prefix is a prefix of the node, insert it above */
+
+      leaf->child[trie_bit(node->key, len)] = node;
+      rcu_assign_pointer(*pp, leaf);
+    }
+  else
+    {
+      /* The prefixes diverge at common, branch there */
+
+      branch = trie_alloc(key, common, keylen, NULL);
+      if (branch == NULL)
+        {
+          kmm_free(leaf);
+          return -ENOMEM;
+        }
+
+      branch->child[trie_bit(key, common)]       = leaf;
+      branch->child[trie_bit(node->key, common)] = node;
+      rcu_assign_pointer(*pp, branch);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_remove
+ *
+ * Description:
+ *   Remove a route from the trie, replace is the next route of the same
+ *   prefix or NULL.  The unlinked nodes are returned in dead, a lookup may
+ *   still be at them.
+ *
+ ****************************************************************************/
+
+static void trie_remove(FAR struct route_trie_s **root,
+                        FAR const uint8_t *key, unsigned int len,
+                        FAR void *route, FAR void *replace,
+                        FAR struct route_trie_s **dead)
+{
+  FAR struct route_trie_s **pparent = NULL;
+  FAR struct route_trie_s **pp = root;
+  FAR struct route_trie_s *parent;
+  FAR struct route_trie_s *node;
+  unsigned int common = 0;
+
+  dead[0] = NULL;
+  dead[1] = NULL;
+
+  while ((node = *pp) != NULL && node->len < len)
+    {
+      common = trie_common(node->key, key, common, node->len);
+      if (common < node->len)
+        {
+          return;
+        }
+
+      pparent = pp;
+      pp      = &node->child[trie_bit(key, node->len)];
+    }
+
+  /* Only the first route of the prefix is in the trie */
+
+  if (node == NULL || node->len != len || node->route != route)
+    {
+      return;
+    }
+
+  node->route = replace;
+  if (replace != NULL || (node->child[0] != NULL && node->child[1] != NULL))
+    {
+      return;
+    }
+
+  *pp = node->child[0] != NULL ? node->child[0] : node->child[1];
+  dead[0] = node;
+
+  /* A branch node which lost a leaf has a single child left */
+
+  if (*pp == NULL && pparent != NULL)
+    {
+      parent = *pparent;
+      if (parent->route == NULL)
+        {
+          *pparent = parent->child[0] != NULL ?
+                     parent->child[0] : parent->child[1];
+          dead[1] = parent;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: trie_lookup
+ *
+ * Description:
+ *   Return the route of the longest prefix matching the address and its
+ *   length, or NULL.
+ *
+ ****************************************************************************/
+
+static FAR void *trie_lookup(FAR struct route_trie_s *node,
+                             FAR const uint8_t *addr, unsigned int keylen,
+                             FAR int *matchlen)
+{
+  FAR void *route = NULL;
+  unsigned int common = 0;
+
+  while (node != NULL)
+    {
+      common = trie_common(node->key, addr, common, node->len);
+      if (common < node->len)
+        {
+          break;
+        }
+
+      if (node->route != NULL)
+        {
+          route     = node->route;
+          *matchlen = node->len;
+        }
+
+      if (node->len >= keylen * 8)
+        {
+          break;
+        }
+
+      node = node->child[trie_bit(addr, node->len)];
+    }
+
+  return route;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_trieroute_add_ipv4 and net_trieroute_add_ipv6
+ *
+ * Description:
+ *   Index a new route of the in-memory routing table in the longest prefix
+ *   match trie.
+ *
+ * Input Parameters:
+ *   route - The new route, not yet in the routing table list
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+int net_trieroute_add_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  in_addr_t key = route->target & route->netmask;
+  int len;
+
+  len = trie_prefixlen((FAR const uint8_t *)&route->netmask,
+                       sizeof(in_addr_t));
+  if (len < 0)
+    {
+      g_ipv4_nlinear++;
+      return OK;
+    }
+
+  return trie_insert(&g_ipv4_trie, (FAR const uint8_t *)&key, len,
+                     sizeof(in_addr_t), route);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+int net_trieroute_add_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  net_ipv6addr_t key;
+  int len;
+  int i;
+
+  len = trie_prefixlen((FAR const uint8_t *)route->netmask,
+                       sizeof(net_ipv6addr_t));
+  if (len < 0)
+    {
+      g_ipv6_nlinear++;
+      return OK;
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      key[i] = route->target[i] & route->netmask[i];
+    }
+
+  return trie_insert(&g_ipv6_trie, (FAR const uint8_t *)key, len,
+                     sizeof(net_ipv6addr_t), route);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_trieroute_del_ipv4 and net_trieroute_del_ipv6
+ *
+ * Description:
+ *   Remove a route from the longest prefix match trie, another route of
+ *   the same prefix still in the routing table list takes its place.
+ *
+ * Input Parameters:
+ *   route - The route, already removed from the routing table list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+void net_trieroute_del_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  FAR struct net_route_ipv4_entry_s *entry;
+  FAR struct net_route_ipv4_s *replace = NULL;
+  FAR struct route_trie_s *dead[2];
+  in_addr_t key = route->target & route->netmask;
+  int len;
+
+  len = trie_prefixlen((FAR const uint8_t *)&route->netmask,
+                       sizeof(in_addr_t));
+  if (len < 0)
+    {
+      g_ipv4_nlinear--;
+      return;
+    }
+
+  for (entry = g_ipv4_routes.head; entry != NULL; entry = entry->flink)
+    {
+      if (net_ipv4addr_cmp(entry->entry.netmask, route->netmask) &&
+          net_ipv4addr_maskcmp(entry->entry.target, route->target,
+                               route->netmask))
+        {
+          replace = &entry->entry;
+          break;
+        }
+    }
+
+  trie_remove(&g_ipv4_trie, (FAR const uint8_t *)&key, len, route,
+              replace, dead);
+
+  /* The lookups which may have found the route or the nodes are gone */
+
+  synchronize_rcu();
+  kmm_free(dead[0]);
+  kmm_free(dead[1]);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+void net_trieroute_del_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  FAR struct net_route_ipv6_entry_s *entry;
+  FAR struct net_route_ipv6_s *replace = NULL;
+  FAR struct route_trie_s *dead[2];
+  net_ipv6addr_t key;
+  int len;
+  int i;
+
+  len = trie_prefixlen((FAR const uint8_t *)route->netmask,
+                       sizeof(net_ipv6addr_t));
+  if (len < 0)
+    {
+      g_ipv6_nlinear--;
+      return;
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      key[i] = route->target[i] & route->netmask[i];
+    }
+
+  for (entry = g_ipv6_routes.head; entry != NULL; entry = entry->flink)
+    {
+      if (net_ipv6addr_cmp(entry->entry.netmask, route->netmask) &&
+          net_ipv6addr_maskcmp(entry->entry.target, route->target,
+                               route->netmask))
+        {
+          replace = &entry->entry;
+          break;
+        }
+    }
+
+  trie_remove(&g_ipv6_trie, (FAR const uint8_t *)key, len, route,
+              replace, dead);
+
+  /* The lookups which may have found the route or the nodes are gone */
+
+  synchronize_rcu();
+  kmm_free(dead[0]);
+  kmm_free(dead[1]);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_trieroute_ipv4 and net_trieroute_ipv6
+ *
+ * Description:
+ *   Find the router of the longest prefix matching the target with the
+ *   trie, as net_ipv4_router()/net_ipv6_router() do with the list.  The
+ *   lookup doesn't take the routing table lock.
+ *
+ * Input Parameters:
+ *   target    - An IP address on a remote network to use in the lookup.
+ *   router    - The address of router on a local network that can forward
+ *               our packets to the target.
+ *   prefixlen - Only match prefix longer than prefixlen.
+ *
+ * Returned Value:
+ *   OK on success, -ENOENT if there is no route, or -ENOSYS if the table
+ *   has the routes with the non-contiguous netmasks which only the list
+ *   can match.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+int net_trieroute_ipv4(in_addr_t target, FAR in_addr_t *router,
+                       int8_t prefixlen)
+{
+  FAR struct net_route_ipv4_s *route;
+  int ret = -ENOENT;
+  int epoch;
+  int len;
+
+  epoch = rcu_read_lock();
+
+  if (g_ipv4_nlinear > 0)
+    {
+      ret = -ENOSYS;
+    }
+  else
+    {
+      route = trie_lookup(g_ipv4_trie, (FAR const uint8_t *)&target,
+                          sizeof(in_addr_t), &len);
+      if (route != NULL && len > prefixlen)
+        {
+          net_ipv4addr_copy(*router, route->router);
+          ret = OK;
+        }
+    }
+
+  rcu_read_unlock(epoch);
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+int net_trieroute_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router,
+                       int16_t prefixlen)
+{
+  FAR struct net_route_ipv6_s *route;
+  int ret = -ENOENT;
+  int epoch;
+  int len;
+
+  epoch = rcu_read_lock();
+
+  if (g_ipv6_nlinear > 0)
+    {
+      ret = -ENOSYS;
+    }
+  else
+    {
+      route = trie_lookup(g_ipv6_trie, (FAR const uint8_t *)target,
+                          sizeof(net_ipv6addr_t), &len);
+      if (route != NULL && len > prefixlen)
+        {
+          net_ipv6addr_copy(router, route->router);
+          ret = OK;
+        }
+    }
+
+  rcu_read_unlock(epoch);
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_IPv4_TRIEROUTE || CONFIG_ROUTE_IPv6_TRIEROUTE */
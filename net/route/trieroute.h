@@ -0,0 +1,126 @@
+/****************************************************************************
+ * net/route/trieroute.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_TRIEROUTE_H
+#define __NET_ROUTE_TRIEROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_ROUTE_IPv4_TRIEROUTE) || defined(CONFIG_ROUTE_IPv6_TRIEROUTE)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_trieroute_add_ipv4 and net_trieroute_add_ipv6
+ *
+ * Description:
+ *   Index a new route of the in-memory routing table in the longest prefix
+ *   match trie.
+ *
+ * Input Parameters:
+ *   route - The new route, not yet in the routing table list
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+int net_trieroute_add_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+int net_trieroute_add_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_trieroute_del_ipv4 and net_trieroute_del_ipv6
+ *
+ * Description:
+ *   Remove a route from the longest prefix match trie, another route of
+ *   the same prefix still in the routing table list takes its place.  This
+ *   waits for the lookups which may still use the route, so it can be freed
+ *   on return.
+ *
+ * Input Parameters:
+ *   route - The route, already removed from the routing table list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+void net_trieroute_del_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+void net_trieroute_del_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_trieroute_ipv4 and net_trieroute_ipv6
+ *
+ * Description:
+ *   Find the router of the longest prefix matching the target with the
+ *   trie, as net_ipv4_router()/net_ipv6_router() do with the list.  The
+ *   lookup doesn't take the routing table lock.
+ *
+ * Input Parameters:
+ *   target    - An IP address on a remote network to use in the lookup.
+ *   router    - The address of router on a local network that can forward
+ *               our packets to the target.
+ *   prefixlen - Only match prefix longer than prefixlen.
+ *
+ * Returned Value:
+ *   OK on success, -ENOENT if there is no route, or -ENOSYS if the table
+ *   has the routes with the non-contiguous netmasks which only the list
+ *   can match.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIEROUTE
+int net_trieroute_ipv4(in_addr_t target, FAR in_addr_t *router,
+                       int8_t prefixlen);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIEROUTE
+int net_trieroute_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router,
+                       int16_t prefixlen);
+#endif
+
+#endif /* CONFIG_ROUTE_IPv4_TRIEROUTE || CONFIG_ROUTE_IPv6_TRIEROUTE */
+#endif /* __NET_ROUTE_TRIEROUTE_H */
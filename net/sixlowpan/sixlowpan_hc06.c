@@ -59,6 +59,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <string.h>
 #include <debug.h>
 
@@ -118,6 +119,18 @@ struct sixlowpan_addrcontext_s
 
 static struct sixlowpan_addrcontext_s
   g_hc06_addrcontexts[CONFIG_NET_6LOWPAN_MAXADDRCONTEXT];
+
+/* Contexts indexed by their 4-bit context identifier, so that the contexts
+ * carried in received IPHC headers are found without a search.
+ */
+
+static FAR struct sixlowpan_addrcontext_s *g_hc06_ctxbynum[16];
+
+/* The context that matched the last prefix lookup.  Source and destination
+ * of consecutive packets usually share the same prefix.
+ */
+
+static FAR struct sixlowpan_addrcontext_s *g_hc06_lastctx;
 #endif
 
 /* Pointer to the byte where to write next inline field. */
@@ -204,15 +217,9 @@ static FAR struct sixlowpan_addrcontext_s *
    */
 
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
-  int i;
-
-  for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
+  if (number < nitems(g_hc06_ctxbynum))
     {
-      if ((g_hc06_addrcontexts[i].used == 1) &&
-           g_hc06_addrcontexts[i].number == number)
-        {
-          return &g_hc06_addrcontexts[i];
-        }
+      return g_hc06_ctxbynum[number];
     }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 
@@ -237,6 +244,12 @@ static FAR struct sixlowpan_addrcontext_s *
    * used
    */
 
+  if (g_hc06_lastctx != NULL &&
+      net_ipv6addr_prefixcmp(&g_hc06_lastctx->prefix, ipaddr, 64))
+    {
+      return g_hc06_lastctx;
+    }
+
   for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
     {
       if ((g_hc06_addrcontexts[i].used == 1) &&
@@ -250,7 +263,8 @@ static FAR struct sixlowpan_addrcontext_s *
                 NTOHS(ipaddr[6]), NTOHS(ipaddr[7]),
                 g_hc06_addrcontexts[i].number);
 
-          return &g_hc06_addrcontexts[i];
+          g_hc06_lastctx = &g_hc06_addrcontexts[i];
+          return g_hc06_lastctx;
         }
     }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
@@ -594,9 +608,7 @@ static void uncompress_addr(FAR const struct netdev_varaddr_s *addr,
 void sixlowpan_hc06_initialize(void)
 {
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
-#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1
   int i;
-#endif
 
   /* Preinitialize any address contexts for better header compression
    * (Saves up to 13 bytes per 6lowpan packet).
@@ -682,6 +694,22 @@ void sixlowpan_hc06_initialize(void)
 #endif /* SIXLOWPAN_CONF_ADDR_CONTEXT_1 */
     }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1 */
+
+  /* Index the contexts in use by their context identifier */
+
+  memset(g_hc06_ctxbynum, 0, sizeof(g_hc06_ctxbynum));
+  g_hc06_lastctx = NULL;
+
+  for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
+    {
+      if (g_hc06_addrcontexts[i].used == 1 &&
+          g_hc06_addrcontexts[i].number < nitems(g_hc06_ctxbynum) &&
+          g_hc06_ctxbynum[g_hc06_addrcontexts[i].number] == NULL)
+        {
+          g_hc06_ctxbynum[g_hc06_addrcontexts[i].number] =
+            &g_hc06_addrcontexts[i];
+        }
+    }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 }
 
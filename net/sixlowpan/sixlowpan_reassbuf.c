@@ -46,6 +46,15 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Interval between sweeps of the active reassembly buffers for expired
+ * entries.  Lookups check the age of the matching entry themselves, so the
+ * sweep only needs to reclaim abandoned reassemblies.
+ */
+
+#define NET_6LOWPAN_SWEEP   SEC2TICK(1)
+
+#define REASS_NHASH         CONFIG_NET_6LOWPAN_REASS_HASHSIZE
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -57,9 +66,15 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* Active, allocated reassemby buffers hashed by reassembly tag and
+ * fragment source address.
+ */
+
+static FAR struct sixlowpan_reassbuf_s *g_active_reass[REASS_NHASH];
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+/* Time of the last sweep for expired reassembly buffers */
+
+static clock_t g_reass_sweep;
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -67,9 +82,33 @@ static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the hash bucket of a reassembly from its tag and the low bytes
+ *   of the fragment source address.
+ *
  ****************************************************************************/
 
+static inline unsigned int
+sixlowpan_reass_hash(uint16_t reasstag,
+                     FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag;
+
+  if (fragsrc->nv_addrlen > 0)
+    {
+      hash ^= (unsigned int)fragsrc->nv_addr[fragsrc->nv_addrlen - 1] << 8;
+      hash ^= fragsrc->nv_addr[0];
+    }
+
+  return hash % REASS_NHASH;
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -124,31 +163,33 @@ static void sixlowpan_reass_expire(void)
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
   clock_t elapsed;
+  int i;
 
-  /* If reassembly timed out, cancel it */
+  g_reass_sweep = clock_systime_ticks();
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < REASS_NHASH; i++)
     {
-      /* Needed if 'reass' is freed */
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
+        {
+          /* Needed if 'reass' is freed */
 
-      next = reass->rb_flink;
+          next = reass->rb_flink;
 
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not certain.
-       */
+          /* Free any inactive reassembly buffers.  This is done because the
+           * life the reassembly buffer is not certain.
+           */
 
-      if (!reass->rb_active)
-        {
-          sixlowpan_reass_free(reass);
-        }
-      else
-        {
-          /* Get the elpased time of the reassembly */
-
-          elapsed = clock_systime_ticks() - reass->rb_time;
+          if (!reass->rb_active)
+            {
+              sixlowpan_reass_free(reass);
+              continue;
+            }
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* If the reassembly has expired, then free the reassembly
+           * buffer.
+           */
 
+          elapsed = g_reass_sweep - reass->rb_time;
           if (elapsed >= NET_6LOWPAN_TIMEOUT)
             {
               nwarn("WARNING: Reassembly timed out\n");
@@ -177,12 +218,15 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
-  /* Find the reassembly buffer in the list of active reassembly buffers */
+  /* Find the reassembly buffer in its list of active reassembly buffers */
 
-  for (prev = NULL, curr = g_active_reass;
+  head = &g_active_reass[sixlowpan_reass_hash(reass->rb_reasstag,
+                                              &reass->rb_fragsrc)];
+  for (prev = NULL, curr = *head;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -196,7 +240,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *head = reass->rb_flink;
         }
       else
         {
@@ -281,14 +325,20 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
 
-  /* First, removed any expired or inactive reassembly buffers.  This might
-   * free up a pre-allocated buffer for this allocation.
+  /* First, removed any expired or inactive reassembly buffers if the pool
+   * is exhausted or the last sweep is old.  This might free up a
+   * pre-allocated buffer for this allocation.
    */
 
-  sixlowpan_reass_expire();
+  if (g_free_reass == NULL ||
+      clock_systime_ticks() - g_reass_sweep >= NET_6LOWPAN_SWEEP)
+    {
+      sixlowpan_reass_expire();
+    }
 
   /* Now, try the free list first */
 
@@ -328,8 +378,10 @@ FAR struct sixlowpan_reassbuf_s *
 
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      head              = &g_active_reass[sixlowpan_reass_hash(reasstag,
+                                                               fragsrc)];
+      reass->rb_flink   = *head;
+      *head             = reass;
     }
 
   return reass;
@@ -360,17 +412,19 @@ FAR struct sixlowpan_reassbuf_s *
 {
   FAR struct sixlowpan_reassbuf_s *reass;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
-   */
+  /* Sweep the expired reassembly buffers from time to time */
 
-  sixlowpan_reass_expire();
+  if (clock_systime_ticks() - g_reass_sweep >= NET_6LOWPAN_SWEEP)
+    {
+      sixlowpan_reass_expire();
+    }
 
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+  /* Now search for the matching reassembly buffer in the active reassembly
+   * buffers of its hash bucket.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = g_active_reass[sixlowpan_reass_hash(reasstag, fragsrc)];
+       reass != NULL; reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
@@ -380,6 +434,17 @@ FAR struct sixlowpan_reassbuf_s *
       if (reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
+          /* We don't want to return an old reassembly buffer with the same
+           * tag.
+           */
+
+          if (!reass->rb_active ||
+              clock_systime_ticks() - reass->rb_time >= NET_6LOWPAN_TIMEOUT)
+            {
+              sixlowpan_reass_free(reass);
+              return NULL;
+            }
+
           return reass;
         }
     }
@@ -412,10 +477,13 @@ FAR struct sixlowpan_reassbuf_s *
 void sixlowpan_reass_free(FAR struct sixlowpan_reassbuf_s *reass)
 {
   /* First, remove the reassembly buffer from the list of active reassembly
-   * buffers.
+   * buffers.  Buffers provided by the driver are never on that list.
    */
 
-  sixlowpan_remove_active(reass);
+  if (reass->rb_pool != REASS_POOL_RADIO)
+    {
+      sixlowpan_remove_active(reass);
+    }
 
   /* If this is a pre-allocated reassembly buffer structure, then just put it
    * back in the free list.
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -40,6 +41,8 @@
 #include <nuttx/net/tcp.h>
 #include <nuttx/wqueue.h>
 
+#include "devif/devif.h"
+
 #ifdef NET_TCP_HAVE_STACK
 
 /****************************************************************************
@@ -72,6 +75,12 @@
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+#  define TCP_WBSACKED(wrb)          ((wrb)->wb_sacked)
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+#  define TCP_WBXMIT(wrb)            ((wrb)->wb_xmit)
+#endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
@@ -114,6 +123,22 @@
 
 #endif
 
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTOTUNE
+/* The TCP flags for buffer size autotuning */
+
+#define TCP_RCVBUF_LOCK       0x20U /* rcv_bufs set by the user */
+#define TCP_SNDBUF_LOCK       0x40U /* snd_bufs set by the user */
+
+#endif
+
+/* Check if the TCP timer of the connection is not armed */
+
+#ifdef CONFIG_NET_TCP_TIMER_SWEEP
+#  define tcp_timer_available(conn) ((conn)->expiry == 0)
+#else
+#  define tcp_timer_available(conn) work_available(&(conn)->work)
+#endif
+
 /* The Max Range count of TCP Selective ACKs */
 
 #define TCP_SACK_RANGES_MAX   4
@@ -149,6 +174,7 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_conn_s;        /* Forward reference */
 
 /* This is a container that holds the poll-related information */
 
@@ -176,6 +202,43 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm, selected per connection by its name with
+ * the TCP_CONGESTION socket option.  The fast retransmit and the fast
+ * recovery of RFC 6582 and the slow start are common to all of them.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+
+  /* Reset the private state of the algorithm */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Return the slow start threshold after a loss was detected */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+
+  /* Grow cwnd in the congestion avoidance for the newly acked bytes */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* The state of the CUBIC congestion control (RFC 9438) */
+
+struct tcp_cubic_s
+{
+  uint32_t w_max;         /* cwnd before the last reduction */
+  uint32_t origin;        /* The cwnd at the plateau of the cubic curve */
+  uint32_t w_est;         /* The cwnd estimate of Reno for the friendliness */
+  uint32_t k;             /* The time in ms to reach origin */
+  clock_t  epoch;         /* The start of the congestion avoidance epoch */
+};
+#endif
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -209,6 +272,8 @@ struct tcp_conn_s
   /* TCP-specific content follows */
 
   union ip_binding_u u;   /* IP address binding */
+  hash_node_t hactive;    /* Node of the active connection hashtable */
+  hash_node_t hlisten;    /* Node of the listener hashtable */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
   uint8_t  sndseq[4];     /* The sequence number that was last sent by us */
@@ -225,7 +290,11 @@ struct tcp_conn_s
                            * variable */
   uint8_t  rto;           /* Retransmission time-out */
   uint8_t  tcpstateflags; /* TCP state and flags */
+#ifdef CONFIG_NET_TCP_TIMER_SWEEP
+  clock_t  expiry;        /* TCP timer deadline, zero if not armed */
+#else
   struct   work_s work;   /* TCP timer handle */
+#endif
   bool     timeout;       /* Trigger from timer expiry */
   uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
@@ -233,6 +302,7 @@ struct tcp_conn_s
 #ifdef CONFIG_NET_TCP_DELAYED_ACK
   uint8_t  rx_unackseg;   /* Number of un-ACKed received segments */
   uint8_t  rx_acktimer;   /* Time since last ACK sent (units: half-seconds) */
+  uint8_t  rx_quickack;   /* Number of ACKs sent in quick ACK mode */
 #endif
   uint16_t lport;         /* The local TCP port, in network byte order */
   uint16_t rport;         /* The remoteTCP port, in network byte order */
@@ -251,6 +321,11 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  FAR const struct tcp_cc_ops_s *cc_ops; /* The congestion control */
+#  ifdef CONFIG_NET_TCP_CC_CUBIC
+  struct tcp_cubic_s cubic;              /* The state of CUBIC */
+#  endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -265,6 +340,10 @@ struct tcp_conn_s
   uint32_t snd_wl2;
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcv_bufs;      /* Maximum amount of bytes queued in recv */
+#  ifdef CONFIG_NET_TCP_BUFSIZE_AUTOTUNE
+  uint32_t rcv_space;     /* Bytes consumed in the current measurement */
+  clock_t  rcv_stime;     /* Start time of the current measurement */
+#  endif
 #endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
   int32_t  snd_bufs;      /* Maximum amount of bytes queued in send */
@@ -325,6 +404,11 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#  ifdef CONFIG_NET_TCP_RACK
+  clock_t    rack_xmit;   /* Send time of the most recently sent segment
+                           * which has been delivered */
+  clock_t    rack_rtt;    /* The RTT measured with that segment */
+#  endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -412,6 +496,12 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  bool       wb_sacked;    /* The segment is covered by a SACK block */
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  clock_t    wb_xmit;      /* The time of the last transmission */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -454,6 +544,15 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* The congestion control algorithms */
+
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#  ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#  endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -1256,6 +1355,84 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
 uint16_t tcp_rx_mss(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: tcp_synack_stateless
+ *
+ * Description:
+ *   Reply to the SYN segment in the device buffer with a SYN-ACK without a
+ *   connection structure, used to send SYN cookies.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the SYN segment
+ *   listener - The listening connection, used for TTL and TOS
+ *   isn      - The initial sequence number to send
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_synack_stateless(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *listener, uint32_t isn);
+
+/****************************************************************************
+ * Name: tcp_syncookie_synack
+ *
+ * Description:
+ *   Reply to the SYN segment in the device buffer with a SYN-ACK carrying a
+ *   SYN cookie, without allocating a connection.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the SYN segment
+ *   tcp      - The TCP header of the segment
+ *   listener - The listening connection the SYN is for
+ *   iplen    - The length of the IP header
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_syncookie_synack(FAR struct net_driver_s *dev,
+                          FAR struct tcp_hdr_s *tcp,
+                          FAR struct tcp_conn_s *listener,
+                          unsigned int iplen);
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check if the ACK segment in the device buffer completes a handshake
+ *   started with a SYN cookie and, if so, create the connection in the
+ *   TCP_SYN_RCVD state.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the ACK segment
+ *   tcp      - The TCP header of the segment
+ *   listener - The listening connection the ACK is for
+ *
+ * Returned Value:
+ *   The new connection or NULL if the segment carries no valid cookie or
+ *   no connection could be allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *
+tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                     FAR struct tcp_hdr_s *tcp,
+                     FAR struct tcp_conn_s *listener);
+#endif
+
 /****************************************************************************
  * Name: tcp_synack
  *
@@ -1790,6 +1967,49 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
 
 bool tcp_should_send_recvwindow(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_rcvbuf_adjust
+ *
+ * Description:
+ *   Grow the receive buffer according to the rate at which the application
+ *   consumes the received data, measured over one RTT.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure holding connection information.
+ *   copied - Number of bytes just consumed by the application.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_BUFSIZE_AUTOTUNE) && CONFIG_NET_RECV_BUFSIZE > 0
+void tcp_rcvbuf_adjust(FAR struct tcp_conn_s *conn, size_t copied);
+#else
+#  define tcp_rcvbuf_adjust(conn, copied)
+#endif
+
+/****************************************************************************
+ * Name: tcp_sndbuf_adjust
+ *
+ * Description:
+ *   Grow the send buffer according to the amount of data that may be in
+ *   flight on the connection.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_BUFSIZE_AUTOTUNE) && CONFIG_NET_SEND_BUFSIZE > 0
+void tcp_sndbuf_adjust(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_sndbuf_adjust(conn)
+#endif
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
@@ -2356,6 +2576,67 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expired, the connection restarts from the slow start.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_lookup
+ *
+ * Description:
+ *   Find the congestion control algorithm by its name.
+ *
+ * Input Parameters:
+ *   name   - The name of the algorithm, as used by TCP_CONGESTION
+ *
+ * Returned Value:
+ *   The algorithm, or NULL if there is no algorithm with this name.
+ *
+ ****************************************************************************/
+
+FAR const struct tcp_cc_ops_s *tcp_cc_lookup(FAR const char *name);
+#endif
+
+/****************************************************************************
+ * Name: tcp_gso_poll
+ *
+ * Description:
+ *   Cut the large TCP packet in dev->d_iob into segments of d_gsosize
+ *   bytes of payload and hand them to the driver one after another.  The
+ *   large packet is released when done.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the large packet
+ *   callback - The actual sending API provided by the driver
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   The network is locked and the L2 header has been built.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+int tcp_gso_poll(FAR struct net_driver_s *dev,
+                 devif_poll_callback_t callback);
 #endif
 
 #ifdef __cplusplus
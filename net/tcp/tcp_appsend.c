@@ -136,14 +136,25 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
           conn->rx_unackseg = 0;
         }
+      else if (conn->rx_quickack < CONFIG_NET_TCP_QUICKACK_SEGS)
+        {
+          /* Quick ACK mode: ACK every segment at the start of the
+           * connection so that the congestion window of the peer opens
+           * without waiting for the delayed ACKs.
+           */
+
+          conn->rx_quickack++;
+        }
       else
         {
           /* This is only an ACK and there is no pending delayed ACK and
            * no TX data is being sent.  Indicate that there is one un-ACKed
-           * segment and don't send anything now.
+           * segment and don't send anything now, the TCP timer sends the
+           * ACK if no other segment arrives in time.
            */
 
           conn->rx_unackseg = 1;
+          tcp_update_timer(conn);
           return;
         }
     }
@@ -0,0 +1,222 @@
+/****************************************************************************
+ * net/tcp/tcp_autotune.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTOTUNE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The buffer sizes never grow beyond the configured maximum, or beyond the
+ * part of the IOB pool that can be used for TCP buffering if there is no
+ * configured maximum.
+ */
+
+#define TCP_AUTOTUNE_POOLSIZE \
+  ((CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE) * CONFIG_IOB_BUFSIZE)
+
+#if defined(CONFIG_NET_MAX_RECV_BUFSIZE) && CONFIG_NET_MAX_RECV_BUFSIZE > 0
+#  define TCP_AUTOTUNE_MAXRCVBUF \
+     MIN(CONFIG_NET_MAX_RECV_BUFSIZE, TCP_AUTOTUNE_POOLSIZE)
+#else
+#  define TCP_AUTOTUNE_MAXRCVBUF TCP_AUTOTUNE_POOLSIZE
+#endif
+
+#if defined(CONFIG_NET_MAX_SEND_BUFSIZE) && CONFIG_NET_MAX_SEND_BUFSIZE > 0
+#  define TCP_AUTOTUNE_MAXSNDBUF \
+     MIN(CONFIG_NET_MAX_SEND_BUFSIZE, TCP_AUTOTUNE_POOLSIZE)
+#else
+#  define TCP_AUTOTUNE_MAXSNDBUF TCP_AUTOTUNE_POOLSIZE
+#endif
+
+/* The smallest measurement period, used while the RTT estimate (kept in
+ * half-seconds by the retransmission logic) is still zero.
+ */
+
+#define TCP_AUTOTUNE_MINPERIOD MSEC2TICK(CONFIG_NET_TCP_AUTOTUNE_PERIOD)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_grow
+ *
+ * Description:
+ *   Calculate the new buffer size when growing from 'bufs' toward 'target'.
+ *   The growth is limited by 'maxbufs' and by the number of IOBs that are
+ *   currently free, so that buffers do not grow under global IOB pressure.
+ *
+ ****************************************************************************/
+
+static int32_t tcp_autotune_grow(int32_t bufs, uint32_t target,
+                                 uint32_t maxbufs)
+{
+  uint32_t avail;
+
+  if (target > maxbufs)
+    {
+      target = maxbufs;
+    }
+
+  if (target <= (uint32_t)bufs)
+    {
+      return bufs;
+    }
+
+  avail = iob_navail(true) * CONFIG_IOB_BUFSIZE;
+  if (target - bufs > avail)
+    {
+      target = bufs + avail;
+    }
+
+  return target;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_rcvbuf_adjust
+ *
+ * Description:
+ *   Dynamic right-sizing of the receive buffer.  Measure the amount of data
+ *   the application consumed during one RTT, and make the receive buffer
+ *   large enough to hold twice that amount so that the peer is never
+ *   limited by the advertised window.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   copied - Number of bytes just consumed by the application
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_RECV_BUFSIZE > 0
+void tcp_rcvbuf_adjust(FAR struct tcp_conn_s *conn, size_t copied)
+{
+  clock_t period;
+  clock_t now;
+  int32_t bufs;
+
+  if ((conn->flags & TCP_RCVBUF_LOCK) != 0)
+    {
+      return;
+    }
+
+  now = clock_systime_ticks();
+  if (conn->rcv_stime == 0)
+    {
+      conn->rcv_stime = now;
+    }
+
+  conn->rcv_space += copied;
+
+  period = (conn->sa >> 3) * TICK_PER_HSEC;
+  if (period < TCP_AUTOTUNE_MINPERIOD)
+    {
+      period = TCP_AUTOTUNE_MINPERIOD;
+    }
+
+  if (now - conn->rcv_stime < period)
+    {
+      return;
+    }
+
+  bufs = tcp_autotune_grow(conn->rcv_bufs, 2 * conn->rcv_space,
+                           TCP_AUTOTUNE_MAXRCVBUF);
+  if (bufs != conn->rcv_bufs)
+    {
+      ninfo("rcv_bufs %" PRId32 " -> %" PRId32 "\n", conn->rcv_bufs, bufs);
+      conn->rcv_bufs = bufs;
+    }
+
+  conn->rcv_space = 0;
+  conn->rcv_stime = now;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_sndbuf_adjust
+ *
+ * Description:
+ *   Grow the send buffer to twice the amount of data that may be in flight,
+ *   i.e. the peer receive window (and the congestion window if congestion
+ *   control is enabled), so that the sender always has a full window of
+ *   data queued.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+void tcp_sndbuf_adjust(FAR struct tcp_conn_s *conn)
+{
+  uint32_t window = conn->snd_wnd;
+  int32_t bufs;
+
+  if ((conn->flags & TCP_SNDBUF_LOCK) != 0)
+    {
+      return;
+    }
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  if (conn->cwnd > 0 && conn->cwnd < window)
+    {
+      window = conn->cwnd;
+    }
+#endif
+
+  bufs = tcp_autotune_grow(conn->snd_bufs, 2 * window,
+                           TCP_AUTOTUNE_MAXSNDBUF);
+  if (bufs != conn->snd_bufs)
+    {
+      ninfo("snd_bufs %" PRId32 " -> %" PRId32 "\n", conn->snd_bufs, bufs);
+      conn->snd_bufs = bufs;
+    }
+}
+#endif
+
+#endif /* CONFIG_NET_TCP_BUFSIZE_AUTOTUNE */
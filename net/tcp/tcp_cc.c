@@ -24,7 +24,10 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+
 #include <debug.h>
+#include <string.h>
 
 #include "tcp/tcp.h"
 
@@ -74,10 +77,75 @@
     } \
  } while(0)
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                               uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",          /* name */
+  NULL,               /* init */
+  newreno_ssthresh,   /* ssthresh */
+  newreno_cong_avoid  /* cong_avoid */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_ops[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: newreno_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd linearly by approximately maxseg per RTT (RFC 5681).
+ *
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  /* Use maxseg^2 / cwnd per ACK as the increment.  If cwnd > maxseg^2,
+   * fix the cwnd increment at 1 byte to avoid capping cwnd.
+   */
+
+  uint32_t increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+  CC_CWND_INC(conn->cwnd, increase);
+  conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -103,6 +171,22 @@
 
 void tcp_cc_init(FAR struct tcp_conn_s *conn)
 {
+  /* Keep the algorithm set by TCP_CONGESTION before the connection */
+
+  if (conn->cc_ops == NULL)
+    {
+      conn->cc_ops = tcp_cc_lookup(CONFIG_NET_TCP_CC_DEFAULT);
+      if (conn->cc_ops == NULL)
+        {
+          conn->cc_ops = &g_tcp_cc_newreno;
+        }
+    }
+
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
+
   CC_INIT_CWND(conn->cwnd, conn->mss);
 
   /* RFC 5681 recommends setting ssthresh arbitrarily high and
@@ -140,15 +224,14 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+  /* After Fast retransmitted, let the algorithm reduce ssthresh and
+   * enter to Fast Recovery.
    * cwnd=ssthresh + 3*SMSS  referring to rfc5681
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc_ops->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -284,19 +367,77 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
           else
             {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+              /* cong avoid, the growth is up to the algorithm */
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
-
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+              conn->cc_ops->cong_avoid(conn, acked);
               ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
             }
         }
     }
 }
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expired, the connection restarts from the slow start.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
+
+  if (conn->flags & TCP_INFR)
+    {
+      conn->flags &= ~TCP_INFR;
+    }
+
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = conn->cc_ops->ssthresh(conn);
+  conn->cwnd = conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_lookup
+ *
+ * Description:
+ *   Find the congestion control algorithm by its name.
+ *
+ * Input Parameters:
+ *   name   - The name of the algorithm, as used by TCP_CONGESTION
+ *
+ * Returned Value:
+ *   The algorithm, or NULL if there is no algorithm with this name.
+ *
+ ****************************************************************************/
+
+FAR const struct tcp_cc_ops_s *tcp_cc_lookup(FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < nitems(g_tcp_cc_ops); i++)
+    {
+      if (strcmp(g_tcp_cc_ops[i]->name, name) == 0)
+        {
+          return g_tcp_cc_ops[i];
+        }
+    }
+
+  return NULL;
+}
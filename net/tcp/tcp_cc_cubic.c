@@ -0,0 +1,239 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The multiplicative decrease factor, 0.7 scaled by CUBIC_SCALE */
+
+#define CUBIC_SCALE       1024
+#define CUBIC_BETA        717
+
+/* The additive increase of Reno with the same average window,
+ * 3 * (1 - beta) / (1 + beta) segments per RTT, scaled by CUBIC_SCALE.
+ */
+
+#define CUBIC_ALPHA       542
+
+/* C = 0.4 segments / s^3.  With the time in ms, the K of RFC 9438 is
+ * cbrt(W_max - cwnd) * cbrt(1e9 / C) and the growth of the window is
+ * C * t^3 / 1e9.
+ */
+
+#define CUBIC_K_FACTOR    2500000000ull
+#define CUBIC_C_NUM       4
+#define CUBIC_C_DEN       10000000ull
+
+/* Limit the distance from the plateau, (2^17)^3 / 1000 * UINT16_MAX * 4
+ * still fits in 64 bits.
+ */
+
+#define CUBIC_MAX_DELTA   131072
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",            /* name */
+  cubic_init,         /* init */
+  cubic_ssthresh,     /* ssthresh */
+  cubic_cong_avoid    /* cong_avoid */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Return the integer cube root of a 64-bit value, bit by bit.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y += y;
+      b  = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cubic, 0, sizeof(conn->cubic));
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the loss as the plateau of the next epoch and
+ *   reduce it by beta, RFC 9438 section 4.6 and 4.7.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+
+  /* Fast convergence, release the bandwidth to the new flows when the
+   * plateau keeps going down.
+   */
+
+  if (conn->cwnd < cubic->w_max)
+    {
+      cubic->w_max = (uint32_t)((uint64_t)conn->cwnd *
+                                (CUBIC_SCALE + CUBIC_BETA) /
+                                (2 * CUBIC_SCALE));
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  cubic->epoch = 0;
+
+  return MAX((uint32_t)((uint64_t)conn->cwnd * CUBIC_BETA / CUBIC_SCALE),
+             2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd towards the cubic function of the time since the start of
+ *   the congestion avoidance, or towards the Reno estimate if it is
+ *   larger, RFC 9438 section 4.2 to 4.5.
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+  clock_t now = clock_systime_ticks();
+  uint64_t offset;
+  uint64_t target;
+  uint64_t inc;
+  int64_t delta;
+  uint32_t cap;
+
+  if (cubic->epoch == 0)
+    {
+      cubic->epoch = now;
+      cubic->w_est = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          cubic->k      = cubic_root((uint64_t)(cubic->w_max - conn->cwnd) *
+                                     CUBIC_K_FACTOR / conn->mss);
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+    }
+
+  /* W_cubic(t) = C * (t - K)^3 + W_max */
+
+  delta  = (int64_t)TICK2MSEC(now - cubic->epoch) - cubic->k;
+  delta  = MIN(MAX(delta, -CUBIC_MAX_DELTA), CUBIC_MAX_DELTA);
+  offset = (uint64_t)(delta < 0 ? -delta : delta);
+  offset = offset * offset * offset / 1000 * CUBIC_C_NUM * conn->mss /
+           CUBIC_C_DEN;
+
+  if (delta < 0)
+    {
+      target = offset < cubic->origin ? cubic->origin - offset : 0;
+    }
+  else
+    {
+      target = cubic->origin + offset;
+    }
+
+  /* The Reno friendly region */
+
+  cubic->w_est += (uint64_t)acked * conn->mss * CUBIC_ALPHA /
+                  CUBIC_SCALE / conn->cwnd;
+  target = MAX(target, cubic->w_est);
+
+  /* Approach the target in one RTT, but no more than 1.5 * cwnd */
+
+  target = MIN(target, conn->cwnd + conn->cwnd / 2);
+  if (target > conn->cwnd)
+    {
+      inc = (target - conn->cwnd) * acked / conn->cwnd;
+    }
+  else
+    {
+      inc = (uint64_t)acked * conn->mss / (100 * (uint64_t)conn->cwnd);
+    }
+
+  /* Growing the window beyond what the peer accepts doesn't help */
+
+  cap = MAX(conn->max_cwnd, conn->snd_wnd);
+  conn->cwnd = (uint32_t)MIN(conn->cwnd + MAX(inc, 1), cap);
+}
@@ -95,6 +95,13 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The connected TCP connections hashed by the remote address and the ports.
+ * The local address isn't part of the key since it may be still unspecified
+ * when the connection becomes active.
+ */
+
+static DECLARE_HASHTABLE(g_active_tcp_hashtable, CONFIG_NET_TCP_HASH_BITS);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -150,6 +157,86 @@ static FAR struct tcp_conn_s *
 #endif
 }
 
+/****************************************************************************
+ * Name: tcp_ipv4_key
+ *
+ * Description:
+ *   Create the hash key of an IPv4 connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_key(in_addr_t raddr, uint16_t lport,
+                                    uint16_t rport)
+{
+  return NTOHL(raddr) ^ ((uint32_t)lport << 16) ^ rport;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_ipv6_key
+ *
+ * Description:
+ *   Create the hash key of an IPv6 connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_key(FAR const uint16_t *raddr,
+                                    uint16_t lport, uint16_t rport)
+{
+  uint32_t key = ((uint32_t)lport << 16) ^ rport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  return key;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_key
+ *
+ * Description:
+ *   Create the hash key of a connection in the active hashtable.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_key(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_ipv4_key(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  return tcp_ipv6_key(conn->u.ipv6.raddr, conn->lport, conn->rport);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_addconn
+ *
+ * Description:
+ *   Add the connection to the list and the hashtable of active TCP
+ *   connections.  The tcp conn list must be locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addconn(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  hashtable_add(g_active_tcp_hashtable, &conn->hactive,
+                tcp_conn_key(conn));
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_active
  *
@@ -168,15 +255,19 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *p;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
-  while (conn)
+  hashtable_for_every_possible(g_active_tcp_hashtable, p,
+                               tcp_ipv4_key(srcipaddr, tcp->destport,
+                                            tcp->srcport))
     {
+      conn = container_of(p, struct tcp_conn_s, hactive);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -201,19 +292,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -235,15 +320,19 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *p;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
-  while (conn)
+  hashtable_for_every_possible(g_active_tcp_hashtable, p,
+                               tcp_ipv6_key(ip->srcipaddr, tcp->destport,
+                                            tcp->srcport))
     {
+      conn = container_of(p, struct tcp_conn_s, hactive);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -268,19 +357,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -306,6 +389,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
   int port;
   int ret;
   FAR struct net_driver_s *dev;
+  int epoch;
 
   /* Verify or select a local port and address */
 
@@ -321,7 +405,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
     {
       ret = -EADDRNOTAVAIL;
 
-      netdev_list_lock();
+      epoch = netdev_list_read_lock();
       for (dev = g_netdevices; dev; dev = dev->flink)
         {
           if (net_ipv4addr_cmp(addr->sin_addr.s_addr, dev->d_ipaddr))
@@ -331,7 +415,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
             }
         }
 
-      netdev_list_unlock();
+      netdev_list_read_unlock(epoch);
 
       if (ret == -EADDRNOTAVAIL)
         {
@@ -398,6 +482,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
   int port;
   int ret;
   FAR struct net_driver_s *dev;
+  int epoch;
 
   /* Verify or select a local port and address */
 
@@ -416,7 +501,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
     {
       ret = -EADDRNOTAVAIL;
 
-      netdev_list_lock();
+      epoch = netdev_list_read_lock();
       for (dev = g_netdevices; dev; dev = dev->flink)
         {
           if (NETDEV_IS_MY_V6ADDR(dev, addr->sin6_addr.in6_u.u6_addr16))
@@ -426,7 +511,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
             }
         }
 
-      netdev_list_unlock();
+      netdev_list_read_unlock(epoch);
       if (ret == -EADDRNOTAVAIL)
         {
           return ret;
@@ -812,7 +897,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       tcp_conn_list_lock();
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_removeconn(conn);
       tcp_conn_list_unlock();
     }
 
@@ -1130,8 +1215,15 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
       conn->snd_bufs         = listener->snd_bufs;
+#endif
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTOTUNE
+      conn->flags           |= listener->flags &
+                               (TCP_RCVBUF_LOCK | TCP_SNDBUF_LOCK);
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_ops           = listener->cc_ops;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
@@ -1181,7 +1273,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       tcp_conn_list_lock();
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addconn(conn);
       tcp_conn_list_unlock();
 
       tcp_update_retrantimer(conn, TCP_RTO);
@@ -1490,7 +1582,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   tcp_conn_list_lock();
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addconn(conn);
   tcp_conn_list_unlock();
 
   return OK;
@@ -1536,6 +1628,8 @@ void tcp_conn_list_unlock(void)
 void tcp_removeconn(FAR struct tcp_conn_s *conn)
 {
   dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+  hashtable_delete(g_active_tcp_hashtable, &conn->hactive,
+                   tcp_conn_key(conn));
 }
 
 /****************************************************************************
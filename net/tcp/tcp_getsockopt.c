@@ -26,8 +26,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -240,6 +242,32 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          FAR const struct tcp_cc_ops_s *ops = conn->cc_ops;
+
+          if (ops == NULL)
+            {
+              ops = tcp_cc_lookup(CONFIG_NET_TCP_CC_DEFAULT);
+            }
+
+          if (ops == NULL || *value_len == 0)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              /* Truncate the name to the buffer like Linux */
+
+              *value_len = MIN(*value_len, strlen(ops->name) + 1);
+              strlcpy(value, ops->name, *value_len);
+              ret        = OK;
+            }
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
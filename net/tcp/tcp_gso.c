@@ -0,0 +1,298 @@
+/****************************************************************************
+ * net/tcp/tcp_gso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_GSO)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_iphdrlen
+ *
+ * Description:
+ *   Return the size of the IP header in front of the TCP header.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_gso_iphdrlen(FAR const uint8_t *ip)
+{
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 4)
+#  endif
+    {
+      return (ip[0] & IPv4_HLMASK) << 2;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  return IPv6_HDRLEN;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_gso_alloc
+ *
+ * Description:
+ *   Allocate one segment and copy the headers and 'len' bytes of the
+ *   payload at 'offset' of the large packet into it.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *tcp_gso_alloc(FAR struct iob_s *pkt,
+                                       uint16_t hdrlen, unsigned int offset,
+                                       unsigned int len)
+{
+  FAR struct iob_s *seg;
+
+  seg = iob_tryalloc(false);
+  if (seg == NULL)
+    {
+      return NULL;
+    }
+
+  iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+
+  if (iob_clone_partial(pkt, len, hdrlen + offset, seg, hdrlen,
+                        false, false) != OK ||
+      iob_trycopyin(seg, IOB_DATA(pkt), hdrlen, 0, false) != hdrlen)
+    {
+      iob_free_chain(seg);
+      return NULL;
+    }
+
+  return seg;
+}
+
+/****************************************************************************
+ * Name: tcp_gso_header
+ *
+ * Description:
+ *   Fix up the IP and TCP headers copied from the large packet for the
+ *   segment 'index' starting at sequence number 'seqno'.
+ *
+ ****************************************************************************/
+
+static void tcp_gso_header(FAR struct net_driver_s *dev,
+                           FAR struct iob_s *seg, uint16_t iphdrlen,
+                           uint16_t index, uint32_t seqno, uint8_t flags)
+{
+  FAR uint8_t *ip = IOB_DATA(seg);
+  FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)(ip + iphdrlen);
+  uint16_t upperlen = seg->io_pktlen - iphdrlen;
+  uint16_t sum;
+
+  tcp_setsequence(tcp->seqno, seqno);
+  tcp->flags     = flags;
+  tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      ipv6->len[0] = upperlen >> 8;
+      ipv6->len[1] = upperlen & 0xff;
+
+      sum = chksum(upperlen + IP_PROTO_TCP,
+                   (FAR const uint8_t *)ipv6->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+    }
+#endif
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+      uint16_t ipid = ((uint16_t)ipv4->ipid[0] << 8) + ipv4->ipid[1];
+
+      /* The segments take the IP identifications following the one of the
+       * large packet, TCP sets DF so they don't need to be unique.
+       */
+
+      ipid += index;
+      ipv4->len[0]   = seg->io_pktlen >> 8;
+      ipv4->len[1]   = seg->io_pktlen & 0xff;
+      ipv4->ipid[0]  = ipid >> 8;
+      ipv4->ipid[1]  = ipid & 0xff;
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+
+      sum = chksum(upperlen + IP_PROTO_TCP,
+                   (FAR const uint8_t *)ipv4->srcipaddr,
+                   2 * sizeof(in_addr_t));
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  if ((dev->d_features & NETDEV_TX_CSUM) != 0)
+    {
+      /* Leave the pseudo header sum to the hardware to complete */
+
+      tcp->tcpchksum = HTONS(sum);
+    }
+  else
+    {
+      sum = chksum_iob(sum, seg, iphdrlen);
+      tcp->tcpchksum = ~((sum == 0) ? 0xffff : HTONS(sum));
+    }
+#else
+  UNUSED(sum);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_poll
+ *
+ * Description:
+ *   Cut the large TCP packet in dev->d_iob into segments of d_gsosize
+ *   bytes of payload and hand them to the driver one after another.  The
+ *   large packet is released when done.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the large packet
+ *   callback - The actual sending API provided by the driver
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   The network is locked and the L2 header has been built.
+ *
+ ****************************************************************************/
+
+int tcp_gso_poll(FAR struct net_driver_s *dev,
+                 devif_poll_callback_t callback)
+{
+  FAR struct iob_s *pkt = dev->d_iob;
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *seg;
+  unsigned int payload;
+  unsigned int offset;
+  unsigned int len;
+  uint16_t iphdrlen;
+  uint16_t hdrlen;
+  uint16_t index;
+  uint32_t seqno;
+  uint8_t flags;
+  int bstop = false;
+
+  /* tcp_send() built all of the headers in the first buffer */
+
+  iphdrlen = tcp_gso_iphdrlen(IOB_DATA(pkt));
+  tcp      = (FAR struct tcp_hdr_s *)(IOB_DATA(pkt) + iphdrlen);
+  hdrlen   = iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  seqno    = tcp_getsequence(tcp->seqno);
+  flags    = tcp->flags;
+  payload  = pkt->io_pktlen - hdrlen;
+
+  DEBUGASSERT(pkt->io_len >= hdrlen && dev->d_gsosize > 0);
+
+  /* Each segment replaces the large packet in the device in turn */
+
+  netdev_iob_clear(dev);
+
+  for (offset = 0, index = 0; offset < payload && !bstop;
+       offset += len, index++)
+    {
+      len = MIN(payload - offset, dev->d_gsosize);
+      seg = tcp_gso_alloc(pkt, hdrlen, offset, len);
+      if (seg == NULL)
+        {
+          /* The rest is left to the retransmission */
+
+          nerr("ERROR: Failed to allocate the TCP segment\n");
+          bstop = true;
+          break;
+        }
+
+      /* Only the last segment carries PSH and FIN */
+
+      tcp_gso_header(dev, seg, iphdrlen, index, seqno + offset,
+                     offset + len < payload ?
+                     flags & ~(TCP_PSH | TCP_FIN) : flags);
+
+      netdev_iob_replace(dev, seg);
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      dev->d_txcsum = (dev->d_features & NETDEV_TX_CSUM) != 0;
+#endif
+
+      /* Build L2 headers */
+
+      devif_out(dev);
+
+      /* Call back into the driver */
+
+      if (dev->d_len > 0)
+        {
+          bstop = callback(dev);
+        }
+    }
+
+  iob_free_chain(pkt);
+
+#ifdef CONFIG_NET_STATISTICS
+  if (index > 1)
+    {
+      g_netstats.tcp.sent += index - 1;
+    }
+#endif
+
+  /* Reuse iob buffer */
+
+  if (!bstop)
+    {
+      iob_update_pktlen(dev->d_iob, 0, false);
+      netdev_iob_prepare(dev, true, 0);
+    }
+
+  return bstop;
+}
+
+#endif /* NET_TCP_HAVE_STACK && CONFIG_NET_TCP_GSO */
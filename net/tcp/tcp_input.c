@@ -693,6 +693,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
                       unsigned int iplen)
 {
   FAR struct tcp_conn_s *conn = NULL;
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+  FAR struct tcp_conn_s *listener;
+#endif
   FAR struct tcp_hdr_s *tcp;
   union ip_binding_u uaddr;
   unsigned int tcpiplen;
@@ -923,6 +926,23 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
       if ((tcp->flags & TCP_CTL) != TCP_SYN)
         {
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+          /* Is this the ACK returning a SYN cookie? */
+
+          if ((tcp->flags & (TCP_SYN | TCP_RST | TCP_ACK)) == TCP_ACK &&
+              tcp_backlogavailable(conn))
+            {
+              FAR struct tcp_conn_s *newconn;
+
+              newconn = tcp_syncookie_accept(dev, tcp, conn);
+              if (newconn != NULL)
+                {
+                  conn = newconn;
+                  goto found;
+                }
+            }
+#endif
+
           if ((tcp->flags & TCP_ACK) != 0)
             {
               goto reset;
@@ -946,6 +966,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
        * any user application to accept it.
        */
 
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+      listener = conn;
+#endif
       conn = tcp_alloc_accept(dev, tcp, conn);
       if (conn)
         {
@@ -973,6 +996,14 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
       if (!conn)
         {
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+          /* Answer with a SYN cookie, the connection is allocated when the
+           * ACK returns it.
+           */
+
+          tcp_syncookie_synack(dev, tcp, listener, iplen);
+          return;
+#else
           /* Either (1) all available connections are in use, or (2)
            * there is no application in place to accept the connection.
            * We drop packet and hope that the remote end will retransmit
@@ -985,6 +1016,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #endif
           nerr("ERROR: No free TCP connections\n");
           goto drop;
+#endif
         }
 
       net_incr32(conn->rcvseq, 1); /* ack SYN */
@@ -61,9 +61,10 @@
  * Private Data
  ****************************************************************************/
 
-/* The tcp_listenports list all currently listening ports. */
+/* All of the currently listening connections hashed by the local port */
 
-static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+static DECLARE_HASHTABLE(g_tcp_listeners, CONFIG_NET_TCP_HASH_BITS);
+static int g_tcp_nlisteners;
 
 /****************************************************************************
  * Private Functions
@@ -89,18 +90,17 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
-  int ndx;
+  FAR hash_node_t *p;
 
-  /* Examine each connection structure in each slot of the listener list */
+  /* Examine each listener hashed to the same bucket as this port */
 
   tcp_conn_list_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  hashtable_for_every_possible(g_tcp_listeners, p, portno)
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
+      /* Does the connection have the same local port number? */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+      FAR struct tcp_conn_s *conn =
+        container_of(p, struct tcp_conn_s, hlisten);
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (tcp_conn_cmp(domain, (FAR const union ip_addr_u *)uaddr, portno,
                        conn))
@@ -136,15 +136,16 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR hash_node_t *p;
   int ret = -EINVAL;
 
   tcp_conn_list_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  hashtable_for_every_possible(g_tcp_listeners, p, conn->lport)
     {
-      if (tcp_listenports[ndx] == conn)
+      if (p == &conn->hlisten)
         {
-          tcp_listenports[ndx] = NULL;
+          hashtable_delete(g_tcp_listeners, p, conn->lport);
+          g_tcp_nlisteners--;
           tcp_remove_syn_backlog(conn);
           ret = OK;
           break;
@@ -168,7 +169,6 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -191,26 +191,19 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
     }
   else
     {
-      /* Otherwise, save a reference to the connection structure in the
-       * "listener" list.
+      /* Otherwise, add the connection structure to the "listener"
+       * hashtable if the limit of the listening ports isn't reached.
        */
 
-      ret = -ENOBUFS; /* Assume failure */
-
-      /* Search all slots until an available slot is found */
-
-      for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
         {
-          /* Is the next slot available? */
-
-          if (!tcp_listenports[ndx])
-            {
-              /* Yes.. we found it */
-
-              tcp_listenports[ndx] = conn;
-              ret = OK;
-              break;
-            }
+          hashtable_add(g_tcp_listeners, &conn->hlisten, conn->lport);
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOBUFS;
         }
     }
 
@@ -32,6 +32,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/tls.h>
 #include <nuttx/net/net.h>
@@ -905,6 +906,11 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
         }
     }
 
+  if (nrecv > 0 && (flags & MSG_PEEK) == 0)
+    {
+      tcp_rcvbuf_adjust(conn, nrecv);
+    }
+
   conn_dev_unlock(&conn->sconn, conn->dev);
   return nrecv ? nrecv : ret;
 }
@@ -149,7 +149,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      if (work_available(&conn->work) && conn->tx_unacked != 0)
+      if (tcp_timer_available(conn) && conn->tx_unacked != 0)
         {
           conn->timeout = false;
           tcp_update_retrantimer(conn, conn->rto);
@@ -200,7 +200,16 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (NETDEV_IS_GSO(dev) || (dev->d_features & NETDEV_TX_CSUM) != 0)
+        {
+          /* Leave the pseudo header sum to the segmentation or the
+           * hardware to complete.
+           */
+
+          tcp->tcpchksum = netdev_upperlayer_header_checksum(dev);
+          dev->d_txcsum  = true;
+        }
+      else
         {
           tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
         }
@@ -227,7 +236,16 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (NETDEV_IS_GSO(dev) || (dev->d_features & NETDEV_TX_CSUM) != 0)
+        {
+          /* Leave the pseudo header sum to the segmentation or the
+           * hardware to complete.
+           */
+
+          tcp->tcpchksum = netdev_upperlayer_header_checksum(dev);
+          dev->d_txcsum  = true;
+        }
+      else
         {
           tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
         }
@@ -364,6 +382,110 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 #endif
 }
 
+/****************************************************************************
+ * Name: tcp_reflect
+ *
+ * Description:
+ *   Turn the received TCP segment in the device buffer into a reply to its
+ *   sender: swap the ports and addresses, then build the IP header and the
+ *   checksum.  The caller has already set up the sequence numbers, flags,
+ *   window and options, and the packet length in dev->d_len.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure holding the segment
+ *   conn - The TCP connection structure, used for TTL and TOS, may be NULL
+ *   tcp  - The TCP header of the segment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_reflect(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_hdr_s *tcp)
+{
+  uint16_t tmp16;
+
+  /* Swap port numbers. */
+
+  tmp16         = tcp->srcport;
+  tcp->srcport  = tcp->destport;
+  tcp->destport = tmp16;
+
+  /* Initialize the rest of the tcp header to sane values.
+   */
+
+  tcp->urgp[0] = 0;
+  tcp->urgp[1] = 0;
+
+  /* Update device buffer length before setup the IP header */
+
+  iob_update_pktlen(dev->d_iob, dev->d_len, false);
+
+  /* Calculate chk & build L3 header */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      ipv6_build_header(ipv6, dev->d_len - IPv6_HDRLEN,
+                        IP_PROTO_TCP,
+                        netdev_ipv6_srcaddr(dev, ipv6->destipaddr),
+                        ipv6->srcipaddr,
+                        conn ? conn->sconn.s_ttl : IP_TTL_DEFAULT,
+                        conn ? conn->sconn.s_tos : 0);
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if ((dev->d_features & NETDEV_TX_CSUM) != 0)
+        {
+          tcp->tcpchksum = netdev_upperlayer_header_checksum(dev);
+          dev->d_txcsum  = true;
+        }
+      else
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      ipv4_build_header(IPv4BUF, dev->d_len, IP_PROTO_TCP,
+                        &dev->d_ipaddr, (FAR in_addr_t *)ipv4->srcipaddr,
+                        conn ? conn->sconn.s_ttl : IP_TTL_DEFAULT,
+                        conn ? conn->sconn.s_tos : 0, NULL);
+
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if ((dev->d_features & NETDEV_TX_CSUM) != 0)
+        {
+          tcp->tcpchksum = netdev_upperlayer_header_checksum(dev);
+          dev->d_txcsum  = true;
+        }
+      else
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
 /****************************************************************************
  * Name: tcp_reset
  *
@@ -384,7 +506,6 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 {
   FAR struct tcp_hdr_s *tcp;
-  uint16_t tmp16;
   uint16_t acklen = 0;
   uint8_t seqbyte;
 
@@ -477,47 +598,53 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp_setsequence(tcp->ackno, ackno);
     }
 
-  /* Swap port numbers. */
-
-  tmp16         = tcp->srcport;
-  tcp->srcport  = tcp->destport;
-  tcp->destport = tmp16;
-
-  /* Initialize the rest of the tcp header to sane values.
-   */
-
   tcp->wnd[0] = 0;
   tcp->wnd[1] = 0;
-  tcp->urgp[0] = 0;
-  tcp->urgp[0] = 0;
 
-  /* Update device buffer length before setup the IP header */
+  tcp_reflect(dev, conn, tcp);
+}
 
-  iob_update_pktlen(dev->d_iob, dev->d_len, false);
+/****************************************************************************
+ * Name: tcp_synack_stateless
+ *
+ * Description:
+ *   Reply to the SYN segment in the device buffer with a SYN-ACK without a
+ *   connection structure, used to send SYN cookies.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the SYN segment
+ *   listener - The listening connection, used for TTL and TOS
+ *   isn      - The initial sequence number to send
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
 
-  /* Calculate chk & build L3 header */
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_synack_stateless(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *listener, uint32_t isn)
+{
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t tcp_mss;
+  uint32_t ackno;
+
+  if (dev->d_iob == NULL)
+    {
+      return;
+    }
+
+  tcp = tcp_header(dev);
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
 #endif
     {
-      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
-
-      ipv6_build_header(ipv6, dev->d_len - IPv6_HDRLEN,
-                        IP_PROTO_TCP,
-                        netdev_ipv6_srcaddr(dev, ipv6->destipaddr),
-                        ipv6->srcipaddr,
-                        conn ? conn->sconn.s_ttl : IP_TTL_DEFAULT,
-                        conn ? conn->sconn.s_tos : 0);
-      tcp->tcpchksum = 0;
-
-#ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
-        {
-          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
-        }
-#endif
+      dev->d_len = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -526,24 +653,39 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
   else
 #endif
     {
-      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+      dev->d_len = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+    }
+#endif /* CONFIG_NET_IPv4 */
 
-      ipv4_build_header(IPv4BUF, dev->d_len, IP_PROTO_TCP,
-                        &dev->d_ipaddr, (FAR in_addr_t *)ipv4->srcipaddr,
-                        conn ? conn->sconn.s_ttl : IP_TTL_DEFAULT,
-                        conn ? conn->sconn.s_tos : 0, NULL);
+  /* Acknowledge the SYN and send our sequence number */
 
-      tcp->tcpchksum = 0;
+  ackno = tcp_getsequence(tcp->seqno) + 1;
+  tcp_setsequence(tcp->ackno, ackno);
+  tcp_setsequence(tcp->seqno, isn);
 
-#ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
-        {
-          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
-        }
-#endif
-    }
-#endif /* CONFIG_NET_IPv4 */
+  tcp->flags     = TCP_SYN | TCP_ACK;
+  tcp->tcpoffset = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+
+  /* Only the MSS option is sent, the other options need the state that
+   * the cookie can not carry.
+   */
+
+  tcp_mss         = tcp_rx_mss(dev);
+  tcp->optdata[0] = TCP_OPT_MSS;
+  tcp->optdata[1] = TCP_OPT_MSS_LEN;
+  tcp->optdata[2] = tcp_mss >> 8;
+  tcp->optdata[3] = tcp_mss & 0xff;
+
+  /* Advertise one segment, the window is opened by the first ACK of the
+   * connection created from the cookie.
+   */
+
+  tcp->wnd[0]     = tcp_mss >> 8;
+  tcp->wnd[1]     = tcp_mss & 0xff;
+
+  tcp_reflect(dev, listener, tcp);
 }
+#endif
 
 /****************************************************************************
  * Name: tcp_rx_mss
@@ -411,6 +411,181 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+/****************************************************************************
+ * Name: rack_update
+ *
+ * Description:
+ *   Remember the send time of the most recently sent segment which has
+ *   been delivered and the RTT measured with it, RFC 8985 section 6.2.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The segment newly ACKed or SACKed
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RACK
+static void rack_update(FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_wrbuffer_s *wrb)
+{
+  /* The ACK of a retransmitted segment may be for the original one, it
+   * can't tell the RTT.
+   */
+
+  if (TCP_WBNRTX(wrb) > 0)
+    {
+      return;
+    }
+
+  if ((sclock_t)(TCP_WBXMIT(wrb) - conn->rack_xmit) >= 0)
+    {
+      conn->rack_xmit = TCP_WBXMIT(wrb);
+      conn->rack_rtt  = clock_systime_ticks() - TCP_WBXMIT(wrb);
+    }
+}
+
+/****************************************************************************
+ * Name: rack_detect_loss
+ *
+ * Description:
+ *   Move the segments sent before the most recently delivered one, and
+ *   not delivered themselves for an RTT plus the reordering window, back
+ *   to the write_q to be retransmitted, RFC 8985 section 6.2.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   True if any segment was found lost.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static bool rack_detect_loss(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  clock_t now = clock_systime_ticks();
+  clock_t timeout;
+  bool lost = false;
+
+  /* A quarter of the RTT for the reordering, one more tick for the
+   * granularity of the clock.
+   */
+
+  timeout = conn->rack_rtt + conn->rack_rtt / 4 + 1;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+    {
+      wrb  = (FAR struct tcp_wrbuffer_s *)entry;
+      next = sq_next(entry);
+
+      if (TCP_WBSACKED(wrb) ||
+          (sclock_t)(conn->rack_xmit - TCP_WBXMIT(wrb)) <= 0 ||
+          now - TCP_WBXMIT(wrb) < timeout)
+        {
+          continue;
+        }
+
+      ninfo("RACK: lost wrb=%p seqno=%" PRIu32 " pktlen=%u\n",
+            wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb));
+
+      sq_rem(entry, &conn->unacked_q);
+      retransmit_segment(conn, wrb);
+      lost = true;
+    }
+
+  return lost;
+}
+#endif /* CONFIG_NET_TCP_RACK */
+
+/****************************************************************************
+ * Name: sack_update
+ *
+ * Description:
+ *   Mark the segments of the unacked_q covered by the SACK blocks of an
+ *   incoming ACK in the scoreboard, they are not retransmitted again.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   segs   - Segments edge of sacks
+ *   nsacks - Number of sacks
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+static void sack_update(FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_ofoseg_s *segs, int nsacks)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  uint32_t lastseq;
+  int i;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if (TCP_WBSACKED(wrb))
+        {
+          continue;
+        }
+
+      lastseq = TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb);
+      for (i = 0; i < nsacks; i++)
+        {
+          if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), segs[i].left) &&
+              TCP_SEQ_LTE(lastseq, segs[i].right))
+            {
+              TCP_WBSACKED(wrb) = true;
+#ifdef CONFIG_NET_TCP_RACK
+              rack_update(conn, wrb);
+#endif
+              break;
+            }
+        }
+    }
+}
+#endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
+
+/****************************************************************************
+ * Name: tcp_max_sndlen
+ *
+ * Description:
+ *   Return the largest amount of data that can be sent in one packet.  This
+ *   is the MSS unless the device takes large TCP packets, which are then
+ *   segmented by the hardware or just before the driver.  Only the poll
+ *   path qualifies, the packets built while processing the input are sent
+ *   by the drivers directly without going through devif_poll_out().
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_max_sndlen(FAR struct net_driver_s *dev,
+                               FAR struct tcp_conn_s *conn, uint32_t flags)
+{
+#ifdef CONFIG_NET_TCP_GSO
+  if ((flags & TCP_POLL) != 0 &&
+      (dev->d_features & (NETDEV_TX_TSO | NETDEV_TX_GSO)) != 0 &&
+      conn->mss < CONFIG_NET_TCP_GSO_MAXSIZE)
+    {
+      /* Whole segments only, so that only the last one may be short */
+
+      return CONFIG_NET_TCP_GSO_MAXSIZE -
+             CONFIG_NET_TCP_GSO_MAXSIZE % conn->mss;
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -542,6 +717,13 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 {
                   ninfo("ACK: wrb=%p Freeing write buffer\n", wrb);
 
+#ifdef CONFIG_NET_TCP_RACK
+                  if (!TCP_WBSACKED(wrb))
+                    {
+                      rack_update(conn, wrb);
+                    }
+#endif
+
                   /* Yes... Remove the write buffer from ACK waiting queue */
 
                   sq_rem(entry, &conn->unacked_q);
@@ -700,6 +882,35 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%" PRIu32 " pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* Record the SACK blocks of every ACK in the scoreboard */
+
+      if ((conn->flags & TCP_SACK) && (tcp->tcpoffset & 0xf0) > 0x50)
+        {
+          sack_update(conn, ofosegs, parse_sack(conn, tcp, ofosegs));
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+      /* Retransmit the segments which are lost by the send time, without
+       * waiting for the duplicate ACKs.
+       */
+
+      if (rack_detect_loss(conn))
+        {
+#  ifdef CONFIG_NET_TCP_CC_NEWRENO
+          /* Enter the Fast Recovery for the first loss of the window */
+
+          if ((conn->flags & (TCP_INFR | TCP_INFT)) == 0)
+            {
+              conn->flags     |= TCP_INFT;
+              conn->fr_recover = conn->sndseq_max;
+              tcp_cc_update(conn, NULL);
+            }
+#  endif
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -797,6 +1008,10 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               return flags;
             }
 
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMIT(wrb) = clock_systime_ticks();
+#endif
+
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
           /* After Fast retransmitted, set ssthresh to the maximum of
            * the unacked and the 2*SMSS, and enter to Fast Recovery.
@@ -852,7 +1067,8 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             {
               /* Wrb seqno out of s-ack edge ? do retransmit ! */
 
-              if (TCP_SEQ_LT(TCP_WBSEQNO(wrb), ofosegs[i].left) &&
+              if (!TCP_WBSACKED(wrb) &&
+                  TCP_SEQ_LT(TCP_WBSEQNO(wrb), ofosegs[i].left) &&
                   TCP_SEQ_GTE(TCP_WBSEQNO(wrb), right))
                 {
                   ninfo("TCP REXMIT "
@@ -891,6 +1107,9 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
     {
       FAR struct tcp_wrbuffer_s *wrb;
       FAR sq_entry_t *entry;
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      FAR sq_entry_t *next;
+#endif
 
       ninfo("REXMIT: %" PRIx32 "\n", flags);
 
@@ -976,6 +1195,36 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
         }
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* The segment at the cumulative ACK can't be SACKed unless the
+       * receiver has discarded the SACKed data, forget the scoreboard
+       * then (RFC 2018 section 8).
+       */
+
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+      if (wrb != NULL && TCP_WBSACKED(wrb))
+        {
+          for (entry = &wrb->wb_node; entry; entry = sq_next(entry))
+            {
+              TCP_WBSACKED((FAR struct tcp_wrbuffer_s *)entry) = false;
+            }
+        }
+
+      /* Move all segments that have been sent but not ACKed nor SACKed to
+       * the write queue again note, the un-ACKed segments are put at the
+       * head of the write_q so they can be resent as soon as possible.
+       */
+
+      for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+        {
+          next = sq_next(entry);
+          if (!TCP_WBSACKED((FAR struct tcp_wrbuffer_s *)entry))
+            {
+              sq_rem(entry, &conn->unacked_q);
+              retransmit_segment(conn, (FAR void *)entry);
+            }
+        }
+#else
       /* Move all segments that have been sent but not ACKed to the write
        * queue again note, the un-ACKed segments are put at the head of the
        * write_q so they can be resent as soon as possible.
@@ -985,6 +1234,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
         {
           retransmit_segment(conn, (FAR void *)entry);
         }
+#endif
     }
 
 #if CONFIG_NET_SEND_BUFSIZE > 0
@@ -1059,12 +1309,14 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       if (TCP_SEQ_LT(seq, snd_wnd_edge))
         {
           uint32_t remaining_snd_wnd;
+          uint32_t maxlen;
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          maxlen = tcp_max_sndlen(dev, conn, flags);
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1128,6 +1380,14 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NET_TCP_GSO
+          /* Packets larger than the MSS are cut into MSS sized segments
+           * by the hardware or by devif_poll_out().
+           */
+
+          dev->d_gsosize = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
@@ -1162,6 +1422,9 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           /* Increment the count of bytes sent from this write buffer */
 
           TCP_WBSENT(wrb) += sndlen;
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMIT(wrb)  = clock_systime_ticks();
+#endif
 
           ninfo("SEND: wrb=%p sent=%u pktlen=%u\n",
                 wrb, TCP_WBSENT(wrb), TCP_WBPKTLEN(wrb));
@@ -1458,6 +1721,8 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        * wait for the write buffer to be released
        */
 
+      tcp_sndbuf_adjust(conn);
+
       while (tcp_wrbuffer_inqueue_size(conn) >= conn->snd_bufs)
         {
           struct tcp_callback_s info;
@@ -1559,6 +1824,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
           TCP_WBSEQNO(wrb) = (unsigned)-1;
           TCP_WBNRTX(wrb)  = 0;
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+          TCP_WBSACKED(wrb) = false;
+#endif
 
           off = TCP_WBPKTLEN(wrb);
           if (off + chunk_len > max_wrb_size)
@@ -45,6 +45,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/tcp.h>
@@ -74,6 +75,9 @@ struct sendfile_s
   FAR struct tcp_conn_s *snd_conn;         /* Connection associated with the socket */
   FAR struct devif_callback_s *snd_cb;     /* Reference to callback instance */
   FAR struct file   *snd_file;             /* File structure of the input file */
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  FAR const uint8_t *snd_xip;              /* The input data in memory or NULL */
+#endif
   sem_t              snd_sem;              /* Used to wake up the waiting thread */
   off_t              snd_foffset;          /* Input file offset */
   size_t             snd_flen;             /* File length */
@@ -97,6 +101,62 @@ struct sendfile_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendfile_xipbase
+ *
+ * Description:
+ *   Return the address of the input data if the whole range is in memory,
+ *   e.g. a file of ROMFS on the XIP flash, otherwise NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+static FAR const uint8_t *sendfile_xipbase(FAR struct file *file,
+                                           off_t offset, size_t count)
+{
+  struct stat st;
+  uintptr_t base;
+
+  if (file_ioctl(file, FIOC_XIPBASE,
+                 (unsigned long)((uintptr_t)&base)) < 0 ||
+      file_fstat(file, &st) < 0 || offset < 0 ||
+      offset + count > st.st_size)
+    {
+      return NULL;
+    }
+
+  return (FAR const uint8_t *)base + offset;
+}
+#endif
+
+/****************************************************************************
+ * Name: sendfile_data
+ *
+ * Description:
+ *   Set up the packet with 'sndlen' bytes of the input data at 'offset'
+ *   from where the send operation started.
+ *
+ ****************************************************************************/
+
+static int sendfile_data(FAR struct net_driver_s *dev,
+                         FAR struct sendfile_s *pstate,
+                         uint32_t offset, uint32_t sndlen)
+{
+  FAR struct tcp_conn_s *conn = pstate->snd_conn;
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  if (pstate->snd_xip != NULL)
+    {
+      return devif_xip_send(dev, pstate->snd_xip + offset, sndlen,
+                            tcpip_hdrsize(conn));
+    }
+#endif
+
+  return devif_file_send(dev, pstate->snd_file, sndlen,
+                         pstate->snd_foffset + offset,
+                         tcpip_hdrsize(conn));
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
@@ -270,9 +330,7 @@ static uint32_t sendfile_eventhandler(FAR struct net_driver_s *dev,
        * happen until the polling cycle completes).
        */
 
-      ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                            pstate->snd_foffset + pstate->snd_acked,
-                            tcpip_hdrsize(conn));
+      ret = sendfile_data(dev, pstate, pstate->snd_acked, sndlen);
       if (ret < 0)
         {
           nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -341,9 +399,7 @@ static uint32_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                                pstate->snd_foffset + pstate->snd_sent,
-                                tcpip_hdrsize(conn));
+          ret = sendfile_data(dev, pstate, pstate->snd_sent, sndlen);
           if (ret < 0)
             {
               nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -419,6 +475,9 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 {
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  FAR const uint8_t *xip;
+#endif
   off_t startpos;
   int ret = OK;
 
@@ -471,6 +530,12 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
       return startpos;
     }
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Reference the data in place if the file is entirely in memory */
+
+  xip = sendfile_xipbase(infile, offset ? *offset : startpos, count);
+#endif
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -487,6 +552,9 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_foffset = offset ? *offset : startpos; /* Input file offset */
   state.snd_flen    = count;                       /* Number of bytes to send */
   state.snd_file    = infile;                      /* File to read from */
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  state.snd_xip     = xip;                         /* Data in memory */
+#endif
 
   /* Allocate resources to receive a callback */
 
@@ -549,6 +617,17 @@ errout_locked:
 #endif
   conn_dev_unlock(&conn->sconn, conn->dev);
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Nothing has been read from the file, move the position past the data
+   * sent like the reads do.
+   */
+
+  if (xip != NULL && state.snd_sent > 0)
+    {
+      file_seek(infile, state.snd_foffset + state.snd_sent, SEEK_SET);
+    }
+#endif
+
   /* Return the current file position */
 
   if (offset)
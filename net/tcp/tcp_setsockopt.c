@@ -28,6 +28,7 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -263,6 +264,43 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          FAR const struct tcp_cc_ops_s *ops;
+          char name[TCP_CA_NAME_MAX];
+
+          if (value_len == 0 || value_len >= TCP_CA_NAME_MAX)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          memcpy(name, value, value_len);
+          name[value_len] = '\0';
+
+          ops = tcp_cc_lookup(name);
+          if (ops == NULL)
+            {
+              nerr("ERROR: TCP_CONGESTION %s not supported\n", name);
+              ret = -ENOENT;
+            }
+          else if (ops != conn->cc_ops)
+            {
+              /* The connection already started keeps its window, only
+               * the private state of the new algorithm is reset.
+               */
+
+              conn->cc_ops = ops;
+              if (conn->tcpstateflags != TCP_ALLOCATED && ops->init != NULL)
+                {
+                  ops->init(conn);
+                }
+            }
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
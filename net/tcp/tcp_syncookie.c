@@ -0,0 +1,341 @@
+/****************************************************************************
+ * net/tcp/tcp_syncookie.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <crypto/md5.h>
+#include <debug.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Layout of the cookie sent as our initial sequence number:
+ *
+ *   Bits 27-31: Time counter, incremented every 64 seconds
+ *   Bits 24-26: Index of the peer MSS in g_tcp_cookie_mss
+ *   Bits  0-23: F(localip, localport, remoteip, remoteport, peer ISN,
+ *               time counter, secretkey)
+ */
+
+#define COOKIE_TIME_SHIFT   27
+#define COOKIE_TIME_MASK    0x1f
+#define COOKIE_MSS_SHIFT    24
+#define COOKIE_MSS_MASK     0x07
+#define COOKIE_HASH_MASK    0x00ffffff
+
+/* A cookie is accepted up to one time counter period after it was sent */
+
+#define COOKIE_TIME_PERIOD  64
+#define COOKIE_TIME_MAXAGE  1
+
+#define IPDATA(hl) (*(FAR uint8_t *)IPBUF(hl))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The peer MSS values that can be encoded in the cookie */
+
+static const uint16_t g_tcp_cookie_mss[COOKIE_MSS_MASK + 1] =
+{
+  536, 1024, 1220, 1380, 1440, 1460, 4312, 8960
+};
+
+/* The secret key of the cookie hash */
+
+static uint32_t g_tcp_cookie_key[4];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cookie_time
+ *
+ * Description:
+ *   Return the current value of the cookie time counter.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cookie_time(void)
+{
+  return (TICK2SEC(clock_systime_ticks()) / COOKIE_TIME_PERIOD) &
+         COOKIE_TIME_MASK;
+}
+
+/****************************************************************************
+ * Name: tcp_cookie_hash
+ *
+ * Description:
+ *   Calculate the hash part of the cookie of the connection the segment in
+ *   the device buffer belongs to.
+ *
+ * Input Parameters:
+ *   dev     - The device driver structure holding the segment
+ *   tcp     - The TCP header of the segment
+ *   peerisn - The initial sequence number of the peer
+ *   time    - The time counter
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cookie_hash(FAR struct net_driver_s *dev,
+                                FAR struct tcp_hdr_s *tcp,
+                                uint32_t peerisn, uint32_t time)
+{
+  uint32_t digest[MD5_DIGEST_LENGTH / 4];
+  MD5_CTX ctx;
+
+  /* Make sure we have a secret key */
+
+  if (g_tcp_cookie_key[0] == 0)
+    {
+      arc4random_buf(g_tcp_cookie_key, sizeof(g_tcp_cookie_key));
+    }
+
+  md5init(&ctx);
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      md5update(&ctx, IPv6BUF->destipaddr, sizeof(net_ipv6addr_t));
+      md5update(&ctx, IPv6BUF->srcipaddr, sizeof(net_ipv6addr_t));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      md5update(&ctx, IPv4BUF->destipaddr, sizeof(in_addr_t));
+      md5update(&ctx, IPv4BUF->srcipaddr, sizeof(in_addr_t));
+    }
+#endif
+
+  md5update(&ctx, &tcp->destport, sizeof(tcp->destport));
+  md5update(&ctx, &tcp->srcport, sizeof(tcp->srcport));
+  md5update(&ctx, &peerisn, sizeof(peerisn));
+  md5update(&ctx, &time, sizeof(time));
+  md5update(&ctx, g_tcp_cookie_key, sizeof(g_tcp_cookie_key));
+
+  md5final((FAR uint8_t *)digest, &ctx);
+
+  return digest[0] & COOKIE_HASH_MASK;
+}
+
+/****************************************************************************
+ * Name: tcp_cookie_peermss
+ *
+ * Description:
+ *   Get the MSS option of the SYN segment in the device buffer.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_cookie_peermss(FAR struct net_driver_s *dev,
+                                   FAR struct tcp_hdr_s *tcp,
+                                   unsigned int iplen)
+{
+  unsigned int optlen = ((tcp->tcpoffset >> 4) << 2) - TCP_HDRLEN;
+  unsigned int tcpiplen = iplen + TCP_HDRLEN;
+  unsigned int i = 0;
+  uint8_t opt;
+
+  while (i + 1 < optlen)
+    {
+      opt = IPDATA(tcpiplen + i);
+      if (opt == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+      else if (opt == TCP_OPT_MSS &&
+               IPDATA(tcpiplen + 1 + i) == TCP_OPT_MSS_LEN &&
+               i + TCP_OPT_MSS_LEN <= optlen)
+        {
+          return ((uint16_t)IPDATA(tcpiplen + 2 + i) << 8) |
+                  (uint16_t)IPDATA(tcpiplen + 3 + i);
+        }
+      else if (IPDATA(tcpiplen + 1 + i) == 0)
+        {
+          break;
+        }
+
+      i += IPDATA(tcpiplen + 1 + i);
+    }
+
+  /* RFC 9293: the default MSS is 536 */
+
+  return g_tcp_cookie_mss[0];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncookie_synack
+ *
+ * Description:
+ *   Reply to the SYN segment in the device buffer with a SYN-ACK carrying a
+ *   SYN cookie, without allocating a connection.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the SYN segment
+ *   tcp      - The TCP header of the segment
+ *   listener - The listening connection the SYN is for
+ *   iplen    - The length of the IP header
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_syncookie_synack(FAR struct net_driver_s *dev,
+                          FAR struct tcp_hdr_s *tcp,
+                          FAR struct tcp_conn_s *listener,
+                          unsigned int iplen)
+{
+  uint32_t peerisn = tcp_getsequence(tcp->seqno);
+  uint16_t peermss = tcp_cookie_peermss(dev, tcp, iplen);
+  uint32_t time = tcp_cookie_time();
+  uint32_t cookie;
+  int idx;
+
+  /* Use the largest MSS that the peer accepts */
+
+  for (idx = COOKIE_MSS_MASK; idx > 0; idx--)
+    {
+      if (g_tcp_cookie_mss[idx] <= peermss)
+        {
+          break;
+        }
+    }
+
+  cookie = (time << COOKIE_TIME_SHIFT) | (idx << COOKIE_MSS_SHIFT) |
+           tcp_cookie_hash(dev, tcp, peerisn, time);
+
+  ninfo("SYN cookie %08" PRIx32 " mss %u\n", cookie, g_tcp_cookie_mss[idx]);
+
+  tcp_synack_stateless(dev, listener, cookie);
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check if the ACK segment in the device buffer completes a handshake
+ *   started with a SYN cookie and, if so, create the connection in the
+ *   TCP_SYN_RCVD state as if the SYN-ACK had been sent from it.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the ACK segment
+ *   tcp      - The TCP header of the segment
+ *   listener - The listening connection the ACK is for
+ *
+ * Returned Value:
+ *   The new connection or NULL if the segment carries no valid cookie or
+ *   no connection could be allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *
+tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                     FAR struct tcp_hdr_s *tcp,
+                     FAR struct tcp_conn_s *listener)
+{
+  FAR struct tcp_conn_s *conn;
+  uint32_t cookie = tcp_getsequence(tcp->ackno) - 1;
+  uint32_t peerisn = tcp_getsequence(tcp->seqno) - 1;
+  uint32_t time = cookie >> COOKIE_TIME_SHIFT;
+  uint16_t mss;
+
+  if (((tcp_cookie_time() - time) & COOKIE_TIME_MASK) > COOKIE_TIME_MAXAGE ||
+      (cookie & COOKIE_HASH_MASK) !=
+      tcp_cookie_hash(dev, tcp, peerisn, time))
+    {
+      return NULL;
+    }
+
+  mss = g_tcp_cookie_mss[(cookie >> COOKIE_MSS_SHIFT) & COOKIE_MSS_MASK];
+  if (mss > tcp_rx_mss(dev))
+    {
+      mss = tcp_rx_mss(dev);
+    }
+
+  /* The sequence number of the ACK already is the peer ISN plus one, which
+   * is the rcvseq expected by the connection.
+   */
+
+  conn = tcp_alloc_accept(dev, tcp, listener);
+  if (conn == NULL)
+    {
+      return NULL;
+    }
+
+  conn->crefs = 1;
+  if (conn->mss > mss)
+    {
+      conn->mss = mss;
+    }
+
+  /* Pretend the SYN-ACK was sent by this connection */
+
+  tcp_setsequence(conn->sndseq, cookie);
+  conn->rexmit_seq = cookie;
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  conn->sndseq_max = cookie + 1;
+#endif
+
+  ninfo("SYN cookie %08" PRIx32 " accepted, mss %u\n", cookie, conn->mss);
+  return conn;
+}
+
+#endif /* CONFIG_NET_TCP_SYNCOOKIES */
@@ -55,6 +55,7 @@
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
 #include <nuttx/net/tcp.h>
@@ -79,6 +80,30 @@
 
 #define ACK_DELAY (1)
 
+/* The maximum number of devices notified by one pass of the timer sweep */
+
+#ifdef CONFIG_NET_TCP_TIMER_SWEEP
+#  define TCP_SWEEP_NDEVS (4)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_SWEEP
+/* The single timer that drives the TCP timers of all connections */
+
+static struct work_s g_tcp_sweep_work;
+
+/* The time when g_tcp_sweep_work runs, zero if it is not queued */
+
+static clock_t g_tcp_sweep_next;
+
+/* Protects g_tcp_sweep_next and the expiry of the connections */
+
+static spinlock_t g_tcp_sweep_lock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -120,6 +145,15 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* A delayed ACK must be sent within ACK_DELAY */
+
+  if (conn->rx_unackseg > 0 && (timeout == 0 || timeout > ACK_DELAY))
+    {
+      timeout = ACK_DELAY;
+    }
+#endif
+
   return timeout;
 }
 
@@ -142,6 +176,141 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_TIMER_SWEEP
+static void tcp_timer_sweep(FAR void *arg);
+
+/****************************************************************************
+ * Name: tcp_sweep_arm
+ *
+ * Description:
+ *   Make sure that the timer sweep runs no later than 'expiry'.
+ *
+ * Assumptions:
+ *   g_tcp_sweep_lock is held.
+ *
+ ****************************************************************************/
+
+static void tcp_sweep_arm(clock_t expiry)
+{
+  sclock_t delay;
+
+  if (g_tcp_sweep_next == 0 ||
+      (sclock_t)(expiry - g_tcp_sweep_next) < 0)
+    {
+      delay = expiry - clock_systime_ticks();
+      if (delay < 0)
+        {
+          delay = 0;
+        }
+
+      g_tcp_sweep_next = expiry;
+      work_queue(LPWORK, &g_tcp_sweep_work, tcp_timer_sweep, NULL, delay);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_timer_sweep
+ *
+ * Description:
+ *   Handle the TCP timer expiration of all the TCP connections whose
+ *   deadline passed, then rearm the sweep for the earliest remaining
+ *   deadline.
+ *
+ * Input Parameters:
+ *   arg - Not used
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void tcp_timer_sweep(FAR void *arg)
+{
+  FAR struct net_driver_s *devs[TCP_SWEEP_NDEVS];
+  FAR struct tcp_conn_s *conn = NULL;
+  irqstate_t flags;
+  clock_t next = 0;
+  clock_t now;
+  int ndevs = 0;
+  int i;
+
+  flags = spin_lock_irqsave(&g_tcp_sweep_lock);
+  g_tcp_sweep_next = 0;
+  spin_unlock_irqrestore(&g_tcp_sweep_lock, flags);
+
+  now = clock_systime_ticks();
+
+  tcp_conn_list_lock();
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      bool expired = false;
+
+      flags = spin_lock_irqsave(&g_tcp_sweep_lock);
+      if (conn->expiry != 0)
+        {
+          if ((sclock_t)(conn->expiry - now) > 0)
+            {
+              if (next == 0 || (sclock_t)(conn->expiry - next) < 0)
+                {
+                  next = conn->expiry;
+                }
+            }
+          else
+            {
+              for (i = 0; i < ndevs && devs[i] != conn->dev; i++);
+
+              if (conn->dev == NULL)
+                {
+                  conn->expiry = 0;
+                  expired      = true;
+                }
+              else if (i < TCP_SWEEP_NDEVS)
+                {
+                  conn->expiry = 0;
+                  expired      = true;
+
+                  if (i == ndevs)
+                    {
+                      devs[ndevs++] = conn->dev;
+                    }
+                }
+              else
+                {
+                  /* Too many devices, leave it to the next pass */
+
+                  next = now;
+                }
+            }
+        }
+
+      spin_unlock_irqrestore(&g_tcp_sweep_lock, flags);
+
+      if (expired)
+        {
+          conn->timeout = true;
+        }
+    }
+
+  tcp_conn_list_unlock();
+
+  /* Notify the devices outside of the connection list lock */
+
+  for (i = 0; i < ndevs; i++)
+    {
+      netdev_lock(devs[i]);
+      netdev_txnotify_dev(devs[i], TCP_POLL);
+      netdev_unlock(devs[i]);
+    }
+
+  if (next != 0)
+    {
+      flags = spin_lock_irqsave(&g_tcp_sweep_lock);
+      tcp_sweep_arm(next);
+      spin_unlock_irqrestore(&g_tcp_sweep_lock, flags);
+    }
+}
+#else
 static void tcp_timer_expiry(FAR void *arg)
 {
   FAR struct tcp_conn_s *conn = NULL;
@@ -163,6 +332,7 @@ static void tcp_timer_expiry(FAR void *arg)
 
   tcp_conn_list_unlock();
 }
+#endif
 
 /****************************************************************************
  * Name: tcp_xmit_probe
@@ -234,6 +404,10 @@ static void tcp_xmit_probe(FAR struct net_driver_s *dev,
 void tcp_update_timer(FAR struct tcp_conn_s *conn)
 {
   sclock_t timeout = tcp_get_timeout(conn);
+#ifdef CONFIG_NET_TCP_TIMER_SWEEP
+  irqstate_t flags;
+  clock_t now;
+#endif
 
   if (timeout > 0)
     {
@@ -255,16 +429,34 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
         }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMER_SWEEP
+      now   = clock_systime_ticks();
+      flags = spin_lock_irqsave(&g_tcp_sweep_lock);
+      if (conn->expiry == 0 ||
+          TICK2HSEC((sclock_t)(conn->expiry - now)) != timeout)
+        {
+          conn->expiry = now + HSEC2TICK(timeout);
+          if (conn->expiry == 0)
+            {
+              conn->expiry = 1;
+            }
+
+          tcp_sweep_arm(conn->expiry);
+        }
+
+      spin_unlock_irqrestore(&g_tcp_sweep_lock, flags);
+#else
       if (work_available(&conn->work) ||
           TICK2HSEC(work_timeleft(&conn->work)) != timeout)
         {
           work_queue(LPWORK, &conn->work, tcp_timer_expiry,
                      conn, HSEC2TICK(timeout));
         }
+#endif
     }
   else
     {
-      work_cancel(LPWORK, &conn->work);
+      tcp_stop_timer(conn);
     }
 }
 
@@ -342,7 +534,16 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout)
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_TIMER_SWEEP
+  irqstate_t flags = spin_lock_irqsave(&g_tcp_sweep_lock);
+
+  /* The sweep simply skips the connection from now on */
+
+  conn->expiry = 0;
+  spin_unlock_irqrestore(&g_tcp_sweep_lock, flags);
+#else
   work_cancel(LPWORK, &conn->work);
+#endif
 }
 
 /****************************************************************************
@@ -628,22 +829,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
+                    /* Restart from the slow start */
 
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -39,6 +40,10 @@
 #include <nuttx/net/udp.h>
 #include <nuttx/mm/iob.h>
 
+#ifdef CONFIG_NET_UDP_GSO
+#  include <nuttx/net/netdev.h>
+#endif
+
 #ifdef CONFIG_NET_UDP_NOTIFIER
 #  include <nuttx/wqueue.h>
 #endif
@@ -70,8 +75,16 @@
 /* Definitions for the UDP connection struct flag field */
 
 #define _UDP_FLAG_CONNECTMODE (1 << 0) /* Bit 0:  UDP connection-mode */
+#define _UDP_FLAG_GRO         (1 << 1) /* Bit 1:  UDP_GRO enabled */
 
 #define _UDP_ISCONNECTMODE(f) (((f) & _UDP_FLAG_CONNECTMODE) != 0)
+#define _UDP_ISGRO(f)         (((f) & _UDP_FLAG_GRO) != 0)
+
+/* The maximum number of datagrams sent or received as a single buffer
+ * with UDP_SEGMENT or UDP_GRO.
+ */
+
+#define UDP_MAX_SEGMENTS      64
 
 /* This is a helper pointer for accessing the contents of the udp header */
 
@@ -111,6 +124,7 @@ struct udp_conn_s
   /* UDP-specific content follows */
 
   union ip_binding_u u;   /* IP address binding */
+  hash_node_t hnode;      /* Node of the hashtable of the bound ports */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
   uint8_t  flags;         /* See _UDP_FLAG_* definitions */
@@ -149,6 +163,10 @@ struct udp_conn_s
   FAR struct devif_callback_s *sndcb;
 #endif
 
+#ifdef CONFIG_NET_UDP_GSO
+  uint16_t gsosize;       /* Segment size set with UDP_SEGMENT, or 0 */
+#endif
+
 #if defined(CONFIG_NET_IGMP) || defined(CONFIG_NET_MLD)
   struct ip_mreqn mreq;
 #endif
@@ -175,6 +193,10 @@ struct udp_wrbuffer_s
   sq_entry_t wb_node;              /* Supports a singly linked list */
   struct sockaddr_storage wb_dest; /* Destination address */
   FAR struct iob_s *wb_iob;        /* Head of the I/O buffer chain */
+#ifdef CONFIG_NET_UDP_GSO
+  uint16_t wb_gsosize;             /* Datagram size if several, else 0 */
+  uint16_t wb_offset;              /* Payload taken by the datagrams sent */
+#endif
 };
 #endif
 
@@ -253,6 +275,22 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of the UDP connection and move the connection to
+ *   the bucket of the new port in the hashtable used by udp_active().  A
+ *   port of zero unbinds the connection.
+ *
+ * Input Parameters:
+ *   conn   - A reference to UDP connection structure
+ *   portno - The new local port number in network byte order
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_conn_list_lock
  *
@@ -496,6 +534,61 @@ int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len);
 #endif
 
+/****************************************************************************
+ * Name: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value for the UDP-protocol option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ *   See <netinet/udp.h> for the a complete list of values of UDP protocol
+ *   options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_getsockopt() for
+ *   the complete list of appropriate return error codes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
+/****************************************************************************
+ * Name: udp_gso_poll
+ *
+ * Description:
+ *   Cut the UDP packet in dev->d_iob holding several datagrams into the
+ *   datagrams of d_gsosize bytes of payload and pass them one after
+ *   another through devif_poll_out().  The large packet is released when
+ *   done.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the large packet
+ *   callback - The actual sending API provided by the driver
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GSO
+int udp_gso_poll(FAR struct net_driver_s *dev,
+                 devif_poll_callback_t callback);
+#endif
+
 /****************************************************************************
  * Name: udp_wrbuffer_alloc
  *
@@ -796,6 +889,36 @@ ssize_t psock_udp_sendto(FAR struct socket *psock,
                          FAR const void *buf, size_t len, int flags,
                          FAR const struct sockaddr *to, socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendto_segment
+ *
+ * Description:
+ *   Same as psock_udp_sendto() but the data is sent as the datagrams of
+ *   'gsosize' bytes, the last one may be shorter.  A 'gsosize' of zero
+ *   sends a single datagram.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *   gsosize  The size of the datagrams
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GSO
+ssize_t psock_udp_sendto_segment(FAR struct socket *psock,
+                                 FAR const void *buf, size_t len, int flags,
+                                 FAR const struct sockaddr *to,
+                                 socklen_t tolen, uint16_t gsosize);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
@@ -96,6 +96,10 @@ NET_BUFPOOL_DECLARE(g_udp_connections, sizeof(struct udp_conn_s),
 
 static dq_queue_t g_active_udp_connections;
 
+/* The bound UDP connections hashed by the local port */
+
+static DECLARE_HASHTABLE(g_active_udp_hashtable, CONFIG_NET_UDP_HASH_BITS);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -182,6 +186,38 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   return conn;
 }
 
+/****************************************************************************
+ * Name: udp_bucket
+ *
+ * Description:
+ *   Return the bucket of the hashtable that the local port belongs to.
+ *
+ ****************************************************************************/
+
+static inline FAR hash_head_t *udp_bucket(uint16_t portno)
+{
+  return &g_active_udp_hashtable[HASH(portno,
+                                 hashtable_bits(g_active_udp_hashtable))];
+}
+
+/****************************************************************************
+ * Name: udp_nextport
+ *
+ * Description:
+ *   Traverse the UDP connections which may be bound to the local port, the
+ *   first one is returned if conn is NULL.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+udp_nextport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  FAR hash_node_t *p;
+
+  p = conn == NULL ? dq_peek(udp_bucket(portno)) : dq_next(&conn->hnode);
+  return p != NULL ? container_of(p, struct udp_conn_s, hnode) : NULL;
+}
+
 /****************************************************************************
  * Name: udp_ipv4_active
  *
@@ -204,7 +240,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn)
     {
@@ -316,9 +352,9 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection bound to the same port */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -344,7 +380,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -456,9 +492,9 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection bound to the same port */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -606,7 +642,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   NET_BUFPOOL_LOCK(g_udp_connections);
-  conn->lport = 0;
+  udp_setport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -735,6 +771,38 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of the UDP connection and move the connection to
+ *   the bucket of the new port in the hashtable used by udp_active().  A
+ *   port of zero unbinds the connection.
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  udp_conn_list_lock();
+
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->hnode, udp_bucket(conn->lport));
+    }
+
+  /* Keep the order of binding, the first matching connection takes the
+   * unicast datagram.
+   */
+
+  conn->lport = portno;
+  if (portno != 0)
+    {
+      dq_addlast(&conn->hnode, udp_bucket(portno));
+    }
+
+  udp_conn_list_unlock();
+}
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -752,6 +820,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
   uint16_t portno;
   int ret;
   FAR struct net_driver_s *dev;
+  int epoch;
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
   if (conn->domain != addr->sa_family)
@@ -781,7 +850,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           ret = -EADDRNOTAVAIL;
 
-          netdev_list_lock();
+          epoch = netdev_list_read_lock();
           for (dev = g_netdevices; dev; dev = dev->flink)
             {
               if (net_ipv4addr_cmp(inaddr->sin_addr.s_addr, dev->d_ipaddr))
@@ -791,7 +860,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
                 }
             }
 
-          netdev_list_unlock();
+          netdev_list_read_unlock(epoch);
           if (ret == -EADDRNOTAVAIL)
             {
               conn_unlock(&conn->sconn);
@@ -830,7 +899,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           ret = -EADDRNOTAVAIL;
 
-          netdev_list_lock();
+          epoch = netdev_list_read_lock();
           for (dev = g_netdevices; dev; dev = dev->flink)
             {
               if (NETDEV_IS_MY_V6ADDR(dev,
@@ -841,7 +910,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
                 }
             }
 
-          netdev_list_unlock();
+          netdev_list_read_unlock(epoch);
           if (ret == -EADDRNOTAVAIL)
             {
               conn_unlock(&conn->sconn);
@@ -876,7 +945,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
     }
@@ -901,7 +970,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -953,7 +1022,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
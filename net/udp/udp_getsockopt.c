@@ -0,0 +1,119 @@
+/****************************************************************************
+ * net/udp/udp_getsockopt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netinet/udp.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/udp.h>
+
+#include "socket/socket.h"
+#include "utils/utils.h"
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value for the UDP-protocol option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ *   See <netinet/udp.h> for the a complete list of values of UDP protocol
+ *   options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_getsockopt() for
+ *   the complete list of appropriate return error codes.
+ *
+ ****************************************************************************/
+
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+#if defined(CONFIG_NET_UDP_GSO) || defined(CONFIG_NET_UDP_GRO)
+  FAR struct udp_conn_s *conn;
+
+  DEBUGASSERT(value != NULL && value_len != NULL);
+  conn = psock->s_conn;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      nerr("ERROR:  Not a UDP socket\n");
+      return -ENOTCONN;
+    }
+
+  if (*value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_UDP_GSO
+      case UDP_SEGMENT:
+        *(FAR int *)value = conn->gsosize;
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP_GRO
+      case UDP_GRO:
+        *(FAR int *)value = _UDP_ISGRO(conn->flags);
+        break;
+#endif
+
+      default:
+        nerr("ERROR: Unrecognized UDP option: %d\n", option);
+        return -ENOPROTOOPT;
+    }
+
+  *value_len = sizeof(int);
+  return OK;
+#else
+  return -ENOPROTOOPT;
+#endif
+}
+
+#endif /* CONFIG_NET_UDPPROTO_OPTIONS */
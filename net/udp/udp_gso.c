@@ -0,0 +1,274 @@
+/****************************************************************************
+ * net/udp/udp_gso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/param.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/udp.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "utils/utils.h"
+#include "udp/udp.h"
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_GSO)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_gso_alloc
+ *
+ * Description:
+ *   Allocate one datagram and copy the headers and 'len' bytes of the
+ *   payload at 'offset' of the large packet into it.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *udp_gso_alloc(FAR struct iob_s *pkt,
+                                       uint16_t hdrlen, unsigned int offset,
+                                       unsigned int len)
+{
+  FAR struct iob_s *seg;
+
+  seg = iob_tryalloc(false);
+  if (seg == NULL)
+    {
+      return NULL;
+    }
+
+  iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+
+  if (iob_clone_partial(pkt, len, hdrlen + offset, seg, hdrlen,
+                        false, false) != OK ||
+      iob_trycopyin(seg, IOB_DATA(pkt), hdrlen, 0, false) != hdrlen)
+    {
+      iob_free_chain(seg);
+      return NULL;
+    }
+
+  return seg;
+}
+
+/****************************************************************************
+ * Name: udp_gso_header
+ *
+ * Description:
+ *   Fix up the IP and UDP headers copied from the large packet for the
+ *   datagram 'index'.
+ *
+ ****************************************************************************/
+
+static void udp_gso_header(FAR struct net_driver_s *dev,
+                           FAR struct iob_s *seg, uint16_t iphdrlen,
+                           uint16_t index)
+{
+  FAR uint8_t *ip = IOB_DATA(seg);
+  FAR struct udp_hdr_s *udp = (FAR struct udp_hdr_s *)(ip + iphdrlen);
+  uint16_t upperlen = seg->io_pktlen - iphdrlen;
+  uint16_t sum;
+
+  udp->udplen    = HTONS(upperlen);
+  udp->udpchksum = 0;
+
+#ifdef CONFIG_NET_IPv6
+  if (iphdrlen == IPv6_HDRLEN)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      ipv6->len[0] = upperlen >> 8;
+      ipv6->len[1] = upperlen & 0xff;
+
+      sum = chksum(upperlen + IP_PROTO_UDP,
+                   (FAR const uint8_t *)ipv6->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+    }
+#endif
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+      uint16_t ipid = ((uint16_t)ipv4->ipid[0] << 8) + ipv4->ipid[1];
+
+      /* The datagrams take the IP identifications following the one of the
+       * large packet, they are sent with DF so don't need to be unique.
+       */
+
+      ipid += index;
+      ipv4->len[0]   = seg->io_pktlen >> 8;
+      ipv4->len[1]   = seg->io_pktlen & 0xff;
+      ipv4->ipid[0]  = ipid >> 8;
+      ipv4->ipid[1]  = ipid & 0xff;
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+
+      sum = chksum(upperlen + IP_PROTO_UDP,
+                   (FAR const uint8_t *)ipv4->srcipaddr,
+                   2 * sizeof(in_addr_t));
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP_CHECKSUMS
+  if ((dev->d_features & NETDEV_TX_CSUM) != 0)
+    {
+      /* Leave the pseudo header sum to the hardware to complete */
+
+      udp->udpchksum = HTONS(sum);
+    }
+  else
+    {
+      sum = chksum_iob(sum, seg, iphdrlen);
+      udp->udpchksum = ~((sum == 0) ? 0xffff : HTONS(sum));
+      if (udp->udpchksum == 0)
+        {
+          udp->udpchksum = 0xffff;
+        }
+    }
+#else
+  UNUSED(sum);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_gso_poll
+ *
+ * Description:
+ *   Cut the UDP packet in dev->d_iob holding several datagrams into the
+ *   datagrams of d_gsosize bytes of payload and pass them one after
+ *   another through devif_poll_out().  The large packet is released when
+ *   done.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the large packet
+ *   callback - The actual sending API provided by the driver
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int udp_gso_poll(FAR struct net_driver_s *dev,
+                 devif_poll_callback_t callback)
+{
+  FAR struct iob_s *pkt = dev->d_iob;
+  FAR struct iob_s *seg;
+  unsigned int payload;
+  unsigned int offset;
+  unsigned int len;
+  uint16_t gsosize = dev->d_gsosize;
+  uint16_t iphdrlen;
+  uint16_t hdrlen;
+  uint16_t index;
+  int bstop = false;
+
+  /* udp_send() built all of the headers in the first buffer */
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv4(dev->d_flags))
+#  endif
+    {
+      iphdrlen = IPv4_HDRLEN;
+    }
+#endif
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  else
+#  endif
+    {
+      iphdrlen = IPv6_HDRLEN;
+    }
+#endif
+
+  hdrlen  = iphdrlen + UDP_HDRLEN;
+  payload = pkt->io_pktlen - hdrlen;
+
+  DEBUGASSERT(pkt->io_len >= hdrlen && gsosize > 0);
+
+  /* Each datagram replaces the large packet in the device in turn and
+   * takes the normal path to the driver.
+   */
+
+  netdev_iob_clear(dev);
+  dev->d_gsosize = 0;
+
+  for (offset = 0, index = 0; offset < payload && !bstop;
+       offset += len, index++)
+    {
+      len = MIN(payload - offset, gsosize);
+      seg = udp_gso_alloc(pkt, hdrlen, offset, len);
+      if (seg == NULL)
+        {
+          /* The rest of the datagrams are lost */
+
+          nerr("ERROR: Failed to allocate the UDP datagram\n");
+          netdev_iob_release(dev);
+          bstop = true;
+          break;
+        }
+
+      udp_gso_header(dev, seg, iphdrlen, index);
+
+      netdev_iob_replace(dev, seg);
+#ifdef CONFIG_NET_UDP_CHECKSUMS
+      dev->d_txcsum = (dev->d_features & NETDEV_TX_CSUM) != 0;
+#endif
+
+      bstop = devif_poll_out(dev, callback);
+    }
+
+  iob_free_chain(pkt);
+
+#ifdef CONFIG_NET_STATISTICS
+  if (index > 1)
+    {
+      g_netstats.udp.sent += index - 1;
+    }
+#endif
+
+  return bstop;
+}
+
+#endif /* NET_UDP_HAVE_STACK && CONFIG_NET_UDP_GSO */
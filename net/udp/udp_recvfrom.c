@@ -33,6 +33,7 @@
 #include <assert.h>
 
 #include <sys/time.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -41,6 +42,7 @@
 #include <nuttx/net/udp.h>
 #include <nuttx/tls.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 
 #include "netdev/netdev.h"
 #include "devif/devif.h"
@@ -170,6 +172,159 @@ static inline size_t udp_recvfrom_newdata(FAR struct net_driver_s *dev,
   return recvlen;
 }
 
+/****************************************************************************
+ * Name: udp_readahead_record
+ *
+ * Description:
+ *   Unflatten the connection information saved in front of the datagram at
+ *   'offset' of the read-ahead buffer.
+ *
+ * Returned Value:
+ *   The offset following the source address.
+ *
+ ****************************************************************************/
+
+static int udp_readahead_record(FAR struct iob_s *iob, int offset,
+                                FAR uint16_t *datalen, FAR uint8_t *ifindex,
+                                FAR uint8_t *src_addr_size,
+                                FAR uint8_t *srcaddr)
+{
+  int recvlen;
+
+  /* Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data| */
+
+  recvlen = iob_copyout((FAR uint8_t *)datalen, iob,
+                        sizeof(*datalen), offset);
+  offset += sizeof(*datalen);
+  DEBUGASSERT(recvlen == sizeof(*datalen));
+
+#ifdef CONFIG_NETDEV_IFINDEX
+  recvlen = iob_copyout(ifindex, iob, sizeof(*ifindex), offset);
+  offset += sizeof(*ifindex);
+  DEBUGASSERT(recvlen == sizeof(*ifindex));
+#else
+  *ifindex = 1;
+#endif
+  recvlen = iob_copyout(src_addr_size, iob,
+                        sizeof(*src_addr_size), offset);
+  offset += sizeof(*src_addr_size);
+  DEBUGASSERT(recvlen == sizeof(*src_addr_size));
+
+  recvlen = iob_copyout(srcaddr, iob, *src_addr_size, offset);
+  offset += *src_addr_size;
+  DEBUGASSERT(recvlen == *src_addr_size);
+
+  UNUSED(recvlen);
+  return offset;
+}
+
+/****************************************************************************
+ * Name: udp_gro_sameaddr
+ *
+ * Description:
+ *   Check if two saved source addresses are of the same sender.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GRO
+static bool udp_gro_sameaddr(FAR const void *addr1, FAR const void *addr2)
+{
+  FAR const struct sockaddr *sa1 = addr1;
+  FAR const struct sockaddr *sa2 = addr2;
+
+  if (sa1->sa_family != sa2->sa_family)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+  if (sa1->sa_family == AF_INET6)
+    {
+      FAR const struct sockaddr_in6 *in1 = addr1;
+      FAR const struct sockaddr_in6 *in2 = addr2;
+
+      return in1->sin6_port == in2->sin6_port &&
+             net_ipv6addr_cmp(in1->sin6_addr.s6_addr16,
+                              in2->sin6_addr.s6_addr16);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if (sa1->sa_family == AF_INET)
+    {
+      FAR const struct sockaddr_in *in1 = addr1;
+      FAR const struct sockaddr_in *in2 = addr2;
+
+      return in1->sin_port == in2->sin_port &&
+             in1->sin_addr.s_addr == in2->sin_addr.s_addr;
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: udp_readahead_gro
+ *
+ * Description:
+ *   Append the following datagrams of the same sender and interface to the
+ *   first one of 'segsize' bytes already copied to the user, as long as
+ *   they are not larger and fit in the user buffer.  A shorter datagram
+ *   ends the train.
+ *
+ * Returned Value:
+ *   The number of datagrams coalesced, the first one included.
+ *
+ ****************************************************************************/
+
+static int udp_readahead_gro(FAR struct udp_recvfrom_s *pstate,
+                             FAR struct iob_s *iob, FAR int *offset,
+                             uint16_t segsize, FAR const uint8_t *srcaddr,
+                             uint8_t ifindex)
+{
+  FAR struct iovec *iov = pstate->ir_msg->msg_iov;
+  uint16_t datalen;
+  uint8_t src_addr_size;
+  uint8_t nextif;
+#ifdef CONFIG_NET_IPv6
+  uint8_t nextaddr[sizeof(struct sockaddr_in6)];
+#else
+  uint8_t nextaddr[sizeof(struct sockaddr_in)];
+#endif
+  int nsegs = 1;
+  int next;
+
+  while (nsegs < UDP_MAX_SEGMENTS && *offset < iob->io_pktlen)
+    {
+      next = udp_readahead_record(iob, *offset, &datalen, &nextif,
+                                  &src_addr_size, nextaddr);
+#ifdef CONFIG_NET_TIMESTAMP
+      next += sizeof(struct timespec);
+#endif
+
+      if (datalen == 0 || datalen > segsize || nextif != ifindex ||
+          datalen > iov->iov_len - pstate->ir_recvlen ||
+          !udp_gro_sameaddr(srcaddr, nextaddr))
+        {
+          break;
+        }
+
+      pstate->ir_recvlen +=
+        iob_copyout((FAR uint8_t *)iov->iov_base + pstate->ir_recvlen,
+                    iob, datalen, next);
+      *offset = next + datalen;
+      nsegs++;
+
+      if (datalen < segsize)
+        {
+          break;
+        }
+    }
+
+  return nsegs;
+}
+#endif /* CONFIG_NET_UDP_GRO */
+
 static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 {
   FAR struct udp_conn_s *conn = pstate->ir_conn;
@@ -184,7 +339,7 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
   if ((iob = conn->readahead) != NULL)
     {
       int recvlen;
-      int offset = 0;
+      int offset;
       uint16_t datalen;
       uint8_t src_addr_size;
       uint8_t ifindex;
@@ -198,26 +353,8 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
        * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
        */
 
-      recvlen = iob_copyout((FAR uint8_t *)&datalen, iob,
-                            sizeof(datalen), offset);
-      offset += sizeof(datalen);
-      DEBUGASSERT(recvlen == sizeof(datalen));
-
-#ifdef CONFIG_NETDEV_IFINDEX
-      recvlen = iob_copyout(&ifindex, iob, sizeof(ifindex), offset);
-      offset += sizeof(ifindex);
-      DEBUGASSERT(recvlen == sizeof(ifindex));
-#else
-      ifindex = 1;
-#endif
-      recvlen = iob_copyout(&src_addr_size, iob,
-                            sizeof(src_addr_size), offset);
-      offset += sizeof(src_addr_size);
-      DEBUGASSERT(recvlen == sizeof(src_addr_size));
-
-      recvlen = iob_copyout(srcaddr, iob, src_addr_size, offset);
-      offset += src_addr_size;
-      DEBUGASSERT(recvlen == src_addr_size);
+      offset = udp_readahead_record(iob, 0, &datalen, &ifindex,
+                                    &src_addr_size, srcaddr);
 
 #ifdef CONFIG_NET_TIMESTAMP
       /* Unpack stored timestamp if SO_TIMESTAMP socket option is enabled */
@@ -244,9 +381,27 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
       /* Update the accumulated size of the data read */
 
       pstate->ir_recvlen = recvlen;
+      offset += datalen;
 
-      ninfo("Received %d bytes (of %d, total %d)\n",
-            recvlen, datalen, iob->io_pktlen);
+#ifdef CONFIG_NET_UDP_GRO
+      /* Coalesce the following datagrams of the same size and sender */
+
+      if (_UDP_ISGRO(conn->flags) && !(pstate->ir_flags & MSG_PEEK) &&
+          recvlen == datalen && datalen > 0)
+        {
+          int segsize = datalen;
+
+          if (udp_readahead_gro(pstate, iob, &offset, datalen,
+                                srcaddr, ifindex) > 1)
+            {
+              cmsg_append(pstate->ir_msg, SOL_UDP, UDP_GRO,
+                          &segsize, sizeof(segsize));
+            }
+        }
+#endif
+
+      ninfo("Received %zd bytes (of %d, total %d)\n",
+            pstate->ir_recvlen, datalen, iob->io_pktlen);
 
       if (pstate->ir_msg->msg_name)
         {
@@ -264,14 +419,14 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 
       if (!(pstate->ir_flags & MSG_PEEK))
         {
-          if (offset + datalen >= iob->io_pktlen)
+          if (offset >= iob->io_pktlen)
             {
               iob_free_chain(iob);
               conn->readahead = NULL;
             }
           else
             {
-              conn->readahead = iob_trimhead(iob, offset + datalen);
+              conn->readahead = iob_trimhead(iob, offset);
             }
         }
     }
@@ -622,6 +777,7 @@ static ssize_t udp_recvfrom_result(int result, struct udp_recvfrom_s *pstate)
 #ifdef CONFIG_NETDEV_RSS
 static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
 {
+  FAR struct net_driver_s *dev;
   int cpu;
 
   if (!conn)
@@ -632,15 +788,18 @@ static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
   cpu = this_cpu();
   if (cpu != conn->rcvcpu)
     {
+      /* The datagrams arrive on the device of the local address */
+
+      dev = udp_find_laddr_device(conn);
       if (conn->domain == PF_INET)
         {
-          netdev_notify_recvcpu(conn->dev, cpu, conn->domain,
+          netdev_notify_recvcpu(dev, cpu, conn->domain,
                                 &(conn->u.ipv4.laddr), conn->lport,
                                 &(conn->u.ipv4.raddr), conn->rport);
         }
       else
         {
-          netdev_notify_recvcpu(conn->dev, cpu, conn->domain,
+          netdev_notify_recvcpu(dev, cpu, conn->domain,
                                 &(conn->u.ipv6.laddr), conn->lport,
                                 &(conn->u.ipv6.raddr), conn->rport);
         }
@@ -86,7 +86,13 @@
     (defined(CONFIG_NET_IGMP) || defined(CONFIG_NET_MLD))
 static void udp_send_loopback(FAR struct net_driver_s *dev)
 {
-  FAR struct iob_s *iob = netdev_iob_clone(dev, true);
+  FAR struct iob_s *iob;
+
+  /* Both copies need the complete checksum */
+
+  netdev_checksum_complete(dev);
+
+  iob = netdev_iob_clone(dev, true);
   if (iob == NULL)
     {
       nerr("ERROR: IOB clone failed when looping UDP.\n");
@@ -250,7 +256,16 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
 #ifdef CONFIG_NET_UDP_CHECKSUMS
       /* Calculate UDP checksum. */
 
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (NETDEV_IS_GSO(dev) || (dev->d_features & NETDEV_TX_CSUM) != 0)
+        {
+          /* Leave the pseudo header sum to the segmentation or the
+           * hardware to complete.
+           */
+
+          udp->udpchksum = netdev_upperlayer_header_checksum(dev);
+          dev->d_txcsum  = true;
+        }
+      else
         {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
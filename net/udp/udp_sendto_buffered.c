@@ -37,6 +37,7 @@
 #endif
 
 #include <sys/types.h>
+#include <sys/param.h>
 #include <sys/socket.h>
 
 #include <stdint.h>
@@ -269,7 +270,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -301,10 +302,25 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
       return -EHOSTUNREACH;
     }
 
+#ifdef CONFIG_NET_UDP_GSO
+  /* The datagrams of a segmented send are never fragmented */
+
+  if (wrb->wb_gsosize > 0 &&
+      udpip_hdrsize(conn) + wrb->wb_gsosize > devif_get_mtu(dev))
+    {
+      nerr("ERROR: Segment too long to send!\n");
+      return -EMSGSIZE;
+    }
+#endif
+
 #ifndef CONFIG_NET_IPFRAG
   /* Sanity check if the packet len (with IP hdr) is greater than the MTU */
 
-  if (wrb->wb_iob->io_pktlen > devif_get_mtu(dev))
+  if (wrb->wb_iob->io_pktlen > devif_get_mtu(dev)
+#ifdef CONFIG_NET_UDP_GSO
+      && wrb->wb_gsosize == 0
+#endif
+     )
     {
       nerr("ERROR: Packet too long to send!\n");
       return -EMSGSIZE;
@@ -366,6 +382,63 @@ out:
   return ret;
 }
 
+/****************************************************************************
+ * Name: sendto_next_datagram
+ *
+ * Description:
+ *   Copy the next datagram of a segmented write buffer into a new I/O
+ *   buffer chain, for the devices that can't take all of the datagrams at
+ *   once.  The write buffer is released when the last datagram is taken.
+ *
+ * Input Parameters:
+ *   conn     - The UDP connection of interest
+ *   wrb      - The write buffer at the head of the write queue
+ *   udpiplen - The size of the IP and UDP headers
+ *
+ * Returned Value:
+ *   The I/O buffer chain of the datagram, NULL if none was available.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GSO
+static FAR struct iob_s *
+sendto_next_datagram(FAR struct udp_conn_s *conn,
+                     FAR struct udp_wrbuffer_s *wrb, uint16_t udpiplen)
+{
+  FAR struct iob_s *iob;
+  unsigned int len;
+
+  len = MIN(wrb->wb_iob->io_pktlen - udpiplen - wrb->wb_offset,
+            wrb->wb_gsosize);
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
+    {
+      return NULL;
+    }
+
+  iob_reserve(iob, CONFIG_NET_LL_GUARDSIZE);
+  if (iob_clone_partial(wrb->wb_iob, len, udpiplen + wrb->wb_offset,
+                        iob, udpiplen, false, false) != OK)
+    {
+      iob_free_chain(iob);
+      return NULL;
+    }
+
+  wrb->wb_offset += len;
+  if (udpiplen + wrb->wb_offset >= wrb->wb_iob->io_pktlen)
+    {
+      sq_remfirst(&conn->write_q);
+      sendto_writebuffer_release(conn, wrb);
+    }
+
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: sendto_eventhandler
  *
@@ -439,7 +512,7 @@ static uint32_t sendto_eventhandler(FAR struct net_driver_s *dev,
   if (dev->d_sndlen <= 0 && (flags & UDP_NEWDATA) == 0 &&
       (flags & UDP_POLL) != 0 && !sq_empty(&conn->write_q))
     {
-      uint16_t udpiplen = udpip_hdrsize(conn);
+      uint16_t udpiplen;
       FAR struct udp_wrbuffer_s *wrb;
 
       /* Peek at the head of the write queue (but don't remove anything
@@ -447,7 +520,7 @@ static uint32_t sendto_eventhandler(FAR struct net_driver_s *dev,
        * the write_q is not empty.
        */
 
-      wrb = (FAR struct udp_wrbuffer_s *)sq_remfirst(&conn->write_q);
+      wrb = (FAR struct udp_wrbuffer_s *)sq_peek(&conn->write_q);
       DEBUGASSERT(wrb != NULL);
 
       /* If the udp socket not connected, it is possible to have
@@ -457,6 +530,39 @@ static uint32_t sendto_eventhandler(FAR struct net_driver_s *dev,
        */
 
       udp_connect(conn, (FAR const struct sockaddr *)&wrb->wb_dest);
+      udpiplen = udpip_hdrsize(conn);
+
+#ifdef CONFIG_NET_UDP_GSO
+      if (wrb->wb_gsosize > 0 &&
+          (dev->d_features & (NETDEV_TX_TSO | NETDEV_TX_GSO)) == 0)
+        {
+          FAR struct iob_s *iob;
+
+          /* The device takes one datagram per poll */
+
+          iob = sendto_next_datagram(conn, wrb, udpiplen);
+          if (iob == NULL)
+            {
+              nwarn("WARNING: No IOB for the next datagram\n");
+              return flags;
+            }
+
+          netdev_iob_replace(dev, iob);
+          dev->d_sndlen = iob->io_pktlen - udpiplen;
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+          sendto_ipselect(dev, conn);
+#endif
+
+          return flags & ~UDP_POLL;
+        }
+
+      /* The large packet is cut into the datagrams by devif_poll_out() */
+
+      dev->d_gsosize = wrb->wb_gsosize;
+#endif
+
+      sq_remfirst(&conn->write_q);
 
       /* Then set-up to send that amount of data with the offset
        * corresponding to the size of the IP-dependent address structure.
@@ -564,9 +670,49 @@ static unsigned int udp_send_gettimeout(clock_t start, unsigned int timeout)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_UDP_GSO
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags,
+                         FAR const struct sockaddr *to, socklen_t tolen)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+
+  return psock_udp_sendto_segment(psock, buf, len, flags, to, tolen,
+                                  conn->gsosize);
+}
+
+/****************************************************************************
+ * Name: psock_udp_sendto_segment
+ *
+ * Description:
+ *   Same as psock_udp_sendto() but the data is sent as the datagrams of
+ *   'gsosize' bytes, the last one may be shorter.  A 'gsosize' of zero
+ *   sends a single datagram.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *   gsosize  The size of the datagrams
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto_segment(FAR struct socket *psock,
+                                 FAR const void *buf, size_t len, int flags,
+                                 FAR const struct sockaddr *to,
+                                 socklen_t tolen, uint16_t gsosize)
+#else
 ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags,
                          FAR const struct sockaddr *to, socklen_t tolen)
+#endif
 {
   FAR struct udp_wrbuffer_s *wrb;
   FAR struct udp_conn_s *conn;
@@ -588,6 +734,19 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EMSGSIZE;
     }
 
+#ifdef CONFIG_NET_UDP_GSO
+  /* Only the data larger than one datagram needs the segmentation */
+
+  if (len <= gsosize)
+    {
+      gsosize = 0;
+    }
+  else if (len > UDP_MAX_SEGMENTS * (size_t)gsosize)
+    {
+      return -EINVAL;
+    }
+#endif
+
   /* If the UDP socket was previously assigned a remote peer address via
    * connect(), then as with connection-mode socket, sendto() may not be
    * used with a non-NULL destination address.  Normally send() would be
@@ -831,6 +990,19 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   udpiplen = udpip_hdrsize(conn);
 
+#ifdef CONFIG_NET_UDP_GSO
+  /* The whole packet still has to fit in the IP length */
+
+  if (gsosize > 0 && len + udpiplen > UINT16_MAX)
+    {
+      ret = -EMSGSIZE;
+      goto errout_with_wrb;
+    }
+
+  wrb->wb_gsosize = gsosize;
+  wrb->wb_offset  = 0;
+#endif
+
   iob_reserve(wrb->wb_iob, CONFIG_NET_LL_GUARDSIZE);
   iob_update_pktlen(wrb->wb_iob, udpiplen, false);
 
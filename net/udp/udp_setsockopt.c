@@ -76,7 +76,67 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
+#if defined(CONFIG_NET_UDP_GSO) || defined(CONFIG_NET_UDP_GRO)
+  FAR struct udp_conn_s *conn;
+  int ret = OK;
+  int val;
+
+  DEBUGASSERT(value != NULL);
+  conn = psock->s_conn;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      nerr("ERROR:  Not a UDP socket\n");
+      return -ENOTCONN;
+    }
+
+  if (value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  val = *(FAR const int *)value;
+
+  conn_lock(&conn->sconn);
+  switch (option)
+    {
+#ifdef CONFIG_NET_UDP_GSO
+      case UDP_SEGMENT: /* Send the data as the datagrams of this size */
+        if (val < 0 || val > UINT16_MAX)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            conn->gsosize = val;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP_GRO
+      case UDP_GRO: /* Coalesce the received datagrams */
+        if (val)
+          {
+            conn->flags |= _UDP_FLAG_GRO;
+          }
+        else
+          {
+            conn->flags &= ~_UDP_FLAG_GRO;
+          }
+        break;
+#endif
+
+      default:
+        nerr("ERROR: Unrecognized UDP option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  conn_unlock(&conn->sconn);
+  return ret;
+#else
   return -ENOPROTOOPT;
+#endif
 }
 
 #endif /* CONFIG_NET_UDPPROTO_OPTIONS */
@@ -544,70 +544,98 @@ ssize_t usrsock_response(FAR const char *buffer, size_t len,
   FAR struct usrsock_req_s *req = &g_usrsock_req;
   FAR struct usrsock_conn_s *conn;
   size_t origlen = len;
-  int ret = 0;
+  ssize_t ret = 0;
 
-  if (!req->datain_conn)
-    {
-      /* Start of message, buffer length should be at least size of common
-       * message header.
-       */
+  /* The buffer may carry several messages back to back (e.g. a response
+   * followed by the events batched behind it), so keep handling them
+   * until the buffer is consumed.
+   */
 
-      if (len < sizeof(struct usrsock_message_common_s))
+  do
+    {
+      if (!req->datain_conn)
         {
-          nerr("message too short, %zu < %zu.\n", len,
-               sizeof(struct usrsock_message_common_s));
-          return -EINVAL;
-        }
+          /* Start of message, buffer length should be at least size of
+           * common message header.
+           */
 
-      /* Handle message. */
+          if (len < sizeof(struct usrsock_message_common_s))
+            {
+              if (len != origlen)
+                {
+                  break;
+                }
+
+              nerr("message too short, %zu < %zu.\n", len,
+                   sizeof(struct usrsock_message_common_s));
+              return -EINVAL;
+            }
+
+          /* Handle message. */
+
+          ret = usrsock_handle_message(buffer, len, req_done);
+          if (ret < 0)
+            {
+              break;
+            }
 
-      ret = usrsock_handle_message(buffer, len, req_done);
-      if (ret >= 0)
-        {
           buffer += ret;
           len -= ret;
-          ret = origlen - len;
         }
-    }
 
-  if (req->datain_conn)
-    {
-      conn = req->datain_conn;
+      if (req->datain_conn)
+        {
+          conn = req->datain_conn;
 
-      /* Copy data from user-space. */
+          /* Copy data from user-space. */
 
-      if (len != 0)
-        {
-          ret = usrsock_iovec_put(conn->resp.datain.iov,
-                                  conn->resp.datain.iovcnt,
-                                  conn->resp.datain.pos, buffer, len);
-          if (ret < 0)
+          if (len != 0)
             {
-              /* Tried writing beyond buffer. */
+              ret = usrsock_iovec_put(conn->resp.datain.iov,
+                                      conn->resp.datain.iovcnt,
+                                      conn->resp.datain.pos, buffer, len);
+              if (ret < 0)
+                {
+                  /* Tried writing beyond buffer. */
+
+                  conn->resp.result = ret;
+                  conn->resp.datain.pos = conn->resp.datain.total;
+                }
+              else
+                {
+                  conn->resp.datain.pos += ret;
+                  buffer += ret;
+                  len -= ret;
+                }
+            }
+
+          if (conn->resp.datain.pos == conn->resp.datain.total)
+            {
+              req->datain_conn = NULL;
 
-              conn->resp.result = ret;
-              conn->resp.datain.pos = conn->resp.datain.total;
+              /* Done with data response. */
+
+              usrsock_event(conn);
             }
-          else
+
+          if (ret < 0)
             {
-              conn->resp.datain.pos += ret;
-              buffer += ret;
-              len -= ret;
-              ret = origlen - len;
+              break;
             }
         }
+    }
+  while (len > 0);
 
-      if (conn->resp.datain.pos == conn->resp.datain.total)
-        {
-          req->datain_conn = NULL;
-
-          /* Done with data response. */
+  /* Report an error only if nothing could be consumed, otherwise let the
+   * caller retry with the remaining bytes.
+   */
 
-          usrsock_event(conn);
-        }
+  if (ret < 0 && len == origlen)
+    {
+      return ret;
     }
 
-  return ret;
+  return origlen - len;
 }
 
 /****************************************************************************
@@ -648,6 +676,32 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
 
   req_head = iov[0].iov_base;
 
+#ifdef CONFIG_NET_USRSOCK_PIPELINE
+  /* The transport copies the whole request before returning and the
+   * completion is reported through USRSOCK_EVENT_REQ_COMPLETE of the
+   * connection, so there is no need to hold the request line until the
+   * daemon acknowledges it.  usrsock_lock() held by the caller keeps the
+   * transaction id and the request frames in order.
+   */
+
+  if (++req->newxid == 0)
+    {
+      ++req->newxid;
+    }
+
+  req_head->xid = req->newxid;
+
+  /* Prepare connection for response. */
+
+  conn->resp.xid = req_head->xid;
+  conn->resp.result = -EACCES;
+
+  ret = usrsock_request(iov, iovcnt);
+  if (ret < 0)
+    {
+      nerr("error: usrsock request failed with %d\n", ret);
+    }
+#else
   /* Set outstanding request for daemon to handle. */
 
   usrsock_mutex_timedlock(&req->lock, UINT_MAX);
@@ -682,6 +736,8 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
   /* Free request line for next command. */
 
   nxmutex_unlock(&req->lock);
+#endif
+
   return ret;
 }
 
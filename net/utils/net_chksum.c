@@ -29,6 +29,22 @@
 
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The value of a 16-bit word in the CPU byte order with 'b' as its first or
+ * its second byte in memory and zero as the other one.
+ */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b) << 8)
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b))
+#else
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b))
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b) << 8)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -57,56 +73,38 @@
 uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
                     uint16_t len, bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  uint32_t res;
 
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  if (*odd == true)
+  if (len == 0)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 1;
+      return sum;
     }
 
-  while (dataptr < last_byte)
-    {
-      /* At least two more bytes */
-
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  /* The one's complement sum doesn't depend on the byte order (RFC1071),
+   * so sum the words in the CPU byte order and swap the result.
+   */
 
-      dataptr += 2;
-    }
+  res = net_chksum_partial(0, data, len);
+  res = (res & 0xffff) + (res >> 16);
+  res = (res & 0xffff) + (res >> 16);
+  res = NTOHS((uint16_t)res);
 
-  *odd = false;
+  /* The data starts at the second byte of a word if the previous call
+   * ended with an odd byte, which shifts all of the words by one byte.
+   */
 
-  if (dataptr == last_byte)
+  if (*odd)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      *odd = true;
+      res = ((res & 0xff) << 8) | (res >> 8);
     }
 
+  *odd ^= (len & 1) != 0;
+
   /* Return sum in host byte order. */
 
-  return sum;
+  res += sum;
+  res = (res & 0xffff) + (res >> 16);
+  return (uint16_t)res;
 }
 
 /****************************************************************************
@@ -141,6 +139,106 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
+/****************************************************************************
+ * Name: net_chksum_partial
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer in the CPU byte order to a 32-bit one's
+ *   complement sum.  The trailing odd byte is taken as the first byte of a
+ *   word padded with zero.
+ *
+ *   If CONFIG_LIBC_ARCH_NET_CHKSUM is defined, then this function must be
+ *   provided by architecture-specific logic.
+ *
+ * Input Parameters:
+ *   sum  - The partial sum carried over from a previous call
+ *   data - Beginning of the data to add, there is no alignment requirement
+ *   len  - Length of the data to add
+ *
+ * Returned Value:
+ *   The updated sum, which still has to be folded to 16 bits.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_LIBC_ARCH_NET_CHKSUM
+uint32_t net_chksum_partial(uint32_t sum, FAR const void *data, size_t len)
+{
+  FAR const uint8_t *ptr = data;
+  uint64_t acc = 0;
+  uint32_t res;
+  bool odd;
+
+  if (len == 0)
+    {
+      return sum;
+    }
+
+  /* Sum the aligned words from an even address, the result is swapped at
+   * the end if the words were shifted by one byte for that.
+   */
+
+  odd = ((uintptr_t)ptr & 1) != 0;
+  if (odd)
+    {
+      acc = CHKSUM_BYTE1(*ptr++);
+      len--;
+    }
+
+  if (((uintptr_t)ptr & 2) != 0 && len >= 2)
+    {
+      acc += *(FAR const uint16_t *)ptr;
+      ptr += 2;
+      len -= 2;
+    }
+
+  /* Add 32-bit words into the 64-bit accumulator and fold the carries
+   * once at the end, instead of one carry test per 16-bit word.
+   */
+
+  while (len >= 16)
+    {
+      FAR const uint32_t *ptr32 = (FAR const uint32_t *)ptr;
+
+      acc += (uint64_t)ptr32[0] + ptr32[1] + ptr32[2] + ptr32[3];
+      ptr += 16;
+      len -= 16;
+    }
+
+  while (len >= 4)
+    {
+      acc += *(FAR const uint32_t *)ptr;
+      ptr += 4;
+      len -= 4;
+    }
+
+  if (len >= 2)
+    {
+      acc += *(FAR const uint16_t *)ptr;
+      ptr += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc += CHKSUM_BYTE0(*ptr);
+    }
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  res = (uint32_t)acc;
+  res = (res & 0xffff) + (res >> 16);
+  res = (res & 0xffff) + (res >> 16);
+
+  if (odd)
+    {
+      res = ((res & 0xff) << 8) | (res >> 8);
+    }
+
+  sum += res;
+  return sum < res ? sum + 1 : sum;
+}
+#endif /* CONFIG_LIBC_ARCH_NET_CHKSUM */
+
 /****************************************************************************
  * Name: chksum_iob
  *
@@ -86,3 +86,39 @@ FAR void *cmsg_append(FAR struct msghdr *msg, int level, int type,
 
   return cmsgdata;
 }
+
+/****************************************************************************
+ * Name: cmsg_find
+ *
+ * Description:
+ *   Find the control message of the given level and type sent with the
+ *   message.
+ *
+ * Input Parameters:
+ *   msg       - The message sent.
+ *   level     - The level of control message.
+ *   type      - The type of control message.
+ *   value_len - The least value length of control message.
+ *
+ * Returned Value:
+ *   On success, a pointer to the start address of control message data.
+ *   NULL if there is no such control message, or it is too short.
+ *
+ ****************************************************************************/
+
+FAR void *cmsg_find(FAR const struct msghdr *msg, int level, int type,
+                    int value_len)
+{
+  FAR struct cmsghdr *cmsg;
+
+  for_each_cmsghdr(cmsg, msg)
+    {
+      if (CMSG_OK(msg, cmsg) && cmsg->cmsg_level == level &&
+          cmsg->cmsg_type == type && cmsg->cmsg_len >= CMSG_LEN(value_len))
+        {
+          return CMSG_DATA(cmsg);
+        }
+    }
+
+  return NULL;
+}
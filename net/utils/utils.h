@@ -670,6 +670,28 @@ uint16_t icmpv6_chksum(FAR struct net_driver_s *dev, unsigned int iplen);
 FAR void *cmsg_append(FAR struct msghdr *msg, int level, int type,
                       FAR void *value, int value_len);
 
+/****************************************************************************
+ * Name: cmsg_find
+ *
+ * Description:
+ *   Find the control message of the given level and type sent with the
+ *   message.
+ *
+ * Input Parameters:
+ *   msg       - The message sent.
+ *   level     - The level of control message.
+ *   type      - The type of control message.
+ *   value_len - The least value length of control message.
+ *
+ * Returned Value:
+ *   On success, a pointer to the start address of control message data.
+ *   NULL if there is no such control message, or it is too short.
+ *
+ ****************************************************************************/
+
+FAR void *cmsg_find(FAR const struct msghdr *msg, int level, int type,
+                    int value_len);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
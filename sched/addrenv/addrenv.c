@@ -28,10 +28,14 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
 
 #include <nuttx/addrenv.h>
+#include <nuttx/arch.h>
 #include <nuttx/atomic.h>
 #include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/pgalloc.h>
 #include <nuttx/sched.h>
 #include <nuttx/wqueue.h>
 
@@ -81,6 +85,17 @@ static void addrenv_destroy(FAR void *arg)
 {
   FAR struct addrenv_s *addrenv = (FAR struct addrenv_s *)arg;
 
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+  /* Unmap the shared text first, it is not ours to free */
+
+  if (addrenv->text != NULL)
+    {
+      up_addrenv_text_unshare(&addrenv->addrenv, addrenv->text->pages,
+                              addrenv->text->npages);
+      addrenv_text_release(addrenv->text);
+    }
+#endif
+
   /* Destroy the address environment */
 
   up_addrenv_destroy(&addrenv->addrenv);
@@ -461,3 +476,135 @@ void addrenv_drop(FAR struct addrenv_s *addrenv, bool deferred)
         }
     }
 }
+
+#ifdef CONFIG_ARCH_ADDRENV_SHARED_TEXT
+
+/****************************************************************************
+ * Name: addrenv_text_create
+ *
+ * Description:
+ *   Make the text pages of a freshly loaded address environment shareable.
+ *   The returned object holds one reference for the address environment and
+ *   one for the caller.
+ *
+ * Input Parameters:
+ *   addrenv  - The address environment holding the loaded text.
+ *   textsize - The size of the text region in bytes.
+ *
+ * Returned Value:
+ *   The shared text on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct addrenv_text_s *addrenv_text_create(FAR struct addrenv_s *addrenv,
+                                               size_t textsize)
+{
+  FAR struct addrenv_text_s *text;
+  uintptr_t vtext;
+  unsigned int npages;
+  unsigned int i;
+
+  DEBUGASSERT(addrenv != NULL && addrenv->text == NULL);
+
+  npages = MM_NPAGES(textsize);
+  if (npages == 0 || up_addrenv_vtext(&addrenv->addrenv,
+                                      (FAR void **)&vtext) < 0)
+    {
+      return NULL;
+    }
+
+  text = kmm_malloc(sizeof(struct addrenv_text_s) +
+                    (npages - 1) * sizeof(uintptr_t));
+  if (text == NULL)
+    {
+      return NULL;
+    }
+
+  for (i = 0; i < npages; i++)
+    {
+      text->pages[i] = up_addrenv_find_page(&addrenv->addrenv,
+                                            vtext + i * MM_PGSIZE);
+      if (text->pages[i] == 0)
+        {
+          kmm_free(text);
+          return NULL;
+        }
+    }
+
+  text->npages = npages;
+  atomic_set(&text->refs, 2);
+  addrenv->text = text;
+  return text;
+}
+
+/****************************************************************************
+ * Name: addrenv_text_attach
+ *
+ * Description:
+ *   Map shared text pages into an address environment in place of its own
+ *   text pages, taking a reference to the shared text.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment.
+ *   text    - The shared text.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int addrenv_text_attach(FAR struct addrenv_s *addrenv,
+                        FAR struct addrenv_text_s *text)
+{
+  int ret;
+
+  DEBUGASSERT(addrenv != NULL && addrenv->text == NULL && text != NULL);
+
+  /* Take the reference first, the pages already shared are unmapped again
+   * when the address environment is destroyed, even after a failure.
+   */
+
+  atomic_fetch_add(&text->refs, 1);
+  addrenv->text = text;
+
+  ret = up_addrenv_text_share(&addrenv->addrenv, text->pages, text->npages);
+  if (ret < 0)
+    {
+      berr("ERROR: up_addrenv_text_share failed: %d\n", ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: addrenv_text_release
+ *
+ * Description:
+ *   Release a reference to shared text, freeing the pages with the last
+ *   one.
+ *
+ * Input Parameters:
+ *   text - The shared text.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void addrenv_text_release(FAR struct addrenv_text_s *text)
+{
+  unsigned int i;
+
+  if (atomic_fetch_sub(&text->refs, 1) == 1)
+    {
+      for (i = 0; i < text->npages; i++)
+        {
+          mm_pgfree(text->pages[i], 1);
+        }
+
+      kmm_free(text);
+    }
+}
+
+#endif /* CONFIG_ARCH_ADDRENV_SHARED_TEXT */
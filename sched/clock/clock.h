@@ -82,4 +82,12 @@ clock_t clock_get_sched_ticks(void);
 void cpuload_init(void);
 #endif
 
+#ifdef CONFIG_CLOCK_VDSO
+void clock_vdso_initialize(void);
+void clock_vdso_update(void);
+#else
+#  define clock_vdso_initialize()
+#  define clock_vdso_update()
+#endif
+
 #endif /* __SCHED_CLOCK_CLOCK_H */
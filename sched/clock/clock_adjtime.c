@@ -41,6 +41,9 @@
 #include <nuttx/timers/ptp_clock.h>
 
 #include "clock/clock.h"
+#ifdef CONFIG_CLOCK_TIMEKEEPING
+#  include "clock/clock_timekeeping.h"
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -68,7 +71,9 @@ static void adjtime_wdog_callback(wdparm_t arg)
 
   flags = spin_lock_irqsave(&g_adjtime_lock);
 
-#ifdef CONFIG_ARCH_HAVE_ADJTIME
+#if defined(CONFIG_CLOCK_TIMEKEEPING)
+  clock_timekeeping_set_rate(0);
+#elif defined(CONFIG_ARCH_HAVE_ADJTIME)
   up_adjtime(0);
 #endif
 
@@ -123,7 +128,13 @@ static int adjtime_start(long long adjust_usec)
 
   g_adjtime_ppb = ppb;
 
-#ifdef CONFIG_ARCH_HAVE_ADJTIME
+#if defined(CONFIG_CLOCK_TIMEKEEPING)
+  /* Slew the wall time through the timekeeping multiplier rather than
+   * the timer period, so readers see the adjustment without locking.
+   */
+
+  clock_timekeeping_set_rate(g_adjtime_ppb);
+#elif defined(CONFIG_ARCH_HAVE_ADJTIME)
   up_adjtime(g_adjtime_ppb);
 #endif
 
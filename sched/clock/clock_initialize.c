@@ -231,6 +231,10 @@ void clock_initialize(void)
   cpuload_init();
 #endif
 
+  /* Publish the timekeeping state to user space */
+
+  clock_vdso_initialize();
+
   sched_trace_end();
 }
 
@@ -372,6 +376,7 @@ void clock_resynchronize(FAR struct timespec *rtc_diff)
                            NSEC2TICK(rtc_diff->tv_nsec);
 
       clock_increase_sched_ticks(diff_ticks);
+      clock_vdso_update();
     }
 }
 #endif
@@ -92,6 +92,8 @@ static void nxclock_set_realtime(FAR const struct timespec *tp)
 #else
   clock_timekeeping_set_wall_time(tp);
 #endif
+
+  clock_vdso_update();
 }
 
 /****************************************************************************
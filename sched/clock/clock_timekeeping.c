@@ -30,74 +30,125 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <time.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/seqlock.h>
 
 #include "clock/clock.h"
+#include "clock/clock_timekeeping.h"
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define NTP_MAX_ADJUST 500
+/* Maximum slew applied by adjtime(), in microseconds per second */
+
+#define NTP_MAX_ADJUST     500
+
+/* The multiplier converts counter ticks to nanoseconds in units of
+ * 2^-CLOCK_MULT_SHIFT ns, so rate adjustments finer than 1 ns per tick can
+ * be represented.
+ */
+
+#define CLOCK_MULT_SHIFT   16
+#define CLOCK_MULT_NOMINAL ((uint64_t)NSEC_PER_TICK << CLOCK_MULT_SHIFT)
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+/* The wall time is advanced from the counter on every tick.  Readers take
+ * no lock: they sample the state under g_clock_seq and retry if an update
+ * raced with them.  g_clock_mult carries the current slew rate, so time is
+ * adjusted continuously instead of in steps.
+ */
+
+static seqcount_t      g_clock_seq;
 static struct timespec g_clock_wall_time;
-static uint64_t        g_clock_last_counter;
-static uint64_t        g_clock_mask;
-static long            g_clock_adjust;
-static spinlock_t      g_clock_lock = SP_UNLOCKED;
+static clock_t         g_clock_last_counter;
+static clock_t         g_clock_mask;
+static uint64_t        g_clock_mult = CLOCK_MULT_NOMINAL;
+static uint64_t        g_clock_frac;
+
+#ifndef CONFIG_CLOCK_ADJTIME
+/* Remaining adjtime() correction in nanoseconds */
+
+static int64_t         g_clock_adjust;
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: clock_get_current_time
+ * Name: clock_rate2mult
+ *
+ * Description:
+ *   Return the multiplier that runs the clock 'ppb' parts per billion fast
+ *   (or slow if negative).
+ *
  ****************************************************************************/
 
-static int clock_get_current_time(FAR struct timespec *ts,
-                                  FAR struct timespec *base)
+static uint64_t clock_rate2mult(long ppb)
 {
-  irqstate_t flags;
-  uint64_t counter;
-  uint64_t offset;
-  uint64_t nsec;
-  time_t sec;
-  int ret;
+  return CLOCK_MULT_NOMINAL +
+         (int64_t)CLOCK_MULT_NOMINAL / NSEC_PER_USEC * ppb / USEC_PER_SEC;
+}
 
-  flags = spin_lock_irqsave(&g_clock_lock);
+/****************************************************************************
+ * Name: clock_timespec_addns
+ ****************************************************************************/
 
-  ret = up_timer_gettick(&counter);
-  if (ret < 0)
+static void clock_timespec_addns(FAR struct timespec *ts, int64_t nsec)
+{
+  nsec += ts->tv_nsec;
+  ts->tv_sec += nsec / NSEC_PER_SEC;
+  nsec %= NSEC_PER_SEC;
+
+  if (nsec < 0)
     {
-      goto errout_in_critical_section;
+      nsec += NSEC_PER_SEC;
+      ts->tv_sec--;
     }
 
-  offset = (counter - g_clock_last_counter) & g_clock_mask;
-  nsec   = offset * NSEC_PER_TICK;
-  sec    = nsec   / NSEC_PER_SEC;
-  nsec  -= sec    * NSEC_PER_SEC;
+  ts->tv_nsec = (long)nsec;
+}
+
+/****************************************************************************
+ * Name: clock_get_current_time
+ ****************************************************************************/
+
+static int clock_get_current_time(FAR struct timespec *ts,
+                                  FAR const struct timespec *base)
+{
+  clock_t counter;
+  clock_t offset;
+  uint64_t frac;
+  uint32_t start;
+  int ret;
 
-  nsec  += base->tv_nsec;
-  if (nsec >= NSEC_PER_SEC)
+  do
     {
-      nsec -= NSEC_PER_SEC;
-      sec  += 1;
-    }
+      start = read_seqbegin(&g_clock_seq);
+
+      ret = up_timer_gettick(&counter);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
-  ts->tv_nsec = nsec;
-  ts->tv_sec = base->tv_sec + sec;
+      *ts    = *base;
+      offset = (counter - g_clock_last_counter) & g_clock_mask;
+      frac   = (uint64_t)offset * g_clock_mult + g_clock_frac;
+    }
+  while (read_seqretry(&g_clock_seq, start));
 
-errout_in_critical_section:
-  spin_unlock_irqrestore(&g_clock_lock, flags);
+  clock_timespec_addns(ts, frac >> CLOCK_MULT_SHIFT);
   return ret;
 }
 
@@ -121,10 +172,10 @@ int clock_timekeeping_get_wall_time(FAR struct timespec *ts)
 int clock_timekeeping_set_wall_time(FAR const struct timespec *ts)
 {
   irqstate_t flags;
-  uint64_t counter;
+  clock_t counter;
   int ret;
 
-  flags = spin_lock_irqsave(&g_clock_lock);
+  flags = write_seqlock_irqsave(&g_clock_seq);
 
   ret = up_timer_gettick(&counter);
   if (ret < 0)
@@ -134,14 +185,40 @@ int clock_timekeeping_set_wall_time(FAR const struct timespec *ts)
 
   memcpy(&g_clock_wall_time, ts, sizeof(struct timespec));
 
+#ifndef CONFIG_CLOCK_ADJTIME
   g_clock_adjust       = 0;
+  g_clock_mult         = CLOCK_MULT_NOMINAL;
+#endif
+  g_clock_frac         = 0;
   g_clock_last_counter = counter;
 
 errout_in_critical_section:
-  spin_unlock_irqrestore(&g_clock_lock, flags);
+  write_sequnlock_irqrestore(&g_clock_seq, flags);
   return ret;
 }
 
+#ifdef CONFIG_CLOCK_ADJTIME
+/****************************************************************************
+ * Name: clock_timekeeping_set_rate
+ *
+ * Description:
+ *   Run the wall time 'ppb' parts per billion fast (or slow if negative).
+ *   Used by adjtime() to slew the clock; zero restores the nominal rate.
+ *   Time accumulated so far is folded in at the old rate first.
+ *
+ ****************************************************************************/
+
+void clock_timekeeping_set_rate(long ppb)
+{
+  irqstate_t flags;
+
+  clock_update_wall_time();
+
+  flags = write_seqlock_irqsave(&g_clock_seq);
+  g_clock_mult = clock_rate2mult(ppb);
+  write_sequnlock_irqrestore(&g_clock_seq, flags);
+}
+#else
 /****************************************************************************
  * Name: adjtime
  *
@@ -181,7 +258,7 @@ errout_in_critical_section:
 int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
 {
   irqstate_t flags;
-  long adjust_usec;
+  int64_t adjust;
 
   if (!delta)
     {
@@ -189,21 +266,30 @@ int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
       return -1;
     }
 
-  flags = spin_lock_irqsave(&g_clock_lock);
+  /* Fold in the time elapsed at the old rate before changing it */
 
-  adjust_usec = delta->tv_sec * USEC_PER_SEC + delta->tv_usec;
+  clock_update_wall_time();
+
+  adjust = ((int64_t)delta->tv_sec * USEC_PER_SEC + delta->tv_usec) *
+           NSEC_PER_USEC;
+
+  flags = write_seqlock_irqsave(&g_clock_seq);
 
   if (olddelta)
     {
-      olddelta->tv_usec = g_clock_adjust;
+      olddelta->tv_sec  = g_clock_adjust / NSEC_PER_SEC;
+      olddelta->tv_usec = g_clock_adjust % NSEC_PER_SEC / NSEC_PER_USEC;
     }
 
-  g_clock_adjust = adjust_usec;
+  g_clock_adjust = adjust;
+  g_clock_mult   = clock_rate2mult(adjust > 0 ?  NTP_MAX_ADJUST * 1000 :
+                                   adjust < 0 ? -NTP_MAX_ADJUST * 1000 : 0);
 
-  spin_unlock_irqrestore(&g_clock_lock, flags);
+  write_sequnlock_irqrestore(&g_clock_seq, flags);
 
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: clock_update_wall_time
@@ -212,13 +298,13 @@ int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
 void clock_update_wall_time(void)
 {
   irqstate_t flags;
-  uint64_t counter;
-  uint64_t offset;
+  clock_t counter;
+  clock_t offset;
+  uint64_t frac;
   int64_t nsec;
-  time_t sec;
   int ret;
 
-  flags = spin_lock_irqsave(&g_clock_lock);
+  flags = write_seqlock_irqsave(&g_clock_seq);
 
   ret = up_timer_gettick(&counter);
   if (ret < 0)
@@ -232,47 +318,36 @@ void clock_update_wall_time(void)
       goto errout_in_critical_section;
     }
 
-  nsec  = offset * NSEC_PER_TICK;
-  sec   = nsec / NSEC_PER_SEC;
-  nsec -= sec * NSEC_PER_SEC;
-
-  nsec += g_clock_wall_time.tv_nsec;
-  if (nsec >= NSEC_PER_SEC)
-    {
-      nsec -= NSEC_PER_SEC;
-      sec  += 1;
-    }
+  frac = (uint64_t)offset * g_clock_mult + g_clock_frac;
+  nsec = frac >> CLOCK_MULT_SHIFT;
 
-  if (g_clock_adjust != 0 && sec > 0)
+#ifndef CONFIG_CLOCK_ADJTIME
+  if (g_clock_adjust != 0)
     {
-      long adjust = NTP_MAX_ADJUST * (long)sec;
-      if (g_clock_adjust < adjust && g_clock_adjust > -adjust)
-        {
-          adjust = g_clock_adjust;
-        }
+      /* Account for the slew included at the current rate, and stop
+       * slewing once the requested correction has been applied.
+       */
 
-      nsec += adjust * NSEC_PER_USEC;
-
-      while (nsec < 0)
-        {
-          nsec += NSEC_PER_SEC;
-          sec  -= 1;
-        }
+      int64_t slew = nsec - (int64_t)((uint64_t)offset * NSEC_PER_TICK);
 
-      while (nsec >= NSEC_PER_SEC)
+      g_clock_adjust -= slew;
+      if ((slew > 0 && g_clock_adjust <= 0) ||
+          (slew < 0 && g_clock_adjust >= 0))
         {
-          nsec -= NSEC_PER_SEC;
-          sec  += 1;
+          nsec          += g_clock_adjust;
+          g_clock_adjust = 0;
+          g_clock_mult   = CLOCK_MULT_NOMINAL;
         }
     }
+#endif
 
-  g_clock_wall_time.tv_sec += sec;
-  g_clock_wall_time.tv_nsec = (long)nsec;
+  clock_timespec_addns(&g_clock_wall_time, nsec);
 
+  g_clock_frac         = frac & ((1 << CLOCK_MULT_SHIFT) - 1);
   g_clock_last_counter = counter;
 
 errout_in_critical_section:
-  spin_unlock_irqrestore(&g_clock_lock, flags);
+  write_sequnlock_irqrestore(&g_clock_seq, flags);
 }
 
 /****************************************************************************
@@ -283,7 +358,7 @@ void clock_inittimekeeping(FAR const struct timespec *tp)
 {
   irqstate_t flags;
 
-  flags = spin_lock_irqsave(&g_clock_lock);
+  flags = write_seqlock_irqsave(&g_clock_seq);
   up_timer_getmask(&g_clock_mask);
 
   if (tp)
@@ -295,8 +370,9 @@ void clock_inittimekeeping(FAR const struct timespec *tp)
       clock_basetime(&g_clock_wall_time);
     }
 
+  g_clock_frac = 0;
   up_timer_gettick(&g_clock_last_counter);
-  spin_unlock_irqrestore(&g_clock_lock, flags);
+  write_sequnlock_irqrestore(&g_clock_seq, flags);
 }
 
 #endif /* CONFIG_CLOCK_TIMEKEEPING */
@@ -43,6 +43,10 @@ int clock_timekeeping_set_wall_time(FAR const struct timespec *ts);
 
 void clock_update_wall_time(void);
 
+#ifdef CONFIG_CLOCK_ADJTIME
+void clock_timekeeping_set_rate(long ppb);
+#endif
+
 void clock_inittimekeeping(FAR const struct timespec *tp);
 
 #endif /* __SCHED_CLOCK_CLOCK_TIMEKEEPING_H */
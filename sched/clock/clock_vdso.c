@@ -0,0 +1,179 @@
+/****************************************************************************
+ * sched/clock/clock_vdso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/clock_vdso.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/seqlock.h>
+
+#include "clock/clock.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The snapshot is allocated from the user heap so that user space can read
+ * it directly.
+ */
+
+static FAR struct clock_vdso_s *g_clock_vdso;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_snapshot
+ *
+ * Description:
+ *   Capture the current time into the snapshot.  Must be called with the
+ *   sequence count held for writing.
+ *
+ ****************************************************************************/
+
+static void clock_vdso_snapshot(FAR struct clock_vdso_s *vdso)
+{
+  if (vdso->counter != NULL)
+    {
+      vdso->cycle_last = *vdso->counter;
+    }
+
+  clock_ticks2time(&vdso->monotonic, clock_get_sched_ticks());
+  nxclock_gettime(CLOCK_REALTIME, &vdso->realtime);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_initialize
+ *
+ * Description:
+ *   Allocate and publish the initial timekeeping snapshot.
+ *
+ ****************************************************************************/
+
+void clock_vdso_initialize(void)
+{
+  FAR struct clock_vdso_s *vdso;
+
+  vdso = kumm_zalloc(sizeof(struct clock_vdso_s));
+  if (vdso != NULL)
+    {
+      seqlock_init(&vdso->seq);
+      clock_vdso_snapshot(vdso);
+      g_clock_vdso = vdso;
+    }
+}
+
+/****************************************************************************
+ * Name: clock_vdso_update
+ *
+ * Description:
+ *   Refresh the timekeeping snapshot.  Called on every system tick and
+ *   whenever the time of day changes.
+ *
+ ****************************************************************************/
+
+void clock_vdso_update(void)
+{
+  FAR struct clock_vdso_s *vdso = g_clock_vdso;
+  irqstate_t flags;
+
+  if (vdso != NULL)
+    {
+      flags = write_seqlock_irqsave(&vdso->seq);
+      clock_vdso_snapshot(vdso);
+      write_sequnlock_irqrestore(&vdso->seq, flags);
+    }
+}
+
+/****************************************************************************
+ * Name: clock_vdso_counter
+ *
+ * Description:
+ *   Register a free running 32-bit up counter that user space is permitted
+ *   to read.
+ *
+ ****************************************************************************/
+
+void clock_vdso_counter(FAR const volatile uint32_t *counter, uint32_t freq)
+{
+  FAR struct clock_vdso_s *vdso = g_clock_vdso;
+  irqstate_t flags;
+  uint64_t mult = 0;
+  uint32_t shift;
+
+  if (vdso == NULL)
+    {
+      return;
+    }
+
+  /* Pick the largest shift whose multiplier still fits in 32 bits so that
+   * the conversion keeps as much precision as possible.
+   */
+
+  for (shift = 32; counter != NULL && freq != 0 && shift > 0; shift--)
+    {
+      mult = ((uint64_t)NSEC_PER_SEC << shift) / freq;
+      if (mult <= UINT32_MAX)
+        {
+          break;
+        }
+    }
+
+  if (mult > UINT32_MAX || freq == 0)
+    {
+      counter = NULL;
+      mult    = 0;
+    }
+
+  flags = write_seqlock_irqsave(&vdso->seq);
+  vdso->counter = counter;
+  vdso->mult    = (uint32_t)mult;
+  vdso->shift   = shift;
+  clock_vdso_snapshot(vdso);
+  write_sequnlock_irqrestore(&vdso->seq, flags);
+}
+
+/****************************************************************************
+ * Name: nxclock_vdso
+ *
+ * Description:
+ *   Return the address of the timekeeping snapshot.
+ *
+ ****************************************************************************/
+
+FAR const struct clock_vdso_s *nxclock_vdso(void)
+{
+  return g_clock_vdso;
+}
@@ -66,8 +66,10 @@
 int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
 {
   FAR char **envp = NULL;
+  FAR char *blk = NULL;
   size_t envc = 0;
   size_t size;
+  size_t i;
   int ret = OK;
 
   DEBUGASSERT(group != NULL);
@@ -82,10 +84,12 @@ int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
 
       nxrmutex_lock(&group->tg_mutex);
 
-      /* Count the strings */
+      /* Count the strings and their total size */
 
+      size = 0;
       while (envcp[envc] != NULL)
         {
+          size += strlen(envcp[envc]) + 1;
           envc++;
         }
 
@@ -99,42 +103,47 @@ int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
 
       if (envc > 0)
         {
-          /* There is an environment, duplicate it */
+          /* There is an environment, duplicate it.  All strings go into
+           * one allocation, which keeps spawning cheap.
+           */
 
           envp = group_malloc(group, sizeof(*envp) * group->tg_envpc);
-          if (envp == NULL)
+          blk  = group_malloc(group, size);
+          if (envp == NULL || blk == NULL)
             {
               /* The parent's environment can not be inherited due to a
                * failure in the allocation of the child environment.
                */
 
+              if (envp != NULL)
+                {
+                  group_free(group, envp);
+                  envp = NULL;
+                }
+
+              if (blk != NULL)
+                {
+                  group_free(group, blk);
+                }
+
               ret = -ENOMEM;
             }
           else
             {
-              envp[envc] = NULL;
+              group->tg_envblk    = blk;
+              group->tg_envblklen = size;
 
               /* Duplicate the parent environment. */
 
-              while (envc-- > 0)
+              for (i = 0; i < envc; i++)
                 {
-                  size = strlen(envcp[envc]) + 1;
-                  envp[envc] = group_malloc(group, size);
-                  if (envp[envc] == NULL)
-                    {
-                      while (envp[++envc] != NULL)
-                        {
-                          group_free(group, envp[envc]);
-                        }
-
-                      group_free(group, envp);
-                      envp = NULL;
-                      ret = -ENOMEM;
-                      break;
-                    }
-
-                  strlcpy(envp[envc], envcp[envc], size);
+                  size = strlen(envcp[i]) + 1;
+                  memcpy(blk, envcp[i], size);
+                  envp[i] = blk;
+                  blk += size;
                 }
+
+              envp[envc] = NULL;
             }
         }
 
@@ -67,7 +67,7 @@ void env_removevar(FAR struct task_group_s *group, ssize_t index)
 
   /* Free the allocate environment string */
 
-  group_free(group, group->tg_envp[index]);
+  env_freevar(group, group->tg_envp[index]);
 
   /* Exchange the last env and the index env */
 
@@ -41,6 +41,22 @@
 
 #  define SCHED_ENVIRON_RESERVED (4)
 
+/* The strings inherited by env_dup() share one allocation, which is only
+ * freed by env_release().  Individual strings must be freed with
+ * env_freevar() to skip those.
+ */
+
+#  define env_freevar(group, var) \
+     do \
+       { \
+         if ((uintptr_t)(var) - (uintptr_t)(group)->tg_envblk >= \
+             (group)->tg_envblklen) \
+           { \
+             group_free(group, var); \
+           } \
+       } \
+     while (0)
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
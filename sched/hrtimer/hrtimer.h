@@ -276,12 +276,12 @@ static inline_function FAR hrtimer_t *hrtimer_get_first(void)
  * Name: hrtimer_is_first
  *
  * Description:
- *   Test whether the given high-resolution timer is the earliest
+ *   Test whether the given armed high-resolution timer is the earliest
  *   expiring timer in the container.
  *
- *   In a container ordered by expiration time, the earliest timer
- *   is represented by the left-most node. Therefore, a timer is the
- *   earliest one if it has no left child.
+ *   In a tree ordered by expiration time, the earliest timer is the
+ *   left-most node.  Note that having no left child is not sufficient,
+ *   a freshly inserted leaf usually has none.
  *
  * Input Parameters:
  *   hrtimer - Pointer to the high-resolution timer to be tested.
@@ -294,7 +294,7 @@ static inline_function FAR hrtimer_t *hrtimer_get_first(void)
 static inline_function bool hrtimer_is_first(FAR hrtimer_t *hrtimer)
 {
 #ifdef CONFIG_HRTIMER_TREE
-  return RB_LEFT(&hrtimer->node, entry) == NULL;
+  return hrtimer_get_first() == hrtimer;
 #else
   return hrtimer == list_first_entry(&g_hrtimer_list, hrtimer_t, node.entry);
 #endif
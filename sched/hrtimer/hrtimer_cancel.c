@@ -79,6 +79,7 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer)
 {
   FAR hrtimer_t *first;
   irqstate_t flags;
+  bool head;
   int ret;
 
   DEBUGASSERT(hrtimer != NULL);
@@ -93,11 +94,15 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer)
 
   if (hrtimer_is_armed(hrtimer))
     {
+      head = hrtimer_is_first(hrtimer);
+
       hrtimer_remove(hrtimer);
 
-      /* Update the hardware timer if the queue head changed. */
+      /* Update the hardware timer if the queue head changed.  Whether the
+       * timer was the head must be sampled before it is removed.
+       */
 
-      if (hrtimer_is_first(hrtimer))
+      if (head)
         {
           first = hrtimer_get_first();
           if (first != NULL)
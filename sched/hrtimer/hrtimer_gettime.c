@@ -56,3 +56,47 @@ uint64_t hrtimer_gettime(FAR hrtimer_t *timer)
 
   return remain < 0 ? 0u : remain;
 }
+
+/****************************************************************************
+ * Name: hrtimer_gettime_next
+ *
+ * Description:
+ *   Get the delay until the first armed hrtimer expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value
+ *   The time until the next expiration in nanoseconds, zero if it is
+ *   already due, or UINT64_MAX if no hrtimer is armed.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime_next(void)
+{
+  FAR hrtimer_t *first;
+  uint64_t expire;
+  int64_t remain;
+  uint32_t seq;
+
+  do
+    {
+      seq    = read_seqbegin(&g_hrtimer_lock);
+#ifdef CONFIG_HRTIMER_TREE
+      first  = hrtimer_get_first();
+#else
+      first  = list_is_empty(&g_hrtimer_list) ? NULL :
+               hrtimer_get_first();
+#endif
+      expire = first != NULL ? first->expired : UINT64_MAX;
+    }
+  while (read_seqretry(&g_hrtimer_lock, seq));
+
+  if (expire == UINT64_MAX)
+    {
+      return expire;
+    }
+
+  remain = expire - clock_systime_nsec();
+  return remain < 0 ? 0u : remain;
+}
@@ -0,0 +1,356 @@
+/****************************************************************************
+ * sched/init/nx_bootasync.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/init.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum bootasync_state_e
+{
+  BOOTASYNC_WAITING = 0,  /* Waiting for the initialization it runs after */
+  BOOTASYNC_QUEUED,       /* Queued or running on the work queue */
+  BOOTASYNC_DONE          /* Completed, result is valid */
+};
+
+struct bootasync_s
+{
+  sq_entry_t          node;   /* Link in g_bootasync */
+  struct work_s       work;   /* Work queue entry */
+  FAR const char     *name;   /* Name of the initialization */
+  FAR const char     *after;  /* Name of the one it runs after, or NULL */
+  bootasync_t         init;   /* The initialization function */
+  FAR void           *arg;    /* Argument of init */
+  int                 result; /* Value returned by init */
+  uint8_t             state;  /* See enum bootasync_state_e */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All the initializations, they are kept after completion so that
+ * nx_bootasync_wait() can return their result.
+ */
+
+static sq_queue_t g_bootasync;
+static mutex_t g_bootasync_lock = NXMUTEX_INITIALIZER;
+
+/* Threads in nx_bootasync_wait() wait here for any completion */
+
+static sem_t g_bootasync_sem = SEM_INITIALIZER(0);
+static int g_bootasync_nwaiters;
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bootasync_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bootasync_find
+ *
+ * Description:
+ *   Find the most recent initialization with this name.  Called with
+ *   g_bootasync_lock held.
+ *
+ ****************************************************************************/
+
+static FAR struct bootasync_s *bootasync_find(FAR const char *name)
+{
+  FAR struct bootasync_s *found = NULL;
+  FAR sq_entry_t *node;
+
+  sq_for_every(&g_bootasync, node)
+    {
+      FAR struct bootasync_s *job = (FAR struct bootasync_s *)node;
+
+      if (strcmp(job->name, name) == 0)
+        {
+          found = job;
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Name: bootasync_start
+ *
+ * Description:
+ *   Start an initialization whose dependency, if any, has completed.  If
+ *   the dependency failed the initialization is not run.  Called with
+ *   g_bootasync_lock held.
+ *
+ ****************************************************************************/
+
+static void bootasync_start(FAR struct bootasync_s *job,
+                            FAR struct bootasync_s *after)
+{
+  FAR sq_entry_t *node;
+
+  if (after == NULL || after->result >= 0)
+    {
+      job->state = BOOTASYNC_QUEUED;
+      work_queue(LPWORK, &job->work, bootasync_worker, job, 0);
+      return;
+    }
+
+  /* Cancel this initialization and everything waiting for it */
+
+  job->result = -ECANCELED;
+  job->state  = BOOTASYNC_DONE;
+
+  sq_for_every(&g_bootasync, node)
+    {
+      FAR struct bootasync_s *next = (FAR struct bootasync_s *)node;
+
+      if (next->state == BOOTASYNC_WAITING &&
+          strcmp(next->after, job->name) == 0)
+        {
+          bootasync_start(next, job);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bootasync_worker
+ *
+ * Description:
+ *   Run one initialization on the low priority work queue, then start the
+ *   initializations waiting for it and wake up nx_bootasync_wait().
+ *
+ ****************************************************************************/
+
+static void bootasync_worker(FAR void *arg)
+{
+  FAR struct bootasync_s *job = arg;
+  FAR sq_entry_t *node;
+  int result;
+
+#ifdef CONFIG_SCHED_BOOT_PROFILE
+  int slot = nx_bootprof_begin(job->name);
+#endif
+
+  result = job->init(job->arg);
+
+#ifdef CONFIG_SCHED_BOOT_PROFILE
+  nx_bootprof_end(slot);
+#endif
+
+  nxmutex_lock(&g_bootasync_lock);
+
+  job->result = result;
+  job->state  = BOOTASYNC_DONE;
+
+  sq_for_every(&g_bootasync, node)
+    {
+      FAR struct bootasync_s *next = (FAR struct bootasync_s *)node;
+
+      if (next->state == BOOTASYNC_WAITING &&
+          strcmp(next->after, job->name) == 0)
+        {
+          bootasync_start(next, job);
+        }
+    }
+
+  while (g_bootasync_nwaiters > 0)
+    {
+      g_bootasync_nwaiters--;
+      nxsem_post(&g_bootasync_sem);
+    }
+
+  nxmutex_unlock(&g_bootasync_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_bootasync
+ *
+ * Description:
+ *   Run a slow initialization, like card detection, PHY link negotiation
+ *   or a flash mount, on the low priority work queue instead of the boot
+ *   thread.  Initializations with no dependency between them run
+ *   concurrently, up to CONFIG_SCHED_LPNTHREADS at a time.
+ *
+ * Input Parameters:
+ *   name  - The name of the initialization, must remain valid after boot.
+ *   init  - The initialization function.
+ *   arg   - The argument passed to init.
+ *   after - The name of an initialization that must have completed
+ *           successfully before this one starts, or NULL.  If it fails,
+ *           this initialization does not run and fails with -ECANCELED.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nx_bootasync(FAR const char *name, bootasync_t init, FAR void *arg,
+                 FAR const char *after)
+{
+  FAR struct bootasync_s *prev = NULL;
+  FAR struct bootasync_s *job;
+
+  if (name == NULL || init == NULL)
+    {
+      return -EINVAL;
+    }
+
+  job = kmm_zalloc(sizeof(*job));
+  if (job == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  job->name  = name;
+  job->after = after;
+  job->init  = init;
+  job->arg   = arg;
+
+  nxmutex_lock(&g_bootasync_lock);
+
+  if (after != NULL)
+    {
+      prev = bootasync_find(after);
+      if (prev == NULL)
+        {
+          nxmutex_unlock(&g_bootasync_lock);
+          kmm_free(job);
+          return -ENOENT;
+        }
+    }
+
+  sq_addlast(&job->node, &g_bootasync);
+
+  if (prev == NULL || prev->state == BOOTASYNC_DONE)
+    {
+      bootasync_start(job, prev);
+    }
+
+  nxmutex_unlock(&g_bootasync_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nx_bootasync_wait
+ *
+ * Description:
+ *   Wait for an initialization started by nx_bootasync(), or for all of
+ *   them.
+ *
+ * Input Parameters:
+ *   name - The name of the initialization, or NULL to wait for all.
+ *
+ * Returned Value:
+ *   The value returned by the initialization function, the first error of
+ *   all of them if name is NULL, or -ENOENT if there is no such
+ *   initialization.
+ *
+ ****************************************************************************/
+
+int nx_bootasync_wait(FAR const char *name)
+{
+  FAR struct bootasync_s *job;
+  FAR sq_entry_t *node;
+  int ret;
+
+  nxmutex_lock(&g_bootasync_lock);
+
+  for (; ; )
+    {
+      ret = OK;
+
+      if (name != NULL)
+        {
+          job = bootasync_find(name);
+          if (job == NULL)
+            {
+              ret = -ENOENT;
+              break;
+            }
+
+          if (job->state == BOOTASYNC_DONE)
+            {
+              ret = job->result;
+              break;
+            }
+        }
+      else
+        {
+          bool busy = false;
+
+          sq_for_every(&g_bootasync, node)
+            {
+              job = (FAR struct bootasync_s *)node;
+              if (job->state != BOOTASYNC_DONE)
+                {
+                  busy = true;
+                  break;
+                }
+
+              if (ret == OK && job->result < 0)
+                {
+                  ret = job->result;
+                }
+            }
+
+          if (!busy)
+            {
+              break;
+            }
+        }
+
+      /* Wait for the next completion and check again */
+
+      g_bootasync_nwaiters++;
+      nxmutex_unlock(&g_bootasync_lock);
+      nxsem_wait_uninterruptible(&g_bootasync_sem);
+      nxmutex_lock(&g_bootasync_lock);
+    }
+
+  nxmutex_unlock(&g_bootasync_lock);
+  return ret;
+}
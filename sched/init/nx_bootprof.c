@@ -0,0 +1,96 @@
+/****************************************************************************
+ * sched/init/nx_bootprof.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/sched_note.h>
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct bootprof_s g_bootprof[CONFIG_SCHED_BOOT_PROFILE_NRECORDS];
+atomic_t g_nbootprof;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_bootprof_begin
+ *
+ * Description:
+ *   Record the start of a boot step.  Usually called through
+ *   nx_bootcall().
+ *
+ * Input Parameters:
+ *   name - The name of the step, must remain valid after boot.
+ *
+ * Returned Value:
+ *   The record of the step for nx_bootprof_end(), or a negated errno value
+ *   if the profile is full.
+ *
+ ****************************************************************************/
+
+int nx_bootprof_begin(FAR const char *name)
+{
+  int slot = atomic_fetch_add(&g_nbootprof, 1);
+
+  if (slot >= CONFIG_SCHED_BOOT_PROFILE_NRECORDS)
+    {
+      return -ENOMEM;
+    }
+
+  g_bootprof[slot].name  = name;
+  g_bootprof[slot].start = perf_gettime();
+  sched_note_beginex(NOTE_TAG_ALWAYS, name);
+  return slot;
+}
+
+/****************************************************************************
+ * Name: nx_bootprof_end
+ *
+ * Description:
+ *   Record the end of a boot step.
+ *
+ * Input Parameters:
+ *   slot - The value returned by nx_bootprof_begin().
+ *
+ ****************************************************************************/
+
+void nx_bootprof_end(int slot)
+{
+  if (slot >= 0)
+    {
+      g_bootprof[slot].end = perf_gettime();
+      sched_note_endex(NOTE_TAG_ALWAYS, g_bootprof[slot].name);
+    }
+}
@@ -48,6 +48,7 @@
 #  include "paging/paging.h"
 #endif
 
+#include "irq/irq.h"
 #include "sched/sched.h"
 #include "wqueue/wqueue.h"
 #include "init/init.h"
@@ -212,6 +213,12 @@ static inline void nx_workqueues(void)
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+#ifdef CONFIG_IRQ_BALANCE
+  /* Start spreading interrupts over the CPUs */
+
+  irq_balance_start();
+#endif
+
 #ifdef CONFIG_LIBC_USRWORK
   /* Start the user-space work queue */
 
@@ -319,7 +326,7 @@ static inline void nx_start_application(void)
    */
 
   boards_trace_begin();
-  board_late_initialize();
+  nx_bootcall(board_late_initialize());
   boards_trace_end();
 #endif
 
@@ -63,14 +63,6 @@
 #include "instrument/instrument.h"
 #include "tls/tls.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-/* This set of all CPUs */
-
-#define SCHED_ALL_CPUS           ((1 << CONFIG_SMP_NCPUS) - 1)
-
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -92,7 +84,11 @@
  * task, is always the IDLE task.
  */
 
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+dq_queue_t g_readytorun[CONFIG_SMP_NCPUS];
+#else
 dq_queue_t g_readytorun;
+#endif
 
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
@@ -123,6 +119,12 @@ enum task_deliver_e g_delivertasks[CONFIG_SMP_NCPUS];
 
 FAR struct tcb_s *g_running_tasks[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SCHED_IDLE_POLL
+/* CPUs that spin instead of sleeping when idle */
+
+cpu_set_t g_idle_poll_cpus = CONFIG_SCHED_IDLE_POLL_CPUS;
+#endif
+
 /* This is the list of all tasks that are ready-to-run, but cannot be placed
  * in the g_readytorun list because:  (1) They are higher priority than the
  * currently active task at the head of the g_readytorun list, and (2) the
@@ -237,7 +239,12 @@ static void tasklist_initialize(void)
   /* TSTATE_TASK_READYTORUN */
 
   tlist[TSTATE_TASK_READYTORUN].list = list_readytorun();
+#  ifdef CONFIG_SCHED_PERCPU_READYTORUN
+  tlist[TSTATE_TASK_READYTORUN].attr = TLIST_ATTR_PRIORITIZED |
+                                       TLIST_ATTR_INDEXED;
+#  else
   tlist[TSTATE_TASK_READYTORUN].attr = TLIST_ATTR_PRIORITIZED;
+#  endif
 
 #else
 
@@ -378,15 +385,26 @@ static void idle_task_initialize(void)
        * enforced by the TCB_FLAG_CPU_LOCKED which overrides the affinity
        * mask.  This is essential because all tasks inherit the affinity
        * mask from their parent and, ultimately, the parent of all tasks is
-       * the IDLE task.
+       * the IDLE task.  Isolated CPUs are left out so that nothing lands on
+       * them unless it is bound there explicitly.
        */
 
       tcb->affinity =
-        (cpu_set_t)(CONFIG_SMP_DEFAULT_CPUSET & SCHED_ALL_CPUS);
+        (cpu_set_t)(CONFIG_SMP_DEFAULT_CPUSET & SCHED_HOUSEKEEPING_CPUS);
+      if (tcb->affinity == 0)
+        {
+          tcb->affinity = SCHED_HOUSEKEEPING_CPUS;
+        }
 #else
       tcb->flags = TCB_FLAG_TTYPE_KERNEL;
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_SLACK
+      /* All tasks inherit the timer slack from the IDLE task */
+
+      tcb->timerslack = USEC2TICK(CONFIG_WDOG_TIMER_SLACK_DEFAULT);
+#endif
+
 #if CONFIG_TASK_NAME_SIZE > 0
       /* Set the IDLE task name */
 
@@ -656,13 +674,13 @@ void nx_start(void)
 #ifdef CONFIG_NET
   /* Initialize the networking system */
 
-  net_initialize();
+  nx_bootcall(net_initialize());
 #endif
 
 #ifndef CONFIG_BINFMT_DISABLE
   /* Initialize the binfmt system */
 
-  binfmt_initialize();
+  nx_bootcall(binfmt_initialize());
 #endif
 
   /* Initialize Hardware Facilities *****************************************/
@@ -673,11 +691,11 @@ void nx_start(void)
    * that are different for each  processor and hardware platform.
    */
 
-  up_initialize();
+  nx_bootcall(up_initialize());
 
   /* Initialize common drivers */
 
-  drivers_initialize();
+  nx_bootcall(drivers_initialize());
 
 #ifdef CONFIG_BOARD_EARLY_INITIALIZE
   /* Call the board-specific up_initialize() extension to support
@@ -686,7 +704,7 @@ void nx_start(void)
    */
 
   boards_trace_begin();
-  board_early_initialize();
+  nx_bootcall(board_early_initialize());
   boards_trace_end();
 #endif
 
@@ -58,6 +58,16 @@ struct irq_info_s
 #endif
 };
 
+#ifdef CONFIG_IRQ_AFFINITY
+/* CPU routing of one IRQ */
+
+struct irq_affinity_s
+{
+  cpu_set_t cpuset;  /* CPUs the IRQ is routed to, zero if never set */
+  bool pinned;       /* Set by irq_set_affinity(), skipped by balancing */
+};
+#endif
+
 #ifdef CONFIG_SCHED_IRQMONITOR
 /* This is the type of the callback from irq_foreach(). */
 
@@ -80,6 +90,16 @@ extern struct irq_info_s g_irqvector[CONFIG_ARCH_NUSER_INTERRUPTS];
 extern struct irq_info_s g_irqvector[NR_IRQS];
 #endif
 
+/* The IRQ thread (if any) created for each IRQ by irq_attach_thread() */
+
+extern pid_t g_irqthread_pid[NR_IRQS];
+
+#ifdef CONFIG_IRQ_AFFINITY
+/* Current routing of each IRQ */
+
+extern struct irq_affinity_s g_irqaffinity[NR_IRQS];
+#endif
+
 #ifdef CONFIG_SMP
 /* This is the spinlock that enforces critical sections when interrupts are
  * disabled.
@@ -159,6 +179,33 @@ int irq_unexpected_isr(int irq, FAR void *context, FAR void *arg);
 int irq_foreach(irq_foreach_t callback, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_affinity_route
+ *
+ * Description:
+ *   Route 'irq' and its IRQ thread to 'cpuset' without pinning it, as
+ *   done by the IRQ balancer.  Fails with -EPERM if the IRQ was pinned by
+ *   irq_set_affinity().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+int irq_affinity_route(int irq, cpu_set_t cpuset);
+#endif
+
+/****************************************************************************
+ * Name: irq_balance_start
+ *
+ * Description:
+ *   Start the periodic IRQ balancing work.  Called once the work queues
+ *   are running.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_BALANCE
+void irq_balance_start(void);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 void irqchain_initialize(void);
 bool is_irqchain(int ndx, xcpt_t isr);
@@ -0,0 +1,138 @@
+/****************************************************************************
+ * sched/irq/irq_affinity.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#include "irq/irq.h"
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_irqaffinity_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct irq_affinity_s g_irqaffinity[NR_IRQS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_affinity_set
+ ****************************************************************************/
+
+static int irq_affinity_set(int irq, cpu_set_t cpuset, bool pinned)
+{
+  irqstate_t flags;
+  pid_t pid;
+
+  cpuset &= (1 << CONFIG_SMP_NCPUS) - 1;
+  if (irq < 0 || irq >= NR_IRQS || cpuset == 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&g_irqaffinity_lock);
+
+  /* The balancer must not undo a manual setting that raced with it */
+
+  if (!pinned && g_irqaffinity[irq].pinned)
+    {
+      spin_unlock_irqrestore(&g_irqaffinity_lock, flags);
+      return -EPERM;
+    }
+
+  up_affinity_irq(irq, cpuset);
+  g_irqaffinity[irq].cpuset = cpuset;
+  g_irqaffinity[irq].pinned = pinned;
+  pid = g_irqthread_pid[irq];
+
+  spin_unlock_irqrestore(&g_irqaffinity_lock, flags);
+
+  /* Let the deferred half run where the interrupt is taken */
+
+  if (pid > 0)
+    {
+      nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_affinity_route
+ *
+ * Description:
+ *   Route 'irq' and its IRQ thread to 'cpuset' without pinning it, as
+ *   done by the IRQ balancer.  Fails with -EPERM if the IRQ was pinned by
+ *   irq_set_affinity().
+ *
+ ****************************************************************************/
+
+int irq_affinity_route(int irq, cpu_set_t cpuset)
+{
+  return irq_affinity_set(irq, cpuset, false);
+}
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Route IRQ number 'irq' to the CPUs in 'cpuset' and move its IRQ
+ *   thread, if any, to the same CPUs.  The IRQ is then excluded from
+ *   automatic balancing.
+ *
+ * Input Parameters:
+ *   irq    - IRQ number
+ *   cpuset - Set of target CPUs
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_set_affinity(int irq, cpu_set_t cpuset)
+{
+  irqinfo("IRQ%d cpuset %08" PRIx32 "\n", irq, (uint32_t)cpuset);
+  return irq_affinity_set(irq, cpuset, true);
+}
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * sched/irq/irq_attach_direct.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#include "irq/irq.h"
+#include "clock/clock.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_irqdirect_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_direct_dispatch
+ *
+ * Description:
+ *   Entry kept in g_irqvector[] for a direct IRQ.  It marks the IRQ as in
+ *   use for irq_foreach() and, should the interrupt ever arrive through
+ *   the common path, forwards it to the direct handler.
+ *
+ ****************************************************************************/
+
+static int irq_direct_dispatch(int irq, FAR void *context, FAR void *arg)
+{
+  direct_xcpt_t isr = (direct_xcpt_t)arg;
+
+  isr();
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_attach_direct
+ *
+ * Description:
+ *   Install 'isr' directly in the hardware vector of IRQ number 'irq',
+ *   bypassing irq_dispatch().
+ *
+ * Input Parameters:
+ *   irq - IRQ number
+ *   isr - Direct handler, or NULL to restore the common vector
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_attach_direct(int irq, direct_xcpt_t isr)
+{
+  irqstate_t flags;
+  int ndx = IRQ_TO_NDX(irq);
+  int ret;
+
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  flags = spin_lock_irqsave(&g_irqdirect_lock);
+
+  ret = up_attach_direct(irq, isr);
+  if (ret >= 0)
+    {
+      if (isr != NULL)
+        {
+          g_irqvector[ndx].handler = irq_direct_dispatch;
+          g_irqvector[ndx].arg     = (FAR void *)isr;
+        }
+      else
+        {
+          g_irqvector[ndx].handler = irq_unexpected_isr;
+          g_irqvector[ndx].arg     = NULL;
+        }
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+      g_irqvector[ndx].start = clock_systime_ticks();
+      g_irqvector[ndx].time  = 0;
+      g_irqvector[ndx].count = 0;
+#endif
+    }
+
+  spin_unlock_irqrestore(&g_irqdirect_lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_direct_count
+ *
+ * Description:
+ *   Account one occurrence of a direct interrupt in the IRQ monitor.  This
+ *   is a single increment so that it can be called from the handler
+ *   itself without measurable cost.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+void irq_direct_count(int irq)
+{
+  int ndx = IRQ_TO_NDX(irq);
+
+  if (ndx >= 0)
+    {
+      g_irqvector[ndx].count++;
+    }
+}
+#endif
@@ -53,6 +53,14 @@ struct irq_thread_info_s
   FAR sem_t *sem;     /* irq sem used to notify irq thread */
 };
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if NR_IRQS > 0
+pid_t g_irqthread_pid[NR_IRQS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -147,8 +155,6 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
 {
   int ret = OK;
 #if NR_IRQS > 0
-  static pid_t irq_thread_pid[NR_IRQS];
-
   FAR char *argv[5];
   char arg1[32];  /* irq */
   char arg2[32];  /* isr */
@@ -165,11 +171,11 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
       /* If the isrthread is NULL, then the ISR is being detached. */
 
       irq_detach(irq);
-      DEBUGASSERT(irq_thread_pid[ndx] != 0);
-      kthread_delete(irq_thread_pid[ndx]);
-      irq_thread_pid[ndx] = 0;
+      DEBUGASSERT(g_irqthread_pid[ndx] != 0);
+      kthread_delete(g_irqthread_pid[ndx]);
+      g_irqthread_pid[ndx] = 0;
     }
-  else if(irq_thread_pid[ndx] != 0)
+  else if(g_irqthread_pid[ndx] != 0)
     {
       ret = -EINVAL;
     }
@@ -191,8 +197,21 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
         {
           ret = pid;
         }
+      else
+        {
+          g_irqthread_pid[ndx] = pid;
+
+#ifdef CONFIG_IRQ_AFFINITY
+          /* Keep the thread on the CPUs the IRQ is already routed to */
 
-      irq_thread_pid[ndx] = pid;
+          if (g_irqaffinity[ndx].cpuset != 0)
+            {
+              cpu_set_t cpuset = g_irqaffinity[ndx].cpuset;
+
+              nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+            }
+#endif
+        }
     }
 #endif /* NR_IRQS */
 
@@ -55,6 +55,9 @@ struct irq_work_info_s
   struct work_s work; /* Interrupt work to the wq */
 
   FAR struct kwork_wqueue_s *wqueue;   /* Work queue. */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  bool percpu;                         /* Use the queue of the local CPU */
+#endif
 };
 
 /****************************************************************************
@@ -129,7 +132,23 @@ static int irq_default_handler(int irq, FAR void *context, FAR void *arg)
 
   if (ret == IRQ_WAKE_THREAD)
     {
-      work_queue_wq(info->wqueue, &info->work, irq_work_handler, info, 0u);
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      /* Run the work on the CPU that took the interrupt.  If the work is
+       * still queued, it will already handle this interrupt.
+       */
+
+      if (info->percpu)
+        {
+          work_queue_cpu(this_cpu(), &info->work, irq_work_handler,
+                         info, 0u);
+        }
+      else
+#endif
+        {
+          work_queue_wq(info->wqueue, &info->work, irq_work_handler,
+                        info, 0u);
+        }
+
       ret = OK;
     }
 
@@ -189,6 +208,14 @@ int irq_attach_wqueue(int irq, xcpt_t isr, xcpt_t isrwork,
       if (isrwork == NULL)
         {
           irq_detach(irq);
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+          if (info->percpu)
+            {
+              work_cancel_cpu(&info->work);
+            }
+
+          info->percpu  = false;
+#endif
           info->isrwork = NULL;
           info->handler = NULL;
           info->arg     = NULL;
@@ -200,7 +227,16 @@ int irq_attach_wqueue(int irq, xcpt_t isr, xcpt_t isrwork,
           info->handler = isr;
           info->arg     = arg;
           info->irq     = irq;
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+          /* Interrupt work at the high priority work queue priority is
+           * sent to the per-CPU high priority work queues.
+           */
+
+          info->percpu  = priority == CONFIG_SCHED_HPWORKPRIORITY;
+          if (!info->percpu && info->wqueue == NULL)
+#else
           if (info->wqueue == NULL)
+#endif
             {
               info->wqueue = irq_get_wqueue(priority);
             }
@@ -0,0 +1,205 @@
+/****************************************************************************
+ * sched/irq/irq_balance.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/wqueue.h>
+
+#include "irq/irq.h"
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IRQBALANCE_DELAY MSEC2TICK(CONFIG_IRQ_BALANCE_INTERVAL)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct work_s g_irqbalance_work;
+
+/* IRQ monitor count seen on the previous pass and the number of
+ * interrupts taken during the last interval.
+ */
+
+static uint32_t g_irqbalance_last[NR_IRQS];
+static uint32_t g_irqbalance_load[NR_IRQS];
+
+/* Balanced IRQs sorted by decreasing load */
+
+static irq_t g_irqbalance_order[NR_IRQS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_balance_cpu
+ *
+ * Description:
+ *   Return the CPU an IRQ is currently routed to.  Interrupts that were
+ *   never routed explicitly are assumed to go to the boot CPU.
+ *
+ ****************************************************************************/
+
+static int irq_balance_cpu(int irq)
+{
+  cpu_set_t cpuset = g_irqaffinity[irq].cpuset;
+
+  return cpuset != 0 ? ffs(cpuset) - 1 : 0;
+}
+
+/****************************************************************************
+ * Name: irq_balance_worker
+ *
+ * Description:
+ *   Measure the interrupt rate of each IRQ over the last interval and
+ *   redistribute the IRQs with a longest-load-first greedy assignment.
+ *   An IRQ stays where it is unless its CPU is loaded by more than half
+ *   of the IRQ's own rate above the least loaded CPU, which keeps
+ *   interrupts from bouncing between CPUs with similar load.
+ *
+ ****************************************************************************/
+
+static void irq_balance_worker(FAR void *arg)
+{
+  cpu_set_t housekeeping = SCHED_HOUSEKEEPING_CPUS;
+  uint32_t cpuload[CONFIG_SMP_NCPUS];
+  uint32_t count;
+  uint32_t delta;
+  int nirqs = 0;
+  int irq;
+  int cpu;
+  int i;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cpuload[cpu] = 0;
+    }
+
+  for (irq = CONFIG_IRQ_BALANCE_MINIRQ; irq < NR_IRQS; irq++)
+    {
+      if (g_irqvector[irq].handler == NULL ||
+          g_irqvector[irq].handler == irq_unexpected_isr)
+        {
+          continue;
+        }
+
+      /* irq_procfs resets the count on every read, so a count below the
+       * previous sample means it restarted from zero.
+       */
+
+      count = g_irqvector[irq].count;
+      delta = count >= g_irqbalance_last[irq] ?
+              count - g_irqbalance_last[irq] : count;
+      g_irqbalance_last[irq] = count;
+
+      if (g_irqaffinity[irq].pinned)
+        {
+          cpuload[irq_balance_cpu(irq)] += delta;
+          continue;
+        }
+
+      if (delta == 0)
+        {
+          continue;
+        }
+
+      g_irqbalance_load[irq] = delta;
+
+      for (i = nirqs; i > 0 &&
+           g_irqbalance_load[g_irqbalance_order[i - 1]] < delta; i--)
+        {
+          g_irqbalance_order[i] = g_irqbalance_order[i - 1];
+        }
+
+      g_irqbalance_order[i] = irq;
+      nirqs++;
+    }
+
+  for (i = 0; i < nirqs; i++)
+    {
+      int current;
+      int target = -1;
+
+      irq   = g_irqbalance_order[i];
+      delta = g_irqbalance_load[irq];
+
+      /* Isolated CPUs never receive balanced interrupts */
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          if (CPU_ISSET(cpu, &housekeeping) &&
+              (target < 0 || cpuload[cpu] < cpuload[target]))
+            {
+              target = cpu;
+            }
+        }
+
+      current = irq_balance_cpu(irq);
+      if (CPU_ISSET(current, &housekeeping) &&
+          cpuload[current] <= cpuload[target] + delta / 2)
+        {
+          target = current;
+        }
+
+      cpuload[target] += delta;
+
+      if (g_irqaffinity[irq].cpuset != (1 << target))
+        {
+          irq_affinity_route(irq, 1 << target);
+        }
+    }
+
+  work_queue(LPWORK, &g_irqbalance_work, irq_balance_worker, NULL,
+             IRQBALANCE_DELAY);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_balance_start
+ *
+ * Description:
+ *   Start the periodic IRQ balancing work.  Called once the work queues
+ *   are running.
+ *
+ ****************************************************************************/
+
+void irq_balance_start(void)
+{
+  work_queue(LPWORK, &g_irqbalance_work, irq_balance_worker, NULL,
+             IRQBALANCE_DELAY);
+}
@@ -140,7 +140,9 @@ void irq_dispatch(int irq, FAR void *context)
 
   /* Then dispatch to the interrupt handler */
 
+  nxsched_critmon_irq(true);
   CALL_VECTOR(ndx, vector, irq, context, arg);
+  nxsched_critmon_irq(false);
   UNUSED(ndx);
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
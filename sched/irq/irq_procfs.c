@@ -28,6 +28,7 @@
 
 #include <sys/stat.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <string.h>
 #include <assert.h>
@@ -102,6 +103,10 @@ static int     irq_open(FAR struct file *filep, FAR const char *relpath,
 static int     irq_close(FAR struct file *filep);
 static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+#ifdef CONFIG_IRQ_AFFINITY
+static ssize_t irq_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+#endif
 static int     irq_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     irq_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -120,7 +125,11 @@ const struct procfs_operations g_irq_operations =
   irq_open,       /* open */
   irq_close,      /* close */
   irq_read,       /* read */
+#ifdef CONFIG_IRQ_AFFINITY
+  irq_write,      /* write */
+#else
   NULL,           /* write */
+#endif
   NULL,           /* poll */
 
   irq_dup,        /* dup */
@@ -275,6 +284,7 @@ static int irq_open(FAR struct file *filep, FAR const char *relpath,
 
   finfo("Open '%s'\n", relpath);
 
+#ifndef CONFIG_IRQ_AFFINITY
   /* This PROCFS file is read-only.  Any attempt to open with write access
    * is not permitted.
    */
@@ -284,6 +294,7 @@ static int irq_open(FAR struct file *filep, FAR const char *relpath,
       ferr("ERROR: Only O_RDONLY supported\n");
       return -EACCES;
     }
+#endif
 
   /* Allocate a container to hold the file attributes */
 
@@ -367,6 +378,48 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
   return irqfile->ncopied;
 }
 
+/****************************************************************************
+ * Name: irq_write
+ *
+ * Description:
+ *   Pin an interrupt to a set of CPUs.  The written text is
+ *   "<irq> <cpumask>" with the mask in hexadecimal, for example
+ *   "echo 75 2 >/proc/irqs" routes IRQ 75 to CPU1.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+static ssize_t irq_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  char line[32];
+  FAR char *ptr;
+  unsigned long irq;
+  unsigned long cpuset;
+  size_t len;
+  int ret;
+
+  len = buflen < sizeof(line) - 1 ? buflen : sizeof(line) - 1;
+  memcpy(line, buffer, len);
+  line[len] = '\0';
+
+  irq = strtoul(line, &ptr, 0);
+  if (ptr == line)
+    {
+      return -EINVAL;
+    }
+
+  cpuset = strtoul(ptr, &ptr, 16);
+  ret = irq_set_affinity((int)irq, (cpu_set_t)cpuset);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: irq_dup
  *
@@ -419,6 +472,9 @@ static int irq_stat(const char *relpath, struct stat *buf)
 
   memset(buf, 0, sizeof(struct stat));
   buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+#ifdef CONFIG_IRQ_AFFINITY
+  buf->st_mode |= S_IWUSR;
+#endif
   return OK;
 }
 
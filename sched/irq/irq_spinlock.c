@@ -35,14 +35,216 @@
 
 #if defined(CONFIG_SPINLOCK)
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_LOCKSTAT
+/* Serializes the claiming of free entries in g_spinlock_stat */
+
+static spinlock_t g_spinlock_stat_lock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_SPINLOCK_LOCKSTAT
+struct spinlock_stat_s g_spinlock_stat[CONFIG_SPINLOCK_LOCKSTAT_NLOCKS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_LOCKSTAT
+
+/****************************************************************************
+ * Name: spin_lock_stat_find
+ *
+ * Description:
+ *   Find the statistics entry of a lock in the open-addressed table,
+ *   optionally claiming a free entry for it.
+ *
+ * Input Parameters:
+ *   lock   - The spinlock to look up.
+ *   caller - Recorded as the owner of a newly claimed entry.
+ *   claim  - True: claim a free entry if the lock is not yet present.
+ *
+ * Returned Value:
+ *   The entry of the lock, or NULL if it is not present (and could not be
+ *   claimed).
+ *
+ ****************************************************************************/
+
+static FAR struct spinlock_stat_s *
+spin_lock_stat_find(FAR volatile spinlock_t *lock, FAR void *caller,
+                    bool claim)
+{
+  FAR struct spinlock_stat_s *stat;
+  FAR volatile spinlock_t *entry;
+  unsigned int index;
+  unsigned int i;
+
+  index = ((uintptr_t)lock / sizeof(uintptr_t)) %
+          CONFIG_SPINLOCK_LOCKSTAT_NLOCKS;
+
+  for (i = 0; i < CONFIG_SPINLOCK_LOCKSTAT_NLOCKS; i++)
+    {
+      stat  = &g_spinlock_stat[index];
+      entry = stat->lock;
+
+      if (entry == lock)
+        {
+          return stat;
+        }
+      else if (entry == NULL)
+        {
+          if (!claim)
+            {
+              return NULL;
+            }
+
+          stat->caller = caller;
+          UP_DMB();
+          stat->lock   = lock;
+          return stat;
+        }
+
+      if (++index >= CONFIG_SPINLOCK_LOCKSTAT_NLOCKS)
+        {
+          index = 0;
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_SPINLOCK_LOCKSTAT */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SPINLOCK_LOCKSTAT
+
+/****************************************************************************
+ * Name: spin_lock_stat
+ *
+ * Description:
+ *   Take the spinlock like spin_lock_notrace(), recording whether the lock
+ *   was contended and how long this CPU spun for it.  The statistics entry
+ *   is updated while the lock is held, so its counters need no further
+ *   protection; only claiming a new entry is serialized.
+ *
+ * Input Parameters:
+ *   lock   - A reference to the spinlock object to lock.
+ *   caller - The return address of the caller of spin_lock().
+ *
+ * Returned Value:
+ *   None.  When the function returns, the spinlock was successfully locked
+ *   by this CPU.
+ *
+ ****************************************************************************/
+
+void spin_lock_stat(FAR volatile spinlock_t *lock, FAR void *caller)
+{
+  FAR struct spinlock_stat_s *stat;
+  irqstate_t flags;
+  clock_t elapsed = 0;
+  clock_t start;
+  bool contended;
+
+#ifdef CONFIG_TICKET_SPINLOCK
+  int ticket = atomic_fetch_add(&lock->next, 1);
+
+  contended = atomic_read(&lock->owner) != ticket;
+  if (contended)
+    {
+      start = up_perf_gettime();
+      while (atomic_read(&lock->owner) != ticket)
+        {
+          UP_DSB();
+          UP_WFE();
+        }
+
+      elapsed = up_perf_gettime() - start;
+    }
+#else
+  contended = up_testset(lock) == SP_LOCKED;
+  if (contended)
+    {
+      start = up_perf_gettime();
+      while (up_testset(lock) == SP_LOCKED)
+        {
+          UP_DSB();
+          UP_WFE();
+        }
+
+      elapsed = up_perf_gettime() - start;
+    }
+#endif
+
+  UP_DMB();
+
+  /* Look the lock up without serialization first: an entry never changes
+   * owner once it was claimed.
+   */
+
+  stat = spin_lock_stat_find(lock, caller, false);
+  if (stat == NULL)
+    {
+      flags = spin_lock_irqsave_notrace(&g_spinlock_stat_lock);
+      stat  = spin_lock_stat_find(lock, caller, true);
+      spin_unlock_irqrestore_notrace(&g_spinlock_stat_lock, flags);
+
+      if (stat == NULL)
+        {
+          return;
+        }
+    }
+
+  stat->acquired++;
+  if (contended)
+    {
+      stat->contended++;
+      stat->spintime += elapsed;
+      if (elapsed > stat->maxspin)
+        {
+          stat->maxspin = elapsed;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: spin_lock_stat_reset
+ *
+ * Description:
+ *   Clear the counters of all tracked spinlocks.  The locks stay in the
+ *   table so that concurrent lookups keep finding their entries.
+ *
+ ****************************************************************************/
+
+void spin_lock_stat_reset(void)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave_notrace(&g_spinlock_stat_lock);
+
+  for (i = 0; i < CONFIG_SPINLOCK_LOCKSTAT_NLOCKS; i++)
+    {
+      g_spinlock_stat[i].acquired  = 0;
+      g_spinlock_stat[i].contended = 0;
+      g_spinlock_stat[i].spintime  = 0;
+      g_spinlock_stat[i].maxspin   = 0;
+    }
+
+  spin_unlock_irqrestore_notrace(&g_spinlock_stat_lock, flags);
+}
+
+#endif /* CONFIG_SPINLOCK_LOCKSTAT */
+
 #ifdef CONFIG_RW_SPINLOCK
 
 /****************************************************************************
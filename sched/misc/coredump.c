@@ -108,6 +108,10 @@ static struct memory_region_s g_memory_region[] =
     CONFIG_BOARD_MEMORY_RANGE
   };
 #endif
+#if CONFIG_BOARD_COREDUMP_NREGIONS > 0
+static struct memory_region_s
+g_region_table[CONFIG_BOARD_COREDUMP_NREGIONS + 1];
+#endif
 static const struct memory_region_s *g_regions;
 
 /****************************************************************************
@@ -276,6 +280,80 @@ static int elf_get_info_note_size(void)
          sizeof(struct coredump_info_s);
 }
 
+/****************************************************************************
+ * Name: elf_get_tcb_regs
+ *
+ * Description:
+ *   Get the register context of the tcb.  The context of the running task
+ *   is saved once by coredump() so that the program header, the notes and
+ *   the stack dump all see the same stack pointer.
+ *
+ ****************************************************************************/
+
+static FAR uintptr_t *elf_get_tcb_regs(FAR struct tcb_s *tcb)
+{
+  if (running_task() == tcb)
+    {
+      if (up_interrupt_context())
+        {
+          return (FAR uintptr_t *)running_regs();
+        }
+
+      return (FAR uintptr_t *)g_running_regs;
+    }
+
+  return (FAR uintptr_t *)tcb->xcp.regs;
+}
+
+/****************************************************************************
+ * Name: elf_get_tcb_stack
+ *
+ * Description:
+ *   Get the part of the task stack to dump.  Only the used part of the
+ *   stack (from the saved stack pointer up to the stack base) is dumped,
+ *   the whole stack is dumped only when the stack pointer is unknown.
+ *
+ ****************************************************************************/
+
+static void elf_get_tcb_stack(FAR struct tcb_s *tcb,
+                              FAR uintptr_t *buf, FAR size_t *len)
+{
+  FAR uintptr_t *regs = elf_get_tcb_regs(tcb);
+  uintptr_t top = (uintptr_t)tcb->stack_base_ptr + tcb->adj_stack_size;
+  uintptr_t sp;
+
+  *buf = 0;
+
+  if (regs != NULL)
+    {
+      sp = up_getusrsp(regs);
+
+      if (sp > (uintptr_t)tcb->stack_base_ptr && sp < top)
+        {
+          *len = top - sp;
+          *buf = sp;
+        }
+#ifdef CONFIG_STACK_COLORATION
+      else if (running_task() != tcb)
+        {
+          *len = up_check_tcbstack(tcb, tcb->adj_stack_size);
+          *buf = top - *len;
+        }
+#endif
+    }
+
+  if (*buf == 0)
+    {
+      *buf = (uintptr_t)tcb->stack_alloc_ptr;
+      *len = tcb->adj_stack_size +
+             (tcb->stack_base_ptr - tcb->stack_alloc_ptr);
+    }
+
+  sp   = ALIGN_DOWN(*buf, PROGRAM_ALIGNMENT);
+  *len = ALIGN_UP(*len + (*buf - sp), PROGRAM_ALIGNMENT);
+  *buf = sp;
+}
+
 /****************************************************************************
  * Name: elf_emit_tcb_note
  *
@@ -322,23 +400,7 @@ static void elf_emit_tcb_note(FAR struct elf_dumpinfo_s *cinfo,
 
   status.pr_pid = tcb->pid;
 
-  if (running_task() == tcb)
-    {
-      if (up_interrupt_context())
-        {
-          regs = (FAR uintptr_t *)running_regs();
-        }
-      else
-        {
-          up_saveusercontext(g_running_regs);
-          regs = (FAR uintptr_t *)g_running_regs;
-        }
-    }
-  else
-    {
-      regs = (FAR uintptr_t *)tcb->xcp.regs;
-    }
-
+  regs = elf_get_tcb_regs(tcb);
   if (regs != NULL)
     {
       for (i = 0; i < MIN(nitems(status.pr_regs), g_tcbinfo.regs_num); i++)
@@ -393,42 +455,10 @@ static void elf_emit_note(FAR struct elf_dumpinfo_s *cinfo)
 static void elf_emit_tcb_stack(FAR struct elf_dumpinfo_s *cinfo,
                                FAR struct tcb_s *tcb)
 {
-  uintptr_t buf = 0;
-  uintptr_t sp;
+  uintptr_t buf;
   size_t len;
 
-  if (running_task() != tcb)
-    {
-      sp = up_getusrsp(tcb->xcp.regs);
-
-      if (sp > (uintptr_t)tcb->stack_base_ptr &&
-          sp < (uintptr_t)tcb->stack_base_ptr + tcb->adj_stack_size)
-        {
-          len = ((uintptr_t)tcb->stack_base_ptr +
-                            tcb->adj_stack_size) - sp;
-          buf = sp;
-        }
-#ifdef CONFIG_STACK_COLORATION
-      else
-        {
-          len = up_check_tcbstack(tcb, tcb->adj_stack_size);
-          buf = (uintptr_t)tcb->stack_base_ptr +
-                           (tcb->adj_stack_size - len);
-        }
-#endif
-    }
-
-  if (buf == 0)
-    {
-      buf = (uintptr_t)tcb->stack_alloc_ptr;
-      len = tcb->adj_stack_size +
-            (tcb->stack_base_ptr - tcb->stack_alloc_ptr);
-    }
-
-  sp  = ALIGN_DOWN(buf, PROGRAM_ALIGNMENT);
-  len = ALIGN_UP(len + (buf - sp), PROGRAM_ALIGNMENT);
-  buf = sp;
-
+  elf_get_tcb_stack(tcb, &buf, &len);
   elf_emit(cinfo, (FAR void *)buf, len);
 
   /* Align to page */
@@ -558,43 +588,13 @@ static void elf_emit_tcb_phdr(FAR struct elf_dumpinfo_s *cinfo,
                               FAR struct tcb_s *tcb,
                               FAR Elf_Phdr *phdr, off_t *offset)
 {
-  uintptr_t sp;
-
-  phdr->p_vaddr = 0;
-
-  if (running_task() != tcb)
-    {
-      sp = up_getusrsp(tcb->xcp.regs);
-
-      if (sp > (uintptr_t)tcb->stack_base_ptr &&
-          sp < (uintptr_t)tcb->stack_base_ptr + tcb->adj_stack_size)
-        {
-          phdr->p_filesz = ((uintptr_t)tcb->stack_base_ptr +
-                           tcb->adj_stack_size) - sp;
-          phdr->p_vaddr  = sp;
-        }
-#ifdef CONFIG_STACK_COLORATION
-      else
-        {
-          phdr->p_filesz = up_check_tcbstack(tcb, tcb->adj_stack_size);
-          phdr->p_vaddr  = (uintptr_t)tcb->stack_base_ptr +
-                           (tcb->adj_stack_size - phdr->p_filesz);
-        }
-#endif
-    }
-
-  if (phdr->p_vaddr == 0)
-    {
-      phdr->p_vaddr  = (uintptr_t)tcb->stack_alloc_ptr;
-      phdr->p_filesz = tcb->adj_stack_size +
-                      (tcb->stack_base_ptr - tcb->stack_alloc_ptr);
-    }
+  uintptr_t buf;
+  size_t len;
 
-  sp = ALIGN_DOWN(phdr->p_vaddr, PROGRAM_ALIGNMENT);
-  phdr->p_filesz = ALIGN_UP(phdr->p_filesz +
-                            (phdr->p_vaddr - sp), PROGRAM_ALIGNMENT);
-  phdr->p_vaddr  = sp;
+  elf_get_tcb_stack(tcb, &buf, &len);
 
+  phdr->p_vaddr  = buf;
+  phdr->p_filesz = len;
   phdr->p_type   = PT_LOAD;
   phdr->p_offset = ALIGN_UP(*offset, ELF_PAGESIZE);
   phdr->p_paddr  = phdr->p_vaddr;
@@ -851,13 +851,32 @@ int coredump_add_memory_region(FAR const void *ptr, size_t size,
       /* Need a new region */
     }
 
+#if CONFIG_BOARD_COREDUMP_NREGIONS > 0
+  /* The region table is static, so that no memory is allocated and the
+   * table is never left half updated by a crash in the heap.
+   */
+
+  if (count > CONFIG_BOARD_COREDUMP_NREGIONS)
+    {
+      return -ENOSPC;
+    }
+
+  region = g_region_table;
+  if (g_regions != NULL && g_regions != g_region_table)
+    {
+      memcpy(region, g_regions, sizeof(struct memory_region_s) * count);
+    }
+#else
   region = lib_malloc(sizeof(struct memory_region_s) * (count + 1));
   if (region == NULL)
     {
       return -ENOMEM;
     }
 
-  memcpy(region, g_regions, sizeof(struct memory_region_s) * count);
+  if (g_regions != NULL)
+    {
+      memcpy(region, g_regions, sizeof(struct memory_region_s) * count);
+    }
 
   if (g_regions != NULL
 #ifdef CONFIG_BOARD_MEMORY_RANGE
@@ -867,6 +886,7 @@ int coredump_add_memory_region(FAR const void *ptr, size_t size,
     {
       lib_free((FAR void *)g_regions);
     }
+#endif
 
   region[count - 1].start = (uintptr_t)ptr;
   region[count - 1].end = (uintptr_t)ptr + size;
@@ -962,6 +982,15 @@ int coredump(FAR const struct memory_region_s *regions,
 
   flags = enter_critical_section();
 
+  /* Save the context of the running task once, before any stack range is
+   * calculated, so that every segment agrees on its stack pointer.
+   */
+
+  if (!up_interrupt_context())
+    {
+      up_saveusercontext(g_running_regs);
+    }
+
   if (cinfo.pid != INVALID_PROCESS_ID)
     {
       if (nxsched_get_tcb(cinfo.pid) == NULL)
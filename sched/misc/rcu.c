@@ -0,0 +1,190 @@
+/****************************************************************************
+ * sched/misc/rcu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/rcu.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+atomic_t g_rcu_epoch;
+atomic_t g_rcu_readers[2];
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* A grace period flips the epoch and waits for the counter of the previous
+ * one to drain, all the readers which entered later can't see what the
+ * writer unlinked before the flip.  The grace periods don't overlap, or a
+ * reader of the epoch before the last one might be missed.
+ */
+
+static mutex_t g_rcu_gplock = NXMUTEX_INITIALIZER;
+
+#ifdef CONFIG_SCHED_LPWORK
+/* The callbacks waiting for the next grace period, in the order they were
+ * queued.
+ */
+
+static spinlock_t g_rcu_lock = SP_UNLOCKED;
+static FAR struct rcu_head_s *g_rcu_head;
+static FAR struct rcu_head_s *g_rcu_tail;
+static struct work_s g_rcu_work;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_worker
+ *
+ * Description:
+ *   Run the queued callbacks after a grace period.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+static void rcu_worker(FAR void *arg)
+{
+  FAR struct rcu_head_s *head;
+  FAR struct rcu_head_s *next;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_rcu_lock);
+  head = g_rcu_head;
+  g_rcu_head = NULL;
+  g_rcu_tail = NULL;
+  spin_unlock_irqrestore(&g_rcu_lock, flags);
+
+  /* The callbacks queued meanwhile schedule the work again */
+
+  synchronize_rcu();
+
+  for (; head != NULL; head = next)
+    {
+      next = head->next;
+      head->func(head);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait for the end of a grace period.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void)
+{
+  int epoch;
+
+  DEBUGASSERT(!up_interrupt_context());
+
+  nxmutex_lock(&g_rcu_gplock);
+
+  /* Make the unlink visible before the flip */
+
+  SMP_MB();
+
+  epoch = atomic_read(&g_rcu_epoch);
+  atomic_set_release(&g_rcu_epoch, epoch + 1);
+
+  /* Order the flip before the counter poll.  This pairs with the barrier
+   * in rcu_read_lock(): either the reader sees the new epoch and retries,
+   * or the writer sees its count.  Release and acquire alone don't order a
+   * store before a later load.
+   */
+
+  SMP_MB();
+
+  /* Sleep rather than yield, the reader may have a lower priority */
+
+  while (atomic_read_acquire(&g_rcu_readers[epoch & 1]) != 0)
+    {
+      nxsched_usleep(USEC_PER_TICK);
+    }
+
+  nxmutex_unlock(&g_rcu_gplock);
+}
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Call func with head from the low priority work queue after a grace
+ *   period.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+void call_rcu(FAR struct rcu_head_s *head, rcu_callback_t func)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(head != NULL && func != NULL);
+
+  head->next = NULL;
+  head->func = func;
+
+  flags = spin_lock_irqsave(&g_rcu_lock);
+  if (g_rcu_tail != NULL)
+    {
+      g_rcu_tail->next = head;
+    }
+  else
+    {
+      g_rcu_head = head;
+    }
+
+  g_rcu_tail = head;
+  spin_unlock_irqrestore(&g_rcu_lock, flags);
+
+  /* The worker takes the callbacks queued until it runs */
+
+  if (work_available(&g_rcu_work))
+    {
+      work_queue(LPWORK, &g_rcu_work, rcu_worker, NULL, 0);
+    }
+}
+#endif
@@ -0,0 +1,366 @@
+/****************************************************************************
+ * sched/mqueue/mq_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <assert.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <fcntl.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_verify_buf
+ *
+ * Description:
+ *   Verify that a message queue descriptor is usable for the requested
+ *   access and return its message queue.
+ *
+ ****************************************************************************/
+
+static FAR struct mqueue_inode_s *nxmq_verify_buf(FAR struct file *mq,
+                                                  int access,
+                                                  FAR int *errcode)
+{
+  FAR struct mqueue_inode_s *msgq;
+
+  if (mq == NULL || mq->f_inode == NULL ||
+      (msgq = mq->f_inode->i_private) == NULL)
+    {
+      *errcode = -EBADF;
+      return NULL;
+    }
+
+  if ((mq->f_oflags & access) == 0)
+    {
+      *errcode = -EBADF;
+      return NULL;
+    }
+
+  return msgq;
+}
+
+/****************************************************************************
+ * Name: nxmq_buf2msg
+ *
+ * Description:
+ *   Return the message that contains a buffer.
+ *
+ ****************************************************************************/
+
+static inline FAR struct mqueue_msg_s *nxmq_buf2msg(FAR void *buf)
+{
+  return container_of((FAR char *)buf, struct mqueue_msg_s, mail[0]);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_mq_allocbuf
+ *
+ * Description:
+ *   Allocate a message buffer that the caller fills in place and then
+ *   passes to file_mq_sendbuf().
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor, opened for writing
+ *   msglen - The size of the buffer, at most the mq_msgsize of the queue
+ *   buf    - Location to return the buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure:
+ *
+ *     EBADF    Message queue not opened for writing.
+ *     EMSGSIZE 'msglen' was greater than the maxmsgsize attribute of the
+ *               message queue.
+ *     ENOMEM   There is no free message.
+ *
+ ****************************************************************************/
+
+int file_mq_allocbuf(FAR struct file *mq, size_t msglen, FAR void **buf)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  int ret;
+
+  DEBUGASSERT(buf != NULL);
+
+  msgq = nxmq_verify_buf(mq, O_WROK, &ret);
+  if (msgq == NULL)
+    {
+      return ret;
+    }
+
+  if (msglen > (size_t)msgq->maxmsgsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  mqmsg = nxmq_alloc_msg(msglen);
+  if (mqmsg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Remember the size, a message may be sent shorter but not longer */
+
+  mqmsg->msglen = msglen;
+  *buf = mqmsg->mail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_freebuf
+ *
+ * Description:
+ *   Release a buffer from file_mq_allocbuf() that was not sent, or a
+ *   buffer received with file_mq_receivebufs().
+ *
+ * Input Parameters:
+ *   buf - The buffer to release
+ *
+ ****************************************************************************/
+
+void nxmq_freebuf(FAR void *buf)
+{
+  nxmq_free_msg(nxmq_buf2msg(buf));
+}
+
+/****************************************************************************
+ * Name: file_mq_sendbuf
+ *
+ * Description:
+ *   Add a buffer from file_mq_allocbuf() to the message queue without
+ *   copying it.  Otherwise this behaves like file_mq_timedsend().
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   buf     - The buffer holding the message
+ *   msglen  - The length of the message, at most the size of the buffer
+ *   prio    - The priority of the message
+ *   abstime - The absolute time to wait for room, NULL to wait forever
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success and the buffer then belongs to the
+ *   queue.  A negated errno value is returned on failure (see
+ *   file_mq_timedsend()) and the buffer then still belongs to the caller.
+ *
+ ****************************************************************************/
+
+int file_mq_sendbuf(FAR struct file *mq, FAR void *buf, size_t msglen,
+                    unsigned int prio, FAR const struct timespec *abstime)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  int ret;
+
+  if (buf == NULL || prio >= MQ_PRIO_MAX ||
+      (abstime && (abstime->tv_nsec < 0 ||
+                   abstime->tv_nsec >= 1000000000)))
+    {
+      return -EINVAL;
+    }
+
+  if (nxmq_verify_buf(mq, O_WROK, &ret) == NULL)
+    {
+      return ret;
+    }
+
+  mqmsg = nxmq_buf2msg(buf);
+  if (msglen > mqmsg->msglen)
+    {
+      return -EMSGSIZE;
+    }
+
+  mqmsg->msglen = msglen;
+  return nxmq_send_msg(mq, mqmsg, prio, abstime, -1);
+}
+
+/****************************************************************************
+ * Name: file_mq_receivebufs
+ *
+ * Description:
+ *   Take up to 'nbufs' messages off the message queue without copying
+ *   them, all within one critical section.  If the queue is empty, wait
+ *   for one message like file_mq_timedreceive() does.  Each buffer must be
+ *   released with nxmq_freebuf().
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   bufs    - Location to return the buffers, their lengths and priorities
+ *   nbufs   - The number of entries in 'bufs'
+ *   abstime - The absolute time to wait for a message, NULL to wait forever
+ *
+ * Returned Value:
+ *   The number of messages received, at least one, is returned on success.
+ *   A negated errno value is returned on failure (see
+ *   file_mq_timedreceive()).
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_receivebufs(FAR struct file *mq,
+                            FAR struct mqueue_buf_s *bufs, int nbufs,
+                            FAR const struct timespec *abstime)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+  int n = 0;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (bufs == NULL || nbufs <= 0 ||
+      (abstime && (abstime->tv_nsec < 0 ||
+                   abstime->tv_nsec >= 1000000000)))
+    {
+      return -EINVAL;
+    }
+
+  msgq = nxmq_verify_buf(mq, O_RDOK, &ret);
+  if (msgq == NULL)
+    {
+      return ret;
+    }
+
+  /* nxmq_wait_receive() expects to have interrupts disabled because
+   * messages can be sent from interrupt level.
+   */
+
+  flags = enter_critical_section();
+
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+  if (mqmsg == NULL)
+    {
+      if ((mq->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      ret = nxmq_wait_receive(msgq, &mqmsg, abstime, -1);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  /* Drain what is there, waking one blocked sender per message taken */
+
+  do
+    {
+      if (msgq->nmsgs-- == msgq->maxmsgs)
+        {
+          nxmq_pollnotify(msgq, POLLOUT);
+        }
+
+      nxmq_notify_receive(msgq);
+
+      bufs[n].buf    = mqmsg->mail;
+      bufs[n].msglen = mqmsg->msglen;
+      bufs[n].prio   = mqmsg->priority;
+      n++;
+    }
+  while (n < nbufs &&
+         (mqmsg = (FAR struct mqueue_msg_s *)
+                  list_remove_head(&msgq->msglist)) != NULL);
+
+  leave_critical_section(flags);
+  return n;
+}
+
+/****************************************************************************
+ * Name: nxmq_allocbuf, nxmq_sendbuf and nxmq_receivebufs
+ *
+ * Description:
+ *   The same as file_mq_allocbuf(), file_mq_sendbuf() and
+ *   file_mq_receivebufs(), with a message queue descriptor.
+ *
+ ****************************************************************************/
+
+int nxmq_allocbuf(mqd_t mqdes, size_t msglen, FAR void **buf)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = file_get(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_allocbuf(filep, msglen, buf);
+  file_put(filep);
+  return ret;
+}
+
+int nxmq_sendbuf(mqd_t mqdes, FAR void *buf, size_t msglen,
+                 unsigned int prio, FAR const struct timespec *abstime)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = file_get(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_sendbuf(filep, buf, msglen, prio, abstime);
+  file_put(filep);
+  return ret;
+}
+
+ssize_t nxmq_receivebufs(mqd_t mqdes, FAR struct mqueue_buf_s *bufs,
+                         int nbufs, FAR const struct timespec *abstime)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  ret = file_get(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_receivebufs(filep, bufs, nbufs, abstime);
+  file_put(filep);
+  return ret;
+}
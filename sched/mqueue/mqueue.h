@@ -40,6 +40,8 @@
 #include <nuttx/spinlock.h>
 #include <nuttx/mqueue.h>
 
+#include "sched/sched.h"
+
 #if defined(CONFIG_MQ_MAXMSGSIZE) && CONFIG_MQ_MAXMSGSIZE > 0
 
 /****************************************************************************
@@ -110,6 +112,7 @@ EXTERN spinlock_t g_msgfreelock;
 
 struct tcb_s;        /* Forward reference */
 struct task_group_s; /* Forward reference */
+struct file;         /* Forward reference */
 
 /* Functions defined in mq_initialize.c *************************************/
 
@@ -131,6 +134,13 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
                       sclock_t ticks);
 void nxmq_notify_receive(FAR struct mqueue_inode_s *msgq);
 
+/* mq_send.c ****************************************************************/
+
+FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize);
+int nxmq_send_msg(FAR struct file *mq, FAR struct mqueue_msg_s *mqmsg,
+                  unsigned int prio, FAR const struct timespec *abstime,
+                  sclock_t ticks);
+
 /* mq_sndinternal.c *********************************************************/
 
 int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
@@ -142,6 +152,26 @@ void nxmq_notify_send(FAR struct mqueue_inode_s *msgq);
 
 void nxmq_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* The message free lists are protected by g_msgfreelock */
+
+static inline_function irqstate_t nxmq_lock_msgfree(void)
+{
+  irqstate_t flags = spin_lock_irqsave(&g_msgfreelock);
+
+  nxsched_critmon_subsys(CRITMON_SUBSYS_MQUEUE, true);
+  return flags;
+}
+
+static inline_function void nxmq_unlock_msgfree(irqstate_t flags)
+{
+  nxsched_critmon_subsys(CRITMON_SUBSYS_MQUEUE, false);
+  spin_unlock_irqrestore(&g_msgfreelock, flags);
+}
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -42,6 +42,17 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* A released TCB can be cached if it is a pthread TCB allocated by
+ * nx_pthread_create() together with its stack.
+ */
+
+#ifdef CONFIG_PTHREAD_CACHE
+#  define PTHREAD_CACHE_FLAGS (TCB_FLAG_FREE_TCB | TCB_FLAG_FREE_STACK)
+#  define PTHREAD_CACHE_KEEP(tcb, ttype) \
+     ((ttype) == TCB_FLAG_TTYPE_PTHREAD && (tcb)->stack_alloc_ptr != NULL && \
+      ((tcb)->flags & PTHREAD_CACHE_FLAGS) == PTHREAD_CACHE_FLAGS)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -78,6 +89,12 @@ void pthread_mutex_inconsistent(FAR struct tls_info_s *tls);
 int pthread_mutexattr_verifytype(int type);
 #endif
 
+#ifdef CONFIG_PTHREAD_CACHE
+FAR struct tcb_s *pthread_cache_get(size_t stack_size);
+void pthread_cache_put(FAR struct tcb_s *tcb);
+void pthread_cache_latency(clock_t elapsed);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
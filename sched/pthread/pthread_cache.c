@@ -0,0 +1,320 @@
+/****************************************************************************
+ * sched/pthread/pthread_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/pthread.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/wqueue.h>
+
+#include "pthread/pthread.h"
+
+#ifdef CONFIG_PTHREAD_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A cached pthread TCB.  It lives in the memory of the TCB, in the part
+ * that is cleared when the TCB is reused.
+ */
+
+struct pthread_cache_s
+{
+  sq_entry_t node;                  /* Entry in g_pthread_cache */
+  FAR void *stack_alloc_ptr;        /* The stack allocation */
+  size_t stack_size;                /* Stack size set by up_create_stack() */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* TCBs ready for reuse and, if their stacks get cleared, TCBs waiting for
+ * their stack to be cleared.
+ */
+
+static sq_queue_t g_pthread_cache;
+#ifdef CONFIG_PTHREAD_CACHE_CLEAR
+static sq_queue_t g_pthread_cache_dirty;
+static struct work_s g_pthread_cache_work;
+#endif
+
+/* Number of TCBs on both lists, and the statistics */
+
+static int g_pthread_cache_count;
+static struct pthread_cache_stats_s g_pthread_cache_stats;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cache_free
+ *
+ * Description:
+ *   Release a TCB that does not fit in the cache, and its stack.
+ *
+ ****************************************************************************/
+
+static void pthread_cache_free(FAR struct tcb_s *tcb)
+{
+  up_release_stack(tcb, TCB_FLAG_TTYPE_PTHREAD);
+  kmm_free(tcb);
+}
+
+/****************************************************************************
+ * Name: pthread_cache_worker
+ *
+ * Description:
+ *   Clear the stacks of the released TCBs, moving them to the cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_CACHE_CLEAR
+static void pthread_cache_worker(FAR void *arg)
+{
+  FAR struct pthread_cache_s *entry;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      entry = (FAR struct pthread_cache_s *)
+        sq_remfirst(&g_pthread_cache_dirty);
+      leave_critical_section(flags);
+
+      if (entry == NULL)
+        {
+          break;
+        }
+
+      memset(entry->stack_alloc_ptr, 0, entry->stack_size);
+
+      flags = enter_critical_section();
+      sq_addfirst(&entry->node, &g_pthread_cache);
+      leave_critical_section(flags);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cache_get
+ *
+ * Description:
+ *   Take a released pthread TCB whose stack has the requested size out of
+ *   the cache.
+ *
+ * Input Parameters:
+ *   stack_size - The stack size that will be passed to up_create_stack()
+ *
+ * Returned Value:
+ *   A zeroed TCB with the stack of the requested size attached, which
+ *   up_create_stack() will reuse; NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *pthread_cache_get(size_t stack_size)
+{
+  FAR struct pthread_cache_s *entry;
+  FAR struct tcb_s *tcb = NULL;
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *curr;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  for (curr = sq_peek(&g_pthread_cache); curr != NULL; curr = curr->flink)
+    {
+      entry = (FAR struct pthread_cache_s *)curr;
+      if (entry->stack_size == stack_size)
+        {
+          if (prev != NULL)
+            {
+              sq_remafter(prev, &g_pthread_cache);
+            }
+          else
+            {
+              sq_remfirst(&g_pthread_cache);
+            }
+
+          g_pthread_cache_count--;
+          tcb = (FAR struct tcb_s *)entry;
+          break;
+        }
+
+      prev = curr;
+    }
+
+  if (tcb != NULL)
+    {
+      g_pthread_cache_stats.hits++;
+    }
+  else
+    {
+      g_pthread_cache_stats.misses++;
+    }
+
+  leave_critical_section(flags);
+
+  if (tcb != NULL)
+    {
+      FAR void *stack_alloc_ptr = entry->stack_alloc_ptr;
+
+      /* Leave the stack as up_create_stack() found it, so that it keeps
+       * the allocation instead of replacing it.
+       */
+
+      memset(tcb, 0, sizeof(struct tcb_s) + sizeof(struct pthread_entry_s));
+
+      tcb->stack_alloc_ptr = stack_alloc_ptr;
+      tcb->stack_base_ptr  = stack_alloc_ptr;
+      tcb->adj_stack_size  = stack_size;
+      tcb->flags           = TCB_FLAG_FREE_STACK;
+    }
+
+  return tcb;
+}
+
+/****************************************************************************
+ * Name: pthread_cache_put
+ *
+ * Description:
+ *   Keep a pthread TCB released by nxsched_release_tcb() and its stack for
+ *   reuse, or free them if the cache is full.
+ *
+ * Input Parameters:
+ *   tcb - A TCB for which PTHREAD_CACHE_KEEP() is true.  It is not used by
+ *         the caller afterwards.
+ *
+ ****************************************************************************/
+
+void pthread_cache_put(FAR struct tcb_s *tcb)
+{
+  FAR struct pthread_cache_s *entry = (FAR struct pthread_cache_s *)tcb;
+  FAR void *stack_alloc_ptr = tcb->stack_alloc_ptr;
+  size_t stack_size;
+  irqstate_t flags;
+
+  /* up_stack_frame() moved the base of the stack up for the TLS, the top
+   * of the stack is where up_create_stack() put it.
+   */
+
+  stack_size = (uintptr_t)tcb->stack_base_ptr + tcb->adj_stack_size -
+               (uintptr_t)stack_alloc_ptr;
+
+  flags = enter_critical_section();
+
+  if (g_pthread_cache_count >= CONFIG_PTHREAD_CACHE_NENTRIES)
+    {
+      leave_critical_section(flags);
+      pthread_cache_free(tcb);
+      return;
+    }
+
+  entry->stack_alloc_ptr = stack_alloc_ptr;
+  entry->stack_size      = stack_size;
+  g_pthread_cache_count++;
+
+#ifdef CONFIG_PTHREAD_CACHE_CLEAR
+  /* The stack may still be in use if this is the exiting thread, clear it
+   * later from the work queue.
+   */
+
+  sq_addlast(&entry->node, &g_pthread_cache_dirty);
+  if (work_available(&g_pthread_cache_work))
+    {
+      work_queue(LPWORK, &g_pthread_cache_work, pthread_cache_worker,
+                 NULL, 0);
+    }
+#else
+  sq_addfirst(&entry->node, &g_pthread_cache);
+#endif
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: pthread_cache_latency
+ *
+ * Description:
+ *   Account the time nx_pthread_create() took to set up a thread.
+ *
+ * Input Parameters:
+ *   elapsed - The setup time in perf_gettime() units
+ *
+ ****************************************************************************/
+
+void pthread_cache_latency(clock_t elapsed)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  g_pthread_cache_stats.ncreated++;
+  g_pthread_cache_stats.total += elapsed;
+  if (elapsed > g_pthread_cache_stats.max)
+    {
+      g_pthread_cache_stats.max = elapsed;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nx_pthread_cache_stats
+ *
+ * Description:
+ *   Get the statistics of the pthread TCB and stack cache.
+ *
+ * Input Parameters:
+ *   stats - Location to return the statistics
+ *
+ ****************************************************************************/
+
+void nx_pthread_cache_stats(FAR struct pthread_cache_stats_s *stats)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  *stats         = g_pthread_cache_stats;
+  stats->ncached = g_pthread_cache_count;
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_PTHREAD_CACHE */
@@ -38,6 +38,8 @@
 #include <nuttx/queue.h>
 #include <nuttx/sched.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/pthread.h>
@@ -185,7 +187,10 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
                       pthread_startroutine_t entry, pthread_addr_t arg)
 {
   pthread_attr_t default_attr = g_default_pthread_attr;
-  FAR struct tcb_s *ptcb;
+  FAR struct tcb_s *ptcb = NULL;
+#ifdef CONFIG_PTHREAD_CACHE
+  clock_t start = perf_gettime();
+#endif
   struct sched_param param;
   FAR struct tcb_s *parent;
   int policy;
@@ -201,9 +206,18 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
 
   if (!attr)
     {
-      /* Inherit parent priority by default. except idle */
+      /* Inherit parent priority by default. except idle.  A
+       * SCHED_DEADLINE parent runs in the deadline band, which the new
+       * SCHED_FIFO thread must not enter without admission, so it keeps
+       * the default priority then.
+       */
 
-      if (!is_idle_task(parent))
+      if (!is_idle_task(parent)
+#ifdef CONFIG_SCHED_DEADLINE
+          && (parent->flags & TCB_FLAG_POLICY_MASK) !=
+             TCB_FLAG_SCHED_DEADLINE
+#endif
+         )
         {
           default_attr.priority = parent->sched_priority;
         }
@@ -211,9 +225,23 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
       attr = &default_attr;
     }
 
-  /* Allocate a TCB for the new task. */
+  /* Allocate a TCB for the new task, reusing a cached one with a stack of
+   * the same size if possible.
+   */
+
+#ifdef CONFIG_PTHREAD_CACHE
+  if (attr->stackaddr == NULL)
+    {
+      ptcb = pthread_cache_get(attr->stacksize + attr->guardsize);
+    }
+
+  if (ptcb == NULL)
+#endif
+    {
+      ptcb = kmm_zalloc(sizeof(struct tcb_s) +
+                        sizeof(struct pthread_entry_s));
+    }
 
-  ptcb = kmm_zalloc(sizeof(struct tcb_s) + sizeof(struct pthread_entry_s));
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -306,6 +334,17 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
           errcode = -policy;
           goto errout_with_tcb;
         }
+
+#ifdef CONFIG_SCHED_DEADLINE
+      /* The current priority of a SCHED_DEADLINE thread depends on its
+       * remaining budget; the new thread starts in the deadline band.
+       */
+
+      if (policy == SCHED_DEADLINE)
+        {
+          param.sched_priority = CONFIG_SCHED_DEADLINE_PRIORITY;
+        }
+#endif
     }
   else
     {
@@ -410,6 +449,33 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A thread inheriting SCHED_DEADLINE reserves its own bandwidth with the
+   * parameters of the parent and so is subject to the same admission
+   * control as sched_setattr().  This is done after the last step that can
+   * fail, as nxsched_release_tcb() does not release the bandwidth.
+   */
+
+  if (policy == SCHED_DEADLINE)
+    {
+      FAR struct deadline_s *dl;
+      irqstate_t flags;
+
+      flags = enter_critical_section();
+      dl = parent->deadline;
+      ret = dl != NULL ? nxsched_start_deadline(ptcb, dl->runtime,
+                                                dl->deadline, dl->period) :
+                         -EINVAL;
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_tcb;
+        }
+    }
+#endif
+
   /* Configure the TCB for a pthread receiving on parameter
    * passed by value
    */
@@ -443,6 +509,12 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
         ptcb->flags    |= TCB_FLAG_SCHED_SPORADIC;
         break;
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        ptcb->flags    |= TCB_FLAG_SCHED_DEADLINE;
+        break;
+#endif
     }
 
   /* Return the thread information to the caller */
@@ -452,6 +524,10 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
       *thread = (pthread_t)ptcb->pid;
     }
 
+#ifdef CONFIG_PTHREAD_CACHE
+  pthread_cache_latency(perf_gettime() - start);
+#endif
+
   /* Then activate the task */
 
   nxtask_activate(ptcb);
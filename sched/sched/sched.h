@@ -52,7 +52,13 @@
  * need to be prioritized).
  */
 
-#define list_readytorun()        (&g_readytorun)
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+#  define list_readytorun()      (g_readytorun)
+#  define list_cpureadytorun(cpu) (&g_readytorun[cpu])
+#else
+#  define list_readytorun()      (&g_readytorun)
+#  define list_cpureadytorun(cpu) (&g_readytorun)
+#endif
 #ifndef CONFIG_SMP
 #define list_pendingtasks()      (&g_pendingtasks)
 #endif
@@ -74,6 +80,19 @@
 
 #define is_idle_task(t)          ((t)->pid < CONFIG_SMP_NCPUS)
 
+/* The set of all CPUs, the CPUs reserved for explicitly bound tasks and
+ * the CPUs left over for everything else.
+ */
+
+#ifdef CONFIG_SMP
+#  define SCHED_ALL_CPUS         ((cpu_set_t)((1 << CONFIG_SMP_NCPUS) - 1))
+#  define SCHED_ISOLATED_CPUS \
+     ((cpu_set_t)(CONFIG_SMP_ISOLATED_CPUSET & SCHED_ALL_CPUS))
+#  define SCHED_HOUSEKEEPING_CPUS \
+     ((SCHED_ALL_CPUS & ~SCHED_ISOLATED_CPUS) != 0 ? \
+      (cpu_set_t)(SCHED_ALL_CPUS & ~SCHED_ISOLATED_CPUS) : (cpu_set_t)1)
+#endif
+
 /* This macro returns the running task which may different from this_task()
  * during interrupt level context switches.
  */
@@ -165,7 +184,16 @@ enum task_deliver_e
  * task, is always the IDLE task.
  */
 
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+/* With CONFIG_SCHED_PERCPU_READYTORUN each CPU owns its own prioritized
+ * ready-to-run list.  A task in the TSTATE_TASK_READYTORUN state is always
+ * kept in the list indexed by its tcb->cpu field.
+ */
+
+extern dq_queue_t g_readytorun[CONFIG_SMP_NCPUS];
+#else
 extern dq_queue_t g_readytorun;
+#endif
 
 #ifdef CONFIG_SMP
 /* In order to support SMP, the function of the g_readytorun list changes,
@@ -366,6 +394,14 @@ clock_t nxsched_process_sporadic(FAR struct tcb_s *tcb, clock_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb, clock_t runtime,
+                            clock_t deadline, clock_t period);
+int  nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_resume_deadline(FAR struct tcb_s *tcb);
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -407,6 +443,7 @@ void nxsched_checkstackoverflow(FAR struct tcb_s *tcb);
 #endif
 
 #ifdef CONFIG_SMP
+FAR struct tcb_s *nxsched_peek_readytorun(int cpu, int sched_priority);
 bool nxsched_switch_running(int cpu, bool switch_equal);
 void nxsched_process_delivered(int cpu);
 #else
@@ -445,6 +482,30 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
                               FAR void *caller);
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0
+void nxsched_critmon_subsys(int subsys, bool state);
+#else
+#  define nxsched_critmon_subsys(s, st)
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+void nxsched_critmon_irq(bool state);
+clock_t nxsched_critmon_runtime(FAR struct tcb_s *tcb);
+void nxsched_critmon_work(clock_t start);
+#else
+#  define nxsched_critmon_irq(s)
+#endif
+
+/* Scheduling latency histograms */
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+void nxsched_latency_wakeup(FAR struct tcb_s *tcb);
+void nxsched_latency_resume(FAR struct tcb_s *tcb);
+#else
+#  define nxsched_latency_wakeup(t)
+#  define nxsched_latency_resume(t)
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
@@ -459,6 +520,22 @@ FAR char **nxsched_get_stackargs(FAR struct tcb_s *tcb);
  * Inline functions
  ****************************************************************************/
 
+/* SCHED_DEADLINE threads of equal priority are kept in order of their
+ * absolute deadlines.  Returns true if tcb must be queued before next.
+ */
+
+#ifdef CONFIG_SCHED_DEADLINE
+static inline_function bool nxsched_deadline_before(FAR struct tcb_s *tcb,
+                                                    FAR struct tcb_s *next)
+{
+  return (tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+         (next->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+         (sclock_t)(tcb->deadline->abstime - next->deadline->abstime) < 0;
+}
+#else
+#  define nxsched_deadline_before(tcb, next) false
+#endif
+
 static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
                                                     DSEG dq_queue_t *list)
 {
@@ -476,7 +553,9 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && (sched_priority < next->sched_priority ||
+                 (sched_priority == next->sched_priority &&
+                  !nxsched_deadline_before(tcb, next))));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
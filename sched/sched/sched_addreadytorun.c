@@ -122,6 +122,96 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
 #else /* !CONFIG_SMP */
 
+/****************************************************************************
+ * Name:  nxsched_peek_readytorun
+ *
+ * Description:
+ *   Find the highest priority task in the ready-to-run list(s) that is
+ *   allowed to run on the CPU 'cpu' and has a priority higher than
+ *   'sched_priority'.  The task is not removed from its list.
+ *
+ *   With CONFIG_SCHED_PERCPU_READYTORUN, the CPU's own list is searched
+ *   first and the lists of the other CPUs are then searched for a task of
+ *   even higher priority that may be stolen.  If several peers hold an
+ *   eligible task of the same priority, the first one found starting from
+ *   the CPU next to 'cpu' is taken so that stealing is spread evenly.
+ *
+ * Input Parameters:
+ *   cpu            - The CPU that is looking for a task to run
+ *   sched_priority - Only tasks with higher priority are considered
+ *
+ * Returned Value:
+ *   The TCB of the task found or NULL if there is no such task.  NULL is
+ *   the normal result on a CPU that has nothing else to run, whether the
+ *   ready-to-run lists are per-CPU or not, so every caller must check it.
+ *
+ * Assumptions:
+ * - The caller has established a critical section
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_peek_readytorun(int cpu, int sched_priority)
+{
+  FAR struct tcb_s *btcb;
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+  FAR struct tcb_s *stcb;
+  int i;
+#endif
+
+  /* Check if the task found in ready-to-run list is allowed to run on
+   * this CPU. TCB_FLAG_CPU_LOCKED may be used to override affinity. If
+   * the flag is set, assume that btcb->cpu is valid, and it is the only
+   * CPU on which the btcb can run.
+   */
+
+  for (btcb = (FAR struct tcb_s *)dq_peek(list_cpureadytorun(cpu));
+       btcb && btcb->sched_priority > sched_priority;
+       btcb = btcb->flink)
+    {
+      if (CPU_ISSET(cpu, &btcb->affinity) &&
+          ((btcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || btcb->cpu == cpu))
+        {
+          break;
+        }
+    }
+
+  if (btcb != NULL && btcb->sched_priority <= sched_priority)
+    {
+      btcb = NULL;
+    }
+
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+  /* Only steal a task from a peer if it has a higher priority than the
+   * best candidate in the local list.
+   */
+
+  if (btcb != NULL)
+    {
+      sched_priority = btcb->sched_priority;
+    }
+
+  for (i = 1; i < CONFIG_SMP_NCPUS; i++)
+    {
+      int peer = (cpu + i) % CONFIG_SMP_NCPUS;
+
+      for (stcb = (FAR struct tcb_s *)dq_peek(list_cpureadytorun(peer));
+           stcb && stcb->sched_priority > sched_priority;
+           stcb = stcb->flink)
+        {
+          if (CPU_ISSET(cpu, &stcb->affinity) &&
+              (stcb->flags & TCB_FLAG_CPU_LOCKED) == 0)
+            {
+              btcb = stcb;
+              sched_priority = stcb->sched_priority;
+              break;
+            }
+        }
+    }
+#endif
+
+  return btcb;
+}
+
 /****************************************************************************
  * Name:  nxsched_switch_running
  *
@@ -173,43 +263,31 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
    * switch the current task to that one.
    */
 
-  for (btcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
-       btcb && btcb->sched_priority > sched_priority;
-       btcb = btcb->flink)
+  btcb = nxsched_peek_readytorun(cpu, sched_priority);
+  if (btcb != NULL)
     {
-      /* Check if the task found in ready-to-run list is allowed to run on
-       * this CPU. TCB_FLAG_CPU_LOCKED may be used to override affinity. If
-       * the flag is set, assume that btcb->cpu is valid, and it is the only
-       * CPU on which the btcb can run.
-       */
-
-      if (CPU_ISSET(cpu, &btcb->affinity) &&
-          ((btcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || btcb->cpu == cpu))
-        {
-          /* Found a task, remove it from ready-to-run list */
+      /* Found a task, remove it from ready-to-run list */
 
-          dq_rem((FAR struct dq_entry_s *)btcb, list_readytorun());
+      dq_rem((FAR struct dq_entry_s *)btcb, list_cpureadytorun(btcb->cpu));
 
-          if (!is_idle_task(rtcb))
-            {
-              /* Put currently running task back to ready-to-run list */
+      if (!is_idle_task(rtcb))
+        {
+          /* Put currently running task back to ready-to-run list */
 
-              rtcb->task_state = TSTATE_TASK_READYTORUN;
-              nxsched_add_prioritized(rtcb, list_readytorun());
-            }
-          else
-            {
-              rtcb->task_state = TSTATE_TASK_ASSIGNED;
-            }
+          rtcb->task_state = TSTATE_TASK_READYTORUN;
+          nxsched_add_prioritized(rtcb, list_cpureadytorun(cpu));
+        }
+      else
+        {
+          rtcb->task_state = TSTATE_TASK_ASSIGNED;
+        }
 
-          g_assignedtasks[cpu] = btcb;
-          up_update_task(btcb);
+      g_assignedtasks[cpu] = btcb;
+      up_update_task(btcb);
 
-          btcb->cpu = cpu;
-          btcb->task_state = TSTATE_TASK_RUNNING;
-          ret = true;
-          break;
-        }
+      btcb->cpu = cpu;
+      btcb->task_state = TSTATE_TASK_RUNNING;
+      ret = true;
     }
 
   return ret;
@@ -256,12 +334,38 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   int target_cpu = btcb->flags & TCB_FLAG_CPU_LOCKED ? btcb->cpu :
     nxsched_select_cpu(btcb->affinity);
 
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+  /* Queue the btcb on the ready-to-run list of the target CPU.  If no CPU
+   * can run it right now, keep it on the list of the CPU that it last ran
+   * on (if still permitted by its affinity) where it will be either picked
+   * up by its owner or stolen by a peer.
+   */
+
+  if (target_cpu < CONFIG_SMP_NCPUS)
+    {
+      btcb->cpu = target_cpu;
+    }
+  else if (!CPU_ISSET(btcb->cpu, &btcb->affinity))
+    {
+      int cpu;
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          if (CPU_ISSET(cpu, &btcb->affinity))
+            {
+              btcb->cpu = cpu;
+              break;
+            }
+        }
+    }
+#endif
+
   /* Add the btcb to the ready to run list, and try to run it on the target
    * CPU
    */
 
   btcb->task_state = TSTATE_TASK_READYTORUN;
-  nxsched_add_prioritized(btcb, list_readytorun());
+  nxsched_add_prioritized(btcb, list_cpureadytorun(btcb->cpu));
 
   if (target_cpu < CONFIG_SMP_NCPUS)
     {
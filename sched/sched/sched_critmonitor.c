@@ -86,6 +86,21 @@
 #  define CHECK_BUSYWAIT(pid, elapsed)
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS > 0
+#  define CHECK_SUBSYS(subsys, elapsed) \
+     do \
+       { \
+         if (elapsed > CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS) \
+           { \
+             CRITMONITOR_PANIC("Subsystem %d hold lock too long %" \
+                               PRIu32 "\n", subsys, elapsed); \
+           } \
+       } \
+     while (0)
+#else
+#  define CHECK_SUBSYS(subsys, elapsed)
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD > 0
 #  define CHECK_THREAD(pid, elapsed) \
      do \
@@ -102,6 +117,12 @@
 #  define CHECK_THREAD(pid, elapsed)
 #endif
 
+#ifdef CONFIG_SMP
+#  define TCB_CPU(tcb) ((tcb)->cpu)
+#else
+#  define TCB_CPU(tcb) 0
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -110,6 +131,20 @@
 static spinlock_t g_crimonitor_lock = SP_UNLOCKED;
 #endif
 
+/* Start time and nesting level of the subsystem lock held on each CPU */
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0
+static clock_t g_subsys_start[CONFIG_SMP_NCPUS][CRITMON_SUBSYS_NUM];
+static uint8_t g_subsys_nest[CONFIG_SMP_NCPUS][CRITMON_SUBSYS_NUM];
+#endif
+
+/* Start time and nesting level of the interrupt handled on each CPU */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+static clock_t g_irq_start[CONFIG_SMP_NCPUS];
+static uint8_t g_irq_nest[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -129,6 +164,16 @@ clock_t g_busywait_max[CONFIG_SMP_NCPUS];
 clock_t g_busywait_total[CONFIG_SMP_NCPUS];
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0
+clock_t g_subsys_max[CONFIG_SMP_NCPUS][CRITMON_SUBSYS_NUM];
+clock_t g_subsys_total[CONFIG_SMP_NCPUS][CRITMON_SUBSYS_NUM];
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+clock_t g_cputime_irq[CONFIG_SMP_NCPUS];
+clock_t g_cputime_work[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -295,6 +340,54 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/****************************************************************************
+ * Name: nxsched_critmon_subsys
+ *
+ * Description:
+ *   Called when a subsystem acquires or releases the lock protecting its
+ *   internal data.  Only the outermost acquisition on each CPU is timed.
+ *
+ * Assumptions:
+ *   - Called with local interrupts disabled.
+ *   - Might be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0
+void nxsched_critmon_subsys(int subsys, bool state)
+{
+  clock_t current = perf_gettime();
+  int cpu         = this_cpu();
+
+  DEBUGASSERT(subsys >= 0 && subsys < CRITMON_SUBSYS_NUM);
+
+  /* Are we taking or releasing the subsystem lock? */
+
+  if (state)
+    {
+      /* Taking... Save the start time of the outermost acquisition */
+
+      if (g_subsys_nest[cpu][subsys]++ == 0)
+        {
+          g_subsys_start[cpu][subsys] = current;
+        }
+    }
+  else if (--g_subsys_nest[cpu][subsys] == 0)
+    {
+      /* Released... Check for the max elapsed time */
+
+      clock_t elapsed = current - g_subsys_start[cpu][subsys];
+
+      g_subsys_total[cpu][subsys] += elapsed;
+      if (elapsed > g_subsys_max[cpu][subsys])
+        {
+          g_subsys_max[cpu][subsys] = elapsed;
+          CHECK_SUBSYS(subsys, elapsed);
+        }
+    }
+}
+#endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS >= 0 */
+
 /****************************************************************************
  * Name: nxsched_critmon_busywait
  *
@@ -352,6 +445,92 @@ void nxsched_critmon_busywait(bool state, FAR void *caller)
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT >= 0 */
 
+/****************************************************************************
+ * Name: nxsched_critmon_irq
+ *
+ * Description:
+ *   Called when the interrupt dispatch is entered or left.  Only the
+ *   outermost interrupt on each CPU is timed, its time is accounted to the
+ *   CPU and removed from the run time of the interrupted thread.
+ *
+ * Assumptions:
+ *   - Called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+void nxsched_critmon_irq(bool state)
+{
+  clock_t current = perf_gettime();
+  int cpu         = this_cpu();
+
+  if (state)
+    {
+      if (g_irq_nest[cpu]++ == 0)
+        {
+          g_irq_start[cpu] = current;
+        }
+    }
+  else if (--g_irq_nest[cpu] == 0)
+    {
+      clock_t elapsed = current - g_irq_start[cpu];
+
+      /* The context switch requested by the handler happens only after
+       * the dispatch, g_running_tasks still holds the interrupted thread.
+       */
+
+      g_cputime_irq[cpu] += elapsed;
+      g_running_tasks[cpu]->run_start += elapsed;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_critmon_runtime
+ *
+ * Description:
+ *   Return the run time of a thread including its current time slice.
+ *
+ ****************************************************************************/
+
+clock_t nxsched_critmon_runtime(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags = up_irq_save();
+  clock_t runtime  = tcb->run_time;
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      runtime += perf_gettime() - tcb->run_start;
+    }
+
+  up_irq_restore(flags);
+  return runtime;
+}
+
+/****************************************************************************
+ * Name: nxsched_critmon_work
+ *
+ * Description:
+ *   Called by a work queue thread after a work item completed, account the
+ *   run time the worker consumed since start to the current CPU.
+ *
+ * Input Parameters:
+ *   start - The run time of the worker thread when the work item started,
+ *           as returned by nxsched_critmon_runtime().
+ *
+ ****************************************************************************/
+
+void nxsched_critmon_work(clock_t start)
+{
+  FAR struct tcb_s *tcb = this_task();
+  clock_t elapsed       = nxsched_critmon_runtime(tcb) - start;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  g_cputime_work[this_cpu()] += elapsed;
+  up_irq_restore(flags);
+}
+#endif /* CONFIG_SCHED_CRITMONITOR_CPUTIME */
+
 /****************************************************************************
  * Name: nxsched_switch_critmon
  *
@@ -379,7 +558,11 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
 
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
   from->run_time += elapsed;
-  to->run_time = current;
+  to->run_start = current;
+#  ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+  from->run_cpu[this_cpu()] += elapsed;
+#  endif
+
   if (elapsed > from->run_max)
     {
       from->run_max = elapsed;
@@ -415,10 +598,6 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
         }
     }
 
-  if (to->lockcount > 0)
-    {
-      to->premp_start = current;
-    }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION */
 
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
@@ -462,7 +641,7 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
     {
       /* Yes.. Save the start time */
 
-      to->premp_start = current;
+      to->preemp_start = current;
     }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION */
 }
@@ -484,6 +663,10 @@ void nxsched_update_critmon(FAR struct tcb_s *tcb)
 
   tcb->run_start = current;
   tcb->run_time += elapsed;
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+  tcb->run_cpu[TCB_CPU(tcb)] += elapsed;
+#endif
+
   if (elapsed > tcb->run_max)
     {
       tcb->run_max = elapsed;
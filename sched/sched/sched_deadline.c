@@ -0,0 +1,402 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths are expressed as fixed point fractions of one CPU */
+
+#define DEADLINE_BW_SHIFT 20
+#define DEADLINE_BW_LIMIT \
+  ((((uint64_t)CONFIG_SCHED_DEADLINE_UTILIZATION * CONFIG_SMP_NCPUS) << \
+    DEADLINE_BW_SHIFT) / 100)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void deadline_budget_expire(wdparm_t arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of the bandwidths of all admitted SCHED_DEADLINE threads */
+
+static uint64_t g_deadline_bw;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_set_priority
+ *
+ * Description:
+ *   Move the thread to a new priority.  If the priority of the thread is
+ *   currently boosted by priority inheritance, only the base priority is
+ *   changed and the thread keeps running at the boosted priority.
+ *
+ * Input Parameters:
+ *   tcb      - TCB of task whose priority will be modified
+ *   priority - The new priority
+ *
+ ****************************************************************************/
+
+static void deadline_set_priority(FAR struct tcb_s *tcb, int priority)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority > priority)
+    {
+      tcb->base_priority = priority;
+      return;
+    }
+#endif
+
+  DEBUGVERIFY(nxsched_reprioritize(tcb, priority));
+}
+
+/****************************************************************************
+ * Name: deadline_budget_start
+ *
+ * Description:
+ *   Start consuming the remaining budget of the current period.
+ *
+ ****************************************************************************/
+
+static void deadline_budget_start(FAR struct deadline_s *dl, clock_t now)
+{
+  dl->running   = true;
+  dl->eventtime = now;
+  wd_start(&dl->budget_timer, dl->remaining, deadline_budget_expire,
+           (wdparm_t)dl);
+}
+
+/****************************************************************************
+ * Name: deadline_budget_expire
+ *
+ * Description:
+ *   Handles the expiration of the budget timer: the thread has consumed all
+ *   of the runtime granted in this period and is throttled to the lowest
+ *   priority until the next period begins.
+ *
+ * Input Parameters:
+ *   arg - The deadline_s structure of the thread
+ *
+ * Assumptions:
+ *   Called from the watchdog timer handler with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void deadline_budget_expire(wdparm_t arg)
+{
+  FAR struct deadline_s *dl = (FAR struct deadline_s *)arg;
+  FAR struct tcb_s *tcb = dl->tcb;
+
+  dl->running   = false;
+  dl->remaining = 0;
+  dl->throttled = true;
+
+  /* The priority cannot be dropped while the thread holds the scheduler
+   * lock; retry on the next tick.
+   */
+
+  if (nxsched_islocked_tcb(tcb))
+    {
+      dl->running = true;
+      wd_start(&dl->budget_timer, 1, deadline_budget_expire, arg);
+      return;
+    }
+
+  deadline_set_priority(tcb, SCHED_PRIORITY_MIN);
+}
+
+/****************************************************************************
+ * Name: deadline_period_expire
+ *
+ * Description:
+ *   Handles the start of a new period: the budget is replenished, the
+ *   absolute deadline moves forward and a throttled thread gets its
+ *   priority back.
+ *
+ * Input Parameters:
+ *   arg - The deadline_s structure of the thread
+ *
+ * Assumptions:
+ *   Called from the watchdog timer handler with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void deadline_period_expire(wdparm_t arg)
+{
+  FAR struct deadline_s *dl = (FAR struct deadline_s *)arg;
+  FAR struct tcb_s *tcb = dl->tcb;
+  clock_t now = clock_systime_ticks();
+
+  wd_start_next(&dl->period_timer, dl->period, deadline_period_expire, arg);
+
+  dl->abstime   = now + dl->deadline;
+  dl->remaining = dl->runtime;
+
+  /* Restart the accounting if the thread is running right now.  This
+   * includes a throttled thread that kept running at the lowest priority.
+   */
+
+  if (dl->running || tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      wd_cancel(&dl->budget_timer);
+      deadline_budget_start(dl, now);
+    }
+
+  if (dl->throttled)
+    {
+      dl->throttled = false;
+      deadline_set_priority(tcb, CONFIG_SCHED_DEADLINE_PRIORITY);
+    }
+  else if (tcb->task_state == TSTATE_TASK_RUNNING ||
+           tcb->task_state == TSTATE_TASK_READYTORUN)
+    {
+      /* The absolute deadline moved, so requeue the thread behind the
+       * threads whose deadlines are now earlier.
+       */
+
+      nxsched_set_priority(tcb, tcb->sched_priority);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Admit a thread to the SCHED_DEADLINE policy or change its parameters.
+ *   Admission fails if the sum of the runtime/period ratios of all
+ *   SCHED_DEADLINE threads would exceed CONFIG_SCHED_DEADLINE_UTILIZATION
+ *   percent of the CPUs.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB of the thread
+ *   runtime  - Execution budget per period in clock ticks
+ *   deadline - Relative deadline in clock ticks
+ *   period   - Activation period in clock ticks
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *   - 0 < runtime <= deadline <= period
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb, clock_t runtime,
+                           clock_t deadline, clock_t period)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  uint64_t oldbw = dl != NULL ? dl->bandwidth : 0;
+  uint64_t newbw;
+  clock_t now;
+
+  DEBUGASSERT(runtime > 0 && runtime <= deadline && deadline <= period);
+
+  /* Admission control */
+
+  newbw = ((uint64_t)runtime << DEADLINE_BW_SHIFT) / period;
+  if (g_deadline_bw - oldbw + newbw > DEADLINE_BW_LIMIT)
+    {
+      return -EBUSY;
+    }
+
+  if (dl == NULL)
+    {
+      dl = kmm_zalloc(sizeof(struct deadline_s));
+      if (dl == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          return -ENOMEM;
+        }
+
+      dl->tcb       = tcb;
+      tcb->deadline = dl;
+    }
+  else
+    {
+      wd_cancel(&dl->budget_timer);
+      wd_cancel(&dl->period_timer);
+    }
+
+  g_deadline_bw = g_deadline_bw - oldbw + newbw;
+
+  /* The first period starts now */
+
+  now           = clock_systime_ticks();
+  dl->runtime   = runtime;
+  dl->deadline  = deadline;
+  dl->period    = period;
+  dl->bandwidth = newbw;
+  dl->abstime   = now + deadline;
+  dl->remaining = runtime;
+  dl->running   = false;
+  dl->throttled = false;
+
+  wd_start(&dl->period_timer, period, deadline_period_expire,
+           (wdparm_t)dl);
+
+  /* A running thread is not switched in again, so start accounting now */
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      deadline_budget_start(dl, now);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Remove a thread from the SCHED_DEADLINE policy and free all resources
+ *   associated with it.  This is called when the thread exits or when it
+ *   is changed to some other scheduling policy.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+int nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  DEBUGASSERT(dl != NULL);
+
+  wd_cancel(&dl->budget_timer);
+  wd_cancel(&dl->period_timer);
+  g_deadline_bw -= dl->bandwidth;
+
+  kmm_free(dl);
+  tcb->deadline = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_deadline
+ *
+ * Description:
+ *   Called when a SCHED_DEADLINE thread is switched in.  The thread starts
+ *   consuming the remaining budget of the current period.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is being resumed
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+void nxsched_resume_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  DEBUGASSERT(dl != NULL);
+
+  /* A throttled thread may still run at the lowest priority, but that is
+   * not charged against the budget of the next period.
+   */
+
+  if (!dl->running && !dl->throttled)
+    {
+      deadline_budget_start(dl, clock_systime_ticks());
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_deadline
+ *
+ * Description:
+ *   Called when a SCHED_DEADLINE thread is switched out.  The time that it
+ *   ran is charged against the budget of the current period.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is being suspended
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  clock_t elapsed;
+
+  DEBUGASSERT(dl != NULL);
+
+  if (dl->running)
+    {
+      wd_cancel(&dl->budget_timer);
+      dl->running = false;
+
+      /* Leave at least one tick; if the budget is really used up the
+       * budget timer will throttle the thread as soon as it runs again.
+       */
+
+      elapsed = clock_systime_ticks() - dl->eventtime;
+      dl->remaining = elapsed < dl->remaining ? dl->remaining - elapsed : 1;
+    }
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -0,0 +1,171 @@
+/****************************************************************************
+ * sched/sched/sched_getattr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <string.h>
+#include <sched.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_get_attr
+ *
+ * Description:
+ *   nxsched_get_attr() returns the scheduling policy and the associated
+ *   attributes of the thread identified by pid.  If pid equals zero, the
+ *   attributes of the calling thread are returned.
+ *
+ *   nxsched_get_attr() is identical to the function sched_getattr(),
+ *   differing only in its return value:  This function does not modify the
+ *   errno variable.
+ *
+ * Input Parameters:
+ *   pid   - the task ID of the task to query.  If pid is zero, the
+ *           calling task is queried.
+ *   attr  - The location to return the attributes.
+ *   size  - The size of the structure pointed to by attr.
+ *   flags - Reserved, must be zero.
+ *
+ * Returned Value:
+ *   On success, nxsched_get_attr() returns OK (zero).  On error, a negated
+ *   errno value is returned:
+ *
+ *   EINVAL The arguments are not valid.
+ *   ESRCH  The task whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int nxsched_get_attr(pid_t pid, FAR struct sched_attr *attr,
+                     unsigned int size, unsigned int flags)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t irqflags;
+  int ret = OK;
+
+  if (attr == NULL || size < sizeof(struct sched_attr) || flags != 0)
+    {
+      return -EINVAL;
+    }
+
+  memset(attr, 0, sizeof(struct sched_attr));
+  attr->size = sizeof(struct sched_attr);
+
+  /* Keep the thread from exiting while its attributes are read */
+
+  irqflags = enter_critical_section();
+
+  if (pid == 0)
+    {
+      tcb = this_task();
+    }
+  else
+    {
+      tcb = nxsched_get_tcb(pid);
+    }
+
+  if (tcb == NULL)
+    {
+      ret = -ESRCH;
+      goto errout_with_irq;
+    }
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      FAR struct deadline_s *dl = tcb->deadline;
+
+      attr->sched_policy   = SCHED_DEADLINE;
+      attr->sched_runtime  = TICK2NSEC((uint64_t)dl->runtime);
+      attr->sched_deadline = TICK2NSEC((uint64_t)dl->deadline);
+      attr->sched_period   = TICK2NSEC((uint64_t)dl->period);
+    }
+  else
+#endif
+    {
+      attr->sched_policy = ((tcb->flags & TCB_FLAG_POLICY_MASK) >>
+                            TCB_FLAG_POLICY_SHIFT) + 1;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      attr->sched_priority = tcb->base_priority;
+#else
+      attr->sched_priority = tcb->sched_priority;
+#endif
+    }
+
+errout_with_irq:
+  leave_critical_section(irqflags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sched_getattr
+ *
+ * Description:
+ *   sched_getattr() returns the scheduling policy and the associated
+ *   attributes of the thread identified by pid.  If pid equals zero, the
+ *   attributes of the calling thread are returned.
+ *
+ *   This function is a simply wrapper around nxsched_get_attr() that
+ *   sets the errno value in the event of an error.
+ *
+ * Input Parameters:
+ *   pid   - the task ID of the task to query.  If pid is zero, the
+ *           calling task is queried.
+ *   attr  - The location to return the attributes.
+ *   size  - The size of the structure pointed to by attr.
+ *   flags - Reserved, must be zero.
+ *
+ * Returned Value:
+ *   On success, sched_getattr() returns OK (zero).  On error, ERROR (-1)
+ *   is returned, and errno is set appropriately:
+ *
+ *   EINVAL The arguments are not valid.
+ *   ESRCH  The task whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int sched_getattr(pid_t pid, FAR struct sched_attr *attr,
+                  unsigned int size, unsigned int flags)
+{
+  int ret = nxsched_get_attr(pid, attr, size, flags);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+}
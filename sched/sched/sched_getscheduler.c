@@ -94,6 +94,16 @@ int nxsched_get_scheduler(pid_t pid)
    */
 
   policy = (tcb->flags & TCB_FLAG_POLICY_MASK) >> TCB_FLAG_POLICY_SHIFT;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* SCHED_DEADLINE does not follow SCHED_SPORADIC in the user values */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      return SCHED_DEADLINE;
+    }
+#endif
+
   return policy + 1;
 }
 
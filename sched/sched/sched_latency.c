@@ -0,0 +1,116 @@
+/****************************************************************************
+ * sched/sched/sched_latency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Wakeup-to-run latency histogram of each CPU */
+
+uint32_t g_latency_hist[CONFIG_SMP_NCPUS][CONFIG_SCHED_LATENCY_NBUCKETS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_latency_wakeup
+ *
+ * Description:
+ *   Called when a thread leaves the blocked state.  Save the time so that
+ *   the latency can be accounted once the thread really starts running.
+ *
+ * Input Parameters:
+ *   tcb - The thread that was just unblocked.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_latency_wakeup(FAR struct tcb_s *tcb)
+{
+  /* Zero means that no measurement is pending; losing the sample taken
+   * exactly when the counter wraps to zero is of no consequence.
+   */
+
+  tcb->latency_start = perf_gettime();
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_resume
+ *
+ * Description:
+ *   Called when a thread is switched in.  If the thread became ready-to-run
+ *   after being blocked, add the elapsed time to the histograms of the
+ *   thread and of the current CPU.
+ *
+ * Input Parameters:
+ *   tcb - The thread that is being switched in.
+ *
+ * Assumptions:
+ *   - Called with local interrupts disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_latency_resume(FAR struct tcb_s *tcb)
+{
+  clock_t elapsed;
+  uint64_t nsec;
+  int bucket;
+
+  if (tcb->latency_start == 0)
+    {
+      return;
+    }
+
+  elapsed = perf_gettime() - tcb->latency_start;
+  tcb->latency_start = 0;
+
+  /* Bucket n collects the latencies in [2^(n-1), 2^n) nanoseconds; the
+   * last bucket also collects everything beyond.
+   */
+
+  nsec   = (uint64_t)elapsed * NSEC_PER_SEC / perf_getfreq();
+  bucket = nsec != 0 ? flsll(nsec) : 0;
+  if (bucket >= CONFIG_SCHED_LATENCY_NBUCKETS)
+    {
+      bucket = CONFIG_SCHED_LATENCY_NBUCKETS - 1;
+    }
+
+  tcb->latency_hist[bucket]++;
+  g_latency_hist[this_cpu()][bucket]++;
+}
@@ -177,6 +177,10 @@ void nxsched_process_tick(void)
 
   clock_increase_sched_ticks(1);
 
+  /* Refresh the timekeeping state published to user space */
+
+  clock_vdso_update();
+
   /* Check if the currently executing task has exceeded its
    * timeslice.
    */
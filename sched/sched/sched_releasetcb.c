@@ -28,6 +28,7 @@
 
 #include <sys/types.h>
 #include <sched.h>
+#include <stdbool.h>
 #include <errno.h>
 
 #include <nuttx/arch.h>
@@ -38,6 +39,10 @@
 #include "group/group.h"
 #include "timer/timer.h"
 
+#ifdef CONFIG_PTHREAD_CACHE
+#  include "pthread/pthread.h"
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -100,10 +105,19 @@ static void nxsched_releasepid(pid_t pid)
 
 int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 {
+#ifdef CONFIG_PTHREAD_CACHE
+  bool cache;
+#endif
   int ret = OK;
 
   if (tcb)
     {
+#ifdef CONFIG_PTHREAD_CACHE
+      /* Keep the stack of a pthread allocation with the TCB for reuse */
+
+      cache = PTHREAD_CACHE_KEEP(tcb, ttype);
+#endif
+
       /* Released tcb shouldn't on any list */
 
       DEBUGASSERT(tcb->flink == NULL && tcb->blink == NULL);
@@ -131,7 +145,11 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       /* Delete the thread's stack if one has been allocated */
 
+#ifdef CONFIG_PTHREAD_CACHE
+      if (tcb->stack_alloc_ptr && !cache)
+#else
       if (tcb->stack_alloc_ptr)
+#endif
         {
           up_release_stack(tcb, ttype);
         }
@@ -176,6 +194,13 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       /* And, finally, release the TCB itself */
 
+#ifdef CONFIG_PTHREAD_CACHE
+      if (cache)
+        {
+          pthread_cache_put(tcb);
+        }
+      else
+#endif
       if (tcb->flags & TCB_FLAG_FREE_TCB)
         {
           kmm_free(tcb);
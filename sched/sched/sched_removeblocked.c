@@ -74,6 +74,10 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb)
 
   btcb->waitobj = NULL;
 
+  /* Start measuring the time until the TCB gets the CPU */
+
+  nxsched_latency_wakeup(btcb);
+
   /* Make sure the TCB's state corresponds to not being in
    * any list
    */
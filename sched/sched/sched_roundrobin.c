@@ -45,9 +45,11 @@
  * Private Data
  ****************************************************************************/
 
-#ifdef CONFIG_SMP
-static struct smp_call_data_s g_call_data;
-#endif
+/* One call per target CPU, so expirations on several remote CPUs in the
+ * same pass do not reuse a call that is still pending.
+ */
+
+static struct smp_call_data_s g_call_data[CONFIG_SMP_NCPUS];
 
 /****************************************************************************
  * Private Types
@@ -188,17 +190,28 @@ clock_t nxsched_process_roundrobin(FAR struct tcb_s *tcb, clock_t ticks,
            * we cannot check it to find the next task.  If the task is
            * running on a different CPU, send an SMP call to that CPU.
            * Otherwise, directly call nxsched_switch_running() to find the
-           * directly call nxsched_switch_running() to find the next eligible
-           * task from the ready-to-run list and switch to it.
+           * next eligible task from the ready-to-run list and switch to it.
            */
 
           DEBUGASSERT(tcb->task_state == TSTATE_TASK_RUNNING);
           if (tcb->cpu != this_cpu())
             {
-              nxsched_smp_call_init(&g_call_data,
-                                    nxsched_roundrobin_handler,
-                                    (FAR void *)(uintptr_t)tcb->pid);
-              nxsched_smp_call_single_async(tcb->cpu, &g_call_data);
+              /* Only interrupt the other CPU if some task of the same or
+               * higher priority could actually replace this one there.
+               * A lone round-robin task on an isolated CPU just starts a
+               * new timeslice.
+               */
+
+              if (nxsched_peek_readytorun(tcb->cpu,
+                                          tcb->sched_priority - 1) != NULL)
+                {
+                  FAR struct smp_call_data_s *data =
+                    &g_call_data[tcb->cpu];
+
+                  nxsched_smp_call_init(data, nxsched_roundrobin_handler,
+                                        (FAR void *)(uintptr_t)tcb->pid);
+                  nxsched_smp_call_single_async(tcb->cpu, data);
+                }
             }
           else if (nxsched_switch_running(tcb->cpu, true))
             {
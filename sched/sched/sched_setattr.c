@@ -0,0 +1,255 @@
+/****************************************************************************
+ * sched/sched/sched_setattr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_set_deadline
+ *
+ * Description:
+ *   Switch the thread to the SCHED_DEADLINE policy, or update its deadline
+ *   parameters if it already uses that policy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+static int nxsched_set_deadline(pid_t pid, FAR const struct sched_attr *attr)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint64_t period;
+  clock_t runtime_ticks;
+  clock_t deadline_ticks;
+  clock_t period_ticks;
+  int ret;
+
+  /* A zero period means that the period equals the deadline */
+
+  period = attr->sched_period != 0 ? attr->sched_period :
+           attr->sched_deadline;
+
+  if (attr->sched_runtime == 0 ||
+      attr->sched_runtime > attr->sched_deadline ||
+      attr->sched_deadline > period)
+    {
+      return -EINVAL;
+    }
+
+  /* Convert the nanosecond values to system clock ticks, avoiding zero */
+
+  runtime_ticks  = NSEC2TICK(attr->sched_runtime);
+  deadline_ticks = NSEC2TICK(attr->sched_deadline);
+  period_ticks   = NSEC2TICK(period);
+
+  if (runtime_ticks < 1)
+    {
+      runtime_ticks = 1;
+    }
+
+  if (deadline_ticks < runtime_ticks)
+    {
+      deadline_ticks = runtime_ticks;
+    }
+
+  if (period_ticks < deadline_ticks)
+    {
+      period_ticks = deadline_ticks;
+    }
+
+  if (pid == 0)
+    {
+      tcb = this_task();
+    }
+  else
+    {
+      tcb = nxsched_get_tcb(pid);
+    }
+
+  if (tcb == NULL)
+    {
+      return -ESRCH;
+    }
+
+  /* Prohibit any context switches while we set up the new policy */
+
+  sched_lock();
+  flags = enter_critical_section();
+
+  ret = nxsched_start_deadline(tcb, runtime_ticks, deadline_ticks,
+                               period_ticks);
+  if (ret < 0)
+    {
+      leave_critical_section(flags);
+      sched_unlock();
+      return ret;
+    }
+
+#ifdef CONFIG_SCHED_SPORADIC
+  /* Cancel any on-going sporadic scheduling */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+    {
+      DEBUGVERIFY(nxsched_stop_sporadic(tcb));
+    }
+#endif
+
+  tcb->flags &= ~TCB_FLAG_POLICY_MASK;
+  tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+  tcb->timeslice = 0;
+#endif
+
+  leave_critical_section(flags);
+
+  /* All SCHED_DEADLINE threads share the same priority band */
+
+  ret = nxsched_reprioritize(tcb, CONFIG_SCHED_DEADLINE_PRIORITY);
+  sched_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_set_attr
+ *
+ * Description:
+ *   nxsched_set_attr() sets the scheduling policy and the associated
+ *   attributes for the thread identified by pid.  If pid equals zero, the
+ *   attributes of the calling thread will be set.  This is the only way
+ *   to select the SCHED_DEADLINE policy.
+ *
+ *   nxsched_set_attr() is identical to the function sched_setattr(),
+ *   differing only in its return value:  This function does not modify the
+ *   errno variable.
+ *
+ * Input Parameters:
+ *   pid   - the task ID of the task to modify.  If pid is zero, the
+ *           calling task is modified.
+ *   attr  - The new scheduling policy and attributes.
+ *   flags - Reserved, must be zero.
+ *
+ * Returned Value:
+ *   On success, nxsched_set_attr() returns OK (zero).  On error, a negated
+ *   errno value is returned:
+ *
+ *   EINVAL The policy or its attributes are not valid.
+ *   EBUSY  Admitting the SCHED_DEADLINE thread would exceed the bandwidth
+ *          limit.
+ *   ESRCH  The task whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int nxsched_set_attr(pid_t pid, FAR const struct sched_attr *attr,
+                     unsigned int flags)
+{
+  struct sched_param param;
+
+  if (attr == NULL || flags != 0 || attr->sched_flags != 0 ||
+      (attr->size != 0 && attr->size < sizeof(struct sched_attr)))
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (attr->sched_policy == SCHED_DEADLINE)
+    {
+      return nxsched_set_deadline(pid, attr);
+    }
+#endif
+
+  /* Any other policy is handled like sched_setscheduler() */
+
+  if (attr->sched_policy == SCHED_SPORADIC)
+    {
+      /* The sporadic parameters cannot be described by struct sched_attr */
+
+      return -EINVAL;
+    }
+
+  param.sched_priority = attr->sched_priority;
+  return nxsched_set_scheduler(pid, attr->sched_policy, &param);
+}
+
+/****************************************************************************
+ * Name: sched_setattr
+ *
+ * Description:
+ *   sched_setattr() sets the scheduling policy and the associated
+ *   attributes for the thread identified by pid.  If pid equals zero, the
+ *   attributes of the calling thread will be set.
+ *
+ *   This function is a simply wrapper around nxsched_set_attr() that
+ *   sets the errno value in the event of an error.
+ *
+ * Input Parameters:
+ *   pid   - the task ID of the task to modify.  If pid is zero, the
+ *           calling task is modified.
+ *   attr  - The new scheduling policy and attributes.
+ *   flags - Reserved, must be zero.
+ *
+ * Returned Value:
+ *   On success, sched_setattr() returns OK (zero).  On error, ERROR (-1)
+ *   is returned, and errno is set appropriately:
+ *
+ *   EINVAL The policy or its attributes are not valid.
+ *   EBUSY  Admitting the SCHED_DEADLINE thread would exceed the bandwidth
+ *          limit.
+ *   ESRCH  The task whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int sched_setattr(pid_t pid, FAR const struct sched_attr *attr,
+                  unsigned int flags)
+{
+  int ret = nxsched_set_attr(pid, attr, flags);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+}
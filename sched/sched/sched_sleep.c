@@ -87,7 +87,8 @@ void nxsched_ticksleep(unsigned int ticks)
 
   rtcb = this_task();
 
-  wd_start(&rtcb->waitdog, ticks, nxsched_timeout, (uintptr_t)rtcb);
+  wd_start_slack(&rtcb->waitdog, ticks, wd_task_slack(),
+                 nxsched_timeout, (uintptr_t)rtcb);
 
   /* Remove the tcb task from the ready-to-run list. */
 
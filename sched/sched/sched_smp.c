@@ -68,22 +68,28 @@ static spinlock_t g_smp_call_lock;
  *   data  - Call data
  *
  * Returned Value:
- *   None
+ *   True if the target queue was empty, so that the target must be sent
+ *   an IPI.  A non-empty queue already has an IPI outstanding and the
+ *   handler drains the queue until it finds it empty, so further calls
+ *   are coalesced into that IPI.
  *
  ****************************************************************************/
 
-static void nxsched_smp_call_add(int cpu,
+static bool nxsched_smp_call_add(int cpu,
                                  FAR struct smp_call_data_s *data)
 {
   irqstate_t flags;
+  bool kick = false;
 
   flags = spin_lock_irqsave(&g_smp_call_lock);
   if (!sq_inqueue(&data->node[cpu], &g_smp_call_queue[cpu]))
     {
+      kick = sq_empty(&g_smp_call_queue[cpu]);
       sq_addlast(&data->node[cpu], &g_smp_call_queue[cpu]);
     }
 
   spin_unlock_irqrestore(&g_smp_call_lock, flags);
+  return kick;
 }
 
 /****************************************************************************
@@ -111,21 +117,23 @@ int nxsched_smp_call_handler(int irq, FAR void *context,
 {
   FAR sq_queue_t *call_queue;
   FAR sq_entry_t *curr;
-  FAR sq_entry_t *next;
   int cpu = this_cpu();
 
   irqstate_t flags = spin_lock_irqsave(&g_smp_call_lock);
 
   call_queue = &g_smp_call_queue[cpu];
 
-  sq_for_every_safe(call_queue, curr, next)
+  /* Keep going until the queue is seen empty under the lock: senders only
+   * raise an IPI for an empty queue, so calls queued while a function is
+   * running here must be picked up by this pass.
+   */
+
+  while ((curr = sq_remfirst(call_queue)) != NULL)
     {
       FAR struct smp_call_data_s *data =
         container_of(curr, struct smp_call_data_s, node[cpu]);
       int ret;
 
-      sq_rem(&data->node[cpu], call_queue);
-
       spin_unlock_irqrestore(&g_smp_call_lock, flags);
 
       ret = data->func(data->arg);
@@ -303,6 +311,7 @@ int nxsched_smp_call_single_async(int cpuid,
 int nxsched_smp_call_async(cpu_set_t cpuset,
                            FAR struct smp_call_data_s *data)
 {
+  cpu_set_t kickset;
   int cpucnt;
   int ret = OK;
   int i;
@@ -336,11 +345,16 @@ int nxsched_smp_call_async(cpu_set_t cpuset,
       goto out;
     }
 
+  CPU_ZERO(&kickset);
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
       if (CPU_ISSET(i, &cpuset))
         {
-          nxsched_smp_call_add(i, data);
+          if (nxsched_smp_call_add(i, data))
+            {
+              CPU_SET(i, &kickset);
+            }
+
           if (--cpucnt == 0)
             {
               break;
@@ -348,7 +362,12 @@ int nxsched_smp_call_async(cpu_set_t cpuset,
         }
     }
 
-  up_send_smp_call(cpuset);
+  /* Only CPUs without an IPI already outstanding need to be interrupted */
+
+  if (CPU_COUNT(&kickset) > 0)
+    {
+      up_send_smp_call(kickset);
+    }
 
 out:
   if (!up_interrupt_context())
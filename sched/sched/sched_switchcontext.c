@@ -26,8 +26,43 @@
 
 #include "sched/sched.h"
 
+#include <nuttx/arch.h>
+#include <nuttx/perf_event.h>
 #include <nuttx/sched_note.h>
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_stack_watermark
+ *
+ * Description:
+ *   Sample the stack pointer of the suspended task and record it if it is
+ *   the deepest one seen so far.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STACK_WATERMARK
+static inline void nxsched_stack_watermark(FAR struct tcb_s *tcb)
+{
+  if (tcb->xcp.regs != NULL)
+    {
+      uintptr_t sp  = up_getusrsp(tcb->xcp.regs);
+      uintptr_t bot = (uintptr_t)tcb->stack_base_ptr;
+      uintptr_t top = bot + tcb->adj_stack_size;
+
+      if (sp > bot && sp <= top &&
+          (tcb->sp_watermark == 0 || sp < tcb->sp_watermark))
+        {
+          tcb->sp_watermark = sp;
+        }
+    }
+}
+#else
+#  define nxsched_stack_watermark(tcb)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -50,6 +85,7 @@
 void nxsched_switch_context(FAR struct tcb_s *from, FAR struct tcb_s *to)
 {
   nxsched_checkstackoverflow(from);
+  nxsched_stack_watermark(from);
 
 #ifdef CONFIG_SCHED_SPORADIC
   /* Perform sporadic schedule operations */
@@ -65,12 +101,34 @@ void nxsched_switch_context(FAR struct tcb_s *from, FAR struct tcb_s *to)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Charge the budget of deadline threads */
+
+  if ((from->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      nxsched_suspend_deadline(from);
+    }
+
+  if ((to->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      nxsched_resume_deadline(to);
+    }
+#endif
+
   /* Indicate that the task has been suspended */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_switch_critmon(from, to);
 #endif
 
+  /* Account the wakeup-to-run latency of the resumed task */
+
+  nxsched_latency_resume(to);
+
+  /* Move the per-task hardware event counters to the resumed task */
+
+  perf_event_switch(from, to);
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(from);
   sched_note_resume(to);
@@ -987,4 +987,56 @@ void nxsem_release_all(FAR struct tcb_s *htcb)
     }
 }
 
+/****************************************************************************
+ * Name: nxsem_boost_holder
+ *
+ * Description:
+ *   Raise the priority of a thread holding a lock other than a semaphore,
+ *   like a read-write semaphore, that the current thread waits for.
+ *
+ * Input Parameters:
+ *   htcb - TCB of the thread holding the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsem_boost_holder(FAR struct tcb_s *htcb)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  if (rtcb->sched_priority > htcb->sched_priority)
+    {
+      nxsched_set_priority(htcb, rtcb->sched_priority);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsem_restore_holder
+ *
+ * Description:
+ *   Drop the priority of a thread boosted by nxsem_boost_holder() after it
+ *   released the lock.  The thread keeps the priority of the highest
+ *   thread waiting for a semaphore it still holds.
+ *
+ * Input Parameters:
+ *   htcb - TCB of the thread that released the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsem_restore_holder(FAR struct tcb_s *htcb)
+{
+  nxsem_restore_priority(htcb);
+}
+
 #endif /* CONFIG_PRIORITY_INHERITANCE */
@@ -24,9 +24,55 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/rwsem.h>
 #include <nuttx/sched.h>
 #include <assert.h>
+#include <string.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With writer preference a new reader also waits behind waiting writers,
+ * unless the thread already holds a read lock: the writer waits for that
+ * lock to be released, so a recursive read lock must not wait for the
+ * writer.  The threads count their read locks of all semaphores, as the
+ * readers are not tracked per semaphore.
+ */
+
+#ifdef CONFIG_RWSEM_PREFER_WRITER
+#  define RWSEM_READ_BLOCKED(r) ((r)->writer > 0 || \
+                                 ((r)->wwaiter > 0 && \
+                                  this_task()->rwsem_nreads == 0))
+#  define rwsem_read_acquired() (this_task()->rwsem_nreads++)
+#  define rwsem_read_released() \
+  do \
+    { \
+      FAR struct tcb_s *rtcb = this_task(); \
+      if (rtcb->rwsem_nreads > 0) \
+        { \
+          rtcb->rwsem_nreads--; \
+        } \
+    } \
+  while (0)
+#else
+#  define RWSEM_READ_BLOCKED(r) ((r)->writer > 0)
+#  define rwsem_read_acquired()
+#  define rwsem_read_released()
+#endif
+
+#define RWSEM_NOWAIT            ((clock_t)-1)
+
+#ifndef CONFIG_RWSEM_STATS
+#  define rwsem_account(r, w, s)
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -45,6 +91,159 @@ static inline void up_wait(FAR rw_semaphore_t *rwsem)
     }
 }
 
+/****************************************************************************
+ * Name: rwsem_boost
+ *
+ * Description:
+ *   Raise the priority of the writer holding the lock to the priority of
+ *   the calling thread, which is about to wait for it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static void rwsem_boost(FAR rw_semaphore_t *rwsem)
+{
+  FAR struct tcb_s *htcb;
+  irqstate_t flags;
+
+  if (rwsem->holder == RWSEM_NO_HOLDER)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  htcb  = nxsched_get_tcb(rwsem->holder);
+  if (htcb != NULL &&
+      this_task()->sched_priority > htcb->sched_priority)
+    {
+      nxsem_boost_holder(htcb);
+      rwsem->boosted = true;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: rwsem_unboost
+ *
+ * Description:
+ *   Called with the lock protected when the writer gave up the lock, return
+ *   true if its priority was raised and has to be restored by
+ *   rwsem_restore() once the protection is dropped.
+ *
+ ****************************************************************************/
+
+static bool rwsem_unboost(FAR rw_semaphore_t *rwsem)
+{
+  bool boosted = rwsem->boosted;
+
+  rwsem->boosted = false;
+  return boosted;
+}
+
+static void rwsem_restore(bool boosted)
+{
+  irqstate_t flags;
+
+  if (boosted)
+    {
+      flags = enter_critical_section();
+      nxsem_restore_holder(this_task());
+      leave_critical_section(flags);
+    }
+}
+#else
+#  define rwsem_boost(rwsem)
+#  define rwsem_unboost(rwsem) false
+#  define rwsem_restore(boosted)
+#endif
+
+/****************************************************************************
+ * Name: rwsem_wait
+ *
+ * Description:
+ *   Wait once for the lock to change, with the lock protected on entry and
+ *   on return.  'start' records when the caller began to wait.
+ *
+ ****************************************************************************/
+
+static void rwsem_wait(FAR rw_semaphore_t *rwsem, bool write,
+                       FAR clock_t *start)
+{
+#ifdef CONFIG_RWSEM_STATS
+  if (*start == RWSEM_NOWAIT)
+    {
+      *start = clock_systime_ticks();
+    }
+#endif
+
+#ifdef CONFIG_RWSEM_PREFER_WRITER
+  if (write)
+    {
+      rwsem->wwaiter++;
+    }
+#endif
+
+  rwsem_boost(rwsem);
+
+  rwsem->waiter++;
+  nxmutex_unlock(&rwsem->protected);
+  nxsem_wait(&rwsem->waiting);
+  nxmutex_lock(&rwsem->protected);
+  rwsem->waiter--;
+
+#ifdef CONFIG_RWSEM_PREFER_WRITER
+  if (write)
+    {
+      rwsem->wwaiter--;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: rwsem_account
+ *
+ * Description:
+ *   Count an acquisition of the lock, with the lock protected.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RWSEM_STATS
+static void rwsem_account(FAR rw_semaphore_t *rwsem, bool write,
+                          clock_t start)
+{
+  FAR struct rwsem_stats_s *stats = &rwsem->stats;
+  clock_t elapsed;
+
+  if (write)
+    {
+      stats->nwrites++;
+    }
+  else
+    {
+      stats->nreads++;
+    }
+
+  if (start != RWSEM_NOWAIT)
+    {
+      if (write)
+        {
+          stats->wcontended++;
+        }
+      else
+        {
+          stats->rcontended++;
+        }
+
+      elapsed = clock_systime_ticks() - start;
+      if (elapsed > stats->maxwait)
+        {
+          stats->maxwait = elapsed;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,7 +277,7 @@ int down_read_trylock(FAR rw_semaphore_t *rwsem)
       goto out;
     }
 
-  if (rwsem->writer > 0)
+  if (RWSEM_READ_BLOCKED(rwsem))
     {
       nxmutex_unlock(&rwsem->protected);
       return 0;
@@ -89,6 +288,8 @@ int down_read_trylock(FAR rw_semaphore_t *rwsem)
    */
 
   rwsem->reader++;
+  rwsem_read_acquired();
+  rwsem_account(rwsem, false, RWSEM_NOWAIT);
 
 out:
   nxmutex_unlock(&rwsem->protected);
@@ -109,6 +310,8 @@ out:
 
 void down_read(FAR rw_semaphore_t *rwsem)
 {
+  clock_t start = RWSEM_NOWAIT;
+
   /* we have to check if there is a write-lock scenario, if there is then we
    * block and wait for the write-lock to be unlocked.
    */
@@ -126,13 +329,9 @@ void down_read(FAR rw_semaphore_t *rwsem)
       goto out;
     }
 
-  while (rwsem->writer > 0)
+  while (RWSEM_READ_BLOCKED(rwsem))
     {
-      rwsem->waiter++;
-      nxmutex_unlock(&rwsem->protected);
-      nxsem_wait(&rwsem->waiting);
-      nxmutex_lock(&rwsem->protected);
-      rwsem->waiter--;
+      rwsem_wait(rwsem, false, &start);
     }
 
   /* In a scenario where there is no write lock, we just need to make the
@@ -140,6 +339,8 @@ void down_read(FAR rw_semaphore_t *rwsem)
    */
 
   rwsem->reader++;
+  rwsem_read_acquired();
+  rwsem_account(rwsem, false, start);
 
 out:
   nxmutex_unlock(&rwsem->protected);
@@ -158,6 +359,8 @@ out:
 
 void up_read(FAR rw_semaphore_t *rwsem)
 {
+  bool boosted = false;
+
   nxmutex_lock(&rwsem->protected);
 
   /* when releasing a read lock and holder is oneself, the read lock is a
@@ -170,6 +373,8 @@ void up_read(FAR rw_semaphore_t *rwsem)
       if (--rwsem->writer <= 0)
         {
           rwsem->holder = RWSEM_NO_HOLDER;
+          boosted = rwsem_unboost(rwsem);
+          up_wait(rwsem);
         }
 
       goto out;
@@ -178,6 +383,7 @@ void up_read(FAR rw_semaphore_t *rwsem)
   DEBUGASSERT(rwsem->reader > 0);
 
   rwsem->reader--;
+  rwsem_read_released();
 
   if (rwsem->waiter > 0)
     {
@@ -186,6 +392,7 @@ void up_read(FAR rw_semaphore_t *rwsem)
 
 out:
   nxmutex_unlock(&rwsem->protected);
+  rwsem_restore(boosted);
 }
 
 /****************************************************************************
@@ -218,6 +425,7 @@ int down_write_trylock(FAR rw_semaphore_t *rwsem)
 
   rwsem->writer++;
   rwsem->holder = tid;
+  rwsem_account(rwsem, true, RWSEM_NOWAIT);
 
   nxmutex_unlock(&rwsem->protected);
 
@@ -238,22 +446,20 @@ int down_write_trylock(FAR rw_semaphore_t *rwsem)
 void down_write(FAR rw_semaphore_t *rwsem)
 {
   pid_t tid = _SCHED_GETTID();
+  clock_t start = RWSEM_NOWAIT;
 
   nxmutex_lock(&rwsem->protected);
 
   while (rwsem->reader > 0 || (rwsem->writer > 0 && rwsem->holder != tid))
     {
-      rwsem->waiter++;
-      nxmutex_unlock(&rwsem->protected);
-      nxsem_wait(&rwsem->waiting);
-      nxmutex_lock(&rwsem->protected);
-      rwsem->waiter--;
+      rwsem_wait(rwsem, true, &start);
     }
 
   /* The check passes, then we just need the writer reference + 1 */
 
   rwsem->writer++;
   rwsem->holder = tid;
+  rwsem_account(rwsem, true, start);
 
   nxmutex_unlock(&rwsem->protected);
 }
@@ -271,6 +477,8 @@ void down_write(FAR rw_semaphore_t *rwsem)
 
 void up_write(FAR rw_semaphore_t *rwsem)
 {
+  bool boosted = false;
+
   nxmutex_lock(&rwsem->protected);
 
   DEBUGASSERT(rwsem->writer > 0);
@@ -279,11 +487,13 @@ void up_write(FAR rw_semaphore_t *rwsem)
   if (--rwsem->writer <= 0)
     {
       rwsem->holder = RWSEM_NO_HOLDER;
+      boosted = rwsem_unboost(rwsem);
     }
 
   up_wait(rwsem);
 
   nxmutex_unlock(&rwsem->protected);
+  rwsem_restore(boosted);
 }
 
 /****************************************************************************
@@ -299,6 +509,8 @@ void up_write(FAR rw_semaphore_t *rwsem)
 
 void downgrade_write(FAR rw_semaphore_t *rwsem)
 {
+  bool boosted;
+
   nxmutex_lock(&rwsem->protected);
 
   DEBUGASSERT(rwsem->writer == 1);
@@ -307,10 +519,13 @@ void downgrade_write(FAR rw_semaphore_t *rwsem)
 
   rwsem->writer = 0;
   rwsem->reader++;
+  rwsem_read_acquired();
   rwsem->holder = RWSEM_NO_HOLDER;
+  boosted = rwsem_unboost(rwsem);
 
   up_wait(rwsem);
   nxmutex_unlock(&rwsem->protected);
+  rwsem_restore(boosted);
 }
 
 /****************************************************************************
@@ -351,6 +566,15 @@ int init_rwsem(FAR rw_semaphore_t *rwsem)
   rwsem->writer = 0;
   rwsem->waiter = 0;
   rwsem->holder = RWSEM_NO_HOLDER;
+#ifdef CONFIG_RWSEM_PREFER_WRITER
+  rwsem->wwaiter = 0;
+#endif
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  rwsem->boosted = false;
+#endif
+#ifdef CONFIG_RWSEM_STATS
+  memset(&rwsem->stats, 0, sizeof(rwsem->stats));
+#endif
 
   return OK;
 }
@@ -377,3 +601,32 @@ void destroy_rwsem(FAR rw_semaphore_t *rwsem)
   nxmutex_destroy(&rwsem->protected);
   nxsem_destroy(&rwsem->waiting);
 }
+
+/****************************************************************************
+ * Name: get_rwsem_stats
+ *
+ * Description:
+ *   Return the contention statistics of a read-write-lock object.
+ *
+ * Input Parameters:
+ *   rwsem - Pointer to the read-write-lock descriptor.
+ *   stats - Location to return the statistics.
+ *   reset - Clear the statistics after returning them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RWSEM_STATS
+void get_rwsem_stats(FAR rw_semaphore_t *rwsem,
+                     FAR struct rwsem_stats_s *stats, bool reset)
+{
+  nxmutex_lock(&rwsem->protected);
+
+  *stats = rwsem->stats;
+  if (reset)
+    {
+      memset(&rwsem->stats, 0, sizeof(rwsem->stats));
+    }
+
+  nxmutex_unlock(&rwsem->protected);
+}
+#endif
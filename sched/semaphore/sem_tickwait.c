@@ -108,7 +108,8 @@ int nxsem_tickwait(FAR sem_t *sem, uint32_t delay)
 
   /* Start the watchdog with interrupts still disabled */
 
-  wd_start(&rtcb->waitdog, delay, nxsem_timeout, (uintptr_t)rtcb);
+  wd_start_slack(&rtcb->waitdog, delay, wd_task_slack(),
+                 nxsem_timeout, (uintptr_t)rtcb);
 
   /* Now perform the blocking wait */
 
@@ -38,6 +38,89 @@
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_spin_mutex
+ *
+ * Description:
+ *   Spin on a contended mutex while its holder is running on another CPU,
+ *   trying to take the mutex when it gets released.
+ *
+ * Input Parameters:
+ *   sem  - Semaphore descriptor of the mutex.
+ *   rtcb - The TCB of the calling task.
+ *
+ * Returned Value:
+ *   True if the mutex was acquired, false if the caller has to block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+static bool nxsem_spin_mutex(FAR sem_t *sem, FAR struct tcb_s *rtcb)
+{
+  FAR struct tcb_s *htcb;
+  irqstate_t flags;
+  bool running;
+  int count;
+
+#ifdef CONFIG_PRIORITY_PROTECT
+  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_PROTECT)
+    {
+      return false;
+    }
+#endif
+
+  for (count = 0; count < CONFIG_MUTEX_ADAPTIVE_SPIN_COUNT; count++)
+    {
+      int32_t old = atomic_read(NXSEM_MHOLDER(sem));
+
+      if ((uint32_t)old == NXSEM_NO_MHOLDER)
+        {
+          if (atomic_try_cmpxchg_acquire(NXSEM_MHOLDER(sem), &old,
+                                         rtcb->pid))
+            {
+              return true;
+            }
+
+          continue;
+        }
+
+      /* Do not jump the queue of already blocked waiters, they will get
+       * the mutex handed over on release.
+       */
+
+      if (NXSEM_MBLOCKING(old) || !NXSEM_MACQUIRED(old))
+        {
+          break;
+        }
+
+      /* Spinning only makes sense while the holder makes progress on
+       * another CPU.  The holder may exit at any time, so it is looked up
+       * again on every pass and its TCB is only read in the critical
+       * section, which keeps it from being released meanwhile.
+       */
+
+      flags   = enter_critical_section();
+      htcb    = nxsched_get_tcb(old);
+      running = htcb != NULL && htcb->task_state == TSTATE_TASK_RUNNING &&
+                htcb->cpu != this_cpu();
+      leave_critical_section(flags);
+
+      if (!running)
+        {
+          break;
+        }
+
+      UP_RELAX();
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,6 +161,15 @@ int nxsem_wait_slow(FAR sem_t *sem)
   FAR struct tcb_s *htcb = NULL;
   bool mutex = NXSEM_IS_MUTEX(sem);
 
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+  /* Try spinning first if the holder is running on another CPU */
+
+  if (mutex && !up_interrupt_context() && nxsem_spin_mutex(sem, rtcb))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
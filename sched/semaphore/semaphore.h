@@ -85,6 +85,8 @@ void nxsem_release_holder(FAR sem_t *sem);
 void nxsem_restore_baseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_release_all(FAR struct tcb_s *stcb);
+void nxsem_boost_holder(FAR struct tcb_s *htcb);
+void nxsem_restore_holder(FAR struct tcb_s *htcb);
 #else
 #  define nxsem_initialize_holders()
 #  define nxsem_destroyholder(sem)
@@ -95,6 +97,8 @@ void nxsem_release_all(FAR struct tcb_s *stcb);
 #  define nxsem_restore_baseprio(stcb,sem)
 #  define nxsem_canceled(stcb,sem)
 #  define nxsem_release_all(stcb)
+#  define nxsem_boost_holder(htcb)
+#  define nxsem_restore_holder(htcb)
 #endif
 
 /* Special logic needed only by priority protect */
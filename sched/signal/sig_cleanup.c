@@ -62,6 +62,16 @@ void nxsig_cleanup(FAR struct tcb_s *stcb)
       nxsig_release_pendingsigaction(sigq);
     }
 
+#ifdef CONFIG_SIG_FASTPATH
+  /* Deallocate the signal action kept for reuse */
+
+  if (stcb->sigqcache != NULL)
+    {
+      nxsig_release_pendingsigaction(stcb->sigqcache);
+      stcb->sigqcache = NULL;
+    }
+#endif
+
   /* Misc. signal-related clean-up */
 
   sigfillset(&stcb->sigprocmask);
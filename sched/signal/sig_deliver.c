@@ -195,6 +195,17 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
       /* Remove the signal structure from the sigpostedq */
 
       sq_rem((FAR sq_entry_t *)sigq, &(stcb->sigpostedq));
+
+#ifdef CONFIG_SIG_FASTPATH
+      /* Keep the signal structure for the next signal to this thread */
+
+      if (stcb->sigqcache == NULL)
+        {
+          stcb->sigqcache = sigq;
+          sigq = NULL;
+        }
+#endif
+
       leave_critical_section(flags);
 
       /* Now, handle the (rare?) case where (a) a blocked signal was
@@ -206,7 +217,12 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
 
       /* Then deallocate the signal structure */
 
-      nxsig_release_pendingsigaction(sigq);
+#ifdef CONFIG_SIG_FASTPATH
+      if (sigq != NULL)
+#endif
+        {
+          nxsig_release_pendingsigaction(sigq);
+        }
     }
 
   /* Restore the saved errno value */
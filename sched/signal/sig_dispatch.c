@@ -95,6 +95,36 @@ static int sig_handler(FAR void *cookie)
 }
 #endif
 
+/****************************************************************************
+ * Name: nxsig_find_queuedaction
+ *
+ * Description:
+ *   Find the queued, not yet delivered action of a standard signal.
+ *
+ * Assumptions:
+ *   Called in critical section
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIG_FASTPATH
+static FAR sigq_t *nxsig_find_queuedaction(FAR struct tcb_s *stcb,
+                                           int signo)
+{
+  FAR sigq_t *sigq;
+
+  if (SIGRTMIN <= signo && signo <= SIGRTMAX)
+    {
+      return NULL;
+    }
+
+  for (sigq = (FAR sigq_t *)stcb->sigpendactionq.head;
+       sigq != NULL && sigq->info.si_signo != signo;
+       sigq = sigq->flink);
+
+  return sigq;
+}
+#endif
+
 /****************************************************************************
  * Name: nxsig_queue_action
  *
@@ -124,12 +154,34 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb,
 
   if ((sigact) && (sigact->act.sa_u._sa_sigaction))
     {
-      /* Allocate a new element for the signal queue. NOTE:
-       * nxsig_alloc_pendingsigaction will force a system crash if it is
-       * unable to allocate memory for the signal data.
+#ifdef CONFIG_SIG_FASTPATH
+      /* A standard signal whose action is still queued is delivered only
+       * once, with the latest signal information.
        */
 
-      sigq = nxsig_alloc_pendingsigaction();
+      sigq = nxsig_find_queuedaction(stcb, info->si_signo);
+      if (sigq != NULL)
+        {
+          memcpy(&sigq->info, info, sizeof(siginfo_t));
+          sigq->info.si_user = sigact->act.sa_user;
+          return OK;
+        }
+
+      /* Reuse the element kept by the last delivery to this thread */
+
+      sigq = stcb->sigqcache;
+      stcb->sigqcache = NULL;
+      if (sigq == NULL)
+#endif
+        {
+          /* Allocate a new element for the signal queue. NOTE:
+           * nxsig_alloc_pendingsigaction will force a system crash if it
+           * is unable to allocate memory for the signal data.
+           */
+
+          sigq = nxsig_alloc_pendingsigaction();
+        }
+
       if (!sigq)
         {
           ret = -ENOMEM;
@@ -373,15 +425,22 @@ static FAR sigpendq_t *nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
  *
  * Assumptions:
  *   Called with g_sigpendingsignal and g_sigpendingaction locked by
- *   critical section.
+ *   critical section.  No signal action is allocated if the thread
+ *   receiving the signal has one cached.
  *
  ****************************************************************************/
 
-static int nxsig_alloc_dyn_pending(FAR irqstate_t *flags)
+static int nxsig_alloc_dyn_pending(FAR struct tcb_s *stcb,
+                                   FAR irqstate_t *flags)
 {
   int ret = OK;
   bool alloc_signal = sq_empty(&g_sigpendingsignal);
+#ifdef CONFIG_SIG_FASTPATH
+  bool alloc_sigact = sq_empty(&g_sigpendingaction) &&
+                      stcb->sigqcache == NULL;
+#else
   bool alloc_sigact = sq_empty(&g_sigpendingaction);
+#endif
 
   if (alloc_signal || alloc_sigact)
     {
@@ -520,7 +579,7 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info,
    */
 
 #ifdef CONFIG_ENABLE_ALL_SIGNALS
-  ret = nxsig_alloc_dyn_pending(&flags);
+  ret = nxsig_alloc_dyn_pending(stcb, &flags);
   if (ret < 0)
     {
       leave_critical_section(flags);
@@ -148,17 +148,36 @@ int prctl(int option, ...)
         goto errout;
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_SLACK
+      case PR_SET_TIMERSLACK:
+        {
+          unsigned long slack = va_arg(ap, unsigned long);
+
+          if (slack == 0)
+            {
+              slack = CONFIG_WDOG_TIMER_SLACK_DEFAULT * NSEC_PER_USEC;
+            }
+
+          this_task()->timerslack = NSEC2TICK(slack);
+        }
+        break;
+
+      case PR_GET_TIMERSLACK:
+        va_end(ap);
+        return TICK2NSEC(this_task()->timerslack);
+#endif
+
       default:
         serr("ERROR: Unrecognized option: %d\n", option);
         errcode = EINVAL;
         goto errout;
     }
 
-  /* Not reachable unless CONFIG_TASK_NAME_SIZE is > 0.  NOTE: This might
-   * change if additional commands are supported.
+  /* Not reachable unless CONFIG_TASK_NAME_SIZE is > 0 or the timer slack
+   * is supported.
    */
 
-#if CONFIG_TASK_NAME_SIZE > 0
+#if CONFIG_TASK_NAME_SIZE > 0 || defined(CONFIG_WDOG_TIMER_SLACK)
   va_end(ap);
   return OK;
 #endif
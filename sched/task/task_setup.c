@@ -228,6 +228,17 @@ static inline void nxtask_inherit_affinity(FAR struct tcb_s *tcb)
 {
   FAR struct tcb_s *rtcb = this_task();
   tcb->affinity = rtcb->affinity;
+
+#if CONFIG_SMP_ISOLATED_CPUSET != 0
+  /* Kernel threads do housekeeping work and must not follow a creator
+   * that is bound to an isolated CPU.
+   */
+
+  if ((tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_KERNEL)
+    {
+      tcb->affinity = SCHED_HOUSEKEEPING_CPUS;
+    }
+#endif
 }
 #else
 #  define nxtask_inherit_affinity(tcb)
@@ -465,6 +476,12 @@ static int nxthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
       tcb->sigprocmask = rtcb->sigprocmask;
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_SLACK
+      /* And the timer slack */
+
+      tcb->timerslack = rtcb->timerslack;
+#endif
+
       /* Initialize the task state.  It does not get a valid state
        * until it is activated.
        */
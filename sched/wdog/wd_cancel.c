@@ -60,9 +60,13 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
-  FAR struct wdog_s *first;
-  irqstate_t         flags;
-  int                  ret = -EINVAL;
+  irqstate_t flags;
+  bool       first;
+#ifdef CONFIG_WDOG_SPINLOCK
+  bool       running = false;
+  int        cpu;
+#endif
+  int        ret = -EINVAL;
 
   if (wdog != NULL)
     {
@@ -70,30 +74,28 @@ int wd_cancel(FAR struct wdog_s *wdog)
        * cancellation is complete
        */
 
-      flags = enter_critical_section();
+      flags = wd_lock_irqsave();
 
       /* Make sure that the watchdog is valid and still active. */
 
       if (WDOG_ISACTIVE(wdog))
         {
-          first = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-
           /* Now, remove the watchdog from the timer queue */
 
-          list_delete_fast(&wdog->node);
+          first = wd_remove(wdog);
 
           /* Mark the watchdog inactive */
 
           wdog->func = NULL;
 
-          if (first == wdog && !wd_in_callback())
+          if (first && !wd_in_callback())
             {
               /* If the watchdog is at the head of the timer queue, then
                * we will need to re-adjust the interval timer that will
                * generate the next interval event.
                */
 
-              if (!list_is_empty(&g_wdactivelist))
+              if (!wd_is_empty())
                 {
                   wd_timer_start(wd_next_expire());
                 }
@@ -106,7 +108,36 @@ int wd_cancel(FAR struct wdog_s *wdog)
           ret = OK;
         }
 
-      leave_critical_section(flags);
+#ifdef CONFIG_WDOG_SPINLOCK
+      /* The callback of the watchdog may still be running on another CPU.
+       * A callback on this CPU is the caller itself.
+       */
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          if (cpu != this_cpu() && g_wdrunning[cpu] == wdog)
+            {
+              running = true;
+            }
+        }
+#endif
+
+      wd_unlock_irqrestore(flags);
+
+#ifdef CONFIG_WDOG_SPINLOCK
+      /* The expiring CPU holds the critical section until its callbacks
+       * are done.  Wait for it the way wd_cancel() did before the
+       * watchdog lock was split out, so that the watchdog may be freed
+       * once we return.
+       */
+
+      if (running)
+        {
+          flags = enter_critical_section();
+          leave_critical_section(flags);
+        }
+#endif
+
       sched_note_wdog(NOTE_WDOG_CANCEL, (FAR void *)wdog->func,
                       (FAR void *)(uintptr_t)wdog->expired);
     }
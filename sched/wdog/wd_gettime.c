@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <limits.h>
+
 #include <nuttx/wdog.h>
 #include <nuttx/irq.h>
 
@@ -61,10 +63,10 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
-      flags     = enter_critical_section();
+      flags     = wd_lock_irqsave();
       is_active = WDOG_ISACTIVE(wdog);
       expired   = wdog->expired;
-      leave_critical_section(flags);
+      wd_unlock_irqrestore(flags);
 
       if (is_active)
         {
@@ -75,3 +77,37 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
 
   return delay;
 }
+
+/****************************************************************************
+ * Name: wd_gettime_next
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the first watchdog expires,
+ *   zero if it has already expired, or CLOCK_MAX if no watchdog is active.
+ *
+ ****************************************************************************/
+
+clock_t wd_gettime_next(void)
+{
+  irqstate_t flags;
+  clock_t    delay = CLOCK_MAX;
+  sclock_t   remain;
+
+  flags = wd_lock_irqsave();
+
+  if (!wd_is_empty())
+    {
+      remain = (sclock_t)(wd_next_expire() - clock_systime_ticks());
+      delay  = remain >= 0 ? remain : 0;
+    }
+
+  wd_unlock_irqrestore(flags);
+  return delay;
+}
@@ -41,6 +41,18 @@
 
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
 
+#ifdef CONFIG_WDOG_SPINLOCK
+/* This spinlock protects g_wdactivelist and the watchdogs in it */
+
+spinlock_t g_wdspinlock = SP_UNLOCKED;
+
+/* The watchdog whose callback each CPU is executing, protected by
+ * g_wdspinlock.
+ */
+
+FAR struct wdog_s *g_wdrunning[CONFIG_SMP_NCPUS];
+#endif
+
 #ifdef CONFIG_SCHED_TICKLESS
 bool g_wdtimernested;
 clock_t  g_wdexpired;
@@ -108,11 +108,27 @@ static inline_function void wd_expiration(clock_t ticks)
 {
   FAR struct wdog_s *wdog;
   irqstate_t         flags;
+#ifdef CONFIG_WDOG_SPINLOCK
+  irqstate_t         csflags;
+  int                cpu;
+#endif
   wdentry_t          func;
   wdparm_t           arg;
   clock_t     next_ticks = ticks;
 
-  flags = enter_critical_section();
+#ifdef CONFIG_WDOG_SPINLOCK
+  /* The callbacks run in the critical section.  Enter it before any
+   * watchdog is taken off the list, so that a wd_cancel() from within the
+   * critical section on another CPU can never see an expired watchdog as
+   * inactive while its callback is still pending.  The lock order is
+   * always the critical section first, then the watchdog lock.
+   */
+
+  csflags = enter_critical_section();
+  cpu     = this_cpu();
+#endif
+
+  flags = wd_lock_irqsave();
 
   wd_update_expire(ticks);
 
@@ -122,8 +138,13 @@ static inline_function void wd_expiration(clock_t ticks)
    * other watchdogs that became ready to run at this time
    */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  while ((wdog = wd_wheel_expire(ticks)) != NULL)
+#else
   while (!list_is_empty(&g_wdactivelist))
+#endif
     {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
       wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
 
       /* Check if watchdog has expired;
@@ -139,6 +160,7 @@ static inline_function void wd_expiration(clock_t ticks)
       /* Remove the watchdog from the head of the list */
 
       list_delete_fast(&wdog->node);
+#endif
 
       /* Indicate that the watchdog is no longer active. */
 
@@ -149,17 +171,41 @@ static inline_function void wd_expiration(clock_t ticks)
       /* Execute the watchdog function */
 
       up_setpicbase(wdog->picbase);
+#ifdef CONFIG_WDOG_SPINLOCK
+      /* Release the watchdog lock so that the callback may start or cancel
+       * watchdogs.  wd_cancel() callers outside of the critical section
+       * find the watchdog in g_wdrunning and wait for the callback.
+       */
+
+      g_wdrunning[cpu] = wdog;
+      wd_unlock_irqrestore(flags);
       CALL_FUNC(func, arg);
+      flags = wd_lock_irqsave();
+      g_wdrunning[cpu] = NULL;
+#else
+      CALL_FUNC(func, arg);
+#endif
     }
 
   wd_set_nested(false);
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  if (!wd_wheel_is_empty())
+    {
+      next_ticks = wd_wheel_next_expire();
+    }
+#endif
+
   if (next_ticks != ticks)
     {
       wd_timer_start(next_ticks);
     }
 
-  leave_critical_section(flags);
+  wd_unlock_irqrestore(flags);
+
+#ifdef CONFIG_WDOG_SPINLOCK
+  leave_critical_section(csflags);
+#endif
 }
 
 /****************************************************************************
@@ -187,6 +233,16 @@ static inline_function
 bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  /* Return whether the earliest expiration time has changed. */
+
+  return wd_wheel_insert(wdog);
+#else
   FAR struct wdog_s *curr;
   FAR struct wdog_s *head;
 
@@ -221,50 +277,58 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
   /* Return whether the head of the watchdog list has changed. */
 
   return head == curr;
+#endif
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: wd_start_abstick
+ * Name: wd_coalesce
  *
  * Description:
- *   This function adds a watchdog timer to the active timer queue.  The
- *   specified watchdog function at 'wdentry' will be called from the
- *   interrupt level after the specified number of ticks has reached.
- *   Watchdog timers may be started from the interrupt level.
- *
- *   Watchdog timers execute in the address environment that was in effect
- *   when wd_start() is called.
- *
- *   Watchdog timers execute only once.
- *
- *   To replace either the timeout delay or the function to be executed,
- *   call wd_start again with the same wdog; only the most recent wdStart()
- *   on a given watchdog ID has any effect.
- *
- * Input Parameters:
- *   wdog     - Watchdog ID
- *   ticks    - Absolute time in clock ticks
- *   wdentry  - Function to call on timeout
- *   arg      - Parameter to pass to wdentry.
+ *   Pick the expiration of a watchdog started with slack: the expiration
+ *   of the first active watchdog within [expired, expired + slack] or,
+ *   without one, expired rounded up to a multiple of the slack.
  *
- *   NOTE:  The parameter must be of type wdparm_t.
+ * Assumptions:
+ *   Called with the watchdog lock held.
  *
- * Returned Value:
- *   Zero (OK) is returned on success; a negated errno value is return to
- *   indicate the nature of any failure.
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_SLACK
+static clock_t wd_coalesce(clock_t expired, clock_t slack)
+{
+#ifndef CONFIG_WDOG_TIMER_WHEEL
+  FAR struct wdog_s *curr;
+
+  list_for_every_entry(&g_wdactivelist, curr, struct wdog_s, node)
+    {
+      if (clock_compare(expired, curr->expired))
+        {
+          if (curr->expired - expired <= slack)
+            {
+              return curr->expired;
+            }
+
+          break;
+        }
+    }
+#endif
+
+  return expired + (slack - 1) - (expired + (slack - 1)) % slack;
+}
+#endif
+
+/****************************************************************************
+ * Name: wd_start_common
  *
- * Assumptions:
- *   The watchdog routine runs in the context of the timer interrupt handler
- *   and is subject to all ISR restrictions.
+ * Description:
+ *   Start a watchdog at an absolute time, moved by up to 'slack' ticks
+ *   when CONFIG_WDOG_TIMER_SLACK is enabled.
  *
  ****************************************************************************/
 
-int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
-                     wdentry_t wdentry, wdparm_t arg)
+static inline_function
+int wd_start_common(FAR struct wdog_s *wdog, clock_t ticks, clock_t slack,
+                    wdentry_t wdentry, wdparm_t arg)
 {
   irqstate_t flags;
   bool       reassess = false;
@@ -279,7 +343,7 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
        * the critical section is established.
        */
 
-      flags = enter_critical_section();
+      flags = wd_lock_irqsave();
 
       /* If the wdog is canceling, restarting the wdog is not allowed. */
 
@@ -290,10 +354,16 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       if (WDOG_ISACTIVE(wdog))
         {
-          reassess |= list_is_head(&g_wdactivelist, &wdog->node);
-          list_delete_fast(&wdog->node);
+          reassess |= wd_remove(wdog);
         }
 
+#ifdef CONFIG_WDOG_TIMER_SLACK
+      if (slack > 0)
+        {
+          ticks = wd_coalesce(ticks, slack);
+        }
+#endif
+
       reassess |= wd_insert(wdog, ticks, wdentry, arg);
       reassess &= !wd_in_callback();
 
@@ -313,12 +383,12 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       if (WDOG_ISACTIVE(wdog))
         {
-          list_delete_fast(&wdog->node);
+          wd_remove(wdog);
         }
 
       wd_insert(wdog, ticks, wdentry, arg);
 #endif
-      leave_critical_section(flags);
+      wd_unlock_irqrestore(flags);
       sched_note_wdog(NOTE_WDOG_START, wdentry,
                       (FAR void *)(uintptr_t)ticks);
       ret = OK;
@@ -327,6 +397,96 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_start_abstick
+ *
+ * Description:
+ *   This function adds a watchdog timer to the active timer queue.  The
+ *   specified watchdog function at 'wdentry' will be called from the
+ *   interrupt level after the specified number of ticks has reached.
+ *   Watchdog timers may be started from the interrupt level.
+ *
+ *   Watchdog timers execute in the address environment that was in effect
+ *   when wd_start() is called.
+ *
+ *   Watchdog timers execute only once.
+ *
+ *   To replace either the timeout delay or the function to be executed,
+ *   call wd_start again with the same wdog; only the most recent wdStart()
+ *   on a given watchdog ID has any effect.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   ticks    - Absolute time in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry.
+ *
+ *   NOTE:  The parameter must be of type wdparm_t.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ * Assumptions:
+ *   The watchdog routine runs in the context of the timer interrupt handler
+ *   and is subject to all ISR restrictions.
+ *
+ ****************************************************************************/
+
+int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
+                     wdentry_t wdentry, wdparm_t arg)
+{
+  return wd_start_common(wdog, ticks, 0, wdentry, arg);
+}
+
+/****************************************************************************
+ * Name: wd_start_abstick_slack
+ *
+ * Description:
+ *   Like wd_start_abstick(), but the watchdog may expire up to 'slack'
+ *   ticks late so that it shares the timer interrupt of other watchdogs.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   ticks    - Absolute time in clock ticks
+ *   slack    - Tolerated delay in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_SLACK
+int wd_start_abstick_slack(FAR struct wdog_s *wdog, clock_t ticks,
+                           clock_t slack, wdentry_t wdentry, wdparm_t arg)
+{
+  return wd_start_common(wdog, ticks, slack, wdentry, arg);
+}
+#endif
+
+/****************************************************************************
+ * Name: wd_task_slack
+ *
+ * Description:
+ *   Return the timer slack, in clock ticks, of the calling thread, as set
+ *   by prctl(PR_SET_TIMERSLACK).  Zero is returned in interrupt context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_SLACK
+clock_t wd_task_slack(void)
+{
+  return up_interrupt_context() ? 0 : this_task()->timerslack;
+}
+#endif
+
 /****************************************************************************
  * Name: wd_timer
  *
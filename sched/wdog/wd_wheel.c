@@ -0,0 +1,562 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/list.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The wheel consists of WHEEL_LEVELS levels of WHEEL_SLOTS slots each.
+ * Slot 'j' of level 'l' holds the watchdogs expiring in the 2^(l * BITS)
+ * ticks long interval whose index at that level is 'j'.  Level 0 has a
+ * resolution of one tick, so all watchdogs in a level 0 slot expire at
+ * the same tick.  When the base time enters the interval of a higher
+ * level slot, the watchdogs in it are cascaded down to the lower levels.
+ * Watchdogs beyond the range of the top level are kept in an unsorted
+ * overflow list and are redistributed each time the top level wraps.
+ */
+
+#define WHEEL_BITS        CONFIG_WDOG_TIMER_WHEEL_BITS
+#define WHEEL_SLOTS       (1 << WHEEL_BITS)
+#define WHEEL_MASK        (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS      CONFIG_WDOG_TIMER_WHEEL_LEVELS
+
+#define WHEEL_SHIFT(l)    ((l) * WHEEL_BITS)
+#define WHEEL_SPAN(l)     ((clock_t)1 << WHEEL_SHIFT(l))
+#define WHEEL_INDEX(t, l) ((unsigned int)((t) >> WHEEL_SHIFT(l)) & WHEEL_MASK)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct wd_wheel_s
+{
+  struct list_node slot[WHEEL_LEVELS][WHEEL_SLOTS];
+  uint32_t         bitmap[WHEEL_LEVELS]; /* Possibly non-empty slots */
+  struct list_node overflow;             /* Beyond the range of the wheel */
+  clock_t          base;                 /* Last tick processed */
+  clock_t          next;                 /* Cached earliest expiration */
+  bool             next_valid;           /* True: 'next' is up to date */
+  bool             initialized;
+  unsigned int     count;                /* Number of queued watchdogs */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct wd_wheel_s g_wdwheel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ ****************************************************************************/
+
+static void wd_wheel_initialize(void)
+{
+  int level;
+  int i;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      for (i = 0; i < WHEEL_SLOTS; i++)
+        {
+          list_initialize(&g_wdwheel.slot[level][i]);
+        }
+    }
+
+  list_initialize(&g_wdwheel.overflow);
+  g_wdwheel.base        = clock_systime_ticks();
+  g_wdwheel.initialized = true;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_find
+ *
+ * Description:
+ *   Return the first possibly non-empty slot of 'level' at or after the
+ *   index 'start' in wheel order, wrapping around.  The returned value is
+ *   the distance from 'start' in slots or -1 if the level is empty.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_find(int level, unsigned int start)
+{
+  uint32_t bitmap = g_wdwheel.bitmap[level];
+  uint32_t upper;
+
+  if (bitmap == 0)
+    {
+      return -1;
+    }
+
+  upper = bitmap & ~((UINT32_C(1) << start) - 1);
+  if (upper != 0)
+    {
+      return ffs(upper) - 1 - start;
+    }
+
+  return ffs(bitmap) - 1 + WHEEL_SLOTS - start;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Put a watchdog in the slot matching its expiration time relative to the
+ *   current base time.  Watchdogs that already expired are queued in the
+ *   slot of the base time.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  clock_t expired = wdog->expired;
+  clock_t delta;
+  int level;
+
+  if ((sclock_t)(expired - g_wdwheel.base) < 0)
+    {
+      expired = g_wdwheel.base;
+    }
+
+  delta = expired - g_wdwheel.base;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      if (delta < WHEEL_SPAN(level + 1))
+        {
+          unsigned int index = WHEEL_INDEX(expired, level);
+
+          list_add_tail(&g_wdwheel.slot[level][index], &wdog->node);
+          g_wdwheel.bitmap[level] |= UINT32_C(1) << index;
+          return;
+        }
+    }
+
+  list_add_tail(&g_wdwheel.overflow, &wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_redistribute
+ *
+ * Description:
+ *   Move all watchdogs of a slot (or of the overflow list) back to the
+ *   wheel using the current base time.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_redistribute(FAR struct list_node *list)
+{
+  struct list_node pending;
+  FAR struct wdog_s *wdog;
+
+  if (list_is_empty(list))
+    {
+      return;
+    }
+
+  /* Detach the whole list first, entries may be queued back to it */
+
+  pending.next       = list->next;
+  pending.prev       = list->prev;
+  pending.next->prev = &pending;
+  pending.prev->next = &pending;
+  list_initialize(list);
+
+  while ((wdog = list_remove_head_type(&pending, struct wdog_s, node))
+         != NULL)
+    {
+      wd_wheel_add(wdog);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Called after the base time has been advanced.  Cascade the slots whose
+ *   interval starts at the new base time down to the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(void)
+{
+  clock_t base = g_wdwheel.base;
+  int level;
+
+  if ((base & (WHEEL_SPAN(WHEEL_LEVELS) - 1)) == 0)
+    {
+      wd_wheel_redistribute(&g_wdwheel.overflow);
+    }
+
+  for (level = WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      if ((base & (WHEEL_SPAN(level) - 1)) == 0)
+        {
+          unsigned int index = WHEEL_INDEX(base, level);
+
+          g_wdwheel.bitmap[level] &= ~(UINT32_C(1) << index);
+          wd_wheel_redistribute(&g_wdwheel.slot[level][index]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next_event
+ *
+ * Description:
+ *   Return the distance in ticks from the base time to the next time at
+ *   which the wheel has something to do: either a level 0 slot becomes due
+ *   or a higher level slot needs to be cascaded.  Zero is returned if the
+ *   wheel is empty.
+ *
+ ****************************************************************************/
+
+static clock_t wd_wheel_next_event(void)
+{
+  clock_t base = g_wdwheel.base;
+  clock_t best = 0;
+  clock_t next;
+  int level;
+  int dist;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      unsigned int index = WHEEL_INDEX(base, level);
+
+      /* The slot of the base time itself was already processed, so look
+       * for the next one.
+       */
+
+      dist = wd_wheel_find(level, (index + 1) & WHEEL_MASK);
+      if (dist < 0)
+        {
+          continue;
+        }
+
+      /* Time from the base to the start of that slot interval */
+
+      next = ((clock_t)(dist + 1) << WHEEL_SHIFT(level)) -
+             (base & (WHEEL_SPAN(level) - 1));
+
+      if (best == 0 || next < best)
+        {
+          best = next;
+        }
+    }
+
+  if (!list_is_empty(&g_wdwheel.overflow))
+    {
+      next = WHEEL_SPAN(WHEEL_LEVELS) -
+             (base & (WHEEL_SPAN(WHEEL_LEVELS) - 1));
+
+      if (best == 0 || next < best)
+        {
+          best = next;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_update_next
+ *
+ * Description:
+ *   Recompute the earliest expiration time of all queued watchdogs.  Only
+ *   the first non-empty slot of each level and the overflow list need to
+ *   be examined.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_update_next(void)
+{
+  FAR struct wdog_s *wdog;
+  clock_t base = g_wdwheel.base;
+  bool found = false;
+  clock_t next = base;
+  int level;
+  int dist;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      unsigned int index = WHEEL_INDEX(base, level);
+      unsigned int start = level == 0 ? index : (index + 1) & WHEEL_MASK;
+
+      /* Clear the bits of the slots that turned out to be empty */
+
+      while ((dist = wd_wheel_find(level, start)) >= 0)
+        {
+          unsigned int slot = (start + dist) & WHEEL_MASK;
+
+          if (!list_is_empty(&g_wdwheel.slot[level][slot]))
+            {
+              list_for_every_entry(&g_wdwheel.slot[level][slot], wdog,
+                                   struct wdog_s, node)
+                {
+                  if (!found || clock_compare(wdog->expired, next))
+                    {
+                      next  = wdog->expired;
+                      found = true;
+                    }
+                }
+
+              break;
+            }
+
+          g_wdwheel.bitmap[level] &= ~(UINT32_C(1) << slot);
+        }
+    }
+
+  list_for_every_entry(&g_wdwheel.overflow, wdog, struct wdog_s, node)
+    {
+      if (!found || clock_compare(wdog->expired, next))
+        {
+          next  = wdog->expired;
+          found = true;
+        }
+    }
+
+  g_wdwheel.next       = next;
+  g_wdwheel.next_valid = true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_is_empty
+ *
+ * Description:
+ *   Return true if no watchdog is queued in the timer wheel.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_is_empty(void)
+{
+  return g_wdwheel.count == 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Queue an active watchdog whose expiration time has already been set.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to queue
+ *
+ * Returned Value:
+ *   True if the earliest expiration time of the wheel has changed.
+ *
+ * Assumptions:
+ *   The caller holds the watchdog lock.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  bool first;
+
+  if (!g_wdwheel.initialized)
+    {
+      wd_wheel_initialize();
+    }
+
+  /* An empty wheel can be rebased to the current time, which saves the
+   * cascading work of catching up with a base time far in the past.
+   */
+
+  if (g_wdwheel.count == 0)
+    {
+      g_wdwheel.base       = clock_systime_ticks();
+      g_wdwheel.next       = wdog->expired;
+      g_wdwheel.next_valid = true;
+      first                = true;
+    }
+  else
+    {
+      if (!g_wdwheel.next_valid)
+        {
+          wd_wheel_update_next();
+        }
+
+      first = clock_compare(wdog->expired, g_wdwheel.next) &&
+              wdog->expired != g_wdwheel.next;
+      if (first)
+        {
+          g_wdwheel.next = wdog->expired;
+        }
+    }
+
+  wd_wheel_add(wdog);
+  g_wdwheel.count++;
+  return first;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a queued watchdog from the wheel.  The slot bitmap is cleaned up
+ *   lazily.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove
+ *
+ * Returned Value:
+ *   True if the watchdog might have been the earliest one to expire.
+ *
+ * Assumptions:
+ *   The caller holds the watchdog lock.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  bool first = !g_wdwheel.next_valid || wdog->expired == g_wdwheel.next;
+
+  DEBUGASSERT(g_wdwheel.count > 0);
+
+  list_delete_fast(&wdog->node);
+  g_wdwheel.count--;
+
+  if (first)
+    {
+      g_wdwheel.next_valid = false;
+    }
+
+  return first;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ *
+ * Description:
+ *   Advance the wheel up to 'ticks' and remove the next watchdog that is
+ *   due at or before that time.
+ *
+ * Input Parameters:
+ *   ticks - Current time in clock ticks
+ *
+ * Returned Value:
+ *   The expired watchdog or NULL if no more watchdogs are due.
+ *
+ * Assumptions:
+ *   The caller holds the watchdog lock.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expire(clock_t ticks)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  clock_t next;
+
+  if (g_wdwheel.count == 0)
+    {
+      return NULL;
+    }
+
+  for (; ; )
+    {
+      /* All watchdogs in the level 0 slot of the base time are due */
+
+      slot = &g_wdwheel.slot[0][WHEEL_INDEX(g_wdwheel.base, 0)];
+      if (!list_is_empty(slot) && clock_compare(g_wdwheel.base, ticks))
+        {
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          wd_wheel_remove(wdog);
+          return wdog;
+        }
+
+      if ((sclock_t)(ticks - g_wdwheel.base) <= 0)
+        {
+          return NULL;
+        }
+
+      /* Skip directly to the next time the wheel has work to do, but do not
+       * go beyond the current time.
+       */
+
+      g_wdwheel.bitmap[0] &= ~(UINT32_C(1) <<
+                               WHEEL_INDEX(g_wdwheel.base, 0));
+
+      next = wd_wheel_next_event();
+      if (next == 0 || next > ticks - g_wdwheel.base)
+        {
+          next = ticks - g_wdwheel.base;
+        }
+
+      g_wdwheel.base += next;
+      wd_wheel_cascade();
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next_expire
+ *
+ * Description:
+ *   Return the earliest expiration time of the queued watchdogs.  The wheel
+ *   must not be empty.
+ *
+ * Assumptions:
+ *   The caller holds the watchdog lock.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_next_expire(void)
+{
+  DEBUGASSERT(g_wdwheel.count > 0);
+
+  if (!g_wdwheel.next_valid)
+    {
+      wd_wheel_update_next();
+    }
+
+  return g_wdwheel.next;
+}
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
@@ -34,10 +34,14 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
 #include <nuttx/arch.h>
 
+#include "sched/sched.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -61,11 +65,31 @@ extern "C"
 
 extern struct list_node g_wdactivelist;
 
+#ifdef CONFIG_WDOG_SPINLOCK
+extern spinlock_t g_wdspinlock;
+
+/* The watchdog whose callback each CPU is executing, NULL if none */
+
+extern FAR struct wdog_s *g_wdrunning[CONFIG_SMP_NCPUS];
+#endif
+
 #ifdef CONFIG_SCHED_TICKLESS
 extern bool g_wdtimernested;
 extern clock_t  g_wdexpired;
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* Timer wheel backend, see wd_wheel.c.  All functions must be called with
+ * the watchdog lock held.
+ */
+
+bool wd_wheel_is_empty(void);
+bool wd_wheel_insert(FAR struct wdog_s *wdog);
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+FAR struct wdog_s *wd_wheel_expire(clock_t ticks);
+clock_t wd_wheel_next_expire(void);
+#endif
+
 /****************************************************************************
  * Inline functions
  ****************************************************************************/
@@ -80,6 +104,33 @@ extern clock_t  g_wdexpired;
 #  define wd_update_expire(expired)
 #endif
 
+/* The watchdog list is protected either by its own spinlock or by the
+ * global critical section.
+ */
+
+static inline_function irqstate_t wd_lock_irqsave(void)
+{
+#ifdef CONFIG_WDOG_SPINLOCK
+  irqstate_t flags = spin_lock_irqsave(&g_wdspinlock);
+#else
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  nxsched_critmon_subsys(CRITMON_SUBSYS_WDOG, true);
+  return flags;
+}
+
+static inline_function void wd_unlock_irqrestore(irqstate_t flags)
+{
+  nxsched_critmon_subsys(CRITMON_SUBSYS_WDOG, false);
+
+#ifdef CONFIG_WDOG_SPINLOCK
+  spin_unlock_irqrestore(&g_wdspinlock, flags);
+#else
+  leave_critical_section(flags);
+#endif
+}
+
 #ifdef CONFIG_SCHED_TICKLESS
 static inline_function clock_t wd_adjust_next_tick(clock_t tick)
 {
@@ -138,9 +189,38 @@ static inline_function void wd_timer_cancel(void)
 #  define wd_timer_cancel()
 #endif
 
+static inline_function bool wd_is_empty(void)
+{
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  return wd_wheel_is_empty();
+#else
+  return list_is_empty(&g_wdactivelist);
+#endif
+}
+
 static inline_function clock_t wd_next_expire(void)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  return wd_wheel_next_expire();
+#else
   return list_first_entry(&g_wdactivelist, struct wdog_s, node)->expired;
+#endif
+}
+
+/* Remove an active watchdog from the queue, return true if it may have
+ * been the next one to expire.
+ */
+
+static inline_function bool wd_remove(FAR struct wdog_s *wdog)
+{
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  return wd_wheel_remove(wdog);
+#else
+  bool head = list_is_head(&g_wdactivelist, &wdog->node);
+
+  list_delete_fast(&wdog->node);
+  return head;
+#endif
 }
 
 /****************************************************************************
@@ -150,14 +230,14 @@ static inline_function clock_t wd_next_expire(void)
 static inline_function clock_t wd_get_next_expire(clock_t curr)
 {
   clock_t     next = curr;
-  irqstate_t flags = enter_critical_section();
+  irqstate_t flags = wd_lock_irqsave();
 
-  if (!list_is_empty(&g_wdactivelist))
+  if (!wd_is_empty())
     {
       next = wd_next_expire();
     }
 
-  leave_critical_section(flags);
+  wd_unlock_irqrestore(flags);
   return (sclock_t)(next - curr) <= 0 ? 0u : next;
 }
 
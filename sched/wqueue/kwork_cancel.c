@@ -60,8 +60,16 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
 
   flags = spin_lock_irqsave(&wqueue->lock);
 
-  if (!work_available(work))
+  work_settle(wqueue, work);
+
+  /* A work queued by work_queue_cpu() may only be removed from the queue
+   * it was queued to.
+   */
+
+  if (!work_available(work) && work_queued_on(work, wqueue))
     {
+      work_clear_wq(work);
+
       /* If the head of the pending queue has changed, we should reset
        * the wqueue timer.
        */
@@ -174,4 +182,76 @@ int work_cancel_sync_wq(FAR struct kwork_wqueue_s *wqueue,
   return work_qcancel(wqueue, true, work);
 }
 
+/****************************************************************************
+ * Name: work_cancel_cpu/work_cancel_sync_cpu
+ *
+ * Description:
+ *   Cancel work previously queued by work_queue_cpu().  The work is
+ *   removed from the queue recorded in the work structure.  The
+ *   synchronous variant then waits on every high priority queue the work
+ *   might have been running on.
+ *
+ * Input Parameters:
+ *   work - The previously queued work structure to cancel
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_cancel_cpu(FAR struct work_s *work)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+
+  if (work == NULL)
+    {
+      return -EINVAL;
+    }
+
+  wqueue = work_ptr_read(&work->wq);
+  return wqueue != NULL ? work_qcancel(wqueue, false, work) : OK;
+}
+
+int work_cancel_sync_cpu(FAR struct work_s *work)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  int ret = OK;
+  int err;
+  int cpu;
+
+  if (work == NULL)
+    {
+      return -EINVAL;
+    }
+
+  wqueue = work_ptr_read(&work->wq);
+  if (wqueue != NULL)
+    {
+      ret = work_qcancel(wqueue, false, work);
+    }
+
+  /* The work may be running on any of the queues it can be sent to.  Wait
+   * on all of them and report the first error.
+   */
+
+  err = work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork, true, work);
+  if (ret >= 0)
+    {
+      ret = err;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      err = work_qcancel(&g_hpwork_cpu[cpu].wq, true, work);
+      if (ret >= 0)
+        {
+          ret = err;
+        }
+    }
+
+  return ret;
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
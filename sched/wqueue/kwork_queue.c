@@ -170,6 +170,16 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 
   expected = clock_delay2abstick(delay);
 
+#ifdef CONFIG_WQUEUE_MPSC
+  /* Fast path: queue idle immediate work without taking the lock. */
+
+  if (!delay && work_queue_incoming(wqueue, work, worker, arg, expected))
+    {
+      nxsem_post(&wqueue->sem);
+      return 0;
+    }
+#endif
+
   /* Interrupts are disabled so that this logic can be called from with
    * task logic or from interrupt handling logic.
    */
@@ -178,6 +188,7 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 
   /* Ensure the work has been removed. */
 
+  work_settle(wqueue, work);
   retimer = work_available(work) ? false : work_remove(wqueue, work);
 
   /* Initialize the work structure. */
@@ -229,4 +240,56 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
   return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
 }
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work to the high priority work queue of a CPU, see
+ *   include/nuttx/wqueue.h.  The queue is recorded in the work structure
+ *   with an atomic compare-and-exchange, which also serializes concurrent
+ *   callers queueing the same work to different CPUs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_cpu(int cpu, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  FAR struct kworker_s *kworker;
+  int ret;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || work == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Use the shared queue if the worker of the CPU is busy and there is
+   * already a backlog of expired work in front of this one.
+   */
+
+  wqueue  = &g_hpwork_cpu[cpu].wq;
+  kworker = wq_get_worker(wqueue);
+
+  if (kworker->pid == 0 ||
+      (kworker->work != NULL && !list_is_empty(&wqueue->expired)))
+    {
+      wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork;
+    }
+
+  if (!work_ptr_cmpxchg(&work->wq, NULL, wqueue))
+    {
+      return -EBUSY;
+    }
+
+  ret = work_queue_wq(wqueue, work, worker, arg, delay);
+  if (ret < 0)
+    {
+      work_clear_wq(work);
+    }
+
+  return ret;
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -93,6 +93,14 @@ struct hp_wqueue_s g_hpwork =
   }
 };
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+/* The state of the per-CPU, high priority work queues.  These are
+ * initialized by work_start_highpri().
+ */
+
+struct hp_cpu_wqueue_s g_hpwork_cpu[CONFIG_SMP_NCPUS];
+#endif
+
 #endif /* CONFIG_SCHED_HPWORK */
 
 #if defined(CONFIG_SCHED_LPWORK)
@@ -144,9 +152,11 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
           break;
         }
 
-      /* Expired work will be moved to tail of the expired queue. */
+      /* Expired work will be moved to tail of the expired queue.  The
+       * work stays linked, so it can not be claimed in between.
+       */
 
-      list_delete(&work->node);
+      list_delete_fast(&work->node);
       list_add_tail(&wq->expired, &work->node);
 
       /* Note that the thread execution this function is also
@@ -191,6 +201,9 @@ static int work_thread(int argc, FAR char *argv[])
   worker_t      worker;
   irqstate_t    flags;
   FAR void     *arg;
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+  clock_t       runtime;
+#endif
 
   /* Get the handle from argv */
 
@@ -222,12 +235,14 @@ static int work_thread(int argc, FAR char *argv[])
           work_dispatch(wqueue);
         }
 
+      /* Collect the work submitted through the lock-free path. */
+
+      work_drain_incoming(wqueue);
+
       if (!list_is_empty(&wqueue->expired))
         {
           work = list_first_entry(&wqueue->expired, struct work_s, node);
 
-          list_delete(&work->node);
-
           /* Extract the work description from the entry (in case the
            * work instance will be reused after it has been de-queued).
            */
@@ -238,10 +253,16 @@ static int work_thread(int argc, FAR char *argv[])
 
           arg = work->arg;
 
-          /* Return the work structure ownership to the work owner. */
+          /* Return the work structure ownership to the work owner.  The
+           * queue recorded by work_queue_cpu() is released before the work
+           * is unlinked, after that it may be queued again.
+           */
 
           work->worker = NULL;
 
+          work_clear_wq(work);
+          work_unlink(work);
+
           /* Mark the thread busy */
 
           kworker->work = work;
@@ -252,7 +273,16 @@ static int work_thread(int argc, FAR char *argv[])
            * performed... we don't have any idea how long this will take!
            */
 
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+          runtime = nxsched_critmon_runtime(this_task());
+#endif
+
           CALL_WORKER(worker, arg);
+
+#ifdef CONFIG_SCHED_CRITMONITOR_CPUTIME
+          nxsched_critmon_work(runtime);
+#endif
+
           flags = spin_lock_irqsave_nopreempt(&wqueue->lock);
 
           /* Mark the thread un-busy */
@@ -351,6 +381,65 @@ static int work_thread_create(FAR const char *name, int priority,
   return OK;
 }
 
+/****************************************************************************
+ * Name: work_start_highpri_percpu
+ *
+ * Description:
+ *   Initialize the per-CPU, high-priority work queues and start their
+ *   worker threads, each pinned to its CPU.
+ *
+ * Returned Value:
+ *   Return zero (OK) on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+static int work_start_highpri_percpu(void)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  char name[16];
+  cpu_set_t cpuset;
+  int ret;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      wqueue = &g_hpwork_cpu[cpu].wq;
+
+      list_initialize(&wqueue->expired);
+      list_initialize(&wqueue->pending);
+      nxsem_init(&wqueue->sem, 0, 0);
+      nxsem_init(&wqueue->exsem, 0, 0);
+      spin_lock_init(&wqueue->lock);
+      wqueue->nthreads = 1;
+
+      snprintf(name, sizeof(name), HPWORKNAME "%d", cpu);
+
+      sched_lock();
+      ret = work_thread_create(name, CONFIG_SCHED_HPWORKPRIORITY, NULL,
+                               CONFIG_SCHED_HPWORKSTACKSIZE, wqueue);
+      if (ret >= 0)
+        {
+          CPU_ZERO(&cpuset);
+          CPU_SET(cpu, &cpuset);
+          ret = nxsched_set_affinity(g_hpwork_cpu[cpu].worker[0].pid,
+                                     sizeof(cpuset), &cpuset);
+        }
+
+      sched_unlock();
+
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to start hpwork for CPU%d: %d\n", cpu, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -554,10 +643,22 @@ int work_queue_priority(int qid)
 #ifdef CONFIG_SCHED_HPWORK
 int work_start_highpri(void)
 {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  int ret;
+#endif
+
   /* Start the high-priority, kernel mode worker thread(s) */
 
   sinfo("Starting high-priority kernel worker thread(s)\n");
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  ret = work_start_highpri_percpu();
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
 #ifdef SCHED_HPWORKSTACKSECTION
   static uint8_t hp_work_stack[CONFIG_SCHED_HPNTHREADS]
                               [CONFIG_SCHED_HPWORKSTACKSIZE]
@@ -32,6 +32,8 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
 #include <nuttx/clock.h>
 #include <nuttx/list.h>
 #include <nuttx/wqueue.h>
@@ -55,6 +57,52 @@
 #define wq_get_worker(wq) \
   (FAR struct kworker_s *)((FAR char *)(wq) + sizeof(struct kwork_wqueue_s))
 
+/* With CONFIG_WQUEUE_MPSC, the node.prev field of a work is used to claim
+ * it: a work whose node.prev is NULL is not linked to any list and may be
+ * claimed by an atomic compare-and-exchange to WORK_INCOMING.  A claimed
+ * work is then pushed to the incoming list of the wqueue, which is
+ * singly linked through node.next.
+ */
+
+#define WORK_INCOMING ((FAR struct list_node *)1)
+
+/* Unlink a work from the list it belongs to.  The node.prev field must be
+ * cleared last, as it releases the work to lock-free producers.
+ */
+
+#ifdef CONFIG_WQUEUE_MPSC
+#  define work_unlink(work) \
+  do \
+    { \
+      list_delete_fast(&(work)->node); \
+      (work)->node.next = NULL; \
+      UP_DMB(); \
+      (work)->node.prev = NULL; \
+    } \
+  while (0)
+#else
+#  define work_unlink(work) list_delete(&(work)->node)
+#endif
+
+/* The queue recorded by work_queue_cpu() is cleared once the work has left
+ * the queue, which allows the work to be queued to another CPU again.
+ */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define work_clear_wq(work) \
+  do \
+    { \
+      UP_DMB(); \
+      (work)->wq = NULL; \
+    } \
+  while (0)
+#  define work_queued_on(work, wqueue) \
+  ((work)->wq == NULL || (work)->wq == (wqueue))
+#else
+#  define work_clear_wq(work)
+#  define work_queued_on(work, wqueue) (true)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -81,6 +129,9 @@ struct kwork_wqueue_s
   uint8_t          nthreads;  /* Number of worker threads */
   bool             exit;      /* A flag to request the thread to exit */
   struct wdog_s    timer;     /* Timer to pending. */
+#ifdef CONFIG_WQUEUE_MPSC
+  FAR struct work_s *incoming; /* Lock-free LIFO of immediate work */
+#endif
 };
 
 /* This structure defines the state of one high-priority work queue.  This
@@ -96,6 +147,18 @@ struct hp_wqueue_s
 
   struct kworker_s      worker[CONFIG_SCHED_HPNTHREADS];
 };
+
+/* This structure defines the state of one per-CPU high priority work
+ * queue, which is serviced by a single pinned worker thread.
+ */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+struct hp_cpu_wqueue_s
+{
+  struct kwork_wqueue_s wq;
+  struct kworker_s      worker[1];
+};
+#endif
 #endif
 
 /* This structure defines the state of one low-priority work queue.  This
@@ -121,6 +184,12 @@ struct lp_wqueue_s
 /* The state of the kernel mode, high priority work queue. */
 
 extern struct hp_wqueue_s g_hpwork;
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+/* The state of the per-CPU, high priority work queues. */
+
+extern struct hp_cpu_wqueue_s g_hpwork_cpu[CONFIG_SMP_NCPUS];
+#endif
 #endif
 
 #ifdef CONFIG_SCHED_LPWORK
@@ -154,6 +223,186 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
     }
 }
 
+/****************************************************************************
+ * Name: work_ptr_read/work_ptr_cmpxchg/work_ptr_xchg
+ *
+ * Description:
+ *   Atomic accessors of the pointer fields used by the lock-free
+ *   submission path.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_WQUEUE_MPSC) || defined(CONFIG_SCHED_HPWORK_PERCPU)
+#  if UINTPTR_MAX > UINT32_MAX
+static inline_function FAR void *work_ptr_read(FAR void *ptr)
+{
+  return (FAR void *)(uintptr_t)atomic64_read_acquire((FAR atomic64_t *)ptr);
+}
+
+static inline_function
+bool work_ptr_cmpxchg(FAR void *ptr, FAR void *expected, FAR void *desired)
+{
+  int64_t old = (int64_t)(uintptr_t)expected;
+
+  return atomic64_cmpxchg((FAR atomic64_t *)ptr, &old,
+                          (int64_t)(uintptr_t)desired);
+}
+
+static inline_function FAR void *work_ptr_xchg(FAR void *ptr, FAR void *val)
+{
+  return (FAR void *)(uintptr_t)atomic64_xchg((FAR atomic64_t *)ptr,
+                                              (int64_t)(uintptr_t)val);
+}
+#  else
+static inline_function FAR void *work_ptr_read(FAR void *ptr)
+{
+  return (FAR void *)(uintptr_t)atomic_read_acquire((FAR atomic_t *)ptr);
+}
+
+static inline_function
+bool work_ptr_cmpxchg(FAR void *ptr, FAR void *expected, FAR void *desired)
+{
+  int32_t old = (int32_t)(uintptr_t)expected;
+
+  return atomic_cmpxchg((FAR atomic_t *)ptr, &old,
+                        (int32_t)(uintptr_t)desired);
+}
+
+static inline_function FAR void *work_ptr_xchg(FAR void *ptr, FAR void *val)
+{
+  return (FAR void *)(uintptr_t)atomic_xchg((FAR atomic_t *)ptr,
+                                            (int32_t)(uintptr_t)val);
+}
+#  endif
+#endif
+
+#ifdef CONFIG_WQUEUE_MPSC
+
+/****************************************************************************
+ * Name: work_queue_incoming
+ *
+ * Description:
+ *   Internal public function to queue an idle work for immediate execution
+ *   without taking the wqueue lock.  Require wqueue != NULL and
+ *   work != NULL.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work to be queued.
+ *   worker - The worker callback.
+ *   arg    - The worker argument.
+ *   qtime  - The queue time.
+ *
+ * Returned Value:
+ *   True if the work was queued, false if the work is already queued or
+ *   being queued and the locked path must be used.
+ *
+ ****************************************************************************/
+
+static inline_function
+bool work_queue_incoming(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct work_s *work, worker_t worker,
+                         FAR void *arg, clock_t qtime)
+{
+  FAR struct work_s *head;
+  irqstate_t flags;
+
+  /* Interrupts stay disabled between the claim and the push, so that a
+   * CPU waiting for the push in work_settle() is never waiting for
+   * itself.
+   */
+
+  flags = up_irq_save();
+
+  if (!work_ptr_cmpxchg(&work->node.prev, NULL, WORK_INCOMING))
+    {
+      up_irq_restore(flags);
+      return false;
+    }
+
+  work->worker = worker;
+  work->arg    = arg;
+  work->qtime  = qtime;
+
+  do
+    {
+      head = work_ptr_read(&wqueue->incoming);
+      work->node.next = (FAR struct list_node *)head;
+    }
+  while (!work_ptr_cmpxchg(&wqueue->incoming, head, work));
+
+  up_irq_restore(flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: work_drain_incoming
+ *
+ * Description:
+ *   Internal public function to move the lock-free submitted work to the
+ *   tail of the expired queue, preserving the submission order.  The
+ *   caller must hold the wqueue lock.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *
+ ****************************************************************************/
+
+static inline_function
+void work_drain_incoming(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct list_node *tail;
+  FAR struct work_s *work;
+  FAR struct work_s *next;
+
+  if (work_ptr_read(&wqueue->incoming) == NULL)
+    {
+      return;
+    }
+
+  /* The incoming list is LIFO, inserting each entry right after the old
+   * tail reverses it.
+   */
+
+  tail = wqueue->expired.prev;
+  work = work_ptr_xchg(&wqueue->incoming, NULL);
+
+  while (work != NULL)
+    {
+      next = (FAR struct work_s *)work->node.next;
+      list_add_after(tail, &work->node);
+      work = next;
+    }
+}
+
+/****************************************************************************
+ * Name: work_settle
+ *
+ * Description:
+ *   Internal public function to make sure that a work is not in the
+ *   incoming list, so that it can be handled by the locked path.  If the
+ *   work is being pushed by another CPU, wait for the push to complete.
+ *   The caller must hold the wqueue lock.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work.
+ *
+ ****************************************************************************/
+
+static inline_function
+void work_settle(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work)
+{
+  while (work_ptr_read(&work->node.prev) == WORK_INCOMING)
+    {
+      work_drain_incoming(wqueue);
+    }
+}
+#else
+#  define work_drain_incoming(wqueue)
+#  define work_settle(wqueue, work)
+#endif
+
 /****************************************************************************
  * Name: work_insert_pending
  *
@@ -237,7 +486,7 @@ bool work_remove(FAR struct kwork_wqueue_s *wqueue,
 
   work->worker = NULL;
 
-  list_delete(&work->node);
+  work_unlink(work);
 
   return head == work;
 }
@@ -640,6 +640,10 @@ static const char *g_white_content_list[] =
   "unzGetCurrentFileInfo64",
   "unzGoToNextFile",
   "unzGoToFirstFile",
+  "unzCloseCurrentFile",
+  "unzGetGlobalInfo64",
+  "unzGetFilePos64",
+  "unzGoToFilePos64",
 
   /* Ref:
    * apps/netutils/telnetc/telnetc.c
@@ -332,7 +332,7 @@ FAR struct bt_buf_s *bt_buf_alloc(enum bt_buf_type_e type,
       /* Yes.. use that IOB */
 
       DEBUGASSERT(iob->io_len >= iob->io_offset &&
-                  iob->io_len <= BLUETOOTH_MAX_FRAMELEN);
+                  iob->io_len <= CONFIG_IOB_BUFSIZE);
 
       buf->frame = iob;
       buf->data  = &iob->io_data[iob->io_offset];
@@ -1188,6 +1188,89 @@ static void priority_rx_work(FAR void *arg)
     }
 }
 
+/****************************************************************************
+ * Name: bt_receive_buf
+ *
+ * Description:
+ *   Queue a received buffer for processing.  Command Complete/Status events
+ *   are handled on the high priority work queue, all others on the low
+ *   priority work queue.
+ *
+ * Input Parameters:
+ *   buf - The buffer holding the received frame.  It is consumed.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  Otherwise a negated errno value is
+ *   returned to indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+static int bt_receive_buf(FAR struct bt_buf_s *buf)
+{
+  FAR struct bt_hci_evt_hdr_s *hdr;
+  int ret;
+
+  if (buf->type != BT_ACL_IN)
+    {
+      if (buf->type != BT_EVT)
+        {
+          wlerr("ERROR: Invalid buf type %u\n", buf->type);
+          bt_buf_release(buf);
+          return -EINVAL;
+        }
+
+      /* Command Complete/Status events use high priority messages. */
+
+      hdr = (FAR void *)buf->data;
+      if (hdr->evt == BT_HCI_EVT_CMD_COMPLETE ||
+          hdr->evt == BT_HCI_EVT_CMD_STATUS ||
+          hdr->evt == BT_HCI_EVT_NUM_COMPLETED_PACKETS)
+        {
+          /* Add the buffer to the high priority Rx buffer list */
+
+          bt_enqueue_bufwork(&g_hp_rxlist, buf);
+
+          /* If there is already pending work, then do nothing.  Otherwise,
+           * schedule processing of the Rx buffer list on the high priority
+           * work queue.
+           */
+
+          if (work_available(&g_hp_work))
+            {
+              ret = work_queue(HPWORK, &g_hp_work, priority_rx_work,
+                               &g_hp_rxlist, 0);
+              if (ret < 0)
+                {
+                  wlerr("ERROR:  Failed to schedule HPWORK: %d\n", ret);
+                }
+            }
+
+          return OK;
+        }
+    }
+
+  /* All others use the low priority work queue */
+
+  /* Add the buffer to the low priority Rx buffer list */
+
+  bt_enqueue_bufwork(&g_lp_rxlist, buf);
+
+  /* If there is already pending work, then do nothing.  Otherwise, schedule
+   * processing of the Rx buffer list on the low priority work queue.
+   */
+
+  if (work_available(&g_lp_work))
+    {
+      ret = work_queue(LPWORK, &g_lp_work, hci_rx_work, &g_lp_rxlist, 0);
+      if (ret < 0)
+        {
+          wlerr("ERROR:  Failed to schedule LPWORK: %d\n", ret);
+        }
+    }
+
+  return OK;
+}
+
 #ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
 static void read_local_features_complete(FAR struct bt_buf_s *buf)
 {
@@ -1798,9 +1881,7 @@ void bt_driver_unset(FAR struct bt_driver_s *btdev)
 int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
                FAR void *data, size_t len)
 {
-  FAR struct bt_hci_evt_hdr_s *hdr;
-  struct bt_buf_s *buf;
-  int ret;
+  FAR struct bt_buf_s *buf;
 
   if (len + BLUETOOTH_H4_HDRLEN > CONFIG_IOB_BUFSIZE)
     {
@@ -1810,10 +1891,6 @@ int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
 
   wlinfo("data %p len %zu\n", data, len);
 
-  /* Critical command complete/status events use the high priority work
-   * queue.
-   */
-
   buf = bt_buf_alloc(type, NULL, BLUETOOTH_H4_HDRLEN);
   if (buf == NULL)
     {
@@ -1821,66 +1898,52 @@ int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
     }
 
   memcpy(bt_buf_extend(buf, len), data, len);
+  return bt_receive_buf(buf);
+}
 
-  if (type != BT_ACL_IN)
-    {
-      if (type != BT_EVT)
-        {
-          wlerr("ERROR: Invalid buf type %u\n", buf->type);
-          bt_buf_release(buf);
-          return -EINVAL;
-        }
-
-      /* Command Complete/Status events use high priority messages. */
-
-      hdr = (FAR void *)buf->data;
-      if (hdr->evt == BT_HCI_EVT_CMD_COMPLETE ||
-          hdr->evt == BT_HCI_EVT_CMD_STATUS ||
-          hdr->evt == BT_HCI_EVT_NUM_COMPLETED_PACKETS)
-        {
-          /* Add the buffer to the high priority Rx buffer list */
-
-          bt_enqueue_bufwork(&g_hp_rxlist, buf);
-
-          /* If there is already pending work, then do nothing.  Otherwise,
-           * schedule processing of the Rx buffer list on the high priority
-           * work queue.
-           */
+/****************************************************************************
+ * Name: bt_receive_iob
+ *
+ * Description:
+ *   Zero-copy variant of bt_receive().  The low-level driver has already
+ *   received the frame into an IOB: io_offset skips the transport header
+ *   and io_len includes io_offset, as for the IOBs used by bt_buf_alloc().
+ *   The IOB is wrapped by a buffer structure without copying and is
+ *   consumed in all cases.
+ *
+ * Input Parameters:
+ *   btdev - An instance of the low-level drivers interface structure.
+ *   type  - The type of the received frame.
+ *   iob   - The IOB holding the received frame.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  Otherwise a negated errno value is
+ *   returned to indicate the nature of the failure.
+ *
+ ****************************************************************************/
 
-          if (work_available(&g_hp_work))
-            {
-              ret = work_queue(HPWORK, &g_hp_work, priority_rx_work,
-                               &g_hp_rxlist, 0);
-              if (ret < 0)
-                {
-                  wlerr("ERROR:  Failed to schedule HPWORK: %d\n", ret);
-                }
-            }
+int bt_receive_iob(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
+                   FAR struct iob_s *iob)
+{
+  FAR struct bt_buf_s *buf;
 
-          return OK;
-        }
+  if (iob->io_len < iob->io_offset || iob->io_len > CONFIG_IOB_BUFSIZE)
+    {
+      wlerr("ERROR: Bad frame length %u\n", iob->io_len);
+      iob_free(iob);
+      return -EINVAL;
     }
 
-  /* All others use the low priority work queue */
-
-  /* Add the buffer to the low priority Rx buffer list */
-
-  bt_enqueue_bufwork(&g_lp_rxlist, buf);
-
-  /* If there is already pending work, then do nothing.  Otherwise, schedule
-   * processing of the Rx buffer list on the low priority work queue.
-   */
+  wlinfo("iob %p len %u\n", iob, iob->io_len - iob->io_offset);
 
-  if (work_available(&g_lp_work))
+  buf = bt_buf_alloc(type, iob, 0);
+  if (buf == NULL)
     {
-      ret = work_queue(LPWORK, &g_lp_work, hci_rx_work, &g_lp_rxlist, 0);
-      if (ret < 0)
-        {
-          wlerr("ERROR:  Failed to schedule LPWORK: %d\n", ret);
-        }
+      iob_free(iob);
+      return -ENOMEM;
     }
 
-  return OK;
+  return bt_receive_buf(buf);
 }
 
 #ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
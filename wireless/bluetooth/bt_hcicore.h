@@ -489,4 +489,16 @@ void bt_hci_cb_register(FAR struct bt_hci_cb_s *cb);
 int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
                FAR void *data, size_t len);
 
+/****************************************************************************
+ * Name: bt_receive_iob
+ *
+ * Description:
+ *   Zero-copy variant of bt_receive(): the received frame is handed over in
+ *   an IOB that becomes owned by the stack.
+ *
+ ****************************************************************************/
+
+int bt_receive_iob(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
+                   FAR struct iob_s *iob);
+
 #endif /* __WIRELESS_BLUETOOTH_BT_HDICORE_H */